@@ -36,6 +36,9 @@ CMAKE_ARGS=(
   # Also check if microbenchmarks are buildable.
   "-DIREE_BUILD_MICROBENCHMARKS=ON"
 
+  # Also build and test the VM bytecode execution profiler.
+  "-DIREE_ENABLE_VM_EXECUTION_PROFILING=ON"
+
   "-DIREE_ENABLE_ASSERTIONS=${IREE_ENABLE_ASSERTIONS}"
 )
 
@@ -38,6 +38,13 @@ case "${BUILD_PRESET}" in
       -DIREE_BUILD_SAMPLES=ON
     )
     ;;
+  test-with-tracing-sampling)
+    args+=(
+      -DIREE_ENABLE_ASSERTIONS=ON
+      -DIREE_BUILD_SAMPLES=OFF
+      -DIREE_ENABLE_RUNTIME_TRACING_SAMPLING=ON
+    )
+    ;;
   benchmark)
     args+=(
       -DIREE_ENABLE_ASSERTIONS=OFF
@@ -62,7 +69,7 @@ esac
 "${CMAKE_BIN}" "${args[@]}"
 
 case "${BUILD_PRESET}" in
-  test)
+  test|test-with-tracing-sampling)
     "${CMAKE_BIN}" --build "${BUILD_DIR}" -- -k 0
     ;;
   benchmark|benchmark-with-tracing)
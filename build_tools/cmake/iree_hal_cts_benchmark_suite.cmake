@@ -0,0 +1,94 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+include(CMakeParseArguments)
+
+# iree_hal_cts_benchmark_suite()
+#
+# Creates a benchmark binary for a provided Hardware Abstraction Layer (HAL)
+# driver running the microbenchmarks in iree/hal/cts/cts_benchmarks.h.
+# A `${NAME}_test` target runs each benchmark once as a smoke test.
+#
+# Parameters match iree_hal_cts_test_suite(). The dispatch benchmarks are only
+# enabled if the suite is declared after an iree_hal_cts_test_suite() in the
+# same package with the same COMPILER_TARGET_BACKEND (which produces the
+# executable testdata).
+#
+# Parameters:
+#   DRIVER_NAME: The name of the driver to benchmark.
+#   VARIANT_SUFFIX: Suffix to add to the binary name, separate from the driver
+#       name.
+#   DRIVER_REGISTRATION_HDR: The C #include path for `DRIVER_REGISTRATION_FN`.
+#   DRIVER_REGISTRATION_FN: The C function which registers `DRIVER_NAME`.
+#   COMPILER_TARGET_BACKEND: Optional target backend name used to locate the
+#       executable testdata.
+#   EXECUTABLE_FORMAT: Executable format identifier, as in
+#       iree_hal_cts_test_suite().
+#   DEPS: List of other libraries to link in to the binary target (typically
+#       the dependency for `DRIVER_REGISTRATION_HDR`).
+#   LABELS: Additional labels to forward to the test. The package path and
+#     "driver=${DRIVER}" are added automatically.
+function(iree_hal_cts_benchmark_suite)
+  if(NOT IREE_BUILD_TESTS)
+    return()
+  endif()
+
+  cmake_parse_arguments(
+    _RULE
+    ""
+    "DRIVER_NAME;VARIANT_SUFFIX;DRIVER_REGISTRATION_HDR;DRIVER_REGISTRATION_FN;COMPILER_TARGET_BACKEND;EXECUTABLE_FORMAT"
+    "DEPS;LABELS"
+    ${ARGN}
+  )
+
+  list(APPEND _RULE_LABELS "driver=${_RULE_DRIVER_NAME}")
+
+  set(_BENCHMARK_DEPS "${_RULE_DEPS}")
+  set(IREE_CTS_EXECUTABLE_FORMAT "")
+  set(IREE_CTS_EXECUTABLES_TESTDATA_HDR "")
+  if(DEFINED _RULE_COMPILER_TARGET_BACKEND)
+    set(_EXECUTABLES_TESTDATA_NAME "${_RULE_COMPILER_TARGET_BACKEND}_executables")
+    iree_package_name(_PACKAGE_NAME)
+    if(TARGET ${_PACKAGE_NAME}_${_EXECUTABLES_TESTDATA_NAME}_c)
+      list(APPEND _BENCHMARK_DEPS ::${_EXECUTABLES_TESTDATA_NAME}_c)
+      set(IREE_CTS_EXECUTABLE_FORMAT "${_RULE_EXECUTABLE_FORMAT}")
+      set(IREE_CTS_EXECUTABLES_TESTDATA_HDR "${_EXECUTABLES_TESTDATA_NAME}_c.h")
+    endif()
+  endif()
+
+  if(DEFINED _RULE_VARIANT_SUFFIX)
+    set(_BENCHMARK_TARGET_NAME "${_RULE_DRIVER_NAME}_${_RULE_VARIANT_SUFFIX}_cts_benchmarks")
+  else()
+    set(_BENCHMARK_TARGET_NAME "${_RULE_DRIVER_NAME}_cts_benchmarks")
+  endif()
+  set(_BENCHMARK_SOURCE_NAME "${_BENCHMARK_TARGET_NAME}.cc")
+
+  set(IREE_CTS_DRIVER_REGISTRATION_HDR "${_RULE_DRIVER_REGISTRATION_HDR}")
+  set(IREE_CTS_DRIVER_REGISTRATION_FN "${_RULE_DRIVER_REGISTRATION_FN}")
+  set(IREE_CTS_DRIVER_NAME "${_RULE_DRIVER_NAME}")
+
+  configure_file(
+    "${IREE_ROOT_DIR}/runtime/src/iree/hal/cts/cts_benchmark_template.cc.in"
+    ${_BENCHMARK_SOURCE_NAME}
+  )
+
+  iree_cc_binary_benchmark(
+    NAME
+      ${_BENCHMARK_TARGET_NAME}
+    SRCS
+      "${CMAKE_CURRENT_BINARY_DIR}/${_BENCHMARK_SOURCE_NAME}"
+    DEPS
+      ${_BENCHMARK_DEPS}
+      iree::base
+      iree::base::internal::flags
+      iree::hal
+      iree::hal::cts::cts_benchmarks
+      iree::testing::benchmark
+    LABELS
+      ${_RULE_LABELS}
+    TESTONLY
+  )
+endfunction()
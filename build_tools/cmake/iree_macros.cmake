@@ -53,10 +53,9 @@ string(TOLOWER "${_IREE_UNNORMALIZED_ARCH}" _IREE_UNNORMALIZED_ARCH_LOWERCASE)
 
 # Normalize _IREE_UNNORMALIZED_ARCH into IREE_ARCH.
 if (EMSCRIPTEN)
-  # TODO: figure what to do about the wasm target, which masquerades as x86.
-  # This is the one case where the IREE_ARCH CMake variable is currently
-  # inconsistent with the IREE_ARCH C preprocessor token.
-  set (IREE_ARCH "")
+  # The wasm target masquerades as x86 in CMAKE_SYSTEM_PROCESSOR, so check for
+  # it first. This matches the IREE_ARCH C preprocessor token for __wasm32__.
+  set (IREE_ARCH "wasm_32")
 elseif ((_IREE_UNNORMALIZED_ARCH_LOWERCASE STREQUAL "aarch64") OR
         (_IREE_UNNORMALIZED_ARCH_LOWERCASE STREQUAL "arm64") OR
         (_IREE_UNNORMALIZED_ARCH_LOWERCASE STREQUAL "arm64e") OR
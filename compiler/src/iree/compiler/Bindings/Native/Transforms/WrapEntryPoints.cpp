@@ -8,6 +8,7 @@
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "mlir/Dialect/Affine/Utils.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -290,6 +291,19 @@ static void populateReflectionAttrs(IREE::ABI::InvocationModel invocationModel,
       break;
   }
 
+  // Donated arguments are listed so that callers know the buffers they pass
+  // for them may be overwritten and must not be used after the call.
+  SmallVector<std::string> donatedArgs;
+  for (unsigned i = 0; i < exportOp.getNumArguments(); ++i) {
+    if (exportOp.getArgAttr(i, "iree.abi.donate")) {
+      donatedArgs.push_back(std::to_string(i));
+    }
+  }
+  if (!donatedArgs.empty()) {
+    attrs.emplace_back(StringAttr::get(context, "iree.abi.donate"),
+                       StringAttr::get(context, llvm::join(donatedArgs, ",")));
+  }
+
   if (!attrs.empty()) {
     auto reflectionAttr = DictionaryAttr::get(context, attrs);
     wrapperOp->setAttr("iree.reflection", reflectionAttr);
@@ -392,6 +406,41 @@ static func::FuncOp createExportWrapperFunc(
     resultStorages[outputAttr.getInt()] = storageArg;
   }
 
+  // Donated arguments provide the storage for the result they are tied to.
+  // The caller relinquishes the buffer and the result is produced in-place
+  // when possible instead of into a new allocation.
+  for (unsigned i = 0; i < exportOp.getNumArguments(); ++i) {
+    auto donateAttr =
+        exportOp.getArgAttrOfType<IntegerAttr>(i, "iree.abi.donate");
+    if (!donateAttr) continue;
+    int64_t resultIndex = donateAttr.getInt();
+    if (resultIndex < 0 ||
+        resultIndex >= static_cast<int64_t>(resultTypes.size())) {
+      exportOp.emitError() << "donated argument " << i
+                           << " references invalid result " << resultIndex;
+      return {};
+    }
+    auto argType = oldExportType.getInput(i);
+    auto resultType = oldExportType.getResult(resultIndex);
+    if (!argType.isa<TensorType>() || argType != resultType) {
+      exportOp.emitError() << "donated argument " << i << " of type "
+                           << argType << " must be a tensor of the same type "
+                           << "as result " << resultIndex << " (" << resultType
+                           << ")";
+      return {};
+    }
+    if (resultStorages[resultIndex]) {
+      exportOp.emitError() << "result " << resultIndex
+                           << " already has storage provided";
+      return {};
+    }
+    auto donatedArg = entryBlock->getArgument(i);
+    resultStorages[resultIndex] =
+        entryBuilder.create<IREE::HAL::BufferViewBufferOp>(
+            donatedArg.getLoc(),
+            entryBuilder.getType<IREE::HAL::BufferType>(), donatedArg);
+  }
+
   // Build a map of each I/O argument to the fence that covers them.
   // TODO(benvanik): actually support a map; for now we just handle the 1:M
   // coarse mode where all inputs are covered by a single wait fence and all
@@ -57,6 +57,30 @@ func.func @outputStorage(%arg0: tensor<?x8x8x3xf32>, %ret1: !hal.buffer {iree.ab
 
 // -----
 
+// CHECK-LABEL: func.func @donatedStorage(
+//  CHECK-SAME:   %[[ARG0:.+]]: !hal.buffer_view {iree.abi.donate = 0 : index},
+//  CHECK-SAME:   %[[ARG1:.+]]: !hal.buffer_view
+//  CHECK-SAME: -> !hal.buffer_view
+//  CHECK-SAME: attributes {
+//  CHECK-SAME:   iree.abi.stub
+//  CHECK-SAME:   iree.reflection = {iree.abi.donate = "0"}
+//  CHECK-SAME: } {
+//  CHECK-NEXT:   %[[ARG0_STORAGE:.+]] = hal.buffer_view.buffer<%[[ARG0]] : !hal.buffer_view> : !hal.buffer
+//  CHECK-NEXT:   %[[ARG0_TENSOR:.+]] = hal.tensor.import %[[ARG0]] "input 0" : !hal.buffer_view -> tensor<4xf32>
+//  CHECK-NEXT:   %[[ARG1_TENSOR:.+]] = hal.tensor.import %[[ARG1]] "input 1" : !hal.buffer_view -> tensor<4xf32>
+//  CHECK-NEXT:   %[[RET_TENSOR:.+]] = call @_donatedStorage(%[[ARG0_TENSOR]], %[[ARG1_TENSOR]])
+//  CHECK-NEXT:   %[[RET_VIEW:.+]] = hal.tensor.export %[[RET_TENSOR]] "output 0" into %[[ARG0_STORAGE]] : tensor<4xf32> -> !hal.buffer_view
+//  CHECK-NEXT:   return %[[RET_VIEW]] : !hal.buffer_view
+//  CHECK-NEXT: }
+
+// CHECK-LABEL: func.func private @_donatedStorage(
+func.func @donatedStorage(%state: tensor<4xf32> {iree.abi.donate = 0 : index}, %update: tensor<4xf32>) -> tensor<4xf32> {
+  %0 = arith.addf %state, %update : tensor<4xf32>
+  return %0 : tensor<4xf32>
+}
+
+// -----
+
 // CHECK-LABEL: func.func @wrappedAlready
 //  CHECK-SAME: (%arg0: !hal.buffer_view) -> !hal.buffer_view
 //  CHECK-SAME: attributes {iree.abi.stub}
@@ -344,6 +344,16 @@ chooseDynamicEncodingInfoVMVXMicrokernels(RankedTensorType tensorType,
     flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32;
   } else if (*matmulType == MatmulType::I8I8I32) {
     flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32;
+  } else if (*matmulType == MatmulType::F16F16F32) {
+    flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32;
+  } else if (*matmulType == MatmulType::F16F16F16) {
+    flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16;
+  } else if (*matmulType == MatmulType::BF16BF16F32) {
+    flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32;
+  } else if (*matmulType == MatmulType::BF16BF16BF16) {
+    flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16;
+  } else if (*matmulType == MatmulType::I8I4I32) {
+    flags |= IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32;
   } else {
     return failure();
   }
@@ -208,3 +208,14 @@ func.func @ukernel_mmt4d_i8i8i32(%arg0 : memref<?x?x?x?xi8>, %arg1 : memref<?x?x
 }
 // CHECK-LABEL: func @ukernel_mmt4d_i8i8i32(
 //       CHECK:   call @vmvx.mmt4d.i8i8i32
+
+// -----
+
+func.func @ukernel_mmt4d_f16f16f16(%arg0 : memref<?x?x?x?xf16>, %arg1 : memref<?x?x?x?xf16>,
+    %arg2 : memref<?x?x?x?xf16>) {
+  iree_codegen.ukernel.mmt4d lhs(%arg0 : memref<?x?x?x?xf16>) rhs(%arg1 : memref<?x?x?x?xf16>)
+      outs(%arg2 : memref<?x?x?x?xf16>) accumulate(false)
+  return
+}
+// CHECK-LABEL: func @ukernel_mmt4d_f16f16f16(
+//       CHECK:   call @vmvx.mmt4d.f16f16f16
@@ -347,6 +347,21 @@ FailureOr<func::CallOp> UKernelMmt4DOp::lowerToFunctionCall(
     case MatmulType::F32F32F32:
       fnName.append("f32f32f32");
       break;
+    case MatmulType::F16F16F32:
+      fnName.append("f16f16f32");
+      break;
+    case MatmulType::F16F16F16:
+      fnName.append("f16f16f16");
+      break;
+    case MatmulType::BF16BF16F32:
+      fnName.append("bf16bf16f32");
+      break;
+    case MatmulType::BF16BF16BF16:
+      fnName.append("bf16bf16bf16");
+      break;
+    case MatmulType::I8I4I32:
+      fnName.append("i8i4i32");
+      break;
   }
 
   // Create the function type.
@@ -22,6 +22,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/TargetSelect.h"
+#include "mlir/AsmParser/AsmParser.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
@@ -30,6 +31,7 @@
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
 #include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 #define DEBUG_TYPE "kernel-dispatch"
@@ -88,6 +90,17 @@ static llvm::cl::opt<bool> enableVectorPeeling(
     "iree-codegen-enable-vector-peeling",
     llvm::cl::desc("Enable peeling for vectorization"), llvm::cl::init(true));
 
+static llvm::cl::opt<std::string> clCPUCodegenTuningDatabase(
+    "iree-codegen-llvmcpu-tuning-database",
+    llvm::cl::desc(
+        "MLIR file containing a dictionary attribute that maps tuning keys of "
+        "root ops to #iree_codegen.compilation_info attributes to use instead "
+        "of the default heuristics. Keys have the form "
+        "`<target triple>:<op name>:<loop ranges>:<operand element types>`, "
+        "e.g. `x86_64-unknown-linux-gnu:linalg.matmul:384x128x512:"
+        "f32,f32,f32`"),
+    llvm::cl::init(""));
+
 // Non-static options are used in other places.
 llvm::cl::opt<std::string> clCPUCodegenTransformDialectFileName(
     "iree-codegen-llvmcpu-use-transform-dialect",
@@ -1246,6 +1259,17 @@ static bool isSupportedTransposeOp(linalg::GenericOp genericOp) {
            indexing_maps[1].isIdentity()));
 }
 
+/// Returns true if `entryPointFn` contains more than one op with reduction
+/// loops, as in the dispatches formed from fused reduction chains (such as a
+/// softmax).
+static bool hasMultipleReductionOps(func::FuncOp entryPointFn) {
+  int64_t numReductionOps = 0;
+  entryPointFn.walk([&](linalg::LinalgOp linalgOp) {
+    if (linalgOp.getNumReductionLoops() != 0) ++numReductionOps;
+  });
+  return numReductionOps > 1;
+}
+
 /// Sets the default lowering configuration for a generic op to use
 /// CPUDoubleTilingExpert pipeline.
 static LogicalResult setDefaultGenericOpRootConfig(
@@ -1270,6 +1294,19 @@ static LogicalResult setDefaultGenericOpRootConfig(
   // allocation limit See #9469 for example.
   SmallVector<int64_t> maxTileSizes(numLoops, defaultWorkgroupTileSize / 2);
 
+  // Dispatches with multiple reductions keep the intermediate results between
+  // the reductions live across the full reduction loops of a workgroup tile.
+  // Distribute with the minimum tile sizes along the parallel loops to bound
+  // those temporary allocations.
+  if (hasMultipleReductionOps(entryPointFn)) {
+    for (auto [index, iteratorType] :
+         llvm::enumerate(genericOp.getIteratorTypesArray())) {
+      if (iteratorType == utils::IteratorType::parallel) {
+        maxTileSizes[index] = minTileSizes[index];
+      }
+    }
+  }
+
   LLVM_DEBUG(KD_DBGS() << "Min tile sizes for distribution: " << minTileSizes
                        << "\n");
   LLVM_DEBUG(KD_DBGS() << "Max tile sizes for distribution: " << maxTileSizes
@@ -1789,6 +1826,66 @@ static LogicalResult setRootConfig(
   return setDefaultRootConfig(entryPointFn, partitionableLoopOp, lbs, ubs);
 }
 
+/// Sets the configuration for `iree_linalg_ext.attention`. Each workgroup
+/// processes a tile of query rows and the decomposition iterates over the keys
+/// and values with the same tile size, so the tile size is picked such that the
+/// query, key, value and accumulator tiles and the score tile of one iteration
+/// fit in the L1 cache.
+static LogicalResult setRootConfig(
+    func::FuncOp entryPointFn, IREE::LinalgExt::AttentionOp attnOp,
+    const TargetMLTransformInfo &targetMLTransInfo) {
+  assert(!getLoweringConfig(attnOp) && "expected lowering_config is not set");
+  ArrayRef<int64_t> queryShape = attnOp.getQueryType().getShape();
+  ArrayRef<int64_t> keyShape = attnOp.getKeyType().getShape();
+  Type elementType = attnOp.getQueryType().getElementType();
+  if (ShapedType::isDynamicShape(queryShape) ||
+      ShapedType::isDynamicShape(keyShape) || !elementType.isIntOrFloat()) {
+    return setRootConfig(entryPointFn, cast<TilingInterface>(*attnOp));
+  }
+
+  int64_t elementBytes = elementType.getIntOrFloatBitWidth() / 8;
+  int64_t headDim = queryShape[2];
+  auto getFootprintBytes = [&](int64_t tileSize) {
+    return elementBytes *
+           (4 * tileSize * headDim + tileSize * tileSize + 2 * tileSize);
+  };
+  std::optional<int64_t> sequenceTileSize;
+  for (int64_t tileSize = 128; tileSize >= 4; tileSize /= 2) {
+    if (queryShape[1] % tileSize != 0 || keyShape[1] % tileSize != 0) continue;
+    if (getFootprintBytes(tileSize) > targetMLTransInfo.defaultL1CacheSizeBytes)
+      continue;
+    sequenceTileSize = tileSize;
+    break;
+  }
+  if (!sequenceTileSize) {
+    return setRootConfig(entryPointFn, cast<TilingInterface>(*attnOp));
+  }
+
+  TileSizesListType tileSizes = {{1, *sequenceTileSize}};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, attnOp, tileSizes,
+      DispatchLoweringPassPipeline::CPUAttentionTileAndDecompose);
+}
+
+/// Sets the configuration for the Winograd input and output transform ops. The
+/// iteration domain of both ops is the batch and channel dimensions; each
+/// workgroup transforms the image tiles of a single image for a block of
+/// channels.
+template <typename WinogradOpTy>
+static LogicalResult setWinogradRootConfig(func::FuncOp entryPointFn,
+                                           WinogradOpTy winogradOp) {
+  assert(!getLoweringConfig(winogradOp) &&
+         "expected lowering_config is not set");
+  SmallVector<int64_t> workgroupTileSizes =
+      getLinalgExtDefaultWorkgroupTileSizes(
+          cast<TilingInterface>(winogradOp.getOperation()));
+  if (workgroupTileSizes[0] != 0) workgroupTileSizes[0] = 1;
+  TileSizesListType tileSizes = {workgroupTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, winogradOp, tileSizes,
+      DispatchLoweringPassPipeline::CPUWinogradTileAndDecompose);
+}
+
 /// Redirects to methods that set the configuration based on operation type.
 static LogicalResult setRootConfigImpl(
     func::FuncOp entryPointFn, Operation *op,
@@ -1806,6 +1903,12 @@ static LogicalResult setRootConfigImpl(
               linalg::PoolingNhwcMinUnsignedOp, linalg::PoolingNchwSumOp,
               linalg::PoolingNchwMaxOp, linalg::DepthwiseConv2DNhwcHwcOp>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
+        .Case<IREE::LinalgExt::AttentionOp>([&](auto op) {
+          return setRootConfig(entryPointFn, op, targetMLTransInfo);
+        })
+        .Case<IREE::LinalgExt::WinogradInputTransformOp,
+              IREE::LinalgExt::WinogradOutputTransformOp>(
+            [&](auto op) { return setWinogradRootConfig(entryPointFn, op); })
         .Case<tensor::UnPackOp>(
             [&](auto op) { return setUnPackOpRootConfig(entryPointFn, op); })
         .Case<linalg::ContractionOpInterface>(
@@ -1986,9 +2089,66 @@ static LogicalResult adjustTileSizesForUnPackOp(func::FuncOp entryPointFn,
                                                tileSizesList, pipeline);
 }
 
+/// Returns the key identifying `rootOp` in the tuning database (see
+/// `--iree-codegen-llvmcpu-tuning-database`). Returns std::nullopt for ops
+/// that are not tuned, i.e., non-Linalg ops and ops with dynamic shapes.
+static std::optional<std::string> getTuningKey(
+    IREE::HAL::ExecutableTargetAttr targetAttr, Operation *rootOp) {
+  auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp);
+  if (!linalgOp) return std::nullopt;
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  if (llvm::any_of(loopRanges, ShapedType::isDynamic)) return std::nullopt;
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  if (std::optional<StringAttr> triple =
+          getConfigStringAttr(targetAttr, "target_triple")) {
+    os << triple->getValue();
+  }
+  os << ":" << rootOp->getName() << ":";
+  llvm::interleave(loopRanges, os, "x");
+  os << ":";
+  llvm::interleave(
+      rootOp->getOperandTypes(), os,
+      [&](Type type) { os << getElementTypeOrSelf(type); }, ",");
+  return os.str();
+}
+
+/// Loads the tuning database specified with
+/// `--iree-codegen-llvmcpu-tuning-database`. Returns a null attribute if no
+/// database is specified.
+static FailureOr<DictionaryAttr> loadTuningDatabase(ModuleOp moduleOp) {
+  if (clCPUCodegenTuningDatabase.empty()) return DictionaryAttr();
+
+  std::string errorMessage;
+  std::unique_ptr<llvm::MemoryBuffer> file =
+      openInputFile(clCPUCodegenTuningDatabase, &errorMessage);
+  if (!file) {
+    return moduleOp.emitError()
+           << "failed to open tuning database '" << clCPUCodegenTuningDatabase
+           << "': " << errorMessage;
+  }
+  auto database = dyn_cast_or_null<DictionaryAttr>(
+      parseAttribute(file->getBuffer(), moduleOp.getContext()));
+  if (!database) {
+    return moduleOp.emitError()
+           << "expected tuning database '" << clCPUCodegenTuningDatabase
+           << "' to contain a dictionary attribute";
+  }
+  for (NamedAttribute entry : database) {
+    if (!isa<IREE::Codegen::CompilationInfoAttr>(entry.getValue())) {
+      return moduleOp.emitError()
+             << "expected tuning database entry '" << entry.getName().getValue()
+             << "' to be a #iree_codegen.compilation_info attribute";
+    }
+  }
+  return database;
+}
+
 /// Sets the translation information to use for a dispatch region.
 static LogicalResult setTranslationInfoAndRootConfig(
-    func::FuncOp entryPointFn, ArrayRef<Operation *> computeOps) {
+    func::FuncOp entryPointFn, ArrayRef<Operation *> computeOps,
+    DictionaryAttr tuningDatabase) {
   if (computeOps.empty()) {
     // No compute operations found. Allow to pass through without a config.
     return success();
@@ -2012,8 +2172,21 @@ static LogicalResult setTranslationInfoAndRootConfig(
   if (failed(rootOp)) return failure();
   Operation *rootOperation = rootOp.value();
 
+  // Prefer configurations found by tuning over the heuristics below.
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  if (rootOperation && tuningDatabase) {
+    if (std::optional<std::string> key =
+            getTuningKey(targetAttr, rootOperation)) {
+      if (auto compilationInfo =
+              tuningDatabase.getAs<IREE::Codegen::CompilationInfoAttr>(*key)) {
+        LLVM_DEBUG(KD_DBGS() << "using tuned config for " << *key << "\n");
+        return setUserConfig(entryPointFn, rootOperation, compilationInfo);
+      }
+      LLVM_DEBUG(KD_DBGS() << "no tuned config for " << *key << "\n");
+    }
+  }
+
   if (rootOperation) {
-    auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
     if (isVMVXBackend(targetAttr)) {
       if (failed(setVMVXRootConfigImpl(entryPointFn, rootOperation))) {
         return failure();
@@ -2049,6 +2222,9 @@ static LogicalResult setTranslationInfoAndRootConfig(
 }
 
 LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
+  FailureOr<DictionaryAttr> tuningDatabase = loadTuningDatabase(moduleOp);
+  if (failed(tuningDatabase)) return failure();
+
   llvm::StringMap<IREE::HAL::ExecutableExportOp> exportOps =
       getAllEntryPoints(moduleOp);
   for (auto funcOp : moduleOp.getOps<func::FuncOp>()) {
@@ -2068,7 +2244,8 @@ LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
     }
 
     SmallVector<Operation *> computeOps = getComputeOps(funcOp);
-    if (failed(setTranslationInfoAndRootConfig(funcOp, computeOps))) {
+    if (failed(setTranslationInfoAndRootConfig(funcOp, computeOps,
+                                               *tuningDatabase))) {
       return failure();
     }
   }
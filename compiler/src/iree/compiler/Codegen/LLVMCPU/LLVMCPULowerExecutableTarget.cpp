@@ -189,6 +189,9 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
           isX86(target) || isRISCV(target) ||
           (isAArch64(target) && hasAnySVEFeature(target));
       bool enableMicrokernels = hasMicrokernels(target);
+      bool vectorizeGatherAccesses =
+          hasAVX512fFeature(target) ||
+          (isAArch64(target) && hasAnySVEFeature(target));
       if (!testLoweringConfiguration) {
         switch (translationInfo.value().getDispatchLoweringPassPipeline()) {
           case IREE::Codegen::DispatchLoweringPassPipeline::CPUDefault:
@@ -205,7 +208,8 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
             addMultiTilingExpertPassPipeline(
                 executableLoweringPipeline,
                 static_cast<int>(TilingLevel::NumTileLevels),
-                /*enablePeeling=*/false, enableVectorMasking, lowerToAVX2);
+                /*enablePeeling=*/false, enableVectorMasking, lowerToAVX2,
+                vectorizeGatherAccesses);
             break;
           case IREE::Codegen::DispatchLoweringPassPipeline::
               CPUDoubleTilingPadExpert:
@@ -217,7 +221,8 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
             addMultiTilingExpertPassPipeline(
                 executableLoweringPipeline,
                 static_cast<int>(TilingLevel::NumTileLevels),
-                /*enablePeeling=*/true, enableVectorMasking, lowerToAVX2);
+                /*enablePeeling=*/true, enableVectorMasking, lowerToAVX2,
+                vectorizeGatherAccesses);
             break;
           case IREE::Codegen::DispatchLoweringPassPipeline::
               CPUConvTileAndDecomposeExpert:
@@ -231,6 +236,16 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
           case IREE::Codegen::DispatchLoweringPassPipeline::CPUDataTiling:
             addCPUDataTilingPipeline(executableLoweringPipeline);
             break;
+          case IREE::Codegen::DispatchLoweringPassPipeline::
+              CPUAttentionTileAndDecompose:
+            addCPUAttentionTileAndDecomposePassPipeline(
+                executableLoweringPipeline, enableVectorMasking);
+            break;
+          case IREE::Codegen::DispatchLoweringPassPipeline::
+              CPUWinogradTileAndDecompose:
+            addCPUWinogradTileAndDecomposePassPipeline(
+                executableLoweringPipeline, enableVectorMasking);
+            break;
           case IREE::Codegen::DispatchLoweringPassPipeline::VMVXDefault:
             addVMVXDefaultPassPipeline(executableLoweringPipeline,
                                        enableMicrokernels);
@@ -244,6 +259,7 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
             variantOp.emitOpError("Unsupported pipeline on CPU target.");
             return signalPassFailure();
         }
+        addCPUWorkgroupSwizzlePasses(executableLoweringPipeline);
       }
     }
   }
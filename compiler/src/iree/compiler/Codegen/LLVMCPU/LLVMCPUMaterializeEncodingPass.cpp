@@ -9,12 +9,15 @@
 #include "iree/compiler/Codegen/Common/EncodingInfo.h"
 #include "iree/compiler/Codegen/LLVMCPU/Utils.h"
 #include "iree/compiler/Codegen/PassDetail.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tensor/Transforms/Transforms.h"
+#include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -43,6 +46,15 @@ static MatmulTileParams chooseMatmulTileParamsAArch64(
         return {8, 4, 8};
       }
       return {8, 1, 8};
+    case MatmulType::F16F16F32:
+    case MatmulType::F16F16F16:
+    case MatmulType::BF16BF16F32:
+    case MatmulType::BF16BF16BF16:
+      // No optimized kernels yet, use the same tile sizes as f32.
+      return {8, 1, 8};
+    case MatmulType::I8I4I32:
+      // No optimized kernel yet. K0=2 keeps RHS tiles a whole number of bytes.
+      return {8, 2, 8};
     default:
       assert(false);
       return {};
@@ -64,6 +76,10 @@ static MatmulTileParams chooseMatmulTileParamsX86_64(
       // SSE fallback.
       return {8, 1, 4};
     case MatmulType::I8I8I32:
+      if (hasFeature(target, "+amx-int8") && hasFeature(target, "+avx512bw")) {
+        // Aim to use TDPBSSD, which takes groups of 4 int8 values along K.
+        return {16, 4, 16};
+      }
       if (hasFeature(target, "+avx512vnni")) {
         // Aim to use VPDPWSSD. This is the same tile size as with VPMADDWD
         // as the only difference is that VPDPWSSD accumulates. VPDPBUSD would
@@ -80,20 +96,171 @@ static MatmulTileParams chooseMatmulTileParamsX86_64(
       }
       // SSE fallback. Aim to use PMADDWD (xmm).
       return {8, 2, 4};
+    case MatmulType::F16F16F32:
+    case MatmulType::F16F16F16:
+      // Aim to use VCVTPH2PS and VFMADD231PS (zmm), accumulating in f32.
+      if (hasFeature(target, "+avx512f")) return {16, 1, 16};
+      return chooseMatmulTileParamsX86_64(MatmulType::F32F32F32, target);
+    case MatmulType::BF16BF16F32:
+    case MatmulType::BF16BF16BF16:
+      if (hasFeature(target, "+avx512bf16") ||
+          hasFeature(target, "+amx-bf16")) {
+        // Aim to use VDPBF16PS (zmm), or TDPBF16PS which uses the same tile
+        // layout.
+        return {16, 2, 16};
+      }
+      return chooseMatmulTileParamsX86_64(MatmulType::F32F32F32, target);
+    case MatmulType::I8I4I32:
+      // Same as i8i8i32 with VPMADDWD, after sign-extending the i4 values to
+      // i16. K0=2 keeps RHS tiles a whole number of bytes.
+      if (hasFeature(target, "+avx512bw")) return {16, 2, 16};
+      if (hasFeature(target, "+avx2")) return {8, 2, 8};
+      return {8, 2, 4};
     default:
       assert(false);
       return {};
   }
 }
 
+static MatmulTileParams chooseMatmulTileParamsRISCV(
+    MatmulType type, ExecutableTargetAttr target) {
+  if (!hasVFeature(target)) return chooseMatmulTileParamsGeneric();
+  switch (type) {
+    case MatmulType::F32F32F32:
+    case MatmulType::I8I8I32:
+      // Aim to use VFMACC/VWMACC with rows of 8 elements in LMUL=2 registers.
+      return {8, 1, 8};
+    default:
+      return chooseMatmulTileParamsGeneric();
+  }
+}
+
+static MatmulTileParams chooseMatmulTileParamsWasm(
+    MatmulType type, ExecutableTargetAttr target) {
+  if (!hasFeature(target, "+simd128")) return chooseMatmulTileParamsGeneric();
+  switch (type) {
+    case MatmulType::F32F32F32:
+      // Rows of 8 elements in two v128 registers. 4 rows keep the 8
+      // accumulators within the 16 xmm registers of x86-64 hosts.
+      return {4, 1, 8};
+    case MatmulType::I8I8I32:
+      // Aim to use I32X4.DOT_I16X8_S, which takes pairs of values along K.
+      return {4, 2, 8};
+    default:
+      return chooseMatmulTileParamsGeneric();
+  }
+}
+
+// Returns the name of the query_tile_sizes operation corresponding to `type`,
+// as in the OPERATION column of tuned_tile_sizes.inl.
+static StringRef getTunedOperationName(MatmulType type) {
+  switch (type) {
+    case MatmulType::F32F32F32:
+      return "MATMUL_F32F32F32";
+    case MatmulType::I8I8I32:
+      return "MATMUL_I8I8I32";
+    case MatmulType::F16F16F32:
+      return "MATMUL_F16F16F32";
+    case MatmulType::F16F16F16:
+      return "MATMUL_F16F16F16";
+    case MatmulType::BF16BF16F32:
+      return "MATMUL_BF16BF16F32";
+    case MatmulType::BF16BF16BF16:
+      return "MATMUL_BF16BF16BF16";
+    case MatmulType::I8I4I32:
+      return "MATMUL_I8I4I32";
+  }
+  return "";
+}
+
+// Returns true if `target` has all the CPU features of the named feature set,
+// as in the CPU_FEATURES column of tuned_tile_sizes.inl.
+static bool hasTunedFeatureSet(ExecutableTargetAttr target,
+                               StringRef featureSet) {
+  auto hasAll = [&](ArrayRef<StringRef> features) {
+    return llvm::all_of(features,
+                        [&](StringRef f) { return hasFeature(target, f); });
+  };
+  const StringRef avx512Base[] = {"+avx512f", "+avx512bw", "+avx512dq",
+                                  "+avx512vl", "+avx512cd"};
+  if (featureSet == "baseline") return true;
+  if (featureSet == "avx2_fma") return hasAll({"+avx2", "+fma"});
+  if (featureSet == "avx512_base") return hasAll(avx512Base);
+  if (featureSet == "avx512_vnni") {
+    return hasAll(avx512Base) && hasFeature(target, "+avx512vnni");
+  }
+  if (featureSet == "avx512_bf16") {
+    return hasAll(avx512Base) && hasFeature(target, "+avx512bf16");
+  }
+  if (featureSet == "amx_int8") {
+    return hasAll(avx512Base) && hasAll({"+amx-tile", "+amx-int8"});
+  }
+  if (featureSet == "amx_bf16") {
+    return hasAll(avx512Base) && hasAll({"+amx-tile", "+amx-bf16"});
+  }
+  if (featureSet == "dotprod") return hasFeature(target, "+dotprod");
+  if (featureSet == "i8mm") return hasFeature(target, "+i8mm");
+  return false;
+}
+
+// Returns the tile params tuned for the target CPU, if any. These come from the
+// same table as the runtime's iree_uk_query_tile_sizes_2d uses, keyed by the
+// LLVM CPU name here instead of the processor model at runtime.
+static std::optional<MatmulTileParams> chooseTunedMatmulTileParams(
+    MatmulType type, ExecutableTargetAttr target) {
+  std::optional<StringAttr> cpu = getConfigStringAttr(target, "cpu");
+  if (!cpu) return std::nullopt;
+  struct TunedEntry {
+    bool isX86_64;
+    StringRef llvmCpu;
+    StringRef operation;
+    StringRef cpuFeatures;
+    MatmulTileParams tileParams;
+  };
+  static const TunedEntry entries[] = {
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)       \
+  {false, LLVM_CPU, #OPERATION, #CPU_FEATURES, {M_, K_, N_}},
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)       \
+  {true, LLVM_CPU, #OPERATION, #CPU_FEATURES, {M_, K_, N_}},
+#include "iree/builtins/ukernel/tuned_tile_sizes.inl"
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64
+      // Terminator, keeping the array non-empty.
+      {false, "", "", "", {}},
+  };
+  if (!isX86_64(target) && !isAArch64(target)) return std::nullopt;
+  StringRef operation = getTunedOperationName(type);
+  for (const TunedEntry &entry : entries) {
+    if (entry.llvmCpu.empty()) break;
+    if (entry.isX86_64 == isX86_64(target) &&
+        entry.llvmCpu == cpu->getValue() && entry.operation == operation &&
+        hasTunedFeatureSet(target, entry.cpuFeatures)) {
+      return entry.tileParams;
+    }
+  }
+  return std::nullopt;
+}
+
 static MatmulTileParams chooseMatmulTileParams(MatmulType type,
                                                ExecutableTargetAttr target) {
+  if (std::optional<MatmulTileParams> tuned =
+          chooseTunedMatmulTileParams(type, target)) {
+    return *tuned;
+  }
   if (isAArch64(target)) {
     return chooseMatmulTileParamsAArch64(type, target);
   }
   if (isX86_64(target)) {
     return chooseMatmulTileParamsX86_64(type, target);
   }
+  if (isRISCV(target)) {
+    return chooseMatmulTileParamsRISCV(type, target);
+  }
+  if (isWasm(target)) {
+    return chooseMatmulTileParamsWasm(type, target);
+  }
   return chooseMatmulTileParamsGeneric();
 }
 
@@ -106,6 +273,17 @@ struct LLVMCPUMaterializeEncodingPass
   void runOnOperation() override;
 };
 
+struct LLVMCPUMaterializeHomogeneousEncodingsPass
+    : public LLVMCPUMaterializeHomogeneousEncodingsBase<
+          LLVMCPUMaterializeHomogeneousEncodingsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, AffineDialect, IREE::Flow::FlowDialect,
+                    IREE::LinalgExt::IREELinalgExtDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override;
+};
+
 }  // namespace
 
 void LLVMCPUMaterializeEncodingPass::runOnOperation() {
@@ -161,5 +339,34 @@ createLLVMCPUMaterializeEncodingPass() {
   return std::make_unique<LLVMCPUMaterializeEncodingPass>();
 }
 
+void LLVMCPUMaterializeHomogeneousEncodingsPass::runOnOperation() {
+  auto moduleOp = getOperation();
+
+  // Host code can only pick a layout if every dispatch consuming it agrees on
+  // it, which is only known when all devices share a single llvm-cpu target.
+  auto executableTargets =
+      IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(moduleOp);
+  if (executableTargets.size() != 1) return;
+  auto targetAttr = executableTargets.front();
+  if (targetAttr.getBackend().getValue() != "llvm-cpu") return;
+
+  // The per-function pass looks up the target from the closest
+  // hal.executable.target override so it is attached to the module while the
+  // host functions are materialized.
+  auto attrId = StringAttr::get(moduleOp.getContext(), "hal.executable.target");
+  moduleOp->setAttr(attrId, targetAttr);
+  OpPassManager passManager(moduleOp.getOperationName());
+  passManager.addNestedPass<func::FuncOp>(
+      createLLVMCPUMaterializeEncodingPass());
+  LogicalResult result = runPipeline(passManager, moduleOp);
+  moduleOp->removeAttr(attrId);
+  if (failed(result)) return signalPassFailure();
+}
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createLLVMCPUMaterializeHomogeneousEncodingsPass() {
+  return std::make_unique<LLVMCPUMaterializeHomogeneousEncodingsPass>();
+}
+
 }  // namespace iree_compiler
 }  // namespace mlir
@@ -62,6 +62,15 @@ static llvm::cl::opt<bool> clEnableReassociateFpReductions(
     llvm::cl::desc("Enables reassociation for FP reductions"),
     llvm::cl::init(false));
 
+// The task system hands out workgroups to workers in linear order so grouping
+// rows of workgroups makes concurrently executing tiles share LHS/RHS panels in
+// the shared caches.
+static llvm::cl::opt<unsigned> clWorkgroupSwizzleLogTile(
+    "iree-llvmcpu-workgroup-swizzle-log-tile",
+    llvm::cl::desc("log2 of the number of workgroup rows grouped together when "
+                   "linearizing 2-D workgroup grids (0 disables swizzling)"),
+    llvm::cl::init(0));
+
 static llvm::cl::opt<bool> clInstrumentMemoryAccesses{
     "iree-llvmcpu-instrument-memory-accesses",
     llvm::cl::desc("Instruments memory accesses in dispatches when dispatch "
@@ -427,7 +436,8 @@ void addVMVXDefaultPassPipeline(OpPassManager &passManager,
 void addMultiTilingExpertPassPipeline(OpPassManager &passManager,
                                       int64_t numLevels, bool enablePeeling,
                                       bool enableVectorMasking,
-                                      bool lowerToAVX2) {
+                                      bool lowerToAVX2,
+                                      bool vectorizeGatherAccesses) {
   addTileAndDistributePasses(passManager);
 
   OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
@@ -467,8 +477,10 @@ void addMultiTilingExpertPassPipeline(OpPassManager &passManager,
     nestedModulePM.addNestedPass<func::FuncOp>(createCSEPass());
     LLVMCPUVectorizationPassOptions options;
     options.enableVectorMasking = enableVectorMasking;
-    // TODO(#13036): Re-enable once debugged.
-    options.vectorizeGatherAccesses = false;
+    // Embedding lookups and other gathers are only vectorized on targets with
+    // hardware gather instructions; elsewhere the gathers would be scalarized.
+    // TODO(#13036): Re-enable for all targets once debugged.
+    options.vectorizeGatherAccesses = vectorizeGatherAccesses;
     nestedModulePM.addNestedPass<func::FuncOp>(
         createLLVMCPUVectorizationPass(options));
     nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
@@ -601,6 +613,58 @@ void addCPUDataTilingPipeline(OpPassManager &passManager) {
       createSplitFullPartialTransferPass("linalg-copy"));
 }
 
+/// Vectorizes, bufferizes and lowers the ops produced by decomposing a
+/// LinalgExt op during tile and distribute.
+static void addDecomposedOpsVectorizationPasses(OpPassManager &passManager,
+                                                bool enableVectorMasking) {
+  OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
+  nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+  nestedModulePM.addNestedPass<func::FuncOp>(createCSEPass());
+  {
+    LLVMCPUVectorizationPassOptions options;
+    options.enableVectorMasking = enableVectorMasking;
+    // TODO(#13036): Re-enable once debugged.
+    options.vectorizeGatherAccesses = false;
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        createLLVMCPUVectorizationPass(options));
+    nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+    nestedModulePM.addNestedPass<func::FuncOp>(createCSEPass());
+  }
+  nestedModulePM.addNestedPass<func::FuncOp>(
+      createOptimizeVectorTransferPass(/*flatten=*/false));
+
+  addBufferizePasses(nestedModulePM);
+
+  // Run IREE specific passes before vector lowering expert.
+  nestedModulePM.addNestedPass<func::FuncOp>(
+      createRemoveSingleIterationLoopPass());
+
+  {
+    LLVMCPUVectorLoweringPassOptions options;
+    options.splitVectorTransfersTo = "linalg-copy";
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        createLLVMCPUVectorLoweringPass(options));
+  }
+}
+
+void addCPUAttentionTileAndDecomposePassPipeline(OpPassManager &passManager,
+                                                 bool enableVectorMasking) {
+  // Distribution tiles the query rows and decomposes the attention op into a
+  // loop over key/value tiles of the same size that carries the running max
+  // and sum of the online softmax.
+  addTileAndDistributePasses(passManager);
+  addDecomposedOpsVectorizationPasses(passManager, enableVectorMasking);
+}
+
+void addCPUWinogradTileAndDecomposePassPipeline(OpPassManager &passManager,
+                                                bool enableVectorMasking) {
+  // Distribution tiles the batch and channel dimensions and decomposes the
+  // Winograd transform ops into loops over the image tiles, each transforming
+  // a single input tile with two small matmuls against constant matrices.
+  addTileAndDistributePasses(passManager);
+  addDecomposedOpsVectorizationPasses(passManager, enableVectorMasking);
+}
+
 void addCPUDefaultPassPipeline(OpPassManager &passManager) {
   addTileAndDistributePasses(passManager);
   OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
@@ -614,6 +678,21 @@ void addCPUDefaultPassPipeline(OpPassManager &passManager) {
   }
 }
 
+void addCPUWorkgroupSwizzlePasses(OpPassManager &passManager) {
+  if (clWorkgroupSwizzleLogTile == 0) return;
+  // The swizzle only remaps the last workgroup ID op of each dimension so
+  // duplicates must be CSE'd first. It also runs after the pipelines have
+  // removed single-iteration workgroup loops as those are only recognized when
+  // their bounds use the raw workgroup IDs.
+  OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
+  nestedModulePM.addPass(createCanonicalizerPass());
+  nestedModulePM.addPass(createCSEPass());
+  nestedModulePM.addNestedPass<func::FuncOp>(
+      createWorkGroupSwizzle(clWorkgroupSwizzleLogTile));
+  nestedModulePM.addPass(createCanonicalizerPass());
+  nestedModulePM.addPass(createCSEPass());
+}
+
 void addTransformDialectPasses(OpPassManager &passManager) {
   // Give control to the transform dialect.
   passManager.addPass(
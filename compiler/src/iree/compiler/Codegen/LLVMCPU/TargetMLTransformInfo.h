@@ -20,6 +20,9 @@ struct TargetMLTransformInfo {
   unsigned defaultMaxUnrollFactor = 8;
   unsigned defaultMaxTransposeUnrollFactor =
       std::numeric_limits<unsigned>::max();
+  // Size of the per-core L1 data cache used to size the working set of tiles
+  // that are reused across an inner loop.
+  int64_t defaultL1CacheSizeBytes = 32 * 1024;
 
   static const TargetMLTransformInfo getTargetMLTransformInfo(
       IREE::HAL::ExecutableTargetAttr targetAttr);
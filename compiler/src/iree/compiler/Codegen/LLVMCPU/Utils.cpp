@@ -41,6 +41,11 @@ bool isRISCV(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return triple && triple.value().isRISCV();
 }
 
+bool isWasm(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  std::optional<llvm::Triple> triple = getTargetTriple(targetAttr);
+  return triple && triple.value().isWasm();
+}
+
 bool preferIntrinsicsOverAsm(IREE::HAL::ExecutableTargetAttr targetAttr) {
   auto intrinsicsAttr =
       getConfigBoolAttr(targetAttr, "prefer_intrinsics_over_asm");
@@ -74,6 +79,10 @@ bool hasAVX2Feature(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return hasFeature(targetAttr, "+avx2");
 }
 
+bool hasAVX512fFeature(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  return hasFeature(targetAttr, "+avx512f");
+}
+
 bool hasVFeature(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return hasFeature(targetAttr, "+v");
 }
@@ -21,6 +21,7 @@ bool isX86(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isX86_64(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isAArch64(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isRISCV(IREE::HAL::ExecutableTargetAttr targetAttr);
+bool isWasm(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool preferIntrinsicsOverAsm(IREE::HAL::ExecutableTargetAttr targetAttr);
 
 /// Returns true if `targetAttr` has `feature` in its CPU features.
@@ -29,6 +30,9 @@ bool hasFeature(IREE::HAL::ExecutableTargetAttr targetAttr, StringRef feature);
 /// Returns true if the 'targetAttr' contains '+avx2' in its cpu features.
 bool hasAVX2Feature(IREE::HAL::ExecutableTargetAttr targetAttr);
 
+/// Returns true if the 'targetAttr' contains '+avx512f' in its cpu features.
+bool hasAVX512fFeature(IREE::HAL::ExecutableTargetAttr targetAttr);
+
 /// Returns true if the 'targetAttr' contains '+v' in its cpu features.
 bool hasVFeature(IREE::HAL::ExecutableTargetAttr targetAttr);
 
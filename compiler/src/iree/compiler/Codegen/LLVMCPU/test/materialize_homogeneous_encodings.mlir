@@ -0,0 +1,50 @@
+// RUN: iree-opt --iree-llvmcpu-materialize-homogeneous-encodings --split-input-file %s | FileCheck %s
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-aarch64", {target_triple = "aarch64-none-elf"}>
+#device_target = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target]}>
+module attributes {hal.device.targets = [#device_target]} {
+  func.func @set_encoding(%arg0: tensor<16x32xf32>) -> tensor<16x32xf32> {
+    %0 = iree_linalg_ext.set_encoding %arg0 : tensor<16x32xf32> -> tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>>
+    %1 = iree_linalg_ext.unset_encoding %0 : tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>> -> tensor<16x32xf32>
+    return %1 : tensor<16x32xf32>
+  }
+}
+//      CHECK: module attributes {hal.device.targets
+//  CHECK-NOT:   hal.executable.target
+//      CHECK: func.func @set_encoding(%[[ARG0:.+]]: tensor<16x32xf32>)
+//      CHECK:   %[[PACK:.+]] = tensor.pack %[[ARG0]]
+// CHECK-SAME:       outer_dims_perm = [1, 0] inner_dims_pos = [1, 0] inner_tiles = [8, 1]
+// CHECK-SAME:       -> tensor<4x16x8x1xf32>
+//      CHECK:   %[[UNPACK:.+]] = tensor.unpack %[[PACK]]
+//      CHECK:   return %[[UNPACK]]
+
+// -----
+
+#executable_target_arm = #hal.executable.target<"llvm-cpu", "embedded-elf-aarch64", {target_triple = "aarch64-none-elf"}>
+#executable_target_x86 = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf"}>
+#device_target = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_arm, #executable_target_x86]}>
+module attributes {hal.device.targets = [#device_target]} {
+  func.func @heterogeneous(%arg0: tensor<16x32xf32>) -> tensor<16x32xf32> {
+    %0 = iree_linalg_ext.set_encoding %arg0 : tensor<16x32xf32> -> tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>>
+    %1 = iree_linalg_ext.unset_encoding %0 : tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>> -> tensor<16x32xf32>
+    return %1 : tensor<16x32xf32>
+  }
+}
+// CHECK-LABEL: func.func @heterogeneous
+//       CHECK:   iree_linalg_ext.set_encoding
+//   CHECK-NOT:   tensor.pack
+
+// -----
+
+#executable_target = #hal.executable.target<"vmvx", "vmvx-bytecode-fb">
+#device_target = #hal.device.target<"vmvx", {executable_targets = [#executable_target]}>
+module attributes {hal.device.targets = [#device_target]} {
+  func.func @non_llvm_cpu(%arg0: tensor<16x32xf32>) -> tensor<16x32xf32> {
+    %0 = iree_linalg_ext.set_encoding %arg0 : tensor<16x32xf32> -> tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>>
+    %1 = iree_linalg_ext.unset_encoding %0 : tensor<16x32xf32, #iree_linalg_ext.encoding<MATMUL_F32F32F32_RHS>> -> tensor<16x32xf32>
+    return %1 : tensor<16x32xf32>
+  }
+}
+// CHECK-LABEL: func.func @non_llvm_cpu
+//       CHECK:   iree_linalg_ext.set_encoding
+//   CHECK-NOT:   tensor.pack
@@ -1651,3 +1651,79 @@ hal.executable private @quant_model {
 // CHECK-SAME:     translation_info = #[[TRANSLATION]]
 //      CHECK:   linalg.matmul
 // CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+hal.executable private @attention  {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm-cpu", "system-elf-x86_64", {
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    target_triple = "x86_64-unknown-linux-gnu"
+  }> {
+    hal.executable.export @attention layout(#pipeline_layout)
+    builtin.module {
+      func.func @attention() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<16x1024x64xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %7 = tensor.empty() : tensor<16x1024x64xf32>
+        %8 = iree_linalg_ext.attention ins(%4, %5, %6 : tensor<16x1024x64xf32>, tensor<16x1024x64xf32>, tensor<16x1024x64xf32>) outs(%7 : tensor<16x1024x64xf32>) -> tensor<16x1024x64xf32>
+        flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : tensor<16x1024x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<16x1024x64xf32>>
+        return
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 16]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPUAttentionTileAndDecompose>
+//      CHECK: hal.executable.export public @attention
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   iree_linalg_ext.attention
+// CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+hal.executable private @winograd_input_transform  {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm-cpu", "system-elf-x86_64", {
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    target_triple = "x86_64-unknown-linux-gnu"
+  }> {
+    hal.executable.export @winograd_input_transform layout(#pipeline_layout)
+    builtin.module {
+      func.func @winograd_input_transform() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<2x10x10x128xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<8x8x2x2x2x128xf32>>
+        %2 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0, 0], sizes = [2, 10, 10, 128], strides = [1, 1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<2x10x10x128xf32>> -> tensor<2x10x10x128xf32>
+        %3 = tensor.empty() : tensor<8x8x2x2x2x128xf32>
+        %4 = iree_linalg_ext.winograd.input_transform output_tile_size(6) kernel_size(3) image_dimensions([1, 2]) ins(%2 : tensor<2x10x10x128xf32>) outs(%3 : tensor<8x8x2x2x2x128xf32>) -> tensor<8x8x2x2x2x128xf32>
+        flow.dispatch.tensor.store %4, %1, offsets = [0, 0, 0, 0, 0, 0], sizes = [8, 8, 2, 2, 2, 128], strides = [1, 1, 1, 1, 1, 1] : tensor<8x8x2x2x2x128xf32> -> !flow.dispatch.tensor<writeonly:tensor<8x8x2x2x2x128xf32>>
+        return
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 64]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPUWinogradTileAndDecompose>
+//      CHECK: hal.executable.export public @winograd_input_transform
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   iree_linalg_ext.winograd.input_transform
+// CHECK-SAME:       lowering_config = #[[CONFIG]]
@@ -0,0 +1,8 @@
+// Tuning database used by materialize_tuned_launch_configuration.mlir.
+{
+  "x86_64-unknown-unknown-eabi-elf:linalg.matmul:384x128x512:f32,f32,f32" =
+    #iree_codegen.compilation_info<
+      lowering_config = <tile_sizes = [[64, 32, 0], [16, 16, 0], [0, 0, 8]]>,
+      translation_info = <CPUDoubleTilingExpert>,
+      workgroup_size = []>
+}
@@ -95,3 +95,39 @@ module attributes {hal.device.targets = [#hal.device.target<"llvm-cpu", {executa
 
 // CHECK-LABEL: func.func @main_dispatch_77_generic_1x257x257x21
 //     CHECK-8: vector.load
+
+// -----
+
+hal.executable private @embedding_gather {
+  hal.executable.variant public @embedded_elf_x86_64, target = <"llvm-cpu", "embedded-elf-x86_64", {cpu = "cascadelake", cpu_features = "+avx,+avx2,+fma,+avx512f", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 64 : index, target_triple = "x86_64-unknown-unknown-eabi-elf"}> {
+    hal.executable.export public @embedding_gather ordinal(0) layout(#hal.pipeline.layout<push_constants = 0, sets = [<0, bindings = [<0, storage_buffer, ReadOnly>, <1, storage_buffer, ReadOnly>, <2, storage_buffer>]>]>) {
+    ^bb0(%arg0: !hal.device, %arg1: index):
+      %x, %y, %z = flow.dispatch.workgroup_count_from_dag_root %arg1
+      hal.return %x, %y, %z : index, index, index
+    }
+    builtin.module {
+      func.func @embedding_gather() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<65536xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<1024xi32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<1024xf32>>
+        %table = flow.dispatch.tensor.load %0, offsets = [0], sizes = [65536], strides = [1] : !flow.dispatch.tensor<readonly:tensor<65536xf32>> -> tensor<65536xf32>
+        %indices = flow.dispatch.tensor.load %1, offsets = [0], sizes = [1024], strides = [1] : !flow.dispatch.tensor<readonly:tensor<1024xi32>> -> tensor<1024xi32>
+        %3 = tensor.empty() : tensor<1024xf32>
+        %4 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%indices : tensor<1024xi32>) outs(%3 : tensor<1024xf32>) {
+        ^bb0(%in: i32, %out: f32):
+          %5 = arith.index_cast %in : i32 to index
+          %6 = tensor.extract %table[%5] : tensor<65536xf32>
+          linalg.yield %6 : f32
+        } -> tensor<1024xf32>
+        flow.dispatch.tensor.store %4, %2, offsets = [0], sizes = [1024], strides = [1] : tensor<1024xf32> -> !flow.dispatch.tensor<writeonly:tensor<1024xf32>>
+        return
+      }
+    }
+  }
+}
+
+// Gathers are vectorized on targets with hardware gather instructions.
+
+// CHECK-LABEL: func.func @embedding_gather
+//       CHECK:   vector.gather
@@ -0,0 +1,64 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(hal.executable(hal.executable.variant(iree-llvmcpu-lower-executable-target)))' --iree-llvmcpu-workgroup-swizzle-log-tile=2 %s | FileCheck %s
+
+// Checks that the workgroup IDs are swizzled once the distributed loops have
+// been simplified: the 4x3 grid exactly covers the matmul so both workgroup
+// loops must still be removed and all uses must see the swizzled IDs.
+#compilation = #iree_codegen.compilation_info<
+    lowering_config = <tile_sizes = [[32, 32], [8, 32, 0], [0, 0, 16]]>,
+    translation_info  = <CPUDoubleTilingExpert>,
+    workgroup_size = []>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {
+  cpu_features = "",
+  data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+  native_vector_size = 16 : index,
+  target_triple = "x86_64-unknown-unknown-eabi-elf"}>
+hal.executable private @matmul_swizzle {
+  hal.executable.variant public @embedded_elf_x86_64, target = #executable_target_embedded_elf_x86_64_ {
+    hal.executable.export public @matmul_swizzle ordinal(0) layout(#pipeline_layout) {
+    ^bb0(%arg0: !hal.device):
+      %x, %y, %z = flow.dispatch.workgroup_count_from_dag_root
+      hal.return %x, %y, %z : index, index, index
+    }
+    builtin.module {
+      func.func @matmul_swizzle() {
+        %cst = arith.constant 0.000000e+00 : f32
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<128x80xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<80x96xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<128x96xf32>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [128, 80], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<128x80xf32>> -> tensor<128x80xf32>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [80, 96], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<80x96xf32>> -> tensor<80x96xf32>
+        %5 = tensor.empty() : tensor<128x96xf32>
+        %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<128x96xf32>) -> tensor<128x96xf32>
+        %7 = linalg.matmul {compilation_info = #compilation}
+          ins(%3, %4 : tensor<128x80xf32>, tensor<80x96xf32>)
+          outs(%6 : tensor<128x96xf32>) -> tensor<128x96xf32>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [128, 96], strides = [1, 1] : tensor<128x96xf32> -> !flow.dispatch.tensor<writeonly:tensor<128x96xf32>>
+        return
+      }
+    }
+  }
+}
+// CHECK-LABEL: func.func @matmul_swizzle
+//   CHECK-DAG:   %[[C4:.+]] = arith.constant 4 : index
+//   CHECK-DAG:   %[[ID_X:.+]] = hal.interface.workgroup.id[0] : index
+//   CHECK-DAG:   %[[ID_Y:.+]] = hal.interface.workgroup.id[1] : index
+//   CHECK-NOT:   hal.interface.workgroup.id
+//   CHECK-DAG:   arith.remui %[[ID_Y]], %[[C4]] : index
+//   CHECK-DAG:   arith.divui %[[ID_Y]], %[[C4]] : index
+//       CHECK:   %[[SWZ_X:.+]] = arith.select %{{.+}}, %[[ID_X]], %{{.+}} : index
+//       CHECK:   %[[SWZ_Y:.+]] = arith.select %{{.+}}, %[[ID_Y]], %{{.+}} : index
+//   CHECK-DAG:   affine.apply {{.+}}%[[SWZ_Y]]]
+//   CHECK-DAG:   affine.apply {{.+}}%[[SWZ_X]]]
+//   CHECK-NOT:   affine.apply {{.+}}%[[ID_X]]]
+//   CHECK-NOT:   affine.apply {{.+}}%[[ID_Y]]]
+//   CHECK-NOT:   scf.for {{.+}} to %c128
+//   CHECK-NOT:   scf.for {{.+}} to %c96
+//       CHECK:   vector.outerproduct
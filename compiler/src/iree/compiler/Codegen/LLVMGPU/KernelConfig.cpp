@@ -76,6 +76,9 @@ struct TargetInfo {
   // TODO: add finer grain control for other tensorcore types.
   bool hasTF32TensorCore = false;
   bool hasWarpShuffle = false;
+  // sm_90 and newer have enough shared memory per SM to keep more and larger
+  // stages of the copy pipeline in flight.
+  bool hasSM90TensorCore = false;
 };
 
 struct TileWorkgroupSizePair {
@@ -109,8 +112,9 @@ static void getMatmulConfig(SmallVectorImpl<TileWorkgroupSizePair> &tileSizes) {
 /// Return the best combination of tile size and wg size when using tensorcore
 /// operations.
 static void getTensorCoreConfig(
-    SmallVectorImpl<TileWorkgroupSizePair> &tileSizes, bool isFp16, int64_t M,
-    int64_t N, int64_t K) {
+    SmallVectorImpl<TileWorkgroupSizePair> &tileSizes,
+    const TargetInfo &targetInfo, bool isFp16, int64_t M, int64_t N,
+    int64_t K) {
   // Based on early analysis we found that 128x256x32_3 gives acceptable
   // performance across many of the large matrix sizes for f16 and fp32. This
   // needs to be refined into a better startegy based on empircal data but this
@@ -119,6 +123,18 @@ static void getTensorCoreConfig(
   int64_t parallelDim = M * N;
   static constexpr int64_t kLargDimThreashold = 1536;
   if (isFp16) {
+    if (targetInfo.hasSM90TensorCore) {
+      // Deeper pipelines and a larger K tile hide more of the global memory
+      // latency while staying within the shared memory allocation limit.
+      if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
+        tileSizes.push_back(
+            TileWorkgroupSizePair({{128, 256, 32}, {128, 2, 1}, 5}));
+        tileSizes.push_back(
+            TileWorkgroupSizePair({{128, 128, 64}, {64, 2, 1}, 4}));
+      }
+      tileSizes.push_back(
+          TileWorkgroupSizePair({{64, 128, 64}, {64, 2, 1}, 4}));
+    }
     if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
       tileSizes.push_back(
           TileWorkgroupSizePair({{128, 256, 32}, {128, 2, 1}, 3}));
@@ -180,6 +196,7 @@ static TargetInfo getTargetInfo(func::FuncOp entryPoint) {
   }
   int64_t smVersion = version.getZExtValue();
   if (smVersion >= 80) info.hasTF32TensorCore = true;
+  if (smVersion >= 90) info.hasSM90TensorCore = true;
   return info;
 }
 
@@ -319,7 +336,8 @@ static LogicalResult setContractConfig(func::FuncOp entryPoint,
                         .cast<RankedTensorType>()
                         .getElementType()
                         .isF16();
-      getTensorCoreConfig(TCtileSizeConfig, isFp16, sizeM, sizeN, sizeK);
+      getTensorCoreConfig(TCtileSizeConfig, targetInfo, isFp16, sizeM, sizeN,
+                          sizeK);
       // Pick the best configuration where the original shape is aligned on the
       // tile size.
       for (TileWorkgroupSizePair &config : TCtileSizeConfig) {
@@ -451,6 +469,32 @@ static LogicalResult setSortConfig(func::FuncOp entryPoint, Operation *op) {
       workgroupSize);
 }
 
+/// Sets the config for `iree_linalg_ext.attention`. Each workgroup computes a
+/// tile of query rows of one batch and iterates over the keys in tiles of the
+/// same size, so the score tile is sequence tile x sequence tile.
+static LogicalResult setAttentionConfig(func::FuncOp entryPoint,
+                                        IREE::LinalgExt::AttentionOp op) {
+  const int64_t sequenceTileSize = 128;
+  ArrayRef<int64_t> queryShape = op.getQueryType().getShape();
+  ArrayRef<int64_t> keyShape = op.getKeyType().getShape();
+  if (ShapedType::isDynamicShape(queryShape) ||
+      ShapedType::isDynamicShape(keyShape)) {
+    return failure();
+  }
+  // The decomposition steps over the keys by the query tile size, so both
+  // sequence lengths need to be multiples of it.
+  if (queryShape[1] % sequenceTileSize != 0 ||
+      keyShape[1] % sequenceTileSize != 0) {
+    return failure();
+  }
+  TileSizesListType tileSizes = {{1, sequenceTileSize}};
+  std::array<int64_t, 3> workgroupSize = {sequenceTileSize, 1, 1};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes,
+      IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUAttention,
+      workgroupSize);
+}
+
 static SmallVector<int64_t> getDefaultWorkgroupTileSizesForPackUnPack(
     TilingInterface op, int64_t defaultSize) {
   unsigned numLoops = op.getLoopIteratorTypes().size();
@@ -690,6 +734,25 @@ static LogicalResult setWarpReductionConfig(func::FuncOp entryPoint,
     return failure();
   if (op.getRegionOutputArgs().size() != 1) return failure();
 
+  // Dispatches formed from fused reduction chains (such as a softmax) contain
+  // multiple reductions that all share this configuration, so they must
+  // reduce along the same dimension of the same iteration space.
+  SmallVector<int64_t> loopRanges = op.getStaticLoopRanges();
+  bool hasIncompatibleReduction = false;
+  entryPoint.walk([&](linalg::LinalgOp otherOp) {
+    if (otherOp.getOperation() == op.getOperation() ||
+        otherOp.getNumReductionLoops() == 0) {
+      return;
+    }
+    SmallVector<unsigned> otherReductionDims;
+    otherOp.getReductionDims(otherReductionDims);
+    if (otherReductionDims != reductionDims ||
+        otherOp.getStaticLoopRanges() != loopRanges) {
+      hasIncompatibleReduction = true;
+    }
+  });
+  if (hasIncompatibleReduction) return failure();
+
   // Only support projected permutation, this could be extended to projected
   // permutated with broadcast.
   if (llvm::any_of(op.getDpsInputOperands(), [&](OpOperand *input) {
@@ -1027,6 +1090,11 @@ static LogicalResult setRootConfig(func::FuncOp entryPointFn,
   if (auto packOp = dyn_cast<tensor::PackOp>(computeOp)) {
     return setPackConfig(entryPointFn, packOp);
   }
+  if (auto attentionOp = dyn_cast<IREE::LinalgExt::AttentionOp>(computeOp)) {
+    if (succeeded(setAttentionConfig(entryPointFn, attentionOp))) {
+      return success();
+    }
+  }
 
   return setRootDefaultConfig(entryPointFn, computeOp);
 }
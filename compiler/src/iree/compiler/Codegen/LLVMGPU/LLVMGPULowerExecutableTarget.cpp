@@ -178,6 +178,9 @@ void LLVMGPULowerExecutableTargetPass::runOnOperation() {
       case IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUPackUnPack:
         addGPUPackUnPackPasses(executableLoweringPipeline);
         break;
+      case IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUAttention:
+        addGPUAttentionPassPipeline(executableLoweringPipeline);
+        break;
       // Transform-dialect pipelines.
       case IREE::Codegen::DispatchLoweringPassPipeline::TransformDialectCodegen:
         addGPUTransformDialectPasses(executableLoweringPipeline);
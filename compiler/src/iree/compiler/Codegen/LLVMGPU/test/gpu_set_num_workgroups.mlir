@@ -680,6 +680,52 @@ hal.executable.variant public @cuda_nvptx_fb, target = <"cuda", "cuda-nvptx-fb",
 
 // -----
 
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable @user_config {
+hal.executable.variant public @cuda_nvptx_fb, target = <"cuda", "cuda-nvptx-fb", {target_arch = "sm_90"}> {
+  hal.executable.export public @large_matmul_f16_sm90 layout(#pipeline_layout)
+  builtin.module {
+    func.func @large_matmul_f16_sm90() {
+      %cst = arith.constant 0.000000e+00 : f16
+      %c128 = arith.constant 128 : index
+      %c1024 = arith.constant 1024 : index
+      %c0 = arith.constant 0 : index
+      %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<2560x1792xf16>>
+      %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<1792x2048xf16>>
+      %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<2560x2048xf16>>
+      %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [2560, 1792], strides = [1, 1]
+          : !flow.dispatch.tensor<readonly:tensor<2560x1792xf16>> -> tensor<2560x1792xf16>
+      %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [1792, 2048], strides = [1, 1]
+          : !flow.dispatch.tensor<readonly:tensor<1792x2048xf16>> -> tensor<1792x2048xf16>
+      %15 = tensor.empty() : tensor<2560x2048xf16>
+      %16 = linalg.fill ins(%cst : f16) outs(%15 : tensor<2560x2048xf16>) -> tensor<2560x2048xf16>
+      %17 = linalg.matmul
+          ins(%3, %4 : tensor<2560x1792xf16>, tensor<1792x2048xf16>) outs(%16 : tensor<2560x2048xf16>) -> tensor<2560x2048xf16>
+      flow.dispatch.tensor.store %17, %2, offsets = [0, 0], sizes = [2560, 2048], strides = [1, 1] : tensor<2560x2048xf16> -> !flow.dispatch.tensor<writeonly:tensor<2560x2048xf16>>
+      return
+    }
+  }
+}
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[128, 256, 32]{{\]}}
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<LLVMGPUMatmulTensorCoreMmaSync pipeline_depth = 5>
+//      CHECK: hal.executable.export public @large_matmul_f16_sm90
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+// CHECK-SAME:     workgroup_size = [128 : index, 2 : index, 1 : index]
+//      CHECK: linalg.fill
+// CHECK-SAME:     lowering_config = #[[CONFIG]]
+//      CHECK: linalg.matmul
+// CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
 #pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
   #hal.descriptor_set.layout<0, bindings = [
     #hal.descriptor_set.binding<0, storage_buffer>,
@@ -772,3 +818,44 @@ hal.executable @inner_unit_dim {
 //      CHECK: func.func @inner_unit_dim
 //      CHECK:   linalg.generic
 // CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+hal.executable private @attention {
+  hal.executable.variant @cuda, target = <"cuda", "cuda-nvptx-fb"> {
+    hal.executable.export @attention layout(#pipeline_layout)
+    builtin.module {
+      func.func @attention() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<16x1024x64xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<16x1024x64xf32>> -> tensor<16x1024x64xf32>
+        %7 = tensor.empty() : tensor<16x1024x64xf32>
+        %8 = iree_linalg_ext.attention ins(%4, %5, %6 : tensor<16x1024x64xf32>, tensor<16x1024x64xf32>, tensor<16x1024x64xf32>) outs(%7 : tensor<16x1024x64xf32>) -> tensor<16x1024x64xf32>
+        flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [16, 1024, 64], strides = [1, 1, 1] : tensor<16x1024x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<16x1024x64xf32>>
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 128]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<LLVMGPUAttention>
+//      CHECK: hal.executable.export public @attention
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+// CHECK-SAME:     workgroup_size = [128 : index, 1 : index, 1 : index]
+//      CHECK: func.func @attention
+//      CHECK:   iree_linalg_ext.attention
+// CHECK-SAME:       lowering_config = #[[CONFIG]]
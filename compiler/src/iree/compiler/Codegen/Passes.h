@@ -383,6 +383,13 @@ std::unique_ptr<OperationPass<>> createLLVMCPULowerToUKernelsPass();
 std::unique_ptr<OperationPass<func::FuncOp>>
 createLLVMCPUMaterializeEncodingPass();
 
+/// Materialize the encodings of host functions outside of executables using the
+/// llvm-cpu layout. This is a no-op unless the module targets a single
+/// llvm-cpu executable target, as otherwise dispatches may disagree on the
+/// layout of the encoded tensors they share.
+std::unique_ptr<OperationPass<ModuleOp>>
+createLLVMCPUMaterializeHomogeneousEncodingsPass();
+
 /// Synchronizes LLVM linkage with MLIR symbol visibility.
 std::unique_ptr<OperationPass<ModuleOp>>
 createLLVMCPUSynchronizeSymbolVisibilityPass();
@@ -421,6 +428,21 @@ void addCPUDefaultPassPipeline(OpPassManager &passManager);
 /// Populates the passes to lower ops through data tiling transformations.
 void addCPUDataTilingPipeline(OpPassManager &passManager);
 
+/// Populates the passes that swizzle workgroup IDs when
+/// `--iree-llvmcpu-workgroup-swizzle-log-tile` is set. Must be added after one
+/// of the CPU lowering pipelines.
+void addCPUWorkgroupSwizzlePasses(OpPassManager &passManager);
+
+/// Populates the passes to lower `iree_linalg_ext.attention` to a loop over
+/// key/value tiles with an online softmax followed by vectorization.
+void addCPUAttentionTileAndDecomposePassPipeline(OpPassManager &passManager,
+                                                 bool enableVectorMasking);
+
+/// Populates the passes to lower the Winograd input and output transform ops
+/// to loops over image tiles followed by vectorization.
+void addCPUWinogradTileAndDecomposePassPipeline(OpPassManager &passManager,
+                                                bool enableVectorMasking);
+
 /// Populates the passes to lower to tiled/distributed/bufferized ops,
 /// suitable for library call dispatch and lowering to loops.
 void addVMVXDefaultPassPipeline(OpPassManager &passManager,
@@ -449,7 +471,8 @@ LogicalResult verifyDoubleTilingExpertPassPipelineConfig(
 void addMultiTilingExpertPassPipeline(OpPassManager &passManager,
                                       int64_t numLevels, bool enablePeeling,
                                       bool enableVectorMasking,
-                                      bool lowerToAVX2);
+                                      bool lowerToAVX2,
+                                      bool vectorizeGatherAccesses);
 void addDoubleTilingPadExpertPassPipeline(OpPassManager &passManager,
                                           bool enableVectorMasking);
 
@@ -534,6 +557,10 @@ void addGPUTransposePassPipeline(OpPassManager &pm);
 /// Lowering reductions to warp reductions.
 void addGPUWarpReductionPassPipeline(OpPassManager &pm);
 
+/// Lowering of `iree_linalg_ext.attention` to a fused online-softmax loop that
+/// keeps the score tile of each workgroup in registers.
+void addGPUAttentionPassPipeline(OpPassManager &pm);
+
 /// Transform dialect-based path.
 void addGPUTransformDialectPasses(OpPassManager &pm);
 
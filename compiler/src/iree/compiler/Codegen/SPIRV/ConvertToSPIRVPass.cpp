@@ -165,24 +165,47 @@ InterfaceResourceMap createResourceVariables(mlir::ModuleOp module) {
 //===----------------------------------------------------------------------===//
 
 namespace {
+/// Returns the pipeline layout of the entry point of the executable variant
+/// containing `op`.
+IREE::HAL::PipelineLayoutAttr getEntryPointLayout(Operation *op) {
+  // TODO(#1519): this conversion should look up the entry point information
+  // to get the total push constant count.
+  auto variantOp = op->getParentOfType<IREE::HAL::ExecutableVariantOp>();
+  auto exportOps =
+      llvm::to_vector<1>(variantOp.getOps<IREE::HAL::ExecutableExportOp>());
+  assert(exportOps.size() == 1);
+  return exportOps.front().getLayout();
+}
+
+/// Returns the number of 32-bit values in the push constant storage for
+/// `layoutAttr`. When bindings are passed as buffer device addresses the
+/// addresses follow the push constants as pairs of 32-bit values.
+uint64_t getPushConstantCount(IREE::HAL::PipelineLayoutAttr layoutAttr,
+                              bool useBufferDeviceAddresses) {
+  uint64_t count = layoutAttr.getPushConstants();
+  if (useBufferDeviceAddresses) {
+    count += 2 * *getSPIRVBufferDeviceAddressSlotCount(layoutAttr);
+  }
+  return count;
+}
+
 /// A pattern to convert hal.interface.constant.load into a sequence of SPIR-V
 /// ops to load from a global variable representing the push constant storage.
 struct HALInterfaceLoadConstantConverter final
     : public OpConversionPattern<IREE::HAL::InterfaceConstantLoadOp> {
-  using OpConversionPattern::OpConversionPattern;
+  HALInterfaceLoadConstantConverter(TypeConverter &typeConverter,
+                                    MLIRContext *context,
+                                    bool useBufferDeviceAddresses,
+                                    PatternBenefit benefit = 1)
+      : OpConversionPattern(typeConverter, context, benefit),
+        useBufferDeviceAddresses(useBufferDeviceAddresses) {}
 
   LogicalResult matchAndRewrite(
       IREE::HAL::InterfaceConstantLoadOp loadOp, OpAdaptor adaptor,
       ConversionPatternRewriter &rewriter) const override {
-    // TODO(#1519): this conversion should look up the entry point information
-    // to get the total push constant count.
-    auto variantOp = loadOp->getParentOfType<IREE::HAL::ExecutableVariantOp>();
-    auto exportOps =
-        llvm::to_vector<1>(variantOp.getOps<IREE::HAL::ExecutableExportOp>());
-    assert(exportOps.size() == 1);
-    auto layoutAttr = exportOps.front().getLayout();
-
-    uint64_t elementCount = layoutAttr.getPushConstants();
+    auto layoutAttr = getEntryPointLayout(loadOp);
+    uint64_t elementCount =
+        getPushConstantCount(layoutAttr, useBufferDeviceAddresses);
     unsigned index = loadOp.getIndex().getZExtValue();
 
     // The following function generates SPIR-V ops with i32 types. So it does
@@ -195,6 +218,9 @@ struct HALInterfaceLoadConstantConverter final
     rewriter.replaceOp(loadOp, value);
     return success();
   }
+
+ private:
+  bool useBufferDeviceAddresses;
 };
 
 /// A pattern to convert hal.interface.workgroup.id/count into corresponding
@@ -274,6 +300,65 @@ struct HALInterfaceBindingSubspanConverter final
   const InterfaceResourceMap &interfaceToResourceVars;
 };
 
+/// A pattern to convert hal.interface.binding.subspan into a physical storage
+/// buffer pointer built from the buffer device address of the binding, passed
+/// as a pair of 32-bit values (low bits first) in the push constant storage
+/// after the push constants.
+struct HALInterfaceBindingSubspanToAddressConverter final
+    : public OpConversionPattern<IREE::HAL::InterfaceBindingSubspanOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      IREE::HAL::InterfaceBindingSubspanOp subspanOp, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    if (subspanOp.use_empty()) {
+      rewriter.eraseOp(subspanOp);
+      return success();
+    }
+
+    Value offset = subspanOp.getByteOffset();
+    APInt offsetInt;
+    if (offset && matchPattern(offset, m_ConstantInt(&offsetInt)) &&
+        !offsetInt.isZero()) {
+      return subspanOp.emitOpError() << "should have no or zero byte offset";
+    }
+
+    Type resultType = subspanOp.getOperation()->getResult(0).getType();
+    Type convertedType = this->getTypeConverter()->convertType(resultType);
+    if (!convertedType) {
+      return subspanOp.emitError()
+             << "failed to convert SPIR-V type: " << resultType;
+    }
+
+    auto layoutAttr = getEntryPointLayout(subspanOp);
+    uint64_t elementCount =
+        getPushConstantCount(layoutAttr, /*useBufferDeviceAddresses=*/true);
+    auto [set, binding] = getInterfaceSetAndBinding(subspanOp);
+    unsigned index =
+        layoutAttr.getPushConstants() +
+        2 * getSPIRVBufferDeviceAddressSlot(layoutAttr, set, binding);
+
+    Location loc = subspanOp.getLoc();
+    auto i32Type = rewriter.getIntegerType(32);
+    auto i64Type = rewriter.getIntegerType(64);
+    Value lowBits = spirv::getPushConstantValue(subspanOp, elementCount, index,
+                                                i32Type, rewriter);
+    Value highBits = spirv::getPushConstantValue(
+        subspanOp, elementCount, index + 1, i32Type, rewriter);
+    lowBits = rewriter.create<spirv::UConvertOp>(loc, i64Type, lowBits);
+    highBits = rewriter.create<spirv::UConvertOp>(loc, i64Type, highBits);
+    Value shift = rewriter.create<spirv::ConstantOp>(
+        loc, i64Type, rewriter.getI64IntegerAttr(32));
+    highBits = rewriter.create<spirv::ShiftLeftLogicalOp>(loc, i64Type,
+                                                          highBits, shift);
+    Value address =
+        rewriter.create<spirv::BitwiseOrOp>(loc, i64Type, lowBits, highBits);
+    rewriter.replaceOpWithNewOp<spirv::ConvertUToPtrOp>(subspanOp,
+                                                        convertedType, address);
+    return success();
+  }
+};
+
 /// Pattern to lower operations that become a no-ops at this level.
 template <typename OpTy>
 struct FoldAsNoOp final : public OpConversionPattern<OpTy> {
@@ -416,6 +501,18 @@ void ConvertToSPIRVPass::runOnOperation() {
     return signalPassFailure();
   }
 
+  // Bindings are passed as buffer device addresses when the target requests it
+  // and they fit in the push constant range.
+  bool useBufferDeviceAddresses = usesSPIRVBufferDeviceAddresses(moduleOp);
+  if (useBufferDeviceAddresses &&
+      (!targetEnv.allows(spirv::Capability::PhysicalStorageBufferAddresses) ||
+       !targetEnv.allows(spirv::Capability::Int64))) {
+    moduleOp.emitOpError(
+        "buffer device addresses are not supported for the specified target "
+        "environment");
+    return signalPassFailure();
+  }
+
   SPIRVConversionOptions options = {};
   options.enableFastMathMode = this->enableFastMath;
   options.use64bitIndex = use64bitIndex;
@@ -461,8 +558,9 @@ void ConvertToSPIRVPass::runOnOperation() {
   populateBuiltinFuncToSPIRVPatterns(typeConverter, patterns);
 
   // Add IREE HAL interface op conversions.
+  patterns.insert<HALInterfaceLoadConstantConverter>(typeConverter, context,
+                                                     useBufferDeviceAddresses);
   patterns.insert<
-      HALInterfaceLoadConstantConverter,
       HALInterfaceWorkgroupIdAndCountConverter<
           IREE::HAL::InterfaceWorkgroupIDOp, spirv::BuiltIn::WorkgroupId>,
       HALInterfaceWorkgroupIdAndCountConverter<
@@ -470,11 +568,18 @@ void ConvertToSPIRVPass::runOnOperation() {
       typeConverter, context);
 
   // Performs a prelimiary step to analyze all hal.interface.binding.subspan ops
-  // and create spirv.GlobalVariables.
-  auto interfaceToResourceVars = createResourceVariables(moduleOp);
-  // For using use them in conversion.
-  patterns.insert<HALInterfaceBindingSubspanConverter>(typeConverter, context,
-                                                       interfaceToResourceVars);
+  // and create spirv.GlobalVariables. No variables are needed when bindings are
+  // passed as buffer device addresses.
+  InterfaceResourceMap interfaceToResourceVars;
+  if (useBufferDeviceAddresses) {
+    patterns.insert<HALInterfaceBindingSubspanToAddressConverter>(typeConverter,
+                                                                  context);
+  } else {
+    interfaceToResourceVars = createResourceVariables(moduleOp);
+    // For using use them in conversion.
+    patterns.insert<HALInterfaceBindingSubspanConverter>(
+        typeConverter, context, interfaceToResourceVars);
+  }
 
   /// Fold certain operations as no-ops:
   /// - linalg.reshape becomes a no-op since all memrefs are linearized in
@@ -508,7 +613,10 @@ void ConvertToSPIRVPass::runOnOperation() {
   // Collect all SPIR-V ops into a spirv.module.
   auto builder = OpBuilder::atBlockBegin(moduleOp.getBody());
   auto spvModule = builder.create<spirv::ModuleOp>(
-      moduleOp.getLoc(), spirv::AddressingModel::Logical,
+      moduleOp.getLoc(),
+      useBufferDeviceAddresses
+          ? spirv::AddressingModel::PhysicalStorageBuffer64
+          : spirv::AddressingModel::Logical,
       spirv::MemoryModel::GLSL450);
   Block *body = spvModule.getBody();
   Dialect *spvDialect = spvModule->getDialect();
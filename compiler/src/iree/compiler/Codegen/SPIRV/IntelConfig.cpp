@@ -0,0 +1,95 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- IntelConfig.h - Intel CodeGen Configurations -----------------------===//
+//
+// This file contains CodeGen configurations for Intel GPUs.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Codegen/Dialect/LoweringConfig.h"
+#include "iree/compiler/Codegen/SPIRV/KernelConfig.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
+#include "mlir/IR/BuiltinOps.h"
+
+#define DEBUG_TYPE "iree-spirv-intel-config"
+
+namespace mlir {
+namespace iree_compiler {
+namespace detail {
+
+constexpr unsigned IntelSimtSoftwarePipelineDepth = 2;
+constexpr unsigned IntelSimtSoftwarePipelineStoreStage = 0;
+
+constexpr unsigned IntelCoopMatrixSoftwarePipelineDepth = 1;
+constexpr unsigned IntelCoopMatrixSoftwarePipelineStoreStage = 0;
+
+constexpr unsigned IntelNumSubgroupsPerWorkgroup = 8;
+// The number of tiles along M and N dimensions per workgroup.
+constexpr unsigned IntelNumMNTilesPerSubgroup = 8;
+
+static LogicalResult setIntelMatmulConfig(linalg::LinalgOp op,
+                                          const spirv::TargetEnv &targetEnv) {
+  if (succeeded(setCooperativeMatrixConfig(
+          targetEnv, op, IntelNumSubgroupsPerWorkgroup,
+          IntelNumMNTilesPerSubgroup, IntelCoopMatrixSoftwarePipelineDepth,
+          IntelCoopMatrixSoftwarePipelineStoreStage)))
+    return success();
+
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  const int subgroupSize = limits.getSubgroupSize();
+  const std::array<int64_t, 2> workgroupXY = {subgroupSize / 2, 8};
+  std::array<int64_t, 3> threadMNK;
+  auto inputType = op.getDpsInputOperand(0)->get().getType().cast<ShapedType>();
+  if (inputType.getElementType().getIntOrFloatBitWidth() == 16) {
+    threadMNK = {8, 8, 32};
+  } else {
+    threadMNK = {4, 4, 16};
+  }
+  return setMatmulOpConfig(limits, op, workgroupXY, threadMNK,
+                           /*enablePromotion=*/true,
+                           IntelSimtSoftwarePipelineDepth,
+                           IntelSimtSoftwarePipelineStoreStage);
+}
+
+// Xe-HPG architecture (Arc A-series):
+//
+// Each Xe-core has 16 vector engines (XVE) with SIMD8 ALUs and 16 matrix
+// engines (XMX), sharing 64KB of shared local memory.
+//
+// * XMX systolic arrays work on 8 rows per subgroup; they are only available
+//   with subgroup size 8
+// * Max 64KB SLM per workgroup, 32KB exposed through Vulkan
+
+LogicalResult setIntelCodeGenConfig(const spirv::TargetEnv &targetEnv,
+                                    Operation *rootOp) {
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  int subgroupSize = limits.getSubgroupSize();
+
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
+    if (isMatmulOrBatchMatmul(linalgOp))
+      return setIntelMatmulConfig(linalgOp, targetEnv);
+  }
+
+  if (auto convOp = dyn_cast<linalg::ConvolutionOpInterface>(rootOp)) {
+    // Use the result type in case of larger bitwidth for accumulators.
+    auto type = cast<ShapedType>(convOp->getResult(0).getType());
+    const int bitwidth = type.getElementTypeBitWidth();
+    if (bitwidth > 32) return failure();
+    const int multipler = 32 / bitwidth;
+    const int bestTilingFactor = 16 * multipler;
+    return setConvOpConfig(rootOp, subgroupSize, bestTilingFactor);
+  }
+
+  return failure();
+}
+
+}  // namespace detail
+}  // namespace iree_compiler
+}  // namespace mlir
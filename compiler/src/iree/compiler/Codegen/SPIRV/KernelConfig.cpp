@@ -901,8 +901,10 @@ LogicalResult setCooperativeMatrixConfig(
 
   std::optional<int64_t> subgroupSize = limits.getSubgroupSize();
   // AMD RDNA architectures supports both wave32 and wave64 modes. Prefer to use
-  // wave32 mode for better performance.
-  if (targetEnv.getVendorID() == spirv::Vendor::AMD) {
+  // wave32 mode for better performance. Intel XMX engines are only usable with
+  // the minimal subgroup size.
+  if (targetEnv.getVendorID() == spirv::Vendor::AMD ||
+      targetEnv.getVendorID() == spirv::Vendor::Intel) {
     if (std::optional<int> minSize = limits.getMinSubgroupSize())
       subgroupSize = *minSize;
   }
@@ -1082,9 +1084,8 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   }
   if (!foundSingleReductionOutput) return failure();
 
-  const int subgroupSize = targetEnv.getResourceLimits().getSubgroupSize();
   std::optional<int64_t> dimSize = op.getStaticLoopRanges()[reductionDims[0]];
-  if (!dimSize || *dimSize % subgroupSize != 0) return failure();
+  if (!dimSize) return failure();
 
   const Type elementType =
       op.getOutputs()[0].getType().cast<ShapedType>().getElementType();
@@ -1093,29 +1094,62 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   // Reduction distribution only supports 8/16/32 bit types now.
   if (bitWidth != 32 && bitWidth != 16 && bitWidth != 8) return failure();
 
-  // Let each thread handle `vectorSize` elements.
-  unsigned vectorSize = kMaxVectorNumBits / bitWidth;
-  while ((*dimSize / vectorSize) % subgroupSize != 0) vectorSize /= 2;
+  // Targets with subgroup size control support a range of subgroup sizes.
+  // Larger subgroups need fewer steps to reduce across subgroups, so try from
+  // the largest size down and require the chosen size for the pipeline.
+  // Otherwise use the default subgroup size without requiring it.
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  std::optional<int> minSubgroupSize = limits.getMinSubgroupSize();
+  std::optional<int> maxSubgroupSize = limits.getMaxSubgroupSize();
+  const bool hasSubgroupSizeControl = minSubgroupSize && maxSubgroupSize &&
+                                      *minSubgroupSize < *maxSubgroupSize;
+  SmallVector<int64_t> candidateSubgroupSizes;
+  if (hasSubgroupSizeControl) {
+    for (int64_t size = *maxSubgroupSize; size >= *minSubgroupSize; size /= 2)
+      candidateSubgroupSizes.push_back(size);
+  } else {
+    candidateSubgroupSizes.push_back(limits.getSubgroupSize());
+  }
 
   // TODO: Add reduction tiling to handle larger reductions.
-  const int64_t maxWorkgroupSize =
-      targetEnv.getResourceLimits().getMaxComputeWorkgroupInvocations();
-  int64_t groupSize = *dimSize / vectorSize;
-  if (groupSize > maxWorkgroupSize) {
-    groupSize = llvm::APIntOps::GreatestCommonDivisor(
-                    {64, uint64_t(groupSize)}, {64, uint64_t(maxWorkgroupSize)})
-                    .getZExtValue();
-  }
-  // Current warp reduction pattern is a two step butterfly warp reduce.
-  // First, do warp reductions along multiple subgroups.
-  // Second, reduce results from multiple subgroups using single warp reduce.
-  // The final warp reduce requires numSubgroupUsed > subgroupSize to work.
-  // TODO(raikonenfnu): Add flexible num of warp reduce to handle more configs.
-  // TT::CPU and TT::ARM_Valhall is not going through warp reduce.
-  const int64_t numSubgroupsUsed = groupSize / subgroupSize;
-  if (numSubgroupsUsed > subgroupSize) {
-    return failure();
+  const int64_t maxWorkgroupSize = limits.getMaxComputeWorkgroupInvocations();
+  std::optional<int64_t> subgroupSize;
+  int64_t groupSize = 0;
+  unsigned vectorSize = 0;
+  for (int64_t candidate : candidateSubgroupSizes) {
+    if (*dimSize % candidate != 0) continue;
+
+    // Let each thread handle `vectorSize` elements.
+    unsigned candidateVectorSize = kMaxVectorNumBits / bitWidth;
+    while ((*dimSize / candidateVectorSize) % candidate != 0)
+      candidateVectorSize /= 2;
+
+    int64_t candidateGroupSize = *dimSize / candidateVectorSize;
+    if (candidateGroupSize > maxWorkgroupSize) {
+      candidateGroupSize =
+          llvm::APIntOps::GreatestCommonDivisor(
+              {64, uint64_t(candidateGroupSize)},
+              {64, uint64_t(maxWorkgroupSize)})
+              .getZExtValue();
+    }
+    // Current warp reduction pattern is a two step butterfly warp reduce.
+    // First, do warp reductions along multiple subgroups.
+    // Second, reduce results from multiple subgroups using single warp reduce.
+    // The final warp reduce requires numSubgroupUsed > subgroupSize to work.
+    // TODO(raikonenfnu): Add flexible num of warp reduce to handle more
+    // configs. TT::CPU and TT::ARM_Valhall is not going through warp reduce.
+    const int64_t numSubgroupsUsed = candidateGroupSize / candidate;
+    if (numSubgroupsUsed > candidate) continue;
+
+    subgroupSize = candidate;
+    groupSize = candidateGroupSize;
+    vectorSize = candidateVectorSize;
+    break;
   }
+  if (!subgroupSize) return failure();
+  LLVM_DEBUG(llvm::dbgs() << "reduction subgroup size = " << *subgroupSize
+                          << "\n");
+
   std::array<int64_t, 3> workgroupSize = {groupSize, 1, 1};
   // Tile all the parallel dimension to 1.
   SmallVector<unsigned> partitionedLoops =
@@ -1133,7 +1167,8 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   tileSizes.emplace_back(std::move(reductionTileSizes));  // reduction level
   if (failed(setOpConfigAndEntryPointFnTranslation(
           op->getParentOfType<func::FuncOp>(), op, tileSizes,
-          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize))) {
+          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize,
+          hasSubgroupSizeControl ? subgroupSize : std::nullopt))) {
     return failure();
   }
 
@@ -1415,6 +1450,10 @@ static LogicalResult setSPIRVOpConfig(const spirv::TargetEnv &targetEnv,
       if (succeeded(detail::setMaliCodeGenConfig(targetEnv, rootOp)))
         return success();
       break;
+    case spirv::Vendor::Intel:
+      if (succeeded(detail::setIntelCodeGenConfig(targetEnv, rootOp)))
+        return success();
+      break;
     case spirv::Vendor::NVIDIA:
       if (succeeded(detail::setNVIDIACodeGenConfig(targetEnv, rootOp)))
         return success();
@@ -486,10 +486,9 @@ void addSPIRVSubgroupReducePassPipeline(OpPassManager &pm) {
   nestedModulePM.addNestedPass<func::FuncOp>(createForOpCanonicalizationPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
 
+  // Use the subgroup size required by the entry point if there is one.
   auto getWarpSize = [](func::FuncOp func) {
-    auto moduleOp = func->getParentOfType<ModuleOp>();
-    spirv::TargetEnvAttr target = getSPIRVTargetEnvAttr(moduleOp);
-    return target.getResourceLimits().getSubgroupSize();
+    return getSPIRVSubgroupSize(func).value_or(32);
   };
 
   // Handle vector reduction operations specifically.
@@ -45,6 +45,22 @@ std::optional<spirv::StorageClass> mapHALDescriptorTypeForVulkan(
   return spirv::mapMemorySpaceToVulkanStorageClass(attr);
 }
 
+/// Maps HAL descriptor types to physical storage buffers for executables that
+/// receive their bindings as buffer device addresses.
+std::optional<spirv::StorageClass> mapHALDescriptorTypeForVulkanBDA(
+    Attribute attr) {
+  if (auto dtAttr = attr.dyn_cast_or_null<IREE::HAL::DescriptorTypeAttr>()) {
+    switch (dtAttr.getValue()) {
+      case IREE::HAL::DescriptorType::UniformBuffer:
+      case IREE::HAL::DescriptorType::StorageBuffer:
+        return spirv::StorageClass::PhysicalStorageBuffer;
+      default:
+        return std::nullopt;
+    }
+  }
+  return mapHALDescriptorTypeForVulkan(attr);
+}
+
 std::optional<spirv::StorageClass> mapHALDescriptorTypeForOpenCL(
     Attribute attr) {
   if (auto dtAttr = attr.dyn_cast_or_null<IREE::HAL::DescriptorTypeAttr>()) {
@@ -81,7 +97,9 @@ struct SPIRVMapMemRefStorageClassPass final
     if (spirv::TargetEnvAttr attr = getSPIRVTargetEnvAttr(op)) {
       spirv::TargetEnv targetEnv(attr);
       if (targetEnv.allows(spirv::Capability::Shader)) {
-        memorySpaceMap = mapHALDescriptorTypeForVulkan;
+        memorySpaceMap = usesSPIRVBufferDeviceAddresses(op)
+                             ? mapHALDescriptorTypeForVulkanBDA
+                             : mapHALDescriptorTypeForVulkan;
       } else if (targetEnv.allows(spirv::Capability::Kernel)) {
         memorySpaceMap = mapHALDescriptorTypeForOpenCL;
       }
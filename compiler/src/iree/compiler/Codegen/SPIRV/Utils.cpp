@@ -37,6 +37,69 @@ spirv::TargetEnvAttr getSPIRVTargetEnvAttr(Operation *op) {
   return config.getAs<spirv::TargetEnvAttr>(spirv::getTargetEnvAttrName());
 }
 
+const char *getSPIRVBufferDeviceAddressAttrName() {
+  return "buffer_device_address";
+}
+
+// Largest push constant range in bytes used when passing buffer device
+// addresses. This is the minimum maxPushConstantsSize required by Vulkan.
+static constexpr int64_t kMaxBufferDeviceAddressPushConstantSize = 128;
+
+// Largest number of descriptor sets whose bindings may be passed as buffer
+// device addresses.
+static constexpr int64_t kMaxBufferDeviceAddressSetCount = 4;
+
+// Returns the number of buffer device address slots used by `setLayoutAttr`.
+static int64_t getBufferDeviceAddressSlotCount(
+    IREE::HAL::DescriptorSetLayoutAttr setLayoutAttr) {
+  int64_t slotCount = 0;
+  for (auto bindingAttr : setLayoutAttr.getBindings()) {
+    slotCount = std::max(slotCount, bindingAttr.getOrdinal() + 1);
+  }
+  return slotCount;
+}
+
+std::optional<int64_t> getSPIRVBufferDeviceAddressSlotCount(
+    IREE::HAL::PipelineLayoutAttr layoutAttr) {
+  auto setLayouts = layoutAttr.getSetLayouts();
+  if (setLayouts.size() > kMaxBufferDeviceAddressSetCount) return std::nullopt;
+  int64_t slotCount = 0;
+  for (auto setLayoutAttr : setLayouts) {
+    slotCount += getBufferDeviceAddressSlotCount(setLayoutAttr);
+  }
+  int64_t totalSize = layoutAttr.getPushConstants() * sizeof(uint32_t) +
+                      slotCount * sizeof(uint64_t);
+  if (totalSize > kMaxBufferDeviceAddressPushConstantSize) return std::nullopt;
+  return slotCount;
+}
+
+int64_t getSPIRVBufferDeviceAddressSlot(
+    IREE::HAL::PipelineLayoutAttr layoutAttr, int64_t set, int64_t binding) {
+  int64_t setBase = 0;
+  for (auto setLayoutAttr : layoutAttr.getSetLayouts()) {
+    if (setLayoutAttr.getOrdinal() == set) break;
+    setBase += getBufferDeviceAddressSlotCount(setLayoutAttr);
+  }
+  return setBase + binding;
+}
+
+bool usesSPIRVBufferDeviceAddresses(Operation *op) {
+  auto variant = dyn_cast<IREE::HAL::ExecutableVariantOp>(op);
+  if (!variant) variant = op->getParentOfType<IREE::HAL::ExecutableVariantOp>();
+  if (!variant) return false;
+  IREE::HAL::ExecutableTargetAttr targetAttr = variant.getTarget();
+  if (!targetAttr) return false;
+  auto config = targetAttr.getConfiguration();
+  if (!config || !config.get(getSPIRVBufferDeviceAddressAttrName())) {
+    return false;
+  }
+  return llvm::all_of(
+      variant.getOps<IREE::HAL::ExecutableExportOp>(), [](auto exportOp) {
+        return getSPIRVBufferDeviceAddressSlotCount(exportOp.getLayout())
+            .has_value();
+      });
+}
+
 std::optional<int> getSPIRVSubgroupSize(func::FuncOp funcOp) {
   auto moduleOp = funcOp->getParentOfType<ModuleOp>();
   llvm::StringMap<IREE::HAL::ExecutableExportOp> exportOps =
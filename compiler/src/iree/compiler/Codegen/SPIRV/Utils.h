@@ -13,6 +13,7 @@
 #ifndef IREE_COMPILER_CODEGEN_SPIRV_UTILS_H_
 #define IREE_COMPILER_CODEGEN_SPIRV_UTILS_H_
 
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
@@ -32,6 +33,29 @@ std::optional<int> getSPIRVSubgroupSize(func::FuncOp funcOp);
 /// Returns the attribute name carrying information about distribution.
 const char *getSPIRVDistributeAttrName();
 
+/// Returns the attribute name of the unit attribute in executable target
+/// configurations requesting that buffers are passed to shaders as buffer
+/// device addresses in push constants instead of through descriptor sets.
+const char *getSPIRVBufferDeviceAddressAttrName();
+
+/// Returns the number of 64-bit buffer device address slots placed after the
+/// push constants of `layoutAttr` when passing its bindings as buffer device
+/// addresses, or std::nullopt if they don't fit in the push constant range. The
+/// sets are laid out in order with each reserving one slot per binding ordinal
+/// up to its largest binding. This must match the Vulkan HAL pipeline layout.
+std::optional<int64_t> getSPIRVBufferDeviceAddressSlotCount(
+    IREE::HAL::PipelineLayoutAttr layoutAttr);
+
+/// Returns the buffer device address slot of `binding` in `set` of
+/// `layoutAttr`.
+int64_t getSPIRVBufferDeviceAddressSlot(
+    IREE::HAL::PipelineLayoutAttr layoutAttr, int64_t set, int64_t binding);
+
+/// Returns true if the bindings of the executable variant containing `op` are
+/// passed as buffer device addresses: the target requests it and the layouts of
+/// all entry points fit.
+bool usesSPIRVBufferDeviceAddresses(Operation *op);
+
 /// Returns the tile sizes at the given `tilingLevel` for compute ops in
 /// `funcOp`.
 FailureOr<SmallVector<int64_t>> getSPIRVTileSize(func::FuncOp funcOp,
@@ -287,3 +287,51 @@ hal.executable private @interface_wg_count {
 //       INDEX64:     %[[VAL2:.+]] = spirv.Load "Input" %[[ADDR2]]
 //       INDEX64:     %[[WGIDY:.+]] = spirv.CompositeExtract %[[VAL2]][1 : i32]
 //       INDEX64:     %[[WGYEXT:.+]] = spirv.UConvert %[[WGIDY]] : i32 to i64
+
+// -----
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 1, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+hal.executable private @buffer_device_address {
+  hal.executable.variant @vulkan, target = <"vulkan-spirv", "vulkan-spirv-fb", {
+      buffer_device_address,
+      spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Int64, Shader, PhysicalStorageBufferAddresses], [SPV_KHR_physical_storage_buffer]>, #spirv.resource_limits<>>}> {
+    hal.executable.export @buffer_device_address layout(#pipeline_layout) attributes {
+      workgroup_size = [32: index, 1: index, 1: index]
+    }
+    builtin.module {
+      func.func @buffer_device_address() -> f32 {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : memref<16xf32, #spirv.storage_class<PhysicalStorageBuffer>>
+        %1 = memref.load %0[%c0] : memref<16xf32, #spirv.storage_class<PhysicalStorageBuffer>>
+        return %1 : f32
+      }
+    }
+  }
+}
+
+// The address of binding 1 follows the push constant and the address of
+// binding 0 as two 32-bit values.
+
+// CHECK-LABEL: spirv.module PhysicalStorageBuffer64 GLSL450
+//   CHECK-NOT:   spirv.GlobalVariable {{.+}} bind(
+//       CHECK:   spirv.GlobalVariable @__push_constant_var__ : !spirv.ptr<!spirv.struct<(!spirv.array<5 x i32, stride=4> [0])>, PushConstant>
+//       CHECK:   spirv.func @buffer_device_address()
+//   CHECK-DAG:     %[[INDEX_0:.+]] = spirv.Constant 0 : i32
+//   CHECK-DAG:     %[[INDEX_LO:.+]] = spirv.Constant 3 : i32
+//       CHECK:     %[[AC_LO:.+]] = spirv.AccessChain %{{.+}}[%[[INDEX_0]], %[[INDEX_LO]]]
+//       CHECK:     %[[LO:.+]] = spirv.Load "PushConstant" %[[AC_LO]] : i32
+//       CHECK:     %[[INDEX_HI:.+]] = spirv.Constant 4 : i32
+//       CHECK:     %[[AC_HI:.+]] = spirv.AccessChain %{{.+}}[%{{.+}}, %[[INDEX_HI]]]
+//       CHECK:     %[[HI:.+]] = spirv.Load "PushConstant" %[[AC_HI]] : i32
+//       CHECK:     %[[LO64:.+]] = spirv.UConvert %[[LO]] : i32 to i64
+//       CHECK:     %[[HI64:.+]] = spirv.UConvert %[[HI]] : i32 to i64
+//       CHECK:     %[[C32:.+]] = spirv.Constant 32 : i64
+//       CHECK:     %[[SHIFTED:.+]] = spirv.ShiftLeftLogical %[[HI64]], %[[C32]] : i64, i64
+//       CHECK:     %[[ADDRESS:.+]] = spirv.BitwiseOr %[[LO64]], %[[SHIFTED]] : i64
+//       CHECK:     %[[PTR:.+]] = spirv.ConvertUToPtr %[[ADDRESS]] : i64 to !spirv.ptr<!spirv.struct<(!spirv.array<16 x f32, stride=4> [0])>, PhysicalStorageBuffer>
+//       CHECK:     spirv.AccessChain %[[PTR]]
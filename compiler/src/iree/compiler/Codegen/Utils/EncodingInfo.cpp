@@ -20,11 +20,27 @@ std::optional<MatmulType> getMatmulType(Type lhsElementType,
     return MatmulType::I8I8I32;
   }
 
+  if (lhsElementType.isSignlessInteger(8) &&
+      rhsElementType.isSignlessInteger(4) &&
+      resultElementType.isSignlessInteger(32)) {
+    return MatmulType::I8I4I32;
+  }
+
   if (lhsElementType.isF32() && rhsElementType.isF32() &&
       resultElementType.isF32()) {
     return MatmulType::F32F32F32;
   }
 
+  if (lhsElementType.isF16() && rhsElementType.isF16()) {
+    if (resultElementType.isF32()) return MatmulType::F16F16F32;
+    if (resultElementType.isF16()) return MatmulType::F16F16F16;
+  }
+
+  if (lhsElementType.isBF16() && rhsElementType.isBF16()) {
+    if (resultElementType.isF32()) return MatmulType::BF16BF16F32;
+    if (resultElementType.isBF16()) return MatmulType::BF16BF16BF16;
+  }
+
   return std::nullopt;
 }
 
@@ -4,14 +4,23 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <limits>
+
 #include "iree/compiler/ConstEval/PassDetail.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/ConstEval/Runtime.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_ostream.h"
+#include "mlir/AsmParser/AsmParser.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
@@ -25,6 +34,12 @@ namespace mlir {
 namespace iree_compiler {
 namespace ConstEval {
 
+static llvm::cl::opt<std::string> clJitCacheDir(
+    "iree-consteval-jit-cache-dir",
+    llvm::cl::desc("Directory used to cache evaluated global values across "
+                   "compiler invocations. Disabled when empty."),
+    llvm::cl::init(""));
+
 namespace {
 
 struct ProgramExtractor {
@@ -116,6 +131,91 @@ struct ProgramExtractor {
   SmallVector<StringAttr> symbolImportWorklist;
 };
 
+// Returns a key uniquely identifying the evaluation of |moduleOp| by hashing
+// its IR, including all initializers and the constants they consume.
+static std::string computeCacheKey(ModuleOp moduleOp) {
+  // Never elide constants as they are part of what is being evaluated.
+  OpPrintingFlags flags;
+  flags.elideLargeElementsAttrs(std::numeric_limits<int64_t>::max());
+  std::string moduleStr;
+  llvm::raw_string_ostream os(moduleStr);
+  moduleOp.print(os, flags);
+  os.flush();
+  llvm::SHA1 hasher;
+  hasher.update(moduleStr);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+// Returns the path of the cache entry for |cacheKey| in |cacheDir|.
+static std::string getCachePath(StringRef cacheDir, StringRef cacheKey) {
+  SmallString<256> path(cacheDir);
+  llvm::sys::path::append(path, cacheKey + ".mlir");
+  return path.str().str();
+}
+
+// Loads the cached global values from |cachePath| into |outValues|.
+// Fails (without emitting errors) if the entry is missing or does not contain
+// values of the expected types for every global in |globalOps|.
+static LogicalResult loadCachedValues(
+    StringRef cachePath, ArrayRef<IREE::Util::GlobalOp> globalOps,
+    SmallVectorImpl<Attribute> &outValues) {
+  auto fileOr = llvm::MemoryBuffer::getFile(cachePath);
+  if (!fileOr) return failure();
+  MLIRContext *context = globalOps.front().getContext();
+  auto dictAttr = llvm::dyn_cast_or_null<DictionaryAttr>(
+      parseAttribute((*fileOr)->getBuffer(), context));
+  if (!dictAttr) {
+    LLVM_DEBUG(dbgs() << "JitGlobals: ignoring malformed cache entry "
+                      << cachePath << "\n");
+    return failure();
+  }
+  for (auto globalOp : globalOps) {
+    auto value =
+        llvm::dyn_cast_or_null<TypedAttr>(dictAttr.get(globalOp.getSymName()));
+    if (!value || value.getType() != globalOp.getType()) return failure();
+    outValues.push_back(value);
+  }
+  return success();
+}
+
+// Stores |values| for |globalOps| in the cache entry at |cachePath|.
+// The entry is written to a temporary file and moved into place so that
+// concurrent compilations never observe a partial entry. Failures are only
+// logged as the cache is an optimization.
+static void storeCachedValues(StringRef cachePath,
+                              ArrayRef<IREE::Util::GlobalOp> globalOps,
+                              ArrayRef<Attribute> values) {
+  SmallVector<NamedAttribute> entries;
+  for (auto [globalOp, value] : llvm::zip_equal(globalOps, values)) {
+    entries.emplace_back(globalOp.getSymNameAttr(), value);
+  }
+  auto dictAttr = DictionaryAttr::get(globalOps.front().getContext(), entries);
+
+  if (auto ec = llvm::sys::fs::create_directories(
+          llvm::sys::path::parent_path(cachePath))) {
+    LLVM_DEBUG(dbgs() << "JitGlobals: failed to create cache dir: "
+                      << ec.message() << "\n");
+    return;
+  }
+  int fd = -1;
+  SmallString<256> tempPath;
+  if (auto ec = llvm::sys::fs::createUniqueFile(cachePath + "-%%%%%%%%", fd,
+                                                tempPath)) {
+    LLVM_DEBUG(dbgs() << "JitGlobals: failed to create cache entry: "
+                      << ec.message() << "\n");
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    dictAttr.print(os);
+  }
+  if (auto ec = llvm::sys::fs::rename(tempPath, cachePath)) {
+    LLVM_DEBUG(dbgs() << "JitGlobals: failed to store cache entry: "
+                      << ec.message() << "\n");
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
 // These options structs are not copy-constructable so we have to allocate them
 // shared.
 // TODO: See if we can make them copyable?
@@ -204,42 +304,77 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       return;
     }
 
-    // Run the IREE compiler, transforming the inner module into a vm.module.
-    LLVM_DEBUG(dbgs() << "JIT'ing " << uninitializedGlobals.size()
-                      << " uninitialized globals\n");
-    if (failed(runPipeline(compilePipeline, innerModule))) {
-      return signalPassFailure();
+    SmallVector<IREE::Util::GlobalOp> targetGlobals;
+    for (auto &it : uninitializedGlobals) {
+      targetGlobals.push_back(llvm::cast<IREE::Util::GlobalOp>(
+          outerSymbolTable.lookup(it.second)));
     }
 
-    // Generate a binary.
-    InMemoryCompiledBinary binary;
-    if (failed(binary.translateFromModule(innerModule))) {
-      return signalPassFailure();
+    // Reuse values evaluated by a prior compilation of the same initializers.
+    std::string cachePath;
+    SmallVector<Attribute> values;
+    if (!clJitCacheDir.empty()) {
+      cachePath = getCachePath(clJitCacheDir, computeCacheKey(innerModule));
+      if (succeeded(loadCachedValues(cachePath, targetGlobals, values))) {
+        LLVM_DEBUG(dbgs() << "JitGlobals: using cached values from "
+                          << cachePath << "\n");
+        innerModule.erase();
+      } else {
+        values.clear();
+      }
     }
 
-    // Kill the temporary program we constructed.
-    innerModule.erase();
+    if (values.empty()) {
+      // Run the IREE compiler, transforming the inner module into a vm.module.
+      LLVM_DEBUG(dbgs() << "JIT'ing " << uninitializedGlobals.size()
+                        << " uninitialized globals\n");
+      if (failed(runPipeline(compilePipeline, innerModule))) {
+        return signalPassFailure();
+      }
 
-    bool modified = false;
-    for (auto &it : uninitializedGlobals) {
-      StringAttr funcSymbol = it.first;
-      StringAttr globalSymbol = it.second;
-      auto targetGlobal = llvm::cast<IREE::Util::GlobalOp>(
-          outerSymbolTable.lookup(globalSymbol));
-      Location loc = targetGlobal->getLoc();
-
-      Attribute value =
-          binary.invokeNullaryAsAttribute(loc, funcSymbol.strref());
-      if (!value) {
+      // Generate a binary.
+      InMemoryCompiledBinary binary;
+      if (failed(binary.translateFromModule(innerModule))) {
         return signalPassFailure();
       }
 
+      // Kill the temporary program we constructed.
+      innerModule.erase();
+
+      for (auto [it, targetGlobal] :
+           llvm::zip_equal(uninitializedGlobals, targetGlobals)) {
+        StringAttr funcSymbol = it.first;
+        Attribute value = binary.invokeNullaryAsAttribute(
+            targetGlobal->getLoc(), funcSymbol.strref());
+        if (!value) {
+          return signalPassFailure();
+        }
+        values.push_back(value);
+      }
+
+      if (!cachePath.empty()) {
+        storeCachedValues(cachePath, targetGlobals, values);
+      }
+    }
+
+    bool modified = false;
+    for (auto [targetGlobal, value] : llvm::zip_equal(targetGlobals, values)) {
       modified = true;
       targetGlobal.setInitialValueAttr(value);
     }
 
-    // Delete any ops noted for pruning.
+    // Delete any initializers noted for pruning. Initializers that store to
+    // globals we could not evaluate must be preserved.
+    DenseSet<StringAttr> evaluatedGlobals;
+    for (auto &it : uninitializedGlobals) evaluatedGlobals.insert(it.second);
     for (Operation *op : pruneOps) {
+      auto walkResult =
+          op->walk([&](IREE::Util::GlobalStoreOpInterface storeOp) {
+            return evaluatedGlobals.contains(storeOp.getGlobalAttr().getAttr())
+                       ? WalkResult::advance()
+                       : WalkResult::interrupt();
+          });
+      if (walkResult.wasInterrupted()) continue;
       op->erase();
     }
 
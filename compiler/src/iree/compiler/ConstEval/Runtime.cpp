@@ -175,8 +175,10 @@ bool CompiledBinary::isSupportedResultType(Type type) {
     return true;
   }
 
-  // Support tensors.
+  // Support tensors. Encoded tensors have target-specific layouts that cannot
+  // be produced by the JIT.
   if (auto tt = type.dyn_cast<RankedTensorType>()) {
+    if (tt.getEncoding()) return false;
     return isSupportedResultType(tt.getElementType());
   }
 
@@ -91,6 +91,34 @@ module @eval_bf16_tensor {
   }
 }
 
+// -----
+// CHECK-LABEL: @eval_mixed_support
+// Only the initializer of the unsupported global should remain.
+// CHECK: util.global private @supported = dense<2> : tensor<2xi32>
+// CHECK: util.global private @unsupported : tensor<5x6xf16>
+// CHECK: util.initializer
+// CHECK-NEXT: arith.constant dense<2.000000e+02> : tensor<5x6xf16>
+// CHECK-NOT: util.initializer
+module @eval_mixed_support {
+  util.global private @supported : tensor<2xi32>
+  util.global private @unsupported : tensor<5x6xf16>
+  func.func @main() -> (tensor<2xi32>, tensor<5x6xf16>) {
+    %supported = util.global.load @supported : tensor<2xi32>
+    %unsupported = util.global.load @unsupported : tensor<5x6xf16>
+    return %supported, %unsupported : tensor<2xi32>, tensor<5x6xf16>
+  }
+  util.initializer {
+    %cst = arith.constant dense<2> : tensor<2xi32>
+    util.global.store %cst, @supported : tensor<2xi32>
+    util.initializer.return
+  }
+  util.initializer {
+    %cst = arith.constant dense<2.0e+2> : tensor<5x6xf16>
+    util.global.store %cst, @unsupported : tensor<5x6xf16>
+    util.initializer.return
+  }
+}
+
 // -----
 // CHECK-LABEL: @eval_f32_tensor
 // CHECK: util.global private @{{.*}} = dense<[2.000000e+02, 3.200000e+03]> : tensor<2xf32>
@@ -0,0 +1,27 @@
+// RUN: rm -rf %t
+// RUN: iree-opt --iree-consteval-jit-globals --iree-consteval-jit-cache-dir=%t %s | FileCheck %s
+// RUN: ls %t | FileCheck %s --check-prefix=CACHE
+// RUN: iree-opt --iree-consteval-jit-globals --iree-consteval-jit-cache-dir=%t %s | FileCheck %s
+
+// Tests that evaluated values are stored in the cache on the first run and
+// that the second run produces the same values from the cache entry.
+
+// CACHE: {{[0-9a-f]+}}.mlir
+
+// CHECK-LABEL: @cached_eval
+// CHECK: util.global private @hoisted = dense<[3, 4]> : tensor<2xi32>
+// CHECK-NOT: util.initializer
+module @cached_eval {
+  util.global private @hoisted : tensor<2xi32>
+  func.func @main() -> tensor<2xi32> {
+    %hoisted = util.global.load @hoisted : tensor<2xi32>
+    return %hoisted : tensor<2xi32>
+  }
+  util.initializer {
+    %cst = arith.constant dense<[1, 2]> : tensor<2xi32>
+    %cst_2 = arith.constant dense<2> : tensor<2xi32>
+    %0 = arith.addi %cst, %cst_2 : tensor<2xi32>
+    util.global.store %0, @hoisted : tensor<2xi32>
+    util.initializer.return
+  }
+}
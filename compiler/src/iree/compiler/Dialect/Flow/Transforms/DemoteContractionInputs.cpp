@@ -0,0 +1,197 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cmath>
+
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/Analysis/Attributes/Range.h"
+#include "iree/compiler/Dialect/Util/Analysis/DFX/Solver.h"
+#include "iree/compiler/Dialect/Util/Analysis/DFX/State.h"
+#include "iree/compiler/Dialect/Util/Analysis/Explorer.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/PatternMatch.h"
+
+#define DEBUG_TYPE "iree-flow-demote-contraction-inputs"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+// Candidate ops are the named contractions and convolutions that accept mixed
+// input and output element types. Their accumulation happens in the output
+// element type so demoting only the inputs keeps reductions in f32.
+static bool isCandidateOp(Operation *op) {
+  return isa<linalg::MatmulOp, linalg::BatchMatmulOp, linalg::MatvecOp,
+             linalg::VecmatOp, linalg::Conv2DNhwcHwcfOp,
+             linalg::Conv2DNchwFchwOp, linalg::DepthwiseConv2DNhwcHwcOp>(op);
+}
+
+// Recreates the named |op| with |inputs| so that its region is rebuilt for the
+// new input element types.
+template <typename OpTy>
+static Operation *recreateNamedOp(OpTy op, ValueRange inputs,
+                                  RewriterBase &rewriter) {
+  return rewriter.create<OpTy>(op.getLoc(), op->getResultTypes(), inputs,
+                               op.getOutputs(),
+                               linalg::getPrunedAttributeList(op));
+}
+static Operation *recreateNamedOp(linalg::LinalgOp linalgOp,
+                                  ValueRange inputs, RewriterBase &rewriter) {
+  return TypeSwitch<Operation *, Operation *>(linalgOp.getOperation())
+      .Case<linalg::MatmulOp, linalg::BatchMatmulOp, linalg::MatvecOp,
+            linalg::VecmatOp, linalg::Conv2DNhwcHwcfOp,
+            linalg::Conv2DNchwFchwOp, linalg::DepthwiseConv2DNhwcHwcOp>(
+          [&](auto op) { return recreateNamedOp(op, inputs, rewriter); })
+      .Default([](Operation *) { return nullptr; });
+}
+
+class DemoteContractionInputsPass
+    : public DemoteContractionInputsBase<DemoteContractionInputsPass> {
+ public:
+  DemoteContractionInputsPass(std::string demoteType,
+                              bool allowUnboundedRanges, bool report) {
+    this->demoteType = demoteType;
+    this->allowUnboundedRanges = allowUnboundedRanges;
+    this->report = report;
+  }
+  DemoteContractionInputsPass(const DemoteContractionInputsPass &pass)
+      : DemoteContractionInputsPass(pass.demoteType, pass.allowUnboundedRanges,
+                                    pass.report) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, IREE::Util::UtilDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    FloatType targetType;
+    if (demoteType == "f16") {
+      targetType = FloatType::getF16(context);
+    } else if (demoteType == "bf16") {
+      targetType = FloatType::getBF16(context);
+    } else {
+      getOperation()->emitError()
+          << "unsupported demotion type '" << demoteType
+          << "'; expected f16 or bf16";
+      return signalPassFailure();
+    }
+    targetMaxValue =
+        APFloat::getLargest(targetType.getFloatSemantics()).convertToDouble();
+
+    SmallVector<linalg::LinalgOp> candidateOps;
+    getOperation()->walk([&](linalg::LinalgOp linalgOp) {
+      if (!isCandidateOp(linalgOp) || !linalgOp.hasTensorSemantics()) return;
+      auto isF32 = [](Type type) { return getElementTypeOrSelf(type).isF32(); };
+      bool allF32 =
+          llvm::all_of(linalgOp.getDpsInputOperands(),
+                       [&](OpOperand *input) {
+                         return isF32(input->get().getType());
+                       }) &&
+          llvm::all_of(linalgOp->getResultTypes(), isF32);
+      if (allF32) candidateOps.push_back(linalgOp);
+    });
+    if (candidateOps.empty()) return;
+
+    Explorer explorer(getOperation(), TraversalAction::SHALLOW);
+    llvm::BumpPtrAllocator allocator;
+    DFX::Solver solver(explorer, allocator);
+    for (auto linalgOp : candidateOps) {
+      for (OpOperand *input : linalgOp.getDpsInputOperands()) {
+        solver.getOrCreateElementFor<IREE::Util::FloatRangeValueElement>(
+            Position::forValue(input->get()));
+      }
+    }
+    if (failed(solver.run())) {
+      return signalPassFailure();
+    }
+
+    IRRewriter rewriter(context);
+    for (auto linalgOp : candidateOps) {
+      std::string reason;
+      if (!canDemoteInputs(linalgOp, solver, reason)) {
+        LLVM_DEBUG(llvm::dbgs() << "keeping " << linalgOp->getName()
+                                << " in f32: " << reason << "\n");
+        if (report) {
+          linalgOp.emitRemark() << "kept in f32: " << reason;
+        }
+        continue;
+      }
+      demoteInputs(linalgOp, targetType, rewriter);
+    }
+  }
+
+ private:
+  // Returns true if all inputs of |linalgOp| are known to fit in the target
+  // type. Otherwise populates |reason| with why they may not.
+  bool canDemoteInputs(linalg::LinalgOp linalgOp, DFX::Solver &solver,
+                       std::string &reason) {
+    for (OpOperand *input : linalgOp.getDpsInputOperands()) {
+      auto *elt = solver.lookupElementFor<IREE::Util::FloatRangeValueElement>(
+          Position::forValue(input->get()));
+      IREE::Util::FloatRangeStats stats =
+          elt ? elt->getKnown() : IREE::Util::FloatRangeStats::getWidest();
+      if (stats.isInvalid() || !stats.isFinite()) {
+        if (allowUnboundedRanges) continue;
+        reason = "input " + std::to_string(input->getOperandNumber()) +
+                 " has an unbounded range";
+        return false;
+      }
+      double maxMagnitude =
+          std::max(std::abs(stats.minValue), std::abs(stats.maxValue));
+      if (maxMagnitude > targetMaxValue) {
+        reason = "input " + std::to_string(input->getOperandNumber()) +
+                 " range exceeds " + demoteType;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Truncates the inputs of |linalgOp| to |targetType| and replaces it with an
+  // equivalent op that extends them back to f32 for accumulation.
+  void demoteInputs(linalg::LinalgOp linalgOp, FloatType targetType,
+                    IRRewriter &rewriter) {
+    rewriter.setInsertionPoint(linalgOp);
+    SmallVector<Value> newInputs;
+    for (OpOperand *input : linalgOp.getDpsInputOperands()) {
+      Value value = input->get();
+      Type newType = targetType;
+      if (auto shapedType = value.getType().dyn_cast<ShapedType>()) {
+        newType = shapedType.clone(targetType);
+      }
+      newInputs.push_back(
+          rewriter.create<arith::TruncFOp>(value.getLoc(), newType, value));
+    }
+    Operation *newOp = recreateNamedOp(linalgOp, newInputs, rewriter);
+    if (report) {
+      newOp->emitRemark() << "inputs demoted to " << demoteType;
+    }
+    rewriter.replaceOp(linalgOp, newOp->getResults());
+  }
+
+  double targetMaxValue = 0.0;
+};
+
+}  // namespace
+
+std::unique_ptr<Pass> createDemoteContractionInputsPass(
+    std::string demoteType, bool allowUnboundedRanges, bool report) {
+  return std::make_unique<DemoteContractionInputsPass>(
+      demoteType, allowUnboundedRanges, report);
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -654,6 +654,97 @@ static void fuseRootsWithProducers(MLIRContext *context, Operation *root,
   }
 }
 
+/// Returns true if `op` is a `linalg.generic` that can be part of a reduction
+/// chain rooted at an op with `rootOuterParallelLoops`: either all parallel or
+/// a reduction over the same parallel loops as the root.
+static bool isReductionChainOp(
+    Operation *op, const llvm::SmallBitVector &rootOuterParallelLoops,
+    ArrayRef<int64_t> rootLoopRanges) {
+  auto genericOp = dyn_cast<linalg::GenericOp>(op);
+  if (!genericOp || hasRootOpAttribute(op) || hasFusionGroupsAttribute(op)) {
+    return false;
+  }
+  if (genericOp.getNumReductionLoops() == 0) return true;
+  // All reductions in a chain must share the iteration space of the first so
+  // that the dispatch can be tiled and distributed along the same loops.
+  return getOuterParallelLoops(op) == rootOuterParallelLoops &&
+         genericOp.getStaticLoopRanges() == rootLoopRanges;
+}
+
+/// Fuses chains of reductions and the elementwise ops between and after them
+/// (such as the `max -> sub/exp -> sum -> div` of a softmax) into a single
+/// multi-root fusion group. All ops in the chain must have compatible outer
+/// parallel loops with the leading reduction and only the last op of the chain
+/// may have uses outside of the chain. The last op becomes the root of the
+/// group. Returns the number of groups formed.
+static unsigned fuseReductionChains(MLIRContext *context, Block &block,
+                                    unsigned firstGroup) {
+  unsigned numGroups = 0;
+  for (Operation &op : block) {
+    auto reductionOp = dyn_cast<linalg::GenericOp>(&op);
+    if (!reductionOp || reductionOp.getNumReductionLoops() == 0 ||
+        hasRootOpAttribute(&op) || hasFusionGroupsAttribute(&op)) {
+      continue;
+    }
+    llvm::SmallBitVector rootOuterParallelLoops = getOuterParallelLoops(&op);
+    SmallVector<int64_t> rootLoopRanges = reductionOp.getStaticLoopRanges();
+
+    // Grow the chain forward along the first user of the last op in the chain
+    // as long as it is a compatible elementwise op or reduction.
+    SetVector<Operation *> chain;
+    chain.insert(&op);
+    while (true) {
+      Operation *nextOp = nullptr;
+      for (Operation *user : chain.back()->getUsers()) {
+        if (isa<tensor::DimOp>(user) || chain.contains(user)) continue;
+        if (!nextOp || user->isBeforeInBlock(nextOp)) nextOp = user;
+      }
+      if (!nextOp || nextOp->getBlock() != &block ||
+          !isReductionChainOp(nextOp, rootOuterParallelLoops,
+                              rootLoopRanges)) {
+        break;
+      }
+      if (!llvm::all_of(nextOp->getOpOperands(), [&](OpOperand &operand) {
+            Operation *producer = operand.get().getDefiningOp();
+            return !producer || !chain.contains(producer) ||
+                   hasCompatibleOuterParallelLoops(operand,
+                                                   rootOuterParallelLoops);
+          })) {
+        break;
+      }
+      chain.insert(nextOp);
+    }
+
+    // Intermediate values may not escape the dispatch: drop trailing ops until
+    // all non-dim users of the ops before the last one are in the chain.
+    auto hasEscapingUses = [&]() {
+      return llvm::any_of(
+          chain.getArrayRef().drop_back(), [&](Operation *chainOp) {
+            return llvm::any_of(chainOp->getUsers(), [&](Operation *user) {
+              return !isa<tensor::DimOp>(user) && !chain.contains(user);
+            });
+          });
+    };
+    while (chain.size() > 1 && hasEscapingUses()) chain.pop_back();
+
+    // A single reduction is handled by the default root fusion heuristics.
+    unsigned numReductions = llvm::count_if(chain, [](Operation *chainOp) {
+      return cast<linalg::LinalgOp>(chainOp).getNumReductionLoops() != 0;
+    });
+    if (numReductions < 2) continue;
+
+    unsigned groupNum = firstGroup + numGroups++;
+    setRootAttribute(context, chain.back(), groupNum);
+    for (Operation *chainOp : chain.getArrayRef().drop_back()) {
+      appendToFusionGroup(chainOp, groupNum);
+    }
+    LLVM_DEBUG(llvm::dbgs() << "fused reduction chain of " << chain.size()
+                            << " ops with " << numReductions
+                            << " reductions into group " << groupNum << "\n");
+  }
+  return numGroups;
+}
+
 /// Some heuristic is needed to fuse a dispatchable op with root operations
 /// using tile + fuse. Using some heuristic, each root operation is tagged with
 /// an ID (using an IntegerAttr with name `kRootOpAttr`) and all dispatchable
@@ -669,6 +760,12 @@ static unsigned decideFusableLinalgOps(
   MLIRContext *context = funcOp->getContext();
   OpBuilder builder(context);
   for (Block &block : funcOp.getFunctionBody()) {
+    // Multi-root reduction chains are formed first so that the default
+    // heuristics do not split them across dispatches.
+    if (options.fuseReductionChains) {
+      numRootOps += fuseReductionChains(context, block, numRootOps);
+    }
+
     // Dispatch region formation works by first cloning the root into
     // the dispatch region and then pulling operations in.
     // So procedure here is to
@@ -677,7 +774,10 @@ static unsigned decideFusableLinalgOps(
     SmallVector<Operation *> roots;
     for (Operation &op : llvm::reverse(block)) {
       // Start with a root operation and fuse its producers.
-      if (hasFusionGroupsAttribute(&op) || !isRootOp(&op)) continue;
+      if (hasFusionGroupsAttribute(&op) || hasRootOpAttribute(&op) ||
+          !isRootOp(&op)) {
+        continue;
+      }
       unsigned newGroup = numRootOps++;
       setRootAttribute(context, &op, newGroup);
 
@@ -868,11 +968,13 @@ struct FormDispatchRegionsPass
     generateWorkloadRegion = options.generateWorkloadRegion;
     fusePadWithConsumers = options.fusePadWithConsumers;
     fusePadWithProducers = options.fusePadWithProducers;
+    fuseReductionChains = options.fuseReductionChains;
   }
   FormDispatchRegionsPass(const FormDispatchRegionsPass &other)
       : FormDispatchRegionsPass(FormDispatchRegionsOptions{
             other.fuseMultiUse, other.generateWorkloadRegion,
-            other.fusePadWithConsumers, other.fusePadWithProducers}) {}
+            other.fusePadWithConsumers, other.fusePadWithProducers,
+            other.fuseReductionChains}) {}
 
   void runOnOperation() override;
 };
@@ -884,8 +986,8 @@ void FormDispatchRegionsPass::runOnOperation() {
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
   FormDispatchRegionsOptions options{fuseMultiUse, generateWorkloadRegion,
-                                     fusePadWithConsumers,
-                                     fusePadWithProducers};
+                                     fusePadWithConsumers, fusePadWithProducers,
+                                     fuseReductionChains};
   if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
@@ -0,0 +1,230 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--------------- FuseHorizontalParallelOps.cpp ------------------------===//
+//
+// Fuses independent all-parallel `linalg.generic` ops with the same iteration
+// space into a single multi-result `linalg.generic` so that they are formed
+// into a single dispatch instead of one small dispatch each.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/TilingInterface.h"
+#include "mlir/Transforms/RegionUtils.h"
+
+#define DEBUG_TYPE "iree-flow-fuse-horizontal-parallel-ops"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+// Maximum number of operands of a fused op. Each operand may end up as a
+// separate binding of the dispatch and backends limit the number of bindings.
+static constexpr int64_t kMaxFusedOperandCount = 16;
+
+/// Returns true if `genericOp` may be fused horizontally: an all-parallel
+/// `linalg.generic` on statically shaped tensors outside of dispatches whose
+/// results are not consumed by ops that it could instead be fused into.
+static bool isHorizontalFusionCandidate(linalg::GenericOp genericOp) {
+  if (!genericOp.hasTensorSemantics() || genericOp.hasDynamicShape()) {
+    return false;
+  }
+  if (genericOp.getNumLoops() == 0 ||
+      genericOp.getNumLoops() != genericOp.getNumParallelLoops()) {
+    return false;
+  }
+  if (genericOp->getParentOfType<IREE::Flow::DispatchRegionOp>() ||
+      genericOp->getParentOfType<IREE::Flow::DispatchWorkgroupsOp>()) {
+    return false;
+  }
+  // Merging ops consumed by tileable ops would turn them into multi-use
+  // producers and prevent their fusion with their consumers.
+  return llvm::none_of(genericOp->getUsers(), [](Operation *user) {
+    return isa<TilingInterface>(user);
+  });
+}
+
+/// Returns true if `value` is available before `firstOp`. Operand-less
+/// `tensor.empty` ops are considered available as they are moved before
+/// `firstOp` when fusing.
+static bool isDefinedBefore(Value value, Operation *firstOp) {
+  Operation *definingOp = value.getDefiningOp();
+  // Values defined in a different block are defined in an enclosing region.
+  if (!definingOp || definingOp->getBlock() != firstOp->getBlock()) {
+    return true;
+  }
+  if (isa<tensor::EmptyOp>(definingOp) && definingOp->getNumOperands() == 0) {
+    return true;
+  }
+  return definingOp->isBeforeInBlock(firstOp);
+}
+
+/// Returns true if `genericOp` can be fused into a group of ops whose first op
+/// is `firstOp`. The fused op is created at the position of `firstOp` so all
+/// values used by `genericOp` must be available there. This also guarantees
+/// that `genericOp` does not depend on any op in the group.
+static bool isHorizontallyFusableWith(linalg::GenericOp firstOp,
+                                      linalg::GenericOp genericOp) {
+  if (firstOp.getStaticLoopRanges() != genericOp.getStaticLoopRanges()) {
+    return false;
+  }
+  if (!llvm::all_of(genericOp->getOperands(), [&](Value operand) {
+        return isDefinedBefore(operand, firstOp);
+      })) {
+    return false;
+  }
+  SetVector<Value> capturedValues;
+  getUsedValuesDefinedAbove(genericOp.getRegion(), capturedValues);
+  return llvm::all_of(capturedValues, [&](Value capturedValue) {
+    return isDefinedBefore(capturedValue, firstOp);
+  });
+}
+
+/// Fuses `genericOps` into a single `linalg.generic` inserted at the position
+/// of the first op. Operands, indexing maps and results of the fused op are
+/// the concatenation of those of `genericOps` in order.
+static linalg::GenericOp fuseGenericOpsHorizontally(
+    RewriterBase &rewriter, ArrayRef<linalg::GenericOp> genericOps) {
+  SmallVector<Location> locs;
+  SmallVector<Value> inputs;
+  SmallVector<Value> outputs;
+  SmallVector<AffineMap> inputMaps;
+  SmallVector<AffineMap> outputMaps;
+  SmallVector<Type> resultTypes;
+  for (auto genericOp : genericOps) {
+    locs.push_back(genericOp.getLoc());
+    for (OpOperand *operand : genericOp.getDpsInputOperands()) {
+      inputs.push_back(operand->get());
+      inputMaps.push_back(genericOp.getMatchingIndexingMap(operand));
+    }
+    for (OpOperand *operand : genericOp.getDpsInitOperands()) {
+      outputs.push_back(operand->get());
+      outputMaps.push_back(genericOp.getMatchingIndexingMap(operand));
+    }
+    llvm::append_range(resultTypes, genericOp->getResultTypes());
+  }
+  SmallVector<AffineMap> indexingMaps(inputMaps);
+  llvm::append_range(indexingMaps, outputMaps);
+
+  Operation *firstOp = genericOps.front();
+  for (Value operand : llvm::concat<Value>(inputs, outputs)) {
+    auto emptyOp = operand.getDefiningOp<tensor::EmptyOp>();
+    if (emptyOp && emptyOp->getBlock() == firstOp->getBlock() &&
+        firstOp->isBeforeInBlock(emptyOp)) {
+      emptyOp->moveBefore(firstOp);
+    }
+  }
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(firstOp);
+  auto fusedOp = rewriter.create<linalg::GenericOp>(
+      rewriter.getFusedLoc(locs), resultTypes, inputs, outputs, indexingMaps,
+      genericOps.front().getIteratorTypesArray(),
+      [&](OpBuilder &builder, Location loc, ValueRange args) {
+        ValueRange inputArgs = args.take_front(inputs.size());
+        ValueRange outputArgs = args.drop_front(inputs.size());
+        SmallVector<Value> yieldedValues;
+        for (auto genericOp : genericOps) {
+          Block *body = genericOp.getBody();
+          int64_t numInputs = genericOp.getNumDpsInputs();
+          int64_t numOutputs = genericOp.getNumDpsInits();
+          IRMapping mapping;
+          mapping.map(body->getArguments().take_front(numInputs),
+                      inputArgs.take_front(numInputs));
+          mapping.map(body->getArguments().drop_front(numInputs),
+                      outputArgs.take_front(numOutputs));
+          inputArgs = inputArgs.drop_front(numInputs);
+          outputArgs = outputArgs.drop_front(numOutputs);
+          for (Operation &op : body->without_terminator()) {
+            builder.clone(op, mapping);
+          }
+          for (Value yieldedValue : body->getTerminator()->getOperands()) {
+            yieldedValues.push_back(mapping.lookupOrDefault(yieldedValue));
+          }
+        }
+        builder.create<linalg::YieldOp>(loc, yieldedValues);
+      });
+
+  unsigned resultOffset = 0;
+  for (auto genericOp : genericOps) {
+    unsigned numResults = genericOp->getNumResults();
+    rewriter.replaceOp(genericOp,
+                       fusedOp->getResults().slice(resultOffset, numResults));
+    resultOffset += numResults;
+  }
+  return fusedOp;
+}
+
+struct FuseHorizontalParallelOpsPass
+    : public FuseHorizontalParallelOpsBase<FuseHorizontalParallelOpsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect>();
+  }
+
+  void runOnOperation() override {
+    IRRewriter rewriter(&getContext());
+    getOperation()->walk([&](Block *block) {
+      SmallVector<linalg::GenericOp> candidates;
+      for (auto genericOp : block->getOps<linalg::GenericOp>()) {
+        if (isHorizontalFusionCandidate(genericOp)) {
+          candidates.push_back(genericOp);
+        }
+      }
+
+      // Greedily group each candidate with all later candidates that are
+      // independent of it and share its iteration space.
+      DenseSet<Operation *> groupedOps;
+      SmallVector<SmallVector<linalg::GenericOp>> groups;
+      for (auto [index, firstOp] : llvm::enumerate(candidates)) {
+        if (groupedOps.contains(firstOp)) continue;
+        SmallVector<linalg::GenericOp> group = {firstOp};
+        int64_t operandCount = firstOp->getNumOperands();
+        for (auto genericOp : llvm::drop_begin(candidates, index + 1)) {
+          if (groupedOps.contains(genericOp)) continue;
+          if (operandCount + genericOp->getNumOperands() >
+              kMaxFusedOperandCount) {
+            continue;
+          }
+          if (!isHorizontallyFusableWith(firstOp, genericOp)) continue;
+          group.push_back(genericOp);
+          groupedOps.insert(genericOp);
+          operandCount += genericOp->getNumOperands();
+        }
+        if (group.size() > 1) groups.push_back(std::move(group));
+      }
+
+      for (auto &group : groups) {
+        LLVM_DEBUG(llvm::dbgs() << "fusing " << group.size()
+                                << " independent generic ops\n");
+        fuseGenericOpsHorizontally(rewriter, group);
+      }
+    });
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createFuseHorizontalParallelOpsPass() {
+  return std::make_unique<FuseHorizontalParallelOpsPass>();
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -61,6 +61,24 @@ static llvm::cl::opt<bool> clDemoteF64ToF32(
                    "unconditionally before main flow conversions."),
     llvm::cl::init(true));
 
+static llvm::cl::opt<std::string> clDemoteContractionInputs(
+    "iree-flow-demote-contraction-inputs",
+    llvm::cl::desc("Demotes the f32 inputs of matmuls and convolutions to the "
+                   "given type (f16 or bf16) when float range analysis shows "
+                   "the values fit. Accumulation and all other ops remain in "
+                   "f32."),
+    llvm::cl::init(""));
+static llvm::cl::opt<bool> clDemoteContractionInputsAllowUnbounded(
+    "iree-flow-demote-contraction-inputs-allow-unbounded",
+    llvm::cl::desc("Also demotes contraction inputs whose range could not be "
+                   "bounded by analysis (such as function arguments)."),
+    llvm::cl::init(false));
+static llvm::cl::opt<bool> clDemoteContractionInputsReport(
+    "iree-flow-demote-contraction-inputs-report",
+    llvm::cl::desc("Emits a remark for each matmul and convolution describing "
+                   "whether its inputs were demoted."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clEnablePadHandling(
     "iree-flow-enable-pad-handling",
     llvm::cl::desc("Enable native handling of tensor.pad operations"),
@@ -80,6 +98,25 @@ static llvm::cl::opt<bool> clEnableFuseMultiUse(
     "iree-flow-fuse-multi-use", llvm::cl::desc("Fuse multi-use ops"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableFuseReductionChains(
+    "iree-flow-fuse-reduction-chains",
+    llvm::cl::desc("Fuse chains of reductions and their broadcasting "
+                   "elementwise consumers (such as softmax and layernorm) "
+                   "into a single dispatch"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool> clEnableHorizontalFusion(
+    "iree-flow-enable-horizontal-fusion",
+    llvm::cl::desc("Fuse independent small parallel ops with the same "
+                   "iteration space into a single dispatch"),
+    llvm::cl::init(false));
+
+static llvm::cl::list<int64_t> clDispatchShapeBuckets(
+    "iree-flow-dispatch-shape-buckets",
+    llvm::cl::desc("Comma separated list of likely values of dynamic "
+                   "dimensions to specialize dispatches for"),
+    llvm::cl::CommaSeparated);
+
 static llvm::cl::opt<bool> clDispatchGenerateWorkloadRegion(
     "iree-flow-dispatch-generate-workload-region",
     llvm::cl::desc("Generate the workload region"), llvm::cl::init(true));
@@ -88,6 +125,13 @@ static llvm::cl::opt<bool> clEnableDataTiling(
     "iree-flow-enable-data-tiling", llvm::cl::desc("Enable data tiling path"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableTransposePropagation(
+    "iree-flow-enable-transpose-propagation",
+    llvm::cl::desc("Fold standalone transposes into the indexing maps of the "
+                   "ops consuming or producing the transposed tensors instead "
+                   "of forming them into their own dispatches"),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clNormalizeInputIndexingMap(
     "iree-flow-normalize-input-indexing-map",
     llvm::cl::desc("Enable normalizing input indexing map to identity"),
@@ -206,6 +250,14 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
   passManager.addPass(IREE::Flow::createExpandTensorShapesPass());
   buildGlobalOptimizationPassPipeline(passManager, transformOptions);
 
+  // Selectively demote contraction inputs now that constants have been
+  // evaluated and are visible to range analysis.
+  if (!clDemoteContractionInputs.empty()) {
+    passManager.addPass(IREE::Flow::createDemoteContractionInputsPass(
+        clDemoteContractionInputs, clDemoteContractionInputsAllowUnbounded,
+        clDemoteContractionInputsReport));
+  }
+
   // Transform pad operations into linalg.fill + tensor.insert_slice.
   // This is a WAR for not having native pad handling.
   if (!clEnablePadHandling && !clEnableFusePaddingIntoLinalgProducerOps) {
@@ -220,6 +272,9 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       .addPass(mlir::createConvertElementwiseToLinalgPass)
       .addPass(mlir::createLinalgFoldUnitExtentDimsPass)
       .addPass(createRaiseSpecialOps)
+      // Fold transposes into neighboring ops before fusion decisions are made.
+      .addPredicatedPass(clEnableTransposePropagation,
+                         createPropagateTransposesPass)
       .addPass(createInterchangeGenericOpsPass)
       .addPass(memref::createResolveShapedTypeResultDimsPass)
       .addPass(mlir::createCanonicalizerPass)
@@ -241,8 +296,31 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       // transpose.
       .addPredicatedPass(clNormalizeInputIndexingMap,
                          createInterchangeTransposeGenericOpsPass)
+      // Merge independent parallel ops after elementwise fusion so that they
+      // do not each become their own small dispatch.
+      .addPredicatedPass(clEnableHorizontalFusion,
+                         createFuseHorizontalParallelOpsPass)
       // Enable data tiling after all linalg level transformations.
-      .addPredicatedPass(clEnableDataTiling, createSetEncodingPass)
+      .addPredicatedPass(clEnableDataTiling, createSetEncodingPass);
+
+  // Encodings of constant values (such as weights) are hoisted into
+  // initializers so that they are packed once at startup instead of on every
+  // invocation. When the target layout is known on the host the encodings are
+  // first materialized into pack ops that const-eval can then fold into
+  // prepacked constants.
+  if (clEnableDataTiling) {
+    if (transformOptions.buildMaterializeEncodingsPassPipeline) {
+      transformOptions.buildMaterializeEncodingsPassPipeline(passManager);
+    }
+    if (transformOptions.constExprHoisting) {
+      passManager.addPass(IREE::Util::createHoistIntoGlobalsPass());
+    }
+    if (transformOptions.buildConstEvalPassPipeline) {
+      transformOptions.buildConstEvalPassPipeline(passManager);
+    }
+  }
+
+  FunctionLikeNest(passManager)
       ////////////////////////////////////////////////////////////////////////
       // Dispatch region formation.
       .addPredicatedPass(!clDispatchTransformFileName.empty(),
@@ -259,7 +337,8 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
         return createFormDispatchRegionsPass(FormDispatchRegionsOptions{
             clEnableFuseMultiUse, clDispatchGenerateWorkloadRegion,
             clEnableFusePaddingIntoLinalgConsumerOps,
-            clEnableFusePaddingIntoLinalgProducerOps});
+            clEnableFusePaddingIntoLinalgProducerOps,
+            clEnableFuseReductionChains});
       })
       // Collapse dimensions of linalg Ops.
       .addPass(createCollapseDimensionsPass)
@@ -282,6 +361,10 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       // Initialize any empty tensors to zero.
       .addPass([&]() {
         return createInitializeEmptyTensorsPass(clZeroFillEmptyTensors);
+      })
+      // Specialize dispatches with dynamic shapes for likely shape buckets.
+      .addPredicatedPass(!clDispatchShapeBuckets.empty(), [&]() {
+        return createSpecializeDispatchShapesPass(clDispatchShapeBuckets);
       });
 
   // Module pass to outline the dispatch regions into their own functions
@@ -8,6 +8,7 @@
 #define IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_PASSES_H_
 
 #include <functional>
+#include <string>
 
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "llvm/ADT/StringMap.h"
@@ -38,6 +39,14 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
   // because constant-evaluators can depend on the whole compiler, of which
   // this is a part, and we maintain strict optionality for this component.
   std::function<void(OpPassManager &passManager)> buildConstEvalPassPipeline;
+
+  // Hook to populate a pass pipeline materializing data-tiling encodings in
+  // host code into target-specific layouts. If nullptr, then encodings are only
+  // materialized by the target backends within dispatches. This must be
+  // injected in because the layouts are chosen by codegen, which depends on
+  // flow.
+  std::function<void(OpPassManager &passManager)>
+      buildMaterializeEncodingsPassPipeline;
 };
 
 // Adds a set of passes to the given pass manager that run the required flow
@@ -87,9 +96,21 @@ std::unique_ptr<Pass> createConvertRegionToWorkgroupsPass();
 std::unique_ptr<Pass> createTensorPadToTensorInsertSlicePass(
     bool skipSingleLinalgOpUses = false);
 
+// Creates a pass that demotes the f32 inputs of matmuls and convolutions to
+// |demoteType| (f16 or bf16) when float range analysis shows the values fit.
+// Accumulation remains in f32 and all other ops are left unchanged.
+std::unique_ptr<Pass> createDemoteContractionInputsPass(
+    std::string demoteType = "f16", bool allowUnboundedRanges = false,
+    bool report = false);
+
 // Create a pass to detach elementwise ops from named Linalg ops.
 std::unique_ptr<Pass> createDetachElementwiseFromNamedOpsPass();
 
+// Creates a pass to fuse independent all-parallel linalg.generic ops with the
+// same iteration space into a single multi-result linalg.generic.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createFuseHorizontalParallelOpsPass();
+
 // Creates a pass to fuse Linalg operations on tensors.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createFusionOfTensorOpsPass(bool fuseMultiUse = false,
@@ -149,6 +170,7 @@ struct FormDispatchRegionsOptions {
   bool generateWorkloadRegion = true;
   bool fusePadWithConsumers = false;
   bool fusePadWithProducers = false;
+  bool fuseReductionChains = false;
 };
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createFormDispatchRegionsPass(FormDispatchRegionsOptions options = {});
@@ -182,6 +204,12 @@ createDispatchWithTransformDialect(
     llvm::StringRef debugPayloadRootTag = llvm::StringRef(),
     llvm::StringRef debugTransformRootTag = llvm::StringRef());
 
+// Specializes runs of dispatches whose shapes depend on a single dynamic
+// dimension for each value in `shapeBuckets`, falling back to the original
+// dispatches for all other values.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createSpecializeDispatchShapesPass(ArrayRef<int64_t> shapeBuckets = {});
+
 // Captures dynamic shape dimensions required by dispatch operands.
 std::unique_ptr<Pass> createCaptureDispatchDynamicDimsPass();
 
@@ -189,6 +217,11 @@ std::unique_ptr<Pass> createCaptureDispatchDynamicDimsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createOutlineDispatchRegionsPass();
 
+// Creates a pass that folds standalone transposes into the indexing maps of
+// the linalg ops consuming or producing the transposed tensors.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createPropagateTransposesPass();
+
 // Injects tracing markers for dispatch operation tensor inputs and outputs.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createInjectDispatchTracingPass();
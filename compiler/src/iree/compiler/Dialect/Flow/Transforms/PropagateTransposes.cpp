@@ -0,0 +1,286 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--------------- PropagateTransposes.cpp ------------------------------===//
+//
+// Removes standalone transposes by folding them into the indexing maps of the
+// ops that consume or produce the transposed tensors. Without this transposes
+// between named ops (such as those left by layout conversions on imported
+// NCHW models) become their own dispatches that only move memory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/PatternMatch.h"
+
+#define DEBUG_TYPE "iree-flow-propagate-transposes"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+/// Returns the map from result indices to source indices if `op` is a pure
+/// transpose: a single-input all-parallel op that only forwards its input
+/// through permuted indexing maps that are not equivalent to a copy.
+static std::optional<AffineMap> getTransposeMap(linalg::LinalgOp op) {
+  if (!op.hasTensorSemantics() || op.getNumDpsInputs() != 1 ||
+      op.getNumDpsInits() != 1 || op.getNumLoops() == 0 ||
+      op.getNumLoops() != op.getNumParallelLoops()) {
+    return std::nullopt;
+  }
+  if (op->getParentOfType<IREE::Flow::DispatchRegionOp>() ||
+      op->getParentOfType<IREE::Flow::DispatchWorkgroupsOp>()) {
+    return std::nullopt;
+  }
+  AffineMap inputMap = op.getMatchingIndexingMap(op.getDpsInputOperand(0));
+  AffineMap outputMap = op.getMatchingIndexingMap(op.getDpsInitOperand(0));
+  if (!inputMap.isPermutation() || !outputMap.isPermutation()) {
+    return std::nullopt;
+  }
+  Block *body = op.getBlock();
+  auto yieldOp = dyn_cast<linalg::YieldOp>(body->getTerminator());
+  if (!llvm::hasSingleElement(*body) || !yieldOp ||
+      yieldOp.getNumOperands() != 1 ||
+      yieldOp.getOperand(0) != body->getArgument(0)) {
+    return std::nullopt;
+  }
+  // result[j] = source[inputMap(outputMap^-1(j))]
+  AffineMap map = inputMap.compose(inversePermutation(outputMap));
+  if (map.isIdentity()) return std::nullopt;
+  return map;
+}
+
+/// Returns true if named `op` may be generalized to absorb a transpose. This is
+/// limited to contractions and transposes as all backends handle their generic
+/// forms while others (such as convolutions) rely on their named forms.
+static bool isGeneralizable(linalg::LinalgOp op) {
+  return isa<linalg::TransposeOp>(op) || linalg::isaContractionOpInterface(op);
+}
+
+/// Returns true if `use` of a transposed tensor can read the transpose source
+/// instead by composing its indexing map with the transpose.
+static bool canAbsorbIntoConsumer(OpOperand &use, bool allowGeneralization) {
+  auto linalgOp = dyn_cast<linalg::LinalgOp>(use.getOwner());
+  if (!linalgOp || !linalgOp.hasTensorSemantics() ||
+      !linalgOp.isDpsInput(&use)) {
+    return false;
+  }
+  if (linalgOp->getParentOfType<IREE::Flow::DispatchRegionOp>() ||
+      linalgOp->getParentOfType<IREE::Flow::DispatchWorkgroupsOp>()) {
+    return false;
+  }
+  if (isa<linalg::GenericOp>(linalgOp)) return true;
+  return allowGeneralization && isGeneralizable(linalgOp);
+}
+
+/// Returns `op` as a generic op, generalizing it if it is a named op.
+static FailureOr<linalg::GenericOp> getOrGeneralize(RewriterBase &rewriter,
+                                                    linalg::LinalgOp op) {
+  if (auto genericOp = dyn_cast<linalg::GenericOp>(op.getOperation())) {
+    return genericOp;
+  }
+  rewriter.setInsertionPoint(op);
+  return linalg::generalizeNamedOp(rewriter, op);
+}
+
+/// Rewrites all consumers of `transposeOp` to read its source directly.
+static LogicalResult absorbIntoConsumers(RewriterBase &rewriter,
+                                         linalg::LinalgOp transposeOp,
+                                         AffineMap map) {
+  Value source = transposeOp.getDpsInputOperand(0)->get();
+  // Each user is visited once as generalizing a named op replaces it and all
+  // of its uses of the transpose are updated together.
+  llvm::SetVector<Operation *> users;
+  for (Operation *user : transposeOp->getResult(0).getUsers()) {
+    users.insert(user);
+  }
+  for (Operation *user : users) {
+    FailureOr<linalg::GenericOp> genericOp =
+        getOrGeneralize(rewriter, cast<linalg::LinalgOp>(user));
+    if (failed(genericOp)) return failure();
+    // Generalization preserves the operand order so the indexing maps can be
+    // updated for every use of the transpose in the op at once.
+    SmallVector<AffineMap> maps = genericOp->getIndexingMapsArray();
+    rewriter.updateRootInPlace(*genericOp, [&]() {
+      for (OpOperand &operand : genericOp.value()->getOpOperands()) {
+        if (operand.get() != transposeOp->getResult(0)) continue;
+        unsigned index = operand.getOperandNumber();
+        maps[index] = map.compose(maps[index]);
+        operand.set(source);
+      }
+      genericOp->setIndexingMapsAttr(rewriter.getAffineMapArrayAttr(maps));
+    });
+  }
+  rewriter.eraseOp(transposeOp);
+  return success();
+}
+
+/// Creates a tensor of the `transposeOp` result type before `producer` for the
+/// producer to write the transposed result into. If the producer payload reads
+/// `init` it must be a fill which is recreated with the transposed type.
+static FailureOr<Value> createTransposedInit(RewriterBase &rewriter,
+                                             DominanceInfo &dominanceInfo,
+                                             linalg::LinalgOp transposeOp,
+                                             linalg::LinalgOp producer,
+                                             OpOperand *init) {
+  auto resultType =
+      transposeOp->getResult(0).getType().cast<RankedTensorType>();
+  SmallVector<Value> dynamicSizes;
+  if (!resultType.hasStaticShape()) {
+    auto emptyOp = transposeOp.getDpsInitOperand(0)
+                       ->get()
+                       .getDefiningOp<tensor::EmptyOp>();
+    if (!emptyOp ||
+        llvm::any_of(emptyOp.getDynamicSizes(), [&](Value size) {
+          return !dominanceInfo.properlyDominates(size, producer);
+        })) {
+      return failure();
+    }
+    dynamicSizes = llvm::to_vector(emptyOp.getDynamicSizes());
+  }
+
+  linalg::FillOp fillOp;
+  if (producer.payloadUsesValueFromOperand(init)) {
+    fillOp = init->get().getDefiningOp<linalg::FillOp>();
+    if (!fillOp) return failure();
+  }
+
+  rewriter.setInsertionPoint(producer);
+  Value newInit = rewriter.create<tensor::EmptyOp>(
+      producer.getLoc(), resultType, dynamicSizes);
+  if (fillOp) {
+    newInit = rewriter
+                  .create<linalg::FillOp>(fillOp.getLoc(), fillOp.getInputs(),
+                                          newInit)
+                  .getResult(0);
+  }
+  return newInit;
+}
+
+/// Rewrites the producer of the `transposeOp` source to write the transposed
+/// result directly.
+static LogicalResult
+absorbIntoProducer(RewriterBase &rewriter, DominanceInfo &dominanceInfo,
+                   linalg::LinalgOp transposeOp, AffineMap map,
+                   bool allowGeneralization) {
+  auto source = transposeOp.getDpsInputOperand(0)->get().dyn_cast<OpResult>();
+  if (!source || !source.hasOneUse()) return failure();
+  auto producer = dyn_cast<linalg::LinalgOp>(source.getOwner());
+  if (!producer || !producer.hasTensorSemantics()) return failure();
+  if (!isa<linalg::GenericOp>(producer) &&
+      !(allowGeneralization && isGeneralizable(producer))) {
+    return failure();
+  }
+
+  unsigned resultNumber = source.getResultNumber();
+  FailureOr<Value> newInit =
+      createTransposedInit(rewriter, dominanceInfo, transposeOp, producer,
+                           producer.getDpsInitOperand(resultNumber));
+  if (failed(newInit)) return failure();
+  FailureOr<linalg::GenericOp> genericOp = getOrGeneralize(rewriter, producer);
+  if (failed(genericOp)) return failure();
+
+  // source[i] = result[map^-1(i)]
+  SmallVector<AffineMap> maps = genericOp->getIndexingMapsArray();
+  OpOperand *initOperand = genericOp->getDpsInitOperand(resultNumber);
+  unsigned index = initOperand->getOperandNumber();
+  maps[index] = inversePermutation(map).compose(maps[index]);
+  rewriter.updateRootInPlace(*genericOp, [&]() {
+    initOperand->set(*newInit);
+    genericOp->getResult(resultNumber).setType(newInit->getType());
+    genericOp->setIndexingMapsAttr(rewriter.getAffineMapArrayAttr(maps));
+  });
+  rewriter.replaceOp(transposeOp, genericOp->getResult(resultNumber));
+  return success();
+}
+
+/// Folds `transposeOp` into its consumers or producer if possible.
+///
+/// Either side removes the transpose and its memory traffic entirely so the
+/// choice is made to keep named ops intact where possible: backends handle
+/// named contractions with better heuristics than their generic forms. In
+/// order of preference the transpose is folded into
+///   1. its consumers when they are all generic ops,
+///   2. its producer when it is a generic op,
+///   3. its consumers when named ones need to be generalized,
+///   4. its producer when it needs to be generalized.
+/// Transposes that cannot be folded are left to dispatch region formation.
+static LogicalResult propagateTranspose(RewriterBase &rewriter,
+                                        DominanceInfo &dominanceInfo,
+                                        linalg::LinalgOp transposeOp,
+                                        AffineMap map) {
+  Value result = transposeOp->getResult(0);
+  if (result.use_empty()) return failure();
+  for (bool allowGeneralization : {false, true}) {
+    if (llvm::all_of(result.getUses(), [&](OpOperand &use) {
+          return canAbsorbIntoConsumer(use, allowGeneralization);
+        })) {
+      LLVM_DEBUG(llvm::dbgs() << "folding transpose into its consumers: "
+                              << transposeOp << "\n");
+      return absorbIntoConsumers(rewriter, transposeOp, map);
+    }
+    if (succeeded(absorbIntoProducer(rewriter, dominanceInfo, transposeOp, map,
+                                     allowGeneralization))) {
+      LLVM_DEBUG(llvm::dbgs() << "folded transpose into its producer\n");
+      return success();
+    }
+  }
+  return failure();
+}
+
+struct PropagateTransposesPass
+    : public PropagateTransposesBase<PropagateTransposesPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect, tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    auto funcOp = getOperation();
+    IRRewriter rewriter(&getContext());
+    DominanceInfo dominanceInfo(funcOp);
+
+    // Each successful propagation erases one transpose and may turn one of its
+    // consumers into a new transpose (of the composed permutation) so this
+    // always terminates. The walk is restarted after every change as the
+    // rewrites may erase ops that were already visited.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      funcOp.walk([&](linalg::LinalgOp op) {
+        std::optional<AffineMap> map = getTransposeMap(op);
+        if (!map) return WalkResult::advance();
+        if (failed(propagateTranspose(rewriter, dominanceInfo, op, *map))) {
+          return WalkResult::advance();
+        }
+        changed = true;
+        return WalkResult::interrupt();
+      });
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createPropagateTransposesPass() {
+  return std::make_unique<PropagateTransposesPass>();
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,260 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- SpecializeDispatchShapes.cpp - Specialize dispatches on shapes -----===//
+//
+// Specializes runs of dispatches whose shapes depend on a single dynamic
+// dimension for a list of likely values (shape buckets). For example, with
+// buckets 128 and 256 it converts
+//
+//   %0 = flow.dispatch.workgroups(%arg0, %d) : (tensor<?x4xf32>{%d}, index)
+//   ...
+//
+// into
+//
+//   %c128 = arith.constant 128 : index
+//   %is128 = arith.cmpi eq, %d, %c128 : index
+//   cf.cond_br %is128, ^bb128, ^bb1
+// ^bb128:
+//   %0 = flow.dispatch.workgroups(%arg0, %c128) ... with %c128 inlined
+//   cf.br ^merge(%0)
+// ^bb1:
+//   %c256 = arith.constant 256 : index
+//   ...
+// ^default:
+//   %0 = flow.dispatch.workgroups(%arg0, %d) : (tensor<?x4xf32>{%d}, index)
+//   cf.br ^merge(%0)
+// ^merge(%result: tensor<?x4xf32>):
+//
+// Each specialized dispatch is outlined into its own executable that is
+// compiled with static shapes while the original dynamic dispatch remains as
+// the fallback for all other values.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Flow/IR/FlowDialect.h"
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#define DEBUG_TYPE "iree-flow-specialize-dispatch-shapes"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+// Returns the unique non-constant dynamic dimension of the operands and results
+// of |dispatchOp|, a null value if all shapes are static, or failure if the
+// shapes depend on multiple dynamic dimensions.
+static FailureOr<Value> getUniqueDynamicDim(
+    IREE::Flow::DispatchWorkgroupsOp dispatchOp) {
+  Value uniqueDim;
+  for (Value dim : llvm::concat<Value>(dispatchOp.getArgumentDims(),
+                                       dispatchOp.getResultDims())) {
+    if (matchPattern(dim, m_Constant())) continue;
+    if (uniqueDim && uniqueDim != dim) return failure();
+    uniqueDim = dim;
+  }
+  return uniqueDim;
+}
+
+// A contiguous range of ops within a block whose dispatches depend on the
+// same dynamic dimension.
+struct SpecializationRange {
+  Value dim;
+  SmallVector<Operation *> ops;
+};
+
+// Returns true if |op| may be part of a specialization range without being a
+// dispatch. Such ops are cloned into each specialization.
+static bool isClonableIntoRange(Operation *op) {
+  return op->getNumRegions() == 0 && !op->hasTrait<OpTrait::IsTerminator>() &&
+         isMemoryEffectFree(op);
+}
+
+// Finds all ranges of ops in |block| that can be specialized. Each range
+// starts and ends with a dispatch depending on the range dimension and only
+// contains dispatches whose shapes are either static or depend on it.
+static SmallVector<SpecializationRange> findSpecializationRanges(
+    Block *block) {
+  SmallVector<SpecializationRange> ranges;
+  std::optional<SpecializationRange> currentRange;
+  SmallVector<Operation *> pendingOps;
+  auto closeRange = [&]() {
+    if (currentRange) ranges.push_back(std::move(*currentRange));
+    currentRange.reset();
+    pendingOps.clear();
+  };
+  for (auto &op : *block) {
+    auto dispatchOp = dyn_cast<IREE::Flow::DispatchWorkgroupsOp>(op);
+    if (!dispatchOp) {
+      if (currentRange && isClonableIntoRange(&op)) {
+        pendingOps.push_back(&op);
+      } else {
+        closeRange();
+      }
+      continue;
+    }
+    auto dim = getUniqueDynamicDim(dispatchOp);
+    if (failed(dim) || (currentRange && *dim && *dim != currentRange->dim)) {
+      closeRange();
+      if (failed(dim)) continue;
+    }
+    if (!currentRange) {
+      if (!*dim) continue;
+      currentRange = SpecializationRange{*dim, {}};
+    }
+    llvm::append_range(currentRange->ops, pendingOps);
+    pendingOps.clear();
+    currentRange->ops.push_back(dispatchOp);
+  }
+  closeRange();
+  return ranges;
+}
+
+// Replaces uses of the dispatch arguments that are |constantValue| within the
+// body of |dispatchOp| with the constant so that the shapes are static within
+// the outlined executable.
+static void inlineConstantArguments(IREE::Flow::DispatchWorkgroupsOp dispatchOp,
+                                    Value constantValue,
+                                    IntegerAttr constantAttr) {
+  OpBuilder builder = OpBuilder::atBlockBegin(&dispatchOp.getBody().front());
+  Value inlinedValue;
+  for (auto [index, argument] : llvm::enumerate(dispatchOp.getArguments())) {
+    if (argument != constantValue) continue;
+    if (!inlinedValue) {
+      inlinedValue = builder.create<arith::ConstantOp>(constantValue.getLoc(),
+                                                       constantAttr);
+    }
+    dispatchOp.getInputBlockArgument(index).replaceAllUsesWith(inlinedValue);
+  }
+}
+
+// Specializes |range| for each value in |shapeBuckets|. The ops in the range
+// are moved into a fallback block that is branched to when the dimension
+// matches none of the buckets.
+static void specializeRange(const SpecializationRange &range,
+                            ArrayRef<int64_t> shapeBuckets) {
+  Operation *firstOp = range.ops.front();
+  Operation *lastOp = range.ops.back();
+  Block *block = firstOp->getBlock();
+  Location loc = firstOp->getLoc();
+
+  // Values produced within the range that are used after it.
+  DenseSet<Operation *> rangeOps(range.ops.begin(), range.ops.end());
+  SmallVector<Value> escapingValues;
+  for (auto *op : range.ops) {
+    for (auto result : op->getResults()) {
+      if (llvm::any_of(result.getUsers(), [&](Operation *user) {
+            return !rangeOps.contains(block->findAncestorOpInBlock(*user));
+          })) {
+        escapingValues.push_back(result);
+      }
+    }
+  }
+
+  // Split the block around the range, moving the original ops into the
+  // fallback block.
+  Block *mergeBlock = block->splitBlock(std::next(lastOp->getIterator()));
+  Block *fallbackBlock = block->splitBlock(firstOp->getIterator());
+  for (auto escapingValue : escapingValues) {
+    auto mergeArg = mergeBlock->addArgument(escapingValue.getType(),
+                                            escapingValue.getLoc());
+    escapingValue.replaceUsesWithIf(mergeArg, [&](OpOperand &use) {
+      return use.getOwner()->getBlock() != fallbackBlock;
+    });
+  }
+  OpBuilder builder = OpBuilder::atBlockEnd(fallbackBlock);
+  builder.create<cf::BranchOp>(loc, mergeBlock, escapingValues);
+
+  // Build the chain of bucket tests with one specialized clone of the range
+  // per bucket.
+  Block *testBlock = block;
+  for (auto [index, bucket] : llvm::enumerate(shapeBuckets)) {
+    Block *bucketBlock = builder.createBlock(fallbackBlock);
+    Block *nextBlock = index + 1 == shapeBuckets.size()
+                           ? fallbackBlock
+                           : builder.createBlock(fallbackBlock);
+
+    builder.setInsertionPointToEnd(testBlock);
+    auto bucketAttr = builder.getIndexAttr(bucket);
+    Value bucketValue = builder.create<arith::ConstantOp>(loc, bucketAttr);
+    Value isBucket = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, range.dim, bucketValue);
+    builder.create<cf::CondBranchOp>(loc, isBucket, bucketBlock, ValueRange{},
+                                     nextBlock, ValueRange{});
+
+    builder.setInsertionPointToEnd(bucketBlock);
+    IRMapping mapping;
+    mapping.map(range.dim, bucketValue);
+    for (auto &op : fallbackBlock->without_terminator()) {
+      auto *clonedOp = builder.clone(op, mapping);
+      if (auto dispatchOp =
+              dyn_cast<IREE::Flow::DispatchWorkgroupsOp>(clonedOp)) {
+        inlineConstantArguments(dispatchOp, bucketValue, bucketAttr);
+      }
+    }
+    SmallVector<Value> bucketResults = llvm::to_vector(llvm::map_range(
+        escapingValues, [&](Value value) { return mapping.lookup(value); }));
+    builder.create<cf::BranchOp>(loc, mergeBlock, bucketResults);
+
+    testBlock = nextBlock;
+  }
+}
+
+struct SpecializeDispatchShapesPass
+    : public SpecializeDispatchShapesBase<SpecializeDispatchShapesPass> {
+  SpecializeDispatchShapesPass(ArrayRef<int64_t> shapeBuckets) {
+    this->shapeBuckets = shapeBuckets;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, cf::ControlFlowDialect,
+                    IREE::Flow::FlowDialect>();
+  }
+
+  void runOnOperation() override {
+    if (shapeBuckets.empty()) return;
+    auto funcOp = getOperation();
+    if (funcOp.isExternal()) return;
+
+    // Only blocks of the function body are split; nested regions (such as
+    // those of scf ops) may not have multiple blocks.
+    SmallVector<SpecializationRange> ranges;
+    for (auto &block : funcOp.getFunctionBody()) {
+      llvm::append_range(ranges, findSpecializationRanges(&block));
+    }
+    for (auto &range : ranges) {
+      LLVM_DEBUG(llvm::dbgs() << "specializing " << range.ops.size()
+                              << " ops for " << shapeBuckets.size()
+                              << " shape buckets\n");
+      specializeRange(range, shapeBuckets);
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createSpecializeDispatchShapesPass(ArrayRef<int64_t> shapeBuckets) {
+  return std::make_unique<SpecializeDispatchShapesPass>(shapeBuckets);
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -29,11 +29,96 @@ static llvm::cl::opt<int64_t> splitReductionRatio(
     "iree-flow-split-matmul-reduction", llvm::cl::desc("split ratio"),
     llvm::cl::init(1));
 
+static llvm::cl::opt<int64_t> splitSkinnyMatmulTargetWorkgroups(
+    "iree-flow-split-skinny-matmul-target-workgroups",
+    llvm::cl::desc("split the reduction of static matmuls whose output is too "
+                   "small to fill this many workgroups (0 to disable)"),
+    llvm::cl::init(0));
+
 static llvm::cl::list<int64_t> topkSplitReductionRatio(
     "iree-flow-topk-split-reduction",
     llvm::cl::desc("comma separated list of split ratios"),
     llvm::cl::CommaSeparated);
 
+static llvm::cl::opt<int64_t> topkSplitReductionBlockSize(
+    "iree-flow-topk-split-reduction-block-size",
+    llvm::cl::desc("split the reduction of static top-k ops larger than this "
+                   "many elements into blocks of at least this size that are "
+                   "reduced in parallel before a final merge (0 to disable); "
+                   "ignored when explicit split ratios are provided"),
+    llvm::cl::init(0));
+
+static llvm::cl::opt<int64_t> scanSplitReductionBlockSize(
+    "iree-flow-scan-split-reduction-block-size",
+    llvm::cl::desc("split static inclusive scans larger than this many "
+                   "elements into blocks of at least this size that are "
+                   "scanned in parallel before a carry fixup (0 to disable)"),
+    llvm::cl::init(0));
+
+// Nominal workgroup tile of the output and minimum number of reduction
+// iterations left per split used to size split-K of skinny matmuls.
+static constexpr int64_t kSkinnyMatmulTileM = 32;
+static constexpr int64_t kSkinnyMatmulTileN = 128;
+static constexpr int64_t kSkinnyMatmulMinSplitK = 256;
+
+/// Returns the split ratio for |matmulOp| such that its output tiles times the
+/// ratio cover |targetWorkgroups| or 1 if it has enough parallelism already.
+/// The ratio is a power of two that divides K.
+static int64_t getSkinnyMatmulSplitRatio(linalg::MatmulOp matmulOp,
+                                         int64_t targetWorkgroups) {
+  auto lhsType = matmulOp.getDpsInputOperand(0)->get().getType();
+  auto rhsType = matmulOp.getDpsInputOperand(1)->get().getType();
+  auto lhsShape = lhsType.cast<ShapedType>().getShape();
+  auto rhsShape = rhsType.cast<ShapedType>().getShape();
+  if (ShapedType::isDynamicShape(lhsShape) ||
+      ShapedType::isDynamicShape(rhsShape)) {
+    return 1;
+  }
+  int64_t sizeM = lhsShape[0];
+  int64_t sizeK = lhsShape[1];
+  int64_t sizeN = rhsShape[1];
+  int64_t numTiles = llvm::divideCeil(sizeM, kSkinnyMatmulTileM) *
+                     llvm::divideCeil(sizeN, kSkinnyMatmulTileN);
+  int64_t ratio = 1;
+  while (numTiles * ratio < targetWorkgroups && sizeK % (ratio * 2) == 0 &&
+         sizeK / (ratio * 2) >= kSkinnyMatmulMinSplitK) {
+    ratio *= 2;
+  }
+  return ratio;
+}
+
+/// Returns the split ratio for |topkOp| such that each of the parallel blocks
+/// reduces at least |blockSize| elements or 1 if it is small enough already.
+/// The ratio is the largest that divides the reduction dimension.
+static int64_t getTopkSplitRatio(LinalgExt::TopkOp topkOp, int64_t blockSize) {
+  int64_t dimension = topkOp.getDimension();
+  auto inputType = topkOp.getInputType();
+  if (inputType.isDynamicDim(dimension)) return 1;
+  int64_t reductionSize = inputType.getDimSize(dimension);
+  int64_t kSize = topkOp.getResult(0).getType().cast<ShapedType>().getDimSize(
+      dimension);
+  // Each block must produce k candidates for the merge.
+  blockSize = std::max(blockSize, kSize);
+  for (int64_t ratio = reductionSize / blockSize; ratio > 1; --ratio) {
+    if (reductionSize % ratio == 0) return ratio;
+  }
+  return 1;
+}
+
+/// Returns the number of blocks to split the scanned dimension of |scanOp|
+/// into such that each block scans at least |blockSize| elements or 1 if it is
+/// small enough already. The ratio is the largest that divides the dimension.
+static int64_t getScanSplitRatio(LinalgExt::ScanOp scanOp, int64_t blockSize) {
+  int64_t dimension = scanOp.getDimension();
+  ShapedType inputType = scanOp.getOperandType();
+  if (inputType.isDynamicDim(dimension)) return 1;
+  int64_t scanSize = inputType.getDimSize(dimension);
+  for (int64_t ratio = scanSize / blockSize; ratio > 1; --ratio) {
+    if (scanSize % ratio == 0) return ratio;
+  }
+  return 1;
+}
+
 namespace {
 /// Pattern to wrap splitReduction transformation. This also propagates
 /// attributes to allow compilation info attribute to not be lost.
@@ -83,7 +168,10 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
 
   void runOnOperation() override {
     if (splitReductionRatio.getValue() <= 1 &&
-        topkSplitReductionRatio.empty()) {
+        splitSkinnyMatmulTargetWorkgroups.getValue() <= 0 &&
+        topkSplitReductionRatio.empty() &&
+        topkSplitReductionBlockSize.getValue() <= 0 &&
+        scanSplitReductionBlockSize.getValue() <= 0) {
       return;
     }
 
@@ -93,8 +181,15 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
         [&](linalg::LinalgOp op) -> linalg::SplitReductionOptions {
           // For matmul make the new parallel dimension first so that it looks
           // like a batch_matmul and can follow the same codegen.
-          if (isa<linalg::MatmulOp>(op))
-            return {int64_t(splitReductionRatio), 0, /*innerParallel=*/false};
+          if (auto matmulOp = dyn_cast<linalg::MatmulOp>(op.getOperation())) {
+            int64_t ratio = splitReductionRatio;
+            if (ratio <= 1 && splitSkinnyMatmulTargetWorkgroups > 0) {
+              ratio = getSkinnyMatmulSplitRatio(
+                  matmulOp, splitSkinnyMatmulTargetWorkgroups);
+            }
+            if (ratio <= 1) return {int64_t(0), 0, /*innerParallel=*/false};
+            return {ratio, 0, /*innerParallel=*/false};
+          }
           // Currently disable spliting reduction for non-matmul op. This will
           // get enabled after once tests are ready.
           return {int64_t(0), 0, /*innerParallel=*/false};
@@ -103,7 +198,15 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
             ArrayRef<StringAttr>{}, StringAttr::get(&getContext(), "SPLIT")));
 
     LinalgExt::TopkSplitReductionControlFn splitReductionFn =
-        [&](int64_t splitReductionDepth) -> int64_t {
+        [&](LinalgExt::TopkOp topkOp, int64_t splitReductionDepth) -> int64_t {
+      if (topkSplitReductionRatio.empty()) {
+        // A single split gives a two-pass block top-k; the merge only sees
+        // k elements per block and rarely benefits from splitting again.
+        if (splitReductionDepth > 0 || topkSplitReductionBlockSize <= 0) {
+          return -1;
+        }
+        return getTopkSplitRatio(topkOp, topkSplitReductionBlockSize);
+      }
       SmallVector<int64_t, 4> reductionRatios(topkSplitReductionRatio.begin(),
                                               topkSplitReductionRatio.end());
       if (splitReductionDepth >= reductionRatios.size()) {
@@ -117,6 +220,16 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
         LinalgExt::LinalgTransformationFilter(
             ArrayRef<StringAttr>{},
             StringAttr::get(patterns.getContext(), "SPLIT_REDUCTION")));
+    if (scanSplitReductionBlockSize > 0) {
+      LinalgExt::populateScanSplitReductionPattern(
+          patterns,
+          [&](LinalgExt::ScanOp scanOp) -> int64_t {
+            return getScanSplitRatio(scanOp, scanSplitReductionBlockSize);
+          },
+          LinalgExt::LinalgTransformationFilter(
+              ArrayRef<StringAttr>{},
+              StringAttr::get(patterns.getContext(), "SPLIT_REDUCTION")));
+    }
 
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
@@ -0,0 +1,68 @@
+// RUN: iree-opt --split-input-file --iree-flow-demote-contraction-inputs="report=true" --verify-diagnostics %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-flow-demote-contraction-inputs="demote-type=bf16 allow-unbounded-ranges=true" %s | FileCheck %s --check-prefix=UNBOUNDED
+
+// CHECK-LABEL: @demote_bounded_matmul
+// UNBOUNDED-LABEL: @demote_bounded_matmul
+func.func @demote_bounded_matmul(%arg0: tensor<5x3xf32>) -> tensor<5x3xf32> {
+  %lhs = arith.constant dense<[[1.0, -2.0, 3.0], [4.0, 5.0, 6.0], [7.0, 8.0, 9.0], [0.5, 0.25, 0.125], [-1.0, -2.0, -3.0]]> : tensor<5x3xf32>
+  %rhs = arith.constant dense<[[1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 0.0, 1.0]]> : tensor<3x3xf32>
+  // CHECK-DAG: %[[LHS:.+]] = arith.truncf %{{.+}} : tensor<5x3xf32> to tensor<5x3xf16>
+  // CHECK-DAG: %[[RHS:.+]] = arith.truncf %{{.+}} : tensor<3x3xf32> to tensor<3x3xf16>
+  // CHECK: linalg.matmul ins(%[[LHS]], %[[RHS]] : tensor<5x3xf16>, tensor<3x3xf16>) outs(%arg0 : tensor<5x3xf32>)
+  // UNBOUNDED: linalg.matmul ins(%{{.+}}, %{{.+}} : tensor<5x3xbf16>, tensor<3x3xbf16>) outs(%arg0 : tensor<5x3xf32>)
+  // expected-remark @+1 {{inputs demoted to f16}}
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<5x3xf32>, tensor<3x3xf32>) outs(%arg0 : tensor<5x3xf32>) -> tensor<5x3xf32>
+  return %0 : tensor<5x3xf32>
+}
+
+// -----
+
+// Values too large for f16 must stay in f32.
+
+// CHECK-LABEL: @keep_overflowing_matmul
+func.func @keep_overflowing_matmul(%arg0: tensor<1x2xf32>, %arg1: tensor<1x2xf32>) -> tensor<1x2xf32> {
+  %lhs = arith.constant dense<[[1.0e+06]]> : tensor<1x1xf32>
+  %rhs = arith.constant dense<[[1.0, 2.0]]> : tensor<1x2xf32>
+  // CHECK-NOT: arith.truncf
+  // CHECK: linalg.matmul ins(%{{.+}}, %{{.+}} : tensor<1x1xf32>, tensor<1x2xf32>)
+  // expected-remark @+1 {{kept in f32: input 0 range exceeds f16}}
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x1xf32>, tensor<1x2xf32>) outs(%arg0 : tensor<1x2xf32>) -> tensor<1x2xf32>
+  return %0 : tensor<1x2xf32>
+}
+
+// -----
+
+// Inputs with unknown ranges are only demoted when allowed by the policy.
+
+// CHECK-LABEL: @unbounded_batch_matmul
+// UNBOUNDED-LABEL: @unbounded_batch_matmul
+func.func @unbounded_batch_matmul(%arg0: tensor<2x4x8xf32>, %arg1: tensor<2x8x4xf32>, %arg2: tensor<2x4x4xf32>) -> tensor<2x4x4xf32> {
+  // CHECK-NOT: arith.truncf
+  // UNBOUNDED-DAG: %[[LHS:.+]] = arith.truncf %arg0 : tensor<2x4x8xf32> to tensor<2x4x8xbf16>
+  // UNBOUNDED-DAG: %[[RHS:.+]] = arith.truncf %arg1 : tensor<2x8x4xf32> to tensor<2x8x4xbf16>
+  // UNBOUNDED: linalg.batch_matmul ins(%[[LHS]], %[[RHS]] : tensor<2x4x8xbf16>, tensor<2x8x4xbf16>) outs(%arg2 : tensor<2x4x4xf32>)
+  // expected-remark @+1 {{kept in f32: input 0 has an unbounded range}}
+  %0 = linalg.batch_matmul ins(%arg0, %arg1 : tensor<2x4x8xf32>, tensor<2x8x4xf32>) outs(%arg2 : tensor<2x4x4xf32>) -> tensor<2x4x4xf32>
+  return %0 : tensor<2x4x4xf32>
+}
+
+// -----
+
+// Ops other than contractions and convolutions (such as softmax reductions)
+// are never demoted.
+
+// CHECK-LABEL: @ignore_reduction
+// UNBOUNDED-LABEL: @ignore_reduction
+func.func @ignore_reduction(%arg0: tensor<4x8xf32>, %arg1: tensor<4xf32>) -> tensor<4xf32> {
+  // CHECK-NOT: arith.truncf
+  // UNBOUNDED-NOT: arith.truncf
+  %0 = linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+    iterator_types = ["parallel", "reduction"]
+  } ins(%arg0 : tensor<4x8xf32>) outs(%arg1 : tensor<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %1 = arith.maxf %in, %out : f32
+    linalg.yield %1 : f32
+  } -> tensor<4xf32>
+  return %0 : tensor<4xf32>
+}
@@ -0,0 +1,96 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-flow-form-dispatch-regions{fuse-reduction-chains=true}))" --split-input-file %s | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0)>
+func.func @softmax(%arg0 : tensor<12x128xf32>) -> tensor<12x128xf32> {
+  %cst = arith.constant -3.40282347E+38 : f32
+  %cst_0 = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<12xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<12xf32>) -> tensor<12xf32>
+  %2 = linalg.generic {
+      indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<12x128xf32>) outs(%1 : tensor<12xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.maxf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<12xf32>
+  %3 = tensor.empty() : tensor<12x128xf32>
+  %4 = linalg.generic {
+      indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %2 : tensor<12x128xf32>, tensor<12xf32>) outs(%3 : tensor<12x128xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %9 = arith.subf %in, %in_1 : f32
+      %10 = math.exp %9 : f32
+      linalg.yield %10 : f32
+  } -> tensor<12x128xf32>
+  %5 = linalg.fill ins(%cst_0 : f32) outs(%0 : tensor<12xf32>) -> tensor<12xf32>
+  %6 = linalg.generic {
+      indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]}
+      ins(%4 : tensor<12x128xf32>) outs(%5 : tensor<12xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.addf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<12xf32>
+  %7 = linalg.generic {
+      indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%4, %6 : tensor<12x128xf32>, tensor<12xf32>) outs(%3 : tensor<12x128xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %9 = arith.divf %in, %in_1 : f32
+      linalg.yield %9 : f32
+  } -> tensor<12x128xf32>
+  return %7 : tensor<12x128xf32>
+}
+// CHECK-LABEL: func @softmax(
+//       CHECK:   %[[RESULT:.+]] = flow.dispatch.region
+//       CHECK:     %[[MAX:.+]] = linalg.generic
+//  CHECK-SAME:         iterator_types = ["parallel", "reduction"]
+//       CHECK:       arith.maxf
+//       CHECK:     %[[EXP:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%{{.+}}, %[[MAX]] :
+//       CHECK:     %[[SUM:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[EXP]] :
+//       CHECK:     %[[DIV:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[EXP]], %[[SUM]] :
+//       CHECK:     flow.return %[[DIV]]
+//   CHECK-NOT:   flow.dispatch.region
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0)>
+func.func @reduction_chain_escaping_intermediate(%arg0 : tensor<12x128xf32>)
+    -> (tensor<12x128xf32>, tensor<12xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<12xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<12xf32>) -> tensor<12xf32>
+  %2 = linalg.generic {
+      indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<12x128xf32>) outs(%1 : tensor<12xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.addf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<12xf32>
+  %3 = tensor.empty() : tensor<12x128xf32>
+  %4 = linalg.generic {
+      indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %2 : tensor<12x128xf32>, tensor<12xf32>) outs(%3 : tensor<12x128xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %9 = arith.subf %in, %in_1 : f32
+      linalg.yield %9 : f32
+  } -> tensor<12x128xf32>
+  %6 = linalg.generic {
+      indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]}
+      ins(%4 : tensor<12x128xf32>) outs(%1 : tensor<12xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.mulf %in, %in : f32
+      %10 = arith.addf %9, %out : f32
+      linalg.yield %10 : f32
+  } -> tensor<12xf32>
+  return %4, %6 : tensor<12x128xf32>, tensor<12xf32>
+}
+// The centered value escapes the chain so the reductions are not fused with
+// each other.
+// CHECK-LABEL: func @reduction_chain_escaping_intermediate(
+//       CHECK:   flow.dispatch.region
+//       CHECK:   flow.dispatch.region
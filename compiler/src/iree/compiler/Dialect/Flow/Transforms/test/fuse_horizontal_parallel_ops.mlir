@@ -0,0 +1,80 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-flow-fuse-horizontal-parallel-ops))" %s | FileCheck %s
+
+func.func @independent_elementwise(%arg0 : tensor<16x32xf32>, %arg1 : tensor<16x32xf32>, %arg2 : tensor<16x32xi32>) -> (tensor<16x32xf32>, tensor<16x32xi32>) {
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg0, %arg1 : tensor<16x32xf32>, tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%b0: f32, %b1: f32, %b2: f32):
+    %3 = arith.addf %b0, %b1 : f32
+    linalg.yield %3 : f32
+  } -> tensor<16x32xf32>
+  %2 = tensor.empty() : tensor<16x32xi32>
+  %4 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1, d0)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg2 : tensor<16x32xi32>) outs(%2 : tensor<16x32xi32>) {
+  ^bb0(%b0: i32, %b1: i32):
+    %5 = arith.muli %b0, %b0 : i32
+    linalg.yield %5 : i32
+  } -> tensor<16x32xi32>
+  return %1, %4 : tensor<16x32xf32>, tensor<16x32xi32>
+}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1) -> (d1, d0)>
+//      CHECK: func.func @independent_elementwise
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<16x32xi32>
+//  CHECK-DAG:   %[[EMPTY0:.+]] = tensor.empty() : tensor<16x32xf32>
+//  CHECK-DAG:   %[[EMPTY1:.+]] = tensor.empty() : tensor<16x32xi32>
+//      CHECK:   %[[FUSED:.+]]:2 = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP0]], #[[MAP0]], #[[MAP1]], #[[MAP0]], #[[MAP0]]]
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[EMPTY0]], %[[EMPTY1]] :
+//      CHECK:     %[[ADD:.+]] = arith.addf
+//      CHECK:     %[[MUL:.+]] = arith.muli
+//      CHECK:     linalg.yield %[[ADD]], %[[MUL]]
+//      CHECK:   return %[[FUSED]]#0, %[[FUSED]]#1
+
+// -----
+
+func.func @dependent_elementwise(%arg0 : tensor<16x32xf32>) -> (tensor<16x32xf32>, tensor<16x32xf32>) {
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%b0: f32, %b1: f32):
+    %3 = arith.negf %b0 : f32
+    linalg.yield %3 : f32
+  } -> tensor<16x32xf32>
+  %2 = flow.tensor.reshape %1 : tensor<16x32xf32> -> tensor<16x32xf32>
+  %4 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%2 : tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%b0: f32, %b1: f32):
+    %5 = math.exp %b0 : f32
+    linalg.yield %5 : f32
+  } -> tensor<16x32xf32>
+  return %1, %4 : tensor<16x32xf32>, tensor<16x32xf32>
+}
+// CHECK-LABEL: func.func @dependent_elementwise
+//       CHECK:   linalg.generic
+//       CHECK:     arith.negf
+//       CHECK:   flow.tensor.reshape
+//       CHECK:   linalg.generic
+//       CHECK:     math.exp
+
+// -----
+
+func.func @mismatched_iteration_space(%arg0 : tensor<16x32xf32>, %arg1 : tensor<32x16xf32>) -> (tensor<16x32xf32>, tensor<32x16xf32>) {
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%b0: f32, %b1: f32):
+    %3 = arith.negf %b0 : f32
+    linalg.yield %3 : f32
+  } -> tensor<16x32xf32>
+  %2 = tensor.empty() : tensor<32x16xf32>
+  %4 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg1 : tensor<32x16xf32>) outs(%2 : tensor<32x16xf32>) {
+  ^bb0(%b0: f32, %b1: f32):
+    %5 = math.exp %b0 : f32
+    linalg.yield %5 : f32
+  } -> tensor<32x16xf32>
+  return %1, %4 : tensor<16x32xf32>, tensor<32x16xf32>
+}
+// CHECK-LABEL: func.func @mismatched_iteration_space
+//       CHECK:   linalg.generic
+//       CHECK:     arith.negf
+//       CHECK:   linalg.generic
+//       CHECK:     math.exp
@@ -0,0 +1,130 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-flow-propagate-transposes))" %s | FileCheck %s
+
+// Transposed operands of contractions are read through a transposed indexing
+// map instead.
+
+func.func @transpose_into_matmul(%lhs : tensor<8x16xf32>, %rhs : tensor<32x16xf32>) -> tensor<8x32xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.transpose ins(%rhs : tensor<32x16xf32>) outs(%0 : tensor<16x32xf32>) permutation = [1, 0]
+  %2 = tensor.empty() : tensor<8x32xf32>
+  %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %4 = linalg.matmul ins(%lhs, %1 : tensor<8x16xf32>, tensor<16x32xf32>) outs(%3 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %4 : tensor<8x32xf32>
+}
+//  CHECK-DAG: #[[LHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d2)>
+//  CHECK-DAG: #[[RHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d1, d2)>
+//  CHECK-DAG: #[[OUT_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+//      CHECK: func.func @transpose_into_matmul
+// CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<8x16xf32>
+// CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<32x16xf32>
+//  CHECK-NOT:   linalg.transpose
+//      CHECK:   %[[FILL:.+]] = linalg.fill
+//      CHECK:   %[[MATMUL:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUT_MAP]]]
+// CHECK-SAME:       iterator_types = ["parallel", "parallel", "reduction"]
+// CHECK-SAME:       ins(%[[LHS]], %[[RHS]] : tensor<8x16xf32>, tensor<32x16xf32>)
+// CHECK-SAME:       outs(%[[FILL]] : tensor<8x32xf32>)
+//      CHECK:   return %[[MATMUL]]
+
+// -----
+
+// Named consumers using the transpose more than once are generalized once.
+
+func.func @transpose_into_matmul_twice(%arg0 : tensor<16x16xf32>) -> tensor<16x16xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<16x16xf32>
+  %1 = linalg.transpose ins(%arg0 : tensor<16x16xf32>) outs(%0 : tensor<16x16xf32>) permutation = [1, 0]
+  %2 = linalg.fill ins(%cst : f32) outs(%0 : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %3 = linalg.matmul ins(%1, %1 : tensor<16x16xf32>, tensor<16x16xf32>) outs(%2 : tensor<16x16xf32>) -> tensor<16x16xf32>
+  return %3 : tensor<16x16xf32>
+}
+//  CHECK-DAG: #[[LHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d2, d0)>
+//  CHECK-DAG: #[[RHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d1, d2)>
+//  CHECK-DAG: #[[OUT_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+//      CHECK: func.func @transpose_into_matmul_twice
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<16x16xf32>
+//  CHECK-NOT:   linalg.transpose
+//      CHECK:   %[[MATMUL:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUT_MAP]]]
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG0]] : tensor<16x16xf32>, tensor<16x16xf32>)
+//      CHECK:   return %[[MATMUL]]
+
+// -----
+
+// Transposes of results that are not consumed by linalg ops are written by
+// their producer directly.
+
+func.func @transpose_into_matmul_result(%lhs : tensor<8x16xf32>, %rhs : tensor<16x32xf32>) -> tensor<32x8xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<8x32xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %2 = linalg.matmul ins(%lhs, %rhs : tensor<8x16xf32>, tensor<16x32xf32>) outs(%1 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %3 = tensor.empty() : tensor<32x8xf32>
+  %4 = linalg.transpose ins(%2 : tensor<8x32xf32>) outs(%3 : tensor<32x8xf32>) permutation = [1, 0]
+  return %4 : tensor<32x8xf32>
+}
+//  CHECK-DAG: #[[LHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d2)>
+//  CHECK-DAG: #[[RHS_MAP:.+]] = affine_map<(d0, d1, d2) -> (d2, d1)>
+//  CHECK-DAG: #[[OUT_MAP:.+]] = affine_map<(d0, d1, d2) -> (d1, d0)>
+//      CHECK: func.func @transpose_into_matmul_result
+// CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<8x16xf32>
+// CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+//  CHECK-DAG:   %[[CST:.+]] = arith.constant 0.000000e+00 : f32
+//      CHECK:   %[[EMPTY:.+]] = tensor.empty() : tensor<32x8xf32>
+//      CHECK:   %[[FILL:.+]] = linalg.fill ins(%[[CST]] : f32) outs(%[[EMPTY]] : tensor<32x8xf32>)
+//      CHECK:   %[[MATMUL:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUT_MAP]]]
+// CHECK-SAME:       ins(%[[LHS]], %[[RHS]] : tensor<8x16xf32>, tensor<16x32xf32>)
+// CHECK-SAME:       outs(%[[FILL]] : tensor<32x8xf32>)
+//  CHECK-NOT:   linalg.transpose
+//      CHECK:   return %[[MATMUL]]
+
+// -----
+
+// Generic consumers absorb the transpose without changing their result layout.
+
+#map0 = affine_map<(d0, d1) -> (d1, d0)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+func.func @transpose_into_elementwise(%arg0 : tensor<16x32xf32>, %arg1 : tensor<32x16xf32>) -> tensor<32x16xf32> {
+  %0 = tensor.empty() : tensor<32x16xf32>
+  %1 = linalg.generic {indexing_maps = [#map0, #map1], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<16x32xf32>) outs(%0 : tensor<32x16xf32>) {
+  ^bb0(%b0: f32, %b1: f32):
+    linalg.yield %b0 : f32
+  } -> tensor<32x16xf32>
+  %2 = linalg.generic {indexing_maps = [#map1, #map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%1, %arg1 : tensor<32x16xf32>, tensor<32x16xf32>) outs(%0 : tensor<32x16xf32>) {
+  ^bb0(%b0: f32, %b1: f32, %b2: f32):
+    %3 = arith.addf %b0, %b1 : f32
+    linalg.yield %3 : f32
+  } -> tensor<32x16xf32>
+  return %2 : tensor<32x16xf32>
+}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<(d0, d1) -> (d1, d0)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//      CHECK: func.func @transpose_into_elementwise
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<32x16xf32>
+//      CHECK:   %[[ADD:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP0]], #[[MAP1]], #[[MAP1]]]
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] : tensor<16x32xf32>, tensor<32x16xf32>)
+//      CHECK:   return %[[ADD]]
+
+// -----
+
+// Transposes of arguments that are also returned must be materialized.
+
+func.func @transpose_returned(%arg0 : tensor<16x32xf32>, %arg1 : tensor<32x16xf32>) -> (tensor<32x16xf32>, tensor<32x16xf32>) {
+  %0 = tensor.empty() : tensor<32x16xf32>
+  %1 = linalg.transpose ins(%arg0 : tensor<16x32xf32>) outs(%0 : tensor<32x16xf32>) permutation = [1, 0]
+  %2 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%1, %arg1 : tensor<32x16xf32>, tensor<32x16xf32>) outs(%0 : tensor<32x16xf32>) {
+  ^bb0(%b0: f32, %b1: f32, %b2: f32):
+    %3 = arith.addf %b0, %b1 : f32
+    linalg.yield %3 : f32
+  } -> tensor<32x16xf32>
+  return %1, %2 : tensor<32x16xf32>, tensor<32x16xf32>
+}
+//      CHECK: func.func @transpose_returned
+//      CHECK:   %[[TRANSPOSE:.+]] = linalg.transpose
+//      CHECK:   %[[ADD:.+]] = linalg.generic
+// CHECK-SAME:       ins(%[[TRANSPOSE]], %{{.+}} :
+//      CHECK:   return %[[TRANSPOSE]], %[[ADD]]
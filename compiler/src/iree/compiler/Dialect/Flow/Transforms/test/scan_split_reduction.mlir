@@ -0,0 +1,44 @@
+// RUN: iree-opt --split-input-file --iree-flow-scan-split-reduction-block-size=1024 --pass-pipeline="builtin.module(func.func(iree-flow-split-reduction-ops))" %s | FileCheck %s
+
+// Long scans are split into blocks scanned in parallel, a scan of the block
+// totals and a parallel fixup that adds the carry into each block.
+func.func @scan_split_reduction(%input: tensor<2x4096xf32>, %out: tensor<2x4096xf32>, %acc: tensor<2xf32>) -> (tensor<2x4096xf32>, tensor<2xf32>) {
+  %0:2 = iree_linalg_ext.scan
+         dimension(1) inclusive(true)
+         ins(%input : tensor<2x4096xf32>)
+         outs(%out, %acc : tensor<2x4096xf32>, tensor<2xf32>) {
+         ^bb0(%arg0: f32, %arg1: f32):
+           %sum = arith.addf %arg0, %arg1 : f32
+           iree_linalg_ext.yield %sum : f32
+         } -> tensor<2x4096xf32>, tensor<2xf32>
+  return %0#0, %0#1 : tensor<2x4096xf32>, tensor<2xf32>
+}
+
+// CHECK-LABEL: func.func @scan_split_reduction(
+// CHECK:         tensor.expand_shape %{{.+}} {{\[\[}}0], [1, 2]] : tensor<2x4096xf32> into tensor<2x4x1024xf32>
+// CHECK:         %[[BLOCKS:.+]]:2 = iree_linalg_ext.scan dimension(2) inclusive(true)
+// CHECK-SAME:      -> tensor<2x4x1024xf32>, tensor<2x4xf32>
+// CHECK:         iree_linalg_ext.scan dimension(1) inclusive(true)
+// CHECK-SAME:      ins(%[[BLOCKS]]#1 : tensor<2x4xf32>)
+// CHECK:         linalg.generic
+// CHECK:         tensor.collapse_shape %{{.+}} {{\[\[}}0], [1, 2]] : tensor<2x4x1024xf32> into tensor<2x4096xf32>
+
+// -----
+
+// Scans no larger than the block size are left untouched.
+func.func @scan_small(%input: tensor<1024xf32>, %out: tensor<1024xf32>, %acc: tensor<f32>) -> (tensor<1024xf32>, tensor<f32>) {
+  %0:2 = iree_linalg_ext.scan
+         dimension(0) inclusive(true)
+         ins(%input : tensor<1024xf32>)
+         outs(%out, %acc : tensor<1024xf32>, tensor<f32>) {
+         ^bb0(%arg0: f32, %arg1: f32):
+           %sum = arith.addf %arg0, %arg1 : f32
+           iree_linalg_ext.yield %sum : f32
+         } -> tensor<1024xf32>, tensor<f32>
+  return %0#0, %0#1 : tensor<1024xf32>, tensor<f32>
+}
+
+// CHECK-LABEL: func.func @scan_small(
+// CHECK-NOT:     tensor.expand_shape
+// CHECK:         iree_linalg_ext.scan dimension(0) inclusive(true)
+// CHECK-SAME:      ins(%{{.+}} : tensor<1024xf32>)
@@ -0,0 +1,63 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-flow-specialize-dispatch-shapes{shape-buckets=128,256}))" %s | FileCheck %s
+
+// Tests that a run of dispatches depending on the same dynamic dimension is
+// specialized for each bucket with the dimension inlined into the dispatches.
+
+// CHECK-LABEL: @specializeRun
+// CHECK-SAME: (%[[ARG0:.+]]: tensor<?x4xf32>, %[[DIM:.+]]: index)
+func.func @specializeRun(%arg0: tensor<?x4xf32>, %dim: index) -> tensor<?x4xf32> {
+  %c1 = arith.constant 1 : index
+  //      CHECK: %[[C128:.+]] = arith.constant 128 : index
+  //      CHECK: %[[IS128:.+]] = arith.cmpi eq, %[[DIM]], %[[C128]]
+  //      CHECK: cf.cond_br %[[IS128]], ^[[BB128:.+]], ^[[TEST256:.+]]
+  //      CHECK: ^[[BB128]]:
+  //      CHECK: %[[SPEC128_0:.+]] = flow.dispatch.workgroups[%c1](%[[ARG0]], %[[C128]]) : (tensor<?x4xf32>{%[[C128]]}, index) -> tensor<?x4xf32>{%[[C128]]}
+  // CHECK-NEXT: (%{{.+}}: !flow.dispatch.tensor<readonly:tensor<?x4xf32>>, %{{.+}}: index, %[[RET:.+]]: !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>)
+  // CHECK-NEXT: %[[INLINED:.+]] = arith.constant 128 : index
+  // CHECK-NEXT: flow.dispatch.tie_shape %[[RET]] : !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>{%[[INLINED]]}
+  //      CHECK: %[[SPEC128_1:.+]] = flow.dispatch.workgroups[%c1](%[[SPEC128_0]], %[[C128]])
+  //      CHECK: cf.br ^[[MERGE:.+]](%[[SPEC128_1]] : tensor<?x4xf32>)
+  //      CHECK: ^[[TEST256]]:
+  //      CHECK: %[[C256:.+]] = arith.constant 256 : index
+  //      CHECK: %[[IS256:.+]] = arith.cmpi eq, %[[DIM]], %[[C256]]
+  //      CHECK: cf.cond_br %[[IS256]], ^[[BB256:.+]], ^[[FALLBACK:.+]]
+  //      CHECK: ^[[BB256]]:
+  //      CHECK: flow.dispatch.workgroups[%c1](%[[ARG0]], %[[C256]])
+  //      CHECK: flow.dispatch.workgroups[%c1]({{.+}}, %[[C256]])
+  //      CHECK: cf.br ^[[MERGE]]
+  //      CHECK: ^[[FALLBACK]]:
+  //      CHECK: %[[DYN0:.+]] = flow.dispatch.workgroups[%c1](%[[ARG0]], %[[DIM]])
+  //      CHECK: %[[DYN1:.+]] = flow.dispatch.workgroups[%c1](%[[DYN0]], %[[DIM]])
+  //      CHECK: cf.br ^[[MERGE]](%[[DYN1]] : tensor<?x4xf32>)
+  //      CHECK: ^[[MERGE]](%[[RESULT:.+]]: tensor<?x4xf32>):
+  //      CHECK: return %[[RESULT]]
+  %0 = flow.dispatch.workgroups[%c1](%arg0, %dim) : (tensor<?x4xf32>{%dim}, index) -> tensor<?x4xf32>{%dim} =
+      (%arg0_capture: !flow.dispatch.tensor<readonly:tensor<?x4xf32>>, %dim_capture: index, %ret0: !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>) {
+    %ret0_tied = flow.dispatch.tie_shape %ret0 : !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>{%dim_capture}
+    flow.return
+  }
+  %1 = flow.dispatch.workgroups[%c1](%0, %dim) : (tensor<?x4xf32>{%dim}, index) -> tensor<?x4xf32>{%dim} =
+      (%arg0_capture: !flow.dispatch.tensor<readonly:tensor<?x4xf32>>, %dim_capture: index, %ret0: !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>) {
+    %ret0_tied = flow.dispatch.tie_shape %ret0 : !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>{%dim_capture}
+    flow.return
+  }
+  return %1 : tensor<?x4xf32>
+}
+
+// -----
+
+// Tests that dispatches depending on multiple dynamic dimensions are not
+// specialized.
+
+// CHECK-LABEL: @multipleDims
+func.func @multipleDims(%arg0: tensor<?x?xf32>, %dim0: index, %dim1: index) -> tensor<?x?xf32> {
+  %c1 = arith.constant 1 : index
+  // CHECK-NOT: cf.cond_br
+  // CHECK: flow.dispatch.workgroups
+  %0 = flow.dispatch.workgroups[%c1](%arg0, %dim0, %dim1) : (tensor<?x?xf32>{%dim0, %dim1}, index, index) -> tensor<?x?xf32>{%dim0, %dim1} =
+      (%arg0_capture: !flow.dispatch.tensor<readonly:tensor<?x?xf32>>, %dim0_capture: index, %dim1_capture: index, %ret0: !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>) {
+    flow.return
+  }
+  // CHECK-NOT: cf.br
+  return %0 : tensor<?x?xf32>
+}
@@ -0,0 +1,30 @@
+// RUN: iree-opt --split-input-file --iree-flow-split-skinny-matmul-target-workgroups=64 --pass-pipeline="builtin.module(func.func(iree-flow-split-reduction-ops))" %s | FileCheck %s
+
+// Tests that the reduction of a matmul whose output is too small to fill the
+// target workgroup count is split until each split still has at least 256
+// reduction iterations.
+
+// CHECK-LABEL: @skinnyMatmul
+func.func @skinnyMatmul(%lhs: tensor<1x4096xf32>, %rhs: tensor<4096x128xf32>, %init: tensor<1x128xf32>) -> tensor<1x128xf32> {
+  // CHECK-DAG: tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<1x4096xf32> into tensor<1x16x256xf32>
+  // CHECK-DAG: tensor.expand_shape %{{.+}} {{\[}}[0, 1], [2]] : tensor<4096x128xf32> into tensor<16x256x128xf32>
+  //     CHECK: %[[PARTIAL:.+]] = linalg.generic
+  // CHECK-SAME:   -> tensor<16x1x128xf32>
+  //     CHECK: linalg.generic
+  // CHECK-SAME:   ins(%[[PARTIAL]] : tensor<16x1x128xf32>)
+  // CHECK-SAME:   -> tensor<1x128xf32>
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x4096xf32>, tensor<4096x128xf32>) outs(%init : tensor<1x128xf32>) -> tensor<1x128xf32>
+  return %0 : tensor<1x128xf32>
+}
+
+// -----
+
+// Tests that matmuls with enough output tiles are not split.
+
+// CHECK-LABEL: @largeMatmul
+func.func @largeMatmul(%lhs: tensor<512x4096xf32>, %rhs: tensor<4096x512xf32>, %init: tensor<512x512xf32>) -> tensor<512x512xf32> {
+  // CHECK-NOT: tensor.expand_shape
+  // CHECK: linalg.matmul
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<512x4096xf32>, tensor<4096x512xf32>) outs(%init : tensor<512x512xf32>) -> tensor<512x512xf32>
+  return %0 : tensor<512x512xf32>
+}
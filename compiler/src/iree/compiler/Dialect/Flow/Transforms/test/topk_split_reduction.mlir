@@ -0,0 +1,42 @@
+// RUN: iree-opt --split-input-file --iree-flow-topk-split-reduction-block-size=1024 --pass-pipeline="builtin.module(func.func(iree-flow-split-reduction-ops))" %s | FileCheck %s
+
+// Vocabulary-sized top-k is split into blocks reduced in parallel followed by
+// a merge of the per-block candidates. The ratio need not be a power of two.
+
+// CHECK-LABEL: func.func @topk_vocab
+func.func @topk_vocab(%input: tensor<4x50257xf32>, %out_values: tensor<4x8xf32>, %out_indices: tensor<4x8xi32>) -> (tensor<4x8xf32>, tensor<4x8xi32>) {
+  // CHECK: %[[EXPANDED:.+]] = tensor.expand_shape %{{.+}} {{\[\[}}0], [1, 2]] : tensor<4x50257xf32> into tensor<4x29x1733xf32>
+  // CHECK: %[[BLOCKS:.+]]:2 = iree_linalg_ext.topk dimension(2) ins(%[[EXPANDED]] : tensor<4x29x1733xf32>) {{.+}} -> tensor<4x29x8xf32>, tensor<4x29x8xi32>
+  // CHECK: %[[MERGE:.+]]:2 = iree_linalg_ext.topk dimension(1) ins(%{{.+}}, %{{.+}} : tensor<4x232xf32>, tensor<4x232xi32>) {{.+}} -> tensor<4x8xf32>, tensor<4x8xi32>
+  // CHECK-NOT: iree_linalg_ext.topk
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input : tensor<4x50257xf32>)
+        outs(%out_values, %out_indices : tensor<4x8xf32>, tensor<4x8xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):
+          %1 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %1 : i1
+        } -> tensor<4x8xf32>, tensor<4x8xi32>
+  // CHECK: return %[[MERGE]]#0, %[[MERGE]]#1
+  return %0#0, %0#1 : tensor<4x8xf32>, tensor<4x8xi32>
+}
+
+// -----
+
+// Top-k over fewer elements than the block size is left as-is.
+
+// CHECK-LABEL: func.func @topk_small
+func.func @topk_small(%input: tensor<4x1000xf32>, %out_values: tensor<4x8xf32>, %out_indices: tensor<4x8xi32>) -> (tensor<4x8xf32>, tensor<4x8xi32>) {
+  // CHECK-NOT: tensor.expand_shape
+  // CHECK: iree_linalg_ext.topk dimension(1) ins(%{{.+}} : tensor<4x1000xf32>)
+  // CHECK-NOT: iree_linalg_ext.topk
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input : tensor<4x1000xf32>)
+        outs(%out_values, %out_indices : tensor<4x8xf32>, tensor<4x8xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):
+          %1 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %1 : i1
+        } -> tensor<4x8xf32>, tensor<4x8xi32>
+  return %0#0, %0#1 : tensor<4x8xf32>, tensor<4x8xi32>
+}
@@ -1048,7 +1048,11 @@ struct CmdExecuteOpPattern
     // that we may need to wait behind and we can't execute inline. HAL
     // implementations may be able to flush eagerly if they are able to tell
     // that all conditions are met during recording but we leave that to them.
-    auto modes = IREE::HAL::CommandBufferModeBitfield::OneShot;
+    //
+    // Command buffers recorded by compiler-generated code are trusted and skip
+    // runtime validation; hosts can force validation via the HAL module.
+    auto modes = IREE::HAL::CommandBufferModeBitfield::OneShot |
+                 IREE::HAL::CommandBufferModeBitfield::Unvalidated;
     if (!executeOp.getAwaitTimepoint()) {
       modes =
           modes | IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution;
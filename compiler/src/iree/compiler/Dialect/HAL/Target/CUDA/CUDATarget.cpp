@@ -80,6 +80,14 @@ static llvm::cl::opt<std::string> clUsePtxasParams(
     "iree-hal-cuda-use-ptxas-params", llvm::cl::init(""),
     llvm::cl::desc("Passes the given additional parameters to ptxas."));
 
+static llvm::cl::list<std::string> clCubinArchs(
+    "iree-hal-cuda-cubin-archs", llvm::cl::CommaSeparated,
+    llvm::cl::desc(
+        "Comma-separated list of SM architectures (e.g. 'sm_80,sm_86') to "
+        "compile cubins for with ptxas. The cubins are embedded alongside the "
+        "PTX and the runtime loads the best match for the device, falling "
+        "back to JIT compiling the PTX when none are compatible."));
+
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
@@ -215,6 +223,137 @@ static std::string produceGpuImage(std::string &ptxImage) {
   return ptxImage;
 }
 
+namespace {
+struct CubinImage {
+  uint32_t smVersion;
+  std::string data;
+};
+}  // namespace
+
+// Compiles |ptxImage| for each of the --iree-hal-cuda-cubin-archs with ptxas.
+// Architectures that fail to compile are skipped with a warning as the PTX is
+// always available as a fallback at runtime.
+static SmallVector<CubinImage> produceCubinImages(const std::string &ptxImage) {
+  SmallVector<CubinImage> cubinImages;
+  if (clCubinArchs.empty()) return cubinImages;
+
+  std::string message;
+  FailureOr<std::string> ptxasCompiler = findPtxasCompiler(&message);
+  if (failed(ptxasCompiler)) {
+    llvm::WithColor::warning()
+        << "No cubins will be embedded in the executable. \n Error : "
+        << message << " \n";
+    return cubinImages;
+  }
+
+  for (const std::string &arch : clCubinArchs) {
+    uint32_t smVersion = 0;
+    if (!StringRef(arch).startswith("sm_") ||
+        StringRef(arch).drop_front(3).getAsInteger(10, smVersion)) {
+      llvm::WithColor::warning()
+          << "Ignoring invalid cubin architecture '" << arch << "' \n";
+      continue;
+    }
+    message.clear();
+    FailureOr<std::string> maybeCubinImage =
+        compileWithPtxas(ptxasCompiler.value(), arch, clUsePtxasParams,
+                         ptxImage, &message);
+    if (failed(maybeCubinImage)) {
+      llvm::WithColor::warning()
+          << "Compilation with `ptxas` for " << arch
+          << " failed, the cubin will not be embedded. \n Error : " << message
+          << " \n";
+      continue;
+    }
+    cubinImages.push_back({smVersion, std::move(maybeCubinImage.value())});
+  }
+  return cubinImages;
+}
+
+// Attribute on hal.executable.export ops in external variants marking exports
+// that are implemented by a vendor library (cuBLASLt) instead of a kernel in
+// the variant objects. Example:
+//   iree.cuda.library_call = {
+//     op = "matmul", m = 128, n = 256, k = 64,
+//     transpose_lhs = false, transpose_rhs = true,
+//     element_type = f16, epilogue = "relu_bias"
+//   }
+static constexpr char kLibraryCallAttrName[] = "iree.cuda.library_call";
+
+namespace {
+struct LibraryCall {
+  // Ordinal of the export in the entry point list.
+  uint32_t entryPoint;
+  uint32_t m, n, k;
+  bool transposeLhs;
+  bool transposeRhs;
+  iree_CUDALibraryElementTypeDef_enum_t elementType;
+  iree_CUDALibraryEpilogueDef_enum_t epilogue;
+};
+}  // namespace
+
+// Parses the library call described by |attr| on |exportOp|.
+static FailureOr<LibraryCall> parseLibraryCall(
+    IREE::HAL::ExecutableExportOp exportOp, DictionaryAttr attr,
+    uint32_t entryPoint) {
+  auto opAttr = attr.getAs<StringAttr>("op");
+  if (!opAttr || opAttr.getValue() != "matmul") {
+    return exportOp.emitOpError()
+           << "unsupported library call op; only 'matmul' is supported";
+  }
+
+  LibraryCall call;
+  call.entryPoint = entryPoint;
+  auto getDim = [&](StringRef name, uint32_t &value) -> LogicalResult {
+    auto dimAttr = attr.getAs<IntegerAttr>(name);
+    if (!dimAttr || dimAttr.getInt() <= 0) {
+      return exportOp.emitOpError()
+             << "library call requires a positive static '" << name << "'";
+    }
+    value = static_cast<uint32_t>(dimAttr.getInt());
+    return success();
+  };
+  if (failed(getDim("m", call.m)) || failed(getDim("n", call.n)) ||
+      failed(getDim("k", call.k))) {
+    return failure();
+  }
+  auto getFlag = [&](StringRef name) {
+    auto flagAttr = attr.getAs<BoolAttr>(name);
+    return flagAttr && flagAttr.getValue();
+  };
+  call.transposeLhs = getFlag("transpose_lhs");
+  call.transposeRhs = getFlag("transpose_rhs");
+
+  auto elementTypeAttr = attr.getAs<TypeAttr>("element_type");
+  Type elementType = elementTypeAttr ? elementTypeAttr.getValue() : Type();
+  if (elementType && elementType.isF32()) {
+    call.elementType = iree_CUDALibraryElementTypeDef_F32;
+  } else if (elementType && elementType.isF16()) {
+    call.elementType = iree_CUDALibraryElementTypeDef_F16;
+  } else if (elementType && elementType.isBF16()) {
+    call.elementType = iree_CUDALibraryElementTypeDef_BF16;
+  } else {
+    return exportOp.emitOpError()
+           << "library call 'element_type' must be one of f32, f16, or bf16";
+  }
+
+  auto epilogueAttr = attr.getAs<StringAttr>("epilogue");
+  StringRef epilogue = epilogueAttr ? epilogueAttr.getValue() : "none";
+  if (epilogue == "none") {
+    call.epilogue = iree_CUDALibraryEpilogueDef_NONE;
+  } else if (epilogue == "relu") {
+    call.epilogue = iree_CUDALibraryEpilogueDef_RELU;
+  } else if (epilogue == "bias") {
+    call.epilogue = iree_CUDALibraryEpilogueDef_BIAS;
+  } else if (epilogue == "relu_bias") {
+    call.epilogue = iree_CUDALibraryEpilogueDef_RELU_BIAS;
+  } else {
+    return exportOp.emitOpError()
+           << "unsupported library call epilogue '" << epilogue << "'";
+  }
+  return call;
+}
+
 static void dumpBitcodeToPath(StringRef path, StringRef baseName,
                               StringRef suffix, StringRef extension,
                               llvm::Module &module) {
@@ -410,36 +549,49 @@ class CUDATargetBackend final : public TargetBackend {
     }
 
     SmallVector<std::string> entryPointNames;
+    SmallVector<LibraryCall> libraryCalls;
     std::string ptxImage;
     if (variantOp.isExternal()) {
-      if (!variantOp.getObjects().has_value()) {
-        return variantOp.emitOpError()
-               << "no objects defined for external variant";
-      } else if (variantOp.getObjects()->getValue().size() != 1) {
-        // For now we assume there will be exactly one object file.
-        // In the future we will want to perform a linking step here and ideally
-        // support _also_ linking in the codegen results.
-        return variantOp.emitOpError() << "only one object reference is "
-                                          "supported for external variants";
-      }
-
       // Take exported names verbatim. The user must have already sanitized
       // these to match the names in their kernels. We don't support any kind of
       // mangling and if the user was silly enough to rely on nvcc C++ mangling
       // they'll have to figure that out.
-      for (auto exportOp : variantOp.getOps<IREE::HAL::ExecutableExportOp>()) {
+      for (auto [ordinal, exportOp] : llvm::enumerate(
+               variantOp.getOps<IREE::HAL::ExecutableExportOp>())) {
         entryPointNames.emplace_back(exportOp.getSymName());
+        if (auto libraryCallAttr =
+                exportOp->getAttrOfType<DictionaryAttr>(kLibraryCallAttrName)) {
+          auto libraryCall =
+              parseLibraryCall(exportOp, libraryCallAttr, ordinal);
+          if (failed(libraryCall)) return failure();
+          libraryCalls.push_back(*libraryCall);
+        }
       }
 
-      auto objectAttr = variantOp.getObjects()
-                            ->getValue()
-                            .front()
-                            .cast<IREE::HAL::ExecutableObjectAttr>();
-      if (auto data = objectAttr.loadData()) {
-        ptxImage = data.value();
+      // Variants that only contain library calls need no objects.
+      bool hasKernels = libraryCalls.size() < entryPointNames.size();
+      if (!variantOp.getObjects().has_value()) {
+        if (hasKernels) {
+          return variantOp.emitOpError()
+                 << "no objects defined for external variant";
+        }
+      } else if (variantOp.getObjects()->getValue().size() != 1) {
+        // For now we assume there will be exactly one object file.
+        // In the future we will want to perform a linking step here and ideally
+        // support _also_ linking in the codegen results.
+        return variantOp.emitOpError() << "only one object reference is "
+                                          "supported for external variants";
       } else {
-        return variantOp.emitOpError()
-               << "object file could not be loaded: " << objectAttr;
+        auto objectAttr = variantOp.getObjects()
+                              ->getValue()
+                              .front()
+                              .cast<IREE::HAL::ExecutableObjectAttr>();
+        if (auto data = objectAttr.loadData()) {
+          ptxImage = data.value();
+        } else {
+          return variantOp.emitOpError()
+                 << "object file could not be loaded: " << objectAttr;
+        }
       }
     } else {
       ModuleOp innerModuleOp = variantOp.getInnerModule();
@@ -553,7 +705,13 @@ class CUDATargetBackend final : public TargetBackend {
                      variantOp.getName(), ".ptx", ptxImage);
     }
 
-    std::string gpuImage = produceGpuImage(ptxImage);
+    // Executables with only library calls have no PTX to compile.
+    SmallVector<CubinImage> cubinImages;
+    std::string gpuImage;
+    if (!ptxImage.empty()) {
+      cubinImages = produceCubinImages(ptxImage);
+      gpuImage = produceGpuImage(ptxImage);
+    }
 
     FlatbufferBuilder builder;
     iree_CUDAExecutableDef_start_as_root(builder);
@@ -570,12 +728,39 @@ class CUDATargetBackend final : public TargetBackend {
     auto workgroupLocalMemoriesRef =
         builder.createInt32Vec(workgroupLocalMemories);
     auto entryPointsRef = builder.createStringVec(entryPointNames);
+    SmallVector<iree_CUDACubinDef_ref_t> cubinRefs;
+    for (const auto &cubinImage : cubinImages) {
+      auto dataRef = flatbuffers_uint8_vec_create(
+          builder, reinterpret_cast<const uint8_t *>(cubinImage.data.data()),
+          cubinImage.data.size());
+      cubinRefs.push_back(
+          iree_CUDACubinDef_create(builder, cubinImage.smVersion, dataRef));
+    }
+    auto cubinImagesRef = iree_CUDACubinDef_vec_create(
+        builder, cubinRefs.data(), cubinRefs.size());
+    SmallVector<iree_CUDALibraryCallDef_ref_t> libraryCallRefs;
+    for (const auto &libraryCall : libraryCalls) {
+      auto matmulRef = iree_CUDAMatmulDef_create(
+          builder, libraryCall.m, libraryCall.n, libraryCall.k,
+          libraryCall.transposeLhs, libraryCall.transposeRhs,
+          libraryCall.elementType, libraryCall.epilogue);
+      libraryCallRefs.push_back(iree_CUDALibraryCallDef_create(
+          builder, libraryCall.entryPoint, matmulRef));
+    }
+    auto libraryCallsRef = iree_CUDALibraryCallDef_vec_create(
+        builder, libraryCallRefs.data(), libraryCallRefs.size());
 
     iree_CUDAExecutableDef_entry_points_add(builder, entryPointsRef);
     iree_CUDAExecutableDef_block_sizes_add(builder, blockSizesRef);
     iree_CUDAExecutableDef_shared_memory_size_add(builder,
                                                   workgroupLocalMemoriesRef);
     iree_CUDAExecutableDef_ptx_image_add(builder, gpuImageRef);
+    if (!cubinRefs.empty()) {
+      iree_CUDAExecutableDef_cubin_images_add(builder, cubinImagesRef);
+    }
+    if (!libraryCallRefs.empty()) {
+      iree_CUDAExecutableDef_library_calls_add(builder, libraryCallsRef);
+    }
     iree_CUDAExecutableDef_end_as_root(builder);
 
     // Add the binary data to the target executable.
@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMCPUTarget.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
@@ -27,7 +28,11 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/PDL/IR/PDL.h"
@@ -55,6 +60,22 @@ namespace HAL {
 static constexpr char kQueryFunctionName[] =
     "iree_hal_executable_library_query";
 
+// Returns the number of partitions |module| is split into for code generation.
+static unsigned getCodegenPartitionCount(const LLVMTargetOptions &options,
+                                         llvm::Module &module) {
+  if (options.linkStatic) return 1;
+  unsigned partitionCount = options.codegenPartitions;
+  if (partitionCount == 0) {
+    partitionCount = llvm::hardware_concurrency().compute_thread_count();
+  }
+  // Partitions beyond the number of defined functions would be empty.
+  unsigned definedFunctionCount = 0;
+  for (auto &func : module) {
+    if (!func.isDeclaration()) ++definedFunctionCount;
+  }
+  return std::max(1u, std::min(partitionCount, definedFunctionCount));
+}
+
 static void dumpBitcodeToPath(StringRef path, StringRef baseName,
                               StringRef suffix, StringRef extension,
                               llvm::Module &module) {
@@ -65,6 +86,76 @@ static void dumpBitcodeToPath(StringRef path, StringRef baseName,
                  StringRef(data.data(), data.size()));
 }
 
+// Returns the IREE_ARCH_* suffix used in iree/schemas/cpu_feature_bits.inl for
+// |targetTriple| or an empty string if the architecture has no feature bits.
+static StringRef getCPUDataArchName(const llvm::Triple &targetTriple) {
+  switch (targetTriple.getArch()) {
+    case llvm::Triple::aarch64:
+      return "ARM_64";
+    case llvm::Triple::riscv64:
+      return "RISCV_64";
+    case llvm::Triple::x86_64:
+      return "X86_64";
+    default:
+      return "";
+  }
+}
+
+// Returns the processor data bits (see iree/schemas/cpu_data.h) a processor
+// must have to run code compiled with the LLVM target |cpuFeatures|. Fails if
+// a feature has no corresponding bit as the runtime could not check for it.
+static FailureOr<SmallVector<uint64_t>> getProcessorDataRequirements(
+    Location loc, const llvm::Triple &targetTriple, StringRef cpuFeatures) {
+  StringRef archName = getCPUDataArchName(targetTriple);
+  SmallVector<uint64_t> requirements(LibraryBuilder::kProcessorDataCapacity,
+                                     0);
+  SmallVector<StringRef> features;
+  cpuFeatures.split(features, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef feature : features) {
+    feature = feature.trim();
+    if (!feature.consume_front("+")) {
+      return mlir::emitError(loc)
+             << "export variant CPU features may only add features; got '"
+             << feature << "'";
+    }
+    bool found = false;
+#define IREE_CPU_FEATURE_BIT(arch, field_index, bit_pos, bit_name, llvm_name) \
+  if (archName == #arch && feature == llvm_name) {                            \
+    requirements[field_index] |= 1ull << bit_pos;                             \
+    found = true;                                                             \
+  }
+#include "iree/schemas/cpu_feature_bits.inl"
+#undef IREE_CPU_FEATURE_BIT
+    if (!found) {
+      return mlir::emitError(loc)
+             << "export variant CPU feature '" << feature
+             << "' cannot be detected at runtime on '" << targetTriple.str()
+             << "'";
+    }
+  }
+  return requirements;
+}
+
+// Approximate number of operations each worker should be given when the
+// runtime distributes a dispatch: workers are woken up and joined per dispatch
+// and this amortizes that across workgroups with little work.
+static constexpr uint64_t kMinOpsPerWorker = 256 * 1024;
+
+// Returns the statically estimated cost of a workgroup of the dispatch
+// function |func| or an unknown (default) cost if it cannot be estimated.
+static LibraryBuilder::DispatchCost getDispatchCost(
+    llvm::Function *func, const llvm::DataLayout &dataLayout) {
+  LibraryBuilder::DispatchCost cost;
+  auto estimate = estimateFunctionCost(*func, dataLayout);
+  if (!estimate) return cost;
+  cost.workgroupOps = estimate->ops;
+  cost.workgroupBytes = estimate->bytes;
+  uint64_t workgroupOps = std::max<uint64_t>(estimate->ops, 1);
+  cost.tilesPerWorker = static_cast<uint32_t>(std::min<uint64_t>(
+      llvm::divideCeil(kMinOpsPerWorker, workgroupOps), UINT32_MAX));
+  return cost;
+}
+
 static void fixupVisibility(llvm::Module &module,
                             const SetVector<llvm::Function *> &preserveFuncs) {
   for (auto &func : module) {
@@ -296,10 +387,24 @@ class LLVMCPUTargetBackend final : public TargetBackend {
 
     // Declare exported entry points.
     auto align16 = llvm::Attribute::getWithAlignment(context, llvm::Align(16));
+    bool exportDispatchFunctions =
+        options_.linkStatic && options_.staticLibraryExportDispatchFunctions;
+    SmallVector<llvm::Function *> dispatchFuncs;
+    SmallVector<std::string> dispatchFunctionNames;
     for (auto exportOp : variantOp.getBlock().getOps<ExecutableExportOp>()) {
       // Find the matching function in the LLVM module.
       auto *llvmFunc = llvmModule->getFunction(exportOp.getName());
-      llvmFunc->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+      if (exportDispatchFunctions) {
+        // Static libraries may expose the dispatch functions to the program
+        // they are linked into. Names are prefixed with the library name as
+        // multiple libraries share the same namespace.
+        llvmFunc->setName(libraryName + "_" + exportOp.getName().str());
+        llvmFunc->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        dispatchFuncs.push_back(llvmFunc);
+        dispatchFunctionNames.push_back(llvmFunc->getName().str());
+      } else {
+        llvmFunc->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+      }
       llvmFunc->setDSOLocal(true);
 
       // Tag the function parameters in case they got removed during conversion.
@@ -326,9 +431,40 @@ class LLVMCPUTargetBackend final : public TargetBackend {
           sourceLine = loc.getLine();
         }
       }
+      // Estimate the cost of each workgroup so that the runtime can decide how
+      // to distribute the dispatch across workers.
+      auto dispatchCost =
+          getDispatchCost(llvmFunc, targetMachine->createDataLayout());
+
       libraryBuilder.addExport(
           exportOp.getName(), sourceFile, sourceLine, /*tag=*/"",
-          LibraryBuilder::DispatchAttrs{localMemorySize}, llvmFunc);
+          LibraryBuilder::DispatchAttrs{localMemorySize}, dispatchCost,
+          llvmFunc);
+
+      // Compile a copy of the export for each additional CPU feature set the
+      // runtime may select instead on processors that support it. The code
+      // generated so far only assumes the base target features so the copies
+      // are valid and gain from instruction selection and LLVM optimizations.
+      for (size_t i = 0; i < options_.exportVariantCPUFeatures.size(); ++i) {
+        StringRef variantFeatures = options_.exportVariantCPUFeatures[i];
+        auto requirements = getProcessorDataRequirements(
+            exportOp.getLoc(), targetTriple, variantFeatures);
+        if (failed(requirements)) return failure();
+        llvm::ValueToValueMapTy valueMap;
+        llvm::Function *variantFunc = llvm::CloneFunction(llvmFunc, valueMap);
+        variantFunc->setName(llvmFunc->getName() + "_variant" +
+                             std::to_string(i));
+        llvm::SubtargetFeatures features(target.cpuFeatures);
+        SmallVector<StringRef> variantFeatureList;
+        variantFeatures.split(variantFeatureList, ',', /*MaxSplit=*/-1,
+                              /*KeepEmpty=*/false);
+        for (StringRef feature : variantFeatureList) {
+          features.AddFeature(feature.trim());
+        }
+        variantFunc->addFnAttr("target-features", features.getString());
+        libraryBuilder.addExportVariant(exportOp.getName(), *requirements,
+                                        variantFunc);
+      }
     }
 
     auto queryFunctionName = std::string(kQueryFunctionName);
@@ -440,9 +576,11 @@ class LLVMCPUTargetBackend final : public TargetBackend {
     }
 
     // Fixup visibility from any symbols we may link in - we want to hide all
-    // but the query entry point.
+    // but the query entry point and any dispatch functions exported from
+    // static libraries.
     SetVector<llvm::Function *> preservedFuncs;
     preservedFuncs.insert(queryLibraryFunc);
+    preservedFuncs.insert(dispatchFuncs.begin(), dispatchFuncs.end());
     fixupVisibility(*llvmModule, preservedFuncs);
 
     // Dump bitcode post-linking and optimization.
@@ -453,26 +591,40 @@ class LLVMCPUTargetBackend final : public TargetBackend {
 
     SmallVector<Artifact> objectFiles;
 
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
+    // Emit the base object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking order.
     {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
-      std::string objectData;
-      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
-                                      llvm::CGFT_ObjectFile, &objectData))) {
-        return variantOp.emitError()
-               << "failed to compile LLVM-IR module to an object file";
+      // Large linked modules are split into partitions that are compiled to
+      // separate object files in parallel and linked back together. A single
+      // object file is instrumental to static library generation (which only
+      // supports one object file per library).
+      const unsigned partitionCount =
+          getCodegenPartitionCount(options_, *llvmModule);
+      SmallVector<std::string> objectData;
+      if (partitionCount > 1) {
+        if (failed(runEmitObjFilePassesInParallel(
+                [&]() { return createTargetMachine(target, options_); },
+                llvmModule.get(), partitionCount, objectData))) {
+          return variantOp.emitError()
+                 << "failed to compile LLVM-IR module to object files";
+        }
+      } else {
+        std::string data;
+        if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
+                                        llvm::CGFT_ObjectFile, &data))) {
+          return variantOp.emitError()
+                 << "failed to compile LLVM-IR module to an object file";
+        }
+        objectData.push_back(std::move(data));
+      }
+      for (auto &data : objectData) {
+        auto objectFile = Artifact::createTemporary(libraryName, "o");
+        auto &os = objectFile.outputFile->os();
+        os << data;
+        os.flush();
+        os.close();
+        objectFiles.push_back(std::move(objectFile));
       }
-      auto objectFile = Artifact::createTemporary(libraryName, "o");
-      auto &os = objectFile.outputFile->os();
-      os << objectData;
-      os.flush();
-      os.close();
-      objectFiles.push_back(std::move(objectFile));
     }
 
     // Dump assembly listing after optimization, which is just a textual
@@ -516,9 +668,9 @@ class LLVMCPUTargetBackend final : public TargetBackend {
     }
 
     if (options_.linkStatic) {
-      return serializeStaticLibraryExecutable(options, variantOp,
-                                              executableBuilder, libraryName,
-                                              queryFunctionName, objectFiles);
+      return serializeStaticLibraryExecutable(
+          options, variantOp, executableBuilder, libraryName, queryFunctionName,
+          dispatchFunctionNames, objectFiles);
     } else {
       return serializeDynamicLibraryExecutable(
           options, variantOp, executableBuilder, libraryName, targetTriple,
@@ -530,6 +682,7 @@ class LLVMCPUTargetBackend final : public TargetBackend {
       const SerializationOptions &options,
       IREE::HAL::ExecutableVariantOp variantOp, OpBuilder &executableBuilder,
       const std::string &libraryName, const std::string &queryFunctionName,
+      ArrayRef<std::string> dispatchFunctionNames,
       const SmallVector<Artifact> &objectFiles) {
     if (objectFiles.size() != 1) {
       // Static library output only supports single object libraries.
@@ -540,6 +693,7 @@ class LLVMCPUTargetBackend final : public TargetBackend {
     // Copy the static object file to the specified output along with
     // generated header file.
     if (!outputStaticLibrary(libraryName, queryFunctionName,
+                             dispatchFunctionNames,
                              options_.staticLibraryOutput,
                              objectFiles[0].path)) {
       return variantOp.emitError() << "static library generation failed";
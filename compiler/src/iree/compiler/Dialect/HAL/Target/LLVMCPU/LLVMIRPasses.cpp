@@ -6,8 +6,17 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMIRPasses.h"
 
+#include <algorithm>
+
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
@@ -17,8 +26,10 @@
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/Instrumentation/AddressSanitizer.h"
 #include "llvm/Transforms/Instrumentation/ThreadSanitizer.h"
 
@@ -128,6 +139,139 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
   return success();
 }
 
+LogicalResult runEmitObjFilePassesInParallel(
+    const std::function<std::unique_ptr<llvm::TargetMachine>()> &createMachine,
+    llvm::Module *module, unsigned partitionCount,
+    llvm::SmallVectorImpl<std::string> &objData) {
+  // splitCodeGen aborts if a target machine cannot be created so check once
+  // up-front that the factory works.
+  if (partitionCount == 0 || !createMachine()) return failure();
+  llvm::SmallVector<llvm::SmallVector<char, 0>> buffers(partitionCount);
+  llvm::SmallVector<std::unique_ptr<llvm::raw_svector_ostream>> streams;
+  llvm::SmallVector<llvm::raw_pwrite_stream *> streamPtrs;
+  for (auto &buffer : buffers) {
+    streams.push_back(std::make_unique<llvm::raw_svector_ostream>(buffer));
+    streamPtrs.push_back(streams.back().get());
+  }
+  // Each partition is cloned into its own LLVMContext and compiled on a
+  // thread of a pool sized to the partition count.
+  llvm::splitCodeGen(*module, streamPtrs, /*BCOSs=*/{}, createMachine,
+                     llvm::CGFT_ObjectFile, /*PreserveLocals=*/false);
+  streams.clear();
+  for (auto &buffer : buffers) {
+    objData.push_back(std::string(buffer.begin(), buffer.end()));
+  }
+  return success();
+}
+
+// Returns the number of lanes operated on by a value of |type|.
+static uint64_t getLaneCount(llvm::Type *type) {
+  if (auto *vectorType = dyn_cast<llvm::VectorType>(type)) {
+    return vectorType->getElementCount().getKnownMinValue();
+  }
+  return 1;
+}
+
+// Returns the number of bytes accessed by a load or store of |type|.
+static uint64_t getAccessSize(const llvm::DataLayout &dataLayout,
+                              llvm::Type *type) {
+  return dataLayout.getTypeStoreSize(type).getKnownMinValue();
+}
+
+// Accumulates the cost of |inst| into |estimate|. Returns false if the cost of
+// the instruction is unknown.
+static bool accumulateInstructionCost(const llvm::DataLayout &dataLayout,
+                                      llvm::Instruction &inst,
+                                      FunctionCostEstimate &estimate) {
+  if (auto *loadInst = dyn_cast<llvm::LoadInst>(&inst)) {
+    estimate.bytes += getAccessSize(dataLayout, loadInst->getType());
+  } else if (auto *storeInst = dyn_cast<llvm::StoreInst>(&inst)) {
+    estimate.bytes +=
+        getAccessSize(dataLayout, storeInst->getValueOperand()->getType());
+  } else if (isa<llvm::BinaryOperator, llvm::UnaryOperator, llvm::CmpInst,
+                 llvm::SelectInst>(inst)) {
+    estimate.ops += getLaneCount(inst.getType());
+  } else if (auto *memTransferInst = dyn_cast<llvm::MemTransferInst>(&inst)) {
+    auto *length = dyn_cast<llvm::ConstantInt>(memTransferInst->getLength());
+    if (!length) return false;
+    estimate.bytes += 2 * length->getZExtValue();
+  } else if (auto *memSetInst = dyn_cast<llvm::MemSetInst>(&inst)) {
+    auto *length = dyn_cast<llvm::ConstantInt>(memSetInst->getLength());
+    if (!length) return false;
+    estimate.bytes += length->getZExtValue();
+  } else if (auto *intrinsicInst = dyn_cast<llvm::IntrinsicInst>(&inst)) {
+    switch (intrinsicInst->getIntrinsicID()) {
+      case llvm::Intrinsic::masked_load:
+      case llvm::Intrinsic::masked_gather:
+        estimate.bytes += getAccessSize(dataLayout, inst.getType());
+        break;
+      case llvm::Intrinsic::masked_store:
+      case llvm::Intrinsic::masked_scatter:
+        estimate.bytes += getAccessSize(
+            dataLayout, intrinsicInst->getArgOperand(0)->getType());
+        break;
+      case llvm::Intrinsic::fma:
+      case llvm::Intrinsic::fmuladd:
+        estimate.ops += 2 * getLaneCount(inst.getType());
+        break;
+      default:
+        // Math functions and reductions count as one operation per lane of
+        // their result or, for reductions, their source. Intrinsics without
+        // results (debug info, lifetime markers, prefetches, etc.) are free.
+        if (!inst.getType()->isVoidTy()) {
+          uint64_t laneCount = getLaneCount(inst.getType());
+          if (intrinsicInst->arg_size() > 0) {
+            laneCount = std::max(
+                laneCount,
+                getLaneCount(intrinsicInst->getArgOperand(0)->getType()));
+          }
+          estimate.ops += laneCount;
+        }
+        break;
+    }
+  } else if (isa<llvm::CallBase>(inst)) {
+    // Calls to other functions (imports, ukernels, etc) have unknown cost.
+    return false;
+  }
+  return true;
+}
+
+std::optional<FunctionCostEstimate> estimateFunctionCost(
+    llvm::Function &func, const llvm::DataLayout &dataLayout) {
+  if (func.isDeclaration()) return std::nullopt;
+  llvm::DominatorTree domTree(func);
+  llvm::LoopInfo loopInfo(domTree);
+  llvm::TargetLibraryInfoImpl targetLibraryInfoImpl(
+      llvm::Triple(func.getParent()->getTargetTriple()));
+  llvm::TargetLibraryInfo targetLibraryInfo(targetLibraryInfoImpl, &func);
+  llvm::AssumptionCache assumptionCache(func);
+  llvm::ScalarEvolution scalarEvolution(func, targetLibraryInfo,
+                                        assumptionCache, domTree, loopInfo);
+
+  FunctionCostEstimate estimate;
+  for (llvm::BasicBlock &block : func) {
+    // Blocks within loops execute once per iteration of each enclosing loop.
+    uint64_t multiplier = 1;
+    for (llvm::Loop *loop = loopInfo.getLoopFor(&block); loop;
+         loop = loop->getParentLoop()) {
+      unsigned tripCount = scalarEvolution.getSmallConstantTripCount(loop);
+      if (tripCount == 0) return std::nullopt;
+      multiplier = llvm::SaturatingMultiply<uint64_t>(multiplier, tripCount);
+    }
+    FunctionCostEstimate blockEstimate;
+    for (llvm::Instruction &inst : block) {
+      if (!accumulateInstructionCost(dataLayout, inst, blockEstimate)) {
+        return std::nullopt;
+      }
+    }
+    estimate.ops = llvm::SaturatingMultiplyAdd<uint64_t>(
+        blockEstimate.ops, multiplier, estimate.ops);
+    estimate.bytes = llvm::SaturatingMultiplyAdd<uint64_t>(
+        blockEstimate.bytes, multiplier, estimate.bytes);
+  }
+  return estimate;
+}
+
 }  // namespace HAL
 }  // namespace IREE
 }  // namespace iree_compiler
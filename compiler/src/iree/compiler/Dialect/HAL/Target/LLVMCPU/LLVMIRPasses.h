@@ -7,9 +7,14 @@
 #ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVMCPU_LLVMIRPASSES_H_
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVMCPU_LLVMIRPASSES_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMTargetOptions.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Target/TargetMachine.h"
 #include "mlir/Support/LogicalResult.h"
@@ -34,6 +39,32 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
                                    llvm::CodeGenFileType fileType,
                                    std::string *objData);
 
+// Splits |module| into |partitionCount| partitions and emits an object file
+// for each in parallel using target machines created by |createMachine|.
+// Symbols referenced across partitions are given hidden external linkage in
+// |module| so that the objects can be linked together. The object file
+// contents are appended to |objData|.
+LogicalResult runEmitObjFilePassesInParallel(
+    const std::function<std::unique_ptr<llvm::TargetMachine>()> &createMachine,
+    llvm::Module *module, unsigned partitionCount,
+    llvm::SmallVectorImpl<std::string> &objData);
+
+// Statically estimated cost of a single call of a function.
+struct FunctionCostEstimate {
+  // Arithmetic operations performed, counting each vector lane.
+  uint64_t ops = 0;
+  // Bytes loaded and stored.
+  uint64_t bytes = 0;
+};
+
+// Estimates the cost of a single call of |func| by counting its arithmetic
+// and memory instructions weighted by the trip counts of the loops containing
+// them. Memory access sizes are derived from |dataLayout|. Returns
+// std::nullopt if |func| has loops without a constant trip count or calls
+// functions other than intrinsics, as their cost is unknown.
+std::optional<FunctionCostEstimate> estimateFunctionCost(
+    llvm::Function &func, const llvm::DataLayout &dataLayout);
+
 }  // namespace HAL
 }  // namespace IREE
 }  // namespace iree_compiler
@@ -94,6 +94,14 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
                      "host native CPU"),
       llvm::cl::init(""));
 
+  static llvm::cl::list<std::string> clExportVariantCPUFeatures(
+      "iree-llvmcpu-export-variant-cpu-features",
+      llvm::cl::desc(
+          "Additional LLVM target machine CPU features (comma-separated) for "
+          "which all exports are also compiled; the runtime selects the best "
+          "supported variant per export. May be repeated, most preferred "
+          "first"));
+
   static llvm::cl::opt<bool> llvmLoopInterleaving(
       "iree-llvmcpu-loop-interleaving", llvm::cl::init(false),
       llvm::cl::desc("Enable LLVM loop interleaving opt"));
@@ -118,6 +126,8 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
   if (clTargetCPU != "host" && clTargetCPU != "generic") {
     addTargetCPUFeaturesForCPU(targetOptions.target);
   }
+  targetOptions.exportVariantCPUFeatures.assign(
+      clExportVariantCPUFeatures.begin(), clExportVariantCPUFeatures.end());
   // TODO(muralivi): Move this into `addTargetCPUFeaturesForCPU`, after fixing
   // the predicate for when `addTargetCPUFeaturesForCPU` is called (i.e.
   // removing the condition that clTargetCPU is neither host nor generic).
@@ -215,6 +225,14 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::init(targetOptions.linkStatic));
   targetOptions.linkStatic = clLinkStatic;
 
+  static llvm::cl::opt<unsigned> clCodegenPartitions(
+      "iree-llvmcpu-codegen-partitions",
+      llvm::cl::desc("Number of partitions the linked LLVM module of each "
+                     "executable is split into for parallel code generation; "
+                     "0 uses one per hardware thread (non-reproducible)."),
+      llvm::cl::init(targetOptions.codegenPartitions));
+  targetOptions.codegenPartitions = clCodegenPartitions;
+
   static llvm::cl::opt<bool> clKeepLinkerArtifacts(
       "iree-llvmcpu-keep-linker-artifacts",
       llvm::cl::desc("Keep LLVM linker target artifacts (.so/.dll/etc)"),
@@ -230,6 +248,16 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::init(targetOptions.staticLibraryOutput));
   targetOptions.staticLibraryOutput = clStaticLibraryOutputPath;
 
+  static llvm::cl::opt<bool> clStaticLibraryExportDispatchFunctions(
+      "iree-llvmcpu-static-library-export-dispatch-functions",
+      llvm::cl::desc(
+          "Exports the dispatch functions of static libraries as "
+          "'{library}_{export}' symbols declared in the generated '.h' so that "
+          "they can be called directly and inlined with LTO."),
+      llvm::cl::init(targetOptions.staticLibraryExportDispatchFunctions));
+  targetOptions.staticLibraryExportDispatchFunctions =
+      clStaticLibraryExportDispatchFunctions;
+
   static llvm::cl::opt<bool> clListTargets(
       "iree-llvmcpu-list-targets",
       llvm::cl::desc("Lists all registered targets that the LLVM backend can "
@@ -7,6 +7,9 @@
 #ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVMCPU_LLVMTARGETOPTIONS_H_
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVMCPU_LLVMTARGETOPTIONS_H_
 
+#include <string>
+#include <vector>
+
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Target/TargetOptions.h"
 
@@ -33,6 +36,13 @@ struct LLVMTargetOptions {
   // Default target machine configuration.
   LLVMTarget target;
 
+  // Additional CPU feature sets (comma-separated LLVM target features, such as
+  // "+avx512f,+avx512vl") each of which every export is also compiled for.
+  // The runtime selects the implementation of each export for the processor it
+  // runs on, preferring feature sets in the order listed and falling back to
+  // the code compiled for |target|.
+  std::vector<std::string> exportVariantCPUFeatures;
+
   llvm::PipelineTuningOptions pipelineTuningOptions;
   // Optimization level to be used by the LLVM optimizer (middle-end).
   llvm::OptimizationLevel optimizerOptLevel;
@@ -71,6 +81,15 @@ struct LLVMTargetOptions {
   // any machine without requiring matching system libraries to be installed.
   bool linkStatic = false;
 
+  // Number of partitions the linked module of each executable is split into
+  // for code generation. Each partition is compiled to its own object file on
+  // a separate thread and the objects are then linked together into the
+  // library. The output only depends on the partition count so that builds
+  // remain reproducible across machines; 0 selects one partition per hardware
+  // thread at the cost of that. Outputs that require a single object file
+  // (such as static libraries) always use one partition.
+  unsigned codegenPartitions = 8;
+
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
 
@@ -80,6 +99,13 @@ struct LLVMTargetOptions {
   //
   // This option is incompatible with the linkEmbedded option.
   std::string staticLibraryOutput;
+
+  // Gives the dispatch functions of static libraries external linkage as
+  // `{library name}_{export name}` and declares them in the generated '.h' so
+  // that programs can call them directly (and have them inlined with LTO)
+  // instead of going through the library export table. Export variants are
+  // only reachable through the export table.
+  bool staticLibraryExportDispatchFunctions = false;
 };
 
 // Returns LLVMTargetOptions struct intialized with the iree-llvmcpu-* flags.
@@ -133,6 +133,32 @@ static llvm::StructType *makeDispatchAttrsType(llvm::LLVMContext &context) {
   return type;
 }
 
+// %struct.iree_hal_executable_dispatch_cost_v0_t = type {
+//   i64,
+//   i64,
+//   i32,
+//   i32
+// }
+static llvm::StructType *makeDispatchCostType(llvm::LLVMContext &context) {
+  if (auto *existingType = llvm::StructType::getTypeByName(
+          context, "iree_hal_executable_dispatch_cost_v0_t")) {
+    return existingType;
+  }
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+  auto *type =
+      llvm::StructType::create(context,
+                               {
+                                   i64Type,
+                                   i64Type,
+                                   i32Type,
+                                   i32Type,
+                               },
+                               "iree_hal_executable_dispatch_cost_v0_t",
+                               /*isPacked=*/false);
+  return type;
+}
+
 // %struct.iree_hal_executable_src_loc_v0_t = type {
 //   i32,
 //   i32,
@@ -208,6 +234,53 @@ static llvm::StructType *makeConstantTableType(llvm::LLVMContext &context) {
   return type;
 }
 
+// %struct.iree_hal_processor_v0_t = type {
+//   [8 x i64]
+// }
+static llvm::StructType *makeProcessorType(llvm::LLVMContext &context) {
+  if (auto *existingType = llvm::StructType::getTypeByName(
+          context, "iree_hal_processor_v0_t")) {
+    return existingType;
+  }
+  auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+  auto *type = llvm::StructType::create(
+      context,
+      {
+          llvm::ArrayType::get(i64Type,
+                               LibraryBuilder::kProcessorDataCapacity),
+      },
+      "iree_hal_processor_v0_t",
+      /*isPacked=*/false);
+  return type;
+}
+
+// %struct.iree_hal_executable_export_variant_table_v0_t = type {
+//   i32,
+//   i32*,
+//   %struct.iree_hal_processor_v0_t*,
+//   i32*,
+// }
+static llvm::StructType *makeVariantTableType(llvm::LLVMContext &context) {
+  if (auto *existingType = llvm::StructType::getTypeByName(
+          context, "iree_hal_executable_export_variant_table_v0_t")) {
+    return existingType;
+  }
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *dispatchFunctionType = makeDispatchFunctionType(context);
+  auto *processorType = makeProcessorType(context);
+  auto *type = llvm::StructType::create(
+      context,
+      {
+          i32Type,
+          i32Type->getPointerTo(),
+          processorType->getPointerTo(),
+          dispatchFunctionType->getPointerTo()->getPointerTo(),
+      },
+      "iree_hal_executable_export_variant_table_v0_t",
+      /*isPacked=*/false);
+  return type;
+}
+
 // %struct.iree_hal_executable_library_header_t = type {
 //   i32,
 //   i8*,
@@ -237,6 +310,9 @@ static llvm::StructType *makeLibraryHeaderType(llvm::LLVMContext &context) {
 //   %struct.iree_hal_executable_library_header_t*,
 //   %struct.iree_hal_executable_import_table_v0_t,
 //   %struct.iree_hal_executable_export_table_v0_t,
+//   %struct.iree_hal_executable_constant_table_v0_t,
+//   %struct.iree_hal_executable_export_variant_table_v0_t,
+//   %struct.iree_hal_executable_dispatch_cost_v0_t*,
 // }
 static llvm::StructType *makeLibraryType(llvm::StructType *libraryHeaderType) {
   auto &context = libraryHeaderType->getContext();
@@ -247,12 +323,16 @@ static llvm::StructType *makeLibraryType(llvm::StructType *libraryHeaderType) {
   auto *importTableType = makeImportTableType(context);
   auto *exportTableType = makeExportTableType(context);
   auto *constantTableType = makeConstantTableType(context);
+  auto *variantTableType = makeVariantTableType(context);
+  auto *dispatchCostType = makeDispatchCostType(context);
   auto *type = llvm::StructType::create(context,
                                         {
                                             libraryHeaderType->getPointerTo(),
                                             importTableType,
                                             exportTableType,
                                             constantTableType,
+                                            variantTableType,
+                                            dispatchCostType->getPointerTo(),
                                         },
                                         "iree_hal_executable_library_v0_t",
                                         /*isPacked=*/false);
@@ -398,7 +478,7 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
       llvm::find_if(exports, [](const Dispatch &dispatch) {
         return !dispatch.attrs.isDefault();
       }) != exports.end();
-  if (!hasNonDefaultAttrs) {
+  if (hasNonDefaultAttrs) {
     SmallVector<llvm::Constant *, 4> exportAttrValues;
     for (auto dispatch : exports) {
       exportAttrValues.push_back(llvm::ConstantStruct::get(
@@ -524,6 +604,134 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ConstantTable(
                          });
 }
 
+llvm::Constant *LibraryBuilder::buildLibraryV0VariantTable(
+    std::string libraryName) {
+  auto &context = module->getContext();
+  auto *variantTableType = makeVariantTableType(context);
+  auto *dispatchFunctionType = makeDispatchFunctionType(context);
+  auto *processorType = makeProcessorType(context);
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  llvm::Constant *zero = llvm::ConstantInt::get(i32Type, 0);
+
+  llvm::Constant *variantOrdinals =
+      llvm::Constant::getNullValue(i32Type->getPointerTo());
+  llvm::Constant *variantRequirements =
+      llvm::Constant::getNullValue(processorType->getPointerTo());
+  llvm::Constant *variantPtrs = llvm::Constant::getNullValue(
+      dispatchFunctionType->getPointerTo()->getPointerTo());
+  if (!variants.empty()) {
+    SmallVector<llvm::Constant *, 4> ordinalValues;
+    SmallVector<llvm::Constant *, 4> requirementValues;
+    SmallVector<llvm::Constant *, 4> ptrValues;
+    for (auto &variant : variants) {
+      auto it = llvm::find_if(exports, [&](const Dispatch &dispatch) {
+        return dispatch.name == variant.exportName;
+      });
+      assert(it != exports.end() && "variant of an undefined export");
+      ordinalValues.push_back(
+          llvm::ConstantInt::get(i32Type, std::distance(exports.begin(), it)));
+      SmallVector<uint64_t> data(kProcessorDataCapacity, 0);
+      llvm::copy(variant.requirements, data.begin());
+      requirementValues.push_back(llvm::ConstantStruct::get(
+          processorType,
+          {
+              // data=
+              llvm::ConstantDataArray::get(context, data),
+          }));
+      ptrValues.push_back(variant.func);
+    }
+
+    // iree_hal_executable_export_variant_table_v0_t::ordinals
+    auto *ordinalsType = llvm::ArrayType::get(i32Type, ordinalValues.size());
+    variantOrdinals = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        ordinalsType,
+        new llvm::GlobalVariable(
+            *module, ordinalsType, /*isConstant=*/true,
+            llvm::GlobalVariable::PrivateLinkage,
+            llvm::ConstantArray::get(ordinalsType, ordinalValues),
+            /*Name=*/libraryName + "_variant_ordinals"),
+        ArrayRef<llvm::Constant *>{zero, zero});
+
+    // iree_hal_executable_export_variant_table_v0_t::requirements
+    auto *requirementsType =
+        llvm::ArrayType::get(processorType, requirementValues.size());
+    variantRequirements = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        requirementsType,
+        new llvm::GlobalVariable(
+            *module, requirementsType, /*isConstant=*/true,
+            llvm::GlobalVariable::PrivateLinkage,
+            llvm::ConstantArray::get(requirementsType, requirementValues),
+            /*Name=*/libraryName + "_variant_requirements"),
+        ArrayRef<llvm::Constant *>{zero, zero});
+
+    // iree_hal_executable_export_variant_table_v0_t::ptrs
+    auto *ptrsType = llvm::ArrayType::get(dispatchFunctionType->getPointerTo(),
+                                          ptrValues.size());
+    variantPtrs = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        ptrsType,
+        new llvm::GlobalVariable(
+            *module, ptrsType, /*isConstant=*/true,
+            llvm::GlobalVariable::PrivateLinkage,
+            llvm::ConstantArray::get(ptrsType, ptrValues),
+            /*Name=*/libraryName + "_variant_funcs"),
+        ArrayRef<llvm::Constant *>{zero, zero});
+  }
+
+  return llvm::ConstantStruct::get(
+      variantTableType, {
+                            // count=
+                            llvm::ConstantInt::get(i32Type, variants.size()),
+                            // ordinals=
+                            variantOrdinals,
+                            // requirements=
+                            variantRequirements,
+                            // ptrs=
+                            variantPtrs,
+                        });
+}
+
+llvm::Constant *LibraryBuilder::buildLibraryV0CostTable(
+    std::string libraryName) {
+  auto &context = module->getContext();
+  auto *dispatchCostType = makeDispatchCostType(context);
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+  llvm::Constant *zero = llvm::ConstantInt::get(i32Type, 0);
+
+  bool hasNonDefaultCosts =
+      llvm::find_if(exports, [](const Dispatch &dispatch) {
+        return !dispatch.cost.isDefault();
+      }) != exports.end();
+  if (!hasNonDefaultCosts) {
+    return llvm::Constant::getNullValue(dispatchCostType->getPointerTo());
+  }
+
+  SmallVector<llvm::Constant *, 4> costValues;
+  for (auto dispatch : exports) {
+    costValues.push_back(llvm::ConstantStruct::get(
+        dispatchCostType,
+        {
+            // workgroup_ops=
+            llvm::ConstantInt::get(i64Type, dispatch.cost.workgroupOps),
+            // workgroup_bytes=
+            llvm::ConstantInt::get(i64Type, dispatch.cost.workgroupBytes),
+            // tiles_per_worker=
+            llvm::ConstantInt::get(i32Type, dispatch.cost.tilesPerWorker),
+            // reserved=
+            llvm::ConstantInt::get(i32Type, 0),
+        }));
+  }
+  auto *costsType = llvm::ArrayType::get(dispatchCostType, costValues.size());
+  return llvm::ConstantExpr::getInBoundsGetElementPtr(
+      costsType,
+      new llvm::GlobalVariable(
+          *module, costsType, /*isConstant=*/true,
+          llvm::GlobalVariable::PrivateLinkage,
+          llvm::ConstantArray::get(costsType, costValues),
+          /*Name=*/libraryName + "_costs"),
+      ArrayRef<llvm::Constant *>{zero, zero});
+}
+
 llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
   auto &context = module->getContext();
   auto *libraryHeaderType = makeLibraryHeaderType(context);
@@ -532,6 +740,18 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
 
   // ----- Header -----
 
+  // The variant and cost tables are always emitted but only read by runtimes
+  // if declared.
+  auto libraryFeatures = static_cast<uint32_t>(features);
+  if (!variants.empty()) {
+    libraryFeatures |= static_cast<uint32_t>(Features::EXPORT_VARIANTS);
+  }
+  if (llvm::any_of(exports, [](const Dispatch &dispatch) {
+        return !dispatch.cost.isDefault();
+      })) {
+    libraryFeatures |= static_cast<uint32_t>(Features::EXPORT_COSTS);
+  }
+
   auto *libraryHeader = new llvm::GlobalVariable(
       *module, libraryHeaderType, /*isConstant=*/true,
       llvm::GlobalVariable::PrivateLinkage,
@@ -544,7 +764,7 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
               // name=
               getStringConstant(module->getName(), module),
               // features=
-              llvm::ConstantInt::get(i32Type, static_cast<int64_t>(features)),
+              llvm::ConstantInt::get(i32Type, libraryFeatures),
               // sanitizer=
               llvm::ConstantInt::get(i32Type,
                                      static_cast<int64_t>(sanitizerKind)),
@@ -567,6 +787,10 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
                                     buildLibraryV0ExportTable(libraryName),
                                     // constants=
                                     buildLibraryV0ConstantTable(libraryName),
+                                    // variants=
+                                    buildLibraryV0VariantTable(libraryName),
+                                    // costs=
+                                    buildLibraryV0CostTable(libraryName),
                                 }),
       /*Name=*/libraryName);
   // TODO(benvanik): force alignment (8? natural pointer width?)
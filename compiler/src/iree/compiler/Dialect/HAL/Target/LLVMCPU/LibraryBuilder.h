@@ -28,7 +28,8 @@ namespace HAL {
 // Usage:
 //  LibraryBuilder builder(&module);
 //  builder.addExport(
-//     "hello", "source.mlir", 123, "test tag", DispatchAttrs{}, &helloFunc);
+//     "hello", "source.mlir", 123, "test tag", DispatchAttrs{}, DispatchCost{},
+//     &helloFunc);
 //  ...
 //  auto *queryFunc = builder.build("_query_library_foo");
 //  // call queryFunc, export it, etc
@@ -59,6 +60,10 @@ class LibraryBuilder {
   enum class Features : uint32_t {
     // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE
     NONE = 0u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS
+    EXPORT_VARIANTS = 1u << 0,
+    // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_COSTS
+    EXPORT_COSTS = 1u << 1,
   };
 
   // iree_hal_executable_library_sanitizer_kind_t
@@ -78,6 +83,9 @@ class LibraryBuilder {
   // IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
   static const int64_t kWorkgroupLocalMemoryPageSize = 4096;
 
+  // IREE_HAL_PROCESSOR_DATA_CAPACITY_V0
+  static const int64_t kProcessorDataCapacity = 8;
+
   // iree_hal_executable_dispatch_attrs_v0_t
   struct DispatchAttrs {
     // Required workgroup local memory size, in bytes.
@@ -87,6 +95,23 @@ class LibraryBuilder {
     constexpr bool isDefault() const { return localMemorySize == 0; }
   };
 
+  // iree_hal_executable_dispatch_cost_v0_t
+  struct DispatchCost {
+    // Estimated arithmetic operations per workgroup or 0 if unknown.
+    uint64_t workgroupOps = 0;
+
+    // Estimated bytes loaded and stored per workgroup or 0 if unknown.
+    uint64_t workgroupBytes = 0;
+
+    // Preferred minimum number of workgroups per worker or 0 if unknown.
+    uint32_t tilesPerWorker = 0;
+
+    // True if no estimates are available and the cost may be omitted.
+    constexpr bool isDefault() const {
+      return workgroupOps == 0 && workgroupBytes == 0 && tilesPerWorker == 0;
+    }
+  };
+
   LibraryBuilder(llvm::Module *module, Mode mode,
                  Version version = Version::LATEST)
       : module(module), mode(mode), version(version) {}
@@ -114,10 +139,29 @@ class LibraryBuilder {
   // |name| will be used as the library export
   // |sourceFile| and |sourceLoc| are optional source information
   // |tag| is an optional attachment
+  // |cost| is an optional scheduling hint
   void addExport(StringRef name, StringRef sourceFile, uint32_t sourceLoc,
-                 StringRef tag, DispatchAttrs attrs, llvm::Function *func) {
-    exports.push_back(
-        {name.str(), sourceFile.str(), sourceLoc, tag.str(), attrs, func});
+                 StringRef tag, DispatchAttrs attrs, DispatchCost cost,
+                 llvm::Function *func) {
+    exports.push_back({name.str(), sourceFile.str(), sourceLoc, tag.str(),
+                       attrs, cost, func});
+  }
+
+  // Defines an alternative implementation |func| of the export |exportName|
+  // that the runtime uses instead on processors with all of the
+  // |requirements| bits set in their processor data (see
+  // iree/schemas/cpu_data.h). Variants of an export are preferred in the order
+  // they are added and the default export implementation is used if none are
+  // usable.
+  void addExportVariant(StringRef exportName,
+                        ArrayRef<uint64_t> requirements,
+                        llvm::Function *func) {
+    assert(requirements.size() <= kProcessorDataCapacity &&
+           "too many processor data fields");
+    variants.push_back({exportName.str(),
+                        SmallVector<uint64_t>(requirements.begin(),
+                                              requirements.end()),
+                        func});
   }
 
   // Builds a `iree_hal_executable_library_query_fn_t` with the given
@@ -136,6 +180,8 @@ class LibraryBuilder {
   llvm::Constant *buildLibraryV0ImportTable(std::string libraryName);
   llvm::Constant *buildLibraryV0ExportTable(std::string libraryName);
   llvm::Constant *buildLibraryV0ConstantTable(std::string libraryName);
+  llvm::Constant *buildLibraryV0VariantTable(std::string libraryName);
+  llvm::Constant *buildLibraryV0CostTable(std::string libraryName);
 
   llvm::Module *module = nullptr;
   Mode mode = Mode::INCLUDE_REFLECTION_ATTRS;
@@ -155,10 +201,18 @@ class LibraryBuilder {
     uint32_t sourceLoc;
     std::string tag;
     DispatchAttrs attrs;
+    DispatchCost cost;
     llvm::Function *func;
   };
   SmallVector<Dispatch> exports;
 
+  struct Variant {
+    std::string exportName;
+    SmallVector<uint64_t> requirements;
+    llvm::Function *func;
+  };
+  SmallVector<Variant> variants;
+
   size_t constantCount = 0;
 };
 
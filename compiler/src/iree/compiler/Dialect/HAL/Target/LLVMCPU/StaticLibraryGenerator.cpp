@@ -58,6 +58,21 @@ static void generateQueryFunction(llvm::raw_ostream &os,
         "iree_hal_executable_environment_v0_t* environment);\n";
 }
 
+static void generateDispatchFunctions(
+    llvm::raw_ostream &os,
+    llvm::ArrayRef<std::string> dispatch_function_names) {
+  if (dispatch_function_names.empty()) return;
+  os << "\n// Dispatch functions that may be called directly for each "
+        "workgroup\n"
+     << "// instead of through the library export table.\n";
+  for (const auto &function_name : dispatch_function_names) {
+    os << "int " << function_name << "(\n"
+       << "const iree_hal_executable_environment_v0_t* environment,\n"
+       << "const iree_hal_executable_dispatch_state_v0_t* dispatch_state,\n"
+       << "const iree_hal_executable_workgroup_state_v0_t* workgroup_state);\n";
+  }
+}
+
 static void generateSuffix(llvm::raw_ostream &os,
                            const std::string &library_name,
                            const std::string &query_function_name) {
@@ -74,12 +89,14 @@ static void generateSuffix(llvm::raw_ostream &os,
 
 static bool generateExecutableLibraryHeader(
     const std::string &library_name, const std::string &query_function_name,
+    llvm::ArrayRef<std::string> dispatch_function_names,
     const std::string &header_file_path) {
   std::error_code ec;
   llvm::raw_fd_ostream os(header_file_path, ec);
 
   generatePrefix(os, library_name, query_function_name);
   generateQueryFunction(os, library_name, query_function_name);
+  generateDispatchFunctions(os, dispatch_function_names);
   generateSuffix(os, library_name, query_function_name);
 
   os.close();
@@ -88,6 +105,7 @@ static bool generateExecutableLibraryHeader(
 
 bool outputStaticLibrary(const std::string &library_name,
                          const std::string &query_function_name,
+                         llvm::ArrayRef<std::string> dispatch_function_names,
                          const std::string &library_output_path,
                          const std::string &temp_object_path) {
   llvm::SmallString<32> object_file_path(library_output_path);
@@ -103,6 +121,7 @@ bool outputStaticLibrary(const std::string &library_name,
 
   // Generate the header file.
   return generateExecutableLibraryHeader(library_name, query_function_name,
+                                         dispatch_function_names,
                                          header_file_path.c_str());
 }
 
@@ -10,6 +10,8 @@
 
 #include <string>
 
+#include "llvm/ADT/ArrayRef.h"
+
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
@@ -18,9 +20,11 @@ namespace HAL {
 // Produces a static executable library and generated '.h'.
 // The temporary object file is copied to the library_output_path. The '.h' file
 // with the query_function_name is placed beside it (using the same base
-// filename of the library). Returns true if successful.
+// filename of the library). Any |dispatch_function_names| are declared in the
+// '.h' so that they can be called directly. Returns true if successful.
 bool outputStaticLibrary(const std::string &library_name,
                          const std::string &query_function_name,
+                         llvm::ArrayRef<std::string> dispatch_function_names,
                          const std::string &library_output_path,
                          const std::string &temp_object_path);
 
@@ -64,6 +64,14 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-path", executableCachePath,
+      llvm::cl::desc(
+          "Path to a directory used to cache translated executables across "
+          "compiler invocations. Backend flags not reflected in the "
+          "executable target attributes are not part of the cache key."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 void dumpDataToPath(StringRef path, StringRef baseName, StringRef suffix,
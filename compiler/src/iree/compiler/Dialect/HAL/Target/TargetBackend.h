@@ -52,6 +52,12 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // A path to a persistent cache of translated executable variants.
+  // Variants whose contents, target and compiler version match a prior
+  // compilation reuse the cached translation instead of running the target
+  // backend translation pipeline.
+  std::string executableCachePath;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
@@ -54,9 +54,19 @@ VulkanSPIRVTargetOptions getVulkanSPIRVTargetOptionsFromFlags() {
           "Vulkan target environment as #vk.target_env attribute assembly"),
       llvm::cl::init(""));
 
+  static llvm::cl::opt<bool> clVulkanBufferDeviceAddress(
+      "iree-vulkan-experimental-buffer-device-address",
+      llvm::cl::desc(
+          "Passes buffers to shaders as buffer device addresses in push "
+          "constants instead of through descriptor sets when the target "
+          "environment supports physical storage buffers and the bindings "
+          "fit in the push constant range"),
+      llvm::cl::init(false));
+
   VulkanSPIRVTargetOptions targetOptions;
   targetOptions.vulkanTargetEnv = clVulkanTargetEnv;
   targetOptions.vulkanTargetTriple = clVulkanTargetTriple;
+  targetOptions.vulkanBufferDeviceAddress = clVulkanBufferDeviceAddress;
 
   return targetOptions;
 }
@@ -185,6 +195,12 @@ class VulkanSPIRVTargetBackend : public TargetBackend {
       iree_SpirVExecutableDef_subgroup_sizes_add(builder, subgroupSizesRef);
     }
     iree_SpirVExecutableDef_code_add(builder, spvCodeRef);
+    // Shaders using physical storage buffers take their bindings as buffer
+    // device addresses in push constants.
+    if (spvModuleOp.getAddressingModel() ==
+        spirv::AddressingModel::PhysicalStorageBuffer64) {
+      iree_SpirVExecutableDef_buffer_device_addresses_add(builder, true);
+    }
     iree_SpirVExecutableDef_end_as_root(builder);
 
     // Add the binary data to the target executable.
@@ -278,6 +294,18 @@ class VulkanSPIRVTargetBackend : public TargetBackend {
     configItems.emplace_back(b.getStringAttr(spirv::getTargetEnvAttrName()),
                              targetEnv);
 
+    // Buffer device addresses require physical storage buffers and 64-bit
+    // integers to assemble the addresses from push constants.
+    if (options_.vulkanBufferDeviceAddress && targetEnv) {
+      spirv::TargetEnv env(targetEnv);
+      if (env.allows(spirv::Capability::PhysicalStorageBufferAddresses) &&
+          env.allows(spirv::Capability::Int64) &&
+          env.allows(spirv::Extension::SPV_KHR_physical_storage_buffer)) {
+        configItems.emplace_back(b.getStringAttr("buffer_device_address"),
+                                 b.getUnitAttr());
+      }
+    }
+
     auto configAttr = b.getDictionaryAttr(configItems);
     return IREE::HAL::ExecutableTargetAttr::get(
         context, b.getStringAttr("vulkan"), b.getStringAttr("vulkan-spirv-fb"),
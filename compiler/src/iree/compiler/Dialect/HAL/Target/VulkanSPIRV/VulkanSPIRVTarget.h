@@ -21,6 +21,10 @@ struct VulkanSPIRVTargetOptions {
   std::string vulkanTargetEnv;
   // Vulkan target triple.
   std::string vulkanTargetTriple;
+  // Pass buffers to shaders as buffer device addresses in push constants
+  // instead of through descriptor sets when the target environment supports
+  // physical storage buffers.
+  bool vulkanBufferDeviceAddress = false;
 };
 
 // Returns a VulkanSPIRVTargetOptions struct initialized with Vulkan/SPIR-V
@@ -234,7 +234,8 @@ static void appendDispatchBenchmark(IREE::HAL::ExecutableOp executableOp,
   // TODO(benvanik): reuse the command buffer (initialize once and store).
   auto commandBufferModes =
       IREE::HAL::CommandBufferModeBitfield::OneShot |
-      IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution;
+      IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution |
+      IREE::HAL::CommandBufferModeBitfield::Unvalidated;
   auto commandBuffer =
       funcBuilder
           .create<IREE::HAL::CommandBufferCreateOp>(
@@ -10,12 +10,15 @@
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/PostOrderIterator.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/IR/RegionGraphTraits.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir {
@@ -28,10 +31,19 @@ struct DescriptorState {
   Value buffer;
   Value offset;
   Value length;
+
+  bool operator==(const DescriptorState &other) const {
+    return buffer == other.buffer && offset == other.offset &&
+           length == other.length;
+  }
+  bool operator!=(const DescriptorState &other) const {
+    return !(*this == other);
+  }
 };
 
 struct DescriptorSetState {
   Value pipelineLayout;
+  // Indexed by binding ordinal. Slots not known to be bound are empty.
   SmallVector<DescriptorState, 32> descriptors;
 
   DescriptorState &getDescriptor(int64_t index) {
@@ -45,6 +57,19 @@ struct DescriptorSetState {
     pipelineLayout = {};
     descriptors.clear();
   }
+
+  // Retains only the state that is identical in |other|.
+  void intersect(const DescriptorSetState &other) {
+    if (pipelineLayout != other.pipelineLayout) {
+      clear();
+      return;
+    }
+    descriptors.truncate(
+        std::min(descriptors.size(), other.descriptors.size()));
+    for (auto it : llvm::enumerate(descriptors)) {
+      if (it.value() != other.descriptors[it.index()]) it.value() = {};
+    }
+  }
 };
 
 struct CommandBufferState {
@@ -81,6 +106,26 @@ struct CommandBufferState {
     }
     return &descriptorSets[index];
   }
+
+  // Retains only the state that is identical in |other|.
+  void intersect(const CommandBufferState &other) {
+    if (pushConstantLayout != other.pushConstantLayout) {
+      pushConstantLayout = {};
+      pushConstants.clear();
+    } else {
+      pushConstants.truncate(
+          std::min(pushConstants.size(), other.pushConstants.size()));
+      for (auto it : llvm::enumerate(pushConstants)) {
+        if (it.value() != other.pushConstants[it.index()]) it.value() = {};
+      }
+    }
+    descriptorSets.truncate(
+        std::min(descriptorSets.size(), other.descriptorSets.size()));
+    for (auto it : llvm::enumerate(descriptorSets)) {
+      it.value().intersect(other.descriptorSets[it.index()]);
+    }
+    if (!other.previousFullBarrier) previousFullBarrier = {};
+  }
 };
 
 using CommandBufferStateMap = DenseMap<Value, CommandBufferState>;
@@ -167,41 +212,152 @@ static LogicalResult processOp(IREE::HAL::CommandBufferPushDescriptorSetOp op,
   auto *setState = state.getDescriptorSet(op.getSet());
   if (!setState) return failure();
 
-  bool isLayoutEqual = setState->pipelineLayout == op.getPipelineLayout();
-  setState->pipelineLayout = op.getPipelineLayout();
-
-  int64_t descriptorCount = op.getBindingBuffers().size();
-  llvm::BitVector redundantIndices(descriptorCount);
-  for (int64_t index = 0; index < descriptorCount; ++index) {
-    auto &descriptor = setState->getDescriptor(index);
-    auto buffer = op.getBindingBuffers()[index];
-    auto offset = op.getBindingOffsets()[index];
-    auto length = op.getBindingLengths()[index];
-    if (descriptor.buffer == buffer && descriptor.offset == offset &&
-        descriptor.length == length) {
-      // Redundant descriptor.
-      redundantIndices.set(index);
-    } else {
-      descriptor.buffer = buffer;
-      descriptor.offset = offset;
-      descriptor.length = length;
+  // Descriptors are tracked per binding slot so that pushes listing bindings
+  // in a different order or a subset of the previously pushed bindings can
+  // still be compared.
+  SmallVector<int64_t> bindingOrdinals;
+  for (auto ordinal : op.getBindingOrdinals()) {
+    APInt ordinalInt;
+    if (!matchPattern(ordinal, m_ConstantInt(&ordinalInt))) {
+      // Dynamic binding ordinal; not analyzable with this approach.
+      return failure();
     }
+    bindingOrdinals.push_back(ordinalInt.getSExtValue());
   }
 
-  // Bail early if no redundant bindings.
-  if (isLayoutEqual && redundantIndices.none()) {
-    return success();  // no-op
+  // The push is redundant if every binding it specifies is already bound with
+  // the same layout. Bindings set by prior pushes that are not specified
+  // remain bound as the prior descriptor set is not replaced.
+  bool isRedundant = setState->pipelineLayout == op.getPipelineLayout();
+  for (auto it : llvm::enumerate(bindingOrdinals)) {
+    if (!isRedundant) break;
+    DescriptorState descriptor = {
+        op.getBindingBuffers()[it.index()],
+        op.getBindingOffsets()[it.index()],
+        op.getBindingLengths()[it.index()],
+    };
+    isRedundant = it.value() < setState->descriptors.size() &&
+                  setState->descriptors[it.value()] == descriptor;
   }
-
-  // If all bits are set we can just kill the op.
-  if (isLayoutEqual && redundantIndices.all()) {
+  if (isRedundant) {
     op.erase();
     return success();
   }
 
+  // Pushing replaces the entire descriptor set and any bindings not specified
+  // are undefined afterward.
+  setState->clear();
+  setState->pipelineLayout = op.getPipelineLayout();
+  for (auto it : llvm::enumerate(bindingOrdinals)) {
+    setState->getDescriptor(it.value()) = {
+        op.getBindingBuffers()[it.index()],
+        op.getBindingOffsets()[it.index()],
+        op.getBindingLengths()[it.index()],
+    };
+  }
   return success();
 }
 
+// Elides redundant ops in |block| starting from the incoming |stateMap| and
+// updates it to reflect the state at the end of the block.
+static void processBlock(Block &block, CommandBufferStateMap &stateMap) {
+  // Discard state on ops we don't currently analyze (because this is super
+  // basic - we really need to analyze them).
+  auto invalidateState = [&](Value commandBuffer) {
+    stateMap[commandBuffer] = {};
+  };
+  auto resetCommandBufferBarrierBit = [&](Operation *op) {
+    assert(op->getNumOperands() > 0 && "must be a command buffer op");
+    auto commandBuffer = op->getOperand(0);
+    assert(commandBuffer.getType().isa<IREE::HAL::CommandBufferType>() &&
+           "operand 0 must be a command buffer");
+    stateMap[commandBuffer].previousFullBarrier = {};
+  };
+  for (auto &op : llvm::make_early_inc_range(block.getOperations())) {
+    if (!op.getDialect()) continue;
+    TypeSwitch<Operation *>(&op)
+        .Case([&](IREE::HAL::CommandBufferFinalizeOp op) {
+          invalidateState(op.getCommandBuffer());
+        })
+        .Case([&](IREE::HAL::CommandBufferExecutionBarrierOp op) {
+          processOp(op, stateMap[op.getCommandBuffer()]);
+        })
+        .Case([&](IREE::HAL::CommandBufferPushConstantsOp op) {
+          resetCommandBufferBarrierBit(op);
+          if (failed(processOp(op, stateMap[op.getCommandBuffer()]))) {
+            invalidateState(op.getCommandBuffer());
+          }
+        })
+        .Case([&](IREE::HAL::CommandBufferPushDescriptorSetOp op) {
+          resetCommandBufferBarrierBit(op);
+          if (failed(processOp(op, stateMap[op.getCommandBuffer()]))) {
+            invalidateState(op.getCommandBuffer());
+          }
+        })
+        .Case<IREE::HAL::CommandBufferDeviceOp,
+              IREE::HAL::CommandBufferBeginDebugGroupOp,
+              IREE::HAL::CommandBufferEndDebugGroupOp,
+              IREE::HAL::CommandBufferFillBufferOp,
+              IREE::HAL::CommandBufferCopyBufferOp,
+              IREE::HAL::CommandBufferDispatchSymbolOp,
+              IREE::HAL::CommandBufferDispatchOp,
+              IREE::HAL::CommandBufferDispatchIndirectSymbolOp,
+              IREE::HAL::CommandBufferDispatchIndirectOp>([&](Operation *op) {
+          // Ok - don't impact state.
+          resetCommandBufferBarrierBit(op);
+        })
+        .Default([&](Operation *op) {
+          if (op->getNumRegions() > 0 || isa<CallOpInterface>(op)) {
+            // Region ops (like scf.if) and calls may record commands that we
+            // don't analyze here - discard the entire state cache.
+            stateMap.clear();
+            return;
+          }
+          // Other unknown ops can only change the state of command buffers
+          // they use (such as branches forwarding them to successors).
+          for (auto operand : op->getOperands()) {
+            if (operand.getType().isa<IREE::HAL::CommandBufferType>()) {
+              invalidateState(operand);
+            }
+          }
+        });
+  }
+}
+
+// Returns the state at the entry of |block| derived from the state at the
+// exit of all of its predecessors. State is only known if all predecessors
+// have been processed and the state is identical along all edges.
+static CommandBufferStateMap getBlockEntryState(
+    Block *block, const DenseMap<Block *, CommandBufferStateMap> &exitStates) {
+  CommandBufferStateMap entryState;
+  bool isFirstPredecessor = true;
+  for (auto *predecessor : block->getPredecessors()) {
+    auto it = exitStates.find(predecessor);
+    if (it == exitStates.end()) {
+      // Back edge or unreachable predecessor.
+      return {};
+    }
+    if (isFirstPredecessor) {
+      entryState = it->second;
+      isFirstPredecessor = false;
+      continue;
+    }
+    SmallVector<Value> unknownCommandBuffers;
+    for (auto &entry : entryState) {
+      auto otherIt = it->second.find(entry.first);
+      if (otherIt == it->second.end()) {
+        unknownCommandBuffers.push_back(entry.first);
+      } else {
+        entry.second.intersect(otherIt->second);
+      }
+    }
+    for (auto commandBuffer : unknownCommandBuffers) {
+      entryState.erase(commandBuffer);
+    }
+  }
+  return entryState;
+}
+
 class ElideRedundantCommandsPass
     : public PassWrapper<ElideRedundantCommandsPass, OperationPass<void>> {
  public:
@@ -220,68 +376,23 @@ class ElideRedundantCommandsPass
   void runOnOperation() override {
     auto parentOp = getOperation();
 
-    // TODO(benvanik): intraprocedural at least; keep track of state at block
-    // boundaries. IPO would be nice but it (today) rarely happens that we
+    // State is tracked across blocks within each region by visiting blocks in
+    // reverse post-order such that all predecessors of a block have been
+    // processed before it unless they are reached through a back edge.
+    // Values tracked along all incoming edges dominate the block and can be
+    // compared against directly.
+    //
+    // TODO(benvanik): IPO would be nice but it (today) rarely happens that we
     // pass command buffers across calls.
     for (auto &region : parentOp->getRegions()) {
-      for (auto &block : region.getBlocks()) {
+      if (region.empty()) continue;
+      DenseMap<Block *, CommandBufferStateMap> exitStates;
+      for (auto *block : llvm::ReversePostOrderTraversal<Block *>(
+               &region.front())) {
         // State tracking for each command buffer found.
-        // Discard state on ops we don't currently analyze (because this is
-        // super basic - we really need to analyze them).
-        CommandBufferStateMap stateMap;
-        auto invalidateState = [&](Value commandBuffer) {
-          stateMap[commandBuffer] = {};
-        };
-        auto resetCommandBufferBarrierBit = [&](Operation *op) {
-          assert(op->getNumOperands() > 0 && "must be a command buffer op");
-          auto commandBuffer = op->getOperand(0);
-          assert(commandBuffer.getType().isa<IREE::HAL::CommandBufferType>() &&
-                 "operand 0 must be a command buffer");
-          stateMap[commandBuffer].previousFullBarrier = {};
-        };
-        for (auto &op : llvm::make_early_inc_range(block.getOperations())) {
-          if (!op.getDialect()) continue;
-          TypeSwitch<Operation *>(&op)
-              .Case([&](IREE::HAL::CommandBufferFinalizeOp op) {
-                invalidateState(op.getCommandBuffer());
-              })
-              .Case([&](IREE::HAL::CommandBufferExecutionBarrierOp op) {
-                processOp(op, stateMap[op.getCommandBuffer()]);
-              })
-              .Case([&](IREE::HAL::CommandBufferPushConstantsOp op) {
-                resetCommandBufferBarrierBit(op);
-                if (failed(processOp(op, stateMap[op.getCommandBuffer()]))) {
-                  invalidateState(op.getCommandBuffer());
-                }
-              })
-              .Case([&](IREE::HAL::CommandBufferPushDescriptorSetOp op) {
-                resetCommandBufferBarrierBit(op);
-                if (failed(processOp(op, stateMap[op.getCommandBuffer()]))) {
-                  invalidateState(op.getCommandBuffer());
-                }
-              })
-              .Case<IREE::HAL::CommandBufferDeviceOp,
-                    IREE::HAL::CommandBufferBeginDebugGroupOp,
-                    IREE::HAL::CommandBufferEndDebugGroupOp,
-                    IREE::HAL::CommandBufferFillBufferOp,
-                    IREE::HAL::CommandBufferCopyBufferOp,
-                    IREE::HAL::CommandBufferDispatchSymbolOp,
-                    IREE::HAL::CommandBufferDispatchOp,
-                    IREE::HAL::CommandBufferDispatchIndirectSymbolOp,
-                    IREE::HAL::CommandBufferDispatchIndirectOp>(
-                  [&](Operation *op) {
-                    // Ok - don't impact state.
-                    resetCommandBufferBarrierBit(op);
-                  })
-              .Default([&](Operation *op) {
-                // Unknown op - discard state cache.
-                // This is to avoid correctness issues with region ops (like
-                // scf.if) that we don't analyze properly here. We could
-                // restrict this a bit by only discarding on use of the
-                // command buffer.
-                stateMap.clear();
-              });
-        }
+        CommandBufferStateMap stateMap = getBlockEntryState(block, exitStates);
+        processBlock(*block, stateMap);
+        exitStates[block] = std::move(stateMap);
       }
     }
   }
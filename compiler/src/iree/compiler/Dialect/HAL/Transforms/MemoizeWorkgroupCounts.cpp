@@ -0,0 +1,233 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/SetVector.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Workgroup count calculations that contain at most this many ops per key
+// value (plus a fixed overhead) are cheaper to recompute than to look up.
+static constexpr int kLookupCostPerKey = 3;
+static constexpr int kLookupCostBase = 3;
+
+namespace {
+
+// Host computation producing the workgroup count of a single dispatch.
+struct WorkgroupCountSlice {
+  // Pure ops computing the workgroup count in block order.
+  SmallVector<Operation *> ops;
+  // Non-constant values the computation depends on in first-use order.
+  SmallVector<Value> keys;
+  // Number of ops in |ops| that are not constants.
+  int computeOpCount = 0;
+};
+
+}  // namespace
+
+// Returns true if |op| can be recomputed inside the memoization branch.
+static bool isMemoizableOp(Operation *op) {
+  if (op->getNumRegions() != 0 || !isPure(op)) return false;
+  return llvm::all_of(op->getResultTypes(),
+                      [](Type type) { return type.isIntOrIndex(); });
+}
+
+// Gathers the pure computation in |block| producing |workgroupCount|.
+static WorkgroupCountSlice computeSlice(Block *block,
+                                        ValueRange workgroupCount) {
+  WorkgroupCountSlice slice;
+  llvm::SetVector<Operation *> ops;
+  llvm::SetVector<Value> keys;
+  SmallVector<Value> worklist(workgroupCount.begin(), workgroupCount.end());
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    Operation *definingOp = value.getDefiningOp();
+    if (definingOp && definingOp->getBlock() == block &&
+        isMemoizableOp(definingOp)) {
+      if (!ops.insert(definingOp)) continue;
+      if (!definingOp->hasTrait<OpTrait::ConstantLike>()) {
+        ++slice.computeOpCount;
+      }
+      llvm::append_range(worklist, definingOp->getOperands());
+    } else if (value.getType().isIntOrIndex()) {
+      keys.insert(value);
+    } else {
+      // Non-integer leaves (such as device handles) cannot be used as keys.
+      return {};
+    }
+  }
+  slice.ops = ops.takeVector();
+  llvm::sort(slice.ops, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+  slice.keys = keys.takeVector();
+  return slice;
+}
+
+// Wraps the workgroup count computation of |dispatchOp| such that it is only
+// performed when the keys differ from those of the previous execution.
+template <typename DispatchOpT>
+static void memoizeWorkgroupCount(DispatchOpT dispatchOp,
+                                  SymbolTable &symbolTable,
+                                  OpBuilder &moduleBuilder) {
+  SmallVector<Value> workgroupCount = {
+      dispatchOp.getWorkgroupX(),
+      dispatchOp.getWorkgroupY(),
+      dispatchOp.getWorkgroupZ(),
+  };
+  auto slice = computeSlice(dispatchOp->getBlock(), workgroupCount);
+  if (slice.keys.empty() ||
+      slice.computeOpCount <=
+          kLookupCostPerKey * static_cast<int>(slice.keys.size()) +
+              kLookupCostBase) {
+    return;
+  }
+
+  auto loc = dispatchOp.getLoc();
+  auto createGlobal = [&](StringRef name, Type type,
+                          TypedAttr initialValue = {}) {
+    auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+        loc, name, /*isMutable=*/true, type,
+        initialValue ? std::optional<TypedAttr>(initialValue) : std::nullopt);
+    globalOp.setPrivate();
+    symbolTable.insert(globalOp);
+    return globalOp;
+  };
+  auto validGlobalOp = createGlobal("_workgroup_count_valid",
+                                    moduleBuilder.getI1Type(),
+                                    moduleBuilder.getBoolAttr(false));
+  SmallVector<IREE::Util::GlobalOp> keyGlobalOps;
+  for (Value key : slice.keys) {
+    keyGlobalOps.push_back(createGlobal("_workgroup_count_key", key.getType()));
+  }
+  SmallVector<IREE::Util::GlobalOp> countGlobalOps;
+  for (Value count : workgroupCount) {
+    countGlobalOps.push_back(
+        createGlobal("_workgroup_count_value", count.getType()));
+  }
+
+  // Compare the keys against the last execution.
+  OpBuilder builder(dispatchOp);
+  Value isHit =
+      builder.create<IREE::Util::GlobalLoadOp>(loc, validGlobalOp).getResult();
+  for (auto [key, keyGlobalOp] : llvm::zip_equal(slice.keys, keyGlobalOps)) {
+    Value cachedKey =
+        builder.create<IREE::Util::GlobalLoadOp>(loc, keyGlobalOp).getResult();
+    Value isEqual = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                                  key, cachedKey);
+    isHit = builder.create<arith::AndIOp>(loc, isHit, isEqual);
+  }
+
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, isHit,
+      [&](OpBuilder &thenBuilder, Location loc) {
+        SmallVector<Value> cachedCount;
+        for (auto countGlobalOp : countGlobalOps) {
+          cachedCount.push_back(
+              thenBuilder.create<IREE::Util::GlobalLoadOp>(loc, countGlobalOp)
+                  .getResult());
+        }
+        thenBuilder.create<scf::YieldOp>(loc, cachedCount);
+      },
+      [&](OpBuilder &elseBuilder, Location loc) {
+        IRMapping mapping;
+        for (Operation *op : slice.ops) elseBuilder.clone(*op, mapping);
+        SmallVector<Value> newCount;
+        for (auto [count, countGlobalOp] :
+             llvm::zip_equal(workgroupCount, countGlobalOps)) {
+          Value newValue = mapping.lookupOrDefault(count);
+          elseBuilder.create<IREE::Util::GlobalStoreOp>(loc, newValue,
+                                                        countGlobalOp);
+          newCount.push_back(newValue);
+        }
+        for (auto [key, keyGlobalOp] :
+             llvm::zip_equal(slice.keys, keyGlobalOps)) {
+          elseBuilder.create<IREE::Util::GlobalStoreOp>(loc, key, keyGlobalOp);
+        }
+        Value trueValue = elseBuilder.create<arith::ConstantIntOp>(
+            loc, 1, elseBuilder.getI1Type());
+        elseBuilder.create<IREE::Util::GlobalStoreOp>(loc, trueValue,
+                                                      validGlobalOp);
+        elseBuilder.create<scf::YieldOp>(loc, newCount);
+      });
+  dispatchOp.getWorkgroupXMutable().assign(ifOp.getResult(0));
+  dispatchOp.getWorkgroupYMutable().assign(ifOp.getResult(1));
+  dispatchOp.getWorkgroupZMutable().assign(ifOp.getResult(2));
+
+  // Drop the original computation if the dispatch was its only user.
+  for (Operation *op : llvm::reverse(slice.ops)) {
+    if (op->use_empty()) op->erase();
+  }
+}
+
+class MemoizeWorkgroupCountsPass
+    : public PassWrapper<MemoizeWorkgroupCountsPass,
+                         OperationPass<ModuleOp>> {
+ public:
+  StringRef getArgument() const override {
+    return "iree-hal-memoize-workgroup-counts";
+  }
+
+  StringRef getDescription() const override {
+    return "Caches dynamic dispatch workgroup counts across invocations";
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, scf::SCFDialect,
+                    IREE::Util::UtilDialect>();
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SymbolTable symbolTable(moduleOp);
+    auto moduleBuilder = OpBuilder::atBlockBegin(moduleOp.getBody());
+
+    // Gather first as memoization inserts new ops around the dispatches.
+    SmallVector<Operation *> dispatchOps;
+    for (auto callableOp : moduleOp.getOps<mlir::CallableOpInterface>()) {
+      callableOp.walk([&](Operation *op) {
+        if (isa<IREE::HAL::CommandBufferDispatchOp,
+                IREE::HAL::CommandBufferDispatchSymbolOp>(op)) {
+          dispatchOps.push_back(op);
+        }
+      });
+    }
+    for (auto *op : dispatchOps) {
+      if (auto dispatchOp = dyn_cast<IREE::HAL::CommandBufferDispatchOp>(op)) {
+        memoizeWorkgroupCount(dispatchOp, symbolTable, moduleBuilder);
+      } else {
+        memoizeWorkgroupCount(
+            cast<IREE::HAL::CommandBufferDispatchSymbolOp>(op), symbolTable,
+            moduleBuilder);
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>> createMemoizeWorkgroupCountsPass() {
+  return std::make_unique<MemoizeWorkgroupCountsPass>();
+}
+
+static PassRegistration<MemoizeWorkgroupCountsPass> pass;
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
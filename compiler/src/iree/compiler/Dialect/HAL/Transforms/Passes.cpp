@@ -54,6 +54,15 @@ static llvm::cl::opt<unsigned> clBenchmarkDispatchRepeatCount{
     llvm::cl::init(1),
 };
 
+static llvm::cl::opt<bool> clMemoizeWorkgroupCounts{
+    "iree-hal-memoize-dynamic-workgroup-counts",
+    llvm::cl::desc(
+        "Caches the workgroup counts of dynamically-shaped dispatches in "
+        "globals keyed on their inputs so that invocations with repeated "
+        "shapes skip recalculating them."),
+    llvm::cl::init(false),
+};
+
 static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     "iree-hal-instrument-dispatches",
     llvm::cl::desc("Enables dispatch instrumentation with a power-of-two byte "
@@ -240,7 +249,7 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // After this point the executables are opaque blobs and we cannot change
   // their interfaces.
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      createTranslateExecutablesPass());
+      createTranslateExecutablesPass(targetOptions.executableCachePath));
 
   if (compileTo == PipelinePhase::ExecutableTargets) return;
 
@@ -320,6 +329,11 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // Elide redundant command buffer state ops created during conversion.
   FunctionLikeNest(passManager).addPass(createElideRedundantCommandsPass);
 
+  // Cache dynamic workgroup count calculations across invocations.
+  if (clMemoizeWorkgroupCounts) {
+    passManager.addPass(createMemoizeWorkgroupCountsPass());
+  }
+
   // Fixup workgroup count calculations that may have used the affine dialect.
   // Kind of random here but can happen if the benchmarking code does things.
   passManager.addPass(mlir::createLowerAffinePass());
@@ -89,6 +89,11 @@ std::unique_ptr<OperationPass<void>> createInlineDeviceSwitchesPass();
 // Finds hal.device.query ops and creates variables initialized on startup.
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createMemoizeDeviceQueriesPass();
 
+// Caches dynamic workgroup count calculations in globals keyed on their inputs
+// so that repeated invocations with the same shapes reuse the prior results.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createMemoizeWorkgroupCountsPass();
+
 //===----------------------------------------------------------------------===//
 // Executable translation
 //===----------------------------------------------------------------------===//
@@ -128,12 +133,15 @@ std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createPreprocessExecutablesWithToolPass(std::string command);
 
 // Translates hal.executable.variant ops via a nested translation pipeline.
+// If |cachePath| is provided translated variants are cached in and reused from
+// the directory across compiler invocations.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass();
+createTranslateExecutablesPass(std::string cachePath = "");
 
 // Translates hal.executable.variant ops for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
-createTranslateTargetExecutableVariantsPass(StringRef target);
+createTranslateTargetExecutableVariantsPass(StringRef target,
+                                            std::string cachePath = "");
 
 // Calls into each target backend to have it link multiple hal.executables
 // together (if that makes sense). For example, the LLVM AOT backend may combine
@@ -204,6 +212,7 @@ inline void registerHALPasses() {
   createMaterializeInterfacesPass();
   createMaterializeResourceCachesPass(targetOptions);
   createMemoizeDeviceQueriesPass();
+  createMemoizeWorkgroupCountsPass();
   createPreprocessExecutablesPass("");
   createResolveExportOrdinalsPass();
   createSerializeExecutablesPass();
@@ -11,12 +11,20 @@
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "iree/compiler/Tools/version.h"
 #include "iree/compiler/Utils/TracingUtils.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/Parser/Parser.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 
@@ -25,6 +33,89 @@ namespace iree_compiler {
 namespace IREE {
 namespace HAL {
 
+//===----------------------------------------------------------------------===//
+// Persistent executable cache
+//===----------------------------------------------------------------------===//
+
+// Returns the path of the cache entry for the translation of |variantOp| by
+// |target| under |cachePath|. The key covers the variant contents (including
+// its target attributes), the target backend and the compiler version but not
+// locations so that unrelated source edits still hit the cache.
+static std::string getCacheEntryPath(StringRef cachePath, StringRef target,
+                                     IREE::HAL::ExecutableVariantOp variantOp) {
+  std::string keyStr;
+  llvm::raw_string_ostream keyStream(keyStr);
+  keyStream << getIreeRevision() << "\n"
+            << LLVM_VERSION_STRING << "\n"
+            << target << "\n";
+  variantOp->print(keyStream, OpPrintingFlags().printGenericOpForm());
+  llvm::SHA256 hasher;
+  hasher.update(keyStream.str());
+  SmallString<128> entryPath(cachePath);
+  llvm::sys::path::append(
+      entryPath, llvm::toHex(hasher.result(), /*LowerCase=*/true) + ".mlir");
+  return entryPath.str().str();
+}
+
+// Replaces the contents of |variantOp| with the translated variant cached at
+// |entryPath|. Missing or unparsable entries are treated as misses.
+static LogicalResult loadCachedVariant(
+    StringRef entryPath, IREE::HAL::ExecutableVariantOp variantOp) {
+  auto fileOrErr = llvm::MemoryBuffer::getFile(entryPath);
+  if (!fileOrErr) return failure();
+
+  // Entries are only parsed for their contents and are verified once moved
+  // into place as a variant is not valid outside of an executable.
+  auto *context = variantOp.getContext();
+  ScopedDiagnosticHandler diagHandler(context,
+                                      [](Diagnostic &) { return success(); });
+  Block block;
+  if (failed(parseSourceString((*fileOrErr)->getBuffer(), &block,
+                               ParserConfig(context,
+                                            /*verifyAfterParse=*/false)))) {
+    return failure();
+  }
+  auto cachedOp = dyn_cast_or_null<IREE::HAL::ExecutableVariantOp>(
+      block.empty() ? nullptr : &block.front());
+  if (!cachedOp || cachedOp.getSymName() != variantOp.getSymName()) {
+    return failure();
+  }
+
+  variantOp->setAttrs(cachedOp->getAttrDictionary());
+  variantOp->getRegion(0).takeBody(cachedOp->getRegion(0));
+  return success();
+}
+
+// Writes the translated |variantOp| to |entryPath|. Entries are written to a
+// temporary file and renamed into place so that concurrent compilations never
+// observe partial entries. Failures only lose the cache entry.
+static void storeCachedVariant(StringRef entryPath,
+                               IREE::HAL::ExecutableVariantOp variantOp) {
+  llvm::sys::fs::create_directories(llvm::sys::path::parent_path(entryPath));
+  SmallString<128> tempPath;
+  int fd = -1;
+  if (llvm::sys::fs::createUniqueFile(entryPath + ".%%%%%%%%.tmp", fd,
+                                      tempPath)) {
+    return;
+  }
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  variantOp->print(
+      os, OpPrintingFlags().printGenericOpForm().enableDebugInfo());
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    llvm::sys::fs::remove(tempPath);
+    return;
+  }
+  if (llvm::sys::fs::rename(tempPath, entryPath)) {
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-hal-translate-target-executable-variants
+//===----------------------------------------------------------------------===//
+
 class TranslateTargetExecutableVariantsPass
     : public PassWrapper<TranslateTargetExecutableVariantsPass,
                          OperationPass<IREE::HAL::ExecutableVariantOp>> {
@@ -32,8 +123,10 @@ class TranslateTargetExecutableVariantsPass
   TranslateTargetExecutableVariantsPass() = default;
   TranslateTargetExecutableVariantsPass(
       const TranslateTargetExecutableVariantsPass &pass) {}
-  TranslateTargetExecutableVariantsPass(StringRef target) {
+  TranslateTargetExecutableVariantsPass(StringRef target,
+                                        std::string cachePath) {
     this->target = target.str();
+    this->cachePath = cachePath;
   }
 
   StringRef getArgument() const override {
@@ -63,6 +156,14 @@ class TranslateTargetExecutableVariantsPass
       return signalPassFailure();
     }
 
+    // The key must be computed prior to translation as it is derived from the
+    // source contents of the variant.
+    std::string cacheEntryPath;
+    if (!cachePath.empty()) {
+      cacheEntryPath = getCacheEntryPath(cachePath, target, variantOp);
+      if (succeeded(loadCachedVariant(cacheEntryPath, variantOp))) return;
+    }
+
     OpPassManager passManager(variantOp.getOperationName());
     targetBackend->buildTranslationPassPipeline(variantOp, passManager);
     if (failed(runPipeline(passManager, variantOp))) {
@@ -71,6 +172,8 @@ class TranslateTargetExecutableVariantsPass
                             << variantOp.getTarget();
       return signalPassFailure();
     }
+
+    if (!cacheEntryPath.empty()) storeCachedVariant(cacheEntryPath, variantOp);
   }
 
  private:
@@ -79,21 +182,32 @@ class TranslateTargetExecutableVariantsPass
       llvm::cl::desc(
           "Target backend name whose executables will be translated by "
           "this pass.")};
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Path to a directory used to cache translated variants "
+                     "across compiler invocations.")};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
-createTranslateTargetExecutableVariantsPass(StringRef target) {
-  return std::make_unique<TranslateTargetExecutableVariantsPass>(target);
+createTranslateTargetExecutableVariantsPass(StringRef target,
+                                            std::string cachePath) {
+  return std::make_unique<TranslateTargetExecutableVariantsPass>(target,
+                                                                 cachePath);
 }
 
 static PassRegistration<TranslateTargetExecutableVariantsPass> linkTargetPass(
     [] { return std::make_unique<TranslateTargetExecutableVariantsPass>(); });
 
+//===----------------------------------------------------------------------===//
+// --iree-hal-translate-executables
+//===----------------------------------------------------------------------===//
+
 class TranslateExecutablesPass
     : public PassWrapper<TranslateExecutablesPass,
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   TranslateExecutablesPass() = default;
+  TranslateExecutablesPass(std::string cachePath) : cachePath(cachePath) {}
 
   StringRef getArgument() const override {
     return "iree-hal-translate-executables";
@@ -117,7 +231,7 @@ class TranslateExecutablesPass
     OpPassManager passManager(executableOp.getOperationName());
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
-          createTranslateTargetExecutableVariantsPass(targetName));
+          createTranslateTargetExecutableVariantsPass(targetName, cachePath));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
@@ -127,11 +241,14 @@ class TranslateExecutablesPass
       return signalPassFailure();
     }
   }
+
+ private:
+  std::string cachePath;
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass() {
-  return std::make_unique<TranslateExecutablesPass>();
+createTranslateExecutablesPass(std::string cachePath) {
+  return std::make_unique<TranslateExecutablesPass>(cachePath);
 }
 
 static PassRegistration<TranslateExecutablesPass> translatePass([] {
@@ -87,7 +87,7 @@ module attributes {hal.device.targets = [#device_target_cpu]}  {
 
     // CHECK: %[[CMD:.+]] = hal.command_buffer.create
     // CHECK-SAME: device(%[[DEVICE]] : !hal.device)
-    // CHECK-SAME: mode("OneShot|AllowInlineExecution")
+    // CHECK-SAME: mode("OneShot|AllowInlineExecution|Unvalidated")
     // CHECK-SAME: categories("Transfer|Dispatch") : !hal.command_buffer
     %timepoint = stream.cmd.execute
         with(%arg0_resource as %arg0_capture: !stream.resource<external>{%c16},
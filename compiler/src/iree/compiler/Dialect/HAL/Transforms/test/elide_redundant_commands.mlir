@@ -100,8 +100,6 @@ func.func @elidePushConstantsSuffix(%cmd: !hal.command_buffer, %pipeline_layout:
 
 // -----
 
-// NOTE: today we just check for complete equality.
-
 // CHECK-LABEL: @elidePushDescriptorSet
 // CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.pipeline_layout, %[[BUFFER0:.+]]: !hal.buffer, %[[BUFFER1:.+]]: !hal.buffer)
 func.func @elidePushDescriptorSet(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %buffer0: !hal.buffer, %buffer1: !hal.buffer) {
@@ -127,3 +125,115 @@ func.func @elidePushDescriptorSet(%cmd: !hal.command_buffer, %pipeline_layout: !
   // CHECK: return
   return
 }
+
+// -----
+
+// Tests that descriptors are compared per binding slot.
+
+// CHECK-LABEL: @elidePushDescriptorSetSlots
+// CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.pipeline_layout, %[[BUFFER0:.+]]: !hal.buffer, %[[BUFFER1:.+]]: !hal.buffer)
+func.func @elidePushDescriptorSetSlots(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %buffer0: !hal.buffer, %buffer1: !hal.buffer) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %size = arith.constant 100 : index
+  // CHECK: hal.command_buffer.push_descriptor_set<%[[CMD]] : !hal.command_buffer> layout(%[[LAYOUT]] : !hal.pipeline_layout)[%c0] bindings([
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer0 : !hal.buffer)[%c0, %size],
+    %c1 = (%buffer1 : !hal.buffer)[%c0, %size]
+  ])
+  // Same bindings in a different order.
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c1 = (%buffer1 : !hal.buffer)[%c0, %size],
+    %c0 = (%buffer0 : !hal.buffer)[%c0, %size]
+  ])
+  // Subset of the bound bindings.
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c1 = (%buffer1 : !hal.buffer)[%c0, %size]
+  ])
+  // Same buffers bound to different slots.
+  //      CHECK: hal.command_buffer.push_descriptor_set<%[[CMD]] : !hal.command_buffer> layout(%[[LAYOUT]] : !hal.pipeline_layout)[%c0] bindings([
+  // CHECK-NEXT:   %c0 = (%[[BUFFER1]] : !hal.buffer)
+  // CHECK-NEXT:   %c1 = (%[[BUFFER0]] : !hal.buffer)
+  // CHECK-NEXT: ])
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer1 : !hal.buffer)[%c0, %size],
+    %c1 = (%buffer0 : !hal.buffer)[%c0, %size]
+  ])
+  // CHECK: return
+  return
+}
+
+// -----
+
+// Tests that ops not using the command buffer don't discard state and that
+// state is carried across blocks when known along all incoming edges.
+
+// CHECK-LABEL: @elideAcrossBlocks
+// CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.pipeline_layout, %[[BUFFER:.+]]: !hal.buffer, %[[COND:.+]]: i1)
+func.func @elideAcrossBlocks(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %buffer: !hal.buffer, %cond: i1) {
+  %c0 = arith.constant 0 : index
+  %size = arith.constant 100 : index
+  // CHECK: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %size]
+  ])
+  // CHECK: cf.cond_br
+  cf.cond_br %cond, ^bb1, ^bb2
+// CHECK: ^bb1:
+^bb1:
+  // CHECK-NEXT: arith.addi
+  %unrelated = arith.addi %c0, %size : index
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %size]
+  ])
+  // CHECK: cf.br ^bb3
+  cf.br ^bb3
+// CHECK: ^bb2:
+^bb2:
+  // CHECK-NEXT: cf.br ^bb3
+  cf.br ^bb3
+// CHECK: ^bb3:
+^bb3:
+  // CHECK-NEXT: return
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %size]
+  ])
+  return
+}
+
+// -----
+
+// Tests that state is not carried into blocks that differ along their incoming
+// edges or are reached through back edges.
+
+// CHECK-LABEL: @preserveDivergentState
+// CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.pipeline_layout, %[[BUFFER0:.+]]: !hal.buffer, %[[BUFFER1:.+]]: !hal.buffer, %[[COND:.+]]: i1)
+func.func @preserveDivergentState(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %buffer0: !hal.buffer, %buffer1: !hal.buffer, %cond: i1) {
+  %c0 = arith.constant 0 : index
+  %size = arith.constant 100 : index
+  // CHECK: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer0 : !hal.buffer)[%c0, %size]
+  ])
+  cf.cond_br %cond, ^bb1, ^bb2
+^bb1:
+  // CHECK: hal.command_buffer.push_descriptor_set{{.+}}
+  // CHECK-NEXT: %c0 = (%[[BUFFER1]] : !hal.buffer)
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer1 : !hal.buffer)[%c0, %size]
+  ])
+  cf.br ^bb2
+// CHECK: ^bb2:
+^bb2:
+  // CHECK-NEXT: hal.command_buffer.push_descriptor_set{{.+}}
+  // CHECK-NEXT: %c0 = (%[[BUFFER0]] : !hal.buffer)
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer0 : !hal.buffer)[%c0, %size]
+  ])
+  cf.cond_br %cond, ^bb2, ^bb3
+^bb3:
+  return
+}
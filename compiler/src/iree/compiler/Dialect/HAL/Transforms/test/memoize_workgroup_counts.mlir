@@ -0,0 +1,70 @@
+// RUN: iree-opt --split-input-file --iree-hal-memoize-workgroup-counts %s | FileCheck %s
+
+//      CHECK: util.global private mutable @[[VALID:_workgroup_count_valid]] = false
+// CHECK-NEXT: util.global private mutable @[[KEY:_workgroup_count_key]] : index
+// CHECK-NEXT: util.global private mutable @[[VALUE_X:_workgroup_count_value[_0-9]*]] : index
+// CHECK-NEXT: util.global private mutable @[[VALUE_Y:_workgroup_count_value[_0-9]*]] : index
+// CHECK-NEXT: util.global private mutable @[[VALUE_Z:_workgroup_count_value[_0-9]*]] : index
+
+// CHECK-LABEL: func.func @memoizeDynamicCount
+//  CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[EXE:.+]]: !hal.executable, %[[N:.+]]: index)
+func.func @memoizeDynamicCount(%cmd: !hal.command_buffer, %exe: !hal.executable, %n: index) {
+  %c1 = arith.constant 1 : index
+  %c3 = arith.constant 3 : index
+  %c7 = arith.constant 7 : index
+  %c8 = arith.constant 8 : index
+  %c15 = arith.constant 15 : index
+  %c16 = arith.constant 16 : index
+  %c64 = arith.constant 64 : index
+  %0 = arith.addi %n, %c15 : index
+  %1 = arith.divui %0, %c16 : index
+  %2 = arith.maxui %1, %c1 : index
+  %3 = arith.muli %n, %c3 : index
+  %4 = arith.addi %3, %c7 : index
+  %5 = arith.divui %4, %c8 : index
+  %6 = arith.minui %5, %c64 : index
+
+  // CHECK: %[[CACHED_VALID:.+]] = util.global.load @[[VALID]] : i1
+  // CHECK: %[[CACHED_KEY:.+]] = util.global.load @[[KEY]] : index
+  // CHECK: %[[KEY_EQ:.+]] = arith.cmpi eq, %[[N]], %[[CACHED_KEY]] : index
+  // CHECK: %[[HIT:.+]] = arith.andi %[[CACHED_VALID]], %[[KEY_EQ]] : i1
+  // CHECK: %[[COUNT:.+]]:3 = scf.if %[[HIT]] -> (index, index, index) {
+  // CHECK-DAG:   %[[CACHED_X:.+]] = util.global.load @[[VALUE_X]] : index
+  // CHECK-DAG:   %[[CACHED_Y:.+]] = util.global.load @[[VALUE_Y]] : index
+  // CHECK-DAG:   %[[CACHED_Z:.+]] = util.global.load @[[VALUE_Z]] : index
+  //     CHECK:   scf.yield %[[CACHED_X]], %[[CACHED_Y]], %[[CACHED_Z]]
+  //     CHECK: } else {
+  //     CHECK:   %[[NEW_X:.+]] = arith.maxui
+  //     CHECK:   %[[NEW_Y:.+]] = arith.minui
+  //     CHECK:   util.global.store %[[NEW_X]], @[[VALUE_X]] : index
+  //     CHECK:   util.global.store %[[NEW_Y]], @[[VALUE_Y]] : index
+  //     CHECK:   util.global.store %[[NEW_Z:.+]], @[[VALUE_Z]] : index
+  //     CHECK:   util.global.store %[[N]], @[[KEY]] : index
+  //     CHECK:   %[[TRUE:.+]] = arith.constant true
+  //     CHECK:   util.global.store %[[TRUE]], @[[VALID]] : i1
+  //     CHECK:   scf.yield %[[NEW_X]], %[[NEW_Y]], %[[NEW_Z]]
+  //     CHECK: }
+  //     CHECK: hal.command_buffer.dispatch<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   workgroups([%[[COUNT]]#0, %[[COUNT]]#1, %[[COUNT]]#2])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%exe : !hal.executable)[0] workgroups([%2, %6, %c1])
+  return
+}
+
+// -----
+
+// Calculations cheaper than the lookup are left as-is.
+
+// CHECK-NOT: util.global
+// CHECK-LABEL: func.func @skipCheapCount
+//  CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[EXE:.+]]: !hal.executable, %[[N:.+]]: index)
+func.func @skipCheapCount(%cmd: !hal.command_buffer, %exe: !hal.executable, %n: index) {
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  // CHECK: %[[X:.+]] = arith.divui %[[N]]
+  %0 = arith.divui %n, %c16 : index
+  // CHECK-NOT: scf.if
+  // CHECK: hal.command_buffer.dispatch<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME: workgroups([%[[X]], %c1, %c1])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%exe : !hal.executable)[0] workgroups([%0, %c1, %c1])
+  return
+}
@@ -381,6 +381,21 @@ vm.import private @device.queue.flush(
   %queue_affinity : i64
 )
 
+//===----------------------------------------------------------------------===//
+// Device list
+//===----------------------------------------------------------------------===//
+
+// Returns the number of devices available to the context.
+vm.import private @devices.count() -> i32
+attributes {nosideeffects}
+
+// Returns the device at |index| in the devices available to the context.
+// Index 0 is the default device returned by @ex.shared_device.
+vm.import private @devices.get(
+  %index : i32
+) -> !vm.ref<!hal.device>
+attributes {nosideeffects}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_t
 //===----------------------------------------------------------------------===//
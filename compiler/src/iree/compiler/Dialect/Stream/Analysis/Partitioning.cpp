@@ -167,15 +167,23 @@ void PartitionSet::topologicalSort() {
 }
 
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block) {
-  // Only one algorithm today.
+                                    Block *block,
+                                    const PartitioningOptions &options) {
+  // No cost model is used when forming execution regions today; concurrency
+  // and memory pressure are balanced when forming waves within them.
   return partitionStreamableOpsReference(config, block);
 }
 
 PartitionSet partitionRegionConcurrency(
-    IREE::Stream::PartitioningConfigAttr config, Block *block) {
-  // Only one algorithm today.
-  return partitionRegionConcurrencyReference(config, block);
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    const PartitioningOptions &options) {
+  switch (options.algorithm) {
+    case PartitioningAlgorithm::CostModel:
+      return partitionRegionConcurrencyCostModel(config, block, options);
+    case PartitioningAlgorithm::Reference:
+    default:
+      return partitionRegionConcurrencyReference(config, block);
+  }
 }
 
 }  // namespace Stream
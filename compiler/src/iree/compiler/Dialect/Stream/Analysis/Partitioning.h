@@ -62,6 +62,26 @@ struct PartitionSet {
   void topologicalSort();
 };
 
+// Selects the algorithm used by the partitioning entry points.
+enum class PartitioningAlgorithm {
+  // Hazard-only greedy clustering (partition*Reference).
+  Reference = 0,
+  // Balances concurrency against the estimated memory of concurrently produced
+  // resources (partition*CostModel).
+  CostModel = 1,
+};
+
+// Options controlling partitioning that are not carried on the IR.
+struct PartitioningOptions {
+  // Algorithm used to partition.
+  PartitioningAlgorithm algorithm = PartitioningAlgorithm::Reference;
+  // Maximum estimated number of bytes of new resources produced by the ops of
+  // a single concurrency wave when using the cost model. Ops whose results
+  // would exceed the budget are placed into earlier waves instead. 0 disables
+  // the limit.
+  int64_t maxConcurrentMemory = 0;
+};
+
 //===----------------------------------------------------------------------===//
 // Stream partitioning algorithms
 //===----------------------------------------------------------------------===//
@@ -107,9 +127,11 @@ struct PartitionSet {
 // non-streamable ops if it is safe to do so (such as std arithmetic). Not all
 // ops in the block will be covered by a partition.
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block);
+                                    Block *block,
+                                    const PartitioningOptions &options = {});
 PartitionSet partitionRegionConcurrency(
-    IREE::Stream::PartitioningConfigAttr config, Block *block);
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    const PartitioningOptions &options = {});
 
 //===----------------------------------------------------------------------===//
 // Reference partitioning
@@ -125,6 +147,20 @@ PartitionSet partitionStreamableOpsReference(
 PartitionSet partitionRegionConcurrencyReference(
     IREE::Stream::PartitioningConfigAttr config, Block *block);
 
+//===----------------------------------------------------------------------===//
+// Cost model partitioning
+//===----------------------------------------------------------------------===//
+
+// Forms waves of concurrently executable work like
+// partitionRegionConcurrencyReference but bounds the estimated number of bytes
+// of new resources produced by each wave to |options.maxConcurrentMemory|.
+// Ops that would exceed the budget of every candidate wave are placed into a
+// new wave that executes before them, trading concurrency for peak memory.
+// Resources with dynamic sizes are not counted.
+PartitionSet partitionRegionConcurrencyCostModel(
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    const PartitioningOptions &options);
+
 }  // namespace Stream
 }  // namespace IREE
 }  // namespace iree_compiler
@@ -0,0 +1,241 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
+#include "iree/compiler/Dialect/Stream/Analysis/ResourceHazards.h"
+#include "iree/compiler/Dialect/Util/IR/UtilInterfaces.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Matchers.h"
+
+#define DEBUG_TYPE "iree-stream-partitioning"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+
+// Returns an AsmState at the ancestor to |block| that is isolated from above.
+// Returns nullptr if debug dumps of partitioning is disabled.
+static std::unique_ptr<AsmState> getRootAsmState(Block *block) {
+  LLVM_DEBUG({
+    auto *rootOp = block->getParentOp();
+    while (auto parentOp = rootOp->getParentOp()) {
+      if (!isa<IREE::Stream::TimelineOpInterface>(parentOp) &&
+          parentOp->hasTrait<OpTrait::IsIsolatedFromAbove>()) {
+        rootOp = parentOp;
+        break;
+      }
+      rootOp = parentOp;
+    }
+    return std::make_unique<AsmState>(rootOp);
+  });
+  return nullptr;
+}
+
+// Returns the estimated number of bytes of new resources produced by |op|.
+// Results tied to operands are updated in-place and not counted. Results with
+// dynamic sizes are not counted as their size is unknown at compile time.
+static int64_t estimateProducedBytes(Operation *op) {
+  auto sizeAwareOp = dyn_cast<IREE::Util::SizeAwareOpInterface>(op);
+  if (!sizeAwareOp) return 0;
+  auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(op);
+  int64_t totalBytes = 0;
+  for (auto result : op->getResults()) {
+    if (!result.getType().isa<IREE::Stream::ResourceType>()) continue;
+    if (tiedOp && tiedOp.getTiedResultOperand(result)) continue;
+    APInt resultSize;
+    if (matchPattern(sizeAwareOp.getResultSize(result.getResultNumber()),
+                     m_ConstantInt(&resultSize))) {
+      totalBytes += resultSize.getSExtValue();
+    }
+  }
+  return totalBytes;
+}
+
+PartitionSet partitionRegionConcurrencyCostModel(
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    const PartitioningOptions &options) {
+  PartitionSet waveSet;
+
+  auto favor = config.getFavor().getValue();
+  if (favor == IREE::Stream::Favor::Debug) {
+    // Disable partitioning when favoring debuggability.
+    return waveSet;
+  }
+
+  struct PartitionBuilder {
+    unsigned ordinal;
+    // Ops present in the wave; ops may be present in multiple waves.
+    SetVector<Operation *> ops;
+    // Estimated bytes of new resources produced by the ops in the wave.
+    int64_t producedBytes = 0;
+  };
+  SmallVector<std::unique_ptr<PartitionBuilder>> builders;
+
+  struct OpInfo {
+    // Which waves the op is contained within.
+    llvm::BitVector membership;
+    // Which waves transitively depend on this operation.
+    llvm::BitVector hazards;
+  };
+  DenseMap<Operation *, OpInfo> opInfos;
+
+  auto asmState = getRootAsmState(block);
+
+  // Run analysis - if it fails then we'll just be conservative.
+  IREE::Stream::ResourceHazardAnalysis hazardAnalysis(block->getParentOp());
+  if (failed(hazardAnalysis.run())) {
+    LLVM_DEBUG(llvm::dbgs() << "WARNING: resource hazard analysis failed; "
+                               "conservatively scheduling\n");
+  }
+
+  // Returns true if |opBytes| can be added to |builder| within the budget.
+  // Ops larger than the budget end up in their own wave.
+  auto fitsBudget = [&](const PartitionBuilder &builder, int64_t opBytes) {
+    if (options.maxConcurrentMemory <= 0) return true;
+    return builder.producedBytes + opBytes <= options.maxConcurrentMemory;
+  };
+
+  for (auto &op : llvm::reverse(*block)) {
+    // Skip constants; they just add noise (and since they are heavily CSE'd
+    // they have lots of users to test).
+    if (op.hasTrait<OpTrait::ConstantLike>()) {
+      LLVM_DEBUG(llvm::dbgs() << "(ignoring constant)\n");
+      continue;
+    }
+
+    // NOTE: it's ok if this op is not streamable as we still need to track the
+    // hazards for other ops that it may use/may use it.
+    auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op);
+
+    // Initialize op info for this op - whether streamable or not. See
+    // partitionRegionConcurrencyReference for how hazards are tracked.
+    auto &opInfo = opInfos[&op];
+    opInfo.hazards.reserve(builders.size() + 1);
+    opInfo.hazards.resize(builders.size(), /*t=*/false);
+
+    LLVM_DEBUG({
+      llvm::dbgs() << "====\nPartitioning op:\n";
+      op.print(llvm::dbgs(), *asmState);
+      llvm::dbgs() << "\n";
+    });
+
+    for (auto user : op.getUsers()) {
+      auto userInfoIt = opInfos.find(user);
+      if (userInfoIt == opInfos.end()) continue;
+      auto &userInfo = userInfoIt->second;
+      if (hazardAnalysis.hasHazard(streamableOp, user)) {
+        // Hazard with existing op usage - prevent concurrent scheduling.
+        opInfo.hazards |= userInfo.membership;
+      }
+      // Always inherit hazards whether merging or not.
+      opInfo.hazards |= userInfo.hazards;
+    }
+    llvm::BitVector candidates(builders.size(), /*t=*/true);
+    candidates ^= opInfo.hazards;
+
+    // If this op is not streamable then bail here; we've still setup the hazard
+    // map for following iteration.
+    if (!streamableOp || streamableOp.isMetadata()) {
+      LLVM_DEBUG(llvm::dbgs() << "Not streamable/is subview (skip)\n");
+      continue;
+    }
+
+    opInfo.membership.reserve(builders.size() + 1);
+    opInfo.membership.resize(builders.size(), /*t=*/false);
+
+    // Pick the first candidate wave in favor order that has room left in its
+    // memory budget. MaxConcurrency prefers the waves executing last to keep
+    // ops as concurrent as possible while MinPeakMemory prefers the waves
+    // executing first to keep live ranges short.
+    int64_t opBytes = estimateProducedBytes(&op);
+    int candidateOrdinal = -1;
+    if (favor == IREE::Stream::Favor::MaxConcurrency) {
+      for (auto ordinal : candidates.set_bits()) {
+        if (fitsBudget(*builders[ordinal], opBytes)) {
+          candidateOrdinal = ordinal;
+          break;
+        }
+      }
+    } else {
+      for (int ordinal = candidates.find_last(); ordinal != -1;
+           ordinal = candidates.find_prev(ordinal)) {
+        if (fitsBudget(*builders[ordinal], opBytes)) {
+          candidateOrdinal = ordinal;
+          break;
+        }
+      }
+    }
+    if (candidateOrdinal != -1) {
+      LLVM_DEBUG(llvm::dbgs() << "Moving to candidate wave " << candidateOrdinal
+                              << " with " << opBytes << " bytes (continue)\n");
+      builders[candidateOrdinal]->ops.insert(&op);
+      builders[candidateOrdinal]->producedBytes += opBytes;
+      opInfo.membership.set(candidateOrdinal);
+      opInfo.hazards.set(0, candidateOrdinal);
+      opInfo.hazards.reset(candidateOrdinal);
+      continue;
+    }
+    if (candidates.any()) {
+      LLVM_DEBUG(llvm::dbgs() << "All candidate waves over budget with "
+                              << opBytes << " bytes\n");
+    }
+
+    // Mark the op as having hazards against all other waves.
+    opInfo.hazards.set(0, builders.size());
+
+    // Create a new wave just for this op.
+    opInfo.membership.resize(opInfo.membership.size() + 1, /*t=*/true);
+    auto builder = std::make_unique<PartitionBuilder>();
+    builder->ordinal = builders.size();
+    builder->ops.insert(&op);
+    builder->producedBytes = opBytes;
+    LLVM_DEBUG(llvm::dbgs() << "Created wave " << builder->ordinal << "\n");
+    builders.push_back(std::move(builder));
+  }
+
+  // Emit waves in forward order (as they are topologically sorted in
+  // reverse order from our bottom-up walk).
+  for (auto &builder : llvm::reverse(builders)) {
+    Partition wave;
+
+    SetVector<Value> consumedValues;
+    SetVector<Value> producedValues;
+    SetVector<Value> escapingValues;
+    for (auto *op : llvm::reverse(builder->ops)) {
+      for (auto operand : op->getOperands()) {
+        consumedValues.insert(operand);
+      }
+      for (auto result : op->getResults()) {
+        producedValues.insert(result);
+        // TODO(benvanik): optimize this - creates n^2/nlogn behavior.
+        for (auto user : result.getUsers()) {
+          if (!builder->ops.contains(user)) {
+            escapingValues.insert(result);
+          }
+        }
+      }
+    }
+    consumedValues.set_subtract(producedValues);
+    wave.ins = consumedValues;
+    wave.outs = escapingValues;
+
+    wave.ops = std::move(builder->ops);
+    waveSet.partitions.push_back(std::move(wave));
+  }
+
+  LLVM_DEBUG(waveSet.dump(*asmState));
+
+  return waveSet;
+}
+
+}  // namespace Stream
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
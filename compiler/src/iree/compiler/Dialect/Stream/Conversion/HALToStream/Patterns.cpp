@@ -133,6 +133,37 @@ struct ConvertTensorImportOp
   }
 };
 
+// Returns the resource imported from the buffer view backing |storage| if that
+// buffer view was also imported as a tensor prior to |exportOp|. This happens
+// when an argument is donated (`iree.abi.donate`) to provide the storage for a
+// result. Updating the already imported resource instead of importing the
+// storage again keeps the aliasing visible so that all reads of the input are
+// ordered before the result is written.
+static Value findImportedStorage(Value storage, Operation *exportOp) {
+  auto bufferOp = storage.getDefiningOp<IREE::HAL::BufferViewBufferOp>();
+  if (!bufferOp) return {};
+  for (auto *user : bufferOp.getBufferView().getUsers()) {
+    auto importOp = dyn_cast<IREE::Stream::TensorImportOp>(user);
+    if (!importOp || importOp->getBlock() != exportOp->getBlock() ||
+        !importOp->isBeforeInBlock(exportOp)) {
+      continue;
+    }
+    // If the import waits on a fence we need to use the awaited value so
+    // that the update is ordered after the fence is reached.
+    Value importedResource = importOp.getResult();
+    for (auto *importUser : importedResource.getUsers()) {
+      auto awaitOp = dyn_cast<IREE::Stream::TimepointAwaitOp>(importUser);
+      if (!awaitOp) continue;
+      for (auto [i, operand] :
+           llvm::enumerate(awaitOp.getResourceOperands())) {
+        if (operand == importedResource) return awaitOp.getResults()[i];
+      }
+    }
+    return importedResource;
+  }
+  return {};
+}
+
 // %1 = hal.tensor.export %0 : tensor<4xf32> -> !hal.buffer_view
 // ->
 // %1 = stream.tensor.export %0 : tensor<4xf32> in !stream.resource<*> ->
@@ -156,7 +187,24 @@ struct ConvertTensorExportOp
         IREE::Stream::Lifetime::External);
     auto exportSource = adaptor.getSource();
     auto exportSize = source.resourceSize;
+    Value importedStorage;
     if (adaptor.getTargetStorage()) {
+      importedStorage = findImportedStorage(adaptor.getTargetStorage(), op);
+    }
+    if (importedStorage) {
+      // Update the resource imported from the donated argument in-place.
+      // Donated arguments must have the same type as the result they provide
+      // storage for and the import size is used for the export.
+      auto importedSize = IREE::Util::SizeAwareTypeInterface::queryValueSize(
+          op.getLoc(), importedStorage, rewriter);
+      auto zeroOffset = rewriter.create<arith::ConstantIndexOp>(op.getLoc(), 0);
+      auto updateOp = rewriter.create<IREE::Stream::AsyncUpdateOp>(
+          op.getLoc(), externalType, importedStorage, importedSize, zeroOffset,
+          source.resourceSize, source.resource, source.resourceSize,
+          /*affinity=*/nullptr);
+      exportSource = updateOp.getResult();
+      exportSize = updateOp.getTargetSize();
+    } else if (adaptor.getTargetStorage()) {
       // Query the target storage buffer length; we will only populate up to
       // what is required for the output.
       auto storageSize =
@@ -84,3 +84,28 @@ func.func @exportBufferViewInPlace(%tensor: tensor<?x?x4xf32>, %dim0: index, %di
   // CHECK: return %[[STORAGE_RESULT]]
   return %0 : !hal.buffer_view
 }
+
+// -----
+
+// Tests that exporting into the storage of a donated argument that was also
+// imported updates the imported resource instead of importing it again.
+
+// CHECK-LABEL: @exportBufferViewIntoDonated
+// CHECK-SAME: (%[[VIEW:.+]]: !hal.buffer_view)
+func.func @exportBufferViewIntoDonated(%view: !hal.buffer_view) -> !hal.buffer_view {
+  //  CHECK-DAG: %[[SIZE:.+]] = stream.tensor.sizeof tensor<4xf32> : index
+  //      CHECK: %[[IMPORT:.+]] = stream.tensor.import %[[VIEW]] : !hal.buffer_view ->
+  // CHECK-SAME:     tensor<4xf32> in !stream.resource<external>{%[[SIZE]]}
+  // CHECK-NEXT: %[[TENSOR:.+]] = stream.async.transfer %[[IMPORT]]
+  %tensor = hal.tensor.import %view : !hal.buffer_view -> tensor<4xf32>
+  %storage = hal.buffer_view.buffer<%view : !hal.buffer_view> : !hal.buffer
+  //  CHECK-NOT: stream.tensor.import
+  //      CHECK: %[[UPDATE:.+]] = stream.async.update %[[TENSOR]], %[[IMPORT]][%c0 to %[[SIZE]]]
+  // CHECK-SAME:   : !stream.resource<*>{%[[SIZE]]} -> %[[IMPORT]] as !stream.resource<external>{%[[SIZE]]}
+  // CHECK-NEXT: %[[RESULT:.+]] = stream.tensor.export %[[UPDATE]] :
+  // CHECK-SAME:     tensor<4xf32> in !stream.resource<external>{%[[SIZE]]}
+  // CHECK-SAME:     -> !hal.buffer_view
+  %0 = hal.tensor.export %tensor into %storage : tensor<4xf32> -> !hal.buffer_view
+  // CHECK: return %[[RESULT]]
+  return %0 : !hal.buffer_view
+}
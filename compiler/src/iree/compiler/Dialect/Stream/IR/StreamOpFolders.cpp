@@ -1481,10 +1481,12 @@ void AsyncFillOp::getCanonicalizationPatterns(RewritePatternSet &results,
 //===----------------------------------------------------------------------===//
 
 OpFoldResult AsyncUpdateOp::fold(FoldAdaptor operands) {
-  if (getUpdateSize() == getTargetSize()) {
+  if (getUpdateSize() == getTargetSize() &&
+      getUpdate().getType() == getResult().getType()) {
     // If updating the entire target then just replace with the update.
     // Note that this breaks copy-on-write semantics but will be fixed up during
-    // canonicalization if needed.
+    // canonicalization if needed. Updates that change lifetime (such as
+    // writing into imported storage) must be preserved.
     return getUpdate();
   }
   return {};
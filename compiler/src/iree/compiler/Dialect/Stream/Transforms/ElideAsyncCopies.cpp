@@ -19,11 +19,13 @@
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Analysis/Liveness.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -87,6 +89,10 @@ class LastUsers
                         .nest(parentOp)
                         .getAnalysis<Liveness>();
     for (auto user : value.getUsers()) {
+      // Liveness is only valid within a single region: users nested in other
+      // regions (such as loop bodies) may execute multiple times or be
+      // followed by uses of the value after the op containing them.
+      if (user->getParentRegion() != value.getParentRegion()) continue;
       if (liveness.isDeadAfter(value, user)) {
         unionAssumed(user);
       }
@@ -243,10 +249,29 @@ class ArgumentSemantics
 
     auto arg = value.cast<BlockArgument>();
     bool isEntryArg = arg.getParentBlock()->isEntryBlock();
-    if (isEntryArg) {
+    auto *parentOp = arg.getParentBlock()->getParentOp();
+    if (isEntryArg && isa<scf::ForOp>(parentOp)) {
+      // Loop-carried argument; sourced from the loop initial value on entry and
+      // the yielded value from the prior iteration on the back-edge.
+      auto forOp = cast<scf::ForOp>(parentOp);
+      if (arg.getArgNumber() < forOp.getNumInductionVars()) {
+        removeAssumedBits(NOT_BY_REFERENCE | NOT_MUTATED);
+      } else {
+        updateFromPredecessorUse(forOp.getOpOperandForRegionIterArg(arg),
+                                 solver);
+        updateFromPredecessorUse(
+            forOp.getBody()->getTerminator()->getOpOperand(
+                arg.getArgNumber() - forOp.getNumInductionVars()),
+            solver);
+      }
+    } else if (isEntryArg && !isa<mlir::CallableOpInterface>(parentOp)) {
+      // Entry argument of some other region op we don't model.
+      LLVM_DEBUG(llvm::dbgs()
+                 << "  !! unknown region argument; assuming by reference\n");
+      removeAssumedBits(NOT_BY_REFERENCE | NOT_MUTATED);
+    } else if (isEntryArg) {
       // Call argument.
-      auto callableOp =
-          cast<mlir::CallableOpInterface>(arg.getParentBlock()->getParentOp());
+      auto callableOp = cast<mlir::CallableOpInterface>(parentOp);
       traversalResult |= solver.getExplorer().walkIncomingCalls(
           callableOp, [&](mlir::CallOpInterface callOp) -> WalkResult {
             unsigned baseIdx = callOp.getArgOperands().getBeginOperandIndex();
@@ -292,6 +317,8 @@ class LastUseAnalysis {
         solver(explorer, allocator) {
     explorer.setOpAction<IREE::Util::InitializerOp>(TraversalAction::RECURSE);
     explorer.setOpAction<mlir::func::FuncOp>(TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::ForOp>(TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::IfOp>(TraversalAction::RECURSE);
     explorer.setDialectAction<IREE::Stream::StreamDialect>(
         TraversalAction::RECURSE);
     // Ignore the contents of executables (linalg goo, etc).
@@ -306,18 +333,19 @@ class LastUseAnalysis {
   // Runs analysis and populates the state cache.
   // May fail if analysis cannot be completed due to unsupported or unknown IR.
   LogicalResult run() {
-    // Seed all block arguments throughout the program.
+    // Seed all block arguments throughout the program, including those of
+    // nested regions such as loop bodies.
     for (auto callableOp : getTopLevelOps()) {
       auto *region = callableOp.getCallableRegion();
       if (!region) continue;
-      for (auto &block : *region) {
-        for (auto arg : block.getArguments()) {
+      region->walk([&](Block *block) {
+        for (auto arg : block->getArguments()) {
           if (arg.getType().isa<IREE::Stream::ResourceType>()) {
             solver.getOrCreateElementFor<ArgumentSemantics>(
                 Position::forValue(arg));
           }
         }
-      }
+      });
     }
 
     // Run solver to completion.
@@ -392,6 +420,16 @@ static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
     return false;
   }
 
+  // Liveness is only tracked within a region so if the source comes from an
+  // ancestor region (such as a value captured by a loop body) we can't tell if
+  // it is used again by a later iteration or after the region op.
+  if (cloneOp.getSource().getParentRegion() != cloneOp->getParentRegion()) {
+    LLVM_DEBUG(llvm::dbgs()
+               << "  - clone source is from an ancestor region; cannot "
+                  "elide\n");
+    return false;
+  }
+
   // If the source is a block argument we have to look into the analysis cache
   // to see if it's been classified as a last use/by-value move. If it isn't
   // then we cannot mutate it in-place as it could be used by the caller/another
@@ -427,30 +465,34 @@ static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
 }
 
 // Tries to elide |cloneOp| by replacing all uses with its source if safe.
-// Returns true if the op was elided.
+// Returns true if the op was elided and adds the statically-known size of the
+// copy to |elidedByteCount|.
 static bool tryElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
-                            LastUseAnalysis &analysis) {
+                            LastUseAnalysis &analysis,
+                            int64_t &elidedByteCount) {
   if (!isSafeToElideCloneOp(cloneOp, analysis)) return false;
+  APInt sourceSize;
+  if (matchPattern(cloneOp.getSourceSize(), m_ConstantInt(&sourceSize))) {
+    elidedByteCount += sourceSize.getSExtValue();
+  }
   cloneOp.replaceAllUsesWith(cloneOp.getSource());
   cloneOp.erase();
   return true;
 }
 
-// Tries to elide copies nested within |region| when safe.
-// Returns true if any ops were elided.
-static bool tryElideAsyncCopiesInRegion(Region &region,
-                                        LastUseAnalysis &analysis) {
-  bool didChange = false;
-  for (auto &block : region) {
-    for (auto cloneOp : llvm::make_early_inc_range(
-             block.getOps<IREE::Stream::AsyncCloneOp>())) {
-      if (!isSafeToElideCloneOp(cloneOp, analysis)) continue;
-      cloneOp.replaceAllUsesWith(cloneOp.getSource());
-      cloneOp.erase();
-      didChange = true;
-    }
+// Tries to elide copies nested within |region| (including within nested
+// regions such as loop bodies) when safe. Returns the number of ops elided.
+static unsigned tryElideAsyncCopiesInRegion(Region &region,
+                                            LastUseAnalysis &analysis,
+                                            int64_t &elidedByteCount) {
+  SmallVector<IREE::Stream::AsyncCloneOp> cloneOps;
+  region.walk(
+      [&](IREE::Stream::AsyncCloneOp cloneOp) { cloneOps.push_back(cloneOp); });
+  unsigned elidedCount = 0;
+  for (auto cloneOp : cloneOps) {
+    if (tryElideCloneOp(cloneOp, analysis, elidedByteCount)) ++elidedCount;
   }
-  return didChange;
+  return elidedCount;
 }
 
 //===----------------------------------------------------------------------===//
@@ -500,13 +542,17 @@ class ElideAsyncCopiesPass : public ElideAsyncCopiesBase<ElideAsyncCopiesPass> {
 
       // Apply analysis by eliding all copies that are safe to elide.
       // If we can't elide any we'll consider the iteration complete and exit.
-      bool didChange = false;
+      unsigned elidedCount = 0;
+      int64_t elidedByteCount = 0;
       for (auto callableOp : analysis.getTopLevelOps()) {
         auto *region = callableOp.getCallableRegion();
         if (!region) continue;
-        didChange = tryElideAsyncCopiesInRegion(*region, analysis) || didChange;
+        elidedCount +=
+            tryElideAsyncCopiesInRegion(*region, analysis, elidedByteCount);
       }
-      if (!didChange) break;
+      elidedCopies += elidedCount;
+      elidedCopyBytes += elidedByteCount;
+      if (!elidedCount) break;
     }
     if (iterationCount == maxIterationCount) {
       // If you find yourself hitting this we can evaluate increasing the
@@ -520,6 +566,13 @@ class ElideAsyncCopiesPass : public ElideAsyncCopiesBase<ElideAsyncCopiesPass> {
       return;
     }
   }
+
+ private:
+  Statistic elidedCopies{this, "elided copies",
+                         "Number of stream.async.clone ops elided"};
+  Statistic elidedCopyBytes{
+      this, "elided copy bytes",
+      "Total statically-known bytes of stream.async.clone ops elided"};
 };
 
 }  // namespace
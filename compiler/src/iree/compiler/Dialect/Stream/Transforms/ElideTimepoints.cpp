@@ -408,29 +408,38 @@ class TimepointCoverage
 
     // Intersect coverage of all callee/child region return operands.
     // The intersection prevents multiple return sites from interfering.
+    // Region ops that may skip their regions entirely (zero-trip scf.for) also
+    // intersect the operands that bypass the regions.
     auto gatherRegionReturns = [&](Operation *regionOp, unsigned resultIndex) {
       StateType uniformState;
       bool firstEdge = true;
-      if (solver.getExplorer().walkReturnOperands(
-              regionOp, [&](OperandRange operands) {
-                auto operand = operands[resultIndex];
-                auto operandCoverage = solver.getElementFor<TimepointCoverage>(
-                    *this, Position::forValue(operand),
-                    DFX::Resolution::REQUIRED);
-                LLVM_DEBUG({
-                  llvm::dbgs()
-                      << "[ElideTimepoints] intersect incoming return operand ";
-                  operandCoverage.print(llvm::dbgs(), solver.getAsmState());
-                  llvm::dbgs() << "\n";
-                });
-                if (firstEdge) {
-                  uniformState = operandCoverage.getState();
-                  firstEdge = false;
-                } else {
-                  uniformState.intersectAssumed(operandCoverage.getState());
-                }
-                return WalkResult::advance();
-              }) == TraversalResult::INCOMPLETE) {
+      auto intersectOperand = [&](Value operand) {
+        auto operandCoverage = solver.getElementFor<TimepointCoverage>(
+            *this, Position::forValue(operand), DFX::Resolution::REQUIRED);
+        LLVM_DEBUG({
+          llvm::dbgs()
+              << "[ElideTimepoints] intersect incoming return operand ";
+          operandCoverage.print(llvm::dbgs(), solver.getAsmState());
+          llvm::dbgs() << "\n";
+        });
+        if (firstEdge) {
+          uniformState = operandCoverage.getState();
+          firstEdge = false;
+        } else {
+          uniformState.intersectAssumed(operandCoverage.getState());
+        }
+        return WalkResult::advance();
+      };
+      auto traversalResult = TraversalResult::COMPLETE;
+      if (auto regionBranchOp = dyn_cast<RegionBranchOpInterface>(regionOp)) {
+        traversalResult |= solver.getExplorer().walkRegionBypassOperands(
+            regionBranchOp, resultIndex, intersectOperand);
+      }
+      traversalResult |= solver.getExplorer().walkReturnOperands(
+          regionOp, [&](OperandRange operands) {
+            return intersectOperand(operands[resultIndex]);
+          });
+      if (traversalResult == TraversalResult::INCOMPLETE) {
         LLVM_DEBUG(llvm::dbgs() << "[ElideTimepoints] incomplete region "
                                    "traversal; assuming unknown\n");
         uniformState.unionAssumedWithUndef();
@@ -518,6 +527,7 @@ class TimepointCoverageAnalysis {
     explorer.setOpAction<IREE::Util::InitializerOp>(TraversalAction::RECURSE);
     explorer.setOpAction<mlir::func::FuncOp>(TraversalAction::RECURSE);
     explorer.setOpAction<mlir::scf::IfOp>(TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::ForOp>(TraversalAction::RECURSE);
     explorer.setDialectAction<IREE::Stream::StreamDialect>(
         TraversalAction::RECURSE);
     // Ignore the contents of executables (linalg goo, etc) and execution
@@ -842,15 +852,14 @@ static bool tryElideTimepointsInRegion(Region &region,
   // Walk all blocks and elide timepoints.
   // We walk pre-order to make the debug output easier to read.
   region.walk<WalkOrder::PreOrder>([&](Operation *op) {
-    // TODO(benvanik): handle more ops from scf or other dialects.
     TypeSwitch<Operation *>(op)
         .Case([&](IREE::Stream::TimelineOpInterface op) {
           // Most of the interesting stream.* stuff happens here.
           processTimelineOp(op);
         })
-        .Case<scf::IfOp, scf::ForOp, IREE::Util::GlobalLoadOp>(
+        .Case<scf::IfOp, IREE::Util::GlobalLoadOp>(
             [&](Operation *op) { elideTimepointResults(op); })
-        .Case<CallOpInterface, arith::SelectOp>([&](Operation *op) {
+        .Case<CallOpInterface, scf::ForOp, arith::SelectOp>([&](Operation *op) {
           elideTimepointOperands(op);
           elideTimepointResults(op);
         })
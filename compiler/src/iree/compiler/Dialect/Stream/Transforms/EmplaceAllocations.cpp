@@ -35,6 +35,39 @@ namespace {
 // Emplacement
 //===----------------------------------------------------------------------===//
 
+// Returns true if the contents of |targetResource| may be read by
+// |dispatchOp| or any op following it other than |updateOp|. Placing the
+// dispatch results into the target would then clobber the contents before
+// those reads. This is the case for storage donated by an argument
+// (`iree.abi.donate`) that is used both as an input and as the update target
+// of a result. We look through transfers as they may alias their source once
+// lifetimes are refined.
+static bool isTargetReadDuringOrAfter(Value targetResource,
+                                      IREE::Stream::AsyncDispatchOp dispatchOp,
+                                      Operation *updateOp) {
+  SmallVector<Value> worklist = {targetResource};
+  while (!worklist.empty()) {
+    auto value = worklist.pop_back_val();
+    for (auto &use : value.getUses()) {
+      auto *userOp = use.getOwner();
+      if (userOp == updateOp) continue;
+      if (userOp == dispatchOp.getOperation()) {
+        // Operands tied to results are written and not read (beyond what the
+        // dispatch already requires).
+        if (dispatchOp.isOperandTied(use.getOperandNumber())) continue;
+        return true;
+      }
+      if (auto transferOp = dyn_cast<IREE::Stream::AsyncTransferOp>(userOp)) {
+        worklist.push_back(transferOp.getResult());
+        continue;
+      }
+      if (userOp->getBlock() != dispatchOp->getBlock()) return true;
+      if (dispatchOp->isBeforeInBlock(userOp)) return true;
+    }
+  }
+  return false;
+}
+
 static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
   bool didChange = false;
   for (auto [resultIndex, result] : llvm::enumerate(dispatchOp.getResults())) {
@@ -68,6 +101,10 @@ static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
         // results - if so we need to find the operand to capture tied to that
         // new result instead of our own new result (which would make a cycle).
         targetResource = dispatchOp.getTiedResultOperand(targetResource);
+      } else if (isTargetReadDuringOrAfter(targetResource, dispatchOp,
+                                           updateOp)) {
+        // Target contents are still required; the update will copy.
+        continue;
       }
       targetResourceSize = updateOp.getTargetSize();
       targetOffset = updateOp.getTargetOffset();
@@ -92,7 +129,9 @@ static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
     resultSizes[resultIndex] = targetResultSize;
     dispatchOp.getResultSizesMutable().assign(resultSizes);
 
-    // Replace users with the result of the dispatch op.
+    // Replace users with the result of the dispatch op. The result now aliases
+    // the target and takes on its lifetime (such as external for imports).
+    result.setType(targetResult.getType());
     targetResult.replaceAllUsesWith(result);
     userOp->erase();
 
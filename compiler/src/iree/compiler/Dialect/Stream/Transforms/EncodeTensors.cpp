@@ -16,6 +16,7 @@
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/Support/CommandLine.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -33,10 +34,32 @@ namespace IREE {
 namespace Stream {
 namespace {
 
+static llvm::cl::opt<bool> clPackedSubByteStorage(
+    "iree-stream-experimental-packed-sub-byte-storage",
+    llvm::cl::desc("Stores i2 and i4 tensors densely packed with multiple "
+                   "elements per byte instead of extending each element to "
+                   "a byte. Requires backends that support packed sub-byte "
+                   "bindings."),
+    llvm::cl::init(false));
+
 //===----------------------------------------------------------------------===//
 // Encoding utilities
 //===----------------------------------------------------------------------===//
 
+// Returns true if elements of |type| are stored packed with multiple elements
+// per byte. Elements are packed little-endian such that element 0 occupies the
+// least significant bits of byte 0.
+//
+// i1 is excluded as it is predominantly used for predicates that are cheaper to
+// operate on when byte-aligned.
+static bool isPackedStorageElementType(Type type) {
+  if (!clPackedSubByteStorage) return false;
+  auto intType = type.dyn_cast<IntegerType>();
+  if (!intType) return false;
+  unsigned bitWidth = intType.getWidth();
+  return bitWidth == 2 || bitWidth == 4;
+}
+
 // Asserts that the given encoding is supported by this code right now.
 // Non-trivial dense tensor encodings need special handling.
 static LogicalResult checkEncoding(Operation *op, RankedTensorType encodingType,
@@ -55,7 +78,7 @@ static LogicalResult checkEncoding(Operation *op, RankedTensorType encodingType,
 //
 // Examples:
 //   i1  -> i8
-//   i4  -> i8
+//   i4  -> i8 (or i4 with packed storage)
 //   i11 -> i16
 //   i33 -> i64
 static Type alignElementType(Type originalType) {
@@ -63,6 +86,9 @@ static Type alignElementType(Type originalType) {
   auto elementType = originalType.dyn_cast<IntegerType>();
   if (!elementType) return originalType;
 
+  // Packed types are stored as-is.
+  if (isPackedStorageElementType(elementType)) return originalType;
+
   // Align the element type to a power of two byte size.
   auto alignedBitWidth =
       IREE::Util::getRoundedElementByteWidth(elementType) * 8;
@@ -141,18 +167,76 @@ static Value calculateElementOffset(Location loc, RankedTensorType tensorType,
   return offset;
 }
 
+// Returns the total size in bytes of a dense tensor.
+static Value calculateStorageSize(Location loc, RankedTensorType tensorType,
+                                  ValueRange dynamicDims,
+                                  PatternRewriter &rewriter) {
+  auto elementType = tensorType.getElementType();
+  if (!isPackedStorageElementType(elementType)) {
+    return calculateElementCount(
+        loc, tensorType, dynamicDims,
+        IREE::Util::getRoundedElementByteWidth(elementType), rewriter);
+  }
+
+  // Packed: the trailing byte may be partially used.
+  auto bitCount = calculateElementCount(loc, tensorType, dynamicDims,
+                                        elementType.getIntOrFloatBitWidth(),
+                                        rewriter);
+  return rewriter.createOrFold<arith::CeilDivUIOp>(
+      loc, bitCount, rewriter.create<arith::ConstantIndexOp>(loc, 8));
+}
+
 // Returns an element offset within a dense tensor based on indices, in bytes.
+// Offsets into packed tensors must land on a byte boundary.
 static Value calculateElementByteOffset(Location loc,
                                         RankedTensorType tensorType,
                                         ValueRange dynamicDims,
                                         ValueRange indices,
                                         PatternRewriter &rewriter) {
+  auto elementType = tensorType.getElementType();
+  auto elementOffset =
+      calculateElementOffset(loc, tensorType, dynamicDims, indices, rewriter);
+  if (isPackedStorageElementType(elementType)) {
+    auto bitOffset = rewriter.createOrFold<arith::MulIOp>(
+        loc, elementOffset,
+        rewriter.create<arith::ConstantIndexOp>(
+            loc, elementType.getIntOrFloatBitWidth()));
+    return rewriter.createOrFold<arith::DivUIOp>(
+        loc, bitOffset, rewriter.create<arith::ConstantIndexOp>(loc, 8));
+  }
   return rewriter.createOrFold<arith::MulIOp>(
-      loc,
-      calculateElementOffset(loc, tensorType, dynamicDims, indices, rewriter),
+      loc, elementOffset,
       rewriter.create<arith::ConstantIndexOp>(
-          loc,
-          IREE::Util::getRoundedElementByteWidth(tensorType.getElementType())));
+          loc, IREE::Util::getRoundedElementByteWidth(elementType)));
+}
+
+// Packs the sub-byte elements of |attr| into a flat i8 attribute.
+static ElementsAttr packElementsAttr(DenseIntElementsAttr attr) {
+  auto context = attr.getContext();
+  unsigned bitWidth = attr.getElementType().getIntOrFloatBitWidth();
+  unsigned elementsPerByte = 8 / bitWidth;
+  uint8_t elementMask = (1u << bitWidth) - 1;
+  int64_t byteCount = llvm::divideCeil(attr.getNumElements(), elementsPerByte);
+  auto packedType =
+      RankedTensorType::get({byteCount}, IntegerType::get(context, 8));
+  if (attr.isSplat()) {
+    uint8_t element = attr.getSplatValue<APInt>().getZExtValue() & elementMask;
+    uint8_t packedByte = 0;
+    for (unsigned i = 0; i < elementsPerByte; ++i) {
+      packedByte |= element << (i * bitWidth);
+    }
+    return DenseElementsAttr::get(
+        packedType, IntegerAttr::get(packedType.getElementType(), packedByte));
+  }
+  SmallVector<uint8_t> packedBytes(byteCount, 0);
+  int64_t index = 0;
+  for (const APInt &value : attr.getValues<APInt>()) {
+    uint8_t element = value.getZExtValue() & elementMask;
+    packedBytes[index / elementsPerByte] |=
+        element << ((index % elementsPerByte) * bitWidth);
+    ++index;
+  }
+  return DenseElementsAttr::get(packedType, ArrayRef<uint8_t>(packedBytes));
 }
 
 //===----------------------------------------------------------------------===//
@@ -217,10 +301,8 @@ struct EncodeTensorSizeOfOp
     }
 
     // Dense: element count * element size.
-    auto elementByteSize =
-        IREE::Util::getRoundedElementByteWidth(encodingType.getElementType());
-    auto totalSize = calculateElementCount(
-        op.getLoc(), encodingType, encodingDims, elementByteSize, rewriter);
+    auto totalSize =
+        calculateStorageSize(op.getLoc(), encodingType, encodingDims, rewriter);
     rewriter.replaceOp(op, totalSize);
 
     return success();
@@ -294,13 +376,20 @@ struct EncodeTensorConstantOp
               return sourceValue.zext(alignedBitWidth);
             });
       }
+    } else if (isPackedStorageElementType(resultType.getElementType())) {
+      // Packed sub-byte constants are stored as raw bytes so that they stay
+      // compressed in the final binary.
+      auto sourceAttr = encodedAttr.dyn_cast<DenseIntElementsAttr>();
+      if (!sourceAttr) {
+        return rewriter.notifyMatchFailure(
+            op, "packed storage requires dense integer constants");
+      }
+      encodedAttr = packElementsAttr(sourceAttr);
     }
 
     // Dense:
-    auto resultSize = calculateElementCount(
-        op.getLoc(), alignedType, resultDims,
-        IREE::Util::getRoundedElementByteWidth(alignedType.getElementType()),
-        rewriter);
+    auto resultSize =
+        calculateStorageSize(op.getLoc(), alignedType, resultDims, rewriter);
     rewriter.replaceOpWithNewOp<IREE::Stream::AsyncConstantOp>(
         op, op.getResult().getType(), encodedAttr, resultSize,
         op.getAffinityAttr());
@@ -346,6 +435,19 @@ static Value canonicalizeFillPattern(Value pattern, PatternRewriter &rewriter) {
   if (patternType.isInteger(1)) {
     return rewriter.createOrFold<arith::ExtUIOp>(loc, rewriter.getI8Type(),
                                                  pattern);
+  } else if (isPackedStorageElementType(patternType)) {
+    // Replicate packed values across an i8 pattern; e.g. i4 0xA -> i8 0xAA.
+    auto elementPattern = rewriter.createOrFold<arith::ExtUIOp>(
+        loc, rewriter.getI8Type(), pattern);
+    auto bytePattern = elementPattern;
+    for (unsigned shift = bitWidth; shift < 8; shift += bitWidth) {
+      auto shiftedPattern = rewriter.createOrFold<arith::ShLIOp>(
+          loc, elementPattern,
+          rewriter.create<arith::ConstantIntOp>(loc, shift, 8));
+      bytePattern =
+          rewriter.createOrFold<arith::OrIOp>(loc, bytePattern, shiftedPattern);
+    }
+    return bytePattern;
   } else if ((bitWidth % 8) != 0) {
     // We'd need some policy to determine how to handle non-byte-aligned widths.
     return {};
@@ -541,6 +643,11 @@ struct EncodeTensorLoadOp
       return failure();
     }
 
+    if (isPackedStorageElementType(sourceType.getElementType())) {
+      return rewriter.notifyMatchFailure(
+          op, "element loads from packed storage not supported");
+    }
+
     // Dense:
     auto sourceOffset = calculateElementByteOffset(
         op.getLoc(), sourceType, sourceDims, op.getIndices(), rewriter);
@@ -567,6 +674,11 @@ struct EncodeTensorStoreOp
       return failure();
     }
 
+    if (isPackedStorageElementType(targetType.getElementType())) {
+      return rewriter.notifyMatchFailure(
+          op, "element stores to packed storage not supported");
+    }
+
     // Dense:
     auto targetOffset = calculateElementByteOffset(
         op.getLoc(), targetType, targetDims, op.getIndices(), rewriter);
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <list>
+#include <numeric>
 
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -63,7 +64,16 @@ static Value packSlicesWithNoAliasing(
   return builder.createOrFold<IREE::Util::AlignOp>(loc, offset, rangeAlignment);
 }
 
-// Packs a set of statically-sized slices by greedy strip packing.
+// Offsets assigned to a set of statically-sized slices by one packing order.
+struct StaticPacking {
+  // Offset of each slice relative to the base offset in slice order.
+  SmallVector<int64_t> offsets;
+  // Total bytes required for all slices aligned to the range alignment.
+  int64_t totalSize = 0;
+};
+
+// Packs statically-sized slices by greedy strip packing in the given |order|.
+// |alignedSizes| are the sizes of each slice aligned to the range alignment.
 //
 // This is the same algorithm used in tflite here:
 // https://github.com/tensorflow/tensorflow/blob/master/tensorflow/lite/simple_memory_arena.cc
@@ -72,22 +82,15 @@ static Value packSlicesWithNoAliasing(
 // we do while doing the packing here offline. For this initial version I
 // wanted to ensure we matched apples/apples their implementation.
 //
-// We should use a set of heuristics and pick the smallest one. There are also
-// some really great papers that have approximations (as all of these are -
-// 2D strip packing is NP-hard) such as
+// There are some really great papers that have approximations (as all of
+// these are - 2D strip packing is NP-hard) such as
 // https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
 // someone with a brain able to parse mathy papers can try implementing.
-//
-// Slice packed offset SSA values will be updated and start at the given
-// |baseOffset|. Returns |baseOffset| + the total size of the allocation
-// aligned to the requirements of |resourceConfig|.
-static Value packStaticSlicesGreedily(
-    IREE::Stream::ResourcePackOp packOp, Value baseOffset,
-    ArrayRef<Slice> slices, IREE::Stream::ResourceConfigAttr resourceConfig,
-    IndexSet &indexSet, OpBuilder &builder) {
-  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
-  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
-
+static StaticPacking packStaticSlicesInOrder(ArrayRef<Slice> slices,
+                                             ArrayRef<int64_t> alignedSizes,
+                                             ArrayRef<unsigned> order,
+                                             int64_t offsetAlignment,
+                                             int64_t rangeAlignment) {
   struct Reservation {
     const Slice *slice = nullptr;
     int64_t staticOffset = 0;
@@ -95,14 +98,15 @@ static Value packStaticSlicesGreedily(
   };
   static constexpr int64_t UNASSIGNED = INT64_MAX;
 
+  StaticPacking packing;
+  packing.offsets.resize(slices.size(), 0);
   std::list<Reservation> reservations;
   int64_t highwaterMark = 0;
-  for (auto &slice : slices) {
+  for (unsigned sliceIndex : order) {
+    const Slice &slice = slices[sliceIndex];
     int64_t bestOffset = UNASSIGNED;
     int64_t bestOffsetFit = UNASSIGNED;
-    int64_t staticSize =
-        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
-    int64_t alignedSize = IREE::Util::align(staticSize, rangeAlignment);
+    int64_t alignedSize = alignedSizes[sliceIndex];
 
     // Iterate through reservations (sorted by ascending offset) and identify
     // gaps in which the slice will fit. To reduce wastage we want to find the
@@ -141,17 +145,127 @@ static Value packStaticSlicesGreedily(
       ++insertionIt;
     }
     reservations.insert(insertionIt, reservation);
-    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
-        packOp.getLoc(), baseOffset, indexSet.get(bestOffset)));
+    packing.offsets[sliceIndex] = bestOffset;
 
     // Update highwater mark indicating how much memory needs to be allocated
     // for the entire slab.
     highwaterMark = std::max(highwaterMark, bestOffset + alignedSize);
   }
 
-  highwaterMark = IREE::Util::align(highwaterMark, rangeAlignment);
-  return builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
-                                             indexSet.get(highwaterMark));
+  packing.totalSize = IREE::Util::align(highwaterMark, rangeAlignment);
+  return packing;
+}
+
+// Returns the maximum number of bytes live at any point in time across all
+// |slices|. No packing can require fewer bytes than this.
+static int64_t computeStaticLowerBound(ArrayRef<Slice> slices,
+                                       ArrayRef<int64_t> alignedSizes) {
+  // Sweep over lifetime start/end events. Lifetimes are inclusive so ends are
+  // processed after starts at the same point in time.
+  SmallVector<std::tuple<int64_t, bool, int64_t>> events;
+  events.reserve(slices.size() * 2);
+  for (auto [slice, alignedSize] : llvm::zip_equal(slices, alignedSizes)) {
+    events.push_back({slice.lifetimeStart, /*isEnd=*/false, alignedSize});
+    events.push_back({slice.lifetimeEnd, /*isEnd=*/true, alignedSize});
+  }
+  llvm::sort(events);
+  int64_t liveSize = 0;
+  int64_t maxLiveSize = 0;
+  for (auto [time, isEnd, alignedSize] : events) {
+    liveSize += isEnd ? -alignedSize : alignedSize;
+    maxLiveSize = std::max(maxLiveSize, liveSize);
+  }
+  return maxLiveSize;
+}
+
+// Orders in which statically-sized slices are packed. All orders are packed
+// and the one producing the smallest total size is used, preferring earlier
+// orders on ties.
+enum class StaticPackingOrder {
+  // Ascending by lifetime as the slices are defined.
+  Lifetime = 0,
+  // Descending by size × lifetime length (best-fit-decreasing by area).
+  Area = 1,
+  // Descending by size (first-fit interval coloring by weight).
+  Size = 2,
+};
+static constexpr unsigned kStaticPackingOrderCount = 3;
+
+// Returns the order in which |slices| are packed for |packingOrder|.
+static SmallVector<unsigned> getStaticPackingOrder(
+    StaticPackingOrder packingOrder, ArrayRef<Slice> slices,
+    ArrayRef<int64_t> alignedSizes) {
+  SmallVector<unsigned> order(slices.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto getArea = [&](unsigned i) {
+    return alignedSizes[i] *
+           (slices[i].lifetimeEnd - slices[i].lifetimeStart + 1);
+  };
+  switch (packingOrder) {
+    case StaticPackingOrder::Lifetime:
+      break;
+    case StaticPackingOrder::Area:
+      llvm::stable_sort(order, [&](unsigned lhs, unsigned rhs) {
+        return getArea(lhs) > getArea(rhs);
+      });
+      break;
+    case StaticPackingOrder::Size:
+      llvm::stable_sort(order, [&](unsigned lhs, unsigned rhs) {
+        return alignedSizes[lhs] > alignedSizes[rhs];
+      });
+      break;
+  }
+  return order;
+}
+
+// Packs a set of statically-sized slices with each of the StaticPackingOrders
+// and keeps whichever produces the smallest total size.
+//
+// Slice packed offset SSA values will be updated and start at the given
+// |baseOffset|. Returns |baseOffset| + the total size of the allocation
+// aligned to the requirements of |resourceConfig|. |outPackedSize| and
+// |outLowerBound| are set to the total packed size and the lower bound of any
+// packing, and |outPackingOrder| to the order used.
+static Value packStaticSlices(IREE::Stream::ResourcePackOp packOp,
+                              Value baseOffset, ArrayRef<Slice> slices,
+                              IREE::Stream::ResourceConfigAttr resourceConfig,
+                              IndexSet &indexSet, OpBuilder &builder,
+                              int64_t &outPackedSize, int64_t &outLowerBound,
+                              StaticPackingOrder &outPackingOrder) {
+  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
+  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
+
+  SmallVector<int64_t> alignedSizes;
+  alignedSizes.reserve(slices.size());
+  for (auto &slice : slices) {
+    int64_t staticSize =
+        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
+    alignedSizes.push_back(IREE::Util::align(staticSize, rangeAlignment));
+  }
+
+  StaticPacking bestPacking;
+  for (unsigned i = 0; i < kStaticPackingOrderCount; ++i) {
+    auto packingOrder = static_cast<StaticPackingOrder>(i);
+    auto packing = packStaticSlicesInOrder(
+        slices, alignedSizes,
+        getStaticPackingOrder(packingOrder, slices, alignedSizes),
+        offsetAlignment, rangeAlignment);
+    LLVM_DEBUG(llvm::dbgs() << "static packing order " << i << ": "
+                            << packing.totalSize << " bytes\n");
+    if (i == 0 || packing.totalSize < bestPacking.totalSize) {
+      bestPacking = std::move(packing);
+      outPackingOrder = packingOrder;
+    }
+  }
+  outPackedSize = bestPacking.totalSize;
+  outLowerBound = computeStaticLowerBound(slices, alignedSizes);
+
+  for (auto [slice, offset] : llvm::zip_equal(slices, bestPacking.offsets)) {
+    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
+        packOp.getLoc(), baseOffset, indexSet.get(offset)));
+  }
+  return builder.createOrFold<arith::AddIOp>(
+      packOp.getLoc(), baseOffset, indexSet.get(bestPacking.totalSize));
 }
 
 // Packs a set of dynamically-sized slices based on the structural information
@@ -260,9 +374,6 @@ class LayoutSlicesPass : public LayoutSlicesBase<LayoutSlicesPass> {
       return;
     }
 
-    // NOTE: we could try several algorithms and compute which packs best. For
-    // now we just pack greedily as it's fast and what most existing ML
-    // frameworks do.
     parentOp.walk([&](IREE::Stream::ResourcePackOp packOp) {
       // Derive resource constraints based on pack affinity.
       auto resourceConfig = IREE::Stream::ResourceConfigAttr::lookup(packOp);
@@ -290,8 +401,25 @@ class LayoutSlicesPass : public LayoutSlicesBase<LayoutSlicesPass> {
       // compile time.
       auto offset = packOp.getOffset() ? packOp.getOffset() : indexSet.get(0);
       if (!staticSlices.empty()) {
-        offset = packStaticSlicesGreedily(packOp, offset, staticSlices,
-                                          resourceConfig, indexSet, builder);
+        int64_t packedSize = 0;
+        int64_t lowerBound = 0;
+        StaticPackingOrder packingOrder = StaticPackingOrder::Lifetime;
+        offset = packStaticSlices(packOp, offset, staticSlices, resourceConfig,
+                                  indexSet, builder, packedSize, lowerBound,
+                                  packingOrder);
+        staticPackedSize += packedSize;
+        staticLowerBound += lowerBound;
+        switch (packingOrder) {
+          case StaticPackingOrder::Lifetime:
+            ++lifetimeOrderPacks;
+            break;
+          case StaticPackingOrder::Area:
+            ++areaOrderPacks;
+            break;
+          case StaticPackingOrder::Size:
+            ++sizeOrderPacks;
+            break;
+        }
 
         // TODO(benvanik): make this an option; it can be useful for debugging
         // this code.
@@ -314,6 +442,23 @@ class LayoutSlicesPass : public LayoutSlicesBase<LayoutSlicesPass> {
       packOp.erase();
     });
   }
+
+ private:
+  Statistic staticPackedSize{
+      this, "static packed bytes",
+      "Total bytes of statically-sized slices after packing"};
+  Statistic staticLowerBound{
+      this, "static lower bound bytes",
+      "Sum of the peak live bytes of statically-sized slices per pack"};
+  Statistic lifetimeOrderPacks{
+      this, "lifetime order pack(s)",
+      "Number of packs where packing in lifetime order was smallest"};
+  Statistic areaOrderPacks{
+      this, "area order pack(s)",
+      "Number of packs where packing by decreasing area was smallest"};
+  Statistic sizeOrderPacks{
+      this, "size order pack(s)",
+      "Number of packs where packing by decreasing size was smallest"};
 };
 
 }  // namespace
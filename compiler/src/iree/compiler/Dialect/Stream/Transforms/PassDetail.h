@@ -7,6 +7,7 @@
 #ifndef IREE_COMPILER_DIALECT_STREAM_TRANSFORMS_PASS_DETAIL_H_
 #define IREE_COMPILER_DIALECT_STREAM_TRANSFORMS_PASS_DETAIL_H_
 
+#include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir {
@@ -150,10 +150,28 @@ void buildStreamAsyncPassPipeline(OpPassManager &passManager,
   //----------------------------------------------------------------------------
 
   FunctionLikeNest(passManager)
+      // Issue transfers as early as possible so that they overlap with the
+      // work preceding their first use.
+      .addPredicatedPass(transformOptions.prefetchTransfers,
+                         [&]() {
+                           return IREE::Stream::createPrefetchTransfersPass(
+                               transformOptions.maxPrefetchMemory);
+                         })
       // Combine async work into execution regions.
       .addPass(IREE::Stream::createScheduleExecutionPass)
+      // Shorten the live ranges of cheap transients if a budget is set.
+      .addPredicatedPass(
+          transformOptions.maxTransientMemory > 0,
+          [&]() {
+            return IREE::Stream::createRematerializeTransientsPass(
+                transformOptions.maxTransientMemory);
+          })
       // Group concurrently executable work into waves.
-      .addPass(IREE::Stream::createScheduleConcurrencyPass);
+      .addPass([&]() {
+        return IREE::Stream::createScheduleConcurrencyPass(
+            transformOptions.partitioningAlgorithm,
+            transformOptions.maxConcurrentMemory);
+      });
 
   // Materialize timepoints across the entire module. This simplifies scheduling
   // of the timeline as we can shake the IR and see what timepoints we still
@@ -35,6 +35,52 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
       llvm::cl::init(true),
   };
 
+  Option<PartitioningAlgorithm> partitioningAlgorithm{
+      *this,
+      "partitioning-algorithm",
+      llvm::cl::desc(
+          "Algorithm used to form waves of concurrently executable work."),
+      llvm::cl::init(PartitioningAlgorithm::Reference),
+      llvm::cl::values(
+          clEnumValN(PartitioningAlgorithm::Reference, "reference",
+                     "Hazard-only greedy wave formation."),
+          clEnumValN(PartitioningAlgorithm::CostModel, "cost-model",
+                     "Balances concurrency against estimated transient "
+                     "memory.")),
+  };
+  Option<int64_t> maxConcurrentMemory{
+      *this,
+      "max-concurrent-memory",
+      llvm::cl::desc("Maximum estimated bytes of new resources produced by a "
+                     "single wave with the cost model; 0 is unbounded."),
+      llvm::cl::init(0),
+  };
+
+  Option<int64_t> maxTransientMemory{
+      *this,
+      "max-transient-memory",
+      llvm::cl::desc("Maximum estimated bytes of transient resources live at "
+                     "once within an execution region. Cheap producers are "
+                     "rematerialized to fit and a warning is emitted if the "
+                     "estimate still exceeds it; 0 is unbounded."),
+      llvm::cl::init(0),
+  };
+
+  Option<bool> prefetchTransfers{
+      *this,
+      "prefetch-transfers",
+      llvm::cl::desc("Hoists resource transfers (such as constant uploads) "
+                     "earlier so that they overlap with preceding work."),
+      llvm::cl::init(false),
+  };
+  Option<int64_t> maxPrefetchMemory{
+      *this,
+      "max-prefetch-memory",
+      llvm::cl::desc("Maximum bytes of hoisted transfer results live across "
+                     "any op when prefetching; 0 is unbounded."),
+      llvm::cl::init(0),
+  };
+
   Option<DumpOutputFormat> dumpStatisticsFormat{
       *this,
       "dump-statistics-format",
@@ -119,10 +165,17 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createRefineUsagePass();
 // Stream formation and scheduling
 //===----------------------------------------------------------------------===//
 
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPrefetchTransfersPass(
+    int64_t maxPrefetchMemory = 0);
 std::unique_ptr<InterfacePass<CallableOpInterface>>
 createScheduleExecutionPass();
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleConcurrencyPass();
+createRematerializeTransientsPass(int64_t maxTransientMemory = 0);
+std::unique_ptr<InterfacePass<CallableOpInterface>>
+createScheduleConcurrencyPass(
+    PartitioningAlgorithm partitioningAlgorithm =
+        PartitioningAlgorithm::Reference,
+    int64_t maxConcurrentMemory = 0);
 
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createPropagateTimepointsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createElideTimepointsPass();
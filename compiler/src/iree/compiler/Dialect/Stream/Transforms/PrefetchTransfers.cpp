@@ -0,0 +1,167 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-prefetch-transfers"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Transfer hoisting
+//===----------------------------------------------------------------------===//
+
+// Returns the last op in the block of |op| that defines one of its operands or
+// nullptr if all operands are defined outside of the block.
+static Operation *findLastOperandDefiningOp(Operation *op) {
+  Block *block = op->getBlock();
+  Operation *lastOp = nullptr;
+  for (auto operand : op->getOperands()) {
+    auto *definingOp = operand.getDefiningOp();
+    if (!definingOp) continue;
+    definingOp = block->findAncestorOpInBlock(*definingOp);
+    if (!definingOp) continue;
+    if (!lastOp || lastOp->isBeforeInBlock(definingOp)) lastOp = definingOp;
+  }
+  return lastOp;
+}
+
+// Returns the number of bytes produced by |transferOp| or -1 if unknown.
+static int64_t getTransferBytes(IREE::Stream::AsyncTransferOp transferOp) {
+  APInt resultSize;
+  if (!matchPattern(transferOp.getResultSize(), m_ConstantInt(&resultSize))) {
+    return -1;
+  }
+  return resultSize.getSExtValue();
+}
+
+// Tracks transfers hoisted within a callable and the bytes they keep live.
+struct PrefetchState {
+  // Transfers that have been hoisted; later transfers are not hoisted above
+  // them so that the original issue order of transfers is preserved.
+  DenseSet<Operation *> hoistedOps;
+  // Bytes of hoisted transfer results live across each op in addition to
+  // those in the original program order.
+  DenseMap<Operation *, int64_t> prefetchedBytes;
+};
+
+// Hoists |transferOp| to the earliest point in its block where all of its
+// operands are available without exceeding |maxPrefetchMemory| bytes of
+// prefetched results live across any op. Returns true if the op was moved.
+static bool tryHoistTransfer(IREE::Stream::AsyncTransferOp transferOp,
+                             int64_t maxPrefetchMemory,
+                             PrefetchState &state) {
+  int64_t transferBytes = getTransferBytes(transferOp);
+  if (maxPrefetchMemory > 0 &&
+      (transferBytes < 0 || transferBytes > maxPrefetchMemory)) {
+    // Can't account for the transfer in the budget.
+    return false;
+  }
+
+  // Walk up from the transfer until we hit an operand producer, a previously
+  // hoisted transfer, or an op that would exceed the budget.
+  Operation *lastOperandOp = findLastOperandDefiningOp(transferOp);
+  Operation *insertionOp = nullptr;
+  for (auto *op = transferOp->getPrevNode(); op && op != lastOperandOp;
+       op = op->getPrevNode()) {
+    if (state.hoistedOps.contains(op)) break;
+    if (maxPrefetchMemory > 0 &&
+        state.prefetchedBytes.lookup(op) + transferBytes > maxPrefetchMemory) {
+      break;
+    }
+    insertionOp = op;
+  }
+  if (!insertionOp) return false;
+
+  LLVM_DEBUG({
+    llvm::dbgs() << "hoisting transfer of " << transferBytes
+                 << " bytes before: ";
+    insertionOp->print(llvm::dbgs(),
+                       OpPrintingFlags().elideLargeElementsAttrs());
+    llvm::dbgs() << "\n";
+  });
+
+  // Account for the result now being live across the ops it was moved above.
+  if (transferBytes > 0) {
+    for (auto *op = insertionOp; op != transferOp.getOperation();
+         op = op->getNextNode()) {
+      state.prefetchedBytes[op] += transferBytes;
+    }
+  }
+  transferOp->moveBefore(insertionOp);
+  state.hoistedOps.insert(transferOp);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-prefetch-transfers
+//===----------------------------------------------------------------------===//
+
+class PrefetchTransfersPass
+    : public PrefetchTransfersBase<PrefetchTransfersPass> {
+ public:
+  PrefetchTransfersPass() = default;
+  PrefetchTransfersPass(int64_t maxPrefetchMemory) {
+    this->maxPrefetchMemory = maxPrefetchMemory;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::Stream::StreamDialect>();
+  }
+
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (!parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+
+    // Gather transfers in program order. Transfers already within execution
+    // regions have been scheduled and are left as-is.
+    SmallVector<IREE::Stream::AsyncTransferOp> transferOps;
+    parentOp.getCallableRegion()->walk(
+        [&](IREE::Stream::AsyncTransferOp transferOp) {
+          if (!transferOp->getParentOfType<IREE::Stream::AsyncExecuteOp>()) {
+            transferOps.push_back(transferOp);
+          }
+        });
+
+    PrefetchState state;
+    for (auto transferOp : transferOps) {
+      if (tryHoistTransfer(transferOp, maxPrefetchMemory, state)) {
+        ++numHoistedTransfers;
+      }
+    }
+  }
+
+ private:
+  Statistic numHoistedTransfers{this, "hoisted-transfers",
+                                "Number of transfers hoisted"};
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPrefetchTransfersPass(
+    int64_t maxPrefetchMemory) {
+  return std::make_unique<PrefetchTransfersPass>(maxPrefetchMemory);
+}
+
+}  // namespace Stream
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
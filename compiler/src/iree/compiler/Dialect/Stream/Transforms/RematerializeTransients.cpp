@@ -0,0 +1,230 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilInterfaces.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-rematerialize-transients"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Transient liveness estimation
+//===----------------------------------------------------------------------===//
+
+// A resource produced within an execution region along with the range of ops
+// (by index in the region block) over which it or any value tied to it is
+// live.
+struct LiveRange {
+  Operation *definingOp = nullptr;
+  int64_t bytes = 0;
+  unsigned start = 0;
+  unsigned end = 0;
+};
+
+// Returns the estimated number of bytes of the new resource produced by
+// |result| or 0 if it is tied to an operand or has a dynamic size.
+static int64_t getResultBytes(OpResult result) {
+  if (!result.getType().isa<IREE::Stream::ResourceType>()) return 0;
+  auto sizeAwareOp =
+      dyn_cast<IREE::Util::SizeAwareOpInterface>(result.getOwner());
+  if (!sizeAwareOp) return 0;
+  APInt resultSize;
+  if (!matchPattern(sizeAwareOp.getResultSize(result.getResultNumber()),
+                    m_ConstantInt(&resultSize))) {
+    return 0;
+  }
+  return resultSize.getSExtValue();
+}
+
+// Computes the live ranges of all resources produced within |block|. Results
+// tied to operands extend the live range of the resource they alias.
+static SmallVector<LiveRange> computeLiveRanges(Block *block) {
+  DenseMap<Operation *, unsigned> opIndices;
+  for (auto &op : *block) opIndices[&op] = opIndices.size();
+
+  SmallVector<LiveRange> ranges;
+  DenseMap<Value, unsigned> rangeIndices;
+  for (auto &op : *block) {
+    unsigned opIndex = opIndices[&op];
+    auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(op);
+    for (auto result : op.getResults()) {
+      if (tiedOp) {
+        if (auto tiedOperand = tiedOp.getTiedResultOperand(result)) {
+          auto it = rangeIndices.find(tiedOperand);
+          if (it != rangeIndices.end()) rangeIndices[result] = it->second;
+          continue;
+        }
+      }
+      int64_t bytes = getResultBytes(result);
+      if (bytes == 0) continue;
+      rangeIndices[result] = ranges.size();
+      ranges.push_back({&op, bytes, opIndex, opIndex});
+    }
+  }
+
+  // Extend each range to the last user of any of its aliases.
+  for (auto [value, rangeIndex] : rangeIndices) {
+    auto &range = ranges[rangeIndex];
+    for (auto *user : value.getUsers()) {
+      auto *userOp = block->findAncestorOpInBlock(*user);
+      if (!userOp) continue;
+      range.end = std::max(range.end, opIndices[userOp]);
+    }
+  }
+  return ranges;
+}
+
+// Returns the peak number of live bytes across |ranges| and the index of the
+// first op at which it is reached.
+static std::pair<int64_t, unsigned> computePeakLiveBytes(
+    ArrayRef<LiveRange> ranges, unsigned numOps) {
+  SmallVector<int64_t> deltas(numOps + 1, 0);
+  for (auto &range : ranges) {
+    deltas[range.start] += range.bytes;
+    deltas[range.end + 1] -= range.bytes;
+  }
+  int64_t liveBytes = 0;
+  int64_t peakBytes = 0;
+  unsigned peakIndex = 0;
+  for (unsigned i = 0; i < numOps; ++i) {
+    liveBytes += deltas[i];
+    if (liveBytes > peakBytes) {
+      peakBytes = liveBytes;
+      peakIndex = i;
+    }
+  }
+  return std::make_pair(peakBytes, peakIndex);
+}
+
+//===----------------------------------------------------------------------===//
+// Rematerialization
+//===----------------------------------------------------------------------===//
+
+// Replaces |splatOp| with a clone placed immediately before each of its users
+// so that the resource is only live while it is being consumed.
+static void rematerializeAtUsers(IREE::Stream::AsyncSplatOp splatOp,
+                                 DenseSet<Operation *> &rematerializedOps) {
+  Block *block = splatOp->getBlock();
+  SetVector<Operation *> userOps;
+  for (auto *user : splatOp.getResult().getUsers()) {
+    userOps.insert(block->findAncestorOpInBlock(*user));
+  }
+  OpBuilder builder(splatOp);
+  for (auto *userOp : userOps) {
+    builder.setInsertionPoint(userOp);
+    auto *clonedOp = builder.clone(*splatOp.getOperation());
+    rematerializedOps.insert(clonedOp);
+    splatOp.getResult().replaceUsesWithIf(
+        clonedOp->getResult(0), [&](OpOperand &use) {
+          return block->findAncestorOpInBlock(*use.getOwner()) == userOp;
+        });
+  }
+  splatOp.erase();
+}
+
+// Returns a splat op that is live at |peakIndex| without being consumed there
+// and can be rematerialized to shorten its live range.
+static IREE::Stream::AsyncSplatOp findRematerializationCandidate(
+    ArrayRef<LiveRange> ranges, unsigned peakIndex,
+    const DenseSet<Operation *> &rematerializedOps) {
+  for (auto &range : ranges) {
+    if (range.start >= peakIndex || range.end <= peakIndex) continue;
+    auto splatOp = dyn_cast<IREE::Stream::AsyncSplatOp>(range.definingOp);
+    if (!splatOp || rematerializedOps.contains(splatOp)) continue;
+    return splatOp;
+  }
+  return {};
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-rematerialize-transients
+//===----------------------------------------------------------------------===//
+
+class RematerializeTransientsPass
+    : public RematerializeTransientsBase<RematerializeTransientsPass> {
+ public:
+  RematerializeTransientsPass() = default;
+  RematerializeTransientsPass(int64_t maxTransientMemory) {
+    this->maxTransientMemory = maxTransientMemory;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::Stream::StreamDialect>();
+  }
+
+  void runOnOperation() override {
+    if (maxTransientMemory <= 0) return;
+    auto parentOp = getOperation();
+    if (!parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+    parentOp.getCallableRegion()->walk(
+        [&](IREE::Stream::AsyncExecuteOp executeOp) {
+          runOnRegion(executeOp);
+        });
+  }
+
+  void runOnRegion(IREE::Stream::AsyncExecuteOp executeOp) {
+    if (executeOp.getBody().empty()) return;
+    auto *block = &executeOp.getBody().front();
+
+    // Rematerialize cheap producers live across the peak until the estimate
+    // fits within the budget or there is nothing left to rematerialize.
+    DenseSet<Operation *> rematerializedOps;
+    while (true) {
+      auto ranges = computeLiveRanges(block);
+      auto [peakBytes, peakIndex] =
+          computePeakLiveBytes(ranges, block->getOperations().size());
+      if (peakBytes <= maxTransientMemory) return;
+      auto splatOp =
+          findRematerializationCandidate(ranges, peakIndex, rematerializedOps);
+      if (!splatOp) {
+        executeOp.emitWarning()
+            << "estimated peak transient memory of " << peakBytes
+            << " bytes exceeds the budget of " << maxTransientMemory
+            << " bytes";
+        return;
+      }
+      LLVM_DEBUG(llvm::dbgs() << "rematerializing splat live across peak of "
+                              << peakBytes << " bytes at op " << peakIndex
+                              << "\n");
+      rematerializeAtUsers(splatOp, rematerializedOps);
+      ++numRematerializedOps;
+    }
+  }
+
+ private:
+  Statistic numRematerializedOps{this, "rematerialized-ops",
+                                 "Number of producers rematerialized"};
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<CallableOpInterface>>
+createRematerializeTransientsPass(int64_t maxTransientMemory) {
+  return std::make_unique<RematerializeTransientsPass>(maxTransientMemory);
+}
+
+}  // namespace Stream
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
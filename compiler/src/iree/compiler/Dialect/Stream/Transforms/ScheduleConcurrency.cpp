@@ -170,6 +170,13 @@ struct WavePartitionBuilder {
 class ScheduleConcurrencyPass
     : public ScheduleConcurrencyBase<ScheduleConcurrencyPass> {
  public:
+  ScheduleConcurrencyPass() = default;
+  ScheduleConcurrencyPass(PartitioningAlgorithm partitioningAlgorithm,
+                          int64_t maxConcurrentMemory) {
+    this->partitioningAlgorithm = partitioningAlgorithm;
+    this->maxConcurrentMemory = maxConcurrentMemory;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<IREE::Stream::StreamDialect>();
     registry.insert<IREE::Util::UtilDialect>();
@@ -198,7 +205,10 @@ class ScheduleConcurrencyPass
 
     // Compute a set of partitions covering all of the streamable ops in the
     // execution region.
-    auto waveSet = partitionRegionConcurrency(configAttr, block);
+    PartitioningOptions options;
+    options.algorithm = partitioningAlgorithm;
+    options.maxConcurrentMemory = maxConcurrentMemory;
+    auto waveSet = partitionRegionConcurrency(configAttr, block, options);
     if (waveSet.empty()) return success();
     if (failed(waveSet.verify(parentOp.getLoc()))) return failure();
 
@@ -263,8 +273,10 @@ class ScheduleConcurrencyPass
 }  // namespace
 
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleConcurrencyPass() {
-  return std::make_unique<ScheduleConcurrencyPass>();
+createScheduleConcurrencyPass(PartitioningAlgorithm partitioningAlgorithm,
+                              int64_t maxConcurrentMemory) {
+  return std::make_unique<ScheduleConcurrencyPass>(partitioningAlgorithm,
+                                                   maxConcurrentMemory);
 }
 
 }  // namespace Stream
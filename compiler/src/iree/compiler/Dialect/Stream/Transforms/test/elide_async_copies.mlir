@@ -120,3 +120,59 @@ func.func private @blockArgMove(%cond: i1, %size: index) -> (!stream.resource<*>
 ^bb2(%bb2_0: !stream.resource<*>, %bb2_1: !stream.resource<*>):
   return %bb2_0, %bb2_1 : !stream.resource<*>, !stream.resource<*>
 }
+
+// -----
+
+// Tests that copies of loop-carried values are elided when the loop receives
+// the last use of the initial value and yields the last use of the updated
+// value, while copies of values captured from outside the loop are preserved
+// as they are read again by each iteration.
+
+// CHECK-LABEL: @loopCarriedMove
+// CHECK-SAME: (%[[COUNT:.+]]: index, %[[SIZE:.+]]: index)
+func.func private @loopCarriedMove(%count: index, %size: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %c123_i32 = arith.constant 123 : i32
+  %c456_i32 = arith.constant 456 : i32
+  // CHECK: %[[SPLAT0:.+]] = stream.async.splat %c123
+  %splat0 = stream.async.splat %c123_i32 : i32 -> !stream.resource<*>{%size}
+  // CHECK: %[[SPLAT1:.+]] = stream.async.splat %c456
+  %splat1 = stream.async.splat %c456_i32 : i32 -> !stream.resource<*>{%size}
+  // CHECK: scf.for %{{.+}} = %c0 to %[[COUNT]] step %c1 iter_args(%[[ITER:.+]] = %[[SPLAT0]])
+  %result = scf.for %i = %c0 to %count step %c1 iter_args(%iter = %splat0) -> !stream.resource<*> {
+    // CHECK-NOT: stream.async.clone %[[ITER]]
+    %clone0 = stream.async.clone %iter : !stream.resource<*>{%size} -> !stream.resource<*>{%size}
+    // CHECK: %[[FILL:.+]] = stream.async.fill %c123_i32, %[[ITER]]
+    %fill = stream.async.fill %c123_i32, %clone0[%c0 to %c128 for %c128] : i32 -> !stream.resource<*>{%size}
+    // CHECK: %[[CLONE1:.+]] = stream.async.clone %[[SPLAT1]]
+    %clone1 = stream.async.clone %splat1 : !stream.resource<*>{%size} -> !stream.resource<*>{%size}
+    // CHECK: %[[UPDATE:.+]] = stream.async.update %[[CLONE1]], %[[FILL]]
+    %update = stream.async.update %clone1, %fill[%c0 to %size] : !stream.resource<*>{%size} -> %fill as !stream.resource<*>{%size}
+    // CHECK: scf.yield %[[UPDATE]]
+    scf.yield %update : !stream.resource<*>
+  }
+  return %result : !stream.resource<*>
+}
+
+// -----
+
+// Tests that the copy-on-write clone of an imported resource that is donated as
+// the storage of a result is elided when the update is the last use. Prior
+// reads of the import are ordered before the update by the tie.
+
+// CHECK-LABEL: @donatedImportUpdate
+func.func @donatedImportUpdate(%view: !hal.buffer_view, %size: index) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  // CHECK: %[[IMPORT:.+]] = stream.tensor.import
+  %import = stream.tensor.import %view : !hal.buffer_view -> tensor<4xf32> in !stream.resource<external>{%size}
+  %input = stream.async.transfer %import : !stream.resource<external>{%size} -> !stream.resource<*>{%size}
+  %result = stream.async.dispatch @ex::@dispatch(%input[%c0 to %size for %size]) : (!stream.resource<*>{%size}) -> !stream.resource<*>{%size}
+  // CHECK-NOT: stream.async.clone
+  %clone = stream.async.clone %import : !stream.resource<external>{%size} -> !stream.resource<external>{%size}
+  // CHECK: %[[UPDATE:.+]] = stream.async.update %{{.+}}, %[[IMPORT]]
+  %update = stream.async.update %result, %clone[%c0 to %size] : !stream.resource<*>{%size} -> %clone as !stream.resource<external>{%size}
+  // CHECK: return %[[UPDATE]]
+  return %update : !stream.resource<external>
+}
@@ -285,4 +285,26 @@ func.func @scfIfConvergent(%cond: i1, %t0: !stream.timepoint, %t1: !stream.timep
   return %join : !stream.timepoint
 }
 
-// TODO(benvanik): support scf.for
+// -----
+
+// Tests that scf.for loops that may run zero times don't propagate coverage
+// from the loop body: %t0 is only covered if the loop body executes and must
+// be preserved.
+
+// CHECK-LABEL: func @scfForZeroTrip
+// CHECK-SAME: (%[[LB:.+]]: index, %[[UB:.+]]: index, %[[STEP:.+]]: index, %[[T0:.+]]: !stream.timepoint, %[[T1:.+]]: !stream.timepoint)
+func.func @scfForZeroTrip(%lb: index, %ub: index, %step: index, %t0: !stream.timepoint, %t1: !stream.timepoint) -> !stream.timepoint {
+  // CHECK: %[[FOR:.+]] = scf.for
+  // CHECK-SAME: iter_args(%[[ARG:.+]] = %[[T1]])
+  %for = scf.for %i = %lb to %ub step %step iter_args(%arg = %t1) -> !stream.timepoint {
+    // CHECK: %[[T:.+]] = stream.cmd.execute await(%[[T0]])
+    %t = stream.cmd.execute await(%t0) => with() {} => !stream.timepoint
+    // CHECK: yield %[[T]]
+    scf.yield %t : !stream.timepoint
+  }
+  // CHECK-NOT: stream.timepoint.immediate
+  // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[T0]], %[[FOR]])
+  %join = stream.timepoint.join max(%t0, %for) => !stream.timepoint
+  // CHECK: return %[[JOIN]]
+  return %join : !stream.timepoint
+}
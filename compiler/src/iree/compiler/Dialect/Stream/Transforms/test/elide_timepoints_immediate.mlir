@@ -375,4 +375,47 @@ func.func @scfIfDivergent(%cond: i1, %unknown: !stream.timepoint) -> !stream.tim
   return %join_outer : !stream.timepoint
 }
 
-// TODO(benvanik): support scf.for
+// -----
+
+// Tests that scf.for loop-carried timepoints that are immediate on entry and
+// across every iteration are elided.
+
+// CHECK-LABEL: func @scfForImmediate
+// CHECK-SAME: (%[[LB:.+]]: index, %[[UB:.+]]: index, %[[STEP:.+]]: index)
+func.func @scfForImmediate(%lb: index, %ub: index, %step: index) -> !stream.timepoint {
+  // CHECK: %[[IMM:.+]] = stream.timepoint.immediate
+  %imm = stream.timepoint.immediate => !stream.timepoint
+  // CHECK: scf.for
+  %for = scf.for %i = %lb to %ub step %step iter_args(%arg = %imm) -> !stream.timepoint {
+    // CHECK: %[[ARG_IMM:.+]] = stream.timepoint.immediate
+    // CHECK-NEXT: %[[JOIN:.+]] = stream.timepoint.join max(%[[ARG_IMM]], %[[IMM]])
+    %join = stream.timepoint.join max(%arg, %imm) => !stream.timepoint
+    // CHECK: yield
+    scf.yield %join : !stream.timepoint
+  }
+  // CHECK: %[[FOR_IMM:.+]] = stream.timepoint.immediate
+  // CHECK-NEXT: return %[[FOR_IMM]]
+  return %for : !stream.timepoint
+}
+
+// -----
+
+// Tests that scf.for loop-carried timepoints that become non-immediate in the
+// loop body are preserved.
+
+// CHECK-LABEL: func @scfForDivergent
+// CHECK-SAME: (%[[LB:.+]]: index, %[[UB:.+]]: index, %[[STEP:.+]]: index, %[[UNKNOWN:.+]]: !stream.timepoint)
+func.func @scfForDivergent(%lb: index, %ub: index, %step: index, %unknown: !stream.timepoint) -> !stream.timepoint {
+  // CHECK: %[[IMM:.+]] = stream.timepoint.immediate
+  %imm = stream.timepoint.immediate => !stream.timepoint
+  // CHECK: %[[FOR:.+]] = scf.for
+  %for = scf.for %i = %lb to %ub step %step iter_args(%arg = %imm) -> !stream.timepoint {
+    // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[ARG:.+]], %[[UNKNOWN]])
+    %join = stream.timepoint.join max(%arg, %unknown) => !stream.timepoint
+    // CHECK: yield %[[JOIN]]
+    scf.yield %join : !stream.timepoint
+  }
+  // CHECK-NOT: stream.timepoint.immediate
+  // CHECK: return %[[FOR]]
+  return %for : !stream.timepoint
+}
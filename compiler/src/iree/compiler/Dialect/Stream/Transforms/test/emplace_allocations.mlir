@@ -182,3 +182,45 @@ func.func @emplaceDependentDispatchSequence(
   // CHECK-NEXT: return %[[TARGET1]]
   return %target1 : !stream.resource<*>
 }
+
+// -----
+
+// Tests that a dispatch is not placed into a target that it reads as doing so
+// would clobber its input. This originates from arguments donated as the
+// storage for results they are used to compute.
+
+// CHECK-LABEL: @dontEmplaceIntoReadTarget
+// CHECK-SAME: (%[[TARGET:.+]]: !stream.resource<external>, %[[TARGET_SIZE:.+]]: index)
+func.func @dontEmplaceIntoReadTarget(%target: !stream.resource<external>, %target_size: index) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  // CHECK: %[[INPUT:.+]] = stream.async.transfer %[[TARGET]]
+  %input = stream.async.transfer %target : !stream.resource<external>{%target_size} -> !stream.resource<*>{%target_size}
+  // CHECK: %[[UPDATE:.+]] = stream.async.dispatch @ex::@dispatch(%[[INPUT]][{{.+}}]) : (!stream.resource<*>{%[[TARGET_SIZE]]}) -> !stream.resource<*>{%[[TARGET_SIZE]]}
+  %update = stream.async.dispatch @ex::@dispatch(%input[%c0 to %target_size for %target_size]) : (!stream.resource<*>{%target_size}) -> !stream.resource<*>{%target_size}
+  // CHECK: %[[RESULT:.+]] = stream.async.update %[[UPDATE]], %[[TARGET]]
+  %result = stream.async.update %update, %target[%c0 to %target_size] : !stream.resource<*>{%target_size} -> %target as !stream.resource<external>{%target_size}
+  // CHECK: return %[[RESULT]]
+  return %result : !stream.resource<external>
+}
+
+// -----
+
+// Tests that a dispatch is placed into a donated target once all reads of the
+// target have been performed by prior dispatches.
+
+// CHECK-LABEL: @emplaceIntoDonatedTarget
+// CHECK-SAME: (%[[TARGET:.+]]: !stream.resource<external>, %[[TARGET_SIZE:.+]]: index)
+func.func @emplaceIntoDonatedTarget(%target: !stream.resource<external>, %target_size: index) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  // CHECK: %[[INPUT:.+]] = stream.async.transfer %[[TARGET]]
+  %input = stream.async.transfer %target : !stream.resource<external>{%target_size} -> !stream.resource<*>{%target_size}
+  // CHECK: %[[TEMP:.+]] = stream.async.dispatch @ex::@dispatch0(%[[INPUT]]
+  %temp = stream.async.dispatch @ex::@dispatch0(%input[%c0 to %target_size for %target_size]) : (!stream.resource<*>{%target_size}) -> !stream.resource<*>{%target_size}
+  // CHECK: %[[RESULT:.+]] = stream.async.dispatch @ex::@dispatch1(%[[TEMP]][{{.+}}], %[[TARGET]][%c0 to %[[TARGET_SIZE]] for %[[TARGET_SIZE]]]) :
+  // CHECK-SAME: (!stream.resource<*>{%[[TARGET_SIZE]]}, !stream.resource<external>{%[[TARGET_SIZE]]}) -> %[[TARGET]]{%[[TARGET_SIZE]]}
+  %update = stream.async.dispatch @ex::@dispatch1(%temp[%c0 to %target_size for %target_size]) : (!stream.resource<*>{%target_size}) -> !stream.resource<*>{%target_size}
+  // CHECK-NOT: stream.async.update
+  %result = stream.async.update %update, %target[%c0 to %target_size] : !stream.resource<*>{%target_size} -> %target as !stream.resource<external>{%target_size}
+  // CHECK: return %[[RESULT]]
+  return %result : !stream.resource<external>
+}
@@ -0,0 +1,94 @@
+// RUN: iree-opt --split-input-file --iree-stream-experimental-packed-sub-byte-storage --iree-stream-encode-host-tensors --iree-stream-encode-device-tensors %s | FileCheck %s
+
+// CHECK-LABEL: @packedTensorSizeOfStatic
+func.func @packedTensorSizeOfStatic() -> index {
+  // CHECK: %[[STATIC_SIZE:.+]] = arith.constant 5 : index
+  %0 = stream.tensor.sizeof tensor<10xi4> : index
+  // CHECK: return %[[STATIC_SIZE]]
+  return %0 : index
+}
+
+// -----
+
+// CHECK-LABEL: @packedTensorSizeOfDynamic
+func.func @packedTensorSizeOfDynamic(%arg0: index) -> index {
+  // CHECK-DAG: %[[C20:.+]] = arith.constant 20 : index
+  // CHECK-DAG: %[[C8:.+]] = arith.constant 8 : index
+  // CHECK: %[[BITS:.+]] = arith.muli %arg0, %[[C20]] : index
+  // CHECK: %[[SIZE:.+]] = arith.ceildivui %[[BITS]], %[[C8]] : index
+  %0 = stream.tensor.sizeof tensor<?x5xi4>{%arg0} : index
+  // CHECK: return %[[SIZE]]
+  return %0 : index
+}
+
+// -----
+
+// CHECK-LABEL: @packedTensorConstantI4
+func.func @packedTensorConstantI4() -> !stream.resource<constant> {
+  // CHECK: %[[STATIC_SIZE:.+]] = arith.constant 2 : index
+  // CHECK: %[[RET:.+]] = stream.async.constant : !stream.resource<constant>{%[[STATIC_SIZE]]} = dense<[33, 67]> : tensor<2xi8>
+  %0 = stream.tensor.constant : tensor<4xi4> in !stream.resource<constant> = dense<[1, 2, 3, 4]> : tensor<4xi4>
+  // CHECK: return %[[RET]]
+  return %0 : !stream.resource<constant>
+}
+
+// -----
+
+// CHECK-LABEL: @packedTensorConstantSplatI2
+func.func @packedTensorConstantSplatI2() -> !stream.resource<constant> {
+  // CHECK: %[[STATIC_SIZE:.+]] = arith.constant 3 : index
+  // CHECK: %[[RET:.+]] = stream.async.constant : !stream.resource<constant>{%[[STATIC_SIZE]]} = dense<85> : tensor<3xi8>
+  %0 = stream.tensor.constant : tensor<10xi2> in !stream.resource<constant> = dense<1> : tensor<10xi2>
+  // CHECK: return %[[RET]]
+  return %0 : !stream.resource<constant>
+}
+
+// -----
+
+// CHECK-LABEL: @packedTensorSplatI4
+func.func @packedTensorSplatI4(%arg0: i4, %arg1: index) -> !stream.resource<*> {
+  // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i8
+  // CHECK-DAG: %[[LO:.+]] = arith.extui %arg0 : i4 to i8
+  // CHECK: %[[HI:.+]] = arith.shli %[[LO]], %[[C4]] : i8
+  // CHECK: %[[PATTERN:.+]] = arith.ori %[[LO]], %[[HI]] : i8
+  // CHECK: %[[RET:.+]] = stream.async.splat %[[PATTERN]] : i8 -> !stream.resource<*>{%arg1}
+  %0 = stream.tensor.splat %arg0 : i4 -> tensor<8xi4> in !stream.resource<*>{%arg1}
+  // CHECK: return %[[RET]]
+  return %0 : !stream.resource<*>
+}
+
+// -----
+
+// CHECK-LABEL: @packedTensorSliceI4
+func.func @packedTensorSliceI4(%arg0: !stream.resource<*>, %arg1: index, %arg2: index) -> !stream.resource<*> {
+  %c2 = arith.constant 2 : index
+  %c0 = arith.constant 0 : index
+  // CHECK-DAG: %[[OFFSET:.+]] = arith.constant 8 : index
+  // CHECK-DAG: %[[END:.+]] = arith.addi %arg2, %[[OFFSET]] : index
+  // CHECK: %[[RET:.+]] = stream.async.slice %arg0[%[[OFFSET]] to %[[END]]] : !stream.resource<*>{%arg1} -> !stream.resource<*>{%arg2}
+  %0 = stream.tensor.slice %arg0[%c2, %c0 for %c2, %c2] : tensor<4x8xi4> in !stream.resource<*>{%arg1} -> tensor<2x8xi4> in !stream.resource<*>{%arg2}
+  // CHECK: return %[[RET]]
+  return %0 : !stream.resource<*>
+}
+
+// -----
+
+// Packed bindings are passed through to codegen without widening.
+
+// CHECK-LABEL: @packedBindingI4
+stream.executable private @packedBindingI4 {
+  stream.executable.export public @dispatch
+  builtin.module {
+    func.func @dispatch(%arg0: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      // CHECK: %[[BINDING:.+]] = stream.binding.subspan {{.+}} -> !flow.dispatch.tensor<readonly:tensor<8xi4>>
+      %binding = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<8xi4>>
+      // CHECK: %[[TILE:.+]] = flow.dispatch.tensor.load %[[BINDING]], {{.+}} -> tensor<8xi4>
+      // CHECK-NOT: arith.trunci
+      %tile = flow.dispatch.tensor.load %binding, offsets = [0], sizes = [8], strides = [1] : !flow.dispatch.tensor<readonly:tensor<8xi4>> -> tensor<8xi4>
+      // CHECK: util.optimization_barrier %[[TILE]]
+      util.optimization_barrier %tile : tensor<8xi4>
+      return
+    }
+  }
+}
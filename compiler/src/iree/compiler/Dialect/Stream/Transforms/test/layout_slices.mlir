@@ -29,6 +29,38 @@ func.func @layoutStatic() -> (index, index, index, index, index, index, index)
 
 // -----
 
+#layoutStaticBySizeConfig = #stream.resource_config<{
+  max_allocation_size = 1073741824,
+  min_buffer_offset_alignment = 16,
+  max_buffer_range = 1073741824,
+  min_buffer_range_alignment = 16,
+  index_bits = 32
+}>
+
+// Packing in lifetime order needs 272 bytes while packing the largest slices
+// first reaches the 224 byte peak live size at time 4.
+
+// CHECK-LABEL: @layoutStaticBySize
+func.func @layoutStaticBySize() -> (index, index, index, index, index, index)
+    attributes {stream.resources = #layoutStaticBySizeConfig} {
+  %c16 = arith.constant 16 : index
+  %c48 = arith.constant 48 : index
+  %c64 = arith.constant 64 : index
+  %c96 = arith.constant 96 : index
+  %t:6 = stream.resource.pack slices({
+    [0, 3] = %c48,  // +0
+    [3, 5] = %c16,  // +208 (after [3, 6])
+    [3, 6] = %c48,  // +160 (after [4, 6])
+    [4, 5] = %c96,  // +0 (reuse [0, 3])
+    [4, 6] = %c64,  // +96 (after [4, 5])
+  }) : index
+  // CHECK: return %c224
+  // CHECK-SAME: %c0, %c208, %c160, %c0, %c96
+  return %t#0, %t#1, %t#2, %t#3, %t#4, %t#5 : index, index, index, index, index, index
+}
+
+// -----
+
 #layoutDynamicConfig = #stream.resource_config<{
   max_allocation_size = 1073741824,
   min_buffer_offset_alignment = 16,
@@ -0,0 +1,52 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-stream-prefetch-transfers))" %s | FileCheck %s
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-stream-prefetch-transfers{max-prefetch-memory=128}))" %s | FileCheck %s --check-prefix=BUDGET
+
+// Tests that transfers of resources available at function entry are hoisted
+// above the work preceding their use so they can overlap with it. Transfers
+// keep their relative order.
+
+// CHECK-LABEL: @hoistTransfers
+// BUDGET-LABEL: @hoistTransfers
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>, %[[WEIGHT0:.+]]: !stream.resource<staging>, %[[WEIGHT1:.+]]: !stream.resource<staging>)
+func.func @hoistTransfers(%arg0: !stream.resource<external>, %weight0: !stream.resource<staging>, %weight1: !stream.resource<staging>) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  %c128 = arith.constant 128 : index
+  // CHECK: %[[UPLOAD0:.+]] = stream.async.transfer %[[WEIGHT0]]
+  // CHECK: %[[UPLOAD1:.+]] = stream.async.transfer %[[WEIGHT1]]
+  // CHECK-NEXT: %[[DISPATCH0:.+]] = stream.async.dispatch @ex::@dispatch_0
+  // With a budget the second transfer can only be hoisted until the bytes of
+  // both transfers would be live at the same time.
+  // BUDGET: stream.async.transfer
+  // BUDGET: stream.async.dispatch @ex::@dispatch_0
+  // BUDGET-NEXT: stream.async.transfer
+  // BUDGET-NEXT: stream.async.dispatch @ex::@dispatch_1
+  %0 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}) -> !stream.resource<transient>{%c64}
+  %1 = stream.async.transfer %weight0 : !stream.resource<staging>{%c64} -> !stream.resource<constant>{%c64}
+  // CHECK-NEXT: %[[DISPATCH1:.+]] = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%[[DISPATCH0]][{{.+}}], %[[UPLOAD0]][{{.+}}])
+  %2 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%0[%c0 to %c64 for %c64], %1[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}, !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64}
+  %3 = stream.async.transfer %weight1 : !stream.resource<staging>{%c128} -> !stream.resource<constant>{%c128}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%[[DISPATCH1]][{{.+}}], %[[UPLOAD1]][{{.+}}])
+  %4 = stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%2[%c0 to %c64 for %c64], %3[%c0 to %c128 for %c128]) : (!stream.resource<transient>{%c64}, !stream.resource<constant>{%c128}) -> !stream.resource<external>{%c64}
+  return %4 : !stream.resource<external>
+}
+
+// -----
+
+// Tests that transfers are not hoisted above the producers of their operands.
+
+// CHECK-LABEL: @hoistToProducer
+func.func @hoistToProducer(%arg0: !stream.resource<external>) -> !stream.resource<staging> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  // CHECK: %[[DISPATCH0:.+]] = stream.async.dispatch @ex::@dispatch_0
+  %0 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK-NEXT: %[[READBACK:.+]] = stream.async.transfer %[[DISPATCH0]]
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+  %1 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}) -> !stream.resource<external>{%c64}
+  %2 = stream.async.transfer %0 : !stream.resource<transient>{%c64} -> !stream.resource<staging>{%c64}
+  // CHECK: return %[[READBACK]]
+  return %2 : !stream.resource<staging>
+}
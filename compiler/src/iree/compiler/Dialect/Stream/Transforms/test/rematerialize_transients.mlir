@@ -0,0 +1,51 @@
+// RUN: iree-opt --split-input-file --verify-diagnostics --pass-pipeline="builtin.module(func.func(iree-stream-rematerialize-transients{max-transient-memory=2560}))" %s | FileCheck %s
+
+// Tests that a splat live across the peak is rematerialized at each of its
+// users so that the estimated peak fits within the budget.
+
+// CHECK-LABEL: @rematerializeSplat
+func.func @rematerializeSplat() -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c512 = arith.constant 512 : index
+  %c1024 = arith.constant 1024 : index
+  %c0_i32 = arith.constant 0 : i32
+  // CHECK: stream.async.execute
+  %results, %result_timepoint = stream.async.execute with() -> !stream.resource<external>{%c512} {
+    // CHECK-NEXT: %[[SPLAT0:.+]] = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    %0 = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: %[[DISPATCH0:.+]] = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%[[SPLAT0]][{{.+}}])
+    %1 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%0[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}) -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: %[[DISPATCH1:.+]] = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%[[DISPATCH0]][{{.+}}])
+    %2 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%1[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}) -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: %[[SPLAT1:.+]] = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: %[[DISPATCH2:.+]] = stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%[[DISPATCH1]][{{.+}}], %[[SPLAT1]][{{.+}}])
+    %3 = stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%2[%c0 to %c1024 for %c1024], %0[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}, !stream.resource<transient>{%c1024}) -> !stream.resource<external>{%c512}
+    // CHECK-NEXT: stream.yield %[[DISPATCH2]]
+    stream.yield %3 : !stream.resource<external>{%c512}
+  } => !stream.timepoint
+  %4 = stream.timepoint.await %result_timepoint => %results : !stream.resource<external>{%c512}
+  return %4 : !stream.resource<external>
+}
+
+// -----
+
+// Tests that a warning is emitted when the estimate cannot be reduced below
+// the budget.
+
+// CHECK-LABEL: @overBudget
+func.func @overBudget() -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c1024 = arith.constant 1024 : index
+  %c2048 = arith.constant 2048 : index
+  %c0_i32 = arith.constant 0 : i32
+  // expected-warning @+1 {{estimated peak transient memory of 3072 bytes exceeds the budget of 2560 bytes}}
+  %results, %result_timepoint = stream.async.execute with() -> !stream.resource<external>{%c2048} {
+    %0 = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    %1 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%0[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}) -> !stream.resource<external>{%c2048}
+    stream.yield %1 : !stream.resource<external>{%c2048}
+  } => !stream.timepoint
+  %2 = stream.timepoint.await %result_timepoint => %results : !stream.resource<external>{%c2048}
+  return %2 : !stream.resource<external>
+}
@@ -0,0 +1,34 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-stream-schedule-concurrency{partitioning-algorithm=cost-model max-concurrent-memory=2048}))" %s | FileCheck %s
+
+// Tests that the cost model splits waves that would produce more new resources
+// than the concurrent memory budget allows. All three splats are independent
+// and would be placed into a single wave by the reference algorithm.
+
+// CHECK-LABEL: @partitioningWithMemoryBudget
+func.func @partitioningWithMemoryBudget() -> !stream.resource<external>
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  %c1024 = arith.constant 1024 : index
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c2_i32 = arith.constant 2 : i32
+  // CHECK: stream.async.execute
+  %results, %result_timepoint = stream.async.execute with() -> !stream.resource<external>{%c20} {
+    // CHECK-DAG: %[[SPLAT0:.+]] = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK-DAG: %[[CON:.+]]:2 = stream.async.concurrent with()
+    // CHECK-SAME: -> (!stream.resource<transient>{%c1024}, !stream.resource<transient>{%c1024}) {
+    // CHECK-NEXT: %[[SPLAT1:.+]] = stream.async.splat %c1_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: %[[SPLAT2:.+]] = stream.async.splat %c2_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK-NEXT: stream.yield %[[SPLAT1]], %[[SPLAT2]]
+    %0 = stream.async.splat %c0_i32 : i32 -> !stream.resource<transient>{%c1024}
+    %1 = stream.async.splat %c1_i32 : i32 -> !stream.resource<transient>{%c1024}
+    %2 = stream.async.splat %c2_i32 : i32 -> !stream.resource<transient>{%c1024}
+    // CHECK: stream.async.dispatch @ex::@dispatch[%c1, %c1, %c1](%[[SPLAT0]][{{.+}}], %[[CON]]#0[{{.+}}], %[[CON]]#1[{{.+}}])
+    %3 = stream.async.dispatch @ex::@dispatch[%c1, %c1, %c1](%0[%c0 to %c1024 for %c1024], %1[%c0 to %c1024 for %c1024], %2[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}, !stream.resource<transient>{%c1024}, !stream.resource<transient>{%c1024}) -> !stream.resource<external>{%c20}
+    stream.yield %3 : !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %4 = stream.timepoint.await %result_timepoint => %results : !stream.resource<external>{%c20}
+  return %4 : !stream.resource<external>
+}
@@ -466,6 +466,24 @@ TraversalResult Explorer::walkReturnOperands(Operation *parentOp,
   });
 }
 
+TraversalResult Explorer::walkRegionBypassOperands(
+    RegionBranchOpInterface regionOp, unsigned resultIdx,
+    std::function<WalkResult(Value operand)> fn) {
+  SmallVector<RegionSuccessor, 2> entrySuccessors;
+  regionOp.getSuccessorRegions(/*index=*/std::nullopt, entrySuccessors);
+  for (auto &entrySuccessor : entrySuccessors) {
+    if (!entrySuccessor.isParent()) continue;
+    auto successorInputs = entrySuccessor.getSuccessorInputs();
+    auto it = llvm::find(successorInputs, regionOp->getResult(resultIdx));
+    if (it == successorInputs.end()) continue;
+    unsigned idx = std::distance(successorInputs.begin(), it);
+    auto operands = regionOp.getSuccessorEntryOperands(std::nullopt);
+    if (idx >= operands.size()) continue;
+    if (fn(operands[idx]).wasInterrupted()) break;
+  }
+  return TraversalResult::COMPLETE;
+}
+
 TraversalResult Explorer::walkIncomingBranchOperands(
     Block *targetBlock,
     std::function<WalkResult(Block *sourceBlock, OperandRange operands)> fn) {
@@ -479,6 +497,8 @@ TraversalResult Explorer::walkIncomingBranchOperands(
       SmallVector<RegionSuccessor, 2> entrySuccessors;
       regionOp.getSuccessorRegions(/*index=*/std::nullopt, entrySuccessors);
       for (auto &entrySuccessor : entrySuccessors) {
+        // Parent successors bypass the regions (zero-trip loops/etc).
+        if (entrySuccessor.isParent()) continue;
         if (fn(regionOp->getBlock(),
                regionOp.getSuccessorEntryOperands(
                    entrySuccessor.getSuccessor()->getRegionNumber()))
@@ -524,6 +544,16 @@ TraversalResult Explorer::walkIncomingBranchOperands(
 TraversalResult Explorer::walkIncomingBlockArgument(
     BlockArgument blockArg,
     std::function<WalkResult(Block *sourceBlock, Value operand)> fn) {
+  // Region entry blocks may have arguments that don't map 1:1 with the entry
+  // operands (such as scf.for induction variables) and may be reached from
+  // terminators within the op itself (such as scf.yield back-edges).
+  auto *targetBlock = blockArg.getParentBlock();
+  if (targetBlock->isEntryBlock()) {
+    if (auto regionOp =
+            dyn_cast<RegionBranchOpInterface>(targetBlock->getParentOp())) {
+      return walkIncomingRegionArgument(regionOp, blockArg, fn);
+    }
+  }
   return walkIncomingBranchOperands(
       blockArg.getParentBlock(),
       [&](Block *sourceBlock, OperandRange operands) {
@@ -531,6 +561,72 @@ TraversalResult Explorer::walkIncomingBlockArgument(
       });
 }
 
+TraversalResult Explorer::walkIncomingRegionArgument(
+    RegionBranchOpInterface regionOp, BlockArgument blockArg,
+    std::function<WalkResult(Block *sourceBlock, Value operand)> fn) {
+  TraversalResult result = TraversalResult::COMPLETE;
+  auto *targetRegion = blockArg.getParentRegion();
+
+  // Finds the operand in |operands| that flows into |blockArg| along the edge
+  // to |successor|, if the edge targets the region containing the argument.
+  // Returns false if the argument is not fed by the edge operands (like
+  // induction variables) and the traversal cannot be completed.
+  auto walkSuccessor = [&](const RegionSuccessor &successor, Block *sourceBlock,
+                           OperandRange operands) {
+    if (successor.getSuccessor() != targetRegion) return WalkResult::advance();
+    auto successorInputs = successor.getSuccessorInputs();
+    auto it = llvm::find(successorInputs, blockArg);
+    if (it == successorInputs.end()) {
+      LLVM_DEBUG(llvm::dbgs()
+                 << "  !! traversal incomplete due to region argument not "
+                    "provided by successor operands\n");
+      result |= TraversalResult::INCOMPLETE;
+      return WalkResult::interrupt();
+    }
+    unsigned idx = std::distance(successorInputs.begin(), it);
+    if (idx >= operands.size()) {
+      result |= TraversalResult::INCOMPLETE;
+      return WalkResult::interrupt();
+    }
+    return fn(sourceBlock, operands[idx]);
+  };
+
+  // Walk the edge from the parent op into the region.
+  SmallVector<RegionSuccessor, 2> entrySuccessors;
+  regionOp.getSuccessorRegions(/*index=*/std::nullopt, entrySuccessors);
+  for (auto &entrySuccessor : entrySuccessors) {
+    if (entrySuccessor.isParent()) continue;
+    auto operands = regionOp.getSuccessorEntryOperands(
+        entrySuccessor.getSuccessor()->getRegionNumber());
+    if (walkSuccessor(entrySuccessor, regionOp->getBlock(), operands)
+            .wasInterrupted()) {
+      return result;
+    }
+  }
+
+  // Walk all edges from terminators of sibling (or the same) regions that
+  // branch into the region, such as loop back-edges.
+  for (auto &region : regionOp->getRegions()) {
+    SmallVector<RegionSuccessor, 2> successors;
+    regionOp.getSuccessorRegions(region.getRegionNumber(), successors);
+    for (auto &successor : successors) {
+      if (successor.isParent()) continue;
+      for (auto &block : region) {
+        auto terminatorOp =
+            dyn_cast<RegionBranchTerminatorOpInterface>(block.getTerminator());
+        if (!terminatorOp) continue;
+        auto operands = terminatorOp.getSuccessorOperands(
+            successor.getSuccessor()->getRegionNumber());
+        if (walkSuccessor(successor, &block, operands).wasInterrupted()) {
+          return result;
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
 TraversalResult Explorer::walkOutgoingBranchArguments(
     Block *sourceBlock,
     std::function<WalkResult(Block *targetBlock, Block::BlockArgListType args)>
@@ -594,10 +690,8 @@ TraversalResult Explorer::walkDefiningOps(Value value, ResultWalkFn fn) {
 
   // Move from a block argument to all predecessors.
   auto traverseBlockArg = [&](BlockArgument arg) {
-    auto *targetBlock = arg.getParentBlock();
-    return walkIncomingBranchOperands(
-        targetBlock, [&](Block *sourceBlock, OperandRange operands) {
-          auto branchOperand = operands[arg.getArgNumber()];
+    return walkIncomingBlockArgument(
+        arg, [&](Block *sourceBlock, Value branchOperand) {
           LLVM_DEBUG({
             llvm::dbgs() << "   + queuing ";
             sourceBlock->printAsOperand(llvm::dbgs(), asmState);
@@ -690,6 +784,16 @@ TraversalResult Explorer::walkDefiningOps(Value value, ResultWalkFn fn) {
     }
     LLVM_DEBUG(llvm::dbgs() << "  -> traversing into region op "
                             << regionOp->getName().getStringRef() << "\n");
+    // Operands may bypass the regions entirely (zero-trip loops).
+    walkRegionBypassOperands(regionOp, idx, [&](Value bypassOperand) {
+      LLVM_DEBUG({
+        llvm::dbgs() << "   + queuing region bypass operand ";
+        bypassOperand.printAsOperand(llvm::dbgs(), asmState);
+        llvm::dbgs() << "\n";
+      });
+      worklist.insert(bypassOperand);
+      return WalkResult::advance();
+    });
     return walkReturnOperands(
         regionOp.getOperation(), [&](OperandRange returnOperands) {
           auto returnOperand = returnOperands[idx];
@@ -15,6 +15,7 @@
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/ControlFlowInterfaces.h"
 #include "mlir/Pass/AnalysisManager.h"
 #include "mlir/Support/LLVM.h"
 
@@ -229,6 +230,13 @@ class Explorer {
   TraversalResult walkReturnOperands(Operation *parentOp,
                                      OperandRangeWalkFn fn);
 
+  // Walks all operands of |regionOp| that flow directly into result
+  // |resultIdx| without entering any region. An example is the initial value
+  // of an scf.for iter_arg when the loop runs zero times.
+  TraversalResult walkRegionBypassOperands(
+      RegionBranchOpInterface regionOp, unsigned resultIdx,
+      std::function<WalkResult(Value operand)> fn);
+
   // Walks all predecessor blocks of |targetBlock| and provides the operands
   // passed to them along the incoming edge. Note that |targetBlock| may be
   // enumerated if there is recursion.
@@ -241,6 +249,14 @@ class Explorer {
       BlockArgument blockArg,
       std::function<WalkResult(Block *sourceBlock, Value operand)> fn);
 
+  // Walks all incoming edges of the region branch op |regionOp| providing
+  // values for the region entry block argument |blockArg|. This includes both
+  // the entry from the parent op and branches from nested region terminators
+  // (such as loop back-edges).
+  TraversalResult walkIncomingRegionArgument(
+      RegionBranchOpInterface regionOp, BlockArgument blockArg,
+      std::function<WalkResult(Block *sourceBlock, Value operand)> fn);
+
   // Walks all successor blocks of |sourceBlock| and provides their arguments.
   // Note that |sourceBlock| may be enumerated if there is recursion.
   TraversalResult walkOutgoingBranchArguments(
@@ -146,6 +146,16 @@ struct RegisterUsage {
     }
   }
 
+  // Returns true if |reg| is entirely unused.
+  bool isRegisterAvailable(Register reg) {
+    if (reg.isRef()) return !refRegisters.test(reg.ordinal());
+    for (unsigned int ordinal = reg.ordinal();
+         ordinal < reg.ordinal() + reg.byteWidth() / 4; ++ordinal) {
+      if (intRegisters.test(ordinal)) return false;
+    }
+    return true;
+  }
+
   void markRegisterUsed(Register reg) {
     int ordinalStart = reg.ordinal();
     if (reg.isRef()) {
@@ -211,6 +221,10 @@ static SmallVector<Block *, 8> sortBlocksInDominanceOrder(
 // ensure we are avoiding as many moves as possible. The special case we need to
 // handle is when values are not defined within the current block (as values in
 // dominators are allowed to cross block boundaries outside of arguments).
+//
+// Block arguments are coalesced with the registers of the values forwarded to
+// them when possible (see getBlockArgHints) so that the most common branches
+// (loop back-edges and single-predecessor blocks) need no register copies.
 LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
   map_.clear();
 
@@ -239,6 +253,18 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
 
     // Allocate arguments first from left-to-right.
     for (auto blockArg : block->getArguments()) {
+      // Coalesce with the register of a value forwarded to the argument from
+      // an already allocated predecessor if it is free on entry. The branch
+      // from that predecessor then needs no copy for the argument.
+      auto hints = getBlockArgHints(blockArg);
+      auto hintIt = llvm::find_if(hints, [&](Register hint) {
+        return registerUsage.isRegisterAvailable(hint);
+      });
+      if (hintIt != hints.end()) {
+        registerUsage.markRegisterUsed(*hintIt);
+        map_[blockArg] = *hintIt;
+        continue;
+      }
       auto reg = registerUsage.allocateRegister(blockArg.getType());
       if (!reg.has_value()) {
         return funcOp.emitError() << "register allocation failed for block arg "
@@ -295,6 +321,22 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
   return success();
 }
 
+SmallVector<Register> RegisterAllocation::getBlockArgHints(
+    BlockArgument blockArg) {
+  SmallVector<Register> hints;
+  Block *block = blockArg.getOwner();
+  for (auto it = block->pred_begin(); it != block->pred_end(); ++it) {
+    auto branchOp = dyn_cast<BranchOpInterface>((*it)->getTerminator());
+    if (!branchOp) continue;
+    auto operands = branchOp.getSuccessorOperands(it.getSuccessorIndex())
+                        .getForwardedOperands();
+    if (blockArg.getArgNumber() >= operands.size()) continue;
+    auto regIt = map_.find(operands[blockArg.getArgNumber()]);
+    if (regIt != map_.end()) hints.push_back(regIt->second.asBaseRegister());
+  }
+  return hints;
+}
+
 Register RegisterAllocation::mapToRegister(Value value) {
   auto it = map_.find(value);
   assert(it != map_.end());
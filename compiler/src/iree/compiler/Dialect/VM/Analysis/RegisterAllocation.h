@@ -211,6 +211,10 @@ class RegisterAllocation {
       Operation *op, int successorIndex);
 
  private:
+  // Returns the registers of the values forwarded to |blockArg| from its
+  // predecessors that have already been allocated in predecessor order.
+  SmallVector<Register> getBlockArgHints(BlockArgument blockArg);
+
   int maxI32RegisterOrdinal_ = -1;
   int maxRefRegisterOrdinal_ = -1;
   int scratchI32RegisterCount_ = 0;
@@ -351,14 +351,15 @@ std::optional<Value> createVmTypeDefPtr(
 /// Move multiple refs from one set of variables to another set. As these two
 /// sets may alias we move the source variables into temporaries first.
 /// The generated code works as follows:
-/// `isMove` == true:
+/// `isMove(src_i)` == true:
 ///    move(src_i, tmp_i); for all i
 ///    move(tmp_i, dest_i); for all i
-/// `isMove` == false:
+/// `isMove(src_i)` == false:
 ///    retain(src_i, tmp_i); for all i
 ///    assign(tmp_i, dest_i); for all i
 LogicalResult retainOrMoveRefs(OpBuilder &builder, Location location,
-                               IRMapping mapping, bool isMove) {
+                               IRMapping mapping,
+                               llvm::function_ref<bool(Value)> isMove) {
   auto ctx = builder.getContext();
 
   IRMapping tmpMapping;
@@ -375,7 +376,8 @@ LogicalResult retainOrMoveRefs(OpBuilder &builder, Location location,
       return failure();
     }
 
-    StringRef callee = isMove ? "iree_vm_ref_move" : "iree_vm_ref_retain";
+    StringRef callee =
+        isMove(srcRef) ? "iree_vm_ref_move" : "iree_vm_ref_retain";
     builder.create<emitc::CallOp>(
         /*location=*/location,
         /*type=*/TypeRange{},
@@ -390,7 +392,8 @@ LogicalResult retainOrMoveRefs(OpBuilder &builder, Location location,
   for (const auto &[srcRef, destRef] : mapping.getValueMap()) {
     Value tmpRef = tmpMapping.lookup(srcRef);
 
-    StringRef callee = isMove ? "iree_vm_ref_move" : "iree_vm_ref_assign";
+    StringRef callee =
+        isMove(srcRef) ? "iree_vm_ref_move" : "iree_vm_ref_assign";
 
     builder.create<emitc::CallOp>(
         /*location=*/location,
@@ -404,6 +407,12 @@ LogicalResult retainOrMoveRefs(OpBuilder &builder, Location location,
   return success();
 }
 
+LogicalResult retainOrMoveRefs(OpBuilder &builder, Location location,
+                               IRMapping mapping, bool isMove) {
+  return retainOrMoveRefs(builder, location, mapping,
+                          [&](Value) { return isMove; });
+}
+
 /// Releases refs which are local to the function as well as ref arguments.
 void releaseRefs(OpBuilder &builder, Location location,
                  mlir::func::FuncOp funcOp,
@@ -2649,8 +2658,8 @@ class CompareRefOpConversion : public OpConversionPattern<CmpOpTy> {
       emitc_builders::ireeVmRefRelease(rewriter, loc, refLhs.value());
     }
 
-    // NOTE: If lhs and rhs alias we call release twice on the same
-    // argument.
+    // NOTE: Aliasing lhs and rhs operands are never moved so the ref is not
+    // released twice.
     if (moveRhs) {
       emitc_builders::ireeVmRefRelease(rewriter, loc, refRhs.value());
     }
@@ -2889,6 +2898,7 @@ class BranchOpConversion : public OpConversionPattern<IREE::VM::BranchOp> {
       destDispatch = rewriter.createBlock(dest);
 
       IRMapping refMapping;
+      DenseSet<Value> movedRefs;
       for (auto [operand, blockArg] :
            llvm::zip_equal(op.getOperands(), dest->getArguments())) {
         if (isNotRefOperand(operand)) {
@@ -2911,9 +2921,13 @@ class BranchOpConversion : public OpConversionPattern<IREE::VM::BranchOp> {
         }
 
         refMapping.map(operandRef.value(), blockArgRef.value());
+        if (vmAnalysis.value().get().isMove(operand, op.getOperation())) {
+          movedRefs.insert(operandRef.value());
+        }
       }
-      if (failed(retainOrMoveRefs(rewriter, loc, refMapping,
-                                  /*isMove=*/false))) {
+      if (failed(retainOrMoveRefs(
+              rewriter, loc, refMapping,
+              [&](Value ref) { return movedRefs.contains(ref); }))) {
         return op.emitError() << "moving of multiple refs failed";
       }
       rewriter.create<mlir::cf::BranchOp>(loc, op.getDest(), nonRefOperands);
@@ -4703,6 +4717,12 @@ class ConvertVMToEmitCPass
  public:
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(ConvertVMToEmitCPass)
 
+  ConvertVMToEmitCPass() = default;
+  ConvertVMToEmitCPass(const ConvertVMToEmitCPass &pass) {}
+  explicit ConvertVMToEmitCPass(bool elideRefRetains) {
+    this->elideRefRetains = elideRefRetains;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<mlir::emitc::EmitCDialect, mlir::BuiltinDialect,
                     mlir::func::FuncDialect, IREE::Util::UtilDialect>();
@@ -4730,7 +4750,7 @@ class ConvertVMToEmitCPass
     for (auto funcOp : module.getOps<IREE::VM::FuncOp>()) {
       Operation *op = funcOp.getOperation();
       typeConverter.analysisCache.insert(
-          std::make_pair(op, VMAnalysis(funcOp)));
+          std::make_pair(op, VMAnalysis(funcOp, elideRefRetains)));
 
       if (failed(convertFuncOp(funcOp, typeConverter, blockArgsToRemove))) {
         return signalPassFailure();
@@ -4803,13 +4823,20 @@ class ConvertVMToEmitCPass
       }
     });
   }
+
+ private:
+  Option<bool> elideRefRetains{
+      *this, "elide-ref-retains",
+      llvm::cl::desc("Moves refs on their last use instead of retaining them "
+                     "and releasing them when the function returns."),
+      llvm::cl::init(false)};
 };
 
 }  // namespace
 
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
-createConvertVMToEmitCPass() {
-  return std::make_unique<ConvertVMToEmitCPass>();
+createConvertVMToEmitCPass(bool elideRefRetains) {
+  return std::make_unique<ConvertVMToEmitCPass>(elideRefRetains);
 }
 
 }  // namespace VM
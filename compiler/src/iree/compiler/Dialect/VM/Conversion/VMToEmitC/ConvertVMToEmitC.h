@@ -22,7 +22,10 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
 namespace IREE {
 namespace VM {
 
-std::unique_ptr<OperationPass<IREE::VM::ModuleOp>> createConvertVMToEmitCPass();
+// Converts VM ops to EmitC. If |elideRefRetains| is set refs are moved on
+// their last use instead of being retained.
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>> createConvertVMToEmitCPass(
+    bool elideRefRetains = false);
 
 }  // namespace VM
 }  // namespace IREE
@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/Analysis/ValueLiveness.h"
 #include "iree/compiler/Dialect/VM/IR/VMTypes.h"
+#include "llvm/ADT/DenseSet.h"
 #include "mlir/Dialect/EmitC/IR/EmitC.h"
 
 namespace mlir {
@@ -18,11 +19,14 @@ namespace iree_compiler {
 struct VMAnalysis {
  public:
   VMAnalysis() = default;
-  VMAnalysis(IREE::VM::FuncOp &funcOp) {
+  VMAnalysis(IREE::VM::FuncOp &funcOp, bool elideRefRetains = false) {
     Operation *op = funcOp.getOperation();
     registerAllocation = RegisterAllocation(op);
     valueLiveness = ValueLiveness(op);
     originalFunctionType = funcOp.getFunctionType();
+    if (elideRefRetains) {
+      cacheRefMoves(funcOp);
+    }
   }
   VMAnalysis(FunctionType functionType) { originalFunctionType = functionType; }
 
@@ -51,10 +55,25 @@ struct VMAnalysis {
     return registerAllocation.mapToRegister(ref).ordinal();
   }
 
+  // Returns true if |op| has the last use of |ref| and may move it out of its
+  // register instead of retaining it. Refs used by more than one operand of
+  // |op| are conservatively retained.
   bool isMove(Value ref, Operation *op) {
     assert(ref.getType().isa<IREE::VM::RefType>());
-    bool lastUse = valueLiveness.isLastValueUse(ref, op);
-    return lastUse && false;
+    std::optional<unsigned> operandIndex;
+    for (OpOperand &operand : op->getOpOperands()) {
+      if (operand.get() != ref) continue;
+      if (operandIndex.has_value()) return false;
+      operandIndex = operand.getOperandNumber();
+    }
+    return operandIndex.has_value() && isMove(ref, op, *operandIndex);
+  }
+
+  // Returns true if the operand of |op| at |operandIndex| is the last use of
+  // |ref| and may move it out of its register instead of retaining it.
+  bool isMove(Value ref, Operation *op, unsigned operandIndex) {
+    assert(ref.getType().isa<IREE::VM::RefType>());
+    return refMoves.contains({op, operandIndex});
   }
 
   void cacheLocalRef(int64_t ordinal, emitc::ApplyOp &applyOp) {
@@ -71,9 +90,25 @@ struct VMAnalysis {
   DenseMap<int64_t, Operation *> &localRefs() { return refs; }
 
  private:
+  // Records all ref operands that are the last use of their value.
+  // This must be computed on the original function as the conversion splits
+  // blocks (such as for error handling) which invalidates the block liveness.
+  void cacheRefMoves(IREE::VM::FuncOp &funcOp) {
+    funcOp.walk([&](Operation *op) {
+      for (OpOperand &operand : op->getOpOperands()) {
+        if (!operand.get().getType().isa<IREE::VM::RefType>()) continue;
+        if (valueLiveness.isLastValueUse(operand.get(), op,
+                                         operand.getOperandNumber())) {
+          refMoves.insert({op, operand.getOperandNumber()});
+        }
+      }
+    });
+  }
+
   RegisterAllocation registerAllocation;
   ValueLiveness valueLiveness;
   DenseMap<int64_t, Operation *> refs;
+  DenseSet<std::pair<Operation *, unsigned>> refMoves;
   FunctionType originalFunctionType;
 };
 
@@ -0,0 +1,50 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(vm.module(iree-vm-ordinal-allocation),vm.module(iree-convert-vm-to-emitc{elide-ref-retains=true}))" %s | FileCheck %s
+
+vm.module @my_module {
+  vm.global.ref private mutable @g0_mut : !vm.buffer
+
+  // CHECK-LABEL: @my_module_global_store_ref_move
+  vm.func @global_store_ref_move(%arg0 : !vm.buffer) {
+    // CHECK: %{{.+}} = emitc.call "iree_vm_ref_retain_or_move_checked"(%arg3, %{{.+}}, %{{.+}}) {args = [true, 0 : index, 1 : index, 2 : index]}
+    vm.global.store.ref %arg0, @g0_mut : !vm.buffer
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  vm.global.ref private mutable @g0_mut : !vm.buffer
+
+  // CHECK-LABEL: @my_module_global_store_ref_retain
+  vm.func @global_store_ref_retain(%arg0 : !vm.buffer) -> !vm.buffer {
+    // CHECK: %{{.+}} = emitc.call "iree_vm_ref_retain_or_move_checked"(%arg3, %{{.+}}, %{{.+}}) {args = [false, 0 : index, 1 : index, 2 : index]}
+    vm.global.store.ref %arg0, @g0_mut : !vm.buffer
+    vm.return %arg0 : !vm.buffer
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @my_module_list_set_ref_move
+  vm.func @list_set_ref_move(%arg0: !vm.list<!vm.ref<?>>, %arg1: i32, %arg2: !vm.buffer) {
+    // CHECK: %{{.+}} = emitc.call "iree_vm_list_set_ref_move"(%{{.+}}, %arg4, %arg5)
+    vm.list.set.ref %arg0, %arg1, %arg2 : (!vm.list<!vm.ref<?>>, i32, !vm.buffer)
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @my_module_branch_ref_move
+  vm.func @branch_ref_move(%arg0: !vm.buffer) -> !vm.buffer {
+    // CHECK: emitc.call "iree_vm_ref_move"
+    // CHECK: emitc.call "iree_vm_ref_move"
+    // CHECK-NOT: emitc.call "iree_vm_ref_retain"
+    vm.br ^bb1(%arg0 : !vm.buffer)
+  ^bb1(%0 : !vm.buffer):
+    vm.return %0 : !vm.buffer
+  }
+}
@@ -6,6 +6,8 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ArchiveWriter.h"
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/schemas/bytecode_module_def_json_printer.h"
 #include "llvm/Support/CRC.h"
@@ -23,6 +25,34 @@ namespace VM {
 // boundary.
 static constexpr unsigned kArchiveSegmentAlignment = 64;
 
+// Returns the length of the module FlatBuffer data (excluding its 4b length
+// prefix) padded such that the rodata that follows it starts on a boundary
+// satisfying |baseAlignment| when the data begins at |moduleOffset| in the
+// stream. The runtime locates the rodata base by aligning the end of the
+// FlatBuffer to kArchiveSegmentAlignment so the padding must be included in
+// the length prefix for larger alignments to be preserved. Declared files are
+// aligned relative to the rodata base and this ensures their absolute offsets
+// in the archive (and in memory when the archive is mapped) are aligned.
+static flatbuffers_uoffset_t computePaddedModuleLength(
+    uint64_t moduleOffset, uint64_t moduleLength, uint64_t baseAlignment) {
+  uint64_t dataOffset = moduleOffset + sizeof(flatbuffers_uoffset_t);
+  return static_cast<flatbuffers_uoffset_t>(
+      IREE::Util::align(dataOffset + moduleLength, baseAlignment) - dataOffset);
+}
+
+// Writes the serialized |moduleData| (including its length prefix) to |os|
+// with the length prefix replaced by |paddedModuleLength| and padding zeros.
+static void writePaddedModule(StringRef moduleData,
+                              flatbuffers_uoffset_t paddedModuleLength,
+                              llvm::raw_ostream &os) {
+  os.write(reinterpret_cast<char *>(&paddedModuleLength),
+           sizeof(flatbuffers_uoffset_t));
+  os.write(moduleData.data() + sizeof(flatbuffers_uoffset_t),
+           moduleData.size() - sizeof(flatbuffers_uoffset_t));
+  os.write_zeros(paddedModuleLength -
+                 (moduleData.size() - sizeof(flatbuffers_uoffset_t)));
+}
+
 //====---------------------------------------------------------------------===//
 // JSONArchiveWriter
 //====---------------------------------------------------------------------===//
@@ -72,6 +102,7 @@ ArchiveWriter::File FlatArchiveWriter::declareFile(
   file.fileName = std::move(fileName);
   file.relativeOffset = IREE::Util::align(tailFileOffset, fileAlignment);
   tailFileOffset = file.relativeOffset + fileLength;
+  maxFileAlignment = std::max(maxFileAlignment, fileAlignment);
   file.fileLength = fileLength;
   file.write = std::move(write);
   files.push_back(file);
@@ -79,13 +110,29 @@ ArchiveWriter::File FlatArchiveWriter::declareFile(
 }
 
 LogicalResult FlatArchiveWriter::flush(FlatbufferBuilder &fbb) {
-  // Write the FlatBuffer contents out.
-  if (failed(fbb.copyToStream(os))) {
-    return mlir::emitError(loc)
-           << "failed to copy FlatBuffer emitter contents to the output stream "
-              "- possibly out of memory or storage";
+  // Serialize the module FlatBuffer to a binary blob in memory so that we can
+  // pad it out such that the rodata base meets the alignment of all files.
+  std::string moduleData;
+  {
+    llvm::raw_string_ostream moduleStream(moduleData);
+    if (failed(fbb.copyToStream(moduleStream))) {
+      return mlir::emitError(loc)
+             << "failed to copy FlatBuffer emitter contents to memory - "
+                "possibly out of memory";
+    }
+    moduleStream.flush();
   }
 
+  // Write the FlatBuffer contents out.
+  uint64_t baseAlignment =
+      std::max<uint64_t>(kArchiveSegmentAlignment, maxFileAlignment);
+  writePaddedModule(moduleData,
+                    computePaddedModuleLength(
+                        os.tell(),
+                        moduleData.size() - sizeof(flatbuffers_uoffset_t),
+                        baseAlignment),
+                    os);
+
   // Pad out to the start of the external rodata segment.
   // This ensures we begin writing at an aligned offset; all relative offsets
   // in the embedded files assume this.
@@ -583,6 +630,7 @@ ArchiveWriter::File ZIPArchiveWriter::declareFile(
   uint64_t fileOffset =
       IREE::Util::align(headerOffset + headerLength, fileAlignment);
   tailFileOffset = fileOffset + fileLength;
+  maxFileAlignment = std::max(maxFileAlignment, fileAlignment);
 
   File file;
   file.fileName = std::move(fileName);
@@ -620,21 +668,20 @@ LogicalResult ZIPArchiveWriter::flush(FlatbufferBuilder &fbb) {
     moduleStream.flush();
   }
 
-  // Pad out the module data so we can easily compute the relative offsets.
-  auto paddedModuleLength = static_cast<flatbuffers_uoffset_t>(
-      IREE::Util::align(sizeof(flatbuffers_uoffset_t) + moduleData.size(),
-                        kArchiveSegmentAlignment) -
-      sizeof(flatbuffers_uoffset_t));
+  // Pad out the module data so we can easily compute the relative offsets and
+  // so that the rodata base is aligned to the maximum declared file alignment.
+  uint64_t baseAlignment =
+      std::max<uint64_t>(kArchiveSegmentAlignment, maxFileAlignment);
+  auto paddedModuleLength = computePaddedModuleLength(
+      startOffset + modulePadding,
+      moduleData.size() - sizeof(flatbuffers_uoffset_t), baseAlignment);
 
   // Stream out the FlatBuffer contents.
   auto zipFile = appendZIPFile(
-      moduleName, modulePadding, paddedModuleLength,
+      moduleName, modulePadding,
+      sizeof(flatbuffers_uoffset_t) + paddedModuleLength,
       [&](llvm::raw_ostream &os) -> LogicalResult {
-        os.write(reinterpret_cast<char *>(&paddedModuleLength),
-                 sizeof(flatbuffers_uoffset_t));
-        os.write(moduleData.data() + sizeof(flatbuffers_uoffset_t),
-                 moduleData.size() - sizeof(flatbuffers_uoffset_t));
-        os.write_zeros(paddedModuleLength - moduleData.size());
+        writePaddedModule(moduleData, paddedModuleLength, os);
         return success();
       },
       os);
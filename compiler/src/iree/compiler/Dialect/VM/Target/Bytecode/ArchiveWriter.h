@@ -83,7 +83,7 @@ class JSONArchiveWriter : public ArchiveWriter {
 // Archive structure:
 //   [4b flatbuffers_uoffset_t defining module FlatBuffer length]
 //   [module FlatBuffer contents]
-//   [zero padding to 64b alignment]
+//   [zero padding to 64b or the maximum declared file alignment]
 //   <<rodata base offset>>
 //   [declared file 0]
 //   [zero padding to 64b alignment]
@@ -103,6 +103,7 @@ class FlatArchiveWriter : public ArchiveWriter {
   Location loc;
   llvm::raw_ostream &os;
   uint64_t tailFileOffset = 0;  // unpadded
+  uint64_t maxFileAlignment = 1;
   SmallVector<File> files;
 };
 
@@ -116,7 +117,7 @@ class FlatArchiveWriter : public ArchiveWriter {
 //  - [zip local file header for module]
 //    [4b flatbuffers_uoffset_t defining module FlatBuffer length]
 //    [module FlatBuffer contents]
-//    [zero padding to 64b alignment]
+//    [zero padding to 64b or the maximum declared file alignment]
 //    <<rodata base offset>>
 //  - [zip local file header for file 0]
 //    [declared file 0 contents, aligned]
@@ -138,6 +139,7 @@ class ZIPArchiveWriter : public ArchiveWriter {
   Location loc;
   llvm::raw_ostream &os;
   uint64_t tailFileOffset = 0;  // unpadded
+  uint64_t maxFileAlignment = 1;
   SmallVector<File> files;
 };
 
@@ -6,11 +6,14 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeEncoder.h"
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMTypes.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 
@@ -27,8 +30,10 @@ namespace {
 class V0BytecodeEncoder : public BytecodeEncoder {
  public:
   V0BytecodeEncoder(llvm::DenseMap<Type, int> *typeTable,
-                    RegisterAllocation *registerAllocation)
-      : typeTable_(typeTable), registerAllocation_(registerAllocation) {}
+                    RegisterAllocation *registerAllocation, bool emitRefMoves)
+      : typeTable_(typeTable),
+        registerAllocation_(registerAllocation),
+        emitRefMoves_(emitRefMoves) {}
   ~V0BytecodeEncoder() = default;
 
   LogicalResult beginBlock(Block *block) override {
@@ -217,10 +222,7 @@ class V0BytecodeEncoder : public BytecodeEncoder {
   }
 
   LogicalResult encodeOperand(Value value, int ordinal) override {
-    uint16_t reg =
-        registerAllocation_->mapUseToRegister(value, currentOp_, ordinal)
-            .encode();
-    return writeUint16(reg);
+    return writeUint16(encodeUse(value, getOperandNumber(value, ordinal)));
   }
 
   LogicalResult encodeOperands(Operation::operand_range values) override {
@@ -229,9 +231,9 @@ class V0BytecodeEncoder : public BytecodeEncoder {
       return failure();
     }
     for (auto it : llvm::enumerate(values)) {
-      uint16_t reg = registerAllocation_
-                         ->mapUseToRegister(it.value(), currentOp_, it.index())
-                         .encode();
+      uint16_t reg = encodeUse(
+          it.value(), getOperandNumber(it.value(), values.getBeginOperandIndex() +
+                                                      it.index()));
       if (failed(writeUint16(reg))) {
         return failure();
       }
@@ -258,6 +260,27 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  // Encodes |cmpOp| and the |branchOp| consuming its result as a single fused
+  // |opcode| superinstruction. The comparison result is never materialized.
+  LogicalResult encodeCmpCondBranch(Operation *cmpOp, CondBranchOp branchOp,
+                                    Opcode opcode) {
+    currentOp_ = cmpOp;
+    if (failed(writeUint8(static_cast<uint8_t>(opcode))) ||
+        failed(encodeOperand(cmpOp->getOperand(0), 0)) ||
+        failed(encodeOperand(cmpOp->getOperand(1), 1))) {
+      return failure();
+    }
+    currentOp_ = branchOp;
+    if (failed(encodeBranch(branchOp.getTrueDest(),
+                            branchOp.getTrueOperands(), 0)) ||
+        failed(encodeBranch(branchOp.getFalseDest(),
+                            branchOp.getFalseOperands(), 1))) {
+      return failure();
+    }
+    currentOp_ = nullptr;
+    return success();
+  }
+
   std::optional<std::vector<uint8_t>> finish() {
     if (failed(fixupOffsets())) {
       return std::nullopt;
@@ -267,6 +290,43 @@ class V0BytecodeEncoder : public BytecodeEncoder {
 
   size_t getOffset() const { return bytecode_.size(); }
 
+  // True if any encoded op operand carries the ref move bit.
+  bool usesRefMoves() const { return usesRefMoves_; }
+
+  // Returns the operand number of |value| in the current op used to decide
+  // whether the use can move the value. |ordinal| is the position of the
+  // operand in the op encoding and need not match the operand number. Values
+  // used by multiple operands are never moved as the runtime may read the
+  // operands in any order.
+  unsigned getOperandNumber(Value value, int ordinal) {
+    std::optional<unsigned> operandNumber;
+    for (auto &operand : currentOp_->getOpOperands()) {
+      if (operand.get() != value) continue;
+      if (operandNumber.has_value()) {
+        // The first operand number is never the last use.
+        return *operandNumber;
+      }
+      operandNumber = operand.getOperandNumber();
+    }
+    return operandNumber.value_or(ordinal);
+  }
+
+  // Returns the encoded register of the use of |value| by the current op.
+  // The move bit is dropped when ref moves are disabled and otherwise recorded
+  // so that the module is stamped with a version whose runtime honors it.
+  uint16_t encodeUse(Value value, unsigned operandNumber) {
+    auto reg =
+        registerAllocation_->mapUseToRegister(value, currentOp_, operandNumber);
+    if (reg.isMove()) {
+      if (emitRefMoves_) {
+        usesRefMoves_ = true;
+      } else {
+        reg.setMove(false);
+      }
+    }
+    return reg.encode();
+  }
+
   LogicalResult ensureAlignment(size_t alignment) {
     size_t paddedSize = (bytecode_.size() + (alignment - 1)) & ~(alignment - 1);
     size_t padding = paddedSize - bytecode_.size();
@@ -332,6 +392,8 @@ class V0BytecodeEncoder : public BytecodeEncoder {
 
   llvm::DenseMap<Type, int> *typeTable_;
   RegisterAllocation *registerAllocation_;
+  bool emitRefMoves_ = true;
+  bool usesRefMoves_ = false;
 
   Operation *currentOp_ = nullptr;
 
@@ -340,12 +402,35 @@ class V0BytecodeEncoder : public BytecodeEncoder {
   std::vector<std::pair<Block *, size_t>> blockOffsetFixups_;
 };
 
+// Returns the fused superinstruction opcode for |op| and the |nextOp|
+// following it in the same block, if any.
+static std::optional<Opcode> matchCmpCondBranch(Operation &op,
+                                                Operation *nextOp) {
+  auto branchOp = dyn_cast_or_null<CondBranchOp>(nextOp);
+  if (!branchOp || op.getNumResults() != 1 ||
+      branchOp.getCondition() != op.getResult(0) ||
+      !op.getResult(0).hasOneUse()) {
+    return std::nullopt;
+  }
+  return llvm::TypeSwitch<Operation *, std::optional<Opcode>>(&op)
+      .Case([](CmpEQI32Op) { return Opcode::CmpEQI32CondBranch; })
+      .Case([](CmpNEI32Op) { return Opcode::CmpNEI32CondBranch; })
+      .Case([](CmpLTI32SOp) { return Opcode::CmpLTI32SCondBranch; })
+      .Case([](CmpLTI32UOp) { return Opcode::CmpLTI32UCondBranch; })
+      .Case([](CmpEQI64Op) { return Opcode::CmpEQI64CondBranch; })
+      .Case([](CmpNEI64Op) { return Opcode::CmpNEI64CondBranch; })
+      .Case([](CmpLTI64SOp) { return Opcode::CmpLTI64SCondBranch; })
+      .Case([](CmpLTI64UOp) { return Opcode::CmpLTI64UCondBranch; })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
 }  // namespace
 
 // static
 std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase) {
+    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+    bool emitSuperinstructions, bool emitRefMoves) {
   EncodedBytecodeFunction result;
 
   // Perform register allocation first so that we can quickly lookup values as
@@ -359,14 +444,15 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
   FunctionSourceMap sourceMap;
   sourceMap.localName = funcOp.getName().str();
 
-  V0BytecodeEncoder encoder(&typeTable, &registerAllocation);
+  V0BytecodeEncoder encoder(&typeTable, &registerAllocation, emitRefMoves);
   for (auto &block : funcOp.getBlocks()) {
     if (failed(encoder.beginBlock(&block))) {
       funcOp.emitError() << "failed to begin block";
       return std::nullopt;
     }
 
-    for (auto &op : block.getOperations()) {
+    for (auto it = block.begin(); it != block.end(); ++it) {
+      Operation &op = *it;
       auto serializableOp = dyn_cast<IREE::VM::VMSerializableOp>(op);
       if (!serializableOp) {
         op.emitOpError() << "is not serializable";
@@ -374,6 +460,25 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
       }
       sourceMap.locations.push_back(
           {static_cast<int32_t>(encoder.getOffset()), op.getLoc()});
+
+      // Fuse supported sequences into superinstructions. The fused ops must be
+      // adjacent so that no other op could observe the elided intermediates.
+      if (emitSuperinstructions && std::next(it) != block.end()) {
+        Operation *nextOp = &*std::next(it);
+        if (auto opcode = matchCmpCondBranch(op, nextOp)) {
+          if (failed(encoder.encodeCmpCondBranch(
+                  &op, cast<CondBranchOp>(nextOp), *opcode))) {
+            op.emitOpError() << "failed to encode fused superinstruction";
+            return std::nullopt;
+          }
+          result.requiredVersionMinor =
+              std::max(result.requiredVersionMinor,
+                       BytecodeEncoder::kVersionMinorSuperinstructions);
+          ++it;
+          continue;
+        }
+      }
+
       if (failed(encoder.beginOp(&op)) ||
           failed(serializableOp.encode(symbolTable, encoder)) ||
           failed(encoder.endOp(&op))) {
@@ -400,6 +505,10 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     funcOp.emitError() << "failed to fixup and finish encoding";
     return std::nullopt;
   }
+  if (encoder.usesRefMoves()) {
+    result.requiredVersionMinor = std::max(
+        result.requiredVersionMinor, BytecodeEncoder::kVersionMinorRefMoves);
+  }
   result.bytecodeData = bytecodeData.value();
   result.bytecodeLength = finalLength;
   result.blockCount = funcOp.getBlocks().size();
@@ -31,6 +31,9 @@ struct EncodedBytecodeFunction {
   uint16_t i32RegisterCount = 0;
   // Total vm.ref register slots required for execution.
   uint16_t refRegisterCount = 0;
+
+  // Minimum bytecode minor version required by the encoded function.
+  uint32_t requiredVersionMinor = 0;
 };
 
 // Abstract encoder used for function bytecode encoding.
@@ -39,14 +42,29 @@ class BytecodeEncoder : public VMFuncEncoder {
   // Matches IREE_VM_BYTECODE_VERSION_MAJOR.
   static constexpr uint32_t kVersionMajor = 15;
   // Matches IREE_VM_BYTECODE_VERSION_MINOR.
-  static constexpr uint32_t kVersionMinor = 0;
-  static constexpr uint32_t kVersion = (kVersionMajor << 16) | kVersionMinor;
+  // Modules are stamped with the lowest minor version that supports all of the
+  // features they use so that they remain loadable by older runtimes.
+  static constexpr uint32_t kVersionMinor = 2;
+  // Minor version adding the compare-and-branch superinstructions.
+  static constexpr uint32_t kVersionMinorSuperinstructions = 1;
+  // Minor version from which runtimes trust the move bit on ref operands.
+  // Older runtimes ignored the bit on op operands and always retained.
+  static constexpr uint32_t kVersionMinorRefMoves = 2;
+
+  // Returns the encoded bytecode version for the given |versionMinor|.
+  static constexpr uint32_t getVersion(uint32_t versionMinor) {
+    return (kVersionMajor << 16) | versionMinor;
+  }
 
   // Encodes a vm.func to bytecode and returns the result.
+  // When |emitSuperinstructions| is set common op sequences are fused into
+  // single superinstructions. When |emitRefMoves| is set ref operands on their
+  // last use carry the move bit so ops can steal the reference.
   // Returns None on failure.
   static std::optional<EncodedBytecodeFunction> encodeFunction(
       IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-      SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase);
+      SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+      bool emitSuperinstructions, bool emitRefMoves);
 
   BytecodeEncoder() = default;
   ~BytecodeEncoder() = default;
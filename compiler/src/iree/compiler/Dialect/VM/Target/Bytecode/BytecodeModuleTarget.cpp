@@ -7,6 +7,8 @@
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
 
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
@@ -57,6 +59,11 @@ using namespace llvm::support;
 // overridden by creators of the rodata with the `alignment` attribute.
 static constexpr int kDefaultRodataAlignment = 16;
 
+// External rodata without a mime type is constant data that the runtime will
+// try to import into device buffers directly from the mapped module file. Page
+// alignment allows devices to alias the pages of the file instead of copying.
+static constexpr uint64_t kExternalConstantRodataAlignment = 4096;
+
 // Anything over a few KB should be split out of the FlatBuffer.
 // This limit is rather arbitrary - we could support hundreds of MB of embedded
 // data at the risk of tripping the 31-bit FlatBuffer offset values.
@@ -71,6 +78,9 @@ struct RodataRef {
   uint64_t alignment = kDefaultRodataAlignment;
   // Total size of the serialized data in bytes.
   uint64_t totalSize = 0;
+  // True if the archive file contains the data compressed as an LZ4 block that
+  // expands to totalSize bytes.
+  bool lz4Compressed = false;
   // Optional reference to the rodata in the file.
   std::optional<ArchiveWriter::File> archiveFile;
 };
@@ -127,6 +137,90 @@ static flatbuffers_uint8_vec_ref_t serializeEmbeddedData(
   return flatbuffers_uint8_vec_end(fbb);
 }
 
+// Compresses |input| as a single LZ4 block.
+// This is a greedy compressor using a single-entry hash table of the most
+// recent position of each 4-byte sequence: it is fast and good at the highly
+// repetitive data common in constants (zero fill, splats, padding) but makes
+// no attempt to find optimal matches. The output honors the end-of-block
+// restrictions of the format: the last 5 bytes are always literals and the
+// last match starts at least 12 bytes before the end. See
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md.
+static std::vector<uint8_t> compressLZ4Block(ArrayRef<uint8_t> input) {
+  static constexpr size_t kMinMatch = 4;
+  static constexpr size_t kLastLiterals = 5;
+  static constexpr size_t kMatchFindLimit = 12;
+  static constexpr size_t kMaxOffset = 65535;
+  static constexpr unsigned kHashLog = 16;
+
+  std::vector<uint8_t> output;
+  output.reserve(input.size() + input.size() / 255 + 16);
+  auto writeExtendedLength = [&](size_t length) {
+    for (; length >= 255; length -= 255) output.push_back(255);
+    output.push_back(static_cast<uint8_t>(length));
+  };
+  // Emits the literals in [literalStart, literalEnd) followed by an optional
+  // match (omitted when matchLength is 0).
+  auto writeSequence = [&](size_t literalStart, size_t literalEnd,
+                           size_t matchOffset, size_t matchLength) {
+    size_t literalLength = literalEnd - literalStart;
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15))
+                    << 4;
+    if (matchLength) {
+      token |= static_cast<uint8_t>(
+          std::min<size_t>(matchLength - kMinMatch, 15));
+    }
+    output.push_back(token);
+    if (literalLength >= 15) writeExtendedLength(literalLength - 15);
+    output.insert(output.end(), input.begin() + literalStart,
+                  input.begin() + literalEnd);
+    if (!matchLength) return;
+    output.push_back(static_cast<uint8_t>(matchOffset & 0xFF));
+    output.push_back(static_cast<uint8_t>(matchOffset >> 8));
+    if (matchLength - kMinMatch >= 15) {
+      writeExtendedLength(matchLength - kMinMatch - 15);
+    }
+  };
+
+  size_t anchor = 0;
+  if (input.size() > kMatchFindLimit) {
+    auto read32 = [&](size_t pos) {
+      uint32_t value;
+      std::memcpy(&value, input.data() + pos, sizeof(value));
+      return value;
+    };
+    auto hash = [](uint32_t value) {
+      return (value * 2654435761u) >> (32 - kHashLog);
+    };
+    // Positions are biased by 1 so that 0 indicates an empty entry.
+    std::vector<size_t> table(1u << kHashLog, 0);
+    const size_t matchLimit = input.size() - kLastLiterals;
+    const size_t searchLimit = input.size() - kMatchFindLimit;
+    size_t pos = 0;
+    while (pos <= searchLimit) {
+      uint32_t sequence = read32(pos);
+      size_t &entry = table[hash(sequence)];
+      size_t candidate = entry;
+      entry = pos + 1;
+      if (!candidate || pos - (candidate - 1) > kMaxOffset ||
+          read32(candidate - 1) != sequence) {
+        ++pos;
+        continue;
+      }
+      size_t matchPos = candidate - 1;
+      size_t matchLength = kMinMatch;
+      while (pos + matchLength < matchLimit &&
+             input[matchPos + matchLength] == input[pos + matchLength]) {
+        ++matchLength;
+      }
+      writeSequence(anchor, pos, pos - matchPos, matchLength);
+      pos += matchLength;
+      anchor = pos;
+    }
+  }
+  writeSequence(anchor, input.size(), 0, 0);
+  return output;
+}
+
 // Canonicalizes the module to its final form prior to emission.
 // This verifies that we only have ops we can serialize and performs any of the
 // required transformations (such as debug op stripping).
@@ -347,15 +441,19 @@ static LogicalResult buildFlatBufferModule(
   bytecodeDataParts.resize(internalFuncOps.size());
   functionDescriptors.resize(internalFuncOps.size());
   iree_vm_FeatureBits_enum_t moduleRequirements = 0;
+  uint32_t moduleVersionMinor = 0;
   size_t totalBytecodeLength = 0;
   for (auto [i, funcOp] : llvm::enumerate(internalFuncOps)) {
     auto encodedFunction = BytecodeEncoder::encodeFunction(
-        funcOp, typeOrdinalMap, symbolTable, debugDatabase);
+        funcOp, typeOrdinalMap, symbolTable, debugDatabase,
+        bytecodeOptions.emitSuperinstructions, bytecodeOptions.emitRefMoves);
     if (!encodedFunction) {
       return funcOp.emitError() << "failed to encode function bytecode";
     }
     auto funcRequirements = findRequiredFeatures(funcOp);
     moduleRequirements |= funcRequirements;
+    moduleVersionMinor =
+        std::max(moduleVersionMinor, encodedFunction->requiredVersionMinor);
     iree_vm_FunctionDescriptor_assign(
         &functionDescriptors[i], totalBytecodeLength,
         encodedFunction->bytecodeLength, funcRequirements,
@@ -399,7 +497,16 @@ static LogicalResult buildFlatBufferModule(
   for (auto &rodataRef : llvm::reverse(rodataRefs)) {
     if (rodataRef.archiveFile.has_value()) {
       // Data is already in the file at a calculated offset.
+      iree_vm_CompressionTypeDef_union_ref_t compressionRef =
+          iree_vm_CompressionTypeDef_as_NONE();
+      if (rodataRef.lz4Compressed) {
+        compressionRef = iree_vm_CompressionTypeDef_as_LZ4BlockDataDef(
+            iree_vm_LZ4BlockDataDef_create(fbb, rodataRef.totalSize));
+      }
       iree_vm_RodataSegmentDef_start(fbb);
+      if (rodataRef.lz4Compressed) {
+        iree_vm_RodataSegmentDef_compression_type_add(fbb, compressionRef);
+      }
       iree_vm_RodataSegmentDef_external_data_offset_add(
           fbb, rodataRef.archiveFile->relativeOffset +
                    rodataRef.archiveFile->prefixLength);
@@ -542,8 +649,8 @@ static LogicalResult buildFlatBufferModule(
   iree_vm_BytecodeModuleDef_rwdata_segments_add(fbb, rwdataSegmentsRef);
   iree_vm_BytecodeModuleDef_function_descriptors_add(fbb,
                                                      functionDescriptorsRef);
-  iree_vm_BytecodeModuleDef_bytecode_version_add(fbb,
-                                                 BytecodeEncoder::kVersion);
+  iree_vm_BytecodeModuleDef_bytecode_version_add(
+      fbb, BytecodeEncoder::getVersion(moduleVersionMinor));
   iree_vm_BytecodeModuleDef_bytecode_data_add(fbb, bytecodeDataRef);
   iree_vm_BytecodeModuleDef_debug_database_add(fbb, debugDatabaseRef);
   iree_vm_BytecodeModuleDef_end_as_root(fbb);
@@ -645,7 +752,44 @@ LogicalResult translateModuleToBytecode(
     rodataRef.alignment =
         rodataOp.getAlignment().value_or(kDefaultRodataAlignment);
     rodataRef.totalSize = static_cast<uint64_t>(actualSize);
-    if (storeExternal) {
+    if (storeExternal && !rodataOp.getMimeType().has_value()) {
+      rodataRef.alignment =
+          std::max(rodataRef.alignment, kExternalConstantRodataAlignment);
+    }
+    // Constant data may be compressed when requested. The runtime expands it
+    // into host memory when the module is loaded and it is only kept if it
+    // actually saves space as compressed data cannot be aliased from the file.
+    std::shared_ptr<std::vector<uint8_t>> compressedData;
+    if (storeExternal && !rodataOp.getMimeType().has_value() &&
+        bytecodeOptions.rodataCompression == BytecodeRodataCompression::kLZ4) {
+      SmallVector<char> uncompressedData;
+      if (failed(rodataValue.serializeToVector(
+              llvm::support::endianness::little, uncompressedData))) {
+        return rodataOp.emitError() << "constant attribute failed to "
+                                       "serialize: unsupported format or "
+                                       "encoding";
+      }
+      auto lz4Data =
+          std::make_shared<std::vector<uint8_t>>(compressLZ4Block(
+              ArrayRef<uint8_t>(
+                  reinterpret_cast<const uint8_t *>(uncompressedData.data()),
+                  uncompressedData.size())));
+      if (lz4Data->size() < uncompressedData.size()) {
+        compressedData = std::move(lz4Data);
+        rodataRef.lz4Compressed = true;
+        rodataRef.alignment =
+            rodataOp.getAlignment().value_or(kDefaultRodataAlignment);
+      }
+    }
+    if (storeExternal && compressedData) {
+      rodataRef.archiveFile = archiveWriter->declareFile(
+          (rodataOp.getName() + ".lz4").str(), rodataRef.alignment,
+          compressedData->size(), [=](llvm::raw_ostream &os) {
+            os.write(reinterpret_cast<const char *>(compressedData->data()),
+                     compressedData->size());
+            return success();
+          });
+    } else if (storeExternal) {
       std::string fileName =
           (rodataOp.getName() +
            mimeTypeToFileExtension(rodataOp.getMimeType().value_or("")))
@@ -724,6 +868,27 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-vm-bytecode-module-strip-debug-ops", stripDebugOps,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips debug-only ops from the module"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-emit-superinstructions", emitSuperinstructions,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Fuses common op sequences into superinstructions to "
+                     "reduce interpreter dispatch overhead"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-emit-ref-moves", emitRefMoves,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Marks the last use of ref operands as moves so that ops "
+                     "can take ownership of the reference"));
+  binder.opt<BytecodeRodataCompression>(
+      "iree-vm-bytecode-module-rodata-compression", rodataCompression,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Compresses large constant rodata segments; they are "
+                     "decompressed into host memory when the module is "
+                     "loaded"),
+      llvm::cl::values(
+          clEnumValN(BytecodeRodataCompression::kNone, "none",
+                     "Stores rodata uncompressed"),
+          clEnumValN(BytecodeRodataCompression::kLZ4, "lz4",
+                     "Compresses rodata as LZ4 blocks")));
   binder.opt<bool>(
       "iree-vm-emit-polyglot-zip", emitPolyglotZip,
       llvm::cl::cat(vmBytecodeOptionsCategory),
@@ -33,6 +33,14 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Defines how external constant rodata segments are compressed.
+enum class BytecodeRodataCompression {
+  // Segments are stored uncompressed and can be mapped directly.
+  kNone,
+  // Segments are stored as LZ4 blocks when doing so reduces their size.
+  kLZ4,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -51,6 +59,24 @@ struct BytecodeTargetOptions {
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
 
+  // Fuses common op sequences (such as a comparison feeding a conditional
+  // branch) into single superinstructions to reduce interpreter dispatch
+  // overhead. Modules containing superinstructions require a runtime
+  // supporting bytecode version 15.1 or newer.
+  bool emitSuperinstructions = true;
+
+  // Sets the move bit on ref operands at their last use so that ops can take
+  // ownership of the reference instead of retaining it. Modules using moves
+  // require a runtime supporting bytecode version 15.2 or newer. Modules using
+  // neither moves nor superinstructions are stamped 15.0.
+  bool emitRefMoves = true;
+
+  // Compresses external constant rodata segments. Compressed segments are
+  // decompressed into host memory when the module is loaded and cannot be
+  // aliased directly from the mapped module file.
+  BytecodeRodataCompression rodataCompression =
+      BytecodeRodataCompression::kNone;
+
   // Enables the output .vmfb to be inspected as a ZIP file.
   // This is useful for debugging/diagnosing issues as embedded executables can
   // be extracted and inspected. It adds several KB to the output files and
@@ -0,0 +1,29 @@
+// RUN: iree-compile --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-binary \
+// RUN:   --iree-vm-emit-polyglot-zip=false %s -o %t.flat.vmfb && \
+// RUN: python3 %S/archive_alignment.py %t.flat.vmfb cdab3412 4096 | \
+// RUN: FileCheck %s
+// RUN: iree-compile --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-binary \
+// RUN:   --iree-vm-emit-polyglot-zip=true %s -o %t.zip.vmfb && \
+// RUN: python3 %S/archive_alignment.py %t.zip.vmfb cdab3412 4096 | \
+// RUN: FileCheck %s
+
+// External rodata without a mime type is page aligned so that devices can
+// alias it from the mapped module file. The module FlatBuffer length prefix
+// includes the padding needed for the rodata base (and with it every file) to
+// be page aligned in the archive and not only relative to the rodata base.
+
+// CHECK: module end % 4096 = 0{{$}}
+// CHECK: rodata base % 4096 = 0{{$}}
+// CHECK: file offset % 4096 = 0{{$}}
+vm.module @archive_alignment {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+  // Small enough to stay embedded in the FlatBuffer.
+  vm.rodata private @embedded dense<[1, 2, 3]> : tensor<3xi8>
+  // 0x1234ABCD repeated; large enough to be stored as an external file.
+  vm.rodata private @external dense<305441741> : tensor<2048xi32>
+}
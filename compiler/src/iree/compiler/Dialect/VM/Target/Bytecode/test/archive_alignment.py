@@ -0,0 +1,44 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Prints the alignment of the rodata base and of an embedded file.
+
+Usage: archive_alignment.py <module.vmfb> <hex byte pattern> <alignment>
+
+The rodata base is located the same way as the runtime does
+(iree_vm_bytecode_archive_parse_header): the end of the length-prefixed module
+FlatBuffer (after any polyglot zip local file header) aligned to 64 bytes. The
+embedded file is located by searching for a repeated byte pattern.
+"""
+
+import struct
+import sys
+
+SEGMENT_ALIGNMENT = 64
+ZIP_LOCAL_FILE_HEADER_SIGNATURE = 0x04034B50
+
+path, pattern_hex, alignment = sys.argv[1], sys.argv[2], int(sys.argv[3])
+with open(path, "rb") as f:
+  data = f.read()
+
+module_offset = 0
+(signature,) = struct.unpack_from("<I", data, 0)
+if signature == ZIP_LOCAL_FILE_HEADER_SIGNATURE:
+  file_name_length, extra_field_length = struct.unpack_from("<HH", data, 26)
+  module_offset = 30 + file_name_length + extra_field_length
+
+(module_length,) = struct.unpack_from("<I", data, module_offset)
+module_end = module_offset + 4 + module_length
+rodata_base = ((module_end + SEGMENT_ALIGNMENT - 1) // SEGMENT_ALIGNMENT *
+               SEGMENT_ALIGNMENT)
+print(f"module end % {alignment} = {module_end % alignment}")
+print(f"rodata base % {alignment} = {rodata_base % alignment}")
+
+pattern = bytes.fromhex(pattern_hex) * 16
+file_offset = data.find(pattern)
+if file_offset < 0:
+  print("file not found")
+else:
+  print(f"file offset % {alignment} = {file_offset % alignment}")
@@ -0,0 +1,43 @@
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN: --iree-vm-bytecode-module-optimize=false \
+// RUN: --iree-vm-bytecode-module-output-format=flatbuffer-text %s | \
+// RUN: FileCheck %s --check-prefix=FUSED
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN: --iree-vm-bytecode-module-optimize=false \
+// RUN: --iree-vm-bytecode-module-emit-superinstructions=false \
+// RUN: --iree-vm-bytecode-module-output-format=flatbuffer-text %s | \
+// RUN: FileCheck %s --check-prefix=UNFUSED
+
+// Tests that modules are stamped with the lowest bytecode version supporting
+// the features they use: 15.1 (983041) when a superinstruction is emitted and
+// 15.0 (983040) otherwise.
+
+// FUSED-LABEL: "name": "fused_module"
+// FUSED: "bytecode_version": 983041
+// UNFUSED-LABEL: "name": "fused_module"
+// UNFUSED: "bytecode_version": 983040
+vm.module @fused_module {
+  vm.func @min(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+  vm.export @min
+}
+
+// -----
+
+// FUSED-LABEL: "name": "unfused_module"
+// FUSED: "bytecode_version": 983040
+// UNFUSED-LABEL: "name": "unfused_module"
+// UNFUSED: "bytecode_version": 983040
+vm.module @unfused_module {
+  vm.func @add(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.add.i32 %arg0, %arg1 : i32
+    vm.return %0 : i32
+  }
+  vm.export @add
+}
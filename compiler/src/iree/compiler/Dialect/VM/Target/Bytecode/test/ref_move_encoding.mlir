@@ -0,0 +1,86 @@
+// RUN: iree-compile --compile-mode=vm \
+// RUN: --iree-vm-bytecode-module-optimize=false \
+// RUN: --iree-vm-bytecode-module-output-format=flatbuffer-text %s | \
+// RUN: FileCheck %s --check-prefix=MOVE
+// RUN: iree-compile --compile-mode=vm \
+// RUN: --iree-vm-bytecode-module-optimize=false \
+// RUN: --iree-vm-bytecode-module-emit-ref-moves=false \
+// RUN: --iree-vm-bytecode-module-output-format=flatbuffer-text %s | \
+// RUN: FileCheck %s --check-prefix=RETAIN
+
+// Tests that only the last use of a ref operand carries the move bit (0x4000)
+// and that modules using it are stamped with bytecode version 15.2 (983042).
+// With moves disabled both uses retain (0x8000) and the module is 15.0.
+
+// MOVE-LABEL: "name": "ref_move_module"
+// RETAIN-LABEL: "name": "ref_move_module"
+vm.module @ref_move_module {
+  vm.global.ref private mutable @lhs : !vm.buffer
+  vm.global.ref private mutable @rhs : !vm.buffer
+
+  vm.func @store_twice(%arg0 : !vm.buffer) {
+    vm.global.store.ref %arg0, @lhs : !vm.buffer
+    vm.global.store.ref %arg0, @rhs : !vm.buffer
+    vm.return
+  }
+  vm.export @store_twice
+
+  // MOVE: "bytecode_version": 983042
+  // RETAIN: "bytecode_version": 983040
+
+  // MOVE:      "bytecode_data": [
+  // MOVE-NEXT:   121,
+  // MOVE-NEXT:   9,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   128,
+  // MOVE-NEXT:   9,
+  // MOVE-NEXT:   1,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   {{[0-9]+}},
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   192,
+  // MOVE-NEXT:   90,
+  // MOVE-NEXT:   0,
+  // MOVE-NEXT:   0,
+
+  // RETAIN:      "bytecode_data": [
+  // RETAIN-NEXT:   121,
+  // RETAIN-NEXT:   9,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   128,
+  // RETAIN-NEXT:   9,
+  // RETAIN-NEXT:   1,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   {{[0-9]+}},
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   128,
+  // RETAIN-NEXT:   90,
+  // RETAIN-NEXT:   0,
+  // RETAIN-NEXT:   0,
+}
@@ -0,0 +1,52 @@
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN: --iree-vm-bytecode-module-optimize=false \
+// RUN: --iree-vm-bytecode-module-output-format=flatbuffer-text %s | FileCheck %s
+
+// Tests that a comparison only used by the vm.cond_br that follows it is
+// fused into a single compare-and-branch superinstruction (132 = 0x84).
+
+// CHECK: "name": "cmp_cond_br_module"
+vm.module @cmp_cond_br_module {
+  // CHECK: "bytecode_length": 30
+  vm.func @min(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+  vm.export @min
+
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   132,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   18,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   24,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   90,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   90,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+}
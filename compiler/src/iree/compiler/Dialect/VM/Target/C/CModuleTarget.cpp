@@ -369,7 +369,8 @@ static LogicalResult canonicalizeModule(
   modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
 
   // C target specific pass
-  modulePasses.addPass(createConvertVMToEmitCPass());
+  modulePasses.addPass(
+      createConvertVMToEmitCPass(targetOptions.elideRefRetains));
 
   modulePasses.addPass(IREE::Util::createDropCompilerHintsPass());
   modulePasses.addPass(mlir::createCanonicalizerPass());
@@ -35,6 +35,9 @@ struct CTargetOptions {
 
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Moves refs on their last use instead of retaining them.
+  bool elideRefRetains = false;
 };
 
 // Translates a vm.module to a c module.
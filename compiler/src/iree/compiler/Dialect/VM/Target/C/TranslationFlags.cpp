@@ -36,11 +36,19 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<bool> elideRefRetainsFlag{
+    "iree-vm-c-module-elide-ref-retains",
+    llvm::cl::desc("Moves refs on their last use instead of retaining them and "
+                   "releasing them when the function returns"),
+    llvm::cl::init(false),
+};
+
 CTargetOptions getCTargetOptionsFromFlags() {
   CTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
   targetOptions.optimize = optimizeFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.elideRefRetains = elideRefRetainsFlag;
   return targetOptions;
 }
 
@@ -491,6 +491,101 @@ vm.import private @mmt4d.i8i8i32(
   %flags : i32
 )
 
+vm.import private @mmt4d.i8i4i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i64,
+  %lhs_row_stride : i64,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i64,
+  %rhs_row_stride : i64,
+  %out_buffer : !vm.buffer,
+  %out_offset : i64,
+  %out_row_stride : i64,
+  %m : i64,
+  %n : i64,
+  %k : i64,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32,
+  %flags : i32
+)
+
+vm.import private @mmt4d.f16f16f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i64,
+  %lhs_row_stride : i64,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i64,
+  %rhs_row_stride : i64,
+  %out_buffer : !vm.buffer,
+  %out_offset : i64,
+  %out_row_stride : i64,
+  %m : i64,
+  %n : i64,
+  %k : i64,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32,
+  %flags : i32
+)
+
+vm.import private @mmt4d.f16f16f16(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i64,
+  %lhs_row_stride : i64,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i64,
+  %rhs_row_stride : i64,
+  %out_buffer : !vm.buffer,
+  %out_offset : i64,
+  %out_row_stride : i64,
+  %m : i64,
+  %n : i64,
+  %k : i64,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32,
+  %flags : i32
+)
+
+vm.import private @mmt4d.bf16bf16f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i64,
+  %lhs_row_stride : i64,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i64,
+  %rhs_row_stride : i64,
+  %out_buffer : !vm.buffer,
+  %out_offset : i64,
+  %out_row_stride : i64,
+  %m : i64,
+  %n : i64,
+  %k : i64,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32,
+  %flags : i32
+)
+
+vm.import private @mmt4d.bf16bf16bf16(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i64,
+  %lhs_row_stride : i64,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i64,
+  %rhs_row_stride : i64,
+  %out_buffer : !vm.buffer,
+  %out_offset : i64,
+  %out_row_stride : i64,
+  %m : i64,
+  %n : i64,
+  %k : i64,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32,
+  %flags : i32
+)
+
 //==============================================================================
 // pack ops
 //==============================================================================
@@ -15,6 +15,7 @@
 #include "iree/compiler/InputConversion/MHLO/PassDetail.h"
 #include "iree/compiler/InputConversion/MHLO/Passes.h"
 #include "iree/compiler/InputConversion/MHLO/Rewriters.h"
+#include "llvm/Support/CommandLine.h"
 #include "mhlo/IR/hlo_ops.h"
 #include "mhlo/transforms/map_mhlo_to_scalar_op.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
@@ -34,6 +35,13 @@ namespace mlir {
 namespace iree_compiler {
 namespace MHLO {
 
+static llvm::cl::opt<int> clFftFusedRadix(
+    "iree-mhlo-fft-fused-radix",
+    llvm::cl::desc("computes the first log2(radix) radix-2 stages of FFTs as "
+                   "a single batched radix-N DFT pass over the input "
+                   "(power of two; 0 or 1 to disable)"),
+    llvm::cl::init(0));
+
 namespace {
 
 static Type convertIntegerToSignless(IntegerType intType) {
@@ -345,6 +353,90 @@ struct FftOpConversion : public OpConversionPattern<mhlo::FftOp> {
                                     DenseFPElementsAttr::get(type, imag))};
   }
 
+  // Computes the first log2(|radix|) stages of the FFT of the bit-reversed
+  // |real| input in one pass. After those stages each contiguous block of
+  // |radix| elements holds the DFT of the block in bit-reversed order:
+  //   out[b, k] = sum_j real[b * radix + j] * exp(-2 * PI * rev(j) * k / radix)
+  // This is computed as a batched real-by-complex matmul against a constant
+  // coefficient matrix. It does more arithmetic than the butterflies it
+  // replaces but reads and writes the data once instead of once per stage.
+  static SmallVector<Value> getFusedRadixStages(ImplicitLocOpBuilder &b,
+                                                Value real, int radix) {
+    auto realType = real.getType().cast<RankedTensorType>();
+    int64_t rank = realType.getRank();
+    int64_t fftLength = realType.getShape().back();
+    int logr = std::log(radix) / std::log(2);
+    constexpr std::complex<double> kI(0, 1);
+    SmallVector<Attribute> coeffReal, coeffImag;
+    for (int j = 0; j < radix; ++j) {
+      int r = 0;
+      for (int bit = 0; bit < logr; ++bit) {
+        r |= ((j >> bit) & 1) << (logr - bit - 1);
+      }
+      for (int k = 0; k < radix; ++k) {
+        auto v = std::exp(-2 * M_PI * ((r * k) % radix) / radix * kI);
+        coeffReal.push_back(b.getF32FloatAttr(v.real()));
+        coeffImag.push_back(b.getF32FloatAttr(v.imag()));
+      }
+    }
+    auto coeffType = RankedTensorType::get({radix, radix}, b.getF32Type());
+    Value coeffRealValue = b.create<arith::ConstantOp>(
+        coeffType, DenseFPElementsAttr::get(coeffType, coeffReal));
+    Value coeffImagValue = b.create<arith::ConstantOp>(
+        coeffType, DenseFPElementsAttr::get(coeffType, coeffImag));
+
+    SmallVector<int64_t> expandedShape(realType.getShape());
+    expandedShape.back() = fftLength / radix;
+    expandedShape.push_back(radix);
+    auto expandedType =
+        RankedTensorType::get(expandedShape, realType.getElementType());
+    SmallVector<ReassociationIndices> reassociation;
+    for (int64_t i = 0; i < rank - 1; ++i) reassociation.push_back({i});
+    reassociation.push_back({rank - 1, rank});
+    Value expanded =
+        b.create<tensor::ExpandShapeOp>(expandedType, real, reassociation);
+
+    Value zero = b.create<arith::ConstantOp>(b.getF32FloatAttr(0.0));
+    Value empty = b.create<tensor::EmptyOp>(expandedShape, b.getF32Type());
+    Value init = b.create<linalg::FillOp>(zero, empty).getResult(0);
+
+    // Loops are (outer..., block, k, j) with j reduced.
+    int64_t numLoops = rank + 2;
+    SmallVector<AffineExpr> inputExprs, coeffExprs, outputExprs;
+    for (int64_t i = 0; i < rank; ++i) {
+      inputExprs.push_back(b.getAffineDimExpr(i));
+      outputExprs.push_back(b.getAffineDimExpr(i));
+    }
+    inputExprs.push_back(b.getAffineDimExpr(rank + 1));
+    outputExprs.push_back(b.getAffineDimExpr(rank));
+    coeffExprs.push_back(b.getAffineDimExpr(rank + 1));
+    coeffExprs.push_back(b.getAffineDimExpr(rank));
+    auto inputMap = AffineMap::get(numLoops, 0, inputExprs, b.getContext());
+    auto coeffMap = AffineMap::get(numLoops, 0, coeffExprs, b.getContext());
+    auto outputMap = AffineMap::get(numLoops, 0, outputExprs, b.getContext());
+    SmallVector<utils::IteratorType> iterTypes(numLoops,
+                                               utils::IteratorType::parallel);
+    iterTypes.back() = utils::IteratorType::reduction;
+
+    auto genericOp = b.create<linalg::GenericOp>(
+        TypeRange{expandedType, expandedType},
+        ValueRange{expanded, coeffRealValue, coeffImagValue},
+        ValueRange{init, init},
+        ArrayRef<AffineMap>{inputMap, coeffMap, coeffMap, outputMap,
+                            outputMap},
+        iterTypes, [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value mulReal = b.create<arith::MulFOp>(loc, args[0], args[1]);
+          Value mulImag = b.create<arith::MulFOp>(loc, args[0], args[2]);
+          Value accReal = b.create<arith::AddFOp>(loc, args[3], mulReal);
+          Value accImag = b.create<arith::AddFOp>(loc, args[4], mulImag);
+          b.create<linalg::YieldOp>(loc, ValueRange{accReal, accImag});
+        });
+    return {b.create<tensor::CollapseShapeOp>(realType, genericOp.getResult(0),
+                                              reassociation),
+            b.create<tensor::CollapseShapeOp>(realType, genericOp.getResult(1),
+                                              reassociation)};
+  }
+
   LogicalResult matchAndRewrite(
       mhlo::FftOp op, OpAdaptor adaptor,
       ConversionPatternRewriter &rewriter) const final {
@@ -364,7 +456,14 @@ struct FftOpConversion : public OpConversionPattern<mhlo::FftOp> {
     SmallVector<Value> results =
         getBitReversalOrder(b, adaptor.getOperand(), fftLength);
     int lognPlus1 = std::log(fftLength) / std::log(2) + 1;
-    for (auto s : llvm::seq<unsigned>(1, lognPlus1)) {
+    int firstStage = 1;
+    int radix = std::min<int>(clFftFusedRadix, fftLength);
+    if (radix > 1 && (radix & (radix - 1)) == 0) {
+      // The input is real so the bit-reversed imaginary part is not needed.
+      results = getFusedRadixStages(b, results[0], radix);
+      firstStage = std::log(radix) / std::log(2) + 1;
+    }
+    for (auto s : llvm::seq<unsigned>(firstStage, lognPlus1)) {
       SmallVector<Value> inputs;
       inputs.push_back(b.create<arith::ConstantIndexOp>(s));
       inputs.append(getCoeffConstants(b, s));
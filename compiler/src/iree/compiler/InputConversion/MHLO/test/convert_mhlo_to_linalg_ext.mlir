@@ -1,6 +1,7 @@
 // RUN: iree-opt --split-input-file --iree-mhlo-to-linalg-ext %s | FileCheck %s
 // Also ensure that full lowering to linalg doesn't error.
 // RUN: iree-opt --split-input-file --iree-mhlo-to-linalg-ext --iree-mhlo-to-linalg-on-tensors --reconcile-unrealized-casts %s
+// RUN: iree-opt --split-input-file --iree-mhlo-to-linalg-ext --iree-mhlo-fft-fused-radix=4 %s | FileCheck %s --check-prefix=RADIX
 
 func.func @sort_1d(%arg0: tensor<128xi32>) -> (tensor<128xi32>) {
   %0 = "mhlo.sort"(%arg0) ( {
@@ -409,6 +410,31 @@ func.func @rfft_1d(%input: tensor<8xf32>) -> (tensor<5xf32>, tensor<5xf32>) {
 // CHECK:        %[[RES_IMAG:.+]] = tensor.extract_slice %[[R3]]#1[0] [5] [1] : tensor<8xf32> to tensor<5xf32>
 // CHECK:        %{{.+}} = mhlo.complex %[[RES_REAL]], %[[RES_IMAG]]
 
+// The first two stages are computed as a single radix-4 pass.
+// RADIX-DAG:  #[[IN_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d2)>
+// RADIX-DAG:  #[[COEF_MAP:.+]] = affine_map<(d0, d1, d2) -> (d2, d1)>
+// RADIX-DAG:  #[[OUT_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+// RADIX:      func.func @rfft_1d
+// RADIX:        %[[REORDERED:.+]] = linalg.generic
+// RADIX-DAG:    %[[COEF_REAL:.+]] = arith.constant dense<{{.+}}> : tensor<4x4xf32>
+// RADIX-DAG:    %[[COEF_IMAG:.+]] = arith.constant dense<{{.+}}> : tensor<4x4xf32>
+// RADIX-DAG:    %[[EXPANDED:.+]] = tensor.expand_shape %[[REORDERED]] {{\[\[}}0, 1]] : tensor<8xf32> into tensor<2x4xf32>
+// RADIX-DAG:    %[[INIT:.+]] = linalg.fill
+// RADIX:        %[[RADIX4:.+]]:2 = linalg.generic
+// RADIX-SAME:     indexing_maps = [#[[IN_MAP]], #[[COEF_MAP]], #[[COEF_MAP]], #[[OUT_MAP]], #[[OUT_MAP]]]
+// RADIX-SAME:     iterator_types = ["parallel", "parallel", "reduction"]
+// RADIX-SAME:     ins(%[[EXPANDED]], %[[COEF_REAL]], %[[COEF_IMAG]]
+// RADIX-SAME:     outs(%[[INIT]], %[[INIT]]
+// RADIX:        %[[R2_REAL:.+]] = tensor.collapse_shape %[[RADIX4]]#0 {{\[\[}}0, 1]] : tensor<2x4xf32> into tensor<8xf32>
+// RADIX:        %[[R2_IMAG:.+]] = tensor.collapse_shape %[[RADIX4]]#1 {{\[\[}}0, 1]] : tensor<2x4xf32> into tensor<8xf32>
+// RADIX-NOT:    iree_linalg_ext.fft
+// RADIX:        %[[C3:.+]] = arith.constant 3 : index
+// RADIX:        %[[R3:.+]]:2 = iree_linalg_ext.fft
+// RADIX-SAME:     ins(%[[C3]]
+// RADIX-SAME:     outs(%[[R2_REAL]], %[[R2_IMAG]]
+// RADIX-NOT:    iree_linalg_ext.fft
+// RADIX:        mhlo.complex
+
 // -----
 
 func.func @rfft_2d(%input: tensor<4x8xf32>) -> (tensor<4x5xf32>, tensor<4x5xf32>) {
@@ -62,7 +62,8 @@ void buildHALInlineStaticTransformPassPipeline(
 
   // Translate each executable down to common MLIR dialects.
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      IREE::HAL::createTranslateExecutablesPass());
+      IREE::HAL::createTranslateExecutablesPass(
+          targetOptions.executableCachePath));
 
   // Inline the translated executable functions.
   // We preserve the executables for their metadata used during conversion.
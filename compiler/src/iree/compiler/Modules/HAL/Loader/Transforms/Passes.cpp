@@ -67,7 +67,8 @@ void buildHALInlineDynamicTransformPassPipeline(
   // After this point the executables are opaque blobs and we cannot change
   // their interfaces.
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      IREE::HAL::createTranslateExecutablesPass());
+      IREE::HAL::createTranslateExecutablesPass(
+          targetOptions.executableCachePath));
 
   //----------------------------------------------------------------------------
   // Conversion
@@ -8,6 +8,7 @@
 
 #include "iree/compiler/Bindings/Native/Transforms/Passes.h"
 #include "iree/compiler/Bindings/TFLite/Transforms/Passes.h"
+#include "iree/compiler/Codegen/Passes.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
@@ -108,6 +109,12 @@ void buildIREEVMTransformPassPipeline(
         hooks.buildConstEvalPassPipelineCallback;
   }
 
+  // Encodings in host code are materialized with the layout of the target
+  // devices when they all share it; see the pass for details.
+  flowOptions.buildMaterializeEncodingsPassPipeline = [](OpPassManager &pm) {
+    pm.addPass(createLLVMCPUMaterializeHomogeneousEncodingsPass());
+  };
+
   if (highLevelOptimizationOptions.stripAssertions) {
     // Strip std.assert & co after we perform optimizations; prior to this we
     // may use the assertions to derive information during analysis.
@@ -132,6 +139,14 @@ void buildIREEVMTransformPassPipeline(
       if (compileTo == IREEVMPipelinePhase::Preprocessing)
         return;  // early-exit
 
+      // Assign the target devices ahead of the HAL pipeline so that the flow
+      // pipeline can make target-specific decisions (such as the layout of
+      // data-tiled tensors). The HAL pipeline keeps any existing assignment.
+      if (!executableOptions.targets.empty()) {
+        passManager.addPass(IREE::HAL::createAssignTargetDevicesPass(
+            executableOptions.targets));
+      }
+
       IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "Flow");
       IREE::Flow::buildFlowTransformPassPipeline(passManager, flowOptions);
       IREE_TRACE_ADD_END_FRAME_PASS(passManager, "Flow");
@@ -83,14 +83,19 @@ CompilationModeNames = {
 }
 
 
+# Default uses the heuristics in KernelConfig.cpp/KernelDispatch.cpp, Custom
+# attaches a tuning configuration to the operation, and Ukernel compiles the
+# operation through data-tiling and the LLVMCPU microkernels.
 class CompilationConfigType(enum.Enum):
   Default = auto()
   Custom = auto()
+  Ukernel = auto()
 
 
 CompilationConfigTypeName = {
     CompilationConfigType.Default: 'default',
     CompilationConfigType.Custom: 'custom',
+    CompilationConfigType.Ukernel: 'ukernel',
 }
 
 
@@ -189,6 +194,11 @@ class TranslationInfo(enum.Enum):
   LLVMGPUMatmulSIMT = auto()
   LLVMGPUMatmulTensorCore = auto()
   LLVMGPUMatmulTensorCoreMmaSync = auto()
+  CPUDoubleTilingExpert = auto()
+  CPUDoubleTilingPadExpert = auto()
+  CPUDoubleTilingPeelingExpert = auto()
+  SPIRVBaseVectorize = auto()
+  SPIRVMatmulPromoteVectorize = auto()
 
 
 TranslationInfoTag = {
@@ -198,12 +208,51 @@ TranslationInfoTag = {
         "LLVMGPUMatmulTensorCore",
     TranslationInfo.LLVMGPUMatmulTensorCoreMmaSync:
         "LLVMGPUMatmulTensorCoreMmaSync",
+    TranslationInfo.CPUDoubleTilingExpert:
+        "CPUDoubleTilingExpert",
+    TranslationInfo.CPUDoubleTilingPadExpert:
+        "CPUDoubleTilingPadExpert",
+    TranslationInfo.CPUDoubleTilingPeelingExpert:
+        "CPUDoubleTilingPeelingExpert",
+    TranslationInfo.SPIRVBaseVectorize:
+        "SPIRVBaseVectorize",
+    TranslationInfo.SPIRVMatmulPromoteVectorize:
+        "SPIRVMatmulPromoteVectorize",
 }
 
 TranslationInfoName = {
     TranslationInfo.LLVMGPUMatmulSIMT: "simt",
     TranslationInfo.LLVMGPUMatmulTensorCore: "tensorcore_wmma",
     TranslationInfo.LLVMGPUMatmulTensorCoreMmaSync: "tensorcore_mma_sync",
+    TranslationInfo.CPUDoubleTilingExpert: "cpu_double_tiling",
+    TranslationInfo.CPUDoubleTilingPadExpert: "cpu_double_tiling_pad",
+    TranslationInfo.CPUDoubleTilingPeelingExpert: "cpu_double_tiling_peel",
+    TranslationInfo.SPIRVBaseVectorize: "spirv_vectorize",
+    TranslationInfo.SPIRVMatmulPromoteVectorize: "spirv_promote_vectorize",
+}
+
+# Translation infos that accept a software pipelining depth.
+TranslationInfoWithPipelineDepth = [
+    TranslationInfo.LLVMGPUMatmulSIMT,
+    TranslationInfo.LLVMGPUMatmulTensorCore,
+    TranslationInfo.LLVMGPUMatmulTensorCoreMmaSync,
+    TranslationInfo.SPIRVMatmulPromoteVectorize,
+]
+
+
+# Target devices: the iree-compile target backend and the runtime HAL device
+# used by iree-run-module and iree-benchmark-module.
+###################################################################################################
+TargetBackendName = {
+    'cuda': 'cuda',
+    'cpu': 'llvm-cpu',
+    'vulkan': 'vulkan-spirv',
+}
+
+RuntimeDeviceName = {
+    'cuda': 'cuda',
+    'cpu': 'local-task',
+    'vulkan': 'vulkan',
 }
 
 
@@ -260,6 +309,60 @@ class TileDescription:
                             self.threadblock_shape[1],
                             self.threadblock_shape[2], self.stages)
 
+  def tile_sizes(self):
+    """Returns the `lowering_config` tile sizes."""
+    return "[[%d, %d, %d]]" % tuple(self.threadblock_shape)
+
+  def workgroup_size(self):
+    """Returns the `workgroup_size` entries."""
+    return ", ".join("%d : index" % dim for dim in self.block_dim)
+
+
+class MultiLevelTileDescription:
+  """A class for multi-level tile description used by the LLVMCPU and SPIR-V
+  pipelines. A workgroup tile in M and N is distributed and then tiled again in
+  M and N to an inner tile (vector tile on LLVMCPU, per-thread tile on SPIR-V)
+  with the reduction dimension K tiled last."""
+
+  def __init__(self,
+               workgroup_shape,
+               inner_shape,
+               reduction_size,
+               stages=0,
+               block_dim=None):
+    self.workgroup_shape = workgroup_shape  # in number of elements in M, N
+    self.inner_shape = inner_shape  # in number of elements in M, N
+    self.reduction_size = reduction_size  # in number of elements in K
+    self.stages = stages  # pipelining depth; 0 when not pipelined
+    self.block_dim = block_dim or []  # empty on LLVMCPU
+
+    # Tile shape in M, N, K used to check alignment with the problem shape.
+    self.threadblock_shape = workgroup_shape + [reduction_size]
+
+  def name(self):
+    name = "%dx%d_%dx%d_%d" % (self.workgroup_shape[0], self.workgroup_shape[1],
+                               self.inner_shape[0], self.inner_shape[1],
+                               self.reduction_size)
+    if self.stages:
+      name += "x%d" % self.stages
+    return name
+
+  def tile_sizes(self):
+    """Returns the `lowering_config` tile sizes."""
+    if len(self.block_dim):
+      # SPIR-V: workgroup, thread, and reduction tiles.
+      return "[[%d, %d], [%d, %d], [0, 0, %d]]" % (
+          self.workgroup_shape[0], self.workgroup_shape[1],
+          self.inner_shape[0], self.inner_shape[1], self.reduction_size)
+    # LLVMCPU: distribution, parallel vector, and reduction vector tiles.
+    return "[[%d, %d, 0], [%d, %d, 0], [0, 0, %d]]" % (
+        self.workgroup_shape[0], self.workgroup_shape[1], self.inner_shape[0],
+        self.inner_shape[1], self.reduction_size)
+
+  def workgroup_size(self):
+    """Returns the `workgroup_size` entries."""
+    return ", ".join("%d : index" % dim for dim in self.block_dim)
+
 
 ###################################################################################################
 # The following part contains utility functions for which are used by the profiler tool.
@@ -112,14 +112,11 @@ class MatmulCompilationInfo:
 
   def name(self):
     """Procedurally generated name for the matmul compilation info."""
-    if self.config_type == CompilationConfigType.Default:
-      return "tile_config_default"
-
-    return "tile_config_{tbm}x{tbn}_{tbk}x{stages}_{translation_info}".format(
-        tbm=self.tile_description.threadblock_shape[0],
-        tbn=self.tile_description.threadblock_shape[1],
-        tbk=self.tile_description.threadblock_shape[2],
-        stages=self.tile_description.stages,
+    if self.config_type != CompilationConfigType.Custom:
+      return "tile_config_" + CompilationConfigTypeName[self.config_type]
+
+    return "tile_config_{tile_description}_{translation_info}".format(
+        tile_description=self.tile_description.name(),
         translation_info=TranslationInfoName[self.translation_info])
 
 
@@ -131,36 +128,28 @@ class EmitMatmulCompilationInfo:
     self.compilation_info_template = """
 // matmul compilation info (tile configuration, translation info, workgroup size)
 #${compilation_info_name} = #iree_codegen.compilation_info<
-  lowering_config = <tile_sizes = [[${threadblock_shape_m}, ${threadblock_shape_n}, ${threadblock_shape_k}]]>,
-  translation_info = <${translation_info} pipeline_depth = ${stages}>,
-  workgroup_size = [${block_dim_x} : index, ${block_dim_y} : index, ${block_dim_z} : index]
+  lowering_config = <tile_sizes = ${tile_sizes}>,
+  translation_info = <${translation_info}>,
+  workgroup_size = [${workgroup_size}]
 >
 """
 
   def emit(self, compilation_info):
     """Emits the matmul compilation info as a string."""
-    if compilation_info.config_type == CompilationConfigType.Default:
+    if compilation_info.config_type != CompilationConfigType.Custom:
       return ""
 
+    tile_description = compilation_info.tile_description
+    translation_info = TranslationInfoTag[compilation_info.translation_info]
+    if compilation_info.translation_info in TranslationInfoWithPipelineDepth \
+       and tile_description.stages:
+      translation_info += " pipeline_depth = %d" % tile_description.stages
+
     values = {
-        'compilation_info_name':
-            compilation_info.name(),
-        'translation_info':
-            TranslationInfoTag[compilation_info.translation_info],
-        'threadblock_shape_m':
-            str(compilation_info.tile_description.threadblock_shape[0]),
-        'threadblock_shape_n':
-            str(compilation_info.tile_description.threadblock_shape[1]),
-        'threadblock_shape_k':
-            str(compilation_info.tile_description.threadblock_shape[2]),
-        'stages':
-            str(compilation_info.tile_description.stages),
-        'block_dim_x':
-            str(compilation_info.tile_description.block_dim[0]),
-        'block_dim_y':
-            str(compilation_info.tile_description.block_dim[1]),
-        'block_dim_z':
-            str(compilation_info.tile_description.block_dim[2]),
+        'compilation_info_name': compilation_info.name(),
+        'tile_sizes': tile_description.tile_sizes(),
+        'translation_info': translation_info,
+        'workgroup_size': tile_description.workgroup_size(),
     }
 
     return SubstituteTemplate(self.compilation_info_template, values)
@@ -196,7 +185,7 @@ func.func @${operation_name}_${compilation_info_name}(
         compilation_info_attribute_template,
         {'compilation_info_name': matmul_dispatch.configuration.name()})
     compilation_info_attribute = compilation_info_attribute_str \
-      if matmul_dispatch.configuration.config_type != CompilationConfigType.Default else ""
+      if matmul_dispatch.configuration.config_type == CompilationConfigType.Custom else ""
 
     values = {
         'operation_name':
@@ -345,31 +334,49 @@ class MatmulOperationLauncher:
     self.iree_run_module_path = os.path.join(args.build_dir, 'tools',
                                              'iree-run-module')
 
-    # output vmfb files for the operation.
-    self.vmfb_verify_file = os.path.join(self.operation_path,
-                                         self.operation.name() + '_verify.vmfb')
-    self.vmfb_benchmark_file = os.path.join(
-        self.operation_path,
-        self.operation.name() + '_benchmark.vmfb')
-
-  def compile(self, compilation_mode):
+    # HAL device used by iree-run-module and iree-benchmark-module.
+    self.runtime_device = RuntimeDeviceName[args.device]
+
+  def _vmfb_file(self, compilation_mode, configuration):
+    """Returns the vmfb file for the operation compiled for a configuration.
+    All the configurations of the operation share a single vmfb file, except
+    for the ukernel configuration that is compiled with different flags."""
+    suffix = '_verify.vmfb' if compilation_mode == CompilationMode.Verify \
+             else '_benchmark.vmfb'
+    if configuration is not None and \
+       configuration.config_type == CompilationConfigType.Ukernel:
+      suffix = '_ukernel' + suffix
+    return os.path.join(self.operation_path, self.operation.name() + suffix)
+
+  def compile(self, compilation_mode, configuration=None):
     """Compiles the matmul operation to a vmfb file for profiling."""
 
     benchmark_dispatch_repeat_count = self.benchmark_dispatch_repeat_count if compilation_mode == CompilationMode.Profile else 1
-    vmfb_file = self.vmfb_benchmark_file if compilation_mode == CompilationMode.Profile else self.vmfb_verify_file
+    vmfb_file = self._vmfb_file(compilation_mode, configuration)
 
     # Base iree-compile commandline
     cmd = [self.iree_compile_path, self.source_mlir_file, "-o", f"{vmfb_file}"]
 
     # General compilation options
-    cmd += [f"--iree-hal-target-backends={self.args.device}"]
-    cmd += [f"--iree-hal-cuda-llvm-target-arch={self.args.cuda_arch}"]
+    cmd += [f"--iree-hal-target-backends={TargetBackendName[self.args.device]}"]
     if self.args.split_k_slices != "":
       cmd += [f"--iree-flow-split-matmul-reduction={self.args.split_k_slices}"]
-    if self.args.use_mma_sync:
-      cmd += [f"--iree-codegen-llvmgpu-use-mma-sync"]
-    if self.args.use_wmma:
-      cmd += [f"--iree-codegen-llvmgpu-use-wmma"]
+
+    # Target-specific compilation options
+    if self.args.device == 'cuda':
+      cmd += [f"--iree-hal-cuda-llvm-target-arch={self.args.cuda_arch}"]
+      if self.args.use_mma_sync:
+        cmd += [f"--iree-codegen-llvmgpu-use-mma-sync"]
+      if self.args.use_wmma:
+        cmd += [f"--iree-codegen-llvmgpu-use-wmma"]
+    elif self.args.device == 'cpu':
+      cmd += [f"--iree-llvmcpu-target-cpu={self.args.cpu}"]
+      if configuration is not None and \
+         configuration.config_type == CompilationConfigType.Ukernel:
+        cmd += [f"--iree-flow-enable-data-tiling"]
+        cmd += [f"--iree-llvmcpu-enable-microkernels"]
+    elif self.args.device == 'vulkan':
+      cmd += [f"--iree-vulkan-target-triple={self.args.vulkan_target_triple}"]
 
     # Compilation options for profiling
     cmd += [
@@ -389,7 +396,8 @@ class MatmulOperationLauncher:
   def verify(self, configuration):
     """Verifies the matmul operation with a given configuration."""
     # First compile the operation to a vmfb file.
-    self.compile(CompilationMode.Verify)
+    self.compile(CompilationMode.Verify, configuration)
+    vmfb_file = self._vmfb_file(CompilationMode.Verify, configuration)
 
     # Verify using random data distribution.
     # TODO 1) make input distribution configurable through command line.
@@ -413,8 +421,8 @@ class MatmulOperationLauncher:
 
     # Commandline `iree-run-module` for verification.
     cmd = [
-        self.iree_run_module_path, f'--module={self.vmfb_verify_file}',
-        f'--device={self.args.device}'
+        self.iree_run_module_path, f'--module={vmfb_file}',
+        f'--device={self.runtime_device}'
     ]
 
     # Operation-specific verification command-line.
@@ -447,17 +455,19 @@ class MatmulOperationLauncher:
   def profile(self, configuration):
     """Profiles the matmul operation with a given configuration."""
     # First compile the operation to a vmfb file.
-    self.compile(CompilationMode.Profile)
+    self.compile(CompilationMode.Profile, configuration)
+    vmfb_file = self._vmfb_file(CompilationMode.Profile, configuration)
 
     # Commandline `iree-benchmark-module` for profiling.
     cmd = [
-        self.iree_benchmark_module_path, f'--module={self.vmfb_benchmark_file}',
-        f'--device={self.args.device}'
+        self.iree_benchmark_module_path, f'--module={vmfb_file}',
+        f'--device={self.runtime_device}'
     ]
 
     # Profiling specific flags.
     cmd += [f'--benchmark_repetitions={self.args.benchmark_repetitions}']
     cmd += [f'--batch_size={self.batch_size}']
+    cmd += [f'--time_unit=ms']
 
     # Operation-specific profiling command-line.
     cmd += [f'--function={self.operation.name()}_{configuration.name()}']
@@ -517,6 +527,11 @@ class MatmulGenerator:
     self.cuda_warp_size = 32
     self.cuda_smem_capacity_in_bytes_sm80 = 192 << 10
 
+    # SPIR-V specific constants. Vulkan only guarantees 128 invocations and
+    # 16KB of workgroup memory; 32KB is common across desktop and mobile GPUs.
+    self.spirv_max_workgroup_invocations = 128
+    self.spirv_workgroup_memory_in_bytes = 32 << 10
+
   def _is_tile_aligned_shape(self, dispatch):
     """Checks if the given dispatch is valid for CUDA."""
     problem_shape = dispatch.operation.problem_shape
@@ -528,10 +543,10 @@ class MatmulGenerator:
         a % b == 0 for a, b in zip(problem_shape, threadblock_shape))
     return is_aligned
 
-  def _cuda_smem_required_in_bytes(self, dispatch):
-    """Returns size bytes of shared memory required for a given cuda dispatch."""
+  def _smem_required_in_bytes(self, dispatch):
+    """Returns size bytes of shared memory required for a given GPU dispatch."""
     threadblock_shape = dispatch.configuration.tile_description.threadblock_shape
-    num_stages = dispatch.configuration.tile_description.stages
+    num_stages = max(dispatch.configuration.tile_description.stages, 1)
     tile_shape_lhs = threadblock_shape[0] * threadblock_shape[2]
     tile_shape_rhs = threadblock_shape[2] * threadblock_shape[1]
     return ((tile_shape_lhs * DataTypeSizeInBits[dispatch.operation.lhs.datatype] + \
@@ -539,7 +554,7 @@ class MatmulGenerator:
 
   def _is_cuda_smem_avialable(self, dispatch):
     """Checks if the given dispatch is valid for CUDA."""
-    return self._cuda_smem_required_in_bytes(
+    return self._smem_required_in_bytes(
         dispatch) <= self.cuda_smem_capacity_in_bytes_sm80
 
   def _cuda_supported_configuration_list(self, operation, configuration_list):
@@ -551,7 +566,7 @@ class MatmulGenerator:
         print(f"Warning: {dispatch.name()} is not aligned is being skipped.")
         continue
       if not self._is_cuda_smem_avialable(dispatch):
-        print(f"Warning: {dispatch.name()} requires {self._cuda_smem_required_in_bytes(dispatch)} "\
+        print(f"Warning: {dispatch.name()} requires {self._smem_required_in_bytes(dispatch)} "\
               f"bytes of shared memory, which is larger than the SM80 capacity "\
               f"{self.cuda_smem_capacity_in_bytes_sm80} bytes.")
         continue
@@ -642,11 +657,169 @@ class MatmulGenerator:
       self.dispatches_collection_list.append(DispatchCollection(\
         operation, supported_configuration_list))
 
+  ################################################################################
+  def _cpu_supported_configuration_list(self, operation, configuration_list):
+    """Returns a list of supported configurations for LLVMCPU."""
+    supported_configuration_list = []
+    for configuration in configuration_list:
+      dispatch = Dispatch(operation, configuration)
+      tile_description = configuration.tile_description
+      if any(wg % inner != 0 for wg, inner in zip(
+          tile_description.workgroup_shape, tile_description.inner_shape)):
+        print(f"Warning: {dispatch.name()} vector tile does not divide the "\
+              f"workgroup tile and is being skipped.")
+        continue
+      # Only the padding and peeling pipelines handle partial tiles.
+      if configuration.translation_info == TranslationInfo.CPUDoubleTilingExpert \
+         and not self._is_tile_aligned_shape(dispatch):
+        print(f"Warning: {dispatch.name()} is not aligned is being skipped.")
+        continue
+
+      # If all checks pass, add the configuration to the supported list.
+      supported_configuration_list.append(configuration)
+
+    return supported_configuration_list
+
+  def _cpu_matmul_f32(self):
+    """Appends a list of matmul dispatches for LLVMCPU F32 data type."""
+
+    # Workgroup tile [M, N], vector tile [M, N], and reduction tile K.
+    tile_descriptions = [
+        MultiLevelTileDescription([64, 64], [8, 32], 16),
+        MultiLevelTileDescription([64, 64], [16, 16], 16),
+        MultiLevelTileDescription([64, 128], [8, 32], 16),
+        MultiLevelTileDescription([128, 64], [8, 32], 32),
+        MultiLevelTileDescription([128, 128], [8, 32], 16),
+        MultiLevelTileDescription([32, 32], [8, 16], 32),
+    ]
+
+    translation_infos = [
+        TranslationInfo.CPUDoubleTilingExpert,
+        TranslationInfo.CPUDoubleTilingPadExpert,
+        TranslationInfo.CPUDoubleTilingPeelingExpert,
+    ]
+
+    configuration_list = []
+    for tile_description in tile_descriptions:
+      for translation_info in translation_infos:
+        configuration_list.append(
+            MatmulCompilationInfo(tile_description, translation_info))
+
+    for problem_shape in self.problem_shapes:
+      operation = MatmulOperation(
+        problem_shape,\
+        TensorDescription(DataType.f32, LayoutType.RowMajor), \
+        TensorDescription(DataType.f32, LayoutType.RowMajor), \
+        TensorDescription(DataType.f32, LayoutType.RowMajor))
+
+      supported_configuration_list = self._cpu_supported_configuration_list(
+          operation, configuration_list)
+
+      # Add default configuration if requested.
+      if self.default_config:
+        supported_configuration_list.append(
+            MatmulCompilationInfo([], [], CompilationConfigType.Default))
+
+      # Always compare the codegen paths against the microkernel path.
+      supported_configuration_list.append(
+          MatmulCompilationInfo([], [], CompilationConfigType.Ukernel))
+
+      self.dispatches_collection_list.append(DispatchCollection(\
+        operation, supported_configuration_list))
+
+  ################################################################################
+  def _spirv_supported_configuration_list(self, operation, configuration_list):
+    """Returns a list of supported configurations for SPIR-V."""
+    supported_configuration_list = []
+    for configuration in configuration_list:
+      dispatch = Dispatch(operation, configuration)
+      tile_description = configuration.tile_description
+      if not self._is_tile_aligned_shape(dispatch):
+        print(f"Warning: {dispatch.name()} is not aligned is being skipped.")
+        continue
+      invocations = functools.reduce(operator.mul, tile_description.block_dim)
+      if invocations > self.spirv_max_workgroup_invocations:
+        print(f"Warning: {dispatch.name()} requires {invocations} invocations "\
+              f"per workgroup, which is larger than "\
+              f"{self.spirv_max_workgroup_invocations}.")
+        continue
+      if configuration.translation_info == TranslationInfo.SPIRVMatmulPromoteVectorize \
+         and self._smem_required_in_bytes(dispatch) > self.spirv_workgroup_memory_in_bytes:
+        print(f"Warning: {dispatch.name()} requires {self._smem_required_in_bytes(dispatch)} "\
+              f"bytes of workgroup memory, which is larger than "\
+              f"{self.spirv_workgroup_memory_in_bytes} bytes.")
+        continue
+
+      # If all checks pass, add the configuration to the supported list.
+      supported_configuration_list.append(configuration)
+
+    return supported_configuration_list
+
+  def _spirv_tile_description(self, workgroup_shape, thread_shape,
+                              reduction_size, stages):
+    """Returns a tile description with one invocation per thread tile."""
+    block_dim = [
+        workgroup_shape[1] // thread_shape[1],
+        workgroup_shape[0] // thread_shape[0], 1
+    ]
+    return MultiLevelTileDescription(workgroup_shape, thread_shape,
+                                     reduction_size, stages, block_dim)
+
+  def _spirv_matmul_f32(self):
+    """Appends a list of matmul dispatches for SPIR-V F32 data type."""
+
+    # Workgroup tile [M, N], thread tile [M, N], reduction tile K, and stages.
+    tile_descriptions = [
+        self._spirv_tile_description([64, 64], [8, 4], 16, 1),
+        self._spirv_tile_description([64, 64], [8, 4], 16, 2),
+        self._spirv_tile_description([64, 64], [4, 8], 32, 1),
+        self._spirv_tile_description([64, 128], [8, 8], 16, 1),
+        self._spirv_tile_description([128, 64], [8, 8], 16, 1),
+        self._spirv_tile_description([32, 32], [4, 4], 32, 2),
+    ]
+
+    translation_infos = [
+        TranslationInfo.SPIRVBaseVectorize,
+        TranslationInfo.SPIRVMatmulPromoteVectorize,
+    ]
+
+    configuration_list = []
+    for tile_description in tile_descriptions:
+      for translation_info in translation_infos:
+        # Only the promotion pipeline is software pipelined.
+        if translation_info == TranslationInfo.SPIRVBaseVectorize and \
+           tile_description.stages > 1:
+          continue
+        configuration_list.append(
+            MatmulCompilationInfo(tile_description, translation_info))
+
+    for problem_shape in self.problem_shapes:
+      operation = MatmulOperation(
+        problem_shape,\
+        TensorDescription(DataType.f32, LayoutType.RowMajor), \
+        TensorDescription(DataType.f32, LayoutType.RowMajor), \
+        TensorDescription(DataType.f32, LayoutType.RowMajor))
+
+      supported_configuration_list = self._spirv_supported_configuration_list(
+          operation, configuration_list)
+
+      # Add default configuration if requested.
+      if self.default_config:
+        supported_configuration_list.append(
+            MatmulCompilationInfo([], [], CompilationConfigType.Default))
+
+      self.dispatches_collection_list.append(DispatchCollection(\
+        operation, supported_configuration_list))
+
   def generate(self):
     """Generates a list of matmul operations."""
     if self.args.device == 'cuda':
       self._cuda_matmul_tensor_cores_f16()
       self._cuda_matmul_tensor_cores_f32()
+    elif self.args.device == 'cpu':
+      self._cpu_matmul_f32()
+    elif self.args.device == 'vulkan':
+      self._spirv_matmul_f32()
     return self.dispatches_collection_list
 
 
@@ -72,6 +72,16 @@ def add_iree_compile_arguments(parser):
                       dest="cuda_arch", default='sm_80', \
                       help="Target architecture for the CUDA backend. ", \
                       choices=["sm_50", "sm_60", "sm_75", "sm_80", "sm_86"])
+  iree_compile_parser.add_argument(
+                      "--iree-llvmcpu-target-cpu", "--cpu", \
+                      dest="cpu", default='host', \
+                      help="Target CPU for the LLVMCPU backend. ")
+  iree_compile_parser.add_argument(
+                      "--iree-vulkan-target-triple", "--vulkan-target-triple", \
+                      dest="vulkan_target_triple", \
+                      default='unknown-unknown-unknown', \
+                      help="Target triple for the Vulkan SPIR-V backend, "\
+                      "e.g. ampere-unknown-linux or rdna3-unknown-linux.")
   iree_compile_parser.add_argument(
                       '--iree-hal-benchmark-dispatch-repeat-count', '--batch-size', \
                       dest="batch_size", default=100,
@@ -137,6 +147,13 @@ def add_performance_report_arguments(parser):
                       help="Inserts leading columns in output table and uniform "\
                         "values for each column. Useful for generating pivot tables.")
 
+  performance_report_parser.add_argument("--peak-gflops", default=0.0, \
+                      type=float, help="Measured peak compute throughput of "\
+                      "the device in GFLOP/s for the roofline report.")
+  performance_report_parser.add_argument("--peak-memory-bandwidth", \
+                      default=0.0, type=float, help="Measured peak memory "\
+                      "bandwidth of the device in GB/s for the roofline report.")
+
 
 ###############################################################################
 # Parser all the arguments for a script function:
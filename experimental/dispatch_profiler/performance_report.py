@@ -2,6 +2,30 @@ import csv
 import os
 import numpy as np
 from collections import namedtuple
+from library import *
+
+
+class Roofline:
+  """Roofline model of a device built from its measured peak compute
+  throughput and memory bandwidth. A dispatch with an arithmetic intensity
+  (flops per byte) below the ridge point is bound by memory bandwidth."""
+
+  def __init__(self, peak_gflops, peak_bandwidth):
+    self.peak_gflops = peak_gflops  # in GFLOP/s
+    self.peak_bandwidth = peak_bandwidth  # in GB/s
+
+  def ridge_point(self):
+    """Returns the arithmetic intensity at which compute becomes the bound."""
+    return self.peak_gflops / self.peak_bandwidth
+
+  def attainable_gflops(self, arithmetic_intensity):
+    """Returns the upper bound on GFLOP/s at the arithmetic intensity."""
+    return min(self.peak_gflops, arithmetic_intensity * self.peak_bandwidth)
+
+  def bound(self, arithmetic_intensity):
+    """Returns the resource bounding a dispatch at the arithmetic intensity."""
+    return 'compute' if arithmetic_intensity >= self.ridge_point(
+    ) else 'memory'
 
 
 class PerformanceResult:
@@ -13,10 +37,16 @@ class PerformanceResult:
     self.verification_result = verification_result
     self.bytes = operation.bytes()
     self.flops = operation.flops()
+    self.arithmetic_intensity = float(self.flops) / self.bytes
     self.runtime = runtime  # in milliseconds
     self.gflops = float(self.flops) / self.runtime / 1.0e6
+    self.bandwidth = float(self.bytes) / self.runtime / 1.0e6  # in GB/s
+
+  def roofline_efficiency(self, roofline):
+    """Returns the fraction of the attainable GFLOP/s that was achieved."""
+    return self.gflops / roofline.attainable_gflops(self.arithmetic_intensity)
 
-  def print(self):
+  def print(self, roofline=None):
     """Prints the performance result to the console."""
     runtime = (str(self.runtime) if self.runtime != -1.0 else 'Not profiled')
     gflops = (str(float(round(self.gflops, 2)))
@@ -34,13 +64,19 @@ class PerformanceResult:
     print('Flops         : %d' % self.flops)
     print('Runtime(ms)   : %s' % runtime)
     print('GFLOP/s       : %s' % gflops)
-
-  def create_dict_entry(self):
+    if roofline is not None and self.runtime != -1.0:
+      print('GB/s          : %.2f' % self.bandwidth)
+      print('Roofline      : %.1f%% of %.2f GFLOP/s (%s bound)' %
+            (100.0 * self.roofline_efficiency(roofline),
+             roofline.attainable_gflops(self.arithmetic_intensity),
+             roofline.bound(self.arithmetic_intensity)))
+
+  def create_dict_entry(self, roofline=None):
     """Returns a dictionary with the performance result."""
     runtime = self.runtime if self.runtime != -1.0 else ''
     gflops = (float(round(self.gflops, 2))
               if self.runtime != -1.0 else 'Not run')
-    return {
+    entry = {
         'Provider': 'IREE Codegen',
         'Operation': self.operation.name(),
         'Configuration': self.configuration.name(),
@@ -50,6 +86,20 @@ class PerformanceResult:
         'Runtime(ms)': runtime,
         'GFLOP/s': gflops,
     }
+    if roofline is not None:
+      profiled = self.runtime != -1.0
+      entry.update({
+          'GB/s':
+              float(round(self.bandwidth, 2)) if profiled else '',
+          'Arithmetic intensity':
+              float(round(self.arithmetic_intensity, 2)),
+          'Bound':
+              roofline.bound(self.arithmetic_intensity),
+          'Roofline(%)':
+              float(round(100.0 * self.roofline_efficiency(roofline), 2))
+              if profiled else '',
+      })
+    return entry
 
 
 class PerformanceReport:
@@ -71,6 +121,11 @@ class PerformanceReport:
     if args.tags != '':
       self.tags = args.tags.split(',')
 
+    # Roofline of the device if its peak compute and bandwidth are known.
+    self.roofline = None
+    if args.peak_gflops > 0 and args.peak_memory_bandwidth > 0:
+      self.roofline = Roofline(args.peak_gflops, args.peak_memory_bandwidth)
+
     # If the args.output set, open the file and write the header.
     if self.output_file_path != '':
       open_mode = 'a' if self.args.append else 'w'
@@ -82,6 +137,8 @@ class PerformanceReport:
           'Verification', 'Bytes', 'Flops', 'Runtime(ms)', 'GFLOP/s'
       ]
       csv_header = common_header + performance_header
+      if self.roofline is not None:
+        csv_header += ['GB/s', 'Arithmetic intensity', 'Bound', 'Roofline(%)']
 
       # If tags are present, add the tags.keys() to the csv header.
       if len(self.tags):
@@ -108,7 +165,7 @@ class PerformanceReport:
 
     if self.output_file_path != '':
       # Create the row entries for performance result.
-      csv_dict_row = performance_result.create_dict_entry()
+      csv_dict_row = performance_result.create_dict_entry(self.roofline)
 
       # Create the row entries for tags.
       for tag in self.tags:
@@ -117,3 +174,45 @@ class PerformanceReport:
 
       # Write the row.
       self.csv_writer.writerow(csv_dict_row)
+
+  def print_roofline_summary(self):
+    """Prints the best configuration of each operation against the roofline.
+    The default and ukernel configurations are listed alongside to compare the
+    heuristics in KernelConfig.cpp/KernelDispatch.cpp with the tuned best."""
+    if self.roofline is None:
+      return
+
+    # Group the profiled results by operation preserving the profiling order.
+    results_by_operation = {}
+    for result in self.perf_result_vector:
+      if result.runtime == -1.0:
+        continue
+      results_by_operation.setdefault(result.operation.name(),
+                                      []).append(result)
+
+    print('================================================================ ')
+    print('Roofline: peak %.2f GFLOP/s, %.2f GB/s, ridge point %.2f FLOP/byte' %
+          (self.roofline.peak_gflops, self.roofline.peak_bandwidth,
+           self.roofline.ridge_point()))
+    for operation_name, results in results_by_operation.items():
+      best = max(results, key=lambda result: result.gflops)
+      print('---------------------------------------------------------------- ')
+      print('Operation     : %s' % operation_name)
+      print('Intensity     : %.2f FLOP/byte (%s bound)' %
+            (best.arithmetic_intensity,
+             self.roofline.bound(best.arithmetic_intensity)))
+      print('Attainable    : %.2f GFLOP/s' %
+            self.roofline.attainable_gflops(best.arithmetic_intensity))
+      self._print_roofline_entry('Best', best)
+      for result in results:
+        config_type = result.configuration.config_type
+        if config_type != CompilationConfigType.Custom:
+          self._print_roofline_entry(
+              CompilationConfigTypeName[config_type].title(), result)
+
+  def _print_roofline_entry(self, label, result):
+    """Prints a single profiled result against the roofline."""
+    print('%-14s: %.2f GFLOP/s, %.1f%% of roofline (%s)' %
+          (label, result.gflops,
+           100.0 * result.roofline_efficiency(self.roofline),
+           result.configuration.name()))
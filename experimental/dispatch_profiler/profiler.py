@@ -67,8 +67,8 @@ if __name__ == "__main__":
 
         # Compile the operation dispatches for verification and profiling.
         if args.compile_only:
-          operation_launcher.compile(CompilationMode.Verify)
-          operation_launcher.compile(CompilationMode.Profile)
+          operation_launcher.compile(CompilationMode.Verify, configuration)
+          operation_launcher.compile(CompilationMode.Profile, configuration)
 
         else:
           # Initialize verification and profiling results.
@@ -87,7 +87,10 @@ if __name__ == "__main__":
             result = PerformanceResult(operation_collection.operation,
                                        configuration, verification_result,
                                        runtime)
-            result.print()
+            result.print(perf_report.roofline)
 
             # Append the performance result to the performance report.
             perf_report.append_perf_result(result)
+
+  # Summarize the profiled dispatches of each operation against the roofline.
+  perf_report.print_roofline_summary()
@@ -16,6 +16,71 @@
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// iree_hal_rocm_device_t
+//===----------------------------------------------------------------------===//
+
+// Defines how command buffers are recorded and executed.
+typedef enum iree_hal_rocm_command_buffer_mode_e {
+  // Command buffers are recorded into HIP graphs and launched on submission.
+  IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH = 0,
+  // Command buffers are directly issued against a HIP stream as they are
+  // recorded.
+  IREE_HAL_ROCM_COMMAND_BUFFER_MODE_DIRECT = 1,
+} iree_hal_rocm_command_buffer_mode_t;
+
+// Parameters defining a hipMemPool_t.
+typedef struct iree_hal_rocm_memory_pool_params_t {
+  // Minimum number of bytes to keep in the pool when trimming with
+  // iree_hal_device_trim.
+  uint64_t minimum_capacity;
+  // Soft maximum number of bytes to keep in the pool.
+  // When more than this is allocated the extra will be freed at the next
+  // device synchronization in order to remain under the threshold.
+  uint64_t release_threshold;
+} iree_hal_rocm_memory_pool_params_t;
+
+// Parameters configuring an iree_hal_rocm_device_t.
+// Must be initialized with iree_hal_rocm_device_params_initialize prior to use.
+typedef struct iree_hal_rocm_device_params_t {
+  // Number of queues exposed on the device.
+  // Each queue acts as a separate synchronization scope where all work executes
+  // concurrently unless prohibited by semaphores. Each queue has its own HIP
+  // stream and queue affinities map to queues modulo the queue count.
+  iree_host_size_t queue_count;
+
+  // Total size of each block in the device shared block pool.
+  // Larger sizes will lower overhead and ensure the heap isn't hit for
+  // transient allocations while also increasing memory consumption.
+  iree_host_size_t arena_block_size;
+
+  // Specifies how command buffers are recorded and executed.
+  iree_hal_rocm_command_buffer_mode_t command_buffer_mode;
+
+  // Enables stream-ordered queue allocations (hipMallocFromPoolAsync) when
+  // supported by the device. When disabled or unsupported queue allocations
+  // are performed synchronously with the device allocator.
+  bool async_allocations;
+
+  // Enables tracing of command buffers when IREE tracing is enabled.
+  // Dispatches issued directly to streams get their own GPU zones while graph
+  // command buffers are traced as a single zone per launch.
+  //
+  // NOTE: tracing has a non-trivial overhead and will skew the timing of
+  // submissions and introduce false barriers between dispatches. Use this to
+  // identify slow dispatches and refine from there; be wary of whole-program
+  // tracing with this enabled.
+  bool stream_tracing;
+
+  // Parameters for the hipMemPool_t used for DEVICE_LOCAL queue-ordered
+  // allocations.
+  iree_hal_rocm_memory_pool_params_t device_local_pool;
+} iree_hal_rocm_device_params_t;
+
+// Initializes |out_params| to default values.
+IREE_API_EXPORT void iree_hal_rocm_device_params_initialize(
+    iree_hal_rocm_device_params_t *out_params);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_rocm_driver_t
 //===----------------------------------------------------------------------===//
@@ -35,6 +100,7 @@ IREE_API_EXPORT void iree_hal_rocm_driver_options_initialize(
 // |out_driver| must be released by the caller (see |iree_hal_driver_release|).
 IREE_API_EXPORT iree_status_t iree_hal_rocm_driver_create(
     iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t *default_params,
     const iree_hal_rocm_driver_options_t *options,
     iree_allocator_t host_allocator, iree_hal_driver_t **out_driver);
 
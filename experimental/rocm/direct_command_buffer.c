@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "experimental/rocm/dynamic_symbols.h"
 #include "experimental/rocm/native_executable.h"
@@ -25,6 +26,9 @@
 typedef struct {
   iree_hal_command_buffer_t base;
   iree_hal_rocm_context_wrapper_t* context;
+  iree_hal_rocm_tracing_context_t* tracing_context;
+  // Stream all commands are issued to as they are recorded.
+  hipStream_t stream;
   iree_arena_block_pool_t* block_pool;
 
   // Keep track of the current set of kernel arguments.
@@ -48,10 +52,11 @@ iree_hal_rocm_direct_command_buffer_cast(
 
 iree_status_t iree_hal_rocm_direct_command_buffer_create(
     iree_hal_device_t* device, iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_tracing_context_t* tracing_context,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_arena_block_pool_t* block_pool,
+    hipStream_t stream, iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(block_pool);
@@ -76,6 +81,8 @@ iree_status_t iree_hal_rocm_direct_command_buffer_create(
         device, mode, command_categories, queue_affinity, binding_capacity,
         &iree_hal_rocm_direct_command_buffer_vtable, &command_buffer->base);
     command_buffer->context = context;
+    command_buffer->tracing_context = tracing_context;
+    command_buffer->stream = stream;
     command_buffer->block_pool = block_pool;
     hipDeviceptr_t* device_ptrs =
         (hipDeviceptr_t*)(command_buffer->current_descriptor +
@@ -119,11 +126,28 @@ static void* iree_hal_rocm_direct_command_buffer_dyn_cast(
 
 static iree_status_t iree_hal_rocm_direct_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_rocm_direct_command_buffer_t* command_buffer =
+      iree_hal_rocm_direct_command_buffer_cast(base_command_buffer);
+  (void)command_buffer;
+
+  IREE_ROCM_TRACE_ZONE_BEGIN_EXTERNAL(
+      command_buffer->tracing_context, command_buffer->stream,
+      /*file_name=*/NULL, 0,
+      /*line=*/0, /*func_name=*/NULL, 0, "iree_hal_rocm_direct_command_buffer",
+      strlen("iree_hal_rocm_direct_command_buffer"));
+
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_rocm_direct_command_buffer_end(
     iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_rocm_direct_command_buffer_t* command_buffer =
+      iree_hal_rocm_direct_command_buffer_cast(base_command_buffer);
+  (void)command_buffer;
+
+  IREE_ROCM_TRACE_ZONE_END(command_buffer->tracing_context,
+                           command_buffer->stream);
+
   return iree_ok_status();
 }
 
@@ -131,12 +155,25 @@ static void iree_hal_rocm_direct_command_buffer_begin_debug_group(
     iree_hal_command_buffer_t* base_command_buffer, iree_string_view_t label,
     iree_hal_label_color_t label_color,
     const iree_hal_label_location_t* location) {
-  // TODO(benvanik): tracy event stack.
+  iree_hal_rocm_direct_command_buffer_t* command_buffer =
+      iree_hal_rocm_direct_command_buffer_cast(base_command_buffer);
+  (void)command_buffer;
+
+  IREE_ROCM_TRACE_ZONE_BEGIN_EXTERNAL(
+      command_buffer->tracing_context, command_buffer->stream,
+      location ? location->file.data : NULL, location ? location->file.size : 0,
+      location ? location->line : 0, /*func_name=*/NULL, 0, label.data,
+      label.size);
 }
 
 static void iree_hal_rocm_direct_command_buffer_end_debug_group(
     iree_hal_command_buffer_t* base_command_buffer) {
-  // TODO(benvanik): tracy event stack.
+  iree_hal_rocm_direct_command_buffer_t* command_buffer =
+      iree_hal_rocm_direct_command_buffer_cast(base_command_buffer);
+  (void)command_buffer;
+
+  IREE_ROCM_TRACE_ZONE_END(command_buffer->tracing_context,
+                           command_buffer->stream);
 }
 
 static iree_status_t iree_hal_rocm_direct_command_buffer_execution_barrier(
@@ -199,27 +236,28 @@ static iree_status_t iree_hal_rocm_direct_command_buffer_fill_buffer(
   hipDeviceptr_t dst =
       (hipDeviceptr_t)((uintptr_t)target_device_buffer + target_offset);
   size_t num_elements = length / pattern_length;
-  // TODO(raikonenfnu): Currently using NULL stream, need to figure out way to
-  // access proper stream from command buffer
   switch (pattern_length) {
     case 4: {
       ROCM_RETURN_IF_ERROR(
           command_buffer->context->syms,
-          hipMemsetD32Async(dst, *(const uint32_t*)(pattern), num_elements, 0),
+          hipMemsetD32Async(dst, *(const uint32_t*)(pattern), num_elements,
+                            command_buffer->stream),
           "hipMemsetD32Async");
       break;
     }
     case 2: {
       ROCM_RETURN_IF_ERROR(
           command_buffer->context->syms,
-          hipMemsetD16Async(dst, *(const uint16_t*)(pattern), num_elements, 0),
+          hipMemsetD16Async(dst, *(const uint16_t*)(pattern), num_elements,
+                            command_buffer->stream),
           "hipMemsetD16Async");
       break;
     }
     case 1: {
       ROCM_RETURN_IF_ERROR(
           command_buffer->context->syms,
-          hipMemsetD8Async(dst, *(const uint8_t*)(pattern), num_elements, 0),
+          hipMemsetD8Async(dst, *(const uint8_t*)(pattern), num_elements,
+                           command_buffer->stream),
           "hipMemsetD*Async");
       break;
     }
@@ -256,11 +294,10 @@ static iree_status_t iree_hal_rocm_direct_command_buffer_copy_buffer(
       (hipDeviceptr_t)((uintptr_t)target_device_buffer + target_offset);
   hipDeviceptr_t src =
       (hipDeviceptr_t)((uintptr_t)source_device_buffer + source_offset);
-  // TODO(raikonenfnu): Currently using NULL stream, need to figure out way to
-  // access proper stream from command buffer
   ROCM_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      hipMemcpyAsync(dst, src, length, hipMemcpyDeviceToDevice, 0),
+      hipMemcpyAsync(dst, src, length, hipMemcpyDeviceToDevice,
+                     command_buffer->stream),
       "hipMemcpyAsync");
   return iree_ok_status();
 }
@@ -361,20 +398,23 @@ static iree_status_t iree_hal_rocm_direct_command_buffer_dispatch(
         command_buffer->push_constant[i];
   }
 
-  int32_t block_size_x, block_size_y, block_size_z;
+  uint32_t block_size_x, block_size_y, block_size_z;
   IREE_RETURN_IF_ERROR(iree_hal_rocm_native_executable_block_size(
       executable, entry_point, &block_size_x, &block_size_y, &block_size_z));
   hipFunction_t func =
       iree_hal_rocm_native_executable_for_entry_point(executable, entry_point);
-  // TODO(raikonenfnu): Currently using NULL stream, need to figure out way to
-  // access proper stream from command buffer
-  ROCM_RETURN_IF_ERROR(
+  IREE_ROCM_TRACE_ZONE_BEGIN(command_buffer->tracing_context,
+                             command_buffer->stream);
+  iree_status_t status = ROCM_RESULT_TO_STATUS(
       command_buffer->context->syms,
       hipModuleLaunchKernel(func, workgroup_x, workgroup_y, workgroup_z,
-                            block_size_x, block_size_y, block_size_z, 0, 0,
+                            block_size_x, block_size_y, block_size_z, 0,
+                            command_buffer->stream,
                             command_buffer->current_descriptor, NULL),
       "hipModuleLaunchKernel");
-  return iree_ok_status();
+  IREE_ROCM_TRACE_ZONE_END(command_buffer->tracing_context,
+                           command_buffer->stream);
+  return status;
 }
 
 static iree_status_t iree_hal_rocm_direct_command_buffer_dispatch_indirect(
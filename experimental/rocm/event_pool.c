@@ -0,0 +1,79 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/rocm/event_pool.h"
+
+#include <string.h>
+
+#include "experimental/rocm/status_util.h"
+#include "iree/base/tracing.h"
+
+void iree_hal_rocm_event_pool_initialize(
+    iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_event_pool_t* out_pool) {
+  memset(out_pool, 0, sizeof(*out_pool));
+  out_pool->context = context;
+  iree_slim_mutex_initialize(&out_pool->mutex);
+}
+
+void iree_hal_rocm_event_pool_deinitialize(iree_hal_rocm_event_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_EQ(pool->available_count, pool->created_count,
+                 "events still acquired from the pool");
+  for (iree_host_size_t i = 0; i < pool->available_count; ++i) {
+    ROCM_IGNORE_ERROR(pool->context->syms, hipEventDestroy(pool->events[i]));
+  }
+  iree_allocator_free(pool->context->host_allocator, pool->events);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  memset(pool, 0, sizeof(*pool));
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_rocm_event_pool_acquire(iree_hal_rocm_event_pool_t* pool,
+                                               hipEvent_t* out_event) {
+  *out_event = NULL;
+
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool->available_count > 0) {
+    // Fast path: reuse an available event.
+    *out_event = pool->events[--pool->available_count];
+    iree_slim_mutex_unlock(&pool->mutex);
+    return iree_ok_status();
+  }
+
+  // Reserve a slot for the new event so that it can always be released.
+  iree_status_t status = iree_ok_status();
+  if (pool->created_count == pool->capacity) {
+    iree_host_size_t new_capacity = iree_max(16, pool->capacity * 2);
+    status = iree_allocator_realloc(pool->context->host_allocator,
+                                    new_capacity * sizeof(*pool->events),
+                                    (void**)&pool->events);
+    if (iree_status_is_ok(status)) pool->capacity = new_capacity;
+  }
+  if (iree_status_is_ok(status)) ++pool->created_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (!iree_status_is_ok(status)) return status;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  status = ROCM_RESULT_TO_STATUS(
+      pool->context->syms,
+      hipEventCreateWithFlags(out_event, hipEventDisableTiming),
+      "hipEventCreateWithFlags");
+  if (!iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&pool->mutex);
+    --pool->created_count;
+    iree_slim_mutex_unlock(&pool->mutex);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_rocm_event_pool_release(iree_hal_rocm_event_pool_t* pool,
+                                      hipEvent_t event) {
+  iree_slim_mutex_lock(&pool->mutex);
+  pool->events[pool->available_count++] = event;
+  iree_slim_mutex_unlock(&pool->mutex);
+}
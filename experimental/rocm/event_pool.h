@@ -0,0 +1,60 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_ROCM_EVENT_POOL_H_
+#define IREE_HAL_ROCM_EVENT_POOL_H_
+
+#include "experimental/rocm/context_wrapper.h"
+#include "experimental/rocm/rocm_headers.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A pool of hipEvent_ts used to order work against semaphore signals.
+//
+// Events are created on demand when the pool is empty and returned to the pool
+// for reuse instead of being destroyed. Releasing an event makes no HIP calls
+// and never allocates so that it is safe to do from HIP host functions.
+typedef struct iree_hal_rocm_event_pool_t {
+  // HIP context the events are created in.
+  iree_hal_rocm_context_wrapper_t* context;
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+  // Total number of events created by the pool. |events| always has capacity
+  // for all of them so that releases need not grow it.
+  iree_host_size_t created_count;
+  iree_host_size_t capacity;
+  // Events available for reuse.
+  iree_host_size_t available_count;
+  hipEvent_t* events;
+} iree_hal_rocm_event_pool_t;
+
+// Initializes an empty event pool in |out_pool|.
+void iree_hal_rocm_event_pool_initialize(
+    iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_event_pool_t* out_pool);
+
+// Deinitializes |pool| and destroys all available events. All events acquired
+// from the pool must have been released.
+void iree_hal_rocm_event_pool_deinitialize(iree_hal_rocm_event_pool_t* pool);
+
+// Acquires an event from |pool|, creating one if none are available.
+// Must not be called from HIP host functions.
+iree_status_t iree_hal_rocm_event_pool_acquire(iree_hal_rocm_event_pool_t* pool,
+                                               hipEvent_t* out_event);
+
+// Returns |event| to |pool| for reuse. Safe to call from HIP host functions.
+void iree_hal_rocm_event_pool_release(iree_hal_rocm_event_pool_t* pool,
+                                      hipEvent_t event);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_ROCM_EVENT_POOL_H_
@@ -7,15 +7,45 @@
 #include "experimental/rocm/event_semaphore.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/utils/semaphore_base.h"
 
+// Sentinel used to indicate that the semaphore has failed and an error status
+// is set.
+#define IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE UINT64_MAX
+
+// A value that will be signaled once the work issued to a stream prior to
+// recording |event| completes.
+typedef struct iree_hal_rocm_semaphore_signal_t {
+  uint64_t value;
+  hipEvent_t event;
+} iree_hal_rocm_semaphore_signal_t;
+
 typedef struct iree_hal_rocm_semaphore_t {
   iree_hal_semaphore_t base;
   iree_hal_rocm_context_wrapper_t* context;
-  iree_atomic_int64_t value;
+  iree_hal_rocm_event_pool_t* event_pool;
+  iree_notification_t* notification;
+
+  // Guards all mutable fields.
+  iree_slim_mutex_t mutex;
+
+  // Current signaled value. May be IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE to
+  // indicate that the semaphore has been signaled for failure and
+  // |failure_status| contains the error.
+  uint64_t current_value;
+
+  // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
+  iree_status_t failure_status;
+
+  // Signals issued to streams that have not yet been observed, sorted by
+  // increasing value. Each owns an event acquired from |event_pool|.
+  iree_host_size_t pending_count;
+  iree_host_size_t pending_capacity;
+  iree_hal_rocm_semaphore_signal_t* pending;
 } iree_hal_rocm_semaphore_t;
 
 static const iree_hal_semaphore_vtable_t iree_hal_rocm_semaphore_vtable;
@@ -27,9 +57,12 @@ static iree_hal_rocm_semaphore_t* iree_hal_rocm_semaphore_cast(
 }
 
 iree_status_t iree_hal_rocm_semaphore_create(
-    iree_hal_rocm_context_wrapper_t* context, uint64_t initial_value,
-    iree_hal_semaphore_t** out_semaphore) {
+    iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_event_pool_t* event_pool, iree_notification_t* notification,
+    uint64_t initial_value, iree_hal_semaphore_t** out_semaphore) {
   IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(event_pool);
+  IREE_ASSERT_ARGUMENT(notification);
   IREE_ASSERT_ARGUMENT(out_semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -37,9 +70,15 @@ iree_status_t iree_hal_rocm_semaphore_create(
   iree_status_t status = iree_allocator_malloc(
       context->host_allocator, sizeof(*semaphore), (void**)&semaphore);
   if (iree_status_is_ok(status)) {
+    memset(semaphore, 0, sizeof(*semaphore));
     iree_hal_semaphore_initialize(&iree_hal_rocm_semaphore_vtable,
                                   &semaphore->base);
     semaphore->context = context;
+    semaphore->event_pool = event_pool;
+    semaphore->notification = notification;
+    iree_slim_mutex_initialize(&semaphore->mutex);
+    semaphore->current_value = initial_value;
+    semaphore->failure_status = iree_ok_status();
     *out_semaphore = &semaphore->base;
   }
 
@@ -47,6 +86,23 @@ iree_status_t iree_hal_rocm_semaphore_create(
   return status;
 }
 
+// Returns the events of all pending signals up to and including |value| to the
+// pool. Makes no HIP calls. Must be called with the semaphore mutex held.
+static void iree_hal_rocm_semaphore_retire_signals(
+    iree_hal_rocm_semaphore_t* semaphore, uint64_t value) {
+  iree_host_size_t retired_count = 0;
+  while (retired_count < semaphore->pending_count &&
+         semaphore->pending[retired_count].value <= value) {
+    iree_hal_rocm_event_pool_release(semaphore->event_pool,
+                                     semaphore->pending[retired_count].event);
+    ++retired_count;
+  }
+  if (retired_count == 0) return;
+  semaphore->pending_count -= retired_count;
+  memmove(semaphore->pending, semaphore->pending + retired_count,
+          semaphore->pending_count * sizeof(*semaphore->pending));
+}
+
 static void iree_hal_rocm_semaphore_destroy(
     iree_hal_semaphore_t* base_semaphore) {
   iree_hal_rocm_semaphore_t* semaphore =
@@ -54,39 +110,297 @@ static void iree_hal_rocm_semaphore_destroy(
   iree_allocator_t host_allocator = semaphore->context->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_rocm_semaphore_retire_signals(semaphore, UINT64_MAX);
+  iree_allocator_free(host_allocator, semaphore->pending);
+  iree_slim_mutex_deinitialize(&semaphore->mutex);
+  iree_status_ignore(semaphore->failure_status);
+
   iree_hal_semaphore_deinitialize(&semaphore->base);
   iree_allocator_free(host_allocator, semaphore);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+bool iree_hal_rocm_semaphore_isa(iree_hal_semaphore_t* semaphore) {
+  return iree_hal_resource_is(&semaphore->resource,
+                              &iree_hal_rocm_semaphore_vtable);
+}
+
 static iree_status_t iree_hal_rocm_semaphore_query(
     iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
   iree_hal_rocm_semaphore_t* semaphore =
       iree_hal_rocm_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely.
-  *out_value =
-      iree_atomic_load_int64(&semaphore->value, iree_memory_order_acquire);
-  return iree_ok_status();
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  *out_value = semaphore->current_value;
+
+  iree_status_t status = iree_ok_status();
+  if (*out_value >= IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE) {
+    status = iree_status_clone(semaphore->failure_status);
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  return status;
+}
+
+// Advances the payload to |new_value| and wakes waiters.
+// The semaphore mutex must be held and is released.
+static void iree_hal_rocm_semaphore_advance_and_unlock(
+    iree_hal_rocm_semaphore_t* semaphore, uint64_t new_value) {
+  semaphore->current_value = new_value;
+  iree_hal_rocm_semaphore_retire_signals(semaphore, new_value);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  // Notify waiters and timepoints - note that this must happen outside the
+  // lock.
+  iree_notification_post(semaphore->notification, IREE_ALL_WAITERS);
+  iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
 }
 
 static iree_status_t iree_hal_rocm_semaphore_signal(
     iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
   iree_hal_rocm_semaphore_t* semaphore =
       iree_hal_rocm_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely. Return OK currently as everything is
-  // synchronized for each submit to allow things to run.
-  iree_hal_semaphore_poll(&semaphore->base);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  if (new_value <= semaphore->current_value) {
+    uint64_t current_value IREE_ATTRIBUTE_UNUSED = semaphore->current_value;
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "semaphore values must be monotonically "
+                            "increasing; current_value=%" PRIu64
+                            ", new_value=%" PRIu64,
+                            current_value, new_value);
+  }
+
+  iree_hal_rocm_semaphore_advance_and_unlock(semaphore, new_value);
   return iree_ok_status();
 }
 
+void iree_hal_rocm_semaphore_notify_signaled(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value) {
+  iree_hal_rocm_semaphore_t* semaphore =
+      iree_hal_rocm_semaphore_cast(base_semaphore);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Signals from different streams may complete out of order and failed
+  // semaphores stay failed.
+  if (value <= semaphore->current_value) {
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return;
+  }
+
+  iree_hal_rocm_semaphore_advance_and_unlock(semaphore, value);
+}
+
 static void iree_hal_rocm_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
                                          iree_status_t status) {
   iree_hal_rocm_semaphore_t* semaphore =
       iree_hal_rocm_semaphore_cast(base_semaphore);
-  // TODO: save status and mark timepoint as failed.
-  iree_status_ignore(status);
-  iree_hal_semaphore_poll(&semaphore->base);
+  const iree_status_code_t status_code = iree_status_code(status);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Try to set our local status - we only preserve the first failure so only
+  // do this if we are going from a valid semaphore to a failed one.
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Previous status was not OK; drop our new status.
+    IREE_IGNORE_ERROR(status);
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return;
+  }
+
+  // Signal to our failure sentinel value. Pending signals can no longer be
+  // waited on.
+  semaphore->current_value = IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE;
+  semaphore->failure_status = status;
+  iree_hal_rocm_semaphore_retire_signals(semaphore, UINT64_MAX);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  // Notify waiters and timepoints - note that this must happen outside the
+  // lock.
+  iree_notification_post(semaphore->notification, IREE_ALL_WAITERS);
+  iree_hal_semaphore_notify(&semaphore->base,
+                            IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE, status_code);
+}
+
+iree_status_t iree_hal_rocm_semaphore_stream_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value, hipStream_t stream,
+    bool* out_waited) {
+  iree_hal_rocm_semaphore_t* semaphore =
+      iree_hal_rocm_semaphore_cast(base_semaphore);
+  *out_waited = false;
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  iree_status_t status = iree_ok_status();
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    status = iree_status_from_code(IREE_STATUS_ABORTED);
+  } else if (semaphore->current_value >= value) {
+    // Fast path: already satisfied.
+    *out_waited = true;
+  } else {
+    // Wait on the earliest pending signal that satisfies the value; the event
+    // cannot be retired and reused while we hold the lock.
+    for (iree_host_size_t i = 0; i < semaphore->pending_count; ++i) {
+      if (semaphore->pending[i].value < value) continue;
+      status = ROCM_RESULT_TO_STATUS(
+          semaphore->context->syms,
+          hipStreamWaitEvent(stream, semaphore->pending[i].event, 0),
+          "hipStreamWaitEvent");
+      *out_waited = iree_status_is_ok(status);
+      break;
+    }
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return status;
+}
+
+bool iree_hal_rocm_semaphore_can_stream_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value) {
+  iree_hal_rocm_semaphore_t* semaphore =
+      iree_hal_rocm_semaphore_cast(base_semaphore);
+  iree_slim_mutex_lock(&semaphore->mutex);
+  // Pending signals are sorted so the last has the largest value.
+  bool can_wait =
+      semaphore->current_value >= value ||
+      (semaphore->pending_count > 0 &&
+       semaphore->pending[semaphore->pending_count - 1].value >= value);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return can_wait;
+}
+
+iree_status_t iree_hal_rocm_semaphore_stream_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value, hipStream_t stream) {
+  iree_hal_rocm_semaphore_t* semaphore =
+      iree_hal_rocm_semaphore_cast(base_semaphore);
+
+  hipEvent_t event = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_rocm_event_pool_acquire(semaphore->event_pool, &event));
+  iree_status_t status =
+      ROCM_RESULT_TO_STATUS(semaphore->context->syms,
+                          hipEventRecord(event, stream), "hipEventRecord");
+  if (!iree_status_is_ok(status)) {
+    iree_hal_rocm_event_pool_release(semaphore->event_pool, event);
+    return status;
+  }
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Values already reached (or failed semaphores) need no event.
+  if (value <= semaphore->current_value) {
+    iree_hal_rocm_event_pool_release(semaphore->event_pool, event);
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_ok_status();
+  }
+
+  if (semaphore->pending_count == semaphore->pending_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(4, semaphore->pending_capacity * 2);
+    status = iree_allocator_realloc(
+        semaphore->context->host_allocator,
+        new_capacity * sizeof(*semaphore->pending),
+        (void**)&semaphore->pending);
+    if (iree_status_is_ok(status)) {
+      semaphore->pending_capacity = new_capacity;
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    // Keep sorted by value; signals are usually issued in increasing order.
+    iree_host_size_t i = semaphore->pending_count;
+    while (i > 0 && semaphore->pending[i - 1].value > value) {
+      semaphore->pending[i] = semaphore->pending[i - 1];
+      --i;
+    }
+    semaphore->pending[i].value = value;
+    semaphore->pending[i].event = event;
+    ++semaphore->pending_count;
+  } else {
+    iree_hal_rocm_event_pool_release(semaphore->event_pool, event);
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  // Work deferred until the value was signaled by a stream can now be issued.
+  if (iree_status_is_ok(status)) {
+    iree_notification_post(semaphore->notification, IREE_ALL_WAITERS);
+  }
+  return status;
+}
+
+typedef struct iree_hal_rocm_semaphore_wait_state_t {
+  iree_hal_wait_mode_t wait_mode;
+  const iree_hal_semaphore_list_t* semaphore_list;
+} iree_hal_rocm_semaphore_wait_state_t;
+
+static bool iree_hal_rocm_semaphore_is_reached(
+    iree_hal_rocm_semaphore_t* semaphore, uint64_t value) {
+  iree_slim_mutex_lock(&semaphore->mutex);
+  bool is_reached = semaphore->current_value >= value;
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return is_reached;
+}
+
+// Returns true if the wait is satisfied or any semaphore has failed; failed
+// semaphores are at the failure value and always reached.
+static bool iree_hal_rocm_semaphore_wait_condition(void* arg) {
+  const iree_hal_rocm_semaphore_wait_state_t* state =
+      (const iree_hal_rocm_semaphore_wait_state_t*)arg;
+  const iree_hal_semaphore_list_t* list = state->semaphore_list;
+  bool any_reached = false;
+  bool all_reached = true;
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    bool is_reached = iree_hal_rocm_semaphore_is_reached(
+        iree_hal_rocm_semaphore_cast(list->semaphores[i]),
+        list->payload_values[i]);
+    any_reached |= is_reached;
+    all_reached &= is_reached;
+  }
+  return state->wait_mode == IREE_HAL_WAIT_MODE_ANY ? any_reached
+                                                   : all_reached;
+}
+
+iree_status_t iree_hal_rocm_semaphore_multi_wait(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_notification_t* notification) {
+  if (semaphore_list.count == 0) return iree_ok_status();
+
+  iree_hal_rocm_semaphore_wait_state_t state = {
+      .wait_mode = wait_mode,
+      .semaphore_list = &semaphore_list,
+  };
+  if (!iree_hal_rocm_semaphore_wait_condition(&state)) {
+    if (iree_timeout_is_immediate(timeout)) {
+      // Not satisfied but a poll, so can avoid the expensive wait work.
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+    IREE_TRACE_ZONE_BEGIN(z0);
+    bool satisfied = iree_notification_await(
+        notification, iree_hal_rocm_semaphore_wait_condition, &state, timeout);
+    IREE_TRACE_ZONE_END(z0);
+    if (!satisfied) {
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+  }
+
+  // Return an error to tell callers to query for any failure.
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    if (iree_hal_rocm_semaphore_is_reached(
+            iree_hal_rocm_semaphore_cast(semaphore_list.semaphores[i]),
+            IREE_HAL_HIP_SEMAPHORE_FAILURE_VALUE)) {
+      return iree_status_from_code(IREE_STATUS_ABORTED);
+    }
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_rocm_semaphore_wait(
@@ -94,10 +408,14 @@ static iree_status_t iree_hal_rocm_semaphore_wait(
     iree_timeout_t timeout) {
   iree_hal_rocm_semaphore_t* semaphore =
       iree_hal_rocm_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely. Return OK currently as everything is
-  // synchronized for each submit to allow things to run.
-  iree_hal_semaphore_poll(&semaphore->base);
-  return iree_ok_status();
+  iree_hal_semaphore_list_t semaphore_list = {
+      .count = 1,
+      .semaphores = &base_semaphore,
+      .payload_values = &value,
+  };
+  return iree_hal_rocm_semaphore_multi_wait(IREE_HAL_WAIT_MODE_ALL,
+                                            semaphore_list, timeout,
+                                            semaphore->notification);
 }
 
 static const iree_hal_semaphore_vtable_t iree_hal_rocm_semaphore_vtable = {
@@ -7,21 +7,71 @@
 #ifndef IREE_HAL_ROCM_SEMAPHORE_H_
 #define IREE_HAL_ROCM_SEMAPHORE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "experimental/rocm/context_wrapper.h"
+#include "experimental/rocm/event_pool.h"
 #include "experimental/rocm/status_util.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
-// Create a rocm allocator.
+// Creates a timeline semaphore that can be signaled and waited on by both the
+// host and HIP streams.
+//
+// Each value a stream will signal has a hipEvent_t from |event_pool| recorded
+// after the signaling work. Streams wait on that event with hipStreamWaitEvent
+// instead of the host blocking on the value. Payload values are advanced on
+// the host once the signaling work completes (see
+// iree_hal_rocm_semaphore_notify_signaled) at which point |notification| is
+// posted to wake host waiters. |notification| is shared by all semaphores of a
+// device so that multi-waits can block on any of them.
 iree_status_t iree_hal_rocm_semaphore_create(
-    iree_hal_rocm_context_wrapper_t* context, uint64_t initial_value,
-    iree_hal_semaphore_t** out_semaphore);
+    iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_event_pool_t* event_pool, iree_notification_t* notification,
+    uint64_t initial_value, iree_hal_semaphore_t** out_semaphore);
+
+// Returns true if |semaphore| is a ROCm semaphore.
+bool iree_hal_rocm_semaphore_isa(iree_hal_semaphore_t* semaphore);
+
+// Orders work subsequently issued to |stream| after |semaphore| reaches
+// |value|. Sets |out_waited| to false if the value has not yet been signaled
+// nor has any work been issued to signal it; callers must then wait on the
+// host instead.
+iree_status_t iree_hal_rocm_semaphore_stream_wait(
+    iree_hal_semaphore_t* semaphore, uint64_t value, hipStream_t stream,
+    bool* out_waited);
+
+// Returns true if a wait for |semaphore| to reach |value| can be issued to a
+// stream without blocking the host: the value has been reached (or the
+// semaphore has failed) or work to signal it has been issued to a stream.
+bool iree_hal_rocm_semaphore_can_stream_wait(iree_hal_semaphore_t* semaphore,
+                                             uint64_t value);
+
+// Records that |semaphore| will be signaled to |value| once the work issued to
+// |stream| so far completes. The host payload is updated when the caller
+// observes the completion with iree_hal_rocm_semaphore_notify_signaled.
+iree_status_t iree_hal_rocm_semaphore_stream_signal(
+    iree_hal_semaphore_t* semaphore, uint64_t value, hipStream_t stream);
+
+// Advances the payload of |semaphore| to |value| after the work signaling it
+// has completed. Values may be observed out of order when signaled from
+// multiple streams and lower values are ignored. Makes no HIP calls and is
+// safe to call from HIP host functions.
+void iree_hal_rocm_semaphore_notify_signaled(iree_hal_semaphore_t* semaphore,
+                                             uint64_t value);
+
+// Waits on the host until |semaphore_list| is satisfied per |wait_mode|.
+// All semaphores must be ROCm semaphores sharing |notification|.
+iree_status_t iree_hal_rocm_semaphore_multi_wait(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_notification_t* notification);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -0,0 +1,226 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/rocm/memory_pools.h"
+
+#include <string.h>
+
+#include "experimental/rocm/dynamic_symbols.h"
+#include "experimental/rocm/rocm_buffer.h"
+#include "experimental/rocm/status_util.h"
+#include "iree/base/tracing.h"
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+static const char* IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID =
+    "ROCm pool: device-local reserved";
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
+static iree_status_t iree_hal_rocm_create_memory_pool(
+    iree_hal_rocm_context_wrapper_t* context, hipDevice_t device,
+    const iree_hal_rocm_memory_pool_params_t* params,
+    hipMemPool_t* IREE_RESTRICT out_pool) {
+  *out_pool = NULL;
+
+  hipMemPoolProps pool_props;
+  memset(&pool_props, 0, sizeof(pool_props));
+  pool_props.allocType = hipMemAllocationTypePinned;
+  pool_props.handleTypes = hipMemHandleTypeNone;
+  pool_props.location.type = hipMemLocationTypeDevice;
+  pool_props.location.id = device;
+
+  hipMemPool_t pool = NULL;
+  ROCM_RETURN_IF_ERROR(context->syms, hipMemPoolCreate(&pool, &pool_props),
+                       "hipMemPoolCreate");
+
+  uint64_t release_threshold = params->release_threshold;
+  iree_status_t status = ROCM_RESULT_TO_STATUS(
+      context->syms,
+      hipMemPoolSetAttribute(pool, hipMemPoolAttrReleaseThreshold,
+                             &release_threshold),
+      "hipMemPoolSetAttribute");
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    ROCM_IGNORE_ERROR(context->syms, hipMemPoolDestroy(pool));
+  }
+  return status;
+}
+
+iree_status_t iree_hal_rocm_memory_pools_initialize(
+    iree_hal_rocm_context_wrapper_t* context, hipDevice_t device,
+    hipStream_t stream,
+    const iree_hal_rocm_memory_pool_params_t* device_local_params,
+    iree_hal_rocm_memory_pools_t* IREE_RESTRICT out_pools) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(device_local_params);
+  IREE_ASSERT_ARGUMENT(out_pools);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_pools, 0, sizeof(*out_pools));
+  out_pools->context = context;
+  out_pools->stream = stream;
+
+  // Stream-ordered allocators are optional depending on the device and driver.
+  int memory_pools_supported = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, ROCM_RESULT_TO_STATUS(
+              context->syms,
+              hipDeviceGetAttribute(&memory_pools_supported,
+                                    hipDeviceAttributeMemoryPoolsSupported,
+                                    device),
+              "hipDeviceGetAttribute"));
+  if (!memory_pools_supported) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device does not support HIP memory pools");
+  }
+
+  iree_status_t status = iree_hal_rocm_create_memory_pool(
+      context, device, device_local_params, &out_pools->device_local);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_rocm_memory_pools_deinitialize(
+    iree_hal_rocm_memory_pools_t* pools) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (pools->device_local) {
+    ROCM_IGNORE_ERROR(pools->context->syms,
+                      hipMemPoolDestroy(pools->device_local));
+    pools->device_local = NULL;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_rocm_memory_pools_trim(
+    iree_hal_rocm_memory_pools_t* pools,
+    const iree_hal_rocm_memory_pool_params_t* device_local_params) {
+  ROCM_RETURN_IF_ERROR(
+      pools->context->syms,
+      hipMemPoolTrimTo(pools->device_local,
+                       (size_t)device_local_params->minimum_capacity),
+      "hipMemPoolTrimTo");
+  return iree_ok_status();
+}
+
+// NOTE: this only frees memory if the buffer is destroyed without having been
+// scheduled for deallocation asynchronously. When a buffer is scheduled we
+// clear its device pointer so that we don't double-free here.
+static void iree_hal_rocm_async_buffer_release_callback(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_rocm_memory_pools_t* pools =
+      (iree_hal_rocm_memory_pools_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  hipDeviceptr_t device_ptr = iree_hal_rocm_buffer_device_pointer(buffer);
+  if (device_ptr) {
+    IREE_TRACE_FREE_NAMED(IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID,
+                          (void*)device_ptr);
+    ROCM_IGNORE_ERROR(pools->context->syms,
+                      hipFreeAsync(device_ptr, pools->stream));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_rocm_memory_pools_alloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  // Guard against the corner case where the requested buffer size is 0 to
+  // match the behavior of the synchronous allocator.
+  if (allocation_size == 0) allocation_size = 4;
+
+  // Zero-initialized params (such as an unspecified access) get the same
+  // defaults as they would from the device allocator.
+  iree_hal_buffer_params_canonicalize(&params);
+
+  // Only device-local memory that is not host visible is pooled; everything
+  // else is allocated synchronously by the device allocator.
+  hipMemPool_t memory_pool =
+      iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) &&
+              !iree_any_bit_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)
+          ? pools->device_local
+          : NULL;
+  if (!memory_pool) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no memory pool available for the requested memory type");
+  }
+
+  hipDeviceptr_t device_ptr = NULL;
+  iree_status_t status = ROCM_RESULT_TO_STATUS(
+      pools->context->syms,
+      hipMallocFromPoolAsync(&device_ptr, (size_t)allocation_size, memory_pool,
+                             stream),
+      "hipMallocFromPoolAsync");
+
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_hal_rocm_async_buffer_release_callback,
+        .user_data = pools,
+    };
+    status = iree_hal_rocm_buffer_wrap(
+        /*allocator=*/NULL, pools->context->host_allocator,
+        params.type & ~IREE_HAL_MEMORY_TYPE_OPTIMAL, params.access,
+        params.usage, allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, IREE_HAL_ROCM_BUFFER_TYPE_ASYNC,
+        device_ptr, /*host_ptr=*/NULL, release_callback, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED(IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID,
+                           (void*)device_ptr, allocation_size);
+    *out_buffer = buffer;
+  } else if (device_ptr) {
+    ROCM_IGNORE_ERROR(pools->context->syms, hipFreeAsync(device_ptr, stream));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_rocm_memory_pools_dealloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(
+      z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
+
+  // Only process the request if the buffer came from an async pool.
+  // Synchronously allocated buffers are freed when they are released.
+  iree_status_t status = iree_ok_status();
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (iree_hal_rocm_buffer_type(allocated_buffer) ==
+      IREE_HAL_ROCM_BUFFER_TYPE_ASYNC) {
+    hipDeviceptr_t device_ptr =
+        iree_hal_rocm_buffer_device_pointer(allocated_buffer);
+    if (device_ptr) {
+      // Clear the pointer first so that the release callback doesn't try to
+      // free the memory again when the buffer wrapper is destroyed.
+      iree_hal_rocm_buffer_set_device_pointer(allocated_buffer, NULL);
+      IREE_TRACE_FREE_NAMED(IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID,
+                            (void*)device_ptr);
+      status = ROCM_RESULT_TO_STATUS(pools->context->syms,
+                                     hipFreeAsync(device_ptr, stream),
+                                     "hipFreeAsync");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
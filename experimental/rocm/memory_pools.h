@@ -0,0 +1,68 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_ROCM_MEMORY_POOLS_H_
+#define IREE_HAL_ROCM_MEMORY_POOLS_H_
+
+#include "experimental/rocm/api.h"
+#include "experimental/rocm/context_wrapper.h"
+#include "experimental/rocm/rocm_headers.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Retained HIP memory pools for various allocation types.
+typedef struct iree_hal_rocm_memory_pools_t {
+  // HIP context the pools are attached to.
+  iree_hal_rocm_context_wrapper_t* context;
+  // Stream used for freeing allocations that are released without an explicit
+  // queue-ordered deallocation.
+  hipStream_t stream;
+  // Used exclusively for DEVICE_LOCAL allocations.
+  hipMemPool_t device_local;
+} iree_hal_rocm_memory_pools_t;
+
+// Initializes |out_pools| by configuring new HIP memory pools for |device|.
+// Fails with IREE_STATUS_UNAVAILABLE if the device does not support memory
+// pools; callers should fall back to synchronous allocation in that case.
+iree_status_t iree_hal_rocm_memory_pools_initialize(
+    iree_hal_rocm_context_wrapper_t* context, hipDevice_t device,
+    hipStream_t stream,
+    const iree_hal_rocm_memory_pool_params_t* device_local_params,
+    iree_hal_rocm_memory_pools_t* IREE_RESTRICT out_pools);
+
+// Deinitializes the |pools| and releases the underlying HIP resources.
+void iree_hal_rocm_memory_pools_deinitialize(
+    iree_hal_rocm_memory_pools_t* pools);
+
+// Trims all memory pools by releasing resources back to the system down to
+// the minimum capacity specified in |device_local_params|.
+iree_status_t iree_hal_rocm_memory_pools_trim(
+    iree_hal_rocm_memory_pools_t* pools,
+    const iree_hal_rocm_memory_pool_params_t* device_local_params);
+
+// Asynchronously allocates a buffer from an appropriate pool.
+// The allocation will be stream-ordered on |stream|.
+iree_status_t iree_hal_rocm_memory_pools_alloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer);
+
+// Asynchronously deallocates a buffer from its pool.
+// The deallocation will be stream-ordered on |stream|.
+iree_status_t iree_hal_rocm_memory_pools_dealloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_buffer_t* buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_ROCM_MEMORY_POOLS_H_
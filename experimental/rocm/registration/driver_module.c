@@ -11,8 +11,29 @@
 
 #include "experimental/rocm/api.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
 #include "iree/base/tracing.h"
 
+IREE_FLAG(bool, rocm_use_graphs, true,
+          "Record command buffers into HIP graphs launched on submission "
+          "(instead of issuing them directly as they are recorded).");
+
+IREE_FLAG(int32_t, rocm_queue_count, 1,
+          "Number of queues exposed on each ROCm device, each backed by its "
+          "own HIP stream. Work with different queue affinities may overlap.");
+
+IREE_FLAG(bool, rocm_tracing, true,
+          "Enables tracing of stream events when Tracy instrumentation is "
+          "enabled. Severely impacts benchmark timings and should only be used "
+          "when analyzing dispatch timings.");
+
+IREE_FLAG(bool, rocm_async_allocations, true,
+          "Enables stream-ordered queue allocations using HIP memory pools "
+          "when supported by the device.");
+IREE_FLAG(int64_t, rocm_async_allocation_release_threshold, 0,
+          "Soft maximum number of bytes of reserved memory retained by the "
+          "device-local memory pool across synchronizations.");
+
 static iree_status_t iree_hal_rocm_driver_factory_enumerate(
     void *self, iree_host_size_t *out_driver_info_count,
     const iree_hal_driver_info_t **out_driver_infos) {
@@ -37,10 +58,24 @@ static iree_status_t iree_hal_rocm_driver_factory_try_create(
                             (int)driver_name.size, driver_name.data);
   }
   IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_rocm_device_params_t default_params;
+  iree_hal_rocm_device_params_initialize(&default_params);
+  if (!FLAG_rocm_use_graphs) {
+    default_params.command_buffer_mode =
+        IREE_HAL_ROCM_COMMAND_BUFFER_MODE_DIRECT;
+  }
+  default_params.queue_count = (iree_host_size_t)FLAG_rocm_queue_count;
+  default_params.async_allocations = FLAG_rocm_async_allocations;
+  default_params.stream_tracing = FLAG_rocm_tracing;
+  default_params.device_local_pool.release_threshold =
+      (uint64_t)FLAG_rocm_async_allocation_release_threshold;
+
   iree_hal_rocm_driver_options_t driver_options;
   iree_hal_rocm_driver_options_initialize(&driver_options);
-  iree_status_t status = iree_hal_rocm_driver_create(
-      driver_name, &driver_options, host_allocator, out_driver);
+  iree_status_t status =
+      iree_hal_rocm_driver_create(driver_name, &default_params, &driver_options,
+                                  host_allocator, out_driver);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
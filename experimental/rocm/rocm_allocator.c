@@ -237,10 +237,12 @@ static iree_status_t iree_hal_rocm_allocator_allocate_buffer(
   iree_hal_buffer_t* buffer = NULL;
   if (iree_status_is_ok(status)) {
     status = iree_hal_rocm_buffer_wrap(
-        (iree_hal_allocator_t*)allocator, compat_params.type,
-        compat_params.access, compat_params.usage, allocation_size,
-        /*byte_offset=*/0,
-        /*byte_length=*/allocation_size, device_ptr, host_ptr, &buffer);
+        (iree_hal_allocator_t*)allocator, allocator->context->host_allocator,
+        compat_params.type, compat_params.access, compat_params.usage,
+        allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, IREE_HAL_ROCM_BUFFER_TYPE_DEVICE,
+        device_ptr, host_ptr, iree_hal_buffer_release_callback_null(),
+        &buffer);
   }
 
   // Copy the initial contents into the buffer. This may require staging.
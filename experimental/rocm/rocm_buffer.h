@@ -15,19 +15,44 @@
 extern "C" {
 #endif  // __cplusplus
 
+typedef enum iree_hal_rocm_buffer_type_e {
+  // hipMalloc/hipMallocManaged/hipMemAllocHost + hipFree/hipHostFree
+  IREE_HAL_ROCM_BUFFER_TYPE_DEVICE = 1u << 0,
+  // hipMallocFromPoolAsync + hipFreeAsync
+  IREE_HAL_ROCM_BUFFER_TYPE_ASYNC = 1u << 1,
+} iree_hal_rocm_buffer_type_t;
+
 // Wraps a ROCm allocation in an iree_hal_buffer_t.
+// |allocator| is optional and if omitted the buffer will be destroyed when
+// released instead of being returned to the allocator; |host_allocator| is used
+// for the buffer wrapper itself. |release_callback| is called when the buffer
+// is destroyed.
 iree_status_t iree_hal_rocm_buffer_wrap(
-    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_allocator_t* allocator, iree_allocator_t host_allocator,
+    iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
-    hipDeviceptr_t device_ptr, void* host_ptr, iree_hal_buffer_t** out_buffer);
+    iree_hal_rocm_buffer_type_t buffer_type, hipDeviceptr_t device_ptr,
+    void* host_ptr, iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns the underlying ROCm buffer type.
+iree_hal_rocm_buffer_type_t iree_hal_rocm_buffer_type(
+    iree_hal_buffer_t* buffer);
 
 // Returns the ROCm base pointer for the given |buffer|.
 // This is the entire allocated_buffer and must be offset by the buffer
 // byte_offset and byte_length when used.
 hipDeviceptr_t iree_hal_rocm_buffer_device_pointer(iree_hal_buffer_t* buffer);
 
+// Replaces the ROCm base pointer of the given |buffer|.
+// Used by stream-ordered deallocations to indicate that the device memory has
+// already been freed (by setting the pointer to NULL) when the buffer wrapper
+// outlives the allocation.
+void iree_hal_rocm_buffer_set_device_pointer(iree_hal_buffer_t* buffer,
+                                             hipDeviceptr_t device_ptr);
+
 // Returns the ROCm host pointer for the given |buffer|, if available.
 void* iree_hal_rocm_buffer_host_pointer(iree_hal_buffer_t* buffer);
 
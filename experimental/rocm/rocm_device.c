@@ -13,21 +13,70 @@
 #include "experimental/rocm/context_wrapper.h"
 #include "experimental/rocm/direct_command_buffer.h"
 #include "experimental/rocm/dynamic_symbols.h"
+#include "experimental/rocm/event_pool.h"
 #include "experimental/rocm/event_semaphore.h"
+#include "experimental/rocm/graph_command_buffer.h"
+#include "experimental/rocm/memory_pools.h"
 #include "experimental/rocm/nop_executable_cache.h"
 #include "experimental/rocm/pipeline_layout.h"
 #include "experimental/rocm/rocm_allocator.h"
 #include "experimental/rocm/rocm_event.h"
 #include "experimental/rocm/status_util.h"
+#include "experimental/rocm/tracing.h"
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_rocm_device_t
 //===----------------------------------------------------------------------===//
 
-typedef struct iree_hal_rocm_device_t {
+// A device queue backed by its own HIP stream.
+typedef struct iree_hal_rocm_device_queue_t {
+  hipStream_t stream;
+  // Event recorded on |stream| when work issued to other queues needs to be
+  // ordered against work issued to this one with hipStreamWaitEvent.
+  // Only created when the device has more than one queue.
+  hipEvent_t event;
+  // Tracing context for |stream|; NULL if tracing is disabled.
+  iree_hal_rocm_tracing_context_t* tracing_context;
+} iree_hal_rocm_device_queue_t;
+
+typedef struct iree_hal_rocm_device_t iree_hal_rocm_device_t;
+
+// Resources kept live until the work of a queue operation completes.
+// Completed submissions are posted by a HIP host function and reclaimed later
+// by a host thread as host functions must not make HIP calls.
+typedef struct iree_hal_rocm_device_submission_t {
+  struct iree_hal_rocm_device_submission_t* next;
+  iree_hal_rocm_device_t* device;
+  // Retained command buffers referenced by work on the stream.
+  iree_host_size_t command_buffer_count;
+  iree_hal_command_buffer_t** command_buffers;
+  // Retained semaphores signaled when the work completes.
+  iree_hal_semaphore_list_t signal_semaphore_list;
+} iree_hal_rocm_device_submission_t;
+
+// A queue operation that waits on semaphore values that had neither been
+// reached nor had work issued to signal them when it was submitted. It is
+// issued by the deferred thread of the device once they have.
+typedef struct iree_hal_rocm_device_deferred_t {
+  struct iree_hal_rocm_device_deferred_t* next;
+  iree_hal_rocm_device_queue_t* queue;
+  // Retained semaphores waited on and signaled by the operation.
+  iree_hal_semaphore_list_t wait_semaphore_list;
+  iree_hal_semaphore_list_t signal_semaphore_list;
+  // Retained command buffers to execute.
+  iree_host_size_t command_buffer_count;
+  iree_hal_command_buffer_t** command_buffers;
+  // Retained buffer to deallocate or NULL if not a dealloca.
+  iree_hal_buffer_t* dealloca_buffer;
+} iree_hal_rocm_device_deferred_t;
+
+struct iree_hal_rocm_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
 
@@ -39,14 +88,49 @@ typedef struct iree_hal_rocm_device_t {
   // to ensure the symbols remains valid.
   iree_hal_driver_t* driver;
 
+  // Parameters used to control device behavior.
+  iree_hal_rocm_device_params_t params;
+
   hipDevice_t device;
 
-  // TODO: support multiple streams.
-  hipStream_t stream;
   iree_hal_rocm_context_wrapper_t context_wrapper;
   iree_hal_allocator_t* device_allocator;
 
-} iree_hal_rocm_device_t;
+  // Whether |memory_pools| was initialized and can be used for queue-ordered
+  // allocations. Devices without memory pool support fall back to synchronous
+  // allocations.
+  bool supports_memory_pools;
+  // Memory pools used for stream-ordered queue allocations.
+  iree_hal_rocm_memory_pools_t memory_pools;
+
+  // Events used by semaphores to order stream work against signals.
+  iree_hal_rocm_event_pool_t event_pool;
+  // Posted whenever any semaphore created by the device changes value.
+  iree_notification_t semaphore_notification;
+
+  // Submissions whose work has completed and whose resources can be released.
+  iree_slim_mutex_t completion_mutex;
+  iree_hal_rocm_device_submission_t* completed_head;
+
+  // Deferred queue operations in submission order. The thread is created on
+  // first use and woken by |semaphore_notification|, which is posted whenever
+  // a semaphore of the device advances or has a stream signal issued.
+  iree_slim_mutex_t deferred_mutex;
+  iree_hal_rocm_device_deferred_t* deferred_head
+      IREE_GUARDED_BY(deferred_mutex);
+  iree_hal_rocm_device_deferred_t* deferred_tail
+      IREE_GUARDED_BY(deferred_mutex);
+  iree_thread_t* deferred_thread IREE_GUARDED_BY(deferred_mutex);
+  bool deferred_exit_requested IREE_GUARDED_BY(deferred_mutex);
+  // Set by the thread once it will no longer touch the device.
+  bool deferred_exited IREE_GUARDED_BY(deferred_mutex);
+
+  // Queues selected by queue affinity, each with its own stream. Work issued
+  // to different queues may execute concurrently. The first queue is also used
+  // by the memory pools for work not issued to a queue.
+  iree_host_size_t queue_count;
+  iree_hal_rocm_device_queue_t queues[];
+};
 
 static const iree_hal_device_vtable_t iree_hal_rocm_device_vtable;
 
@@ -56,15 +140,138 @@ static iree_hal_rocm_device_t* iree_hal_rocm_device_cast(
   return (iree_hal_rocm_device_t*)base_value;
 }
 
+IREE_API_EXPORT void iree_hal_rocm_device_params_initialize(
+    iree_hal_rocm_device_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->queue_count = 1;
+  out_params->arena_block_size = 32 * 1024;
+  out_params->command_buffer_mode = IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->async_allocations = true;
+}
+
+static iree_status_t iree_hal_rocm_device_check_params(
+    const iree_hal_rocm_device_params_t* params) {
+  if (params->arena_block_size < 4096) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "arena block size too small (< 4096 bytes)");
+  }
+  if (params->queue_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "at least one queue is required");
+  }
+  if (params->queue_count > sizeof(iree_hal_queue_affinity_t) * 8) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue count %" PRIhsz
+                            " exceeds the number of queue affinity bits",
+                            params->queue_count);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_rocm_device_create_queue(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue) {
+  iree_hal_rocm_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  IREE_RETURN_IF_ERROR(ROCM_RESULT_TO_STATUS(
+      syms, hipStreamCreateWithFlags(&queue->stream, hipStreamNonBlocking)));
+  if (device->queue_count > 1) {
+    IREE_RETURN_IF_ERROR(ROCM_RESULT_TO_STATUS(
+        syms, hipEventCreateWithFlags(&queue->event, hipEventDisableTiming)));
+  }
+
+  // Enable tracing for the stream - no-op if disabled.
+  if (device->params.stream_tracing) {
+    IREE_RETURN_IF_ERROR(iree_hal_rocm_tracing_context_allocate(
+        &device->context_wrapper, device->identifier, queue->stream,
+        &device->block_pool, device->context_wrapper.host_allocator,
+        &queue->tracing_context));
+  }
+  return iree_ok_status();
+}
+
+static void iree_hal_rocm_device_destroy_queue(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue) {
+  iree_hal_rocm_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  iree_hal_rocm_tracing_context_free(queue->tracing_context);
+  if (queue->event) {
+    ROCM_IGNORE_ERROR(syms, hipEventDestroy(queue->event));
+  }
+  if (queue->stream) {
+    ROCM_IGNORE_ERROR(syms, hipStreamDestroy(queue->stream));
+  }
+}
+
+static void iree_hal_rocm_device_submission_release(
+    iree_hal_rocm_device_submission_t* submission) {
+  iree_allocator_t host_allocator =
+      submission->device->context_wrapper.host_allocator;
+  for (iree_host_size_t i = 0; i < submission->command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(submission->command_buffers[i]);
+  }
+  for (iree_host_size_t i = 0; i < submission->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_release(submission->signal_semaphore_list.semaphores[i]);
+  }
+  iree_allocator_free(host_allocator, submission);
+}
+
+// Releases the resources of all submissions that have completed.
+static void iree_hal_rocm_device_reclaim_submissions(
+    iree_hal_rocm_device_t* device) {
+  iree_slim_mutex_lock(&device->completion_mutex);
+  iree_hal_rocm_device_submission_t* submission = device->completed_head;
+  device->completed_head = NULL;
+  iree_slim_mutex_unlock(&device->completion_mutex);
+  if (!submission) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  while (submission) {
+    iree_hal_rocm_device_submission_t* next = submission->next;
+    iree_hal_rocm_device_submission_release(submission);
+    submission = next;
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_hal_rocm_device_stop_deferred(iree_hal_rocm_device_t* device);
+
 static void iree_hal_rocm_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Stop issuing deferred work and cancel any that is still waiting.
+  iree_hal_rocm_device_stop_deferred(device);
+
+  // Wait for all in-flight work (including host functions posting completed
+  // submissions) so that nothing references the device after this returns.
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    if (!device->queues[i].stream) continue;
+    ROCM_IGNORE_ERROR(device->context_wrapper.syms,
+                      hipStreamSynchronize(device->queues[i].stream));
+  }
+  iree_hal_rocm_device_reclaim_submissions(device);
+
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
+
+  // Destroy memory pools that hold on to reserved memory. Outstanding
+  // stream-ordered frees have completed above.
+  if (device->supports_memory_pools) {
+    iree_hal_rocm_memory_pools_deinitialize(&device->memory_pools);
+  }
+
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_rocm_device_destroy_queue(device, &device->queues[i]);
+  }
+
+  iree_slim_mutex_deinitialize(&device->completion_mutex);
+  iree_slim_mutex_deinitialize(&device->deferred_mutex);
+  iree_notification_deinitialize(&device->semaphore_notification);
+  iree_hal_rocm_event_pool_deinitialize(&device->event_pool);
+
+  iree_arena_block_pool_deinitialize(&device->block_pool);
+
   ROCM_IGNORE_ERROR(device->context_wrapper.syms,
-                    hipStreamDestroy(device->stream));
+                    hipCtxDestroy(device->context_wrapper.rocm_context));
 
   // Finally, destroy the device.
   iree_hal_driver_release(device->driver);
@@ -74,30 +281,71 @@ static void iree_hal_rocm_device_destroy(iree_hal_device_t* base_device) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Takes ownership of |context|.
 static iree_status_t iree_hal_rocm_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
-    hipDevice_t rocm_device, hipStream_t stream, hipCtx_t context,
-    iree_hal_rocm_dynamic_symbols_t* syms, iree_allocator_t host_allocator,
-    iree_hal_device_t** out_device) {
+    const iree_hal_rocm_device_params_t* params, hipDevice_t rocm_device,
+    hipCtx_t context, iree_hal_rocm_dynamic_symbols_t* syms,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_rocm_device_t* device = NULL;
-  iree_host_size_t total_size = sizeof(*device) + identifier.size;
-  IREE_RETURN_IF_ERROR(
-      iree_allocator_malloc(host_allocator, total_size, (void**)&device));
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*device) +
+      params->queue_count * sizeof(device->queues[0]) + identifier.size;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, total_size, (void**)&device);
+  if (!iree_status_is_ok(status)) {
+    syms->hipCtxDestroy(context);
+    return status;
+  }
   memset(device, 0, total_size);
   iree_hal_resource_initialize(&iree_hal_rocm_device_vtable, &device->resource);
   device->driver = driver;
   iree_hal_driver_retain(device->driver);
-  uint8_t* buffer_ptr = (uint8_t*)device + sizeof(*device);
-  buffer_ptr += iree_string_view_append_to_buffer(
-      identifier, &device->identifier, (char*)buffer_ptr);
+  iree_string_view_append_to_buffer(
+      identifier, &device->identifier,
+      (char*)device + iree_sizeof_struct(*device) +
+          params->queue_count * sizeof(device->queues[0]));
+  device->params = *params;
   device->device = rocm_device;
-  device->stream = stream;
   device->context_wrapper.rocm_context = context;
   device->context_wrapper.host_allocator = host_allocator;
   device->context_wrapper.syms = syms;
-  iree_status_t status = iree_hal_rocm_allocator_create(
-      (iree_hal_device_t*)device, &device->context_wrapper,
-      &device->device_allocator);
+  iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
+                                   &device->block_pool);
+  iree_hal_rocm_event_pool_initialize(&device->context_wrapper,
+                                      &device->event_pool);
+  iree_notification_initialize(&device->semaphore_notification);
+  iree_slim_mutex_initialize(&device->completion_mutex);
+  iree_slim_mutex_initialize(&device->deferred_mutex);
+
+  // Queues are created in order so that a failure leaves a prefix to destroy.
+  device->queue_count = params->queue_count;
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < device->queue_count; ++i) {
+    status = iree_hal_rocm_device_create_queue(device, &device->queues[i]);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_rocm_allocator_create((iree_hal_device_t*)device,
+                                            &device->context_wrapper,
+                                            &device->device_allocator);
+  }
+
+  // Memory pools are optional and only used for queue-ordered allocations; if
+  // unsupported (or disabled) we fall back to synchronous allocations.
+  if (iree_status_is_ok(status) && params->async_allocations) {
+    iree_status_t pools_status = iree_hal_rocm_memory_pools_initialize(
+        &device->context_wrapper, rocm_device, device->queues[0].stream,
+        &params->device_local_pool, &device->memory_pools);
+    if (iree_status_is_ok(pools_status)) {
+      device->supports_memory_pools = true;
+    } else if (iree_status_is_unavailable(pools_status)) {
+      iree_status_ignore(pools_status);
+    } else {
+      status = pools_status;
+    }
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -106,31 +354,21 @@ static iree_status_t iree_hal_rocm_device_create_internal(
   return status;
 }
 
-iree_status_t iree_hal_rocm_device_create(iree_hal_driver_t* driver,
-                                          iree_string_view_t identifier,
-                                          iree_hal_rocm_dynamic_symbols_t* syms,
-                                          hipDevice_t device,
-                                          iree_allocator_t host_allocator,
-                                          iree_hal_device_t** out_device) {
+iree_status_t iree_hal_rocm_device_create(
+    iree_hal_driver_t* driver, iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t* params,
+    iree_hal_rocm_dynamic_symbols_t* syms, hipDevice_t device,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
+                                    iree_hal_rocm_device_check_params(params));
   hipCtx_t context;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, ROCM_RESULT_TO_STATUS(syms, hipCtxCreate(&context, 0, device)));
-  hipStream_t stream;
-  iree_status_t status = ROCM_RESULT_TO_STATUS(
-      syms, hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
-
-  if (iree_status_is_ok(status)) {
-    status = iree_hal_rocm_device_create_internal(driver, identifier, device,
-                                                  stream, context, syms,
-                                                  host_allocator, out_device);
-  }
-  if (!iree_status_is_ok(status)) {
-    if (stream) {
-      syms->hipStreamDestroy(stream);
-    }
-    syms->hipCtxDestroy(context);
-  }
+  iree_status_t status = iree_hal_rocm_device_create_internal(
+      driver, identifier, params, device, context, syms, host_allocator,
+      out_device);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -184,8 +422,14 @@ static iree_status_t iree_hal_rocm_device_query_i64(
 
 static iree_status_t iree_hal_rocm_device_trim(iree_hal_device_t* base_device) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+  iree_hal_rocm_device_reclaim_submissions(device);
   iree_arena_block_pool_trim(&device->block_pool);
-  return iree_hal_allocator_trim(device->device_allocator);
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
+  if (device->supports_memory_pools) {
+    IREE_RETURN_IF_ERROR(iree_hal_rocm_memory_pools_trim(
+        &device->memory_pools, &device->params.device_local_pool));
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_rocm_device_create_channel(
@@ -195,16 +439,73 @@ static iree_status_t iree_hal_rocm_device_create_channel(
                           "collectives not implemented");
 }
 
+// Returns the queue to issue work to based on the |queue_affinity|.
+// Work with equivalent affinities always maps to the same queue.
+static iree_hal_rocm_device_queue_t* iree_hal_rocm_device_select_queue(
+    iree_hal_rocm_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  return &device->queues[queue_affinity % device->queue_count];
+}
+
+// Orders all work subsequently issued to the other queues of |device| after
+// the work issued to |queue| so far.
+static iree_status_t iree_hal_rocm_device_publish_queue(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue) {
+  if (device->queue_count == 1) return iree_ok_status();
+  iree_hal_rocm_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  ROCM_RETURN_IF_ERROR(syms, hipEventRecord(queue->event, queue->stream),
+                       "hipEventRecord");
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_rocm_device_queue_t* other_queue = &device->queues[i];
+    if (other_queue == queue) continue;
+    ROCM_RETURN_IF_ERROR(
+        syms, hipStreamWaitEvent(other_queue->stream, queue->event, 0),
+        "hipStreamWaitEvent");
+  }
+  return iree_ok_status();
+}
+
+// Orders all work subsequently issued to |queue| after the work issued to the
+// other queues of |device| so far.
+static iree_status_t iree_hal_rocm_device_join_queues(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue) {
+  if (device->queue_count == 1) return iree_ok_status();
+  iree_hal_rocm_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_rocm_device_queue_t* other_queue = &device->queues[i];
+    if (other_queue == queue) continue;
+    ROCM_RETURN_IF_ERROR(
+        syms, hipEventRecord(other_queue->event, other_queue->stream),
+        "hipEventRecord");
+    ROCM_RETURN_IF_ERROR(
+        syms, hipStreamWaitEvent(queue->stream, other_queue->event, 0),
+        "hipStreamWaitEvent");
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_rocm_device_create_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
-  return iree_hal_rocm_direct_command_buffer_create(
-      base_device, &device->context_wrapper, mode, command_categories,
-      queue_affinity, binding_capacity, &device->block_pool,
-      out_command_buffer);
+  switch (device->params.command_buffer_mode) {
+    case IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH:
+      return iree_hal_rocm_graph_command_buffer_create(
+          base_device, &device->context_wrapper, mode, command_categories,
+          queue_affinity, binding_capacity, &device->block_pool,
+          out_command_buffer);
+    case IREE_HAL_ROCM_COMMAND_BUFFER_MODE_DIRECT:
+      // Recorded commands are replayed into a direct command buffer on the
+      // queue stream at submission so that they are ordered after the waits.
+      return iree_hal_deferred_command_buffer_create(
+          base_device, mode, command_categories, binding_capacity,
+          &device->block_pool, iree_hal_device_host_allocator(base_device),
+          out_command_buffer);
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid command buffer mode");
+  }
 }
 
 static iree_status_t iree_hal_rocm_device_create_descriptor_set_layout(
@@ -248,17 +549,521 @@ static iree_status_t iree_hal_rocm_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
-  return iree_hal_rocm_semaphore_create(&device->context_wrapper, initial_value,
-                                        out_semaphore);
+  return iree_hal_rocm_semaphore_create(
+      &device->context_wrapper, &device->event_pool,
+      &device->semaphore_notification, initial_value, out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
 iree_hal_rocm_device_query_semaphore_compatibility(
     iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
-  // TODO: implement ROCM semaphores.
+  // ROCm semaphores can be waited on and signaled by streams. Other semaphores
+  // are waited on the host prior to issuing work.
+  if (iree_hal_rocm_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
+  }
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
+// Allocates a submission able to retain up to |command_buffer_capacity|
+// command buffers and the semaphores in |signal_semaphore_list|.
+static iree_status_t iree_hal_rocm_device_submission_allocate(
+    iree_hal_rocm_device_t* device, iree_host_size_t command_buffer_capacity,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_rocm_device_submission_t** out_submission) {
+  *out_submission = NULL;
+  iree_hal_rocm_device_submission_t* submission = NULL;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*submission) +
+      command_buffer_capacity * sizeof(*submission->command_buffers) +
+      signal_semaphore_list.count *
+          (sizeof(*signal_semaphore_list.semaphores) +
+           sizeof(*signal_semaphore_list.payload_values));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->context_wrapper.host_allocator, total_size, (void**)&submission));
+  memset(submission, 0, total_size);
+  submission->device = device;
+  uint8_t* ptr = (uint8_t*)submission + iree_sizeof_struct(*submission);
+  submission->command_buffers = (iree_hal_command_buffer_t**)ptr;
+  ptr += command_buffer_capacity * sizeof(*submission->command_buffers);
+  submission->signal_semaphore_list.count = signal_semaphore_list.count;
+  submission->signal_semaphore_list.semaphores = (iree_hal_semaphore_t**)ptr;
+  ptr +=
+      signal_semaphore_list.count * sizeof(*signal_semaphore_list.semaphores);
+  submission->signal_semaphore_list.payload_values = (uint64_t*)ptr;
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    submission->signal_semaphore_list.semaphores[i] =
+        signal_semaphore_list.semaphores[i];
+    iree_hal_semaphore_retain(signal_semaphore_list.semaphores[i]);
+    submission->signal_semaphore_list.payload_values[i] =
+        signal_semaphore_list.payload_values[i];
+  }
+  *out_submission = submission;
+  return iree_ok_status();
+}
+
+// Orders work subsequently issued to |queue| after |wait_semaphore_list| is
+// satisfied. ROCm semaphores with signals issued to a stream are waited on by
+// the stream; all others are waited on the host.
+static iree_status_t iree_hal_rocm_device_queue_wait(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+    uint64_t value = wait_semaphore_list.payload_values[i];
+    bool waited = false;
+    if (iree_hal_rocm_semaphore_isa(semaphore)) {
+      IREE_RETURN_IF_ERROR(iree_hal_rocm_semaphore_stream_wait(
+          semaphore, value, queue->stream, &waited));
+    }
+    if (!waited) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_semaphore_wait(semaphore, value, iree_infinite_timeout()));
+    }
+  }
+  return iree_ok_status();
+}
+
+// Called by HIP once all work issued to a stream prior to a submission has
+// completed. Must not make HIP calls: semaphores are advanced and waiters
+// woken but resources are released later by the host.
+static void iree_hal_rocm_device_complete_submission(void* user_data) {
+  iree_hal_rocm_device_submission_t* submission =
+      (iree_hal_rocm_device_submission_t*)user_data;
+  iree_hal_rocm_device_t* device = submission->device;
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    if (iree_hal_rocm_semaphore_isa(list->semaphores[i])) {
+      iree_hal_rocm_semaphore_notify_signaled(list->semaphores[i],
+                                              list->payload_values[i]);
+    } else {
+      iree_status_t status = iree_hal_semaphore_signal(list->semaphores[i],
+                                                       list->payload_values[i]);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_semaphore_fail(list->semaphores[i], status);
+      }
+    }
+  }
+  iree_slim_mutex_lock(&device->completion_mutex);
+  submission->next = device->completed_head;
+  device->completed_head = submission;
+  iree_slim_mutex_unlock(&device->completion_mutex);
+}
+
+// Signals the semaphores of |submission| and releases its resources once the
+// work issued to |queue| so far completes. Takes ownership of |submission|
+// regardless of success.
+static iree_status_t iree_hal_rocm_device_queue_signal(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    iree_hal_rocm_device_submission_t* submission) {
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; iree_status_is_ok(status) && i < list->count;
+       ++i) {
+    if (iree_hal_rocm_semaphore_isa(list->semaphores[i])) {
+      status = iree_hal_rocm_semaphore_stream_signal(
+          list->semaphores[i], list->payload_values[i], queue->stream);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    status = ROCM_RESULT_TO_STATUS(
+        device->context_wrapper.syms,
+        hipLaunchHostFunc(queue->stream,
+                         iree_hal_rocm_device_complete_submission, submission),
+        "hipLaunchHostFunc");
+  }
+  if (!iree_status_is_ok(status)) {
+    // Work referencing the submission resources may still be in flight.
+    ROCM_IGNORE_ERROR(device->context_wrapper.syms,
+                      hipStreamSynchronize(queue->stream));
+    iree_hal_rocm_device_submission_release(submission);
+  }
+  return status;
+}
+
+// Issues a dealloca of |buffer| to |queue| ordered after
+// |wait_semaphore_list|.
+static iree_status_t iree_hal_rocm_device_issue_dealloca(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer) {
+  iree_hal_rocm_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_status_t status =
+      iree_hal_rocm_device_queue_wait(device, queue, wait_semaphore_list);
+
+  // Schedule the free on the stream so that it happens after all prior work
+  // using the buffer has completed on any queue. Synchronously allocated
+  // buffers are freed when they are released.
+  if (iree_status_is_ok(status) && device->supports_memory_pools) {
+    status = iree_hal_rocm_device_join_queues(device, queue);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_rocm_memory_pools_dealloca(&device->memory_pools,
+                                                   queue->stream, buffer);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_rocm_device_queue_signal(device, queue, submission);
+  } else {
+    iree_hal_rocm_device_submission_release(submission);
+  }
+  return status;
+}
+
+// Issues the work of |command_buffer| to |queue| and retains any command
+// buffers it requires in |submission|.
+static iree_status_t iree_hal_rocm_device_issue_command_buffer(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_rocm_device_submission_t* submission) {
+  iree_hal_command_buffer_retain(command_buffer);
+  submission->command_buffers[submission->command_buffer_count++] =
+      command_buffer;
+  if (iree_hal_rocm_graph_command_buffer_isa(command_buffer)) {
+    hipGraphExec_t exec =
+        iree_hal_rocm_graph_command_buffer_handle(command_buffer);
+    // Graphs are traced as a single zone as their nodes are opaque.
+    IREE_ROCM_TRACE_ZONE_BEGIN(queue->tracing_context, queue->stream);
+    iree_status_t status =
+        ROCM_RESULT_TO_STATUS(device->context_wrapper.syms,
+                              hipGraphLaunch(exec, queue->stream),
+                              "hipGraphLaunch");
+    IREE_ROCM_TRACE_ZONE_END(queue->tracing_context, queue->stream);
+    return status;
+  }
+
+  // Deferred command buffers are replayed into a direct command buffer that
+  // issues the work to the queue stream. It is kept live with the submission
+  // in case the issued work references it.
+  iree_hal_command_buffer_t* direct_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_direct_command_buffer_create(
+      (iree_hal_device_t*)device, &device->context_wrapper,
+      queue->tracing_context,
+      IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+          IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, queue->stream, &device->block_pool,
+      &direct_command_buffer));
+  submission->command_buffers[submission->command_buffer_count++] =
+      direct_command_buffer;
+  return iree_hal_deferred_command_buffer_apply(
+      command_buffer, direct_command_buffer,
+      iree_hal_buffer_binding_table_empty());
+}
+
+// Issues |command_buffers| to |queue| ordered after |wait_semaphore_list|.
+static iree_status_t iree_hal_rocm_device_issue_execute(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers) {
+  // Each command buffer may need an additional direct command buffer to replay
+  // into.
+  iree_hal_rocm_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_device_submission_allocate(
+      device, command_buffer_count * 2, signal_semaphore_list, &submission));
+  iree_status_t status =
+      iree_hal_rocm_device_queue_wait(device, queue, wait_semaphore_list);
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < command_buffer_count; i++) {
+    status = iree_hal_rocm_device_issue_command_buffer(
+        device, queue, command_buffers[i], submission);
+  }
+
+  // The submission completes asynchronously; semaphores are signaled and
+  // resources released once the stream reaches this point.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_rocm_device_queue_signal(device, queue, submission);
+  } else {
+    ROCM_IGNORE_ERROR(device->context_wrapper.syms,
+                      hipStreamSynchronize(queue->stream));
+    iree_hal_rocm_device_submission_release(submission);
+  }
+
+  iree_hal_rocm_tracing_context_collect(queue->tracing_context);
+
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Deferred queue operations
+//===----------------------------------------------------------------------===//
+
+// Returns true if the waits in |wait_semaphore_list| can be issued without
+// blocking the host on a ROCm semaphore that has nothing issued to signal it.
+// Other semaphores are always waited on the host when the work is issued.
+static bool iree_hal_rocm_device_can_issue(
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+    if (iree_hal_rocm_semaphore_isa(semaphore) &&
+        !iree_hal_rocm_semaphore_can_stream_wait(
+            semaphore, wait_semaphore_list.payload_values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void iree_hal_rocm_device_deferred_release(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_deferred_t* deferred) {
+  for (iree_host_size_t i = 0; i < deferred->wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_release(deferred->wait_semaphore_list.semaphores[i]);
+  }
+  for (iree_host_size_t i = 0; i < deferred->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_release(deferred->signal_semaphore_list.semaphores[i]);
+  }
+  for (iree_host_size_t i = 0; i < deferred->command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(deferred->command_buffers[i]);
+  }
+  iree_hal_buffer_release(deferred->dealloca_buffer);
+  iree_allocator_free(device->context_wrapper.host_allocator, deferred);
+}
+
+// Fails the signal semaphores of |deferred| with |status| and releases it.
+static void iree_hal_rocm_device_deferred_fail(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_deferred_t* deferred,
+    iree_status_t status) {
+  for (iree_host_size_t i = 0; i < deferred->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_fail(deferred->signal_semaphore_list.semaphores[i],
+                            iree_status_clone(status));
+  }
+  iree_status_ignore(status);
+  iree_hal_rocm_device_deferred_release(device, deferred);
+}
+
+// Copies |source| into the storage at |*ptr| and retains its semaphores.
+static void iree_hal_rocm_device_clone_semaphore_list(
+    const iree_hal_semaphore_list_t source, uint8_t** ptr,
+    iree_hal_semaphore_list_t* out_list) {
+  out_list->count = source.count;
+  out_list->semaphores = (iree_hal_semaphore_t**)*ptr;
+  *ptr += source.count * sizeof(*source.semaphores);
+  out_list->payload_values = (uint64_t*)*ptr;
+  *ptr += source.count * sizeof(*source.payload_values);
+  memcpy(out_list->semaphores, source.semaphores,
+         source.count * sizeof(*source.semaphores));
+  memcpy(out_list->payload_values, source.payload_values,
+         source.count * sizeof(*source.payload_values));
+  for (iree_host_size_t i = 0; i < source.count; ++i) {
+    iree_hal_semaphore_retain(source.semaphores[i]);
+  }
+}
+
+static iree_status_t iree_hal_rocm_device_deferred_allocate(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    iree_hal_buffer_t* dealloca_buffer,
+    iree_hal_rocm_device_deferred_t** out_deferred) {
+  *out_deferred = NULL;
+  iree_hal_rocm_device_deferred_t* deferred = NULL;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*deferred) +
+      command_buffer_count * sizeof(*deferred->command_buffers) +
+      (wait_semaphore_list.count + signal_semaphore_list.count) *
+          (sizeof(*wait_semaphore_list.semaphores) +
+           sizeof(*wait_semaphore_list.payload_values));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->context_wrapper.host_allocator, total_size, (void**)&deferred));
+  memset(deferred, 0, total_size);
+  deferred->queue = queue;
+  uint8_t* ptr = (uint8_t*)deferred + iree_sizeof_struct(*deferred);
+  deferred->command_buffer_count = command_buffer_count;
+  deferred->command_buffers = (iree_hal_command_buffer_t**)ptr;
+  ptr += command_buffer_count * sizeof(*deferred->command_buffers);
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    deferred->command_buffers[i] = command_buffers[i];
+    iree_hal_command_buffer_retain(command_buffers[i]);
+  }
+  iree_hal_rocm_device_clone_semaphore_list(wait_semaphore_list, &ptr,
+                                            &deferred->wait_semaphore_list);
+  iree_hal_rocm_device_clone_semaphore_list(signal_semaphore_list, &ptr,
+                                            &deferred->signal_semaphore_list);
+  deferred->dealloca_buffer = dealloca_buffer;
+  iree_hal_buffer_retain(dealloca_buffer);
+  *out_deferred = deferred;
+  return iree_ok_status();
+}
+
+// Returns true if the deferred thread has work to do. Called with the
+// semaphore notification prepared so that any signal racing with the check
+// wakes the thread.
+static bool iree_hal_rocm_device_has_deferred_work(void* arg) {
+  iree_hal_rocm_device_t* device = (iree_hal_rocm_device_t*)arg;
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  bool has_work = device->deferred_exit_requested;
+  for (iree_hal_rocm_device_deferred_t* deferred = device->deferred_head;
+       !has_work && deferred; deferred = deferred->next) {
+    has_work = iree_hal_rocm_device_can_issue(deferred->wait_semaphore_list);
+  }
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  return has_work;
+}
+
+static bool iree_hal_rocm_device_has_deferred_exited(void* arg) {
+  iree_hal_rocm_device_t* device = (iree_hal_rocm_device_t*)arg;
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  bool has_exited = device->deferred_exited;
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  return has_exited;
+}
+
+// Pops the oldest deferred operation that can be issued. Returns NULL if there
+// is none.
+static iree_hal_rocm_device_deferred_t* iree_hal_rocm_device_pop_deferred(
+    iree_hal_rocm_device_t* device) {
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  iree_hal_rocm_device_deferred_t* prev = NULL;
+  iree_hal_rocm_device_deferred_t* deferred = device->deferred_head;
+  while (deferred &&
+         !iree_hal_rocm_device_can_issue(deferred->wait_semaphore_list)) {
+    prev = deferred;
+    deferred = deferred->next;
+  }
+  if (deferred) {
+    if (prev) {
+      prev->next = deferred->next;
+    } else {
+      device->deferred_head = deferred->next;
+    }
+    if (device->deferred_tail == deferred) device->deferred_tail = prev;
+    deferred->next = NULL;
+  }
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  return deferred;
+}
+
+static int iree_hal_rocm_device_deferred_main(void* entry_arg) {
+  iree_hal_rocm_device_t* device = (iree_hal_rocm_device_t*)entry_arg;
+  while (true) {
+    iree_notification_await(&device->semaphore_notification,
+                            iree_hal_rocm_device_has_deferred_work, device,
+                            iree_infinite_timeout());
+    iree_hal_rocm_device_deferred_t* deferred =
+        iree_hal_rocm_device_pop_deferred(device);
+    if (!deferred) break;  // exit requested
+
+    // Issuing a signal posts the notification in turn and wakes us for any
+    // operations deferred on it.
+    iree_status_t status = iree_ok_status();
+    if (deferred->dealloca_buffer) {
+      status = iree_hal_rocm_device_issue_dealloca(
+          device, deferred->queue, deferred->wait_semaphore_list,
+          deferred->signal_semaphore_list, deferred->dealloca_buffer);
+    } else {
+      status = iree_hal_rocm_device_issue_execute(
+          device, deferred->queue, deferred->wait_semaphore_list,
+          deferred->signal_semaphore_list, deferred->command_buffer_count,
+          deferred->command_buffers);
+    }
+    if (iree_status_is_ok(status)) {
+      iree_hal_rocm_device_deferred_release(device, deferred);
+    } else {
+      iree_hal_rocm_device_deferred_fail(device, deferred, status);
+    }
+  }
+
+  // The device joins the thread after observing the exit so it remains live
+  // until we return.
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  device->deferred_exited = true;
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  iree_notification_post(&device->semaphore_notification, IREE_ALL_WAITERS);
+  return 0;
+}
+
+// Defers the queue operation described by the arguments if its waits cannot
+// be issued yet. |out_deferred| is set to false if the operation must be
+// issued by the caller instead.
+static iree_status_t iree_hal_rocm_device_defer_if_needed(
+    iree_hal_rocm_device_t* device, iree_hal_rocm_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    iree_hal_buffer_t* dealloca_buffer, bool* out_deferred) {
+  *out_deferred = false;
+
+  // The check and the append happen under the lock the deferred thread takes
+  // to check for work so that a signal in between cannot be missed.
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  iree_status_t status = iree_ok_status();
+  if (!iree_hal_rocm_device_can_issue(wait_semaphore_list)) {
+    iree_hal_rocm_device_deferred_t* deferred = NULL;
+    status = iree_hal_rocm_device_deferred_allocate(
+        device, queue, wait_semaphore_list, signal_semaphore_list,
+        command_buffer_count, command_buffers, dealloca_buffer, &deferred);
+    if (iree_status_is_ok(status) && !device->deferred_thread) {
+      iree_thread_create_params_t params;
+      memset(&params, 0, sizeof(params));
+      params.name = iree_make_cstring_view("iree-rocm-deferred");
+      status = iree_thread_create(
+          iree_hal_rocm_device_deferred_main, device, params,
+          device->context_wrapper.host_allocator, &device->deferred_thread);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_rocm_device_deferred_release(device, deferred);
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      if (device->deferred_tail) {
+        device->deferred_tail->next = deferred;
+      } else {
+        device->deferred_head = deferred;
+      }
+      device->deferred_tail = deferred;
+      *out_deferred = true;
+    }
+  }
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  if (*out_deferred) {
+    iree_notification_post(&device->semaphore_notification, IREE_ALL_WAITERS);
+  }
+  return status;
+}
+
+// Joins the deferred thread and fails the signals of all operations that were
+// still waiting.
+static void iree_hal_rocm_device_stop_deferred(iree_hal_rocm_device_t* device) {
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  iree_thread_t* thread = device->deferred_thread;
+  device->deferred_exit_requested = true;
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  if (thread) {
+    iree_notification_post(&device->semaphore_notification, IREE_ALL_WAITERS);
+    iree_notification_await(&device->semaphore_notification,
+                            iree_hal_rocm_device_has_deferred_exited, device,
+                            iree_infinite_timeout());
+    iree_thread_release(thread);
+  }
+
+  iree_slim_mutex_lock(&device->deferred_mutex);
+  iree_hal_rocm_device_deferred_t* deferred = device->deferred_head;
+  device->deferred_head = NULL;
+  device->deferred_tail = NULL;
+  device->deferred_thread = NULL;
+  iree_slim_mutex_unlock(&device->deferred_mutex);
+  while (deferred) {
+    iree_hal_rocm_device_deferred_t* next = deferred->next;
+    iree_hal_rocm_device_deferred_fail(
+        device, deferred,
+        iree_make_status(IREE_STATUS_CANCELLED,
+                         "device destroyed before the queue operation waits "
+                         "were satisfied"));
+    deferred = next;
+  }
+}
+
 static iree_status_t iree_hal_rocm_device_queue_alloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -266,14 +1071,81 @@ static iree_status_t iree_hal_rocm_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO: queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
-      iree_hal_device_allocator(base_device), params, allocation_size,
-      iree_const_byte_span_empty(), out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+  iree_hal_rocm_device_queue_t* queue =
+      iree_hal_rocm_device_select_queue(device, queue_affinity);
+  iree_hal_rocm_device_reclaim_submissions(device);
+
+  // If the waits cannot be issued yet the buffer is allocated synchronously
+  // now and only the signal is deferred until the waits are satisfied.
+  if (!iree_hal_rocm_device_can_issue(wait_semaphore_list)) {
+    IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(base_device), params, allocation_size,
+        iree_const_byte_span_empty(), out_buffer));
+    bool deferred = false;
+    iree_status_t status = iree_hal_rocm_device_defer_if_needed(
+        device, queue, wait_semaphore_list, signal_semaphore_list,
+        /*command_buffer_count=*/0, /*command_buffers=*/NULL,
+        /*dealloca_buffer=*/NULL, &deferred);
+    if (iree_status_is_ok(status) && !deferred) {
+      // The waits became issuable in the meantime.
+      status = iree_hal_rocm_device_issue_execute(
+          device, queue, wait_semaphore_list, signal_semaphore_list,
+          /*command_buffer_count=*/0, /*command_buffers=*/NULL);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_hal_buffer_release(*out_buffer);
+      *out_buffer = NULL;
+    }
+    return status;
+  }
+
+  // The allocation is ordered with respect to prior and subsequent work by the
+  // stream. As the buffer may be used by work issued to any queue the other
+  // queues are made to wait on the allocation.
+  iree_hal_rocm_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_status_t status =
+      iree_hal_rocm_device_queue_wait(device, queue, wait_semaphore_list);
+
+  // Try to allocate from the stream-ordered memory pools; if the memory type
+  // isn't supported by the pools we fall back to a synchronous allocation.
+  if (iree_status_is_ok(status)) {
+    status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+    if (device->supports_memory_pools) {
+      status = iree_hal_rocm_memory_pools_alloca(&device->memory_pools,
+                                                 queue->stream, pool, params,
+                                                 allocation_size, out_buffer);
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_rocm_device_publish_queue(device, queue);
+        if (!iree_status_is_ok(status)) {
+          iree_hal_buffer_release(*out_buffer);
+          *out_buffer = NULL;
+        }
+      }
+    }
+    if (iree_status_is_unavailable(status)) {
+      iree_status_ignore(status);
+      status = iree_hal_allocator_allocate_buffer(
+          iree_hal_device_allocator(base_device), params, allocation_size,
+          iree_const_byte_span_empty(), out_buffer);
+    }
+  }
+
+  // Signal; any work we issue that depends on the allocation will be ordered
+  // after it on the stream.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_rocm_device_queue_signal(device, queue, submission);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_buffer_release(*out_buffer);
+      *out_buffer = NULL;
+    }
+  } else {
+    iree_hal_rocm_device_submission_release(submission);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_rocm_device_queue_dealloca(
@@ -281,10 +1153,18 @@ static iree_status_t iree_hal_rocm_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO: queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+  iree_hal_rocm_device_queue_t* queue =
+      iree_hal_rocm_device_select_queue(device, queue_affinity);
+  iree_hal_rocm_device_reclaim_submissions(device);
+  bool deferred = false;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_device_defer_if_needed(
+      device, queue, wait_semaphore_list, signal_semaphore_list,
+      /*command_buffer_count=*/0, /*command_buffers=*/NULL, buffer,
+      &deferred));
+  if (deferred) return iree_ok_status();
+  return iree_hal_rocm_device_issue_dealloca(
+      device, queue, wait_semaphore_list, signal_semaphore_list, buffer);
 }
 
 static iree_status_t iree_hal_rocm_device_queue_execute(
@@ -294,14 +1174,18 @@ static iree_status_t iree_hal_rocm_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
-  // TODO(raikonenfnu): Once semaphore is implemented wait for semaphores
-  // TODO(thomasraoux): implement semaphores - for now this conservatively
-  // synchronizes after every submit.
-  // TODO(raikonenfnu): currently run on default/null stream, when cmd buffer
-  // stream work with device->stream, we'll change
-  ROCM_RETURN_IF_ERROR(device->context_wrapper.syms, hipStreamSynchronize(0),
-                       "hipStreamSynchronize");
-  return iree_ok_status();
+  iree_hal_rocm_device_queue_t* queue =
+      iree_hal_rocm_device_select_queue(device, queue_affinity);
+  iree_hal_rocm_device_reclaim_submissions(device);
+  bool deferred = false;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_device_defer_if_needed(
+      device, queue, wait_semaphore_list, signal_semaphore_list,
+      command_buffer_count, command_buffers, /*dealloca_buffer=*/NULL,
+      &deferred));
+  if (deferred) return iree_ok_status();
+  return iree_hal_rocm_device_issue_execute(
+      device, queue, wait_semaphore_list, signal_semaphore_list,
+      command_buffer_count, command_buffers);
 }
 
 static iree_status_t iree_hal_rocm_device_queue_flush(
@@ -313,8 +1197,34 @@ static iree_status_t iree_hal_rocm_device_queue_flush(
 static iree_status_t iree_hal_rocm_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "semaphore not implemented");
+  iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+  bool all_rocm = true;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    all_rocm &= iree_hal_rocm_semaphore_isa(semaphore_list.semaphores[i]);
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (all_rocm) {
+    status = iree_hal_rocm_semaphore_multi_wait(
+        wait_mode, semaphore_list, timeout, &device->semaphore_notification);
+  } else if (wait_mode == IREE_HAL_WAIT_MODE_ALL ||
+             semaphore_list.count == 1) {
+    // Semaphores from other devices can only be waited on individually.
+    timeout = iree_make_deadline(iree_timeout_as_deadline_ns(timeout));
+    for (iree_host_size_t i = 0;
+         iree_status_is_ok(status) && i < semaphore_list.count; ++i) {
+      status = iree_hal_semaphore_wait(semaphore_list.semaphores[i],
+                                       semaphore_list.payload_values[i],
+                                       timeout);
+    }
+  } else {
+    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "wait-any on semaphores not created by the ROCm "
+                              "device is not supported");
+  }
+
+  iree_hal_rocm_device_reclaim_submissions(device);
+  return status;
 }
 
 static iree_status_t iree_hal_rocm_device_profiling_begin(
@@ -351,6 +1261,7 @@ static const iree_hal_device_vtable_t iree_hal_rocm_device_vtable = {
     .transfer_range = iree_hal_device_submit_transfer_range_and_wait,
     .queue_alloca = iree_hal_rocm_device_queue_alloca,
     .queue_dealloca = iree_hal_rocm_device_queue_dealloca,
+    .queue_read = iree_hal_device_queue_read_streaming,
     .queue_execute = iree_hal_rocm_device_queue_execute,
     .queue_flush = iree_hal_rocm_device_queue_flush,
     .wait_semaphores = iree_hal_rocm_device_wait_semaphores,
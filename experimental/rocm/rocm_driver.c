@@ -22,6 +22,8 @@ typedef struct iree_hal_rocm_driver_t {
   // We allow overriding so that multiple ROCM versions can be exposed in the
   // same process.
   iree_string_view_t identifier;
+  // Parameters used to control device behavior.
+  iree_hal_rocm_device_params_t device_params;
   int default_device_index;
   // ROCM symbols.
   iree_hal_rocm_dynamic_symbols_t syms;
@@ -46,6 +48,7 @@ IREE_API_EXPORT void iree_hal_rocm_driver_options_initialize(
 
 static iree_status_t iree_hal_rocm_driver_create_internal(
     iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t* default_params,
     const iree_hal_rocm_driver_options_t* options,
     iree_allocator_t host_allocator, iree_hal_driver_t** out_driver) {
   iree_hal_rocm_driver_t* driver = NULL;
@@ -57,6 +60,8 @@ static iree_status_t iree_hal_rocm_driver_create_internal(
   iree_string_view_append_to_buffer(
       identifier, &driver->identifier,
       (char*)driver + total_size - identifier.size);
+  memcpy(&driver->device_params, default_params,
+         sizeof(driver->device_params));
   driver->default_device_index = options->default_device_index;
   iree_status_t status =
       iree_hal_rocm_dynamic_symbols_initialize(host_allocator, &driver->syms);
@@ -81,14 +86,16 @@ static void iree_hal_rocm_driver_destroy(iree_hal_driver_t* base_driver) {
 
 IREE_API_EXPORT iree_status_t iree_hal_rocm_driver_create(
     iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t* default_params,
     const iree_hal_rocm_driver_options_t* options,
     iree_allocator_t host_allocator, iree_hal_driver_t** out_driver) {
+  IREE_ASSERT_ARGUMENT(default_params);
   IREE_ASSERT_ARGUMENT(options);
   IREE_ASSERT_ARGUMENT(out_driver);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_status_t status = iree_hal_rocm_driver_create_internal(
-      identifier, options, host_allocator, out_driver);
+      identifier, default_params, options, host_allocator, out_driver);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -206,9 +213,9 @@ static iree_status_t iree_hal_rocm_driver_create_device_by_id(
   iree_string_view_t device_name = iree_make_cstring_view("rocm");
 
   // Attempt to create the device.
-  iree_status_t status =
-      iree_hal_rocm_device_create(base_driver, device_name, &driver->syms,
-                                  device, host_allocator, out_device);
+  iree_status_t status = iree_hal_rocm_device_create(
+      base_driver, device_name, &driver->device_params, &driver->syms, device,
+      host_allocator, out_device);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -19,9 +19,10 @@
 # Otherwise, it looks for an install directory under path set in the environment
 # variable IREE_HOST_BUILD_DIR (default build-host). The build directory for the
 # emscripten build is taken from the environment variable
-# IREE_EMPSCRIPTEN_BUILD_DIR, defaulting to "build-emscripten". Designed for
-# CI, but can be run manually. It reuses the build directory if it already
-# exists.
+# IREE_EMPSCRIPTEN_BUILD_DIR, defaulting to "build-emscripten". The
+# multithreaded variant is built with -pthread in a second build directory with
+# a "-pthreads" suffix. Designed for CI, but can be run manually. It reuses the
+# build directories if they already exist.
 #
 # NOTE: This is different from most of build scripts we use for CI because it is
 # intended to also be runnable by humans with minimal configuration.
@@ -35,6 +36,8 @@ BUILD_DIR="${IREE_EMPSCRIPTEN_BUILD_DIR:-build-emscripten}"
 INSTALL_ROOT="$(realpath ${1:-${HOST_BUILD_DIR}/install})"
 SOURCE_DIR=${ROOT_DIR}/experimental/web/sample_dynamic
 BINARY_DIR=${BUILD_DIR}/experimental/web/sample_dynamic
+PTHREADS_BUILD_DIR="${BUILD_DIR}-pthreads"
+PTHREADS_BINARY_DIR=${PTHREADS_BUILD_DIR}/experimental/web/sample_dynamic
 IREE_PYTHON3_EXECUTABLE="${IREE_PYTHON3_EXECUTABLE:-$(which python3)}"
 
 
@@ -81,22 +84,42 @@ echo "=== Building web artifacts using Emscripten ==="
 
 # Configure using Emscripten's CMake wrapper, then build.
 # Note: The sample creates a device directly, so no drivers are required.
-emcmake "${CMAKE_BIN}" \
-  -B "${BUILD_DIR}" \
-  -G Ninja \
-  -DPython3_EXECUTABLE="${IREE_PYTHON3_EXECUTABLE}" \
-  -DPYTHON_EXECUTABLE="${IREE_PYTHON3_EXECUTABLE}" \
-  -DCMAKE_BUILD_TYPE=RelWithDebInfo \
-  -DIREE_HOST_BIN_DIR="${INSTALL_ROOT}/bin" \
-  -DIREE_BUILD_EXPERIMENTAL_WEB_SAMPLES=ON \
-  -DIREE_HAL_DRIVER_DEFAULTS=OFF \
-  -DIREE_HAL_DRIVER_LOCAL_SYNC=ON \
-  -DIREE_BUILD_COMPILER=OFF \
-  -DIREE_BUILD_TESTS=OFF \
-  .
-
-"${CMAKE_BIN}" --build "${BUILD_DIR}" --target \
-  iree_experimental_web_sample_dynamic_sync
+#
+# The compiled programs above already require SIMD128, so the runtime is built
+# with it too. This enables the SIMD128 microkernels used by VMVX.
+configure_and_build() {
+  local build_dir="$1"
+  local c_flags="$2"
+  local target="$3"
+  shift 3
+  emcmake "${CMAKE_BIN}" \
+    -B "${build_dir}" \
+    -G Ninja \
+    -DPython3_EXECUTABLE="${IREE_PYTHON3_EXECUTABLE}" \
+    -DPYTHON_EXECUTABLE="${IREE_PYTHON3_EXECUTABLE}" \
+    -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+    -DCMAKE_C_FLAGS="${c_flags}" \
+    -DCMAKE_CXX_FLAGS="${c_flags}" \
+    -DIREE_HOST_BIN_DIR="${INSTALL_ROOT}/bin" \
+    -DIREE_BUILD_EXPERIMENTAL_WEB_SAMPLES=ON \
+    -DIREE_HAL_DRIVER_DEFAULTS=OFF \
+    -DIREE_BUILD_COMPILER=OFF \
+    -DIREE_BUILD_TESTS=OFF \
+    "$@" \
+    .
+
+  "${CMAKE_BIN}" --build "${build_dir}" --target "${target}"
+}
+
+configure_and_build "${BUILD_DIR}" "-msimd128" \
+  iree_experimental_web_sample_dynamic_sync \
+  -DIREE_HAL_DRIVER_LOCAL_SYNC=ON
+
+# All code linked into a program using pthreads must be compiled with -pthread,
+# so the multithreaded variant uses its own build directory.
+configure_and_build "${PTHREADS_BUILD_DIR}" "-msimd128 -pthread" \
+  iree_experimental_web_sample_dynamic_multithreaded \
+  -DIREE_HAL_DRIVER_LOCAL_TASK=ON
 
 echo "=== Copying static files (.html, .js) to the build directory ==="
 
@@ -105,3 +128,4 @@ cp "${SOURCE_DIR}/benchmarks.html" "${BINARY_DIR}"
 cp "${ROOT_DIR}/docs/website/overrides/.icons/iree/ghost.svg" "${BINARY_DIR}"
 cp "${SOURCE_DIR}/iree_api.js" "${BINARY_DIR}"
 cp "${SOURCE_DIR}/iree_worker.js" "${BINARY_DIR}"
+cp "${PTHREADS_BINARY_DIR}"/web-sample-dynamic-multithreaded.* "${BINARY_DIR}"
@@ -4,9 +4,13 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-// TODO(scotttodd): configure this through the build system / scripts?
-// const MAIN_SCRIPT_URL = 'web-sample-dynamic-multithreaded.js';
-const MAIN_SCRIPT_URL = 'web-sample-dynamic-sync.js';
+// The multithreaded build runs the task executor on pthreads, which need
+// SharedArrayBuffer and Atomics.wait. Browsers only expose SharedArrayBuffer to
+// cross-origin isolated pages (served with COOP/COEP headers, as
+// serve_sample.sh does), so fall back to the single-threaded build otherwise.
+const MAIN_SCRIPT_URL = self.crossOriginIsolated ?
+    'web-sample-dynamic-multithreaded.js' :
+    'web-sample-dynamic-sync.js';
 
 let wasmSetupSampleFn;
 let wasmCleanupSampleFn;
@@ -41,6 +45,9 @@ var Module = {
     });
   },
   noInitialRun: true,
+  // Emscripten's pthread workers load the main script by URL. It can't infer
+  // that from within this worker, since the script is loaded by importScripts.
+  mainScriptUrlOrBlob: MAIN_SCRIPT_URL,
 };
 
 function loadProgramBuffer(id, programDataBuffer) {
@@ -0,0 +1,126 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// See iree/base/api.h for documentation on the API conventions used.
+
+#ifndef IREE_HAL_WEBGPU_API_H_
+#define IREE_HAL_WEBGPU_API_H_
+
+#include "experimental/webgpu/webgpu_headers.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_device_t
+//===----------------------------------------------------------------------===//
+
+// Parameters configuring an iree_hal_webgpu_device_t.
+// Must be initialized with iree_hal_webgpu_device_params_initialize prior to
+// use.
+typedef struct iree_hal_webgpu_device_params_t {
+  // Total size of each block in the device shared block pool.
+  // Larger sizes will lower overhead and ensure the heap isn't hit for
+  // transient allocations while also increasing memory consumption.
+  iree_host_size_t arena_block_size;
+
+  // Total size of each uniform buffer used to hold dispatch parameters
+  // (emulated push constants). Each dispatch with push constants consumes one
+  // minUniformBufferOffsetAlignment (256B) slot and command buffers allocate
+  // additional buffers as they fill.
+  iree_host_size_t params_buffer_size;
+
+  // Loop used to deliver asynchronous completions from WebGPU such as
+  // submitted work finishing or buffers being mapped. Semaphores are signaled
+  // from callbacks issued to this loop. The loop must remain valid for the
+  // lifetime of the device.
+  iree_loop_t loop;
+} iree_hal_webgpu_device_params_t;
+
+// Initializes |out_params| to default values.
+// The loop defaults to iree_loop_inline and should be replaced with the
+// browser event loop (iree_loop_emscripten) when running on the web.
+IREE_API_EXPORT void iree_hal_webgpu_device_params_initialize(
+    iree_hal_webgpu_device_params_t* out_params);
+
+// Creates a device that wraps an existing WGPUDevice, such as the one
+// preinitialized by JavaScript and returned by emscripten_webgpu_get_device.
+// The device handle is retained by the HAL device.
+//
+// WebGPU completes all work asynchronously on the event loop of the page or
+// worker and blocking waits are not possible: submissions signal their
+// semaphores from callbacks issued to |params|.loop and users must yield to the
+// loop (or use semaphore timepoints) to observe progress.
+//
+// |out_device| must be released by the caller (see iree_hal_device_release).
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_wrap_device(
+    iree_string_view_t identifier,
+    const iree_hal_webgpu_device_params_t* params, WGPUDevice handle,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device);
+
+// Returns the WGPUDevice handle wrapped by |device|.
+IREE_API_EXPORT WGPUDevice
+iree_hal_webgpu_device_handle(iree_hal_device_t* device);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_buffer_t
+//===----------------------------------------------------------------------===//
+
+// Returns the WGPUBuffer backing |buffer|.
+// Subspans return the handle of the allocated buffer they reference.
+IREE_API_EXPORT WGPUBuffer
+iree_hal_webgpu_buffer_handle(iree_hal_buffer_t* buffer);
+
+// Asynchronously maps a HOST_VISIBLE |buffer| for host access and issues
+// |callback| from |loop| once the mapping is available (or has failed).
+//
+// WebGPU only allows buffers to be mapped when no work using them is in flight
+// and mapping cannot be performed synchronously: buffers allocated with
+// IREE_HAL_BUFFER_USAGE_MAPPING are mapped at creation for writing and must be
+// remapped with this function prior to reading back results from the device.
+// iree_hal_buffer_map_range and its helpers succeed only while mapped.
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_buffer_map_async(
+    iree_hal_buffer_t* buffer, iree_hal_memory_access_t memory_access,
+    iree_loop_t loop, iree_loop_callback_t callback);
+
+// Unmaps |buffer| so that it may be used by device work.
+// Buffers mapped at creation or with iree_hal_webgpu_buffer_map_async must be
+// unmapped prior to submitting work that references them.
+IREE_API_EXPORT void iree_hal_webgpu_buffer_unmap(iree_hal_buffer_t* buffer);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_driver_t
+//===----------------------------------------------------------------------===//
+
+// WebGPU driver creation options.
+typedef struct iree_hal_webgpu_driver_options_t {
+  // Parameters used for devices created by the driver. The loop is ignored and
+  // the driver provides its own browser event loop.
+  iree_hal_webgpu_device_params_t default_params;
+} iree_hal_webgpu_driver_options_t;
+
+IREE_API_EXPORT void iree_hal_webgpu_driver_options_initialize(
+    iree_hal_webgpu_driver_options_t* out_options);
+
+// Creates a WebGPU HAL driver exposing the device preinitialized by the web
+// page (Module.preinitializedWebGPUDevice in Emscripten). Only available when
+// targeting Emscripten as adapters and devices can only be requested
+// asynchronously from JavaScript.
+//
+// |out_driver| must be released by the caller (see |iree_hal_driver_release|).
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_driver_create(
+    iree_string_view_t identifier,
+    const iree_hal_webgpu_driver_options_t* options,
+    iree_allocator_t host_allocator, iree_hal_driver_t** out_driver);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_API_H_
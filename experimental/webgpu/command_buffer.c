@@ -0,0 +1,819 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/command_buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "experimental/webgpu/api.h"
+#include "experimental/webgpu/native_executable.h"
+#include "experimental/webgpu/pipeline_layout.h"
+#include "experimental/webgpu/webgpu_buffer.h"
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/resource_set.h"
+
+// WebGPU objects created during recording that must live as long as the
+// command buffer. Allocated from the command buffer arena.
+typedef struct iree_hal_webgpu_command_buffer_object_t {
+  struct iree_hal_webgpu_command_buffer_object_t* next;
+  WGPUBuffer buffer;
+  WGPUBindGroup bind_group;
+} iree_hal_webgpu_command_buffer_object_t;
+
+typedef struct iree_hal_webgpu_command_buffer_set_t {
+  // Bindings last pushed with push_descriptor_set.
+  iree_host_size_t binding_count;
+  iree_hal_descriptor_set_binding_t
+      bindings[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  // Bind group created from |bindings| for |layout| or NULL if the bindings
+  // have changed since it was last created.
+  iree_hal_descriptor_set_layout_t* layout;
+  WGPUBindGroup bind_group;
+} iree_hal_webgpu_command_buffer_set_t;
+
+typedef struct iree_hal_webgpu_command_buffer_t {
+  iree_hal_command_buffer_t base;
+  iree_allocator_t host_allocator;
+  WGPUDevice device;
+  iree_hal_webgpu_command_buffer_params_t params;
+
+  // Arena used for recording-time allocations; all are released when the
+  // command buffer is destroyed.
+  iree_arena_allocator_t arena;
+
+  // Maintains a reference to all resources used within the command buffer.
+  iree_hal_resource_set_t* resource_set;
+
+  // WebGPU objects owned by the command buffer.
+  iree_hal_webgpu_command_buffer_object_t* object_head;
+
+  // Encoder commands are recorded into between begin and end.
+  WGPUCommandEncoder encoder;
+  // Finished command buffer ready for submission after end.
+  WGPUCommandBuffer handle;
+
+  // Compute pass dispatches are recorded into, if open, along with the
+  // pipeline and bind groups bound to it.
+  struct {
+    WGPUComputePassEncoder encoder;
+    WGPUComputePipeline pipeline;
+    WGPUBindGroup bind_groups[IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX];
+  } pass;
+
+  // Uniform buffer dispatch params are written to. Mapped at creation and
+  // unmapped when full or when recording ends.
+  struct {
+    WGPUBuffer handle;
+    uint8_t* mapped_ptr;
+    WGPUBindGroup bind_group;
+    iree_host_size_t capacity;
+    iree_host_size_t offset;
+  } params_buffer;
+
+  struct {
+    uint32_t push_constants[IREE_HAL_WEBGPU_MAX_PUSH_CONSTANT_COUNT];
+    iree_hal_webgpu_command_buffer_set_t
+        sets[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT];
+  } state;
+} iree_hal_webgpu_command_buffer_t;
+
+static const iree_hal_command_buffer_vtable_t
+    iree_hal_webgpu_command_buffer_vtable;
+
+static iree_hal_webgpu_command_buffer_t* iree_hal_webgpu_command_buffer_cast(
+    iree_hal_command_buffer_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_command_buffer_vtable);
+  return (iree_hal_webgpu_command_buffer_t*)base_value;
+}
+
+iree_status_t iree_hal_webgpu_command_buffer_create(
+    iree_hal_device_t* device, WGPUDevice handle,
+    const iree_hal_webgpu_command_buffer_params_t* params,
+    iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(block_pool);
+  IREE_ASSERT_ARGUMENT(out_command_buffer);
+  *out_command_buffer = NULL;
+
+  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "WebGPU command buffers can only be submitted once; reusable command "
+        "buffers must be recorded with a deferred command buffer");
+  }
+  if (binding_capacity > 0) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "indirect command buffers not yet implemented");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_command_buffer_t* command_buffer = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*command_buffer), (void**)&command_buffer);
+  if (iree_status_is_ok(status)) {
+    memset(command_buffer, 0, sizeof(*command_buffer));
+    iree_hal_command_buffer_initialize(
+        device, mode, command_categories, queue_affinity, binding_capacity,
+        &iree_hal_webgpu_command_buffer_vtable, &command_buffer->base);
+    command_buffer->host_allocator = host_allocator;
+    command_buffer->device = handle;
+    command_buffer->params = *params;
+    iree_arena_initialize(block_pool, &command_buffer->arena);
+
+    // Params buffers are divided into whole dispatch slots.
+    command_buffer->params_buffer.capacity =
+        iree_max(params->params_buffer_size, IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE) /
+        IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE * IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE;
+
+    status = iree_hal_resource_set_allocate(block_pool,
+                                            &command_buffer->resource_set);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_command_buffer = &command_buffer->base;
+  } else if (command_buffer) {
+    iree_hal_command_buffer_destroy(&command_buffer->base);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_command_buffer_end_pass(
+    iree_hal_webgpu_command_buffer_t* command_buffer) {
+  if (!command_buffer->pass.encoder) return;
+  wgpuComputePassEncoderEnd(command_buffer->pass.encoder);
+  wgpuComputePassEncoderRelease(command_buffer->pass.encoder);
+  memset(&command_buffer->pass, 0, sizeof(command_buffer->pass));
+}
+
+static void iree_hal_webgpu_command_buffer_unmap_params(
+    iree_hal_webgpu_command_buffer_t* command_buffer) {
+  if (!command_buffer->params_buffer.mapped_ptr) return;
+  wgpuBufferUnmap(command_buffer->params_buffer.handle);
+  command_buffer->params_buffer.mapped_ptr = NULL;
+}
+
+static void iree_hal_webgpu_command_buffer_destroy(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  iree_allocator_t host_allocator = command_buffer->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  iree_hal_webgpu_command_buffer_unmap_params(command_buffer);
+  if (command_buffer->encoder) {
+    wgpuCommandEncoderRelease(command_buffer->encoder);
+  }
+  if (command_buffer->handle) {
+    wgpuCommandBufferRelease(command_buffer->handle);
+  }
+
+  // Browsers keep objects referenced by submitted work alive until it
+  // completes so releasing here is safe even if the work is still in flight.
+  for (iree_hal_webgpu_command_buffer_object_t* object =
+           command_buffer->object_head;
+       object != NULL; object = object->next) {
+    if (object->bind_group) wgpuBindGroupRelease(object->bind_group);
+    if (object->buffer) wgpuBufferRelease(object->buffer);
+  }
+
+  if (command_buffer->resource_set) {
+    iree_hal_resource_set_free(command_buffer->resource_set);
+  }
+  iree_arena_deinitialize(&command_buffer->arena);
+  iree_allocator_free(host_allocator, command_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_webgpu_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer) {
+  return iree_hal_command_buffer_dyn_cast(
+      command_buffer, &iree_hal_webgpu_command_buffer_vtable);
+}
+
+static void* iree_hal_webgpu_command_buffer_dyn_cast(
+    iree_hal_command_buffer_t* command_buffer, const void* vtable) {
+  if (vtable == &iree_hal_webgpu_command_buffer_vtable) {
+    IREE_HAL_ASSERT_TYPE(command_buffer, vtable);
+    return command_buffer;
+  }
+  return NULL;
+}
+
+WGPUCommandBuffer iree_hal_webgpu_command_buffer_handle(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  return command_buffer->handle;
+}
+
+// Takes ownership of |buffer| and/or |bind_group| until the command buffer is
+// destroyed. The objects are released immediately on failure.
+static iree_status_t iree_hal_webgpu_command_buffer_track(
+    iree_hal_webgpu_command_buffer_t* command_buffer, WGPUBuffer buffer,
+    WGPUBindGroup bind_group) {
+  iree_hal_webgpu_command_buffer_object_t* object = NULL;
+  iree_status_t status = iree_arena_allocate(
+      &command_buffer->arena, sizeof(*object), (void**)&object);
+  if (!iree_status_is_ok(status)) {
+    if (bind_group) wgpuBindGroupRelease(bind_group);
+    if (buffer) wgpuBufferRelease(buffer);
+    return status;
+  }
+  object->next = command_buffer->object_head;
+  object->buffer = buffer;
+  object->bind_group = bind_group;
+  command_buffer->object_head = object;
+  return iree_ok_status();
+}
+
+// Creates a buffer of |size| bytes mapped at creation for initialization and
+// returns the host pointer to its contents. The caller must unmap it prior to
+// submission.
+static iree_status_t iree_hal_webgpu_command_buffer_create_mapped_buffer(
+    iree_hal_webgpu_command_buffer_t* command_buffer,
+    WGPUBufferUsageFlags usage, iree_host_size_t size, WGPUBuffer* out_buffer,
+    uint8_t** out_mapped_ptr) {
+  const WGPUBufferDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .usage = usage,
+      .size = size,
+      .mappedAtCreation = true,
+  };
+  WGPUBuffer buffer = wgpuDeviceCreateBuffer(command_buffer->device,
+                                             &descriptor);
+  if (!buffer) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "unable to allocate %" PRIhsz
+                            " byte command buffer staging buffer",
+                            size);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_command_buffer_track(command_buffer, buffer, NULL));
+  *out_buffer = buffer;
+  *out_mapped_ptr = (uint8_t*)wgpuBufferGetMappedRange(buffer, 0, size);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_begin(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const WGPUCommandEncoderDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  command_buffer->encoder =
+      wgpuDeviceCreateCommandEncoder(command_buffer->device, &descriptor);
+  iree_status_t status = iree_ok_status();
+  if (!command_buffer->encoder) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "wgpuDeviceCreateCommandEncoder failed");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_end(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  iree_hal_webgpu_command_buffer_unmap_params(command_buffer);
+
+  const WGPUCommandBufferDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  command_buffer->handle =
+      wgpuCommandEncoderFinish(command_buffer->encoder, &descriptor);
+  wgpuCommandEncoderRelease(command_buffer->encoder);
+  command_buffer->encoder = NULL;
+  iree_status_t status = iree_ok_status();
+  if (!command_buffer->handle) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "wgpuCommandEncoderFinish failed");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_command_buffer_begin_debug_group(
+    iree_hal_command_buffer_t* base_command_buffer, iree_string_view_t label,
+    iree_hal_label_color_t label_color,
+    const iree_hal_label_location_t* location) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  // Debug groups must be balanced within a pass; groups are always recorded on
+  // the encoder so that passes can span them.
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  char label_str[128];
+  snprintf(label_str, sizeof(label_str), "%.*s", (int)label.size, label.data);
+  wgpuCommandEncoderPushDebugGroup(command_buffer->encoder, label_str);
+}
+
+static void iree_hal_webgpu_command_buffer_end_debug_group(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  wgpuCommandEncoderPopDebugGroup(command_buffer->encoder);
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_execution_barrier(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_execution_stage_t source_stage_mask,
+    iree_hal_execution_stage_t target_stage_mask,
+    iree_hal_execution_barrier_flags_t flags,
+    iree_host_size_t memory_barrier_count,
+    const iree_hal_memory_barrier_t* memory_barriers,
+    iree_host_size_t buffer_barrier_count,
+    const iree_hal_buffer_barrier_t* buffer_barriers) {
+  // WebGPU tracks hazards between dispatches and passes automatically.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_signal_event(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
+    iree_hal_execution_stage_t source_stage_mask) {
+  // WebGPU has no events and always executes commands in order.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_reset_event(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
+    iree_hal_execution_stage_t source_stage_mask) {
+  // WebGPU has no events and always executes commands in order.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_wait_events(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_host_size_t event_count, const iree_hal_event_t** events,
+    iree_hal_execution_stage_t source_stage_mask,
+    iree_hal_execution_stage_t target_stage_mask,
+    iree_host_size_t memory_barrier_count,
+    const iree_hal_memory_barrier_t* memory_barriers,
+    iree_host_size_t buffer_barrier_count,
+    const iree_hal_buffer_barrier_t* buffer_barriers) {
+  // WebGPU has no events and always executes commands in order.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_discard_buffer(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_buffer_t* buffer) {
+  return iree_ok_status();
+}
+
+// Returns an error if |offset| or |length| is not aligned as WebGPU requires
+// for buffer transfer commands.
+static iree_status_t iree_hal_webgpu_verify_transfer_alignment(
+    iree_device_size_t offset, iree_device_size_t length) {
+  if (!iree_device_size_has_alignment(offset,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT) ||
+      !iree_device_size_has_alignment(length,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "WebGPU transfers must have 4-byte aligned offsets "
+                            "and lengths; offset=%" PRIdsz ", length=%" PRIdsz,
+                            offset, length);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_fill_buffer(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, const void* pattern,
+    iree_host_size_t pattern_length) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+
+  target_offset += iree_hal_buffer_byte_offset(target_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_verify_transfer_alignment(target_offset, length));
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &target_buffer));
+
+  // Splat the pattern to 4 bytes.
+  uint32_t pattern_value = 0;
+  switch (pattern_length) {
+    case 1:
+      pattern_value = *(const uint8_t*)pattern * 0x01010101u;
+      break;
+    case 2:
+      pattern_value = *(const uint16_t*)pattern * 0x00010001u;
+      break;
+    case 4:
+      pattern_value = *(const uint32_t*)pattern;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unsupported fill pattern length: %" PRIhsz,
+                              pattern_length);
+  }
+
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  WGPUBuffer target_handle = iree_hal_webgpu_buffer_handle(target_buffer);
+  if (pattern_value == 0) {
+    wgpuCommandEncoderClearBuffer(command_buffer->encoder, target_handle,
+                                  target_offset, length);
+    return iree_ok_status();
+  }
+
+  // WebGPU can only clear to zero; other patterns are copied from a staging
+  // buffer.
+  WGPUBuffer staging_buffer = NULL;
+  uint8_t* staging_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_create_mapped_buffer(
+      command_buffer, WGPUBufferUsage_CopySrc, (iree_host_size_t)length,
+      &staging_buffer, &staging_ptr));
+  uint32_t* staging_values = (uint32_t*)staging_ptr;
+  for (iree_host_size_t i = 0; i < length / sizeof(uint32_t); ++i) {
+    staging_values[i] = pattern_value;
+  }
+  wgpuBufferUnmap(staging_buffer);
+  wgpuCommandEncoderCopyBufferToBuffer(command_buffer->encoder, staging_buffer,
+                                       0, target_handle, target_offset,
+                                       length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_update_buffer(
+    iree_hal_command_buffer_t* base_command_buffer, const void* source_buffer,
+    iree_host_size_t source_offset, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+
+  target_offset += iree_hal_buffer_byte_offset(target_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_verify_transfer_alignment(target_offset, length));
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &target_buffer));
+
+  // The source data is only valid during this call and is captured into a
+  // staging buffer that is copied from in order with other commands.
+  WGPUBuffer staging_buffer = NULL;
+  uint8_t* staging_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_create_mapped_buffer(
+      command_buffer, WGPUBufferUsage_CopySrc, (iree_host_size_t)length,
+      &staging_buffer, &staging_ptr));
+  memcpy(staging_ptr, (const uint8_t*)source_buffer + source_offset, length);
+  wgpuBufferUnmap(staging_buffer);
+
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  wgpuCommandEncoderCopyBufferToBuffer(
+      command_buffer->encoder, staging_buffer, 0,
+      iree_hal_webgpu_buffer_handle(target_buffer), target_offset, length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_copy_buffer(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+
+  source_offset += iree_hal_buffer_byte_offset(source_buffer);
+  target_offset += iree_hal_buffer_byte_offset(target_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_verify_transfer_alignment(source_offset, length));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_verify_transfer_alignment(target_offset, length));
+  const iree_hal_buffer_t* buffers[2] = {source_buffer, target_buffer};
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, IREE_ARRAYSIZE(buffers), buffers));
+
+  iree_hal_webgpu_command_buffer_end_pass(command_buffer);
+  wgpuCommandEncoderCopyBufferToBuffer(
+      command_buffer->encoder, iree_hal_webgpu_buffer_handle(source_buffer),
+      source_offset, iree_hal_webgpu_buffer_handle(target_buffer),
+      target_offset, length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_collective(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
+    iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "collectives not supported on WebGPU");
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_push_constants(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, iree_host_size_t offset,
+    const void* values, iree_host_size_t values_length) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  if (IREE_UNLIKELY(offset + values_length >
+                    sizeof(command_buffer->state.push_constants))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "push constant range [%" PRIhsz ", %" PRIhsz
+                            ") out of range",
+                            offset, offset + values_length);
+  }
+  memcpy((uint8_t*)command_buffer->state.push_constants + offset, values,
+         values_length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  if (IREE_UNLIKELY(set >= IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set %u out of range; WebGPU supports "
+                            "at most %d",
+                            set, IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT);
+  }
+  if (IREE_UNLIKELY(binding_count >
+                    IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "descriptor set binding count %" PRIhsz
+                            " exceeds the maximum of %d",
+                            binding_count,
+                            IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT);
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_strided(
+      command_buffer->resource_set, binding_count, bindings,
+      offsetof(iree_hal_descriptor_set_binding_t, buffer),
+      sizeof(iree_hal_descriptor_set_binding_t)));
+
+  // The bind group is created lazily on the next dispatch using the set.
+  iree_hal_webgpu_command_buffer_set_t* set_state =
+      &command_buffer->state.sets[set];
+  set_state->binding_count = binding_count;
+  memcpy(set_state->bindings, bindings,
+         binding_count * sizeof(set_state->bindings[0]));
+  set_state->bind_group = NULL;
+  return iree_ok_status();
+}
+
+// Creates a bind group for the bindings pushed to |set_state| with |layout|.
+static iree_status_t iree_hal_webgpu_command_buffer_create_bind_group(
+    iree_hal_webgpu_command_buffer_t* command_buffer,
+    iree_hal_webgpu_command_buffer_set_t* set_state,
+    iree_hal_descriptor_set_layout_t* layout) {
+  WGPUBindGroupEntry entries[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  memset(entries, 0, sizeof(entries));
+  for (iree_host_size_t i = 0; i < set_state->binding_count; ++i) {
+    const iree_hal_descriptor_set_binding_t* binding = &set_state->bindings[i];
+    if (IREE_UNLIKELY(!binding->buffer)) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "binding table slots not yet implemented");
+    }
+    iree_device_size_t length =
+        binding->length == IREE_WHOLE_BUFFER
+            ? iree_hal_buffer_byte_length(binding->buffer) - binding->offset
+            : binding->length;
+    entries[i].binding = binding->binding;
+    entries[i].buffer = iree_hal_webgpu_buffer_handle(binding->buffer);
+    entries[i].offset =
+        iree_hal_buffer_byte_offset(binding->buffer) + binding->offset;
+    entries[i].size = length;
+  }
+  const WGPUBindGroupDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .layout = iree_hal_webgpu_descriptor_set_layout_handle(layout),
+      .entryCount = (uint32_t)set_state->binding_count,
+      .entries = entries,
+  };
+  WGPUBindGroup bind_group =
+      wgpuDeviceCreateBindGroup(command_buffer->device, &descriptor);
+  if (!bind_group) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateBindGroup failed");
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_command_buffer_track(command_buffer, NULL, bind_group));
+  set_state->layout = layout;
+  set_state->bind_group = bind_group;
+  return iree_ok_status();
+}
+
+// Writes the current push constants to a new params buffer slot and binds it.
+static iree_status_t iree_hal_webgpu_command_buffer_bind_params(
+    iree_hal_webgpu_command_buffer_t* command_buffer,
+    iree_host_size_t push_constant_count) {
+  if (!command_buffer->params_buffer.handle ||
+      command_buffer->params_buffer.offset + IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE >
+          command_buffer->params_buffer.capacity) {
+    // Current params buffer (if any) is full; retire it and start another.
+    iree_hal_webgpu_command_buffer_unmap_params(command_buffer);
+    WGPUBuffer params_buffer = NULL;
+    uint8_t* mapped_ptr = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_create_mapped_buffer(
+        command_buffer, WGPUBufferUsage_Uniform,
+        command_buffer->params_buffer.capacity, &params_buffer, &mapped_ptr));
+    const WGPUBindGroupEntry entry = {
+        .binding = IREE_HAL_WEBGPU_PARAMS_BINDING_INDEX,
+        .buffer = params_buffer,
+        .offset = 0,
+        .size = IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE,
+    };
+    const WGPUBindGroupDescriptor descriptor = {
+        .nextInChain = NULL,
+        .label = NULL,
+        .layout = command_buffer->params.params_bind_group_layout,
+        .entryCount = 1,
+        .entries = &entry,
+    };
+    WGPUBindGroup bind_group =
+        wgpuDeviceCreateBindGroup(command_buffer->device, &descriptor);
+    if (!bind_group) {
+      // The buffer is already tracked; just drop the mapping.
+      wgpuBufferUnmap(params_buffer);
+      return iree_make_status(IREE_STATUS_INTERNAL,
+                              "wgpuDeviceCreateBindGroup failed");
+    }
+    IREE_RETURN_IF_ERROR(
+        iree_hal_webgpu_command_buffer_track(command_buffer, NULL, bind_group));
+    command_buffer->params_buffer.handle = params_buffer;
+    command_buffer->params_buffer.mapped_ptr = mapped_ptr;
+    command_buffer->params_buffer.bind_group = bind_group;
+    command_buffer->params_buffer.offset = 0;
+  }
+
+  uint32_t dynamic_offset = (uint32_t)command_buffer->params_buffer.offset;
+  command_buffer->params_buffer.offset += IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE;
+  memcpy(command_buffer->params_buffer.mapped_ptr + dynamic_offset,
+         command_buffer->state.push_constants,
+         push_constant_count * sizeof(uint32_t));
+  wgpuComputePassEncoderSetBindGroup(
+      command_buffer->pass.encoder, IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX,
+      command_buffer->params_buffer.bind_group, 1, &dynamic_offset);
+  return iree_ok_status();
+}
+
+// Opens the compute pass (if needed) and binds the pipeline, bind groups, and
+// params required by |entry_point| of |executable|.
+static iree_status_t iree_hal_webgpu_command_buffer_prepare_dispatch(
+    iree_hal_webgpu_command_buffer_t* command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point) {
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &executable));
+
+  if (!command_buffer->pass.encoder) {
+    const WGPUComputePassDescriptor descriptor = {
+        .nextInChain = NULL,
+        .label = NULL,
+    };
+    command_buffer->pass.encoder = wgpuCommandEncoderBeginComputePass(
+        command_buffer->encoder, &descriptor);
+  }
+
+  WGPUComputePipeline pipeline =
+      iree_hal_webgpu_native_executable_pipeline(executable, entry_point);
+  if (command_buffer->pass.pipeline != pipeline) {
+    wgpuComputePassEncoderSetPipeline(command_buffer->pass.encoder, pipeline);
+    command_buffer->pass.pipeline = pipeline;
+  }
+
+  // Bind groups are only created and set when the bindings or layout changed.
+  iree_hal_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_native_executable_layout(executable, entry_point);
+  iree_host_size_t set_count =
+      iree_hal_webgpu_pipeline_layout_set_count(pipeline_layout);
+  for (uint32_t i = 0; i < set_count; ++i) {
+    iree_hal_descriptor_set_layout_t* set_layout =
+        iree_hal_webgpu_pipeline_layout_set_layout(pipeline_layout, i);
+    iree_hal_webgpu_command_buffer_set_t* set_state =
+        &command_buffer->state.sets[i];
+    if (!set_state->bind_group || set_state->layout != set_layout) {
+      IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_create_bind_group(
+          command_buffer, set_state, set_layout));
+    }
+    if (command_buffer->pass.bind_groups[i] != set_state->bind_group) {
+      wgpuComputePassEncoderSetBindGroup(command_buffer->pass.encoder, i,
+                                         set_state->bind_group, 0, NULL);
+      command_buffer->pass.bind_groups[i] = set_state->bind_group;
+    }
+  }
+
+  iree_host_size_t push_constant_count =
+      iree_hal_webgpu_pipeline_layout_push_constant_count(pipeline_layout);
+  if (push_constant_count == 0) return iree_ok_status();
+
+  // Bind groups between the last set and params must still be bound.
+  for (uint32_t i = (uint32_t)set_count;
+       i < IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX; ++i) {
+    WGPUBindGroup empty_bind_group = command_buffer->params.empty_bind_group;
+    if (command_buffer->pass.bind_groups[i] != empty_bind_group) {
+      wgpuComputePassEncoderSetBindGroup(command_buffer->pass.encoder, i,
+                                         empty_bind_group, 0, NULL);
+      command_buffer->pass.bind_groups[i] = empty_bind_group;
+    }
+  }
+  return iree_hal_webgpu_command_buffer_bind_params(command_buffer,
+                                                    push_constant_count);
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_dispatch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_prepare_dispatch(
+      command_buffer, executable, entry_point));
+  wgpuComputePassEncoderDispatchWorkgroups(command_buffer->pass.encoder,
+                                           workgroup_x, workgroup_y,
+                                           workgroup_z);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_dispatch_indirect(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    iree_hal_buffer_t* workgroups_buffer,
+    iree_device_size_t workgroups_offset) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &workgroups_buffer));
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_prepare_dispatch(
+      command_buffer, executable, entry_point));
+  wgpuComputePassEncoderDispatchWorkgroupsIndirect(
+      command_buffer->pass.encoder,
+      iree_hal_webgpu_buffer_handle(workgroups_buffer),
+      iree_hal_buffer_byte_offset(workgroups_buffer) + workgroups_offset);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_command_buffer_execute_commands(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_command_buffer_t* base_commands,
+    iree_hal_buffer_binding_table_t binding_table) {
+  iree_hal_webgpu_command_buffer_t* command_buffer =
+      iree_hal_webgpu_command_buffer_cast(base_command_buffer);
+  // WebGPU has no secondary command buffers; reusable command buffers are
+  // recorded as deferred command buffers and their commands are replayed into
+  // this one as if they had been recorded here directly.
+  if (!iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "only reusable command buffers created by the "
+                            "WebGPU device can be executed");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &base_commands));
+  return iree_hal_deferred_command_buffer_apply_inline(
+      base_commands, base_command_buffer, binding_table);
+}
+
+static const iree_hal_command_buffer_vtable_t
+    iree_hal_webgpu_command_buffer_vtable = {
+        .destroy = iree_hal_webgpu_command_buffer_destroy,
+        .dyn_cast = iree_hal_webgpu_command_buffer_dyn_cast,
+        .begin = iree_hal_webgpu_command_buffer_begin,
+        .end = iree_hal_webgpu_command_buffer_end,
+        .begin_debug_group = iree_hal_webgpu_command_buffer_begin_debug_group,
+        .end_debug_group = iree_hal_webgpu_command_buffer_end_debug_group,
+        .execution_barrier = iree_hal_webgpu_command_buffer_execution_barrier,
+        .signal_event = iree_hal_webgpu_command_buffer_signal_event,
+        .reset_event = iree_hal_webgpu_command_buffer_reset_event,
+        .wait_events = iree_hal_webgpu_command_buffer_wait_events,
+        .discard_buffer = iree_hal_webgpu_command_buffer_discard_buffer,
+        .fill_buffer = iree_hal_webgpu_command_buffer_fill_buffer,
+        .update_buffer = iree_hal_webgpu_command_buffer_update_buffer,
+        .copy_buffer = iree_hal_webgpu_command_buffer_copy_buffer,
+        .collective = iree_hal_webgpu_command_buffer_collective,
+        .push_constants = iree_hal_webgpu_command_buffer_push_constants,
+        .push_descriptor_set =
+            iree_hal_webgpu_command_buffer_push_descriptor_set,
+        .dispatch = iree_hal_webgpu_command_buffer_dispatch,
+        .dispatch_indirect = iree_hal_webgpu_command_buffer_dispatch_indirect,
+        .execute_commands = iree_hal_webgpu_command_buffer_execute_commands,
+};
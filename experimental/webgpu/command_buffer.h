@@ -0,0 +1,60 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_COMMAND_BUFFER_H_
+#define IREE_HAL_WEBGPU_COMMAND_BUFFER_H_
+
+#include "experimental/webgpu/webgpu_headers.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Shared device objects used by command buffers to emulate push constants.
+typedef struct iree_hal_webgpu_command_buffer_params_t {
+  // Bind group layout of the params uniform buffer with a dynamic offset.
+  WGPUBindGroupLayout params_bind_group_layout;
+  // Bind group with no entries bound to unused bind group indices below the
+  // params bind group.
+  WGPUBindGroup empty_bind_group;
+  // Size of each params uniform buffer allocated by the command buffer.
+  iree_host_size_t params_buffer_size;
+} iree_hal_webgpu_command_buffer_params_t;
+
+// Creates a command buffer that records directly into a WGPUCommandEncoder.
+// Consecutive dispatches are recorded into a single compute pass that is only
+// ended when a transfer command or debug group requires it.
+//
+// Only one-shot command buffers are supported as WebGPU command buffers can
+// only be submitted once; reusable command buffers should be recorded with
+// iree_hal_deferred_command_buffer_t and replayed into a new command buffer
+// on each submission.
+iree_status_t iree_hal_webgpu_command_buffer_create(
+    iree_hal_device_t* device, WGPUDevice handle,
+    const iree_hal_webgpu_command_buffer_params_t* params,
+    iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer);
+
+// Returns true if |command_buffer| is a WebGPU command buffer.
+bool iree_hal_webgpu_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer);
+
+// Returns the finished WGPUCommandBuffer of |command_buffer| for submission or
+// NULL if recording has not ended.
+WGPUCommandBuffer iree_hal_webgpu_command_buffer_handle(
+    iree_hal_command_buffer_t* command_buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_COMMAND_BUFFER_H_
@@ -0,0 +1,284 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/pipeline_layout.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_descriptor_set_layout_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_webgpu_descriptor_set_layout_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  WGPUBindGroupLayout handle;
+} iree_hal_webgpu_descriptor_set_layout_t;
+
+static const iree_hal_descriptor_set_layout_vtable_t
+    iree_hal_webgpu_descriptor_set_layout_vtable;
+
+static iree_hal_webgpu_descriptor_set_layout_t*
+iree_hal_webgpu_descriptor_set_layout_cast(
+    iree_hal_descriptor_set_layout_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value,
+                       &iree_hal_webgpu_descriptor_set_layout_vtable);
+  return (iree_hal_webgpu_descriptor_set_layout_t*)base_value;
+}
+
+static WGPUBufferBindingType iree_hal_webgpu_binding_type(
+    const iree_hal_descriptor_set_layout_binding_t* binding) {
+  if (binding->type == IREE_HAL_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+    return WGPUBufferBindingType_Uniform;
+  }
+  return iree_all_bits_set(binding->flags, IREE_HAL_DESCRIPTOR_FLAG_READ_ONLY)
+             ? WGPUBufferBindingType_ReadOnlyStorage
+             : WGPUBufferBindingType_Storage;
+}
+
+iree_status_t iree_hal_webgpu_descriptor_set_layout_create(
+    WGPUDevice device, iree_hal_descriptor_set_layout_flags_t flags,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_layout_binding_t* bindings,
+    iree_allocator_t host_allocator,
+    iree_hal_descriptor_set_layout_t** out_descriptor_set_layout) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(!binding_count || bindings);
+  IREE_ASSERT_ARGUMENT(out_descriptor_set_layout);
+  *out_descriptor_set_layout = NULL;
+  if (binding_count > IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set binding count %zu over the limit "
+                            "of %d",
+                            binding_count,
+                            IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  WGPUBindGroupLayoutEntry
+      entries[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  memset(entries, 0, sizeof(entries));
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    entries[i].binding = bindings[i].binding;
+    entries[i].visibility = WGPUShaderStage_Compute;
+    entries[i].buffer.type = iree_hal_webgpu_binding_type(&bindings[i]);
+    entries[i].buffer.hasDynamicOffset = false;
+    entries[i].buffer.minBindingSize = 0;
+  }
+  const WGPUBindGroupLayoutDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .entryCount = (uint32_t)binding_count,
+      .entries = entries,
+  };
+  WGPUBindGroupLayout handle =
+      wgpuDeviceCreateBindGroupLayout(device, &descriptor);
+  if (!handle) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateBindGroupLayout failed");
+  }
+
+  iree_hal_webgpu_descriptor_set_layout_t* descriptor_set_layout = NULL;
+  iree_status_t status = iree_allocator_malloc(host_allocator,
+                                               sizeof(*descriptor_set_layout),
+                                               (void**)&descriptor_set_layout);
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(&iree_hal_webgpu_descriptor_set_layout_vtable,
+                                 &descriptor_set_layout->resource);
+    descriptor_set_layout->host_allocator = host_allocator;
+    descriptor_set_layout->handle = handle;
+    *out_descriptor_set_layout =
+        (iree_hal_descriptor_set_layout_t*)descriptor_set_layout;
+  } else {
+    wgpuBindGroupLayoutRelease(handle);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_descriptor_set_layout_destroy(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout) {
+  iree_hal_webgpu_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_webgpu_descriptor_set_layout_cast(base_descriptor_set_layout);
+  iree_allocator_t host_allocator = descriptor_set_layout->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  wgpuBindGroupLayoutRelease(descriptor_set_layout->handle);
+  iree_allocator_free(host_allocator, descriptor_set_layout);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+WGPUBindGroupLayout iree_hal_webgpu_descriptor_set_layout_handle(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout) {
+  iree_hal_webgpu_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_webgpu_descriptor_set_layout_cast(base_descriptor_set_layout);
+  return descriptor_set_layout->handle;
+}
+
+static const iree_hal_descriptor_set_layout_vtable_t
+    iree_hal_webgpu_descriptor_set_layout_vtable = {
+        .destroy = iree_hal_webgpu_descriptor_set_layout_destroy,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_pipeline_layout_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_webgpu_pipeline_layout_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  WGPUPipelineLayout handle;
+  iree_host_size_t push_constant_count;
+  iree_host_size_t set_layout_count;
+  iree_hal_descriptor_set_layout_t* set_layouts[];
+} iree_hal_webgpu_pipeline_layout_t;
+
+static const iree_hal_pipeline_layout_vtable_t
+    iree_hal_webgpu_pipeline_layout_vtable;
+
+static iree_hal_webgpu_pipeline_layout_t* iree_hal_webgpu_pipeline_layout_cast(
+    iree_hal_pipeline_layout_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_pipeline_layout_vtable);
+  return (iree_hal_webgpu_pipeline_layout_t*)base_value;
+}
+
+iree_status_t iree_hal_webgpu_pipeline_layout_create(
+    WGPUDevice device, iree_host_size_t set_layout_count,
+    iree_hal_descriptor_set_layout_t* const* set_layouts,
+    iree_host_size_t push_constant_count,
+    WGPUBindGroupLayout empty_bind_group_layout,
+    WGPUBindGroupLayout params_bind_group_layout,
+    iree_allocator_t host_allocator,
+    iree_hal_pipeline_layout_t** out_pipeline_layout) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(!set_layout_count || set_layouts);
+  IREE_ASSERT_ARGUMENT(out_pipeline_layout);
+  *out_pipeline_layout = NULL;
+  if (set_layout_count > IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set count %zu over the limit of %d "
+                            "(bind group %d is reserved for push constants)",
+                            set_layout_count,
+                            IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT,
+                            IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX);
+  }
+  if (push_constant_count > IREE_HAL_WEBGPU_MAX_PUSH_CONSTANT_COUNT) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "push constant count %zu over the limit of %d",
+                            push_constant_count,
+                            (int)IREE_HAL_WEBGPU_MAX_PUSH_CONSTANT_COUNT);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Bind group layouts must be dense; any gap before the params bind group is
+  // filled with an empty layout.
+  WGPUBindGroupLayout
+      bind_group_layouts[IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX + 1];
+  uint32_t bind_group_layout_count = 0;
+  for (iree_host_size_t i = 0; i < set_layout_count; ++i) {
+    bind_group_layouts[bind_group_layout_count++] =
+        iree_hal_webgpu_descriptor_set_layout_handle(set_layouts[i]);
+  }
+  if (push_constant_count > 0) {
+    while (bind_group_layout_count < IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX) {
+      bind_group_layouts[bind_group_layout_count++] = empty_bind_group_layout;
+    }
+    bind_group_layouts[bind_group_layout_count++] = params_bind_group_layout;
+  }
+  const WGPUPipelineLayoutDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .bindGroupLayoutCount = bind_group_layout_count,
+      .bindGroupLayouts = bind_group_layouts,
+  };
+  WGPUPipelineLayout handle =
+      wgpuDeviceCreatePipelineLayout(device, &descriptor);
+  if (!handle) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreatePipelineLayout failed");
+  }
+
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout = NULL;
+  iree_host_size_t total_size =
+      sizeof(*pipeline_layout) +
+      set_layout_count * sizeof(*pipeline_layout->set_layouts);
+  iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
+                                               (void**)&pipeline_layout);
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(&iree_hal_webgpu_pipeline_layout_vtable,
+                                 &pipeline_layout->resource);
+    pipeline_layout->host_allocator = host_allocator;
+    pipeline_layout->handle = handle;
+    pipeline_layout->push_constant_count = push_constant_count;
+    pipeline_layout->set_layout_count = set_layout_count;
+    for (iree_host_size_t i = 0; i < set_layout_count; ++i) {
+      pipeline_layout->set_layouts[i] = set_layouts[i];
+      iree_hal_descriptor_set_layout_retain(set_layouts[i]);
+    }
+    *out_pipeline_layout = (iree_hal_pipeline_layout_t*)pipeline_layout;
+  } else {
+    wgpuPipelineLayoutRelease(handle);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_pipeline_layout_destroy(
+    iree_hal_pipeline_layout_t* base_pipeline_layout) {
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_pipeline_layout_cast(base_pipeline_layout);
+  iree_allocator_t host_allocator = pipeline_layout->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  wgpuPipelineLayoutRelease(pipeline_layout->handle);
+  for (iree_host_size_t i = 0; i < pipeline_layout->set_layout_count; ++i) {
+    iree_hal_descriptor_set_layout_release(pipeline_layout->set_layouts[i]);
+  }
+  iree_allocator_free(host_allocator, pipeline_layout);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+WGPUPipelineLayout iree_hal_webgpu_pipeline_layout_handle(
+    iree_hal_pipeline_layout_t* base_pipeline_layout) {
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_pipeline_layout_cast(base_pipeline_layout);
+  return pipeline_layout->handle;
+}
+
+iree_host_size_t iree_hal_webgpu_pipeline_layout_set_count(
+    iree_hal_pipeline_layout_t* base_pipeline_layout) {
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_pipeline_layout_cast(base_pipeline_layout);
+  return pipeline_layout->set_layout_count;
+}
+
+iree_hal_descriptor_set_layout_t* iree_hal_webgpu_pipeline_layout_set_layout(
+    iree_hal_pipeline_layout_t* base_pipeline_layout, uint32_t set) {
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_pipeline_layout_cast(base_pipeline_layout);
+  if (set >= pipeline_layout->set_layout_count) return NULL;
+  return pipeline_layout->set_layouts[set];
+}
+
+iree_host_size_t iree_hal_webgpu_pipeline_layout_push_constant_count(
+    iree_hal_pipeline_layout_t* base_pipeline_layout) {
+  iree_hal_webgpu_pipeline_layout_t* pipeline_layout =
+      iree_hal_webgpu_pipeline_layout_cast(base_pipeline_layout);
+  return pipeline_layout->push_constant_count;
+}
+
+static const iree_hal_pipeline_layout_vtable_t
+    iree_hal_webgpu_pipeline_layout_vtable = {
+        .destroy = iree_hal_webgpu_pipeline_layout_destroy,
+};
@@ -0,0 +1,93 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_PIPELINE_LAYOUT_H_
+#define IREE_HAL_WEBGPU_PIPELINE_LAYOUT_H_
+
+#include "experimental/webgpu/webgpu_headers.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// WebGPU has no push constants: the compiler replaces them with loads from a
+// uniform buffer bound at this bind group and binding index (see
+// WGSLReplacePushConstants.cpp). Must match IREE_HAL_WEBGPU_PARAMS_* there.
+#define IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX 3
+#define IREE_HAL_WEBGPU_PARAMS_BINDING_INDEX 0
+
+// Maximum number of descriptor sets; WebGPU only guarantees 4 bind groups
+// (maxBindGroups) and the last is reserved for the params buffer.
+#define IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_COUNT \
+  IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX
+
+// Maximum number of bindings in a descriptor set that are tracked by command
+// buffers.
+#define IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT 16
+
+// Size in bytes of the params of a single dispatch. Each dispatch is given one
+// minUniformBufferOffsetAlignment slot of the params buffer and the compiler
+// packs push constants into vec4<i32>s.
+#define IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE 256
+#define IREE_HAL_WEBGPU_MAX_PUSH_CONSTANT_COUNT \
+  (IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE / sizeof(uint32_t))
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_descriptor_set_layout_t
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_webgpu_descriptor_set_layout_create(
+    WGPUDevice device, iree_hal_descriptor_set_layout_flags_t flags,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_layout_binding_t* bindings,
+    iree_allocator_t host_allocator,
+    iree_hal_descriptor_set_layout_t** out_descriptor_set_layout);
+
+// Returns the WGPUBindGroupLayout of |descriptor_set_layout|.
+WGPUBindGroupLayout iree_hal_webgpu_descriptor_set_layout_handle(
+    iree_hal_descriptor_set_layout_t* descriptor_set_layout);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_pipeline_layout_t
+//===----------------------------------------------------------------------===//
+
+// Creates a pipeline layout from |set_layouts|.
+// When |push_constant_count| is non-zero the bind groups between the last set
+// and IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX are filled with
+// |empty_bind_group_layout| and the params bind group uses
+// |params_bind_group_layout|.
+iree_status_t iree_hal_webgpu_pipeline_layout_create(
+    WGPUDevice device, iree_host_size_t set_layout_count,
+    iree_hal_descriptor_set_layout_t* const* set_layouts,
+    iree_host_size_t push_constant_count,
+    WGPUBindGroupLayout empty_bind_group_layout,
+    WGPUBindGroupLayout params_bind_group_layout,
+    iree_allocator_t host_allocator,
+    iree_hal_pipeline_layout_t** out_pipeline_layout);
+
+// Returns the WGPUPipelineLayout of |pipeline_layout|.
+WGPUPipelineLayout iree_hal_webgpu_pipeline_layout_handle(
+    iree_hal_pipeline_layout_t* pipeline_layout);
+
+// Returns the number of descriptor sets in |pipeline_layout|.
+iree_host_size_t iree_hal_webgpu_pipeline_layout_set_count(
+    iree_hal_pipeline_layout_t* pipeline_layout);
+
+// Returns the layout of descriptor |set| in |pipeline_layout|.
+iree_hal_descriptor_set_layout_t* iree_hal_webgpu_pipeline_layout_set_layout(
+    iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set);
+
+// Returns the number of push constants in |pipeline_layout|.
+iree_host_size_t iree_hal_webgpu_pipeline_layout_push_constant_count(
+    iree_hal_pipeline_layout_t* pipeline_layout);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_PIPELINE_LAYOUT_H_
@@ -0,0 +1,360 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/webgpu_allocator.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "experimental/webgpu/webgpu_buffer.h"
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+
+// Minimum alignment of storage and uniform buffer binding offsets
+// (minStorageBufferOffsetAlignment/minUniformBufferOffsetAlignment).
+// Implementations may report smaller values but this is the default limit all
+// implementations must support.
+#define IREE_HAL_WEBGPU_MIN_BINDING_OFFSET_ALIGNMENT 256
+
+typedef struct iree_hal_webgpu_allocator_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  WGPUDevice device;
+  WGPUQueue queue;
+
+  IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
+} iree_hal_webgpu_allocator_t;
+
+static const iree_hal_allocator_vtable_t iree_hal_webgpu_allocator_vtable;
+
+static iree_hal_webgpu_allocator_t* iree_hal_webgpu_allocator_cast(
+    iree_hal_allocator_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_allocator_vtable);
+  return (iree_hal_webgpu_allocator_t*)base_value;
+}
+
+iree_status_t iree_hal_webgpu_allocator_create(
+    WGPUDevice device, WGPUQueue queue, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(queue);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_allocator_t* allocator = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*allocator), (void**)&allocator);
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(&iree_hal_webgpu_allocator_vtable,
+                                 &allocator->resource);
+    allocator->host_allocator = host_allocator;
+    allocator->device = device;
+    allocator->queue = queue;
+    *out_allocator = (iree_hal_allocator_t*)allocator;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_allocator_destroy(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_webgpu_allocator_t* allocator =
+      iree_hal_webgpu_allocator_cast(base_allocator);
+  iree_allocator_t host_allocator = allocator->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_allocator_free(host_allocator, allocator);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_allocator_t iree_hal_webgpu_allocator_host_allocator(
+    const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_webgpu_allocator_t* allocator =
+      (iree_hal_webgpu_allocator_t*)base_allocator;
+  return allocator->host_allocator;
+}
+
+static iree_status_t iree_hal_webgpu_allocator_trim(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  return iree_ok_status();
+}
+
+static void iree_hal_webgpu_allocator_query_statistics(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_allocator_statistics_t* IREE_RESTRICT out_statistics) {
+  IREE_STATISTICS({
+    iree_hal_webgpu_allocator_t* allocator =
+        iree_hal_webgpu_allocator_cast(base_allocator);
+    memcpy(out_statistics, &allocator->statistics, sizeof(*out_statistics));
+  });
+}
+
+static iree_status_t iree_hal_webgpu_allocator_query_memory_heaps(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_host_size_t capacity,
+    iree_hal_allocator_memory_heap_t* IREE_RESTRICT heaps,
+    iree_host_size_t* IREE_RESTRICT out_count) {
+  const iree_host_size_t count = 3;
+  if (out_count) *out_count = count;
+  if (capacity < count) {
+    // NOTE: lightweight as this is hit in normal pre-sizing usage.
+    return iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  }
+
+  // WebGPU doesn't expose heaps; the maxBufferSize limit could be queried from
+  // the device but allocations beyond it fail with a validation error anyway.
+  const iree_device_size_t max_allocation_size = ~(iree_device_size_t)0;
+  const iree_device_size_t min_alignment =
+      IREE_HAL_WEBGPU_MIN_BINDING_OFFSET_ALIGNMENT;
+
+  // Device-local memory (dispatch resources):
+  heaps[0] = (iree_hal_allocator_memory_heap_t){
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .allowed_usage =
+          IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_DISPATCH,
+      .max_allocation_size = max_allocation_size,
+      .min_alignment = min_alignment,
+  };
+
+  // MapWrite|CopySrc host-local memory mapped at creation (upload):
+  heaps[1] = (iree_hal_allocator_memory_heap_t){
+      .type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_COHERENT,
+      .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE |
+                       IREE_HAL_BUFFER_USAGE_MAPPING,
+      .max_allocation_size = max_allocation_size,
+      .min_alignment = min_alignment,
+  };
+
+  // MapRead|CopyDst host-local memory mapped asynchronously (download):
+  heaps[2] = (iree_hal_allocator_memory_heap_t){
+      .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+              IREE_HAL_MEMORY_TYPE_HOST_COHERENT |
+              IREE_HAL_MEMORY_TYPE_HOST_CACHED,
+      .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET |
+                       IREE_HAL_BUFFER_USAGE_MAPPING,
+      .max_allocation_size = max_allocation_size,
+      .min_alignment = min_alignment,
+  };
+
+  return iree_ok_status();
+}
+
+// Returns true if |params| request a host-mappable buffer.
+// WebGPU buffers that can be mapped can only be used as copy sources (when
+// mapped for writing) or copy targets (when mapped for reading).
+static bool iree_hal_webgpu_allocator_is_mappable(
+    const iree_hal_buffer_params_t* params) {
+  const iree_hal_buffer_usage_t mapping_usage =
+      IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+      IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT;
+  return iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+         iree_any_bit_set(params->usage, mapping_usage);
+}
+
+static iree_hal_buffer_compatibility_t
+iree_hal_webgpu_allocator_query_buffer_compatibility(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t* IREE_RESTRICT allocation_size) {
+  // Optional mappings of buffers used on the device are dropped: WebGPU does
+  // not allow mappable buffers to be used by dispatches.
+  if (iree_all_bits_set(params->usage,
+                        IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL) &&
+      iree_any_bit_set(params->usage, IREE_HAL_BUFFER_USAGE_DISPATCH)) {
+    params->usage &= ~(IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                       IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |
+                       IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL);
+  }
+
+  iree_hal_buffer_compatibility_t compatibility =
+      IREE_HAL_BUFFER_COMPATIBILITY_NONE;
+  if (iree_hal_webgpu_allocator_is_mappable(params)) {
+    // Mappable buffers are either upload or download staging buffers.
+    if (iree_any_bit_set(params->usage, IREE_HAL_BUFFER_USAGE_DISPATCH)) {
+      return IREE_HAL_BUFFER_COMPATIBILITY_NONE;
+    }
+    compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE |
+                     IREE_HAL_BUFFER_COMPATIBILITY_QUEUE_TRANSFER;
+    params->type |= IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params->type &= ~IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params->type |= IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  } else {
+    // Everything else is device-local memory only accessible from the host by
+    // queue writes.
+    compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE;
+    if (iree_any_bit_set(params->usage, IREE_HAL_BUFFER_USAGE_TRANSFER)) {
+      compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_QUEUE_TRANSFER;
+    }
+    if (iree_any_bit_set(params->usage, IREE_HAL_BUFFER_USAGE_DISPATCH)) {
+      compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_QUEUE_DISPATCH;
+    }
+    params->type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  }
+
+  // We are now optimal.
+  params->type &= ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
+
+  // Guard against the corner case where the requested buffer size is 0. The
+  // application is unlikely to do anything when requesting a 0-byte buffer; but
+  // it can happen in real world use cases. So we should at least not crash.
+  if (*allocation_size == 0) *allocation_size = 4;
+
+  return compatibility;
+}
+
+static iree_status_t iree_hal_webgpu_allocator_allocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size, iree_const_byte_span_t initial_data,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_webgpu_allocator_t* allocator =
+      iree_hal_webgpu_allocator_cast(base_allocator);
+
+  // Coerce options into those required by the current device.
+  iree_hal_buffer_params_t compat_params = *params;
+  if (!iree_all_bits_set(iree_hal_webgpu_allocator_query_buffer_compatibility(
+                             base_allocator, &compat_params, &allocation_size),
+                         IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "allocator cannot allocate a buffer with the given parameters; "
+        "WebGPU buffers cannot be both host mappable and used by dispatches");
+  }
+
+  // Mappable buffers are created mapped for writing unless they are download
+  // buffers in which case they have to be mapped asynchronously once device
+  // work has written them.
+  WGPUBufferUsageFlags usage = 0;
+  bool mapped_at_creation = false;
+  if (iree_hal_webgpu_allocator_is_mappable(&compat_params)) {
+    if (iree_all_bits_set(compat_params.type,
+                          IREE_HAL_MEMORY_TYPE_HOST_CACHED) ||
+        (iree_all_bits_set(compat_params.usage,
+                           IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET) &&
+         !iree_all_bits_set(compat_params.usage,
+                            IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE))) {
+      usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+      compat_params.type |= IREE_HAL_MEMORY_TYPE_HOST_CACHED;
+      compat_params.usage &= ~IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE;
+      if (!iree_const_byte_span_is_empty(initial_data)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "download buffers cannot have initial data");
+      }
+    } else {
+      usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+      compat_params.usage &= ~IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET;
+      mapped_at_creation = true;
+    }
+  } else {
+    usage = WGPUBufferUsage_Storage | WGPUBufferUsage_Uniform |
+            WGPUBufferUsage_Indirect | WGPUBufferUsage_CopySrc |
+            WGPUBufferUsage_CopyDst;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  const WGPUBufferDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .usage = usage,
+      .size = iree_device_align(allocation_size,
+                                IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT),
+      .mappedAtCreation = mapped_at_creation,
+  };
+  WGPUBuffer handle = wgpuDeviceCreateBuffer(allocator->device, &descriptor);
+  if (!handle) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "unable to allocate WebGPU buffer of %" PRIdsz
+                            " bytes",
+                            allocation_size);
+  }
+
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_webgpu_buffer_wrap(
+      base_allocator, allocator->host_allocator, compat_params.type,
+      compat_params.access, compat_params.usage, allocation_size, handle,
+      mapped_at_creation, &buffer);
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED("WebGPU", (void*)handle, allocation_size);
+    IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
+        &allocator->statistics, compat_params.type, allocation_size));
+  }
+
+  // Upload the initial contents either through the mapping or the queue.
+  if (iree_status_is_ok(status) &&
+      !iree_const_byte_span_is_empty(initial_data)) {
+    if (mapped_at_creation) {
+      memcpy(iree_hal_webgpu_buffer_mapped_ptr(buffer), initial_data.data,
+             initial_data.data_length);
+    } else {
+      status = iree_hal_webgpu_buffer_queue_write(allocator->queue, buffer, 0,
+                                                  initial_data);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_allocator_deallocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
+  iree_hal_webgpu_allocator_t* allocator =
+      iree_hal_webgpu_allocator_cast(base_allocator);
+  (void)allocator;
+
+  IREE_TRACE_FREE_NAMED("WebGPU",
+                        (void*)iree_hal_webgpu_buffer_handle(base_buffer));
+  IREE_STATISTICS(iree_hal_allocator_statistics_record_free(
+      &allocator->statistics, iree_hal_buffer_memory_type(base_buffer),
+      iree_hal_buffer_allocation_size(base_buffer)));
+
+  iree_hal_buffer_destroy(base_buffer);
+}
+
+static iree_status_t iree_hal_webgpu_allocator_import_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "importing buffers is not supported by WebGPU");
+}
+
+static iree_status_t iree_hal_webgpu_allocator_export_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer,
+    iree_hal_external_buffer_type_t requested_type,
+    iree_hal_external_buffer_flags_t requested_flags,
+    iree_hal_external_buffer_t* IREE_RESTRICT out_external_buffer) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "exporting buffers is not supported by WebGPU");
+}
+
+static const iree_hal_allocator_vtable_t iree_hal_webgpu_allocator_vtable = {
+    .destroy = iree_hal_webgpu_allocator_destroy,
+    .host_allocator = iree_hal_webgpu_allocator_host_allocator,
+    .trim = iree_hal_webgpu_allocator_trim,
+    .query_statistics = iree_hal_webgpu_allocator_query_statistics,
+    .query_memory_heaps = iree_hal_webgpu_allocator_query_memory_heaps,
+    .query_buffer_compatibility =
+        iree_hal_webgpu_allocator_query_buffer_compatibility,
+    .allocate_buffer = iree_hal_webgpu_allocator_allocate_buffer,
+    .deallocate_buffer = iree_hal_webgpu_allocator_deallocate_buffer,
+    .import_buffer = iree_hal_webgpu_allocator_import_buffer,
+    .export_buffer = iree_hal_webgpu_allocator_export_buffer,
+};
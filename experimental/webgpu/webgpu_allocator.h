@@ -0,0 +1,28 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_WEBGPU_ALLOCATOR_H_
+#define IREE_HAL_WEBGPU_WEBGPU_ALLOCATOR_H_
+
+#include "experimental/webgpu/webgpu_headers.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a WebGPU allocator allocating WGPUBuffers from |device|.
+// Initial buffer contents are uploaded with writes to |queue|.
+iree_status_t iree_hal_webgpu_allocator_create(
+    WGPUDevice device, WGPUQueue queue, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_WEBGPU_ALLOCATOR_H_
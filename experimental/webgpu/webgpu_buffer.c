@@ -0,0 +1,343 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/webgpu_buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "experimental/webgpu/api.h"
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+
+typedef struct iree_hal_webgpu_buffer_t {
+  iree_hal_buffer_t base;
+  WGPUBuffer handle;
+  // Host pointer to the full allocation while mapped or NULL if unmapped.
+  // WebGPU implementations may copy the mapped range back to the buffer when
+  // unmapped (such as Emscripten copying from the wasm heap) so the range is
+  // fetched once per mapping and reused by all iree_hal_buffer_map_range calls.
+  uint8_t* mapped_ptr;
+  // Access the current mapping allows.
+  iree_hal_memory_access_t mapped_access;
+  // True while an asynchronous map request is pending.
+  bool map_pending;
+} iree_hal_webgpu_buffer_t;
+
+static const iree_hal_buffer_vtable_t iree_hal_webgpu_buffer_vtable;
+
+static iree_hal_webgpu_buffer_t* iree_hal_webgpu_buffer_cast(
+    iree_hal_buffer_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_buffer_vtable);
+  return (iree_hal_webgpu_buffer_t*)base_value;
+}
+
+// Returns the size of the WGPUBuffer backing the allocation of |buffer|.
+static size_t iree_hal_webgpu_buffer_handle_size(iree_hal_buffer_t* buffer) {
+  return (size_t)iree_device_align(iree_hal_buffer_allocation_size(buffer),
+                                   IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT);
+}
+
+iree_status_t iree_hal_webgpu_buffer_wrap(
+    iree_hal_allocator_t* allocator, iree_allocator_t host_allocator,
+    iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    WGPUBuffer handle, bool mapped_at_creation,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_buffer_t* buffer = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_initialize(host_allocator, allocator, &buffer->base,
+                               allocation_size, /*byte_offset=*/0,
+                               allocation_size, memory_type, allowed_access,
+                               allowed_usage, &iree_hal_webgpu_buffer_vtable,
+                               &buffer->base);
+    buffer->handle = handle;
+    buffer->mapped_ptr = NULL;
+    buffer->mapped_access = IREE_HAL_MEMORY_ACCESS_NONE;
+    buffer->map_pending = false;
+    if (mapped_at_creation) {
+      buffer->mapped_ptr = (uint8_t*)wgpuBufferGetMappedRange(
+          handle, 0, iree_hal_webgpu_buffer_handle_size(&buffer->base));
+      buffer->mapped_access = IREE_HAL_MEMORY_ACCESS_ALL;
+    }
+    *out_buffer = &buffer->base;
+  } else {
+    wgpuBufferDestroy(handle);
+    wgpuBufferRelease(handle);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_buffer_destroy(iree_hal_buffer_t* base_buffer) {
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(base_buffer);
+  iree_allocator_t host_allocator = base_buffer->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Destruction is deferred by WebGPU until work using the buffer completes.
+  wgpuBufferDestroy(buffer->handle);
+  wgpuBufferRelease(buffer->handle);
+  iree_allocator_free(host_allocator, buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_webgpu_buffer_isa(iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_hal_webgpu_buffer_vtable);
+}
+
+bool iree_hal_webgpu_buffer_is_mapped(iree_hal_buffer_t* base_buffer) {
+  return iree_hal_webgpu_buffer_mapped_ptr(base_buffer) != NULL;
+}
+
+uint8_t* iree_hal_webgpu_buffer_mapped_ptr(iree_hal_buffer_t* base_buffer) {
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  return buffer->mapped_ptr;
+}
+
+IREE_API_EXPORT WGPUBuffer
+iree_hal_webgpu_buffer_handle(iree_hal_buffer_t* base_buffer) {
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  return buffer->handle;
+}
+
+// State of a pending iree_hal_webgpu_buffer_map_async request.
+typedef struct iree_hal_webgpu_buffer_map_request_t {
+  iree_hal_webgpu_buffer_t* buffer;  // retained
+  iree_hal_memory_access_t memory_access;
+  iree_loop_t loop;
+  iree_loop_callback_t callback;
+  // Status of the mapping passed to the user callback.
+  iree_status_t status;
+} iree_hal_webgpu_buffer_map_request_t;
+
+// Issued from the loop after WebGPU has completed the mapping.
+static iree_status_t iree_hal_webgpu_buffer_map_request_complete(
+    void* user_data, iree_loop_t loop, iree_status_t loop_status) {
+  iree_hal_webgpu_buffer_map_request_t* request =
+      (iree_hal_webgpu_buffer_map_request_t*)user_data;
+  iree_hal_webgpu_buffer_t* buffer = request->buffer;
+  iree_loop_callback_t callback = request->callback;
+  iree_status_t status = request->status;
+  if (!iree_status_is_ok(loop_status)) {
+    status = iree_status_join(status, loop_status);
+  }
+  iree_allocator_free(buffer->base.host_allocator, request);
+  iree_hal_buffer_release(&buffer->base);
+  return callback.fn(callback.user_data, loop, status);
+}
+
+static void iree_hal_webgpu_buffer_map_callback(WGPUBufferMapAsyncStatus result,
+                                                void* user_data) {
+  iree_hal_webgpu_buffer_map_request_t* request =
+      (iree_hal_webgpu_buffer_map_request_t*)user_data;
+  iree_hal_webgpu_buffer_t* buffer = request->buffer;
+  buffer->map_pending = false;
+  if (result == WGPUBufferMapAsyncStatus_Success) {
+    size_t handle_size = iree_hal_webgpu_buffer_handle_size(&buffer->base);
+    if (iree_all_bits_set(request->memory_access,
+                          IREE_HAL_MEMORY_ACCESS_WRITE)) {
+      buffer->mapped_ptr = (uint8_t*)wgpuBufferGetMappedRange(
+          buffer->handle, 0, handle_size);
+    } else {
+      buffer->mapped_ptr = (uint8_t*)wgpuBufferGetConstMappedRange(
+          buffer->handle, 0, handle_size);
+    }
+    buffer->mapped_access = request->memory_access;
+    request->status = iree_ok_status();
+  } else {
+    request->status =
+        iree_make_status(IREE_STATUS_ABORTED,
+                         "WebGPU buffer mapping failed with status %d", result);
+  }
+
+  // Route the completion through the loop so that the user callback is issued
+  // in the same way as all other asynchronous work.
+  iree_status_t status =
+      iree_loop_call(request->loop, IREE_LOOP_PRIORITY_DEFAULT,
+                     iree_hal_webgpu_buffer_map_request_complete, request);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(iree_hal_webgpu_buffer_map_request_complete(
+        request, request->loop, status));
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_buffer_map_async(
+    iree_hal_buffer_t* base_buffer, iree_hal_memory_access_t memory_access,
+    iree_loop_t loop, iree_loop_callback_t callback) {
+  IREE_ASSERT_ARGUMENT(base_buffer);
+  IREE_ASSERT_ARGUMENT(callback.fn);
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_memory_type(
+      iree_hal_buffer_memory_type(base_buffer),
+      IREE_HAL_MEMORY_TYPE_HOST_VISIBLE));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_usage(iree_hal_buffer_allowed_usage(base_buffer),
+                                     IREE_HAL_BUFFER_USAGE_MAPPING));
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_access(
+      iree_hal_buffer_allowed_access(base_buffer), memory_access));
+  if (buffer->mapped_ptr || buffer->map_pending) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "buffer is already mapped or has a pending map "
+                            "request; unmap it first");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_buffer_map_request_t* request = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(buffer->base.host_allocator, sizeof(*request),
+                                (void**)&request));
+  request->buffer = buffer;
+  iree_hal_buffer_retain(&buffer->base);
+  request->memory_access = memory_access;
+  request->loop = loop;
+  request->callback = callback;
+  request->status = iree_ok_status();
+
+  WGPUMapModeFlags map_mode =
+      iree_all_bits_set(memory_access, IREE_HAL_MEMORY_ACCESS_WRITE)
+          ? WGPUMapMode_Write
+          : WGPUMapMode_Read;
+  buffer->map_pending = true;
+  wgpuBufferMapAsync(buffer->handle, map_mode, 0,
+                     iree_hal_webgpu_buffer_handle_size(&buffer->base),
+                     iree_hal_webgpu_buffer_map_callback, request);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void iree_hal_webgpu_buffer_unmap(
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  if (!buffer->mapped_ptr) return;
+  wgpuBufferUnmap(buffer->handle);
+  buffer->mapped_ptr = NULL;
+  buffer->mapped_access = IREE_HAL_MEMORY_ACCESS_NONE;
+}
+
+iree_status_t iree_hal_webgpu_buffer_queue_write(WGPUQueue queue,
+                                                 iree_hal_buffer_t* buffer,
+                                                 iree_device_size_t offset,
+                                                 iree_const_byte_span_t data) {
+  if (data.data_length == 0) return iree_ok_status();
+  iree_device_size_t allocation_offset =
+      iree_hal_buffer_byte_offset(buffer) + offset;
+  iree_device_size_t allocation_end = allocation_offset + data.data_length;
+  if (!iree_device_size_has_alignment(allocation_offset,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "WebGPU buffer writes must be 4-byte aligned; "
+                            "offset %" PRIdsz " is not",
+                            allocation_offset);
+  }
+  iree_host_size_t aligned_length = (iree_host_size_t)iree_device_align(
+      data.data_length, IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT);
+  if (aligned_length == data.data_length) {
+    wgpuQueueWriteBuffer(queue, iree_hal_webgpu_buffer_handle(buffer),
+                         allocation_offset, data.data, data.data_length);
+    return iree_ok_status();
+  }
+  if (allocation_end != iree_hal_buffer_allocation_size(buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "WebGPU buffer writes must be 4-byte aligned; "
+                            "length %" PRIhsz
+                            " is not and does not end the buffer",
+                            data.data_length);
+  }
+
+  // Write the aligned prefix directly and the tail padded into the slack at
+  // the end of the allocation.
+  iree_host_size_t prefix_length =
+      aligned_length - IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT;
+  if (prefix_length > 0) {
+    wgpuQueueWriteBuffer(queue, iree_hal_webgpu_buffer_handle(buffer),
+                         allocation_offset, data.data, prefix_length);
+  }
+  uint8_t tail[IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT] = {0};
+  memcpy(tail, data.data + prefix_length, data.data_length - prefix_length);
+  wgpuQueueWriteBuffer(queue, iree_hal_webgpu_buffer_handle(buffer),
+                       allocation_offset + prefix_length, tail, sizeof(tail));
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_buffer_map_range(
+    iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
+    iree_hal_memory_access_t memory_access,
+    iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
+    iree_hal_buffer_mapping_t* mapping) {
+  iree_hal_webgpu_buffer_t* buffer = iree_hal_webgpu_buffer_cast(base_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_memory_type(
+      iree_hal_buffer_memory_type(base_buffer),
+      IREE_HAL_MEMORY_TYPE_HOST_VISIBLE));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_usage(iree_hal_buffer_allowed_usage(base_buffer),
+                                     IREE_HAL_BUFFER_USAGE_MAPPING));
+  if (!buffer->mapped_ptr) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "WebGPU buffers can only be accessed while mapped; "
+                            "use iree_hal_webgpu_buffer_map_async prior to "
+                            "mapping ranges");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_access(
+      buffer->mapped_access,
+      memory_access & ~IREE_HAL_MEMORY_ACCESS_DISCARD));
+
+  uint8_t* data_ptr = buffer->mapped_ptr + local_byte_offset;
+  // If we mapped for discard scribble over the bytes. This is not a mandated
+  // behavior but it will make debugging issues easier.
+#ifndef NDEBUG
+  if (iree_any_bit_set(memory_access, IREE_HAL_MEMORY_ACCESS_DISCARD)) {
+    memset(data_ptr, 0xCD, local_byte_length);
+  }
+#endif  // !NDEBUG
+
+  mapping->contents = iree_make_byte_span(data_ptr, local_byte_length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_buffer_unmap_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
+  // The whole buffer stays mapped until iree_hal_webgpu_buffer_unmap.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_buffer_invalidate_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  // Nothing to do: mapped ranges are coherent.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_buffer_flush_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  // Nothing to do: writes are made visible when the buffer is unmapped.
+  return iree_ok_status();
+}
+
+static const iree_hal_buffer_vtable_t iree_hal_webgpu_buffer_vtable = {
+    .recycle = iree_hal_buffer_recycle,
+    .destroy = iree_hal_webgpu_buffer_destroy,
+    .map_range = iree_hal_webgpu_buffer_map_range,
+    .unmap_range = iree_hal_webgpu_buffer_unmap_range,
+    .invalidate_range = iree_hal_webgpu_buffer_invalidate_range,
+    .flush_range = iree_hal_webgpu_buffer_flush_range,
+};
@@ -0,0 +1,58 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_WEBGPU_BUFFER_H_
+#define IREE_HAL_WEBGPU_WEBGPU_BUFFER_H_
+
+#include "experimental/webgpu/webgpu_headers.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Alignment in bytes of WGPUBuffer sizes and of the offsets and lengths of
+// copies, writes, and mappings.
+#define IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT 4
+
+// Wraps a WGPUBuffer |handle| in an iree_hal_buffer_t.
+// |handle| must have been created with a size of |allocation_size| rounded up
+// to IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT as WebGPU requires.
+// Ownership of |handle| transfers to the buffer and it is destroyed when the
+// buffer is. If |mapped_at_creation| the buffer was created with
+// mappedAtCreation and is host accessible until first unmapped.
+iree_status_t iree_hal_webgpu_buffer_wrap(
+    iree_hal_allocator_t* allocator, iree_allocator_t host_allocator,
+    iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    WGPUBuffer handle, bool mapped_at_creation, iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a WebGPU buffer.
+bool iree_hal_webgpu_buffer_isa(iree_hal_buffer_t* buffer);
+
+// Returns true if |buffer| is currently mapped for host access.
+bool iree_hal_webgpu_buffer_is_mapped(iree_hal_buffer_t* buffer);
+
+// Returns the host pointer to the start of the mapped allocation of |buffer|
+// or NULL if it is not mapped.
+uint8_t* iree_hal_webgpu_buffer_mapped_ptr(iree_hal_buffer_t* buffer);
+
+// Writes |data| to |buffer| at |offset| with wgpuQueueWriteBuffer.
+// WebGPU requires 4-byte aligned offsets and lengths; unaligned lengths are
+// only allowed when the write extends to the end of the buffer as the padding
+// then lands in the rounding slack of the allocation.
+iree_status_t iree_hal_webgpu_buffer_queue_write(WGPUQueue queue,
+                                                 iree_hal_buffer_t* buffer,
+                                                 iree_device_size_t offset,
+                                                 iree_const_byte_span_t data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_WEBGPU_BUFFER_H_
@@ -0,0 +1,846 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/webgpu_device.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "experimental/webgpu/command_buffer.h"
+#include "experimental/webgpu/nop_executable_cache.h"
+#include "experimental/webgpu/pipeline_layout.h"
+#include "experimental/webgpu/webgpu_allocator.h"
+#include "experimental/webgpu/webgpu_buffer.h"
+#include "experimental/webgpu/webgpu_semaphore.h"
+#include "iree/base/internal/arena.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_webgpu_device_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_webgpu_device_t iree_hal_webgpu_device_t;
+
+// Resources kept live until the work of a queue operation completes.
+// Completion is reported by wgpuQueueOnSubmittedWorkDone and handled on the
+// device loop.
+typedef struct iree_hal_webgpu_device_submission_t {
+  // Retained device; submissions may outlive the user's device reference.
+  iree_hal_webgpu_device_t* device;
+  // Status reported by WebGPU when the work completed.
+  iree_status_t status;
+  // Retained command buffers referenced by the submitted work.
+  iree_host_size_t command_buffer_count;
+  iree_hal_command_buffer_t** command_buffers;
+  // Retained semaphores signaled when the work completes.
+  iree_hal_semaphore_list_t signal_semaphore_list;
+} iree_hal_webgpu_device_submission_t;
+
+struct iree_hal_webgpu_device_t {
+  iree_hal_resource_t resource;
+  iree_string_view_t identifier;
+  iree_allocator_t host_allocator;
+
+  // Block pool used for command buffers with a larger block size (as command
+  // buffers can contain inlined data uploads).
+  iree_arena_block_pool_t block_pool;
+
+  // Optional driver that created the device. We retain it for our lifetime to
+  // ensure the WebGPU instance remains valid.
+  iree_hal_driver_t* driver;
+
+  // Parameters used to control device behavior.
+  iree_hal_webgpu_device_params_t params;
+
+  WGPUDevice handle;
+  WGPUQueue queue;
+  iree_hal_allocator_t* device_allocator;
+
+  // Layout of bind groups with no entries used to fill gaps in pipeline
+  // layouts between descriptor sets and the params bind group.
+  WGPUBindGroupLayout empty_bind_group_layout;
+  WGPUBindGroup empty_bind_group;
+  // Layout of the params (emulated push constant) bind group.
+  WGPUBindGroupLayout params_bind_group_layout;
+};
+
+static const iree_hal_device_vtable_t iree_hal_webgpu_device_vtable;
+
+static iree_hal_webgpu_device_t* iree_hal_webgpu_device_cast(
+    iree_hal_device_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_device_vtable);
+  return (iree_hal_webgpu_device_t*)base_value;
+}
+
+IREE_API_EXPORT void iree_hal_webgpu_device_params_initialize(
+    iree_hal_webgpu_device_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->arena_block_size = 32 * 1024;
+  out_params->params_buffer_size = 16 * 1024;
+  out_params->loop = iree_loop_inline(NULL);
+}
+
+static iree_status_t iree_hal_webgpu_device_check_params(
+    const iree_hal_webgpu_device_params_t* params) {
+  if (params->arena_block_size < 4096) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "arena block size too small (< 4096 bytes)");
+  }
+  if (params->params_buffer_size < IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "params buffer size too small (< %d bytes)",
+                            IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE);
+  }
+  if (!params->loop.ctl) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "a loop is required to deliver completions");
+  }
+  return iree_ok_status();
+}
+
+// Creates the bind group layouts and bind group shared by all pipeline layouts
+// and command buffers of the device.
+static iree_status_t iree_hal_webgpu_device_create_shared_bind_groups(
+    iree_hal_webgpu_device_t* device) {
+  const WGPUBindGroupLayoutDescriptor empty_layout_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .entryCount = 0,
+      .entries = NULL,
+  };
+  device->empty_bind_group_layout = wgpuDeviceCreateBindGroupLayout(
+      device->handle, &empty_layout_descriptor);
+  if (!device->empty_bind_group_layout) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateBindGroupLayout failed");
+  }
+  const WGPUBindGroupDescriptor empty_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .layout = device->empty_bind_group_layout,
+      .entryCount = 0,
+      .entries = NULL,
+  };
+  device->empty_bind_group =
+      wgpuDeviceCreateBindGroup(device->handle, &empty_descriptor);
+  if (!device->empty_bind_group) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateBindGroup failed");
+  }
+
+  // Each dispatch selects its slot in the params buffer with a dynamic offset
+  // so that a single bind group can be shared by many dispatches.
+  const WGPUBindGroupLayoutEntry params_entry = {
+      .nextInChain = NULL,
+      .binding = IREE_HAL_WEBGPU_PARAMS_BINDING_INDEX,
+      .visibility = WGPUShaderStage_Compute,
+      .buffer =
+          {
+              .nextInChain = NULL,
+              .type = WGPUBufferBindingType_Uniform,
+              .hasDynamicOffset = true,
+              .minBindingSize = IREE_HAL_WEBGPU_PARAMS_SLOT_SIZE,
+          },
+  };
+  const WGPUBindGroupLayoutDescriptor params_layout_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+      .entryCount = 1,
+      .entries = &params_entry,
+  };
+  device->params_bind_group_layout = wgpuDeviceCreateBindGroupLayout(
+      device->handle, &params_layout_descriptor);
+  if (!device->params_bind_group_layout) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateBindGroupLayout failed");
+  }
+  return iree_ok_status();
+}
+
+static void iree_hal_webgpu_device_destroy(iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Submissions retain the device so there is no in-flight work referencing
+  // it by the time this is called.
+
+  // There should be no more buffers live that use the allocator.
+  iree_hal_allocator_release(device->device_allocator);
+
+  if (device->params_bind_group_layout) {
+    wgpuBindGroupLayoutRelease(device->params_bind_group_layout);
+  }
+  if (device->empty_bind_group) {
+    wgpuBindGroupRelease(device->empty_bind_group);
+  }
+  if (device->empty_bind_group_layout) {
+    wgpuBindGroupLayoutRelease(device->empty_bind_group_layout);
+  }
+  if (device->queue) wgpuQueueRelease(device->queue);
+  wgpuDeviceRelease(device->handle);
+
+  iree_arena_block_pool_deinitialize(&device->block_pool);
+
+  // Finally, destroy the device.
+  iree_hal_driver_release(device->driver);
+
+  iree_allocator_free(host_allocator, device);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_webgpu_device_create(
+    iree_hal_driver_t* driver, iree_string_view_t identifier,
+    const iree_hal_webgpu_device_params_t* params, WGPUDevice handle,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_device);
+  *out_device = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_webgpu_device_check_params(params));
+
+  iree_hal_webgpu_device_t* device = NULL;
+  iree_host_size_t total_size = iree_sizeof_struct(*device) + identifier.size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&device));
+  memset(device, 0, total_size);
+  iree_hal_resource_initialize(&iree_hal_webgpu_device_vtable,
+                               &device->resource);
+  device->host_allocator = host_allocator;
+  device->driver = driver;
+  iree_hal_driver_retain(device->driver);
+  iree_string_view_append_to_buffer(
+      identifier, &device->identifier,
+      (char*)device + iree_sizeof_struct(*device));
+  device->params = *params;
+  device->handle = handle;
+  wgpuDeviceReference(device->handle);
+  device->queue = wgpuDeviceGetQueue(device->handle);
+  iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
+                                   &device->block_pool);
+
+  iree_status_t status =
+      iree_hal_webgpu_device_create_shared_bind_groups(device);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_webgpu_allocator_create(device->handle, device->queue,
+                                              host_allocator,
+                                              &device->device_allocator);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_device = (iree_hal_device_t*)device;
+  } else {
+    iree_hal_device_release((iree_hal_device_t*)device);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_wrap_device(
+    iree_string_view_t identifier,
+    const iree_hal_webgpu_device_params_t* params, WGPUDevice handle,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+  return iree_hal_webgpu_device_create(/*driver=*/NULL, identifier, params,
+                                       handle, host_allocator, out_device);
+}
+
+IREE_API_EXPORT WGPUDevice
+iree_hal_webgpu_device_handle(iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return device->handle;
+}
+
+static iree_string_view_t iree_hal_webgpu_device_id(
+    iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return device->identifier;
+}
+
+static iree_allocator_t iree_hal_webgpu_device_host_allocator(
+    iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return device->host_allocator;
+}
+
+static iree_hal_allocator_t* iree_hal_webgpu_device_allocator(
+    iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return device->device_allocator;
+}
+
+static void iree_hal_webgpu_replace_device_allocator(
+    iree_hal_device_t* base_device, iree_hal_allocator_t* new_allocator) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  iree_hal_allocator_retain(new_allocator);
+  iree_hal_allocator_release(device->device_allocator);
+  device->device_allocator = new_allocator;
+}
+
+static iree_status_t iree_hal_webgpu_device_query_i64(
+    iree_hal_device_t* base_device, iree_string_view_t category,
+    iree_string_view_t key, int64_t* out_value) {
+  *out_value = 0;
+
+  if (iree_string_view_equal(category,
+                             iree_make_cstring_view("hal.executable.format"))) {
+    *out_value =
+        iree_string_view_equal(key, iree_make_cstring_view("webgpu-wgsl-fb"))
+            ? 1
+            : 0;
+    return iree_ok_status();
+  }
+
+  return iree_make_status(
+      IREE_STATUS_NOT_FOUND,
+      "unknown device configuration key value '%.*s :: %.*s'",
+      (int)category.size, category.data, (int)key.size, key.data);
+}
+
+static iree_status_t iree_hal_webgpu_device_trim(
+    iree_hal_device_t* base_device) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  iree_arena_block_pool_trim(&device->block_pool);
+  return iree_hal_allocator_trim(device->device_allocator);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_channel(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "collectives not implemented");
+}
+
+// Creates a one-shot command buffer recording directly to WebGPU.
+static iree_status_t iree_hal_webgpu_device_create_direct_command_buffer(
+    iree_hal_webgpu_device_t* device, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  const iree_hal_webgpu_command_buffer_params_t params = {
+      .params_bind_group_layout = device->params_bind_group_layout,
+      .empty_bind_group = device->empty_bind_group,
+      .params_buffer_size = device->params.params_buffer_size,
+  };
+  return iree_hal_webgpu_command_buffer_create(
+      (iree_hal_device_t*)device, device->handle, &params, mode,
+      command_categories, queue_affinity, /*binding_capacity=*/0,
+      &device->block_pool, device->host_allocator, out_command_buffer);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_command_buffer(
+    iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) &&
+      binding_capacity == 0) {
+    return iree_hal_webgpu_device_create_direct_command_buffer(
+        device, mode, command_categories, queue_affinity, out_command_buffer);
+  }
+  // WebGPU command buffers can only be submitted once: reusable command
+  // buffers are recorded and replayed into a new one on each submission.
+  return iree_hal_deferred_command_buffer_create(
+      base_device, mode, command_categories, binding_capacity,
+      &device->block_pool, device->host_allocator, out_command_buffer);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_descriptor_set_layout(
+    iree_hal_device_t* base_device,
+    iree_hal_descriptor_set_layout_flags_t flags,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_layout_binding_t* bindings,
+    iree_hal_descriptor_set_layout_t** out_descriptor_set_layout) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return iree_hal_webgpu_descriptor_set_layout_create(
+      device->handle, flags, binding_count, bindings, device->host_allocator,
+      out_descriptor_set_layout);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_event(
+    iree_hal_device_t* base_device, iree_hal_event_t** out_event) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "events not supported on WebGPU");
+}
+
+static iree_status_t iree_hal_webgpu_device_create_executable_cache(
+    iree_hal_device_t* base_device, iree_string_view_t identifier,
+    iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return iree_hal_webgpu_nop_executable_cache_create(
+      device->handle, identifier, device->host_allocator,
+      out_executable_cache);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_pipeline_layout(
+    iree_hal_device_t* base_device, iree_host_size_t push_constants,
+    iree_host_size_t set_layout_count,
+    iree_hal_descriptor_set_layout_t* const* set_layouts,
+    iree_hal_pipeline_layout_t** out_pipeline_layout) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return iree_hal_webgpu_pipeline_layout_create(
+      device->handle, set_layout_count, set_layouts, push_constants,
+      device->empty_bind_group_layout, device->params_bind_group_layout,
+      device->host_allocator, out_pipeline_layout);
+}
+
+static iree_status_t iree_hal_webgpu_device_create_semaphore(
+    iree_hal_device_t* base_device, uint64_t initial_value,
+    iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  return iree_hal_webgpu_semaphore_create(
+      initial_value, device->host_allocator, out_semaphore);
+}
+
+static iree_hal_semaphore_compatibility_t
+iree_hal_webgpu_device_query_semaphore_compatibility(
+    iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
+  // WebGPU semaphores signaled by prior submissions can be waited on by the
+  // queue as it executes in order. Other semaphores must be signaled on the
+  // host prior to issuing work.
+  if (iree_hal_webgpu_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
+  }
+  return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
+}
+
+// Allocates a submission able to retain up to |command_buffer_capacity|
+// command buffers and the semaphores in |signal_semaphore_list|.
+static iree_status_t iree_hal_webgpu_device_submission_allocate(
+    iree_hal_webgpu_device_t* device, iree_host_size_t command_buffer_capacity,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_webgpu_device_submission_t** out_submission) {
+  *out_submission = NULL;
+  iree_hal_webgpu_device_submission_t* submission = NULL;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*submission) +
+      command_buffer_capacity * sizeof(*submission->command_buffers) +
+      signal_semaphore_list.count *
+          (sizeof(*signal_semaphore_list.semaphores) +
+           sizeof(*signal_semaphore_list.payload_values));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->host_allocator, total_size, (void**)&submission));
+  memset(submission, 0, total_size);
+  submission->device = device;
+  iree_hal_device_retain((iree_hal_device_t*)device);
+  submission->status = iree_ok_status();
+  uint8_t* ptr = (uint8_t*)submission + iree_sizeof_struct(*submission);
+  submission->command_buffers = (iree_hal_command_buffer_t**)ptr;
+  ptr += command_buffer_capacity * sizeof(*submission->command_buffers);
+  submission->signal_semaphore_list.count = signal_semaphore_list.count;
+  submission->signal_semaphore_list.semaphores = (iree_hal_semaphore_t**)ptr;
+  ptr +=
+      signal_semaphore_list.count * sizeof(*signal_semaphore_list.semaphores);
+  submission->signal_semaphore_list.payload_values = (uint64_t*)ptr;
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    submission->signal_semaphore_list.semaphores[i] =
+        signal_semaphore_list.semaphores[i];
+    iree_hal_semaphore_retain(signal_semaphore_list.semaphores[i]);
+    submission->signal_semaphore_list.payload_values[i] =
+        signal_semaphore_list.payload_values[i];
+  }
+  *out_submission = submission;
+  return iree_ok_status();
+}
+
+static void iree_hal_webgpu_device_submission_release(
+    iree_hal_webgpu_device_submission_t* submission) {
+  iree_hal_webgpu_device_t* device = submission->device;
+  for (iree_host_size_t i = 0; i < submission->command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(submission->command_buffers[i]);
+  }
+  for (iree_host_size_t i = 0; i < submission->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_release(submission->signal_semaphore_list.semaphores[i]);
+  }
+  iree_status_ignore(submission->status);
+  iree_allocator_free(device->host_allocator, submission);
+  iree_hal_device_release((iree_hal_device_t*)device);
+}
+
+// Returns an error if work issued to the queue now would not be ordered after
+// |wait_semaphore_list| is satisfied. The browser cannot block and the WebGPU
+// queue cannot wait on the host so waits must either already be satisfied or
+// be signaled by work previously submitted to the in-order queue.
+static iree_status_t iree_hal_webgpu_device_queue_wait(
+    iree_hal_webgpu_device_t* device,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+    uint64_t value = wait_semaphore_list.payload_values[i];
+    if (iree_hal_webgpu_semaphore_isa(semaphore) &&
+        iree_hal_webgpu_semaphore_is_reserved(semaphore, value)) {
+      continue;
+    }
+    uint64_t current_value = 0;
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_query(semaphore, &current_value));
+    if (current_value < value) {
+      return iree_make_status(
+          IREE_STATUS_UNIMPLEMENTED,
+          "queue waits are only supported on semaphores that have been "
+          "signaled or will be signaled by prior submissions; semaphore is "
+          "at %" PRIu64 " and waiting for %" PRIu64,
+          current_value, value);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Issued from the device loop once WebGPU reports the submitted work done.
+static iree_status_t iree_hal_webgpu_device_complete_submission(
+    void* user_data, iree_loop_t loop, iree_status_t loop_status) {
+  iree_hal_webgpu_device_submission_t* submission =
+      (iree_hal_webgpu_device_submission_t*)user_data;
+  iree_status_t status = iree_status_join(submission->status, loop_status);
+  submission->status = iree_ok_status();
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    if (iree_status_is_ok(status)) {
+      iree_status_t signal_status =
+          iree_hal_semaphore_signal(list->semaphores[i],
+                                    list->payload_values[i]);
+      if (!iree_status_is_ok(signal_status)) {
+        iree_hal_semaphore_fail(list->semaphores[i], signal_status);
+      }
+    } else {
+      iree_hal_semaphore_fail(list->semaphores[i], iree_status_clone(status));
+    }
+  }
+  iree_status_ignore(status);
+  iree_hal_webgpu_device_submission_release(submission);
+  return iree_ok_status();
+}
+
+// Called by WebGPU once all work submitted to the queue prior to a submission
+// has completed. Completion is deferred to the device loop so that semaphore
+// callbacks run in the context the user expects them to.
+static void iree_hal_webgpu_device_submitted_work_done(
+    WGPUQueueWorkDoneStatus work_done_status, void* user_data) {
+  iree_hal_webgpu_device_submission_t* submission =
+      (iree_hal_webgpu_device_submission_t*)user_data;
+  if (work_done_status != WGPUQueueWorkDoneStatus_Success) {
+    submission->status =
+        iree_make_status(IREE_STATUS_INTERNAL,
+                         "WebGPU queue work failed with status %d",
+                         (int)work_done_status);
+  }
+  iree_status_t status = iree_loop_call(
+      submission->device->params.loop, IREE_LOOP_PRIORITY_DEFAULT,
+      iree_hal_webgpu_device_complete_submission, submission);
+  if (!iree_status_is_ok(status)) {
+    // Unable to enqueue; complete inline with the failure.
+    iree_status_ignore(iree_hal_webgpu_device_complete_submission(
+        submission, submission->device->params.loop, status));
+  }
+}
+
+// Signals the semaphores of |submission| and releases its resources once the
+// work submitted to the queue so far completes. Takes ownership of
+// |submission|.
+static void iree_hal_webgpu_device_queue_signal(
+    iree_hal_webgpu_device_t* device,
+    iree_hal_webgpu_device_submission_t* submission) {
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    if (iree_hal_webgpu_semaphore_isa(list->semaphores[i])) {
+      iree_hal_webgpu_semaphore_reserve(list->semaphores[i],
+                                        list->payload_values[i]);
+    }
+  }
+  wgpuQueueOnSubmittedWorkDone(device->queue,
+                               iree_hal_webgpu_device_submitted_work_done,
+                               submission);
+}
+
+static iree_status_t iree_hal_webgpu_device_queue_alloca(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+
+  // WebGPU has no queue-ordered allocations; the buffer is allocated
+  // synchronously and the signal is ordered after prior work on the queue.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_device_queue_wait(device, wait_semaphore_list));
+  iree_hal_webgpu_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(base_device), params, allocation_size,
+      iree_const_byte_span_empty(), out_buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_webgpu_device_queue_signal(device, submission);
+  } else {
+    iree_hal_webgpu_device_submission_release(submission);
+  }
+  return status;
+}
+
+static iree_status_t iree_hal_webgpu_device_queue_dealloca(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+
+  // Buffers are freed when they are released; browsers keep the underlying
+  // memory live until all work using it has completed.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_device_queue_wait(device, wait_semaphore_list));
+  iree_hal_webgpu_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_hal_webgpu_device_queue_signal(device, submission);
+  return iree_ok_status();
+}
+
+// Prepares |command_buffer| for submission and retains any command buffers it
+// requires in |submission|. Returns the WGPUCommandBuffer to submit.
+static iree_status_t iree_hal_webgpu_device_prepare_command_buffer(
+    iree_hal_webgpu_device_t* device, iree_hal_command_buffer_t* command_buffer,
+    iree_hal_webgpu_device_submission_t* submission,
+    WGPUCommandBuffer* out_handle) {
+  if (iree_hal_webgpu_command_buffer_isa(command_buffer)) {
+    iree_hal_command_buffer_retain(command_buffer);
+    submission->command_buffers[submission->command_buffer_count++] =
+        command_buffer;
+    *out_handle = iree_hal_webgpu_command_buffer_handle(command_buffer);
+    return iree_ok_status();
+  }
+
+  // Deferred command buffers are replayed into a new one-shot command buffer
+  // that is kept live with the submission.
+  iree_hal_command_buffer_t* direct_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_device_create_direct_command_buffer(
+      device,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &direct_command_buffer));
+  submission->command_buffers[submission->command_buffer_count++] =
+      direct_command_buffer;
+  IREE_RETURN_IF_ERROR(iree_hal_deferred_command_buffer_apply(
+      command_buffer, direct_command_buffer,
+      iree_hal_buffer_binding_table_empty()));
+  *out_handle = iree_hal_webgpu_command_buffer_handle(direct_command_buffer);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_device_queue_execute(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_webgpu_device_queue_wait(device, wait_semaphore_list));
+  iree_hal_webgpu_device_submission_t* submission = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_webgpu_device_submission_allocate(
+              device, command_buffer_count, signal_semaphore_list,
+              &submission));
+
+  WGPUCommandBuffer* handles =
+      (WGPUCommandBuffer*)iree_alloca(command_buffer_count * sizeof(*handles));
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < command_buffer_count; i++) {
+    status = iree_hal_webgpu_device_prepare_command_buffer(
+        device, command_buffers[i], submission, &handles[i]);
+  }
+
+  // The submission completes asynchronously; semaphores are signaled and
+  // resources released from the device loop once the queue reaches this point.
+  if (iree_status_is_ok(status)) {
+    if (command_buffer_count > 0) {
+      wgpuQueueSubmit(device->queue, (uint32_t)command_buffer_count, handles);
+    }
+    iree_hal_webgpu_device_queue_signal(device, submission);
+  } else {
+    iree_hal_webgpu_device_submission_release(submission);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_webgpu_device_queue_flush(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity) {
+  // Currently unused; we flush as submissions are made.
+  return iree_ok_status();
+}
+
+// Copies between host memory and buffers with wgpuQueueWriteBuffer or mapped
+// memory, or between buffers with a one-off command encoder. Reading back from
+// buffers that are not mapped is impossible without yielding to the browser
+// event loop: those must be mapped with iree_hal_webgpu_buffer_map_async.
+static iree_status_t iree_hal_webgpu_device_transfer_range(
+    iree_hal_device_t* base_device, iree_hal_transfer_buffer_t source,
+    iree_device_size_t source_offset, iree_hal_transfer_buffer_t target,
+    iree_device_size_t target_offset, iree_device_size_t data_length,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  if (data_length == 0) return iree_ok_status();
+
+  if (!source.device_buffer && target.device_buffer) {
+    // Host -> device.
+    const uint8_t* source_ptr = source.host_buffer.data + source_offset;
+    if (iree_hal_webgpu_buffer_is_mapped(target.device_buffer)) {
+      memcpy(iree_hal_webgpu_buffer_mapped_ptr(target.device_buffer) +
+                 iree_hal_buffer_byte_offset(target.device_buffer) +
+                 target_offset,
+             source_ptr, data_length);
+      return iree_ok_status();
+    }
+    return iree_hal_webgpu_buffer_queue_write(
+        device->queue, target.device_buffer, target_offset,
+        iree_make_const_byte_span(source_ptr, data_length));
+  } else if (source.device_buffer && !target.device_buffer) {
+    // Device -> host.
+    if (!iree_hal_webgpu_buffer_is_mapped(source.device_buffer)) {
+      return iree_make_status(
+          IREE_STATUS_FAILED_PRECONDITION,
+          "WebGPU buffers can only be read on the host while mapped; use "
+          "iree_hal_webgpu_buffer_map_async to asynchronously map the buffer");
+    }
+    memcpy(target.host_buffer.data + target_offset,
+           iree_hal_webgpu_buffer_mapped_ptr(source.device_buffer) +
+               iree_hal_buffer_byte_offset(source.device_buffer) +
+               source_offset,
+           data_length);
+    return iree_ok_status();
+  } else if (!source.device_buffer || !target.device_buffer) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "host to host transfers are not supported");
+  }
+
+  // Device -> device.
+  source_offset += iree_hal_buffer_byte_offset(source.device_buffer);
+  target_offset += iree_hal_buffer_byte_offset(target.device_buffer);
+  if (!iree_device_size_has_alignment(source_offset,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT) ||
+      !iree_device_size_has_alignment(target_offset,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT) ||
+      !iree_device_size_has_alignment(data_length,
+                                      IREE_HAL_WEBGPU_BUFFER_SIZE_ALIGNMENT)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "WebGPU buffer copies must be 4-byte aligned");
+  }
+  const WGPUCommandEncoderDescriptor encoder_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(device->handle, &encoder_descriptor);
+  if (!encoder) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuDeviceCreateCommandEncoder failed");
+  }
+  wgpuCommandEncoderCopyBufferToBuffer(
+      encoder, iree_hal_webgpu_buffer_handle(source.device_buffer),
+      source_offset, iree_hal_webgpu_buffer_handle(target.device_buffer),
+      target_offset, data_length);
+  const WGPUCommandBufferDescriptor command_buffer_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  WGPUCommandBuffer command_buffer =
+      wgpuCommandEncoderFinish(encoder, &command_buffer_descriptor);
+  wgpuCommandEncoderRelease(encoder);
+  if (!command_buffer) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "wgpuCommandEncoderFinish failed");
+  }
+  wgpuQueueSubmit(device->queue, 1, &command_buffer);
+  wgpuCommandBufferRelease(command_buffer);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_device_wait_semaphores(
+    iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
+  if (wait_mode == IREE_HAL_WAIT_MODE_ALL || semaphore_list.count == 1) {
+    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+      IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait(
+          semaphore_list.semaphores[i], semaphore_list.payload_values[i],
+          timeout));
+    }
+    return iree_ok_status();
+  }
+
+  // Wait-any: succeed if any semaphore has already been signaled.
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    iree_status_t status = iree_hal_semaphore_wait(
+        semaphore_list.semaphores[i], semaphore_list.payload_values[i],
+        iree_immediate_timeout());
+    if (!iree_status_is_deadline_exceeded(status)) return status;
+    iree_status_ignore(status);
+  }
+  if (iree_timeout_is_immediate(timeout)) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "blocking waits are not supported on WebGPU; waits "
+                          "must be performed asynchronously by yielding to "
+                          "the loop");
+}
+
+static iree_status_t iree_hal_webgpu_device_profiling_begin(
+    iree_hal_device_t* base_device,
+    const iree_hal_device_profiling_options_t* options) {
+  // Unimplemented (and that's ok).
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_device_profiling_end(
+    iree_hal_device_t* base_device) {
+  // Unimplemented (and that's ok).
+  return iree_ok_status();
+}
+
+static const iree_hal_device_vtable_t iree_hal_webgpu_device_vtable = {
+    .destroy = iree_hal_webgpu_device_destroy,
+    .id = iree_hal_webgpu_device_id,
+    .host_allocator = iree_hal_webgpu_device_host_allocator,
+    .device_allocator = iree_hal_webgpu_device_allocator,
+    .replace_device_allocator = iree_hal_webgpu_replace_device_allocator,
+    .trim = iree_hal_webgpu_device_trim,
+    .query_i64 = iree_hal_webgpu_device_query_i64,
+    .create_channel = iree_hal_webgpu_device_create_channel,
+    .create_command_buffer = iree_hal_webgpu_device_create_command_buffer,
+    .create_descriptor_set_layout =
+        iree_hal_webgpu_device_create_descriptor_set_layout,
+    .create_event = iree_hal_webgpu_device_create_event,
+    .create_executable_cache = iree_hal_webgpu_device_create_executable_cache,
+    .create_pipeline_layout = iree_hal_webgpu_device_create_pipeline_layout,
+    .create_semaphore = iree_hal_webgpu_device_create_semaphore,
+    .query_semaphore_compatibility =
+        iree_hal_webgpu_device_query_semaphore_compatibility,
+    .transfer_range = iree_hal_webgpu_device_transfer_range,
+    .queue_alloca = iree_hal_webgpu_device_queue_alloca,
+    .queue_dealloca = iree_hal_webgpu_device_queue_dealloca,
+    .queue_read = iree_hal_device_queue_read_streaming,
+    .queue_execute = iree_hal_webgpu_device_queue_execute,
+    .queue_flush = iree_hal_webgpu_device_queue_flush,
+    .wait_semaphores = iree_hal_webgpu_device_wait_semaphores,
+    .profiling_begin = iree_hal_webgpu_device_profiling_begin,
+    .profiling_end = iree_hal_webgpu_device_profiling_end,
+};
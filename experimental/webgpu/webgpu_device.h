@@ -0,0 +1,28 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_WEBGPU_DEVICE_H_
+#define IREE_HAL_WEBGPU_WEBGPU_DEVICE_H_
+
+#include "experimental/webgpu/api.h"
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a device wrapping |handle| and retaining the optional |driver|.
+iree_status_t iree_hal_webgpu_device_create(
+    iree_hal_driver_t* driver, iree_string_view_t identifier,
+    const iree_hal_webgpu_device_params_t* params, WGPUDevice handle,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_WEBGPU_DEVICE_H_
@@ -0,0 +1,197 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "experimental/webgpu/api.h"
+#include "experimental/webgpu/webgpu_device.h"
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/api.h"
+
+IREE_API_EXPORT void iree_hal_webgpu_driver_options_initialize(
+    iree_hal_webgpu_driver_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  iree_hal_webgpu_device_params_initialize(&out_options->default_params);
+}
+
+#if defined(IREE_PLATFORM_EMSCRIPTEN)
+
+#include <emscripten/html5_webgpu.h>
+
+#include "iree/base/loop_emscripten.h"
+
+// The only device exposed by the driver: the one preinitialized by JavaScript.
+#define IREE_HAL_WEBGPU_DEVICE_ID_PREINITIALIZED 1
+
+typedef struct iree_hal_webgpu_driver_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  // Identifier used for the driver in the IREE driver registry.
+  iree_string_view_t identifier;
+  // Parameters used to control device behavior.
+  iree_hal_webgpu_device_params_t device_params;
+  // Browser event loop devices deliver completions on.
+  iree_loop_emscripten_t* loop;
+} iree_hal_webgpu_driver_t;
+
+static const iree_hal_driver_vtable_t iree_hal_webgpu_driver_vtable;
+
+static iree_hal_webgpu_driver_t* iree_hal_webgpu_driver_cast(
+    iree_hal_driver_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_driver_vtable);
+  return (iree_hal_webgpu_driver_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_driver_create(
+    iree_string_view_t identifier,
+    const iree_hal_webgpu_driver_options_t* options,
+    iree_allocator_t host_allocator, iree_hal_driver_t** out_driver) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_driver);
+  *out_driver = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_driver_t* driver = NULL;
+  iree_host_size_t total_size = sizeof(*driver) + identifier.size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&driver));
+  memset(driver, 0, total_size);
+  iree_hal_resource_initialize(&iree_hal_webgpu_driver_vtable,
+                               &driver->resource);
+  driver->host_allocator = host_allocator;
+  iree_string_view_append_to_buffer(
+      identifier, &driver->identifier,
+      (char*)driver + total_size - identifier.size);
+  driver->device_params = options->default_params;
+
+  iree_status_t status =
+      iree_loop_emscripten_allocate(host_allocator, &driver->loop);
+  if (iree_status_is_ok(status)) {
+    driver->device_params.loop = iree_loop_emscripten(driver->loop);
+    *out_driver = (iree_hal_driver_t*)driver;
+  } else {
+    iree_hal_driver_release((iree_hal_driver_t*)driver);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_driver_destroy(iree_hal_driver_t* base_driver) {
+  iree_hal_webgpu_driver_t* driver = iree_hal_webgpu_driver_cast(base_driver);
+  iree_allocator_t host_allocator = driver->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (driver->loop) iree_loop_emscripten_free(driver->loop);
+  iree_allocator_free(host_allocator, driver);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_webgpu_driver_query_available_devices(
+    iree_hal_driver_t* base_driver, iree_allocator_t host_allocator,
+    iree_host_size_t* out_device_info_count,
+    iree_hal_device_info_t** out_device_infos) {
+  // Adapters and devices can only be requested asynchronously from JavaScript;
+  // we expose the one preinitialized device if present.
+  *out_device_info_count = 0;
+  *out_device_infos = NULL;
+  WGPUDevice handle = emscripten_webgpu_get_device();
+  if (!handle) return iree_ok_status();
+  wgpuDeviceRelease(handle);
+
+  static const iree_hal_device_info_t device_info = {
+      .device_id = IREE_HAL_WEBGPU_DEVICE_ID_PREINITIALIZED,
+      .path = IREE_SVL(""),
+      .name = IREE_SVL("default"),
+  };
+  iree_hal_device_info_t* device_infos = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*device_infos), (void**)&device_infos));
+  *device_infos = device_info;
+  *out_device_info_count = 1;
+  *out_device_infos = device_infos;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_driver_dump_device_info(
+    iree_hal_driver_t* base_driver, iree_hal_device_id_t device_id,
+    iree_string_builder_t* builder) {
+  // TODO: dump adapter info once exposed by the browser.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_webgpu_driver_create_device_by_id(
+    iree_hal_driver_t* base_driver, iree_hal_device_id_t device_id,
+    iree_host_size_t param_count, const iree_string_pair_t* params,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+  iree_hal_webgpu_driver_t* driver = iree_hal_webgpu_driver_cast(base_driver);
+  if (device_id != IREE_HAL_DEVICE_ID_DEFAULT &&
+      device_id != IREE_HAL_WEBGPU_DEVICE_ID_PREINITIALIZED) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "WebGPU device %" PRIu64 " not found",
+                            (uint64_t)device_id);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Returns a new reference to Module.preinitializedWebGPUDevice.
+  WGPUDevice handle = emscripten_webgpu_get_device();
+  if (!handle) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no WebGPU device has been preinitialized; set "
+        "Module.preinitializedWebGPUDevice from JavaScript");
+  }
+
+  iree_status_t status = iree_hal_webgpu_device_create(
+      base_driver, driver->identifier, &driver->device_params, handle,
+      host_allocator, out_device);
+  wgpuDeviceRelease(handle);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_webgpu_driver_create_device_by_path(
+    iree_hal_driver_t* base_driver, iree_string_view_t driver_name,
+    iree_string_view_t device_path, iree_host_size_t param_count,
+    const iree_string_pair_t* params, iree_allocator_t host_allocator,
+    iree_hal_device_t** out_device) {
+  if (!iree_string_view_is_empty(device_path)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "device paths not yet implemented");
+  }
+  return iree_hal_webgpu_driver_create_device_by_id(
+      base_driver, IREE_HAL_DEVICE_ID_DEFAULT, param_count, params,
+      host_allocator, out_device);
+}
+
+static const iree_hal_driver_vtable_t iree_hal_webgpu_driver_vtable = {
+    .destroy = iree_hal_webgpu_driver_destroy,
+    .query_available_devices = iree_hal_webgpu_driver_query_available_devices,
+    .dump_device_info = iree_hal_webgpu_driver_dump_device_info,
+    .create_device_by_id = iree_hal_webgpu_driver_create_device_by_id,
+    .create_device_by_path = iree_hal_webgpu_driver_create_device_by_path,
+};
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_hal_webgpu_driver_create(
+    iree_string_view_t identifier,
+    const iree_hal_webgpu_driver_options_t* options,
+    iree_allocator_t host_allocator, iree_hal_driver_t** out_driver) {
+  IREE_ASSERT_ARGUMENT(out_driver);
+  *out_driver = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "the WebGPU driver is only available on the web; "
+                          "use iree_hal_webgpu_wrap_device with native "
+                          "WebGPU implementations");
+}
+
+#endif  // IREE_PLATFORM_EMSCRIPTEN
@@ -0,0 +1,15 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_WEBGPU_HEADERS_H_
+#define IREE_HAL_WEBGPU_WEBGPU_HEADERS_H_
+
+// The webgpu.h C API provided by Emscripten when linking with -sUSE_WEBGPU=1.
+// Native implementations of the same header (such as Dawn) may also be used
+// but only the browser event loop is supported for completion callbacks.
+#include <webgpu/webgpu.h>  // IWYU pragma: export
+
+#endif  // IREE_HAL_WEBGPU_WEBGPU_HEADERS_H_
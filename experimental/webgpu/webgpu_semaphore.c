@@ -0,0 +1,231 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/webgpu/webgpu_semaphore.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/utils/semaphore_base.h"
+
+// Sentinel used the semaphore has failed and an error status is set.
+#define IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE UINT64_MAX
+
+typedef struct iree_hal_webgpu_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+
+  // Guards all mutable fields. Completion callbacks are issued from the
+  // browser event loop but the semaphore may be queried from workers.
+  iree_slim_mutex_t mutex;
+
+  // Current signaled value. May be IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE to
+  // indicate that the semaphore has been signaled for failure and
+  // |failure_status| contains the error.
+  uint64_t current_value;
+
+  // Maximum value queued work will signal the semaphore to. Always greater
+  // than or equal to |current_value|.
+  uint64_t pending_value;
+
+  // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
+  iree_status_t failure_status;
+} iree_hal_webgpu_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t iree_hal_webgpu_semaphore_vtable;
+
+static iree_hal_webgpu_semaphore_t* iree_hal_webgpu_semaphore_cast(
+    iree_hal_semaphore_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_webgpu_semaphore_vtable);
+  return (iree_hal_webgpu_semaphore_t*)base_value;
+}
+
+iree_status_t iree_hal_webgpu_semaphore_create(
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_webgpu_semaphore_t* semaphore = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*semaphore), (void**)&semaphore);
+  if (iree_status_is_ok(status)) {
+    iree_hal_semaphore_initialize(&iree_hal_webgpu_semaphore_vtable,
+                                  &semaphore->base);
+    semaphore->host_allocator = host_allocator;
+
+    iree_slim_mutex_initialize(&semaphore->mutex);
+    semaphore->current_value = initial_value;
+    semaphore->pending_value = initial_value;
+    semaphore->failure_status = iree_ok_status();
+
+    *out_semaphore = &semaphore->base;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_webgpu_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_deinitialize(&semaphore->mutex);
+  iree_status_ignore(semaphore->failure_status);
+
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(host_allocator, semaphore);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_webgpu_semaphore_isa(iree_hal_semaphore_t* semaphore) {
+  return iree_hal_resource_is(semaphore, &iree_hal_webgpu_semaphore_vtable);
+}
+
+void iree_hal_webgpu_semaphore_reserve(iree_hal_semaphore_t* base_semaphore,
+                                       uint64_t value) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+  iree_slim_mutex_lock(&semaphore->mutex);
+  semaphore->pending_value = iree_max(semaphore->pending_value, value);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+}
+
+bool iree_hal_webgpu_semaphore_is_reserved(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+  iree_slim_mutex_lock(&semaphore->mutex);
+  bool is_reserved = iree_status_is_ok(semaphore->failure_status) &&
+                     semaphore->pending_value >= value;
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return is_reserved;
+}
+
+static iree_status_t iree_hal_webgpu_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  *out_value = semaphore->current_value;
+
+  iree_status_t status = iree_ok_status();
+  if (*out_value >= IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE) {
+    status = iree_status_clone(semaphore->failure_status);
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  return status;
+}
+
+static iree_status_t iree_hal_webgpu_semaphore_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  if (new_value <= semaphore->current_value) {
+    uint64_t current_value IREE_ATTRIBUTE_UNUSED = semaphore->current_value;
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "semaphore values must be monotonically "
+                            "increasing; current_value=%" PRIu64
+                            ", new_value=%" PRIu64,
+                            current_value, new_value);
+  }
+
+  // Update to the new value.
+  semaphore->current_value = new_value;
+  semaphore->pending_value = iree_max(semaphore->pending_value, new_value);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  // Notify timepoints of the new value.
+  iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
+
+  return iree_ok_status();
+}
+
+static void iree_hal_webgpu_semaphore_fail(
+    iree_hal_semaphore_t* base_semaphore, iree_status_t status) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+  const iree_status_code_t status_code = iree_status_code(status);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Try to set our local status - we only preserve the first failure so only
+  // do this if we are going from a valid semaphore to a failed one.
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Previous status was not OK; drop our new status.
+    IREE_IGNORE_ERROR(status);
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return;
+  }
+
+  // Signal to our failure sentinel value.
+  semaphore->current_value = IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE;
+  semaphore->pending_value = IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE;
+  semaphore->failure_status = status;
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  // Notify timepoints of the failure.
+  iree_hal_semaphore_notify(&semaphore->base,
+                            IREE_HAL_WEBGPU_SEMAPHORE_FAILURE_VALUE,
+                            status_code);
+}
+
+static iree_status_t iree_hal_webgpu_semaphore_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_timeout_t timeout) {
+  iree_hal_webgpu_semaphore_t* semaphore =
+      iree_hal_webgpu_semaphore_cast(base_semaphore);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+  iree_status_t status = iree_ok_status();
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Failed; return an error to tell callers to query for it.
+    status = iree_status_from_code(IREE_STATUS_ABORTED);
+  } else if (semaphore->current_value >= value) {
+    // Already satisfied.
+  } else if (iree_timeout_is_immediate(timeout)) {
+    // Not satisfied but a poll.
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  } else {
+    // Completion callbacks are only issued when control returns to the browser
+    // event loop and blocking here would deadlock.
+    uint64_t current_value = semaphore->current_value;
+    status = iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "blocking waits are not supported on WebGPU; semaphore is at %" PRIu64
+        " and the wait for %" PRIu64
+        " must be performed asynchronously by yielding to the loop",
+        current_value, value);
+  }
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return status;
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_webgpu_semaphore_vtable = {
+    .destroy = iree_hal_webgpu_semaphore_destroy,
+    .query = iree_hal_webgpu_semaphore_query,
+    .signal = iree_hal_webgpu_semaphore_signal,
+    .fail = iree_hal_webgpu_semaphore_fail,
+    .wait = iree_hal_webgpu_semaphore_wait,
+};
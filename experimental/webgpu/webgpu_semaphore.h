@@ -0,0 +1,44 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_WEBGPU_WEBGPU_SEMAPHORE_H_
+#define IREE_HAL_WEBGPU_WEBGPU_SEMAPHORE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a host-side semaphore signaled from WebGPU completion callbacks.
+//
+// Browsers do not allow blocking the JavaScript event loop and a wait that
+// cannot be satisfied immediately fails: users must yield to the loop and
+// observe progress with semaphore timepoints (or by polling).
+iree_status_t iree_hal_webgpu_semaphore_create(
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Returns true if |semaphore| is a WebGPU semaphore.
+bool iree_hal_webgpu_semaphore_isa(iree_hal_semaphore_t* semaphore);
+
+// Records that queued work will signal |semaphore| to |value|.
+// As the WebGPU queue executes in order any later submission waiting on a
+// value up to |value| can be issued without waiting on the host.
+void iree_hal_webgpu_semaphore_reserve(iree_hal_semaphore_t* semaphore,
+                                       uint64_t value);
+
+// Returns true if |semaphore| has reached |value| or queued work has been
+// reserved to signal it to at least |value|.
+bool iree_hal_webgpu_semaphore_is_reserved(iree_hal_semaphore_t* semaphore,
+                                           uint64_t value);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_WEBGPU_WEBGPU_SEMAPHORE_H_
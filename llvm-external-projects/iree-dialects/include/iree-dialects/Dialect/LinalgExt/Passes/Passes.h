@@ -139,10 +139,10 @@ std::unique_ptr<OperationPass<>> createPadContractionToBlockSizePass();
 /// Function signature to control reduction splitting. This returns the split
 /// reduction ratio used to split the reduction dimension. The ratio is applied
 /// to the reduction dimension of TopK. If the ratio value is less or equal to 1
-/// then nothing will be done. Input is the current depth of recursive split
-/// reduction, starting from 0 (first level).
+/// then nothing will be done. Inputs are the op being split and the current
+/// depth of recursive split reduction, starting from 0 (first level).
 using TopkSplitReductionControlFn =
-    std::function<int64_t(int64_t splitReductionDepth)>;
+    std::function<int64_t(TopkOp topkOp, int64_t splitReductionDepth)>;
 
 /// Patterns to apply `topk split reduction` pass.
 void populateTopkSplitReductionPattern(
@@ -153,6 +153,20 @@ void populateTopkSplitReductionPattern(
 
 std::unique_ptr<OperationPass<func::FuncOp>> createTopkSplitReductionPass();
 
+/// Function signature to control scan splitting. This returns the number of
+/// blocks the scanned dimension of |scanOp| is split into. If the ratio value
+/// is less or equal to 1 then nothing will be done.
+using ScanSplitReductionControlFn = std::function<int64_t(ScanOp scanOp)>;
+
+/// Patterns to apply `scan split reduction` pass.
+void populateScanSplitReductionPattern(
+    RewritePatternSet &patterns,
+    const ScanSplitReductionControlFn &splitReductionFn,
+    const LinalgExt::LinalgTransformationFilter &f =
+        LinalgExt::LinalgTransformationFilter());
+
+std::unique_ptr<OperationPass<func::FuncOp>> createScanSplitReductionPass();
+
 /// Tile and decompose the winograd transform ops into a sequence
 /// of linalg ops.
 std::unique_ptr<OperationPass<func::FuncOp>>
@@ -318,7 +318,8 @@ struct TopkOpSplitReduction : public OpRewritePattern<TopkOp> {
     int64_t kSize =
         topkOp.getResult(0).getType().cast<ShapedType>().getDimSize(kDimOrig);
     int64_t splitReductionDepth = getSplitReductionDepth(topkOp);
-    int64_t splitReductionRatio = splitReductionFn(splitReductionDepth);
+    int64_t splitReductionRatio =
+        splitReductionFn(topkOp, splitReductionDepth);
     SmallVector<ReassociationIndices> reassociationIndices =
         getReassociationIndices(topkOp.getInputRank(), splitDimParallel);
 
@@ -365,6 +366,189 @@ private:
   LinalgTransformationFilter filter;
 };
 
+//===----------------------------------------------------------------------===//
+// ScanOp
+//===----------------------------------------------------------------------===//
+
+// Returns the sizes of |value| as OpFoldResults, dropping |dropDim| if >= 0.
+SmallVector<OpFoldResult> getMixedSizesWithoutDim(OpBuilder &b, Location loc,
+                                                  Value value,
+                                                  int64_t dropDim = -1) {
+  auto type = value.getType().cast<RankedTensorType>();
+  SmallVector<OpFoldResult> sizes;
+  for (int64_t i = 0; i < type.getRank(); ++i) {
+    if (i == dropDim)
+      continue;
+    if (type.isDynamicDim(i)) {
+      sizes.push_back(b.create<tensor::DimOp>(loc, value, i).getResult());
+    } else {
+      sizes.push_back(b.getIndexAttr(type.getDimSize(i)));
+    }
+  }
+  return sizes;
+}
+
+// Creates an inclusive scan of |input| along |dimension| that uses the
+// combiner region of |scanOp| and fresh output and accumulator tensors.
+ScanOp createInclusiveScan(PatternRewriter &rewriter, Location loc,
+                           ScanOp scanOp, Value input, int64_t dimension) {
+  Type elementType = input.getType().cast<ShapedType>().getElementType();
+  Value output = rewriter.create<tensor::EmptyOp>(
+      loc, getMixedSizesWithoutDim(rewriter, loc, input), elementType);
+  Value accumulator = rewriter.create<tensor::EmptyOp>(
+      loc, getMixedSizesWithoutDim(rewriter, loc, input, dimension),
+      elementType);
+  auto newScanOp = rewriter.create<ScanOp>(
+      loc, TypeRange{output.getType(), accumulator.getType()},
+      ValueRange{input}, ValueRange{output, accumulator},
+      rewriter.getI64IntegerAttr(dimension), rewriter.getBoolAttr(true));
+  rewriter.cloneRegionBefore(scanOp.getRegion(), newScanOp.getRegion(),
+                             newScanOp.getRegion().end());
+  return newScanOp;
+}
+
+struct ScanOpSplitReduction : public OpRewritePattern<ScanOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  ScanOpSplitReduction(MLIRContext *context, ScanSplitReductionControlFn fn,
+                       LinalgTransformationFilter filt)
+      : OpRewritePattern<ScanOp>(context), splitReductionFn(std::move(fn)),
+        filter(std::move(filt)) {}
+
+  // Transforms an inclusive ScanOp into a blocked parallel scan.
+  //
+  // The scanned dimension of size N is split into R blocks of N / R elements
+  // and handled in 3 phases:
+  //   1. Each block is scanned independently (parallel across blocks).
+  //   2. The R block totals are scanned to compute the carry into each block.
+  //   3. The carry of the preceding blocks is combined into every element of
+  //      each block but the first (fully parallel).
+  // This relies on the combiner being associative as any parallel scan does.
+  LogicalResult matchAndRewrite(ScanOp scanOp,
+                                PatternRewriter &rewriter) const override {
+    if (failed(filter.checkAndNotify(rewriter, scanOp))) {
+      return rewriter.notifyMatchFailure(scanOp, "preconditions not met");
+    }
+    if (!scanOp.hasTensorSemantics()) {
+      return rewriter.notifyMatchFailure(scanOp, "expected tensor semantics");
+    }
+    if (!scanOp.getInclusive()) {
+      return rewriter.notifyMatchFailure(scanOp,
+                                         "only inclusive scans are supported");
+    }
+    int64_t dim = scanOp.getDimension();
+    ShapedType inputType = scanOp.getOperandType();
+    if (inputType.isDynamicDim(dim)) {
+      return rewriter.notifyMatchFailure(scanOp,
+                                         "cannot split dynamic dimension");
+    }
+    int64_t splitReductionRatio = splitReductionFn(scanOp);
+    if (splitReductionRatio <= 1) {
+      return rewriter.notifyMatchFailure(scanOp, "reduction ratio <= 1");
+    }
+    if (inputType.getDimSize(dim) % splitReductionRatio != 0) {
+      return rewriter.notifyMatchFailure(
+          scanOp,
+          "scan dimension must be perfectly aligned to (divisible by) the "
+          "split ratio");
+    }
+    Location loc = scanOp.getLoc();
+    int64_t rank = inputType.getRank();
+    SmallVector<ReassociationIndices> reassociationIndices =
+        getReassociationIndices(rank, dim);
+    auto expandedType = RankedTensorType::get(
+        getExpandedShape(inputType.getShape(), splitReductionRatio, dim),
+        inputType.getElementType());
+
+    // Phase 1: scan within each block.
+    Value inputExpanded = rewriter.create<tensor::ExpandShapeOp>(
+        loc, expandedType, scanOp.input(), reassociationIndices);
+    ScanOp blockScanOp =
+        createInclusiveScan(rewriter, loc, scanOp, inputExpanded, dim + 1);
+    Value blockScans = blockScanOp.getResult(0);
+    Value blockTotals = blockScanOp.getResult(1);
+
+    // Phase 2: scan the block totals. Shifting the result by one block gives
+    // the carry into each block; the first block has no carry and keeps its
+    // own total in that position as a placeholder that is never read.
+    ScanOp carryScanOp =
+        createInclusiveScan(rewriter, loc, scanOp, blockTotals, dim);
+    Value blockPrefixes = carryScanOp.getResult(0);
+    SmallVector<OpFoldResult> zeroOffsets(rank, rewriter.getIndexAttr(0));
+    SmallVector<OpFoldResult> unitStrides(rank, rewriter.getIndexAttr(1));
+    SmallVector<OpFoldResult> shiftSizes =
+        getMixedSizesWithoutDim(rewriter, loc, blockPrefixes);
+    shiftSizes[dim] = rewriter.getIndexAttr(splitReductionRatio - 1);
+    Value shiftedPrefixes = rewriter.create<tensor::ExtractSliceOp>(
+        loc, blockPrefixes, zeroOffsets, shiftSizes, unitStrides);
+    SmallVector<OpFoldResult> shiftOffsets = zeroOffsets;
+    shiftOffsets[dim] = rewriter.getIndexAttr(1);
+    Value carries = rewriter.create<tensor::InsertSliceOp>(
+        loc, shiftedPrefixes, blockTotals, shiftOffsets, shiftSizes,
+        unitStrides);
+
+    // Phase 3: combine the carries into the blocks.
+    int64_t expandedRank = rank + 1;
+    SmallVector<AffineExpr> carryExprs;
+    for (int64_t i = 0; i < expandedRank; ++i) {
+      if (i != dim + 1)
+        carryExprs.push_back(rewriter.getAffineDimExpr(i));
+    }
+    AffineMap identityMap = rewriter.getMultiDimIdentityMap(expandedRank);
+    SmallVector<AffineMap> indexingMaps = {
+        identityMap,
+        AffineMap::get(expandedRank, 0, carryExprs, rewriter.getContext()),
+        identityMap};
+    SmallVector<utils::IteratorType> iterators(expandedRank,
+                                               utils::IteratorType::parallel);
+    Value outputExpanded = rewriter.create<tensor::ExpandShapeOp>(
+        loc, expandedType, scanOp.output(), reassociationIndices);
+    Block &combinerBlock = scanOp.getRegion().front();
+    auto fixupOp = rewriter.create<linalg::GenericOp>(
+        loc, expandedType, ValueRange{blockScans, carries},
+        ValueRange{outputExpanded}, indexingMaps, iterators,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          IRMapping mapping;
+          mapping.map(combinerBlock.getArgument(0), args[1]);
+          mapping.map(combinerBlock.getArgument(1), args[0]);
+          for (Operation &op : combinerBlock.without_terminator()) {
+            b.clone(op, mapping);
+          }
+          Value combined = mapping.lookupOrDefault(
+              combinerBlock.getTerminator()->getOperand(0));
+          Value blockIndex = b.create<linalg::IndexOp>(loc, dim);
+          Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+          Value isFirstBlock = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::eq, blockIndex, zero);
+          Value result =
+              b.create<arith::SelectOp>(loc, isFirstBlock, args[0], combined);
+          b.create<linalg::YieldOp>(loc, result);
+        });
+    Value output = rewriter.create<tensor::CollapseShapeOp>(
+        loc, scanOp.getResult(0).getType(), fixupOp.getResult(0),
+        reassociationIndices);
+
+    // The final accumulator is the combined total of all blocks.
+    SmallVector<OpFoldResult> lastOffsets = zeroOffsets;
+    lastOffsets[dim] = rewriter.getIndexAttr(splitReductionRatio - 1);
+    SmallVector<OpFoldResult> lastSizes =
+        getMixedSizesWithoutDim(rewriter, loc, blockPrefixes);
+    lastSizes[dim] = rewriter.getIndexAttr(1);
+    Value accumulator = rewriter.create<tensor::ExtractSliceOp>(
+        loc, scanOp.getResult(1).getType().cast<RankedTensorType>(),
+        blockPrefixes, lastOffsets, lastSizes, unitStrides);
+
+    rewriter.replaceOp(scanOp, ValueRange{output, accumulator});
+    filter.replaceLinalgTransformationFilter(rewriter, blockScanOp);
+    filter.replaceLinalgTransformationFilter(rewriter, carryScanOp);
+    return success();
+  }
+
+private:
+  ScanSplitReductionControlFn splitReductionFn;
+  LinalgTransformationFilter filter;
+};
+
 } // namespace
 
 //===----------------------------------------------------------------------===//
@@ -386,7 +570,7 @@ struct TopkSplitReductionPass
     }
     RewritePatternSet patterns(&getContext());
     TopkSplitReductionControlFn splitReductionFn =
-        [&](int64_t splitReductionDepth) -> int64_t {
+        [&](TopkOp topkOp, int64_t splitReductionDepth) -> int64_t {
       SmallVector<int64_t, 4> reductionRatios(splitRatios.begin(),
                                               splitRatios.end());
       if (splitReductionDepth >= reductionRatios.size()) {
@@ -416,6 +600,37 @@ struct TopkSplitReductionPass
 };
 } // namespace
 
+namespace {
+struct ScanSplitReductionPass
+    : public ScanSplitReductionBase<ScanSplitReductionPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect, func::FuncDialect,
+                    mlir::arith::ArithDialect, tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    if (splitRatio <= 1) {
+      return;
+    }
+    RewritePatternSet patterns(&getContext());
+    populateScanSplitReductionPattern(
+        patterns, [&](ScanOp scanOp) -> int64_t { return splitRatio; },
+        LinalgTransformationFilter(
+            ArrayRef<StringAttr>{},
+            StringAttr::get(patterns.getContext(), "SPLIT_REDUCTION")));
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+
+    // Remove all the markers at the end.
+    getOperation()->walk([&](ScanOp op) {
+      op->removeAttr(LinalgTransforms::kLinalgTransformMarker);
+    });
+  }
+};
+} // namespace
+
 void mlir::iree_compiler::IREE::LinalgExt::populateTopkSplitReductionPattern(
     RewritePatternSet &patterns,
     const TopkSplitReductionControlFn &splitReductionFn,
@@ -428,3 +643,16 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::iree_compiler::IREE::LinalgExt::createTopkSplitReductionPass() {
   return std::make_unique<TopkSplitReductionPass>();
 }
+
+void mlir::iree_compiler::IREE::LinalgExt::populateScanSplitReductionPattern(
+    RewritePatternSet &patterns,
+    const ScanSplitReductionControlFn &splitReductionFn,
+    const LinalgTransformationFilter &f) {
+  patterns.add<ScanOpSplitReduction>(patterns.getContext(), splitReductionFn,
+                                     f);
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::iree_compiler::IREE::LinalgExt::createScanSplitReductionPass() {
+  return std::make_unique<ScanSplitReductionPass>();
+}
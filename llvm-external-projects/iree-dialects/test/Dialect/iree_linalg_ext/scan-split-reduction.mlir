@@ -0,0 +1,87 @@
+// RUN: iree-dialects-opt --iree-linalg-ext-scan-split-reduction='split-ratio=4' --split-input-file %s | FileCheck %s
+
+func.func @scan_split_reduction_1d(%input: tensor<128xf32>, %out: tensor<128xf32>, %acc: tensor<f32>) -> (tensor<128xf32>, tensor<f32>) {
+  %0:2 = iree_linalg_ext.scan
+         dimension(0) inclusive(true)
+         ins(%input : tensor<128xf32>)
+         outs(%out, %acc : tensor<128xf32>, tensor<f32>) {
+         ^bb0(%arg0: f32, %arg1: f32):
+           %sum = arith.addf %arg0, %arg1 : f32
+           iree_linalg_ext.yield %sum : f32
+         } -> tensor<128xf32>, tensor<f32>
+  return %0#0, %0#1 : tensor<128xf32>, tensor<f32>
+}
+
+// CHECK-DAG:   #[[MAP0:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-DAG:   #[[MAP1:.+]] = affine_map<(d0, d1) -> (d0)>
+// CHECK-LABEL: func.func @scan_split_reduction_1d(
+// CHECK-SAME:    %[[ARG0:.+]]: tensor<128xf32>, %[[ARG1:.+]]: tensor<128xf32>, %[[ARG2:.+]]: tensor<f32>)
+// CHECK:         %[[IN:.+]] = tensor.expand_shape %[[ARG0]] {{\[\[}}0, 1]] : tensor<128xf32> into tensor<4x32xf32>
+// CHECK:         %[[BLOCKS:.+]]:2 = iree_linalg_ext.scan dimension(1) inclusive(true)
+// CHECK-SAME:      ins(%[[IN]] : tensor<4x32xf32>)
+// CHECK-SAME:      -> tensor<4x32xf32>, tensor<4xf32>
+// CHECK:         %[[PREFIXES:.+]]:2 = iree_linalg_ext.scan dimension(0) inclusive(true)
+// CHECK-SAME:      ins(%[[BLOCKS]]#1 : tensor<4xf32>)
+// CHECK-SAME:      -> tensor<4xf32>, tensor<f32>
+// CHECK:         %[[SHIFT:.+]] = tensor.extract_slice %[[PREFIXES]]#0[0] [3] [1] : tensor<4xf32> to tensor<3xf32>
+// CHECK:         %[[CARRIES:.+]] = tensor.insert_slice %[[SHIFT]] into %[[BLOCKS]]#1[1] [3] [1] : tensor<3xf32> into tensor<4xf32>
+// CHECK:         %[[OUT:.+]] = tensor.expand_shape %[[ARG1]] {{\[\[}}0, 1]] : tensor<128xf32> into tensor<4x32xf32>
+// CHECK:         %[[FIXUP:.+]] = linalg.generic
+// CHECK-SAME:      indexing_maps = [#[[MAP0]], #[[MAP1]], #[[MAP0]]]
+// CHECK-SAME:      iterator_types = ["parallel", "parallel"]
+// CHECK-SAME:      ins(%[[BLOCKS]]#0, %[[CARRIES]] : tensor<4x32xf32>, tensor<4xf32>)
+// CHECK-SAME:      outs(%[[OUT]] : tensor<4x32xf32>)
+// CHECK:         ^bb0(%[[LOCAL:.+]]: f32, %[[CARRY:.+]]: f32, %{{.+}}: f32):
+// CHECK:           %[[SUM:.+]] = arith.addf %[[CARRY]], %[[LOCAL]] : f32
+// CHECK:           %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:           %[[FIRST:.+]] = arith.cmpi eq, %[[IDX]], %{{.+}} : index
+// CHECK:           %[[SEL:.+]] = arith.select %[[FIRST]], %[[LOCAL]], %[[SUM]] : f32
+// CHECK:           linalg.yield %[[SEL]] : f32
+// CHECK:         %[[RESULT:.+]] = tensor.collapse_shape %[[FIXUP]] {{\[\[}}0, 1]] : tensor<4x32xf32> into tensor<128xf32>
+// CHECK:         %[[TOTAL:.+]] = tensor.extract_slice %[[PREFIXES]]#0[3] [1] [1] : tensor<4xf32> to tensor<f32>
+// CHECK:         return %[[RESULT]], %[[TOTAL]] : tensor<128xf32>, tensor<f32>
+
+// -----
+
+func.func @scan_split_reduction_2d(%input: tensor<8x64xi32>, %out: tensor<8x64xi32>, %acc: tensor<8xi32>) -> (tensor<8x64xi32>, tensor<8xi32>) {
+  %0:2 = iree_linalg_ext.scan
+         dimension(1) inclusive(true)
+         ins(%input : tensor<8x64xi32>)
+         outs(%out, %acc : tensor<8x64xi32>, tensor<8xi32>) {
+         ^bb0(%arg0: i32, %arg1: i32):
+           %sum = arith.addi %arg0, %arg1 : i32
+           iree_linalg_ext.yield %sum : i32
+         } -> tensor<8x64xi32>, tensor<8xi32>
+  return %0#0, %0#1 : tensor<8x64xi32>, tensor<8xi32>
+}
+
+// CHECK-LABEL: func.func @scan_split_reduction_2d(
+// CHECK:         tensor.expand_shape %{{.+}} {{\[\[}}0], [1, 2]] : tensor<8x64xi32> into tensor<8x4x16xi32>
+// CHECK:         iree_linalg_ext.scan dimension(2) inclusive(true)
+// CHECK-SAME:      -> tensor<8x4x16xi32>, tensor<8x4xi32>
+// CHECK:         iree_linalg_ext.scan dimension(1) inclusive(true)
+// CHECK-SAME:      -> tensor<8x4xi32>, tensor<8xi32>
+// CHECK:         linalg.generic
+// CHECK:           linalg.index 1 : index
+// CHECK:         tensor.collapse_shape %{{.+}} {{\[\[}}0], [1, 2]] : tensor<8x4x16xi32> into tensor<8x64xi32>
+// CHECK:         tensor.extract_slice %{{.+}}[0, 3] [8, 1] [1, 1] : tensor<8x4xi32> to tensor<8xi32>
+
+// -----
+
+// Scans that do not divide evenly into blocks are left untouched.
+func.func @scan_split_reduction_unsupported(%input: tensor<30xf32>, %out: tensor<30xf32>, %acc: tensor<f32>) -> (tensor<30xf32>, tensor<f32>) {
+  %0:2 = iree_linalg_ext.scan
+         dimension(0) inclusive(true)
+         ins(%input : tensor<30xf32>)
+         outs(%out, %acc : tensor<30xf32>, tensor<f32>) {
+         ^bb0(%arg0: f32, %arg1: f32):
+           %sum = arith.addf %arg0, %arg1 : f32
+           iree_linalg_ext.yield %sum : f32
+         } -> tensor<30xf32>, tensor<f32>
+  return %0#0, %0#1 : tensor<30xf32>, tensor<f32>
+}
+
+// CHECK-LABEL: func.func @scan_split_reduction_unsupported(
+// CHECK-NOT:     tensor.expand_shape
+// CHECK:         iree_linalg_ext.scan dimension(0) inclusive(true)
+// CHECK-SAME:      ins(%{{.+}} : tensor<30xf32>)
@@ -0,0 +1,78 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BINDINGS_PYTHON_IREE_RT_DLPACK_H_
+#define IREE_BINDINGS_PYTHON_IREE_RT_DLPACK_H_
+
+#include <cstdint>
+
+// The subset of the DLPack (v0.8) ABI used for exchanging tensors with other
+// frameworks sharing the process. Only the types crossing the PyCapsule
+// boundary are declared; the layout must match dlpack.h exactly.
+// See https://dmlc.github.io/dlpack/latest/c_api.html.
+
+namespace iree {
+namespace python {
+namespace dlpack {
+
+// Capsule names defined by the Python specification of the protocol. A
+// capsule is renamed to kUsedTensorCapsuleName once consumed so that its
+// destructor knows ownership of the tensor has been transferred.
+constexpr const char* kTensorCapsuleName = "dltensor";
+constexpr const char* kUsedTensorCapsuleName = "used_dltensor";
+
+enum DeviceType : int32_t {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLCUDAHost = 3,
+  kDLVulkan = 7,
+  kDLROCM = 10,
+  kDLROCMHost = 11,
+  kDLCUDAManaged = 13,
+};
+
+enum DataTypeCode : uint8_t {
+  kDLInt = 0,
+  kDLUInt = 1,
+  kDLFloat = 2,
+  kDLBfloat = 4,
+  kDLComplex = 5,
+  kDLBool = 6,
+};
+
+struct DLDevice {
+  int32_t device_type;
+  int32_t device_id;
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  // Strides in elements or NULL for compact row-major tensors.
+  int64_t* strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+}  // namespace dlpack
+}  // namespace python
+}  // namespace iree
+
+#endif  // IREE_BINDINGS_PYTHON_IREE_RT_DLPACK_H_
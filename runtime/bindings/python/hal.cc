@@ -6,6 +6,10 @@
 
 #include "./hal.h"
 
+#include <memory>
+#include <optional>
+
+#include "./dlpack.h"
 #include "./vm.h"
 #include "iree/base/internal/path.h"
 #include "iree/base/tracing.h"
@@ -245,6 +249,318 @@ void HalDevice::EndProfiling() {
                  "ending device profiling");
 }
 
+//------------------------------------------------------------------------------
+// DLPack interop
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Returns the DLPack device type of the native device pointers of |device|,
+// if the driver it was created with has one.
+std::optional<int32_t> MapDeviceToDLPackDeviceType(iree_hal_device_t* device) {
+  iree_string_view_t device_id = iree_hal_device_id(device);
+  if (iree_string_view_starts_with(device_id, IREE_SV("cuda"))) {
+    return dlpack::kDLCUDA;
+  } else if (iree_string_view_starts_with(device_id, IREE_SV("hip")) ||
+             iree_string_view_starts_with(device_id, IREE_SV("rocm"))) {
+    return dlpack::kDLROCM;
+  }
+  return std::nullopt;
+}
+
+std::optional<dlpack::DLDataType> MapElementTypeToDLDataType(
+    iree_hal_element_type_t element_type) {
+  dlpack::DLDataType dtype;
+  switch (iree_hal_element_numerical_type(element_type)) {
+    case IREE_HAL_NUMERICAL_TYPE_BOOLEAN:
+      dtype.code = dlpack::kDLBool;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER:
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER_SIGNED:
+      dtype.code = dlpack::kDLInt;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED:
+      dtype.code = dlpack::kDLUInt;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_IEEE:
+      dtype.code = dlpack::kDLFloat;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_BRAIN:
+      dtype.code = dlpack::kDLBfloat;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_COMPLEX:
+      dtype.code = dlpack::kDLComplex;
+      break;
+    default:
+      return std::nullopt;
+  }
+  // Sub-byte types are packed differently by each framework.
+  iree_host_size_t bit_count = iree_hal_element_bit_count(element_type);
+  if (bit_count == 0 || bit_count % 8 != 0 || bit_count > 255) {
+    return std::nullopt;
+  }
+  dtype.bits = static_cast<uint8_t>(bit_count);
+  dtype.lanes = 1;
+  return dtype;
+}
+
+std::optional<iree_hal_element_type_t> MapDLDataTypeToElementType(
+    dlpack::DLDataType dtype) {
+  if (dtype.lanes != 1 || dtype.bits == 0 || dtype.bits % 8 != 0) {
+    return std::nullopt;
+  }
+  iree_hal_numerical_type_t numerical_type;
+  switch (dtype.code) {
+    case dlpack::kDLBool:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_BOOLEAN;
+      break;
+    case dlpack::kDLInt:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_INTEGER_SIGNED;
+      break;
+    case dlpack::kDLUInt:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED;
+      break;
+    case dlpack::kDLFloat:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_FLOAT_IEEE;
+      break;
+    case dlpack::kDLBfloat:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_FLOAT_BRAIN;
+      break;
+    case dlpack::kDLComplex:
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_FLOAT_COMPLEX;
+      break;
+    default:
+      return std::nullopt;
+  }
+  return iree_hal_make_element_type(numerical_type, dtype.bits);
+}
+
+// Selects how |buffer| is exported: as a native device pointer of |device|
+// when device-local or as a host pointer when host-visible. |device| is
+// optional and only host-visible buffers can be exported without it.
+dlpack::DLDevice SelectDLPackDevice(iree_hal_device_t* device,
+                                    iree_hal_buffer_t* buffer) {
+  iree_hal_memory_type_t memory_type = iree_hal_buffer_memory_type(buffer);
+  std::optional<int32_t> device_type =
+      device ? MapDeviceToDLPackDeviceType(device) : std::nullopt;
+  // TODO: report the native device ordinal once the HAL exposes it; all
+  // exported device pointers are currently reported as ordinal 0.
+  if (device_type &&
+      iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    return {*device_type, 0};
+  } else if (iree_all_bits_set(memory_type,
+                               IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+    return {dlpack::kDLCPU, 0};
+  }
+  throw RaiseValueError(
+      "DLPack export requires a host-visible buffer or a device-local buffer "
+      "of a device with native pointers");
+}
+
+// Owns the buffer view (and host mapping, if any) backing an exported tensor.
+struct DLPackExport {
+  ~DLPackExport() {
+    if (is_mapped) iree_status_ignore(iree_hal_buffer_unmap_range(&mapping));
+    iree_hal_buffer_view_release(buffer_view);
+  }
+
+  static void Delete(dlpack::DLManagedTensor* self) {
+    delete static_cast<DLPackExport*>(self->manager_ctx);
+  }
+
+  dlpack::DLManagedTensor managed_tensor;
+  iree_hal_buffer_view_t* buffer_view = nullptr;
+  iree_hal_buffer_mapping_t mapping;
+  bool is_mapped = false;
+  std::vector<int64_t> shape;
+};
+
+void DLPackCapsuleDestructor(PyObject* capsule) {
+  // Consumers rename the capsule when taking ownership of the tensor.
+  if (!PyCapsule_IsValid(capsule, dlpack::kTensorCapsuleName)) return;
+  auto* managed_tensor = static_cast<dlpack::DLManagedTensor*>(
+      PyCapsule_GetPointer(capsule, dlpack::kTensorCapsuleName));
+  if (managed_tensor->deleter) managed_tensor->deleter(managed_tensor);
+}
+
+py::object ExportBufferViewAsDLPack(iree_hal_device_t* device,
+                                    iree_hal_buffer_view_t* buffer_view) {
+  IREE_TRACE_SCOPE0("ExportBufferViewAsDLPack");
+  if (iree_hal_buffer_view_encoding_type(buffer_view) !=
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR) {
+    throw RaiseValueError("DLPack export requires a dense row-major view");
+  }
+  auto dtype = MapElementTypeToDLDataType(
+      iree_hal_buffer_view_element_type(buffer_view));
+  if (!dtype) {
+    throw RaiseValueError("Unsupported element type for DLPack export");
+  }
+  iree_hal_buffer_t* buffer = iree_hal_buffer_view_buffer(buffer_view);
+  dlpack::DLDevice dl_device = SelectDLPackDevice(device, buffer);
+
+  auto context = std::make_unique<DLPackExport>();
+  void* data = nullptr;
+  if (dl_device.device_type == dlpack::kDLCPU) {
+    // The mapping is held until the consumer deletes the tensor.
+    CheckApiStatus(
+        iree_hal_buffer_map_range(buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+                                  iree_hal_buffer_allowed_access(buffer), 0,
+                                  IREE_WHOLE_BUFFER, &context->mapping),
+        "Could not map buffer for DLPack export");
+    context->is_mapped = true;
+    data = context->mapping.contents.data;
+  } else {
+    iree_hal_external_buffer_t external_buffer;
+    CheckApiStatus(iree_hal_allocator_export_buffer(
+                       iree_hal_device_allocator(device), buffer,
+                       IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION,
+                       IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE, &external_buffer),
+                   "Could not export buffer for DLPack");
+    data = reinterpret_cast<void*>(
+        static_cast<uintptr_t>(external_buffer.handle.device_allocation.ptr));
+  }
+  context->buffer_view = buffer_view;
+  iree_hal_buffer_view_retain(buffer_view);
+
+  iree_host_size_t rank = iree_hal_buffer_view_shape_rank(buffer_view);
+  const iree_hal_dim_t* dims = iree_hal_buffer_view_shape_dims(buffer_view);
+  context->shape.assign(dims, dims + rank);
+
+  dlpack::DLTensor& tensor = context->managed_tensor.dl_tensor;
+  tensor.data = data;
+  tensor.device = dl_device;
+  tensor.ndim = static_cast<int32_t>(rank);
+  tensor.dtype = *dtype;
+  tensor.shape = context->shape.data();
+  tensor.strides = nullptr;
+  tensor.byte_offset = 0;
+  context->managed_tensor.manager_ctx = context.get();
+  context->managed_tensor.deleter = DLPackExport::Delete;
+
+  PyObject* capsule =
+      PyCapsule_New(&context->managed_tensor, dlpack::kTensorCapsuleName,
+                    DLPackCapsuleDestructor);
+  if (!capsule) throw py::error_already_set();
+  context.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+// Notifies the producer of an imported tensor that the HAL no longer
+// references its memory.
+void ReleaseImportedDLPackTensor(void* user_data, iree_hal_buffer_t* buffer) {
+  auto* managed_tensor = static_cast<dlpack::DLManagedTensor*>(user_data);
+  if (!managed_tensor->deleter || !Py_IsInitialized()) return;
+  // Buffers may be released from threads not holding the GIL and the
+  // deleters of Python producers release Python objects.
+  PyGILState_STATE gil_state = PyGILState_Ensure();
+  managed_tensor->deleter(managed_tensor);
+  PyGILState_Release(gil_state);
+}
+
+}  // namespace
+
+py::tuple HalDevice::DLPackDevice(HalBufferView& buffer_view) {
+  dlpack::DLDevice dl_device = SelectDLPackDevice(
+      raw_ptr(), iree_hal_buffer_view_buffer(buffer_view.raw_ptr()));
+  return py::make_tuple(dl_device.device_type, dl_device.device_id);
+}
+
+py::object HalDevice::ExportDLPack(HalBufferView& buffer_view) {
+  return ExportBufferViewAsDLPack(raw_ptr(), buffer_view.raw_ptr());
+}
+
+HalBufferView HalDevice::ImportDLPack(py::object capsule) {
+  IREE_TRACE_SCOPE0("HalDevice::ImportDLPack");
+  if (!PyCapsule_IsValid(capsule.ptr(), dlpack::kTensorCapsuleName)) {
+    throw RaiseValueError("Expected an unconsumed DLPack tensor capsule");
+  }
+  auto* managed_tensor = static_cast<dlpack::DLManagedTensor*>(
+      PyCapsule_GetPointer(capsule.ptr(), dlpack::kTensorCapsuleName));
+  const dlpack::DLTensor& tensor = managed_tensor->dl_tensor;
+  auto element_type = MapDLDataTypeToElementType(tensor.dtype);
+  if (!element_type) {
+    throw RaiseValueError("Unsupported DLPack dtype");
+  }
+
+  // Only compact row-major tensors can alias a dense buffer. Strides of unit
+  // dimensions are meaningless and frameworks report them inconsistently.
+  std::vector<iree_hal_dim_t> dims(tensor.ndim);
+  int64_t element_count = 1;
+  for (int32_t i = tensor.ndim - 1; i >= 0; --i) {
+    if (tensor.strides && tensor.shape[i] != 1 &&
+        tensor.strides[i] != element_count) {
+      throw RaiseValueError(
+          "DLPack import requires a compact row-major tensor");
+    }
+    dims[i] = static_cast<iree_hal_dim_t>(tensor.shape[i]);
+    element_count *= tensor.shape[i];
+  }
+
+  iree_hal_external_buffer_t external_buffer;
+  memset(&external_buffer, 0, sizeof(external_buffer));
+  external_buffer.size =
+      element_count * iree_hal_element_dense_byte_count(*element_type);
+  uint8_t* data = static_cast<uint8_t*>(tensor.data) + tensor.byte_offset;
+  iree_hal_buffer_params_t params = {0};
+  params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  switch (tensor.device.device_type) {
+    case dlpack::kDLCPU:
+    case dlpack::kDLCUDAHost:
+    case dlpack::kDLROCMHost:
+      external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+      external_buffer.handle.host_allocation.ptr = data;
+      params.type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+      params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING;
+      break;
+    case dlpack::kDLCUDA:
+    case dlpack::kDLROCM:
+      if (MapDeviceToDLPackDeviceType(raw_ptr()) !=
+          tensor.device.device_type) {
+        throw RaiseValueError(
+            "DLPack tensor resides on a device of another driver");
+      }
+      external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION;
+      external_buffer.handle.device_allocation.ptr =
+          static_cast<uint64_t>(reinterpret_cast<uintptr_t>(data));
+      params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+      break;
+    default:
+      throw RaiseValueError("Unsupported DLPack device type");
+  }
+
+  iree_hal_buffer_release_callback_t release_callback = {
+      ReleaseImportedDLPackTensor, managed_tensor};
+  iree_hal_buffer_t* buffer = nullptr;
+  CheckApiStatus(iree_hal_allocator_import_buffer(allocator(), params,
+                                                  &external_buffer,
+                                                  release_callback, &buffer),
+                 "Could not import DLPack tensor");
+  // The buffer now owns the tensor and deletes it when released.
+  PyCapsule_SetName(capsule.ptr(), dlpack::kUsedTensorCapsuleName);
+
+  iree_hal_buffer_view_t* buffer_view = nullptr;
+  iree_status_t status = iree_hal_buffer_view_create(
+      buffer, dims.size(), dims.data(), *element_type,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, iree_allocator_system(),
+      &buffer_view);
+  iree_hal_buffer_release(buffer);
+  CheckApiStatus(status, "Error creating buffer view");
+  return HalBufferView::StealFromRawPtr(buffer_view);
+}
+
+py::tuple HalBufferView::DLPackDevice() {
+  dlpack::DLDevice dl_device =
+      SelectDLPackDevice(nullptr, iree_hal_buffer_view_buffer(raw_ptr()));
+  return py::make_tuple(dl_device.device_type, dl_device.device_id);
+}
+
+py::object HalBufferView::DLPack(py::object stream) {
+  // Buffer views are only handed to Python once their contents are ready so
+  // there is no work for the consumer's |stream| to wait on.
+  return ExportBufferViewAsDLPack(nullptr, raw_ptr());
+}
+
 //------------------------------------------------------------------------------
 // HalDriver
 //------------------------------------------------------------------------------
@@ -630,7 +946,18 @@ void SetupHalBindings(pybind11::module m) {
           },
           py::keep_alive<0, 1>())
       .def("begin_profiling", &HalDevice::BeginProfiling)
-      .def("end_profiling", &HalDevice::EndProfiling);
+      .def("end_profiling", &HalDevice::EndProfiling)
+      .def("dlpack_device", &HalDevice::DLPackDevice, py::arg("buffer_view"),
+           "Returns the DLPack (device_type, device_id) tuple of a buffer "
+           "view allocated from this device.")
+      .def("export_dlpack", &HalDevice::ExportDLPack, py::arg("buffer_view"),
+           "Exports a buffer view allocated from this device as a DLPack "
+           "capsule without copying.")
+      .def("import_dlpack", &HalDevice::ImportDLPack, py::arg("capsule"),
+           py::keep_alive<0, 1>(),
+           "Imports a DLPack capsule as a buffer view aliasing the tensor "
+           "memory without copying. Host tensors and tensors on the native "
+           "device of the driver are supported.");
 
   py::class_<HalDriver>(m, "HalDriver")
       .def_static("query", &HalDriver::Query)
@@ -742,6 +1069,9 @@ void SetupHalBindings(pybind11::module m) {
           [](HalBufferView& self) {
             return iree_hal_buffer_view_element_type(self.raw_ptr());
           })
+      .def("__dlpack__", &HalBufferView::DLPack,
+           py::arg("stream") = py::none())
+      .def("__dlpack_device__", &HalBufferView::DLPackDevice)
       .def("__repr__", &HalBufferView::Repr);
 
   py::class_<HalMappedMemory>(m, "MappedMemory", py::buffer_protocol())
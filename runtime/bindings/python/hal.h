@@ -80,6 +80,8 @@ struct ApiPtrAdapter<iree_hal_buffer_view_t> {
 // ApiRefCounted types
 //------------------------------------------------------------------------------
 
+class HalBufferView;
+
 class HalDevice : public ApiRefCounted<HalDevice, iree_hal_device_t> {
  public:
   iree_hal_allocator_t* allocator() {
@@ -88,6 +90,13 @@ class HalDevice : public ApiRefCounted<HalDevice, iree_hal_device_t> {
 
   void BeginProfiling(const py::kwargs& kwargs);
   void EndProfiling();
+
+  // DLPack interop. Buffers are exchanged without copies: device-local
+  // buffers are exported/imported as native device pointers and
+  // host-visible buffers as host pointers.
+  py::tuple DLPackDevice(HalBufferView& buffer_view);
+  py::object ExportDLPack(HalBufferView& buffer_view);
+  HalBufferView ImportDLPack(py::object capsule);
 };
 
 class HalDriver : public ApiRefCounted<HalDriver, iree_hal_driver_t> {
@@ -129,6 +138,11 @@ class HalBufferView
     : public ApiRefCounted<HalBufferView, iree_hal_buffer_view_t> {
  public:
   py::str Repr();
+
+  // DLPack export of host-visible buffer views. Device-local buffers must be
+  // exported with the device that allocated them (see HalDevice).
+  py::tuple DLPackDevice();
+  py::object DLPack(py::object stream);
 };
 
 class HalBuffer : public ApiRefCounted<HalBuffer, iree_hal_buffer_t> {
@@ -6,6 +6,14 @@
 
 #include "./invoke.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 #include "./hal.h"
 #include "./vm.h"
 #include "iree/base/api.h"
@@ -692,6 +700,208 @@ class ArgumentPacker {
   bool dynamic_dispatch_ = false;
 };
 
+
+// Invocations of a VM context are not thread-safe so asynchronous invocations
+// of the same context are serialized. Each context is assigned a mutex that
+// lives as long as any invocation referencing the context.
+std::shared_ptr<std::mutex> LookupContextInvocationMutex(
+    iree_vm_context_t *context) {
+  static std::mutex registry_mutex;
+  static auto *registry =
+      new std::unordered_map<iree_vm_context_t *, std::weak_ptr<std::mutex>>();
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::weak_ptr<std::mutex> &entry = (*registry)[context];
+  std::shared_ptr<std::mutex> mutex = entry.lock();
+  if (!mutex) {
+    mutex = std::make_shared<std::mutex>();
+    entry = mutex;
+  }
+  return mutex;
+}
+
+/// Results of an invocation running on its own thread without the GIL. For
+/// functions using the coarse-fences ABI model the invocation completes once
+/// the device signals the fence passed to the function.
+class InvokeFuture {
+ public:
+  // State shared with the thread running the invocation.
+  struct State {
+    ~State() {
+      iree_status_ignore(status);
+      iree_hal_fence_release(signal_fence);
+    }
+
+    std::mutex mutex;
+    std::condition_variable completed_cv;
+    bool completed = false;
+    iree_status_t status = iree_ok_status();
+    // Immutable once the invocation has started.
+    iree_hal_fence_t *signal_fence = nullptr;
+  };
+
+  InvokeFuture(std::shared_ptr<State> state, VmVariantList outputs)
+      : state_(std::move(state)), outputs_(std::move(outputs)) {}
+  InvokeFuture(InvokeFuture &&other) = default;
+  ~InvokeFuture() { Join(); }
+
+  void Start(VmContext &context, iree_vm_function_t function,
+             VmVariantList &inputs) {
+    iree_vm_context_t *raw_context = context.raw_ptr();
+    iree_vm_list_t *raw_inputs = inputs.raw_ptr();
+    iree_vm_list_t *raw_outputs = outputs_.raw_ptr();
+    iree_vm_context_retain(raw_context);
+    iree_vm_list_retain(raw_inputs);
+    iree_vm_list_retain(raw_outputs);
+    thread_ = std::thread([state = state_,
+                           context_mutex =
+                               LookupContextInvocationMutex(raw_context),
+                           raw_context, function, raw_inputs, raw_outputs]() {
+      iree_status_t status;
+      {
+        std::lock_guard<std::mutex> lock(*context_mutex);
+        status = iree_vm_invoke(raw_context, function,
+                                IREE_VM_INVOCATION_FLAG_NONE, nullptr,
+                                raw_inputs, raw_outputs,
+                                iree_allocator_system());
+      }
+      iree_vm_list_release(raw_inputs);
+      iree_vm_list_release(raw_outputs);
+      iree_vm_context_release(raw_context);
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->status = status;
+        state->completed = true;
+      }
+      state->completed_cv.notify_all();
+    });
+  }
+
+  /// Returns true if the invocation has completed (successfully or not).
+  bool Done() {
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (!state_->completed) return false;
+      if (!iree_status_is_ok(state_->status)) return true;
+    }
+    if (!state_->signal_fence) return true;
+    iree_status_t status = iree_hal_fence_query(state_->signal_fence);
+    bool is_pending = iree_status_is_deferred(status);
+    iree_status_ignore(status);
+    return !is_pending;
+  }
+
+  /// Waits for the invocation to complete and returns false if it did not
+  /// before |timeout_seconds| elapsed.
+  bool Wait(std::optional<double> timeout_seconds) {
+    iree_time_t deadline_ns =
+        timeout_seconds ? iree_time_now() + static_cast<iree_duration_t>(
+                                                *timeout_seconds * 1e9)
+                        : IREE_TIME_INFINITE_FUTURE;
+    py::gil_scoped_release release;
+    {
+      std::unique_lock<std::mutex> lock(state_->mutex);
+      auto is_completed = [this]() { return state_->completed; };
+      if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+        state_->completed_cv.wait(lock, is_completed);
+      } else if (!state_->completed_cv.wait_for(
+                     lock,
+                     std::chrono::nanoseconds(
+                         std::max<iree_duration_t>(
+                             0, deadline_ns - iree_time_now())),
+                     is_completed)) {
+        return false;
+      }
+      // A failed invocation may never signal its fence.
+      if (!iree_status_is_ok(state_->status)) return true;
+    }
+    if (!state_->signal_fence) return true;
+    iree_status_t status = iree_hal_fence_wait(state_->signal_fence,
+                                               iree_make_deadline(deadline_ns));
+    if (iree_status_is_deadline_exceeded(status)) {
+      iree_status_ignore(status);
+      return false;
+    } else if (!iree_status_is_ok(status)) {
+      // Device failures are reported when the results are requested.
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (iree_status_is_ok(state_->status)) {
+        state_->status = status;
+      } else {
+        iree_status_ignore(status);
+      }
+    }
+    return true;
+  }
+
+  /// Waits for the invocation and returns its results, raising any failure.
+  VmVariantList Result(std::optional<double> timeout_seconds) {
+    if (!Wait(timeout_seconds)) {
+      throw RaisePyError(PyExc_TimeoutError,
+                         "Timed out waiting for the invocation to complete");
+    }
+    Join();
+    iree_status_t status;
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      status = iree_status_clone(state_->status);
+    }
+    CheckApiStatus(status, "Error invoking function");
+    return VmVariantList::BorrowFromRawPtr(outputs_.raw_ptr());
+  }
+
+ private:
+  void Join() {
+    if (!thread_.joinable()) return;
+    py::gil_scoped_release release;
+    thread_.join();
+  }
+
+  std::shared_ptr<State> state_;
+  VmVariantList outputs_;
+  std::thread thread_;
+};
+
+/// Starts invoking |function| with the packed |inputs| and returns without
+/// waiting for it. Functions using the coarse-fences ABI model get an
+/// immediately-satisfied wait fence and a signal fence the future waits on.
+InvokeFuture InvokeAsync(VmContext &context, iree_vm_function_t &function,
+                         HalDevice &device, VmVariantList &inputs,
+                         iree_host_size_t result_capacity) {
+  IREE_TRACE_SCOPE0("InvokeAsync");
+  auto state = std::make_shared<InvokeFuture::State>();
+  iree_string_view_t model = iree_vm_function_lookup_attr_by_name(
+      &function, IREE_SV("iree.abi.model"));
+  if (iree_string_view_equal(model, IREE_SV("coarse-fences"))) {
+    iree_allocator_t host_allocator =
+        iree_hal_device_host_allocator(device.raw_ptr());
+    iree_hal_fence_t *wait_fence = nullptr;
+    CheckApiStatus(iree_hal_fence_create(0, host_allocator, &wait_fence),
+                   "Error creating wait fence");
+    iree_vm_ref_t wait_fence_ref = iree_hal_fence_move_ref(wait_fence);
+    CheckApiStatus(iree_vm_list_push_ref_move(inputs.raw_ptr(),
+                                              &wait_fence_ref),
+                   "could not append wait fence");
+
+    iree_hal_semaphore_t *semaphore = nullptr;
+    CheckApiStatus(iree_hal_semaphore_create(device.raw_ptr(), 0ull,
+                                             &semaphore),
+                   "Error creating semaphore");
+    iree_status_t status = iree_hal_fence_create_at(
+        semaphore, 1ull, host_allocator, &state->signal_fence);
+    iree_hal_semaphore_release(semaphore);
+    CheckApiStatus(status, "Error creating signal fence");
+    iree_vm_ref_t signal_fence_ref =
+        iree_hal_fence_retain_ref(state->signal_fence);
+    CheckApiStatus(iree_vm_list_push_ref_move(inputs.raw_ptr(),
+                                              &signal_fence_ref),
+                   "could not append signal fence");
+  }
+
+  InvokeFuture future(std::move(state),
+                      VmVariantList::Create(result_capacity));
+  future.Start(context, function, inputs);
+  return future;
+}
+
 }  // namespace
 
 void SetupInvokeBindings(pybind11::module &m) {
@@ -700,6 +910,15 @@ void SetupInvokeBindings(pybind11::module &m) {
   py::class_<ArgumentPacker>(m, "ArgumentPacker")
       .def(py::init<InvokeStatics &, std::optional<py::list>>())
       .def("pack", &ArgumentPacker::Pack);
+  py::class_<InvokeFuture>(m, "InvokeFuture")
+      .def("done", &InvokeFuture::Done)
+      .def("wait", &InvokeFuture::Wait, py::arg("timeout") = py::none())
+      .def("result", &InvokeFuture::Result, py::arg("timeout") = py::none());
+  m.def("invoke_async", &InvokeAsync, py::arg("vm_context"),
+        py::arg("vm_function"), py::arg("device"), py::arg("inputs"),
+        py::arg("result_capacity"),
+        "Invokes a function on a background thread without holding the GIL "
+        "and returns an InvokeFuture for its results.");
 
   m.attr("_invoke_statics") = py::cast(InvokeStatics());
 }
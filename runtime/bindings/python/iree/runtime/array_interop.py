@@ -22,6 +22,7 @@ from ._binding import (
 __all__ = [
     "asdevicearray",
     "DeviceArray",
+    "from_dlpack",
 ]
 
 _DEVICE_HANDLED_FUNCTIONS = {}
@@ -93,6 +94,20 @@ class DeviceArray(numpy.lib.mixins.NDArrayOperatorsMixin):
   def __repr__(self):
     return f"<IREE DeviceArray: shape={np.shape(self)}, dtype={self.dtype}>"
 
+  def __dlpack__(self, *, stream=None):
+    """Exports the array as a DLPack capsule aliasing the device buffer.
+
+    Device-local buffers are exported as native device pointers when the
+    driver has them (CUDA, ROCm) and host-visible buffers as host pointers, so
+    frameworks consuming the capsule share the memory without copies. Note
+    that the raw device element type is exported even if `override_dtype` was
+    set.
+    """
+    return self._device.export_dlpack(self._buffer_view)
+
+  def __dlpack_device__(self):
+    return self._device.dlpack_device(self._buffer_view)
+
   @property
   def is_host_accessible(self):
     """Whether this array is currently host accessible."""
@@ -224,6 +239,29 @@ def asdevicearray(device: HalDevice,
                      override_dtype=a.dtype)
 
 
+def from_dlpack(device: HalDevice,
+                x,
+                *,
+                implicit_host_transfer: bool = True) -> DeviceArray:
+  """Creates a DeviceArray aliasing the memory of a DLPack tensor.
+
+  `x` is either an object implementing `__dlpack__` (such as a numpy array or
+  a PyTorch/JAX tensor) or a DLPack capsule. Host tensors and tensors resident
+  on the native device of the driver are imported without copies: the tensor
+  memory must not be modified by its producer while IREE may be using it and
+  is released back to the producer once the array (and any HAL references to
+  its buffer) are dropped.
+  """
+  if hasattr(x, "__dlpack__"):
+    capsule = x.__dlpack__()
+  else:
+    capsule = x
+  buffer_view = device.import_dlpack(capsule)
+  return DeviceArray(device,
+                     buffer_view,
+                     implicit_host_transfer=implicit_host_transfer)
+
+
 # NOTE: Numpy dtypes are not hashable and exist in a hierarchy that should
 # be queried via isinstance checks. This should be done as a fallback but
 # this is a linear list for quick access to the most common. There may also
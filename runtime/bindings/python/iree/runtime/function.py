@@ -18,11 +18,13 @@ from ._binding import (
     HalBufferView,
     HalDevice,
     InvokeContext,
+    InvokeFuture,
     MemoryType,
     VmContext,
     VmFunction,
     VmRef,
     VmVariantList,
+    invoke_async,
 )
 
 from . import tracing
@@ -34,6 +36,7 @@ from .flags import (
     FUNCTION_INPUT_VALIDATION,)
 
 __all__ = [
+    "AsyncInvocation",
     "FunctionInvoker",
 ]
 
@@ -130,29 +133,51 @@ class FunctionInvoker:
       self._invoke(arg_list, ret_list)
       if call_trace:
         call_trace.add_vm_list(ret_list, "results")
-
-      # Un-inline the results to align with reflection, as needed.
-      reflection_aligned_ret_list = ret_list
-      if self._has_inlined_results:
-        reflection_aligned_ret_list = VmVariantList(1)
-        reflection_aligned_ret_list.push_list(ret_list)
-      returns = _extract_vm_sequence_to_python(inv, reflection_aligned_ret_list,
-                                               ret_descs)
-      return_arity = len(returns)
-      if return_arity == 1:
-        return returns[0]
-      elif return_arity == 0:
-        return None
-      else:
-        return tuple(returns)
+      return self._unpack_results(inv, ret_list)
     finally:
       if call_trace:
         call_trace.end_call()
 
+  def invoke_async(self, *args, **kwargs) -> "AsyncInvocation":
+    """Starts an invocation without waiting for its results.
+
+    Arguments are packed as for a regular call and the function is then
+    invoked on a background thread without holding the GIL, allowing a single
+    Python thread to keep several devices busy. Functions compiled with the
+    coarse-fences ABI model are passed fences and complete once the device
+    signals them. Invocations of the same context are serialized: use one
+    context per device to run them concurrently.
+
+    Calls made this way are not recorded by the context tracer.
+    """
+    invoke_context = InvokeContext(self._device)
+    arg_list = self._arg_packer.pack(invoke_context, args, kwargs)
+    ret_descs = self._ret_descs
+    future = invoke_async(self._vm_context, self._vm_function, self._device,
+                          arg_list,
+                          len(ret_descs) if ret_descs is not None else 1)
+    return AsyncInvocation(self, future)
+
   # Break out invoke so it shows up in profiles.
   def _invoke(self, arg_list, ret_list):
     self._vm_context.invoke(self._vm_function, arg_list, ret_list)
 
+  def _unpack_results(self, inv: "Invocation", ret_list: VmVariantList):
+    # Un-inline the results to align with reflection, as needed.
+    reflection_aligned_ret_list = ret_list
+    if self._has_inlined_results:
+      reflection_aligned_ret_list = VmVariantList(1)
+      reflection_aligned_ret_list.push_list(ret_list)
+    returns = _extract_vm_sequence_to_python(inv, reflection_aligned_ret_list,
+                                             self._ret_descs)
+    return_arity = len(returns)
+    if return_arity == 1:
+      return returns[0]
+    elif return_arity == 0:
+      return None
+    else:
+      return tuple(returns)
+
   def _parse_abi_dict(self, vm_function: VmFunction):
     reflection = vm_function.reflection
     abi_json = reflection.get("iree.abi")
@@ -190,6 +215,40 @@ class FunctionInvoker:
     return repr(self._vm_function)
 
 
+class AsyncInvocation:
+  """Pending results of FunctionInvoker.invoke_async."""
+  __slots__ = [
+      "_invoker",
+      "_future",
+      "_returns",
+  ]
+
+  def __init__(self, invoker: FunctionInvoker, future: InvokeFuture):
+    self._invoker = invoker
+    self._future = future
+    self._returns = None
+
+  def done(self) -> bool:
+    """Whether the invocation has completed, successfully or not."""
+    return self._future.done()
+
+  def wait(self, timeout: Optional[float] = None) -> bool:
+    """Waits for completion and returns False if `timeout` seconds elapsed."""
+    return self._future.wait(timeout)
+
+  def result(self, timeout: Optional[float] = None):
+    """Waits for the invocation and returns its results like a regular call.
+
+    Raises TimeoutError if the invocation did not complete within `timeout`
+    seconds and re-raises any error produced by the invocation.
+    """
+    if self._returns is None:
+      ret_list = self._future.result(timeout)
+      self._returns = (self._invoker._unpack_results(
+          Invocation(self._invoker._device), ret_list),)
+    return self._returns[0]
+
+
 # VM to Python converters. All take:
 #   inv: Invocation
 #   vm_list: VmVariantList to read from
@@ -267,14 +267,9 @@ def load_vm_module(vm_module, config: Optional[Config] = None):
   return load_vm_modules(vm_module, config=config)[0]
 
 
-def load_vm_flatbuffer(vm_flatbuffer: bytes,
-                       *,
-                       driver: Optional[str] = None,
-                       backend: Optional[str] = None) -> BoundModule:
-  """Loads a VM Flatbuffer into a callable module.
-
-  Either 'driver' or 'backend' must be specified.
-  """
+def _config_for_driver_or_backend(driver: Optional[str],
+                                  backend: Optional[str]) -> Config:
+  """Returns a Config for 'driver' or the driver inferred from 'backend'."""
   if driver is None and backend is None:
     raise ValueError("Either 'driver' or 'backend' must be specified, but got "
                      "'None' for both.")
@@ -283,23 +278,35 @@ def load_vm_flatbuffer(vm_flatbuffer: bytes,
                      "the driver from.")
   if backend is not None:
     driver = TARGET_BACKEND_TO_DRIVER[backend]
-  config = Config(driver)
+  return Config(driver)
+
+
+def load_vm_flatbuffer(vm_flatbuffer: bytes,
+                       *,
+                       driver: Optional[str] = None,
+                       backend: Optional[str] = None) -> BoundModule:
+  """Loads a VM Flatbuffer into a callable module.
+
+  Either 'driver' or 'backend' must be specified.
+  """
+  config = _config_for_driver_or_backend(driver, backend)
   vm_module = _binding.VmModule.from_flatbuffer(config.vm_instance,
                                                 vm_flatbuffer)
   bound_module = load_vm_module(vm_module, config)
   return bound_module
 
 
-# TODO: There should be an API for mmap'ing the file which should be used
-# instead of reading into memory.
 def load_vm_flatbuffer_file(path: str,
                             *,
                             driver: Optional[str] = None,
                             backend: Optional[str] = None) -> BoundModule:
   """Loads a file containing a VM Flatbuffer into a callable module.
 
+  The file is memory-mapped instead of being read into memory so only the
+  pages actually used are loaded.
+
   Either 'driver' or 'backend' must be specified.
   """
-  with open(path, "rb") as f:
-    vm_flatbuffer = f.read()
-  return load_vm_flatbuffer(vm_flatbuffer, driver=driver, backend=backend)
+  config = _config_for_driver_or_backend(driver, backend)
+  vm_module = _binding.VmModule.mmap(config.vm_instance, path)
+  return load_vm_module(vm_module, config)
@@ -12,6 +12,7 @@ from typing import Dict, List, Optional, Sequence
 import logging
 import os
 import sys
+import time
 
 from . import _binding
 
@@ -43,6 +44,14 @@ class Tracer:
     self.trace_path = trace_path
     os.makedirs(trace_path, exist_ok=True)
     self._name_count = dict()  # type: Dict[str, int]
+    # Calls in all contexts are timestamped relative to this so that the
+    # per-context traces can be replayed concurrently with their recorded
+    # timing (iree-run-trace --concurrent --honor_timestamps).
+    self._start_time = time.perf_counter()
+
+  def get_timestamp(self) -> float:
+    """Returns the seconds elapsed since the tracer was created."""
+    return time.perf_counter() - self._start_time
 
   def persist_vm_module(self, vm_module: _binding.VmModule) -> "TracedModule":
     # Depending on how the module was created, there are different bits
@@ -134,6 +143,7 @@ class ContextTracer:
     record = {
         "type": "call",
         "function": "%s.%s" % (function.module_name, function.name),
+        "timestamp": round(self._parent.get_timestamp(), 6),
     }
     return CallTrace(self, record)
 
@@ -163,6 +163,53 @@ class DeviceHalTest(unittest.TestCase):
     self.assertEqual(repr(ary), "<IREE DeviceArray: shape=[3, 4], dtype=bool>")
     np.testing.assert_array_equal(ary.to_host(), init_ary)
 
+  def testDlpackExport(self):
+    init_ary = np.arange(12, dtype=np.float32).reshape(3, 4)
+    ary = iree.runtime.asdevicearray(self.device, init_ary)
+    self.assertEqual(ary.__dlpack_device__(), (1, 0))
+    host_ary = np.from_dlpack(ary)
+    np.testing.assert_array_equal(host_ary, init_ary)
+
+    # The consumer aliases the device buffer.
+    host_ary[0, 0] = 42
+    self.assertEqual(ary.to_host()[0, 0], 42)
+
+    # The buffer must outlive the array it was exported from.
+    ary = None
+    gc.collect()
+    self.assertEqual(host_ary[0, 0], 42)
+
+  def testDlpackImport(self):
+    init_ary = np.arange(12, dtype=np.int32).reshape(3, 4)
+    ary = iree.runtime.from_dlpack(self.device, init_ary)
+    self.assertEqual([3, 4], ary.shape)
+    self.assertEqual(np.int32, ary.dtype)
+    np.testing.assert_array_equal(ary, init_ary)
+
+    # The imported buffer aliases the producer's memory.
+    init_ary[0, 0] = 42
+    self.assertEqual(ary.to_host()[0, 0], 42)
+
+    # The producer's memory must outlive the producing array.
+    init_ary = None
+    gc.collect()
+    self.assertEqual(ary.to_host()[0, 0], 42)
+
+  def testDlpackImportNonContiguous(self):
+    init_ary = np.arange(12, dtype=np.int32).reshape(3, 4)
+    with self.assertRaises(ValueError):
+      iree.runtime.from_dlpack(self.device, init_ary.T)
+
+  def testDlpackBufferView(self):
+    init_ary = np.arange(6, dtype=np.float32)
+    buffer_view = self.allocator.allocate_buffer_copy(
+        memory_type=iree.runtime.MemoryType.DEVICE_LOCAL,
+        allowed_usage=iree.runtime.BufferUsage.DEFAULT,
+        buffer=init_ary,
+        element_type=iree.runtime.HalElementType.FLOAT_32)
+    self.assertEqual(buffer_view.__dlpack_device__(), (1, 0))
+    np.testing.assert_array_equal(np.from_dlpack(buffer_view), init_ary)
+
 
 if __name__ == "__main__":
   unittest.main()
@@ -101,6 +101,27 @@ class SystemApiTest(unittest.TestCase):
     results2 = f(results, results)
     np.testing.assert_allclose(results2, [16., 100., 324., 784.])
 
+  def test_async_invoke(self):
+    ctx = iree.runtime.SystemContext()
+    ctx.add_vm_module(create_simple_mul_module(ctx.instance))
+    f = ctx.modules.arithmetic["simple_mul"]
+    arg0 = np.array([1., 2., 3., 4.], dtype=np.float32)
+    arg1 = np.array([4., 5., 6., 7.], dtype=np.float32)
+    pending = [f.invoke_async(arg0, arg1) for _ in range(4)]
+    for invocation in pending:
+      self.assertTrue(invocation.wait())
+      self.assertTrue(invocation.done())
+      np.testing.assert_allclose(invocation.result(), [4., 10., 18., 28.])
+
+  def test_async_invoke_error(self):
+    ctx = iree.runtime.SystemContext()
+    ctx.add_vm_module(create_simple_mul_module(ctx.instance))
+    f = ctx.modules.arithmetic["simple_mul"]
+    arg0 = np.array([1., 2., 3.], dtype=np.float32)
+    invocation = f.invoke_async(arg0, arg0)
+    with self.assertRaises((ValueError, RuntimeError)):
+      invocation.result()
+
   def test_tracing_explicit(self):
     with tempfile.TemporaryDirectory() as temp_dir:
       tracer = iree.runtime.Tracer(temp_dir)
@@ -8,6 +8,8 @@
 
 import logging
 import numpy as np
+import os
+import tempfile
 import unittest
 
 import iree.compiler
@@ -77,6 +79,27 @@ class VmTest(unittest.TestCase):
     notfound = m.lookup_function("notfound")
     self.assertIs(notfound, None)
 
+  def test_module_mmap(self):
+    binary = iree.compiler.compile_str(
+        """
+        func.func @add_scalar(%arg0: i32, %arg1: i32) -> i32 {
+          %0 = arith.addi %arg0, %arg1 : i32
+          return %0 : i32
+        }
+        """,
+        target_backends=iree.compiler.core.DEFAULT_TESTING_BACKENDS,
+    )
+    with tempfile.TemporaryDirectory() as temp_dir:
+      vmfb_path = os.path.join(temp_dir, "add_scalar.vmfb")
+      with open(vmfb_path, "wb") as f:
+        f.write(binary)
+      m = iree.runtime.VmModule.mmap(self.instance, vmfb_path)
+    context = iree.runtime.VmContext(self.instance,
+                                     modules=[self.hal_module, m])
+    f = m.lookup_function("add_scalar")
+    finv = iree.runtime.FunctionInvoker(context, self.device, f, tracer=None)
+    self.assertEqual(finv(5, 6), 11)
+
   def test_dynamic_module_context(self):
     context = iree.runtime.VmContext(self.instance)
     m = create_simple_static_mul_module(self.instance)
@@ -8,6 +8,7 @@
 
 #include "./status_utils.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
 #include "iree/base/tracing.h"
 // TODO: We shouldn't need the HAL API but it is used for direct printing
 // summaries of HAL objects in lists. We should have a better way of doing this
@@ -164,6 +165,28 @@ VmModule VmModule::FromFlatbufferBlob(VmInstance* instance,
   return py_module;
 }
 
+VmModule VmModule::MMap(VmInstance* instance, std::string filepath) {
+  IREE_TRACE_SCOPE0("VmModule::MMap");
+  iree_file_contents_t* file_contents = NULL;
+  auto status = iree_file_read_contents(
+      filepath.c_str(), IREE_FILE_READ_FLAG_MMAP, iree_allocator_system(),
+      &file_contents);
+  CheckApiStatus(status, "Error mapping vm module file");
+
+  // The module takes ownership of the file contents (when successful).
+  iree_vm_module_t* module = nullptr;
+  status = iree_vm_bytecode_module_create(
+      instance->raw_ptr(), file_contents->const_buffer,
+      iree_file_contents_deallocator(file_contents), iree_allocator_system(),
+      &module);
+  if (!iree_status_is_ok(status)) {
+    iree_file_contents_free(file_contents);
+  }
+
+  CheckApiStatus(status, "Error creating vm module from mapped file");
+  return VmModule::StealFromRawPtr(module);
+}
+
 std::optional<iree_vm_function_t> VmModule::LookupFunction(
     const std::string& name, iree_vm_function_linkage_t linkage) {
   iree_vm_function_t f;
@@ -639,6 +662,8 @@ void SetupVmBindings(pybind11::module m) {
 
   py::class_<VmModule>(m, "VmModule")
       .def_static("from_flatbuffer", &VmModule::FromFlatbufferBlob)
+      .def_static("mmap", &VmModule::MMap, py::arg("instance"),
+                  py::arg("filepath"))
       .def_property_readonly("name", &VmModule::name)
       .def_property_readonly("version",
                              [](VmModule& self) {
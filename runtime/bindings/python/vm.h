@@ -132,6 +132,10 @@ class VmModule : public ApiRefCounted<VmModule, iree_vm_module_t> {
   static VmModule FromFlatbufferBlob(VmInstance* instance,
                                      py::object flatbuffer_blob_object);
 
+  // Maps the FlatBuffer file at |filepath| into memory and creates a module
+  // that references it directly. Pages are faulted in as they are used.
+  static VmModule MMap(VmInstance* instance, std::string filepath);
+
   std::optional<iree_vm_function_t> LookupFunction(
       const std::string& name, iree_vm_function_linkage_t linkage);
 
@@ -126,6 +126,44 @@ TfLiteInterpreterCreateWithSelectedOps(const TfLiteModel* model,
 TFL_CAPI_EXPORT extern void TfLiteInterpreterOptionsSetUseNNAPI(
     TfLiteInterpreterOptions* options, bool enable);
 
+/// Assigns (or reassigns) a custom memory allocation for the given
+/// tensor. `flags` is a bitmask, see TfLiteCustomAllocationFlags.
+/// The runtime does NOT take ownership of the underlying memory.
+///
+/// NOTE: User needs to call TfLiteInterpreterAllocateTensors() after this.
+/// Invalid/insufficient buffers will cause an error during
+/// TfLiteInterpreterAllocateTensors or TfLiteInterpreterInvoke (in case of
+/// dynamic shapes in the graph).
+///
+/// Parameters should satisfy the following conditions:
+/// 1. tensor->allocation_type == kTfLiteArenaRw or kTfLiteArenaRwPersistent
+///    In general, this is true for I/O tensors & variable tensors.
+/// 2. allocation->data has the appropriate permissions for runtime access
+///    (Read-only for inputs, Read-Write for others), and outlives
+///    TfLiteInterpreter.
+/// 3. allocation->bytes >= tensor->bytes.
+///    This condition is checked again if any tensors are resized.
+/// 4. allocation->data should be aligned to kDefaultTensorAlignment
+///    defined in lite/util.h. (Currently 64 bytes)
+///    This check is skipped if kTfLiteCustomAllocationFlagsSkipAlignCheck is
+///    set through `flags`.
+///
+/// WARNING: This is an experimental API and subject to change.
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags);
+
+/// IREE extension: shares a single process-wide device and its thread pool
+/// across all interpreters created with `enable` set and the same number of
+/// threads (see `TfLiteInterpreterOptionsSetNumThreads`). The device is
+/// destroyed when the last interpreter using it is deleted. Use this to avoid
+/// oversubscribing cores when running multiple interpreters.
+///
+/// WARNING: This is not part of the tflite API and only available in IREE.
+TFL_CAPI_EXPORT extern void TfLiteInterpreterOptionsSetIREEShareDevice(
+    TfLiteInterpreterOptions* options, bool enable);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
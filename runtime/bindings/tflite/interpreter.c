@@ -7,9 +7,15 @@
 #include "runtime/bindings/tflite/interpreter.h"
 
 #include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/init.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/loaders/registration/init.h"
 #include "iree/modules/hal/module.h"
+#include "iree/task/executor.h"
+#include "iree/task/topology.h"
 #include "runtime/bindings/tflite/model.h"
 #include "runtime/bindings/tflite/shim.h"
 #include "runtime/bindings/tflite/tensor.h"
@@ -25,41 +31,196 @@ static void _TfLiteInterpreterRegisterDrivers(void) {
       iree_hal_driver_registry_default()));
 }
 
-// TODO(#3977): if already provided a HAL device in the options use that.
-static iree_status_t _TfLiteInterpreterPrepareHAL(
-    TfLiteInterpreter* interpreter) {
+// Creates a local-task device using the default driver configuration.
+static iree_status_t _TfLiteInterpreterCreateDefaultDevice(
+    iree_allocator_t allocator, iree_hal_device_t** out_device) {
   iree_call_once(&_TfLiteInterpreterRegisterDriverFlag,
                  _TfLiteInterpreterRegisterDrivers);
 
-  iree_hal_driver_registry_t* driver_registry =
-      iree_hal_driver_registry_default();
-
-  iree_host_size_t driver_info_count = 0;
-  iree_hal_driver_info_t* driver_infos = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_driver_registry_enumerate(
-      driver_registry, interpreter->allocator, &driver_info_count,
-      &driver_infos));
-
   // TODO(benvanik): figure out how we want to emulate device selection; may
   // just say "whatever is first" on a query.
-  // iree_string_view_t driver_name = driver_infos[0].driver_name;
   // NOTE: currently the sample file is compiled only with vmvx.
   iree_string_view_t driver_name = iree_make_cstring_view("local-task");
 
-  // TODO(benvanik): switch to iree_hal_driver_registry_try_create when
-  // implemented.
-  iree_status_t status = iree_hal_driver_registry_try_create(
-      driver_registry, driver_name, interpreter->allocator,
-      &interpreter->driver);
-  iree_allocator_free(interpreter->allocator, driver_infos);
-  IREE_RETURN_IF_ERROR(status, "failed to create driver '%.*s'",
+  iree_hal_driver_t* driver = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_driver_registry_try_create(iree_hal_driver_registry_default(),
+                                          driver_name, allocator, &driver),
+      "failed to create driver '%.*s'", (int)driver_name.size,
+      driver_name.data);
+  iree_status_t status =
+      iree_hal_driver_create_default_device(driver, allocator, out_device);
+  iree_hal_driver_release(driver);
+  IREE_RETURN_IF_ERROR(status,
+                       "failed creating the default device for driver '%.*s'",
                        (int)driver_name.size, driver_name.data);
+  return iree_ok_status();
+}
 
-  IREE_RETURN_IF_ERROR(
-      iree_hal_driver_create_default_device(
-          interpreter->driver, interpreter->allocator, &interpreter->device),
-      "failed creating the default device for driver '%.*s'",
-      (int)driver_name.size, driver_name.data);
+// Creates a local-task device with an executor of |num_threads| workers.
+// This matches tflite where the thread count sizes the interpreter thread pool.
+static iree_status_t _TfLiteInterpreterCreateTaskDevice(
+    int32_t num_threads, iree_allocator_t allocator,
+    iree_hal_device_t** out_device) {
+  iree_task_executor_options_t executor_options;
+  iree_task_executor_options_initialize(&executor_options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count((iree_host_size_t)num_threads,
+                                                 &topology);
+  iree_task_executor_t* executor = NULL;
+  iree_status_t status = iree_task_executor_create(executor_options, &topology,
+                                                   allocator, &executor);
+  iree_task_topology_deinitialize(&topology);
+  IREE_RETURN_IF_ERROR(status);
+
+  iree_hal_executable_loader_t* loaders[8] = {NULL};
+  iree_host_size_t loader_count = 0;
+  status = iree_hal_create_all_available_executable_loaders(
+      iree_hal_executable_import_provider_default(), IREE_ARRAYSIZE(loaders),
+      &loader_count, loaders, allocator);
+
+  iree_hal_allocator_t* device_allocator = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
+                                            allocator, allocator,
+                                            &device_allocator);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    status = iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, /*queue_count=*/1,
+        &executor, loader_count, loaders, device_allocator, allocator,
+        out_device);
+  }
+
+  iree_hal_allocator_release(device_allocator);
+  for (iree_host_size_t i = 0; i < loader_count; ++i) {
+    iree_hal_executable_loader_release(loaders[i]);
+  }
+  iree_task_executor_release(executor);
+  return status;
+}
+
+// Creates a new device for interpreters using |num_threads|.
+static iree_status_t _TfLiteInterpreterCreateDevice(
+    int32_t num_threads, iree_allocator_t allocator,
+    iree_hal_device_t** out_device) {
+  if (num_threads > 0) {
+    return _TfLiteInterpreterCreateTaskDevice(num_threads, allocator,
+                                              out_device);
+  }
+  return _TfLiteInterpreterCreateDefaultDevice(allocator, out_device);
+}
+
+//===----------------------------------------------------------------------===//
+// Process-wide shared devices
+//===----------------------------------------------------------------------===//
+
+// Maximum number of distinct thread counts with live shared devices.
+#define _TFLITE_MAX_SHARED_DEVICES 8
+
+// A device shared by all interpreters created with the same thread count.
+typedef struct {
+  int32_t num_threads;
+  // Number of interpreters using the device; the entry is free when 0.
+  iree_host_size_t use_count;
+  iree_hal_device_t* device;
+} _TfLiteSharedDevice;
+
+static iree_slim_mutex_t _TfLiteSharedDeviceMutex;
+static _TfLiteSharedDevice
+    _TfLiteSharedDevices[_TFLITE_MAX_SHARED_DEVICES] IREE_GUARDED_BY(
+        _TfLiteSharedDeviceMutex);
+
+static iree_once_flag _TfLiteSharedDeviceInitializeFlag = IREE_ONCE_FLAG_INIT;
+static void _TfLiteSharedDeviceInitialize(void) {
+  iree_slim_mutex_initialize(&_TfLiteSharedDeviceMutex);
+}
+
+// Returns a retained device shared with all other interpreters using
+// |num_threads|, creating it if this is the first user.
+static iree_status_t _TfLiteSharedDeviceAcquire(
+    int32_t num_threads, iree_hal_device_t** out_device) {
+  iree_call_once(&_TfLiteSharedDeviceInitializeFlag,
+                 _TfLiteSharedDeviceInitialize);
+  *out_device = NULL;
+
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&_TfLiteSharedDeviceMutex);
+  _TfLiteSharedDevice* free_entry = NULL;
+  for (iree_host_size_t i = 0; i < _TFLITE_MAX_SHARED_DEVICES; ++i) {
+    _TfLiteSharedDevice* entry = &_TfLiteSharedDevices[i];
+    if (entry->use_count == 0) {
+      if (!free_entry) free_entry = entry;
+    } else if (entry->num_threads == num_threads) {
+      *out_device = entry->device;
+      break;
+    }
+  }
+  if (*out_device) {
+    // Found an existing device; fall through to retain.
+  } else if (!free_entry) {
+    status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "at most %d shared devices may be live",
+                              _TFLITE_MAX_SHARED_DEVICES);
+  } else {
+    // Shared devices outlive the interpreter that created them so they use the
+    // system allocator instead of the interpreter one.
+    status = _TfLiteInterpreterCreateDevice(
+        num_threads, iree_allocator_system(), &free_entry->device);
+    if (iree_status_is_ok(status)) {
+      free_entry->num_threads = num_threads;
+      *out_device = free_entry->device;
+    }
+  }
+  if (*out_device) {
+    for (iree_host_size_t i = 0; i < _TFLITE_MAX_SHARED_DEVICES; ++i) {
+      if (_TfLiteSharedDevices[i].device == *out_device) {
+        ++_TfLiteSharedDevices[i].use_count;
+        break;
+      }
+    }
+    iree_hal_device_retain(*out_device);
+  }
+  iree_slim_mutex_unlock(&_TfLiteSharedDeviceMutex);
+  return status;
+}
+
+// Releases a device acquired with _TfLiteSharedDeviceAcquire. The device is
+// destroyed once the last interpreter using it has released it.
+static void _TfLiteSharedDeviceRelease(iree_hal_device_t* device) {
+  if (!device) return;
+  iree_hal_device_t* dead_device = NULL;
+  iree_slim_mutex_lock(&_TfLiteSharedDeviceMutex);
+  for (iree_host_size_t i = 0; i < _TFLITE_MAX_SHARED_DEVICES; ++i) {
+    _TfLiteSharedDevice* entry = &_TfLiteSharedDevices[i];
+    if (entry->use_count > 0 && entry->device == device) {
+      if (--entry->use_count == 0) {
+        dead_device = entry->device;
+        memset(entry, 0, sizeof(*entry));
+      }
+      break;
+    }
+  }
+  iree_slim_mutex_unlock(&_TfLiteSharedDeviceMutex);
+  // Device teardown joins worker threads so we do it outside of the lock.
+  iree_hal_device_release(dead_device);
+  iree_hal_device_release(device);
+}
+
+// TODO(#3977): if already provided a HAL device in the options use that.
+static iree_status_t _TfLiteInterpreterPrepareHAL(
+    TfLiteInterpreter* interpreter) {
+  if (interpreter->options.share_device) {
+    IREE_RETURN_IF_ERROR(_TfLiteSharedDeviceAcquire(
+        interpreter->options.num_threads, &interpreter->device));
+  } else {
+    IREE_RETURN_IF_ERROR(_TfLiteInterpreterCreateDevice(
+        interpreter->options.num_threads, interpreter->allocator,
+        &interpreter->device));
+  }
 
   IREE_RETURN_IF_ERROR(iree_hal_module_create(
       interpreter->instance, interpreter->device, IREE_HAL_MODULE_FLAG_NONE,
@@ -427,7 +588,11 @@ TFL_CAPI_EXPORT extern void TfLiteInterpreterDelete(
   iree_vm_context_release(interpreter->context);
   iree_vm_module_release(interpreter->hal_module);
   iree_vm_module_release(interpreter->user_module);
-  iree_hal_driver_release(interpreter->driver);
+  if (interpreter->options.share_device) {
+    _TfLiteSharedDeviceRelease(interpreter->device);
+  } else {
+    iree_hal_device_release(interpreter->device);
+  }
   iree_vm_instance_release(interpreter->instance);
 
   _TfLiteModelRelease(interpreter->model);
@@ -580,13 +745,18 @@ static iree_status_t _TfLiteInterpreterInvoke(TfLiteInterpreter* interpreter) {
                      /*policy=*/NULL, interpreter->input_list,
                      interpreter->output_list, interpreter->allocator));
 
-  // Refresh output shapes.
-  // TODO(#3975): just use buffer view results or at least just refresh outputs.
-  IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
+  // Refresh output shapes. Input shapes can only change with
+  // TfLiteInterpreterResizeInputTensor and are refreshed when the tensors are
+  // reallocated.
+  _TfLiteInterpreterShapeFrame frame;
+  IREE_RETURN_IF_ERROR(_TfLiteInterpreterShapeFrameInitialize(&frame));
+  iree_status_t status =
+      _TfLiteInterpreterRefreshOutputShapes(interpreter, &frame);
+  _TfLiteInterpreterShapeFrameDeinitialize(&frame);
+  IREE_RETURN_IF_ERROR(status);
 
-  // Map the output buffers.
-  // NOTE: we could defer the mapping unless requested and ensure state buffers
-  // remain where they currently are for the next invocation.
+  // Bind the output buffers. They are only mapped when the user accesses their
+  // data and outputs that come back unchanged keep their existing mapping.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
     iree_hal_buffer_t* buffer =
         iree_vm_list_get_buffer_assign(interpreter->output_list, i);
@@ -616,6 +786,37 @@ TFL_CAPI_EXPORT extern TfLiteStatus TfLiteInterpreterInvoke(
   return _TfLiteStatusFromIREEStatus(status);
 }
 
+// tflite indexes all tensors in the graph while only the I/O tensors are
+// visible here: indices [0, input_count) are the inputs followed by the
+// outputs. This matches the order the converter emits them in the model.
+static TfLiteTensor* _TfLiteInterpreterLookupTensor(
+    TfLiteInterpreter* interpreter, int tensor_index) {
+  if (tensor_index < 0) return NULL;
+  if (tensor_index < interpreter->model->input_count) {
+    return &interpreter->input_tensors[tensor_index];
+  }
+  tensor_index -= interpreter->model->input_count;
+  if (tensor_index < interpreter->model->output_count) {
+    return &interpreter->output_tensors[tensor_index];
+  }
+  return NULL;
+}
+
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  TfLiteTensor* tensor =
+      _TfLiteInterpreterLookupTensor(interpreter, tensor_index);
+  if (!tensor || !allocation) return kTfLiteError;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, allocation->bytes);
+  iree_status_t status =
+      _TfLiteTensorSetCustomAllocation(tensor, allocation, flags);
+  IREE_TRACE_ZONE_END(z0);
+  return _TfLiteStatusFromIREEStatus(status);
+}
+
 TFL_CAPI_EXPORT extern int32_t TfLiteInterpreterGetOutputTensorCount(
     const TfLiteInterpreter* interpreter) {
   return interpreter->model->output_count;
@@ -25,7 +25,8 @@ struct TfLiteInterpreter {
   TfLiteInterpreterOptions options;
 
   iree_vm_instance_t* instance;
-  iree_hal_driver_t* driver;
+  // Owned by the interpreter or by the shared device registry when
+  // options.share_device is set.
   iree_hal_device_t* device;
 
   union {
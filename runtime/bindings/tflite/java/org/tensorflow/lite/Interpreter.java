@@ -8,10 +8,14 @@
 
 package org.tensorflow.lite;
 
+import android.hardware.HardwareBuffer;
 import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
 import java.nio.Buffer;
 import java.nio.ByteBuffer;
+import java.util.ArrayList;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Map;
 
 /**
@@ -83,6 +87,22 @@ import java.util.Map;
  *  // Cleanup same as above.
  * }</pre>
  *
+ * <p>To avoid copying inputs and outputs on every inference, direct buffers can be bound to
+ * tensors with {@link #bindInputBuffer(int, Buffer)} and {@link #bindOutputBuffer(int, Buffer)}
+ * (allocated with {@link Tensor#allocateBuffer()} to meet the alignment requirements) or {@link
+ * HardwareBuffer}s with {@link #bindInputHardwareBuffer(int, HardwareBuffer)} and {@link
+ * #bindOutputHardwareBuffer(int, HardwareBuffer)}. The runtime then uses the bound memory in-place:
+ *
+ * <pre>{@code
+ *  ByteBuffer input = interpreter.getInputTensor(0).allocateBuffer();
+ *  ByteBuffer output = interpreter.getOutputTensor(0).allocateBuffer();
+ *  interpreter.bindInputBuffer(0, input);
+ *  interpreter.bindOutputBuffer(0, output);
+ *  ... populate input ...
+ *  interpreter.invoke();
+ *  ... process output ...
+ * }</pre>
+ *
  * <p>Orders of inputs and outputs are determined when converting TensorFlow
  * model to TensorFlow Lite model with TOCO, as are the default shapes of the
  * inputs.
@@ -246,18 +266,167 @@ public final class Interpreter implements AutoCloseable {
       getInputTensor(i).copyFromBuffer(inputs[i]);
     }
 
-    long inferenceStartNanos = System.nanoTime();
-    int status = nativeInvoke();
-    inferenceDurationNanoseconds = System.nanoTime() - inferenceStartNanos;
+    invoke();
+
+    for (Map.Entry<Integer, Buffer> output : outputs.entrySet()) {
+      getOutputTensor(output.getKey()).copyToBuffer(output.getValue());
+    }
+  }
+
+  /**
+   * Runs model inference on the current contents of the input tensors.
+   *
+   * <p>Bound input buffers are read and bound output buffers are written in-place; the contents of
+   * other tensors can be accessed with the {@link Tensor} copy methods. Hardware buffers are
+   * locked for CPU access for the duration of the call.
+   *
+   * @throws IllegalStateException if a hardware buffer cannot be locked or inference fails.
+   */
+  public void invoke() {
+    List<Tensor> lockedTensors = lockHardwareBuffers();
+    try {
+      if (!tensorsAllocated) {
+        allocateTensors();
+      }
+
+      long inferenceStartNanos = System.nanoTime();
+      int status = nativeInvoke();
+      inferenceDurationNanoseconds = System.nanoTime() - inferenceStartNanos;
+
+      if (status != 0) {
+        throw new IllegalStateException(
+            String.format("Failed to run Interpreter. Returned status code: %d", status));
+      }
+    } finally {
+      unlockHardwareBuffers(lockedTensors);
+    }
+  }
+
+  /**
+   * Binds a direct buffer to an input tensor so that inference reads it in-place.
+   *
+   * <p>The buffer must be in native {@link java.nio.ByteOrder}, match the size of the tensor, and
+   * be aligned to 64 bytes (see {@link Tensor#allocateBuffer()}). It must remain valid until it is
+   * unbound by passing {@code null} or the {@link Interpreter} is closed.
+   *
+   * @throws IllegalArgumentException if the buffer is not direct, of the wrong capacity, or
+   *     misaligned.
+   */
+  public void bindInputBuffer(int inputIndex, @Nullable Buffer buffer) {
+    bindBuffer(getInputTensor(inputIndex), inputIndex, buffer);
+  }
+
+  /**
+   * Binds a direct buffer to an output tensor so that inference writes it in-place.
+   *
+   * <p>See {@link #bindInputBuffer(int, Buffer)} for the buffer requirements.
+   *
+   * @throws IllegalArgumentException if the buffer is not direct, of the wrong capacity, or
+   *     misaligned.
+   */
+  public void bindOutputBuffer(int outputIndex, @Nullable Buffer buffer) {
+    bindBuffer(getOutputTensor(outputIndex), inputTensorCount + outputIndex, buffer);
+  }
 
+  /**
+   * Binds a {@link HardwareBuffer} to an input tensor so that inference reads it in-place.
+   *
+   * <p>The hardware buffer must have the {@link HardwareBuffer#BLOB} format, a width matching the
+   * size of the tensor in bytes, and {@link HardwareBuffer#USAGE_CPU_READ_OFTEN} usage. This allows
+   * a producer such as the camera or GPU to write directly into model inputs. Passing {@code null}
+   * unbinds the hardware buffer.
+   *
+   * @throws IllegalArgumentException if the hardware buffer has the wrong format or size.
+   */
+  public void bindInputHardwareBuffer(int inputIndex, @Nullable HardwareBuffer hardwareBuffer) {
+    bindHardwareBuffer(getInputTensor(inputIndex), hardwareBuffer);
+  }
+
+  /**
+   * Binds a {@link HardwareBuffer} to an output tensor so that inference writes it in-place.
+   *
+   * <p>See {@link #bindInputHardwareBuffer(int, HardwareBuffer)} for the hardware buffer
+   * requirements, except that {@link HardwareBuffer#USAGE_CPU_WRITE_OFTEN} usage is required.
+   *
+   * @throws IllegalArgumentException if the hardware buffer has the wrong format or size.
+   */
+  public void bindOutputHardwareBuffer(int outputIndex, @Nullable HardwareBuffer hardwareBuffer) {
+    bindHardwareBuffer(getOutputTensor(outputIndex), hardwareBuffer);
+  }
+
+  private void bindBuffer(Tensor tensor, int nativeTensorIndex, Buffer buffer) {
+    if (buffer != null) {
+      if (!tensor.isDirectBuffer(buffer)) {
+        throw new IllegalArgumentException("Only direct buffers can be bound to tensors.");
+      }
+      tensor.checkBufferCapacity(buffer);
+    }
+    tensor.boundHardwareBuffer = null;
+    int status = nativeSetCustomAllocation(nativeTensorIndex, buffer, tensor.numBytes());
     if (status != 0) {
-      throw new IllegalStateException(
-          String.format("Failed to run Interpreter. Returned status code: %d", status));
+      tensor.boundBuffer = null;
+      throw new IllegalArgumentException(
+          String.format("Unable to bind buffer to Tensor(%d); buffers must be 64 byte aligned. "
+                  + "Return code: %d",
+              tensor.index(), status));
     }
+    tensor.boundBuffer = buffer;
+    tensorsAllocated = false;
+  }
 
-    for (Map.Entry<Integer, Buffer> output : outputs.entrySet()) {
-      getOutputTensor(output.getKey()).copyToBuffer(output.getValue());
+  private void bindHardwareBuffer(Tensor tensor, HardwareBuffer hardwareBuffer) {
+    if (hardwareBuffer != null
+        && (hardwareBuffer.getFormat() != HardwareBuffer.BLOB
+            || hardwareBuffer.getWidth() != tensor.numBytes())) {
+      throw new IllegalArgumentException(String.format(
+          "Hardware buffers bound to Tensor(%d) must be BLOBs of %d bytes", tensor.index(),
+          tensor.numBytes()));
     }
+    if (tensor.boundBuffer != null) {
+      bindBuffer(tensor, nativeTensorIndexOf(tensor), null);
+    }
+    // The hardware buffer is only locked and bound natively while invoking.
+    tensor.boundHardwareBuffer = hardwareBuffer;
+  }
+
+  // Returns the index of the tensor in the native interpreter, where outputs follow inputs.
+  private int nativeTensorIndexOf(Tensor tensor) {
+    int index = tensor.index();
+    boolean isInput = index < inputTensorCount && inputTensors[index] == tensor;
+    return isInput ? index : inputTensorCount + index;
+  }
+
+  private List<Tensor> lockHardwareBuffers() {
+    List<Tensor> lockedTensors = new ArrayList<>();
+    lockHardwareBuffers(inputTensors, /*isInput=*/true, lockedTensors);
+    lockHardwareBuffers(outputTensors, /*isInput=*/false, lockedTensors);
+    return lockedTensors;
+  }
+
+  private void lockHardwareBuffers(Tensor[] tensors, boolean isInput, List<Tensor> lockedTensors) {
+    for (Tensor tensor : tensors) {
+      if (tensor == null || tensor.boundHardwareBuffer == null) {
+        continue;
+      }
+      int status = nativeLockHardwareBuffer(
+          nativeTensorIndexOf(tensor), tensor.boundHardwareBuffer, isInput);
+      if (status != 0) {
+        unlockHardwareBuffers(lockedTensors);
+        throw new IllegalStateException(String.format(
+            "Unable to lock hardware buffer for Tensor(%d). Return code: %d", tensor.index(),
+            status));
+      }
+      lockedTensors.add(tensor);
+      tensorsAllocated = false;
+    }
+  }
+
+  private void unlockHardwareBuffers(List<Tensor> lockedTensors) {
+    for (Tensor tensor : lockedTensors) {
+      nativeUnlockHardwareBuffer(nativeTensorIndexOf(tensor), tensor.boundHardwareBuffer);
+      tensorsAllocated = false;
+    }
+    lockedTensors.clear();
   }
 
   /**
@@ -402,4 +571,12 @@ public final class Interpreter implements AutoCloseable {
   private native int nativeResizeInputTensor(int inputIndex, int[] dims);
 
   private native int nativeInvoke();
+
+  private native int nativeSetCustomAllocation(
+      int tensorIndex, Buffer directBuffer, int byteSize);
+
+  private native int nativeLockHardwareBuffer(
+      int tensorIndex, HardwareBuffer hardwareBuffer, boolean isInput);
+
+  private native int nativeUnlockHardwareBuffer(int tensorIndex, HardwareBuffer hardwareBuffer);
 }
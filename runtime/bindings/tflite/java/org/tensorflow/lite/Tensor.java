@@ -8,6 +8,7 @@
 
 package org.tensorflow.lite;
 
+import android.hardware.HardwareBuffer;
 import java.nio.Buffer;
 import java.nio.ByteBuffer;
 import java.nio.ByteOrder;
@@ -25,6 +26,9 @@ import java.nio.LongBuffer;
 public final class Tensor {
   private static final String TAG = Tensor.class.getCanonicalName();
 
+  // Alignment required of bound buffers; matches tflite's kDefaultTensorAlignment.
+  private static final int BUFFER_ALIGNMENT = 64;
+
   static Tensor inputFromIndex(long nativeInterpreterHandle, int tensorIndex) {
     long nativeAddress = nativeCreateInput(nativeInterpreterHandle, tensorIndex);
     if (nativeAddress == 0) {
@@ -162,7 +166,25 @@ public final class Tensor {
     return quantizationParams;
   }
 
+  /**
+   * Allocates a direct, native {@link ByteOrder} buffer with the size and alignment required to
+   * bind it to this tensor with {@link Interpreter#bindInputBuffer(int, Buffer)} or {@link
+   * Interpreter#bindOutputBuffer(int, Buffer)}.
+   */
+  public ByteBuffer allocateBuffer() {
+    int numBytes = numBytes();
+    ByteBuffer buffer = ByteBuffer.allocateDirect(numBytes + BUFFER_ALIGNMENT - 1);
+    long address = nativeDirectBufferAddress(buffer);
+    int offset = (int) ((BUFFER_ALIGNMENT - (address % BUFFER_ALIGNMENT)) % BUFFER_ALIGNMENT);
+    buffer.position(offset);
+    buffer.limit(offset + numBytes);
+    return buffer.slice().order(ByteOrder.nativeOrder());
+  }
+
   void copyFromBuffer(Buffer inputBuffer) {
+    if (boundBuffer != null && inputBuffer == boundBuffer) {
+      return;  // Already used in-place by the tensor.
+    }
     checkBufferCapacity(inputBuffer);
     if (isDirectBuffer(inputBuffer)) {
       copyFromDirectBuffer(inputBuffer);
@@ -183,6 +205,9 @@ public final class Tensor {
   }
 
   void copyToBuffer(Buffer outputBuffer) {
+    if (boundBuffer != null && outputBuffer == boundBuffer) {
+      return;  // Already written in-place by the tensor.
+    }
     checkBufferCapacity(outputBuffer);
     if (isDirectBuffer(outputBuffer)) {
       copyToDirectBuffer(outputBuffer);
@@ -202,7 +227,7 @@ public final class Tensor {
     }
   }
 
-  private boolean isDirectBuffer(Buffer object) {
+  boolean isDirectBuffer(Buffer object) {
     if (object instanceof ByteBuffer) {
       ByteBuffer buffer = (ByteBuffer) object;
       return buffer.isDirect();
@@ -222,7 +247,7 @@ public final class Tensor {
     return false;
   }
 
-  private void checkBufferCapacity(Buffer otherBuffer) {
+  void checkBufferCapacity(Buffer otherBuffer) {
     int numBytes = numBytes();
     int otherBytes = otherBuffer.capacity();
     // Non ByteBuffers report capacity based on the number of elements rather raw bytes.
@@ -265,6 +290,11 @@ public final class Tensor {
     return nativeGetByteBuffer().order(ByteOrder.nativeOrder());
   }
 
+  // Direct buffer or hardware buffer bound by the Interpreter, if any. The tensor reads or writes
+  // the bound memory in-place instead of copying through its own storage.
+  Buffer boundBuffer;
+  HardwareBuffer boundHardwareBuffer;
+
   private final long nativeAddress;
   private final int tensorIndex;
   private final QuantizationParams quantizationParams;
@@ -301,4 +331,6 @@ public final class Tensor {
   private native int nativeCopyToDirectBuffer(Buffer outputByteBuffer);
 
   private native ByteBuffer nativeGetByteBuffer();
+
+  private static native long nativeDirectBufferAddress(Buffer directBuffer);
 }
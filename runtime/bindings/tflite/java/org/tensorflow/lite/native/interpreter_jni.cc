@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <android/hardware_buffer.h>
+#include <android/hardware_buffer_jni.h>
 #include <jni.h>
 
 #include "iree/base/api.h"
@@ -11,6 +13,7 @@
 // NOTE: we pull in our own copy here in case the tflite API changes upstream.
 #define TFL_COMPILE_LIBRARY 1
 #include "runtime/bindings/tflite/include/tensorflow/lite/c/c_api.h"
+#include "runtime/bindings/tflite/include/tensorflow/lite/c/c_api_experimental.h"
 
 #define JNI_FUNC extern "C" JNIEXPORT
 #define JNI_PREFIX(METHOD) Java_org_tensorflow_lite_Interpreter_##METHOD
@@ -111,3 +114,97 @@ JNI_FUNC jint JNI_PREFIX(nativeInvoke)(JNIEnv* env, jobject thiz) {
 
   return (jint)TfLiteInterpreterInvoke(interpreter);
 }
+
+JNI_FUNC jint JNI_PREFIX(nativeSetCustomAllocation)(JNIEnv* env, jobject thiz,
+                                                    jint tensor_index,
+                                                    jobject direct_buffer,
+                                                    jint byte_size) {
+  TfLiteInterpreter* interpreter = GetInterpreter(env, thiz);
+  if (!interpreter) {
+    return kTfLiteError;  // Failed get handle. Returning to error in Java.
+  }
+
+  // A null buffer clears the allocation and the tensor goes back to using
+  // runtime-allocated memory.
+  TfLiteCustomAllocation allocation = {nullptr, 0};
+  if (direct_buffer) {
+    allocation.data = env->GetDirectBufferAddress(direct_buffer);
+    if (!allocation.data) {
+      return kTfLiteError;  // Not a direct buffer.
+    }
+    // Note: We're using the tensor size rather than the buffer size since non
+    // ByteBuffer direct buffers missreport capacity based on the data type.
+    // This relies on proper capacity checks in Java.
+    allocation.bytes = static_cast<size_t>(byte_size);
+  }
+  return (jint)TfLiteInterpreterSetCustomAllocationForTensor(
+      interpreter, tensor_index, &allocation,
+      kTfLiteCustomAllocationFlagsNone);
+}
+
+JNI_FUNC jint JNI_PREFIX(nativeLockHardwareBuffer)(JNIEnv* env, jobject thiz,
+                                                   jint tensor_index,
+                                                   jobject hardware_buffer,
+                                                   jboolean is_input) {
+  TfLiteInterpreter* interpreter = GetInterpreter(env, thiz);
+  if (!interpreter) {
+    return kTfLiteError;  // Failed get handle. Returning to error in Java.
+  }
+  AHardwareBuffer* ahardware_buffer =
+      AHardwareBuffer_fromHardwareBuffer(env, hardware_buffer);
+  if (!ahardware_buffer) {
+    return kTfLiteError;
+  }
+
+  // Only linear BLOB buffers have a byte layout matching tensors; image
+  // formats have implementation-defined strides and tiling.
+  AHardwareBuffer_Desc desc;
+  AHardwareBuffer_describe(ahardware_buffer, &desc);
+  if (desc.format != AHARDWAREBUFFER_FORMAT_BLOB) {
+    return kTfLiteError;
+  }
+
+  // Locking waits for any pending producer (camera, GPU, etc) to finish
+  // writing and returns the CPU address of the buffer memory. The local HAL
+  // devices then access that memory in-place during the invocation.
+  uint64_t usage = is_input ? AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN
+                            : AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN;
+  void* data = nullptr;
+  if (AHardwareBuffer_lock(ahardware_buffer, usage, /*fence=*/-1,
+                           /*rect=*/nullptr, &data) != 0) {
+    return kTfLiteError;
+  }
+
+  TfLiteCustomAllocation allocation = {data, desc.width};
+  TfLiteStatus status = TfLiteInterpreterSetCustomAllocationForTensor(
+      interpreter, tensor_index, &allocation,
+      kTfLiteCustomAllocationFlagsNone);
+  if (status != kTfLiteOk) {
+    AHardwareBuffer_unlock(ahardware_buffer, /*fence=*/nullptr);
+  }
+  return (jint)status;
+}
+
+JNI_FUNC jint JNI_PREFIX(nativeUnlockHardwareBuffer)(JNIEnv* env, jobject thiz,
+                                                     jint tensor_index,
+                                                     jobject hardware_buffer) {
+  TfLiteInterpreter* interpreter = GetInterpreter(env, thiz);
+  if (!interpreter) {
+    return kTfLiteError;  // Failed get handle. Returning to error in Java.
+  }
+  AHardwareBuffer* ahardware_buffer =
+      AHardwareBuffer_fromHardwareBuffer(env, hardware_buffer);
+  if (!ahardware_buffer) {
+    return kTfLiteError;
+  }
+
+  // Drop the tensor's reference to the locked memory before unlocking it.
+  TfLiteCustomAllocation allocation = {nullptr, 0};
+  TfLiteStatus status = TfLiteInterpreterSetCustomAllocationForTensor(
+      interpreter, tensor_index, &allocation,
+      kTfLiteCustomAllocationFlagsNone);
+  if (AHardwareBuffer_unlock(ahardware_buffer, /*fence=*/nullptr) != 0) {
+    status = kTfLiteError;
+  }
+  return (jint)status;
+}
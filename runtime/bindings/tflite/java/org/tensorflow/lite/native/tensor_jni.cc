@@ -162,3 +162,8 @@ JNI_FUNC jobject JNI_PREFIX(nativeGetByteBuffer)(JNIEnv* env, jobject thiz) {
       static_cast<void*>(TfLiteTensorData(tensor)),
       static_cast<jlong>(TfLiteTensorByteSize(tensor)));
 }
+
+JNI_FUNC jlong JNI_PREFIX(nativeDirectBufferAddress)(JNIEnv* env, jclass clazz,
+                                                     jobject direct_buffer) {
+  return reinterpret_cast<jlong>(env->GetDirectBufferAddress(direct_buffer));
+}
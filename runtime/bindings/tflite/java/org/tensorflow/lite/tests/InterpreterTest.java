@@ -69,6 +69,32 @@ public final class InterpreterTest {
     }
   }
 
+  @Test
+  public void testBoundBuffers() throws Exception {
+    Context context = ApplicationProvider.getApplicationContext();
+    Resources resources = context.getResources();
+    InputStream moduleInputStream = resources.openRawResource(R.raw.simple_add_bytecode_module);
+    ByteBuffer moduleByteBuffer = convertInputStreamToByteBuffer(moduleInputStream);
+
+    try (Interpreter interpreter = new Interpreter(moduleByteBuffer, new Options())) {
+      interpreter.allocateTensors();
+      FloatBuffer inputBuffer = interpreter.getInputTensor(0).allocateBuffer().asFloatBuffer();
+      FloatBuffer outputBuffer = interpreter.getOutputTensor(0).allocateBuffer().asFloatBuffer();
+      interpreter.bindInputBuffer(0, inputBuffer);
+      interpreter.bindOutputBuffer(0, outputBuffer);
+
+      // Bound buffers are used in-place across multiple invocations.
+      inputBuffer.put(0, 1).put(1, 3);
+      interpreter.invoke();
+      assertArrayEquals(
+          new float[] {2, 6}, new float[] {outputBuffer.get(0), outputBuffer.get(1)}, EPSILON);
+      inputBuffer.put(0, 5).put(1, 7);
+      interpreter.run(inputBuffer, outputBuffer);
+      assertArrayEquals(
+          new float[] {10, 14}, new float[] {outputBuffer.get(0), outputBuffer.get(1)}, EPSILON);
+    }
+  }
+
   private static FloatBuffer allocateNativeFloatBuffer(int floatLength) {
     return ByteBuffer.allocateDirect(BYTES_IN_FLOAT * floatLength)
         .order(ByteOrder.nativeOrder())
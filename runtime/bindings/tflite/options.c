@@ -49,6 +49,14 @@ TFL_CAPI_EXPORT extern void TfLiteInterpreterOptionsSetNumThreads(
   IREE_TRACE_ZONE_END(z0);
 }
 
+TFL_CAPI_EXPORT extern void TfLiteInterpreterOptionsSetIREEShareDevice(
+    TfLiteInterpreterOptions* options, bool enable) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, enable);
+  options->share_device = enable;
+  IREE_TRACE_ZONE_END(z0);
+}
+
 TFL_CAPI_EXPORT extern void TfLiteInterpreterOptionsAddDelegate(
     TfLiteInterpreterOptions* options, TfLiteDelegate* delegate) {
   IREE_TRACE_ZONE_BEGIN(z0);
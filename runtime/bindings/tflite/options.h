@@ -20,6 +20,10 @@ struct TfLiteInterpreterOptions {
   void (*reporter)(void* user_data, const char* format, va_list args);
   void* reporter_user_data;
 
+  // Whether interpreters with the same num_threads share a process-wide device
+  // (and its task executor) instead of each creating their own.
+  bool share_device;
+
   // TODO(#3977): an existing iree_hal_device_t to use for the HAL.
 };
 
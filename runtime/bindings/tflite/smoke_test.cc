@@ -30,6 +30,7 @@ limitations under the License.
 // NOTE: we pull in our own copy here in case the tflite API changes upstream.
 #define TFL_COMPILE_LIBRARY 1
 #include "runtime/bindings/tflite/include/tensorflow/lite/c/c_api.h"
+#include "runtime/bindings/tflite/include/tensorflow/lite/c/c_api_experimental.h"
 
 // Test model is available both on the filesystem and here for embedding testing
 // embedding the module directly in a binary.
@@ -214,6 +215,113 @@ TEST(CApiSimple, StaticSmoke) {
   TfLiteInterpreterDelete(interpreter);
 }
 
+// Interpreters opting into device sharing run on the same executor and must
+// still produce independent results.
+TEST(CApiSimple, StaticSharedDevice) {
+  TfLiteModel* model =
+      TfLiteModelCreate(IREE_BINDINGS_TFLITE_TESTDATA_ADD_STATIC_EMBEDDED_DATA,
+                        IREE_BINDINGS_TFLITE_TESTDATA_ADD_STATIC_EMBEDDED_SIZE);
+  ASSERT_NE(model, nullptr);
+
+  TfLiteInterpreterOptions* options = TfLiteInterpreterOptionsCreate();
+  ASSERT_NE(options, nullptr);
+  TfLiteInterpreterOptionsSetNumThreads(options, 2);
+  TfLiteInterpreterOptionsSetIREEShareDevice(options, true);
+
+  std::array<TfLiteInterpreter*, 2> interpreters;
+  for (size_t i = 0; i < interpreters.size(); ++i) {
+    interpreters[i] = TfLiteInterpreterCreate(model, options);
+    ASSERT_NE(interpreters[i], nullptr);
+    ASSERT_EQ(TfLiteInterpreterAllocateTensors(interpreters[i]), kTfLiteOk);
+  }
+  TfLiteInterpreterOptionsDelete(options);
+  TfLiteModelDelete(model);
+
+  for (size_t i = 0; i < interpreters.size(); ++i) {
+    std::array<float, 1 * 8 * 8 * 3> input = {
+        1.f + i,
+        3.f + i,
+    };
+    ASSERT_EQ(TfLiteTensorCopyFromBuffer(
+                  TfLiteInterpreterGetInputTensor(interpreters[i], 0),
+                  input.data(), input.size() * sizeof(float)),
+              kTfLiteOk);
+    ASSERT_EQ(TfLiteInterpreterInvoke(interpreters[i]), kTfLiteOk);
+  }
+
+  for (size_t i = 0; i < interpreters.size(); ++i) {
+    std::array<float, 1 * 8 * 8 * 3> output;
+    ASSERT_EQ(TfLiteTensorCopyToBuffer(
+                  TfLiteInterpreterGetOutputTensor(interpreters[i], 0),
+                  output.data(), output.size() * sizeof(float)),
+              kTfLiteOk);
+    EXPECT_EQ(output[0], 2.f * (1.f + i));
+    EXPECT_EQ(output[1], 2.f * (3.f + i));
+  }
+
+  // Deleting the first interpreter must not tear down the shared device.
+  TfLiteInterpreterDelete(interpreters[0]);
+  ASSERT_EQ(TfLiteInterpreterInvoke(interpreters[1]), kTfLiteOk);
+  TfLiteInterpreterDelete(interpreters[1]);
+}
+
+// Binds user memory to the I/O tensors with the experimental API. Tensor
+// indices 0 and 1 are the input and output of the model.
+TEST(CApiSimple, StaticCustomAllocation) {
+  TfLiteModel* model =
+      TfLiteModelCreate(IREE_BINDINGS_TFLITE_TESTDATA_ADD_STATIC_EMBEDDED_DATA,
+                        IREE_BINDINGS_TFLITE_TESTDATA_ADD_STATIC_EMBEDDED_SIZE);
+  ASSERT_NE(model, nullptr);
+  TfLiteInterpreter* interpreter = TfLiteInterpreterCreate(model, nullptr);
+  ASSERT_NE(interpreter, nullptr);
+  TfLiteModelDelete(model);
+
+  alignas(64) std::array<float, 1 * 8 * 8 * 3> input = {
+      1.f,
+      3.f,
+  };
+  alignas(64) std::array<float, 1 * 8 * 8 * 3> output;
+  TfLiteCustomAllocation input_allocation = {input.data(),
+                                             input.size() * sizeof(float)};
+  TfLiteCustomAllocation output_allocation = {output.data(),
+                                              output.size() * sizeof(float)};
+  ASSERT_EQ(TfLiteInterpreterSetCustomAllocationForTensor(
+                interpreter, 0, &input_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteOk);
+  ASSERT_EQ(TfLiteInterpreterSetCustomAllocationForTensor(
+                interpreter, 1, &output_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteOk);
+  ASSERT_EQ(TfLiteInterpreterAllocateTensors(interpreter), kTfLiteOk);
+
+  TfLiteTensor* input_tensor = TfLiteInterpreterGetInputTensor(interpreter, 0);
+  ASSERT_NE(input_tensor, nullptr);
+  EXPECT_EQ(TfLiteTensorData(input_tensor), input.data());
+
+  // Results are written to the user memory on each invocation.
+  ASSERT_EQ(TfLiteInterpreterInvoke(interpreter), kTfLiteOk);
+  EXPECT_EQ(output[0], 2.f);
+  EXPECT_EQ(output[1], 6.f);
+  input[0] = 2.f;
+  ASSERT_EQ(TfLiteInterpreterInvoke(interpreter), kTfLiteOk);
+  EXPECT_EQ(output[0], 4.f);
+  const TfLiteTensor* output_tensor =
+      TfLiteInterpreterGetOutputTensor(interpreter, 0);
+  ASSERT_NE(output_tensor, nullptr);
+  EXPECT_EQ(TfLiteTensorData(output_tensor), output.data());
+
+  // Allocations smaller than the tensor are rejected.
+  TfLiteCustomAllocation small_allocation = {input.data(), sizeof(float)};
+  ASSERT_EQ(TfLiteInterpreterSetCustomAllocationForTensor(
+                interpreter, 0, &small_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteOk);
+  EXPECT_NE(TfLiteInterpreterAllocateTensors(interpreter), kTfLiteOk);
+
+  TfLiteInterpreterDelete(interpreter);
+}
+
 // TODO(#3971): fix cmake data deps.
 // TODO(#3972): plumb through quantization params.
 TEST(CApiSimple, DISABLED_QuantizationParams) {
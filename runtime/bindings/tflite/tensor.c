@@ -133,69 +133,125 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
     IREE_TRACE_ZONE_END(z0);
     return iree_ok_status();
   }
+  _TfLiteTensorDiscardBuffer(tensor);
 
-  // Allocate the underlying buffer for the tensor.
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_allocator_allocate_buffer(
-              buffer_allocator,
-              (iree_hal_buffer_params_t){
-                  .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
-                          IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
-                  .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
-                           IREE_HAL_BUFFER_USAGE_TRANSFER |
-                           IREE_HAL_BUFFER_USAGE_MAPPING,
-              },
-              allocation_size, iree_const_byte_span_empty(), &tensor->buffer));
-
-  // Map the buffer memory immediately. The tflite API doesn't let us know if
-  // this is a buffer the user will actually touch or some state buffer that is
-  // just going to be passed to future invocations. We could move this to an
-  // on-demand mapping when the user calls TfLiteTensorData but this at least
-  // puts potential errors in the same easy to find place.
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_hal_buffer_map_range(tensor->buffer, IREE_HAL_MAPPING_MODE_SCOPED,
-                                IREE_HAL_MEMORY_ACCESS_ALL, 0,
-                                IREE_WHOLE_BUFFER, &tensor->buffer_mapping));
+  iree_hal_buffer_params_t params = {
+      .type =
+          IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+               IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  iree_status_t status = iree_ok_status();
+  if (tensor->custom_allocation.data) {
+    // Wrap the user memory so that it is passed to the module without copies.
+    // The allocator picks the import mode (direct access, host-visible
+    // mapping, etc) best supported by the device.
+    if (tensor->custom_allocation.bytes < allocation_size) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "custom allocation of %" PRIhsz
+          " bytes is too small for the tensor (needs %" PRIdsz " bytes)",
+          tensor->custom_allocation.bytes, allocation_size);
+    }
+    if (iree_status_is_ok(status)) {
+      iree_hal_external_buffer_t external_buffer = {
+          .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+          .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+          .size = allocation_size,
+          .handle.host_allocation.ptr = tensor->custom_allocation.data,
+      };
+      params.type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+      status = iree_hal_allocator_import_buffer(
+          buffer_allocator, params, &external_buffer,
+          iree_hal_buffer_release_callback_null(), &tensor->buffer);
+    }
+  } else {
+    status = iree_hal_allocator_allocate_buffer(
+        buffer_allocator, params, allocation_size,
+        iree_const_byte_span_empty(), &tensor->buffer);
+  }
+
+  // NOTE: the buffer is mapped on first access by TfLiteTensorData or the copy
+  // functions. State buffers that are only passed to future invocations are
+  // never mapped.
 
   IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Maps the tensor buffer if it has not already been mapped.
+// The mapping is retained until the buffer is discarded so that repeated
+// accesses to an unchanged buffer are free.
+static iree_status_t _TfLiteTensorMapIfNeeded(TfLiteTensor* tensor) {
+  if (!tensor->buffer || tensor->buffer_mapping.contents.data != NULL) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // The tflite API doesn't let us know if this should be read or read/write.
+  iree_status_t status = iree_hal_buffer_map_range(
+      tensor->buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+      IREE_WHOLE_BUFFER, &tensor->buffer_mapping);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t _TfLiteTensorSetCustomAllocation(
+    TfLiteTensor* tensor, const TfLiteCustomAllocation* allocation,
+    int64_t flags) {
+  // This matches the kDefaultTensorAlignment tflite requires.
+  if (allocation->data &&
+      !(flags & kTfLiteCustomAllocationFlagsSkipAlignCheck) &&
+      !iree_host_size_has_alignment((iree_host_size_t)allocation->data, 64)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "custom allocation %p must be 64 byte aligned",
+                            allocation->data);
+  }
+  _TfLiteTensorDiscardBuffer(tensor);
+  tensor->custom_allocation = *allocation;
   return iree_ok_status();
 }
 
 iree_status_t _TfLiteTensorBind(TfLiteTensor* tensor,
                                 iree_hal_buffer_t* buffer) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  _TfLiteTensorDiscardBuffer(tensor);
-  if (!buffer) {
-    // Just a discard (invalid output/etc).
-    IREE_TRACE_ZONE_END(z0);
-    return iree_ok_status();
-  }
 
-  // Attempt to map the buffer. The tflite API doesn't let us know if this
-  // should be read or read/write - or if we even need to map at all. We could
-  // move this to an on-demand mapping when the user calls TfLiteTensorData but
-  // this at least puts potential errors in the same easy to find place.
-  iree_device_size_t byte_offset = 0;
-  iree_device_size_t byte_length = IREE_WHOLE_BUFFER;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_buffer_map_range(
-              buffer, IREE_HAL_MAPPING_MODE_SCOPED,
-              IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE,
-              byte_offset, byte_length, &tensor->buffer_mapping));
+  // If the invocation produced the same buffer as last time (state buffers,
+  // caching allocators, etc) the existing mapping remains valid.
+  if (buffer != tensor->buffer) {
+    _TfLiteTensorDiscardBuffer(tensor);
+    // Retain the buffer until discarded/reset. A NULL buffer is just a
+    // discard (invalid output/etc).
+    tensor->buffer = buffer;
+    iree_hal_buffer_retain(tensor->buffer);
+  }
 
-  // Retain the buffer view until discarded/reset.
-  tensor->buffer = buffer;
-  iree_hal_buffer_retain(tensor->buffer);
+  iree_status_t status = iree_ok_status();
+  if (buffer && tensor->custom_allocation.data) {
+    iree_device_size_t byte_length = iree_hal_buffer_byte_length(buffer);
+    if (byte_length > tensor->custom_allocation.bytes) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "custom allocation of %" PRIhsz
+          " bytes is too small for the output (needs %" PRIdsz " bytes)",
+          tensor->custom_allocation.bytes, byte_length);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_read(
+          buffer, 0, tensor->custom_allocation.data, byte_length);
+    }
+  }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 void _TfLiteTensorDiscardBuffer(TfLiteTensor* tensor) {
   IREE_TRACE_ZONE_BEGIN(z0);
   if (tensor->buffer_mapping.contents.data != NULL) {
     iree_hal_buffer_unmap_range(&tensor->buffer_mapping);
+    memset(&tensor->buffer_mapping, 0, sizeof(tensor->buffer_mapping));
   }
   iree_hal_buffer_release(tensor->buffer);
   tensor->buffer = NULL;
@@ -227,6 +283,16 @@ TFL_CAPI_EXPORT extern size_t TfLiteTensorByteSize(const TfLiteTensor* tensor) {
 }
 
 TFL_CAPI_EXPORT extern void* TfLiteTensorData(const TfLiteTensor* tensor) {
+  if (tensor->custom_allocation.data) {
+    return tensor->custom_allocation.data;
+  }
+  // The mapping is a cache of the buffer contents and not part of the
+  // observable tensor state.
+  iree_status_t status = _TfLiteTensorMapIfNeeded((TfLiteTensor*)tensor);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
   return tensor->buffer_mapping.contents.data;
 }
 
@@ -242,36 +308,53 @@ TFL_CAPI_EXPORT extern TfLiteQuantizationParams TfLiteTensorQuantizationParams(
 
 TFL_CAPI_EXPORT extern TfLiteStatus TfLiteTensorCopyFromBuffer(
     TfLiteTensor* tensor, const void* input_data, size_t input_data_size) {
-  if (input_data_size != tensor->buffer_mapping.contents.data_length) {
+  if (!tensor->buffer ||
+      input_data_size != iree_hal_buffer_byte_length(tensor->buffer)) {
     return kTfLiteApplicationError;
   }
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE(z0, tensor->buffer_mapping.contents.data_length);
-
-  // NOTE: we could use a iree_hal_buffer_map_write here but we already
-  // have the buffer mapped. If we knew the user would never use
-  // TfLiteTensorData and could avoid mapping the buffer it would be more
-  // efficient and portable to do the iree_hal_buffer_map_copy.
-  memcpy(tensor->buffer_mapping.contents.data, input_data, input_data_size);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, input_data_size);
+
+  // Copy directly if the user memory is already the tensor storage or the user
+  // has mapped it. Otherwise a transient mapping is cheaper on devices where
+  // persistent host mappings are expensive to maintain.
+  iree_status_t status = iree_ok_status();
+  void* data = tensor->custom_allocation.data
+                   ? tensor->custom_allocation.data
+                   : tensor->buffer_mapping.contents.data;
+  if (data) {
+    memcpy(data, input_data, input_data_size);
+  } else {
+    status = iree_hal_buffer_map_write(tensor->buffer, 0, input_data,
+                                       input_data_size);
+  }
 
   IREE_TRACE_ZONE_END(z0);
-  return kTfLiteOk;
+  return _TfLiteStatusFromIREEStatus(status);
 }
 
 TFL_CAPI_EXPORT extern TfLiteStatus TfLiteTensorCopyToBuffer(
     const TfLiteTensor* output_tensor, void* output_data,
     size_t output_data_size) {
-  if (output_data_size != output_tensor->buffer_mapping.contents.data_length) {
+  if (!output_tensor->buffer ||
+      output_data_size != iree_hal_buffer_byte_length(output_tensor->buffer)) {
     return kTfLiteApplicationError;
   }
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE(
-      z0, output_tensor->buffer_mapping.contents.data_length);
-
-  // NOTE: as with above we should use an iree_hal_buffer_map_read here.
-  memcpy(output_data, output_tensor->buffer_mapping.contents.data,
-         output_data_size);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, output_data_size);
+
+  // NOTE: as with above we only use the mapping if it already exists.
+  iree_status_t status = iree_ok_status();
+  const void* data = output_tensor->custom_allocation.data
+                         ? output_tensor->custom_allocation.data
+                         : output_tensor->buffer_mapping.contents.data;
+  if (data) {
+    memcpy(output_data, data, output_data_size);
+  } else {
+    status = iree_hal_buffer_map_read(output_tensor->buffer, 0, output_data,
+                                      output_data_size);
+  }
 
   IREE_TRACE_ZONE_END(z0);
-  return kTfLiteOk;
+  return _TfLiteStatusFromIREEStatus(status);
 }
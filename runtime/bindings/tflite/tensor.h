@@ -36,8 +36,14 @@ struct TfLiteTensor {
 
   // Allocated buffer view referencing the backing tensor memory.
   iree_hal_buffer_t* buffer;
-  // Persistently mapped buffer; invalidated when buffer is resized.
+  // Mapping of the buffer established on first access to the tensor data and
+  // retained until the buffer is discarded. contents.data is NULL if unmapped.
   iree_hal_buffer_mapping_t buffer_mapping;
+
+  // User memory set with TfLiteInterpreterSetCustomAllocationForTensor, if
+  // any. Input buffers are imported from the allocation and outputs are read
+  // back into it after each invocation. data is NULL if unset.
+  TfLiteCustomAllocation custom_allocation;
 };
 
 // Parses a tfl.io.names value and sets the |tensor| name.
@@ -53,15 +59,24 @@ iree_status_t _TfLiteTensorParseTypeAttr(TfLiteTensor* tensor,
 iree_status_t _TfLiteTensorParseQuantAttr(TfLiteTensor* tensor,
                                           iree_string_view_t attr);
 
-// Reallocates and remaps the tensor buffer view if needed.
-// No-op if the buffer view is already allocated and its shape matches the
-// current tensor shape.
+// Sets the user-owned |allocation| backing the tensor. The current buffer is
+// discarded and will be imported from the allocation by the next
+// _TfLiteTensorReallocateIfNeeded. A NULL |allocation| data pointer reverts
+// the tensor to runtime-allocated memory.
+iree_status_t _TfLiteTensorSetCustomAllocation(
+    TfLiteTensor* tensor, const TfLiteCustomAllocation* allocation,
+    int64_t flags);
+
+// Reallocates (or imports the custom allocation of) the tensor buffer if
+// needed. No-op if the buffer is already allocated and its size matches the
+// current tensor shape. The buffer is only mapped once its data is accessed.
 iree_status_t _TfLiteTensorReallocateIfNeeded(
     TfLiteTensor* tensor, iree_hal_allocator_t* buffer_allocator,
     iree_allocator_t heap_allocator);
 
-// Binds the given |buffer| to the tensor and maps it.
-// The tensor shape will be overwritten with the buffer view shape.
+// Binds the given |buffer| to the tensor. Rebinding the buffer that is
+// already bound retains its mapping. If the tensor has a custom allocation the
+// buffer contents are read back into it.
 iree_status_t _TfLiteTensorBind(TfLiteTensor* tensor,
                                 iree_hal_buffer_t* buffer);
 
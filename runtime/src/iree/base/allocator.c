@@ -63,6 +63,19 @@ IREE_API_EXPORT void iree_allocator_free(iree_allocator_t allocator,
   }
 }
 
+IREE_API_EXPORT iree_status_t iree_allocator_query_statistics(
+    iree_allocator_t allocator, iree_allocator_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  if (IREE_UNLIKELY(!allocator.ctl)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocator has no control routine");
+  }
+  void* ptr = out_statistics;
+  return allocator.ctl(allocator.self, IREE_ALLOCATOR_COMMAND_QUERY_STATISTICS,
+                       /*params=*/NULL, &ptr);
+}
+
 static iree_status_t iree_allocator_system_alloc(
     iree_allocator_command_t command,
     const iree_allocator_alloc_params_t* params, void** inout_ptr) {
@@ -167,6 +167,14 @@ typedef enum iree_allocator_command_e {
   //   inout_ptr: pointer to free
   IREE_ALLOCATOR_COMMAND_FREE,
 
+  // Populates an iree_allocator_statistics_t with the current allocator state.
+  // Allocators that don't track statistics return IREE_STATUS_UNIMPLEMENTED.
+  //
+  // iree_allocator_ctl_fn_t:
+  //   params: unused
+  //   inout_ptr: pointer to an iree_allocator_statistics_t to populate
+  IREE_ALLOCATOR_COMMAND_QUERY_STATISTICS,
+
   // TODO(benvanik): add optional IREE_ALLOCATOR_COMMAND_BIND like mbind:
   // https://man7.org/linux/man-pages/man2/mbind.2.html
   // This would take a pointer/length and a NUMA node ID to bind the memory to.
@@ -181,6 +189,21 @@ typedef struct iree_allocator_alloc_params_t {
   iree_host_size_t byte_length;
 } iree_allocator_alloc_params_t;
 
+// Statistics reported by allocators supporting
+// IREE_ALLOCATOR_COMMAND_QUERY_STATISTICS. Values are snapshots and may be
+// approximate when the allocator is in use on other threads.
+typedef struct iree_allocator_statistics_t {
+  // Total bytes currently held from the underlying system allocator including
+  // memory retained for reuse.
+  iree_host_size_t reserved_byte_length;
+  // Bytes retained for reuse in caches shared across threads. Allocators with
+  // per-thread caches do not include memory held by those caches.
+  iree_host_size_t cached_byte_length;
+  // Total number of allocation requests forwarded to the underlying system
+  // allocator.
+  iree_host_size_t system_allocation_count;
+} iree_allocator_statistics_t;
+
 // Function pointer for an iree_allocator_t control function.
 // |command| provides the operation to perform. Optionally some commands may use
 // |params| to pass additional operation-specific parameters. |inout_ptr| usage
@@ -229,6 +252,11 @@ iree_allocator_clone(iree_allocator_t allocator,
 // Frees a previously-allocated block of memory to the given allocator.
 IREE_API_EXPORT void iree_allocator_free(iree_allocator_t allocator, void* ptr);
 
+// Queries the current statistics of |allocator| into |out_statistics|.
+// Returns IREE_STATUS_UNIMPLEMENTED if the allocator does not track them.
+IREE_API_EXPORT iree_status_t iree_allocator_query_statistics(
+    iree_allocator_t allocator, iree_allocator_statistics_t* out_statistics);
+
 // Default C allocator controller using malloc/free.
 IREE_API_EXPORT iree_status_t
 iree_allocator_system_ctl(void* self, iree_allocator_command_t command,
@@ -207,4 +207,25 @@
 #define IREE_ATTRIBUTE_UNUSED
 #endif  // IREE_HAVE_ATTRIBUTE(maybe_unused / unused)
 
+//===----------------------------------------------------------------------===//
+// IREE_THREAD_LOCAL
+//===----------------------------------------------------------------------===//
+
+// Declares a variable with thread storage duration such that each thread has
+// its own zero-initialized instance. Only usable on static/global variables
+// with trivial initializers and no destructors: nothing is run on thread exit
+// and anything the variable references must be cleaned up explicitly.
+//
+// Example:
+//   static IREE_THREAD_LOCAL int thread_counter = 0;
+#if defined(IREE_COMPILER_MSVC)
+#define IREE_THREAD_LOCAL __declspec(thread)
+#elif defined(IREE_COMPILER_GCC_COMPAT)
+#define IREE_THREAD_LOCAL __thread
+#elif defined(__cplusplus)
+#define IREE_THREAD_LOCAL thread_local
+#else
+#define IREE_THREAD_LOCAL _Thread_local
+#endif  // IREE_COMPILER_*
+
 #endif  // IREE_BASE_ATTRIBUTES_H_
@@ -189,6 +189,28 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_HAL_HEAP_BUFFER_ALIGNMENT 64
 #endif  // IREE_HAL_HEAP_BUFFER_ALIGNMENT
 
+#if !defined(IREE_HAL_HEAP_BUFFER_CACHE_ENABLE)
+// Enables a per-thread cache of recently freed heap buffer wrappers and small
+// slab allocations that is used to service new heap buffers without going to
+// the host allocator. This greatly reduces allocator traffic in programs that
+// create and release many small transient buffers (inline VMVX/local-sync
+// execution) at the cost of retaining a bounded amount of memory per thread.
+// Disable when debugging leaks or using tools that need to observe every
+// allocation; it is disabled by default when ASAN is enabled.
+#if defined(IREE_SANITIZER_ADDRESS) || defined(IREE_SANITIZER_MEMORY)
+#define IREE_HAL_HEAP_BUFFER_CACHE_ENABLE 0
+#else
+#define IREE_HAL_HEAP_BUFFER_CACHE_ENABLE 1
+#endif  // IREE_SANITIZER_*
+#endif  // IREE_HAL_HEAP_BUFFER_CACHE_ENABLE
+
+#if !defined(IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE)
+// Maximum size in bytes of a heap buffer payload that will be retained in the
+// per-thread heap buffer cache. Larger buffers are always returned to the host
+// allocator. Only used when IREE_HAL_HEAP_BUFFER_CACHE_ENABLE is set.
+#define IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE 4096
+#endif  // IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE
+
 #if !defined(IREE_HAL_COMMAND_BUFFER_VALIDATION_ENABLE)
 // Enables additional validation of commands issued against command buffers.
 // This adds small amounts of per-command overhead but in all but the most
@@ -251,10 +273,26 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE 0
 #endif  // !IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE
 
+#if !defined(IREE_VM_EXECUTION_PROFILING_ENABLE)
+// Enables sampling of bytecode program counters and timing of import calls for
+// invocations with IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION set. Adds a
+// countdown to every branch, call, and return and per-context profile storage;
+// see iree_vm_bytecode_module_append_profile for retrieving the results.
+#define IREE_VM_EXECUTION_PROFILING_ENABLE 0
+#endif  // !IREE_VM_EXECUTION_PROFILING_ENABLE
+
+#if !defined(IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL)
+// Number of bytecode branches, calls, and returns dispatched on a thread
+// between samples of the executing program counter when profiling is enabled.
+#define IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL 127
+#endif  // !IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL
+
 #if !defined(IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE)
-// Enables the use of compute goto for bytecode dispatch. This can have a
-// moderate performance improvement (~10-20%) on very heavy VMVX workloads but
-// adds 20-30KB to the binary size.
+// Enables the use of computed goto for bytecode dispatch. This can have a
+// moderate performance improvement (~10-20%) on very heavy VMVX workloads or
+// host code that spends significant time in the interpreter but adds 20-30KB to
+// the binary size. Only supported by compilers with labels-as-values (clang and
+// gcc); others use switch-based dispatch regardless of this setting.
 #define IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE 0
 #endif  // !IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE
 
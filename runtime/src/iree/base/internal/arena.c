@@ -15,6 +15,151 @@
 // iree_arena_block_pool_t
 //===----------------------------------------------------------------------===//
 
+// Frees all blocks in the chain starting at |head| back to the allocator.
+static void iree_arena_block_pool_free_chain(
+    iree_arena_block_pool_t* block_pool, iree_arena_block_t* head) {
+  while (head) {
+    void* ptr = (uint8_t*)head - block_pool->usable_block_size;
+    head = head->next;
+    iree_allocator_free(block_pool->block_allocator, ptr);
+  }
+}
+
+// Pops a block from the shared list of |block_pool|, if any.
+// The pop is counted as in-flight so that a concurrent trim does not free the
+// block the pop is reading before the pop has swapped it out of the list.
+static iree_arena_block_t* iree_arena_block_pool_pop_shared(
+    iree_arena_block_pool_t* block_pool) {
+  iree_atomic_fetch_add_int32(&block_pool->shared_pop_count, 1,
+                              iree_memory_order_seq_cst);
+  iree_arena_block_t* block =
+      iree_atomic_arena_block_slist_pop(&block_pool->available_slist);
+  iree_atomic_fetch_sub_int32(&block_pool->shared_pop_count, 1,
+                              iree_memory_order_release);
+  return block;
+}
+
+static void iree_arena_block_pool_increment_counter(
+    iree_atomic_intptr_t* counter) {
+  iree_atomic_fetch_add_intptr(counter, 1, iree_memory_order_relaxed);
+}
+
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
+// Next magazine index handed out to a thread on its first use of any pool.
+static iree_atomic_int32_t iree_arena_block_pool_next_magazine_index =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Magazine index + 1 assigned to the current thread or 0 if not yet assigned.
+// The same index is used for all pools.
+static IREE_THREAD_LOCAL int32_t iree_arena_block_pool_thread_magazine_index =
+    0;
+
+// Tries to lock the magazine of |block_pool| assigned to the current thread.
+// Returns NULL if another thread sharing the magazine index holds it; callers
+// should fall back to the shared list instead of waiting.
+static iree_arena_block_magazine_t* iree_arena_block_magazine_try_lock(
+    iree_arena_block_pool_t* block_pool) {
+  int32_t index = iree_arena_block_pool_thread_magazine_index;
+  if (IREE_UNLIKELY(!index)) {
+    uint32_t next_index = (uint32_t)iree_atomic_fetch_add_int32(
+        &iree_arena_block_pool_next_magazine_index, 1,
+        iree_memory_order_relaxed);
+    index = 1 + (int32_t)(next_index % IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT);
+    iree_arena_block_pool_thread_magazine_index = index;
+  }
+  iree_arena_block_magazine_t* magazine = &block_pool->magazines[index - 1];
+  if (iree_atomic_exchange_int32(&magazine->lock, 1,
+                                 iree_memory_order_acquire) != 0) {
+    return NULL;
+  }
+  return magazine;
+}
+
+static void iree_arena_block_magazine_unlock(
+    iree_arena_block_magazine_t* magazine) {
+  iree_atomic_store_int32(&magazine->lock, 0, iree_memory_order_release);
+}
+
+// Increments a counter only ever modified by the holder of the magazine lock.
+// Avoids a read-modify-write while allowing concurrent statistics queries.
+static void iree_arena_block_magazine_increment_counter(
+    iree_atomic_intptr_t* counter) {
+  iree_atomic_store_intptr(
+      counter, iree_atomic_load_intptr(counter, iree_memory_order_relaxed) + 1,
+      iree_memory_order_relaxed);
+}
+
+// Refills an empty locked |magazine| with up to half its capacity from the
+// shared list of |block_pool|. The whole shared list is taken in one operation
+// and whatever isn't needed is returned in another so that the refill costs
+// two atomic operations regardless of how many blocks are moved.
+static void iree_arena_block_magazine_refill(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_magazine_t* magazine) {
+  iree_arena_block_t* head = NULL;
+  iree_arena_block_t* tail = NULL;
+  if (!iree_atomic_arena_block_slist_flush(
+          &block_pool->available_slist,
+          IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &head, &tail)) {
+    return;
+  }
+  while (head &&
+         magazine->count < IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY / 2) {
+    iree_arena_block_t* next = head->next;
+    magazine->blocks[magazine->count++] = head;
+    head = next;
+  }
+  if (head) {
+    iree_atomic_arena_block_slist_concat(&block_pool->available_slist, head,
+                                         tail);
+  }
+}
+
+// Retains as much of the chain |block_head| to |block_tail| as fits in the
+// locked |magazine| and returns the head of the chain that must be released to
+// the shared list, if any. When the magazine fills up half of it is spilled
+// onto the returned chain so that subsequent releases can be retained.
+static iree_arena_block_t* iree_arena_block_magazine_retain(
+    iree_arena_block_magazine_t* magazine, iree_arena_block_t* block_head,
+    iree_arena_block_t* block_tail) {
+  if (!block_head) return NULL;
+  while (magazine->count < IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY) {
+    iree_arena_block_t* next = block_head->next;
+    magazine->blocks[magazine->count++] = block_head;
+    if (block_head == block_tail) return NULL;
+    block_head = next;
+  }
+  while (magazine->count > IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY / 2) {
+    iree_arena_block_t* block = magazine->blocks[--magazine->count];
+    block->next = block_head;
+    block_head = block;
+  }
+  return block_head;
+}
+
+// Frees all blocks retained by magazines that are not in use.
+static void iree_arena_block_pool_trim_magazines(
+    iree_arena_block_pool_t* block_pool) {
+  for (iree_host_size_t i = 0; i < IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT; ++i) {
+    iree_arena_block_magazine_t* magazine = &block_pool->magazines[i];
+    if (iree_atomic_exchange_int32(&magazine->lock, 1,
+                                   iree_memory_order_acquire) != 0) {
+      continue;  // in use; will be picked up by a future trim
+    }
+    iree_arena_block_t* head = NULL;
+    while (magazine->count > 0) {
+      iree_arena_block_t* block = magazine->blocks[--magazine->count];
+      block->next = head;
+      head = block;
+    }
+    iree_arena_block_magazine_unlock(magazine);
+    iree_arena_block_pool_free_chain(block_pool, head);
+  }
+}
+
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
 void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
                                       iree_allocator_t block_allocator,
                                       iree_arena_block_pool_t* out_block_pool) {
@@ -34,7 +179,8 @@ void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Since all blocks must have been released we can just reuse trim (today) as
-  // it doesn't retain any blocks.
+  // it doesn't retain any blocks. No magazines can be in use as no other
+  // threads may be using the pool.
   iree_arena_block_pool_trim(block_pool);
   iree_atomic_arena_block_slist_deinitialize(&block_pool->available_slist);
 
@@ -44,25 +190,86 @@ void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool) {
 void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  iree_arena_block_pool_trim_magazines(block_pool);
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
   iree_arena_block_t* head = NULL;
   iree_atomic_arena_block_slist_flush(
       &block_pool->available_slist,
       IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &head, NULL);
-  while (head) {
-    void* ptr = (uint8_t*)head - block_pool->usable_block_size;
-    head = head->next;
-    iree_allocator_free(block_pool->block_allocator, ptr);
+
+  // Pops that started before the flush may still be reading the next pointer
+  // of a flushed block. Pops that start after it can't reach the flushed blocks
+  // so this only waits for the (short, non-blocking) pops already in flight.
+  if (head) {
+    while (iree_atomic_load_int32(&block_pool->shared_pop_count,
+                                  iree_memory_order_seq_cst) != 0) {
+    }
   }
+  iree_arena_block_pool_free_chain(block_pool, head);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_arena_block_pool_query_statistics(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_pool_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  for (iree_host_size_t i = 0; i < IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT; ++i) {
+    iree_arena_block_magazine_t* magazine = &block_pool->magazines[i];
+    out_statistics->magazine_acquire_count += (iree_host_size_t)
+        iree_atomic_load_intptr(&magazine->acquire_count,
+                                iree_memory_order_relaxed);
+    out_statistics->magazine_release_count += (iree_host_size_t)
+        iree_atomic_load_intptr(&magazine->release_count,
+                                iree_memory_order_relaxed);
+  }
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  out_statistics->shared_acquire_count =
+      (iree_host_size_t)iree_atomic_load_intptr(
+          &block_pool->shared_acquire_count, iree_memory_order_relaxed);
+  out_statistics->allocation_count = (iree_host_size_t)iree_atomic_load_intptr(
+      &block_pool->allocation_count, iree_memory_order_relaxed);
+  out_statistics->shared_release_count =
+      (iree_host_size_t)iree_atomic_load_intptr(
+          &block_pool->shared_release_count, iree_memory_order_relaxed);
+}
+
 iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
                                             iree_arena_block_t** out_block) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_arena_block_t* block =
-      iree_atomic_arena_block_slist_pop(&block_pool->available_slist);
+  iree_arena_block_t* block = NULL;
+  bool used_shared_list = false;
+
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  iree_arena_block_magazine_t* magazine =
+      iree_arena_block_magazine_try_lock(block_pool);
+  if (magazine) {
+    if (magazine->count > 0) {
+      block = magazine->blocks[--magazine->count];
+      iree_arena_block_magazine_increment_counter(&magazine->acquire_count);
+    } else {
+      iree_arena_block_magazine_refill(block_pool, magazine);
+      if (magazine->count > 0) block = magazine->blocks[--magazine->count];
+      used_shared_list = true;
+    }
+    iree_arena_block_magazine_unlock(magazine);
+  }
+  if (!block && !used_shared_list) {
+    block = iree_arena_block_pool_pop_shared(block_pool);
+    used_shared_list = true;
+  }
+#else
+  block = iree_arena_block_pool_pop_shared(block_pool);
+  used_shared_list = true;
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
+  if (used_shared_list) {
+    iree_arena_block_pool_increment_counter(&block_pool->shared_acquire_count);
+  }
 
   if (!block) {
     // No blocks available; allocate one now.
@@ -77,6 +284,7 @@ iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
                                                 block_pool->total_block_size,
                                                 (void**)&block_base));
     block = (iree_arena_block_t*)(block_base + block_pool->usable_block_size);
+    iree_arena_block_pool_increment_counter(&block_pool->allocation_count);
   }
 
   block->next = NULL;
@@ -90,8 +298,26 @@ void iree_arena_block_pool_release(iree_arena_block_pool_t* block_pool,
                                    iree_arena_block_t* block_head,
                                    iree_arena_block_t* block_tail) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_atomic_arena_block_slist_concat(&block_pool->available_slist, block_head,
-                                       block_tail);
+
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  iree_arena_block_magazine_t* magazine =
+      iree_arena_block_magazine_try_lock(block_pool);
+  if (magazine) {
+    block_head =
+        iree_arena_block_magazine_retain(magazine, block_head, block_tail);
+    if (!block_head) {
+      iree_arena_block_magazine_increment_counter(&magazine->release_count);
+    }
+    iree_arena_block_magazine_unlock(magazine);
+  }
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
+  if (block_head) {
+    iree_atomic_arena_block_slist_concat(&block_pool->available_slist,
+                                         block_head, block_tail);
+    iree_arena_block_pool_increment_counter(&block_pool->shared_release_count);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/atomic_slist.h"
+#include "iree/base/internal/atomics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +35,43 @@ typedef struct iree_arena_block_t {
 IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
                                 offsetof(iree_arena_block_t, next));
 
+// Number of per-thread block magazines in each block pool.
+// Threads are assigned a magazine index on first use and share magazines when
+// there are more threads than magazines. Set to 0 to disable magazines and have
+// all requests go to the shared available_slist.
+#if !defined(IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT)
+#define IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT 8
+#endif  // !IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT
+
+// Maximum number of blocks retained in each block magazine.
+#if !defined(IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY)
+#define IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY 8
+#endif  // !IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY
+
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
+// A small stack of free blocks preferentially used by a single thread.
+// Blocks move between the magazine and the shared pool list in batches so that
+// threads acquiring and releasing blocks at high rates only rarely touch the
+// shared list. The magazine is guarded by a try-lock: if another thread sharing
+// the magazine index holds it the shared list is used instead of waiting.
+typedef struct iree_arena_block_magazine_t {
+  // 1 when a thread is using the magazine and 0 otherwise.
+  iree_atomic_int32_t lock;
+  // Number of valid entries in blocks.
+  uint32_t count;
+  // Number of acquisitions served from the magazine.
+  // Only modified while locked but may be read at any time.
+  iree_atomic_intptr_t acquire_count;
+  // Number of releases fully retained by the magazine.
+  // Only modified while locked but may be read at any time.
+  iree_atomic_intptr_t release_count;
+  // Free blocks (LIFO).
+  iree_arena_block_t* blocks[IREE_ARENA_BLOCK_POOL_MAGAZINE_CAPACITY];
+} iree_arena_block_magazine_t;
+
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
 // A simple atomic fixed-size block pool.
 // Blocks are allocated from the system as required and kept in the pool to
 // satisfy future requests. Blocks are all of a uniform size specified when the
@@ -41,6 +79,11 @@ IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
 // blocks so that the underlying allocator is more likely to bucket them
 // appropriately.
 //
+// Free blocks are cached in per-thread magazines in front of the shared list
+// such that a thread releasing and reacquiring blocks usually does so without
+// contending with other threads. Blocks released on one thread and acquired on
+// another flow through the shared list in batches.
+//
 // Thread-safe; multiple threads may acquire and release blocks from the pool.
 // The underlying allocator must also be thread-safe.
 typedef struct iree_arena_block_pool_t {
@@ -53,8 +96,40 @@ typedef struct iree_arena_block_pool_t {
   iree_allocator_t block_allocator;
   // Linked list of free blocks (LIFO).
   iree_atomic_arena_block_slist_t available_slist;
+  // Number of acquisitions that went to the available_slist.
+  iree_atomic_intptr_t shared_acquire_count;
+  // Number of blocks allocated from the block_allocator.
+  iree_atomic_intptr_t allocation_count;
+  // Number of releases that went to the available_slist.
+  iree_atomic_intptr_t shared_release_count;
+  // Number of pops from the available_slist in progress. A lock-free pop reads
+  // the next pointer of a block it may lose to another thread so trim must
+  // wait for in-flight pops to complete before freeing any blocks it flushed.
+  iree_atomic_int32_t shared_pop_count;
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  // Per-thread block caches indexed by the thread magazine index.
+  iree_arena_block_magazine_t magazines[IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT];
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
 } iree_arena_block_pool_t;
 
+// Counters tracking how block pool requests were served.
+// Each acquire and release call is counted once as either a magazine or shared
+// operation; a high shared count relative to the magazine count indicates that
+// threads are contending on the shared list. Counters are read individually and
+// are only approximate while the pool is in use.
+typedef struct iree_arena_block_pool_statistics_t {
+  // Acquisitions served from a thread magazine.
+  iree_host_size_t magazine_acquire_count;
+  // Acquisitions that popped from or refilled a magazine from the shared list.
+  iree_host_size_t shared_acquire_count;
+  // Blocks allocated from the block allocator as the pool was empty.
+  iree_host_size_t allocation_count;
+  // Releases fully retained by a thread magazine.
+  iree_host_size_t magazine_release_count;
+  // Releases that pushed blocks to the shared list, including magazine spills.
+  iree_host_size_t shared_release_count;
+} iree_arena_block_pool_statistics_t;
+
 // Initializes a new block pool in |out_block_pool|.
 // |block_allocator| will be used to allocate and free blocks for the pool.
 // Each block allocated will be |total_block_size| but have a slightly smaller
@@ -69,9 +144,17 @@ void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
 void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool);
 
 // Trims the pool by freeing unused blocks back to the allocator.
-// Acquired blocks are not freed and remain valid.
+// Acquired blocks are not freed and remain valid. Blocks held in magazines in
+// use by other threads at the time of the call may be retained. Safe to call
+// while other threads acquire and release blocks; the trim waits for any
+// concurrent pops from the shared list to finish before freeing blocks.
 void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool);
 
+// Queries the counters tracking how block requests have been served.
+void iree_arena_block_pool_query_statistics(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_pool_statistics_t* out_statistics);
+
 // Acquires a single block from the pool and returns it in |out_block|.
 // The block may be either a new allocation with undefined contents or a reused
 // prior allocation with undefined contents.
@@ -0,0 +1,206 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/arena.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static constexpr iree_host_size_t kBlockSize = 4096;
+
+TEST(ArenaBlockPool, Lifetime) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+TEST(ArenaBlockPool, ReusesReleasedBlocks) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+
+  iree_arena_block_t* block0 = NULL;
+  IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &block0));
+  iree_arena_block_pool_release(&block_pool, block0, block0);
+  iree_arena_block_t* block1 = NULL;
+  IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &block1));
+  EXPECT_EQ(block0, block1);
+  iree_arena_block_pool_release(&block_pool, block1, block1);
+
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool, &statistics);
+  EXPECT_EQ(1, statistics.allocation_count);
+  EXPECT_EQ(2, statistics.magazine_acquire_count +
+                   statistics.shared_acquire_count);
+#if IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+  EXPECT_EQ(1, statistics.magazine_acquire_count);
+  EXPECT_EQ(2, statistics.magazine_release_count);
+  EXPECT_EQ(0, statistics.shared_release_count);
+#endif  // IREE_ARENA_BLOCK_POOL_MAGAZINE_COUNT > 0
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+// Releases a chain of blocks larger than a magazine can hold and ensures that
+// all blocks are reused before any new ones are allocated.
+TEST(ArenaBlockPool, ReleaseLongChain) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+
+  static constexpr size_t kBlockCount = 64;
+  std::vector<iree_arena_block_t*> blocks(kBlockCount);
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &blocks[i]));
+    if (i > 0) blocks[i - 1]->next = blocks[i];
+  }
+  iree_arena_block_pool_release(&block_pool, blocks.front(), blocks.back());
+
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &blocks[i]));
+    EXPECT_EQ(NULL, blocks[i]->next);
+  }
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool, &statistics);
+  EXPECT_EQ(kBlockCount, statistics.allocation_count);
+
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    iree_arena_block_pool_release(&block_pool, blocks[i], blocks[i]);
+  }
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+TEST(ArenaBlockPool, TrimFreesCachedBlocks) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+
+  iree_arena_block_t* block = NULL;
+  IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &block));
+  iree_arena_block_pool_release(&block_pool, block, block);
+  iree_arena_block_pool_trim(&block_pool);
+
+  // No blocks are retained after the trim so a new one must be allocated.
+  IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &block));
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool, &statistics);
+  EXPECT_EQ(2, statistics.allocation_count);
+  iree_arena_block_pool_release(&block_pool, block, block);
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+// Acquires and releases single blocks and chains from several threads sharing
+// the pool.
+TEST(ArenaBlockPool, Multithreaded) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+
+  static constexpr int kThreadCount = 4;
+  static constexpr int kIterationCount = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&block_pool]() {
+      iree_arena_block_t* blocks[4] = {NULL};
+      for (int i = 0; i < kIterationCount; ++i) {
+        for (int j = 0; j < 4; ++j) {
+          IREE_ASSERT_OK(
+              iree_arena_block_pool_acquire(&block_pool, &blocks[j]));
+          // Touch the usable bytes to catch blocks handed out twice under
+          // ASAN/TSAN.
+          uint8_t* block_base =
+              (uint8_t*)blocks[j] - block_pool.usable_block_size;
+          block_base[0] = (uint8_t)i;
+        }
+        blocks[0]->next = blocks[1];
+        blocks[1]->next = blocks[2];
+        iree_arena_block_pool_release(&block_pool, blocks[0], blocks[2]);
+        iree_arena_block_pool_release(&block_pool, blocks[3], blocks[3]);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool, &statistics);
+  EXPECT_EQ((iree_host_size_t)kThreadCount * kIterationCount * 4,
+            statistics.magazine_acquire_count +
+                statistics.shared_acquire_count);
+  EXPECT_EQ((iree_host_size_t)kThreadCount * kIterationCount * 2,
+            statistics.magazine_release_count +
+                statistics.shared_release_count);
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+// Trims the pool continuously while other threads acquire and release blocks.
+// More threads than magazines are used and each holds more blocks than fit in
+// a magazine so that acquisitions pop from the shared list while trim frees
+// what it flushed from it. Under ASAN a trim freeing a block that a pop is
+// still reading reports a use-after-free.
+TEST(ArenaBlockPool, ConcurrentPopAndTrim) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                   &block_pool);
+
+  static constexpr int kThreadCount = 16;
+  static constexpr int kIterationCount = 2000;
+  static constexpr int kBlocksPerIteration = 12;
+  std::atomic<bool> workers_done{false};
+  std::vector<iree_status_t> statuses(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&block_pool, &statuses, t]() {
+      iree_status_t status = iree_ok_status();
+      iree_arena_block_t* blocks[kBlocksPerIteration] = {NULL};
+      for (int i = 0; i < kIterationCount && iree_status_is_ok(status); ++i) {
+        int acquired = 0;
+        for (; acquired < kBlocksPerIteration; ++acquired) {
+          status =
+              iree_arena_block_pool_acquire(&block_pool, &blocks[acquired]);
+          if (!iree_status_is_ok(status)) break;
+          uint8_t* block_base =
+              (uint8_t*)blocks[acquired] - block_pool.usable_block_size;
+          block_base[0] = (uint8_t)i;
+        }
+        for (int j = 0; j < acquired; ++j) {
+          iree_arena_block_pool_release(&block_pool, blocks[j], blocks[j]);
+        }
+      }
+      statuses[t] = status;
+    });
+  }
+  std::thread trim_thread([&block_pool, &workers_done]() {
+    while (!workers_done.load()) {
+      iree_arena_block_pool_trim(&block_pool);
+    }
+  });
+  for (auto& thread : threads) thread.join();
+  workers_done = true;
+  trim_thread.join();
+  for (iree_status_t status : statuses) {
+    IREE_EXPECT_OK(status);
+  }
+
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool, &statistics);
+  EXPECT_EQ((iree_host_size_t)kThreadCount * kIterationCount *
+                kBlocksPerIteration,
+            statistics.magazine_acquire_count +
+                statistics.shared_acquire_count);
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+}  // namespace
@@ -10,9 +10,126 @@
 
 #include "iree/base/attributes.h"
 
-// TODO(benvanik): add TSAN annotations when switched to atomics:
-// https://github.com/gcc-mirror/gcc/blob/master/libsanitizer/include/sanitizer/tsan_interface_atomic.h
-// https://reviews.llvm.org/D18500
+#if IREE_ATOMIC_SLIST_LOCK_FREE
+
+#if defined(IREE_COMPILER_MSVC)
+#include <intrin.h>
+#endif  // IREE_COMPILER_MSVC
+
+// Compares |list| head with |expected| and if equal replaces it with |desired|.
+// Returns true if the head was replaced and otherwise false with |expected|
+// updated to the current head. All variants are full barriers.
+static inline bool iree_atomic_slist_compare_exchange_head(
+    iree_atomic_slist_t* list, iree_atomic_slist_head_t* expected,
+    iree_atomic_slist_head_t desired) {
+#if defined(IREE_COMPILER_MSVC)
+  return _InterlockedCompareExchange128((volatile __int64*)&list->head,
+                                        (__int64)desired.tag,
+                                        (__int64)desired.entry,
+                                        (__int64*)expected) != 0;
+#elif defined(IREE_ARCH_X86_64)
+  // CMPXCHG16B is in every x86-64 CPU that matters but compilers only emit it
+  // for __sync/__atomic builtins with -mcx16 so we spell it out.
+  bool exchanged;
+  __asm__ __volatile__("lock cmpxchg16b %1"
+                       : "=@ccz"(exchanged), "+m"(list->head),
+                         "+a"(expected->entry), "+d"(expected->tag)
+                       : "b"(desired.entry), "c"(desired.tag)
+                       : "memory");
+  return exchanged;
+#else
+#if IREE_PTR_SIZE == 8
+  typedef unsigned __int128 iree_atomic_slist_dword_t;
+#else
+  typedef uint64_t iree_atomic_slist_dword_t;
+#endif  // IREE_PTR_SIZE == 8
+  iree_atomic_slist_dword_t expected_bits = 0;
+  iree_atomic_slist_dword_t desired_bits = 0;
+  memcpy(&expected_bits, expected, sizeof(expected_bits));
+  memcpy(&desired_bits, &desired, sizeof(desired_bits));
+  iree_atomic_slist_dword_t current_bits = __sync_val_compare_and_swap(
+      (iree_atomic_slist_dword_t*)&list->head, expected_bits, desired_bits);
+  if (current_bits == expected_bits) return true;
+  memcpy(expected, &current_bits, sizeof(current_bits));
+  return false;
+#endif  // IREE_COMPILER_MSVC
+}
+
+// Returns a snapshot of the |list| head used to seed a compare-exchange loop.
+// The two halves are read independently and may be torn; the compare-exchange
+// then fails and returns the actual head.
+static inline iree_atomic_slist_head_t iree_atomic_slist_load_head(
+    iree_atomic_slist_t* list) {
+  iree_atomic_slist_head_t head;
+  head.entry = ((iree_atomic_slist_entry_t* volatile*)&list->head.entry)[0];
+  head.tag = ((volatile uintptr_t*)&list->head.tag)[0];
+  return head;
+}
+
+void iree_atomic_slist_initialize(iree_atomic_slist_t* out_list) {
+  memset(out_list, 0, sizeof(*out_list));
+}
+
+void iree_atomic_slist_deinitialize(iree_atomic_slist_t* list) {
+  // TODO(benvanik): assert empty.
+  memset(list, 0, sizeof(*list));
+}
+
+void iree_atomic_slist_concat(iree_atomic_slist_t* list,
+                              iree_atomic_slist_entry_t* head,
+                              iree_atomic_slist_entry_t* tail) {
+  if (IREE_UNLIKELY(!head)) return;
+  // Pushes don't need to change the tag: only pops can observe a stale next
+  // pointer.
+  iree_atomic_slist_head_t expected = iree_atomic_slist_load_head(list);
+  iree_atomic_slist_head_t desired;
+  do {
+    tail->next = expected.entry;
+    desired.entry = head;
+    desired.tag = expected.tag;
+  } while (!iree_atomic_slist_compare_exchange_head(list, &expected, desired));
+}
+
+void iree_atomic_slist_push(iree_atomic_slist_t* list,
+                            iree_atomic_slist_entry_t* entry) {
+  iree_atomic_slist_concat(list, entry, entry);
+}
+
+void iree_atomic_slist_push_unsafe(iree_atomic_slist_t* list,
+                                   iree_atomic_slist_entry_t* entry) {
+  entry->next = list->head.entry;
+  list->head.entry = entry;
+}
+
+iree_atomic_slist_entry_t* iree_atomic_slist_pop(iree_atomic_slist_t* list) {
+  iree_atomic_slist_head_t expected = iree_atomic_slist_load_head(list);
+  iree_atomic_slist_head_t desired;
+  do {
+    if (!expected.entry) return NULL;
+    // NOTE: the entry may be popped (and even reused) by another thread between
+    // the load and the exchange; the tag check makes the exchange fail and the
+    // garbage next pointer is discarded.
+    desired.entry = expected.entry->next;
+    desired.tag = expected.tag + 1;
+  } while (!iree_atomic_slist_compare_exchange_head(list, &expected, desired));
+  expected.entry->next = NULL;
+  return expected.entry;
+}
+
+// Exchanges the list head with NULL to steal the entire list.
+static iree_atomic_slist_entry_t* iree_atomic_slist_steal(
+    iree_atomic_slist_t* list) {
+  iree_atomic_slist_head_t expected = iree_atomic_slist_load_head(list);
+  iree_atomic_slist_head_t desired;
+  do {
+    if (!expected.entry) return NULL;
+    desired.entry = NULL;
+    desired.tag = expected.tag + 1;
+  } while (!iree_atomic_slist_compare_exchange_head(list, &expected, desired));
+  return expected.entry;
+}
+
+#else
 
 void iree_atomic_slist_initialize(iree_atomic_slist_t* out_list) {
   memset(out_list, 0, sizeof(*out_list));
@@ -44,8 +161,6 @@ void iree_atomic_slist_push(iree_atomic_slist_t* list,
 
 void iree_atomic_slist_push_unsafe(iree_atomic_slist_t* list,
                                    iree_atomic_slist_entry_t* entry) {
-  // NOTE: no lock is held here and no atomic operation will be used when this
-  // is actually made atomic.
   entry->next = list->head;
   list->head = entry;
 }
@@ -61,16 +176,25 @@ iree_atomic_slist_entry_t* iree_atomic_slist_pop(iree_atomic_slist_t* list) {
   return entry;
 }
 
-bool iree_atomic_slist_flush(iree_atomic_slist_t* list,
-                             iree_atomic_slist_flush_order_t flush_order,
-                             iree_atomic_slist_entry_t** out_head,
-                             iree_atomic_slist_entry_t** out_tail) {
-  // Exchange list head with NULL to steal the entire list. The list will be in
-  // the native LIFO order of the slist.
+// Exchanges the list head with NULL to steal the entire list.
+static iree_atomic_slist_entry_t* iree_atomic_slist_steal(
+    iree_atomic_slist_t* list) {
   iree_slim_mutex_lock(&list->mutex);
   iree_atomic_slist_entry_t* head = list->head;
   list->head = NULL;
   iree_slim_mutex_unlock(&list->mutex);
+  return head;
+}
+
+#endif  // IREE_ATOMIC_SLIST_LOCK_FREE
+
+bool iree_atomic_slist_flush(iree_atomic_slist_t* list,
+                             iree_atomic_slist_flush_order_t flush_order,
+                             iree_atomic_slist_entry_t** out_head,
+                             iree_atomic_slist_entry_t** out_tail) {
+  // Steal the entire list. The list will be in the native LIFO order of the
+  // slist.
+  iree_atomic_slist_entry_t* head = iree_atomic_slist_steal(list);
   if (!head) return false;
 
   switch (flush_order) {
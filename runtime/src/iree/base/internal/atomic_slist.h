@@ -32,6 +32,43 @@ typedef struct iree_atomic_slist_entry_t {
   struct iree_atomic_slist_entry_t* next;
 } iree_atomic_slist_entry_t;
 
+// Set to 1 when the slist is implemented with a double-width compare-exchange
+// on a tagged head pointer and 0 when it falls back to a mutex-guarded head.
+// The lock-free implementation is used on 64-bit x86 and arm and on other
+// targets where the compiler provides a native double-width compare-exchange.
+// TSAN doesn't model the inline assembly and 128-bit atomics involved and
+// builds with it use the mutex so that the list remains visible to it.
+#if !defined(IREE_ATOMIC_SLIST_LOCK_FREE)
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE || defined(IREE_SANITIZER_THREAD)
+#define IREE_ATOMIC_SLIST_LOCK_FREE 0
+#elif defined(IREE_COMPILER_MSVC) && \
+    (defined(IREE_ARCH_X86_64) || defined(IREE_ARCH_ARM_64))
+#define IREE_ATOMIC_SLIST_LOCK_FREE 1
+#elif defined(IREE_COMPILER_GCC_COMPAT) && defined(IREE_ARCH_X86_64)
+#define IREE_ATOMIC_SLIST_LOCK_FREE 1
+#elif defined(IREE_COMPILER_GCC_COMPAT) && IREE_PTR_SIZE == 8 && \
+    defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define IREE_ATOMIC_SLIST_LOCK_FREE 1
+#elif defined(IREE_COMPILER_GCC_COMPAT) && IREE_PTR_SIZE == 4 && \
+    defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+#define IREE_ATOMIC_SLIST_LOCK_FREE 1
+#else
+#define IREE_ATOMIC_SLIST_LOCK_FREE 0
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE || ...
+#endif  // !IREE_ATOMIC_SLIST_LOCK_FREE
+
+#if IREE_ATOMIC_SLIST_LOCK_FREE
+// DO NOT USE: implementation detail.
+// The list head pointer paired with a tag that is incremented by every pop and
+// flush. Both are compared and swapped together so that a pop racing with other
+// threads popping and re-pushing the same head entry (the ABA problem) fails
+// instead of installing a stale next pointer.
+typedef iree_alignas(2 * sizeof(uintptr_t)) struct {
+  iree_atomic_slist_entry_t* entry;
+  uintptr_t tag;
+} iree_atomic_slist_head_t;
+#endif  // IREE_ATOMIC_SLIST_LOCK_FREE
+
 // Lightweight contention-avoiding singly linked list.
 // This models optimistically-ordered LIFO behavior (stack push/pop) using
 // atomic primitives.
@@ -72,15 +109,26 @@ typedef struct iree_atomic_slist_entry_t {
 //
 // WARNING: this is an extremely sharp pufferfish-esque API. Don't use it. 🐡
 //
+// When IREE_ATOMIC_SLIST_LOCK_FREE is set a pop may read the next pointer of an
+// entry that another thread has concurrently popped or flushed: entry memory
+// must remain readable until every pop that may have observed the entry at the
+// head of the list has returned. Owners that free entries while other threads
+// may pop must quiesce those pops first (iree_arena_block_pool_trim waits for
+// in-flight pops) or only free entries when no other thread can be using the
+// list (iree_task_pool_trim requires that there are no outstanding tasks).
+//
 // TODO(benvanik): verify behavior (and worthwhileness) of supporting platform
 // primitives. The benefit of something like OSAtomicEnqueue/Dequeue is that it
 // may have better tooling (TSAN), special intrinsic handling in the compiler,
 // etc. That said, the Windows Interlocked* variants don't seem to. Having a
 // single heavily tested implementation seems more worthwhile than several.
 typedef iree_alignas(iree_max_align_t) struct {
-  // TODO(benvanik): spend some time golfing this. Unblocking myself for now :)
+#if IREE_ATOMIC_SLIST_LOCK_FREE
+  iree_atomic_slist_head_t head;
+#else
   iree_slim_mutex_t mutex;
   iree_atomic_slist_entry_t* head;
+#endif  // IREE_ATOMIC_SLIST_LOCK_FREE
 } iree_atomic_slist_t;
 
 // Initializes an slist handle to an empty list.
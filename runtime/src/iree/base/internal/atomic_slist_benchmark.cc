@@ -0,0 +1,111 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/internal/atomic_slist.h"
+
+namespace {
+
+struct benchmark_entry_t {
+  iree_atomic_slist_intrusive_ptr_t slist_next = NULL;
+  int value = 0;
+};
+IREE_TYPED_ATOMIC_SLIST_WRAPPER(benchmark, benchmark_entry_t,
+                                offsetof(benchmark_entry_t, slist_next));
+
+//==============================================================================
+// Uncontended push/pop
+//==============================================================================
+
+void BM_PushPopUncontended(benchmark::State& state) {
+  benchmark_slist_t list;
+  benchmark_slist_initialize(&list);
+  benchmark_entry_t entry;
+  for (auto _ : state) {
+    benchmark_slist_push(&list, &entry);
+    benchmark::DoNotOptimize(benchmark_slist_pop(&list));
+  }
+  benchmark_slist_deinitialize(&list);
+}
+
+BENCHMARK(BM_PushPopUncontended)->UseRealTime()->Threads(1);
+
+//==============================================================================
+// Contended push/pop
+//==============================================================================
+
+// Models a shared free-list: each thread pops an entry, touches it, and pushes
+// it back. The list is seeded with enough entries that pops rarely see it empty
+// so that the benchmark measures contention on the list head.
+void BM_PushPopContended(benchmark::State& state) {
+  struct Shared {
+    benchmark_slist_t list;
+    std::vector<benchmark_entry_t> entries;
+    Shared() : entries(256) {
+      benchmark_slist_initialize(&list);
+      for (auto& entry : entries) benchmark_slist_push(&list, &entry);
+    }
+  };
+  static auto* shared = new Shared();
+  for (auto _ : state) {
+    benchmark_entry_t* entry = benchmark_slist_pop(&shared->list);
+    if (!entry) continue;
+    ++entry->value;
+    benchmark::DoNotOptimize(entry->value);
+    benchmark_slist_push(&shared->list, entry);
+  }
+}
+
+BENCHMARK(BM_PushPopContended)
+    ->UseRealTime()
+    // ThreadPerCpu poorly handles non-power-of-two CPU counts.
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->Threads(32);
+
+// Models a consumer draining the list in batches while producers push: one
+// thread flushes the list and concats the batch back while the others push and
+// pop individual entries.
+void BM_FlushConcatContended(benchmark::State& state) {
+  struct Shared {
+    benchmark_slist_t list;
+    std::vector<benchmark_entry_t> entries;
+    Shared() : entries(256) {
+      benchmark_slist_initialize(&list);
+      for (auto& entry : entries) benchmark_slist_push(&list, &entry);
+    }
+  };
+  static auto* shared = new Shared();
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      benchmark_entry_t* head = NULL;
+      benchmark_entry_t* tail = NULL;
+      if (benchmark_slist_flush(&shared->list,
+                                IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO,
+                                &head, &tail)) {
+        benchmark_slist_concat(&shared->list, head, tail);
+      }
+    } else {
+      benchmark_entry_t* entry = benchmark_slist_pop(&shared->list);
+      if (entry) benchmark_slist_push(&shared->list, entry);
+    }
+  }
+}
+
+BENCHMARK(BM_FlushConcatContended)
+    ->UseRealTime()
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16);
+
+}  // namespace
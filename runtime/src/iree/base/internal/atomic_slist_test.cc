@@ -6,6 +6,7 @@
 
 #include "iree/base/internal/atomic_slist.h"
 
+#include <thread>
 #include <vector>
 
 #include "iree/testing/gtest.h"
@@ -182,4 +183,54 @@ TEST(AtomicSList, FlushFIFO) {
   dummy_slist_deinitialize(&list);
 }
 
+
+// Hammers the list from several threads that each repeatedly pop an item and
+// push it back, with one thread periodically flushing and concatenating the
+// whole list back in. Items must neither be lost nor duplicated.
+TEST(AtomicSList, MultithreadedPushPop) {
+  dummy_slist_t list;
+  dummy_slist_initialize(&list);
+
+  auto item_storage = MakeDummySListItems(0, 1024);
+  for (size_t i = 0; i < item_storage.size(); ++i) {
+    dummy_slist_push(&list, &item_storage[i]);
+  }
+
+  static constexpr int kThreadCount = 4;
+  static constexpr int kIterationCount = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&list, t]() {
+      for (int i = 0; i < kIterationCount; ++i) {
+        if (t == 0 && (i % 64) == 0) {
+          dummy_entry_t* head = NULL;
+          dummy_entry_t* tail = NULL;
+          if (dummy_slist_flush(&list,
+                                IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO,
+                                &head, &tail)) {
+            dummy_slist_concat(&list, head, tail);
+          }
+          continue;
+        }
+        dummy_entry_t* p = dummy_slist_pop(&list);
+        if (p) dummy_slist_push(&list, p);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  // Every item must come back out exactly once.
+  std::vector<bool> seen(item_storage.size(), false);
+  size_t count = 0;
+  while (dummy_entry_t* p = dummy_slist_pop(&list)) {
+    ASSERT_LT(p->value, seen.size());
+    EXPECT_FALSE(seen[p->value]);
+    seen[p->value] = true;
+    ++count;
+  }
+  EXPECT_EQ(item_storage.size(), count);
+
+  dummy_slist_deinitialize(&list);
+}
+
 }  // namespace
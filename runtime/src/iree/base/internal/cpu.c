@@ -9,6 +9,7 @@
 
 #include "iree/base/internal/cpu.h"
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
@@ -33,8 +34,12 @@
 // NOTE: not all kernel versions have all of the cap bits we need defined so as
 // a practice we always define the feature bits we need locally.
 // https://docs.kernel.org/arm64/elf_hwcaps.html
+#define IREE_HWCAP_CPUID (1u << 11)
 #define IREE_HWCAP_ASIMDDP (1u << 20)
+#define IREE_HWCAP_SVE (1u << 22)
+#define IREE_HWCAP2_SVE2 (1u << 1)
 #define IREE_HWCAP2_I8MM (1u << 13)
+#define IREE_HWCAP2_SME (1u << 23)
 
 static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
   uint32_t hwcap = getauxval(AT_HWCAP);
@@ -43,7 +48,17 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
   IREE_COPY_BITS(out0, IREE_CPU_DATA0_ARM_64_DOTPROD, hwcap,
                  IREE_HWCAP_ASIMDDP);
   IREE_COPY_BITS(out0, IREE_CPU_DATA0_ARM_64_I8MM, hwcap2, IREE_HWCAP2_I8MM);
+  IREE_COPY_BITS(out0, IREE_CPU_DATA0_ARM_64_SVE, hwcap, IREE_HWCAP_SVE);
+  IREE_COPY_BITS(out0, IREE_CPU_DATA0_ARM_64_SVE2, hwcap2, IREE_HWCAP2_SVE2);
+  IREE_COPY_BITS(out0, IREE_CPU_DATA0_ARM_64_SME, hwcap2, IREE_HWCAP2_SME);
   out_fields[0] = out0;
+  // With HWCAP_CPUID, the kernel emulates reads of the ID registers from EL0.
+  if (hwcap & IREE_HWCAP_CPUID) {
+    uint64_t midr = 0;
+    __asm__("mrs %0, MIDR_EL1" : "=r"(midr));
+    out_fields[1] =
+        IREE_CPU_DATA1_ARM_64_MODEL((midr >> 24) & 0xFF, (midr >> 4) & 0xFFF);
+  }
 }
 
 #elif defined(IREE_PLATFORM_MACOS) || defined(IREE_PLATFORM_IOS)
@@ -65,6 +80,8 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
                     IREE_CPU_DATA0_ARM_64_DOTPROD);
   IREE_QUERY_SYSCTL("hw.optional.arm.FEAT_I8MM", out_fields[0],
                     IREE_CPU_DATA0_ARM_64_I8MM);
+  IREE_QUERY_SYSCTL("hw.optional.arm.FEAT_SME", out_fields[0],
+                    IREE_CPU_DATA0_ARM_64_SME);
 }
 
 #else
@@ -75,6 +92,31 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
 
 #endif  // IREE_PLATFORM_*
 
+#elif defined(IREE_ARCH_RISCV_64)
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <sys/auxv.h>
+
+// Single-letter extensions are reported in AT_HWCAP as the bit of their letter.
+// https://docs.kernel.org/arch/riscv/uabi.html
+#define IREE_HWCAP_RISCV_V (1u << ('V' - 'A'))
+
+static void iree_cpu_initialize_from_platform_riscv_64(uint64_t* out_fields) {
+  uint64_t hwcap = getauxval(AT_HWCAP);
+  uint64_t out0 = 0;
+  IREE_COPY_BITS(out0, IREE_CPU_DATA0_RISCV_64_V, hwcap, IREE_HWCAP_RISCV_V);
+  out_fields[0] = out0;
+}
+
+#else
+
+static void iree_cpu_initialize_from_platform_riscv_64(uint64_t* out_fields) {
+  // No implementation available. CPU data will be all zeros.
+}
+
+#endif  // IREE_PLATFORM_*
+
 #elif defined(IREE_ARCH_X86_64)
 
 #if defined(__GNUC__)
@@ -83,6 +125,28 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
 #include <intrin.h>
 #endif
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Linux only enables the AMX tile data state (XTILEDATA) for processes that
+// explicitly request it. Without that, executing AMX instructions raises
+// SIGILL even though CPUID and XCR0 report AMX as supported.
+// https://docs.kernel.org/arch/x86/xstate.html
+#define IREE_ARCH_REQ_XCOMP_PERM 0x1023
+#define IREE_XFEATURE_XTILEDATA 18
+
+static bool iree_cpu_request_amx_permission(void) {
+  return syscall(SYS_arch_prctl, IREE_ARCH_REQ_XCOMP_PERM,
+                 IREE_XFEATURE_XTILEDATA) == 0;
+}
+
+#else
+
+static bool iree_cpu_request_amx_permission(void) { return true; }
+
+#endif  // IREE_PLATFORM_*
+
 typedef struct iree_cpuid_regs_t {
   uint32_t eax;
   uint32_t ebx;
@@ -145,8 +209,31 @@ static inline iree_cpuid_regs_t iree_cpuid_or_zero(uint32_t eax, uint32_t ecx,
   return iree_cpuid_raw(eax, ecx);
 }
 
+// Returns the processor model as in IREE_CPU_DATA1_X86_64_MODEL, or 0 if the
+// vendor is unknown. |leaf0| and |leaf1| are the results of CPUID leaves 0, 1.
+static uint64_t iree_cpu_query_model_x86_64(iree_cpuid_regs_t leaf0,
+                                            iree_cpuid_regs_t leaf1) {
+  // The vendor string is in EBX, EDX, ECX in that order.
+  uint64_t vendor = 0;
+  if (leaf0.ebx == 0x756E6547u && leaf0.edx == 0x49656E69u &&
+      leaf0.ecx == 0x6C65746Eu) {
+    vendor = IREE_CPU_DATA1_X86_64_VENDOR_INTEL;  // "GenuineIntel"
+  } else if (leaf0.ebx == 0x68747541u && leaf0.edx == 0x69746E65u &&
+             leaf0.ecx == 0x444D4163u) {
+    vendor = IREE_CPU_DATA1_X86_64_VENDOR_AMD;  // "AuthenticAMD"
+  } else {
+    return 0;
+  }
+  uint32_t family = (leaf1.eax >> 8) & 0xF;
+  uint32_t model = (leaf1.eax >> 4) & 0xF;
+  if (family == 0xF) family += (leaf1.eax >> 20) & 0xFF;
+  if (family == 0x6 || family >= 0xF) model |= ((leaf1.eax >> 16) & 0xF) << 4;
+  return IREE_CPU_DATA1_X86_64_MODEL(vendor, family, model);
+}
+
 static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
   iree_cpuid_bounds_t bounds = iree_cpuid_query_bounds();
+  iree_cpuid_regs_t leaf0 = iree_cpuid_raw(0, 0);
   iree_cpuid_regs_t leaf1 = iree_cpuid_or_zero(1, 0, bounds);
   iree_cpuid_regs_t leaf7_0 = iree_cpuid_or_zero(7, 0, bounds);
   iree_cpuid_regs_t leaf7_1 = iree_cpuid_or_zero(7, 1, bounds);
@@ -197,14 +284,18 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
                    1 << 23);
   }
 
-  // Features that depend on AMX TILE state being enabled by the OS.
-  if (iree_all_bits_set(leafD.eax, 0x60000)) {
+  // Features that depend on AMX TILE state being enabled by the OS. The
+  // permission is process-wide so requesting it once here is sufficient.
+  if (iree_all_bits_set(leafD.eax, 0x60000) &&
+      iree_all_bits_set(leaf7_0.edx, 1 << 24) &&
+      iree_cpu_request_amx_permission()) {
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXTILE, leaf7_0.edx, 1 << 24);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXINT8, leaf7_0.edx, 1 << 25);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXBF16, leaf7_0.edx, 1 << 22);
   }
 
   out_fields[0] = out0;
+  out_fields[1] = iree_cpu_query_model_x86_64(leaf0, leaf1);
 }
 
 #endif  // defined(IREE_ARCH_ARM_64)
@@ -213,6 +304,8 @@ static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
                                               uint64_t* out_fields) {
 #if defined(IREE_ARCH_ARM_64)
   iree_cpu_initialize_from_platform_arm_64(out_fields);
+#elif defined(IREE_ARCH_RISCV_64)
+  iree_cpu_initialize_from_platform_riscv_64(out_fields);
 #elif defined(IREE_ARCH_X86_64)
   iree_cpu_initialize_from_platform_x86_64(out_fields);
 #else
@@ -227,10 +320,43 @@ static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
 static iree_alignas(64) uint64_t
     iree_cpu_data_cache_[IREE_CPU_DATA_FIELD_COUNT] = {0};
 
+// States of iree_cpu_data_cache_.
+enum iree_cpu_data_cache_state_e {
+  IREE_CPU_DATA_CACHE_STATE_UNINITIALIZED = 0,
+  IREE_CPU_DATA_CACHE_STATE_INITIALIZING = 1,
+  IREE_CPU_DATA_CACHE_STATE_INITIALIZED = 2,
+};
+
+// One of iree_cpu_data_cache_state_e. Platform queries may involve syscalls
+// and are only made by the first iree_cpu_initialize in the process.
+static iree_atomic_int32_t iree_cpu_data_cache_state_ =
+    IREE_ATOMIC_VAR_INIT(IREE_CPU_DATA_CACHE_STATE_UNINITIALIZED);
+
 void iree_cpu_initialize(iree_allocator_t temp_allocator) {
+  if (IREE_LIKELY(iree_atomic_load_int32(&iree_cpu_data_cache_state_,
+                                         iree_memory_order_acquire) ==
+                  IREE_CPU_DATA_CACHE_STATE_INITIALIZED)) {
+    return;
+  }
   IREE_TRACE_ZONE_BEGIN(z0);
-  memset(iree_cpu_data_cache_, 0, sizeof(iree_cpu_data_cache_));
-  iree_cpu_initialize_from_platform(temp_allocator, iree_cpu_data_cache_);
+  int32_t expected_state = IREE_CPU_DATA_CACHE_STATE_UNINITIALIZED;
+  if (iree_atomic_compare_exchange_strong_int32(
+          &iree_cpu_data_cache_state_, &expected_state,
+          IREE_CPU_DATA_CACHE_STATE_INITIALIZING, iree_memory_order_acquire,
+          iree_memory_order_acquire)) {
+    memset(iree_cpu_data_cache_, 0, sizeof(iree_cpu_data_cache_));
+    iree_cpu_initialize_from_platform(temp_allocator, iree_cpu_data_cache_);
+    iree_atomic_store_int32(&iree_cpu_data_cache_state_,
+                            IREE_CPU_DATA_CACHE_STATE_INITIALIZED,
+                            iree_memory_order_release);
+  } else {
+    // Another thread is querying the platform; the query is short so we spin
+    // instead of taking a dependency on the threading primitives.
+    while (iree_atomic_load_int32(&iree_cpu_data_cache_state_,
+                                  iree_memory_order_acquire) !=
+           IREE_CPU_DATA_CACHE_STATE_INITIALIZED) {
+    }
+  }
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -240,6 +366,9 @@ void iree_cpu_initialize_with_data(iree_host_size_t field_count,
   memcpy(iree_cpu_data_cache_, fields,
          iree_min(field_count, IREE_ARRAYSIZE(iree_cpu_data_cache_)) *
              sizeof(*iree_cpu_data_cache_));
+  iree_atomic_store_int32(&iree_cpu_data_cache_state_,
+                          IREE_CPU_DATA_CACHE_STATE_INITIALIZED,
+                          iree_memory_order_release);
 }
 
 const uint64_t* iree_cpu_data_fields(void) { return iree_cpu_data_cache_; }
@@ -22,10 +22,16 @@ extern "C" {
 
 // Initializes cached CPU data using |temp_allocator| for any temporary
 // allocations required during initialization.
+// The platform is only queried by the first call in the process and subsequent
+// calls return immediately. Thread-safe.
 void iree_cpu_initialize(iree_allocator_t temp_allocator);
 
 // Initializes cached CPU data with the given fields.
 // Extraneous fields will be ignored and unspecified fields will be set to zero.
+// Subsequent calls to iree_cpu_initialize will not query the platform. This can
+// be used to skip the platform query in processes that are handed the CPU data
+// of the host they run on (such as from iree_cpu_read_data in another process).
+// Not thread-safe with concurrent readers of the CPU data.
 void iree_cpu_initialize_with_data(iree_host_size_t field_count,
                                    const uint64_t* fields);
 
@@ -24,12 +24,30 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#if defined(SYS_memfd_create)
+// memfd_create is called through syscall as older libc versions (including
+// Android prior to API 30) do not expose a wrapper for it.
+#define IREE_DYNAMIC_LIBRARY_HAVE_MEMFD 1
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif  // MFD_CLOEXEC
+#endif  // SYS_memfd_create
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
 struct iree_dynamic_library_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
 
   // dlopen shared object handle.
   void* handle;
+
+  // Anonymous memory file the library was loaded from or -1 if loaded from a
+  // file path. Kept open for the lifetime of the library so that the
+  // /proc/self/fd/ path used to load it is not reused (and deduplicated by the
+  // loader) for another library while this one is loaded.
+  int memfd;
 };
 
 // Allocate a new string from |allocator| returned in |out_file_path| containing
@@ -128,6 +146,7 @@ static iree_status_t iree_dynamic_library_create(
   iree_atomic_ref_count_init(&library->ref_count);
   library->allocator = allocator;
   library->handle = handle;
+  library->memfd = -1;
 
   *out_library = library;
   return iree_ok_status();
@@ -223,10 +242,87 @@ static void iree_dynamic_library_init_temp_dir(void) {
       stat(path, &s) == 0 && (s.st_mode & S_IFMT) == S_IFDIR;
 }
 
-// TODO(#3845): use dlopen on an fd with either dlopen(/proc/self/fd/NN),
-// fdlopen, or android_dlopen_ext to avoid needing to write the file to disk.
-// Can fallback to memfd_create + dlopen where available, and fallback from
-// that to disk (maybe just windows/mac).
+#if defined(IREE_DYNAMIC_LIBRARY_HAVE_MEMFD)
+
+// Set once memfd_create has failed so that we don't keep trying (and failing)
+// for every library in environments that disallow it (old kernels, seccomp
+// filters, etc).
+static iree_atomic_int32_t iree_dynamic_library_memfd_unavailable_ =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Writes all of |buffer| to |fd|.
+static iree_status_t iree_dynamic_library_write_fd(
+    int fd, iree_const_byte_span_t buffer) {
+  const uint8_t* data = buffer.data;
+  size_t remaining = buffer.data_length;
+  while (remaining > 0) {
+    ssize_t written = write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "unable to write %zu bytes to memfd", remaining);
+    }
+    data += written;
+    remaining -= (size_t)written;
+  }
+  return iree_ok_status();
+}
+
+// Loads a library from |buffer| by copying it into an anonymous memory file and
+// opening it by its /proc/self/fd/ path. This avoids touching the filesystem
+// entirely and is much faster than temp files when TMPDIR is slow (overlay
+// filesystems in containers, network mounts, etc).
+static iree_status_t iree_dynamic_library_load_from_memfd(
+    iree_string_view_t identifier, iree_const_byte_span_t buffer,
+    iree_dynamic_library_flags_t flags, iree_allocator_t allocator,
+    iree_dynamic_library_t** out_library) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The name is only used for debugging and shows up in /proc/self/maps.
+  char memfd_name[64];
+  snprintf(memfd_name, sizeof(memfd_name), "iree_dylib_%.*s",
+           (int)iree_min(identifier.size, 48), identifier.data);
+  int fd = (int)syscall(SYS_memfd_create, memfd_name, MFD_CLOEXEC);
+  if (fd < 0) {
+    iree_atomic_store_int32(&iree_dynamic_library_memfd_unavailable_, 1,
+                            iree_memory_order_relaxed);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "memfd_create failed");
+  }
+
+  iree_status_t status = iree_dynamic_library_write_fd(fd, buffer);
+
+  void* handle = NULL;
+  if (iree_status_is_ok(status)) {
+    char fd_path[32];
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
+    handle = dlopen(fd_path, RTLD_LAZY | RTLD_LOCAL);
+    if (!handle) {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "failed to load memfd dynamic library: %s",
+                                dlerror());
+    }
+  }
+
+  iree_dynamic_library_t* library = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_dynamic_library_create(handle, allocator, &library);
+  }
+
+  if (iree_status_is_ok(status)) {
+    library->memfd = fd;
+    *out_library = library;
+  } else {
+    if (handle) dlclose(handle);
+    close(fd);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_DYNAMIC_LIBRARY_HAVE_MEMFD
+
 iree_status_t iree_dynamic_library_load_from_memory(
     iree_string_view_t identifier, iree_const_byte_span_t buffer,
     iree_dynamic_library_flags_t flags, iree_allocator_t allocator,
@@ -238,7 +334,24 @@ iree_status_t iree_dynamic_library_load_from_memory(
   iree_call_once(&iree_dynamic_library_temp_dir_init_once_flag_,
                  iree_dynamic_library_init_temp_dir);
 
+#if defined(IREE_DYNAMIC_LIBRARY_HAVE_MEMFD)
+  // Try loading without touching the filesystem first unless the user wants
+  // the files preserved for tooling. On failure fall back to temp files.
+  if (!iree_dynamic_library_temp_dir_preserve_ &&
+      !iree_atomic_load_int32(&iree_dynamic_library_memfd_unavailable_,
+                              iree_memory_order_relaxed)) {
+    iree_status_t memfd_status = iree_dynamic_library_load_from_memfd(
+        identifier, buffer, flags, allocator, out_library);
+    if (iree_status_is_ok(memfd_status)) {
+      IREE_TRACE_ZONE_END(z0);
+      return memfd_status;
+    }
+    iree_status_ignore(memfd_status);
+  }
+#endif  // IREE_DYNAMIC_LIBRARY_HAVE_MEMFD
+
   if (!iree_dynamic_library_temp_dir_valid_) {
+    IREE_TRACE_ZONE_END(z0);
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
         "path of dylib temp files (%s) is not the path of a directory",
@@ -285,6 +398,11 @@ static void iree_dynamic_library_delete(iree_dynamic_library_t* library) {
   if (library->handle != NULL) {
     dlclose(library->handle);
   }
+  // Only close the memfd once the library is unloaded; when tracing the leaked
+  // library keeps it open as well.
+  if (library->memfd >= 0) {
+    close(library->memfd);
+  }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
   iree_allocator_free(allocator, library);
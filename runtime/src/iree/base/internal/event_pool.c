@@ -21,40 +21,64 @@ struct iree_event_pool_t {
   // relatively low contention: callers are rate limited by how fast they can
   // signal and wait on the events they get.
   iree_slim_mutex_t mutex;
-  // Maximum number of events that will be maintained in the pool. More events
+  // Number of events that are always retained in the pool.
+  iree_host_size_t min_capacity;
+  // Maximum number of events that will be retained in the pool. More events
   // may be allocated at any time but when they are no longer needed they will
   // be disposed directly.
+  iree_host_size_t max_capacity;
+  // Total number of events acquired from the pool and not yet released.
+  iree_host_size_t acquired_count;
+  // Largest acquired_count observed since allocation or the last trim.
+  // Released events are retained while the total number of events owned by
+  // the pool is below this (clamped to [min_capacity, max_capacity]).
+  iree_host_size_t high_water_mark;
+  // Capacity of available_list in events.
   iree_host_size_t available_capacity;
-  // Total number of available
+  // Total number of available events in available_list.
   iree_host_size_t available_count;
   // Dense left-aligned list of available_count events.
-  iree_event_t available_list[];
+  iree_event_t* available_list;
 };
 
-iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
+iree_status_t iree_event_pool_allocate(iree_host_size_t min_capacity,
+                                       iree_host_size_t max_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool) {
   IREE_ASSERT_ARGUMENT(out_event_pool);
   *out_event_pool = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
+  max_capacity = iree_max(min_capacity, max_capacity);
 
   iree_event_pool_t* event_pool = NULL;
-  iree_host_size_t total_size =
-      sizeof(*event_pool) +
-      available_capacity * sizeof(event_pool->available_list[0]);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(host_allocator, total_size, (void**)&event_pool));
+      z0, iree_allocator_malloc(host_allocator, sizeof(*event_pool),
+                                (void**)&event_pool));
   event_pool->host_allocator = host_allocator;
-  event_pool->available_capacity = available_capacity;
+  iree_slim_mutex_initialize(&event_pool->mutex);
+  event_pool->min_capacity = min_capacity;
+  event_pool->max_capacity = max_capacity;
+  event_pool->acquired_count = 0;
+  event_pool->high_water_mark = min_capacity;
+  event_pool->available_capacity = 0;
   event_pool->available_count = 0;
+  event_pool->available_list = NULL;
 
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < available_capacity; ++i) {
+  if (min_capacity > 0) {
+    status = iree_allocator_malloc(
+        host_allocator, min_capacity * sizeof(event_pool->available_list[0]),
+        (void**)&event_pool->available_list);
+    if (iree_status_is_ok(status)) {
+      event_pool->available_capacity = min_capacity;
+    }
+  }
+  for (iree_host_size_t i = 0; i < min_capacity && iree_status_is_ok(status);
+       ++i) {
     status = iree_event_initialize(
         /*initial_state=*/false,
         &event_pool->available_list[event_pool->available_count++]);
-    if (!iree_status_is_ok(status)) break;
+    if (!iree_status_is_ok(status)) --event_pool->available_count;
   }
 
   if (iree_status_is_ok(status)) {
@@ -73,12 +97,50 @@ void iree_event_pool_free(iree_event_pool_t* event_pool) {
   for (iree_host_size_t i = 0; i < event_pool->available_count; ++i) {
     iree_event_deinitialize(&event_pool->available_list[i]);
   }
+  iree_allocator_free(host_allocator, event_pool->available_list);
   iree_slim_mutex_deinitialize(&event_pool->mutex);
   iree_allocator_free(host_allocator, event_pool);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_event_pool_trim(iree_event_pool_t* event_pool) {
+  IREE_ASSERT_ARGUMENT(event_pool);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Detach the events to destroy so that the syscalls happen outside the lock.
+  iree_event_t* trimmed_list = NULL;
+  iree_host_size_t trimmed_count = 0;
+  iree_slim_mutex_lock(&event_pool->mutex);
+  event_pool->high_water_mark =
+      iree_max(event_pool->acquired_count, event_pool->min_capacity);
+  if (event_pool->available_count > event_pool->min_capacity) {
+    trimmed_count = event_pool->available_count - event_pool->min_capacity;
+    iree_status_t status = iree_allocator_malloc(
+        event_pool->host_allocator, trimmed_count * sizeof(iree_event_t),
+        (void**)&trimmed_list);
+    if (iree_status_is_ok(status)) {
+      event_pool->available_count = event_pool->min_capacity;
+      memcpy(trimmed_list,
+             &event_pool->available_list[event_pool->available_count],
+             trimmed_count * sizeof(iree_event_t));
+    } else {
+      // Trimming is best-effort; the events will be reused instead.
+      iree_status_ignore(status);
+      trimmed_count = 0;
+    }
+  }
+  iree_slim_mutex_unlock(&event_pool->mutex);
+
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)trimmed_count);
+  for (iree_host_size_t i = 0; i < trimmed_count; ++i) {
+    iree_event_deinitialize(&trimmed_list[i]);
+  }
+  iree_allocator_free(event_pool->host_allocator, trimmed_list);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
                                       iree_host_size_t event_count,
                                       iree_event_t* out_events) {
@@ -102,6 +164,9 @@ iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
     event_pool->available_count -= from_pool_count;
     remaining_count -= from_pool_count;
   }
+  event_pool->acquired_count += event_count;
+  event_pool->high_water_mark =
+      iree_max(event_pool->high_water_mark, event_pool->acquired_count);
   iree_slim_mutex_unlock(&event_pool->mutex);
 
   // Allocate the rest of the events.
@@ -112,7 +177,11 @@ iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
       status = iree_event_initialize(/*initial_state=*/false,
                                      &out_events[from_pool_count + i]);
       if (!iree_status_is_ok(status)) {
-        // Must release all events we've acquired so far.
+        // Must release all events we've acquired so far. The events we failed
+        // to create are no longer outstanding.
+        iree_slim_mutex_lock(&event_pool->mutex);
+        event_pool->acquired_count -= remaining_count - i;
+        iree_slim_mutex_unlock(&event_pool->mutex);
         iree_event_pool_release(event_pool, from_pool_count + i, out_events);
         IREE_TRACE_ZONE_END(z0);
         return status;
@@ -124,6 +193,27 @@ iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
   return iree_ok_status();
 }
 
+// Grows the available list such that it can hold at least |minimum_capacity|
+// events. Returns false if the list could not be grown.
+// Must be called with the pool mutex held.
+static bool iree_event_pool_grow_available_list_locked(
+    iree_event_pool_t* event_pool, iree_host_size_t minimum_capacity) {
+  if (minimum_capacity <= event_pool->available_capacity) return true;
+  iree_host_size_t new_capacity =
+      iree_min(iree_max(minimum_capacity, event_pool->available_capacity * 2),
+               event_pool->max_capacity);
+  iree_status_t status = iree_allocator_realloc(
+      event_pool->host_allocator,
+      new_capacity * sizeof(event_pool->available_list[0]),
+      (void**)&event_pool->available_list);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  event_pool->available_capacity = new_capacity;
+  return true;
+}
+
 void iree_event_pool_release(iree_event_pool_t* event_pool,
                              iree_host_size_t event_count,
                              iree_event_t* events) {
@@ -135,13 +225,25 @@ void iree_event_pool_release(iree_event_pool_t* event_pool,
   // the ones that won't fit.
   iree_host_size_t remaining_count = event_count;
 
-  // Try first to release to the pool.
+  // Try first to release to the pool. Events are retained up to the
+  // high-water mark of outstanding events so that the pool settles at the size
+  // the workload needs. The events we are releasing still count as acquired
+  // so the retention limit covers every event owned by the pool.
   // Note that we reset the events we add back to the pool so that they are
   // ready to be acquired again.
   iree_slim_mutex_lock(&event_pool->mutex);
+  const iree_host_size_t retain_limit =
+      iree_min(event_pool->high_water_mark, event_pool->max_capacity);
   iree_host_size_t to_pool_count =
-      iree_min(event_pool->available_capacity - event_pool->available_count,
-               event_count);
+      event_pool->available_count < retain_limit
+          ? iree_min(retain_limit - event_pool->available_count, event_count)
+          : 0;
+  if (to_pool_count > 0 &&
+      !iree_event_pool_grow_available_list_locked(
+          event_pool, event_pool->available_count + to_pool_count)) {
+    to_pool_count =
+        event_pool->available_capacity - event_pool->available_count;
+  }
   if (to_pool_count > 0) {
     iree_host_size_t pool_base_index = event_pool->available_count;
     for (iree_host_size_t i = 0; i < to_pool_count; ++i) {
@@ -152,6 +254,7 @@ void iree_event_pool_release(iree_event_pool_t* event_pool,
     event_pool->available_count += to_pool_count;
     remaining_count -= to_pool_count;
   }
+  event_pool->acquired_count -= event_count;
   iree_slim_mutex_unlock(&event_pool->mutex);
 
   // Deallocate the rest of the events. We don't bother resetting them as we are
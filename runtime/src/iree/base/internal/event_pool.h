@@ -16,11 +16,22 @@ extern "C" {
 
 // A simple pool of iree_event_ts to recycle.
 //
+// The pool grows elastically with demand: events released back to the pool are
+// retained up to the largest number of events that have been outstanding at
+// once (the high-water mark) so that steady-state workloads with many
+// concurrent waits don't create and destroy events on every acquire and
+// release. Retention is bounded by the maximum capacity requested when the pool
+// is allocated and iree_event_pool_trim can be used to drop events retained
+// from past peaks.
+//
 // Thread-safe; multiple threads may acquire and release events from the pool.
 typedef struct iree_event_pool_t iree_event_pool_t;
 
-// Allocates a new event pool with up to |available_capacity| events.
-iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
+// Allocates a new event pool with |min_capacity| events created up-front and
+// always retained. Up to |max_capacity| events will be retained when more are
+// outstanding at once; events released beyond that are destroyed.
+iree_status_t iree_event_pool_allocate(iree_host_size_t min_capacity,
+                                       iree_host_size_t max_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool);
 
@@ -29,6 +40,11 @@ iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
 // back to it prior to deallocation.
 void iree_event_pool_free(iree_event_pool_t* event_pool);
 
+// Destroys available events beyond the minimum capacity and resets the
+// high-water mark to the number of events currently outstanding.
+// Events may be acquired from and released to the pool concurrently.
+void iree_event_pool_trim(iree_event_pool_t* event_pool);
+
 // Acquires one or more events from the event pool.
 // The returned events will be unsignaled and ready for use. Callers may set and
 // reset the events as much as they want prior to releasing them back to the
@@ -0,0 +1,135 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/event_pool.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static bool IsSameEvent(const iree_event_t& lhs, const iree_event_t& rhs) {
+  return lhs.type == rhs.type &&
+         memcmp(&lhs.value, &rhs.value, sizeof(lhs.value)) == 0;
+}
+
+static void ExpectUnsignaled(const std::vector<iree_event_t>& events) {
+  for (const iree_event_t& event : events) {
+    iree_event_t wait_event = event;
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_DEADLINE_EXCEEDED,
+                          iree_wait_one(&wait_event, IREE_TIME_INFINITE_PAST));
+  }
+}
+
+TEST(EventPoolTest, AcquireRelease) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*min_capacity=*/4, /*max_capacity=*/16, iree_allocator_system(),
+      &event_pool));
+  std::vector<iree_event_t> events(2);
+  IREE_ASSERT_OK(
+      iree_event_pool_acquire(event_pool, events.size(), events.data()));
+  ExpectUnsignaled(events);
+  iree_event_pool_release(event_pool, events.size(), events.data());
+  iree_event_pool_free(event_pool);
+}
+
+// Events beyond the minimum capacity are retained up to the high-water mark
+// and come back unsignaled even if they were set before being released.
+TEST(EventPoolTest, RetainsToHighWaterMark) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*min_capacity=*/2, /*max_capacity=*/16, iree_allocator_system(),
+      &event_pool));
+
+  std::vector<iree_event_t> events(8);
+  IREE_ASSERT_OK(
+      iree_event_pool_acquire(event_pool, events.size(), events.data()));
+  for (iree_event_t& event : events) iree_event_set(&event);
+  std::vector<iree_event_t> released_events = events;
+  iree_event_pool_release(event_pool, events.size(), events.data());
+
+  IREE_ASSERT_OK(
+      iree_event_pool_acquire(event_pool, events.size(), events.data()));
+  ExpectUnsignaled(events);
+  for (const iree_event_t& event : events) {
+    bool found = false;
+    for (const iree_event_t& released_event : released_events) {
+      found = found || IsSameEvent(event, released_event);
+    }
+    EXPECT_TRUE(found);
+  }
+  iree_event_pool_release(event_pool, events.size(), events.data());
+
+  iree_event_pool_free(event_pool);
+}
+
+// Events released beyond the maximum capacity are destroyed.
+TEST(EventPoolTest, ReleaseBeyondMaxCapacity) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*min_capacity=*/0, /*max_capacity=*/4, iree_allocator_system(),
+      &event_pool));
+  for (int i = 0; i < 3; ++i) {
+    std::vector<iree_event_t> events(8);
+    IREE_ASSERT_OK(
+        iree_event_pool_acquire(event_pool, events.size(), events.data()));
+    ExpectUnsignaled(events);
+    iree_event_pool_release(event_pool, events.size(), events.data());
+  }
+  iree_event_pool_free(event_pool);
+}
+
+// Trimming may happen while events are outstanding.
+TEST(EventPoolTest, TrimWithOutstandingEvents) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*min_capacity=*/1, /*max_capacity=*/32, iree_allocator_system(),
+      &event_pool));
+
+  std::vector<iree_event_t> events(16);
+  IREE_ASSERT_OK(
+      iree_event_pool_acquire(event_pool, events.size(), events.data()));
+  iree_event_pool_release(event_pool, 12, events.data());
+  iree_event_pool_trim(event_pool);
+  iree_event_pool_release(event_pool, 4, events.data() + 12);
+  iree_event_pool_trim(event_pool);
+
+  IREE_ASSERT_OK(
+      iree_event_pool_acquire(event_pool, events.size(), events.data()));
+  ExpectUnsignaled(events);
+  iree_event_pool_release(event_pool, events.size(), events.data());
+  iree_event_pool_free(event_pool);
+}
+
+TEST(EventPoolTest, ConcurrentAcquireRelease) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*min_capacity=*/4, /*max_capacity=*/64, iree_allocator_system(),
+      &event_pool));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 256; ++i) {
+        iree_event_t events[8];
+        const iree_host_size_t event_count = 1 + (i + t) % 8;
+        IREE_ASSERT_OK(
+            iree_event_pool_acquire(event_pool, event_count, events));
+        iree_event_set(&events[0]);
+        iree_event_pool_release(event_pool, event_count, events);
+        if (i % 64 == 0) iree_event_pool_trim(event_pool);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  iree_event_pool_free(event_pool);
+}
+
+}  // namespace
@@ -26,6 +26,14 @@
 #define IREE_SET_BINARY_MODE(handle) ((void)0)
 #endif  // IREE_PLATFORM_WINDOWS
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_FILE_IO_MMAP_POSIX 1
+#include <sys/mman.h>
+#elif defined(IREE_PLATFORM_WINDOWS)
+#define IREE_FILE_IO_MMAP_WIN32 1
+#endif  // IREE_PLATFORM_*
+
 // We could take alignment as an arg, but roughly page aligned should be
 // acceptable for all uses - if someone cares about memory usage they won't
 // be using this method.
@@ -99,8 +107,7 @@ iree_status_t iree_file_contents_allocator_ctl(void* self,
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "only the file contents buffer is valid");
   }
-  iree_allocator_t allocator = contents->allocator;
-  iree_allocator_free(allocator, contents);
+  iree_file_contents_free(contents);
   return iree_ok_status();
 }
 
@@ -113,9 +120,12 @@ iree_allocator_t iree_file_contents_deallocator(
   return allocator;
 }
 
+static void iree_file_contents_unmap(iree_file_contents_t* contents);
+
 void iree_file_contents_free(iree_file_contents_t* contents) {
   if (!contents) return;
   IREE_TRACE_ZONE_BEGIN(z0);
+  if (contents->mapping) iree_file_contents_unmap(contents);
   iree_allocator_free(contents->allocator, contents);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -147,9 +157,10 @@ static iree_status_t iree_file_read_contents_impl(
   contents->buffer.data = (void*)iree_host_align(
       (uintptr_t)contents + sizeof(*contents), IREE_FILE_BASE_ALIGNMENT);
   contents->buffer.data_length = file_size;
+  contents->mapping = NULL;
 
   // Attempt to read the file into memory.
-  if (fread(contents->buffer.data, file_size, 1, file) != 1) {
+  if (file_size > 0 && fread(contents->buffer.data, file_size, 1, file) != 1) {
     iree_allocator_free(allocator, contents);
     return iree_make_status(iree_status_code_from_errno(errno),
                             "unable to read entire %zu file bytes", file_size);
@@ -161,7 +172,121 @@ static iree_status_t iree_file_read_contents_impl(
   return iree_ok_status();
 }
 
+#if defined(IREE_FILE_IO_MMAP_POSIX)
+
+static void iree_file_contents_unmap(iree_file_contents_t* contents) {
+  munmap(contents->mapping, contents->buffer.data_length);
+  contents->mapping = NULL;
+}
+
+// Maps |file| read-only into the process address space.
+// Returns OK with |out_contents| NULL if the file cannot be mapped and the
+// caller should fall back to reading it.
+static iree_status_t iree_file_map_contents_impl(
+    FILE* file, iree_file_read_flags_t flags, iree_allocator_t allocator,
+    iree_file_contents_t** out_contents) {
+  uint64_t file_length = 0;
+  IREE_RETURN_IF_ERROR(iree_file_query_length(file, &file_length));
+  if (file_length == 0 || file_length > IREE_HOST_SIZE_MAX) {
+    return iree_ok_status();  // fallback
+  }
+  iree_host_size_t file_size = (iree_host_size_t)file_length;
+
+  void* base = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fileno(file), 0);
+  if (base == MAP_FAILED) return iree_ok_status();  // fallback
+
+  // Module rodata is sparsely accessed (only the parameters and executables
+  // actually used get touched) so by default we let the kernel perform its
+  // normal on-demand readahead. Callers that know they will touch everything
+  // can request preloading and we'll have the kernel start paging it in.
+  if (flags & IREE_FILE_READ_FLAG_PRELOAD) {
+    madvise(base, file_size, MADV_WILLNEED);
+  }
+
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(allocator, sizeof(*contents), (void**)&contents);
+  if (!iree_status_is_ok(status)) {
+    munmap(base, file_size);
+    return status;
+  }
+  contents->allocator = allocator;
+  contents->buffer.data = (uint8_t*)base;
+  contents->buffer.data_length = file_size;
+  contents->mapping = base;
+  *out_contents = contents;
+  return iree_ok_status();
+}
+
+#elif defined(IREE_FILE_IO_MMAP_WIN32)
+
+static void iree_file_contents_unmap(iree_file_contents_t* contents) {
+  UnmapViewOfFile(contents->buffer.data);
+  CloseHandle((HANDLE)contents->mapping);
+  contents->mapping = NULL;
+}
+
+// Maps |file| read-only into the process address space.
+// Returns OK with |out_contents| NULL if the file cannot be mapped and the
+// caller should fall back to reading it.
+static iree_status_t iree_file_map_contents_impl(
+    FILE* file, iree_file_read_flags_t flags, iree_allocator_t allocator,
+    iree_file_contents_t** out_contents) {
+  uint64_t file_length = 0;
+  IREE_RETURN_IF_ERROR(iree_file_query_length(file, &file_length));
+  if (file_length == 0 || file_length > IREE_HOST_SIZE_MAX) {
+    return iree_ok_status();  // fallback
+  }
+  iree_host_size_t file_size = (iree_host_size_t)file_length;
+
+  HANDLE file_handle = (HANDLE)_get_osfhandle(_fileno(file));
+  if (file_handle == INVALID_HANDLE_VALUE) return iree_ok_status();
+  HANDLE mapping_handle =
+      CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping_handle) return iree_ok_status();  // fallback
+  void* base = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, file_size);
+  if (!base) {
+    CloseHandle(mapping_handle);
+    return iree_ok_status();  // fallback
+  }
+
+#if _WIN32_WINNT >= 0x0602  // _WIN32_WINNT_WIN8
+  if (flags & IREE_FILE_READ_FLAG_PRELOAD) {
+    WIN32_MEMORY_RANGE_ENTRY range = {base, file_size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#endif  // _WIN32_WINNT >= 0x0602
+
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(allocator, sizeof(*contents), (void**)&contents);
+  if (!iree_status_is_ok(status)) {
+    UnmapViewOfFile(base);
+    CloseHandle(mapping_handle);
+    return status;
+  }
+  contents->allocator = allocator;
+  contents->buffer.data = (uint8_t*)base;
+  contents->buffer.data_length = file_size;
+  contents->mapping = (void*)mapping_handle;
+  *out_contents = contents;
+  return iree_ok_status();
+}
+
+#else
+
+static void iree_file_contents_unmap(iree_file_contents_t* contents) {}
+
+static iree_status_t iree_file_map_contents_impl(
+    FILE* file, iree_file_read_flags_t flags, iree_allocator_t allocator,
+    iree_file_contents_t** out_contents) {
+  return iree_ok_status();  // fallback
+}
+
+#endif  // IREE_FILE_IO_MMAP_*
+
 iree_status_t iree_file_read_contents(const char* path,
+                                      iree_file_read_flags_t flags,
                                       iree_allocator_t allocator,
                                       iree_file_contents_t** out_contents) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -176,9 +301,15 @@ iree_status_t iree_file_read_contents(const char* path,
                             "failed to open file '%s'", path);
   }
 
-  // Read the file contents into memory.
-  iree_status_t status =
-      iree_file_read_contents_impl(file, allocator, out_contents);
+  // Try mapping the file first if requested and otherwise (or if mapping is
+  // not possible) read the file contents into memory.
+  iree_status_t status = iree_ok_status();
+  if (flags & IREE_FILE_READ_FLAG_MMAP) {
+    status = iree_file_map_contents_impl(file, flags, allocator, out_contents);
+  }
+  if (iree_status_is_ok(status) && !*out_contents) {
+    status = iree_file_read_contents_impl(file, allocator, out_contents);
+  }
   if (!iree_status_is_ok(status)) {
     status = iree_status_annotate_f(status, "reading file '%s'", path);
   }
@@ -231,6 +362,7 @@ static iree_status_t iree_stdin_read_contents_impl(
       (void**)&contents));
   contents->buffer.data = (void*)iree_host_align(
       (uintptr_t)contents + sizeof(*contents), IREE_FILE_BASE_ALIGNMENT);
+  contents->mapping = NULL;
 
   iree_host_size_t size = 0;
   for (int c = getchar(); c != EOF; c = getchar()) {
@@ -295,6 +427,7 @@ iree_allocator_t iree_file_contents_deallocator(
 void iree_file_contents_free(iree_file_contents_t* contents) {}
 
 iree_status_t iree_file_read_contents(const char* path,
+                                      iree_file_read_flags_t flags,
                                       iree_allocator_t allocator,
                                       iree_file_contents_t** out_contents) {
   return iree_make_status(IREE_STATUS_UNAVAILABLE, "File I/O is disabled");
@@ -29,6 +29,23 @@ iree_status_t iree_file_query_length(FILE* file, uint64_t* out_length);
 // Returns true if |file| position is at |position|.
 bool iree_file_is_at(FILE* file, uint64_t position);
 
+// Controls how file contents are brought into memory.
+enum iree_file_read_flag_bits_t {
+  // Fully reads the file contents into a heap allocation (or when combined
+  // with IREE_FILE_READ_FLAG_MMAP hints to the platform that the mapped pages
+  // will be needed soon so it can prefetch them).
+  IREE_FILE_READ_FLAG_PRELOAD = 1u << 0,
+  // Maps the file contents into the process address space read-only instead of
+  // copying them. Pages are faulted in on demand and are backed by the file
+  // (and page cache) so unreferenced pages never count against process memory.
+  // Mapped contents are not NUL terminated. If mapping is unavailable on the
+  // platform or fails for the particular file (pipes, empty files, etc) the
+  // contents are read into memory as with IREE_FILE_READ_FLAG_PRELOAD.
+  IREE_FILE_READ_FLAG_MMAP = 1u << 1,
+  IREE_FILE_READ_FLAG_DEFAULT = IREE_FILE_READ_FLAG_PRELOAD,
+};
+typedef uint32_t iree_file_read_flags_t;
+
 // Loaded file contents.
 typedef struct iree_file_contents_t {
   iree_allocator_t allocator;
@@ -36,6 +53,9 @@ typedef struct iree_file_contents_t {
     iree_byte_span_t buffer;
     iree_const_byte_span_t const_buffer;
   };
+  // Platform mapping handle when the contents are memory-mapped or NULL if the
+  // contents are stored inline in the allocation.
+  void* mapping;
 } iree_file_contents_t;
 
 // Returns an allocator that deallocates the |contents|.
@@ -46,11 +66,14 @@ iree_allocator_t iree_file_contents_deallocator(iree_file_contents_t* contents);
 void iree_file_contents_free(iree_file_contents_t* contents);
 
 // Synchronously reads a file's contents into memory.
+// When |flags| includes IREE_FILE_READ_FLAG_MMAP the file is mapped read-only
+// and the contents must not be modified.
 //
 // Returns the contents of the file in |out_contents|.
 // |allocator| is used to allocate the memory and the caller must use
 // iree_file_contents_free to release the memory.
 iree_status_t iree_file_read_contents(const char* path,
+                                      iree_file_read_flags_t flags,
                                       iree_allocator_t allocator,
                                       iree_file_contents_t** out_contents);
 
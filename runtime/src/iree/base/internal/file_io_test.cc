@@ -82,7 +82,9 @@ TEST(FileIO, ReadWriteContents) {
 
   // Read the contents from disk.
   iree_file_contents_t* read_contents = NULL;
-  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(), iree_allocator_system(),
+  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(),
+                                         IREE_FILE_READ_FLAG_DEFAULT,
+                                         iree_allocator_system(),
                                          &read_contents));
 
   // Expect the contents are equal.
@@ -94,6 +96,48 @@ TEST(FileIO, ReadWriteContents) {
   iree_file_contents_free(read_contents);
 }
 
+TEST(FileIO, ReadContentsMapped) {
+  constexpr const char* kUniqueName = "ReadContentsMapped";
+  auto path = GetUniquePath(kUniqueName);
+
+  // Generate file contents and write them to disk.
+  auto write_contents = GetUniqueContents(kUniqueName);
+  IREE_ASSERT_OK(iree_file_write_contents(
+      path.c_str(),
+      iree_make_const_byte_span(write_contents.data(), write_contents.size())));
+
+  // Map the contents from disk.
+  iree_file_contents_t* read_contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(), IREE_FILE_READ_FLAG_MMAP,
+                                         iree_allocator_system(),
+                                         &read_contents));
+
+  // Expect the contents are equal.
+  EXPECT_EQ(write_contents.size(), read_contents->const_buffer.data_length);
+  EXPECT_EQ(memcmp(write_contents.data(), read_contents->const_buffer.data,
+                   read_contents->const_buffer.data_length),
+            0);
+
+  // Freeing through the deallocator must also release the mapping.
+  iree_allocator_t deallocator = iree_file_contents_deallocator(read_contents);
+  iree_allocator_free(deallocator, read_contents->buffer.data);
+}
+
+TEST(FileIO, ReadContentsMappedEmpty) {
+  constexpr const char* kUniqueName = "ReadContentsMappedEmpty";
+  auto path = GetUniquePath(kUniqueName);
+
+  // Empty files cannot be mapped and must fall back to reading.
+  IREE_ASSERT_OK(
+      iree_file_write_contents(path.c_str(), iree_const_byte_span_empty()));
+  iree_file_contents_t* read_contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(), IREE_FILE_READ_FLAG_MMAP,
+                                         iree_allocator_system(),
+                                         &read_contents));
+  EXPECT_EQ(0, read_contents->const_buffer.data_length);
+  iree_file_contents_free(read_contents);
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
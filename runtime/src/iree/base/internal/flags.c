@@ -506,7 +506,8 @@ static iree_status_t iree_flags_parse_file(iree_string_view_t file_path) {
   iree_allocator_t allocator = iree_flags_leaky_allocator();
   iree_file_contents_t* file_contents = NULL;
   IREE_RETURN_IF_ERROR(
-      iree_file_read_contents(file_path.data, allocator, &file_contents),
+      iree_file_read_contents(file_path.data, IREE_FILE_READ_FLAG_DEFAULT,
+                              allocator, &file_contents),
       "while trying to parse flagfile");
 
   // Run through the file line-by-line.
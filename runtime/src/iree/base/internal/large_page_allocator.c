@@ -0,0 +1,178 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/large_page_allocator.h"
+
+#include <string.h>
+
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+// Large pages are transparent huge pages requested with madvise. hugetlbfs is
+// not used as it requires a preallocated pool that is rarely configured.
+#if (defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)) && \
+    defined(MADV_HUGEPAGE)
+#define IREE_LARGE_PAGE_ALLOCATOR_ENABLE 1
+#else
+#define IREE_LARGE_PAGE_ALLOCATOR_ENABLE 0
+#endif  // MADV_HUGEPAGE
+
+#if IREE_LARGE_PAGE_ALLOCATOR_ENABLE
+
+// Prefix of each allocation recording how it must be freed.
+typedef struct iree_large_page_header_t {
+  // Length of the mapping starting at the header or 0 if the allocation is
+  // from the system allocator.
+  uint64_t mapped_length;
+  // Length of the allocation following the header in bytes.
+  uint64_t byte_length;
+} iree_large_page_header_t;
+static_assert(sizeof(iree_large_page_header_t) % iree_max_align_t == 0,
+              "header must preserve the natural alignment of allocations");
+
+iree_host_size_t iree_large_page_size(void) {
+  // The size of a page table directory entry: one page of 8-byte entries each
+  // mapping a normal page (2MB with 4KB pages on x86_64 and aarch64).
+  iree_host_size_t page_size = (iree_host_size_t)sysconf(_SC_PAGESIZE);
+  return page_size * page_size / 8;
+}
+
+static iree_status_t iree_large_page_map(iree_host_size_t mapped_length,
+                                         iree_host_size_t alignment,
+                                         void** out_ptr) {
+  // Over-map so that the mapping can be trimmed to an aligned base, as only
+  // aligned ranges can be backed by large pages.
+  iree_host_size_t reserve_length = mapped_length + alignment;
+  uint8_t* reserve_base =
+      (uint8_t*)mmap(NULL, reserve_length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (reserve_base == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "large page mapping of %" PRIhsz " bytes failed",
+                            mapped_length);
+  }
+  uint8_t* base =
+      (uint8_t*)iree_host_align((iree_host_size_t)reserve_base, alignment);
+  if (base > reserve_base) munmap(reserve_base, base - reserve_base);
+  uint8_t* reserve_end = reserve_base + reserve_length;
+  uint8_t* end = base + mapped_length;
+  if (reserve_end > end) munmap(end, reserve_end - end);
+
+  // Advice failures (such as THP being disabled) just mean normal pages.
+  madvise(base, mapped_length, MADV_HUGEPAGE);
+  *out_ptr = base;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_large_page_allocate(iree_allocator_command_t command,
+                                              iree_host_size_t byte_length,
+                                              void** out_ptr) {
+  *out_ptr = NULL;
+  iree_large_page_header_t* header = NULL;
+  const iree_host_size_t total_length = sizeof(*header) + byte_length;
+  const iree_host_size_t large_page_size = iree_large_page_size();
+  if (byte_length < large_page_size) {
+    // Too small to cover a large page.
+    iree_allocator_alloc_params_t params = {.byte_length = total_length};
+    IREE_RETURN_IF_ERROR(iree_allocator_system_ctl(
+        NULL,
+        command == IREE_ALLOCATOR_COMMAND_CALLOC
+            ? IREE_ALLOCATOR_COMMAND_CALLOC
+            : IREE_ALLOCATOR_COMMAND_MALLOC,
+        &params, (void**)&header));
+    header->mapped_length = 0;
+  } else {
+    // Fresh anonymous mappings are always zeroed.
+    const iree_host_size_t mapped_length = iree_host_align(
+        total_length, (iree_host_size_t)sysconf(_SC_PAGESIZE));
+    IREE_RETURN_IF_ERROR(
+        iree_large_page_map(mapped_length, large_page_size, (void**)&header));
+    IREE_TRACE_ALLOC(header, mapped_length);
+    header->mapped_length = mapped_length;
+  }
+  header->byte_length = byte_length;
+  *out_ptr = header + 1;
+  return iree_ok_status();
+}
+
+static void iree_large_page_free(void* ptr) {
+  iree_large_page_header_t* header = (iree_large_page_header_t*)ptr - 1;
+  if (header->mapped_length) {
+    IREE_TRACE_FREE(header);
+    munmap(header, (size_t)header->mapped_length);
+  } else {
+    iree_status_ignore(iree_allocator_system_ctl(
+        NULL, IREE_ALLOCATOR_COMMAND_FREE, NULL, (void**)&header));
+  }
+}
+
+iree_status_t iree_allocator_large_page_ctl(void* self,
+                                            iree_allocator_command_t command,
+                                            const void* params,
+                                            void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+    case IREE_ALLOCATOR_COMMAND_REALLOC: {
+      iree_host_size_t byte_length =
+          ((const iree_allocator_alloc_params_t*)params)->byte_length;
+      if (IREE_UNLIKELY(byte_length == 0)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "allocations must be >0 bytes");
+      }
+      IREE_TRACE_ZONE_BEGIN(z0);
+      void* existing_ptr =
+          command == IREE_ALLOCATOR_COMMAND_REALLOC ? *inout_ptr : NULL;
+      void* new_ptr = NULL;
+      iree_status_t status =
+          iree_large_page_allocate(command, byte_length, &new_ptr);
+      if (iree_status_is_ok(status) && existing_ptr) {
+        // Large allocations move between mappings so reallocation always
+        // copies; it's expected to be rare for these allocations.
+        const iree_large_page_header_t* existing_header =
+            (const iree_large_page_header_t*)existing_ptr - 1;
+        memcpy(new_ptr, existing_ptr,
+               (iree_host_size_t)iree_min(existing_header->byte_length,
+                                          byte_length));
+        iree_large_page_free(existing_ptr);
+      }
+      if (iree_status_is_ok(status)) *inout_ptr = new_ptr;
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      if (*inout_ptr) {
+        IREE_TRACE_ZONE_BEGIN(z0);
+        iree_large_page_free(*inout_ptr);
+        *inout_ptr = NULL;
+        IREE_TRACE_ZONE_END(z0);
+      }
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported large page allocator command");
+  }
+}
+
+#else
+
+iree_host_size_t iree_large_page_size(void) { return 0; }
+
+iree_status_t iree_allocator_large_page_ctl(void* self,
+                                            iree_allocator_command_t command,
+                                            const void* params,
+                                            void** inout_ptr) {
+  return iree_allocator_system_ctl(NULL, command, params, inout_ptr);
+}
+
+#endif  // IREE_LARGE_PAGE_ALLOCATOR_ENABLE
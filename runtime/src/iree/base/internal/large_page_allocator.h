@@ -0,0 +1,43 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_LARGE_PAGE_ALLOCATOR_H_
+#define IREE_BASE_INTERNAL_LARGE_PAGE_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns the size of the large pages used by iree_allocator_large_page or 0
+// if the host does not support them.
+iree_host_size_t iree_large_page_size(void);
+
+// Control function for iree_allocator_large_page.
+iree_status_t iree_allocator_large_page_ctl(void* self,
+                                            iree_allocator_command_t command,
+                                            const void* params,
+                                            void** inout_ptr);
+
+// Returns an allocator for large, long-lived allocations such as buffer
+// storage. Allocations of at least iree_large_page_size bytes are mapped
+// directly from the system and backed by large (huge) pages where possible to
+// reduce TLB misses when streaming through them. Smaller allocations, and all
+// allocations on hosts without large page support, use the system allocator.
+//
+// Large allocations are rounded up to the normal page size and take a system
+// call to allocate and free; callers should pool them if they are frequent.
+static inline iree_allocator_t iree_allocator_large_page(void) {
+  iree_allocator_t v = {NULL, iree_allocator_large_page_ctl};
+  return v;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_LARGE_PAGE_ALLOCATOR_H_
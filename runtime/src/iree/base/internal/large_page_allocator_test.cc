@@ -0,0 +1,72 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/large_page_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Returns a size that takes the large page path when supported.
+iree_host_size_t LargeAllocationSize() {
+  iree_host_size_t large_page_size = iree_large_page_size();
+  return large_page_size ? 2 * large_page_size + 123 : 4 * 1024 * 1024 + 123;
+}
+
+TEST(LargePageAllocatorTest, SmallAllocation) {
+  iree_allocator_t allocator = iree_allocator_large_page();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 100, (void**)&ptr));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, (uintptr_t)ptr % iree_max_align_t);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(0, ptr[i]);
+  memset(ptr, 0xCD, 100);
+  iree_allocator_free(allocator, ptr);
+}
+
+TEST(LargePageAllocatorTest, LargeAllocation) {
+  iree_allocator_t allocator = iree_allocator_large_page();
+  const iree_host_size_t size = LargeAllocationSize();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, size, (void**)&ptr));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, (uintptr_t)ptr % iree_max_align_t);
+  EXPECT_EQ(0, ptr[0]);
+  EXPECT_EQ(0, ptr[size - 1]);
+  memset(ptr, 0xCD, size);
+  iree_allocator_free(allocator, ptr);
+}
+
+TEST(LargePageAllocatorTest, AlignedAllocation) {
+  iree_allocator_t allocator = iree_allocator_large_page();
+  const iree_host_size_t size = LargeAllocationSize();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc_aligned(allocator, size, 64,
+                                               /*offset=*/0, (void**)&ptr));
+  EXPECT_EQ(0u, (uintptr_t)ptr % 64);
+  memset(ptr, 0xCD, size);
+  iree_allocator_free_aligned(allocator, ptr);
+}
+
+TEST(LargePageAllocatorTest, ReallocGrowsAcrossThreshold) {
+  iree_allocator_t allocator = iree_allocator_large_page();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 64, (void**)&ptr));
+  for (int i = 0; i < 64; ++i) ptr[i] = (uint8_t)i;
+  const iree_host_size_t size = LargeAllocationSize();
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, size, (void**)&ptr));
+  for (int i = 0; i < 64; ++i) EXPECT_EQ((uint8_t)i, ptr[i]);
+  ptr[size - 1] = 0xAB;
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 32, (void**)&ptr));
+  for (int i = 0; i < 32; ++i) EXPECT_EQ((uint8_t)i, ptr[i]);
+  iree_allocator_free(allocator, ptr);
+}
+
+}  // namespace
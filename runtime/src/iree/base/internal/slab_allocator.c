@@ -0,0 +1,618 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/slab_allocator.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomic_slist.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+// Sanitizers track heap objects through the system allocator and would miss
+// use-after-free and overflows of objects recycled within slabs.
+#if defined(IREE_SANITIZER_ADDRESS) || defined(IREE_SANITIZER_MEMORY)
+#define IREE_SLAB_ALLOCATOR_ENABLE 0
+#else
+#define IREE_SLAB_ALLOCATOR_ENABLE 1
+#endif  // IREE_SANITIZER_ADDRESS || IREE_SANITIZER_MEMORY
+
+#if IREE_SLAB_ALLOCATOR_ENABLE
+
+//===----------------------------------------------------------------------===//
+// Size classes
+//===----------------------------------------------------------------------===//
+
+// Size classes cover object sizes (including the object header) in 16 byte
+// steps up to 128 bytes and then 4 classes per power of two up to 8KB. This
+// bounds internal fragmentation to 25% for all but the smallest objects.
+//
+// Class:  0   1   2   3   4   5    6    7    8    9    10   11  ... 30
+// Size:   32  48  64  80  96  112  128  160  192  224  256  320 ... 8192
+#define IREE_SLAB_SIZE_CLASS_COUNT 31
+
+// Size class used to mark allocations forwarded to the system allocator.
+#define IREE_SLAB_SIZE_CLASS_LARGE UINT32_MAX
+
+// Size of each slab allocated from the system allocator for small objects.
+// Must hold at least one object of the largest size class.
+#define IREE_SLAB_ALLOCATOR_SLAB_SIZE (64 * 1024)
+
+// Approximate size, in bytes, of the batches of objects moved between thread
+// caches and the shared lists. Thread caches retain up to two batches of each
+// size class.
+#define IREE_SLAB_ALLOCATOR_BATCH_SIZE (4 * 1024)
+
+// Maximum number of objects in a batch.
+#define IREE_SLAB_ALLOCATOR_MAX_BATCH_COUNT 64
+
+// Prefix of each allocation recording how it must be freed.
+typedef struct iree_slab_object_header_t {
+  // Size class of the object or IREE_SLAB_SIZE_CLASS_LARGE.
+  uint32_t size_class;
+  // Number of objects in the batch headed by this object when it is stored in
+  // a shared list.
+  uint32_t batch_count;
+  // Length of the allocation including the header for large allocations.
+  uint64_t byte_length;
+} iree_slab_object_header_t;
+static_assert(sizeof(iree_slab_object_header_t) % iree_max_align_t == 0,
+              "header must preserve the natural alignment of allocations");
+
+// A free object in a thread cache or shared list.
+typedef struct iree_slab_free_object_t {
+  iree_slab_object_header_t header;
+  // Next free object in the thread cache or batch.
+  struct iree_slab_free_object_t* next;
+  // Next batch in the shared list when the object heads a batch.
+  iree_atomic_slist_intrusive_ptr_t batch_next;
+} iree_slab_free_object_t;
+
+// The smallest size class must be able to hold a free object.
+static_assert(sizeof(iree_slab_free_object_t) <= 32,
+              "free objects must fit in the smallest size class");
+
+IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_slab_batch, iree_slab_free_object_t,
+                                offsetof(iree_slab_free_object_t,
+                                         batch_next));
+
+// Returns the size class of objects of |object_size| bytes in (16, 8192].
+static uint32_t iree_slab_size_class_index(iree_host_size_t object_size) {
+  if (object_size <= 128) {
+    return (uint32_t)((object_size + 15) / 16 - 2);
+  }
+  const int log2_size =
+      63 - iree_math_count_leading_zeros_u64((uint64_t)(object_size - 1));
+  const uint32_t subclass =
+      (uint32_t)(((object_size - 1) >> (log2_size - 2)) & 3);
+  return 7 + (uint32_t)(log2_size - 7) * 4 + subclass;
+}
+
+// Returns the object size, in bytes, of |size_class| including its header.
+static iree_host_size_t iree_slab_size_class_object_size(uint32_t size_class) {
+  if (size_class < 7) return (iree_host_size_t)(size_class + 2) * 16;
+  const uint32_t log2_size = 7 + (size_class - 7) / 4;
+  const uint32_t subclass = (size_class - 7) % 4;
+  return (iree_host_size_t)(5 + subclass) << (log2_size - 2);
+}
+
+// Returns the number of objects in each batch of |size_class|.
+static uint32_t iree_slab_size_class_batch_count(uint32_t size_class) {
+  const iree_host_size_t count = IREE_SLAB_ALLOCATOR_BATCH_SIZE /
+                                 iree_slab_size_class_object_size(size_class);
+  return (uint32_t)iree_max(
+      1, iree_min(count, IREE_SLAB_ALLOCATOR_MAX_BATCH_COUNT));
+}
+
+//===----------------------------------------------------------------------===//
+// Shared state
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+// Small objects are tracked in their own pool as their slabs are already
+// tracked as allocations from the system allocator.
+static const char* IREE_SLAB_ALLOCATOR_ID = "iree_allocator_slab";
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
+typedef struct iree_slab_allocator_state_t {
+  // Batches of free objects available to any thread for each size class.
+  iree_slab_batch_slist_t batches[IREE_SLAB_SIZE_CLASS_COUNT];
+  // Bytes held from the system allocator in slabs and large allocations.
+  iree_atomic_intptr_t reserved_byte_length;
+  // Bytes of free objects in the batches lists.
+  iree_atomic_intptr_t cached_byte_length;
+  // Number of allocations made from the system allocator.
+  iree_atomic_intptr_t system_allocation_count;
+} iree_slab_allocator_state_t;
+
+static iree_slab_allocator_state_t iree_slab_allocator_state;
+static iree_once_flag iree_slab_allocator_state_once_flag = IREE_ONCE_FLAG_INIT;
+
+static void iree_slab_allocator_state_initialize(void) {
+  for (uint32_t i = 0; i < IREE_SLAB_SIZE_CLASS_COUNT; ++i) {
+    iree_slab_batch_slist_initialize(&iree_slab_allocator_state.batches[i]);
+  }
+}
+
+// Returns the shared state, initializing it on first use. Only needed on the
+// slow paths that move objects between thread caches and shared lists.
+static iree_slab_allocator_state_t* iree_slab_allocator_state_get(void) {
+  iree_call_once(&iree_slab_allocator_state_once_flag,
+                 iree_slab_allocator_state_initialize);
+  return &iree_slab_allocator_state;
+}
+
+static void iree_slab_allocator_counter_add(iree_atomic_intptr_t* counter,
+                                            iree_host_size_t value) {
+  iree_atomic_fetch_add_intptr(counter, (intptr_t)value,
+                               iree_memory_order_relaxed);
+}
+
+static void iree_slab_allocator_counter_sub(iree_atomic_intptr_t* counter,
+                                            iree_host_size_t value) {
+  iree_atomic_fetch_sub_intptr(counter, (intptr_t)value,
+                               iree_memory_order_relaxed);
+}
+
+//===----------------------------------------------------------------------===//
+// Thread caches
+//===----------------------------------------------------------------------===//
+
+// Free objects of one size class cached by a thread.
+typedef struct iree_slab_thread_bin_t {
+  iree_slab_free_object_t* head;
+  uint32_t count;
+} iree_slab_thread_bin_t;
+
+// Free objects cached by a thread. Each thread's cache is allocated the first
+// time the thread allocates or frees a small object and is stored in a pthread
+// key (or fiber local storage slot on Windows) whose destructor returns the
+// cached objects to the shared lists when the thread exits. The destructor
+// never touches compiler thread-local storage as some platforms tear that down
+// first.
+typedef struct iree_slab_thread_cache_t {
+  iree_slab_thread_bin_t bins[IREE_SLAB_SIZE_CLASS_COUNT];
+} iree_slab_thread_cache_t;
+
+static void iree_slab_allocator_spill(uint32_t size_class,
+                                      iree_slab_thread_bin_t* bin);
+
+// Returns all objects in |cache| to the shared lists.
+static void iree_slab_thread_cache_trim(iree_slab_thread_cache_t* cache) {
+  for (uint32_t i = 0; i < IREE_SLAB_SIZE_CLASS_COUNT; ++i) {
+    while (cache->bins[i].count > 0) {
+      iree_slab_allocator_spill(i, &cache->bins[i]);
+    }
+  }
+}
+
+// Returns the objects in the |cache_ptr| of an exiting thread to the shared
+// lists and frees the cache.
+static void iree_slab_thread_cache_destroy(void* cache_ptr) {
+  iree_slab_thread_cache_t* cache = (iree_slab_thread_cache_t*)cache_ptr;
+  if (!cache) return;
+  iree_slab_thread_cache_trim(cache);
+  iree_allocator_free(iree_allocator_system(), cache);
+}
+
+#if defined(IREE_PLATFORM_WINDOWS)
+
+static iree_once_flag iree_slab_thread_cache_slot_once = IREE_ONCE_FLAG_INIT;
+static DWORD iree_slab_thread_cache_fls_index = FLS_OUT_OF_INDEXES;
+
+static void NTAPI iree_slab_thread_cache_fls_callback(void* cache_ptr) {
+  iree_slab_thread_cache_destroy(cache_ptr);
+}
+
+static void iree_slab_thread_cache_slot_initialize(void) {
+  iree_slab_thread_cache_fls_index =
+      FlsAlloc(iree_slab_thread_cache_fls_callback);
+}
+
+// Returns the calling thread's cache or NULL if it has not been created.
+static iree_slab_thread_cache_t* iree_slab_thread_cache_get(void) {
+  iree_call_once(&iree_slab_thread_cache_slot_once,
+                 iree_slab_thread_cache_slot_initialize);
+  if (iree_slab_thread_cache_fls_index == FLS_OUT_OF_INDEXES) return NULL;
+  return (iree_slab_thread_cache_t*)FlsGetValue(
+      iree_slab_thread_cache_fls_index);
+}
+
+// Sets the calling thread's |cache| and returns true if it will be destroyed
+// when the thread exits.
+static bool iree_slab_thread_cache_set(iree_slab_thread_cache_t* cache) {
+  return iree_slab_thread_cache_fls_index != FLS_OUT_OF_INDEXES &&
+         FlsSetValue(iree_slab_thread_cache_fls_index, cache);
+}
+
+#elif !IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+static iree_once_flag iree_slab_thread_cache_slot_once = IREE_ONCE_FLAG_INIT;
+static pthread_key_t iree_slab_thread_cache_key;
+static bool iree_slab_thread_cache_key_valid = false;
+
+static void iree_slab_thread_cache_slot_initialize(void) {
+  iree_slab_thread_cache_key_valid =
+      pthread_key_create(&iree_slab_thread_cache_key,
+                         iree_slab_thread_cache_destroy) == 0;
+}
+
+// Returns the calling thread's cache or NULL if it has not been created.
+static iree_slab_thread_cache_t* iree_slab_thread_cache_get(void) {
+  iree_call_once(&iree_slab_thread_cache_slot_once,
+                 iree_slab_thread_cache_slot_initialize);
+  if (!iree_slab_thread_cache_key_valid) return NULL;
+  return (iree_slab_thread_cache_t*)pthread_getspecific(
+      iree_slab_thread_cache_key);
+}
+
+// Sets the calling thread's |cache| and returns true if it will be destroyed
+// when the thread exits.
+static bool iree_slab_thread_cache_set(iree_slab_thread_cache_t* cache) {
+  return iree_slab_thread_cache_key_valid &&
+         pthread_setspecific(iree_slab_thread_cache_key, cache) == 0;
+}
+
+#else
+
+// Without threads the single cache lives as long as the process.
+static iree_slab_thread_cache_t* iree_slab_thread_cache_instance = NULL;
+
+static iree_slab_thread_cache_t* iree_slab_thread_cache_get(void) {
+  return iree_slab_thread_cache_instance;
+}
+
+static bool iree_slab_thread_cache_set(iree_slab_thread_cache_t* cache) {
+  iree_slab_thread_cache_instance = cache;
+  return true;
+}
+
+#endif  // IREE_PLATFORM_WINDOWS / !IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+// Returns the calling thread's cache, creating it if needed, or NULL if a cache
+// is not available.
+static iree_slab_thread_cache_t* iree_slab_thread_cache_get_or_create(void) {
+  iree_slab_thread_cache_t* cache = iree_slab_thread_cache_get();
+  if (IREE_LIKELY(cache)) return cache;
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*cache), (void**)&cache);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  if (!iree_slab_thread_cache_set(cache)) {
+    iree_allocator_free(host_allocator, cache);
+    return NULL;
+  }
+  return cache;
+}
+
+// Carves a new slab into objects of |size_class|, keeping one batch in |bin|
+// and publishing the rest to the shared list.
+static iree_status_t iree_slab_allocator_carve_slab(
+    iree_slab_allocator_state_t* state, uint32_t size_class,
+    iree_slab_thread_bin_t* bin) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  uint8_t* slab = NULL;
+  iree_allocator_alloc_params_t params = {
+      .byte_length = IREE_SLAB_ALLOCATOR_SLAB_SIZE,
+  };
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_system_ctl(NULL, IREE_ALLOCATOR_COMMAND_MALLOC,
+                                    &params, (void**)&slab));
+  iree_slab_allocator_counter_add(&state->reserved_byte_length,
+                                  IREE_SLAB_ALLOCATOR_SLAB_SIZE);
+  iree_slab_allocator_counter_add(&state->system_allocation_count, 1);
+
+  // Split the slab into batches of objects linked through |next| with the
+  // batches linked through |batch_next|.
+  const iree_host_size_t object_size =
+      iree_slab_size_class_object_size(size_class);
+  const uint32_t object_count =
+      (uint32_t)(IREE_SLAB_ALLOCATOR_SLAB_SIZE / object_size);
+  const uint32_t batch_count = iree_slab_size_class_batch_count(size_class);
+  iree_slab_free_object_t* first_batch = NULL;
+  iree_slab_free_object_t* last_batch = NULL;
+  for (uint32_t i = 0; i < object_count; i += batch_count) {
+    const uint32_t count = iree_min(batch_count, object_count - i);
+    iree_slab_free_object_t* batch =
+        (iree_slab_free_object_t*)(slab + i * object_size);
+    for (uint32_t j = 0; j < count; ++j) {
+      iree_slab_free_object_t* object =
+          (iree_slab_free_object_t*)(slab + (i + j) * object_size);
+      object->header.size_class = size_class;
+      object->next = j + 1 < count
+                         ? (iree_slab_free_object_t*)(slab + (i + j + 1) *
+                                                                 object_size)
+                         : NULL;
+    }
+    batch->header.batch_count = count;
+    iree_slab_batch_slist_set_next(batch, NULL);
+    if (last_batch) iree_slab_batch_slist_set_next(last_batch, batch);
+    if (!first_batch) first_batch = batch;
+    last_batch = batch;
+  }
+
+  bin->head = first_batch;
+  bin->count = first_batch->header.batch_count;
+  iree_slab_free_object_t* shared_head =
+      iree_slab_batch_slist_get_next(first_batch);
+  if (shared_head) {
+    iree_slab_allocator_counter_add(
+        &state->cached_byte_length,
+        (object_count - first_batch->header.batch_count) * object_size);
+    iree_slab_batch_slist_concat(&state->batches[size_class], shared_head,
+                                 last_batch);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Refills the empty |bin| of |size_class| with a batch from the shared list or
+// a new slab if none are available.
+static iree_status_t iree_slab_allocator_refill(uint32_t size_class,
+                                                iree_slab_thread_bin_t* bin) {
+  iree_slab_allocator_state_t* state = iree_slab_allocator_state_get();
+  iree_slab_free_object_t* batch =
+      iree_slab_batch_slist_pop(&state->batches[size_class]);
+  if (!batch) {
+    return iree_slab_allocator_carve_slab(state, size_class, bin);
+  }
+  bin->head = batch;
+  bin->count = batch->header.batch_count;
+  iree_slab_allocator_counter_sub(
+      &state->cached_byte_length,
+      batch->header.batch_count * iree_slab_size_class_object_size(size_class));
+  return iree_ok_status();
+}
+
+// Moves one batch of objects from |bin| of |size_class| to the shared list.
+static void iree_slab_allocator_spill(uint32_t size_class,
+                                      iree_slab_thread_bin_t* bin) {
+  iree_slab_allocator_state_t* state = iree_slab_allocator_state_get();
+  const uint32_t batch_count = iree_min(
+      bin->count, iree_slab_size_class_batch_count(size_class));
+  iree_slab_free_object_t* batch = bin->head;
+  iree_slab_free_object_t* last = batch;
+  for (uint32_t i = 1; i < batch_count; ++i) last = last->next;
+  bin->head = last->next;
+  bin->count -= batch_count;
+  last->next = NULL;
+  batch->header.batch_count = batch_count;
+  iree_slab_allocator_counter_add(
+      &state->cached_byte_length,
+      batch_count * iree_slab_size_class_object_size(size_class));
+  iree_slab_batch_slist_push(&state->batches[size_class], batch);
+}
+
+void iree_allocator_slab_trim_thread_cache(void) {
+  iree_slab_thread_cache_t* cache = iree_slab_thread_cache_get();
+  if (cache) iree_slab_thread_cache_trim(cache);
+}
+
+//===----------------------------------------------------------------------===//
+// Allocation
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_slab_allocator_allocate_small(
+    iree_slab_thread_cache_t* cache, uint32_t size_class,
+    iree_host_size_t byte_length, void** out_ptr) {
+  iree_slab_thread_bin_t* bin = &cache->bins[size_class];
+  if (IREE_UNLIKELY(!bin->head)) {
+    IREE_RETURN_IF_ERROR(iree_slab_allocator_refill(size_class, bin));
+  }
+  iree_slab_free_object_t* object = bin->head;
+  bin->head = object->next;
+  --bin->count;
+  void* ptr = &object->header + 1;
+  IREE_TRACE_ALLOC_NAMED(IREE_SLAB_ALLOCATOR_ID, ptr, byte_length);
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+static void iree_slab_allocator_free_small(iree_slab_object_header_t* header) {
+  IREE_TRACE_FREE_NAMED(IREE_SLAB_ALLOCATOR_ID, header + 1);
+  const uint32_t size_class = header->size_class;
+  iree_slab_free_object_t* object = (iree_slab_free_object_t*)header;
+  iree_slab_thread_cache_t* cache = iree_slab_thread_cache_get_or_create();
+  if (IREE_UNLIKELY(!cache)) {
+    // Without a thread cache the object is shared as a batch of its own.
+    iree_slab_allocator_state_t* state = iree_slab_allocator_state_get();
+    object->next = NULL;
+    object->header.batch_count = 1;
+    iree_slab_allocator_counter_add(
+        &state->cached_byte_length,
+        iree_slab_size_class_object_size(size_class));
+    iree_slab_batch_slist_push(&state->batches[size_class], object);
+    return;
+  }
+  iree_slab_thread_bin_t* bin = &cache->bins[size_class];
+  object->next = bin->head;
+  bin->head = object;
+  if (IREE_UNLIKELY(++bin->count >=
+                    2 * iree_slab_size_class_batch_count(size_class))) {
+    iree_slab_allocator_spill(size_class, bin);
+  }
+}
+
+static iree_status_t iree_slab_allocator_allocate_large(
+    iree_allocator_command_t command, iree_host_size_t byte_length,
+    void** out_ptr) {
+  const iree_host_size_t total_length =
+      sizeof(iree_slab_object_header_t) + byte_length;
+  iree_allocator_alloc_params_t params = {.byte_length = total_length};
+  iree_slab_object_header_t* header = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_system_ctl(
+      NULL,
+      command == IREE_ALLOCATOR_COMMAND_CALLOC ? IREE_ALLOCATOR_COMMAND_CALLOC
+                                               : IREE_ALLOCATOR_COMMAND_MALLOC,
+      &params, (void**)&header));
+  header->size_class = IREE_SLAB_SIZE_CLASS_LARGE;
+  header->byte_length = total_length;
+  iree_slab_allocator_state_t* state = &iree_slab_allocator_state;
+  iree_slab_allocator_counter_add(&state->reserved_byte_length, total_length);
+  iree_slab_allocator_counter_add(&state->system_allocation_count, 1);
+  *out_ptr = header + 1;
+  return iree_ok_status();
+}
+
+static void iree_slab_allocator_free_large(iree_slab_object_header_t* header) {
+  iree_slab_allocator_counter_sub(
+      &iree_slab_allocator_state.reserved_byte_length,
+      (iree_host_size_t)header->byte_length);
+  iree_status_ignore(iree_allocator_system_ctl(
+      NULL, IREE_ALLOCATOR_COMMAND_FREE, NULL, (void**)&header));
+}
+
+static iree_status_t iree_slab_allocator_allocate(
+    iree_allocator_command_t command, iree_host_size_t byte_length,
+    void** out_ptr) {
+  if (byte_length > IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE) {
+    if (IREE_UNLIKELY(byte_length > IREE_HOST_SIZE_MAX -
+                                        sizeof(iree_slab_object_header_t))) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "allocation of %" PRIhsz " bytes is too large",
+                              byte_length);
+    }
+    return iree_slab_allocator_allocate_large(command, byte_length, out_ptr);
+  }
+  iree_slab_thread_cache_t* cache = iree_slab_thread_cache_get_or_create();
+  if (IREE_UNLIKELY(!cache)) {
+    // Objects can't be carved from slabs without a thread cache to hold the
+    // rest of their batch.
+    return iree_slab_allocator_allocate_large(command, byte_length, out_ptr);
+  }
+  const uint32_t size_class = iree_slab_size_class_index(
+      sizeof(iree_slab_object_header_t) + byte_length);
+  IREE_RETURN_IF_ERROR(iree_slab_allocator_allocate_small(
+      cache, size_class, byte_length, out_ptr));
+  if (command == IREE_ALLOCATOR_COMMAND_CALLOC) {
+    memset(*out_ptr, 0, byte_length);
+  }
+  return iree_ok_status();
+}
+
+static void iree_slab_allocator_free(void* ptr) {
+  iree_slab_object_header_t* header = (iree_slab_object_header_t*)ptr - 1;
+  if (header->size_class == IREE_SLAB_SIZE_CLASS_LARGE) {
+    iree_slab_allocator_free_large(header);
+  } else {
+    iree_slab_allocator_free_small(header);
+  }
+}
+
+static iree_status_t iree_slab_allocator_reallocate(
+    iree_host_size_t byte_length, void** inout_ptr) {
+  iree_slab_object_header_t* header =
+      (iree_slab_object_header_t*)*inout_ptr - 1;
+  const bool is_large = header->size_class == IREE_SLAB_SIZE_CLASS_LARGE;
+  const iree_host_size_t capacity =
+      (is_large ? (iree_host_size_t)header->byte_length
+                : iree_slab_size_class_object_size(header->size_class)) -
+      sizeof(*header);
+
+  if (!is_large && byte_length <= capacity) {
+    // Fits in the existing object; shrinking in place wastes at most the
+    // existing object's size class which was already being used.
+    IREE_TRACE_FREE_NAMED(IREE_SLAB_ALLOCATOR_ID, *inout_ptr);
+    IREE_TRACE_ALLOC_NAMED(IREE_SLAB_ALLOCATOR_ID, *inout_ptr, byte_length);
+    return iree_ok_status();
+  } else if (is_large && byte_length > IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE &&
+             byte_length <= IREE_HOST_SIZE_MAX - sizeof(*header)) {
+    // Large to large reallocations can grow or shrink in place.
+    const iree_host_size_t existing_length =
+        (iree_host_size_t)header->byte_length;
+    iree_allocator_alloc_params_t params = {
+        .byte_length = sizeof(*header) + byte_length,
+    };
+    IREE_RETURN_IF_ERROR(iree_allocator_system_ctl(
+        NULL, IREE_ALLOCATOR_COMMAND_REALLOC, &params, (void**)&header));
+    header->byte_length = params.byte_length;
+    iree_slab_allocator_state_t* state = &iree_slab_allocator_state;
+    iree_slab_allocator_counter_sub(&state->reserved_byte_length,
+                                    existing_length);
+    iree_slab_allocator_counter_add(&state->reserved_byte_length,
+                                    params.byte_length);
+    *inout_ptr = header + 1;
+    return iree_ok_status();
+  }
+
+  // Moving between size classes or between slabs and the system allocator.
+  void* new_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_slab_allocator_allocate(
+      IREE_ALLOCATOR_COMMAND_MALLOC, byte_length, &new_ptr));
+  memcpy(new_ptr, *inout_ptr, iree_min(capacity, byte_length));
+  iree_slab_allocator_free(*inout_ptr);
+  *inout_ptr = new_ptr;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_slab_allocator_query_statistics(
+    iree_allocator_statistics_t* out_statistics) {
+  iree_slab_allocator_state_t* state = iree_slab_allocator_state_get();
+  out_statistics->reserved_byte_length =
+      (iree_host_size_t)iree_atomic_load_intptr(&state->reserved_byte_length,
+                                                iree_memory_order_relaxed);
+  out_statistics->cached_byte_length =
+      (iree_host_size_t)iree_atomic_load_intptr(&state->cached_byte_length,
+                                                iree_memory_order_relaxed);
+  out_statistics->system_allocation_count =
+      (iree_host_size_t)iree_atomic_load_intptr(
+          &state->system_allocation_count, iree_memory_order_relaxed);
+  return iree_ok_status();
+}
+
+iree_status_t iree_allocator_slab_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+    case IREE_ALLOCATOR_COMMAND_REALLOC: {
+      iree_host_size_t byte_length =
+          ((const iree_allocator_alloc_params_t*)params)->byte_length;
+      if (IREE_UNLIKELY(byte_length == 0)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "allocations must be >0 bytes");
+      }
+      if (command == IREE_ALLOCATOR_COMMAND_REALLOC && *inout_ptr) {
+        return iree_slab_allocator_reallocate(byte_length, inout_ptr);
+      }
+      return iree_slab_allocator_allocate(command, byte_length, inout_ptr);
+    }
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      if (*inout_ptr) {
+        iree_slab_allocator_free(*inout_ptr);
+        *inout_ptr = NULL;
+      }
+      return iree_ok_status();
+    case IREE_ALLOCATOR_COMMAND_QUERY_STATISTICS:
+      return iree_slab_allocator_query_statistics(
+          (iree_allocator_statistics_t*)*inout_ptr);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported slab allocator command");
+  }
+}
+
+#else
+
+void iree_allocator_slab_trim_thread_cache(void) {}
+
+iree_status_t iree_allocator_slab_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr) {
+  return iree_allocator_system_ctl(NULL, command, params, inout_ptr);
+}
+
+#endif  // IREE_SLAB_ALLOCATOR_ENABLE
@@ -0,0 +1,60 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_SLAB_ALLOCATOR_H_
+#define IREE_BASE_INTERNAL_SLAB_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Largest allocation, in bytes, served from size-class slabs by
+// iree_allocator_slab. Larger allocations go to the system allocator.
+#define IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE (8 * 1024 - 16)
+
+// Control function for iree_allocator_slab.
+iree_status_t iree_allocator_slab_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr);
+
+// Returns a process-wide allocator tuned for many small, short-lived
+// allocations made from many threads, such as VM lists and refs, HAL resources
+// and statuses.
+//
+// Small allocations are rounded up to one of a set of size classes and carved
+// out of slabs obtained from the system allocator. Each thread caches a few
+// free objects of each size class so that most allocations and frees complete
+// without synchronization, and objects move between threads through lock-free
+// lists shared by all threads in batches. Allocations larger than
+// IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE are forwarded to the system allocator.
+//
+// Slab memory is retained for the lifetime of the process and is not returned
+// to the system: the allocator trades peak memory for throughput and avoids
+// the fragmentation of mixing short-lived small objects with long-lived ones
+// in the system heap. Memory may be freed on any thread.
+//
+// Objects cached by a thread are returned to the shared lists when the thread
+// exits or calls iree_allocator_slab_trim_thread_cache.
+//
+// Supports IREE_ALLOCATOR_COMMAND_QUERY_STATISTICS. Builds with address or
+// memory sanitizers use the system allocator so that heap checks still apply.
+static inline iree_allocator_t iree_allocator_slab(void) {
+  iree_allocator_t v = {NULL, iree_allocator_slab_ctl};
+  return v;
+}
+
+// Returns the objects cached by the calling thread to the lists shared across
+// threads. Threads that are about to go idle can call this to make their
+// cached objects available to other threads before they exit.
+void iree_allocator_slab_trim_thread_cache(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_SLAB_ALLOCATOR_H_
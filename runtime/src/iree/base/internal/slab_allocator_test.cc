@@ -0,0 +1,179 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/slab_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+TEST(SlabAllocatorTest, SmallAllocation) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 100, (void**)&ptr));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, (uintptr_t)ptr % iree_max_align_t);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(0, ptr[i]);
+  memset(ptr, 0xCD, 100);
+  iree_allocator_free(allocator, ptr);
+
+  // Recycled objects must still be zeroed when requested.
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 100, (void**)&ptr));
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(0, ptr[i]);
+  iree_allocator_free(allocator, ptr);
+}
+
+TEST(SlabAllocatorTest, LargeAllocation) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  const iree_host_size_t size = IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE + 1;
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, size, (void**)&ptr));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, (uintptr_t)ptr % iree_max_align_t);
+  EXPECT_EQ(0, ptr[0]);
+  EXPECT_EQ(0, ptr[size - 1]);
+  memset(ptr, 0xCD, size);
+  iree_allocator_free(allocator, ptr);
+}
+
+// Allocates objects of every size up to past the small size limit and ensures
+// none of them overlap.
+TEST(SlabAllocatorTest, AllSizes) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  const iree_host_size_t max_size = IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE + 64;
+  std::vector<uint8_t*> ptrs(max_size + 1, nullptr);
+  for (iree_host_size_t size = 1; size <= max_size; ++size) {
+    IREE_ASSERT_OK(iree_allocator_malloc_uninitialized(allocator, size,
+                                                       (void**)&ptrs[size]));
+    EXPECT_EQ(0u, (uintptr_t)ptrs[size] % iree_max_align_t);
+    memset(ptrs[size], (int)(size & 0xFF), size);
+  }
+  for (iree_host_size_t size = 1; size <= max_size; ++size) {
+    const uint8_t value = (uint8_t)(size & 0xFF);
+    ASSERT_EQ(value, ptrs[size][0]) << "size " << size;
+    ASSERT_EQ(value, ptrs[size][size - 1]) << "size " << size;
+    iree_allocator_free(allocator, ptrs[size]);
+  }
+}
+
+TEST(SlabAllocatorTest, ReallocPreservesContents) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 16, (void**)&ptr));
+  for (int i = 0; i < 16; ++i) ptr[i] = (uint8_t)i;
+
+  // Grow within the small sizes, past them, and back.
+  const iree_host_size_t sizes[] = {
+      24, 200, 4000, IREE_SLAB_ALLOCATOR_MAX_SMALL_SIZE + 1, 64 * 1024, 100, 8,
+  };
+  for (iree_host_size_t size : sizes) {
+    IREE_ASSERT_OK(iree_allocator_realloc(allocator, size, (void**)&ptr));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(0u, (uintptr_t)ptr % iree_max_align_t);
+    for (int i = 0; i < 8; ++i) ASSERT_EQ((uint8_t)i, ptr[i]);
+    ptr[size - 1] = 0xCD;
+  }
+  iree_allocator_free(allocator, ptr);
+}
+
+TEST(SlabAllocatorTest, AlignedAllocation) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc_aligned(allocator, 100, 64,
+                                               /*offset=*/0, (void**)&ptr));
+  EXPECT_EQ(0u, (uintptr_t)ptr % 64);
+  memset(ptr, 0xCD, 100);
+  iree_allocator_free_aligned(allocator, ptr);
+}
+
+TEST(SlabAllocatorTest, QueryStatistics) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 64 * 1024, &ptr));
+  iree_allocator_statistics_t statistics;
+  iree_status_t status =
+      iree_allocator_query_statistics(allocator, &statistics);
+  if (iree_status_is_unimplemented(status)) {
+    // Sanitizer builds forward to the system allocator.
+    iree_status_ignore(status);
+  } else {
+    IREE_ASSERT_OK(status);
+    EXPECT_GE(statistics.reserved_byte_length, 64 * 1024u);
+    EXPECT_GE(statistics.system_allocation_count, 1u);
+  }
+  iree_allocator_free(allocator, ptr);
+}
+
+// Frees objects on threads other than the ones that allocated them so that
+// objects migrate between thread caches through the shared lists.
+TEST(SlabAllocatorTest, CrossThreadFree) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  static constexpr int kThreadCount = 4;
+  static constexpr int kObjectCount = 4096;
+  std::vector<std::vector<uint8_t*>> objects(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kObjectCount; ++i) {
+        const iree_host_size_t size = 1 + (i * 37 + t * 11) % 512;
+        uint8_t* ptr = NULL;
+        IREE_ASSERT_OK(
+            iree_allocator_malloc_uninitialized(allocator, size, (void**)&ptr));
+        memset(ptr, t, size);
+        objects[t].push_back(ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  threads.clear();
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&, t]() {
+      const int owner = (t + 1) % kThreadCount;
+      for (uint8_t* ptr : objects[owner]) {
+        EXPECT_EQ(owner, ptr[0]);
+        iree_allocator_free(allocator, ptr);
+      }
+      iree_allocator_slab_trim_thread_cache();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+// Objects cached by a thread that exits without trimming its cache are
+// returned to the shared lists.
+TEST(SlabAllocatorTest, ThreadExitReturnsCache) {
+  iree_allocator_t allocator = iree_allocator_slab();
+  iree_allocator_statistics_t exiting_statistics;
+  iree_status_t exiting_status = iree_ok_status();
+  std::thread thread([&]() {
+    void* ptr = NULL;
+    exiting_status = iree_allocator_malloc(allocator, 100, &ptr);
+    if (!iree_status_is_ok(exiting_status)) return;
+    iree_allocator_free(allocator, ptr);
+    exiting_status =
+        iree_allocator_query_statistics(allocator, &exiting_statistics);
+  });
+  thread.join();
+  if (iree_status_is_unimplemented(exiting_status)) {
+    // Sanitizer builds forward to the system allocator.
+    iree_status_ignore(exiting_status);
+    GTEST_SKIP();
+  }
+  IREE_ASSERT_OK(exiting_status);
+
+  iree_allocator_statistics_t statistics;
+  IREE_ASSERT_OK(iree_allocator_query_statistics(allocator, &statistics));
+  EXPECT_GT(statistics.cached_byte_length,
+            exiting_statistics.cached_byte_length);
+}
+
+}  // namespace
@@ -634,36 +634,52 @@ void iree_notification_initialize(iree_notification_t* out_notification) {
 void iree_notification_deinitialize(iree_notification_t* notification) {
   // Assert no more waiters (callers must tear down waiters first).
   pthread_mutex_lock(&notification->mutex);
-  SYNC_ASSERT(notification->waiters == 0);
+  SYNC_ASSERT(iree_atomic_load_int32(&notification->waiters,
+                                     iree_memory_order_acquire) == 0);
   pthread_cond_destroy(&notification->cond);
   pthread_mutex_unlock(&notification->mutex);
   pthread_mutex_destroy(&notification->mutex);
 }
 
-void iree_notification_post(iree_notification_t* notification, int32_t count) {
-  pthread_mutex_lock(&notification->mutex);
-  ++notification->epoch;
-  if (notification->waiters > 0) {
-    // NOTE: we only do the signal if we have waiters - this avoids a syscall
-    // in cases where no one is actively listening.
-    if (count == IREE_ALL_WAITERS) {
-      pthread_cond_broadcast(&notification->cond);
-    } else {
-      for (int32_t i = 0; i < count; ++i) {
-        pthread_cond_signal(&notification->cond);
-      }
+// Wakes up to |count| of |waiter_count| threads blocked on the condition
+// variable. Must be called with the notification mutex held.
+static void iree_notification_signal_locked(iree_notification_t* notification,
+                                            int32_t count,
+                                            int32_t waiter_count) {
+  if (count >= waiter_count) {
+    pthread_cond_broadcast(&notification->cond);
+  } else {
+    for (int32_t i = 0; i < count; ++i) {
+      pthread_cond_signal(&notification->cond);
     }
   }
+}
+
+void iree_notification_post(iree_notification_t* notification, int32_t count) {
+  // The epoch is advanced before checking for waiters while
+  // iree_notification_prepare_wait registers a waiter before reading the
+  // epoch. With sequentially consistent ordering either we observe the waiter
+  // or the waiter observes the new epoch, so skipping the mutex when there are
+  // no waiters can't lose a wake.
+  iree_atomic_fetch_add_int32(&notification->epoch, 1,
+                              iree_memory_order_seq_cst);
+  int32_t waiter_count =
+      iree_atomic_load_int32(&notification->waiters, iree_memory_order_seq_cst);
+  if (waiter_count == 0) return;
+
+  // Waiters check the epoch with the mutex held before blocking so signaling
+  // with it held ensures that they either see the new epoch or get woken.
+  pthread_mutex_lock(&notification->mutex);
+  iree_notification_signal_locked(notification, count, waiter_count);
   pthread_mutex_unlock(&notification->mutex);
 }
 
 iree_wait_token_t iree_notification_prepare_wait(
     iree_notification_t* notification) {
-  pthread_mutex_lock(&notification->mutex);
-  iree_wait_token_t epoch = notification->epoch;
-  ++notification->waiters;
-  pthread_mutex_unlock(&notification->mutex);
-  return epoch;
+  iree_atomic_fetch_add_int32(&notification->waiters, 1,
+                              iree_memory_order_seq_cst);
+  return (iree_wait_token_t)iree_atomic_load_int32(&notification->epoch,
+                                                   iree_memory_order_seq_cst);
 }
 
 bool iree_notification_commit_wait(iree_notification_t* notification,
@@ -680,7 +696,8 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
   // Spin until notified and the epoch increments from what we captured during
   // iree_notification_prepare_wait.
   bool result = true;
-  while (notification->epoch == wait_token) {
+  while ((iree_wait_token_t)iree_atomic_load_int32(
+             &notification->epoch, iree_memory_order_acquire) == wait_token) {
     int ret = pthread_cond_timedwait(&notification->cond, &notification->mutex,
                                      &abs_ts);
     if (ret != 0) {
@@ -693,21 +710,21 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
     }
   }
 
+  pthread_mutex_unlock(&notification->mutex);
+
   // Remove us from the waiter list - the caller will need to reacquire a wait
   // token if it wants to wait again.
-  SYNC_ASSERT(notification->waiters > 0);
-  --notification->waiters;
-
-  pthread_mutex_unlock(&notification->mutex);
+  int32_t previous_count = iree_atomic_fetch_sub_int32(
+      &notification->waiters, 1, iree_memory_order_acq_rel);
+  SYNC_ASSERT(previous_count > 0);
 
   return result;
 }
 
 void iree_notification_cancel_wait(iree_notification_t* notification) {
-  pthread_mutex_lock(&notification->mutex);
-  SYNC_ASSERT(notification->waiters > 0);
-  --notification->waiters;
-  pthread_mutex_unlock(&notification->mutex);
+  int32_t previous_count = iree_atomic_fetch_sub_int32(
+      &notification->waiters, 1, iree_memory_order_acq_rel);
+  SYNC_ASSERT(previous_count > 0);
 }
 
 #else
@@ -758,7 +775,12 @@ void iree_notification_post(iree_notification_t* notification, int32_t count) {
       &notification->value, IREE_NOTIFICATION_EPOCH_INC,
       iree_memory_order_acq_rel);
   // Ensure we have at least one waiter; wake up to |count| of them.
-  if (IREE_UNLIKELY(previous_value & IREE_NOTIFICATION_WAITER_MASK)) {
+  const uint32_t waiter_count =
+      (uint32_t)(previous_value & IREE_NOTIFICATION_WAITER_MASK);
+  if (IREE_UNLIKELY(waiter_count)) {
+    // Waking at least as many threads as are waiting is the same as waking
+    // all of them, which platforms without a counted wake can do in one call.
+    if ((uint32_t)count >= waiter_count) count = IREE_ALL_WAITERS;
     iree_futex_wake(iree_notification_epoch_address(notification), count);
   }
 }
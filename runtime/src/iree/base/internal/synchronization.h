@@ -349,10 +349,12 @@ typedef struct iree_notification_t {
   int reserved;
 #elif !defined(IREE_PLATFORM_HAS_FUTEX)
   // No futex on darwin/when using TSAN, so use mutex/condvar instead.
+  // The epoch and waiter count are atomic so that posts with no waiters and
+  // wait preparation don't need to take the mutex.
   pthread_mutex_t mutex;
   pthread_cond_t cond;
-  uint32_t epoch;
-  uint32_t waiters;
+  iree_atomic_int32_t epoch;
+  iree_atomic_int32_t waiters;
 #else
   iree_atomic_int64_t value;
 #endif  // IREE_PLATFORM_*
@@ -362,8 +364,11 @@ typedef struct iree_notification_t {
 #define IREE_NOTIFICATION_INIT \
   { IREE_ATOMIC_VAR_INIT(0) }
 #elif !defined(IREE_PLATFORM_HAS_FUTEX)
-#define IREE_NOTIFICATION_INIT \
-  { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0 }
+#define IREE_NOTIFICATION_INIT                                   \
+  {                                                              \
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,         \
+        IREE_ATOMIC_VAR_INIT(0), IREE_ATOMIC_VAR_INIT(0)         \
+  }
 #else
 #define IREE_NOTIFICATION_INIT \
   { IREE_ATOMIC_VAR_INIT(0) }
@@ -380,6 +385,10 @@ void iree_notification_deinitialize(iree_notification_t* notification);
 // check to see if they need to do any additional work.
 // To notify all potential waiters pass IREE_ALL_WAITERS.
 //
+// Posting is a single atomic operation when there are no waiters. When
+// |count| covers all current waiters they are woken with one system call
+// instead of one per waiter.
+//
 // Acts as (at least) a memory_order_release operation on the
 // notification object. See the comment on iree_notification_commit_wait, which
 // is the memory_order_acquire operation that is meant to pair with that.
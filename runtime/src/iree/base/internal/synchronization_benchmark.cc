@@ -6,6 +6,8 @@
 
 #include <cstddef>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "iree/base/internal/synchronization.h"
@@ -249,8 +251,103 @@ BENCHMARK_TEMPLATE(BM_Contended, std::mutex)
 // iree_notification_t
 //==============================================================================
 
-// TODO(benvanik): benchmark this; it should in the worst case be as bad as
-// mutex/futex (as that's what is used), but at the moment we don't really
-// care beyond that.
+// Posting with no waiters is the common case for workers and semaphores that
+// are already running and should not enter the kernel.
+void BM_NotificationPostNoWaiters(benchmark::State& state) {
+  static iree_notification_t notification = IREE_NOTIFICATION_INIT;
+  for (auto _ : state) {
+    iree_notification_post(&notification, IREE_ALL_WAITERS);
+  }
+}
+BENCHMARK(BM_NotificationPostNoWaiters)
+    ->UseRealTime()
+    ->Threads(1)
+    ->ThreadPerCpu();
+
+// A generation counter along with the notification posted when it changes.
+struct NotifiedCounter {
+  NotifiedCounter() {
+    iree_notification_initialize(&notification);
+    iree_atomic_store_int32(&value, 0, iree_memory_order_relaxed);
+  }
+  ~NotifiedCounter() { iree_notification_deinitialize(&notification); }
+
+  void Add(int32_t delta) {
+    iree_atomic_fetch_add_int32(&value, delta, iree_memory_order_release);
+    iree_notification_post(&notification, IREE_ALL_WAITERS);
+  }
+
+  // Makes all current and future waiters return false from Await.
+  void Stop() {
+    iree_atomic_store_int32(&value, -1, iree_memory_order_release);
+    iree_notification_post(&notification, IREE_ALL_WAITERS);
+  }
+
+  // Blocks until the value is at least |minimum_value| and returns true, or
+  // returns false if the counter has been stopped.
+  bool Await(int32_t minimum_value) {
+    struct Params {
+      NotifiedCounter* counter;
+      int32_t minimum_value;
+    } params = {this, minimum_value};
+    iree_notification_await(
+        &notification,
+        +[](void* arg) -> bool {
+          auto* params = reinterpret_cast<Params*>(arg);
+          int32_t value = iree_atomic_load_int32(&params->counter->value,
+                                                 iree_memory_order_acquire);
+          return value < 0 || value >= params->minimum_value;
+        },
+        &params, iree_infinite_timeout());
+    return iree_atomic_load_int32(&value, iree_memory_order_acquire) >= 0;
+  }
+
+  iree_notification_t notification;
+  iree_atomic_int32_t value;
+};
+
+// Measures post-to-wake latency as the round trip of a ping between two
+// threads that each block on a notification until the other posts.
+void BM_NotificationPingPong(benchmark::State& state) {
+  NotifiedCounter ping;
+  NotifiedCounter pong;
+  std::thread thread([&]() {
+    for (int32_t i = 1; ping.Await(i); ++i) {
+      pong.Add(1);
+    }
+  });
+  int32_t i = 0;
+  for (auto _ : state) {
+    ping.Add(1);
+    pong.Await(++i);
+  }
+  ping.Stop();
+  thread.join();
+}
+BENCHMARK(BM_NotificationPingPong)->UseRealTime();
+
+// Measures waking a number of blocked threads with a single post and waiting
+// for all of them to acknowledge the wake.
+void BM_NotificationFanOut(benchmark::State& state) {
+  const int waiter_count = static_cast<int>(state.range(0));
+  NotifiedCounter generation;
+  NotifiedCounter acks;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < waiter_count; ++t) {
+    threads.emplace_back([&]() {
+      for (int32_t i = 1; generation.Await(i); ++i) {
+        acks.Add(1);
+      }
+    });
+  }
+  int32_t i = 0;
+  for (auto _ : state) {
+    generation.Add(1);
+    acks.Await(++i * waiter_count);
+  }
+  generation.Stop();
+  for (auto& thread : threads) thread.join();
+}
+BENCHMARK(BM_NotificationFanOut)->UseRealTime()->Arg(1)->Arg(4)->Arg(16);
 
 }  // namespace
@@ -263,14 +263,36 @@ static struct sched_param iree_thread_sched_param_for_priority_class(
   return param;
 }
 
+#if defined(IREE_PLATFORM_ANDROID)
+
+// Maps an IREE iree_thread_priority_class_t value to a nice value matching the
+// ANDROID_PRIORITY_* values from ThreadDefs.h.
+static int iree_thread_nice_value_for_priority_class(
+    iree_thread_priority_class_t priority_class) {
+  switch (priority_class) {
+    case IREE_THREAD_PRIORITY_CLASS_LOWEST:
+      return 19;  // ANDROID_PRIORITY_LOWEST
+    case IREE_THREAD_PRIORITY_CLASS_LOW:
+      return 10;  // ANDROID_PRIORITY_BACKGROUND
+    case IREE_THREAD_PRIORITY_CLASS_HIGH:
+      return -2;  // ANDROID_PRIORITY_FOREGROUND
+    case IREE_THREAD_PRIORITY_CLASS_HIGHEST:
+      return -4;  // ANDROID_PRIORITY_DISPLAY
+    case IREE_THREAD_PRIORITY_CLASS_NORMAL:
+    default:
+      return 0;  // ANDROID_PRIORITY_NORMAL
+  }
+}
+
+#endif  // IREE_PLATFORM_ANDROID
+
 // Sets the thread priority to the given |priority_class|, resetting any
 // previous value.
 //
-// NOTE: this probably doesn't work on Android, because Android.
-// They seem to use linux LWPs and setpriority/nice on the tid will actually
-// change the priority. It doesn't seem possible to elevate priority above
-// normal (without root), but it would at least be useful to be able to
-// indicate background threads.
+// NOTE: Android threads run under SCHED_OTHER where the pthread priority range
+// is empty. Each thread is an LWP with its own nice value, which is what the
+// framework changes as well. Raising the priority may fail when RLIMIT_NICE
+// doesn't allow it and failures are ignored as the priority is only a hint.
 //
 // See:
 // https://stackoverflow.com/questions/17398075/change-native-thread-priority-on-android-in-c-c
@@ -282,8 +304,13 @@ static void iree_thread_set_priority_class(
     iree_thread_t* thread, iree_thread_priority_class_t priority_class) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_EMSCRIPTEN)
-  // TODO(benvanik): Some sort of solution on Android, if possible (see above)
+#if defined(IREE_PLATFORM_ANDROID)
+#if __ANDROID_API__ >= 21
+  pid_t tid = pthread_gettid_np(thread->handle);
+  setpriority(PRIO_PROCESS, tid,
+              iree_thread_nice_value_for_priority_class(priority_class));
+#endif  // __ANDROID_API__ >= 21
+#elif defined(IREE_PLATFORM_EMSCRIPTEN)
   // TODO(benvanik): Some sort of solution on Emscripten, if possible
 #else
   int policy = 0;
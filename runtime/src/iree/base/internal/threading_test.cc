@@ -163,6 +163,44 @@ TEST(ThreadTest, PriorityOverride) {
   iree_thread_release(thread);
 }
 
+//==============================================================================
+// IREE_THREAD_LOCAL
+//==============================================================================
+
+static IREE_THREAD_LOCAL int32_t thread_local_counter = 0;
+
+// Each thread starts with its own zero-initialized instance and writes made on
+// one thread are not visible on any other.
+TEST(ThreadLocalTest, PerThreadInstances) {
+  thread_local_counter = 123;
+  int32_t* main_thread_ptr = &thread_local_counter;
+
+  static const int kThreadCount = 4;
+  static const int kIncrementCount = 1000;
+  int32_t initial_values[kThreadCount];
+  int32_t final_values[kThreadCount];
+  int32_t* thread_ptrs[kThreadCount];
+  std::thread threads[kThreadCount];
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads[i] = std::thread([&, i]() {
+      initial_values[i] = thread_local_counter;
+      for (int j = 0; j < kIncrementCount; ++j) ++thread_local_counter;
+      final_values[i] = thread_local_counter;
+      thread_ptrs[i] = &thread_local_counter;
+    });
+  }
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads[i].join();
+  }
+
+  for (int i = 0; i < kThreadCount; ++i) {
+    EXPECT_EQ(initial_values[i], 0);
+    EXPECT_EQ(final_values[i], kIncrementCount);
+    EXPECT_NE(thread_ptrs[i], main_thread_ptr);
+  }
+  EXPECT_EQ(thread_local_counter, 123);
+}
+
 //==============================================================================
 // iree_thread_override_list_t
 //==============================================================================
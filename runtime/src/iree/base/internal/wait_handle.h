@@ -125,6 +125,8 @@ bool iree_wait_set_is_empty(const iree_wait_set_t* set);
 // Inserts a wait handle into the set.
 // If the handle is already in the set it will be reference counted such that a
 // matching number of iree_wait_set_erase calls are required.
+// Returns IREE_STATUS_RESOURCE_EXHAUSTED without any message if the set is at
+// its capacity so callers can cheaply grow it and retry.
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle);
 
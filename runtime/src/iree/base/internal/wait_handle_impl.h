@@ -41,9 +41,21 @@
 #define IREE_WAIT_API_PPOLL 4
 #define IREE_WAIT_API_EPOLL 5
 #define IREE_WAIT_API_KQUEUE 6
+#define IREE_WAIT_API_IO_URING 7
 
 // We allow overriding the wait API via command line flags. If unspecified we
 // try to guess based on the target platform.
+//
+// IREE_WAIT_API_IO_URING is Linux-only (5.11+) and must be explicitly selected
+// with -DIREE_WAIT_API=IREE_WAIT_API_IO_URING. It keeps poll requests
+// registered with the kernel across waits and batches registration, removal,
+// and waiting into a single syscall which benefits sets with many handles.
+//
+// IREE_WAIT_API_INPROC may be selected on any platform with
+// -DIREE_WAIT_API=IREE_WAIT_API_INPROC when wait handles never need to be
+// exported to or imported from the OS (such as with the local task driver).
+// Events are then futex-backed and avoid a file descriptor and a syscall per
+// set/reset; waits on OS handles are no longer supported.
 #if !defined(IREE_WAIT_API)
 
 // NOTE: we could be tighter here, but we today only have win32 or not-win32.
@@ -70,10 +82,11 @@
 
 // Many implementations share the same posix-like nature (file descriptors/etc)
 // and can share most of their code.
-#if (IREE_WAIT_API == IREE_WAIT_API_POLL) ||  \
-    (IREE_WAIT_API == IREE_WAIT_API_PPOLL) || \
-    (IREE_WAIT_API == IREE_WAIT_API_EPOLL) || \
-    (IREE_WAIT_API == IREE_WAIT_API_KQUEUE)
+#if (IREE_WAIT_API == IREE_WAIT_API_POLL) ||   \
+    (IREE_WAIT_API == IREE_WAIT_API_PPOLL) ||  \
+    (IREE_WAIT_API == IREE_WAIT_API_EPOLL) ||  \
+    (IREE_WAIT_API == IREE_WAIT_API_KQUEUE) || \
+    (IREE_WAIT_API == IREE_WAIT_API_IO_URING)
 #define IREE_WAIT_API_POSIX_LIKE 1
 #endif  // IREE_WAIT_API = posix-like
 
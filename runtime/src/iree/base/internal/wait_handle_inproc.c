@@ -152,10 +152,8 @@ bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
   if (set->total_handle_count + 1 > set->capacity) {
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                            "wait set capacity %" PRIhsz
-                            " reached; no more wait handles available",
-                            set->capacity);
+    // Expected by callers that grow the set on demand.
+    return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
   } else if (handle.type != IREE_WAIT_PRIMITIVE_TYPE_LOCAL_FUTEX) {
     return iree_make_status(
         IREE_STATUS_UNIMPLEMENTED,
@@ -0,0 +1,606 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// NOTE: must be first to ensure that we can define settings for all includes.
+#include "iree/base/internal/wait_handle_impl.h"
+
+#if IREE_WAIT_API == IREE_WAIT_API_IO_URING
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "iree/base/internal/wait_handle_posix.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// Platform utilities
+//===----------------------------------------------------------------------===//
+
+// We issue the syscalls directly instead of depending on liburing. Only the
+// small subset of the API required for poll requests is used.
+//
+// Documentation: https://man7.org/linux/man-pages/man7/io_uring.7.html
+
+static int iree_syscall_io_uring_setup(unsigned entries,
+                                       struct io_uring_params* params) {
+  return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int iree_syscall_io_uring_enter(int fd, unsigned to_submit,
+                                       unsigned min_complete, unsigned flags,
+                                       const void* arg, size_t arg_size) {
+  return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                      arg, arg_size);
+}
+
+// Maximum number of ring entries supported by the kernel (IORING_MAX_ENTRIES).
+#define IREE_IO_URING_MAX_ENTRIES 32768
+
+// user_data of submissions whose completions are ignored (poll removals).
+#define IREE_IO_URING_USER_DATA_IGNORED UINT64_MAX
+
+//===----------------------------------------------------------------------===//
+// iree_wait_set_t
+//===----------------------------------------------------------------------===//
+
+enum iree_wait_set_slot_flag_bits_t {
+  // Slot has a handle inserted.
+  IREE_WAIT_SET_SLOT_FLAG_IN_USE = 1u << 0,
+  // A poll request is in-flight in the kernel for the slot.
+  IREE_WAIT_SET_SLOT_FLAG_ARMED = 1u << 1,
+  // The handle was observed signaled during the current wait.
+  IREE_WAIT_SET_SLOT_FLAG_SIGNALED = 1u << 2,
+};
+typedef uint32_t iree_wait_set_slot_flags_t;
+
+// Storage for a handle in the set.
+// Slots are stable for the lifetime of the inserted handle as the kernel
+// references them by index in the completion user_data.
+typedef struct iree_wait_set_slot_t {
+  // User-provided handle.
+  iree_wait_handle_t handle;
+  // Generation counter incremented each time the slot is erased so that
+  // completions for requests made on behalf of prior handles can be ignored.
+  uint32_t generation;
+  iree_wait_set_slot_flags_t flags;
+} iree_wait_set_slot_t;
+
+struct iree_wait_set_t {
+  iree_allocator_t allocator;
+
+  // Total capacity of the slot list.
+  iree_host_size_t handle_capacity;
+
+  // Total number of valid handles in the set.
+  iree_host_size_t handle_count;
+
+  // High-water mark of slots that have been used. All slots [0, slot_count)
+  // are either in use or present in the free list.
+  iree_host_size_t slot_count;
+
+  // Stack of slot indices available for reuse.
+  iree_host_size_t free_count;
+  uint32_t* free_slots;
+
+  // Handle slots referenced by the kernel by index.
+  iree_wait_set_slot_t* slots;
+
+  // io_uring instance file descriptor.
+  int ring_fd;
+
+  // Submission queue ring mapping.
+  void* sq_ptr;
+  size_t sq_size;
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t sq_mask;
+  uint32_t sq_entries;
+  uint32_t* sq_array;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  // Locally queued submission tail; submissions between the kernel-visible
+  // sq_tail and this are flushed in batches on the next enter.
+  uint32_t sq_local_tail;
+
+  // Completion queue ring mapping. May alias sq_ptr.
+  void* cq_ptr;
+  size_t cq_size;
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  uint32_t cq_mask;
+  struct io_uring_cqe* cqes;
+};
+
+static iree_status_t iree_wait_set_map_ring(iree_wait_set_t* set,
+                                            const struct io_uring_params* p) {
+  set->sq_size = p->sq_off.array + p->sq_entries * sizeof(uint32_t);
+  set->cq_size = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (p->features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    set->sq_size = set->cq_size = iree_max(set->sq_size, set->cq_size);
+  }
+
+  set->sq_ptr =
+      mmap(NULL, set->sq_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, set->ring_fd, IORING_OFF_SQ_RING);
+  if (set->sq_ptr == MAP_FAILED) {
+    set->sq_ptr = NULL;
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to map io_uring submission queue (%d)",
+                            errno);
+  }
+  if (single_mmap) {
+    set->cq_ptr = set->sq_ptr;
+  } else {
+    set->cq_ptr =
+        mmap(NULL, set->cq_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, set->ring_fd, IORING_OFF_CQ_RING);
+    if (set->cq_ptr == MAP_FAILED) {
+      set->cq_ptr = NULL;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to map io_uring completion queue (%d)",
+                              errno);
+    }
+  }
+  set->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+  set->sqes = (struct io_uring_sqe*)mmap(
+      NULL, set->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      set->ring_fd, IORING_OFF_SQES);
+  if ((void*)set->sqes == MAP_FAILED) {
+    set->sqes = NULL;
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to map io_uring submission entries (%d)",
+                            errno);
+  }
+
+  uint8_t* sq_base = (uint8_t*)set->sq_ptr;
+  set->sq_head = (uint32_t*)(sq_base + p->sq_off.head);
+  set->sq_tail = (uint32_t*)(sq_base + p->sq_off.tail);
+  set->sq_mask = *(uint32_t*)(sq_base + p->sq_off.ring_mask);
+  set->sq_entries = *(uint32_t*)(sq_base + p->sq_off.ring_entries);
+  set->sq_array = (uint32_t*)(sq_base + p->sq_off.array);
+  set->sq_local_tail = *set->sq_tail;
+
+  uint8_t* cq_base = (uint8_t*)set->cq_ptr;
+  set->cq_head = (uint32_t*)(cq_base + p->cq_off.head);
+  set->cq_tail = (uint32_t*)(cq_base + p->cq_off.tail);
+  set->cq_mask = *(uint32_t*)(cq_base + p->cq_off.ring_mask);
+  set->cqes = (struct io_uring_cqe*)(cq_base + p->cq_off.cqes);
+  return iree_ok_status();
+}
+
+static void iree_wait_set_unmap_ring(iree_wait_set_t* set) {
+  if (set->sqes) munmap(set->sqes, set->sqes_size);
+  if (set->cq_ptr && set->cq_ptr != set->sq_ptr) {
+    munmap(set->cq_ptr, set->cq_size);
+  }
+  if (set->sq_ptr) munmap(set->sq_ptr, set->sq_size);
+  if (set->ring_fd >= 0) close(set->ring_fd);
+}
+
+iree_status_t iree_wait_set_allocate(iree_host_size_t capacity,
+                                     iree_allocator_t allocator,
+                                     iree_wait_set_t** out_set) {
+  IREE_ASSERT_ARGUMENT(out_set);
+
+  // Each handle may have both a poll request and a removal of a prior poll
+  // request queued between waits and we need ring space for both.
+  if (capacity * 2 > IREE_IO_URING_MAX_ENTRIES) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "wait set capacity of %zu is unreasonably large",
+                            capacity);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)capacity);
+
+  iree_host_size_t slot_list_size =
+      capacity * iree_sizeof_struct(iree_wait_set_slot_t);
+  iree_host_size_t free_list_size = capacity * sizeof(uint32_t);
+  iree_host_size_t total_size =
+      iree_sizeof_struct(iree_wait_set_t) + slot_list_size + free_list_size;
+
+  iree_wait_set_t* set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&set));
+  set->allocator = allocator;
+  set->handle_capacity = capacity;
+  set->slots =
+      (iree_wait_set_slot_t*)((uint8_t*)set +
+                              iree_sizeof_struct(iree_wait_set_t));
+  set->free_slots = (uint32_t*)((uint8_t*)set->slots + slot_list_size);
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  uint32_t entries = 1;
+  while (entries < capacity * 2) entries <<= 1;
+  set->ring_fd = iree_syscall_io_uring_setup(entries, &params);
+  iree_status_t status = iree_ok_status();
+  if (set->ring_fd < 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to create io_uring instance (%d)", errno);
+  } else if (!iree_all_bits_set(params.features, IORING_FEAT_EXT_ARG)) {
+    // We rely on the extended arguments to wait with a timeout without needing
+    // to submit (and later cancel) timeout requests.
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "io_uring IORING_FEAT_EXT_ARG not supported by "
+                              "the kernel (requires 5.11+)");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_wait_set_map_ring(set, &params);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_set = set;
+  } else {
+    iree_wait_set_free(set);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_wait_set_free(iree_wait_set_t* set) {
+  if (!set) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_wait_set_unmap_ring(set);
+  iree_allocator_free(set->allocator, set);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
+  return set->handle_count == 0;
+}
+
+// Returns the user_data used for requests made on behalf of |slot_index|.
+static uint64_t iree_wait_set_slot_user_data(const iree_wait_set_t* set,
+                                             iree_host_size_t slot_index) {
+  return ((uint64_t)set->slots[slot_index].generation << 32) |
+         (uint64_t)slot_index;
+}
+
+// Submits all locally queued submissions to the kernel without waiting.
+static iree_status_t iree_wait_set_flush(iree_wait_set_t* set) {
+  __atomic_store_n(set->sq_tail, set->sq_local_tail, __ATOMIC_RELEASE);
+  uint32_t pending_count =
+      set->sq_local_tail - __atomic_load_n(set->sq_head, __ATOMIC_ACQUIRE);
+  if (!pending_count) return iree_ok_status();
+  int rv = -1;
+  IREE_SYSCALL(rv, iree_syscall_io_uring_enter(set->ring_fd, pending_count, 0,
+                                               0, NULL, 0));
+  if (rv < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "io_uring submission failure %d", errno);
+  }
+  return iree_ok_status();
+}
+
+// Reserves a submission queue entry, flushing the queue if it is full.
+static iree_status_t iree_wait_set_get_sqe(iree_wait_set_t* set,
+                                           struct io_uring_sqe** out_sqe) {
+  uint32_t head = __atomic_load_n(set->sq_head, __ATOMIC_ACQUIRE);
+  if (set->sq_local_tail - head >= set->sq_entries) {
+    IREE_RETURN_IF_ERROR(iree_wait_set_flush(set));
+    head = __atomic_load_n(set->sq_head, __ATOMIC_ACQUIRE);
+    if (set->sq_local_tail - head >= set->sq_entries) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "io_uring submission queue full");
+    }
+  }
+  uint32_t index = set->sq_local_tail & set->sq_mask;
+  struct io_uring_sqe* sqe = &set->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  set->sq_array[index] = index;
+  ++set->sq_local_tail;
+  *out_sqe = sqe;
+  return iree_ok_status();
+}
+
+// Queues a poll request for the slot at |slot_index|.
+static iree_status_t iree_wait_set_arm_slot(iree_wait_set_t* set,
+                                            iree_host_size_t slot_index) {
+  iree_wait_set_slot_t* slot = &set->slots[slot_index];
+  struct io_uring_sqe* sqe = NULL;
+  IREE_RETURN_IF_ERROR(iree_wait_set_get_sqe(set, &sqe));
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = iree_wait_primitive_get_read_fd(&slot->handle);
+  sqe->poll_events = POLLIN | POLLPRI;  // implicit POLLERR | POLLHUP | POLLNVAL
+  sqe->user_data = iree_wait_set_slot_user_data(set, slot_index);
+  slot->flags |= IREE_WAIT_SET_SLOT_FLAG_ARMED;
+  return iree_ok_status();
+}
+
+// Queues a poll request for all slots that are not signaled or already armed.
+// Requests stay in-flight across waits so that unchanged handles are not
+// re-registered with the kernel.
+static iree_status_t iree_wait_set_arm_all(iree_wait_set_t* set) {
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    const iree_wait_set_slot_flags_t flags = set->slots[i].flags;
+    if (!iree_all_bits_set(flags, IREE_WAIT_SET_SLOT_FLAG_IN_USE) ||
+        iree_any_bit_set(flags, IREE_WAIT_SET_SLOT_FLAG_ARMED |
+                                    IREE_WAIT_SET_SLOT_FLAG_SIGNALED)) {
+      continue;
+    }
+    IREE_RETURN_IF_ERROR(iree_wait_set_arm_slot(set, i));
+  }
+  return iree_ok_status();
+}
+
+// Releases the slot at |slot_index| and cancels any in-flight poll request.
+// The removal is queued and submitted in the same batch as the next wait.
+static void iree_wait_set_release_slot(iree_wait_set_t* set,
+                                       iree_host_size_t slot_index) {
+  iree_wait_set_slot_t* slot = &set->slots[slot_index];
+  if (iree_all_bits_set(slot->flags, IREE_WAIT_SET_SLOT_FLAG_ARMED)) {
+    struct io_uring_sqe* sqe = NULL;
+    iree_status_t status = iree_wait_set_get_sqe(set, &sqe);
+    if (iree_status_is_ok(status)) {
+      sqe->opcode = IORING_OP_POLL_REMOVE;
+      sqe->addr = iree_wait_set_slot_user_data(set, slot_index);
+      sqe->user_data = IREE_IO_URING_USER_DATA_IGNORED;
+    } else {
+      // If we can't cancel the request the stale completion will be ignored
+      // as the generation is bumped below. The kernel holds its own reference
+      // to the file so the handle may still be closed by the caller.
+      iree_status_ignore(status);
+    }
+  }
+  ++slot->generation;
+  slot->flags = 0;
+  set->free_slots[set->free_count++] = (uint32_t)slot_index;
+  --set->handle_count;
+}
+
+iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
+                                   iree_wait_handle_t handle) {
+  if (set->handle_count + 1 > set->handle_capacity) {
+    // Expected by callers that grow the set on demand.
+    return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
+  }
+
+  iree_host_size_t index = set->free_count > 0
+                               ? set->free_slots[--set->free_count]
+                               : set->slot_count++;
+  ++set->handle_count;
+
+  iree_wait_set_slot_t* slot = &set->slots[index];
+  iree_wait_handle_wrap_primitive(handle.type, handle.value, &slot->handle);
+  slot->flags = IREE_WAIT_SET_SLOT_FLAG_IN_USE;
+
+  return iree_ok_status();
+}
+
+void iree_wait_set_erase(iree_wait_set_t* set, iree_wait_handle_t handle) {
+  // Find the slot in the set. If the handle came from an iree_wait_any wake
+  // we can use its index to do a quick lookup.
+  iree_host_size_t index = handle.set_internal.index;
+  if (IREE_UNLIKELY(index >= set->slot_count) ||
+      IREE_UNLIKELY(!iree_all_bits_set(set->slots[index].flags,
+                                       IREE_WAIT_SET_SLOT_FLAG_IN_USE)) ||
+      IREE_UNLIKELY(!iree_wait_primitive_compare_identical(
+          &set->slots[index].handle, &handle))) {
+    index = IREE_HOST_SIZE_MAX;
+    for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+      if (iree_all_bits_set(set->slots[i].flags,
+                            IREE_WAIT_SET_SLOT_FLAG_IN_USE) &&
+          iree_wait_primitive_compare_identical(&set->slots[i].handle,
+                                                &handle)) {
+        index = i;
+        break;
+      }
+    }
+    if (index == IREE_HOST_SIZE_MAX) return;
+  }
+  iree_wait_set_release_slot(set, index);
+}
+
+void iree_wait_set_clear(iree_wait_set_t* set) {
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    if (iree_all_bits_set(set->slots[i].flags,
+                          IREE_WAIT_SET_SLOT_FLAG_IN_USE)) {
+      iree_wait_set_release_slot(set, i);
+    }
+  }
+}
+
+// Maps a poll revent bitfield result to a status (on failure) and an indicator
+// of whether the event was signaled.
+static iree_status_t iree_wait_set_resolve_poll_events(int32_t revents,
+                                                       bool* out_signaled) {
+  if (revents < 0) {
+    return iree_make_status(iree_status_code_from_errno(-revents),
+                            "io_uring poll failure %d", -revents);
+  } else if (revents & POLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "POLLERR on fd");
+  } else if (revents & POLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "POLLHUP on fd");
+  } else if (revents & POLLNVAL) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "POLLNVAL on fd");
+  }
+  *out_signaled = (revents & POLLIN) != 0;
+  return iree_ok_status();
+}
+
+// Harvests all available completions and marks their slots as signaled.
+// Completions for slots that have since been erased are ignored.
+// Returns the first failure encountered while still harvesting all others.
+static iree_status_t iree_wait_set_reap(iree_wait_set_t* set) {
+  iree_status_t status = iree_ok_status();
+  uint32_t head = *set->cq_head;
+  const uint32_t tail = __atomic_load_n(set->cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+    const struct io_uring_cqe* cqe = &set->cqes[head & set->cq_mask];
+    const uint64_t user_data = cqe->user_data;
+    if (user_data == IREE_IO_URING_USER_DATA_IGNORED) continue;
+    const iree_host_size_t index = (iree_host_size_t)(uint32_t)user_data;
+    if (index >= set->slot_count) continue;
+    iree_wait_set_slot_t* slot = &set->slots[index];
+    if (!iree_all_bits_set(slot->flags, IREE_WAIT_SET_SLOT_FLAG_IN_USE) ||
+        slot->generation != (uint32_t)(user_data >> 32)) {
+      continue;  // stale
+    }
+    slot->flags &= ~IREE_WAIT_SET_SLOT_FLAG_ARMED;
+    bool signaled = false;
+    iree_status_t poll_status =
+        iree_wait_set_resolve_poll_events(cqe->res, &signaled);
+    if (iree_status_is_ok(status)) {
+      status = poll_status;
+    } else {
+      iree_status_ignore(poll_status);
+    }
+    if (signaled) slot->flags |= IREE_WAIT_SET_SLOT_FLAG_SIGNALED;
+  }
+  __atomic_store_n(set->cq_head, head, __ATOMIC_RELEASE);
+  return status;
+}
+
+// Submits all queued requests and waits until at least one completion is
+// available or |deadline_ns| elapses. Registration of new handles, removal of
+// erased handles, and the wait itself are all performed in a single syscall.
+static iree_status_t iree_wait_set_enter(iree_wait_set_t* set,
+                                         iree_time_t deadline_ns) {
+  __atomic_store_n(set->sq_tail, set->sq_local_tail, __ATOMIC_RELEASE);
+  int rv = -1;
+  do {
+    struct __kernel_timespec timeout_ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    if (deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      // Wait only for as much time as we have before the deadline is exceeded.
+      // Must be recomputed each iteration as an interrupted wait may have taken
+      // some of the time.
+      iree_duration_t timeout_ns = 0;
+      if (deadline_ns != IREE_TIME_INFINITE_PAST) {
+        timeout_ns = iree_max(0, deadline_ns - iree_time_now());
+      }
+      timeout_ts.tv_sec = (int64_t)(timeout_ns / 1000000000ull);
+      timeout_ts.tv_nsec = (long long)(timeout_ns % 1000000000ull);
+      arg.ts = (uint64_t)(uintptr_t)&timeout_ts;
+    }
+    uint32_t pending_count =
+        set->sq_local_tail - __atomic_load_n(set->sq_head, __ATOMIC_ACQUIRE);
+    rv = iree_syscall_io_uring_enter(
+        set->ring_fd, pending_count, /*min_complete=*/1,
+        IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+  } while (rv < 0 && errno == EINTR);
+  if (rv >= 0) {
+    return iree_ok_status();
+  } else if (errno == ETIME) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  } else if (errno == EBUSY || errno == EAGAIN) {
+    // Completion queue is backed up; the caller will reap and try again.
+    return iree_ok_status();
+  }
+  return iree_make_status(iree_status_code_from_errno(errno),
+                          "io_uring wait failure %d", errno);
+}
+
+// Clears the signaled state of all handles from a prior wait. Handles may have
+// been reset since then and are re-armed to observe their current state.
+static void iree_wait_set_reset_signals(iree_wait_set_t* set) {
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    set->slots[i].flags &= ~IREE_WAIT_SET_SLOT_FLAG_SIGNALED;
+  }
+}
+
+iree_status_t iree_wait_all(iree_wait_set_t* set, iree_time_t deadline_ns) {
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Poll requests are one-shot and we only re-arm those that have not yet been
+  // signaled. Only when all handles have signaled is the wait satisfied.
+  iree_wait_set_reset_signals(set);
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status)) {
+    status = iree_wait_set_arm_all(set);
+    if (!iree_status_is_ok(status)) break;
+    iree_status_t wait_status = iree_wait_set_enter(set, deadline_ns);
+    status = iree_wait_set_reap(set);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(wait_status);
+      break;
+    }
+    iree_host_size_t signaled_count = 0;
+    for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+      if (iree_all_bits_set(set->slots[i].flags,
+                            IREE_WAIT_SET_SLOT_FLAG_SIGNALED)) {
+        ++signaled_count;
+      }
+    }
+    if (signaled_count == set->handle_count) {
+      iree_status_ignore(wait_status);
+      break;
+    }
+    status = wait_status;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
+                            iree_wait_handle_t* out_wake_handle) {
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Register any new (or previously signaled) handles and wait. Handles that
+  // were armed during a prior wait and not yet signaled remain registered with
+  // the kernel and cost nothing here.
+  iree_wait_set_reset_signals(set);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_wait_set_arm_all(set));
+  iree_status_t status = iree_ok_status();
+  do {
+    iree_status_t wait_status = iree_wait_set_enter(set, deadline_ns);
+    status = iree_wait_set_reap(set);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(wait_status);
+      break;
+    }
+
+    // Find at least one signaled handle.
+    for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+      if (iree_all_bits_set(set->slots[i].flags,
+                            IREE_WAIT_SET_SLOT_FLAG_SIGNALED)) {
+        memcpy(out_wake_handle, &set->slots[i].handle,
+               sizeof(*out_wake_handle));
+        out_wake_handle->set_internal.index = i;
+        break;
+      }
+    }
+    if (!iree_wait_handle_is_immediate(*out_wake_handle)) {
+      iree_status_ignore(wait_status);
+      break;
+    }
+
+    // Woken by completions of stale requests only; wait again.
+    status = wait_status;
+  } while (iree_status_is_ok(status));
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// NOTE: iree_wait_one is shared with the ppoll implementation in
+// wait_handle_poll.c as a single handle does not benefit from the ring.
+
+#endif  // IREE_WAIT_API == IREE_WAIT_API_IO_URING
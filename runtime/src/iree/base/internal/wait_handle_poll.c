@@ -7,7 +7,9 @@
 // NOTE: must be first to ensure that we can define settings for all includes.
 #include "iree/base/internal/wait_handle_impl.h"
 
-#if IREE_WAIT_API == IREE_WAIT_API_POLL || IREE_WAIT_API == IREE_WAIT_API_PPOLL
+#if IREE_WAIT_API == IREE_WAIT_API_POLL ||  \
+    IREE_WAIT_API == IREE_WAIT_API_PPOLL || \
+    IREE_WAIT_API == IREE_WAIT_API_IO_URING
 
 #include <errno.h>
 #include <poll.h>
@@ -29,6 +31,9 @@
 // ensure that we do so with an updated timeout based on the deadline.
 //
 // Documentation: https://linux.die.net/man/2/poll
+//
+// The io_uring implementation (wait_handle_io_uring.c) provides its own
+// iree_wait_set_t and only uses ppoll here for iree_wait_one.
 
 #if IREE_WAIT_API == IREE_WAIT_API_POLL
 static iree_status_t iree_syscall_poll(struct pollfd* fds, nfds_t nfds,
@@ -52,7 +57,8 @@ static iree_status_t iree_syscall_poll(struct pollfd* fds, nfds_t nfds,
   // Timeout; no events set.
   return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
 }
-#elif IREE_WAIT_API == IREE_WAIT_API_PPOLL
+#elif IREE_WAIT_API == IREE_WAIT_API_PPOLL || \
+    IREE_WAIT_API == IREE_WAIT_API_IO_URING
 static iree_status_t iree_syscall_poll(struct pollfd* fds, nfds_t nfds,
                                        iree_time_t deadline_ns,
                                        int* out_signaled_count) {
@@ -109,6 +115,8 @@ static iree_status_t iree_syscall_poll(struct pollfd* fds, nfds_t nfds,
 // iree_wait_set_t
 //===----------------------------------------------------------------------===//
 
+#if IREE_WAIT_API == IREE_WAIT_API_POLL || IREE_WAIT_API == IREE_WAIT_API_PPOLL
+
 struct iree_wait_set_t {
   iree_allocator_t allocator;
 
@@ -185,8 +193,8 @@ bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
   if (set->handle_count + 1 > set->handle_capacity) {
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                            "wait set capacity reached");
+    // Expected by callers that grow the set on demand.
+    return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
   }
 
   iree_host_size_t index = set->handle_count++;
@@ -375,6 +383,9 @@ iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
   return iree_ok_status();
 }
 
+#endif  // IREE_WAIT_API == IREE_WAIT_API_POLL ||
+        // IREE_WAIT_API == IREE_WAIT_API_PPOLL
+
 iree_status_t iree_wait_one(iree_wait_handle_t* handle,
                             iree_time_t deadline_ns) {
   struct pollfd poll_fds;
@@ -403,4 +414,5 @@ iree_status_t iree_wait_one(iree_wait_handle_t* handle,
 }
 
 #endif  // IREE_WAIT_API == IREE_WAIT_API_POLL ||
-        // IREE_WAIT_API == IREE_WAIT_API_PPOLL
+        // IREE_WAIT_API == IREE_WAIT_API_PPOLL ||
+        // IREE_WAIT_API == IREE_WAIT_API_IO_URING
@@ -187,10 +187,8 @@ bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
   if (set->total_handle_count + 1 > set->handle_capacity) {
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                            "wait set capacity %" PRIhsz
-                            " reached; no more wait handles available",
-                            set->handle_capacity);
+    // Expected by callers that grow the set on demand.
+    return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
   }
 
   // First check to see if we already have the handle in the set; since APIs
@@ -25,6 +25,13 @@ extern iree_status_t iree_loop_command_call(iree_loop_emscripten_scope_t scope,
                                             iree_loop_callback_fn_t callback,
                                             void* user_data, iree_loop_t loop);
 
+// Sentinel |timeout_ms| for waits that only complete when the scope is freed.
+#define IREE_LOOP_EMSCRIPTEN_TIMEOUT_INFINITE UINT32_MAX
+
+extern iree_status_t iree_loop_command_wait_until(
+    iree_loop_emscripten_scope_t scope, iree_loop_callback_fn_t callback,
+    void* user_data, uint32_t timeout_ms, iree_loop_t loop);
+
 //===----------------------------------------------------------------------===//
 // iree_loop_emscripten_t
 //===----------------------------------------------------------------------===//
@@ -63,6 +70,75 @@ static iree_status_t iree_loop_emscripten_run_call(
                                 params->callback.user_data, loop);
 }
 
+// Dispatch state retained until the dispatch runs. The params passed to the
+// loop are only valid for the duration of the control call.
+typedef struct iree_loop_emscripten_dispatch_t {
+  iree_allocator_t allocator;
+  iree_loop_dispatch_params_t params;
+} iree_loop_emscripten_dispatch_t;
+
+static iree_status_t iree_loop_emscripten_dispatch_callback(
+    void* user_data, iree_loop_t loop, iree_status_t status) {
+  iree_loop_emscripten_dispatch_t* dispatch =
+      (iree_loop_emscripten_dispatch_t*)user_data;
+  iree_loop_dispatch_params_t params = dispatch->params;
+  iree_allocator_free(dispatch->allocator, dispatch);
+
+  // JavaScript is single threaded so workgroups run serially within a single
+  // task. If any workgroup fails we exit early and pass the failing status to
+  // the completion callback. Aborted dispatches skip all workgroups.
+  for (uint32_t z = 0;
+       iree_status_is_ok(status) && z < params.workgroup_count_xyz[2]; ++z) {
+    for (uint32_t y = 0;
+         iree_status_is_ok(status) && y < params.workgroup_count_xyz[1]; ++y) {
+      for (uint32_t x = 0;
+           iree_status_is_ok(status) && x < params.workgroup_count_xyz[0];
+           ++x) {
+        status = params.workgroup_fn(params.callback.user_data, loop, x, y, z);
+      }
+    }
+  }
+
+  return params.callback.fn(params.callback.user_data, loop, status);
+}
+
+static iree_status_t iree_loop_emscripten_run_dispatch(
+    iree_loop_emscripten_t* loop_emscripten,
+    iree_loop_dispatch_params_t* params) {
+  iree_loop_emscripten_dispatch_t* dispatch = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      loop_emscripten->allocator, sizeof(*dispatch), (void**)&dispatch));
+  dispatch->allocator = loop_emscripten->allocator;
+  dispatch->params = *params;
+  iree_loop_t loop = iree_loop_emscripten(loop_emscripten);
+  iree_status_t status = iree_loop_command_call(
+      loop_emscripten->scope, iree_loop_emscripten_dispatch_callback, dispatch,
+      loop);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(loop_emscripten->allocator, dispatch);
+  }
+  return status;
+}
+
+static iree_status_t iree_loop_emscripten_run_wait_until(
+    iree_loop_emscripten_t* loop_emscripten,
+    iree_loop_wait_until_params_t* params) {
+  // setTimeout takes milliseconds so round up to avoid waking early.
+  uint32_t timeout_ms = IREE_LOOP_EMSCRIPTEN_TIMEOUT_INFINITE;
+  if (params->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+    iree_duration_t timeout_ns = iree_max(
+        0, iree_absolute_deadline_to_timeout_ns(params->deadline_ns));
+    timeout_ms = (uint32_t)iree_min(
+        (timeout_ns + 1000000 - 1) / 1000000,
+        (iree_duration_t)IREE_LOOP_EMSCRIPTEN_TIMEOUT_INFINITE - 1);
+  }
+  iree_loop_t loop = iree_loop_emscripten(loop_emscripten);
+  return iree_loop_command_wait_until(loop_emscripten->scope,
+                                      params->callback.fn,
+                                      params->callback.user_data, timeout_ms,
+                                      loop);
+}
+
 // Control function for the Emscripten loop.
 IREE_API_EXPORT iree_status_t
 iree_loop_emscripten_ctl(void* self, iree_loop_command_t command,
@@ -77,13 +153,20 @@ iree_loop_emscripten_ctl(void* self, iree_loop_command_t command,
       return iree_loop_emscripten_run_call(loop_emscripten,
                                            (iree_loop_call_params_t*)params);
     case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_loop_emscripten_run_dispatch(
+          loop_emscripten, (iree_loop_dispatch_params_t*)params);
     case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      return iree_loop_emscripten_run_wait_until(
+          loop_emscripten, (iree_loop_wait_until_params_t*)params);
     case IREE_LOOP_COMMAND_WAIT_ONE:
     case IREE_LOOP_COMMAND_WAIT_ALL:
     case IREE_LOOP_COMMAND_WAIT_ANY:
-      // TODO(scotttodd): implement these commands
+      // Wait sources are backed by OS primitives (or Atomics.wait on worker
+      // threads) that can't be observed from the browser event loop without
+      // blocking it. Callers must signal completion with a call instead.
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "unimplemented loop command");
+                              "wait source commands are not supported on the "
+                              "emscripten loop");
     case IREE_LOOP_COMMAND_DRAIN:
       return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
                               "unsupported loop command");
@@ -19,6 +19,9 @@ const IreeLibraryLoopEmscripten = {
     const IREE_STATUS_ABORTED = 10 & IREE_STATUS_CODE_MASK;
     const IREE_STATUS_OUT_OF_RANGE = 11 & IREE_STATUS_CODE_MASK;
 
+    // Matches IREE_LOOP_EMSCRIPTEN_TIMEOUT_INFINITE in loop_emscripten.c.
+    const TIMEOUT_INFINITE = 0xFFFFFFFF;
+
     class LoopCommand {
       abort() {}
     }
@@ -49,6 +52,35 @@ const IreeLibraryLoopEmscripten = {
       }
     }
 
+    // IREE_LOOP_COMMAND_WAIT_UNTIL
+    class LoopCommandWaitUntil extends LoopCommand {
+      constructor(scope, operationId, callback, user_data, timeout_ms, loop) {
+        super();
+
+        this.callback = callback;
+        this.user_data = user_data;
+        this.loop = loop;
+
+        // Infinite waits never time out and only complete when aborted.
+        this.timeoutId = null;
+        if (timeout_ms >>> 0 !== TIMEOUT_INFINITE) {
+          this.timeoutId = setTimeout(() => {
+            Module['dynCall'](
+                'iiii', this.callback, this.user_data, this.loop,
+                IREE_STATUS_OK);
+            delete scope.pendingOperations[operationId];
+          }, timeout_ms);
+        }
+      }
+
+      abort() {
+        if (this.timeoutId !== null) clearTimeout(this.timeoutId);
+        Module['dynCall'](
+            'iiii', this.callback, this.user_data, this.loop,
+            IREE_STATUS_ABORTED);
+      }
+    }
+
     class LoopEmscriptenScope {
       constructor() {
         this.nextOperationId = 0;
@@ -72,6 +104,13 @@ const IreeLibraryLoopEmscripten = {
             new LoopCommandCall(this, operationId, callback, user_data, loop);
         return IREE_STATUS_OK;
       }
+
+      command_wait_until(callback, user_data, timeout_ms, loop) {
+        const operationId = this.nextOperationId++;
+        this.pendingOperations[operationId] = new LoopCommandWaitUntil(
+            this, operationId, callback, user_data, timeout_ms, loop);
+        return IREE_STATUS_OK;
+      }
     }
 
     class LoopEmscripten {
@@ -102,6 +141,14 @@ const IreeLibraryLoopEmscripten = {
         const scope = this.scopes[scope_handle];
         return scope.command_call(callback, user_data, loop);
       }
+
+      iree_loop_command_wait_until(
+          scope_handle, callback, user_data, timeout_ms, loop) {
+        if (!(scope_handle in this.scopes)) return IREE_STATUS_OUT_OF_RANGE;
+
+        const scope = this.scopes[scope_handle];
+        return scope.command_wait_until(callback, user_data, timeout_ms, loop);
+      }
     }
 
     const instance = new LoopEmscripten();
@@ -109,6 +156,8 @@ const IreeLibraryLoopEmscripten = {
         instance.iree_loop_allocate_scope.bind(instance);
     _iree_loop_free_scope = instance.iree_loop_free_scope.bind(instance);
     _iree_loop_command_call = instance.iree_loop_command_call.bind(instance);
+    _iree_loop_command_wait_until =
+        instance.iree_loop_command_wait_until.bind(instance);
   },
   $iree_loop_emscripten_support__deps: ['$dynCall'],
 
@@ -118,6 +167,8 @@ const IreeLibraryLoopEmscripten = {
   iree_loop_free_scope__deps: ['$iree_loop_emscripten_support'],
   iree_loop_command_call: function() {},
   iree_loop_command_call__deps: ['$iree_loop_emscripten_support'],
+  iree_loop_command_wait_until: function() {},
+  iree_loop_command_wait_until__deps: ['$iree_loop_emscripten_support'],
 }
 
 mergeInto(LibraryManager.library, IreeLibraryLoopEmscripten);
@@ -171,6 +171,15 @@ typedef enum iree_status_code_e {
 typedef struct iree_status_handle_t* iree_status_t;
 
 // Returns an iree_status_t from the an iree_status_code_t.
+//
+// The result carries only the code: no storage is allocated and no source
+// location, message, or stack trace is captured regardless of
+// IREE_STATUS_MODE. Creating and ignoring such a status is free. Use this
+// instead of iree_make_status for expected conditions that callers branch on
+// and usually discard such as IREE_STATUS_DEFERRED from resumable calls,
+// IREE_STATUS_DEADLINE_EXCEEDED from polls with an immediate timeout, and
+// IREE_STATUS_RESOURCE_EXHAUSTED from fixed-capacity structures callers are
+// expected to grow.
 #define iree_status_from_code(code)                          \
   ((iree_status_t)((uintptr_t)((iree_status_code_t)(code)) & \
                    IREE_STATUS_CODE_MASK))
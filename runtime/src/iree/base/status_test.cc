@@ -59,6 +59,16 @@ TEST(Status, StreamInsertionContinued) {
   CHECK_STREAM_MESSAGE(status, os, "annotation");
 }
 
+// Statuses from iree_status_from_code are used for expected conditions on hot
+// paths and must not own any storage that would need to be allocated.
+TEST(Status, FromCodeIsCodeOnly) {
+  iree_status_t status = iree_status_from_code(IREE_STATUS_DEFERRED);
+  EXPECT_EQ(IREE_STATUS_DEFERRED, iree_status_code(status));
+  EXPECT_EQ(static_cast<uintptr_t>(IREE_STATUS_DEFERRED),
+            reinterpret_cast<uintptr_t>(status));
+  iree_status_ignore(status);
+}
+
 TEST(StatusMacro, ReturnIfError) {
   auto returnIfError = [](iree_status_t status) -> iree_status_t {
     IREE_RETURN_IF_ERROR(status, "annotation");
@@ -8,6 +8,15 @@
 
 #include "iree/base/target_platform.h"
 
+#if IREE_TRACING_SAMPLING_ENABLE
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <new>
+#endif  // IREE_TRACING_SAMPLING_ENABLE
+
 // Textually include the Tracy implementation.
 // We do this here instead of relying on an external build target so that we can
 // ensure our configuration specified in tracing.h is picked up.
@@ -324,3 +333,253 @@ void iree_tracing_mutex_after_unlock(uint32_t lock_id) {
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Sampled zones
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_SAMPLING_ENABLE
+
+namespace {
+
+// Zone IDs pack the index of the recording thread in the upper bits and the
+// 1-based index of the sample in that thread's buffer in the lower bits so
+// that zones can be ended from any thread.
+constexpr int kSampleIndexBits = 22;
+constexpr uint32_t kSampleIndexMask = (1u << kSampleIndexBits) - 1;
+static_assert(IREE_TRACING_SAMPLING_THREAD_CAPACITY < kSampleIndexMask,
+              "thread capacity must fit in the zone ID sample index");
+static_assert(IREE_TRACING_SAMPLING_MAX_THREADS <=
+                  (1u << (32 - kSampleIndexBits)),
+              "max threads must fit in the zone ID thread index");
+
+struct iree_tracing_sample_t {
+  const iree_tracing_sample_location_t* location;
+  int64_t begin_ns;
+  // Set when the zone ends; 0 while it is still open.
+  std::atomic<int64_t> end_ns;
+};
+
+// Samples recorded by a single thread. Only the owning thread appends samples
+// and publishes them with |count| so that exports can read them concurrently.
+struct iree_tracing_sample_thread_t {
+  uint32_t thread_index;
+  // Published once the name has been copied into |name|; 0 if unnamed.
+  std::atomic<uint32_t> name_length;
+  char name[64];
+  std::atomic<uint32_t> count;
+  // Samples dropped because the buffer was full.
+  std::atomic<uint64_t> dropped_count;
+  iree_tracing_sample_t samples[IREE_TRACING_SAMPLING_THREAD_CAPACITY];
+};
+
+std::atomic<uint32_t> iree_tracing_sampling_period_value{0};
+std::atomic<uint32_t> iree_tracing_sampling_thread_count{0};
+std::atomic<iree_tracing_sample_thread_t*>
+    iree_tracing_sampling_threads[IREE_TRACING_SAMPLING_MAX_THREADS];
+
+// Buffer of the calling thread, allocated on its first sample.
+IREE_THREAD_LOCAL iree_tracing_sample_thread_t* iree_tracing_sampling_thread;
+// Set if the calling thread could not be given a buffer.
+IREE_THREAD_LOCAL bool iree_tracing_sampling_thread_failed;
+// Name of the calling thread set before its buffer was allocated.
+IREE_THREAD_LOCAL char iree_tracing_sampling_thread_name[64];
+
+int64_t iree_tracing_sampling_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void iree_tracing_sampling_publish_name(iree_tracing_sample_thread_t* thread,
+                                        const char* name) {
+  if (thread->name_length.load(std::memory_order_relaxed) != 0) return;
+  const size_t name_length = std::min(strlen(name), sizeof(thread->name) - 1);
+  if (name_length == 0) return;
+  memcpy(thread->name, name, name_length);
+  thread->name_length.store((uint32_t)name_length, std::memory_order_release);
+}
+
+iree_tracing_sample_thread_t* iree_tracing_sampling_current_thread() {
+  iree_tracing_sample_thread_t* thread = iree_tracing_sampling_thread;
+  if (IREE_LIKELY(thread) || iree_tracing_sampling_thread_failed) {
+    return thread;
+  }
+  const uint32_t thread_index = iree_tracing_sampling_thread_count.fetch_add(
+      1, std::memory_order_relaxed);
+  if (thread_index < IREE_TRACING_SAMPLING_MAX_THREADS) {
+    thread = new (std::nothrow) iree_tracing_sample_thread_t();
+  }
+  if (!thread) {
+    iree_tracing_sampling_thread_failed = true;
+    return nullptr;
+  }
+  thread->thread_index = thread_index;
+  iree_tracing_sampling_publish_name(thread, iree_tracing_sampling_thread_name);
+  iree_tracing_sampling_threads[thread_index].store(thread,
+                                                    std::memory_order_release);
+  iree_tracing_sampling_thread = thread;
+  return thread;
+}
+
+bool iree_tracing_sampling_write_json_string(FILE* file, const char* value) {
+  if (fputc('"', file) == EOF) return false;
+  for (const char* c = value; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      if (fputc('\\', file) == EOF || fputc(*c, file) == EOF) return false;
+    } else if ((unsigned char)*c < 0x20) {
+      if (fprintf(file, "\\u%04x", (unsigned)*c) < 0) return false;
+    } else if (fputc(*c, file) == EOF) {
+      return false;
+    }
+  }
+  return fputc('"', file) != EOF;
+}
+
+// Writes |ns| as microseconds, the unit of Chrome trace event timestamps.
+bool iree_tracing_sampling_write_us(FILE* file, int64_t ns) {
+  return fprintf(file, "%" PRId64 ".%03d", ns / 1000, (int)(ns % 1000)) >= 0;
+}
+
+bool iree_tracing_sampling_write_thread(
+    FILE* file, const iree_tracing_sample_thread_t* thread, bool* first) {
+  // Thread IDs start at 1 to match what trace viewers expect.
+  const uint32_t tid = thread->thread_index + 1;
+  const uint32_t name_length =
+      thread->name_length.load(std::memory_order_acquire);
+  if (name_length) {
+    char name[sizeof(thread->name)];
+    memcpy(name, thread->name, name_length);
+    name[name_length] = 0;
+    if (fprintf(file,
+                "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":%" PRIu32 ",\"args\":{\"name\":",
+                *first ? "" : ",", tid) < 0 ||
+        !iree_tracing_sampling_write_json_string(file, name) ||
+        fputs("}}", file) == EOF) {
+      return false;
+    }
+    *first = false;
+  }
+  const uint32_t count = thread->count.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < count; ++i) {
+    const iree_tracing_sample_t* sample = &thread->samples[i];
+    const int64_t end_ns = sample->end_ns.load(std::memory_order_acquire);
+    if (!end_ns) continue;
+    const iree_tracing_sample_location_t* location = sample->location;
+    if (fprintf(file, "%s\n{\"name\":", *first ? "" : ",") < 0 ||
+        !iree_tracing_sampling_write_json_string(
+            file, location->name ? location->name : location->function) ||
+        fprintf(file,
+                ",\"cat\":\"iree\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32
+                ",\"ts\":",
+                tid) < 0 ||
+        !iree_tracing_sampling_write_us(file, sample->begin_ns) ||
+        fputs(",\"dur\":", file) == EOF ||
+        !iree_tracing_sampling_write_us(file, end_ns - sample->begin_ns) ||
+        fputs(",\"args\":{\"file\":", file) == EOF ||
+        !iree_tracing_sampling_write_json_string(file, location->file) ||
+        fprintf(file, ",\"line\":%" PRIu32 "}}", location->line) < 0) {
+      return false;
+    }
+    *first = false;
+  }
+  return true;
+}
+
+}  // namespace
+
+extern "C" {
+
+IREE_THREAD_LOCAL int32_t iree_tracing_sampling_countdown = 0;
+
+void iree_tracing_sampling_set_period(uint32_t period) {
+  iree_tracing_sampling_period_value.store(period, std::memory_order_relaxed);
+}
+
+uint32_t iree_tracing_sampling_period(void) {
+  return iree_tracing_sampling_period_value.load(std::memory_order_relaxed);
+}
+
+void iree_tracing_sampling_set_thread_name(const char* name) {
+  // Avoid allocating a buffer for threads that may never take a sample.
+  iree_tracing_sample_thread_t* thread = iree_tracing_sampling_thread;
+  if (thread) {
+    iree_tracing_sampling_publish_name(thread, name);
+  } else {
+    const size_t name_length =
+        std::min(strlen(name), sizeof(iree_tracing_sampling_thread_name) - 1);
+    memcpy(iree_tracing_sampling_thread_name, name, name_length);
+    iree_tracing_sampling_thread_name[name_length] = 0;
+  }
+}
+
+iree_zone_id_t iree_tracing_sampled_zone_begin_impl(
+    const iree_tracing_sample_location_t* location) {
+  const uint32_t period = iree_tracing_sampling_period();
+  if (period == 0) {
+    iree_tracing_sampling_countdown = IREE_TRACING_SAMPLING_RECHECK_INTERVAL;
+    return 0;
+  }
+  iree_tracing_sampling_countdown =
+      (int32_t)std::min(period, (uint32_t)INT32_MAX);
+
+  iree_tracing_sample_thread_t* thread = iree_tracing_sampling_current_thread();
+  if (IREE_UNLIKELY(!thread)) {
+    // Stop sampling on this thread as there's nowhere to record samples.
+    iree_tracing_sampling_countdown = INT32_MAX;
+    return 0;
+  }
+  const uint32_t index = thread->count.load(std::memory_order_relaxed);
+  if (IREE_UNLIKELY(index >= IREE_TRACING_SAMPLING_THREAD_CAPACITY)) {
+    thread->dropped_count.store(
+        thread->dropped_count.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    return 0;
+  }
+  iree_tracing_sample_t* sample = &thread->samples[index];
+  sample->location = location;
+  sample->begin_ns = iree_tracing_sampling_now_ns();
+  thread->count.store(index + 1, std::memory_order_release);
+  return (thread->thread_index << kSampleIndexBits) | (index + 1);
+}
+
+void iree_tracing_sampled_zone_end_impl(iree_zone_id_t zone_id) {
+  const int64_t end_ns = iree_tracing_sampling_now_ns();
+  const uint32_t thread_index = zone_id >> kSampleIndexBits;
+  const uint32_t index = (zone_id & kSampleIndexMask) - 1;
+  iree_tracing_sample_thread_t* thread =
+      iree_tracing_sampling_threads[thread_index].load(
+          std::memory_order_acquire);
+  if (!thread || index >= IREE_TRACING_SAMPLING_THREAD_CAPACITY) return;
+  thread->samples[index].end_ns.store(end_ns, std::memory_order_release);
+}
+
+bool iree_tracing_sampling_write_chrome_trace(FILE* file) {
+  if (fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file) == EOF) {
+    return false;
+  }
+  bool first = true;
+  uint64_t dropped_count = 0;
+  const uint32_t thread_count = std::min(
+      iree_tracing_sampling_thread_count.load(std::memory_order_acquire),
+      (uint32_t)IREE_TRACING_SAMPLING_MAX_THREADS);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    const iree_tracing_sample_thread_t* thread =
+        iree_tracing_sampling_threads[i].load(std::memory_order_acquire);
+    if (!thread) continue;
+    if (!iree_tracing_sampling_write_thread(file, thread, &first)) return false;
+    dropped_count += thread->dropped_count.load(std::memory_order_relaxed);
+  }
+  if (fprintf(file,
+              "\n],\"otherData\":{\"sampling_period\":\"%" PRIu32
+              "\",\"dropped_samples\":\"%" PRIu64 "\"}}\n",
+              iree_tracing_sampling_period(), dropped_count) < 0) {
+    return false;
+  }
+  return fflush(file) == 0 && !ferror(file);
+}
+
+}  // extern "C"
+
+#endif  // IREE_TRACING_SAMPLING_ENABLE
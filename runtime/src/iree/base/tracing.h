@@ -133,6 +133,40 @@
 #endif  // IREE_TRACING_MODE
 #endif  // !IREE_TRACING_FEATURES
 
+//===----------------------------------------------------------------------===//
+// IREE_TRACING_SAMPLING_ENABLE
+//===----------------------------------------------------------------------===//
+
+// Enables sampled zones when Tracy instrumentation is not enabled: the
+// IREE_TRACE_ZONE_* macros record 1 in every N zones into per-thread buffers
+// that can be exported in the Chrome trace event format and loaded into
+// Perfetto or chrome://tracing. Sampling is switched on and off at runtime with
+// iree_tracing_sampling_set_period and costs a thread-local decrement per zone
+// when no sample is taken, making it suitable for production builds.
+#if !defined(IREE_TRACING_SAMPLING_ENABLE)
+#define IREE_TRACING_SAMPLING_ENABLE 0
+#endif  // !IREE_TRACING_SAMPLING_ENABLE
+
+// Tracy instrumentation takes precedence as it records every zone.
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+#undef IREE_TRACING_SAMPLING_ENABLE
+#define IREE_TRACING_SAMPLING_ENABLE 0
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#if !defined(IREE_TRACING_SAMPLING_THREAD_CAPACITY)
+// Maximum number of samples recorded per thread. Samples taken after a thread's
+// buffer is full are dropped and counted. Each sample is 24 bytes and buffers
+// are allocated on the first sample taken on each thread.
+#define IREE_TRACING_SAMPLING_THREAD_CAPACITY 4096
+#endif  // !IREE_TRACING_SAMPLING_THREAD_CAPACITY
+
+#if !defined(IREE_TRACING_SAMPLING_MAX_THREADS)
+// Maximum number of threads that can record samples over the process lifetime.
+// Thread buffers are retained after their threads exit so that their samples
+// can still be exported.
+#define IREE_TRACING_SAMPLING_MAX_THREADS 256
+#endif  // !IREE_TRACING_SAMPLING_MAX_THREADS
+
 //===----------------------------------------------------------------------===//
 // Tracy configuration
 //===----------------------------------------------------------------------===//
@@ -284,6 +318,78 @@ void iree_tracing_mutex_after_unlock(uint32_t lock_id);
 }  // extern "C"
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// C API used for sampled zones
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_SAMPLING_ENABLE
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Static source location of a sampled zone.
+typedef struct iree_tracing_sample_location_t {
+  // Optional zone name literal; the function name is used if NULL.
+  const char* name;
+  const char* function;
+  const char* file;
+  uint32_t line;
+} iree_tracing_sample_location_t;
+
+// Sets the process-wide sampling period such that 1 in every |period| zones
+// begun on each thread is recorded. A |period| of 0 disables sampling and is
+// the default. Threads observe a change the next time they take a sample or,
+// when sampling was disabled, within IREE_TRACING_SAMPLING_RECHECK_INTERVAL
+// zones.
+void iree_tracing_sampling_set_period(uint32_t period);
+
+// Returns the current process-wide sampling period or 0 if disabled.
+uint32_t iree_tracing_sampling_period(void);
+
+// Sets the name of the calling thread in exported traces.
+// The C-string |name| will be copied and does not need to be a literal.
+void iree_tracing_sampling_set_thread_name(const char* name);
+
+// Writes all completed samples from all threads to |file| as a Chrome trace
+// event format JSON object. Zones still open are omitted. May be called at any
+// time from any thread while other threads continue recording. Returns false
+// if writing to |file| failed.
+bool iree_tracing_sampling_write_chrome_trace(FILE* file);
+
+// Number of zones a thread skips before checking whether sampling has been
+// enabled again.
+#define IREE_TRACING_SAMPLING_RECHECK_INTERVAL 4096
+
+// Zones begun on the calling thread until the next one is sampled.
+// Implementation detail of iree_tracing_sampled_zone_begin.
+extern IREE_THREAD_LOCAL int32_t iree_tracing_sampling_countdown;
+
+iree_zone_id_t iree_tracing_sampled_zone_begin_impl(
+    const iree_tracing_sample_location_t* location);
+void iree_tracing_sampled_zone_end_impl(iree_zone_id_t zone_id);
+
+// Begins a zone at |location| and returns its ID if it was sampled or 0.
+static inline iree_zone_id_t iree_tracing_sampled_zone_begin(
+    const iree_tracing_sample_location_t* location) {
+  if (IREE_LIKELY(--iree_tracing_sampling_countdown > 0)) return 0;
+  return iree_tracing_sampled_zone_begin_impl(location);
+}
+
+// Ends the zone |zone_id| returned by iree_tracing_sampled_zone_begin.
+// Zones may be ended on threads other than the one that began them.
+static inline void iree_tracing_sampled_zone_end(iree_zone_id_t zone_id) {
+  if (IREE_UNLIKELY(zone_id)) iree_tracing_sampled_zone_end_impl(zone_id);
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TRACING_SAMPLING_ENABLE
+
 //===----------------------------------------------------------------------===//
 // Instrumentation macros (C)
 //===----------------------------------------------------------------------===//
@@ -452,6 +558,60 @@ enum {
 #define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
   IREE_TRACE_IMPL_GET_VARIADIC_HELPER_ args
 
+#elif IREE_TRACING_SAMPLING_ENABLE
+
+// Sampled zones only record the static source location and timing of zones.
+// Dynamic names and appended values are not recorded and zones with external
+// source locations are never sampled. IREE_TRACE expressions are evaluated so
+// that zone IDs stored in trace-only fields remain available.
+#define IREE_TRACE_SET_APP_INFO(value, value_length)
+#define IREE_TRACE_SET_THREAD_NAME(name) \
+  iree_tracing_sampling_set_thread_name(name)
+#define IREE_TRACE(expr) expr
+#define IREE_TRACE_FIBER_ENTER(fiber)
+#define IREE_TRACE_FIBER_LEAVE()
+#define IREE_TRACE_ZONE_BEGIN(zone_id) \
+  IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, NULL)
+#define IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, name_literal)               \
+  static const iree_tracing_sample_location_t                            \
+      IREE_TRACE_IMPL_SAMPLE_LOCATION_(__LINE__) = {                     \
+          name_literal, __FUNCTION__, __FILE__, (uint32_t)__LINE__};     \
+  iree_zone_id_t zone_id = iree_tracing_sampled_zone_begin(              \
+      &IREE_TRACE_IMPL_SAMPLE_LOCATION_(__LINE__));
+#define IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(zone_id, name, name_length) \
+  IREE_TRACE_ZONE_BEGIN(zone_id)
+#define IREE_TRACE_ZONE_BEGIN_EXTERNAL(                        \
+    zone_id, file_name, file_name_length, line, function_name, \
+    function_name_length, name, name_length)                   \
+  iree_zone_id_t zone_id = 0;                                  \
+  (void)zone_id;
+#define IREE_TRACE_ZONE_SET_COLOR(zone_id, color_xrgb)
+#define IREE_TRACE_ZONE_APPEND_VALUE(zone_id, value)
+#define IREE_TRACE_ZONE_APPEND_TEXT(zone_id, ...)
+#define IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(zone_id, value)
+#define IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(zone_id, value, value_length)
+#define IREE_TRACE_ZONE_END(zone_id) iree_tracing_sampled_zone_end(zone_id)
+#define IREE_RETURN_AND_END_ZONE_IF_ERROR(zone_id, ...) \
+  IREE_RETURN_AND_EVAL_IF_ERROR(IREE_TRACE_ZONE_END(zone_id), __VA_ARGS__)
+#define IREE_TRACE_SET_PLOT_TYPE(name_literal, plot_type, step, fill, color)
+#define IREE_TRACE_PLOT_VALUE_I64(name_literal, value)
+#define IREE_TRACE_PLOT_VALUE_F32(name_literal, value)
+#define IREE_TRACE_PLOT_VALUE_F64(name_literal, value)
+#define IREE_TRACE_FRAME_MARK()
+#define IREE_TRACE_FRAME_MARK_NAMED(name_literal)
+#define IREE_TRACE_FRAME_MARK_BEGIN_NAMED(name_literal)
+#define IREE_TRACE_FRAME_MARK_END_NAMED(name_literal)
+#define IREE_TRACE_MESSAGE(level, value_literal)
+#define IREE_TRACE_MESSAGE_COLORED(color, value_literal)
+#define IREE_TRACE_MESSAGE_DYNAMIC(level, value, value_length)
+#define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length)
+
+// Utilities:
+#define IREE_TRACE_IMPL_SAMPLE_LOCATION_HELPER_(line) \
+  iree_tracing_sample_location_##line
+#define IREE_TRACE_IMPL_SAMPLE_LOCATION_(line) \
+  IREE_TRACE_IMPL_SAMPLE_LOCATION_HELPER_(line)
+
 #else
 #define IREE_TRACE_SET_APP_INFO(value, value_length)
 #define IREE_TRACE_SET_THREAD_NAME(name)
@@ -0,0 +1,102 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+#include "iree/testing/gtest.h"
+
+#if !IREE_TRACING_SAMPLING_ENABLE
+#error "test must be built with IREE_TRACING_SAMPLING_ENABLE=1"
+#endif  // !IREE_TRACING_SAMPLING_ENABLE
+
+namespace {
+
+// Returns the sampled zones from all threads exported as a Chrome trace.
+std::string ExportChromeTrace() {
+  FILE* file = tmpfile();
+  EXPECT_NE(file, nullptr);
+  EXPECT_TRUE(iree_tracing_sampling_write_chrome_trace(file));
+  std::string trace;
+  rewind(file);
+  char buffer[4096];
+  size_t read_length = 0;
+  while ((read_length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    trace.append(buffer, read_length);
+  }
+  fclose(file);
+  return trace;
+}
+
+int CountOccurrences(const std::string& haystack, const std::string& needle) {
+  int count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+// Begins and ends |count| zones with the name |name_literal| on a new thread.
+#define RUN_ZONES_ON_THREAD(name_literal, count)         \
+  std::thread([]() {                                     \
+    for (int i = 0; i < (count); ++i) {                  \
+      IREE_TRACE_ZONE_BEGIN_NAMED(z0, name_literal);     \
+      IREE_TRACE_ZONE_END(z0);                           \
+    }                                                    \
+  }).join()
+
+TEST(TracingSamplingTest, DisabledByDefault) {
+  EXPECT_EQ(0u, iree_tracing_sampling_period());
+  RUN_ZONES_ON_THREAD("DisabledZone", 10000);
+  std::string trace = ExportChromeTrace();
+  EXPECT_EQ(0, CountOccurrences(trace, "\"name\":\"DisabledZone\""));
+}
+
+TEST(TracingSamplingTest, SamplesOneInPeriod) {
+  iree_tracing_sampling_set_period(10);
+  RUN_ZONES_ON_THREAD("PeriodicZone", 1000);
+  iree_tracing_sampling_set_period(0);
+  std::string trace = ExportChromeTrace();
+  EXPECT_EQ(100, CountOccurrences(trace, "\"name\":\"PeriodicZone\""));
+  EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, trace.find("tracing_sampling_test.cc"));
+}
+
+TEST(TracingSamplingTest, OpenZonesAreOmitted) {
+  iree_tracing_sampling_set_period(1);
+  iree_zone_id_t zone_id = 0;
+  std::thread([&]() {
+    IREE_TRACE_SET_THREAD_NAME("sampling-test-thread");
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "CrossThreadZone");
+    zone_id = z0;
+  }).join();
+  iree_tracing_sampling_set_period(0);
+  ASSERT_NE(0u, zone_id);
+  std::string trace = ExportChromeTrace();
+  EXPECT_EQ(0, CountOccurrences(trace, "\"name\":\"CrossThreadZone\""));
+  EXPECT_EQ(1, CountOccurrences(trace, "\"sampling-test-thread\""));
+
+  // Zones may be ended on threads other than the one that began them.
+  IREE_TRACE_ZONE_END(zone_id);
+  trace = ExportChromeTrace();
+  EXPECT_EQ(1, CountOccurrences(trace, "\"name\":\"CrossThreadZone\""));
+}
+
+TEST(TracingSamplingTest, DropsSamplesWhenFull) {
+  iree_tracing_sampling_set_period(1);
+  RUN_ZONES_ON_THREAD("FullZone", IREE_TRACING_SAMPLING_THREAD_CAPACITY + 10);
+  iree_tracing_sampling_set_period(0);
+  std::string trace = ExportChromeTrace();
+  EXPECT_EQ(IREE_TRACING_SAMPLING_THREAD_CAPACITY,
+            CountOccurrences(trace, "\"name\":\"FullZone\""));
+  EXPECT_NE(std::string::npos, trace.find("\"dropped_samples\":\"10\""));
+}
+
+}  // namespace
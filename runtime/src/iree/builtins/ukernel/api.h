@@ -9,7 +9,9 @@
 
 #include "iree/builtins/ukernel/elementwise.h"
 #include "iree/builtins/ukernel/mmt4d.h"
+#include "iree/builtins/ukernel/normalize.h"
 #include "iree/builtins/ukernel/pack.h"
+#include "iree/builtins/ukernel/pack_im2col.h"
 #include "iree/builtins/ukernel/query_tile_sizes.h"
 #include "iree/builtins/ukernel/unpack.h"
 
@@ -188,4 +188,32 @@ static inline void iree_uk_neon_copy_8x8xi8_transpose_strided_to_unstrided(
                                                         in_stride);
 }
 
+// Vectorized exp(x) on f32 lanes, following Cephes expf: write
+// x = n * ln(2) + r with |r| <= ln(2) / 2, approximate exp(r) with a degree-6
+// polynomial, and scale by 2^n by constructing the float exponent bits.
+// Accurate to about 2 ulp. n is clamped to the range where 2^n is a normal
+// float (so very negative inputs flush to 0) and x is clamped to a range where
+// y * 2^127 overflows as it should (so very positive inputs saturate to +inf).
+// NaN propagates (NEON min/max return NaN if either operand is NaN).
+static inline float32x4_t iree_uk_neon_exp_f32x4(float32x4_t x) {
+  x = vminq_f32(vdupq_n_f32(89.f),
+                vmaxq_f32(vdupq_n_f32(-88.3762626647949f), x));
+  float32x4_t fx = vmulq_n_f32(x, 1.44269504088896341f);
+  fx = vminq_f32(vdupq_n_f32(127.f), vmaxq_f32(vdupq_n_f32(-127.f), fx));
+  int32x4_t n = vcvtnq_s32_f32(fx);
+  float32x4_t nf = vcvtq_f32_s32(n);
+  float32x4_t r = vfmsq_f32(x, nf, vdupq_n_f32(0.693359375f));
+  r = vfmsq_f32(r, nf, vdupq_n_f32(-2.12194440e-4f));
+  float32x4_t p = vdupq_n_f32(1.9875691500E-4f);
+  p = vfmaq_f32(vdupq_n_f32(1.3981999507E-3f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(8.3334519073E-3f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(4.1665795894E-2f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(1.6666665459E-1f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(5.0000001201E-1f), p, r);
+  float32x4_t y = vfmaq_f32(r, p, vmulq_f32(r, r));
+  y = vaddq_f32(y, vdupq_n_f32(1.f));
+  int32x4_t scale_bits = vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(scale_bits));
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_COMMON_ARM_NEON_H_
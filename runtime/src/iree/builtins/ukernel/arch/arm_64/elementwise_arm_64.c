@@ -0,0 +1,78 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/elementwise_arm_64.h"
+
+#include <arm_neon.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_neon.h"
+
+// Vectorized log(x) following Cephes logf: write x = m * 2^e with m in
+// [sqrt(1/2), sqrt(2)) and approximate log(m) with a degree-9 polynomial.
+// Denormal inputs are treated as the smallest normal float.
+static inline float32x4_t iree_uk_neon_log_f32x4(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  uint32x4_t nan_mask =
+      vorrq_u32(vcltq_f32(x, vdupq_n_f32(0.f)), vmvnq_u32(vceqq_f32(x, x)));
+  uint32x4_t zero_mask = vceqq_f32(x, vdupq_n_f32(0.f));
+  uint32x4_t inf_mask = vceqq_f32(x, vdupq_n_f32(__builtin_inff()));
+  x = vmaxq_f32(x, vreinterpretq_f32_u32(vdupq_n_u32(0x00800000)));
+  uint32x4_t bits = vreinterpretq_u32_f32(x);
+  int32x4_t e_i32 = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)),
+                              vdupq_n_s32(126));
+  float32x4_t e = vcvtq_f32_s32(e_i32);
+  // m in [0.5, 1).
+  float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(
+      vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000)));
+  // If m < sqrt(1/2), use 2 * m - 1 and e - 1, else m - 1.
+  uint32x4_t small_mask = vcltq_f32(m, vdupq_n_f32(0.707106781186547524f));
+  e = vsubq_f32(e, vbslq_f32(small_mask, one, vdupq_n_f32(0.f)));
+  m = vaddq_f32(vsubq_f32(m, one), vbslq_f32(small_mask, m, vdupq_n_f32(0.f)));
+  float32x4_t z = vmulq_f32(m, m);
+  float32x4_t p = vdupq_n_f32(7.0376836292E-2f);
+  p = vfmaq_f32(vdupq_n_f32(-1.1514610310E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(1.1676998740E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(-1.2420140846E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(1.4249322787E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(-1.6668057665E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(2.0000714765E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(-2.4999993993E-1f), p, m);
+  p = vfmaq_f32(vdupq_n_f32(3.3333331174E-1f), p, m);
+  float32x4_t y = vmulq_f32(vmulq_f32(p, m), z);
+  y = vfmaq_f32(y, e, vdupq_n_f32(-2.12194440e-4f));
+  y = vfmsq_f32(y, z, vdupq_n_f32(0.5f));
+  float32x4_t result = vaddq_f32(m, y);
+  result = vfmaq_f32(result, e, vdupq_n_f32(0.693359375f));
+  result = vbslq_f32(inf_mask, x, result);
+  result = vbslq_f32(zero_mask, vdupq_n_f32(-__builtin_inff()), result);
+  return vbslq_f32(nan_mask, vdupq_n_f32(__builtin_nanf("")), result);
+}
+
+static inline float32x4_t iree_uk_neon_rsqrt_f32x4(float32x4_t x) {
+  return vdivq_f32(vdupq_n_f32(1.f), vsqrtq_f32(x));
+}
+
+// Defines iree_uk_x32u_<NAME>_row_arm_64 applying VEC_FUNC to 4 lanes at a
+// time. The remainder is handled one lane at a time.
+#define IREE_UK_X32U_ROW_FUNC_ARM_64(NAME, VEC_FUNC)                      \
+  void iree_uk_x32u_##NAME##_row_arm_64(                                  \
+      const iree_uk_uint32_t* in, iree_uk_uint32_t* IREE_UK_RESTRICT out, \
+      iree_uk_ssize_t size) {                                             \
+    const float* in_ptr = (const float*)in;                               \
+    float* out_ptr = (float*)out;                                         \
+    iree_uk_ssize_t i = 0;                                                \
+    for (; i + 4 <= size; i += 4) {                                       \
+      vst1q_f32(out_ptr + i, VEC_FUNC(vld1q_f32(in_ptr + i)));            \
+    }                                                                     \
+    for (; i < size; ++i) {                                               \
+      float32x4_t v = vld1q_dup_f32(in_ptr + i);                          \
+      vst1q_lane_f32(out_ptr + i, VEC_FUNC(v), 0);                        \
+    }                                                                     \
+  }
+
+IREE_UK_X32U_ROW_FUNC_ARM_64(expf, iree_uk_neon_exp_f32x4)
+IREE_UK_X32U_ROW_FUNC_ARM_64(logf, iree_uk_neon_log_f32x4)
+IREE_UK_X32U_ROW_FUNC_ARM_64(rsqrtf, iree_uk_neon_rsqrt_f32x4)
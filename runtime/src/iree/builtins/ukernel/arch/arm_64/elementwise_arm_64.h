@@ -0,0 +1,24 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ELEMENTWISE_ARM_64_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ELEMENTWISE_ARM_64_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// Row functions for the x32u elementwise ukernels, computing |size| contiguous
+// f32 elements, using NEON.
+void iree_uk_x32u_expf_row_arm_64(const iree_uk_uint32_t* in,
+                                  iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                  iree_uk_ssize_t size);
+void iree_uk_x32u_logf_row_arm_64(const iree_uk_uint32_t* in,
+                                  iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                  iree_uk_ssize_t size);
+void iree_uk_x32u_rsqrtf_row_arm_64(const iree_uk_uint32_t* in,
+                                    iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                    iree_uk_ssize_t size);
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ELEMENTWISE_ARM_64_H_
@@ -12,6 +12,23 @@ IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x4_arm_64_dotprod)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x8_arm_64_i8mm)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8xVLx1_arm_64_sve)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8xVLx4_arm_64_sve)
+IREE_UK_MMT4D_QUANTIZED_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32u4f32_8x8x1_arm_64_neon)
+
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+iree_uk_int32_t iree_uk_arm_64_sve_vector_length_words(void);
+
+// Returns true if the tile is 8xVLxK0 where VL is the number of 32-bit lanes
+// in the SVE vectors of this CPU, which the SVE tile functions require.
+static bool iree_uk_mmt4d_is_sve_tile(const iree_uk_mmt4d_params_t* params,
+                                      iree_uk_int32_t K0) {
+  return (params->cpu_data[0] & IREE_CPU_DATA0_ARM_64_SVE) &&
+         params->M0 == 8 && params->K0 == K0 &&
+         params->N0 == iree_uk_arm_64_sve_vector_length_words();
+}
+#endif
 
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_8x8x8(
@@ -42,6 +59,11 @@ iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_8x8x4(
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32(
     const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  if (iree_uk_mmt4d_is_sve_tile(params, 1)) {
+    return iree_uk_mmt4d_tile_f32f32f32_8xVLx1_arm_64_sve;
+  }
+#endif
   if (params->M0 == 8 && params->N0 == 8 && params->K0 == 1) {
     return iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64;
   }
@@ -50,6 +72,11 @@ iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32(
 
 static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32(
     const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  if (iree_uk_mmt4d_is_sve_tile(params, 4)) {
+    return iree_uk_mmt4d_tile_i8i8i32_8xVLx4_arm_64_sve;
+  }
+#endif
   if (params->M0 == 8 && params->N0 == 8 && params->K0 == 1) {
     return iree_uk_mmt4d_tile_i8i8i32_8x8x1_arm_64;
   }
@@ -69,8 +96,29 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arm_64(
       return iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32(params);
     case iree_uk_mmt4d_type_i8i8i32:
       return iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32(params);
+    case iree_uk_mmt4d_type_f16f16f32:
+    case iree_uk_mmt4d_type_f16f16f16:
+    case iree_uk_mmt4d_type_bf16bf16f32:
+    case iree_uk_mmt4d_type_bf16bf16bf16:
+      // TODO: FEAT_FP16 (FMLA) and FEAT_BF16 (BFMMLA) kernels. Until then,
+      // uses the generic tile functions.
+      return 0;
+    case iree_uk_mmt4d_type_i8i4i32:
+      // TODO: i4 kernels unpacking nibbles into SDOT/SMMLA operands. Until
+      // then, uses the generic tile function.
+      return 0;
     default:
       IREE_UK_ASSUME_UNREACHABLE;
       return 0;
   }
 }
+
+iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_arm_64(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->type == iree_uk_mmt4d_type_f32u4f32 && params->M0 == 8 &&
+      params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_mmt4d_tile_f32u4f32_8x8x1_arm_64_neon;
+  }
+  return 0;
+}
@@ -15,4 +15,10 @@
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arm_64(
     const iree_uk_mmt4d_params_t* params);
 
+// Same as iree_uk_mmt4d_select_tile_func_arm_64, for types with a quantized
+// RHS.
+iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_arm_64(
+    const iree_uk_mmt4d_params_t* params);
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_MMT4D_ARM_64_H_
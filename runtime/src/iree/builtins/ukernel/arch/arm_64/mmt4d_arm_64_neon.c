@@ -0,0 +1,90 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_neon.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_neon.h"
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// Loads 8 nibble-packed u4 values (4 bytes) and dequantizes them to f32 as
+// q * scale + bias, where bias = -zero_point * scale.
+static inline void iree_uk_neon_dequantize_8xu4(const iree_uk_uint8_t* src,
+                                                float32x4_t scale0,
+                                                float32x4_t scale1,
+                                                float32x4_t bias0,
+                                                float32x4_t bias1,
+                                                float32x4_t* out0,
+                                                float32x4_t* out1) {
+  iree_uk_uint32_t word;
+  iree_uk_memcpy(&word, src, sizeof word);
+  uint8x8_t bytes = vcreate_u8(word);
+  // Interleave the low and high nibbles of the 4 bytes to get the 8 values in
+  // element order.
+  uint8x8_t values =
+      vzip1_u8(vand_u8(bytes, vdup_n_u8(0xF)), vshr_n_u8(bytes, 4));
+  uint16x8_t values_u16 = vmovl_u8(values);
+  float32x4_t q0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(values_u16)));
+  float32x4_t q1 = vcvtq_f32_u32(vmovl_high_u16(values_u16));
+  *out0 = vfmaq_f32(bias0, q0, scale0);
+  *out1 = vfmaq_f32(bias1, q1, scale1);
+}
+
+void iree_uk_mmt4d_tile_f32u4f32_8x8x1_arm_64_neon(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, const float* rhs_scales,
+    const float* rhs_zero_points, iree_uk_int32_t K,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // acc[2 * m + n] holds the columns [4 * n, 4 * n + 4) of row m. Constant loop
+  // bounds below get fully unrolled, keeping this in registers.
+  float32x4_t acc[16];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < 16; ++i) acc[i] = vld1q_f32(out_ptr + 4 * i);
+  } else {
+    for (int i = 0; i < 16; ++i) acc[i] = vdupq_n_f32(0);
+  }
+  for (iree_uk_int32_t k_group = 0; k_group < K; k_group += group_size) {
+    float32x4_t scale0 = vld1q_f32(rhs_scales);
+    float32x4_t scale1 = vld1q_f32(rhs_scales + 4);
+    float32x4_t bias0 =
+        vnegq_f32(vmulq_f32(vld1q_f32(rhs_zero_points), scale0));
+    float32x4_t bias1 =
+        vnegq_f32(vmulq_f32(vld1q_f32(rhs_zero_points + 4), scale1));
+    rhs_scales += 8;
+    rhs_zero_points += 8;
+    iree_uk_int32_t k_end = k_group + group_size;
+    if (k_end > K) k_end = K;
+    for (iree_uk_int32_t k = k_group; k < k_end; ++k) {
+      float32x4_t rhs0, rhs1;
+      iree_uk_neon_dequantize_8xu4(rhs_ptr, scale0, scale1, bias0, bias1, &rhs0,
+                                   &rhs1);
+      rhs_ptr += 4;
+      float32x4_t lhs0 = vld1q_f32(lhs_ptr);
+      float32x4_t lhs1 = vld1q_f32(lhs_ptr + 4);
+      lhs_ptr += 8;
+      acc[0] = vfmaq_laneq_f32(acc[0], rhs0, lhs0, 0);
+      acc[1] = vfmaq_laneq_f32(acc[1], rhs1, lhs0, 0);
+      acc[2] = vfmaq_laneq_f32(acc[2], rhs0, lhs0, 1);
+      acc[3] = vfmaq_laneq_f32(acc[3], rhs1, lhs0, 1);
+      acc[4] = vfmaq_laneq_f32(acc[4], rhs0, lhs0, 2);
+      acc[5] = vfmaq_laneq_f32(acc[5], rhs1, lhs0, 2);
+      acc[6] = vfmaq_laneq_f32(acc[6], rhs0, lhs0, 3);
+      acc[7] = vfmaq_laneq_f32(acc[7], rhs1, lhs0, 3);
+      acc[8] = vfmaq_laneq_f32(acc[8], rhs0, lhs1, 0);
+      acc[9] = vfmaq_laneq_f32(acc[9], rhs1, lhs1, 0);
+      acc[10] = vfmaq_laneq_f32(acc[10], rhs0, lhs1, 1);
+      acc[11] = vfmaq_laneq_f32(acc[11], rhs1, lhs1, 1);
+      acc[12] = vfmaq_laneq_f32(acc[12], rhs0, lhs1, 2);
+      acc[13] = vfmaq_laneq_f32(acc[13], rhs1, lhs1, 2);
+      acc[14] = vfmaq_laneq_f32(acc[14], rhs0, lhs1, 3);
+      acc[15] = vfmaq_laneq_f32(acc[15], rhs1, lhs1, 3);
+    }
+  }
+  for (int i = 0; i < 16; ++i) vst1q_f32(out_ptr + 4 * i, acc[i]);
+}
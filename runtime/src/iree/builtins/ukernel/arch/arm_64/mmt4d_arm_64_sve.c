@@ -0,0 +1,114 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_sve.h>
+
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// SVE tile functions. These are vector-length-agnostic: N0 is the number of
+// 32-bit lanes in a SVE vector (svcntw()), so that each row of the output tile
+// is exactly one vector. M0 is fixed at 8, like the NEON kernels, so that the
+// accumulators take 8 of the 32 vector registers regardless of the vector
+// length.
+//
+// The LHS values of each K-iteration are loaded with LD1RQ, which replicates
+// a 128-bit chunk across all segments of the vector, so that the indexed
+// (_lane) forms of FMLA and SDOT, which index within each 128-bit segment,
+// broadcast the same LHS value to all N0 lanes.
+//
+// SVE vector types are sizeless and can't be array elements, so the 8
+// accumulators are spelled out with the macros below.
+
+#define IREE_UK_SVE_FOR_EACH_ROW(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+
+iree_uk_int32_t iree_uk_arm_64_sve_vector_length_words(void) {
+  return (iree_uk_int32_t)svcntw();
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_8xVLx1_arm_64_sve(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const svbool_t pg = svptrue_b32();
+  const iree_uk_int32_t N0 = svcntw();
+#define IREE_UK_SVE_DECL_ACC(m) svfloat32_t acc##m;
+  IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_DECL_ACC)
+#undef IREE_UK_SVE_DECL_ACC
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+#define IREE_UK_SVE_LOAD_ACC(m) acc##m = svld1_f32(pg, out_ptr + m * N0);
+    IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_LOAD_ACC)
+#undef IREE_UK_SVE_LOAD_ACC
+  } else {
+#define IREE_UK_SVE_ZERO_ACC(m) acc##m = svdup_n_f32(0);
+    IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_ZERO_ACC)
+#undef IREE_UK_SVE_ZERO_ACC
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    svfloat32_t rhs = svld1_f32(pg, rhs_ptr);
+    rhs_ptr += N0;
+    svfloat32_t lhs0 = svld1rq_f32(pg, lhs_ptr);
+    svfloat32_t lhs1 = svld1rq_f32(pg, lhs_ptr + 4);
+    lhs_ptr += 8;
+    acc0 = svmla_lane_f32(acc0, rhs, lhs0, 0);
+    acc1 = svmla_lane_f32(acc1, rhs, lhs0, 1);
+    acc2 = svmla_lane_f32(acc2, rhs, lhs0, 2);
+    acc3 = svmla_lane_f32(acc3, rhs, lhs0, 3);
+    acc4 = svmla_lane_f32(acc4, rhs, lhs1, 0);
+    acc5 = svmla_lane_f32(acc5, rhs, lhs1, 1);
+    acc6 = svmla_lane_f32(acc6, rhs, lhs1, 2);
+    acc7 = svmla_lane_f32(acc7, rhs, lhs1, 3);
+  }
+#define IREE_UK_SVE_STORE_ACC(m) svst1_f32(pg, out_ptr + m * N0, acc##m);
+  IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_STORE_ACC)
+#undef IREE_UK_SVE_STORE_ACC
+}
+
+// The RHS panel of one K-iteration is [N0][K0=4] int8, i.e. exactly one SVE
+// vector of int8, which SDOT accumulates as N0 4-element dot products.
+void iree_uk_mmt4d_tile_i8i8i32_8xVLx4_arm_64_sve(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const svbool_t pg8 = svptrue_b8();
+  const svbool_t pg32 = svptrue_b32();
+  const iree_uk_int32_t N0 = svcntw();
+#define IREE_UK_SVE_DECL_ACC(m) svint32_t acc##m;
+  IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_DECL_ACC)
+#undef IREE_UK_SVE_DECL_ACC
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+#define IREE_UK_SVE_LOAD_ACC(m) acc##m = svld1_s32(pg32, out_ptr + m * N0);
+    IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_LOAD_ACC)
+#undef IREE_UK_SVE_LOAD_ACC
+  } else {
+#define IREE_UK_SVE_ZERO_ACC(m) acc##m = svdup_n_s32(0);
+    IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_ZERO_ACC)
+#undef IREE_UK_SVE_ZERO_ACC
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    svint8_t rhs = svld1_s8(pg8, rhs_ptr);
+    rhs_ptr += 4 * N0;
+    svint8_t lhs0 = svld1rq_s8(pg8, lhs_ptr);
+    svint8_t lhs1 = svld1rq_s8(pg8, lhs_ptr + 16);
+    lhs_ptr += 32;
+    acc0 = svdot_lane_s32(acc0, rhs, lhs0, 0);
+    acc1 = svdot_lane_s32(acc1, rhs, lhs0, 1);
+    acc2 = svdot_lane_s32(acc2, rhs, lhs0, 2);
+    acc3 = svdot_lane_s32(acc3, rhs, lhs0, 3);
+    acc4 = svdot_lane_s32(acc4, rhs, lhs1, 0);
+    acc5 = svdot_lane_s32(acc5, rhs, lhs1, 1);
+    acc6 = svdot_lane_s32(acc6, rhs, lhs1, 2);
+    acc7 = svdot_lane_s32(acc7, rhs, lhs1, 3);
+  }
+#define IREE_UK_SVE_STORE_ACC(m) svst1_s32(pg32, out_ptr + m * N0, acc##m);
+  IREE_UK_SVE_FOR_EACH_ROW(IREE_UK_SVE_STORE_ACC)
+#undef IREE_UK_SVE_STORE_ACC
+}
@@ -0,0 +1,104 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/normalize_arm_64.h"
+
+#include <arm_neon.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_neon.h"
+
+static void iree_uk_softmax_row_f32_arm_64(void* out_row, const void* in_row,
+                                           iree_uk_ssize_t size,
+                                           float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)3;
+  // Reduce the max.
+  float32x4_t max4 = vdupq_n_f32(-__builtin_inff());
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 4) {
+    max4 = vmaxq_f32(max4, vld1q_f32(in_ptr + i));
+  }
+  float max_scalar = vmaxvq_f32(max4);
+  for (iree_uk_ssize_t i = vec_size; i < size; ++i) {
+    if (in_ptr[i] > max_scalar) max_scalar = in_ptr[i];
+  }
+  float32x4_t max = vdupq_n_f32(max_scalar);
+  // Compute and store the exponentials, and reduce their sum.
+  float32x4_t sum4 = vdupq_n_f32(0.f);
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 4) {
+    float32x4_t e =
+        iree_uk_neon_exp_f32x4(vsubq_f32(vld1q_f32(in_ptr + i), max));
+    vst1q_f32(out_ptr + i, e);
+    sum4 = vaddq_f32(sum4, e);
+  }
+  float sum = vaddvq_f32(sum4);
+  for (iree_uk_ssize_t i = vec_size; i < size; ++i) {
+    float e = vgetq_lane_f32(
+        iree_uk_neon_exp_f32x4(vdupq_n_f32(in_ptr[i] - max_scalar)), 0);
+    out_ptr[i] = e;
+    sum += e;
+  }
+  // Rescale by the inverse of the sum.
+  float inv_sum = 1.f / sum;
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 4) {
+    vst1q_f32(out_ptr + i, vmulq_n_f32(vld1q_f32(out_ptr + i), inv_sum));
+  }
+  for (iree_uk_ssize_t i = vec_size; i < size; ++i) out_ptr[i] *= inv_sum;
+}
+
+// Same algorithm as iree_uk_layernorm_row_f32_generic: a single pass reducing
+// the sum and sum of squares of the values shifted by the first element, then
+// a pass writing the normalized values.
+static void iree_uk_layernorm_row_f32_arm_64(void* out_row, const void* in_row,
+                                             iree_uk_ssize_t size,
+                                             float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)3;
+  const float shift = in_ptr[0];
+  float32x4_t shift4 = vdupq_n_f32(shift);
+  float32x4_t sum4 = vdupq_n_f32(0.f);
+  float32x4_t sum_sq4 = vdupq_n_f32(0.f);
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 4) {
+    float32x4_t d = vsubq_f32(vld1q_f32(in_ptr + i), shift4);
+    sum4 = vaddq_f32(sum4, d);
+    sum_sq4 = vfmaq_f32(sum_sq4, d, d);
+  }
+  float sum = vaddvq_f32(sum4);
+  float sum_sq = vaddvq_f32(sum_sq4);
+  for (iree_uk_ssize_t i = vec_size; i < size; ++i) {
+    float d = in_ptr[i] - shift;
+    sum += d;
+    sum_sq += d * d;
+  }
+  float inv_size = 1.f / (float)size;
+  float shifted_mean = sum * inv_size;
+  float variance = sum_sq * inv_size - shifted_mean * shifted_mean;
+  if (variance < 0.f) variance = 0.f;
+  float mean_scalar = shift + shifted_mean;
+  float inv_stddev =
+      vgetq_lane_f32(vdivq_f32(vdupq_n_f32(1.f),
+                               vsqrtq_f32(vdupq_n_f32(variance + epsilon))),
+                     0);
+  float32x4_t mean = vdupq_n_f32(mean_scalar);
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 4) {
+    float32x4_t v = vsubq_f32(vld1q_f32(in_ptr + i), mean);
+    vst1q_f32(out_ptr + i, vmulq_n_f32(v, inv_stddev));
+  }
+  for (iree_uk_ssize_t i = vec_size; i < size; ++i) {
+    out_ptr[i] = (in_ptr[i] - mean_scalar) * inv_stddev;
+  }
+}
+
+iree_uk_normalize_row_func_t iree_uk_softmax_select_row_func_arm_64(
+    const iree_uk_normalize_params_t* params) {
+  return iree_uk_softmax_row_f32_arm_64;
+}
+
+iree_uk_normalize_row_func_t iree_uk_layernorm_select_row_func_arm_64(
+    const iree_uk_normalize_params_t* params) {
+  return iree_uk_layernorm_row_f32_arm_64;
+}
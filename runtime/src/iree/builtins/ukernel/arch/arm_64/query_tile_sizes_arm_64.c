@@ -8,15 +8,41 @@
 
 #include "iree/schemas/cpu_data.h"
 
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+iree_uk_int32_t iree_uk_arm_64_sve_vector_length_words(void);
+#endif
+
+// Returns the N0 of the SVE kernels, which is the number of 32-bit lanes in the
+// SVE vectors of this CPU, or 0 if SVE is not available.
+static int iree_uk_query_sve_n0_arm_64(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  if (params->cpu_data[0] & IREE_CPU_DATA0_ARM_64_SVE) {
+    return iree_uk_arm_64_sve_vector_length_words();
+  }
+#endif
+  return 0;
+}
+
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_arm_64_f32f32f32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+  int sve_n0 = iree_uk_query_sve_n0_arm_64(params);
+  // With 128-bit SVE, this would be the same tile as the NEON kernel.
+  if (sve_n0 > 4) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = sve_n0};
+  }
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+  // Wider-than-NEON SVE beats i8mm, which is only 128-bit here.
+  int sve_n0 = iree_uk_query_sve_n0_arm_64(params);
+  if (sve_n0 > 4) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 4, .N = sve_n0};
+  }
 #ifdef IREE_UK_BUILD_ARM_64_I8MM
   if (params->cpu_data[0] & IREE_CPU_DATA0_ARM_64_I8MM) {
     return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 8, .N = 8};
@@ -30,9 +56,56 @@ iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
+// Feature-set predicates for the CPU_FEATURES column of tuned_tile_sizes.inl.
+// These also check that the code was built. SVE tile sizes depend on the
+// vector length, so they can't be tabulated and have no predicate here.
+static inline bool iree_uk_tuned_cpu_supports_baseline(
+    const iree_uk_uint64_t* cpu_data) {
+  return true;
+}
+
+static inline bool iree_uk_tuned_cpu_supports_dotprod(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_ARM_64_DOTPROD
+  return cpu_data[0] & IREE_CPU_DATA0_ARM_64_DOTPROD;
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_i8mm(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_ARM_64_I8MM
+  return cpu_data[0] & IREE_CPU_DATA0_ARM_64_I8MM;
+#else
+  return false;
+#endif
+}
+
+static const iree_uk_matmul_tuned_tile_sizes_t
+    iree_uk_matmul_tuned_tile_sizes_arm_64[] = {
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)       \
+  {CPU_MODEL, IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_##OPERATION,             \
+   iree_uk_tuned_cpu_supports_##CPU_FEATURES,                                  \
+   {.M = M_, .K = K_, .N = N_}},
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)
+#include "iree/builtins/ukernel/tuned_tile_sizes.inl"
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64
+        // Terminator.
+        {0},
+};
+
 bool iree_uk_query_matmul_tile_sizes_arm_64(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+  if (iree_uk_query_matmul_tuned_tile_sizes(
+          params, iree_uk_matmul_tuned_tile_sizes_arm_64,
+          out_matmul_tile_sizes)) {
+    return true;
+  }
   iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
   if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32) {
     *out_matmul_tile_sizes =
@@ -42,6 +115,26 @@ bool iree_uk_query_matmul_tile_sizes_arm_64(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32) {
+    // No optimized kernel yet. K0=2 keeps RHS tiles a whole number of bytes.
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 8};
+    return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32U4F32) {
+    // Same kernel shape as f32, see
+    // iree_uk_mmt4d_select_quantized_tile_func_arm_64.
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_arm_64_f32f32f32(params);
+    return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32 ||
+             op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16 ||
+             op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 ||
+             op ==
+                 IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16) {
+    // No optimized kernels yet, use the same tile sizes as f32.
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_arm_64_f32f32f32(params);
+    return true;
   } else {
     // Can't happen, validated earlier.
     IREE_UK_ASSUME_UNREACHABLE;
@@ -0,0 +1,31 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/mmt4d_riscv_64.h"
+
+#include "iree/schemas/cpu_data.h"
+
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8x8x1_riscv_64_v)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x1_riscv_64_v)
+
+iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_riscv_64(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_RISCV_64_V
+  if (!(params->cpu_data[0] & IREE_CPU_DATA0_RISCV_64_V)) return 0;
+  if (params->M0 != 8 || params->N0 != 8 || params->K0 != 1) return 0;
+  switch (params->type) {
+    case iree_uk_mmt4d_type_f32f32f32:
+      return iree_uk_mmt4d_tile_f32f32f32_8x8x1_riscv_64_v;
+    case iree_uk_mmt4d_type_i8i8i32:
+      return iree_uk_mmt4d_tile_i8i8i32_8x8x1_riscv_64_v;
+    default:
+      return 0;
+  }
+#else
+  (void)params;
+  return 0;
+#endif
+}
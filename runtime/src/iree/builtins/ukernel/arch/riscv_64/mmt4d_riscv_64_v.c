@@ -0,0 +1,95 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <riscv_vector.h>
+
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// RVV tile functions for 8x8 tiles of 32-bit accumulators. Each row of the
+// output tile is one LMUL=2 register group holding 8 32-bit lanes, which fits
+// in the minimum VLEN=128 guaranteed by the V extension. The 8 accumulators
+// then take 16 of the 32 vector registers, leaving room for the RHS operands.
+//
+// RVV vector types are sizeless and can't be array elements, so the 8
+// accumulators are spelled out with the macros below.
+
+#define IREE_UK_RVV_FOR_EACH_ROW(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+
+void iree_uk_mmt4d_tile_f32f32f32_8x8x1_riscv_64_v(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const size_t vl = __riscv_vsetvl_e32m2(8);
+#define IREE_UK_RVV_DECL_ACC(m) vfloat32m2_t acc##m;
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_DECL_ACC)
+#undef IREE_UK_RVV_DECL_ACC
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+#define IREE_UK_RVV_LOAD_ACC(m) \
+  acc##m = __riscv_vle32_v_f32m2(out_ptr + 8 * m, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_LOAD_ACC)
+#undef IREE_UK_RVV_LOAD_ACC
+  } else {
+#define IREE_UK_RVV_ZERO_ACC(m) acc##m = __riscv_vfmv_v_f_f32m2(0.f, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_ZERO_ACC)
+#undef IREE_UK_RVV_ZERO_ACC
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    vfloat32m2_t rhs = __riscv_vle32_v_f32m2(rhs_ptr, vl);
+    rhs_ptr += 8;
+#define IREE_UK_RVV_FMACC(m) \
+  acc##m = __riscv_vfmacc_vf_f32m2(acc##m, lhs_ptr[m], rhs, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_FMACC)
+#undef IREE_UK_RVV_FMACC
+    lhs_ptr += 8;
+  }
+#define IREE_UK_RVV_STORE_ACC(m) \
+  __riscv_vse32_v_f32m2(out_ptr + 8 * m, acc##m, vl);
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_STORE_ACC)
+#undef IREE_UK_RVV_STORE_ACC
+}
+
+// The RHS int8 values are sign-extended to int16 once per K-iteration, then
+// the widening multiply-accumulate VWMACC.VX by each int16 LHS scalar
+// accumulates into the int32 rows.
+void iree_uk_mmt4d_tile_i8i8i32_8x8x1_riscv_64_v(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const size_t vl = __riscv_vsetvl_e32m2(8);
+#define IREE_UK_RVV_DECL_ACC(m) vint32m2_t acc##m;
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_DECL_ACC)
+#undef IREE_UK_RVV_DECL_ACC
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+#define IREE_UK_RVV_LOAD_ACC(m) \
+  acc##m = __riscv_vle32_v_i32m2(out_ptr + 8 * m, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_LOAD_ACC)
+#undef IREE_UK_RVV_LOAD_ACC
+  } else {
+#define IREE_UK_RVV_ZERO_ACC(m) acc##m = __riscv_vmv_v_x_i32m2(0, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_ZERO_ACC)
+#undef IREE_UK_RVV_ZERO_ACC
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    vint16m1_t rhs =
+        __riscv_vsext_vf2_i16m1(__riscv_vle8_v_i8mf2(rhs_ptr, vl), vl);
+    rhs_ptr += 8;
+#define IREE_UK_RVV_WMACC(m) \
+  acc##m = __riscv_vwmacc_vx_i32m2(acc##m, lhs_ptr[m], rhs, vl);
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_WMACC)
+#undef IREE_UK_RVV_WMACC
+    lhs_ptr += 8;
+  }
+#define IREE_UK_RVV_STORE_ACC(m) \
+  __riscv_vse32_v_i32m2(out_ptr + 8 * m, acc##m, vl);
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_STORE_ACC)
+#undef IREE_UK_RVV_STORE_ACC
+}
@@ -0,0 +1,34 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/pack_riscv_64.h"
+
+#include "iree/schemas/cpu_data.h"
+
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_riscv_64_v_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x8_riscv_64_v_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x32_riscv_64_v_direct)
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_riscv_64(
+    const iree_uk_pack_params_t* params) {
+#ifdef IREE_UK_BUILD_RISCV_64_V
+  if (!(params->cpu_data[0] & IREE_CPU_DATA0_RISCV_64_V)) return 0;
+  // The transposed cases are contiguous copies that the generic code already
+  // handles well.
+  if (params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER) return 0;
+  int esize = iree_uk_type_size(iree_uk_pack_out_type(params->type));
+  if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
+    return iree_uk_pack_tile_8x8_x32_riscv_64_v_direct;
+  } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return iree_uk_pack_tile_8x1_x32_riscv_64_v_direct;
+  } else if (esize == 1 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return iree_uk_pack_tile_8x1_x8_riscv_64_v_direct;
+  }
+#else
+  (void)params;
+#endif
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <riscv_vector.h>
+
+#include "iree/builtins/ukernel/pack.h"
+
+// The 8x1 direct tiles gather one column of 8 input rows with a strided load
+// and store it contiguously. This is the LHS and RHS packing for the 8x8x1
+// mmt4d tiles.
+
+void iree_uk_pack_tile_8x1_x32_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  const size_t vl = __riscv_vsetvl_e32m2(8);
+  const ptrdiff_t in_byte_stride0 = in_stride0 * 4;
+  for (; outer_size1 > 0; --outer_size1) {
+    vint32m2_t column = __riscv_vlse32_v_i32m2(in_ptr, in_byte_stride0, vl);
+    __riscv_vse32_v_i32m2(out_ptr, column, vl);
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x8_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  const size_t vl = __riscv_vsetvl_e8mf2(8);
+  for (; outer_size1 > 0; --outer_size1) {
+    vint8mf2_t column = __riscv_vlse8_v_i8mf2(in_ptr, in_stride0, vl);
+    __riscv_vse8_v_i8mf2(out_ptr, column, vl);
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+// Packs the 8x8 accumulator tiles, copying 8 contiguous elements from each of
+// 8 input rows.
+void iree_uk_pack_tile_8x8_x32_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  const size_t vl = __riscv_vsetvl_e32m2(8);
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 8; ++i) {
+      __riscv_vse32_v_i32m2(out_ptr + 8 * i,
+                            __riscv_vle32_v_i32m2(in_ptr + i * in_stride0, vl),
+                            vl);
+    }
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
@@ -0,0 +1,29 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/query_tile_sizes_riscv_64.h"
+
+#include "iree/schemas/cpu_data.h"
+
+bool iree_uk_query_matmul_tile_sizes_riscv_64(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+#ifdef IREE_UK_BUILD_RISCV_64_V
+  if (!(params->cpu_data[0] & IREE_CPU_DATA0_RISCV_64_V)) return false;
+  iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
+  if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32 ||
+      op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32) {
+    // See iree_uk_mmt4d_select_tile_func_riscv_64.
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
+    return true;
+  }
+#else
+  (void)params;
+#endif
+  // Other cases fall back to the generic tile sizes.
+  return false;
+}
@@ -0,0 +1,28 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/unpack_riscv_64.h"
+
+#include "iree/schemas/cpu_data.h"
+
+IREE_UK_UNPACK_TILE_FUNC_DECL(iree_uk_unpack_tile_8x8_x32_riscv_64_v_direct)
+
+iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_riscv_64(
+    const iree_uk_unpack_params_t* params) {
+#ifdef IREE_UK_BUILD_RISCV_64_V
+  if (!(params->cpu_data[0] & IREE_CPU_DATA0_RISCV_64_V)) return 0;
+  int esize = iree_uk_type_size(iree_uk_unpack_out_type(params->type));
+  bool transpose = params->flags & IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER;
+  // Unpack is currently only used in practice with esize==4 and non-transpose.
+  if (esize != 4 || transpose) return 0;
+  if (params->in_size2 == 8 && params->in_size3 == 8) {
+    return iree_uk_unpack_tile_8x8_x32_riscv_64_v_direct;
+  }
+#else
+  (void)params;
+#endif
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <riscv_vector.h>
+
+#include "iree/builtins/ukernel/unpack.h"
+
+// Unpacks the 8x8 accumulator tiles, copying each contiguous row of 8 elements
+// of the tile to its strided output row.
+void iree_uk_unpack_tile_8x8_x32_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride0, iree_uk_ssize_t in_stride1,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  const size_t vl = __riscv_vsetvl_e32m2(8);
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 8; ++i) {
+      __riscv_vse32_v_i32m2(out_ptr + i * out_stride0,
+                            __riscv_vle32_v_i32m2(in_ptr + 8 * i, vl), vl);
+    }
+    out_ptr += 8;
+    in_ptr += in_stride1;
+  }
+}
@@ -0,0 +1,32 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32.h"
+
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_4x8x2_wasm_32_simd128)
+
+iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_wasm_32(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_WASM_32_SIMD128
+  // SIMD128 support is a property of the whole build, see CMakeLists.txt, so
+  // there is no cpu_data bit to check here.
+  if (params->M0 != 4 || params->N0 != 8) return 0;
+  switch (params->type) {
+    case iree_uk_mmt4d_type_f32f32f32:
+      if (params->K0 != 1) return 0;
+      return iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128;
+    case iree_uk_mmt4d_type_i8i8i32:
+      if (params->K0 != 2) return 0;
+      return iree_uk_mmt4d_tile_i8i8i32_4x8x2_wasm_32_simd128;
+    default:
+      return 0;
+  }
+#else
+  (void)params;
+  return 0;
+#endif
+}
@@ -0,0 +1,97 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <wasm_simd128.h>
+
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// SIMD128 tile functions for 4x8 tiles of 32-bit accumulators. Engines map
+// v128 values to the host's 128-bit registers, of which x86-64 only has 16, so
+// the tiles are kept to 8 accumulators to avoid spills even though WebAssembly
+// itself doesn't bound the number of locals.
+
+void iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // acc[2 * m + n] holds the columns [4 * n, 4 * n + 4) of row m. Constant loop
+  // bounds below get fully unrolled, keeping this in registers.
+  v128_t acc[8];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < 8; ++i) acc[i] = wasm_v128_load(out_ptr + 4 * i);
+  } else {
+    for (int i = 0; i < 8; ++i) acc[i] = wasm_f32x4_const_splat(0.f);
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    v128_t rhs0 = wasm_v128_load(rhs_ptr + 0);
+    v128_t rhs1 = wasm_v128_load(rhs_ptr + 4);
+    rhs_ptr += 8;
+    // There is no fused multiply-add outside of the relaxed SIMD proposal,
+    // whose RELAXED_MADD may or may not be fused depending on the engine.
+    for (int m = 0; m < 4; ++m) {
+      v128_t lhs = wasm_f32x4_splat(lhs_ptr[m]);
+#if defined(__wasm_relaxed_simd__)
+      acc[2 * m + 0] = wasm_f32x4_relaxed_madd(lhs, rhs0, acc[2 * m + 0]);
+      acc[2 * m + 1] = wasm_f32x4_relaxed_madd(lhs, rhs1, acc[2 * m + 1]);
+#else
+      acc[2 * m + 0] =
+          wasm_f32x4_add(acc[2 * m + 0], wasm_f32x4_mul(lhs, rhs0));
+      acc[2 * m + 1] =
+          wasm_f32x4_add(acc[2 * m + 1], wasm_f32x4_mul(lhs, rhs1));
+#endif  // defined(__wasm_relaxed_simd__)
+    }
+    lhs_ptr += 4;
+  }
+  for (int i = 0; i < 8; ++i) wasm_v128_store(out_ptr + 4 * i, acc[i]);
+}
+
+// Both operands are sign-extended to int16, then I32X4.DOT_I16X8_S computes
+// the K0=2 dot products of one LHS row against 4 RHS columns at once. The LHS
+// row is a single 32-bit lane of the extended LHS, broadcast with a shuffle.
+// The relaxed I32X4.RELAXED_DOT_I8X16_I7X16_ADD_S is not used: it is only
+// exact when one operand fits in 7 bits, which arbitrary int8 data doesn't.
+void iree_uk_mmt4d_tile_i8i8i32_4x8x2_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // acc[2 * m + n] holds the columns [4 * n, 4 * n + 4) of row m.
+  v128_t acc[8];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < 8; ++i) acc[i] = wasm_v128_load(out_ptr + 4 * i);
+  } else {
+    for (int i = 0; i < 8; ++i) acc[i] = wasm_i32x4_const_splat(0);
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    v128_t lhs = wasm_i16x8_load8x8(lhs_ptr);
+    lhs_ptr += 8;
+    v128_t rhs = wasm_v128_load(rhs_ptr);
+    rhs_ptr += 16;
+    v128_t rhs0 = wasm_i16x8_extend_low_i8x16(rhs);
+    v128_t rhs1 = wasm_i16x8_extend_high_i8x16(rhs);
+    // Shuffle lane indices must be constant expressions, so the rows are
+    // spelled out instead of looping over m.
+#define IREE_UK_WASM_DOT_ROW(m)                                \
+  {                                                            \
+    v128_t lhs_row = wasm_i32x4_shuffle(lhs, lhs, m, m, m, m); \
+    v128_t dot0 = wasm_i32x4_dot_i16x8(lhs_row, rhs0);         \
+    v128_t dot1 = wasm_i32x4_dot_i16x8(lhs_row, rhs1);         \
+    acc[2 * m + 0] = wasm_i32x4_add(acc[2 * m + 0], dot0);     \
+    acc[2 * m + 1] = wasm_i32x4_add(acc[2 * m + 1], dot1);     \
+  }
+    IREE_UK_WASM_DOT_ROW(0)
+    IREE_UK_WASM_DOT_ROW(1)
+    IREE_UK_WASM_DOT_ROW(2)
+    IREE_UK_WASM_DOT_ROW(3)
+#undef IREE_UK_WASM_DOT_ROW
+  }
+  for (int i = 0; i < 8; ++i) wasm_v128_store(out_ptr + 4 * i, acc[i]);
+}
@@ -0,0 +1,48 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32.h"
+
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_4x1_x32_wasm_32_simd128_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_4x2_x8_wasm_32_simd128_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_4x2_x8_wasm_32_simd128_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x2_x8_wasm_32_simd128_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x2_x8_wasm_32_simd128_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_4x8_x32_wasm_32_simd128_direct)
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_wasm_32(
+    const iree_uk_pack_params_t* params) {
+#ifdef IREE_UK_BUILD_WASM_32_SIMD128
+  // These are the LHS, RHS and accumulator tiles of the mmt4d tile functions,
+  // see iree_uk_mmt4d_select_tile_func_wasm_32. Only the element size matters.
+  int esize = iree_uk_type_size(iree_uk_pack_out_type(params->type));
+  bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+  if (esize == 4 && params->out_size2 == 4 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_4x1_x32_wasm_32_simd128_transpose
+                     : iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct;
+  } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose
+                     : iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct;
+  } else if (esize == 1 && params->out_size2 == 4 && params->out_size3 == 2) {
+    return transpose ? iree_uk_pack_tile_4x2_x8_wasm_32_simd128_transpose
+                     : iree_uk_pack_tile_4x2_x8_wasm_32_simd128_direct;
+  } else if (esize == 1 && params->out_size2 == 8 && params->out_size3 == 2) {
+    return transpose ? iree_uk_pack_tile_8x2_x8_wasm_32_simd128_transpose
+                     : iree_uk_pack_tile_8x2_x8_wasm_32_simd128_direct;
+  } else if (esize == 4 && params->out_size2 == 4 && params->out_size3 == 8) {
+    if (transpose) return 0;
+    return iree_uk_pack_tile_4x8_x32_wasm_32_simd128_direct;
+  }
+#else
+  (void)params;
+#endif
+  return 0;
+}
@@ -0,0 +1,291 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <wasm_simd128.h>
+
+#include "iree/builtins/ukernel/pack.h"
+
+// Transposes the 4x4 matrix of 32-bit elements in |r|, in place.
+static inline void iree_uk_wasm_transpose_4x4_x32(v128_t r[4]) {
+  v128_t t0 = wasm_i32x4_shuffle(r[0], r[1], 0, 4, 1, 5);
+  v128_t t1 = wasm_i32x4_shuffle(r[0], r[1], 2, 6, 3, 7);
+  v128_t t2 = wasm_i32x4_shuffle(r[2], r[3], 0, 4, 1, 5);
+  v128_t t3 = wasm_i32x4_shuffle(r[2], r[3], 2, 6, 3, 7);
+  r[0] = wasm_i64x2_shuffle(t0, t2, 0, 2);
+  r[1] = wasm_i64x2_shuffle(t0, t2, 1, 3);
+  r[2] = wasm_i64x2_shuffle(t1, t3, 0, 2);
+  r[3] = wasm_i64x2_shuffle(t1, t3, 1, 3);
+}
+
+// Transposes the 8x8 matrix of 16-bit elements in |r|, in place.
+static inline void iree_uk_wasm_transpose_8x8_x16(v128_t r[8]) {
+  v128_t s[8];
+  for (int i = 0; i < 8; i += 2) {
+    s[i + 0] = wasm_i16x8_shuffle(r[i], r[i + 1], 0, 8, 1, 9, 2, 10, 3, 11);
+    s[i + 1] = wasm_i16x8_shuffle(r[i], r[i + 1], 4, 12, 5, 13, 6, 14, 7, 15);
+  }
+  v128_t u[8];
+  for (int i = 0; i < 8; i += 4) {
+    u[i + 0] = wasm_i32x4_shuffle(s[i + 0], s[i + 2], 0, 4, 1, 5);
+    u[i + 1] = wasm_i32x4_shuffle(s[i + 0], s[i + 2], 2, 6, 3, 7);
+    u[i + 2] = wasm_i32x4_shuffle(s[i + 1], s[i + 3], 0, 4, 1, 5);
+    u[i + 3] = wasm_i32x4_shuffle(s[i + 1], s[i + 3], 2, 6, 3, 7);
+  }
+  for (int i = 0; i < 4; ++i) {
+    r[2 * i + 0] = wasm_i64x2_shuffle(u[i], u[i + 4], 0, 2);
+    r[2 * i + 1] = wasm_i64x2_shuffle(u[i], u[i + 4], 1, 3);
+  }
+}
+
+// Packs Nx1 tiles of 32-bit elements, gathering one column of N input rows per
+// tile. Groups of 4 columns are loaded as rows and transposed.
+static inline void iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0, int N) {
+  for (; outer_size1 >= 4; outer_size1 -= 4) {
+    for (int i = 0; i < N; i += 4) {
+      v128_t r[4];
+      for (int j = 0; j < 4; ++j) {
+        r[j] = wasm_v128_load(in_ptr + (i + j) * in_stride0);
+      }
+      iree_uk_wasm_transpose_4x4_x32(r);
+      for (int j = 0; j < 4; ++j) {
+        wasm_v128_store(out_ptr + j * out_stride1 + i, r[j]);
+      }
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < N; ++i) out_ptr[i] = in_ptr[i * in_stride0];
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+// Packs 1xN tiles of 32-bit elements, which are contiguous in the input.
+static inline void iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_transpose(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, int N) {
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < N; i += 4) {
+      wasm_v128_store(out_ptr + i, wasm_v128_load(in_ptr + i));
+    }
+    out_ptr += out_stride1;
+    in_ptr += N;
+  }
+}
+
+void iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 4);
+}
+
+void iree_uk_pack_tile_4x1_x32_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 4);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_transpose(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, 4);
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 8);
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_transpose(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, 8);
+}
+
+// Packs Nx2 tiles of 8-bit elements. Each tile row is a pair of bytes, so this
+// is the Nx1 packing of 16-bit elements: groups of 8 columns of pairs are
+// loaded as rows and transposed. With N=4, the missing rows are zeros and only
+// the low halves of the transposed rows are stored.
+static inline void iree_uk_pack_tile_Nx2_x8_wasm_32_simd128_direct(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0, int N) {
+  for (; outer_size1 >= 8; outer_size1 -= 8) {
+    v128_t r[8];
+    for (int i = 0; i < 8; ++i) {
+      r[i] = i < N ? wasm_v128_load(in_ptr + i * in_stride0)
+                   : wasm_i64x2_const_splat(0);
+    }
+    iree_uk_wasm_transpose_8x8_x16(r);
+    for (int j = 0; j < 8; ++j) {
+      if (N == 8) {
+        wasm_v128_store(out_ptr + j * out_stride1, r[j]);
+      } else {
+        wasm_v128_store64_lane(out_ptr + j * out_stride1, r[j], 0);
+      }
+    }
+    out_ptr += 8 * out_stride1;
+    in_ptr += 16;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < N; ++i) {
+      out_ptr[2 * i + 0] = in_ptr[i * in_stride0 + 0];
+      out_ptr[2 * i + 1] = in_ptr[i * in_stride0 + 1];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 2;
+  }
+}
+
+void iree_uk_pack_tile_4x2_x8_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 2);
+  iree_uk_pack_tile_Nx2_x8_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 4);
+}
+
+void iree_uk_pack_tile_8x2_x8_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 2);
+  iree_uk_pack_tile_Nx2_x8_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 8);
+}
+
+// Packs 2x4 tiles of 8-bit elements by interleaving the bytes of the two input
+// rows. Each 16-byte load of the two rows covers 4 tiles.
+void iree_uk_pack_tile_4x2_x8_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 2);
+  IREE_UK_ASSERT(tile_size1 == 4);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 >= 4; outer_size1 -= 4) {
+    v128_t in0 = wasm_v128_load(in_ptr);
+    v128_t in1 = wasm_v128_load(in_ptr + in_stride0);
+    v128_t lo = wasm_i8x16_shuffle(in0, in1, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20,
+                                   5, 21, 6, 22, 7, 23);
+    v128_t hi = wasm_i8x16_shuffle(in0, in1, 8, 24, 9, 25, 10, 26, 11, 27, 12,
+                                   28, 13, 29, 14, 30, 15, 31);
+    wasm_v128_store64_lane(out_ptr + 0 * out_stride1, lo, 0);
+    wasm_v128_store64_lane(out_ptr + 1 * out_stride1, lo, 1);
+    wasm_v128_store64_lane(out_ptr + 2 * out_stride1, hi, 0);
+    wasm_v128_store64_lane(out_ptr + 3 * out_stride1, hi, 1);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 16;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 4; ++i) {
+      out_ptr[2 * i + 0] = in_ptr[i];
+      out_ptr[2 * i + 1] = in_ptr[in_stride0 + i];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 4;
+  }
+}
+
+// Same as above for 2x8 tiles, with each 16-byte load covering 2 tiles.
+void iree_uk_pack_tile_8x2_x8_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 2);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 >= 2; outer_size1 -= 2) {
+    v128_t in0 = wasm_v128_load(in_ptr);
+    v128_t in1 = wasm_v128_load(in_ptr + in_stride0);
+    wasm_v128_store(out_ptr,
+                    wasm_i8x16_shuffle(in0, in1, 0, 16, 1, 17, 2, 18, 3, 19, 4,
+                                       20, 5, 21, 6, 22, 7, 23));
+    wasm_v128_store(out_ptr + out_stride1,
+                    wasm_i8x16_shuffle(in0, in1, 8, 24, 9, 25, 10, 26, 11, 27,
+                                       12, 28, 13, 29, 14, 30, 15, 31));
+    out_ptr += 2 * out_stride1;
+    in_ptr += 16;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    v128_t in0 = wasm_v128_load64_zero(in_ptr);
+    v128_t in1 = wasm_v128_load64_zero(in_ptr + in_stride0);
+    wasm_v128_store(out_ptr,
+                    wasm_i8x16_shuffle(in0, in1, 0, 16, 1, 17, 2, 18, 3, 19, 4,
+                                       20, 5, 21, 6, 22, 7, 23));
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+// Packs the 4x8 accumulator tiles, copying 8 contiguous elements from each of
+// 4 input rows.
+void iree_uk_pack_tile_4x8_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 4; ++i) {
+      const iree_uk_int32_t* in_row = in_ptr + i * in_stride0;
+      wasm_v128_store(out_ptr + 8 * i + 0, wasm_v128_load(in_row + 0));
+      wasm_v128_store(out_ptr + 8 * i + 4, wasm_v128_load(in_row + 4));
+    }
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
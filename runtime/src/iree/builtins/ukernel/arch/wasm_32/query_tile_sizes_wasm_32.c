@@ -0,0 +1,30 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/query_tile_sizes_wasm_32.h"
+
+bool iree_uk_query_matmul_tile_sizes_wasm_32(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+#ifdef IREE_UK_BUILD_WASM_32_SIMD128
+  // See iree_uk_mmt4d_select_tile_func_wasm_32.
+  iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
+  if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32) {
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 4, .K = 1, .N = 8};
+    return true;
+  }
+  if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32) {
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 4, .K = 2, .N = 8};
+    return true;
+  }
+#else
+  (void)params;
+#endif
+  // Other cases fall back to the generic tile sizes.
+  return false;
+}
@@ -0,0 +1,26 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/unpack_wasm_32.h"
+
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_4x8_x32_wasm_32_simd128_direct)
+
+iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_wasm_32(
+    const iree_uk_unpack_params_t* params) {
+#ifdef IREE_UK_BUILD_WASM_32_SIMD128
+  int esize = iree_uk_type_size(iree_uk_unpack_out_type(params->type));
+  bool transpose = params->flags & IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER;
+  // Unpack is currently only used in practice with esize==4 and non-transpose.
+  if (esize != 4 || transpose) return 0;
+  if (params->in_size2 == 4 && params->in_size3 == 8) {
+    return iree_uk_unpack_tile_4x8_x32_wasm_32_simd128_direct;
+  }
+#else
+  (void)params;
+#endif
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <wasm_simd128.h>
+
+#include "iree/builtins/ukernel/unpack.h"
+
+// Unpacks the 4x8 accumulator tiles, copying each contiguous row of 8 elements
+// of the tile to its strided output row.
+void iree_uk_unpack_tile_4x8_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride0, iree_uk_ssize_t in_stride1,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 4; ++i) {
+      iree_uk_int32_t* out_row = out_ptr + i * out_stride0;
+      wasm_v128_store(out_row + 0, wasm_v128_load(in_ptr + 8 * i + 0));
+      wasm_v128_store(out_row + 4, wasm_v128_load(in_ptr + 8 * i + 4));
+    }
+    out_ptr += 8;
+    in_ptr += in_stride1;
+  }
+}
@@ -35,6 +35,27 @@ static inline bool iree_uk_cpu_supports_avx512_vnni(
          iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512VNNI);
 }
 
+static inline bool iree_uk_cpu_supports_avx512_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_supports_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512BF16);
+}
+
+// The AMX code paths also use AVX-512 to rearrange data.
+static inline bool iree_uk_cpu_supports_amx_int8(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_supports_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXINT8);
+}
+
+static inline bool iree_uk_cpu_supports_amx_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_supports_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXBF16);
+}
+
 static inline __m256i iree_uk_avx_loadu_2x128(const void* src0,
                                               const void* src1) {
   __m128i v128_0 = _mm_loadu_si128((const __m128i*)src0);
@@ -427,3 +448,96 @@ iree_uk_avx512_copy_16x16xi8_tiled_1x2_transpose_strided_to_strided(
       out_ptr + 6 * out_stride + 16, out_ptr + 7 * out_stride + 16,
       r0123456701234567_3);
 }
+
+// Vectorized exp(x) on f32 lanes, following Cephes expf: write
+// x = n * ln(2) + r with |r| <= ln(2) / 2, approximate exp(r) with a degree-6
+// polynomial, and scale by 2^n by constructing the float exponent bits.
+// Accurate to about 2 ulp. n is clamped to the range where 2^n is a normal
+// float (so very negative inputs flush to 0) and x is clamped to a range where
+// y * 2^127 overflows as it should (so very positive inputs saturate to +inf).
+// NaN propagates (the clamping min/max return their second operand when either
+// is NaN).
+static inline __m128 iree_uk_sse2_exp_f32x4(__m128 x) {
+  x = _mm_min_ps(_mm_set1_ps(89.f),
+                 _mm_max_ps(_mm_set1_ps(-88.3762626647949f), x));
+  __m128 fx = _mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f));
+  fx = _mm_min_ps(_mm_set1_ps(127.f),
+                       _mm_max_ps(_mm_set1_ps(-127.f), fx));
+  __m128i n = _mm_cvtps_epi32(fx);
+  __m128 nf = _mm_cvtepi32_ps(n);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(0.693359375f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(nf, _mm_set1_ps(-2.12194440e-4f)));
+  __m128 p = _mm_set1_ps(1.9875691500E-4f);
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507E-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073E-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894E-2f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201E-1f));
+  __m128 y = _mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), r);
+  y = _mm_add_ps(y, _mm_set1_ps(1.f));
+  __m128i scale_bits =
+      _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(scale_bits));
+}
+
+// AVX2+FMA variant of iree_uk_sse2_exp_f32x4.
+static inline __m256 iree_uk_avx2_exp_f32x8(__m256 x) {
+  x = _mm256_min_ps(_mm256_set1_ps(89.f),
+                    _mm256_max_ps(_mm256_set1_ps(-88.3762626647949f), x));
+  __m256 fx = _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f));
+  fx = _mm256_min_ps(_mm256_set1_ps(127.f),
+                       _mm256_max_ps(_mm256_set1_ps(-127.f), fx));
+  __m256i n = _mm256_cvtps_epi32(fx);
+  __m256 nf = _mm256_cvtepi32_ps(n);
+  __m256 r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(0.693359375f), x);
+  r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(-2.12194440e-4f), r);
+  __m256 p = _mm256_set1_ps(1.9875691500E-4f);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507E-3f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073E-3f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894E-2f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459E-1f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201E-1f));
+  __m256 y = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.f));
+  __m256i scale_bits =
+      _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(scale_bits));
+}
+
+// AVX-512 variant of iree_uk_sse2_exp_f32x4.
+static inline __m512 iree_uk_avx512_exp_f32x16(__m512 x) {
+  x = _mm512_min_ps(_mm512_set1_ps(89.f),
+                    _mm512_max_ps(_mm512_set1_ps(-88.3762626647949f), x));
+  __m512 fx = _mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f));
+  fx = _mm512_min_ps(_mm512_set1_ps(127.f),
+                       _mm512_max_ps(_mm512_set1_ps(-127.f), fx));
+  __m512i n = _mm512_cvtps_epi32(fx);
+  __m512 nf = _mm512_cvtepi32_ps(n);
+  __m512 r = _mm512_fnmadd_ps(nf, _mm512_set1_ps(0.693359375f), x);
+  r = _mm512_fnmadd_ps(nf, _mm512_set1_ps(-2.12194440e-4f), r);
+  __m512 p = _mm512_set1_ps(1.9875691500E-4f);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.3981999507E-3f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(8.3334519073E-3f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(4.1665795894E-2f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.6666665459E-1f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(5.0000001201E-1f));
+  __m512 y = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r);
+  y = _mm512_add_ps(y, _mm512_set1_ps(1.f));
+  __m512i scale_bits =
+      _mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23);
+  return _mm512_mul_ps(y, _mm512_castsi512_ps(scale_bits));
+}
+
+static inline float iree_uk_avx2_reduce_add_f32x8(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+static inline float iree_uk_avx2_reduce_max_f32x8(__m256 v) {
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+  return _mm_cvtss_f32(m);
+}
@@ -0,0 +1,82 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/elementwise_x86_64.h"
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+
+// Selects lanes of |a| where |mask| is set and of |b| elsewhere.
+static inline __m128 iree_uk_sse2_select_f32x4(__m128 mask, __m128 a,
+                                               __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Vectorized log(x) following Cephes logf: write x = m * 2^e with m in
+// [sqrt(1/2), sqrt(2)) and approximate log(m) with a degree-9 polynomial.
+// Denormal inputs are treated as the smallest normal float.
+static inline __m128 iree_uk_sse2_log_f32x4(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.f);
+  __m128 nan_mask = _mm_or_ps(_mm_cmplt_ps(x, _mm_setzero_ps()),
+                              _mm_cmpunord_ps(x, x));
+  __m128 zero_mask = _mm_cmpeq_ps(x, _mm_setzero_ps());
+  __m128 inf_mask = _mm_cmpeq_ps(x, _mm_set1_ps(__builtin_inff()));
+  x = _mm_max_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x00800000)));
+  __m128i bits = _mm_castps_si128(x);
+  __m128i e_i32 = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126));
+  __m128 e = _mm_cvtepi32_ps(e_i32);
+  // m in [0.5, 1).
+  __m128 m = _mm_castsi128_ps(_mm_or_si128(
+      _mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+      _mm_set1_epi32(0x3f000000)));
+  // If m < sqrt(1/2), use 2 * m - 1 and e - 1, else m - 1.
+  __m128 small_mask = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+  e = _mm_sub_ps(e, _mm_and_ps(small_mask, one));
+  m = _mm_add_ps(_mm_sub_ps(m, one), _mm_and_ps(small_mask, m));
+  __m128 z = _mm_mul_ps(m, m);
+  __m128 p = _mm_set1_ps(7.0376836292E-2f);
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-1.1514610310E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(1.1676998740E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-1.2420140846E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(1.4249322787E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-1.6668057665E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(2.0000714765E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-2.4999993993E-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(3.3333331174E-1f));
+  __m128 y = _mm_mul_ps(_mm_mul_ps(p, m), z);
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  __m128 result = _mm_add_ps(m, y);
+  result = _mm_add_ps(result, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+  result = iree_uk_sse2_select_f32x4(inf_mask, x, result);
+  result = iree_uk_sse2_select_f32x4(
+      zero_mask, _mm_set1_ps(-__builtin_inff()), result);
+  return _mm_or_ps(result, nan_mask);
+}
+
+static inline __m128 iree_uk_sse2_rsqrt_f32x4(__m128 x) {
+  return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(x));
+}
+
+// Defines iree_uk_x32u_<NAME>_row_x86_64 applying VEC_FUNC to 4 lanes at a
+// time. The remainder is handled one lane at a time with scalar loads/stores.
+#define IREE_UK_X32U_ROW_FUNC_X86_64(NAME, VEC_FUNC)                      \
+  void iree_uk_x32u_##NAME##_row_x86_64(                                  \
+      const iree_uk_uint32_t* in, iree_uk_uint32_t* IREE_UK_RESTRICT out, \
+      iree_uk_ssize_t size) {                                             \
+    const float* in_ptr = (const float*)in;                               \
+    float* out_ptr = (float*)out;                                         \
+    iree_uk_ssize_t i = 0;                                                \
+    for (; i + 4 <= size; i += 4) {                                       \
+      _mm_storeu_ps(out_ptr + i, VEC_FUNC(_mm_loadu_ps(in_ptr + i)));     \
+    }                                                                     \
+    for (; i < size; ++i) {                                               \
+      _mm_store_ss(out_ptr + i, VEC_FUNC(_mm_load_ss(in_ptr + i)));       \
+    }                                                                     \
+  }
+
+IREE_UK_X32U_ROW_FUNC_X86_64(expf, iree_uk_sse2_exp_f32x4)
+IREE_UK_X32U_ROW_FUNC_X86_64(logf, iree_uk_sse2_log_f32x4)
+IREE_UK_X32U_ROW_FUNC_X86_64(rsqrtf, iree_uk_sse2_rsqrt_f32x4)
@@ -0,0 +1,26 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_ELEMENTWISE_X86_64_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_ELEMENTWISE_X86_64_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// Row functions for the x32u elementwise ukernels, computing |size| contiguous
+// f32 elements. These only use SSE2, which is part of the x86_64 baseline: the
+// elementwise ukernel ABI does not pass cpu_data, so we can't select wider
+// instructions at runtime here.
+void iree_uk_x32u_expf_row_x86_64(const iree_uk_uint32_t* in,
+                                  iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                  iree_uk_ssize_t size);
+void iree_uk_x32u_logf_row_x86_64(const iree_uk_uint32_t* in,
+                                  iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                  iree_uk_ssize_t size);
+void iree_uk_x32u_rsqrtf_row_x86_64(const iree_uk_uint32_t* in,
+                                    iree_uk_uint32_t* IREE_UK_RESTRICT out,
+                                    iree_uk_ssize_t size);
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_ELEMENTWISE_X86_64_H_
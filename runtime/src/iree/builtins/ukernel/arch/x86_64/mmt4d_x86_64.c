@@ -14,10 +14,34 @@ IREE_UK_MMT4D_TILE_FUNC_DECL(
 IREE_UK_MMT4D_TILE_FUNC_DECL(
     iree_uk_mmt4d_tile_i8i8i32_16x16x2_x86_64_avx512_vnni)
 
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i4i32_8x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_i8i4i32_16x16x2_x86_64_avx512_base)
+
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8x8x1_x86_64_avx2_fma)
 IREE_UK_MMT4D_TILE_FUNC_DECL(
     iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base)
 
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f16f16f32_16x16x1_x86_64_avx512_base)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f16f16f16_16x16x1_x86_64_avx512_base)
+
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_bf16bf16f32_16x16x2_x86_64_avx512_bf16)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_bf16bf16bf16_16x16x2_x86_64_avx512_bf16)
+
+IREE_UK_MMT4D_QUANTIZED_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32u4f32_8x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_QUANTIZED_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32u4f32_16x16x1_x86_64_avx512_base)
+
+void iree_uk_mmt4d_i8i8i32_16x16x4_x86_64_amx(
+    const iree_uk_mmt4d_params_t* params);
+void iree_uk_mmt4d_bf16bf16f32_16x16x2_x86_64_amx(
+    const iree_uk_mmt4d_params_t* params);
+
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_8x8x1(
     const iree_uk_mmt4d_params_t* params) {
@@ -90,6 +114,50 @@ static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32(
   return 0;
 }
 
+static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64_i8i4i32(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (params->M0 == 16 && params->N0 == 16 && params->K0 == 2 &&
+      iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_i8i4i32_16x16x2_x86_64_avx512_base;
+  }
+#endif
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  if (params->M0 == 8 && params->N0 == 8 && params->K0 == 2 &&
+      iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_i8i4i32_8x8x2_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64_f16f16(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->M0 != 16 || params->N0 != 16 || params->K0 != 1) return 0;
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return params->type == iree_uk_mmt4d_type_f16f16f32
+               ? iree_uk_mmt4d_tile_f16f16f32_16x16x1_x86_64_avx512_base
+               : iree_uk_mmt4d_tile_f16f16f16_16x16x1_x86_64_avx512_base;
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_x86_64_bf16bf16(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->M0 != 16 || params->N0 != 16 || params->K0 != 2) return 0;
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BF16
+  if (iree_uk_cpu_supports_avx512_bf16(params->cpu_data)) {
+    return params->type == iree_uk_mmt4d_type_bf16bf16f32
+               ? iree_uk_mmt4d_tile_bf16bf16f32_16x16x2_x86_64_avx512_bf16
+               : iree_uk_mmt4d_tile_bf16bf16bf16_16x16x2_x86_64_avx512_bf16;
+  }
+#endif
+  return 0;
+}
+
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64(
     const iree_uk_mmt4d_params_t* params) {
   switch (params->type) {
@@ -97,8 +165,52 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64(
       return iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32(params);
     case iree_uk_mmt4d_type_i8i8i32:
       return iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32(params);
+    case iree_uk_mmt4d_type_i8i4i32:
+      return iree_uk_mmt4d_select_tile_func_x86_64_i8i4i32(params);
+    case iree_uk_mmt4d_type_f16f16f32:
+    case iree_uk_mmt4d_type_f16f16f16:
+      return iree_uk_mmt4d_select_tile_func_x86_64_f16f16(params);
+    case iree_uk_mmt4d_type_bf16bf16f32:
+    case iree_uk_mmt4d_type_bf16bf16bf16:
+      return iree_uk_mmt4d_select_tile_func_x86_64_bf16bf16(params);
     default:
       IREE_UK_ASSUME_UNREACHABLE;
       return 0;
   }
 }
+
+iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_x86_64(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->type != iree_uk_mmt4d_type_f32u4f32 || params->K0 != 1) return 0;
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (params->M0 == 16 && params->N0 == 16 &&
+      iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_f32u4f32_16x16x1_x86_64_avx512_base;
+  }
+#endif
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  if (params->M0 == 8 && params->N0 == 8 &&
+      iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_f32u4f32_8x8x1_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
+
+bool iree_uk_mmt4d_early_x86_64(const iree_uk_mmt4d_params_t* params) {
+  if (params->M0 != 16 || params->N0 != 16) return false;
+#ifdef IREE_UK_BUILD_X86_64_AMX
+  if (params->type == iree_uk_mmt4d_type_i8i8i32 && params->K0 == 4 &&
+      iree_uk_cpu_supports_amx_int8(params->cpu_data)) {
+    iree_uk_mmt4d_i8i8i32_16x16x4_x86_64_amx(params);
+    return true;
+  }
+  if (params->type == iree_uk_mmt4d_type_bf16bf16f32 && params->K0 == 2 &&
+      iree_uk_cpu_supports_amx_bf16(params->cpu_data)) {
+    iree_uk_mmt4d_bf16bf16f32_16x16x2_x86_64_amx(params);
+    return true;
+  }
+#endif
+  return false;
+}
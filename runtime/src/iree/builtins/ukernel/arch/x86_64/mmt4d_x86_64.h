@@ -15,4 +15,16 @@
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64(
     const iree_uk_mmt4d_params_t* params);
 
+// Same as iree_uk_mmt4d_select_tile_func_x86_64, for types with a quantized
+// RHS.
+iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_x86_64(
+    const iree_uk_mmt4d_params_t* params);
+
+// Handles the entire mmt4d with given params in x86_64-specific code
+// specializing the whole loop nest, such as AMX, if available for these params.
+// Returns false if no such code path exists, in which case the caller falls
+// back to using a tile function.
+bool iree_uk_mmt4d_early_x86_64(const iree_uk_mmt4d_params_t* params);
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_X86_64_H_
@@ -0,0 +1,197 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// AMX implementation of mmt4d, handling the entire loop nest instead of just
+// a tile function. This lets us configure the tile registers (LDTILECFG, which
+// is expensive) once per mmt4d call instead of once per M0xN0 tile, and lets us
+// reuse the rearranged LHS tiles across all N.
+//
+// Both supported cases have 16x16 output tiles with 32-bit accumulators and
+// 4-byte groups along K: i8i8i32 with K0=4 (TDPBSSD) and bf16bf16f32 with K0=2
+// (TDPBF16PS). Mapping the mmt4d layouts onto the AMX operands:
+// * A RHS panel is [K][N0][K0], so 16 consecutive K-iterations are exactly
+//   an AMX B tile: 16 rows (one per K-iteration) of 16 4-byte groups.
+// * A LHS panel is [K][M0][K0] but the AMX A tile wants one row per M0 index,
+//   i.e. the 16x16 matrix of 4-byte groups needs to be transposed. We do that
+//   with gathers into a stack buffer, for a chunk of K at a time, and then
+//   reuse that for all the N tiles of the current LHS row.
+// * The output tile is [M0][N0] and is exactly an AMX C tile.
+// The K-remainder (K not a multiple of 16) is handled by zero-padding both the
+// transposed LHS and a copy of the last RHS rows. The padding is needed on the
+// RHS too, even though the corresponding LHS values are zero, because garbage
+// bf16 values could be Inf/NaN, and because reading it could be out of bounds.
+
+// Number of K-iterations in one AMX A/B tile.
+#define IREE_UK_AMX_TILE_K 16
+// Number of AMX A tiles in the LHS chunk buffer, bounding stack usage to 8 KiB.
+#define IREE_UK_AMX_LHS_CHUNK_TILES 8
+#define IREE_UK_AMX_LHS_CHUNK_K \
+  (IREE_UK_AMX_TILE_K * IREE_UK_AMX_LHS_CHUNK_TILES)
+// Bytes in one 16x64-byte AMX tile.
+#define IREE_UK_AMX_TILE_BYTES 1024
+
+// Tile register assignment, used as immediates in the tile intrinsics.
+#define IREE_UK_AMX_TMM_C0 0
+#define IREE_UK_AMX_TMM_C1 1
+#define IREE_UK_AMX_TMM_A 2
+#define IREE_UK_AMX_TMM_B0 3
+#define IREE_UK_AMX_TMM_B1 4
+
+// Memory layout of the LDTILECFG operand, palette 1.
+typedef struct iree_uk_amx_tilecfg_t {
+  iree_uk_uint8_t palette_id;
+  iree_uk_uint8_t start_row;
+  iree_uk_uint8_t reserved[14];
+  iree_uk_uint16_t colsb[16];
+  iree_uk_uint8_t rows[16];
+} iree_uk_amx_tilecfg_t;
+
+// Configures all the tile registers that we use as full 16x64-byte tiles.
+static void iree_uk_amx_configure_tiles(void) {
+  iree_uk_amx_tilecfg_t cfg __attribute__((aligned(64)));
+  iree_uk_memset(&cfg, 0, sizeof cfg);
+  cfg.palette_id = 1;
+  for (int t = IREE_UK_AMX_TMM_C0; t <= IREE_UK_AMX_TMM_B1; ++t) {
+    cfg.colsb[t] = 64;
+    cfg.rows[t] = 16;
+  }
+  _tile_loadconfig(&cfg);
+}
+
+// Transposes |k_size| <= 16 K-iterations of a LHS panel, each a row of 16
+// 4-byte groups, into one AMX A tile at |out_ptr|, zero-padding the rows up to
+// 16 groups. The gathers are masked so nothing is read past |k_size|.
+static inline void iree_uk_amx_transpose_lhs_tile(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT lhs_ptr, int k_size) {
+  __mmask16 mask = (__mmask16)((1u << k_size) - 1);
+  __m512i indices =
+      _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                           11, 12, 13, 14, 15),
+                         _mm512_set1_epi32(16));
+  for (int m = 0; m < 16; ++m) {
+    __m512i row = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), mask,
+                                              indices, lhs_ptr + m, 4);
+    _mm512_storeu_si512((__m512i*)(out_ptr + 16 * m), row);
+  }
+}
+
+// Computes one or two (|n_size|) adjacent 16x16 output tiles for one chunk of
+// K, from the transposed LHS chunk in |lhs_tiles|.
+static inline void iree_uk_mmt4d_amx_tiles(
+    char* out_ptr, const char* lhs_tiles, const char* rhs_panel,
+    iree_uk_ssize_t rhs_panel_stride, iree_uk_int32_t k_size, int n_size,
+    bool accumulate, iree_uk_mmt4d_type_t type) {
+  char rhs_tail[2][IREE_UK_AMX_TILE_BYTES] __attribute__((aligned(64)));
+  const int out_tile_size = IREE_UK_AMX_TILE_BYTES;
+  if (accumulate) {
+    _tile_loadd(IREE_UK_AMX_TMM_C0, out_ptr, 64);
+    if (n_size == 2) {
+      _tile_loadd(IREE_UK_AMX_TMM_C1, out_ptr + out_tile_size, 64);
+    }
+  } else {
+    _tile_zero(IREE_UK_AMX_TMM_C0);
+    if (n_size == 2) _tile_zero(IREE_UK_AMX_TMM_C1);
+  }
+  for (iree_uk_int32_t k = 0; k < k_size; k += IREE_UK_AMX_TILE_K) {
+    const char* rhs_ptr0 = rhs_panel + 64 * k;
+    const char* rhs_ptr1 = rhs_ptr0 + rhs_panel_stride;
+    iree_uk_int32_t k_rem = k_size - k;
+    if (k_rem < IREE_UK_AMX_TILE_K) {
+      for (int n = 0; n < n_size; ++n) {
+        iree_uk_memcpy(rhs_tail[n], n ? rhs_ptr1 : rhs_ptr0, 64 * k_rem);
+        iree_uk_memset(rhs_tail[n] + 64 * k_rem, 0,
+                       IREE_UK_AMX_TILE_BYTES - 64 * k_rem);
+      }
+      rhs_ptr0 = rhs_tail[0];
+      rhs_ptr1 = rhs_tail[1];
+    }
+    _tile_loadd(IREE_UK_AMX_TMM_A, lhs_tiles + 64 * k, 64);
+    _tile_loadd(IREE_UK_AMX_TMM_B0, rhs_ptr0, 64);
+    if (type == iree_uk_mmt4d_type_i8i8i32) {
+      _tile_dpbssd(IREE_UK_AMX_TMM_C0, IREE_UK_AMX_TMM_A, IREE_UK_AMX_TMM_B0);
+    } else {
+      _tile_dpbf16ps(IREE_UK_AMX_TMM_C0, IREE_UK_AMX_TMM_A, IREE_UK_AMX_TMM_B0);
+    }
+    if (n_size == 2) {
+      _tile_loadd(IREE_UK_AMX_TMM_B1, rhs_ptr1, 64);
+      if (type == iree_uk_mmt4d_type_i8i8i32) {
+        _tile_dpbssd(IREE_UK_AMX_TMM_C1, IREE_UK_AMX_TMM_A,
+                     IREE_UK_AMX_TMM_B1);
+      } else {
+        _tile_dpbf16ps(IREE_UK_AMX_TMM_C1, IREE_UK_AMX_TMM_A,
+                       IREE_UK_AMX_TMM_B1);
+      }
+    }
+  }
+  _tile_stored(IREE_UK_AMX_TMM_C0, out_ptr, 64);
+  if (n_size == 2) {
+    _tile_stored(IREE_UK_AMX_TMM_C1, out_ptr + out_tile_size, 64);
+  }
+}
+
+// Shared implementation of the AMX mmt4d loop nest. |type| is a compile-time
+// constant in the callers so that this is inlined into specialized functions.
+static inline void iree_uk_mmt4d_x86_64_amx(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_type_t type) {
+  IREE_UK_ASSERT(params->M0 == 16 && params->N0 == 16);
+  iree_uk_int32_t lhs_tiles[IREE_UK_AMX_LHS_CHUNK_K * 16]
+      __attribute__((aligned(64)));
+  const iree_uk_int16_t in_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_mmt4d_lhs_type(type));
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int32_t out_tile_size = IREE_UK_AMX_TILE_BYTES;
+  iree_uk_ssize_t lhs_panel_stride = params->lhs_stride << in_elem_size_log2;
+  iree_uk_ssize_t rhs_panel_stride = params->rhs_stride << in_elem_size_log2;
+  iree_uk_ssize_t out_stride = params->out_stride << 2;
+  iree_uk_amx_configure_tiles();
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    const char* lhs_panel =
+        (const char*)params->lhs_buffer + i * lhs_panel_stride;
+    char* out_tile_row = (char*)params->out_buffer + i * out_stride;
+    for (iree_uk_int32_t k0 = 0; k0 < K; k0 += IREE_UK_AMX_LHS_CHUNK_K) {
+      iree_uk_int32_t k_size = K - k0;
+      if (k_size > IREE_UK_AMX_LHS_CHUNK_K) k_size = IREE_UK_AMX_LHS_CHUNK_K;
+      for (iree_uk_int32_t k = 0; k < k_size; k += IREE_UK_AMX_TILE_K) {
+        iree_uk_int32_t k_rem = k_size - k;
+        iree_uk_amx_transpose_lhs_tile(
+            lhs_tiles + 16 * k,
+            (const iree_uk_int32_t*)(lhs_panel + 64 * (k0 + k)),
+            k_rem < IREE_UK_AMX_TILE_K ? k_rem : IREE_UK_AMX_TILE_K);
+      }
+      bool accumulate = k0 > 0 || (params->flags & IREE_UK_FLAG_ACCUMULATE);
+      const char* rhs_panel =
+          (const char*)params->rhs_buffer + 64 * (iree_uk_ssize_t)k0;
+      char* out_tile = out_tile_row;
+      for (iree_uk_int32_t j = 0; j < N; j += 2) {
+        int n_size = j + 1 < N ? 2 : 1;
+        iree_uk_mmt4d_amx_tiles(out_tile, (const char*)lhs_tiles, rhs_panel,
+                                rhs_panel_stride, k_size, n_size, accumulate,
+                                type);
+        out_tile += 2 * out_tile_size;
+        rhs_panel += 2 * rhs_panel_stride;
+      }
+    }
+  }
+  _tile_release();
+}
+
+void iree_uk_mmt4d_i8i8i32_16x16x4_x86_64_amx(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_x86_64_amx(params, iree_uk_mmt4d_type_i8i8i32);
+}
+
+void iree_uk_mmt4d_bf16bf16f32_16x16x2_x86_64_amx(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_x86_64_amx(params, iree_uk_mmt4d_type_bf16bf16f32);
+}
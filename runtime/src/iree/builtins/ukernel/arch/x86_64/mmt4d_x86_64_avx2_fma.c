@@ -158,3 +158,104 @@ void iree_uk_mmt4d_tile_i8i8i32_8x8x2_x86_64_avx2_fma(
   iree_uk_avx_storeu_2x128((__m128i*)(out_ptr + 3 * 8 + 4),
                            (__m128i*)(out_ptr + 7 * 8 + 0), acc_3_4567_7_0123);
 }
+
+// Loads 16 nibble-packed i4 values (8 bytes) and sign-extends them to i16.
+static inline __m256i iree_uk_avx2_load_16xi4_as_i16(const void* src) {
+  __m128i bytes = _mm_loadl_epi64((const __m128i*)src);
+  __m128i nibble_mask = _mm_set1_epi8(0xF);
+  __m128i lo = _mm_and_si128(bytes, nibble_mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+  // Interleave to get the values in element order, then sign-extend from 4 to
+  // 8 bits as (x ^ 8) - 8.
+  __m128i values = _mm_unpacklo_epi8(lo, hi);
+  __m128i eight = _mm_set1_epi8(8);
+  values = _mm_sub_epi8(_mm_xor_si128(values, eight), eight);
+  return _mm256_cvtepi8_epi16(values);
+}
+
+void iree_uk_mmt4d_tile_i8i4i32_8x8x2_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // acc[m] holds row m of the output tile. Each VPMADDWD multiplies the pair of
+  // LHS values of row m, broadcast to all lanes, with the pair of RHS values of
+  // each column. Constant loop bounds below get fully unrolled, keeping this in
+  // registers.
+  __m256i acc[8];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int m = 0; m < 8; ++m) {
+      acc[m] = _mm256_loadu_si256((const __m256i*)(out_ptr + 8 * m));
+    }
+  } else {
+    for (int m = 0; m < 8; ++m) acc[m] = _mm256_setzero_si256();
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    __m256i rhs_i16 = iree_uk_avx2_load_16xi4_as_i16(rhs_ptr);
+    rhs_ptr += 8;
+    __m256i lhs_i16 =
+        _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)lhs_ptr));
+    lhs_ptr += 16;
+    for (int m = 0; m < 8; ++m) {
+      __m256i lhs_i16_mm =
+          _mm256_permutevar8x32_epi32(lhs_i16, _mm256_set1_epi32(m));
+      acc[m] = _mm256_add_epi32(acc[m], _mm256_madd_epi16(lhs_i16_mm, rhs_i16));
+    }
+  }
+  for (int m = 0; m < 8; ++m) {
+    _mm256_storeu_si256((__m256i*)(out_ptr + 8 * m), acc[m]);
+  }
+}
+
+// Loads 8 nibble-packed u4 values (4 bytes) and converts them to f32.
+static inline __m256 iree_uk_avx2_load_8xu4_as_ps(const void* src) {
+  iree_uk_int32_t word;
+  iree_uk_memcpy(&word, src, sizeof word);
+  __m128i bytes = _mm_cvtsi32_si128(word);
+  __m128i nibble_mask = _mm_set1_epi8(0xF);
+  __m128i lo = _mm_and_si128(bytes, nibble_mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+  __m128i values = _mm_unpacklo_epi8(lo, hi);
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(values));
+}
+
+void iree_uk_mmt4d_tile_f32u4f32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, const float* rhs_scales,
+    const float* rhs_zero_points, iree_uk_int32_t K,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m256 acc[8];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int m = 0; m < 8; ++m) acc[m] = _mm256_loadu_ps(out_ptr + 8 * m);
+  } else {
+    for (int m = 0; m < 8; ++m) acc[m] = _mm256_setzero_ps();
+  }
+  for (iree_uk_int32_t k_group = 0; k_group < K; k_group += group_size) {
+    // Dequantize as q * scale + bias, with bias = -zero_point * scale, so that
+    // it takes a single FMA per RHS vector.
+    __m256 scale = _mm256_loadu_ps(rhs_scales);
+    __m256 bias = _mm256_mul_ps(
+        _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(rhs_zero_points)),
+        scale);
+    rhs_scales += 8;
+    rhs_zero_points += 8;
+    iree_uk_int32_t k_end = k_group + group_size;
+    if (k_end > K) k_end = K;
+    for (iree_uk_int32_t k = k_group; k < k_end; ++k) {
+      __m256 rhs =
+          _mm256_fmadd_ps(iree_uk_avx2_load_8xu4_as_ps(rhs_ptr), scale, bias);
+      rhs_ptr += 4;
+      for (int m = 0; m < 8; ++m) {
+        acc[m] = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_ptr + m), rhs, acc[m]);
+      }
+      lhs_ptr += 8;
+    }
+  }
+  for (int m = 0; m < 8; ++m) _mm256_storeu_ps(out_ptr + 8 * m, acc[m]);
+}
@@ -291,3 +291,295 @@ void iree_uk_mmt4d_tile_i8i8i32_16x16x2_x86_64_avx512_base(
   iree_uk_avx512_storeu_4x128_to_16x16xi32(out_ptr, 3, 12, 7, 8, 11, 4, 15, 0,
                                            acc_3_CDEF_7_89AB_B_4567_F_0123);
 }
+
+// Shared implementation of the f16*f16->{f32,f16} 16x16x1 tile functions.
+// The accumulator is f32 in both cases; it is only converted to f16 (with
+// round-to-nearest-even) when the destination tile is f16. |out_type| is a
+// compile-time constant in the callers so that this is inlined into two
+// specialized functions.
+static inline void iree_uk_mmt4d_tile_f16f16fXX_16x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, iree_uk_type_t out_type) {
+  float* out_f32_ptr = out_tile;
+  iree_uk_uint16_t* out_f16_ptr = out_tile;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512 acc0, acc1, acc2, acc3, acc4, acc5, acc6, acc7;
+  __m512 acc8, acc9, acc10, acc11, acc12, acc13, acc14, acc15;
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    if (out_type == IREE_UK_TYPE_FLOAT_32) {
+      acc0 = _mm512_loadu_ps(out_f32_ptr + 0 * 16);
+      acc1 = _mm512_loadu_ps(out_f32_ptr + 1 * 16);
+      acc2 = _mm512_loadu_ps(out_f32_ptr + 2 * 16);
+      acc3 = _mm512_loadu_ps(out_f32_ptr + 3 * 16);
+      acc4 = _mm512_loadu_ps(out_f32_ptr + 4 * 16);
+      acc5 = _mm512_loadu_ps(out_f32_ptr + 5 * 16);
+      acc6 = _mm512_loadu_ps(out_f32_ptr + 6 * 16);
+      acc7 = _mm512_loadu_ps(out_f32_ptr + 7 * 16);
+      acc8 = _mm512_loadu_ps(out_f32_ptr + 8 * 16);
+      acc9 = _mm512_loadu_ps(out_f32_ptr + 9 * 16);
+      acc10 = _mm512_loadu_ps(out_f32_ptr + 10 * 16);
+      acc11 = _mm512_loadu_ps(out_f32_ptr + 11 * 16);
+      acc12 = _mm512_loadu_ps(out_f32_ptr + 12 * 16);
+      acc13 = _mm512_loadu_ps(out_f32_ptr + 13 * 16);
+      acc14 = _mm512_loadu_ps(out_f32_ptr + 14 * 16);
+      acc15 = _mm512_loadu_ps(out_f32_ptr + 15 * 16);
+    } else {
+      acc0 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 0 * 16)));
+      acc1 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 1 * 16)));
+      acc2 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 2 * 16)));
+      acc3 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 3 * 16)));
+      acc4 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 4 * 16)));
+      acc5 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 5 * 16)));
+      acc6 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 6 * 16)));
+      acc7 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 7 * 16)));
+      acc8 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 8 * 16)));
+      acc9 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 9 * 16)));
+      acc10 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 10 * 16)));
+      acc11 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 11 * 16)));
+      acc12 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 12 * 16)));
+      acc13 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 13 * 16)));
+      acc14 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 14 * 16)));
+      acc15 = _mm512_cvtph_ps(
+          _mm256_loadu_si256((const __m256i*)(out_f16_ptr + 15 * 16)));
+    }
+  } else {
+    acc0 = _mm512_setzero_ps();
+    acc1 = _mm512_setzero_ps();
+    acc2 = _mm512_setzero_ps();
+    acc3 = _mm512_setzero_ps();
+    acc4 = _mm512_setzero_ps();
+    acc5 = _mm512_setzero_ps();
+    acc6 = _mm512_setzero_ps();
+    acc7 = _mm512_setzero_ps();
+    acc8 = _mm512_setzero_ps();
+    acc9 = _mm512_setzero_ps();
+    acc10 = _mm512_setzero_ps();
+    acc11 = _mm512_setzero_ps();
+    acc12 = _mm512_setzero_ps();
+    acc13 = _mm512_setzero_ps();
+    acc14 = _mm512_setzero_ps();
+    acc15 = _mm512_setzero_ps();
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    __m512 rhs = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)rhs_ptr));
+    rhs_ptr += 16;
+    // Convert the whole LHS row to f32 once and broadcast from there.
+    float lhs[16];
+    _mm512_storeu_ps(
+        lhs, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)lhs_ptr)));
+    lhs_ptr += 16;
+    acc0 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[0]), rhs, acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[1]), rhs, acc1);
+    acc2 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[2]), rhs, acc2);
+    acc3 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[3]), rhs, acc3);
+    acc4 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[4]), rhs, acc4);
+    acc5 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[5]), rhs, acc5);
+    acc6 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[6]), rhs, acc6);
+    acc7 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[7]), rhs, acc7);
+    acc8 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[8]), rhs, acc8);
+    acc9 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[9]), rhs, acc9);
+    acc10 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[10]), rhs, acc10);
+    acc11 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[11]), rhs, acc11);
+    acc12 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[12]), rhs, acc12);
+    acc13 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[13]), rhs, acc13);
+    acc14 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[14]), rhs, acc14);
+    acc15 = _mm512_fmadd_ps(_mm512_set1_ps(lhs[15]), rhs, acc15);
+  }
+  if (out_type == IREE_UK_TYPE_FLOAT_32) {
+    _mm512_storeu_ps(out_f32_ptr + 0 * 16, acc0);
+    _mm512_storeu_ps(out_f32_ptr + 1 * 16, acc1);
+    _mm512_storeu_ps(out_f32_ptr + 2 * 16, acc2);
+    _mm512_storeu_ps(out_f32_ptr + 3 * 16, acc3);
+    _mm512_storeu_ps(out_f32_ptr + 4 * 16, acc4);
+    _mm512_storeu_ps(out_f32_ptr + 5 * 16, acc5);
+    _mm512_storeu_ps(out_f32_ptr + 6 * 16, acc6);
+    _mm512_storeu_ps(out_f32_ptr + 7 * 16, acc7);
+    _mm512_storeu_ps(out_f32_ptr + 8 * 16, acc8);
+    _mm512_storeu_ps(out_f32_ptr + 9 * 16, acc9);
+    _mm512_storeu_ps(out_f32_ptr + 10 * 16, acc10);
+    _mm512_storeu_ps(out_f32_ptr + 11 * 16, acc11);
+    _mm512_storeu_ps(out_f32_ptr + 12 * 16, acc12);
+    _mm512_storeu_ps(out_f32_ptr + 13 * 16, acc13);
+    _mm512_storeu_ps(out_f32_ptr + 14 * 16, acc14);
+    _mm512_storeu_ps(out_f32_ptr + 15 * 16, acc15);
+  } else {
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 0 * 16),
+        _mm512_cvtps_ph(acc0, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 1 * 16),
+        _mm512_cvtps_ph(acc1, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 2 * 16),
+        _mm512_cvtps_ph(acc2, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 3 * 16),
+        _mm512_cvtps_ph(acc3, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 4 * 16),
+        _mm512_cvtps_ph(acc4, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 5 * 16),
+        _mm512_cvtps_ph(acc5, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 6 * 16),
+        _mm512_cvtps_ph(acc6, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 7 * 16),
+        _mm512_cvtps_ph(acc7, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 8 * 16),
+        _mm512_cvtps_ph(acc8, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 9 * 16),
+        _mm512_cvtps_ph(acc9, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 10 * 16),
+        _mm512_cvtps_ph(acc10, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 11 * 16),
+        _mm512_cvtps_ph(acc11, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 12 * 16),
+        _mm512_cvtps_ph(acc12, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 13 * 16),
+        _mm512_cvtps_ph(acc13, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 14 * 16),
+        _mm512_cvtps_ph(acc14, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    _mm256_storeu_si256(
+        (__m256i*)(out_f16_ptr + 15 * 16),
+        _mm512_cvtps_ph(acc15, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+}
+
+void iree_uk_mmt4d_tile_f16f16f32_16x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f16f16fXX_16x16x1_x86_64_avx512_base(
+      out_tile, lhs_panel, rhs_panel, K, flags, IREE_UK_TYPE_FLOAT_32);
+}
+
+void iree_uk_mmt4d_tile_f16f16f16_16x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f16f16fXX_16x16x1_x86_64_avx512_base(
+      out_tile, lhs_panel, rhs_panel, K, flags, IREE_UK_TYPE_FLOAT_16);
+}
+
+// Loads 32 nibble-packed i4 values (16 bytes) and sign-extends them to i16.
+static inline __m512i iree_uk_avx512_load_32xi4_as_i16(const void* src) {
+  __m128i bytes = _mm_loadu_si128((const __m128i*)src);
+  __m128i nibble_mask = _mm_set1_epi8(0xF);
+  __m128i lo = _mm_and_si128(bytes, nibble_mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+  // Interleave to get the values in element order, then sign-extend from 4 to
+  // 8 bits as (x ^ 8) - 8.
+  __m256i values = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_unpacklo_epi8(lo, hi)),
+      _mm_unpackhi_epi8(lo, hi), 1);
+  __m256i eight = _mm256_set1_epi8(8);
+  values = _mm256_sub_epi8(_mm256_xor_si256(values, eight), eight);
+  return _mm512_cvtepi8_epi16(values);
+}
+
+void iree_uk_mmt4d_tile_i8i4i32_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // acc[m] holds row m of the output tile. Each VPMADDWD multiplies the pair of
+  // LHS values of row m, broadcast to all lanes, with the pair of RHS values of
+  // each column. Constant loop bounds below get fully unrolled, keeping this in
+  // registers.
+  __m512i acc[16];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int m = 0; m < 16; ++m) acc[m] = _mm512_loadu_si512(out_ptr + 16 * m);
+  } else {
+    for (int m = 0; m < 16; ++m) acc[m] = _mm512_setzero_si512();
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    __m512i rhs_i16 = iree_uk_avx512_load_32xi4_as_i16(rhs_ptr);
+    rhs_ptr += 16;
+    __m512i lhs_i16 =
+        _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)lhs_ptr));
+    lhs_ptr += 32;
+    for (int m = 0; m < 16; ++m) {
+      __m512i lhs_i16_mm =
+          _mm512_permutexvar_epi32(_mm512_set1_epi32(m), lhs_i16);
+      acc[m] = _mm512_add_epi32(acc[m], _mm512_madd_epi16(lhs_i16_mm, rhs_i16));
+    }
+  }
+  for (int m = 0; m < 16; ++m) _mm512_storeu_si512(out_ptr + 16 * m, acc[m]);
+}
+
+// Loads 16 nibble-packed u4 values (8 bytes) and converts them to f32.
+static inline __m512 iree_uk_avx512_load_16xu4_as_ps(const void* src) {
+  __m128i bytes = _mm_loadl_epi64((const __m128i*)src);
+  __m128i nibble_mask = _mm_set1_epi8(0xF);
+  __m128i lo = _mm_and_si128(bytes, nibble_mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+  __m128i values = _mm_unpacklo_epi8(lo, hi);
+  return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(values));
+}
+
+void iree_uk_mmt4d_tile_f32u4f32_16x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, const float* rhs_scales,
+    const float* rhs_zero_points, iree_uk_int32_t K,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512 acc[16];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int m = 0; m < 16; ++m) acc[m] = _mm512_loadu_ps(out_ptr + 16 * m);
+  } else {
+    for (int m = 0; m < 16; ++m) acc[m] = _mm512_setzero_ps();
+  }
+  for (iree_uk_int32_t k_group = 0; k_group < K; k_group += group_size) {
+    // Dequantize as q * scale + bias, with bias = -zero_point * scale, so that
+    // it takes a single FMA per RHS vector.
+    __m512 scale = _mm512_loadu_ps(rhs_scales);
+    __m512 bias = _mm512_mul_ps(
+        _mm512_sub_ps(_mm512_setzero_ps(), _mm512_loadu_ps(rhs_zero_points)),
+        scale);
+    rhs_scales += 16;
+    rhs_zero_points += 16;
+    iree_uk_int32_t k_end = k_group + group_size;
+    if (k_end > K) k_end = K;
+    for (iree_uk_int32_t k = k_group; k < k_end; ++k) {
+      __m512 rhs = _mm512_fmadd_ps(iree_uk_avx512_load_16xu4_as_ps(rhs_ptr),
+                                   scale, bias);
+      rhs_ptr += 8;
+      for (int m = 0; m < 16; ++m) {
+        acc[m] = _mm512_fmadd_ps(_mm512_set1_ps(lhs_ptr[m]), rhs, acc[m]);
+      }
+      lhs_ptr += 16;
+    }
+  }
+  for (int m = 0; m < 16; ++m) _mm512_storeu_ps(out_ptr + 16 * m, acc[m]);
+}
@@ -0,0 +1,196 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/mmt4d.h"
+
+// Loads 16 bf16 values and widens them to f32, which is exact.
+static inline __m512 iree_uk_avx512_loadu_bf16_as_ps(const void* src) {
+  __m512i bits = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)src));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 16));
+}
+
+// Shared implementation of the bf16*bf16->{f32,bf16} 16x16x2 tile functions.
+// Each VDPBF16PS computes, for each of the 16 f32 lanes of an accumulator row,
+// the dot product of a pair of LHS bf16 values (broadcast to all lanes) with a
+// pair of RHS bf16 values, accumulating in f32. The accumulator is only
+// converted to bf16 (with round-to-nearest-even) when the destination tile is
+// bf16. |out_type| is a compile-time constant in the callers so that this is
+// inlined into two specialized functions.
+//
+// Note that VDPBF16PS and VCVTNEPS2BF16 treat denormals as zero, unlike the
+// generic code.
+static inline void iree_uk_mmt4d_tile_bf16bf16fXX_16x16x2_x86_64_avx512_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, iree_uk_type_t out_type) {
+  float* out_f32_ptr = out_tile;
+  iree_uk_uint16_t* out_bf16_ptr = out_tile;
+  const iree_uk_int32_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512 acc0, acc1, acc2, acc3, acc4, acc5, acc6, acc7;
+  __m512 acc8, acc9, acc10, acc11, acc12, acc13, acc14, acc15;
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    if (out_type == IREE_UK_TYPE_FLOAT_32) {
+      acc0 = _mm512_loadu_ps(out_f32_ptr + 0 * 16);
+      acc1 = _mm512_loadu_ps(out_f32_ptr + 1 * 16);
+      acc2 = _mm512_loadu_ps(out_f32_ptr + 2 * 16);
+      acc3 = _mm512_loadu_ps(out_f32_ptr + 3 * 16);
+      acc4 = _mm512_loadu_ps(out_f32_ptr + 4 * 16);
+      acc5 = _mm512_loadu_ps(out_f32_ptr + 5 * 16);
+      acc6 = _mm512_loadu_ps(out_f32_ptr + 6 * 16);
+      acc7 = _mm512_loadu_ps(out_f32_ptr + 7 * 16);
+      acc8 = _mm512_loadu_ps(out_f32_ptr + 8 * 16);
+      acc9 = _mm512_loadu_ps(out_f32_ptr + 9 * 16);
+      acc10 = _mm512_loadu_ps(out_f32_ptr + 10 * 16);
+      acc11 = _mm512_loadu_ps(out_f32_ptr + 11 * 16);
+      acc12 = _mm512_loadu_ps(out_f32_ptr + 12 * 16);
+      acc13 = _mm512_loadu_ps(out_f32_ptr + 13 * 16);
+      acc14 = _mm512_loadu_ps(out_f32_ptr + 14 * 16);
+      acc15 = _mm512_loadu_ps(out_f32_ptr + 15 * 16);
+    } else {
+      acc0 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 0 * 16);
+      acc1 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 1 * 16);
+      acc2 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 2 * 16);
+      acc3 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 3 * 16);
+      acc4 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 4 * 16);
+      acc5 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 5 * 16);
+      acc6 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 6 * 16);
+      acc7 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 7 * 16);
+      acc8 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 8 * 16);
+      acc9 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 9 * 16);
+      acc10 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 10 * 16);
+      acc11 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 11 * 16);
+      acc12 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 12 * 16);
+      acc13 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 13 * 16);
+      acc14 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 14 * 16);
+      acc15 = iree_uk_avx512_loadu_bf16_as_ps(out_bf16_ptr + 15 * 16);
+    }
+  } else {
+    acc0 = _mm512_setzero_ps();
+    acc1 = _mm512_setzero_ps();
+    acc2 = _mm512_setzero_ps();
+    acc3 = _mm512_setzero_ps();
+    acc4 = _mm512_setzero_ps();
+    acc5 = _mm512_setzero_ps();
+    acc6 = _mm512_setzero_ps();
+    acc7 = _mm512_setzero_ps();
+    acc8 = _mm512_setzero_ps();
+    acc9 = _mm512_setzero_ps();
+    acc10 = _mm512_setzero_ps();
+    acc11 = _mm512_setzero_ps();
+    acc12 = _mm512_setzero_ps();
+    acc13 = _mm512_setzero_ps();
+    acc14 = _mm512_setzero_ps();
+    acc15 = _mm512_setzero_ps();
+  }
+  for (iree_uk_int32_t k = 0; k < K; ++k) {
+    __m512bh rhs = (__m512bh)_mm512_loadu_si512((const __m512i*)rhs_ptr);
+    rhs_ptr += 32;
+    acc0 = _mm512_dpbf16_ps(
+        acc0, (__m512bh)_mm512_set1_epi32(lhs_ptr[0]), rhs);
+    acc1 = _mm512_dpbf16_ps(
+        acc1, (__m512bh)_mm512_set1_epi32(lhs_ptr[1]), rhs);
+    acc2 = _mm512_dpbf16_ps(
+        acc2, (__m512bh)_mm512_set1_epi32(lhs_ptr[2]), rhs);
+    acc3 = _mm512_dpbf16_ps(
+        acc3, (__m512bh)_mm512_set1_epi32(lhs_ptr[3]), rhs);
+    acc4 = _mm512_dpbf16_ps(
+        acc4, (__m512bh)_mm512_set1_epi32(lhs_ptr[4]), rhs);
+    acc5 = _mm512_dpbf16_ps(
+        acc5, (__m512bh)_mm512_set1_epi32(lhs_ptr[5]), rhs);
+    acc6 = _mm512_dpbf16_ps(
+        acc6, (__m512bh)_mm512_set1_epi32(lhs_ptr[6]), rhs);
+    acc7 = _mm512_dpbf16_ps(
+        acc7, (__m512bh)_mm512_set1_epi32(lhs_ptr[7]), rhs);
+    acc8 = _mm512_dpbf16_ps(
+        acc8, (__m512bh)_mm512_set1_epi32(lhs_ptr[8]), rhs);
+    acc9 = _mm512_dpbf16_ps(
+        acc9, (__m512bh)_mm512_set1_epi32(lhs_ptr[9]), rhs);
+    acc10 = _mm512_dpbf16_ps(
+        acc10, (__m512bh)_mm512_set1_epi32(lhs_ptr[10]), rhs);
+    acc11 = _mm512_dpbf16_ps(
+        acc11, (__m512bh)_mm512_set1_epi32(lhs_ptr[11]), rhs);
+    acc12 = _mm512_dpbf16_ps(
+        acc12, (__m512bh)_mm512_set1_epi32(lhs_ptr[12]), rhs);
+    acc13 = _mm512_dpbf16_ps(
+        acc13, (__m512bh)_mm512_set1_epi32(lhs_ptr[13]), rhs);
+    acc14 = _mm512_dpbf16_ps(
+        acc14, (__m512bh)_mm512_set1_epi32(lhs_ptr[14]), rhs);
+    acc15 = _mm512_dpbf16_ps(
+        acc15, (__m512bh)_mm512_set1_epi32(lhs_ptr[15]), rhs);
+    lhs_ptr += 16;
+  }
+  if (out_type == IREE_UK_TYPE_FLOAT_32) {
+    _mm512_storeu_ps(out_f32_ptr + 0 * 16, acc0);
+    _mm512_storeu_ps(out_f32_ptr + 1 * 16, acc1);
+    _mm512_storeu_ps(out_f32_ptr + 2 * 16, acc2);
+    _mm512_storeu_ps(out_f32_ptr + 3 * 16, acc3);
+    _mm512_storeu_ps(out_f32_ptr + 4 * 16, acc4);
+    _mm512_storeu_ps(out_f32_ptr + 5 * 16, acc5);
+    _mm512_storeu_ps(out_f32_ptr + 6 * 16, acc6);
+    _mm512_storeu_ps(out_f32_ptr + 7 * 16, acc7);
+    _mm512_storeu_ps(out_f32_ptr + 8 * 16, acc8);
+    _mm512_storeu_ps(out_f32_ptr + 9 * 16, acc9);
+    _mm512_storeu_ps(out_f32_ptr + 10 * 16, acc10);
+    _mm512_storeu_ps(out_f32_ptr + 11 * 16, acc11);
+    _mm512_storeu_ps(out_f32_ptr + 12 * 16, acc12);
+    _mm512_storeu_ps(out_f32_ptr + 13 * 16, acc13);
+    _mm512_storeu_ps(out_f32_ptr + 14 * 16, acc14);
+    _mm512_storeu_ps(out_f32_ptr + 15 * 16, acc15);
+  } else {
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 0 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc0));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 1 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc1));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 2 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc2));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 3 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc3));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 4 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc4));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 5 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc5));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 6 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc6));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 7 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc7));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 8 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc8));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 9 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc9));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 10 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc10));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 11 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc11));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 12 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc12));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 13 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc13));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 14 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc14));
+    _mm256_storeu_si256((__m256i*)(out_bf16_ptr + 15 * 16),
+                        (__m256i)_mm512_cvtneps_pbh(acc15));
+  }
+}
+
+void iree_uk_mmt4d_tile_bf16bf16f32_16x16x2_x86_64_avx512_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_bf16bf16fXX_16x16x2_x86_64_avx512_bf16(
+      out_tile, lhs_panel, rhs_panel, K, flags, IREE_UK_TYPE_FLOAT_32);
+}
+
+void iree_uk_mmt4d_tile_bf16bf16bf16_16x16x2_x86_64_avx512_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel, iree_uk_int32_t K,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_bf16bf16fXX_16x16x2_x86_64_avx512_bf16(
+      out_tile, lhs_panel, rhs_panel, K, flags, IREE_UK_TYPE_BFLOAT_16);
+}
@@ -0,0 +1,44 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/normalize_x86_64.h"
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+
+IREE_UK_NORMALIZE_ROW_FUNC_DECL(iree_uk_softmax_row_f32_x86_64_avx2_fma)
+IREE_UK_NORMALIZE_ROW_FUNC_DECL(iree_uk_softmax_row_f32_x86_64_avx512_base)
+IREE_UK_NORMALIZE_ROW_FUNC_DECL(iree_uk_layernorm_row_f32_x86_64_avx2_fma)
+IREE_UK_NORMALIZE_ROW_FUNC_DECL(iree_uk_layernorm_row_f32_x86_64_avx512_base)
+
+iree_uk_normalize_row_func_t iree_uk_softmax_select_row_func_x86_64(
+    const iree_uk_normalize_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return iree_uk_softmax_row_f32_x86_64_avx512_base;
+  }
+#endif
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return iree_uk_softmax_row_f32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
+
+iree_uk_normalize_row_func_t iree_uk_layernorm_select_row_func_x86_64(
+    const iree_uk_normalize_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return iree_uk_layernorm_row_f32_x86_64_avx512_base;
+  }
+#endif
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return iree_uk_layernorm_row_f32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
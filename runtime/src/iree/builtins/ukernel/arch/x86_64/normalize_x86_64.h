@@ -0,0 +1,20 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_NORMALIZE_X86_64_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_NORMALIZE_X86_64_H_
+
+#include "iree/builtins/ukernel/normalize.h"
+
+// Return the x86_64 row functions to use for softmax and layernorm with the
+// given params, or NULL if none is available, so the caller may fall back to
+// generic code.
+iree_uk_normalize_row_func_t iree_uk_softmax_select_row_func_x86_64(
+    const iree_uk_normalize_params_t* params);
+iree_uk_normalize_row_func_t iree_uk_layernorm_select_row_func_x86_64(
+    const iree_uk_normalize_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_NORMALIZE_X86_64_H_
@@ -0,0 +1,110 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/normalize_x86_64.h"
+
+// Returns the mask of the first |size| < 8 lanes, for the row remainders.
+static inline __m256i iree_uk_avx2_remainder_mask(iree_uk_ssize_t size) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((iree_uk_int32_t)size),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+void iree_uk_softmax_row_f32_x86_64_avx2_fma(void* out_row, const void* in_row,
+                                             iree_uk_ssize_t size,
+                                             float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)7;
+  __m256i rem_mask = iree_uk_avx2_remainder_mask(size - vec_size);
+  // Reduce the max. The remainder lanes are masked to -inf.
+  __m256 max8 = _mm256_set1_ps(-__builtin_inff());
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 8) {
+    max8 = _mm256_max_ps(max8, _mm256_loadu_ps(in_ptr + i));
+  }
+  if (vec_size < size) {
+    __m256 v = _mm256_blendv_ps(max8,
+                                _mm256_maskload_ps(in_ptr + vec_size, rem_mask),
+                                _mm256_castsi256_ps(rem_mask));
+    max8 = _mm256_max_ps(max8, v);
+  }
+  __m256 max = _mm256_set1_ps(iree_uk_avx2_reduce_max_f32x8(max8));
+  // Compute and store the exponentials, and reduce their sum.
+  __m256 sum8 = _mm256_setzero_ps();
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 8) {
+    __m256 e = iree_uk_avx2_exp_f32x8(
+        _mm256_sub_ps(_mm256_loadu_ps(in_ptr + i), max));
+    _mm256_storeu_ps(out_ptr + i, e);
+    sum8 = _mm256_add_ps(sum8, e);
+  }
+  if (vec_size < size) {
+    __m256 e = iree_uk_avx2_exp_f32x8(_mm256_sub_ps(
+        _mm256_maskload_ps(in_ptr + vec_size, rem_mask), max));
+    e = _mm256_and_ps(e, _mm256_castsi256_ps(rem_mask));
+    _mm256_maskstore_ps(out_ptr + vec_size, rem_mask, e);
+    sum8 = _mm256_add_ps(sum8, e);
+  }
+  // Rescale by the inverse of the sum.
+  __m256 inv_sum =
+      _mm256_set1_ps(1.f / iree_uk_avx2_reduce_add_f32x8(sum8));
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 8) {
+    _mm256_storeu_ps(out_ptr + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(out_ptr + i), inv_sum));
+  }
+  if (vec_size < size) {
+    __m256 v = _mm256_maskload_ps(out_ptr + vec_size, rem_mask);
+    _mm256_maskstore_ps(out_ptr + vec_size, rem_mask,
+                        _mm256_mul_ps(v, inv_sum));
+  }
+}
+
+// Same algorithm as iree_uk_layernorm_row_f32_generic: a single pass reducing
+// the sum and sum of squares of the values shifted by the first element, then
+// a pass writing the normalized values.
+void iree_uk_layernorm_row_f32_x86_64_avx2_fma(void* out_row,
+                                               const void* in_row,
+                                               iree_uk_ssize_t size,
+                                               float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)7;
+  __m256i rem_mask = iree_uk_avx2_remainder_mask(size - vec_size);
+  const float shift = in_ptr[0];
+  __m256 shift8 = _mm256_set1_ps(shift);
+  __m256 sum8 = _mm256_setzero_ps();
+  __m256 sum_sq8 = _mm256_setzero_ps();
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(in_ptr + i), shift8);
+    sum8 = _mm256_add_ps(sum8, d);
+    sum_sq8 = _mm256_fmadd_ps(d, d, sum_sq8);
+  }
+  if (vec_size < size) {
+    __m256 d = _mm256_sub_ps(_mm256_maskload_ps(in_ptr + vec_size, rem_mask),
+                             shift8);
+    d = _mm256_and_ps(d, _mm256_castsi256_ps(rem_mask));
+    sum8 = _mm256_add_ps(sum8, d);
+    sum_sq8 = _mm256_fmadd_ps(d, d, sum_sq8);
+  }
+  float inv_size = 1.f / (float)size;
+  float shifted_mean = iree_uk_avx2_reduce_add_f32x8(sum8) * inv_size;
+  float variance = iree_uk_avx2_reduce_add_f32x8(sum_sq8) * inv_size -
+                   shifted_mean * shifted_mean;
+  if (variance < 0.f) variance = 0.f;
+  __m256 mean = _mm256_set1_ps(shift + shifted_mean);
+  __m256 inv_stddev = _mm256_div_ps(
+      _mm256_set1_ps(1.f),
+      _mm256_sqrt_ps(_mm256_set1_ps(variance + epsilon)));
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 8) {
+    __m256 v = _mm256_sub_ps(_mm256_loadu_ps(in_ptr + i), mean);
+    _mm256_storeu_ps(out_ptr + i, _mm256_mul_ps(v, inv_stddev));
+  }
+  if (vec_size < size) {
+    __m256 v = _mm256_sub_ps(_mm256_maskload_ps(in_ptr + vec_size, rem_mask),
+                             mean);
+    _mm256_maskstore_ps(out_ptr + vec_size, rem_mask,
+                        _mm256_mul_ps(v, inv_stddev));
+  }
+}
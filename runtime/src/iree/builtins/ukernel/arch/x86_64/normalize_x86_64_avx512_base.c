@@ -0,0 +1,89 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/normalize_x86_64.h"
+
+void iree_uk_softmax_row_f32_x86_64_avx512_base(void* out_row,
+                                                const void* in_row,
+                                                iree_uk_ssize_t size,
+                                                float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)15;
+  __mmask16 rem_mask = (__mmask16)((1u << (size - vec_size)) - 1);
+  // Reduce the max.
+  __m512 max16 = _mm512_set1_ps(-__builtin_inff());
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 16) {
+    max16 = _mm512_max_ps(max16, _mm512_loadu_ps(in_ptr + i));
+  }
+  __m512 rem = _mm512_maskz_loadu_ps(rem_mask, in_ptr + vec_size);
+  max16 = _mm512_mask_max_ps(max16, rem_mask, max16, rem);
+  __m512 max = _mm512_set1_ps(_mm512_reduce_max_ps(max16));
+  // Compute and store the exponentials, and reduce their sum.
+  __m512 sum16 = _mm512_setzero_ps();
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 16) {
+    __m512 e = iree_uk_avx512_exp_f32x16(
+        _mm512_sub_ps(_mm512_loadu_ps(in_ptr + i), max));
+    _mm512_storeu_ps(out_ptr + i, e);
+    sum16 = _mm512_add_ps(sum16, e);
+  }
+  __m512 e = iree_uk_avx512_exp_f32x16(
+      _mm512_sub_ps(_mm512_maskz_loadu_ps(rem_mask, in_ptr + vec_size), max));
+  _mm512_mask_storeu_ps(out_ptr + vec_size, rem_mask, e);
+  sum16 = _mm512_mask_add_ps(sum16, rem_mask, sum16, e);
+  // Rescale by the inverse of the sum.
+  __m512 inv_sum = _mm512_set1_ps(1.f / _mm512_reduce_add_ps(sum16));
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 16) {
+    _mm512_storeu_ps(out_ptr + i,
+                     _mm512_mul_ps(_mm512_loadu_ps(out_ptr + i), inv_sum));
+  }
+  __m512 v = _mm512_maskz_loadu_ps(rem_mask, out_ptr + vec_size);
+  _mm512_mask_storeu_ps(out_ptr + vec_size, rem_mask,
+                        _mm512_mul_ps(v, inv_sum));
+}
+
+// Same algorithm as iree_uk_layernorm_row_f32_generic: a single pass reducing
+// the sum and sum of squares of the values shifted by the first element, then
+// a pass writing the normalized values.
+void iree_uk_layernorm_row_f32_x86_64_avx512_base(void* out_row,
+                                                  const void* in_row,
+                                                  iree_uk_ssize_t size,
+                                                  float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  iree_uk_ssize_t vec_size = size & ~(iree_uk_ssize_t)15;
+  __mmask16 rem_mask = (__mmask16)((1u << (size - vec_size)) - 1);
+  const float shift = in_ptr[0];
+  __m512 shift16 = _mm512_set1_ps(shift);
+  __m512 sum16 = _mm512_setzero_ps();
+  __m512 sum_sq16 = _mm512_setzero_ps();
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 16) {
+    __m512 d = _mm512_sub_ps(_mm512_loadu_ps(in_ptr + i), shift16);
+    sum16 = _mm512_add_ps(sum16, d);
+    sum_sq16 = _mm512_fmadd_ps(d, d, sum_sq16);
+  }
+  __m512 d = _mm512_maskz_sub_ps(
+      rem_mask, _mm512_maskz_loadu_ps(rem_mask, in_ptr + vec_size), shift16);
+  sum16 = _mm512_add_ps(sum16, d);
+  sum_sq16 = _mm512_fmadd_ps(d, d, sum_sq16);
+  float inv_size = 1.f / (float)size;
+  float shifted_mean = _mm512_reduce_add_ps(sum16) * inv_size;
+  float variance =
+      _mm512_reduce_add_ps(sum_sq16) * inv_size - shifted_mean * shifted_mean;
+  if (variance < 0.f) variance = 0.f;
+  __m512 mean = _mm512_set1_ps(shift + shifted_mean);
+  __m512 inv_stddev = _mm512_div_ps(
+      _mm512_set1_ps(1.f), _mm512_sqrt_ps(_mm512_set1_ps(variance + epsilon)));
+  for (iree_uk_ssize_t i = 0; i < vec_size; i += 16) {
+    __m512 v = _mm512_sub_ps(_mm512_loadu_ps(in_ptr + i), mean);
+    _mm512_storeu_ps(out_ptr + i, _mm512_mul_ps(v, inv_stddev));
+  }
+  __m512 v =
+      _mm512_sub_ps(_mm512_maskz_loadu_ps(rem_mask, in_ptr + vec_size), mean);
+  _mm512_mask_storeu_ps(out_ptr + vec_size, rem_mask,
+                        _mm512_mul_ps(v, inv_stddev));
+}
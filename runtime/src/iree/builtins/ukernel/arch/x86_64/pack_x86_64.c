@@ -9,8 +9,12 @@
 #include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
 
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nt)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nt)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(
@@ -23,12 +27,29 @@ IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_transpose)
 
+// Returns true if the output of the pack op with given params should be written
+// with non-temporal stores of |align| bytes: it has to be large enough not to
+// fit in the last-level cache, and every output tile has to be aligned.
+static bool iree_uk_pack_x86_64_use_nontemporal_stores(
+    const iree_uk_pack_params_t* params, int align) {
+  iree_uk_ssize_t esize =
+      iree_uk_type_size(iree_uk_pack_out_type(params->type));
+  iree_uk_ssize_t out_bytes = params->out_size0 * params->out_stride0 * esize;
+  iree_uk_ssize_t tile_bytes = params->out_size2 * params->out_size3 * esize;
+  return out_bytes >= iree_uk_pack_x86_64_nontemporal_min_bytes &&
+         (iree_uk_uint64_t)params->out_buffer % align == 0 &&
+         (params->out_stride0 * esize) % align == 0 && tile_bytes % align == 0;
+}
+
 static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_8x8_x32(
     const iree_uk_pack_params_t* params) {
 #ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
   if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
+    if (transpose) return 0;
+    return iree_uk_pack_x86_64_use_nontemporal_stores(params, 32)
+               ? iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nt
+               : iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
   }
 #endif
   return 0;
@@ -39,8 +60,10 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x16_x32(
 #ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
   if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0
-                     : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
+    if (transpose) return 0;
+    return iree_uk_pack_x86_64_use_nontemporal_stores(params, 64)
+               ? iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nt
+               : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
   }
 #endif
   return 0;
@@ -9,6 +9,19 @@
 
 #include "iree/builtins/ukernel/pack.h"
 
+// Tuning parameters for the x86_64 pack tile functions moving whole rows of
+// 32-bit elements (8x8 and 16x16 tiles).
+enum {
+  // Number of tiles ahead of the current one whose input rows get prefetched.
+  // Input rows are typically far apart (in_stride0 is a whole matrix row), so
+  // the hardware prefetcher tracks them poorly.
+  iree_uk_pack_x86_64_prefetch_tiles = 4,
+  // Outputs of at least that many bytes are larger than the last-level cache
+  // of most x86_64 CPUs, so they get written with non-temporal stores, which
+  // avoid reading the output lines first and evicting the input.
+  iree_uk_pack_x86_64_nontemporal_min_bytes = 32 << 20,
+};
+
 // Returns the x86_64 tile function to use for the pack op with given params, or
 // NULL if no suitable x86_64 tile function exists for these params, in which
 // case the caller may fall back to a generic tile function.
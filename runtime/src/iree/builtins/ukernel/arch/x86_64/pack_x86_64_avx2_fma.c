@@ -5,8 +5,41 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/pack_x86_64.h"
 #include "iree/builtins/ukernel/arch/x86_64/unpack_x86_64.h"
 
+static inline void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    bool nontemporal) {
+  const int prefetch_tiles = iree_uk_pack_x86_64_prefetch_tiles;
+  for (; outer_size1 > 0; --outer_size1) {
+    // Each input row of a tile is 32 bytes, so prefetching every other tile
+    // is enough to cover every cache line.
+    if (outer_size1 > prefetch_tiles && !(outer_size1 & 1)) {
+      for (int i = 0; i < 8; ++i) {
+        IREE_UK_PREFETCH_RO(in_ptr + 32 * prefetch_tiles + i * 4 * in_stride0,
+                            3);
+      }
+    }
+    if (nontemporal) {
+      for (int i = 0; i < 8; ++i) {
+        _mm256_stream_si256(
+            (__m256i*)(out_ptr + 32 * i),
+            _mm256_loadu_si256((const __m256i*)(in_ptr + i * 4 * in_stride0)));
+      }
+    } else {
+      iree_uk_copy_8x32xi8_strided_to_strided(out_ptr, in_ptr, 32,
+                                              4 * in_stride0);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+  // Order the non-temporal stores before any subsequent stores.
+  if (nontemporal) _mm_sfence();
+}
+
 void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
@@ -16,14 +49,25 @@ void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
   IREE_UK_ASSERT(elem_size == 4);
   IREE_UK_ASSERT(tile_size0 == 8);
   IREE_UK_ASSERT(tile_size1 == 8);
-  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
-  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
-  for (; outer_size1 > 0; --outer_size1) {
-    iree_uk_copy_8x32xi8_strided_to_strided(out_ptr, in_ptr, 32,
-                                            4 * in_stride0);
-    out_ptr += 4 * out_stride1;
-    in_ptr += 32;
-  }
+  iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma(out_tile_ptr, in_tile_ptr,
+                                            outer_size1, out_stride1,
+                                            in_stride0, false);
+}
+
+// Same as above but with non-temporal stores. Requires 32-byte aligned output
+// tiles.
+void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nt(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma(out_tile_ptr, in_tile_ptr,
+                                            outer_size1, out_stride1,
+                                            in_stride0, true);
 }
 
 static void iree_uk_pack_tile_8x4_x8_x86_64_avx2_fma_direct(
@@ -5,8 +5,39 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/pack_x86_64.h"
 #include "iree/builtins/ukernel/arch/x86_64/unpack_x86_64.h"
 
+static inline void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    bool nontemporal) {
+  const int prefetch_tiles = iree_uk_pack_x86_64_prefetch_tiles;
+  for (; outer_size1 > 0; --outer_size1) {
+    if (outer_size1 > prefetch_tiles) {
+      for (int i = 0; i < 16; ++i) {
+        IREE_UK_PREFETCH_RO(in_ptr + 64 * prefetch_tiles + i * 4 * in_stride0,
+                            3);
+      }
+    }
+    if (nontemporal) {
+      for (int i = 0; i < 16; ++i) {
+        _mm512_stream_si512(
+            (__m512i*)(out_ptr + 64 * i),
+            _mm512_loadu_si512((const __m512i*)(in_ptr + i * 4 * in_stride0)));
+      }
+    } else {
+      iree_uk_copy_16x64xi8_strided_to_strided(out_ptr, in_ptr, 64,
+                                               4 * in_stride0);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 64;
+  }
+  // Order the non-temporal stores before any subsequent stores.
+  if (nontemporal) _mm_sfence();
+}
+
 void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
@@ -16,14 +47,23 @@ void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
   IREE_UK_ASSERT(elem_size == 4);
   IREE_UK_ASSERT(tile_size0 == 16);
   IREE_UK_ASSERT(tile_size1 == 16);
-  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
-  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
-  for (; outer_size1 > 0; --outer_size1) {
-    iree_uk_copy_16x64xi8_strided_to_strided(out_ptr, in_ptr, 64,
-                                             4 * in_stride0);
-    out_ptr += 4 * out_stride1;
-    in_ptr += 64;
-  }
+  iree_uk_pack_tile_16x16_x32_x86_64_avx512_base(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, false);
+}
+
+// Same as above but with non-temporal stores. Requires 64-byte aligned output
+// tiles.
+void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nt(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_ssize_t outer_size1,
+    iree_uk_ssize_t out_stride1, iree_uk_ssize_t in_stride0,
+    iree_uk_ssize_t elem_size, iree_uk_ssize_t tile_size0,
+    iree_uk_ssize_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  iree_uk_pack_tile_16x16_x32_x86_64_avx512_base(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, true);
 }
 
 static void iree_uk_pack_tile_16x4_x8_x86_64_avx512_base_direct(
@@ -28,6 +28,11 @@ iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AMX
+  if (iree_uk_cpu_supports_amx_int8(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 4, .N = 16};
+  }
+#endif
 #ifdef IREE_UK_BUILD_X86_64_AVX512_VNNI
   if (iree_uk_cpu_supports_avx512_vnni(params->cpu_data)) {
     return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
@@ -42,9 +47,134 @@ iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 4};
 }
 
+static iree_uk_matmul_tile_sizes_t
+iree_uk_query_matmul_tile_sizes_x86_64_f16f16(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 1, .N = 16};
+  }
+#endif
+  // No optimized kernel yet, use the same tile sizes as f32.
+  return iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(params);
+}
+
+static iree_uk_matmul_tile_sizes_t
+iree_uk_query_matmul_tile_sizes_x86_64_bf16bf16(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+  // Note: 16x2x16 is also the AMX-BF16 tile shape, see
+  // iree_uk_mmt4d_early_x86_64.
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BF16
+  if (iree_uk_cpu_supports_avx512_bf16(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+  }
+#endif
+  // No optimized kernel yet, use the same tile sizes as f32.
+  return iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(params);
+}
+
+static iree_uk_matmul_tile_sizes_t
+iree_uk_query_matmul_tile_sizes_x86_64_i8i4i32(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+  }
+#endif
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 8};
+  }
+#endif
+  // SSE2 fallback.
+  return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 4};
+}
+
+// Feature-set predicates for the CPU_FEATURES column of tuned_tile_sizes.inl.
+// Unlike iree_uk_cpu_supports_*, these also check that the code was built.
+static inline bool iree_uk_tuned_cpu_supports_baseline(
+    const iree_uk_uint64_t* cpu_data) {
+  return true;
+}
+
+static inline bool iree_uk_tuned_cpu_supports_avx2_fma(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AVX2_FMA
+  return iree_uk_cpu_supports_avx2_fma(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_avx512_base(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BASE
+  return iree_uk_cpu_supports_avx512_base(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_avx512_vnni(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_VNNI
+  return iree_uk_cpu_supports_avx512_vnni(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_avx512_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AVX512_BF16
+  return iree_uk_cpu_supports_avx512_bf16(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_amx_int8(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AMX
+  return iree_uk_cpu_supports_amx_int8(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static inline bool iree_uk_tuned_cpu_supports_amx_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+#ifdef IREE_UK_BUILD_X86_64_AMX
+  return iree_uk_cpu_supports_amx_bf16(cpu_data);
+#else
+  return false;
+#endif
+}
+
+static const iree_uk_matmul_tuned_tile_sizes_t
+    iree_uk_matmul_tuned_tile_sizes_x86_64[] = {
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)
+#define IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64(CPU_MODEL, LLVM_CPU, OPERATION, \
+                                               CPU_FEATURES, M_, K_, N_)       \
+  {CPU_MODEL, IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_##OPERATION,             \
+   iree_uk_tuned_cpu_supports_##CPU_FEATURES,                                  \
+   {.M = M_, .K = K_, .N = N_}},
+#include "iree/builtins/ukernel/tuned_tile_sizes.inl"
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_X86_64
+#undef IREE_UK_TUNED_MATMUL_TILE_SIZES_ARM_64
+        // Terminator.
+        {0},
+};
+
 bool iree_uk_query_matmul_tile_sizes_x86_64(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+  if (iree_uk_query_matmul_tuned_tile_sizes(
+          params, iree_uk_matmul_tuned_tile_sizes_x86_64,
+          out_matmul_tile_sizes)) {
+    return true;
+  }
   iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
   if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32) {
     *out_matmul_tile_sizes =
@@ -54,6 +184,27 @@ bool iree_uk_query_matmul_tile_sizes_x86_64(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32) {
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_x86_64_i8i4i32(params);
+    return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32U4F32) {
+    // Same kernel shapes as f32, see
+    // iree_uk_mmt4d_select_quantized_tile_func_x86_64.
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(params);
+    return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32 ||
+             op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16) {
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_x86_64_f16f16(params);
+    return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 ||
+             op ==
+                 IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16) {
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_x86_64_bf16bf16(params);
+    return true;
   } else {
     // Can't happen, validated earlier.
     IREE_UK_ASSUME_UNREACHABLE;
@@ -103,6 +103,10 @@
 // defined.
 #if defined(IREE_UK_ARCH_ARM_64)
 #include "iree/builtins/ukernel/arch/arm_64/config.h"
+#elif defined(IREE_UK_ARCH_RISCV_64)
+#include "iree/builtins/ukernel/arch/riscv_64/config.h"
+#elif defined(IREE_UK_ARCH_WASM_32)
+#include "iree/builtins/ukernel/arch/wasm_32/config.h"
 #elif defined(IREE_UK_ARCH_X86_64)
 #include "iree/builtins/ukernel/arch/x86_64/config.h"
 #endif
@@ -222,6 +226,16 @@ extern "C" {
 #define IREE_UK_UNLIKELY(x) (x)
 #endif  // IREE_HAVE_ATTRIBUTE(likely)
 
+// Prefetches the cache line containing |ptr| for reading. |locality| is 0..3,
+// from "no temporal locality" to "keep in all cache levels", as in
+// __builtin_prefetch. This is only a hint and may be a no-op.
+#if IREE_UK_HAVE_BUILTIN(__builtin_prefetch) || defined(__GNUC__)
+#define IREE_UK_PREFETCH_RO(ptr, locality) \
+  __builtin_prefetch((ptr), /*rw=*/0, (locality))
+#else
+#define IREE_UK_PREFETCH_RO(ptr, locality)
+#endif
+
 #if IREE_UK_HAVE_ATTRIBUTE(aligned) || \
     (defined(__GNUC__) && !defined(__clang__))
 #define IREE_UK_ATTRIBUTE_ALIGNED(N) __attribute__((aligned(N)))
@@ -444,6 +458,7 @@ enum {
   IREE_UK_TYPE_OPAQUE_16 = IREE_UK_TYPE_CATEGORY_OPAQUE | 4,
   IREE_UK_TYPE_OPAQUE_32 = IREE_UK_TYPE_CATEGORY_OPAQUE | 5,
   IREE_UK_TYPE_OPAQUE_64 = IREE_UK_TYPE_CATEGORY_OPAQUE | 6,
+  IREE_UK_TYPE_INT_4 = IREE_UK_TYPE_CATEGORY_INTEGER | 2,
   IREE_UK_TYPE_INT_8 = IREE_UK_TYPE_CATEGORY_INTEGER | 3,
   IREE_UK_TYPE_INT_16 = IREE_UK_TYPE_CATEGORY_INTEGER | 4,
   IREE_UK_TYPE_INT_32 = IREE_UK_TYPE_CATEGORY_INTEGER | 5,
@@ -452,6 +467,7 @@ enum {
   IREE_UK_TYPE_SINT_16 = IREE_UK_TYPE_CATEGORY_INTEGER_SIGNED | 4,
   IREE_UK_TYPE_SINT_32 = IREE_UK_TYPE_CATEGORY_INTEGER_SIGNED | 5,
   IREE_UK_TYPE_SINT_64 = IREE_UK_TYPE_CATEGORY_INTEGER_SIGNED | 6,
+  IREE_UK_TYPE_UINT_4 = IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED | 2,
   IREE_UK_TYPE_UINT_8 = IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED | 3,
   IREE_UK_TYPE_UINT_16 = IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED | 4,
   IREE_UK_TYPE_UINT_32 = IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED | 5,
@@ -491,6 +507,22 @@ static inline int iree_uk_type_size(iree_uk_type_t t) {
   return 1 << iree_uk_type_size_log2(t);
 }
 
+// Returns the number of bytes taken by |bits| bits, which must be a whole
+// number of bytes. This is how to compute buffer sizes and offsets for sub-byte
+// types (such as 4-bit integers), for which iree_uk_type_size is undefined.
+static inline iree_uk_ssize_t iree_uk_bits_to_bytes_exact(
+    iree_uk_ssize_t bits) {
+  IREE_UK_ASSERT(!(bits & 7));
+  return bits >> 3;
+}
+
+// Returns the number of bytes taken by |count| elements of type |t|, which may
+// be a sub-byte type as long as that is a whole number of bytes.
+static inline iree_uk_ssize_t iree_uk_type_size_of_count(
+    iree_uk_type_t t, iree_uk_ssize_t count) {
+  return iree_uk_bits_to_bytes_exact(count << iree_uk_type_bit_count_log2(t));
+}
+
 //===----------------------------------------------------------------------===//
 // Tuples of types, packed ("tied") into a word.
 //===----------------------------------------------------------------------===//
@@ -601,6 +633,125 @@ static inline int iree_uk_ceil_log2_u32(const iree_uk_uint32_t n) {
   return n <= 1 ? 0 : (1 + iree_uk_floor_log2_u32(n - 1));
 }
 
+//===----------------------------------------------------------------------===//
+// 16-bit floating-point conversions
+//===----------------------------------------------------------------------===//
+
+// Half-precision (f16) and bfloat16 (bf16) values are stored as raw
+// iree_uk_uint16_t bits, as there is no portable C type for them. These
+// conversions are exact in the f32 direction and round-to-nearest-even in the
+// narrowing direction so that generic code computes bit-identical results to
+// the hardware conversion instructions used by architecture-specific code.
+
+static inline float iree_uk_f32_from_bits(iree_uk_uint32_t u) {
+  float f;
+  iree_uk_memcpy(&f, &u, sizeof f);
+  return f;
+}
+
+static inline iree_uk_uint32_t iree_uk_f32_to_bits(float f) {
+  iree_uk_uint32_t u;
+  iree_uk_memcpy(&u, &f, sizeof u);
+  return u;
+}
+
+static inline float iree_uk_f16_to_f32(iree_uk_uint16_t h) {
+  const iree_uk_uint32_t sign = (iree_uk_uint32_t)(h & 0x8000u) << 16;
+  const iree_uk_uint32_t exp = (h >> 10) & 0x1Fu;
+  iree_uk_uint32_t mantissa = h & 0x3FFu;
+  if (exp == 0x1Fu) {
+    // Inf or NaN.
+    return iree_uk_f32_from_bits(sign | 0x7F800000u | (mantissa << 13));
+  }
+  if (exp == 0) {
+    if (mantissa == 0) return iree_uk_f32_from_bits(sign);
+    // Subnormal: renormalize the mantissa so that its leading bit is implicit.
+    int shift = iree_uk_count_leading_zeros_u32(mantissa) - 21;
+    mantissa = (mantissa << shift) & 0x3FFu;
+    return iree_uk_f32_from_bits(sign | ((113u - shift) << 23) |
+                                 (mantissa << 13));
+  }
+  return iree_uk_f32_from_bits(sign | ((exp + 112u) << 23) | (mantissa << 13));
+}
+
+static inline iree_uk_uint16_t iree_uk_f32_to_f16(float f) {
+  iree_uk_uint32_t u = iree_uk_f32_to_bits(f);
+  const iree_uk_uint16_t sign = (u >> 16) & 0x8000u;
+  u &= 0x7FFFFFFFu;
+  if (u >= 0x7F800000u) {
+    // Inf or NaN. NaNs are kept quiet.
+    return sign | 0x7C00u | (u > 0x7F800000u ? 0x200u : 0);
+  }
+  if (u >= 0x477FF000u) {
+    // Rounds to a magnitude above the largest finite f16 value.
+    return sign | 0x7C00u;
+  }
+  iree_uk_uint32_t result;
+  iree_uk_uint32_t remainder;
+  iree_uk_uint32_t half;
+  if (u < 0x38800000u) {
+    // Result is subnormal or zero.
+    const int exp = u >> 23;
+    if (exp < 102) return sign;
+    iree_uk_uint32_t mantissa = (u & 0x7FFFFFu) | 0x800000u;
+    int shift = 126 - exp;
+    result = mantissa >> shift;
+    remainder = mantissa & ((1u << shift) - 1);
+    half = 1u << (shift - 1);
+  } else {
+    // Normal result. A carry out of the mantissa correctly bumps the exponent.
+    result = (u >> 13) - (112u << 10);
+    remainder = u & 0x1FFFu;
+    half = 0x1000u;
+  }
+  if (remainder > half || (remainder == half && (result & 1))) ++result;
+  return sign | result;
+}
+
+static inline float iree_uk_bf16_to_f32(iree_uk_uint16_t b) {
+  return iree_uk_f32_from_bits((iree_uk_uint32_t)b << 16);
+}
+
+static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float f) {
+  iree_uk_uint32_t u = iree_uk_f32_to_bits(f);
+  if ((u & 0x7FFFFFFFu) > 0x7F800000u) {
+    // NaN. Truncating could turn it into Inf, so keep it quiet instead.
+    return (u >> 16) | 0x40u;
+  }
+  return (u + 0x7FFFu + ((u >> 16) & 1)) >> 16;
+}
+
+//===----------------------------------------------------------------------===//
+// 4-bit integer access
+//===----------------------------------------------------------------------===//
+
+// Buffers of 4-bit integers are nibble-packed: element 2*i is the low nibble
+// of byte i and element 2*i+1 is its high nibble.
+
+// Returns the 4-bit element |i| of |buf|, zero-extended.
+static inline iree_uk_uint8_t iree_uk_load_nibble(const void* buf,
+                                                  iree_uk_ssize_t i) {
+  iree_uk_uint8_t byte = ((const iree_uk_uint8_t*)buf)[i >> 1];
+  return (i & 1) ? (byte >> 4) : (byte & 0xF);
+}
+
+// Stores the low 4 bits of |val| to the 4-bit element |i| of |buf|, preserving
+// the other nibble of the same byte.
+static inline void iree_uk_store_nibble(void* buf, iree_uk_ssize_t i,
+                                        iree_uk_uint8_t val) {
+  iree_uk_uint8_t* byte = (iree_uk_uint8_t*)buf + (i >> 1);
+  if (i & 1) {
+    *byte = (*byte & 0x0F) | (val << 4);
+  } else {
+    *byte = (*byte & 0xF0) | (val & 0x0F);
+  }
+}
+
+// Sign-extends a 4-bit two's complement value given in the low 4 bits of |val|.
+static inline iree_uk_int32_t iree_uk_sign_extend_nibble(iree_uk_uint8_t val) {
+  return (iree_uk_int32_t)((val & 0xF) ^ 8) - 8;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
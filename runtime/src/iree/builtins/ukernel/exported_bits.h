@@ -43,6 +43,35 @@
 #define IREE_UK_FLAG_ACCUMULATE_BIT_POS 0
 IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_ACCUMULATE);
 
+// `mmt4d` ukernel-specific bits (bits 16..31).
+// EPILOGUE_* bits request an epilogue applied to each output tile right after
+// it has been accumulated, in this order: bias-add, activation, requantize.
+// EPILOGUE_BIAS adds the per-column iree_uk_mmt4d_params_t::bias_buffer.
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS 0x10000u
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS_BIT_POS 16
+IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS);
+// EPILOGUE_REQUANTIZE rounds i32 accumulators to i8 outputs, see
+// iree_uk_mmt4d_params_t::requantize_scale.
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE 0x20000u
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE_BIT_POS 17
+IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE);
+// EPILOGUE_ACTIVATION (bits 18..19) is an enum selecting the activation.
+// Note: the _INTERNAL suffix conveys that the _MASK value should only be used
+// by microkernels decoding flags, not by the compiler setting flags. Masks may
+// have to change even if flag values don't.
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL 0xc0000u
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_NONE 0x00000u
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU 0x40000u
+// Tanh approximation of GELU. Only for floating-point accumulators.
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU 0x80000u
+// Union of all the EPILOGUE_* bits.
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL 0xf0000u
+// SKIP_ZERO_RHS_TILES skips the K0xN0 RHS tiles whose bits are all zero, for
+// block-sparse RHS matrices. Only for 32-bit accumulators stored as such.
+#define IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES 0x100000u
+#define IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES_BIT_POS 20
+IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES);
+
 // `pack` ukernel-specific bits (bits 16..31).
 #define IREE_UK_FLAG_PACK_TRANSPOSE_INNER 0x10000u
 #define IREE_UK_FLAG_PACK_TRANSPOSE_INNER_BIT_POS 16
@@ -70,7 +99,7 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER);
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERAND_ROLE_RHS 0x10000u
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERAND_ROLE_RESULT 0x20000u
 // OPERATION (bits 20..31, though may be shrunk as needed as this is currently
-// only using bit 20 and will only grow as needed) describes the operation
+// only using bits 20..22 and will only grow as needed) describes the operation
 // owning the tensor (that we are doing a query_tile_sizes for) as an operand.
 // Note: the _INTERNAL suffix conveys that the _MASK value should only be used
 // by microkernels decoding flags, not by the compiler setting flags. Masks may
@@ -78,5 +107,11 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER);
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MASK_INTERNAL 0xfff00000u
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32 0x000000u
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32 0x100000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32 0x200000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16 0x300000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 0x400000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16 0x500000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32 0x600000u
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32U4F32 0x700000u
 
 #endif  // IREE_BUILTINS_UKERNEL_EXPORTED_BITS_H_
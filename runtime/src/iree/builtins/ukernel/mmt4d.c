@@ -8,13 +8,26 @@
 
 #include "iree/builtins/ukernel/mmt4d_tile.h"
 
+#if defined(IREE_UK_ARCH_X86_64)
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64.h"
+#endif
+
 #define OUTSIDE_UINT_RANGE(value, bits) (((value) < 0) || ((value) >> (bits)))
 
 static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
 #ifdef IREE_UK_ENABLE_ASSERTS
-  IREE_UK_ASSERT(!(params->flags & ~IREE_UK_FLAG_ACCUMULATE));
+  const iree_uk_uint32_t allowed_flags =
+      IREE_UK_FLAG_ACCUMULATE | IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL |
+      IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES;
+  IREE_UK_ASSERT(!(params->flags & ~allowed_flags));
   IREE_UK_ASSERT(params->type == iree_uk_mmt4d_type_f32f32f32 ||
-                 params->type == iree_uk_mmt4d_type_i8i8i32);
+                 params->type == iree_uk_mmt4d_type_i8i8i32 ||
+                 params->type == iree_uk_mmt4d_type_f16f16f32 ||
+                 params->type == iree_uk_mmt4d_type_f16f16f16 ||
+                 params->type == iree_uk_mmt4d_type_bf16bf16f32 ||
+                 params->type == iree_uk_mmt4d_type_bf16bf16bf16 ||
+                 params->type == iree_uk_mmt4d_type_i8i4i32 ||
+                 params->type == iree_uk_mmt4d_type_f32u4f32);
   // Some implementations may wish to avoid supporting absurdly wide types. For
   // instance, K is the innermost (i.e. hottest) loop bound, so some 32bit
   // targets may benefit from K being int32, not int64. We still let K be of
@@ -28,12 +41,99 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
   IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N0, 15));
   IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K0, 15));
   // Ensure iree_uk_mmt4d_tile_generic_max_bytes large enough for this tile.
-  IREE_UK_ASSERT(params->M0 * params->N0 *
-                     iree_uk_type_size(iree_uk_mmt4d_out_type(params->type)) <=
+  // 16-bit floating-point output types are accumulated in f32.
+  int acc_type_size = iree_uk_type_size(iree_uk_mmt4d_out_type(params->type));
+  if (acc_type_size < 4) acc_type_size = 4;
+  IREE_UK_ASSERT(params->M0 * params->N0 * acc_type_size <=
                  iree_uk_mmt4d_tile_generic_max_bytes);
+  // Sub-byte RHS types need each RHS tile to be a whole number of bytes.
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  iree_uk_ssize_t rhs_tile_bits = (params->N0 * params->K0)
+                                  << iree_uk_type_bit_count_log2(rhs_type);
+  IREE_UK_ASSERT(!(rhs_tile_bits & 7));
+  if (iree_uk_mmt4d_rhs_is_quantized(params->type)) {
+    IREE_UK_ASSERT(params->rhs_scales_buffer);
+    IREE_UK_ASSERT(params->rhs_zero_points_buffer);
+    IREE_UK_ASSERT(params->rhs_group_size > 0);
+  }
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL) {
+    // Epilogues are only implemented on 32-bit accumulators stored as such.
+    iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
+    IREE_UK_ASSERT(out_type == IREE_UK_TYPE_FLOAT_32 ||
+                   out_type == IREE_UK_TYPE_INT_32);
+    IREE_UK_ASSERT(!iree_uk_mmt4d_rhs_is_quantized(params->type));
+    iree_uk_uint32_t activation =
+        params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL;
+    IREE_UK_ASSERT(activation !=
+                   IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL);
+    if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU) {
+      IREE_UK_ASSERT(out_type == IREE_UK_TYPE_FLOAT_32);
+    }
+    if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS) {
+      IREE_UK_ASSERT(params->bias_buffer);
+    }
+    if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE) {
+      // The i8 output can't be accumulated into.
+      IREE_UK_ASSERT(params->type == iree_uk_mmt4d_type_i8i8i32);
+      IREE_UK_ASSERT(!(params->flags & IREE_UK_FLAG_ACCUMULATE));
+      IREE_UK_ASSERT(params->requantize_zero_point >= -128 &&
+                     params->requantize_zero_point <= 127);
+    }
+  }
+  if (params->flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES) {
+    // Accumulating runs of tiles separately must not round the accumulators.
+    iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
+    IREE_UK_ASSERT(out_type == IREE_UK_TYPE_FLOAT_32 ||
+                   out_type == IREE_UK_TYPE_INT_32);
+    IREE_UK_ASSERT(!iree_uk_mmt4d_rhs_is_quantized(params->type));
+  }
 #endif  // IREE_UK_ENABLE_ASSERTS
 }
 
+// Returns true if the |size| bytes at |ptr| are all zero.
+static bool iree_uk_mmt4d_is_zero(const char* ptr, iree_uk_ssize_t size) {
+  for (iree_uk_ssize_t i = 0; i < size; ++i) {
+    if (ptr[i]) return false;
+  }
+  return true;
+}
+
+// Same as calling tile_func on the whole K dimension, but skipping the K0xN0
+// RHS tiles that are all zeros: tile_func is called on each run of consecutive
+// nonzero RHS tiles instead. Skipping saves M0 multiply-adds per RHS element
+// at the cost of reading the RHS panel once more, so this only pays off for
+// block-sparse RHS matrices. |out_tile_size| is the size in bytes of the
+// accumulator tile, which is zeroed if all RHS tiles are zero.
+static void iree_uk_mmt4d_tile_skipping_zero_rhs_tiles(
+    iree_uk_mmt4d_tile_func_t tile_func, void* out_tile, const char* lhs_panel,
+    const char* rhs_panel, iree_uk_int32_t K, iree_uk_uint32_t flags,
+    iree_uk_ssize_t out_tile_size, const iree_uk_mmt4d_params_t* params) {
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params->type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  const iree_uk_ssize_t lhs_tile_size =
+      iree_uk_type_size_of_count(lhs_type, params->M0 * params->K0);
+  const iree_uk_ssize_t rhs_tile_size =
+      iree_uk_type_size_of_count(rhs_type, params->N0 * params->K0);
+  iree_uk_int32_t k = 0;
+  while (k < K) {
+    while (k < K &&
+           iree_uk_mmt4d_is_zero(rhs_panel + k * rhs_tile_size, rhs_tile_size))
+      ++k;
+    iree_uk_int32_t run_begin = k;
+    while (k < K &&
+           !iree_uk_mmt4d_is_zero(rhs_panel + k * rhs_tile_size, rhs_tile_size))
+      ++k;
+    if (k == run_begin) break;
+    tile_func(out_tile, lhs_panel + run_begin * lhs_tile_size,
+              rhs_panel + run_begin * rhs_tile_size, k - run_begin, flags,
+              params);
+    flags |= IREE_UK_FLAG_ACCUMULATE;
+  }
+  if (!(flags & IREE_UK_FLAG_ACCUMULATE)) {
+    iree_uk_memset(out_tile, 0, out_tile_size);
+  }
+}
+
 // General mmt4d implementation, shared among all cases. The idea is that the
 // only really performance-critical part is the inner-most loop, and that's
 // handled by the tile_func passed as argument here. Sharing the outer loops
@@ -50,21 +150,222 @@ static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
   const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
   const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
   const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
-  const iree_uk_int16_t rhs_elem_size_log2 = iree_uk_type_size_log2(rhs_type);
   const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
   char* out_tile_row = params->out_buffer;
   const char* lhs_panel = params->lhs_buffer;
   iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
   iree_uk_ssize_t lhs_panel_stride = params->lhs_stride << lhs_elem_size_log2;
-  iree_uk_ssize_t rhs_panel_stride = params->rhs_stride << rhs_elem_size_log2;
+  // The RHS may be a sub-byte type.
+  iree_uk_ssize_t rhs_panel_stride =
+      iree_uk_type_size_of_count(rhs_type, params->rhs_stride);
+  iree_uk_ssize_t out_stride = params->out_stride << out_elem_size_log2;
+  const bool skip_zero_rhs_tiles =
+      params->flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES;
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = params->rhs_buffer;
+    for (iree_uk_int32_t j = 0; j < N; ++j) {
+      if (skip_zero_rhs_tiles) {
+        iree_uk_mmt4d_tile_skipping_zero_rhs_tiles(
+            tile_func, out_tile, lhs_panel, rhs_panel, K, params->flags,
+            out_tile_size, params);
+      } else {
+        tile_func(out_tile, lhs_panel, rhs_panel, K, params->flags, params);
+      }
+      out_tile += out_tile_size;
+      rhs_panel += rhs_panel_stride;
+    }
+    out_tile_row += out_stride;
+    lhs_panel += lhs_panel_stride;
+  }
+}
+
+// Same as iree_uk_mmt4d_using_tile_func, for types with a quantized RHS. The
+// only difference is that the quantized_tile_func also gets the scales and
+// zero-points for the current RHS panel.
+static void iree_uk_mmt4d_using_quantized_tile_func(
+    const iree_uk_mmt4d_params_t* params,
+    iree_uk_mmt4d_quantized_tile_func_t tile_func) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_int32_t group_size = params->rhs_group_size;
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params->type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  char* out_tile_row = params->out_buffer;
+  const char* lhs_panel = params->lhs_buffer;
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_ssize_t lhs_panel_stride = params->lhs_stride << lhs_elem_size_log2;
+  iree_uk_ssize_t rhs_panel_stride =
+      iree_uk_type_size_of_count(rhs_type, params->rhs_stride);
+  iree_uk_ssize_t out_stride = params->out_stride << out_elem_size_log2;
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = params->rhs_buffer;
+    const float* rhs_scales = params->rhs_scales_buffer;
+    const float* rhs_zero_points = params->rhs_zero_points_buffer;
+    for (iree_uk_int32_t j = 0; j < N; ++j) {
+      tile_func(out_tile, lhs_panel, rhs_panel, rhs_scales, rhs_zero_points, K,
+                group_size, params->flags, params);
+      out_tile += out_tile_size;
+      rhs_panel += rhs_panel_stride;
+      rhs_scales += params->rhs_scales_stride;
+      rhs_zero_points += params->rhs_scales_stride;
+    }
+    out_tile_row += out_stride;
+    lhs_panel += lhs_panel_stride;
+  }
+}
+
+// Rational approximation of tanh, so that the GELU epilogue does not depend on
+// libm. Outside of the clamping interval, tanh rounds to +/-1 in f32.
+static float iree_uk_mmt4d_tanh_f32(float x) {
+  const float clamp = 7.90531110763549805f;
+  if (x > clamp) x = clamp;
+  if (x < -clamp) x = -clamp;
+  float x2 = x * x;
+  float p = -2.76076847742355e-16f;
+  p = p * x2 + 2.00018790482477e-13f;
+  p = p * x2 - 8.60467152213735e-11f;
+  p = p * x2 + 5.12229709037114e-08f;
+  p = p * x2 + 1.48572235717979e-05f;
+  p = p * x2 + 6.37261928875436e-04f;
+  p = p * x2 + 4.89352455891786e-03f;
+  float q = 1.19825839466702e-06f;
+  q = q * x2 + 1.18534705686654e-04f;
+  q = q * x2 + 2.26843463243900e-03f;
+  q = q * x2 + 4.89352518554385e-03f;
+  return x * p / q;
+}
+
+// Tanh approximation of GELU:
+//   0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+static float iree_uk_mmt4d_gelu_f32(float x) {
+  float inner = 0.797884560802865f * (x + 0.044715f * x * x * x);
+  return 0.5f * x * (1.f + iree_uk_mmt4d_tanh_f32(inner));
+}
+
+static iree_uk_int8_t iree_uk_mmt4d_requantize_i32_to_i8(
+    iree_uk_int32_t v, float scale, iree_uk_int32_t zero_point) {
+  float x = (float)v * scale;
+  // Beyond +/-512 the result saturates anyway, as |zero_point| <= 128. Within
+  // that range, adding and subtracting 1.5 * 2^23 rounds to nearest-even.
+  if (x > 512.f) x = 512.f;
+  if (x < -512.f) x = -512.f;
+  const float magic = 12582912.f;
+  iree_uk_int32_t r = (iree_uk_int32_t)((x + magic) - magic) + zero_point;
+  if (r > 127) r = 127;
+  if (r < -128) r = -128;
+  return (iree_uk_int8_t)r;
+}
+
+// Applies the epilogue requested by params->flags to the M0xN0 accumulator
+// tile |acc_tile|, in place, or into the i8 |out_tile| when requantizing.
+// |bias| points to the N0 bias values of the current column of tiles, if any.
+static void iree_uk_mmt4d_epilogue_tile(void* acc_tile, void* out_tile,
+                                        const void* bias,
+                                        const iree_uk_mmt4d_params_t* params) {
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_uint32_t activation =
+      params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL;
+  const bool has_bias = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+  if (iree_uk_mmt4d_out_type(params->type) == IREE_UK_TYPE_FLOAT_32) {
+    float* acc = acc_tile;
+    const float* bias_f32 = bias;
+    for (iree_uk_int32_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_int32_t j0 = 0; j0 < N0; ++j0) {
+        float v = acc[i0 * N0 + j0];
+        if (has_bias) v += bias_f32[j0];
+        if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU) {
+          v = v > 0.f ? v : 0.f;
+        } else if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU) {
+          v = iree_uk_mmt4d_gelu_f32(v);
+        }
+        acc[i0 * N0 + j0] = v;
+      }
+    }
+    return;
+  }
+  iree_uk_int32_t* acc = acc_tile;
+  const iree_uk_int32_t* bias_i32 = bias;
+  iree_uk_int8_t* out = out_tile;
+  bool requantize = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  for (iree_uk_int32_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_int32_t j0 = 0; j0 < N0; ++j0) {
+      iree_uk_int32_t v = acc[i0 * N0 + j0];
+      if (has_bias) v += bias_i32[j0];
+      if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU) {
+        v = v > 0 ? v : 0;
+      }
+      if (requantize) {
+        out[i0 * N0 + j0] = iree_uk_mmt4d_requantize_i32_to_i8(
+            v, params->requantize_scale, params->requantize_zero_point);
+      } else {
+        acc[i0 * N0 + j0] = v;
+      }
+    }
+  }
+}
+
+// Same as iree_uk_mmt4d_using_tile_func, additionally applying the epilogue
+// requested by params->flags to each tile right after the tile_func has
+// accumulated it, while it is still hot in cache, instead of in a separate pass
+// over the whole output. When requantizing, the tile_func accumulates into a
+// local i32 tile which is then narrowed into the i8 output.
+static void iree_uk_mmt4d_using_tile_func_with_epilogue(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tile_func_t tile_func) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params->type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const bool requantize =
+      params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  const iree_uk_int16_t out_elem_size_log2 = requantize ? 0 : 2;
+  // The tile_func only gets the flags that it knows about.
+  const iree_uk_uint32_t tile_flags = params->flags & IREE_UK_FLAG_ACCUMULATE;
+  iree_uk_int32_t acc_buffer[iree_uk_mmt4d_tile_generic_max_bytes / 4]
+      IREE_UK_ATTRIBUTE_ALIGNED(64);
+  char* out_tile_row = params->out_buffer;
+  const char* lhs_panel = params->lhs_buffer;
+  iree_uk_int32_t acc_tile_size = (M0 * N0) << 2;
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_ssize_t lhs_panel_stride = params->lhs_stride << lhs_elem_size_log2;
+  iree_uk_ssize_t rhs_panel_stride =
+      iree_uk_type_size_of_count(rhs_type, params->rhs_stride);
   iree_uk_ssize_t out_stride = params->out_stride << out_elem_size_log2;
+  const bool skip_zero_rhs_tiles =
+      params->flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES;
   for (iree_uk_int32_t i = 0; i < M; ++i) {
     char* out_tile = out_tile_row;
     const char* rhs_panel = params->rhs_buffer;
+    const char* bias = params->bias_buffer;
     for (iree_uk_int32_t j = 0; j < N; ++j) {
-      tile_func(out_tile, lhs_panel, rhs_panel, K, params->flags, params);
+      void* acc_tile = requantize ? (void*)acc_buffer : (void*)out_tile;
+      if (K == 0) {
+        if (!(tile_flags & IREE_UK_FLAG_ACCUMULATE)) {
+          iree_uk_memset(acc_tile, 0, acc_tile_size);
+        }
+      } else if (skip_zero_rhs_tiles) {
+        iree_uk_mmt4d_tile_skipping_zero_rhs_tiles(
+            tile_func, acc_tile, lhs_panel, rhs_panel, K, tile_flags,
+            acc_tile_size, params);
+      } else {
+        tile_func(acc_tile, lhs_panel, rhs_panel, K, tile_flags, params);
+      }
+      iree_uk_mmt4d_epilogue_tile(acc_tile, out_tile, bias, params);
       out_tile += out_tile_size;
       rhs_panel += rhs_panel_stride;
+      bias += N0 * sizeof(iree_uk_int32_t);
     }
     out_tile_row += out_stride;
     lhs_panel += lhs_panel_stride;
@@ -94,6 +395,11 @@ static bool iree_uk_mmt4d_early(const iree_uk_mmt4d_params_t* params) {
   if (params->M == 0 || params->N == 0) {
     return true;
   }
+  // Epilogues are handled by iree_uk_mmt4d_using_tile_func_with_epilogue,
+  // including when K==0, as the output is then the epilogue applied to zeros.
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL) {
+    return false;
+  }
   if (params->K == 0) {
     if (params->flags & IREE_UK_FLAG_ACCUMULATE) {
       // Nothing to do!
@@ -103,11 +409,30 @@ static bool iree_uk_mmt4d_early(const iree_uk_mmt4d_params_t* params) {
     return true;
   }
 
+  // Zero RHS tiles are only skipped by the generic outer loops.
+  if (params->flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES) {
+    return false;
+  }
+
   // Targets that want to specialize the entire loop nest can do so here.
+#if defined(IREE_UK_ARCH_X86_64)
+  if (iree_uk_mmt4d_early_x86_64(params)) return true;
+#endif
 
   return false;
 }
 
+// Runs the generic outer loops with the given tile_func, which must be the
+// one selected for |params| (or equivalent params differing only in buffers).
+static void iree_uk_mmt4d_using_selected_tile_func(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tile_func_t tile_func) {
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL) {
+    iree_uk_mmt4d_using_tile_func_with_epilogue(params, tile_func);
+    return;
+  }
+  iree_uk_mmt4d_using_tile_func(params, tile_func);
+}
+
 IREE_UK_EXPORT void iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_validate(params);
 
@@ -118,6 +443,92 @@ IREE_UK_EXPORT void iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params) {
 
   // Select a target-specific tile_func (inner loop on K, computing one M0xN0
   // tile) and use that with generic outer loops.
+  if (iree_uk_mmt4d_rhs_is_quantized(params->type)) {
+    iree_uk_mmt4d_quantized_tile_func_t quantized_tile_func =
+        iree_uk_mmt4d_select_quantized_tile_func(params);
+    iree_uk_mmt4d_using_quantized_tile_func(params, quantized_tile_func);
+    return;
+  }
   iree_uk_mmt4d_tile_func_t tile_func = iree_uk_mmt4d_select_tile_func(params);
-  iree_uk_mmt4d_using_tile_func(params, tile_func);
+  iree_uk_mmt4d_using_selected_tile_func(params, tile_func);
+}
+
+// Prefetches the first |size| bytes, up to a limit, of a panel that will
+// be read soon, e.g. by the next batch, so that it does not start with cold
+// misses.
+static void iree_uk_mmt4d_prefetch_panel(const void* panel,
+                                         iree_uk_ssize_t size) {
+  // Enough lines to cover the first few K-iterations of typical tiles, without
+  // flooding the memory system for large K.
+  enum { max_prefetch_bytes = 1024, cache_line_bytes = 64 };
+  size = iree_uk_ssize_min(size, max_prefetch_bytes);
+  for (iree_uk_ssize_t i = 0; i < size; i += cache_line_bytes) {
+    IREE_UK_PREFETCH_RO((const char*)panel + i, 2);
+  }
+}
+
+// Advances the buffers of |params| to the next batch.
+static void iree_uk_batch_mmt4d_advance(iree_uk_mmt4d_params_t* params,
+                                        iree_uk_ssize_t lhs_batch_stride,
+                                        iree_uk_ssize_t rhs_batch_stride,
+                                        iree_uk_ssize_t out_batch_stride) {
+  params->lhs_buffer = (const char*)params->lhs_buffer + lhs_batch_stride;
+  params->rhs_buffer = (const char*)params->rhs_buffer + rhs_batch_stride;
+  params->out_buffer = (char*)params->out_buffer + out_batch_stride;
+}
+
+IREE_UK_EXPORT void iree_uk_batch_mmt4d(
+    const iree_uk_batch_mmt4d_params_t* params) {
+  iree_uk_mmt4d_validate(&params->mmt4d);
+#ifdef IREE_UK_ENABLE_ASSERTS
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->batch_size, 31));
+  IREE_UK_ASSERT(!iree_uk_mmt4d_rhs_is_quantized(params->mmt4d.type));
+#endif  // IREE_UK_ENABLE_ASSERTS
+  if (params->batch_size == 0) return;
+
+  iree_uk_mmt4d_params_t batch_params;
+  iree_uk_memcpy(&batch_params, &params->mmt4d, sizeof batch_params);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(batch_params.type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(batch_params.type);
+  const iree_uk_type_t out_type =
+      batch_params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE
+          ? IREE_UK_TYPE_INT_8
+          : iree_uk_mmt4d_out_type(batch_params.type);
+  const iree_uk_ssize_t lhs_batch_stride =
+      iree_uk_type_size_of_count(lhs_type, params->lhs_batch_stride);
+  const iree_uk_ssize_t rhs_batch_stride =
+      iree_uk_type_size_of_count(rhs_type, params->rhs_batch_stride);
+  const iree_uk_ssize_t out_batch_stride =
+      iree_uk_type_size_of_count(out_type, params->out_batch_stride);
+  const iree_uk_int32_t batch_size = params->batch_size;
+
+  // Whether the early path handles this mmt4d, and otherwise which tile_func
+  // to use, only depends on the type, shape and flags shared by all batches.
+  if (iree_uk_mmt4d_early(&batch_params)) {
+    for (iree_uk_int32_t b = 1; b < batch_size; ++b) {
+      iree_uk_batch_mmt4d_advance(&batch_params, lhs_batch_stride,
+                                  rhs_batch_stride, out_batch_stride);
+      iree_uk_mmt4d_early(&batch_params);
+    }
+    return;
+  }
+  iree_uk_mmt4d_tile_func_t tile_func =
+      iree_uk_mmt4d_select_tile_func(&batch_params);
+  const iree_uk_ssize_t lhs_panel_size = iree_uk_type_size_of_count(
+      lhs_type, batch_params.K * batch_params.M0 * batch_params.K0);
+  const iree_uk_ssize_t rhs_panel_size = iree_uk_type_size_of_count(
+      rhs_type, batch_params.K * batch_params.N0 * batch_params.K0);
+  for (iree_uk_int32_t b = 0; b < batch_size; ++b) {
+    if (b + 1 < batch_size) {
+      iree_uk_mmt4d_prefetch_panel(
+          (const char*)batch_params.lhs_buffer + lhs_batch_stride,
+          lhs_panel_size);
+      iree_uk_mmt4d_prefetch_panel(
+          (const char*)batch_params.rhs_buffer + rhs_batch_stride,
+          rhs_panel_size);
+    }
+    iree_uk_mmt4d_using_selected_tile_func(&batch_params, tile_func);
+    iree_uk_batch_mmt4d_advance(&batch_params, lhs_batch_stride,
+                                rhs_batch_stride, out_batch_stride);
+  }
 }
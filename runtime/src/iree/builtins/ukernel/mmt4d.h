@@ -18,6 +18,21 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, FLOAT_32, FLOAT_32),
   iree_uk_mmt4d_type_i8i8i32 =
       IREE_UK_TIE_3_TYPES_LITERAL(INT_8, INT_8, INT_32),
+  iree_uk_mmt4d_type_f16f16f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, FLOAT_16, FLOAT_32),
+  iree_uk_mmt4d_type_f16f16f16 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, FLOAT_16, FLOAT_16),
+  iree_uk_mmt4d_type_bf16bf16f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
+  iree_uk_mmt4d_type_bf16bf16bf16 =
+      IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  // Signed 4-bit RHS. As for i8, i4 values are interpreted as signed.
+  iree_uk_mmt4d_type_i8i4i32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(INT_8, INT_4, INT_32),
+  // Unsigned 4-bit RHS quantized with per-group scales and zero-points, see
+  // iree_uk_mmt4d_params_t::rhs_scales_buffer.
+  iree_uk_mmt4d_type_f32u4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, UINT_4, FLOAT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_type_t iree_uk_mmt4d_lhs_type(iree_uk_mmt4d_type_t type) {
@@ -32,6 +47,12 @@ static inline iree_uk_type_t iree_uk_mmt4d_out_type(iree_uk_mmt4d_type_t type) {
   return iree_uk_untie_type(2, type);
 }
 
+// Returns true if the RHS of |type| is quantized, i.e. its values need to be
+// dequantized with the per-group scales and zero-points given in the params.
+static inline bool iree_uk_mmt4d_rhs_is_quantized(iree_uk_mmt4d_type_t type) {
+  return type == iree_uk_mmt4d_type_f32u4f32;
+}
+
 // Parameters for a mmt4d operation.
 typedef struct iree_uk_mmt4d_params_t {
   iree_uk_mmt4d_type_t type;
@@ -48,9 +69,43 @@ typedef struct iree_uk_mmt4d_params_t {
   const void* lhs_buffer;
   const void* rhs_buffer;
   void* out_buffer;
+  // Only used when iree_uk_mmt4d_rhs_is_quantized(type). Each RHS value q
+  // dequantizes to (q - zero_point) * scale, where the f32 scales and
+  // zero-points are shared by groups of rhs_group_size consecutive K-iterations
+  // (so, rhs_group_size * K0 consecutive values along the reduction dimension).
+  // Both buffers are laid out as [N][ceil(K / rhs_group_size)][N0], with a
+  // stride of rhs_scales_stride elements between consecutive N-panels.
+  const void* rhs_scales_buffer;
+  const void* rhs_zero_points_buffer;
+  iree_uk_ssize_t rhs_scales_stride;
+  iree_uk_int32_t rhs_group_size;
+  // Only used with IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS. Per-column bias, of the
+  // accumulator type, laid out as [N][N0].
+  const void* bias_buffer;
+  // Only used with IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE, which requires the
+  // i8i8i32 type. Each i32 accumulator value v becomes the i8 output value
+  //   clamp(round_to_nearest_even(v * requantize_scale) +
+  //         requantize_zero_point, -128, 127)
+  // and, in that case, out_buffer and out_stride are in i8 elements.
+  float requantize_scale;
+  iree_uk_int32_t requantize_zero_point;
   const iree_uk_uint64_t* cpu_data;
 } iree_uk_mmt4d_params_t;
 
+// Parameters for a batch of mmt4d operations sharing the same type, shape and
+// flags, e.g. the per-head matmuls of an attention layer. Batch b is the mmt4d
+// operation described by |mmt4d|, with its LHS, RHS and output buffers offset
+// by b times the respective batch stride. Batch strides are in elements, like
+// the other strides. Other buffers (bias) are shared by all batches. Quantized
+// RHS types are not supported.
+typedef struct iree_uk_batch_mmt4d_params_t {
+  iree_uk_mmt4d_params_t mmt4d;
+  iree_uk_ssize_t batch_size;
+  iree_uk_ssize_t lhs_batch_stride;
+  iree_uk_ssize_t rhs_batch_stride;
+  iree_uk_ssize_t out_batch_stride;
+} iree_uk_batch_mmt4d_params_t;
+
 // Function pointer type for tile functions, i.e. typically architecture
 // specific functions computing one M0xN0 tile of the output matrix, i.e.
 // the inner-most loop of the matmul, i.e. the thing that we should actually
@@ -74,6 +129,24 @@ typedef void (*iree_uk_mmt4d_tile_func_t)(
             iree_uk_int32_t K, iree_uk_uint32_t flags,                    \
             const iree_uk_mmt4d_params_t* params);
 
+// Function pointer type for tile functions for types with a quantized RHS.
+// Same as iree_uk_mmt4d_tile_func_t, plus the scales and zero-points for the
+// current RHS panel, laid out as [ceil(K / group_size)][N0], and the group
+// size.
+typedef void (*iree_uk_mmt4d_quantized_tile_func_t)(
+    void* /*out_tile*/, const void* /*lhs_panel*/, const void* /*rhs_panel*/,
+    const float* /*rhs_scales*/, const float* /*rhs_zero_points*/,
+    iree_uk_int32_t /*K*/, iree_uk_int32_t /*group_size*/,
+    iree_uk_uint32_t /*flags*/, const iree_uk_mmt4d_params_t* /*params*/);
+
+// Quantized tile kernel declarations. Prototype matches
+// iree_uk_mmt4d_quantized_tile_func_t.
+#define IREE_UK_MMT4D_QUANTIZED_TILE_FUNC_DECL(NAME)                      \
+  void NAME(void* out_tile, const void* lhs_panel, const void* rhs_panel, \
+            const float* rhs_scales, const float* rhs_zero_points,        \
+            iree_uk_int32_t K, iree_uk_int32_t group_size,                \
+            iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params);
+
 // In order to be helpful as a reference for future architecture-specific
 // kernels, the generic kernels are structured like an actual optimized kernel,
 // using an "accumulator tile" that in this case is a stack array (which would
@@ -95,6 +168,11 @@ enum { iree_uk_mmt4d_tile_generic_max_bytes = 4096 };
 // Main entry point.
 IREE_UK_EXPORT void iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params);
 
+// Batched entry point. Equivalent to calling iree_uk_mmt4d on each batch, but
+// validates and selects a tile function only once for the whole batch.
+IREE_UK_EXPORT void iree_uk_batch_mmt4d(
+    const iree_uk_batch_mmt4d_params_t* params);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
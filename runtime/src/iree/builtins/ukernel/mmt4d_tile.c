@@ -8,6 +8,10 @@
 
 #if defined(IREE_UK_ARCH_ARM_64)
 #include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64.h"
+#elif defined(IREE_UK_ARCH_RISCV_64)
+#include "iree/builtins/ukernel/arch/riscv_64/mmt4d_riscv_64.h"
+#elif defined(IREE_UK_ARCH_WASM_32)
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32.h"
 #elif defined(IREE_UK_ARCH_X86_64)
 #include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64.h"
 #endif
@@ -48,6 +52,87 @@ static void iree_uk_mmt4d_tile_i8i8i32_generic(
   for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
 }
 
+// Generic implementation of matmul tile, i8*i4->i32 case. The RHS panel is
+// nibble-packed, see iree_uk_load_nibble.
+static void iree_uk_mmt4d_tile_i8i4i32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel, iree_uk_int32_t K, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* out_tile = out_tile_untyped;
+  const iree_uk_int8_t* lhs_panel = lhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // Initialize the local accumulator tile.
+  iree_uk_int32_t acc[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(*out_tile)];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = out_tile[i];
+  } else {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = 0;
+  }
+  // Accumulation loop. |rhs_offset| counts 4-bit elements.
+  iree_uk_ssize_t rhs_offset = 0;
+  for (iree_uk_ssize_t k = 0; k < K; ++k) {
+    for (iree_uk_ssize_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_ssize_t j0 = 0; j0 < N0; ++j0) {
+        for (iree_uk_ssize_t k0 = 0; k0 < K0; ++k0) {
+          iree_uk_int32_t lhs_val_int32 = lhs_panel[i0 * K0 + k0];
+          iree_uk_int32_t rhs_val_int32 = iree_uk_sign_extend_nibble(
+              iree_uk_load_nibble(rhs_panel, rhs_offset + j0 * K0 + k0));
+          acc[i0 * N0 + j0] += lhs_val_int32 * rhs_val_int32;
+        }
+      }
+    }
+    lhs_panel += M0 * K0;
+    rhs_offset += N0 * K0;
+  }
+  // Store the local accumulator tile to the destination.
+  for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
+}
+
+// Generic implementation of matmul tile, f32*u4->f32 case, dequantizing each
+// RHS value q to (q - zero_point) * scale with the scale and zero_point of its
+// group of |group_size| K-iterations.
+static void iree_uk_mmt4d_tile_f32u4f32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel, const float* rhs_scales,
+    const float* rhs_zero_points, iree_uk_int32_t K, iree_uk_int32_t group_size,
+    iree_uk_uint32_t flags, const iree_uk_mmt4d_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const float* lhs_panel = lhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // Initialize the local accumulator tile.
+  float acc[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(*out_tile)];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = out_tile[i];
+  } else {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = 0;
+  }
+  // Accumulation loop. |rhs_offset| counts 4-bit elements.
+  iree_uk_ssize_t rhs_offset = 0;
+  for (iree_uk_ssize_t k = 0; k < K; ++k) {
+    const float* scales = rhs_scales + (k / group_size) * N0;
+    const float* zero_points = rhs_zero_points + (k / group_size) * N0;
+    for (iree_uk_ssize_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_ssize_t j0 = 0; j0 < N0; ++j0) {
+        for (iree_uk_ssize_t k0 = 0; k0 < K0; ++k0) {
+          float lhs_val = lhs_panel[i0 * K0 + k0];
+          float rhs_quantized =
+              iree_uk_load_nibble(rhs_panel, rhs_offset + j0 * K0 + k0);
+          float rhs_val = (rhs_quantized - zero_points[j0]) * scales[j0];
+          acc[i0 * N0 + j0] += lhs_val * rhs_val;
+        }
+      }
+    }
+    lhs_panel += M0 * K0;
+    rhs_offset += N0 * K0;
+  }
+  // Store the local accumulator tile to the destination.
+  for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
+}
+
 // Generic implementation of matmul tile, f32*f32->f32 case.
 static void iree_uk_mmt4d_tile_f32f32f32_generic(
     void* out_tile_untyped, const void* lhs_panel_untyped,
@@ -84,6 +169,79 @@ static void iree_uk_mmt4d_tile_f32f32f32_generic(
   for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
 }
 
+// Loads element |i| of a buffer of f32, f16 or bf16 values as a float.
+static inline float iree_uk_mmt4d_load_float_generic(const void* buf,
+                                                     iree_uk_ssize_t i,
+                                                     iree_uk_type_t type) {
+  if (type == IREE_UK_TYPE_FLOAT_16) {
+    return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buf)[i]);
+  } else if (type == IREE_UK_TYPE_BFLOAT_16) {
+    return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buf)[i]);
+  }
+  return ((const float*)buf)[i];
+}
+
+// Stores a float to element |i| of a buffer of f32, f16 or bf16 values.
+static inline void iree_uk_mmt4d_store_float_generic(void* buf,
+                                                     iree_uk_ssize_t i,
+                                                     iree_uk_type_t type,
+                                                     float val) {
+  if (type == IREE_UK_TYPE_FLOAT_16) {
+    ((iree_uk_uint16_t*)buf)[i] = iree_uk_f32_to_f16(val);
+  } else if (type == IREE_UK_TYPE_BFLOAT_16) {
+    ((iree_uk_uint16_t*)buf)[i] = iree_uk_f32_to_bf16(val);
+  } else {
+    ((float*)buf)[i] = val;
+  }
+}
+
+// Generic implementation of matmul tile, 16-bit floating-point inputs
+// (f16*f16 or bf16*bf16) with f32 accumulation. The output is either f32 or
+// the same 16-bit type as the inputs, in which case the accumulator is only
+// rounded once, when storing to the destination.
+static void iree_uk_mmt4d_tile_f16_bf16_generic(
+    void* out_tile, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, iree_uk_int32_t K, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  const iree_uk_uint16_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint16_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params->type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // Initialize the local accumulator tile.
+  float acc[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(float)];
+  if (flags & IREE_UK_FLAG_ACCUMULATE) {
+    for (int i = 0; i < M0 * N0; ++i) {
+      acc[i] = iree_uk_mmt4d_load_float_generic(out_tile, i, out_type);
+    }
+  } else {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = 0;
+  }
+  // Accumulation loop.
+  for (iree_uk_ssize_t k = 0; k < K; ++k) {
+    for (iree_uk_ssize_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_ssize_t j0 = 0; j0 < N0; ++j0) {
+        for (iree_uk_ssize_t k0 = 0; k0 < K0; ++k0) {
+          float lhs_val = iree_uk_mmt4d_load_float_generic(
+              lhs_panel, i0 * K0 + k0, lhs_type);
+          float rhs_val = iree_uk_mmt4d_load_float_generic(
+              rhs_panel, j0 * K0 + k0, rhs_type);
+          acc[i0 * N0 + j0] += lhs_val * rhs_val;
+        }
+      }
+    }
+    lhs_panel += M0 * K0;
+    rhs_panel += N0 * K0;
+  }
+  // Store the local accumulator tile to the destination.
+  for (int i = 0; i < M0 * N0; ++i) {
+    iree_uk_mmt4d_store_float_generic(out_tile, i, out_type, acc[i]);
+  }
+}
+
 static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
     const iree_uk_mmt4d_params_t* params) {
   switch (params->type) {
@@ -91,6 +249,13 @@ static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
       return iree_uk_mmt4d_tile_f32f32f32_generic;
     case iree_uk_mmt4d_type_i8i8i32:
       return iree_uk_mmt4d_tile_i8i8i32_generic;
+    case iree_uk_mmt4d_type_i8i4i32:
+      return iree_uk_mmt4d_tile_i8i4i32_generic;
+    case iree_uk_mmt4d_type_f16f16f32:
+    case iree_uk_mmt4d_type_f16f16f16:
+    case iree_uk_mmt4d_type_bf16bf16f32:
+    case iree_uk_mmt4d_type_bf16bf16bf16:
+      return iree_uk_mmt4d_tile_f16_bf16_generic;
     default:
       // shouldn't happen, validated earlier.
       IREE_UK_ASSUME_UNREACHABLE;
@@ -102,6 +267,10 @@ static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
     const iree_uk_mmt4d_params_t* params) {
 #if defined(IREE_UK_ARCH_ARM_64)
   return iree_uk_mmt4d_select_tile_func_arm_64(params);
+#elif defined(IREE_UK_ARCH_RISCV_64)
+  return iree_uk_mmt4d_select_tile_func_riscv_64(params);
+#elif defined(IREE_UK_ARCH_WASM_32)
+  return iree_uk_mmt4d_select_tile_func_wasm_32(params);
 #elif defined(IREE_UK_ARCH_X86_64)
   return iree_uk_mmt4d_select_tile_func_x86_64(params);
 #endif
@@ -115,3 +284,35 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func(
   if (arch_tile_func) return arch_tile_func;
   return iree_uk_mmt4d_select_tile_func_generic(params);
 }
+
+static iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_generic(
+    const iree_uk_mmt4d_params_t* params) {
+  switch (params->type) {
+    case iree_uk_mmt4d_type_f32u4f32:
+      return iree_uk_mmt4d_tile_f32u4f32_generic;
+    default:
+      // shouldn't happen, validated earlier.
+      IREE_UK_ASSUME_UNREACHABLE;
+      return 0;
+  }
+}
+
+static iree_uk_mmt4d_quantized_tile_func_t
+iree_uk_mmt4d_select_quantized_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+#if defined(IREE_UK_ARCH_ARM_64)
+  return iree_uk_mmt4d_select_quantized_tile_func_arm_64(params);
+#elif defined(IREE_UK_ARCH_X86_64)
+  return iree_uk_mmt4d_select_quantized_tile_func_x86_64(params);
+#endif
+  return 0;
+}
+
+iree_uk_mmt4d_quantized_tile_func_t iree_uk_mmt4d_select_quantized_tile_func(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_quantized_tile_func_t arch_tile_func =
+      iree_uk_mmt4d_select_quantized_tile_func_arch(params);
+  if (arch_tile_func) return arch_tile_func;
+  return iree_uk_mmt4d_select_quantized_tile_func_generic(params);
+}
@@ -0,0 +1,169 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/normalize.h"
+
+#if defined(IREE_UK_ARCH_ARM_64)
+#include "iree/builtins/ukernel/arch/arm_64/normalize_arm_64.h"
+#elif defined(IREE_UK_ARCH_X86_64)
+#include "iree/builtins/ukernel/arch/x86_64/normalize_x86_64.h"
+#endif
+
+static void iree_uk_normalize_validate(
+    const iree_uk_normalize_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  IREE_UK_ASSERT(!params->flags);
+  IREE_UK_ASSERT(params->type == iree_uk_normalize_type_f32f32);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= params->size1);
+  IREE_UK_ASSERT(params->out_stride0 >= params->size1);
+  IREE_UK_ASSERT(params->epsilon >= 0.f);
+  // Aliasing is only supported when it's exactly in-place.
+  IREE_UK_ASSERT(params->in_buffer != params->out_buffer ||
+                 params->in_stride0 == params->out_stride0);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_normalize_early(const iree_uk_normalize_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+// Scalar exp(x), the same approximation as the vectorized arch code (see
+// iree_uk_sse2_exp_f32x4), so that results don't depend much on which code path
+// handled a given element. Avoids a libm dependency.
+static float iree_uk_normalize_exp_f32(float x) {
+  if (x != x) return x;
+  if (x < -88.3762626647949f) x = -88.3762626647949f;
+  if (x > 89.f) x = 89.f;
+  float fx = x * 1.44269504088896341f;
+  if (fx < -127.f) fx = -127.f;
+  if (fx > 127.f) fx = 127.f;
+  iree_uk_int32_t n = (iree_uk_int32_t)(fx + (fx >= 0.f ? 0.5f : -0.5f));
+  float nf = (float)n;
+  float r = x - nf * 0.693359375f - nf * -2.12194440e-4f;
+  float p = 1.9875691500E-4f;
+  p = p * r + 1.3981999507E-3f;
+  p = p * r + 8.3334519073E-3f;
+  p = p * r + 4.1665795894E-2f;
+  p = p * r + 1.6666665459E-1f;
+  p = p * r + 5.0000001201E-1f;
+  float y = p * r * r + r + 1.f;
+  iree_uk_uint32_t scale_bits = (iree_uk_uint32_t)(n + 127) << 23;
+  float scale;
+  iree_uk_memcpy(&scale, &scale_bits, sizeof scale);
+  return y * scale;
+}
+
+// Scalar 1/sqrt(x) for x > 0, by Newton-Raphson iterations from the classic
+// bit-level initial guess. Three iterations converge to float precision.
+// Avoids a libm dependency.
+static float iree_uk_normalize_rsqrt_f32(float x) {
+  iree_uk_uint32_t bits;
+  iree_uk_memcpy(&bits, &x, sizeof bits);
+  bits = 0x5f3759dfu - (bits >> 1);
+  float y;
+  iree_uk_memcpy(&y, &bits, sizeof y);
+  for (int i = 0; i < 3; ++i) y = y * (1.5f - 0.5f * x * y * y);
+  return y;
+}
+
+static void iree_uk_softmax_row_f32_generic(void* out_row, const void* in_row,
+                                            iree_uk_ssize_t size,
+                                            float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  float max = in_ptr[0];
+  for (iree_uk_ssize_t i = 1; i < size; ++i) {
+    if (in_ptr[i] > max) max = in_ptr[i];
+  }
+  float sum = 0.f;
+  for (iree_uk_ssize_t i = 0; i < size; ++i) {
+    float e = iree_uk_normalize_exp_f32(in_ptr[i] - max);
+    out_ptr[i] = e;
+    sum += e;
+  }
+  float inv_sum = 1.f / sum;
+  for (iree_uk_ssize_t i = 0; i < size; ++i) out_ptr[i] *= inv_sum;
+}
+
+// The mean and variance are computed in a single pass over the row, over the
+// values shifted by the first element of the row. The shift makes the
+// sum-of-squares formula for the variance numerically well-behaved (near a
+// two-pass computation) for rows whose mean is large compared to their spread.
+static void iree_uk_layernorm_row_f32_generic(void* out_row, const void* in_row,
+                                              iree_uk_ssize_t size,
+                                              float epsilon) {
+  const float* in_ptr = in_row;
+  float* out_ptr = out_row;
+  const float shift = in_ptr[0];
+  float sum = 0.f;
+  float sum_sq = 0.f;
+  for (iree_uk_ssize_t i = 0; i < size; ++i) {
+    float d = in_ptr[i] - shift;
+    sum += d;
+    sum_sq += d * d;
+  }
+  float inv_size = 1.f / (float)size;
+  float shifted_mean = sum * inv_size;
+  float variance = sum_sq * inv_size - shifted_mean * shifted_mean;
+  if (variance < 0.f) variance = 0.f;
+  float mean = shift + shifted_mean;
+  float inv_stddev = iree_uk_normalize_rsqrt_f32(variance + epsilon);
+  for (iree_uk_ssize_t i = 0; i < size; ++i) {
+    out_ptr[i] = (in_ptr[i] - mean) * inv_stddev;
+  }
+}
+
+static iree_uk_normalize_row_func_t iree_uk_softmax_select_row_func(
+    const iree_uk_normalize_params_t* params) {
+  iree_uk_normalize_row_func_t arch_row_func = 0;
+#if defined(IREE_UK_ARCH_ARM_64)
+  arch_row_func = iree_uk_softmax_select_row_func_arm_64(params);
+#elif defined(IREE_UK_ARCH_X86_64)
+  arch_row_func = iree_uk_softmax_select_row_func_x86_64(params);
+#endif
+  return arch_row_func ? arch_row_func : iree_uk_softmax_row_f32_generic;
+}
+
+static iree_uk_normalize_row_func_t iree_uk_layernorm_select_row_func(
+    const iree_uk_normalize_params_t* params) {
+  iree_uk_normalize_row_func_t arch_row_func = 0;
+#if defined(IREE_UK_ARCH_ARM_64)
+  arch_row_func = iree_uk_layernorm_select_row_func_arm_64(params);
+#elif defined(IREE_UK_ARCH_X86_64)
+  arch_row_func = iree_uk_layernorm_select_row_func_x86_64(params);
+#endif
+  return arch_row_func ? arch_row_func : iree_uk_layernorm_row_f32_generic;
+}
+
+static void iree_uk_normalize_using_row_func(
+    const iree_uk_normalize_params_t* params,
+    iree_uk_normalize_row_func_t row_func) {
+  const float* in_ptr = params->in_buffer;
+  float* out_ptr = params->out_buffer;
+  for (iree_uk_ssize_t i = 0; i < params->size0; ++i) {
+    row_func(out_ptr, in_ptr, params->size1, params->epsilon);
+    in_ptr += params->in_stride0;
+    out_ptr += params->out_stride0;
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_softmax(const iree_uk_normalize_params_t* params) {
+  iree_uk_normalize_validate(params);
+  if (iree_uk_normalize_early(params)) return;
+  iree_uk_normalize_using_row_func(params,
+                                   iree_uk_softmax_select_row_func(params));
+}
+
+IREE_UK_EXPORT void iree_uk_layernorm(
+    const iree_uk_normalize_params_t* params) {
+  iree_uk_normalize_validate(params);
+  if (iree_uk_normalize_early(params)) return;
+  iree_uk_normalize_using_row_func(params,
+                                   iree_uk_layernorm_select_row_func(params));
+}
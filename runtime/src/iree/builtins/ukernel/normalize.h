@@ -0,0 +1,80 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_NORMALIZE_H_
+#define IREE_BUILTINS_UKERNEL_NORMALIZE_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Row-wise normalizations: softmax and layernorm, each normalizing every row
+// of a row-major size0 x size1 matrix independently. These are reductions
+// followed by an elementwise rescaling of the same row, which codegen handles
+// poorly as it needs the whole row reduced before the rescaling can start.
+
+typedef enum iree_uk_normalize_type_t {
+  iree_uk_normalize_type_f32f32 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_normalize_type_t;
+
+static inline iree_uk_type_t iree_uk_normalize_in_type(
+    iree_uk_normalize_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_normalize_out_type(
+    iree_uk_normalize_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Parameters for a softmax or layernorm operation. The output may alias the
+// input (in_buffer == out_buffer and in_stride0 == out_stride0), but may not
+// otherwise overlap it.
+typedef struct iree_uk_normalize_params_t {
+  iree_uk_normalize_type_t type;
+  iree_uk_uint32_t flags;
+  iree_uk_ssize_t in_stride0;
+  iree_uk_ssize_t out_stride0;
+  iree_uk_ssize_t size0;
+  iree_uk_ssize_t size1;
+  // Only used by layernorm: added to the variance before taking its inverse
+  // square root.
+  float epsilon;
+  const void* in_buffer;
+  void* out_buffer;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_normalize_params_t;
+
+// Function pointer type for row functions, normalizing one row of |size|
+// elements. Row functions may be called with out_row == in_row.
+typedef void (*iree_uk_normalize_row_func_t)(void* /*out_row*/,
+                                             const void* /*in_row*/,
+                                             iree_uk_ssize_t /*size*/,
+                                             float /*epsilon*/);
+
+// Row function declarations. Prototype matches iree_uk_normalize_row_func_t.
+#define IREE_UK_NORMALIZE_ROW_FUNC_DECL(NAME)                        \
+  void NAME(void* out_row, const void* in_row, iree_uk_ssize_t size, \
+            float epsilon);
+
+// Softmax: out[i][j] = exp(in[i][j] - m) / sum_k(exp(in[i][k] - m)), where m
+// is the max of row i, which is subtracted for numerical stability.
+IREE_UK_EXPORT void iree_uk_softmax(const iree_uk_normalize_params_t* params);
+
+// Layernorm without the affine part:
+// out[i][j] = (in[i][j] - mean_i) / sqrt(variance_i + epsilon), where mean_i
+// and variance_i are the mean and (biased) variance of row i. The affine
+// scale and bias, if any, are left to subsequent elementwise operations.
+IREE_UK_EXPORT void iree_uk_layernorm(const iree_uk_normalize_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_NORMALIZE_H_
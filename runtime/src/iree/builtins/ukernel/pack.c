@@ -59,7 +59,10 @@ static void iree_uk_pack_validate(const iree_uk_pack_params_t* params) {
   IREE_UK_ASSERT(!(params->flags & ~allflags));
   IREE_UK_ASSERT(params->type == iree_uk_pack_type_f32f32 ||
                  params->type == iree_uk_pack_type_i8i8 ||
-                 params->type == iree_uk_pack_type_i32i32);
+                 params->type == iree_uk_pack_type_i32i32 ||
+                 params->type == iree_uk_pack_type_f16f16 ||
+                 params->type == iree_uk_pack_type_bf16bf16 ||
+                 params->type == iree_uk_pack_type_i4i4);
   IREE_UK_ASSERT(params->in_stride0 >= 0);
   IREE_UK_ASSERT(params->out_stride0 >= 0);
   IREE_UK_ASSERT(params->in_size0 >= 0);
@@ -86,13 +89,15 @@ static void iree_uk_pack_validate(const iree_uk_pack_params_t* params) {
   // IREE_UK_ASSERT((outer_size0 - 1) * tile_size0 < params->in_size0);
   // IREE_UK_ASSERT((outer_size1 - 1) * tile_size1 < params->in_size1);
 
+  // Sub-byte types are packed element-wise, without a temporary buffer.
+  iree_uk_type_t elem_type = iree_uk_pack_in_type(params->type);
+  if (iree_uk_type_bit_count(elem_type) < 8) return;
   // Initialize a padding helper, just to get the assertion that the tile size
   // does not exceed the internal temporary buffer size, without having to
   // duplicate this arithmetic. Generally, we want to hit all failure modes
   // in the validation function so that the subsequent ukernel code can be
   // treated as infallible.
   iree_uk_pack_tmpbuf_helper_t padding_helper;
-  iree_uk_type_t elem_type = iree_uk_pack_in_type(params->type);
   iree_uk_ssize_t elem_size = iree_uk_type_size(elem_type);
   iree_uk_pack_tmpbuf_helper_t_init(tile_size0, tile_size1, elem_size,
                                     params->padding_value, &padding_helper);
@@ -227,11 +232,59 @@ static void iree_uk_pack_using_tile_func(const iree_uk_pack_params_t* params,
   }
 }
 
+// Packs nibble-packed 4-bit elements one at a time. Tiles generally do not
+// start on byte boundaries in the source, so the tile_func approach, which is
+// built around memcpy of whole elements, does not apply. Strides are counted
+// in elements, like for other types.
+static void iree_uk_pack_i4(const iree_uk_pack_params_t* params) {
+  iree_uk_ssize_t tile_size0 = params->out_size2;
+  iree_uk_ssize_t tile_size1 = params->out_size3;
+  if (params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER) {
+    iree_uk_ssize_swap(&tile_size0, &tile_size1);
+  }
+  iree_uk_uint8_t padding = *(const iree_uk_uint8_t*)params->padding_value;
+  iree_uk_ssize_t out_tile_elems = params->out_size2 * params->out_size3;
+  for (iree_uk_ssize_t o0 = 0; o0 < params->out_size0; ++o0) {
+    for (iree_uk_ssize_t o1 = 0; o1 < params->out_size1; ++o1) {
+      iree_uk_ssize_t outer0 = o0;
+      iree_uk_ssize_t outer1 = o1;
+      if (params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_OUTER) {
+        iree_uk_ssize_swap(&outer0, &outer1);
+      }
+      iree_uk_ssize_t out_offset =
+          o0 * params->out_stride0 + o1 * out_tile_elems;
+      for (iree_uk_ssize_t t0 = 0; t0 < params->out_size2; ++t0) {
+        for (iree_uk_ssize_t t1 = 0; t1 < params->out_size3; ++t1) {
+          iree_uk_ssize_t inner0 = t0;
+          iree_uk_ssize_t inner1 = t1;
+          if (params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER) {
+            iree_uk_ssize_swap(&inner0, &inner1);
+          }
+          iree_uk_ssize_t i0 = outer0 * tile_size0 + inner0;
+          iree_uk_ssize_t i1 = outer1 * tile_size1 + inner1;
+          iree_uk_uint8_t val =
+              (i0 < params->in_size0 && i1 < params->in_size1)
+                  ? iree_uk_load_nibble(params->in_buffer,
+                                        i0 * params->in_stride0 + i1)
+                  : padding;
+          iree_uk_store_nibble(params->out_buffer,
+                               out_offset + t0 * params->out_size3 + t1, val);
+        }
+      }
+    }
+  }
+}
+
 IREE_UK_EXPORT void iree_uk_pack(const iree_uk_pack_params_t* params) {
   iree_uk_pack_validate(params);
 
   if (iree_uk_pack_early(params)) return;
 
+  if (params->type == iree_uk_pack_type_i4i4) {
+    iree_uk_pack_i4(params);
+    return;
+  }
+
   // Select a target-specific tile_func and use that with generic outer loops.
   iree_uk_pack_tile_func_t tile_func = iree_uk_pack_select_tile_func(params);
   iree_uk_pack_using_tile_func(params, tile_func);
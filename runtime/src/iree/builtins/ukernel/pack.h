@@ -17,6 +17,12 @@ typedef enum iree_uk_pack_type_t {
   iree_uk_pack_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
   iree_uk_pack_type_i8i8 = IREE_UK_TIE_2_TYPES_LITERAL(INT_8, INT_8),
   iree_uk_pack_type_i32i32 = IREE_UK_TIE_2_TYPES_LITERAL(INT_32, INT_32),
+  iree_uk_pack_type_f16f16 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_16, FLOAT_16),
+  iree_uk_pack_type_bf16bf16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(BFLOAT_16, BFLOAT_16),
+  // Nibble-packed, see iree_uk_load_nibble. The padding value is the low 4 bits
+  // of the byte at padding_value.
+  iree_uk_pack_type_i4i4 = IREE_UK_TIE_2_TYPES_LITERAL(INT_4, INT_4),
 } iree_uk_pack_type_t;
 
 static inline iree_uk_type_t iree_uk_pack_in_type(iree_uk_pack_type_t type) {
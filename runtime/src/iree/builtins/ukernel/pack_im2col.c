@@ -0,0 +1,202 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/pack_im2col.h"
+
+#include "iree/builtins/ukernel/pack_tile.h"
+
+enum { iree_uk_pack_im2col_tmp_buf_size = 4096 };
+
+// Returns the number of rows of the im2col matrix.
+static iree_uk_ssize_t iree_uk_pack_im2col_rows(
+    const iree_uk_pack_im2col_params_t* params) {
+  return params->in_size0 * params->conv_out_size0 * params->conv_out_size1;
+}
+
+// Returns the number of columns of the im2col matrix.
+static iree_uk_ssize_t iree_uk_pack_im2col_cols(
+    const iree_uk_pack_im2col_params_t* params) {
+  return params->kernel_size0 * params->kernel_size1 * params->in_size3;
+}
+
+static void iree_uk_pack_im2col_validate(
+    const iree_uk_pack_im2col_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  IREE_UK_ASSERT(!params->flags);
+  IREE_UK_ASSERT(params->type == iree_uk_pack_type_f32f32 ||
+                 params->type == iree_uk_pack_type_i8i8 ||
+                 params->type == iree_uk_pack_type_i32i32 ||
+                 params->type == iree_uk_pack_type_f16f16 ||
+                 params->type == iree_uk_pack_type_bf16bf16);
+  IREE_UK_ASSERT(params->in_stride0 >= 0);
+  IREE_UK_ASSERT(params->in_stride1 >= 0);
+  IREE_UK_ASSERT(params->in_stride2 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0);
+  IREE_UK_ASSERT(params->in_size0 >= 0);
+  IREE_UK_ASSERT(params->in_size1 >= 0);
+  IREE_UK_ASSERT(params->in_size2 >= 0);
+  IREE_UK_ASSERT(params->in_size3 >= 0);
+  IREE_UK_ASSERT(params->conv_out_size0 >= 0);
+  IREE_UK_ASSERT(params->conv_out_size1 >= 0);
+  IREE_UK_ASSERT(params->kernel_size0 >= 0);
+  IREE_UK_ASSERT(params->kernel_size1 >= 0);
+  IREE_UK_ASSERT(params->conv_stride0 > 0);
+  IREE_UK_ASSERT(params->conv_stride1 > 0);
+  IREE_UK_ASSERT(params->dilation0 > 0);
+  IREE_UK_ASSERT(params->dilation1 > 0);
+  IREE_UK_ASSERT(params->padding0 >= 0);
+  IREE_UK_ASSERT(params->padding1 >= 0);
+  IREE_UK_ASSERT(params->out_size0 >= 0);
+  IREE_UK_ASSERT(params->out_size1 >= 0);
+  IREE_UK_ASSERT(params->out_size2 >= 0);
+  IREE_UK_ASSERT(params->out_size3 >= 0);
+  // The packed im2col matrix must cover the whole im2col matrix, give or take
+  // padding to whole tiles.
+  IREE_UK_ASSERT(params->out_size0 * params->out_size2 >=
+                 iree_uk_pack_im2col_rows(params));
+  IREE_UK_ASSERT(params->out_size1 * params->out_size3 >=
+                 iree_uk_pack_im2col_cols(params));
+  // At least one tile has to fit in the temporary buffer.
+  iree_uk_ssize_t elem_size =
+      iree_uk_type_size(iree_uk_pack_in_type(params->type));
+  IREE_UK_ASSERT(params->out_size2 * params->out_size3 * elem_size <=
+                 iree_uk_pack_im2col_tmp_buf_size);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_pack_im2col_early(
+    const iree_uk_pack_im2col_params_t* params) {
+  return (params->out_size0 == 0 || params->out_size1 == 0 ||
+          params->out_size2 == 0 || params->out_size3 == 0);
+}
+
+// Fills `buf` with `num_elems` times the `elem_size` bytes at `pattern`.
+static void iree_uk_pack_im2col_fill(char* buf, iree_uk_ssize_t num_elems,
+                                     iree_uk_ssize_t elem_size,
+                                     const char* pattern) {
+  for (iree_uk_ssize_t i = 0; i < num_elems; ++i) {
+    iree_uk_memcpy(buf + i * elem_size, pattern, elem_size);
+  }
+}
+
+// Gathers `size` consecutive elements of row `row` of the im2col matrix,
+// starting at column `col`, into `dst_buf`. Each run of columns sharing the
+// same kernel position is a contiguous run of channels in the input and is
+// copied at once.
+static void iree_uk_pack_im2col_gather_row(
+    const iree_uk_pack_im2col_params_t* params, iree_uk_ssize_t row,
+    iree_uk_ssize_t col, iree_uk_ssize_t size, iree_uk_ssize_t elem_size,
+    char* dst_buf) {
+  const char* padding = params->padding_value;
+  if (row >= iree_uk_pack_im2col_rows(params)) {
+    iree_uk_pack_im2col_fill(dst_buf, size, elem_size, padding);
+    return;
+  }
+  iree_uk_ssize_t ow = row % params->conv_out_size1;
+  iree_uk_ssize_t oh = (row / params->conv_out_size1) % params->conv_out_size0;
+  iree_uk_ssize_t n = row / (params->conv_out_size1 * params->conv_out_size0);
+  const char* in_batch = (const char*)params->in_buffer +
+                         n * params->in_stride0 * elem_size;
+  iree_uk_ssize_t cols = iree_uk_pack_im2col_cols(params);
+  iree_uk_ssize_t channels = params->in_size3;
+  iree_uk_ssize_t col_end = col + size;
+  while (col < col_end) {
+    if (col >= cols) {
+      iree_uk_pack_im2col_fill(dst_buf, col_end - col, elem_size, padding);
+      return;
+    }
+    iree_uk_ssize_t c = col % channels;
+    iree_uk_ssize_t kw = (col / channels) % params->kernel_size1;
+    iree_uk_ssize_t kh = col / (channels * params->kernel_size1);
+    iree_uk_ssize_t run = iree_uk_ssize_clamp(channels - c, 0, col_end - col);
+    iree_uk_ssize_t ih =
+        oh * params->conv_stride0 + kh * params->dilation0 - params->padding0;
+    iree_uk_ssize_t iw =
+        ow * params->conv_stride1 + kw * params->dilation1 - params->padding1;
+    if (ih < 0 || ih >= params->in_size1 || iw < 0 ||
+        iw >= params->in_size2) {
+      iree_uk_pack_im2col_fill(dst_buf, run, elem_size, padding);
+    } else {
+      iree_uk_ssize_t in_offset =
+          ih * params->in_stride1 + iw * params->in_stride2 + c;
+      iree_uk_memcpy(dst_buf, in_batch + in_offset * elem_size,
+                     run * elem_size);
+    }
+    dst_buf += run * elem_size;
+    col += run;
+  }
+}
+
+// Returns the pack tile function for the pack of the im2col matrix.
+static iree_uk_pack_tile_func_t iree_uk_pack_im2col_select_tile_func(
+    const iree_uk_pack_im2col_params_t* params) {
+  iree_uk_pack_params_t pack_params = {
+      .type = params->type,
+      .flags = params->flags,
+      .in_stride0 = iree_uk_pack_im2col_cols(params),
+      .out_stride0 = params->out_stride0,
+      .in_size0 = iree_uk_pack_im2col_rows(params),
+      .in_size1 = iree_uk_pack_im2col_cols(params),
+      .out_size0 = params->out_size0,
+      .out_size1 = params->out_size1,
+      .out_size2 = params->out_size2,
+      .out_size3 = params->out_size3,
+      .in_buffer = params->in_buffer,
+      .out_buffer = params->out_buffer,
+      .padding_value = params->padding_value,
+      .cpu_data = params->cpu_data,
+  };
+  return iree_uk_pack_select_tile_func(&pack_params);
+}
+
+// Gathers rows of tiles of the im2col matrix into a temporary buffer, as many
+// tiles at a time as fit, and packs them with the regular pack tile function.
+static void iree_uk_pack_im2col_using_tile_func(
+    const iree_uk_pack_im2col_params_t* params,
+    iree_uk_pack_tile_func_t tile_func) {
+  // For now, the input and output element types are always the same.
+  iree_uk_type_t elem_type = iree_uk_pack_in_type(params->type);
+  iree_uk_ssize_t elem_size = iree_uk_type_size(elem_type);
+  iree_uk_ssize_t tile_size0 = params->out_size2;
+  iree_uk_ssize_t tile_size1 = params->out_size3;
+  iree_uk_ssize_t out_stride1 = tile_size0 * tile_size1;
+  // Cache line alignment, as for the pack temporary buffer.
+  IREE_UK_ATTRIBUTE_ALIGNED(64) char tmp_buf[iree_uk_pack_im2col_tmp_buf_size];
+  iree_uk_ssize_t max_tiles_in_tmp_buf =
+      iree_uk_pack_im2col_tmp_buf_size / (out_stride1 * elem_size);
+  char* out_buf = params->out_buffer;
+  for (iree_uk_ssize_t outer0 = 0; outer0 < params->out_size0; ++outer0) {
+    iree_uk_ssize_t outer1 = 0;
+    while (outer1 < params->out_size1) {
+      iree_uk_ssize_t chunk_tiles = iree_uk_ssize_clamp(
+          params->out_size1 - outer1, 0, max_tiles_in_tmp_buf);
+      iree_uk_ssize_t chunk_width = chunk_tiles * tile_size1;
+      for (iree_uk_ssize_t tile_i0 = 0; tile_i0 < tile_size0; ++tile_i0) {
+        char* row_buf = tmp_buf + tile_i0 * chunk_width * elem_size;
+        iree_uk_pack_im2col_gather_row(params, outer0 * tile_size0 + tile_i0,
+                                       outer1 * tile_size1, chunk_width,
+                                       elem_size, row_buf);
+      }
+      tile_func(out_buf + outer1 * out_stride1 * elem_size, tmp_buf,
+                chunk_tiles, out_stride1, chunk_width, elem_size, tile_size0,
+                tile_size1);
+      outer1 += chunk_tiles;
+    }
+    out_buf += params->out_stride0 * elem_size;
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_pack_im2col(
+    const iree_uk_pack_im2col_params_t* params) {
+  iree_uk_pack_im2col_validate(params);
+
+  if (iree_uk_pack_im2col_early(params)) return;
+
+  iree_uk_pack_tile_func_t tile_func =
+      iree_uk_pack_im2col_select_tile_func(params);
+  iree_uk_pack_im2col_using_tile_func(params, tile_func);
+}
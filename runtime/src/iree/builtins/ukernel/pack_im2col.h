@@ -0,0 +1,73 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_PACK_IM2COL_H_
+#define IREE_BUILTINS_UKERNEL_PACK_IM2COL_H_
+
+#include "iree/builtins/ukernel/common.h"
+#include "iree/builtins/ukernel/pack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Parameters for a pack_im2col operation: a pack whose source is the im2col
+// matrix of a 2-D convolution, gathered on the fly from the convolution input
+// so that the im2col matrix itself never exists in memory. The result has the
+// same layout as the pack of that matrix into the mmt4d LHS layout, so a
+// convolution can be computed as an implicit GEMM by mmt4d.
+//
+// The input is NHWC with unit channel stride. The im2col matrix has
+// in_size0 * conv_out_size0 * conv_out_size1 rows, indexed by (n, oh, ow), and
+// kernel_size0 * kernel_size1 * in_size3 columns, indexed by (kh, kw, c), as
+// for a row-major collapse of a HWCF filter. Its element at (n, oh, ow) and
+// (kh, kw, c) is the input element at
+//   (n, oh * conv_stride0 + kh * dilation0 - padding0,
+//       ow * conv_stride1 + kw * dilation1 - padding1, c)
+// or padding_value if that is outside of the input. padding_value is also used
+// to pad the im2col matrix to whole tiles, as in pack.
+//
+// Strides are counted in elements. Transposes (flags) are not supported.
+typedef struct iree_uk_pack_im2col_params_t {
+  iree_uk_pack_type_t type;
+  iree_uk_uint32_t flags;
+  iree_uk_ssize_t in_stride0;
+  iree_uk_ssize_t in_stride1;
+  iree_uk_ssize_t in_stride2;
+  iree_uk_ssize_t out_stride0;
+  iree_uk_ssize_t in_size0;
+  iree_uk_ssize_t in_size1;
+  iree_uk_ssize_t in_size2;
+  iree_uk_ssize_t in_size3;
+  iree_uk_ssize_t conv_out_size0;
+  iree_uk_ssize_t conv_out_size1;
+  iree_uk_ssize_t kernel_size0;
+  iree_uk_ssize_t kernel_size1;
+  iree_uk_ssize_t conv_stride0;
+  iree_uk_ssize_t conv_stride1;
+  iree_uk_ssize_t dilation0;
+  iree_uk_ssize_t dilation1;
+  iree_uk_ssize_t padding0;
+  iree_uk_ssize_t padding1;
+  iree_uk_ssize_t out_size0;
+  iree_uk_ssize_t out_size1;
+  iree_uk_ssize_t out_size2;
+  iree_uk_ssize_t out_size3;
+  const void* in_buffer;
+  void* out_buffer;
+  const void* padding_value;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_pack_im2col_params_t;
+
+// Main entry point.
+IREE_UK_EXPORT void iree_uk_pack_im2col(
+    const iree_uk_pack_im2col_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_PACK_IM2COL_H_
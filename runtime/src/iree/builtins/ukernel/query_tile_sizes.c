@@ -8,6 +8,10 @@
 
 #if defined(IREE_UK_ARCH_ARM_64)
 #include "iree/builtins/ukernel/arch/arm_64/query_tile_sizes_arm_64.h"
+#elif defined(IREE_UK_ARCH_RISCV_64)
+#include "iree/builtins/ukernel/arch/riscv_64/query_tile_sizes_riscv_64.h"
+#elif defined(IREE_UK_ARCH_WASM_32)
+#include "iree/builtins/ukernel/arch/wasm_32/query_tile_sizes_wasm_32.h"
 #elif defined(IREE_UK_ARCH_X86_64)
 #include "iree/builtins/ukernel/arch/x86_64/query_tile_sizes_x86_64.h"
 #endif
@@ -16,7 +20,13 @@ static bool iree_uk_query_tile_sizes_operation_is_matmul(
     iree_uk_uint32_t flags) {
   iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(flags);
   return op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32 ||
-         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32;
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32 ||
+         op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32U4F32;
 }
 
 static void iree_uk_query_tile_sizes_2d_validate(
@@ -47,6 +57,11 @@ static bool iree_uk_query_matmul_tile_sizes_arch(
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
 #if defined(IREE_UK_ARCH_ARM_64)
   return iree_uk_query_matmul_tile_sizes_arm_64(params, out_matmul_tile_sizes);
+#elif defined(IREE_UK_ARCH_RISCV_64)
+  return iree_uk_query_matmul_tile_sizes_riscv_64(params,
+                                                  out_matmul_tile_sizes);
+#elif defined(IREE_UK_ARCH_WASM_32)
+  return iree_uk_query_matmul_tile_sizes_wasm_32(params, out_matmul_tile_sizes);
 #elif defined(IREE_UK_ARCH_X86_64)
   return iree_uk_query_matmul_tile_sizes_x86_64(params, out_matmul_tile_sizes);
 #endif
@@ -42,6 +42,38 @@ typedef struct iree_uk_matmul_tile_sizes_t {
   int M, K, N;
 } iree_uk_matmul_tile_sizes_t;
 
+// Internal use only. Entry of an architecture-specific table of matmul tile
+// sizes tuned for a given CPU model, see tuned_tile_sizes.inl. Tables are
+// terminated by an entry with cpu_model == 0.
+typedef struct iree_uk_matmul_tuned_tile_sizes_t {
+  iree_uk_uint64_t cpu_model;
+  iree_uk_uint32_t operation;
+  // Returns true if the CPU supports, and the build includes, the tile function
+  // for these tile sizes.
+  bool (*cpu_supports)(const iree_uk_uint64_t* cpu_data);
+  iree_uk_matmul_tile_sizes_t tile_sizes;
+} iree_uk_matmul_tuned_tile_sizes_t;
+
+// Internal use only. Looks up the tile sizes for the given params in |table|.
+// Returns false if there is no applicable entry.
+static inline bool iree_uk_query_matmul_tuned_tile_sizes(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    const iree_uk_matmul_tuned_tile_sizes_t* table,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+  iree_uk_uint64_t cpu_model = params->cpu_data[1];
+  if (!cpu_model) return false;
+  iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
+  for (const iree_uk_matmul_tuned_tile_sizes_t* entry = table;
+       entry->cpu_model; ++entry) {
+    if (entry->cpu_model == cpu_model && entry->operation == op &&
+        entry->cpu_supports(params->cpu_data)) {
+      *out_matmul_tile_sizes = entry->tile_sizes;
+      return true;
+    }
+  }
+  return false;
+}
+
 // Main entry point.
 IREE_UK_EXPORT void iree_uk_query_tile_sizes_2d(
     const iree_uk_query_tile_sizes_2d_params_t* params,
@@ -6,11 +6,32 @@
 
 #include "iree/builtins/ukernel/tools/benchmark.h"
 
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
 #include "iree/schemas/cpu_data.h"
 
+IREE_FLAG(double, roofline_peak_gops, 0,
+          "Peak arithmetic throughput in Gop/s (a multiply-add counting as 2 "
+          "ops) to report results against. If 0 it is measured with a loop "
+          "compiled for the architecture baseline, so kernels using wider "
+          "SIMD than the baseline can exceed 100%.");
+IREE_FLAG(double, roofline_peak_gbps, 0,
+          "Peak memory bandwidth in GB/s of bytes read plus written to report "
+          "results against. If 0 it is measured with memcpy over "
+          "--roofline_working_set_size bytes.");
+IREE_FLAG(int64_t, roofline_working_set_size, 16384,
+          "Number of bytes traversed by memcpy when measuring the bandwidth "
+          "roofline (input and output buffers together). The default fits in "
+          "the L1 cache of most CPUs.");
+IREE_FLAG(int32_t, roofline_min_time_ms, 50,
+          "Minimum time in milliseconds to spend measuring each part of the "
+          "roofline.");
+
+static iree_uk_benchmark_roofline_t s_iree_uk_benchmark_roofline;
+
 struct iree_uk_benchmark_user_data_t {
   const void* params;
   iree_uk_uint64_t* cpu_data;
@@ -47,6 +68,115 @@ void* iree_uk_benchmark_static_alloc(size_t size) {
   return ptr;
 }
 
+IREE_UK_ATTRIBUTE_NOINLINE void iree_uk_benchmark_memcpy_noinline(
+    void* IREE_UK_RESTRICT dst, const void* IREE_UK_RESTRICT src,
+    size_t size) {
+  memcpy(dst, src, size);
+}
+
+// Number of independent multiply-add chains in the peak arithmetic loop. Large
+// enough to hide the latency of the multiply-adds once vectorized.
+#define IREE_UK_BENCHMARK_ROOFLINE_LANES 64
+
+IREE_UK_ATTRIBUTE_NOINLINE static void iree_uk_benchmark_roofline_madd_loop(
+    float* acc, int64_t count) {
+  float local[IREE_UK_BENCHMARK_ROOFLINE_LANES];
+  memcpy(local, acc, sizeof local);
+  // Converges to 1 without denormals or overflow.
+  const float a = 0.999f;
+  const float b = 0.001f;
+  for (int64_t i = 0; i < count; ++i) {
+    for (int j = 0; j < IREE_UK_BENCHMARK_ROOFLINE_LANES; ++j) {
+      local[j] = local[j] * a + b;
+    }
+  }
+  memcpy(acc, local, sizeof local);
+}
+
+// Runs |fn| with doubling iteration counts until it takes at least
+// --roofline_min_time_ms and returns the iterations per second.
+static double iree_uk_benchmark_roofline_rate(void (*fn)(void*, int64_t),
+                                              void* user_data) {
+  fn(user_data, 1);  // Warm up.
+  iree_time_t min_time_ns = FLAG_roofline_min_time_ms * 1000000ll;
+  int64_t iterations = 1;
+  while (true) {
+    iree_time_t start_ns = iree_time_now();
+    fn(user_data, iterations);
+    iree_time_t elapsed_ns = iree_time_now() - start_ns;
+    if (elapsed_ns >= min_time_ns) return iterations * 1e9 / elapsed_ns;
+    iterations *= 2;
+  }
+}
+
+static void iree_uk_benchmark_roofline_madd(void* user_data, int64_t count) {
+  iree_uk_benchmark_roofline_madd_loop((float*)user_data, count);
+}
+
+typedef struct iree_uk_benchmark_roofline_memcpy_t {
+  void* dst;
+  const void* src;
+  size_t size;
+} iree_uk_benchmark_roofline_memcpy_t;
+
+static void iree_uk_benchmark_roofline_memcpy(void* user_data, int64_t count) {
+  const iree_uk_benchmark_roofline_memcpy_t* params = user_data;
+  for (int64_t i = 0; i < count; ++i) {
+    iree_uk_benchmark_memcpy_noinline(params->dst, params->src, params->size);
+  }
+}
+
+static void iree_uk_benchmark_measure_roofline(
+    iree_uk_benchmark_roofline_t* out_roofline) {
+  out_roofline->ops_per_second = FLAG_roofline_peak_gops * 1e9;
+  if (out_roofline->ops_per_second <= 0) {
+    float acc[IREE_UK_BENCHMARK_ROOFLINE_LANES];
+    for (int j = 0; j < IREE_ARRAYSIZE(acc); ++j) acc[j] = (float)j;
+    out_roofline->ops_per_second =
+        iree_uk_benchmark_roofline_rate(iree_uk_benchmark_roofline_madd, acc) *
+        2 * IREE_UK_BENCHMARK_ROOFLINE_LANES;
+  }
+  out_roofline->bytes_per_second = FLAG_roofline_peak_gbps * 1e9;
+  if (out_roofline->bytes_per_second <= 0) {
+    size_t size = iree_max(FLAG_roofline_working_set_size / 2, 1);
+    iree_uk_benchmark_roofline_memcpy_t params = {
+        .dst = malloc(size),
+        .src = malloc(size),
+        .size = size,
+    };
+    memset((void*)params.src, 1, size);
+    out_roofline->bytes_per_second =
+        iree_uk_benchmark_roofline_rate(iree_uk_benchmark_roofline_memcpy,
+                                        &params) *
+        2 * size;
+    free(params.dst);
+    free((void*)params.src);
+  }
+}
+
+const iree_uk_benchmark_roofline_t* iree_uk_benchmark_roofline(void) {
+  return &s_iree_uk_benchmark_roofline;
+}
+
+void iree_uk_benchmark_report_roofline(iree_benchmark_state_t* state,
+                                       int64_t op_count, int64_t byte_count) {
+  const iree_uk_benchmark_roofline_t* roofline = &s_iree_uk_benchmark_roofline;
+  // Rate counters are divided by the elapsed time, so these are percentages
+  // of the peak rates.
+  double ops_pct = 100.0 * op_count / roofline->ops_per_second;
+  double bytes_pct = 100.0 * byte_count / roofline->bytes_per_second;
+  if (op_count > 0) {
+    iree_benchmark_set_rate_counter(state, "ops_peak_pct", ops_pct);
+  }
+  if (byte_count > 0) {
+    iree_benchmark_set_rate_counter(state, "bytes_peak_pct", bytes_pct);
+  }
+  // The attainable op rate is min(peak ops, intensity * peak bandwidth), so
+  // the share of it achieved is the larger of the two shares.
+  iree_benchmark_set_rate_counter(state, "roofline_pct",
+                                  iree_max(ops_pct, bytes_pct));
+}
+
 void iree_uk_benchmark_initialize(int* argc, char** argv) {
   // Maximum number of benchmarks that can be registered.
   int max_benchmarks = 256;
@@ -60,6 +190,15 @@ void iree_uk_benchmark_initialize(int* argc, char** argv) {
       malloc(s_iree_uk_benchmark_static_alloc_max * sizeof(void*));
 
   iree_benchmark_initialize(argc, argv);
+
+  iree_uk_benchmark_measure_roofline(&s_iree_uk_benchmark_roofline);
+  char value[64];
+  snprintf(value, sizeof value, "%.2f",
+           s_iree_uk_benchmark_roofline.ops_per_second * 1e-9);
+  iree_benchmark_add_context("roofline_peak_gops", value);
+  snprintf(value, sizeof value, "%.2f",
+           s_iree_uk_benchmark_roofline.bytes_per_second * 1e-9);
+  iree_benchmark_add_context("roofline_peak_gbps", value);
 }
 
 void iree_uk_benchmark_run_and_cleanup(void) {
@@ -13,7 +13,17 @@
 // Struct for passing around benchmark user data
 typedef struct iree_uk_benchmark_user_data_t iree_uk_benchmark_user_data_t;
 
+// Peak host throughput that benchmark results are reported against.
+typedef struct iree_uk_benchmark_roofline_t {
+  // Arithmetic operations per second, counting a multiply-add as 2 ops.
+  double ops_per_second;
+  // Bytes traversed (read plus written) per second by memcpy.
+  double bytes_per_second;
+} iree_uk_benchmark_roofline_t;
+
 // High level init/register/run/cleanup entry points. Used in main().
+// Initialization measures the roofline unless it is given by flags and adds it
+// to the benchmark context, so flags must have been parsed already.
 void iree_uk_benchmark_initialize(int* argc, char** argv);
 void iree_uk_benchmark_register(
     const char* name,
@@ -27,6 +37,25 @@ void iree_uk_benchmark_run_and_cleanup(void);
 // allocate buffers that will be accessed when the benchmark is run.
 void* iree_uk_benchmark_static_alloc(size_t size);
 
+// Returns the roofline measured by iree_uk_benchmark_initialize.
+const iree_uk_benchmark_roofline_t* iree_uk_benchmark_roofline(void);
+
+// Reports the share of the roofline achieved by a benchmark that performed
+// |op_count| arithmetic operations and traversed |byte_count| bytes in total
+// over all its iterations as the rate counters `ops_peak_pct`,
+// `bytes_peak_pct` and `roofline_pct`, the latter being the share of the
+// throughput attainable at the arithmetic intensity of the benchmark.
+// Must be called after the benchmark loop like
+// iree_benchmark_set_items_processed.
+void iree_uk_benchmark_report_roofline(iree_benchmark_state_t* state,
+                                       int64_t op_count, int64_t byte_count);
+
+// memcpy that is not inlined into the caller so that it is not optimized
+// away. Shared by the memcpy benchmark and the bandwidth roofline.
+void iree_uk_benchmark_memcpy_noinline(void* IREE_UK_RESTRICT dst,
+                                       const void* IREE_UK_RESTRICT src,
+                                       size_t size);
+
 // Accessors for iree_uk_benchmark_user_data_t. Used by benchmark payload funcs.
 const void* iree_uk_benchmark_params(
     const iree_uk_benchmark_user_data_t* user_data);
@@ -339,6 +339,17 @@ static iree_status_t iree_uk_benchmark_e2e_matmul(
   }
   iree_benchmark_set_items_processed(benchmark_state,
                                      total_iterations * 2 * num_mul_adds);
+  // Each pack reads a row-major buffer and writes a packed one, and the
+  // unpack does the reverse, in addition to the mmt4d traffic.
+  int64_t lhs_bytes = rowmajor_lhs_buffer_size + 2 * packed_lhs_buffer_size;
+  int64_t rhs_bytes = rowmajor_rhs_buffer_size + 2 * packed_rhs_buffer_size;
+  int64_t out_bytes = rowmajor_out_buffer_size + 2 * packed_out_buffer_size;
+  if (params->accumulate) {
+    out_bytes += rowmajor_out_buffer_size + 2 * packed_out_buffer_size;
+  }
+  iree_uk_benchmark_report_roofline(
+      benchmark_state, total_iterations * 2 * num_mul_adds,
+      total_iterations * (lhs_bytes + rhs_bytes + out_bytes));
 
   free(rowmajor_lhs_buffer);
   free(rowmajor_rhs_buffer);
@@ -0,0 +1,174 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/memcpy_benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(int64_t, batch_min_traversal_size, 10000000,
+          "Minimum number of bytes to be traversed in each batch.");
+
+IREE_FLAG(int64_t, working_set_size, 10000,
+          "Number of bytes to be traversed by the benchmark workload (input "
+          "and output buffers together). Buffer sizes are computed "
+          "accordingly.");
+
+IREE_FLAG(int32_t, stride1, 1,
+          "Stride between consecutive elements of a row. 1 takes the "
+          "contiguous fast paths of the ukernels.");
+
+typedef struct iree_uk_benchmark_elementwise_params_t {
+  // Exactly one of these is set.
+  iree_uk_x32u_2d_func_t unary_func;
+  iree_uk_x32b_2d_func_t binary_func;
+  // Whether the RHS values must be valid shift amounts.
+  bool rhs_is_shift;
+} iree_uk_benchmark_elementwise_params_t;
+
+// Writes floats in [1, 2) which are valid inputs to all the float ukernels and,
+// reinterpreted as integers, nonzero divisors.
+static void iree_uk_benchmark_elementwise_write_inputs(
+    iree_uk_uint32_t* buffer, iree_uk_ssize_t count, bool is_shift,
+    iree_uk_random_engine_t* engine) {
+  for (iree_uk_ssize_t i = 0; i < count; ++i) {
+    iree_uk_uint32_t r = iree_uk_random_engine_get_0_65535(engine);
+    buffer[i] = is_shift ? r % 32 : (0x3F800000u | (r << 7));
+  }
+}
+
+static iree_status_t iree_uk_benchmark_elementwise(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
+  const iree_uk_benchmark_elementwise_params_t* params =
+      iree_uk_benchmark_params(user_data);
+  bool is_binary = params->binary_func != NULL;
+  int operand_count = is_binary ? 3 : 2;
+
+  // Rows of 256 elements, as many as fit the working set.
+  iree_uk_ssize_t stride1 = iree_max(1, FLAG_stride1);
+  iree_uk_ssize_t size1 = 256;
+  iree_uk_ssize_t bytes_per_row =
+      operand_count * size1 * sizeof(iree_uk_uint32_t);
+  iree_uk_ssize_t size0 = iree_max(1, FLAG_working_set_size / bytes_per_row);
+  iree_uk_ssize_t stride0 = size1 * stride1;
+  iree_uk_ssize_t buffer_length = size0 * stride0;
+  iree_uk_uint32_t* lhs_buffer =
+      malloc(buffer_length * sizeof(iree_uk_uint32_t));
+  iree_uk_uint32_t* rhs_buffer =
+      malloc(buffer_length * sizeof(iree_uk_uint32_t));
+  iree_uk_uint32_t* out_buffer =
+      malloc(buffer_length * sizeof(iree_uk_uint32_t));
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_benchmark_elementwise_write_inputs(lhs_buffer, buffer_length,
+                                             /*is_shift=*/false, engine);
+  iree_uk_benchmark_elementwise_write_inputs(rhs_buffer, buffer_length,
+                                             params->rhs_is_shift, engine);
+
+  int64_t total_iterations = 0;
+  int64_t batch_count =
+      (FLAG_batch_min_traversal_size + FLAG_working_set_size - 1) /
+      FLAG_working_set_size;
+  while (iree_benchmark_keep_running(benchmark_state,
+                                     /*batch_count=*/batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      if (is_binary) {
+        params->binary_func(lhs_buffer, 0, stride0, stride1, rhs_buffer, 0,
+                            stride0, stride1, out_buffer, 0, stride0, stride1,
+                            size0, size1);
+      } else {
+        params->unary_func(lhs_buffer, 0, stride0, stride1, out_buffer, 0,
+                           stride0, stride1, size0, size1);
+      }
+    }
+    total_iterations += batch_count;
+  }
+  // One op per output element. Like the pack and memcpy benchmarks, bytes per
+  // second counts the bytes written.
+  int64_t element_count = total_iterations * size0 * size1;
+  iree_benchmark_set_items_processed(benchmark_state, element_count);
+  iree_benchmark_set_bytes_processed(benchmark_state,
+                                     element_count * sizeof(iree_uk_uint32_t));
+  iree_uk_benchmark_report_roofline(
+      benchmark_state, element_count,
+      element_count * operand_count * sizeof(iree_uk_uint32_t));
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_elementwise(
+    const char* opcode, const iree_uk_benchmark_elementwise_params_t* params) {
+  char name[128];
+  snprintf(name, sizeof name, "elementwise_%s_x32%s_wss_%" PRIi64, opcode,
+           params->binary_func ? "b" : "u", FLAG_working_set_size);
+  // The elementwise ukernels don't take cpu_data, so any
+  // architecture-specific code is baseline and there is no CPU feature to
+  // require.
+  iree_uk_benchmark_register(name, iree_uk_benchmark_elementwise, params,
+                             sizeof *params, /*cpu_features=*/NULL);
+}
+
+#define IREE_UK_BENCHMARK_UNARY(opcode)                            \
+  {#opcode,                                                        \
+   {.unary_func = iree_uk_x32u_##opcode##_2d, .binary_func = NULL, \
+    .rhs_is_shift = false}}
+#define IREE_UK_BENCHMARK_BINARY(opcode, is_shift)                 \
+  {#opcode,                                                        \
+   {.unary_func = NULL, .binary_func = iree_uk_x32b_##opcode##_2d, \
+    .rhs_is_shift = is_shift}}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("elementwise_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+  // The memcpy benchmark provides a useful comparison point, as most
+  // elementwise ops are memory-bound.
+  iree_uk_benchmark_register_memcpy(FLAG_working_set_size,
+                                    FLAG_batch_min_traversal_size);
+
+  static const struct {
+    const char* opcode;
+    iree_uk_benchmark_elementwise_params_t params;
+  } cases[] = {
+      IREE_UK_BENCHMARK_UNARY(absf),
+      IREE_UK_BENCHMARK_UNARY(ceilf),
+      IREE_UK_BENCHMARK_UNARY(ctlz),
+      IREE_UK_BENCHMARK_UNARY(expf),
+      IREE_UK_BENCHMARK_UNARY(floorf),
+      IREE_UK_BENCHMARK_UNARY(logf),
+      IREE_UK_BENCHMARK_UNARY(negf),
+      IREE_UK_BENCHMARK_UNARY(rsqrtf),
+      IREE_UK_BENCHMARK_BINARY(addf, false),
+      IREE_UK_BENCHMARK_BINARY(addi, false),
+      IREE_UK_BENCHMARK_BINARY(andi, false),
+      IREE_UK_BENCHMARK_BINARY(divf, false),
+      IREE_UK_BENCHMARK_BINARY(divsi, false),
+      IREE_UK_BENCHMARK_BINARY(divui, false),
+      IREE_UK_BENCHMARK_BINARY(mulf, false),
+      IREE_UK_BENCHMARK_BINARY(muli, false),
+      IREE_UK_BENCHMARK_BINARY(ori, false),
+      IREE_UK_BENCHMARK_BINARY(shli, true),
+      IREE_UK_BENCHMARK_BINARY(shrsi, true),
+      IREE_UK_BENCHMARK_BINARY(shrui, true),
+      IREE_UK_BENCHMARK_BINARY(subf, false),
+      IREE_UK_BENCHMARK_BINARY(subi, false),
+      IREE_UK_BENCHMARK_BINARY(xori, false),
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(cases); ++i) {
+    iree_uk_benchmark_register_elementwise(cases[i].opcode, &cases[i].params);
+  }
+
+  iree_uk_benchmark_run_and_cleanup();
+}
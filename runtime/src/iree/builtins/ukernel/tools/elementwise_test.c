@@ -0,0 +1,193 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// The elementwise ukernels have contiguous fast paths (and, for some unary
+// opcodes, architecture-specific vectorized code) taken when stride1 == 1 for
+// all operands, and per-element code otherwise. Each test runs both.
+
+typedef struct iree_uk_test_x32u_case_t {
+  const char* name;
+  iree_uk_x32u_2d_func_t func;
+  double (*reference)(double);
+  // Range of the random inputs.
+  float min, max;
+  // Relative tolerance.
+  float tolerance;
+} iree_uk_test_x32u_case_t;
+
+typedef struct iree_uk_test_x32b_case_t {
+  const char* name;
+  iree_uk_x32b_2d_func_t func;
+  iree_uk_uint32_t (*reference)(iree_uk_uint32_t, iree_uk_uint32_t);
+  // Whether the operands are floats, as opposed to integers.
+  bool is_float;
+} iree_uk_test_x32b_case_t;
+
+static double iree_uk_test_rsqrt(double x) { return 1 / sqrt(x); }
+
+static iree_uk_uint32_t iree_uk_test_f32_bits(float x) {
+  iree_uk_uint32_t bits;
+  memcpy(&bits, &x, sizeof bits);
+  return bits;
+}
+
+static float iree_uk_test_bits_f32(iree_uk_uint32_t bits) {
+  float x;
+  memcpy(&x, &bits, sizeof x);
+  return x;
+}
+
+static iree_uk_uint32_t iree_uk_test_addf(iree_uk_uint32_t a,
+                                          iree_uk_uint32_t b) {
+  return iree_uk_test_f32_bits(iree_uk_test_bits_f32(a) +
+                               iree_uk_test_bits_f32(b));
+}
+
+static iree_uk_uint32_t iree_uk_test_mulf(iree_uk_uint32_t a,
+                                          iree_uk_uint32_t b) {
+  return iree_uk_test_f32_bits(iree_uk_test_bits_f32(a) *
+                               iree_uk_test_bits_f32(b));
+}
+
+static iree_uk_uint32_t iree_uk_test_muli(iree_uk_uint32_t a,
+                                          iree_uk_uint32_t b) {
+  return a * b;
+}
+
+static iree_uk_uint32_t iree_uk_test_xori(iree_uk_uint32_t a,
+                                          iree_uk_uint32_t b) {
+  return a ^ b;
+}
+
+static iree_uk_uint32_t iree_uk_test_shli(iree_uk_uint32_t a,
+                                          iree_uk_uint32_t b) {
+  return a << b;
+}
+
+static float iree_uk_test_random_f32(iree_uk_random_engine_t* engine,
+                                     float min, float max) {
+  float u = iree_uk_random_engine_get_0_65535(engine) / 65536.f;
+  return min + u * (max - min);
+}
+
+static bool iree_uk_test_x32u_value_ok(const iree_uk_test_x32u_case_t* c,
+                                       float in, float actual) {
+  double expected = c->reference(in);
+  if (isnan(expected)) return isnan(actual);
+  if (isinf(expected)) return actual == expected;
+  return fabs(actual - expected) <= c->tolerance * fabs(expected) + 1e-37;
+}
+
+// Special values that the vectorized code handles with explicit masks.
+static const float iree_uk_test_special_values[] = {
+    0.f, -0.f, 1.f, -1.f, INFINITY, -INFINITY, NAN, 1e-30f, 1e30f, 80.f, -80.f,
+};
+
+static void iree_uk_test_x32u_for_case(iree_uk_test_t* test,
+                                       const void* src_params) {
+  const iree_uk_test_x32u_case_t* c = src_params;
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  enum { size0 = 3, size1 = 37, max_stride1 = 2 };
+  for (int stride1 = 1; stride1 <= max_stride1; ++stride1) {
+    iree_uk_ssize_t stride0 = size1 * stride1 + 1;
+    float in[size0 * (size1 * max_stride1 + 1)];
+    float out[size0 * (size1 * max_stride1 + 1)];
+    for (int i = 0; i < IREE_ARRAYSIZE(in); ++i) {
+      in[i] = iree_uk_test_random_f32(engine, c->min, c->max);
+    }
+    // Except for the range-limited rsqrt, also test special values.
+    if (c->min < 0.f || c->func == iree_uk_x32u_logf_2d) {
+      for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_test_special_values); ++i) {
+        in[i * stride1] = iree_uk_test_special_values[i];
+      }
+    }
+    int result = c->func((const iree_uk_uint32_t*)in, 0, stride0, stride1,
+                         (iree_uk_uint32_t*)out, 0, stride0, stride1, size0,
+                         size1);
+    if (result) IREE_UK_TEST_FAIL(test);
+    for (int i = 0; i < size0; ++i) {
+      for (int j = 0; j < size1; ++j) {
+        iree_uk_ssize_t k = i * stride0 + j * stride1;
+        if (!iree_uk_test_x32u_value_ok(c, in[k], out[k])) {
+          fprintf(stderr, "%s(%.9g): expected %.9g, actual %.9g\n", c->name,
+                  in[k], c->reference(in[k]), out[k]);
+          IREE_UK_TEST_FAIL(test);
+        }
+      }
+    }
+  }
+}
+
+static void iree_uk_test_x32b_for_case(iree_uk_test_t* test,
+                                       const void* src_params) {
+  const iree_uk_test_x32b_case_t* c = src_params;
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  enum { size0 = 3, size1 = 37, max_stride1 = 2 };
+  for (int stride1 = 1; stride1 <= max_stride1; ++stride1) {
+    iree_uk_ssize_t stride0 = size1 * stride1 + 1;
+    iree_uk_uint32_t lhs[size0 * (size1 * max_stride1 + 1)];
+    iree_uk_uint32_t rhs[size0 * (size1 * max_stride1 + 1)];
+    iree_uk_uint32_t out[size0 * (size1 * max_stride1 + 1)];
+    for (int i = 0; i < IREE_ARRAYSIZE(lhs); ++i) {
+      if (c->is_float) {
+        lhs[i] = iree_uk_test_f32_bits(
+            iree_uk_test_random_f32(engine, -100.f, 100.f));
+        rhs[i] = iree_uk_test_f32_bits(
+            iree_uk_test_random_f32(engine, -100.f, 100.f));
+      } else {
+        lhs[i] = iree_uk_random_engine_get_0_65535(engine);
+        // Keep the RHS small, to be a valid shift amount.
+        rhs[i] = iree_uk_random_engine_get_0_65535(engine) % 32;
+      }
+    }
+    int result = c->func(lhs, 0, stride0, stride1, rhs, 0, stride0, stride1,
+                         out, 0, stride0, stride1, size0, size1);
+    if (result) IREE_UK_TEST_FAIL(test);
+    for (int i = 0; i < size0; ++i) {
+      for (int j = 0; j < size1; ++j) {
+        iree_uk_ssize_t k = i * stride0 + j * stride1;
+        if (out[k] != c->reference(lhs[k], rhs[k])) {
+          IREE_UK_TEST_FAIL(test);
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  // The elementwise ukernels don't take cpu_data, so there is no CPU feature
+  // to enable here: any architecture-specific code is baseline.
+  const iree_uk_test_x32u_case_t x32u_cases[] = {
+      {"absf", iree_uk_x32u_absf_2d, fabs, -100.f, 100.f, 0.f},
+      {"expf", iree_uk_x32u_expf_2d, exp, -87.f, 88.f, 1e-6f},
+      {"logf", iree_uk_x32u_logf_2d, log, 1e-20f, 1e20f, 1e-6f},
+      {"logf near 1", iree_uk_x32u_logf_2d, log, 0.5f, 2.f, 1e-6f},
+      {"rsqrtf", iree_uk_x32u_rsqrtf_2d, iree_uk_test_rsqrt, 1e-20f, 1e20f,
+       1e-6f},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(x32u_cases); ++i) {
+    iree_uk_test(x32u_cases[i].name, iree_uk_test_x32u_for_case,
+                 &x32u_cases[i], NULL);
+  }
+  const iree_uk_test_x32b_case_t x32b_cases[] = {
+      {"addf", iree_uk_x32b_addf_2d, iree_uk_test_addf, true},
+      {"mulf", iree_uk_x32b_mulf_2d, iree_uk_test_mulf, true},
+      {"muli", iree_uk_x32b_muli_2d, iree_uk_test_muli, false},
+      {"xori", iree_uk_x32b_xori_2d, iree_uk_test_xori, false},
+      {"shli", iree_uk_x32b_shli_2d, iree_uk_test_shli, false},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(x32b_cases); ++i) {
+    iree_uk_test(x32b_cases[i].name, iree_uk_test_x32b_for_case,
+                 &x32b_cases[i], NULL);
+  }
+}
@@ -11,11 +11,6 @@
 #include "iree/base/api.h"
 #include "iree/builtins/ukernel/tools/benchmark.h"
 
-IREE_UK_ATTRIBUTE_NOINLINE static void iree_memcpy_noinline(
-    void* restrict dst, const void* restrict src, size_t size) {
-  memcpy(dst, src, size);
-}
-
 typedef struct iree_uk_benchmark_memcpy_user_data_t {
   int64_t working_set_size;
   int64_t batch_min_traversal_size;
@@ -38,15 +33,18 @@ static iree_status_t iree_uk_benchmark_memcpy(
   while (iree_benchmark_keep_running(benchmark_state,
                                      /*batch_count=*/batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
-      iree_memcpy_noinline(out_buffer, in_buffer, buffer_size);
+      iree_uk_benchmark_memcpy_noinline(out_buffer, in_buffer, buffer_size);
     }
     total_iterations += batch_count;
   }
   // Report bytes per second, so that can be easily compared to known memory
   // system performance metrics (e.g. RAM bandwidth, to tell whether this is
-  // memory-bound).
-  iree_benchmark_set_items_processed(benchmark_state,
+  // memory-bound) and between the pack, unpack and memcpy benchmarks, which
+  // all count the bytes written.
+  iree_benchmark_set_bytes_processed(benchmark_state,
                                      total_iterations * buffer_size);
+  iree_uk_benchmark_report_roofline(benchmark_state, /*op_count=*/0,
+                                    total_iterations * 2 * buffer_size);
   assert(!memcmp(in_buffer, out_buffer, buffer_size));
   free(in_buffer);
   free(out_buffer);
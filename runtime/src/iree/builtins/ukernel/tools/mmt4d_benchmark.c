@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <ctype.h>
+#include <inttypes.h>
 #include <stdio.h>
 
 #include "iree/base/api.h"
@@ -11,6 +13,7 @@
 #include "iree/builtins/ukernel/api.h"
 #include "iree/builtins/ukernel/tools/benchmark.h"
 #include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
 
 IREE_FLAG(int32_t, batch_count, 1000, "Ops to run per benchmark iteration.");
 IREE_FLAG(int32_t, m_size, 1,
@@ -26,6 +29,20 @@ IREE_FLAG(
 IREE_FLAG(bool, accumulate, false,
           "Whether the kernel should accumulate into the existing accumulator "
           "tile values, or zero the accumulator tile.");
+IREE_FLAG(bool, autotune, false,
+          "Instead of running benchmarks, time all the tile shapes supported "
+          "on the host CPU for each operation and print, for each operation "
+          "where the fastest one differs from the default, an entry to paste "
+          "into iree/builtins/ukernel/tuned_tile_sizes.inl.");
+IREE_FLAG(string, autotune_llvm_cpu, "host",
+          "LLVM target cpu name for the host CPU to print in --autotune "
+          "entries, e.g. znver4 or neoverse-v1.");
+IREE_FLAG(int32_t, autotune_matmul_size, 512,
+          "Size of the square matmuls timed by --autotune, before rounding up "
+          "to a multiple of the tile shape.");
+IREE_FLAG(int32_t, autotune_min_time_ms, 200,
+          "Minimum time in milliseconds to spend timing each tile shape in "
+          "--autotune.");
 
 static iree_status_t iree_uk_benchmark_mmt4d(
     const iree_benchmark_def_t* benchmark_def,
@@ -74,15 +91,53 @@ static iree_status_t iree_uk_benchmark_mmt4d(
     }
     total_iterations += FLAG_batch_count;
   }
-  iree_benchmark_set_items_processed(
-      benchmark_state, total_iterations * 2 * params.M * params.N * params.K *
-                           params.M0 * params.N0 * params.K0);
+  int64_t op_count = total_iterations * 2 * params.M * params.N * params.K *
+                     params.M0 * params.N0 * params.K0;
+  iree_benchmark_set_items_processed(benchmark_state, op_count);
+  // The accumulator is read as well as written when accumulating.
+  int64_t byte_count =
+      total_iterations * (lhs_buffer_size + rhs_buffer_size +
+                          (FLAG_accumulate ? 2 : 1) * out_buffer_size);
+  iree_benchmark_set_bytes_processed(benchmark_state, byte_count);
+  iree_uk_benchmark_report_roofline(benchmark_state, op_count, byte_count);
   free(lhs_buffer);
   free(rhs_buffer);
   free(out_buffer);
   return iree_ok_status();
 }
 
+typedef struct iree_uk_mmt4d_benchmark_tile_t {
+  iree_uk_mmt4d_type_t type;
+  int M0, N0, K0;
+  const char* cpu_features;
+} iree_uk_mmt4d_benchmark_tile_t;
+
+// Tile shapes to benchmark, and to consider in --autotune. A NULL cpu_features
+// means the architecture baseline.
+static const iree_uk_mmt4d_benchmark_tile_t iree_uk_mmt4d_benchmark_tiles[] = {
+#if defined(IREE_UK_ARCH_ARM_64)
+    {iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL},
+    {iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, NULL},
+    {iree_uk_mmt4d_type_i8i8i32, 8, 8, 4, "dotprod"},
+    {iree_uk_mmt4d_type_i8i8i32, 8, 8, 8, "i8mm"},
+#elif defined(IREE_UK_ARCH_X86_64)
+    {iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, "avx2_fma"},
+    {iree_uk_mmt4d_type_f32f32f32, 16, 16, 1, "avx512_base"},
+    {iree_uk_mmt4d_type_i8i8i32, 8, 8, 2, "avx2_fma"},
+    {iree_uk_mmt4d_type_i8i8i32, 16, 16, 2, "avx512_base"},
+    {iree_uk_mmt4d_type_i8i8i32, 16, 16, 2, "avx512_vnni"},
+    {iree_uk_mmt4d_type_i8i8i32, 16, 16, 4, "amx_int8"},
+    {iree_uk_mmt4d_type_f16f16f32, 16, 16, 1, "avx512_base"},
+    {iree_uk_mmt4d_type_bf16bf16f32, 16, 16, 2, "avx512_bf16"},
+    {iree_uk_mmt4d_type_bf16bf16f32, 16, 16, 2, "amx_bf16"},
+#else   // defined(IREE_UK_ARCH_ARM_64)
+    // Architectures on which we do not have any optimized ukernel code.
+    // Benchmark some arbitrary tile shape.
+    {iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL},
+    {iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, NULL},
+#endif  // defined(IREE_UK_ARCH_ARM_64)
+};
+
 static void iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_t type, int M0,
                                              int N0, int K0,
                                              const char* cpu_features) {
@@ -95,35 +150,171 @@ static void iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_t type, int M0,
                              sizeof params, cpu_features);
 }
 
+static iree_uk_uint32_t iree_uk_mmt4d_autotune_operation(
+    iree_uk_mmt4d_type_t type) {
+  switch (type) {
+    case iree_uk_mmt4d_type_f32f32f32:
+      return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32;
+    case iree_uk_mmt4d_type_i8i8i32:
+      return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32;
+    case iree_uk_mmt4d_type_f16f16f32:
+      return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32;
+    case iree_uk_mmt4d_type_bf16bf16f32:
+      return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32;
+    default:
+      IREE_UK_ASSERT(false && "unhandled type");
+      return 0;
+  }
+}
+
+// Returns the time in nanoseconds per multiply-add of a
+// --autotune_matmul_size square matmul with the given tile shape.
+static double iree_uk_mmt4d_autotune_time_tile(
+    const iree_uk_mmt4d_benchmark_tile_t* tile) {
+  iree_uk_mmt4d_params_t params = {
+      .type = tile->type, .M0 = tile->M0, .N0 = tile->N0, .K0 = tile->K0};
+  iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT] = {0};
+  if (tile->cpu_features) {
+    iree_uk_make_cpu_data_for_features(tile->cpu_features, cpu_data);
+  }
+  params.cpu_data = cpu_data;
+  int size = FLAG_autotune_matmul_size;
+  params.M = (size + params.M0 - 1) / params.M0;
+  params.N = (size + params.N0 - 1) / params.N0;
+  params.K = (size + params.K0 - 1) / params.K0;
+  params.lhs_stride = params.K * params.M0 * params.K0;
+  params.rhs_stride = params.K * params.N0 * params.K0;
+  params.out_stride = params.N * params.M0 * params.N0;
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params.type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params.type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params.type);
+  iree_uk_ssize_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride);
+  iree_uk_ssize_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride);
+  iree_uk_ssize_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, &engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, &engine);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+  // Warm up, then double the iteration count until the minimum time is met.
+  iree_uk_mmt4d(&params);
+  iree_time_t min_time_ns = FLAG_autotune_min_time_ms * 1000000ll;
+  iree_time_t elapsed_ns = 0;
+  int64_t iterations = 1;
+  while (true) {
+    iree_time_t start_ns = iree_time_now();
+    for (int64_t i = 0; i < iterations; ++i) iree_uk_mmt4d(&params);
+    elapsed_ns = iree_time_now() - start_ns;
+    if (elapsed_ns >= min_time_ns) break;
+    iterations *= 2;
+  }
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  double madds = (double)iterations * params.M * params.N * params.K *
+                 params.M0 * params.N0 * params.K0;
+  return elapsed_ns / madds;
+}
+
+static int iree_uk_mmt4d_autotune(void) {
+  iree_uk_uint64_t host_cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  iree_uk_make_cpu_data_for_features("host", host_cpu_data);
+  iree_uk_uint64_t cpu_model = host_cpu_data[1];
+  if (!cpu_model) {
+    fprintf(stderr, "Unknown host CPU model, can't autotune.\n");
+    return EXIT_FAILURE;
+  }
+  // The default tile sizes are what the query would return without any tuned
+  // entry for this CPU model.
+  iree_uk_uint64_t default_cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  memcpy(default_cpu_data, host_cpu_data, sizeof default_cpu_data);
+  default_cpu_data[1] = 0;
+  const int tile_count = IREE_ARRAYSIZE(iree_uk_mmt4d_benchmark_tiles);
+  bool done[IREE_ARRAYSIZE(iree_uk_mmt4d_benchmark_tiles)] = {0};
+  for (int i = 0; i < tile_count; ++i) {
+    if (done[i]) continue;
+    iree_uk_mmt4d_type_t type = iree_uk_mmt4d_benchmark_tiles[i].type;
+    const iree_uk_mmt4d_benchmark_tile_t* best = 0;
+    double best_time = 0;
+    for (int j = i; j < tile_count; ++j) {
+      const iree_uk_mmt4d_benchmark_tile_t* tile =
+          &iree_uk_mmt4d_benchmark_tiles[j];
+      if (tile->type != type) continue;
+      done[j] = true;
+      if (tile->cpu_features) {
+        iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+        iree_uk_make_cpu_data_for_features(tile->cpu_features, cpu_data);
+        if (!iree_uk_cpu_supports(cpu_data)) continue;
+      }
+      double time = iree_uk_mmt4d_autotune_time_tile(tile);
+      char type_str[32];
+      iree_uk_type_triple_str(type_str, sizeof type_str, type);
+      fprintf(stderr, "%s %dx%dx%d %s: %.4f ns/madd\n", type_str, tile->M0,
+              tile->N0, tile->K0,
+              tile->cpu_features ? tile->cpu_features : "baseline", time);
+      if (!best || time < best_time) {
+        best = tile;
+        best_time = time;
+      }
+    }
+    if (!best) continue;
+    iree_uk_uint32_t operation = iree_uk_mmt4d_autotune_operation(type);
+    iree_uk_query_tile_sizes_2d_params_t query_params = {
+        .size0 = IREE_UK_INT64_MIN,
+        .size1 = IREE_UK_INT64_MIN,
+        .cpu_data = default_cpu_data,
+    };
+    iree_uk_query_tile_sizes_2d_out_params_t lhs_tile, result_tile;
+    query_params.flags =
+        operation | IREE_UK_FLAG_QUERY_TILE_SIZES_OPERAND_ROLE_LHS;
+    iree_uk_query_tile_sizes_2d(&query_params, &lhs_tile);
+    query_params.flags =
+        operation | IREE_UK_FLAG_QUERY_TILE_SIZES_OPERAND_ROLE_RESULT;
+    iree_uk_query_tile_sizes_2d(&query_params, &result_tile);
+    if (lhs_tile.tile_size0 == best->M0 && lhs_tile.tile_size1 == best->K0 &&
+        result_tile.tile_size1 == best->N0) {
+      continue;
+    }
+    char operation_str[32];
+    iree_uk_type_triple_str(operation_str, sizeof operation_str, type);
+    for (char* c = operation_str; *c; ++c) *c = toupper(*c);
+    printf("IREE_UK_TUNED_MATMUL_TILE_SIZES_%s(0x%" PRIx64
+           ", \"%s\", MATMUL_%s, %s, %d, %d, %d)\n",
+#if defined(IREE_UK_ARCH_ARM_64)
+           "ARM_64",
+#else
+           "X86_64",
+#endif  // defined(IREE_UK_ARCH_ARM_64)
+           (uint64_t)cpu_model, FLAG_autotune_llvm_cpu, operation_str,
+           best->cpu_features ? best->cpu_features : "baseline", best->M0,
+           best->K0, best->N0);
+  }
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv) {
   iree_flags_set_usage("mmt4d_benchmark", "");
 
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  if (FLAG_autotune) {
+    iree_uk_initialize_cpu_once();
+    return iree_uk_mmt4d_autotune();
+  }
   iree_uk_benchmark_initialize(&argc, argv);
 
-#if defined(IREE_UK_ARCH_ARM_64)
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL);
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, NULL);
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 4,
-                                   "dotprod");
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 8, "i8mm");
-#elif defined(IREE_UK_ARCH_X86_64)
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1,
-                                   "avx2_fma");
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_f32f32f32, 16, 16, 1,
-                                   "avx512_base");
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 2,
-                                   "avx2_fma");
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2,
-                                   "avx512_base");
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2,
-                                   "avx512_vnni");
-#else  // defined(IREE_UK_ARCH_ARM_64)
-  // Architectures on which we do not have any optimized ukernel code.
-  // Benchmark some arbitrary tile shape.
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL);
-  iree_uk_benchmark_register_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, NULL);
-#endif  // defined(IREE_UK_ARCH_ARM_64)
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_mmt4d_benchmark_tiles); ++i) {
+    const iree_uk_mmt4d_benchmark_tile_t* tile =
+        &iree_uk_mmt4d_benchmark_tiles[i];
+    iree_uk_benchmark_register_mmt4d(tile->type, tile->M0, tile->N0, tile->K0,
+                                     tile->cpu_features);
+  }
 
   iree_uk_benchmark_run_and_cleanup();
 }
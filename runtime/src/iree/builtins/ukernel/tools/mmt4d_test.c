@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <math.h>
+
 #include "iree/base/api.h"
 #include "iree/builtins/ukernel/api.h"
 #include "iree/builtins/ukernel/tools/test.h"
@@ -37,11 +39,96 @@ static void iree_mmt4d_reference_innerloop_i8i8i32(
   *out_ptr = acc;
 }
 
+// The RHS is nibble-packed, so it is addressed by element index |rhs_offset|.
+static void iree_mmt4d_reference_innerloop_i8i4i32(
+    int32_t* out_ptr, const int8_t* lhs_ptr, const void* rhs_buffer,
+    iree_uk_ssize_t rhs_offset, const iree_uk_mmt4d_params_t* params) {
+  int32_t acc = params->flags & IREE_UK_FLAG_ACCUMULATE ? *out_ptr : 0;
+  for (iree_uk_ssize_t k = 0; k < params->K; ++k) {
+    for (iree_uk_ssize_t k0 = 0; k0 < params->K0; ++k0) {
+      int32_t lhs_val = lhs_ptr[k * params->M0 * params->K0 + k0];
+      int32_t rhs_val = iree_uk_sign_extend_nibble(iree_uk_load_nibble(
+          rhs_buffer, rhs_offset + k * params->N0 * params->K0 + k0));
+      acc += lhs_val * rhs_val;
+    }
+  }
+  *out_ptr = acc;
+}
+
+// |scales| and |zero_points| point to the values for the current RHS row, for
+// the first group, so consecutive groups are N0 values apart.
+static void iree_mmt4d_reference_innerloop_f32u4f32(
+    float* out_ptr, const float* lhs_ptr, const void* rhs_buffer,
+    iree_uk_ssize_t rhs_offset, const float* scales, const float* zero_points,
+    const iree_uk_mmt4d_params_t* params) {
+  float acc = params->flags & IREE_UK_FLAG_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_ssize_t k = 0; k < params->K; ++k) {
+    iree_uk_ssize_t group = k / params->rhs_group_size;
+    float scale = scales[group * params->N0];
+    float zero_point = zero_points[group * params->N0];
+    for (iree_uk_ssize_t k0 = 0; k0 < params->K0; ++k0) {
+      float lhs_val = lhs_ptr[k * params->M0 * params->K0 + k0];
+      float rhs_quantized = iree_uk_load_nibble(
+          rhs_buffer, rhs_offset + k * params->N0 * params->K0 + k0);
+      float rhs_val = (rhs_quantized - zero_point) * scale;
+      acc += lhs_val * rhs_val;
+    }
+  }
+  *out_ptr = acc;
+}
+
+// Reference for the 16-bit floating-point input types (f16 and bf16). Like the
+// actual ukernels, accumulates in f32 and rounds to the output type (if 16-bit)
+// only once, at the end.
+static float iree_mmt4d_reference_load_float(const void* ptr,
+                                             iree_uk_ssize_t i,
+                                             iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_uk_f16_to_f32(((const uint16_t*)ptr)[i]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_uk_bf16_to_f32(((const uint16_t*)ptr)[i]);
+    default:
+      return ((const float*)ptr)[i];
+  }
+}
+
+static void iree_mmt4d_reference_innerloop_f16_bf16(
+    void* out_ptr, const void* lhs_ptr, const void* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params->type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params->type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params->type);
+  float acc = params->flags & IREE_UK_FLAG_ACCUMULATE
+                  ? iree_mmt4d_reference_load_float(out_ptr, 0, out_type)
+                  : 0.f;
+  for (iree_uk_ssize_t k = 0; k < params->K; ++k) {
+    for (iree_uk_ssize_t k0 = 0; k0 < params->K0; ++k0) {
+      float lhs_val = iree_mmt4d_reference_load_float(
+          lhs_ptr, k * params->M0 * params->K0 + k0, lhs_type);
+      float rhs_val = iree_mmt4d_reference_load_float(
+          rhs_ptr, k * params->N0 * params->K0 + k0, rhs_type);
+      acc += lhs_val * rhs_val;
+    }
+  }
+  switch (out_type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      *(uint16_t*)out_ptr = iree_uk_f32_to_f16(acc);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      *(uint16_t*)out_ptr = iree_uk_f32_to_bf16(acc);
+      break;
+    default:
+      *(float*)out_ptr = acc;
+  }
+}
+
 static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   iree_uk_ssize_t lhs_elem_size =
       iree_uk_type_size(iree_uk_mmt4d_lhs_type(params->type));
-  iree_uk_ssize_t rhs_elem_size =
-      iree_uk_type_size(iree_uk_mmt4d_rhs_type(params->type));
+  // The RHS may be a sub-byte type, so it is addressed in bits.
+  iree_uk_ssize_t rhs_elem_bits =
+      iree_uk_type_bit_count(iree_uk_mmt4d_rhs_type(params->type));
   iree_uk_ssize_t out_elem_size =
       iree_uk_type_size(iree_uk_mmt4d_out_type(params->type));
   for (iree_uk_ssize_t i = 0; i < params->M; ++i) {
@@ -52,16 +139,20 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
               out_elem_size;
       const void* lhs_panel_ptr = ((const char*)params->lhs_buffer) +
                                   i * params->lhs_stride * lhs_elem_size;
-      const void* rhs_panel_ptr = ((const char*)params->rhs_buffer) +
-                                  j * params->rhs_stride * rhs_elem_size;
+      const float* scales_ptr = (const float*)params->rhs_scales_buffer +
+                                j * params->rhs_scales_stride;
+      const float* zero_points_ptr =
+          (const float*)params->rhs_zero_points_buffer +
+          j * params->rhs_scales_stride;
       for (iree_uk_ssize_t i0 = 0; i0 < params->M0; ++i0) {
         for (iree_uk_ssize_t j0 = 0; j0 < params->N0; ++j0) {
           void* out_ptr =
               ((char*)out_tile_ptr) + (i0 * params->N0 + j0) * out_elem_size;
           const void* lhs_ptr =
               ((char*)lhs_panel_ptr) + i0 * params->K0 * lhs_elem_size;
-          const void* rhs_ptr =
-              ((char*)rhs_panel_ptr) + j0 * params->K0 * rhs_elem_size;
+          iree_uk_ssize_t rhs_offset = j * params->rhs_stride + j0 * params->K0;
+          const void* rhs_ptr = ((const char*)params->rhs_buffer) +
+                                rhs_offset * rhs_elem_bits / 8;
           switch (params->type) {
             case iree_uk_mmt4d_type_f32f32f32:
               iree_mmt4d_reference_innerloop_f32f32f32(
@@ -73,6 +164,23 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
                   (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
                   (const int8_t*)rhs_ptr, params);
               break;
+            case iree_uk_mmt4d_type_i8i4i32:
+              iree_mmt4d_reference_innerloop_i8i4i32(
+                  (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
+                  params->rhs_buffer, rhs_offset, params);
+              break;
+            case iree_uk_mmt4d_type_f32u4f32:
+              iree_mmt4d_reference_innerloop_f32u4f32(
+                  (float*)out_ptr, (const float*)lhs_ptr, params->rhs_buffer,
+                  rhs_offset, scales_ptr + j0, zero_points_ptr + j0, params);
+              break;
+            case iree_uk_mmt4d_type_f16f16f32:
+            case iree_uk_mmt4d_type_f16f16f16:
+            case iree_uk_mmt4d_type_bf16bf16f32:
+            case iree_uk_mmt4d_type_bf16bf16bf16:
+              iree_mmt4d_reference_innerloop_f16_bf16(out_ptr, lhs_ptr,
+                                                      rhs_ptr, params);
+              break;
             default:
               IREE_UK_ASSERT(false && "unhandled type");
           }
@@ -83,6 +191,56 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   }
 }
 
+// Applies the epilogue requested by params->flags to the accumulators in
+// |acc_buffer|, laid out like the output but always of a 32-bit type, writing
+// the results to params->out_buffer.
+static void iree_mmt4d_reference_epilogue(
+    const void* acc_buffer, const iree_uk_mmt4d_params_t* params) {
+  uint32_t activation =
+      params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL;
+  bool is_float =
+      iree_uk_mmt4d_out_type(params->type) == IREE_UK_TYPE_FLOAT_32;
+  bool has_bias = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+  bool requantize = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  for (iree_uk_ssize_t i = 0; i < params->M; ++i) {
+    for (iree_uk_ssize_t j = 0; j < params->N; ++j) {
+      for (iree_uk_ssize_t i0 = 0; i0 < params->M0; ++i0) {
+        for (iree_uk_ssize_t j0 = 0; j0 < params->N0; ++j0) {
+          iree_uk_ssize_t index = i * params->out_stride +
+                                  (j * params->M0 + i0) * params->N0 + j0;
+          iree_uk_ssize_t bias_index = j * params->N0 + j0;
+          if (is_float) {
+            float v = ((const float*)acc_buffer)[index];
+            if (has_bias) v += ((const float*)params->bias_buffer)[bias_index];
+            if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU) {
+              v = v > 0.f ? v : 0.f;
+            } else if (activation ==
+                       IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU) {
+              float inner = 0.797884560802865f * (v + 0.044715f * v * v * v);
+              v = 0.5f * v * (1.f + tanhf(inner));
+            }
+            ((float*)params->out_buffer)[index] = v;
+            continue;
+          }
+          int32_t v = ((const int32_t*)acc_buffer)[index];
+          if (has_bias) v += ((const int32_t*)params->bias_buffer)[bias_index];
+          if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU) {
+            v = v > 0 ? v : 0;
+          }
+          if (requantize) {
+            float r = nearbyintf(v * params->requantize_scale) +
+                      params->requantize_zero_point;
+            r = r < -128.f ? -128.f : r > 127.f ? 127.f : r;
+            ((int8_t*)params->out_buffer)[index] = (int8_t)r;
+          } else {
+            ((int32_t*)params->out_buffer)[index] = v;
+          }
+        }
+      }
+    }
+  }
+}
+
 static void iree_uk_test_mmt4d_for_shape_params(
     iree_uk_test_t* test, const iree_uk_mmt4d_params_t* src_params) {
   iree_uk_mmt4d_params_t params;
@@ -92,12 +250,15 @@ static void iree_uk_test_mmt4d_for_shape_params(
   iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
   params.lhs_stride =
       params.K * params.M0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  // Sub-byte RHS types need padding by a whole number of bytes.
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params.type);
+  int rhs_stride_padding = iree_uk_type_bit_count(rhs_type) < 8 ? 2 : 1;
   params.rhs_stride =
-      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+      params.K * params.N0 * params.K0 +
+      rhs_stride_padding * iree_uk_random_engine_get_0_1(engine);
   params.out_stride =
       params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
   iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(params.type);
-  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(params.type);
   iree_uk_ssize_t lhs_buffer_size =
       iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride);
   iree_uk_ssize_t rhs_buffer_size =
@@ -106,12 +267,68 @@ static void iree_uk_test_mmt4d_for_shape_params(
   void* rhs_buffer = malloc(rhs_buffer_size);
   iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
   iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  if (params.flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES) {
+    // Zero random RHS tiles, exercising runs of zero and nonzero tiles.
+    iree_uk_ssize_t rhs_tile_size =
+        iree_uk_type_size_of_count(rhs_type, params.N0 * params.K0);
+    for (iree_uk_ssize_t j = 0; j < params.N; ++j) {
+      char* rhs_panel =
+          (char*)rhs_buffer +
+          iree_uk_type_size_of_count(rhs_type, j * params.rhs_stride);
+      for (iree_uk_ssize_t k = 0; k < params.K; ++k) {
+        if (iree_uk_random_engine_get_0_1(engine)) {
+          memset(rhs_panel + k * rhs_tile_size, 0, rhs_tile_size);
+        }
+      }
+    }
+  }
   params.lhs_buffer = lhs_buffer;
   params.rhs_buffer = rhs_buffer;
+  float* rhs_scales_buffer = NULL;
+  float* rhs_zero_points_buffer = NULL;
+  if (iree_uk_mmt4d_rhs_is_quantized(params.type)) {
+    // Random group sizes, exercising K not being a multiple of them. Scales are
+    // powers of two and zero-points small integers, keeping arithmetic exact.
+    params.rhs_group_size = 1 + iree_uk_random_engine_get_0_65535(engine) % 8;
+    iree_uk_ssize_t num_groups =
+        (params.K + params.rhs_group_size - 1) / params.rhs_group_size;
+    params.rhs_scales_stride =
+        num_groups * params.N0 + iree_uk_random_engine_get_0_1(engine);
+    iree_uk_ssize_t scales_count = params.N * params.rhs_scales_stride;
+    rhs_scales_buffer = malloc(scales_count * sizeof(float) + 1);
+    rhs_zero_points_buffer = malloc(scales_count * sizeof(float) + 1);
+    for (iree_uk_ssize_t i = 0; i < scales_count; ++i) {
+      rhs_scales_buffer[i] =
+          0.5f * (1 << (iree_uk_random_engine_get_0_65535(engine) % 3));
+      rhs_zero_points_buffer[i] =
+          iree_uk_random_engine_get_0_65535(engine) % 16;
+    }
+    params.rhs_scales_buffer = rhs_scales_buffer;
+    params.rhs_zero_points_buffer = rhs_zero_points_buffer;
+  }
+
+  void* bias_buffer = NULL;
+  iree_uk_type_t acc_type = iree_uk_mmt4d_out_type(params.type);
+  if (params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS) {
+    iree_uk_ssize_t bias_buffer_size =
+        iree_uk_2d_buffer_length(acc_type, params.N, params.N0);
+    bias_buffer = malloc(bias_buffer_size);
+    iree_uk_write_random_buffer(bias_buffer, bias_buffer_size, acc_type,
+                                engine);
+    params.bias_buffer = bias_buffer;
+  }
+  bool requantize = params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  if (requantize) {
+    // Power-of-two scales keep the products exact, and exercise rounding ties.
+    params.requantize_scale =
+        1.f / (1 << (iree_uk_random_engine_get_0_65535(engine) % 8));
+    params.requantize_zero_point =
+        iree_uk_random_engine_get_0_65535(engine) % 32 - 16;
+  }
 
   iree_uk_mmt4d_params_t reference_params;
   memcpy(&reference_params, &params, sizeof params);
-  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(params.type);
+  iree_uk_type_t out_type = requantize ? IREE_UK_TYPE_INT_8 : acc_type;
   iree_uk_ssize_t out_buffer_size =
       iree_uk_2d_buffer_length(out_type, params.M, params.out_stride);
   reference_params.out_buffer = malloc(out_buffer_size);
@@ -124,9 +341,39 @@ static void iree_uk_test_mmt4d_for_shape_params(
   memcpy(actual_params.out_buffer, reference_params.out_buffer,
          out_buffer_size);
 
-  iree_mmt4d_reference(&reference_params);
+  if (params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_MASK_INTERNAL) {
+    // Compute the accumulators, then the epilogue. When requantizing, the
+    // accumulators need a separate buffer as the output is narrower.
+    iree_uk_mmt4d_params_t acc_params;
+    memcpy(&acc_params, &reference_params, sizeof acc_params);
+    if (requantize) {
+      acc_params.out_buffer = malloc(
+          iree_uk_2d_buffer_length(acc_type, params.M, params.out_stride));
+    }
+    iree_mmt4d_reference(&acc_params);
+    iree_mmt4d_reference_epilogue(acc_params.out_buffer, &reference_params);
+    if (requantize) free(acc_params.out_buffer);
+  } else {
+    iree_mmt4d_reference(&reference_params);
+  }
   iree_uk_mmt4d(&actual_params);
 
+  // GELU is approximated differently in the ukernel and in the reference, so
+  // that case is compared with a tolerance.
+  if ((params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL) ==
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU) {
+    const float* actual = actual_params.out_buffer;
+    const float* reference = reference_params.out_buffer;
+    for (iree_uk_ssize_t i = 0; i < out_buffer_size / sizeof(float); ++i) {
+      if (!(fabsf(actual[i] - reference[i]) <=
+            1e-5f * (1.f + fabsf(reference[i])))) {
+        IREE_UK_TEST_FAIL(test);
+        break;
+      }
+    }
+    goto cleanup;
+  }
+
   // For now we use exact comparisons, even for float, even though the reference
   // code accumulates in a different order compared to the actual code. This
   // relies on picking input test matrix elements so that all intermediate
@@ -139,10 +386,14 @@ static void iree_uk_test_mmt4d_for_shape_params(
     IREE_UK_TEST_FAIL(test);
   }
 
+cleanup:
   free(reference_params.out_buffer);
   free(actual_params.out_buffer);
   free(lhs_buffer);
   free(rhs_buffer);
+  free(rhs_scales_buffer);
+  free(rhs_zero_points_buffer);
+  free(bias_buffer);
 }
 
 static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
@@ -179,23 +430,157 @@ static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
     params.M = shape.m;
     params.N = shape.n;
     params.K = shape.k;
-    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
-      params.flags = accumulate ? IREE_UK_FLAG_ACCUMULATE : 0;
+    // The epilogue flags, if any, come from src_params. The i8 output of a
+    // requantizing epilogue can't be accumulated into.
+    iree_uk_uint32_t epilogue_flags =
+        ((const iree_uk_mmt4d_params_t*)src_params)->flags;
+    int max_accumulate =
+        epilogue_flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE ? 0 : 1;
+    for (int accumulate = 0; accumulate <= max_accumulate; ++accumulate) {
+      params.flags =
+          epilogue_flags | (accumulate ? IREE_UK_FLAG_ACCUMULATE : 0);
       iree_uk_test_mmt4d_for_shape_params(test, &params);
     }
   }
 }
 
+static void iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_t type,
+                                             int M0, int N0, int K0,
+                                             iree_uk_uint32_t epilogue_flags,
+                                             const char* cpu_features) {
+  iree_uk_mmt4d_params_t params = {
+      .type = type, .flags = epilogue_flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str, type);
+  uint32_t activation =
+      epilogue_flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK_INTERNAL;
+  char epilogue_str[64] = "";
+  if (epilogue_flags) {
+    snprintf(epilogue_str, sizeof epilogue_str, " epilogue:%s%s%s%s",
+             epilogue_flags & IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES
+                 ? "skip-zero-rhs-tiles,"
+                 : "",
+             epilogue_flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS ? "bias," : "",
+             activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU ? "relu,"
+             : activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU
+                 ? "gelu,"
+                 : "",
+             epilogue_flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE
+                 ? "requantize,"
+                 : "");
+    // Drop the trailing comma.
+    epilogue_str[strlen(epilogue_str) - 1] = 0;
+  }
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%dx%d%s",
+           types_str, M0, N0, K0, epilogue_str);
+  iree_uk_test(test_label_str, iree_uk_test_mmt4d_for_tile_params, &params,
+               cpu_features);
+}
+
 static void iree_uk_test_mmt4d(iree_uk_mmt4d_type_t type, int M0, int N0,
                                int K0, const char* cpu_features) {
+  iree_uk_test_mmt4d_with_epilogue(type, M0, N0, K0, 0, cpu_features);
+}
+
+static void iree_uk_test_batch_mmt4d_for_tile_params(iree_uk_test_t* test,
+                                                     const void* src_params) {
+  typedef struct shape_bmnk_t {
+    int batch, m, n, k;
+  } shape_bmnk_t;
+  const shape_bmnk_t shapes[] = {
+      // Degenerate cases. The K==0 one zeroes each batch's output.
+      {0, 2, 3, 4},
+      {3, 0, 3, 4},
+      {3, 2, 3, 0},
+      // Non-degenerate cases.
+      {1, 2, 3, 4},
+      {2, 1, 1, 1},
+      {3, 5, 7, 13},
+  };
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_batch_mmt4d_params_t params;
+    memset(&params, 0, sizeof params);
+    memcpy(&params.mmt4d, src_params, sizeof params.mmt4d);
+    iree_uk_mmt4d_params_t* mmt4d = &params.mmt4d;
+    mmt4d->cpu_data = iree_uk_test_cpu_data(test);
+    shape_bmnk_t shape = shapes[i];
+    params.batch_size = shape.batch;
+    mmt4d->M = shape.m;
+    mmt4d->N = shape.n;
+    mmt4d->K = shape.k;
+    // Randomly make the strides, and then the batch strides, tight or not.
+    iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d->type);
+    iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d->type);
+    iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d->type);
+    int rhs_padding = iree_uk_type_bit_count(rhs_type) < 8 ? 2 : 1;
+    int pad = iree_uk_random_engine_get_0_1(engine);
+    mmt4d->lhs_stride = mmt4d->K * mmt4d->M0 * mmt4d->K0 + pad;
+    mmt4d->rhs_stride = mmt4d->K * mmt4d->N0 * mmt4d->K0 + rhs_padding * pad;
+    mmt4d->out_stride = mmt4d->N * mmt4d->M0 * mmt4d->N0 + pad;
+    pad = iree_uk_random_engine_get_0_1(engine);
+    params.lhs_batch_stride = mmt4d->M * mmt4d->lhs_stride + pad;
+    params.rhs_batch_stride = mmt4d->N * mmt4d->rhs_stride + rhs_padding * pad;
+    params.out_batch_stride = mmt4d->M * mmt4d->out_stride + pad;
+    iree_uk_ssize_t lhs_buffer_size = iree_uk_2d_buffer_length(
+        lhs_type, params.batch_size, params.lhs_batch_stride);
+    iree_uk_ssize_t rhs_buffer_size = iree_uk_2d_buffer_length(
+        rhs_type, params.batch_size, params.rhs_batch_stride);
+    iree_uk_ssize_t out_buffer_size = iree_uk_2d_buffer_length(
+        out_type, params.batch_size, params.out_batch_stride);
+    void* lhs_buffer = malloc(lhs_buffer_size);
+    void* rhs_buffer = malloc(rhs_buffer_size);
+    void* reference_out_buffer = malloc(out_buffer_size);
+    void* actual_out_buffer = malloc(out_buffer_size);
+    iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+    iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+    iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size,
+                                out_type, engine);
+    memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      mmt4d->flags = accumulate ? IREE_UK_FLAG_ACCUMULATE : 0;
+      // The reference is one iree_mmt4d_reference call per batch.
+      for (iree_uk_ssize_t b = 0; b < params.batch_size; ++b) {
+        iree_uk_mmt4d_params_t batch_params;
+        memcpy(&batch_params, mmt4d, sizeof batch_params);
+        batch_params.lhs_buffer =
+            (const char*)lhs_buffer +
+            iree_uk_type_size_of_count(lhs_type, b * params.lhs_batch_stride);
+        batch_params.rhs_buffer =
+            (const char*)rhs_buffer +
+            iree_uk_type_size_of_count(rhs_type, b * params.rhs_batch_stride);
+        batch_params.out_buffer =
+            (char*)reference_out_buffer +
+            iree_uk_type_size_of_count(out_type, b * params.out_batch_stride);
+        iree_mmt4d_reference(&batch_params);
+      }
+      mmt4d->lhs_buffer = lhs_buffer;
+      mmt4d->rhs_buffer = rhs_buffer;
+      mmt4d->out_buffer = actual_out_buffer;
+      iree_uk_batch_mmt4d(&params);
+      if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+        IREE_UK_TEST_FAIL(test);
+      }
+    }
+    free(lhs_buffer);
+    free(rhs_buffer);
+    free(reference_out_buffer);
+    free(actual_out_buffer);
+  }
+}
+
+static void iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_t type, int M0,
+                                     int N0, int K0,
+                                     const char* cpu_features) {
   iree_uk_mmt4d_params_t params = {.type = type, .M0 = M0, .N0 = N0, .K0 = K0};
   char types_str[32];
   iree_uk_type_triple_str(types_str, sizeof types_str, type);
   char test_label_str[256];
-  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%dx%d",
-           types_str, M0, N0, K0);
-  iree_uk_test(test_label_str, iree_uk_test_mmt4d_for_tile_params, &params,
-               cpu_features);
+  snprintf(test_label_str, sizeof test_label_str,
+           "batch types:%s tile:%dx%dx%d", types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_batch_mmt4d_for_tile_params,
+               &params, cpu_features);
 }
 
 int main(int argc, char** argv) {
@@ -204,12 +589,68 @@ int main(int argc, char** argv) {
   // in a power-of-two assumption
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 3, 5, 7, NULL);
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f16f16f32, 3, 5, 7, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f16f16f16, 3, 5, 7, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_bf16bf16f32, 3, 5, 7, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_bf16bf16bf16, 3, 5, 7, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i4i32, 3, 5, 2, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32u4f32, 3, 4, 3, NULL);
+  const iree_uk_uint32_t bias = IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+  const iree_uk_uint32_t relu = IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU;
+  const iree_uk_uint32_t gelu = IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU;
+  const iree_uk_uint32_t requantize = IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 3, 5, 7,
+                                   bias | relu, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 3, 5, 7,
+                                   bias | gelu, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3,
+                                   bias | relu, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3,
+                                   requantize, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3,
+                                   bias | relu | requantize, NULL);
+  const iree_uk_uint32_t skip_zero_rhs_tiles =
+      IREE_UK_FLAG_MMT4D_SKIP_ZERO_RHS_TILES;
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 3, 5, 7,
+                                   skip_zero_rhs_tiles, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3,
+                                   skip_zero_rhs_tiles, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i4i32, 3, 5, 2,
+                                   skip_zero_rhs_tiles, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 9, 6, 3,
+                                   skip_zero_rhs_tiles | bias | requantize,
+                                   NULL);
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_f32f32f32, 3, 5, 7, NULL);
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_i8i4i32, 3, 5, 2, NULL);
 
 #if defined(IREE_UK_ARCH_ARM_64)
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL);
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, NULL);
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 4, "dotprod");
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 8, "i8mm");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32u4f32, 8, 8, 1, NULL);
+  // The SVE tile functions have N0 equal to the number of 32-bit lanes in the
+  // host vectors. Cover 128, 256 and 512-bit vectors; the other N0 values fall
+  // back to other tile functions.
+  for (int n0 = 4; n0 <= 16; n0 *= 2) {
+    iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, n0, 1, "sve");
+    iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, n0, 4, "sve");
+  }
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1,
+                                   bias | gelu, NULL);
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 8, 8, 4,
+                                   bias | requantize, "dotprod");
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, NULL);
+#elif defined(IREE_UK_ARCH_RISCV_64)
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, "v");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 1, "v");
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1,
+                                   bias | relu, "v");
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, "v");
+#elif defined(IREE_UK_ARCH_WASM_32)
+  // SIMD128 is a build-time property on wasm, so there are no CPU features.
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 4, 8, 1, NULL);
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 4, 8, 2, NULL);
 #elif defined(IREE_UK_ARCH_X86_64)
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 4, 1, NULL);  // SSE
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, "avx2_fma");
@@ -218,5 +659,29 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 8, 8, 2, "avx2_fma");
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2, "avx512_base");
   iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2, "avx512_vnni");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f16f16f32, 16, 16, 1, "avx512_base");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f16f16f16, 16, 16, 1, "avx512_base");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_bf16bf16f32, 16, 16, 2, "avx512_bf16");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_bf16bf16bf16, 16, 16, 2,
+                     "avx512_bf16");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i4i32, 8, 8, 2, "avx2_fma");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i4i32, 16, 16, 2, "avx512_base");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32u4f32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_f32u4f32, 16, 16, 1, "avx512_base");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 4, "amx_int8");
+  iree_uk_test_mmt4d(iree_uk_mmt4d_type_bf16bf16f32, 16, 16, 2, "amx_bf16");
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1,
+                                   bias | relu, "avx2_fma");
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_f32f32f32, 16, 16, 1,
+                                   bias | gelu, "avx512_base");
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2,
+                                   bias | requantize, "avx512_vnni");
+  // Epilogues bypass the AMX loop nest in favor of the AVX-512 tile functions.
+  iree_uk_test_mmt4d_with_epilogue(iree_uk_mmt4d_type_i8i8i32, 16, 16, 4,
+                                   bias | relu | requantize, "amx_int8");
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_f32f32f32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 2,
+                           "avx512_vnni");
+  iree_uk_test_batch_mmt4d(iree_uk_mmt4d_type_i8i8i32, 16, 16, 4, "amx_int8");
 #endif  // defined(IREE_UK_ARCH_ARM_64)
 }
@@ -0,0 +1,179 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+typedef enum iree_uk_test_normalize_op_t {
+  iree_uk_test_normalize_op_softmax,
+  iree_uk_test_normalize_op_layernorm,
+} iree_uk_test_normalize_op_t;
+
+// Test case parameters passed to iree_uk_test_normalize_for_op.
+typedef struct iree_uk_test_normalize_case_t {
+  iree_uk_test_normalize_op_t op;
+  // Value added to all inputs, to check the numerical stability of softmax
+  // (large positive values) and layernorm (mean large relative to spread).
+  float offset;
+} iree_uk_test_normalize_case_t;
+
+// Reference implementation, in double precision.
+static void iree_normalize_reference(iree_uk_test_normalize_op_t op,
+                                     const iree_uk_normalize_params_t* params,
+                                     double* out) {
+  const float* in = params->in_buffer;
+  iree_uk_ssize_t size1 = params->size1;
+  for (iree_uk_ssize_t i = 0; i < params->size0; ++i) {
+    const float* in_row = in + i * params->in_stride0;
+    double* out_row = out + i * size1;
+    if (op == iree_uk_test_normalize_op_softmax) {
+      double max = in_row[0];
+      for (iree_uk_ssize_t j = 1; j < size1; ++j) {
+        if (in_row[j] > max) max = in_row[j];
+      }
+      double sum = 0;
+      for (iree_uk_ssize_t j = 0; j < size1; ++j) {
+        out_row[j] = exp(in_row[j] - max);
+        sum += out_row[j];
+      }
+      for (iree_uk_ssize_t j = 0; j < size1; ++j) out_row[j] /= sum;
+    } else {
+      double mean = 0;
+      for (iree_uk_ssize_t j = 0; j < size1; ++j) mean += in_row[j];
+      mean /= size1;
+      double variance = 0;
+      for (iree_uk_ssize_t j = 0; j < size1; ++j) {
+        variance += (in_row[j] - mean) * (in_row[j] - mean);
+      }
+      variance /= size1;
+      double inv_stddev = 1 / sqrt(variance + params->epsilon);
+      for (iree_uk_ssize_t j = 0; j < size1; ++j) {
+        out_row[j] = (in_row[j] - mean) * inv_stddev;
+      }
+    }
+  }
+}
+
+static void iree_uk_test_normalize_for_shape(
+    iree_uk_test_t* test, const iree_uk_test_normalize_case_t* test_case,
+    iree_uk_ssize_t size0, iree_uk_ssize_t size1, bool in_place) {
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  iree_uk_normalize_params_t params = {
+      .type = iree_uk_normalize_type_f32f32,
+      .size0 = size0,
+      .size1 = size1,
+      .epsilon = 1e-5f,
+      .cpu_data = iree_uk_test_cpu_data(test),
+  };
+  // Randomly make strides either tight or not to exercise all cases.
+  params.in_stride0 = size1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      in_place ? params.in_stride0
+               : size1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_ssize_t in_buffer_size =
+      iree_uk_2d_buffer_length(IREE_UK_TYPE_FLOAT_32, size0, params.in_stride0);
+  float* in_buffer = malloc(in_buffer_size);
+  for (iree_uk_ssize_t i = 0; i < in_buffer_size / sizeof(float); ++i) {
+    // Random values in [-16, 16), not just integers.
+    float val = (iree_uk_random_engine_get_0_65535(engine) - 32768) / 2048.f;
+    in_buffer[i] = test_case->offset + val;
+  }
+  params.in_buffer = in_buffer;
+  double* reference = malloc(size0 * size1 * sizeof(double) + 1);
+  iree_normalize_reference(test_case->op, &params, reference);
+
+  float* out_buffer = in_buffer;
+  if (!in_place) {
+    iree_uk_ssize_t out_buffer_size = iree_uk_2d_buffer_length(
+        IREE_UK_TYPE_FLOAT_32, size0, params.out_stride0);
+    out_buffer = malloc(out_buffer_size);
+    iree_uk_write_random_buffer(out_buffer, out_buffer_size,
+                                IREE_UK_TYPE_FLOAT_32, engine);
+  }
+  params.out_buffer = out_buffer;
+  if (test_case->op == iree_uk_test_normalize_op_softmax) {
+    iree_uk_softmax(&params);
+  } else {
+    iree_uk_layernorm(&params);
+  }
+
+  for (iree_uk_ssize_t i = 0; i < size0; ++i) {
+    for (iree_uk_ssize_t j = 0; j < size1; ++j) {
+      double expected = reference[i * size1 + j];
+      double actual = out_buffer[i * params.out_stride0 + j];
+      // Softmax values are in (0, 1] and need a relative tolerance, while
+      // layernorm values are of the order of 1.
+      double tolerance = test_case->op == iree_uk_test_normalize_op_softmax
+                             ? 1e-5 * expected + 1e-7
+                             : 2e-5 * (1 + fabs(expected));
+      if (!(fabs(actual - expected) <= tolerance)) {
+        fprintf(stderr,
+                "size %dx%d, element (%d, %d): expected %g, actual %g\n",
+                (int)size0, (int)size1, (int)i, (int)j, expected, actual);
+        IREE_UK_TEST_FAIL(test);
+      }
+    }
+  }
+
+  free(reference);
+  if (!in_place) free(out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_normalize_for_op(iree_uk_test_t* test,
+                                          const void* src_params) {
+  const iree_uk_test_normalize_case_t* test_case = src_params;
+  // Row sizes around multiples of the vector widths (4, 8 and 16 lanes), to
+  // exercise the remainder handling.
+  const int sizes1[] = {1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1000};
+  const int sizes0[] = {1, 3};
+  // Degenerate cases. Vacuous.
+  iree_uk_test_normalize_for_shape(test, test_case, 0, 5, false);
+  iree_uk_test_normalize_for_shape(test, test_case, 5, 0, false);
+  for (int i = 0; i < IREE_ARRAYSIZE(sizes0); ++i) {
+    for (int j = 0; j < IREE_ARRAYSIZE(sizes1); ++j) {
+      for (int in_place = 0; in_place <= 1; ++in_place) {
+        iree_uk_test_normalize_for_shape(test, test_case, sizes0[i], sizes1[j],
+                                         in_place);
+      }
+    }
+  }
+}
+
+static void iree_uk_test_normalize(iree_uk_test_normalize_op_t op,
+                                   float offset, const char* cpu_features) {
+  iree_uk_test_normalize_case_t test_case = {.op = op, .offset = offset};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "%s offset:%g",
+           op == iree_uk_test_normalize_op_softmax ? "softmax" : "layernorm",
+           offset);
+  iree_uk_test(test_label_str, iree_uk_test_normalize_for_op, &test_case,
+               cpu_features);
+}
+
+static void iree_uk_test_normalize_all_ops(const char* cpu_features) {
+  iree_uk_test_normalize(iree_uk_test_normalize_op_softmax, 0.f, cpu_features);
+  iree_uk_test_normalize(iree_uk_test_normalize_op_softmax, 1000.f,
+                         cpu_features);
+  iree_uk_test_normalize(iree_uk_test_normalize_op_layernorm, 0.f,
+                         cpu_features);
+  iree_uk_test_normalize(iree_uk_test_normalize_op_layernorm, 1000.f,
+                         cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature.
+  iree_uk_test_normalize_all_ops(NULL);
+
+#if defined(IREE_UK_ARCH_X86_64)
+  iree_uk_test_normalize_all_ops("avx2_fma");
+  iree_uk_test_normalize_all_ops("avx512_base");
+#endif  // defined(IREE_UK_ARCH_X86_64)
+}
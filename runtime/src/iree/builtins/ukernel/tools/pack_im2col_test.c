@@ -0,0 +1,205 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Computes the im2col matrix element by element, without any tiling.
+static void iree_pack_im2col_reference(
+    const iree_uk_pack_im2col_params_t* params) {
+  iree_uk_type_t elem_type = iree_uk_pack_in_type(params->type);
+  iree_uk_ssize_t elem_size = iree_uk_type_size(elem_type);
+  iree_uk_ssize_t rows =
+      params->in_size0 * params->conv_out_size0 * params->conv_out_size1;
+  iree_uk_ssize_t cols =
+      params->kernel_size0 * params->kernel_size1 * params->in_size3;
+  iree_uk_ssize_t tile_size0 = params->out_size2;
+  iree_uk_ssize_t tile_size1 = params->out_size3;
+  for (iree_uk_ssize_t i0 = 0; i0 < params->out_size0 * tile_size0; ++i0) {
+    for (iree_uk_ssize_t i1 = 0; i1 < params->out_size1 * tile_size1; ++i1) {
+      iree_uk_ssize_t out_offset = (i0 / tile_size0) * params->out_stride0 +
+                                   (i1 / tile_size1) * tile_size0 * tile_size1 +
+                                   (i0 % tile_size0) * tile_size1 +
+                                   (i1 % tile_size1);
+      char* out_ptr = ((char*)params->out_buffer) + out_offset * elem_size;
+      const char* in_ptr = params->padding_value;
+      if (i0 < rows && i1 < cols) {
+        iree_uk_ssize_t n =
+            i0 / (params->conv_out_size0 * params->conv_out_size1);
+        iree_uk_ssize_t oh =
+            (i0 / params->conv_out_size1) % params->conv_out_size0;
+        iree_uk_ssize_t ow = i0 % params->conv_out_size1;
+        iree_uk_ssize_t kh = i1 / (params->kernel_size1 * params->in_size3);
+        iree_uk_ssize_t kw = (i1 / params->in_size3) % params->kernel_size1;
+        iree_uk_ssize_t c = i1 % params->in_size3;
+        iree_uk_ssize_t ih = oh * params->conv_stride0 +
+                             kh * params->dilation0 - params->padding0;
+        iree_uk_ssize_t iw = ow * params->conv_stride1 +
+                             kw * params->dilation1 - params->padding1;
+        if (ih >= 0 && ih < params->in_size1 && iw >= 0 &&
+            iw < params->in_size2) {
+          iree_uk_ssize_t in_offset = n * params->in_stride0 +
+                                      ih * params->in_stride1 +
+                                      iw * params->in_stride2 + c;
+          in_ptr = ((const char*)params->in_buffer) + in_offset * elem_size;
+        }
+      }
+      memcpy(out_ptr, in_ptr, elem_size);
+    }
+  }
+}
+
+static void iree_uk_test_pack_im2col_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_pack_im2col_params_t* src_params) {
+  iree_uk_pack_im2col_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Populate strides first - we need them below to compute buffer lengths.
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.in_stride2 = params.in_size3 + iree_uk_random_engine_get_0_1(engine);
+  params.in_stride1 = params.in_size2 * params.in_stride2 +
+                      iree_uk_random_engine_get_0_1(engine);
+  params.in_stride0 = params.in_size1 * params.in_stride1;
+  params.out_stride0 = params.out_size1 * params.out_size2 * params.out_size3;
+  iree_uk_type_t in_type = iree_uk_pack_in_type(params.type);
+  iree_uk_ssize_t in_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.in_size0, params.in_stride0);
+  void* in_buffer = malloc(in_buffer_size);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, in_type, engine);
+  params.in_buffer = in_buffer;
+
+  iree_uk_pack_im2col_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  iree_uk_type_t out_type = iree_uk_pack_out_type(params.type);
+  iree_uk_ssize_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.out_size0, params.out_stride0);
+  reference_params.out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_params.out_buffer, out_buffer_size,
+                              out_type, engine);
+
+  iree_uk_pack_im2col_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  actual_params.out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(actual_params.out_buffer, out_buffer_size,
+                              out_type, engine);
+
+  iree_pack_im2col_reference(&reference_params);
+  iree_uk_pack_im2col(&actual_params);
+
+  if (!iree_uk_2d_buffers_equal(actual_params.out_buffer,
+                                reference_params.out_buffer, out_type,
+                                params.out_size0, params.out_stride0,
+                                params.out_stride0)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_params.out_buffer);
+  free(actual_params.out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_pack_im2col_for_tile_params(iree_uk_test_t* test,
+                                                     const void* src_params) {
+  typedef struct conv_shape_t {
+    int batch, height, width, channels;
+    int kernel_height, kernel_width;
+    int stride, dilation, padding;
+  } conv_shape_t;
+  const conv_shape_t conv_shapes[] = {
+      // Degenerate cases. Vacuous.
+      {0, 4, 4, 3, 3, 3, 1, 1, 0},
+      {1, 4, 4, 0, 3, 3, 1, 1, 0},
+      // Non-degenerate cases.
+      {1, 1, 1, 1, 1, 1, 1, 1, 0},
+      {1, 7, 5, 3, 3, 3, 1, 1, 0},
+      {2, 9, 8, 5, 3, 2, 2, 1, 1},
+      {1, 12, 10, 16, 3, 3, 1, 2, 2},
+      {3, 6, 6, 33, 1, 1, 1, 1, 0},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(conv_shapes); ++i) {
+    const conv_shape_t shape = conv_shapes[i];
+    for (int extra_tiles = 0; extra_tiles <= 1; ++extra_tiles) {
+      iree_uk_pack_im2col_params_t params;
+      memcpy(&params, src_params, sizeof params);
+      params.cpu_data = iree_uk_test_cpu_data(test);
+      params.in_size0 = shape.batch;
+      params.in_size1 = shape.height;
+      params.in_size2 = shape.width;
+      params.in_size3 = shape.channels;
+      params.kernel_size0 = shape.kernel_height;
+      params.kernel_size1 = shape.kernel_width;
+      params.conv_stride0 = shape.stride;
+      params.conv_stride1 = shape.stride;
+      params.dilation0 = shape.dilation;
+      params.dilation1 = shape.dilation;
+      params.padding0 = shape.padding;
+      params.padding1 = shape.padding;
+      params.conv_out_size0 =
+          (shape.height + 2 * shape.padding -
+           shape.dilation * (shape.kernel_height - 1) - 1) /
+              shape.stride +
+          1;
+      params.conv_out_size1 =
+          (shape.width + 2 * shape.padding -
+           shape.dilation * (shape.kernel_width - 1) - 1) /
+              shape.stride +
+          1;
+      iree_uk_ssize_t rows =
+          params.in_size0 * params.conv_out_size0 * params.conv_out_size1;
+      iree_uk_ssize_t cols =
+          params.kernel_size0 * params.kernel_size1 * params.in_size3;
+      params.out_size0 =
+          (rows + params.out_size2 - 1) / params.out_size2 + extra_tiles;
+      params.out_size1 =
+          (cols + params.out_size3 - 1) / params.out_size3 + extra_tiles;
+      iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+      iree_uk_type_t out_type = iree_uk_pack_out_type(params.type);
+      int out_elem_size = iree_uk_type_size(out_type);
+      void* padding_value_buffer = malloc(out_elem_size);
+      iree_uk_write_random_buffer(padding_value_buffer, out_elem_size,
+                                  out_type, engine);
+      params.padding_value = padding_value_buffer;
+      iree_uk_test_pack_im2col_for_shape_params(test, &params);
+      free(padding_value_buffer);
+    }
+  }
+}
+
+static void iree_uk_test_pack_im2col(iree_uk_pack_type_t type, int tile_size0,
+                                     int tile_size1, const char* cpu_features) {
+  iree_uk_pack_im2col_params_t params = {
+      .type = type, .out_size2 = tile_size0, .out_size3 = tile_size1};
+  char types_str[32];
+  iree_uk_type_pair_str(types_str, sizeof types_str, type);
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d",
+           types_str, tile_size0, tile_size1);
+  iree_uk_test(test_label_str, iree_uk_test_pack_im2col_for_tile_params,
+               &params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature. The tile sizes
+  // are chosen not to divide the channel counts above so that tiles straddle
+  // kernel positions.
+  iree_uk_test_pack_im2col(iree_uk_pack_type_f32f32, 3, 5, NULL);
+  iree_uk_test_pack_im2col(iree_uk_pack_type_i8i8, 4, 2, NULL);
+  iree_uk_test_pack_im2col(iree_uk_pack_type_f16f16, 4, 3, NULL);
+  iree_uk_test_pack_im2col(iree_uk_pack_type_bf16bf16, 5, 2, NULL);
+
+#if defined(IREE_UK_ARCH_ARM_64)
+  iree_uk_test_pack_im2col(iree_uk_pack_type_f32f32, 8, 1, NULL);
+  iree_uk_test_pack_im2col(iree_uk_pack_type_i8i8, 8, 4, NULL);
+  iree_uk_test_pack_im2col(iree_uk_pack_type_i8i8, 8, 8, NULL);
+#elif defined(IREE_UK_ARCH_X86_64)
+  iree_uk_test_pack_im2col(iree_uk_pack_type_f32f32, 8, 1, "avx2_fma");
+  iree_uk_test_pack_im2col(iree_uk_pack_type_i8i8, 8, 2, "avx2_fma");
+  iree_uk_test_pack_im2col(iree_uk_pack_type_f32f32, 16, 1, "avx512_base");
+  iree_uk_test_pack_im2col(iree_uk_pack_type_i8i8, 16, 2, "avx512_base");
+#endif  // defined(IREE_UK_ARCH_ARM_64)
+}
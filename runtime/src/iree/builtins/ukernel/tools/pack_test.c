@@ -12,7 +12,8 @@
 static void iree_pack_reference(const iree_uk_pack_params_t* params) {
   // For now, the input and output element types are always the same.
   iree_uk_type_t elem_type = iree_uk_pack_in_type(params->type);
-  iree_uk_ssize_t elem_size = iree_uk_type_size(elem_type);
+  bool is_i4 = elem_type == IREE_UK_TYPE_INT_4;
+  iree_uk_ssize_t elem_size = is_i4 ? 0 : iree_uk_type_size(elem_type);
   iree_uk_ssize_t outer_size0 = params->out_size0;
   iree_uk_ssize_t outer_size1 = params->out_size1;
   iree_uk_ssize_t tile_size0 = params->out_size2;
@@ -40,6 +41,15 @@ static void iree_pack_reference(const iree_uk_pack_params_t* params) {
               outer_i1 * out_stride_l1 + tile_i1 * out_stride_l3;
           iree_uk_ssize_t i0 = outer_i0 * tile_size0 + tile_i0;
           iree_uk_ssize_t i1 = outer_i1 * tile_size1 + tile_i1;
+          if (is_i4) {
+            bool in_bounds = i0 < params->in_size0 && i1 < params->in_size1;
+            iree_uk_uint8_t val =
+                in_bounds ? iree_uk_load_nibble(params->in_buffer,
+                                                i1 + i0 * params->in_stride0)
+                          : *(const iree_uk_uint8_t*)params->padding_value;
+            iree_uk_store_nibble(params->out_buffer, out_offset, val);
+            continue;
+          }
           char* out_ptr = ((char*)params->out_buffer) + out_offset * elem_size;
           if (i0 >= params->in_size0 || i1 >= params->in_size1) {
             memcpy(out_ptr, params->padding_value, elem_size);
@@ -89,8 +99,10 @@ static void iree_uk_test_pack_for_shape_params(
   iree_pack_reference(&reference_params);
   iree_uk_pack(&actual_params);
 
-  if (memcmp(actual_params.out_buffer, reference_params.out_buffer,
-             out_buffer_size)) {
+  if (!iree_uk_2d_buffers_equal(actual_params.out_buffer,
+                                reference_params.out_buffer, out_type,
+                                params.out_size0, params.out_stride0,
+                                params.out_stride0)) {
     IREE_UK_TEST_FAIL(test);
   }
 
@@ -158,7 +170,8 @@ static void iree_uk_test_pack_for_tile_params(iree_uk_test_t* test,
             if (params.in_size1 < 0) params.in_size1 = 0;
           }
           iree_uk_type_t out_type = iree_uk_pack_out_type(params.type);
-          int out_elem_size = iree_uk_type_size(out_type);
+          // Rounds up to one byte for sub-byte types.
+          int out_elem_size = iree_uk_2d_buffer_length(out_type, 1, 1);
           void* padding_value_buffer = malloc(out_elem_size);
           iree_uk_write_random_buffer(padding_value_buffer, out_elem_size,
                                       out_type, engine);
@@ -191,6 +204,10 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(iree_uk_pack_type_f32f32, 3, 5, NULL);
   iree_uk_test_pack(iree_uk_pack_type_i8i8, 4, 2, NULL);
   iree_uk_test_pack(iree_uk_pack_type_i32i32, 3, 4, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_f16f16, 4, 3, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_bf16bf16, 5, 2, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_i4i4, 3, 5, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_i4i4, 16, 2, NULL);
 
 #if defined(IREE_UK_ARCH_ARM_64)
   iree_uk_test_pack(iree_uk_pack_type_f32f32, 8, 1, NULL);
@@ -203,6 +220,18 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(iree_uk_pack_type_i8i8, 8, 4, NULL);
   // Tile size selected for CPU feature i8mm. Same comment as for dotprod.
   iree_uk_test_pack(iree_uk_pack_type_i8i8, 8, 8, NULL);
+#elif defined(IREE_UK_ARCH_RISCV_64)
+  iree_uk_test_pack(iree_uk_pack_type_f32f32, 8, 1, "v");
+  iree_uk_test_pack(iree_uk_pack_type_i8i8, 8, 1, "v");
+  iree_uk_test_pack(iree_uk_pack_type_i32i32, 8, 8, "v");
+#elif defined(IREE_UK_ARCH_WASM_32)
+  // SIMD128 is a build-time choice on WebAssembly, so no cpu_features_list.
+  iree_uk_test_pack(iree_uk_pack_type_f32f32, 4, 1, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_f32f32, 8, 1, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_i8i8, 4, 2, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_i8i8, 8, 2, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_f32f32, 4, 8, NULL);
+  iree_uk_test_pack(iree_uk_pack_type_i32i32, 4, 8, NULL);
 #elif defined(IREE_UK_ARCH_X86_64)
   iree_uk_test_pack(iree_uk_pack_type_f32f32, 8, 1, "avx2_fma");
   iree_uk_test_pack(iree_uk_pack_type_i8i8, 8, 2, "avx2_fma");
@@ -94,9 +94,13 @@ static iree_status_t iree_uk_benchmark_unpack(
   }
   // Report bytes per second, so that can be easily compared to known memory
   // system performance metrics (e.g. RAM bandwidth, to tell whether this is
-  // memory-bound).
-  iree_benchmark_set_items_processed(benchmark_state,
+  // memory-bound) and between the pack, unpack and memcpy benchmarks, which
+  // all count the bytes written.
+  iree_benchmark_set_bytes_processed(benchmark_state,
                                      total_iterations * out_buffer_size);
+  iree_uk_benchmark_report_roofline(
+      benchmark_state, /*op_count=*/0,
+      total_iterations * (in_buffer_size + out_buffer_size));
   free(in_buffer);
   free(out_buffer);
   return iree_ok_status();
@@ -185,10 +185,18 @@ int main(int argc, char** argv) {
   iree_uk_test_unpack(iree_uk_unpack_type_f32f32, 3, 5, NULL);
   iree_uk_test_unpack(iree_uk_unpack_type_i8i8, 4, 2, NULL);
   iree_uk_test_unpack(iree_uk_unpack_type_i32i32, 3, 4, NULL);
+  iree_uk_test_unpack(iree_uk_unpack_type_f16f16, 4, 3, NULL);
+  iree_uk_test_unpack(iree_uk_unpack_type_bf16bf16, 5, 2, NULL);
 
 #if defined(IREE_UK_ARCH_ARM_64)
   iree_uk_test_unpack(iree_uk_unpack_type_f32f32, 8, 8, NULL);
   iree_uk_test_unpack(iree_uk_unpack_type_i32i32, 8, 8, NULL);
+#elif defined(IREE_UK_ARCH_RISCV_64)
+  iree_uk_test_unpack(iree_uk_unpack_type_f32f32, 8, 8, "v");
+  iree_uk_test_unpack(iree_uk_unpack_type_i32i32, 8, 8, "v");
+#elif defined(IREE_UK_ARCH_WASM_32)
+  iree_uk_test_unpack(iree_uk_unpack_type_f32f32, 4, 8, NULL);
+  iree_uk_test_unpack(iree_uk_unpack_type_i32i32, 4, 8, NULL);
 #elif defined(IREE_UK_ARCH_X86_64)
   iree_uk_test_unpack(iree_uk_unpack_type_f32f32, 8, 8, "avx2_fma");
   iree_uk_test_unpack(iree_uk_unpack_type_i32i32, 8, 8, "avx2_fma");
@@ -31,13 +31,26 @@ void iree_uk_assert_fail(const char* file, int line, const char* function,
 iree_uk_ssize_t iree_uk_2d_buffer_length(iree_uk_type_t type,
                                          iree_uk_ssize_t size0,
                                          iree_uk_ssize_t stride0) {
-  // Just for testing purposes, so it's OK to overestimate size.
-  return size0 * stride0 << iree_uk_type_size_log2(type);
+  // Just for testing purposes, so it's OK to overestimate size. Rounds up to a
+  // whole number of bytes for sub-byte types.
+  iree_uk_ssize_t bits = size0 * stride0 << iree_uk_type_bit_count_log2(type);
+  return (bits + 7) >> 3;
 }
 
 bool iree_uk_2d_buffers_equal(const void* buf1, const void* buf2,
                               iree_uk_type_t type, iree_uk_ssize_t size0,
                               iree_uk_ssize_t size1, iree_uk_ssize_t stride0) {
+  if (type == IREE_UK_TYPE_INT_4 || type == IREE_UK_TYPE_UINT_4) {
+    for (iree_uk_ssize_t i0 = 0; i0 < size0; ++i0) {
+      for (iree_uk_ssize_t i1 = 0; i1 < size1; ++i1) {
+        iree_uk_ssize_t i = i0 * stride0 + i1;
+        if (iree_uk_load_nibble(buf1, i) != iree_uk_load_nibble(buf2, i)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
   iree_uk_ssize_t elem_size = iree_uk_type_size(type);
   const char* buf1_ptr = buf1;
   const char* buf2_ptr = buf2;
@@ -78,17 +91,31 @@ int iree_uk_random_engine_get_minus16_plus15(iree_uk_random_engine_t* e) {
 void iree_uk_write_random_buffer(void* buffer, iree_uk_ssize_t size_in_bytes,
                                  iree_uk_type_t type,
                                  iree_uk_random_engine_t* engine) {
+  if (type == IREE_UK_TYPE_INT_4 || type == IREE_UK_TYPE_UINT_4) {
+    // Any nibble is a valid value, signed or not.
+    for (iree_uk_ssize_t i = 0; i < size_in_bytes; ++i) {
+      ((uint8_t*)buffer)[i] = iree_uk_random_engine_get_0_65535(engine);
+    }
+    return;
+  }
   iree_uk_ssize_t elem_size = iree_uk_type_size(type);
   iree_uk_ssize_t size_in_elems = size_in_bytes / elem_size;
   for (iree_uk_ssize_t i = 0; i < size_in_elems; ++i) {
     // Small integers, should work for now for all the types we currently have
     // and enable exact float arithmetic, allowing to keep tests simpler for
-    // now. Watch out for when we'll do float16!
+    // now. These are exactly representable even in f16 and bf16, so for those
+    // types only accumulators may be subject to rounding.
     int random_val = iree_uk_random_engine_get_minus16_plus15(engine);
     switch (type) {
       case IREE_UK_TYPE_FLOAT_32:
         ((float*)buffer)[i] = random_val;
         break;
+      case IREE_UK_TYPE_FLOAT_16:
+        ((uint16_t*)buffer)[i] = iree_uk_f32_to_f16((float)random_val);
+        break;
+      case IREE_UK_TYPE_BFLOAT_16:
+        ((uint16_t*)buffer)[i] = iree_uk_f32_to_bf16((float)random_val);
+        break;
       case IREE_UK_TYPE_INT_32:
         ((int32_t*)buffer)[i] = random_val;
         break;
@@ -170,6 +197,11 @@ void iree_uk_make_cpu_data_for_features(const char* cpu_features,
       IREE_CPU_DATA0_X86_64_AVX512BW | IREE_CPU_DATA0_X86_64_AVX512DQ |
       IREE_CPU_DATA0_X86_64_AVX512VL | IREE_CPU_DATA0_X86_64_AVX512CD;
   iree_uk_uint64_t avx512_vnni = avx512_base | IREE_CPU_DATA0_X86_64_AVX512VNNI;
+  iree_uk_uint64_t avx512_bf16 = avx512_base | IREE_CPU_DATA0_X86_64_AVX512BF16;
+  iree_uk_uint64_t amx_int8 = avx512_base | IREE_CPU_DATA0_X86_64_AMXTILE |
+                              IREE_CPU_DATA0_X86_64_AMXINT8;
+  iree_uk_uint64_t amx_bf16 = avx512_base | IREE_CPU_DATA0_X86_64_AMXTILE |
+                              IREE_CPU_DATA0_X86_64_AMXBF16;
   if (!strcmp(cpu_features, "avx2_fma")) {
     out_cpu_data_fields[0] = avx2_fma;
     return;
@@ -182,6 +214,18 @@ void iree_uk_make_cpu_data_for_features(const char* cpu_features,
     out_cpu_data_fields[0] = avx512_vnni;
     return;
   }
+  if (!strcmp(cpu_features, "avx512_bf16")) {
+    out_cpu_data_fields[0] = avx512_bf16;
+    return;
+  }
+  if (!strcmp(cpu_features, "amx_int8")) {
+    out_cpu_data_fields[0] = amx_int8;
+    return;
+  }
+  if (!strcmp(cpu_features, "amx_bf16")) {
+    out_cpu_data_fields[0] = amx_bf16;
+    return;
+  }
 #endif  // defined(IREE_UK_ARCH_X86_64)
   // Fall back to interpreting cpu_features as a comma-separated list of LLVM
   // feature names. TODO: actually support multiple comma-separated values. For
@@ -0,0 +1,40 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Matmul tile sizes tuned for specific CPU models, overriding the defaults
+// that only depend on CPU features. Shared between the runtime
+// (iree_uk_query_tile_sizes_2d, keyed by CPU_MODEL) and the compiler
+// (LLVMCPUMaterializeEncodingPass, keyed by LLVM_CPU), so that both agree on
+// data layouts.
+//
+// Entries are generated by running `mmt4d_benchmark --autotune` on the target
+// CPU and pasting its output below, in the section for the target architecture:
+//
+//   IREE_UK_TUNED_MATMUL_TILE_SIZES_<ARCH>(CPU_MODEL, LLVM_CPU, OPERATION,
+//                                          CPU_FEATURES, M, K, N)
+//
+// * CPU_MODEL is the value of processor data field 1, see
+//   IREE_CPU_DATA1_<ARCH>_MODEL in iree/schemas/cpu_data.h.
+// * LLVM_CPU is the string that the compiler would get as the target cpu.
+// * OPERATION is the suffix of an IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_
+//   value, e.g. MATMUL_F32F32F32.
+// * CPU_FEATURES names the feature set required by the tile function, as in
+//   the cpu_features of the ukernel tests and benchmarks (e.g. avx512_base),
+//   or `baseline` if none. An entry only applies if the CPU supports these
+//   features and, in the runtime, if the corresponding code was built.
+//
+// Keep entries sorted by CPU_MODEL, then OPERATION.
+//
+// This file has no include guard, as it is meant to be included multiple times
+// with different definitions of the above macros.
+
+//===----------------------------------------------------------------------===//
+// arm_64
+//===----------------------------------------------------------------------===//
+
+//===----------------------------------------------------------------------===//
+// x86_64
+//===----------------------------------------------------------------------===//
@@ -17,6 +17,9 @@ typedef enum iree_uk_unpack_type_t {
   iree_uk_unpack_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
   iree_uk_unpack_type_i8i8 = IREE_UK_TIE_2_TYPES_LITERAL(INT_8, INT_8),
   iree_uk_unpack_type_i32i32 = IREE_UK_TIE_2_TYPES_LITERAL(INT_32, INT_32),
+  iree_uk_unpack_type_f16f16 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_16, FLOAT_16),
+  iree_uk_unpack_type_bf16bf16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(BFLOAT_16, BFLOAT_16),
 } iree_uk_unpack_type_t;
 
 static inline iree_uk_type_t iree_uk_unpack_in_type(
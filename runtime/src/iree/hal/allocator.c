@@ -68,12 +68,41 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
       statistics->device_bytes_freed,
       (statistics->device_bytes_allocated - statistics->device_bytes_freed)));
 
+  if (statistics->cache_hit_count || statistics->cache_miss_count) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "      CACHED: %12" PRIu64 "  hits / %12" PRIu64
+        "  misses / %12" PRIdsz "B free\n",
+        statistics->cache_hit_count, statistics->cache_miss_count,
+        statistics->cache_bytes_free));
+  }
+
 #else
   // No-op when disabled.
 #endif  // IREE_STATISTICS_ENABLE
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_allocation_source_t
+//===----------------------------------------------------------------------===//
+
+// Zero-initialized to IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR on all threads.
+static IREE_THREAD_LOCAL iree_hal_allocation_source_t
+    iree_hal_allocation_source_ = IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR;
+
+IREE_API_EXPORT iree_hal_allocation_source_t
+iree_hal_allocation_source_current(void) {
+  return iree_hal_allocation_source_;
+}
+
+IREE_API_EXPORT iree_hal_allocation_source_t
+iree_hal_allocation_source_exchange(iree_hal_allocation_source_t source) {
+  iree_hal_allocation_source_t prior_source = iree_hal_allocation_source_;
+  iree_hal_allocation_source_ = source;
+  return prior_source;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t
 //===----------------------------------------------------------------------===//
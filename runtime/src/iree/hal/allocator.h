@@ -276,6 +276,17 @@ typedef enum iree_hal_external_buffer_type_e {
   //  Uses VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT.
   IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32 = 3,
 
+  // A device pointer allocated from the same driver/device by an external
+  // library sharing the process (such as a framework tensor exchanged via
+  // DLPack). An imported/exported buffer does not own a reference to the
+  // memory and the caller is responsible for ensuring the memory remains live
+  // for as long as the iree_hal_buffer_t referencing it.
+  //
+  // CUDA:
+  //  A CUdeviceptr allocated in the same context (cuMemAlloc, cudaMalloc, or
+  //  an allocator built on them). Not freed by the HAL.
+  IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION = 4,
+
   // TODO(benvanik): additional memory types:
   //  shared memory fd (shmem)/mapped file
   //  VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT
@@ -314,6 +325,11 @@ typedef struct iree_hal_external_buffer_t {
     struct {
       void* handle;
     } opaque_win32;
+    // IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION
+    struct {
+      // Device memory pointer in the driver's native address type.
+      uint64_t ptr;
+    } device_allocation;
   } handle;
 } iree_hal_external_buffer_t;
 
@@ -349,6 +365,11 @@ typedef struct iree_hal_allocator_statistics_t {
   iree_device_size_t device_bytes_peak;
   iree_device_size_t device_bytes_allocated;
   iree_device_size_t device_bytes_freed;
+  // Allocations serviced from and missing in caching allocators, if any.
+  uint64_t cache_hit_count;
+  uint64_t cache_miss_count;
+  // Bytes of free allocations retained by caching allocators, if any.
+  iree_device_size_t cache_bytes_free;
   // TODO(benvanik): mapping information (discarded, mapping ranges,
   //                 flushed/invalidated, etc).
 #else
@@ -361,6 +382,28 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
     const iree_hal_allocator_statistics_t* statistics,
     iree_string_builder_t* builder);
 
+// Identifies the API through which an allocation request was made.
+typedef enum iree_hal_allocation_source_e {
+  // Synchronous allocation via iree_hal_allocator_allocate_buffer.
+  IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR = 0,
+  // Queue-ordered allocation via iree_hal_device_queue_alloca. Devices that
+  // service the request from their own pools (such as stream-ordered driver
+  // pools) may not route it to the device allocator at all.
+  IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA = 1,
+} iree_hal_allocation_source_t;
+
+// Returns the source of the allocation request being serviced on the calling
+// thread. Allocators wrapping other allocators can use this to attribute
+// allocations to the API the user called.
+IREE_API_EXPORT iree_hal_allocation_source_t
+iree_hal_allocation_source_current(void);
+
+// Sets the source of allocation requests made on the calling thread and
+// returns the prior source so that it can be restored after the request.
+// Called by iree_hal_device_queue_alloca around the device implementation.
+IREE_API_EXPORT iree_hal_allocation_source_t
+iree_hal_allocation_source_exchange(iree_hal_allocation_source_t source);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t
 //===----------------------------------------------------------------------===//
@@ -524,6 +567,19 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Releases all small heap buffer allocations retained by the calling thread.
+// When IREE_HAL_HEAP_BUFFER_CACHE_ENABLE is set each thread keeps a bounded
+// number of recently freed heap buffers for reuse. Caches are trimmed
+// automatically when their thread exits and long-lived threads that are about
+// to go idle can call this to return that memory to the system earlier.
+// Trimming a heap allocator also trims the calling thread's cache.
+IREE_API_EXPORT void iree_hal_heap_buffer_trim_thread_cache(void);
+
+// Returns the number of freed heap buffer allocations currently retained for
+// reuse by the calling thread. Always 0 if IREE_HAL_HEAP_BUFFER_CACHE_ENABLE is
+// not set.
+IREE_API_EXPORT iree_host_size_t iree_hal_heap_buffer_thread_cache_count(void);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
@@ -84,6 +84,7 @@ static iree_allocator_t iree_hal_heap_allocator_host_allocator(
 
 static iree_status_t iree_hal_heap_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_heap_buffer_trim_thread_cache();
   return iree_ok_status();
 }
 
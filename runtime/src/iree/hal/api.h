@@ -22,6 +22,7 @@
 #include "iree/hal/executable.h"        // IWYU pragma: export
 #include "iree/hal/executable_cache.h"  // IWYU pragma: export
 #include "iree/hal/fence.h"             // IWYU pragma: export
+#include "iree/hal/file.h"              // IWYU pragma: export
 #include "iree/hal/pipeline_layout.h"   // IWYU pragma: export
 #include "iree/hal/resource.h"          // IWYU pragma: export
 #include "iree/hal/semaphore.h"         // IWYU pragma: export
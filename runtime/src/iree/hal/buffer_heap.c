@@ -9,6 +9,8 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/math.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
@@ -52,6 +54,305 @@ static_assert(sizeof(iree_hal_heap_buffer_t) <= 128,
 
 static const iree_hal_buffer_vtable_t iree_hal_heap_buffer_vtable;
 
+//===----------------------------------------------------------------------===//
+// Per-thread heap buffer cache
+//===----------------------------------------------------------------------===//
+// Each thread keeps a small bounded set of recently freed blocks that can be
+// reused by subsequent heap buffer allocations on the same thread without a
+// round-trip through the host allocator. Bucket 0 holds bare
+// iree_hal_heap_buffer_t wrappers (used by split and external storage) while
+// the remaining buckets hold [metadata, data] slabs with power-of-two payload
+// sizes starting at IREE_HAL_HEAP_BUFFER_ALIGNMENT.
+//
+// Only blocks from the system allocator are cached: user-provided allocators
+// may have lifetimes shorter than the threads using them or may want to observe
+// every allocation. Blocks freed on a different thread than the one that
+// allocated them are retained by the freeing thread.
+//
+// Cached blocks are retained until iree_hal_heap_buffer_trim_thread_cache is
+// called on the owning thread or the thread exits. Each thread's cache is
+// allocated the first time the thread retains a block and is stored in a
+// pthread key (or fiber local storage slot on Windows) whose destructor frees
+// the cache and its blocks on thread exit. The destructor never touches
+// compiler thread-local storage as some platforms tear that down first.
+
+// Maximum number of blocks retained per bucket per thread.
+#define IREE_HAL_HEAP_BUFFER_CACHE_CAPACITY 16
+
+// Bucket index indicating the block is not cacheable.
+#define IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE ((iree_host_size_t)-1)
+
+// Bucket used for bare iree_hal_heap_buffer_t wrappers.
+#define IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_WRAPPER 0
+
+// Total bucket count including the wrapper bucket.
+#define IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT 16
+
+#if IREE_HAL_HEAP_BUFFER_CACHE_ENABLE
+
+static_assert(IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE /
+                      IREE_HAL_HEAP_BUFFER_ALIGNMENT <
+                  (1ull << (IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT - 1)),
+              "cached slab size classes must fit in the bucket count");
+
+typedef struct iree_hal_heap_buffer_cache_t {
+  // Number of valid entries in each bucket.
+  uint8_t counts[IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT];
+  // Free blocks as allocated from the system allocator.
+  void* entries[IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT]
+               [IREE_HAL_HEAP_BUFFER_CACHE_CAPACITY];
+} iree_hal_heap_buffer_cache_t;
+
+// Frees all blocks retained by |cache|.
+static void iree_hal_heap_buffer_cache_trim(
+    iree_hal_heap_buffer_cache_t* cache) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  for (iree_host_size_t i = 0; i < cache->counts[0]; ++i) {
+    iree_allocator_free(host_allocator, cache->entries[0][i]);
+  }
+  cache->counts[0] = 0;
+  for (iree_host_size_t bucket = 1;
+       bucket < IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT; ++bucket) {
+    for (iree_host_size_t i = 0; i < cache->counts[bucket]; ++i) {
+      iree_allocator_free_aligned(host_allocator, cache->entries[bucket][i]);
+    }
+    cache->counts[bucket] = 0;
+  }
+}
+
+// Frees the |cache_ptr| of an exiting thread and all blocks it retains.
+static void iree_hal_heap_buffer_cache_destroy(void* cache_ptr) {
+  iree_hal_heap_buffer_cache_t* cache =
+      (iree_hal_heap_buffer_cache_t*)cache_ptr;
+  if (!cache) return;
+  iree_hal_heap_buffer_cache_trim(cache);
+  iree_allocator_free(iree_allocator_system(), cache);
+}
+
+#if defined(IREE_PLATFORM_WINDOWS)
+
+static iree_once_flag iree_hal_heap_buffer_cache_slot_once =
+    IREE_ONCE_FLAG_INIT;
+static DWORD iree_hal_heap_buffer_cache_fls_index = FLS_OUT_OF_INDEXES;
+
+static void NTAPI iree_hal_heap_buffer_cache_fls_callback(void* cache_ptr) {
+  iree_hal_heap_buffer_cache_destroy(cache_ptr);
+}
+
+static void iree_hal_heap_buffer_cache_slot_initialize(void) {
+  iree_hal_heap_buffer_cache_fls_index =
+      FlsAlloc(iree_hal_heap_buffer_cache_fls_callback);
+}
+
+// Returns the calling thread's cache or NULL if it has not retained any blocks.
+static iree_hal_heap_buffer_cache_t* iree_hal_heap_buffer_cache_get(void) {
+  iree_call_once(&iree_hal_heap_buffer_cache_slot_once,
+                 iree_hal_heap_buffer_cache_slot_initialize);
+  if (iree_hal_heap_buffer_cache_fls_index == FLS_OUT_OF_INDEXES) return NULL;
+  return (iree_hal_heap_buffer_cache_t*)FlsGetValue(
+      iree_hal_heap_buffer_cache_fls_index);
+}
+
+// Sets the calling thread's |cache| and returns true if it will be destroyed
+// when the thread exits.
+static bool iree_hal_heap_buffer_cache_set(
+    iree_hal_heap_buffer_cache_t* cache) {
+  return iree_hal_heap_buffer_cache_fls_index != FLS_OUT_OF_INDEXES &&
+         FlsSetValue(iree_hal_heap_buffer_cache_fls_index, cache);
+}
+
+#elif !IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+static iree_once_flag iree_hal_heap_buffer_cache_slot_once =
+    IREE_ONCE_FLAG_INIT;
+static pthread_key_t iree_hal_heap_buffer_cache_key;
+static bool iree_hal_heap_buffer_cache_key_valid = false;
+
+static void iree_hal_heap_buffer_cache_slot_initialize(void) {
+  iree_hal_heap_buffer_cache_key_valid =
+      pthread_key_create(&iree_hal_heap_buffer_cache_key,
+                         iree_hal_heap_buffer_cache_destroy) == 0;
+}
+
+// Returns the calling thread's cache or NULL if it has not retained any blocks.
+static iree_hal_heap_buffer_cache_t* iree_hal_heap_buffer_cache_get(void) {
+  iree_call_once(&iree_hal_heap_buffer_cache_slot_once,
+                 iree_hal_heap_buffer_cache_slot_initialize);
+  if (!iree_hal_heap_buffer_cache_key_valid) return NULL;
+  return (iree_hal_heap_buffer_cache_t*)pthread_getspecific(
+      iree_hal_heap_buffer_cache_key);
+}
+
+// Sets the calling thread's |cache| and returns true if it will be destroyed
+// when the thread exits.
+static bool iree_hal_heap_buffer_cache_set(
+    iree_hal_heap_buffer_cache_t* cache) {
+  return iree_hal_heap_buffer_cache_key_valid &&
+         pthread_setspecific(iree_hal_heap_buffer_cache_key, cache) == 0;
+}
+
+#else
+
+// Without threads the single cache lives as long as the process.
+static iree_hal_heap_buffer_cache_t* iree_hal_heap_buffer_cache_instance =
+    NULL;
+
+static iree_hal_heap_buffer_cache_t* iree_hal_heap_buffer_cache_get(void) {
+  return iree_hal_heap_buffer_cache_instance;
+}
+
+static bool iree_hal_heap_buffer_cache_set(
+    iree_hal_heap_buffer_cache_t* cache) {
+  iree_hal_heap_buffer_cache_instance = cache;
+  return true;
+}
+
+#endif  // IREE_PLATFORM_WINDOWS / !IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+// Returns the calling thread's cache, creating it if needed, or NULL if a cache
+// is not available.
+static iree_hal_heap_buffer_cache_t* iree_hal_heap_buffer_cache_get_or_create(
+    void) {
+  iree_hal_heap_buffer_cache_t* cache = iree_hal_heap_buffer_cache_get();
+  if (IREE_LIKELY(cache)) return cache;
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*cache), (void**)&cache);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  if (!iree_hal_heap_buffer_cache_set(cache)) {
+    iree_allocator_free(host_allocator, cache);
+    return NULL;
+  }
+  return cache;
+}
+
+static bool iree_hal_heap_buffer_cache_is_cacheable(
+    iree_allocator_t host_allocator) {
+  return host_allocator.self == NULL &&
+         host_allocator.ctl == iree_allocator_system_ctl;
+}
+
+// Returns the slab bucket for a payload of |allocation_size| bytes allocated
+// from |host_allocator| and the payload size all slabs in the bucket have.
+static iree_host_size_t iree_hal_heap_buffer_cache_slab_bucket(
+    iree_allocator_t host_allocator, iree_device_size_t allocation_size,
+    iree_host_size_t* out_storage_size) {
+  if (allocation_size > IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE ||
+      !iree_hal_heap_buffer_cache_is_cacheable(host_allocator)) {
+    *out_storage_size = (iree_host_size_t)allocation_size;
+    return IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE;
+  }
+  const uint32_t storage_size = iree_math_round_up_to_pow2_u32(
+      iree_max((uint32_t)allocation_size, IREE_HAL_HEAP_BUFFER_ALIGNMENT));
+  *out_storage_size = storage_size;
+  return 1 + iree_math_count_trailing_zeros_u32(storage_size /
+                                                IREE_HAL_HEAP_BUFFER_ALIGNMENT);
+}
+
+// Returns a cached block from |bucket| or NULL if none is available.
+static void* iree_hal_heap_buffer_cache_acquire(iree_host_size_t bucket) {
+  if (bucket == IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE) return NULL;
+  iree_hal_heap_buffer_cache_t* cache = iree_hal_heap_buffer_cache_get();
+  if (!cache || !cache->counts[bucket]) return NULL;
+  return cache->entries[bucket][--cache->counts[bucket]];
+}
+
+// Retains |block| in |bucket| and returns true if there was space available.
+// If false is returned the caller must free the block.
+static bool iree_hal_heap_buffer_cache_release(iree_host_size_t bucket,
+                                               void* block) {
+  if (bucket == IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE) return false;
+  iree_hal_heap_buffer_cache_t* cache =
+      iree_hal_heap_buffer_cache_get_or_create();
+  if (!cache || cache->counts[bucket] >= IREE_HAL_HEAP_BUFFER_CACHE_CAPACITY) {
+    return false;
+  }
+  cache->entries[bucket][cache->counts[bucket]++] = block;
+  return true;
+}
+
+IREE_API_EXPORT void iree_hal_heap_buffer_trim_thread_cache(void) {
+  iree_hal_heap_buffer_cache_t* cache = iree_hal_heap_buffer_cache_get();
+  if (cache) iree_hal_heap_buffer_cache_trim(cache);
+}
+
+IREE_API_EXPORT iree_host_size_t iree_hal_heap_buffer_thread_cache_count(void) {
+  iree_hal_heap_buffer_cache_t* cache = iree_hal_heap_buffer_cache_get();
+  if (!cache) return 0;
+  iree_host_size_t count = 0;
+  for (iree_host_size_t bucket = 0;
+       bucket < IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_COUNT; ++bucket) {
+    count += cache->counts[bucket];
+  }
+  return count;
+}
+
+#else
+
+static bool iree_hal_heap_buffer_cache_is_cacheable(
+    iree_allocator_t host_allocator) {
+  return false;
+}
+
+static iree_host_size_t iree_hal_heap_buffer_cache_slab_bucket(
+    iree_allocator_t host_allocator, iree_device_size_t allocation_size,
+    iree_host_size_t* out_storage_size) {
+  *out_storage_size = (iree_host_size_t)allocation_size;
+  return IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE;
+}
+
+static void* iree_hal_heap_buffer_cache_acquire(iree_host_size_t bucket) {
+  return NULL;
+}
+
+static bool iree_hal_heap_buffer_cache_release(iree_host_size_t bucket,
+                                               void* block) {
+  return false;
+}
+
+IREE_API_EXPORT void iree_hal_heap_buffer_trim_thread_cache(void) {}
+
+IREE_API_EXPORT iree_host_size_t iree_hal_heap_buffer_thread_cache_count(void) {
+  return 0;
+}
+
+#endif  // IREE_HAL_HEAP_BUFFER_CACHE_ENABLE
+
+// Returns the cache bucket used for wrappers allocated from |host_allocator|.
+static iree_host_size_t iree_hal_heap_buffer_cache_wrapper_bucket(
+    iree_allocator_t host_allocator) {
+  return iree_hal_heap_buffer_cache_is_cacheable(host_allocator)
+             ? IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_WRAPPER
+             : IREE_HAL_HEAP_BUFFER_CACHE_BUCKET_NONE;
+}
+
+// Allocates a zeroed iree_hal_heap_buffer_t wrapper from |host_allocator|.
+static iree_status_t iree_hal_heap_buffer_allocate_wrapper(
+    iree_allocator_t host_allocator, iree_hal_heap_buffer_t** out_buffer) {
+  iree_hal_heap_buffer_t* buffer = (iree_hal_heap_buffer_t*)
+      iree_hal_heap_buffer_cache_acquire(
+          iree_hal_heap_buffer_cache_wrapper_bucket(host_allocator));
+  if (buffer) {
+    memset(buffer, 0, sizeof(*buffer));
+    *out_buffer = buffer;
+    return iree_ok_status();
+  }
+  return iree_allocator_malloc(host_allocator, sizeof(*buffer),
+                               (void**)out_buffer);
+}
+
+// Frees an iree_hal_heap_buffer_t wrapper allocated from |host_allocator|.
+static void iree_hal_heap_buffer_free_wrapper(iree_allocator_t host_allocator,
+                                              iree_hal_heap_buffer_t* buffer) {
+  if (!iree_hal_heap_buffer_cache_release(
+          iree_hal_heap_buffer_cache_wrapper_bucket(host_allocator), buffer)) {
+    iree_allocator_free(host_allocator, buffer);
+  }
+}
+
 // Allocates a buffer with the metadata and storage split.
 // This results in an additional host allocation but allows for user-overridden
 // data storage allocations.
@@ -71,8 +372,8 @@ static iree_status_t iree_hal_heap_buffer_allocate_split(
   out_data->data = data_ptr;
 
   // Allocate the host metadata wrapper with natural alignment.
-  iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(**out_buffer), (void**)out_buffer);
+  iree_status_t status =
+      iree_hal_heap_buffer_allocate_wrapper(host_allocator, out_buffer);
   if (!iree_status_is_ok(status)) {
     // Need to free the storage we just allocated.
     iree_allocator_free_aligned(data_allocator, out_data->data);
@@ -91,14 +392,26 @@ static iree_status_t iree_hal_heap_buffer_allocate_slab(
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_host_size_t header_size =
       iree_host_align(iree_sizeof_struct(*buffer), iree_max_align_t);
-  iree_host_size_t total_size = header_size + allocation_size;
 
-  // Allocate with the data starting at offset header_size aligned to the
-  // minimum required buffer alignment. The header itself will still be aligned
-  // to the natural alignment but our buffer alignment is often much larger.
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned(
-      host_allocator, total_size, IREE_HAL_HEAP_BUFFER_ALIGNMENT, header_size,
-      (void**)&buffer));
+  // Small slabs are rounded up to their cache bucket size so that they can be
+  // reused by any allocation in the same bucket.
+  iree_host_size_t storage_size = 0;
+  iree_host_size_t bucket = iree_hal_heap_buffer_cache_slab_bucket(
+      host_allocator, allocation_size, &storage_size);
+  buffer = (iree_hal_heap_buffer_t*)iree_hal_heap_buffer_cache_acquire(bucket);
+  if (buffer) {
+    // Match the zero-initialization performed by the allocator.
+    memset(buffer, 0, header_size + (iree_host_size_t)allocation_size);
+  } else {
+    // Allocate with the data starting at offset header_size aligned to the
+    // minimum required buffer alignment. The header itself will still be
+    // aligned to the natural alignment but our buffer alignment is often much
+    // larger.
+    iree_host_size_t total_size = header_size + storage_size;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned(
+        host_allocator, total_size, IREE_HAL_HEAP_BUFFER_ALIGNMENT, header_size,
+        (void**)&buffer));
+  }
   *out_buffer = buffer;
 
   // Set bit indicating that we need to free the metadata with
@@ -198,7 +511,7 @@ iree_status_t iree_hal_heap_buffer_wrap(
       iree_hal_allocator_host_allocator(allocator);
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_status_t status =
-      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
+      iree_hal_heap_buffer_allocate_wrapper(host_allocator, &buffer);
   if (iree_status_is_ok(status)) {
     iree_hal_buffer_initialize(host_allocator, allocator, &buffer->base,
                                allocation_size, 0, data.data_length,
@@ -234,12 +547,17 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
 
   switch (buffer->base.flags) {
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB: {
-      iree_allocator_free_aligned(host_allocator, buffer);
+      iree_host_size_t storage_size = 0;
+      iree_host_size_t bucket = iree_hal_heap_buffer_cache_slab_bucket(
+          host_allocator, base_buffer->allocation_size, &storage_size);
+      if (!iree_hal_heap_buffer_cache_release(bucket, buffer)) {
+        iree_allocator_free_aligned(host_allocator, buffer);
+      }
       break;
     }
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT: {
       iree_allocator_free(buffer->data_allocator, buffer->data.data);
-      iree_allocator_free(host_allocator, buffer);
+      iree_hal_heap_buffer_free_wrapper(host_allocator, buffer);
       break;
     }
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL: {
@@ -247,7 +565,7 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
         buffer->release_callback.fn(buffer->release_callback.user_data,
                                     base_buffer);
       }
-      iree_allocator_free(host_allocator, buffer);
+      iree_hal_heap_buffer_free_wrapper(host_allocator, buffer);
       break;
     }
     default:
@@ -0,0 +1,168 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Size of the small buffers used by the tests; well under the cache limit.
+static const iree_device_size_t kSmallBufferSize = 64;
+
+// Number of buffers released at once to overflow the per-thread cache.
+static const int kOverflowBufferCount = 64;
+
+class HeapBufferCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+#if !IREE_HAL_HEAP_BUFFER_CACHE_ENABLE
+    GTEST_SKIP() << "heap buffer cache disabled in this build";
+#endif  // !IREE_HAL_HEAP_BUFFER_CACHE_ENABLE
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    iree_hal_heap_buffer_trim_thread_cache();
+  }
+
+  void TearDown() override {
+    iree_hal_heap_buffer_trim_thread_cache();
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t allocation_size,
+                                    uint8_t fill_value) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING |
+                   IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE;
+    std::vector<uint8_t> initial_data(allocation_size, fill_value);
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, allocation_size,
+        iree_make_const_byte_span(initial_data.data(), initial_data.size()),
+        &buffer));
+    return buffer;
+  }
+
+  // Returns true if every byte of |buffer| is |value|.
+  static bool BufferContains(iree_hal_buffer_t* buffer, uint8_t value) {
+    std::vector<uint8_t> contents(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(iree_hal_buffer_map_read(buffer, 0, contents.data(),
+                                           contents.size()));
+    for (uint8_t byte : contents) {
+      if (byte != value) return false;
+    }
+    return true;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+};
+
+// Released small buffers are retained by the thread and reused.
+TEST_F(HeapBufferCacheTest, ReleasedBuffersAreReused) {
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+
+  iree_hal_buffer_release(AllocateBuffer(kSmallBufferSize, 0xCD));
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 1);
+
+  // The reused block must be fully initialized for the new buffer.
+  iree_hal_buffer_t* buffer = AllocateBuffer(kSmallBufferSize - 8, 0x12);
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer), kSmallBufferSize - 8);
+  EXPECT_TRUE(BufferContains(buffer, 0x12));
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 1);
+
+  iree_hal_heap_buffer_trim_thread_cache();
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+}
+
+// Buffers larger than the cache limit always go back to the allocator.
+TEST_F(HeapBufferCacheTest, LargeBuffersAreNotRetained) {
+  iree_hal_buffer_release(
+      AllocateBuffer(IREE_HAL_HEAP_BUFFER_CACHE_MAX_SIZE + 1, 0xCD));
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+}
+
+// Releasing more buffers than the cache holds frees the excess immediately.
+TEST_F(HeapBufferCacheTest, Overflow) {
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (int i = 0; i < kOverflowBufferCount; ++i) {
+    buffers.push_back(AllocateBuffer(kSmallBufferSize, (uint8_t)i));
+  }
+  for (iree_hal_buffer_t* buffer : buffers) {
+    iree_hal_buffer_release(buffer);
+  }
+  const iree_host_size_t retained_count =
+      iree_hal_heap_buffer_thread_cache_count();
+  EXPECT_GT(retained_count, 0);
+  EXPECT_LT(retained_count, (iree_host_size_t)kOverflowBufferCount);
+
+  // All retained blocks can be reused and the cache drains without going
+  // negative when more are requested than it holds.
+  for (int i = 0; i < kOverflowBufferCount; ++i) {
+    buffers[i] = AllocateBuffer(kSmallBufferSize, (uint8_t)i);
+    EXPECT_TRUE(BufferContains(buffers[i], (uint8_t)i));
+  }
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+  for (iree_hal_buffer_t* buffer : buffers) {
+    iree_hal_buffer_release(buffer);
+  }
+}
+
+// A buffer released on another thread is retained by the releasing thread.
+TEST_F(HeapBufferCacheTest, ReleasedOnAnotherThread) {
+  iree_hal_buffer_t* buffer = AllocateBuffer(kSmallBufferSize, 0xCD);
+  iree_host_size_t releasing_thread_count = 0;
+  std::thread thread([&]() {
+    iree_hal_buffer_release(buffer);
+    releasing_thread_count = iree_hal_heap_buffer_thread_cache_count();
+    iree_hal_heap_buffer_trim_thread_cache();
+  });
+  thread.join();
+  EXPECT_EQ(releasing_thread_count, 1);
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+}
+
+// Threads that exit with blocks in their cache free them on exit. Sanitizer
+// builds disable the cache by default; build with ASan and
+// -DIREE_HAL_HEAP_BUFFER_CACHE_ENABLE=1 for the leak checker to report any
+// blocks that are not freed.
+TEST_F(HeapBufferCacheTest, ThreadExitWithNonEmptyCache) {
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (int i = 0; i < kOverflowBufferCount; ++i) {
+    buffers.push_back(AllocateBuffer(kSmallBufferSize << (i % 4), 0xCD));
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i]() {
+      // Each thread releases its share of the buffers, allocates and releases
+      // a few of its own, and exits without trimming.
+      for (int j = i; j < kOverflowBufferCount; j += 4) {
+        iree_hal_buffer_release(buffers[j]);
+      }
+      for (int j = 0; j < 4; ++j) {
+        iree_hal_buffer_release(AllocateBuffer(kSmallBufferSize, 0xEF));
+      }
+      EXPECT_GT(iree_hal_heap_buffer_thread_cache_count(), 0);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(iree_hal_heap_buffer_thread_cache_count(), 0);
+}
+
+}  // namespace
@@ -7,6 +7,7 @@
 #include "iree/hal/buffer_view.h"
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer_view_util.h"
@@ -15,14 +16,46 @@
 struct iree_hal_buffer_view_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
-  iree_hal_buffer_t* buffer;
+  // Pool the buffer view returns to when released, retained. NULL if the
+  // buffer view was allocated directly from |host_allocator|.
+  iree_hal_buffer_view_pool_t* pool;
+  union {
+    // Buffer being viewed, retained. Valid while the buffer view is live.
+    iree_hal_buffer_t* buffer;
+    // Next free buffer view in the pool. Valid while the buffer view is in the
+    // pool free list.
+    iree_hal_buffer_view_t* next_free;
+  };
   iree_hal_element_type_t element_type;
   iree_hal_encoding_type_t encoding_type;
   iree_device_size_t byte_length;
   iree_host_size_t shape_rank;
+  // Total number of dimensions that can be stored in |shape|.
+  iree_host_size_t shape_capacity;
   iree_hal_dim_t shape[];
 };
 
+// Assigns |buffer| and the shape and type metadata to |buffer_view|.
+// The shape must fit within the buffer view shape capacity. The previously
+// assigned buffer (if any) is not released.
+static void iree_hal_buffer_view_assign(
+    iree_hal_buffer_view_t* buffer_view, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type) {
+  buffer_view->buffer = buffer;
+  iree_hal_buffer_retain(buffer_view->buffer);
+  buffer_view->element_type = element_type;
+  buffer_view->encoding_type = encoding_type;
+  buffer_view->byte_length =
+      iree_hal_element_dense_byte_count(buffer_view->element_type);
+  buffer_view->shape_rank = shape_rank;
+  for (iree_host_size_t i = 0; i < shape_rank; ++i) {
+    buffer_view->shape[i] = shape[i];
+    buffer_view->byte_length *= shape[i];
+  }
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_buffer_view_create(
     iree_hal_buffer_t* buffer, iree_host_size_t shape_rank,
     const iree_hal_dim_t* shape, iree_hal_element_type_t element_type,
@@ -49,17 +82,10 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_create(
   if (iree_status_is_ok(status)) {
     iree_atomic_ref_count_init(&buffer_view->ref_count);
     buffer_view->host_allocator = host_allocator;
-    buffer_view->buffer = buffer;
-    iree_hal_buffer_retain(buffer_view->buffer);
-    buffer_view->element_type = element_type;
-    buffer_view->encoding_type = encoding_type;
-    buffer_view->byte_length =
-        iree_hal_element_dense_byte_count(buffer_view->element_type);
-    buffer_view->shape_rank = shape_rank;
-    for (iree_host_size_t i = 0; i < shape_rank; ++i) {
-      buffer_view->shape[i] = shape[i];
-      buffer_view->byte_length *= shape[i];
-    }
+    buffer_view->pool = NULL;
+    buffer_view->shape_capacity = shape_rank;
+    iree_hal_buffer_view_assign(buffer_view, buffer, shape_rank, shape,
+                                element_type, encoding_type);
     *out_buffer_view = buffer_view;
   }
 
@@ -93,15 +119,56 @@ IREE_API_EXPORT void iree_hal_buffer_view_release(
   }
 }
 
+static void iree_hal_buffer_view_pool_recycle(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_view_t* buffer_view);
+
 IREE_API_EXPORT void iree_hal_buffer_view_destroy(
     iree_hal_buffer_view_t* buffer_view) {
   iree_allocator_t host_allocator = buffer_view->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_buffer_release(buffer_view->buffer);
-  iree_allocator_free(host_allocator, buffer_view);
+  buffer_view->buffer = NULL;
+  if (buffer_view->pool) {
+    iree_hal_buffer_view_pool_recycle(buffer_view->pool, buffer_view);
+  } else {
+    iree_allocator_free(host_allocator, buffer_view);
+  }
   IREE_TRACE_ZONE_END(z0);
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_rebind(
+    iree_hal_buffer_view_t* buffer_view, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type) {
+  IREE_ASSERT_ARGUMENT(buffer_view);
+  IREE_ASSERT_ARGUMENT(buffer);
+  if (IREE_UNLIKELY(shape_rank > 0 && !shape)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "no shape dimensions specified");
+  }
+  if (IREE_UNLIKELY(shape_rank > buffer_view->shape_capacity)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "buffer view shape storage cannot hold rank %zu "
+                            "(capacity=%zu)",
+                            shape_rank, buffer_view->shape_capacity);
+  }
+  if (IREE_UNLIKELY(iree_atomic_ref_count_load(&buffer_view->ref_count) !=
+                    1)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "buffer views can only be rebound when exclusively "
+                            "owned by the caller");
+  }
+
+  // Retain the new buffer before releasing the old one in case they are the
+  // same and we hold the last reference.
+  iree_hal_buffer_t* old_buffer = buffer_view->buffer;
+  iree_hal_buffer_view_assign(buffer_view, buffer, shape_rank, shape,
+                              element_type, encoding_type);
+  iree_hal_buffer_release(old_buffer);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_hal_buffer_t* iree_hal_buffer_view_buffer(
     const iree_hal_buffer_view_t* buffer_view) {
   IREE_ASSERT_ARGUMENT(buffer_view);
@@ -244,3 +311,171 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_compute_range(
       buffer_view->encoding_type, indices_count, start_indices, lengths_count,
       lengths, out_start_offset, out_length);
 }
+
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_view_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_buffer_view_pool_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Maximum number of free buffer views retained in the pool.
+  iree_host_size_t capacity;
+  // Guards the free list. Held only for the list push/pop.
+  iree_slim_mutex_t mutex;
+  // Number of buffer views in |free_head|.
+  iree_host_size_t free_count IREE_GUARDED_BY(mutex);
+  // LIFO list of free buffer views linked with next_free.
+  iree_hal_buffer_view_t* free_head IREE_GUARDED_BY(mutex);
+};
+
+// Size in bytes of a pooled buffer view including its inline shape storage.
+static iree_host_size_t iree_hal_buffer_view_pool_view_size(void) {
+  return sizeof(iree_hal_buffer_view_t) +
+         sizeof(iree_hal_dim_t) * IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_create(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_buffer_view_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  iree_atomic_ref_count_init(&pool->ref_count);
+  pool->host_allocator = host_allocator;
+  pool->capacity = capacity;
+  iree_slim_mutex_initialize(&pool->mutex);
+  pool->free_count = 0;
+  pool->free_head = NULL;
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_buffer_view_pool_destroy(
+    iree_hal_buffer_view_pool_t* pool) {
+  iree_allocator_t host_allocator = pool->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_view_pool_trim(pool);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_retain(
+    iree_hal_buffer_view_pool_t* pool) {
+  if (IREE_LIKELY(pool)) {
+    iree_atomic_ref_count_inc(&pool->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_release(
+    iree_hal_buffer_view_pool_t* pool) {
+  if (IREE_LIKELY(pool) && iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_hal_buffer_view_pool_destroy(pool);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_trim(
+    iree_hal_buffer_view_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_buffer_view_t* free_head = pool->free_head;
+  pool->free_head = NULL;
+  pool->free_count = 0;
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  while (free_head) {
+    iree_hal_buffer_view_t* next_free = free_head->next_free;
+    iree_allocator_free(pool->host_allocator, free_head);
+    free_head = next_free;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_acquire(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Shapes that don't fit in the inline storage are rare enough that we just
+  // allocate them directly.
+  if (shape_rank > IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK) {
+    iree_status_t status = iree_hal_buffer_view_create(
+        buffer, shape_rank, shape, element_type, encoding_type,
+        pool->host_allocator, out_buffer_view);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  *out_buffer_view = NULL;
+  if (IREE_UNLIKELY(shape_rank > 0 && !shape)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "no shape dimensions specified");
+  }
+
+  // Try to reuse a free buffer view and otherwise allocate a new one.
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_buffer_view_t* buffer_view = pool->free_head;
+  if (buffer_view) {
+    pool->free_head = buffer_view->next_free;
+    --pool->free_count;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (!buffer_view) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(pool->host_allocator,
+                                  iree_hal_buffer_view_pool_view_size(),
+                                  (void**)&buffer_view));
+    buffer_view->host_allocator = pool->host_allocator;
+    buffer_view->shape_capacity = IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK;
+  }
+
+  // Each live buffer view keeps the pool alive so that it can be returned even
+  // if the owner of the pool has released it.
+  iree_atomic_ref_count_init(&buffer_view->ref_count);
+  buffer_view->pool = pool;
+  iree_hal_buffer_view_pool_retain(pool);
+  buffer_view->next_free = NULL;
+  iree_hal_buffer_view_assign(buffer_view, buffer, shape_rank, shape,
+                              element_type, encoding_type);
+
+  *out_buffer_view = buffer_view;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Returns |buffer_view| to |pool| after its buffer has been released.
+// The buffer view is freed if the pool is at capacity.
+static void iree_hal_buffer_view_pool_recycle(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_view_t* buffer_view) {
+  buffer_view->pool = NULL;
+  bool retained = false;
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool->free_count < pool->capacity) {
+    buffer_view->next_free = pool->free_head;
+    pool->free_head = buffer_view;
+    ++pool->free_count;
+    retained = true;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (!retained) {
+    iree_allocator_free(pool->host_allocator, buffer_view);
+  }
+  iree_hal_buffer_view_pool_release(pool);
+}
@@ -207,6 +207,19 @@ IREE_API_EXPORT void iree_hal_buffer_view_retain(
 IREE_API_EXPORT void iree_hal_buffer_view_release(
     iree_hal_buffer_view_t* buffer_view);
 
+// Rebinds |buffer_view| in-place to view |buffer| with the given shape and
+// type metadata. This avoids reallocating the buffer view when the caller is
+// recycling it for a new result. The buffer view must be exclusively owned by
+// the caller and |shape_rank| must fit within the shape storage of the buffer
+// view: buffer views from an iree_hal_buffer_view_pool_t can hold up to
+// IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK dimensions and others only as many as they
+// were created with.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_rebind(
+    iree_hal_buffer_view_t* buffer_view, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type);
+
 // Returns the buffer underlying the buffer view.
 // The caller must retain the returned buffer if they want to continue using it.
 //
@@ -283,6 +296,56 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_compute_range(
     const iree_hal_dim_t* lengths, iree_device_size_t* out_start_offset,
     iree_device_size_t* out_length);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_view_pool_t
+//===----------------------------------------------------------------------===//
+
+// Maximum shape rank of buffer views stored inline in pooled buffer views.
+// Buffer views with larger ranks acquired from a pool are allocated directly.
+#if !defined(IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK)
+#define IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK 6
+#endif  // !IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK
+
+// A thread-safe free list of buffer views used to avoid host allocations when
+// buffer views are frequently created and released, such as for the inputs
+// and outputs of each invocation. Pools are usually owned per device or per
+// context.
+//
+// Buffer views acquired from the pool are normal buffer views and are returned
+// to the pool when their last reference is released. Each live buffer view
+// retains the pool so the owner may release the pool at any time.
+typedef struct iree_hal_buffer_view_pool_t iree_hal_buffer_view_pool_t;
+
+// Creates a buffer view pool retaining up to |capacity| free buffer views.
+// |out_pool| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_create(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_buffer_view_pool_t** out_pool);
+
+// Retains the given |pool| for the caller.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_retain(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Releases the given |pool| from the caller.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_release(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Frees all free buffer views retained by the pool.
+// Live buffer views are unaffected and will return to the pool when released.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_trim(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Acquires a buffer view from the |pool| viewing |buffer|.
+// Behaves like iree_hal_buffer_view_create but reuses a free buffer view when
+// available.
+// |out_buffer_view| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_acquire(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type,
+    iree_hal_buffer_view_t** out_buffer_view);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_t implementation details
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,283 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::iree::Status;
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+class BufferViewTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    buffer_ = AllocateBuffer();
+  }
+
+  void TearDown() override {
+    iree_hal_buffer_release(buffer_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_hal_buffer_t* AllocateBuffer() {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, 1024, iree_const_byte_span_empty(),
+        &buffer));
+    return buffer;
+  }
+
+  // Returns a shape of |rank| dimensions all of size 1.
+  static std::vector<iree_hal_dim_t> MakeShape(iree_host_size_t rank) {
+    return std::vector<iree_hal_dim_t>(rank, 1);
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_buffer_t* buffer_ = NULL;
+};
+
+// Released buffer views are returned to the pool and reused.
+TEST_F(BufferViewTest, PoolReusesReleasedViews) {
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(4, iree_allocator_system(), &pool));
+
+  iree_hal_dim_t shape[2] = {4, 8};
+  iree_hal_buffer_view_t* view_a = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &view_a));
+  EXPECT_EQ(iree_hal_buffer_view_buffer(view_a), buffer_);
+  EXPECT_EQ(iree_hal_buffer_view_shape_rank(view_a), 2);
+  EXPECT_EQ(iree_hal_buffer_view_byte_length(view_a), 4 * 8 * 4);
+  iree_hal_buffer_view_release(view_a);
+
+  // The reacquired view is the same storage with the new metadata.
+  iree_hal_buffer_t* other_buffer = AllocateBuffer();
+  iree_hal_dim_t other_shape[1] = {3};
+  iree_hal_buffer_view_t* view_b = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, other_buffer, IREE_ARRAYSIZE(other_shape), other_shape,
+      IREE_HAL_ELEMENT_TYPE_INT_8, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      &view_b));
+  iree_hal_buffer_release(other_buffer);
+  EXPECT_EQ(view_b, view_a);
+  EXPECT_EQ(iree_hal_buffer_view_buffer(view_b), other_buffer);
+  EXPECT_EQ(iree_hal_buffer_view_shape_rank(view_b), 1);
+  EXPECT_EQ(iree_hal_buffer_view_shape_dim(view_b, 0), 3);
+  EXPECT_EQ(iree_hal_buffer_view_element_type(view_b),
+            IREE_HAL_ELEMENT_TYPE_INT_8);
+  EXPECT_EQ(iree_hal_buffer_view_byte_length(view_b), 3);
+  iree_hal_buffer_view_release(view_b);
+
+  iree_hal_buffer_view_pool_release(pool);
+}
+
+// Views released beyond the pool capacity are freed instead of retained.
+TEST_F(BufferViewTest, PoolCapacity) {
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(1, iree_allocator_system(), &pool));
+
+  iree_hal_buffer_view_t* views[3] = {NULL};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(views); ++i) {
+    IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+        pool, buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &views[i]));
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(views); ++i) {
+    iree_hal_buffer_view_release(views[i]);
+  }
+
+  // Only the first released view was retained.
+  iree_hal_buffer_view_t* view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &view));
+  EXPECT_EQ(view, views[0]);
+  iree_hal_buffer_view_release(view);
+
+  iree_hal_buffer_view_pool_release(pool);
+}
+
+// Shapes above IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK are allocated directly and
+// do not consume or return pooled views.
+TEST_F(BufferViewTest, PoolFallbackAboveMaxRank) {
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(4, iree_allocator_system(), &pool));
+
+  // Seed the pool with one free view.
+  iree_hal_buffer_view_t* pooled_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &pooled_view));
+  iree_hal_buffer_view_release(pooled_view);
+
+  std::vector<iree_hal_dim_t> large_shape =
+      MakeShape(IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK + 1);
+  iree_hal_buffer_view_t* large_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, large_shape.size(), large_shape.data(),
+      IREE_HAL_ELEMENT_TYPE_INT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      &large_view));
+  EXPECT_NE(large_view, pooled_view);
+  EXPECT_EQ(iree_hal_buffer_view_shape_rank(large_view), large_shape.size());
+
+  // The directly-allocated view only holds the rank it was created with.
+  std::vector<iree_hal_dim_t> larger_shape =
+      MakeShape(IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK + 2);
+  EXPECT_THAT(Status(iree_hal_buffer_view_rebind(
+                  large_view, buffer_, larger_shape.size(),
+                  larger_shape.data(), IREE_HAL_ELEMENT_TYPE_INT_32,
+                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+              StatusIs(StatusCode::kOutOfRange));
+  iree_hal_buffer_view_release(large_view);
+
+  // The free view is still in the pool.
+  iree_hal_buffer_view_t* view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &view));
+  EXPECT_EQ(view, pooled_view);
+  iree_hal_buffer_view_release(view);
+
+  iree_hal_buffer_view_pool_release(pool);
+}
+
+// Live views keep the pool alive after its owner releases it.
+TEST_F(BufferViewTest, PoolOutlivesOwner) {
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(4, iree_allocator_system(), &pool));
+
+  iree_hal_dim_t shape[1] = {16};
+  iree_hal_buffer_view_t* view_a = NULL;
+  iree_hal_buffer_view_t* view_b = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &view_a));
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &view_b));
+  iree_hal_buffer_view_pool_release(pool);
+
+  // The first release returns the view to the still-live pool and the last
+  // release destroys the pool along with its free views.
+  EXPECT_EQ(iree_hal_buffer_view_shape_dim(view_a, 0), 16);
+  iree_hal_buffer_view_release(view_a);
+  EXPECT_EQ(iree_hal_buffer_view_shape_dim(view_b, 0), 16);
+  iree_hal_buffer_view_release(view_b);
+}
+
+// Rebinding to the buffer already viewed keeps it alive.
+TEST_F(BufferViewTest, RebindSameBuffer) {
+  iree_hal_buffer_t* buffer = AllocateBuffer();
+  iree_hal_dim_t shape[2] = {2, 2};
+  iree_hal_buffer_view_t* view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_create(
+      buffer, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, iree_allocator_system(), &view));
+  // The view now holds the only reference to the buffer.
+  iree_hal_buffer_release(buffer);
+
+  iree_hal_dim_t new_shape[1] = {4};
+  IREE_ASSERT_OK(iree_hal_buffer_view_rebind(
+      view, buffer, IREE_ARRAYSIZE(new_shape), new_shape,
+      IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR));
+  EXPECT_EQ(iree_hal_buffer_view_buffer(view), buffer);
+  EXPECT_EQ(iree_hal_buffer_view_shape_rank(view), 1);
+  EXPECT_EQ(iree_hal_buffer_view_shape_dim(view, 0), 4);
+  EXPECT_EQ(iree_hal_buffer_view_element_type(view),
+            IREE_HAL_ELEMENT_TYPE_FLOAT_32);
+  EXPECT_EQ(iree_hal_buffer_view_byte_length(view), 4 * 4);
+  EXPECT_EQ(iree_hal_buffer_byte_length(iree_hal_buffer_view_buffer(view)),
+            1024);
+  iree_hal_buffer_view_release(view);
+}
+
+// Rebinding fails if the shape does not fit the view shape storage.
+TEST_F(BufferViewTest, RebindRankAboveCapacity) {
+  iree_hal_dim_t shape[2] = {2, 2};
+  iree_hal_buffer_view_t* view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_create(
+      buffer_, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, iree_allocator_system(), &view));
+
+  iree_hal_dim_t new_shape[3] = {2, 2, 2};
+  EXPECT_THAT(Status(iree_hal_buffer_view_rebind(
+                  view, buffer_, IREE_ARRAYSIZE(new_shape), new_shape,
+                  IREE_HAL_ELEMENT_TYPE_INT_32,
+                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+              StatusIs(StatusCode::kOutOfRange));
+  // The view is unchanged.
+  EXPECT_EQ(iree_hal_buffer_view_shape_rank(view), 2);
+
+  // Pooled views can be rebound up to IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK.
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(1, iree_allocator_system(), &pool));
+  iree_hal_buffer_view_t* pooled_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, &pooled_view));
+  std::vector<iree_hal_dim_t> max_shape =
+      MakeShape(IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK);
+  IREE_EXPECT_OK(iree_hal_buffer_view_rebind(
+      pooled_view, buffer_, max_shape.size(), max_shape.data(),
+      IREE_HAL_ELEMENT_TYPE_INT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR));
+  std::vector<iree_hal_dim_t> large_shape =
+      MakeShape(IREE_HAL_BUFFER_VIEW_POOL_MAX_RANK + 1);
+  EXPECT_THAT(Status(iree_hal_buffer_view_rebind(
+                  pooled_view, buffer_, large_shape.size(), large_shape.data(),
+                  IREE_HAL_ELEMENT_TYPE_INT_32,
+                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+              StatusIs(StatusCode::kOutOfRange));
+  iree_hal_buffer_view_release(pooled_view);
+  iree_hal_buffer_view_pool_release(pool);
+
+  iree_hal_buffer_view_release(view);
+}
+
+// Rebinding fails if other references to the view exist.
+TEST_F(BufferViewTest, RebindSharedView) {
+  iree_hal_buffer_view_t* view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_create(
+      buffer_, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, iree_allocator_system(), &view));
+  iree_hal_buffer_view_retain(view);
+
+  iree_hal_buffer_t* other_buffer = AllocateBuffer();
+  EXPECT_THAT(Status(iree_hal_buffer_view_rebind(
+                  view, other_buffer, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_8,
+                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_EQ(iree_hal_buffer_view_buffer(view), buffer_);
+
+  // Once exclusively owned again the rebind succeeds.
+  iree_hal_buffer_view_release(view);
+  IREE_EXPECT_OK(iree_hal_buffer_view_rebind(
+      view, other_buffer, 0, NULL, IREE_HAL_ELEMENT_TYPE_INT_8,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR));
+  EXPECT_EQ(iree_hal_buffer_view_buffer(view), other_buffer);
+  iree_hal_buffer_release(other_buffer);
+  iree_hal_buffer_view_release(view);
+}
+
+}  // namespace
@@ -7,6 +7,9 @@
 #ifndef IREE_HAL_CTS_ALLOCATOR_TEST_H_
 #define IREE_HAL_CTS_ALLOCATOR_TEST_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/cts/cts_test_base.h"
@@ -21,9 +24,74 @@ namespace {
 
 constexpr iree_device_size_t kAllocationSize = 1024;
 
+// Alignment of host allocations used for import tests. Larger than a page so
+// that drivers widening imports to their required alignment (usually a page)
+// stay within the allocation.
+constexpr iree_host_size_t kImportAlignment = 64 * 1024;
+
 }  // namespace
 
-class allocator_test : public CtsTestBase {};
+class allocator_test : public CtsTestBase {
+ protected:
+  void SetUp() override {
+    CtsTestBase::SetUp();
+    if (IsSkipped()) return;
+    IREE_ASSERT_OK(iree_allocator_malloc_aligned(
+        iree_allocator_system(), kImportAlignment, kImportAlignment,
+        /*offset=*/0, (void**)&host_data_));
+    for (iree_host_size_t i = 0; i < kImportAlignment; ++i) {
+      host_data_[i] = (uint8_t)(i * 7 + 3);
+    }
+  }
+
+  void TearDown() override {
+    if (host_data_) {
+      iree_allocator_free_aligned(iree_allocator_system(), host_data_);
+    }
+    host_data_ = NULL;
+    CtsTestBase::TearDown();
+  }
+
+  static void CountRelease(void* user_data, iree_hal_buffer_t* buffer) {
+    ++*(int*)user_data;
+  }
+
+  // Imports |length| bytes of |host_data_| starting at |offset| with |params|.
+  // Returns the status of the import; drivers may decline any import.
+  iree_status_t ImportHostData(iree_hal_buffer_params_t params,
+                               iree_host_size_t offset,
+                               iree_device_size_t length,
+                               iree_hal_buffer_t** out_buffer) {
+    iree_hal_external_buffer_t external_buffer;
+    memset(&external_buffer, 0, sizeof(external_buffer));
+    external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+    external_buffer.flags = 0;
+    external_buffer.size = length;
+    external_buffer.handle.host_allocation.ptr = host_data_ + offset;
+    iree_hal_buffer_release_callback_t release_callback = {
+        CountRelease, &release_count_};
+    return iree_hal_allocator_import_buffer(device_allocator_, params,
+                                            &external_buffer, release_callback,
+                                            out_buffer);
+  }
+
+  // Copies |buffer| back to the host and verifies it aliases the host data
+  // starting at |offset|.
+  void CheckImportedContents(iree_hal_buffer_t* buffer,
+                             iree_host_size_t offset,
+                             iree_device_size_t length) {
+    std::vector<uint8_t> actual_data(length);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, buffer, /*source_offset=*/0, actual_data.data(), length,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    std::vector<uint8_t> expected_data(host_data_ + offset,
+                                       host_data_ + offset + length);
+    EXPECT_EQ(expected_data, actual_data);
+  }
+
+  uint8_t* host_data_ = NULL;
+  int release_count_ = 0;
+};
 
 // All allocators must support some baseline capabilities.
 //
@@ -115,6 +183,81 @@ TEST_P(allocator_test, AllocateEmptyBuffer) {
   iree_hal_buffer_release(buffer);
 }
 
+// Host allocations imported as host-local memory must alias the host data and
+// notify the owner when the buffer is released.
+TEST_P(allocator_test, ImportHostAllocation) {
+  iree_hal_buffer_params_t params = {0};
+  params.type =
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  params.usage =
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE;
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status =
+      ImportHostData(params, /*offset=*/0, kImportAlignment, &buffer);
+  if (iree_status_is_unavailable(status) ||
+      iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "Host allocation import not supported, skipping test.";
+  }
+  IREE_ASSERT_OK(status);
+  EXPECT_GE(iree_hal_buffer_byte_length(buffer), kImportAlignment);
+  CheckImportedContents(buffer, /*offset=*/0, kImportAlignment);
+
+  EXPECT_EQ(0, release_count_);
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(1, release_count_);
+}
+
+// Host pointers need not be aligned to what the device requires for imports.
+// Drivers that must import whole pages widen the range and offset into it.
+TEST_P(allocator_test, ImportUnalignedHostAllocation) {
+  iree_hal_buffer_params_t params = {0};
+  params.type =
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  params.usage =
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE;
+  const iree_host_size_t offset = 64;
+  const iree_device_size_t length = kAllocationSize - 24;
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = ImportHostData(params, offset, length, &buffer);
+  if (iree_status_is_unavailable(status) ||
+      iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "Host allocation import not supported, skipping test.";
+  }
+  IREE_ASSERT_OK(status);
+  EXPECT_EQ(length, iree_hal_buffer_byte_length(buffer));
+  CheckImportedContents(buffer, offset, length);
+
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(1, release_count_);
+}
+
+// Immutable constants (such as rodata mapped from a module file) may be
+// imported as device-local memory where the device can access host memory
+// directly, such as on integrated devices. Devices that would need to copy
+// instead must decline so that callers fall back to allocating and copying.
+TEST_P(allocator_test, ImportHostAllocationAsConstant) {
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                 IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                 IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE;
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status =
+      ImportHostData(params, /*offset=*/0, kImportAlignment, &buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    EXPECT_EQ(NULL, buffer);
+    GTEST_SKIP() << "Device-local import declined, skipping test.";
+  }
+  CheckImportedContents(buffer, /*offset=*/0, kImportAlignment);
+
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(1, release_count_);
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
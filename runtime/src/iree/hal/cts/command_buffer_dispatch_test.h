@@ -7,6 +7,8 @@
 #ifndef IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 #define IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 
+#include <cmath>
+
 #include "iree/base/api.h"
 #include "iree/base/string_view.h"
 #include "iree/hal/api.h"
@@ -165,6 +167,116 @@ TEST_P(command_buffer_dispatch_test, DispatchAbs) {
   CleanupExecutable();
 }
 
+// Records the dispatch once into a reusable nested command buffer that sources
+// its buffers from a binding table and executes it twice with different tables.
+TEST_P(command_buffer_dispatch_test, DispatchAbsWithBindingTable) {
+  PrepareAbsExecutable();
+
+  iree_hal_command_buffer_t* nested_command_buffer = NULL;
+  iree_status_t status = iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested_command_buffer);
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_free(status);
+    CleanupExecutable();
+    GTEST_SKIP() << "nested command buffers not supported";
+  }
+  IREE_ASSERT_OK(status);
+
+  // Binding 0 reads from table slot 0 and binding 1 writes to table slot 1.
+  iree_hal_descriptor_set_binding_t descriptor_set_bindings[] = {
+      {
+          /*binding=*/0,
+          /*buffer_slot=*/0,
+          /*buffer=*/NULL,
+          /*offset=*/0,
+          sizeof(float),
+      },
+      {
+          /*binding=*/1,
+          /*buffer_slot=*/1,
+          /*buffer=*/NULL,
+          /*offset=*/0,
+          sizeof(float),
+      },
+  };
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested_command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+      nested_command_buffer, pipeline_layout_, /*set=*/0,
+      IREE_ARRAYSIZE(descriptor_set_bindings), descriptor_set_bindings));
+  IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(
+      nested_command_buffer, executable_, /*entry_point=*/0,
+      /*workgroup_x=*/1, /*workgroup_y=*/1, /*workgroup_z=*/1));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested_command_buffer));
+
+  // Each execution gets its own input and output buffers.
+  iree_hal_buffer_params_t params = {0};
+  params.type =
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                 IREE_HAL_BUFFER_USAGE_TRANSFER |
+                 IREE_HAL_BUFFER_USAGE_MAPPING;
+  const float input_values[2] = {-2.5f, 7.0f};
+  iree_hal_buffer_t* input_buffers[2] = {NULL, NULL};
+  iree_hal_buffer_t* output_buffers[2] = {NULL, NULL};
+  for (int i = 0; i < 2; ++i) {
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, sizeof(float),
+        iree_make_const_byte_span(&input_values[i], sizeof(float)),
+        &input_buffers[i]));
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, sizeof(float), iree_const_byte_span_empty(),
+        &output_buffers[i]));
+  }
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  for (int i = 0; i < 2; ++i) {
+    const iree_hal_buffer_binding_t bindings[2] = {
+        {input_buffers[i], /*offset=*/0, sizeof(float)},
+        {output_buffers[i], /*offset=*/0, sizeof(float)},
+    };
+    const iree_hal_buffer_binding_table_t binding_table = {
+        IREE_ARRAYSIZE(bindings),
+        bindings,
+    };
+    status = iree_hal_command_buffer_execute_commands(
+        command_buffer, nested_command_buffer, binding_table);
+    if (iree_status_is_unimplemented(status)) break;
+    IREE_ASSERT_OK(status);
+  }
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_free(status);
+  } else {
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(command_buffer));
+    for (int i = 0; i < 2; ++i) {
+      float output_value = 0.0f;
+      IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+          device_, output_buffers[i],
+          /*source_offset=*/0, &output_value, sizeof(output_value),
+          IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+      EXPECT_EQ(std::fabs(input_values[i]), output_value);
+    }
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_command_buffer_release(nested_command_buffer);
+  for (int i = 0; i < 2; ++i) {
+    iree_hal_buffer_release(output_buffers[i]);
+    iree_hal_buffer_release(input_buffers[i]);
+  }
+  CleanupExecutable();
+  if (iree_status_is_unimplemented(status)) {
+    GTEST_SKIP() << "execute_commands not supported";
+  }
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
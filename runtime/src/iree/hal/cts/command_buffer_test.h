@@ -124,6 +124,43 @@ TEST_P(command_buffer_test, SubmitEmpty) {
   iree_hal_command_buffer_release(command_buffer);
 }
 
+// Tests that a reusable command buffer can be submitted multiple times and
+// that each submission performs all of the recorded work.
+TEST_P(command_buffer_test, SubmitReusable) {
+  iree_hal_buffer_t* device_buffer = NULL;
+  CreateZeroedDeviceBuffer(kDefaultAllocationSize, &device_buffer);
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  uint8_t i8_val = 0x54;
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer, /*target_offset=*/0,
+      kDefaultAllocationSize, &i8_val, sizeof(i8_val)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  std::vector<uint8_t> reference_buffer(kDefaultAllocationSize);
+  std::memset(reference_buffer.data(), i8_val, kDefaultAllocationSize);
+  for (int i = 0; i < 3; ++i) {
+    IREE_ASSERT_OK(
+        iree_hal_buffer_map_zero(device_buffer, 0, IREE_WHOLE_BUFFER));
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(command_buffer));
+    std::vector<uint8_t> actual_data(kDefaultAllocationSize);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, device_buffer, /*source_offset=*/0,
+        /*target_buffer=*/actual_data.data(),
+        /*data_length=*/kDefaultAllocationSize,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(device_buffer);
+}
+
 TEST_P(command_buffer_test, CopyWholeBuffer) {
   iree_hal_command_buffer_t* command_buffer = NULL;
   IREE_ASSERT_OK(iree_hal_command_buffer_create(
@@ -0,0 +1,515 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_CTS_CTS_BENCHMARKS_H_
+#define IREE_HAL_CTS_CTS_BENCHMARKS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/benchmark.h"
+
+namespace iree {
+namespace hal {
+namespace cts {
+
+// Microbenchmarks of common HAL operations that are run against each driver
+// using the same registration as the CTS tests. Benchmark names are prefixed
+// with the driver name so that results from different drivers (and releases)
+// can be compared directly.
+
+// Number of commands recorded per step in the command buffer benchmarks.
+constexpr iree_host_size_t kBenchmarkCommandCount = 64;
+
+// Device and resources shared by all benchmarks of a single driver.
+class CtsBenchmarkContext {
+ public:
+  ~CtsBenchmarkContext() {
+    iree_hal_executable_release(executable_);
+    iree_hal_pipeline_layout_release(pipeline_layout_);
+    iree_hal_descriptor_set_layout_release(descriptor_set_layout_);
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_status_ignore(loop_status_);
+    iree_hal_device_release(device_);
+    iree_hal_driver_release(driver_);
+  }
+
+  // Creates the default device of |driver_name| and, if |executable_data| is
+  // provided, the executable used for dispatch benchmarks.
+  // Returns IREE_STATUS_UNAVAILABLE if the driver or device is unavailable.
+  iree_status_t Initialize(const char* driver_name,
+                           const char* executable_format,
+                           iree_const_byte_span_t executable_data) {
+    driver_name_ = driver_name;
+    IREE_RETURN_IF_ERROR(iree_hal_driver_registry_try_create(
+        iree_hal_driver_registry_default(),
+        iree_make_cstring_view(driver_name), iree_allocator_system(),
+        &driver_));
+    IREE_RETURN_IF_ERROR(iree_hal_driver_create_default_device(
+        driver_, iree_allocator_system(), &device_));
+    if (iree_const_byte_span_is_empty(executable_data)) {
+      return iree_ok_status();
+    }
+    return PrepareExecutable(executable_format, executable_data);
+  }
+
+  const std::string& driver_name() const { return driver_name_; }
+  iree_hal_device_t* device() const { return device_; }
+  iree_hal_pipeline_layout_t* pipeline_layout() const {
+    return pipeline_layout_;
+  }
+  iree_hal_executable_t* executable() const { return executable_; }
+
+ private:
+  // Prepares the executable from command_buffer_dispatch_test.mlir: one export
+  // with two storage buffer bindings.
+  iree_status_t PrepareExecutable(const char* executable_format,
+                                  iree_const_byte_span_t executable_data) {
+    IREE_RETURN_IF_ERROR(iree_hal_executable_cache_create(
+        device_, iree_make_cstring_view("default"),
+        iree_loop_inline(&loop_status_), &executable_cache_));
+    iree_hal_descriptor_set_layout_binding_t bindings[] = {
+        {0, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_NONE},
+        {1, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_NONE},
+    };
+    IREE_RETURN_IF_ERROR(iree_hal_descriptor_set_layout_create(
+        device_, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE,
+        IREE_ARRAYSIZE(bindings), bindings, &descriptor_set_layout_));
+    IREE_RETURN_IF_ERROR(iree_hal_pipeline_layout_create(
+        device_, /*push_constants=*/0, /*set_layout_count=*/1,
+        &descriptor_set_layout_, &pipeline_layout_));
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+    executable_params.executable_format =
+        iree_make_cstring_view(executable_format);
+    executable_params.executable_data = executable_data;
+    executable_params.pipeline_layout_count = 1;
+    executable_params.pipeline_layouts = &pipeline_layout_;
+    return iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &executable_params, &executable_);
+  }
+
+  std::string driver_name_;
+  iree_hal_driver_t* driver_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_status_t loop_status_ = iree_ok_status();
+  iree_hal_executable_cache_t* executable_cache_ = NULL;
+  iree_hal_descriptor_set_layout_t* descriptor_set_layout_ = NULL;
+  iree_hal_pipeline_layout_t* pipeline_layout_ = NULL;
+  iree_hal_executable_t* executable_ = NULL;
+};
+
+// A registered benchmark; passed to the run function as its user_data.
+struct CtsBenchmarkCase {
+  CtsBenchmarkContext* context;
+  // Transfer or allocation size in bytes, if used by the benchmark.
+  iree_device_size_t size;
+};
+
+//===----------------------------------------------------------------------===//
+// Utilities
+//===----------------------------------------------------------------------===//
+
+static inline const CtsBenchmarkCase* GetBenchmarkCase(
+    const iree_benchmark_def_t* benchmark_def) {
+  return (const CtsBenchmarkCase*)benchmark_def->user_data;
+}
+
+static inline iree_hal_buffer_t* AllocateBenchmarkBuffer(
+    iree_hal_device_t* device, iree_device_size_t size) {
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage =
+      IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE | IREE_HAL_BUFFER_USAGE_TRANSFER;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(device), params, size,
+      iree_const_byte_span_empty(), &buffer));
+  return buffer;
+}
+
+static inline iree_hal_command_buffer_t* CreateBenchmarkCommandBuffer(
+    iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_CHECK_OK(iree_hal_command_buffer_create(
+      device, mode, IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  return command_buffer;
+}
+
+// Submits |command_buffer| (if any) signaling |semaphore| to |value| and waits
+// for it to be reached.
+static inline void SubmitAndWait(iree_hal_device_t* device,
+                                 iree_hal_command_buffer_t* command_buffer,
+                                 iree_hal_semaphore_t* semaphore,
+                                 uint64_t value) {
+  iree_hal_semaphore_list_t signal_semaphores = {
+      /*count=*/1,
+      /*semaphores=*/&semaphore,
+      /*payload_values=*/&value,
+  };
+  IREE_CHECK_OK(iree_hal_device_queue_execute(
+      device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_semaphores, command_buffer ? 1 : 0, &command_buffer));
+  IREE_CHECK_OK(
+      iree_hal_semaphore_wait(semaphore, value, iree_infinite_timeout()));
+}
+
+//===----------------------------------------------------------------------===//
+// Command buffer recording
+//===----------------------------------------------------------------------===//
+
+// Measures the host time to record a small fill into a one-shot command
+// buffer, including command buffer creation amortized over the batch.
+static iree_status_t BenchmarkRecordFill(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_device_t* device =
+      GetBenchmarkCase(benchmark_def)->context->device();
+  iree_hal_buffer_t* buffer = AllocateBenchmarkBuffer(
+      device, kBenchmarkCommandCount * sizeof(uint32_t));
+  const uint32_t pattern = 0xCDCDCDCDu;
+  int64_t command_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_hal_command_buffer_t* command_buffer = CreateBenchmarkCommandBuffer(
+        device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    for (iree_host_size_t i = 0; i < kBenchmarkCommandCount; ++i) {
+      IREE_CHECK_OK(iree_hal_command_buffer_fill_buffer(
+          command_buffer, buffer, i * sizeof(pattern), sizeof(pattern),
+          &pattern, sizeof(pattern)));
+    }
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    iree_hal_command_buffer_release(command_buffer);
+    command_count += kBenchmarkCommandCount;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, command_count);
+  iree_hal_buffer_release(buffer);
+  return iree_ok_status();
+}
+
+// Measures the host time to record a dispatch (and its descriptor set) into a
+// one-shot command buffer. Only registered if the context has an executable.
+static iree_status_t BenchmarkRecordDispatch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkContext* context = GetBenchmarkCase(benchmark_def)->context;
+  iree_hal_device_t* device = context->device();
+  iree_hal_buffer_t* input_buffer =
+      AllocateBenchmarkBuffer(device, sizeof(float));
+  iree_hal_buffer_t* output_buffer =
+      AllocateBenchmarkBuffer(device, sizeof(float));
+  iree_hal_descriptor_set_binding_t bindings[] = {
+      {/*binding=*/0, /*buffer_slot=*/0, input_buffer, /*offset=*/0,
+       sizeof(float)},
+      {/*binding=*/1, /*buffer_slot=*/0, output_buffer, /*offset=*/0,
+       sizeof(float)},
+  };
+  int64_t command_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_hal_command_buffer_t* command_buffer = CreateBenchmarkCommandBuffer(
+        device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    for (iree_host_size_t i = 0; i < kBenchmarkCommandCount; ++i) {
+      IREE_CHECK_OK(iree_hal_command_buffer_push_descriptor_set(
+          command_buffer, context->pipeline_layout(), /*set=*/0,
+          IREE_ARRAYSIZE(bindings), bindings));
+      IREE_CHECK_OK(iree_hal_command_buffer_dispatch(
+          command_buffer, context->executable(), /*entry_point=*/0,
+          /*workgroup_x=*/1, /*workgroup_y=*/1, /*workgroup_z=*/1));
+    }
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    iree_hal_command_buffer_release(command_buffer);
+    command_count += kBenchmarkCommandCount;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, command_count);
+  iree_hal_buffer_release(output_buffer);
+  iree_hal_buffer_release(input_buffer);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Submission and synchronization
+//===----------------------------------------------------------------------===//
+
+// Measures the latency from submitting an empty command buffer to the host
+// observing its signal semaphore reach the target value.
+static iree_status_t BenchmarkSubmitToComplete(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_device_t* device =
+      GetBenchmarkCase(benchmark_def)->context->device();
+  iree_hal_command_buffer_t* command_buffer =
+      CreateBenchmarkCommandBuffer(device, /*mode=*/0);
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  uint64_t value = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    SubmitAndWait(device, command_buffer, semaphore, ++value);
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  return iree_ok_status();
+}
+
+// Measures the round-trip latency of a host signal waking a host waiter on
+// another thread that then signals back.
+static iree_status_t BenchmarkSemaphoreSignalWake(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_device_t* device =
+      GetBenchmarkCase(benchmark_def)->context->device();
+  iree_hal_semaphore_t* ping = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &ping));
+  iree_hal_semaphore_t* pong = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &pong));
+  // Not all drivers support host signaling; report that as an error instead of
+  // failing in the thread below.
+  iree_status_t status = iree_hal_semaphore_signal(pong, 1ull);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_semaphore_release(pong);
+    iree_hal_semaphore_release(ping);
+    return status;
+  }
+  std::atomic<bool> exit_requested(false);
+  std::thread thread([&]() {
+    for (uint64_t value = 1;; ++value) {
+      IREE_CHECK_OK(
+          iree_hal_semaphore_wait(ping, value, iree_infinite_timeout()));
+      if (exit_requested.load()) break;
+      IREE_CHECK_OK(iree_hal_semaphore_signal(pong, value + 1));
+    }
+  });
+  uint64_t value = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    ++value;
+    IREE_CHECK_OK(iree_hal_semaphore_signal(ping, value));
+    IREE_CHECK_OK(
+        iree_hal_semaphore_wait(pong, value + 1, iree_infinite_timeout()));
+  }
+  exit_requested.store(true);
+  IREE_CHECK_OK(iree_hal_semaphore_signal(ping, value + 1));
+  thread.join();
+  iree_hal_semaphore_release(pong);
+  iree_hal_semaphore_release(ping);
+  return iree_ok_status();
+}
+
+// Measures a queue-ordered allocation and deallocation round trip.
+static iree_status_t BenchmarkQueueAlloca(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkCase* benchmark_case = GetBenchmarkCase(benchmark_def);
+  iree_hal_device_t* device = benchmark_case->context->device();
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage =
+      IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE | IREE_HAL_BUFFER_USAGE_TRANSFER;
+  // Queue-ordered allocation is optional and may be unimplemented.
+  iree_status_t status = iree_ok_status();
+  uint64_t value = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    uint64_t alloca_value = ++value;
+    uint64_t dealloca_value = ++value;
+    iree_hal_semaphore_list_t alloca_signal = {1, &semaphore, &alloca_value};
+    iree_hal_semaphore_list_t dealloca_signal = {1, &semaphore,
+                                                 &dealloca_value};
+    iree_hal_buffer_t* buffer = NULL;
+    status = iree_hal_device_queue_alloca(
+        device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        alloca_signal, IREE_HAL_ALLOCATOR_POOL_DEFAULT, params,
+        benchmark_case->size, &buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_device_queue_dealloca(
+          device, IREE_HAL_QUEUE_AFFINITY_ANY, alloca_signal, dealloca_signal,
+          buffer);
+    }
+    iree_hal_buffer_release(buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, dealloca_value,
+                                       iree_infinite_timeout());
+    }
+  }
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Bandwidth
+//===----------------------------------------------------------------------===//
+
+// Measures synchronous host-to-device transfer bandwidth.
+static iree_status_t BenchmarkTransferH2D(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkCase* benchmark_case = GetBenchmarkCase(benchmark_def);
+  iree_hal_device_t* device = benchmark_case->context->device();
+  iree_hal_buffer_t* buffer =
+      AllocateBenchmarkBuffer(device, benchmark_case->size);
+  std::vector<uint8_t> host_data(benchmark_case->size, 0xCD);
+  int64_t byte_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_device_transfer_h2d(
+        device, host_data.data(), buffer, /*target_offset=*/0,
+        benchmark_case->size, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    byte_count += benchmark_case->size;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state, byte_count);
+  iree_hal_buffer_release(buffer);
+  return iree_ok_status();
+}
+
+// Measures synchronous device-to-host transfer bandwidth.
+static iree_status_t BenchmarkTransferD2H(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkCase* benchmark_case = GetBenchmarkCase(benchmark_def);
+  iree_hal_device_t* device = benchmark_case->context->device();
+  iree_hal_buffer_t* buffer =
+      AllocateBenchmarkBuffer(device, benchmark_case->size);
+  std::vector<uint8_t> host_data(benchmark_case->size);
+  int64_t byte_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_device_transfer_d2h(
+        device, buffer, /*source_offset=*/0, host_data.data(),
+        benchmark_case->size, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    byte_count += benchmark_case->size;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state, byte_count);
+  iree_hal_buffer_release(buffer);
+  return iree_ok_status();
+}
+
+// Measures on-device fill bandwidth including submission.
+static iree_status_t BenchmarkFillBuffer(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkCase* benchmark_case = GetBenchmarkCase(benchmark_def);
+  iree_hal_device_t* device = benchmark_case->context->device();
+  iree_hal_buffer_t* buffer =
+      AllocateBenchmarkBuffer(device, benchmark_case->size);
+  iree_hal_command_buffer_t* command_buffer =
+      CreateBenchmarkCommandBuffer(device, /*mode=*/0);
+  const uint32_t pattern = 0xCDCDCDCDu;
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffer, /*target_offset=*/0, benchmark_case->size,
+      &pattern, sizeof(pattern)));
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  uint64_t value = 0;
+  int64_t byte_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    SubmitAndWait(device, command_buffer, semaphore, ++value);
+    byte_count += benchmark_case->size;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state, byte_count);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(buffer);
+  return iree_ok_status();
+}
+
+// Measures on-device copy bandwidth including submission.
+static iree_status_t BenchmarkCopyBuffer(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const CtsBenchmarkCase* benchmark_case = GetBenchmarkCase(benchmark_def);
+  iree_hal_device_t* device = benchmark_case->context->device();
+  iree_hal_buffer_t* source_buffer =
+      AllocateBenchmarkBuffer(device, benchmark_case->size);
+  iree_hal_buffer_t* target_buffer =
+      AllocateBenchmarkBuffer(device, benchmark_case->size);
+  iree_hal_command_buffer_t* command_buffer =
+      CreateBenchmarkCommandBuffer(device, /*mode=*/0);
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, source_buffer, /*source_offset=*/0, target_buffer,
+      /*target_offset=*/0, benchmark_case->size));
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  uint64_t value = 0;
+  int64_t byte_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    SubmitAndWait(device, command_buffer, semaphore, ++value);
+    byte_count += benchmark_case->size;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state, byte_count);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(target_buffer);
+  iree_hal_buffer_release(source_buffer);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Registration
+//===----------------------------------------------------------------------===//
+
+// Registers all benchmarks against the device in |context|.
+// |context| must remain valid until the benchmarks have run.
+static inline void RegisterCtsBenchmarks(CtsBenchmarkContext* context) {
+  // Storage for the benchmark cases referenced by the registered definitions.
+  static std::deque<CtsBenchmarkCase> benchmark_cases;
+  auto register_benchmark =
+      [&](const char* name,
+          iree_status_t (*run)(const iree_benchmark_def_t* benchmark_def,
+                               iree_benchmark_state_t* benchmark_state),
+          iree_device_size_t size) {
+        benchmark_cases.push_back({context, size});
+        iree_benchmark_def_t benchmark_def = {0};
+        benchmark_def.flags = IREE_BENCHMARK_FLAG_USE_REAL_TIME;
+        benchmark_def.time_unit = IREE_BENCHMARK_UNIT_MICROSECOND;
+        benchmark_def.run = run;
+        benchmark_def.user_data = &benchmark_cases.back();
+        std::string full_name = context->driver_name() + "/" + name;
+        if (size) full_name += "/" + std::to_string(size);
+        iree_benchmark_register(
+            iree_make_string_view(full_name.data(), full_name.size()),
+            &benchmark_def);
+      };
+
+  register_benchmark("record_fill", BenchmarkRecordFill, 0);
+  if (context->executable()) {
+    register_benchmark("record_dispatch", BenchmarkRecordDispatch, 0);
+  }
+  register_benchmark("submit_to_complete", BenchmarkSubmitToComplete, 0);
+  register_benchmark("semaphore_signal_wake", BenchmarkSemaphoreSignalWake, 0);
+  for (iree_device_size_t size : {4 * 1024, 1024 * 1024}) {
+    register_benchmark("queue_alloca", BenchmarkQueueAlloca, size);
+  }
+  for (iree_device_size_t size : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+    register_benchmark("transfer_h2d", BenchmarkTransferH2D, size);
+    register_benchmark("transfer_d2h", BenchmarkTransferD2H, size);
+    register_benchmark("fill_buffer", BenchmarkFillBuffer, size);
+    register_benchmark("copy_buffer", BenchmarkCopyBuffer, size);
+  }
+}
+
+}  // namespace cts
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_CTS_CTS_BENCHMARKS_H_
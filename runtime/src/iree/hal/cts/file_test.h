@@ -0,0 +1,206 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_CTS_FILE_TEST_H_
+#define IREE_HAL_CTS_FILE_TEST_H_
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/cts/cts_test_base.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace cts {
+
+using ::testing::ContainerEq;
+
+class file_test : public CtsTestBase {
+ protected:
+  void CreatePatternedMemoryFile(iree_host_size_t file_size,
+                                 std::vector<uint8_t>* out_contents,
+                                 iree_hal_file_t** out_file) {
+    out_contents->resize(file_size);
+    for (iree_host_size_t i = 0; i < file_size; ++i) {
+      (*out_contents)[i] = (uint8_t)(i & 0xFF);
+    }
+    IREE_ASSERT_OK(iree_hal_memory_file_wrap(
+        IREE_HAL_MEMORY_ACCESS_READ,
+        iree_make_byte_span(out_contents->data(), out_contents->size()),
+        iree_hal_file_release_callback_null(), iree_allocator_system(),
+        out_file));
+  }
+
+  void AllocateZeroedBuffer(iree_device_size_t buffer_size,
+                            iree_hal_buffer_t** out_buffer) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, buffer_size, iree_const_byte_span_empty(),
+        out_buffer));
+    IREE_ASSERT_OK(iree_hal_buffer_map_zero(*out_buffer, /*byte_offset=*/0,
+                                            IREE_WHOLE_BUFFER));
+  }
+};
+
+TEST_P(file_test, ReadEntireFile) {
+  std::vector<uint8_t> contents;
+  iree_hal_file_t* file = NULL;
+  CreatePatternedMemoryFile(4096, &contents, &file);
+  EXPECT_EQ(iree_hal_file_length(file), contents.size());
+
+  iree_hal_buffer_t* buffer = NULL;
+  AllocateZeroedBuffer(contents.size(), &buffer);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  uint64_t wait_value = 0ull;
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t wait_semaphores = {1, &semaphore, &wait_value};
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphores, signal_semaphores,
+      file, /*source_offset=*/0, buffer, /*target_offset=*/0, contents.size(),
+      IREE_HAL_READ_FLAG_NONE));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+
+  std::vector<uint8_t> actual_data(contents.size());
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(
+      buffer, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+  EXPECT_THAT(actual_data, ContainerEq(contents));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+TEST_P(file_test, ReadSubrange) {
+  std::vector<uint8_t> contents;
+  iree_hal_file_t* file = NULL;
+  CreatePatternedMemoryFile(64, &contents, &file);
+
+  iree_hal_buffer_t* buffer = NULL;
+  AllocateZeroedBuffer(16, &buffer);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_semaphores, file, /*source_offset=*/8, buffer,
+      /*target_offset=*/4, /*length=*/8, IREE_HAL_READ_FLAG_NONE));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+
+  std::vector<uint8_t> actual_data(16);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(
+      buffer, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+  std::vector<uint8_t> reference_buffer{0x00, 0x00, 0x00, 0x00,  //
+                                        0x08, 0x09, 0x0A, 0x0B,  //
+                                        0x0C, 0x0D, 0x0E, 0x0F,  //
+                                        0x00, 0x00, 0x00, 0x00};
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+TEST_P(file_test, ReadWaitsOnSemaphores) {
+  std::vector<uint8_t> contents;
+  iree_hal_file_t* file = NULL;
+  CreatePatternedMemoryFile(256, &contents, &file);
+
+  iree_hal_buffer_t* buffer = NULL;
+  AllocateZeroedBuffer(contents.size(), &buffer);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+
+  // The read must not touch the buffer until the wait value is reached.
+  // Implementations may block the caller until then so the signal comes from
+  // another thread. Results are checked on the main thread after joining as
+  // assertion failures can only end the test from the main thread.
+  std::vector<uint8_t> data_before_signal(contents.size());
+  iree_status_t read_status = iree_ok_status();
+  iree_status_t signal_status = iree_ok_status();
+  std::thread thread([&]() {
+    read_status = iree_hal_buffer_map_read(buffer, /*source_offset=*/0,
+                                           data_before_signal.data(),
+                                           data_before_signal.size());
+    signal_status = iree_hal_semaphore_signal(semaphore, 1ull);
+  });
+
+  uint64_t wait_value = 1ull;
+  uint64_t signal_value = 2ull;
+  iree_hal_semaphore_list_t wait_semaphores = {1, &semaphore, &wait_value};
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphores, signal_semaphores,
+      file, /*source_offset=*/0, buffer, /*target_offset=*/0, contents.size(),
+      IREE_HAL_READ_FLAG_NONE));
+  iree_status_t wait_status =
+      iree_hal_semaphore_wait(semaphore, 2ull, iree_infinite_timeout());
+  thread.join();
+  IREE_ASSERT_OK(read_status);
+  IREE_ASSERT_OK(signal_status);
+  IREE_ASSERT_OK(wait_status);
+  EXPECT_THAT(data_before_signal,
+              ContainerEq(std::vector<uint8_t>(contents.size(), 0)));
+
+  std::vector<uint8_t> actual_data(contents.size());
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(
+      buffer, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+  EXPECT_THAT(actual_data, ContainerEq(contents));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+TEST_P(file_test, ReadOutOfRange) {
+  std::vector<uint8_t> contents;
+  iree_hal_file_t* file = NULL;
+  CreatePatternedMemoryFile(16, &contents, &file);
+
+  iree_hal_buffer_t* buffer = NULL;
+  AllocateZeroedBuffer(16, &buffer);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  iree_status_t status = iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_semaphores, file, /*source_offset=*/8, buffer,
+      /*target_offset=*/0, /*length=*/16, IREE_HAL_READ_FLAG_NONE);
+  if (iree_status_is_ok(status)) {
+    // Implementations may report the failure asynchronously.
+    status = iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout());
+  }
+  EXPECT_FALSE(iree_status_is_ok(status));
+  iree_status_ignore(status);
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+}  // namespace cts
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_CTS_FILE_TEST_H_
@@ -0,0 +1,319 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_CTS_QUEUE_ALLOCA_TEST_H_
+#define IREE_HAL_CTS_QUEUE_ALLOCA_TEST_H_
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/cts/cts_test_base.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace cts {
+
+using ::testing::ContainerEq;
+
+class queue_alloca_test : public CtsTestBase {
+ protected:
+  static iree_hal_buffer_params_t TransientParams() {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    return params;
+  }
+
+  // Device-local memory that is not host-visible. Drivers with queue-ordered
+  // allocators serve these from their device pools.
+  static iree_hal_buffer_params_t DeviceLocalParams() {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE;
+    return params;
+  }
+
+  // Allocates a buffer without waiting and returns once it is available.
+  void AllocaAndWait(iree_device_size_t allocation_size,
+                     iree_hal_buffer_t** out_buffer) {
+    AllocaAndWait(TransientParams(), allocation_size, out_buffer);
+  }
+  void AllocaAndWait(iree_hal_buffer_params_t params,
+                     iree_device_size_t allocation_size,
+                     iree_hal_buffer_t** out_buffer) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore,
+                                                   &signal_value};
+    IREE_ASSERT_OK(iree_hal_device_queue_alloca(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, IREE_HAL_ALLOCATOR_POOL_DEFAULT, params,
+        allocation_size, out_buffer));
+    IREE_ASSERT_OK(
+        iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+    iree_hal_semaphore_release(semaphore);
+  }
+
+  // Deallocates |buffer| and returns once the deallocation has completed.
+  void DeallocaAndWait(iree_hal_buffer_t* buffer) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore,
+                                                   &signal_value};
+    IREE_ASSERT_OK(iree_hal_device_queue_dealloca(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, buffer));
+    IREE_ASSERT_OK(
+        iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+    iree_hal_semaphore_release(semaphore);
+  }
+
+  // Uploads |pattern| to |buffer| and verifies it reads back. Unlike
+  // CheckBufferUsable this does not require |buffer| to be mappable.
+  void CheckDeviceBufferUsable(iree_hal_buffer_t* buffer, uint8_t pattern) {
+    iree_device_size_t length = iree_hal_buffer_byte_length(buffer);
+    std::vector<uint8_t> expected_data(length, pattern);
+    IREE_ASSERT_OK(iree_hal_device_transfer_h2d(
+        device_, expected_data.data(), buffer, /*target_offset=*/0, length,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    std::vector<uint8_t> actual_data(length);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, buffer, /*source_offset=*/0, actual_data.data(), length,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    EXPECT_THAT(actual_data, ContainerEq(expected_data));
+  }
+
+  // Fills |buffer| with |pattern| and verifies it reads back.
+  void CheckBufferUsable(iree_hal_buffer_t* buffer, uint8_t pattern) {
+    iree_device_size_t length = iree_hal_buffer_byte_length(buffer);
+    IREE_ASSERT_OK(iree_hal_buffer_map_fill(buffer, /*byte_offset=*/0, length,
+                                            &pattern, sizeof(pattern)));
+    std::vector<uint8_t> actual_data(length);
+    IREE_ASSERT_OK(iree_hal_buffer_map_read(
+        buffer, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+    EXPECT_THAT(actual_data,
+                ContainerEq(std::vector<uint8_t>(length, pattern)));
+  }
+};
+
+TEST_P(queue_alloca_test, AllocaWaitsOnSemaphores) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+
+  // The alloca must not signal before its wait is satisfied. Implementations
+  // may block the caller until then so the signal comes from another thread.
+  std::thread thread([&]() {
+    uint64_t value = 0ull;
+    IREE_ASSERT_OK(iree_hal_semaphore_query(semaphore, &value));
+    EXPECT_EQ(value, 0ull);
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1ull));
+  });
+
+  uint64_t wait_value = 1ull;
+  uint64_t signal_value = 2ull;
+  iree_hal_semaphore_list_t wait_semaphores = {1, &semaphore, &wait_value};
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_device_queue_alloca(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphores, signal_semaphores,
+      IREE_HAL_ALLOCATOR_POOL_DEFAULT, TransientParams(), 128, &buffer));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 2ull, iree_infinite_timeout()));
+  thread.join();
+  CheckBufferUsable(buffer, 0xCD);
+
+  // The dealloca must also wait before signaling.
+  std::thread dealloca_thread([&]() {
+    uint64_t value = 0ull;
+    IREE_ASSERT_OK(iree_hal_semaphore_query(semaphore, &value));
+    EXPECT_EQ(value, 2ull);
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 3ull));
+  });
+  wait_value = 3ull;
+  signal_value = 4ull;
+  IREE_ASSERT_OK(iree_hal_device_queue_dealloca(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphores, signal_semaphores,
+      buffer));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 4ull, iree_infinite_timeout()));
+  dealloca_thread.join();
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_semaphore_release(semaphore);
+}
+
+// A buffer deallocated after all references are dropped may be reused by a
+// subsequent allocation and must be usable.
+TEST_P(queue_alloca_test, AllocaAfterDealloca) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(256, &buffer);
+  CheckBufferUsable(buffer, 0x11);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_dealloca(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_semaphores, buffer));
+  iree_hal_buffer_release(buffer);
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+  iree_hal_semaphore_release(semaphore);
+
+  iree_hal_buffer_t* reused_buffer = NULL;
+  AllocaAndWait(256, &reused_buffer);
+  CheckBufferUsable(reused_buffer, 0x22);
+  iree_hal_buffer_release(reused_buffer);
+}
+
+// Deallocating the same buffer twice must not hand its storage out to two
+// live allocations.
+TEST_P(queue_alloca_test, DoubleDealloca) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(64, &buffer);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_dealloca(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_semaphores, buffer));
+  // The second dealloca is ordered after the first so that the semaphore
+  // values are signaled in order.
+  uint64_t wait_value = 1ull;
+  iree_hal_semaphore_list_t wait_semaphores = {1, &semaphore, &wait_value};
+  signal_value = 2ull;
+  IREE_ASSERT_OK(iree_hal_device_queue_dealloca(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphores, signal_semaphores,
+      buffer));
+  iree_hal_buffer_release(buffer);
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 2ull, iree_infinite_timeout()));
+  iree_hal_semaphore_release(semaphore);
+
+  iree_hal_buffer_t* buffer_a = NULL;
+  AllocaAndWait(64, &buffer_a);
+  iree_hal_buffer_t* buffer_b = NULL;
+  AllocaAndWait(64, &buffer_b);
+  EXPECT_NE(buffer_a, buffer_b);
+  CheckBufferUsable(buffer_a, 0xAA);
+  CheckBufferUsable(buffer_b, 0xBB);
+  std::vector<uint8_t> actual_data(64);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(
+      buffer_a, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+  EXPECT_THAT(actual_data, ContainerEq(std::vector<uint8_t>(64, 0xAA)));
+
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_buffer_release(buffer_b);
+}
+
+// A buffer still referenced by the program after its dealloca completes must
+// not be handed out to a subsequent allocation.
+TEST_P(queue_alloca_test, DeallocaWhileRetained) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(128, &buffer);
+  CheckBufferUsable(buffer, 0x33);
+  DeallocaAndWait(buffer);
+
+  iree_hal_buffer_t* other_buffer = NULL;
+  AllocaAndWait(128, &other_buffer);
+  EXPECT_NE(buffer, other_buffer);
+  CheckBufferUsable(other_buffer, 0x44);
+  std::vector<uint8_t> actual_data(128);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(
+      buffer, /*source_offset=*/0, actual_data.data(), actual_data.size()));
+  EXPECT_THAT(actual_data, ContainerEq(std::vector<uint8_t>(128, 0x33)));
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_buffer_release(other_buffer);
+}
+
+// Implementations may serve a smaller allocation by aliasing the memory of a
+// larger retired one. An aliasing buffer still referenced after its dealloca
+// completes must keep that memory from being handed out again.
+TEST_P(queue_alloca_test, AliasRetainedAcrossDealloca) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(1024, &buffer);
+  DeallocaAndWait(buffer);
+  iree_hal_buffer_release(buffer);
+
+  // May alias the memory of the retired 1024 byte buffer.
+  iree_hal_buffer_t* alias_buffer = NULL;
+  AllocaAndWait(768, &alias_buffer);
+  CheckBufferUsable(alias_buffer, 0x55);
+  DeallocaAndWait(alias_buffer);
+
+  // Neither an exact-size nor an aliasing allocation may overlap the live
+  // alias.
+  iree_hal_buffer_t* exact_buffer = NULL;
+  AllocaAndWait(768, &exact_buffer);
+  CheckBufferUsable(exact_buffer, 0x66);
+  iree_hal_buffer_t* large_buffer = NULL;
+  AllocaAndWait(1024, &large_buffer);
+  CheckBufferUsable(large_buffer, 0x77);
+  std::vector<uint8_t> actual_data(768);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(alias_buffer, /*source_offset=*/0,
+                                          actual_data.data(),
+                                          actual_data.size()));
+  EXPECT_THAT(actual_data, ContainerEq(std::vector<uint8_t>(768, 0x55)));
+
+  iree_hal_buffer_release(alias_buffer);
+  iree_hal_buffer_release(exact_buffer);
+  iree_hal_buffer_release(large_buffer);
+}
+
+// Device-local allocations may be served from queue-ordered pools. Storage
+// returned with a dealloca must be reusable by later allocations.
+TEST_P(queue_alloca_test, DeviceLocalAllocaAfterDealloca) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(DeviceLocalParams(), 1024, &buffer);
+  CheckDeviceBufferUsable(buffer, 0x5A);
+  DeallocaAndWait(buffer);
+  iree_hal_buffer_release(buffer);
+
+  iree_hal_buffer_t* reused_buffer = NULL;
+  AllocaAndWait(DeviceLocalParams(), 1024, &reused_buffer);
+  CheckDeviceBufferUsable(reused_buffer, 0xA5);
+  DeallocaAndWait(reused_buffer);
+  iree_hal_buffer_release(reused_buffer);
+}
+
+// Buffers released without a dealloca must still return their storage.
+TEST_P(queue_alloca_test, DeviceLocalReleaseWithoutDealloca) {
+  for (int i = 0; i < 4; ++i) {
+    iree_hal_buffer_t* buffer = NULL;
+    AllocaAndWait(DeviceLocalParams(), 4096, &buffer);
+    CheckDeviceBufferUsable(buffer, (uint8_t)(0x10 + i));
+    iree_hal_buffer_release(buffer);
+  }
+}
+
+// Zero-length allocations are valid and may be deallocated.
+TEST_P(queue_alloca_test, DeviceLocalZeroLength) {
+  iree_hal_buffer_t* buffer = NULL;
+  AllocaAndWait(DeviceLocalParams(), 0, &buffer);
+  ASSERT_NE(buffer, nullptr);
+  DeallocaAndWait(buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+}  // namespace cts
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_CTS_QUEUE_ALLOCA_TEST_H_
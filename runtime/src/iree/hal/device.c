@@ -176,9 +176,15 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_alloca(
   IREE_ASSERT_ARGUMENT(out_buffer);
   *out_buffer = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
+  // Attribute any allocator requests made by the device implementation to the
+  // queue-ordered allocation.
+  iree_hal_allocation_source_t prior_source =
+      iree_hal_allocation_source_exchange(
+          IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_alloca)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list, pool,
       params, allocation_size, out_buffer);
+  iree_hal_allocation_source_exchange(prior_source);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -204,6 +210,31 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_dealloca(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_device_queue_read(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_read_flags_t flags) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(
+      !wait_semaphore_list.count ||
+      (wait_semaphore_list.semaphores && wait_semaphore_list.payload_values));
+  IREE_ASSERT_ARGUMENT(!signal_semaphore_list.count ||
+                       (signal_semaphore_list.semaphores &&
+                        signal_semaphore_list.payload_values));
+  IREE_ASSERT_ARGUMENT(source_file);
+  IREE_ASSERT_ARGUMENT(target_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)length);
+  iree_status_t status = _VTABLE_DISPATCH(device, queue_read)(
+      device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+      source_file, source_offset, target_buffer, target_offset, length, flags);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_device_queue_execute(
     iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
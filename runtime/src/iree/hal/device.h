@@ -18,6 +18,7 @@
 #include "iree/hal/event.h"
 #include "iree/hal/executable_cache.h"
 #include "iree/hal/fence.h"
+#include "iree/hal/file.h"
 #include "iree/hal/pipeline_layout.h"
 #include "iree/hal/resource.h"
 #include "iree/hal/semaphore.h"
@@ -95,6 +96,12 @@ enum iree_hal_device_profiling_mode_bits_t {
   // locations. This can have a significant performance impact and should only
   // be used when investigating the performance of an individual dispatch.
   IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS = 1u << 2,
+
+  // Capture the begin and end time of each dispatch and report the total time
+  // spent in each executable export. Dispatches are measured as they execute
+  // within the real program (with the cache effects of the surrounding work)
+  // and with less overhead than the counter modes.
+  IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS = 1u << 3,
 };
 typedef uint32_t iree_hal_device_profiling_mode_t;
 
@@ -378,6 +385,36 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_dealloca(
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer);
 
+// Bitfield specifying flags controlling a file read operation.
+typedef uint64_t iree_hal_read_flags_t;
+enum iree_hal_read_flag_bits_t {
+  IREE_HAL_READ_FLAG_NONE = 0,
+};
+
+// Enqueues a read of |length| bytes from |source_file| starting at
+// |source_offset| into |target_buffer| at |target_offset|.
+// The read will not begin until the entire |wait_semaphore_list| has been
+// reached and once the contents are available in the target buffer the
+// |signal_semaphore_list| will be signaled. If the read fails the signal
+// semaphores will be failed with the error.
+//
+// This allows parameter loading to be pipelined with execution: large files
+// can be streamed into device buffers in the background while earlier work
+// runs. Implementations may use native storage-to-device paths when available
+// and otherwise stage the contents through host memory.
+//
+// Usage:
+//   iree_hal_device_queue_alloca(wait(0), signal(1), &buffer);
+//   iree_hal_device_queue_read(wait(1), signal(2), file, 0, buffer, 0, size);
+//   iree_hal_device_queue_execute(wait(2), signal(3), commands...);
+IREE_API_EXPORT iree_status_t iree_hal_device_queue_read(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_read_flags_t flags);
+
 // Executes zero or more command buffers on a device queue.
 // The command buffers are executed in order as if they were recorded as one.
 // No commands will execute until the wait fence has been reached and the signal
@@ -552,6 +589,14 @@ typedef struct iree_hal_device_vtable_t {
       const iree_hal_semaphore_list_t signal_semaphore_list,
       iree_hal_buffer_t* buffer);
 
+  iree_status_t(IREE_API_PTR* queue_read)(
+      iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+      const iree_hal_semaphore_list_t wait_semaphore_list,
+      const iree_hal_semaphore_list_t signal_semaphore_list,
+      iree_hal_file_t* source_file, uint64_t source_offset,
+      iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+      iree_device_size_t length, iree_hal_read_flags_t flags);
+
   iree_status_t(IREE_API_PTR* queue_execute)(
       iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
       const iree_hal_semaphore_list_t wait_semaphore_list,
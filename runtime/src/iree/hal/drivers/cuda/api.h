@@ -33,12 +33,34 @@ typedef struct {
   char data[128];
 } iree_hal_cuda_nccl_id_t;
 
+// Parameters defining a CUmemoryPool.
+typedef struct iree_hal_cuda_memory_pool_params_t {
+  // Minimum number of bytes to keep in the pool when trimming with
+  // iree_hal_device_trim.
+  uint64_t minimum_capacity;
+  // Soft maximum number of bytes to keep in the pool.
+  // When more than this is allocated the extra will be freed at the next
+  // device synchronization in order to remain under the threshold.
+  // Defaults to UINT64_MAX so that reserved memory is retained across
+  // synchronizations and only released by iree_hal_device_trim. Lower values
+  // act as a high-water mark at the cost of reallocating after each
+  // synchronization.
+  uint64_t release_threshold;
+} iree_hal_cuda_memory_pool_params_t;
+
+// Parameters for each CUmemoryPool used for queue-ordered allocations.
+typedef struct iree_hal_cuda_memory_pooling_params_t {
+  // Used exclusively for DEVICE_LOCAL allocations.
+  iree_hal_cuda_memory_pool_params_t device_local;
+} iree_hal_cuda_memory_pooling_params_t;
+
 // Parameters configuring an iree_hal_cuda_device_t.
 // Must be initialized with iree_hal_cuda_device_params_initialize prior to use.
 typedef struct iree_hal_cuda_device_params_t {
   // Number of queues exposed on the device.
   // Each queue acts as a separate synchronization scope where all work executes
-  // concurrently unless prohibited by semaphores.
+  // concurrently unless prohibited by semaphores. Each queue has its own CUDA
+  // stream and queue affinities map to queues modulo the queue count.
   iree_host_size_t queue_count;
 
   // Total size of each block in the device shared block pool.
@@ -49,11 +71,37 @@ typedef struct iree_hal_cuda_device_params_t {
   // Specifies how command buffers are recorded and executed.
   iree_hal_cuda_command_buffer_mode_t command_buffer_mode;
 
+  // Maximum number of instantiated CUDA graphs retained for reuse by graph
+  // command buffers recorded with the same structure. Reused graphs have their
+  // node parameters updated in-place instead of being instantiated again.
+  // 0 disables caching.
+  iree_host_size_t graph_exec_cache_capacity;
+
+  // Size in bytes of the pinned host staging buffer used to transfer between
+  // host memory and device-local buffers without submitting command buffers.
+  // Transfers are chunked through the buffer so any size is supported.
+  // 0 disables staging and uses queue transfers instead.
+  iree_host_size_t staging_buffer_size;
+
   // Allow executing command buffers against CUDA streams as they are recorded.
   // Only command buffers produced by the compiler that have the
   // IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION bit set will use this.
   bool allow_inline_execution;
 
+  // Enables stream-ordered queue allocations (cuMemAllocFromPoolAsync) when
+  // supported by the device. When disabled or unsupported queue allocations
+  // are performed synchronously with the device allocator.
+  bool async_allocations;
+
+  // Issues collective operations recorded into stream command buffers against
+  // a dedicated stream per queue so that they overlap with independent work
+  // recorded after them. The queue stream waits for the collectives at the
+  // next barrier. When disabled collectives execute inline on the queue stream.
+  bool async_collectives;
+
+  // Parameters for each CUmemoryPool used for queue-ordered allocations.
+  iree_hal_cuda_memory_pooling_params_t memory_pools;
+
   // Enables tracing of command buffers when IREE tracing is enabled.
   // May take advantage of additional extensions for more accurate timing or
   // hardware-specific performance counters.
@@ -64,6 +112,11 @@ typedef struct iree_hal_cuda_device_params_t {
   // tracing with this enabled.
   bool stream_tracing;
 
+  // Enables tracing of dispatches within graph command buffers by bracketing
+  // them with event record nodes. Requires |stream_tracing|. Traced graphs
+  // are instantiated per command buffer and bypass the graph exec cache.
+  bool graph_tracing;
+
   // Unowned provider of default channel configuration and creation.
   // Must remain valid for the lifetime of the driver/device.
   iree_hal_channel_provider_t channel_provider;
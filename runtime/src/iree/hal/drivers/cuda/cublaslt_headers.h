@@ -0,0 +1,65 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUBLASLT_HEADERS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUBLASLT_HEADERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal subset of the cuBLASLt API declarations used by library calls.
+// cuBLASLt is loaded dynamically and optional so we declare only what we need
+// here instead of requiring the full CUDA toolkit headers at build time. All
+// values must match cublasLt.h and library_types.h of CUDA 11.x/12.x.
+
+typedef int cublasStatus_t;
+#define CUBLAS_STATUS_SUCCESS 0
+
+typedef int cublasComputeType_t;
+#define CUBLAS_COMPUTE_32F 68
+
+typedef int cudaDataType_t;
+#define CUDA_R_32F 0
+#define CUDA_R_16F 2
+#define CUDA_R_16BF 14
+
+typedef int cublasOperation_t;
+#define CUBLAS_OP_N 0
+#define CUBLAS_OP_T 1
+
+typedef int cublasLtMatmulDescAttributes_t;
+#define CUBLASLT_MATMUL_DESC_TRANSA 3
+#define CUBLASLT_MATMUL_DESC_TRANSB 4
+#define CUBLASLT_MATMUL_DESC_EPILOGUE 7
+#define CUBLASLT_MATMUL_DESC_BIAS_POINTER 8
+
+typedef int cublasLtEpilogue_t;
+#define CUBLASLT_EPILOGUE_DEFAULT 1
+#define CUBLASLT_EPILOGUE_RELU 2
+#define CUBLASLT_EPILOGUE_BIAS 4
+#define CUBLASLT_EPILOGUE_RELU_BIAS 6
+
+typedef int cublasLtMatmulPreferenceAttributes_t;
+#define CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES 1
+
+typedef struct cublasLtContext* cublasLtHandle_t;
+typedef struct cublasLtMatmulDescOpaque_t* cublasLtMatmulDesc_t;
+typedef struct cublasLtMatrixLayoutOpaque_t* cublasLtMatrixLayout_t;
+typedef struct cublasLtMatmulPreferenceOpaque_t* cublasLtMatmulPreference_t;
+
+typedef struct cublasLtMatmulAlgo_t {
+  uint64_t data[8];
+} cublasLtMatmulAlgo_t;
+
+typedef struct cublasLtMatmulHeuristicResult_t {
+  cublasLtMatmulAlgo_t algo;
+  size_t workspaceSize;
+  cublasStatus_t state;
+  float wavesCount;
+  int reserved[4];
+} cublasLtMatmulHeuristicResult_t;
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUBLASLT_HEADERS_H_
@@ -25,6 +25,9 @@ typedef struct iree_hal_cuda_allocator_t {
   CUdevice device;
   CUstream stream;
   bool supports_concurrent_managed_access;
+  // True if the device is integrated with the host and shares its physical
+  // memory such that registered host memory is as fast as device memory.
+  bool is_integrated;
 
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_cuda_allocator_t;
@@ -65,6 +68,16 @@ iree_status_t iree_hal_cuda_allocator_create(
               : "no CONCURRENT_MANAGED_ACCESS (expect slow accesses on "
                 "device-local + host-visible memory)");
 
+  // Integrated devices (Jetson/etc) share physical memory with the host and
+  // can serve device-local requests directly out of registered host memory.
+  int is_integrated = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, CU_RESULT_TO_STATUS(context->syms,
+                              cuDeviceGetAttribute(
+                                  &is_integrated,
+                                  CU_DEVICE_ATTRIBUTE_INTEGRATED, device),
+                              "cuDeviceGetAttribute"));
+
   iree_hal_cuda_allocator_t* allocator = NULL;
   iree_status_t status = iree_allocator_malloc(
       context->host_allocator, sizeof(*allocator), (void**)&allocator);
@@ -77,6 +90,7 @@ iree_status_t iree_hal_cuda_allocator_create(
     allocator->stream = stream;
     allocator->supports_concurrent_managed_access =
         supports_concurrent_managed_access != 0;
+    allocator->is_integrated = is_integrated != 0;
     *out_allocator = (iree_hal_allocator_t*)allocator;
   }
 
@@ -274,6 +288,15 @@ static void iree_hal_cuda_buffer_free(iree_hal_cuda_context_wrapper_t* context,
       CUDA_IGNORE_ERROR(context->syms, cuMemHostUnregister(host_ptr));
       break;
     }
+    case IREE_HAL_CUDA_BUFFER_TYPE_ASYNC: {
+      // Stream-ordered allocations are freed by the memory pools that
+      // created them and never route through the allocator.
+      break;
+    }
+    case IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL: {
+      // Owned by whoever exported the allocation to us.
+      break;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
 }
@@ -366,8 +389,8 @@ static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
   iree_hal_buffer_t* buffer = NULL;
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_buffer_wrap(
-        base_allocator, compat_params.type, compat_params.access,
-        compat_params.usage, allocation_size,
+        base_allocator, allocator->context->host_allocator, compat_params.type,
+        compat_params.access, compat_params.usage, allocation_size,
         /*byte_offset=*/0,
         /*byte_length=*/allocation_size, buffer_type, device_ptr, host_ptr,
         iree_hal_buffer_release_callback_null(), &buffer);
@@ -496,22 +519,37 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION: {
       if (iree_all_bits_set(compat_params.type,
                             IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
-        return iree_make_status(
-            IREE_STATUS_INVALID_ARGUMENT,
-            "unable to register host allocations as device-local memory");
+        // Immutable constants (usually rodata mapped from the module file) can
+        // be served directly out of the host memory on integrated devices
+        // where the memory is physically shared. On discrete devices this
+        // would route every access over the bus and it's better to copy.
+        if (!allocator->is_integrated ||
+            compat_params.access != IREE_HAL_MEMORY_ACCESS_READ ||
+            !iree_all_bits_set(compat_params.usage,
+                               IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE)) {
+          return iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "unable to register host allocations as device-local memory");
+        }
+        compat_params.type &= ~IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+        compat_params.type |= IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                              IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
       }
       buffer_type = IREE_HAL_CUDA_BUFFER_TYPE_HOST_REGISTERED;
       host_ptr = external_buffer->handle.host_allocation.ptr;
+      // NOTE: read-only registration is required for memory that is mapped
+      // read-only such as file mappings and must be preserved when also
+      // mapping the memory into the device address space.
       uint32_t register_flags = 0;
       if (compat_params.access == IREE_HAL_MEMORY_ACCESS_READ) {
-        register_flags = CU_MEMHOSTREGISTER_READ_ONLY;
+        register_flags |= CU_MEMHOSTREGISTER_READ_ONLY;
       }
       if (iree_any_bit_set(compat_params.usage,
                            IREE_HAL_BUFFER_USAGE_DISPATCH_INDIRECT_PARAMS |
                                IREE_HAL_BUFFER_USAGE_DISPATCH_UNIFORM_READ |
                                IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
                                IREE_HAL_BUFFER_USAGE_DISPATCH_IMAGE)) {
-        register_flags = CU_MEMHOSTREGISTER_DEVICEMAP;
+        register_flags |= CU_MEMHOSTREGISTER_DEVICEMAP;
       }
       status = CU_RESULT_TO_STATUS(
           allocator->context->syms,
@@ -525,6 +563,18 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
       }
       break;
     }
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION: {
+      // The pointer is used as-is: the allocation must have been made in this
+      // context and its owner is notified via |release_callback| when the HAL
+      // no longer references it.
+      buffer_type = IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL;
+      device_ptr = (CUdeviceptr)external_buffer->handle.device_allocation.ptr;
+      if (!device_ptr) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "device allocation pointer is NULL");
+      }
+      break;
+    }
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD:
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32:
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
@@ -537,8 +587,8 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
   iree_hal_buffer_t* buffer = NULL;
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_buffer_wrap(
-        base_allocator, compat_params.type, compat_params.access,
-        compat_params.usage, external_buffer->size,
+        base_allocator, allocator->context->host_allocator, compat_params.type,
+        compat_params.access, compat_params.usage, external_buffer->size,
         /*byte_offset=*/0,
         /*byte_length=*/external_buffer->size, buffer_type, device_ptr,
         host_ptr, release_callback, &buffer);
@@ -563,8 +613,42 @@ static iree_status_t iree_hal_cuda_allocator_export_buffer(
     iree_hal_external_buffer_type_t requested_type,
     iree_hal_external_buffer_flags_t requested_flags,
     iree_hal_external_buffer_t* IREE_RESTRICT out_external_buffer) {
-  return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                          "exporting to external buffers not supported");
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  switch (requested_type) {
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION: {
+      // Note that the returned pointer is unowned and is offset to the start
+      // of the buffer within its allocation.
+      CUdeviceptr device_ptr =
+          iree_hal_cuda_buffer_device_pointer(allocated_buffer);
+      if (!device_ptr) {
+        return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "buffer has no device pointer");
+      }
+      out_external_buffer->type = requested_type;
+      out_external_buffer->flags = requested_flags;
+      out_external_buffer->size = iree_hal_buffer_byte_length(buffer);
+      out_external_buffer->handle.device_allocation.ptr =
+          (uint64_t)(device_ptr + iree_hal_buffer_byte_offset(buffer));
+      return iree_ok_status();
+    }
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION: {
+      void* host_ptr = iree_hal_cuda_buffer_host_pointer(allocated_buffer);
+      if (!host_ptr) {
+        return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "buffer is not host accessible");
+      }
+      out_external_buffer->type = requested_type;
+      out_external_buffer->flags = requested_flags;
+      out_external_buffer->size = iree_hal_buffer_byte_length(buffer);
+      out_external_buffer->handle.host_allocation.ptr =
+          (uint8_t*)host_ptr + iree_hal_buffer_byte_offset(buffer);
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "external buffer type not supported");
+  }
 }
 
 static const iree_hal_allocator_vtable_t iree_hal_cuda_allocator_vtable = {
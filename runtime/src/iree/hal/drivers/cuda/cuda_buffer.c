@@ -36,19 +36,17 @@ static const iree_hal_cuda_buffer_t* iree_hal_cuda_buffer_const_cast(
 }
 
 iree_status_t iree_hal_cuda_buffer_wrap(
-    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_allocator_t* allocator, iree_allocator_t host_allocator,
+    iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
     iree_hal_cuda_buffer_type_t buffer_type, CUdeviceptr device_ptr,
     void* host_ptr, iree_hal_buffer_release_callback_t release_callback,
     iree_hal_buffer_t** out_buffer) {
-  IREE_ASSERT_ARGUMENT(allocator);
   IREE_ASSERT_ARGUMENT(out_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_allocator_t host_allocator =
-      iree_hal_allocator_host_allocator(allocator);
   iree_hal_cuda_buffer_t* buffer = NULL;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
@@ -145,6 +143,12 @@ CUdeviceptr iree_hal_cuda_buffer_device_pointer(
   return buffer->device_ptr;
 }
 
+void iree_hal_cuda_buffer_set_device_pointer(iree_hal_buffer_t* base_buffer,
+                                             CUdeviceptr device_ptr) {
+  iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
+  buffer->device_ptr = device_ptr;
+}
+
 void* iree_hal_cuda_buffer_host_pointer(const iree_hal_buffer_t* base_buffer) {
   const iree_hal_cuda_buffer_t* buffer =
       iree_hal_cuda_buffer_const_cast(base_buffer);
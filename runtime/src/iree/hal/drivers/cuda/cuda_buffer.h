@@ -22,11 +22,19 @@ typedef enum iree_hal_cuda_buffer_type_e {
   IREE_HAL_CUDA_BUFFER_TYPE_HOST = 1u << 1,
   // cuMemHostRegister + cuMemHostUnregister
   IREE_HAL_CUDA_BUFFER_TYPE_HOST_REGISTERED = 1u << 2,
+  // cuMemAllocFromPoolAsync + cuMemFreeAsync
+  IREE_HAL_CUDA_BUFFER_TYPE_ASYNC = 1u << 3,
+  // Externally owned device allocation; not freed by the HAL.
+  IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL = 1u << 4,
 } iree_hal_cuda_buffer_type_t;
 
 // Wraps a CUDA allocation in an iree_hal_buffer_t.
+// |allocator| is optional and if omitted the buffer will be destroyed when
+// released instead of being returned to the allocator; |host_allocator| is used
+// for the buffer wrapper itself.
 iree_status_t iree_hal_cuda_buffer_wrap(
-    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_allocator_t* allocator, iree_allocator_t host_allocator,
+    iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
@@ -44,6 +52,13 @@ iree_hal_cuda_buffer_type_t iree_hal_cuda_buffer_type(
 CUdeviceptr iree_hal_cuda_buffer_device_pointer(
     const iree_hal_buffer_t* buffer);
 
+// Replaces the CUDA base pointer of the given |buffer|.
+// Used by stream-ordered deallocations to indicate that the device memory has
+// already been freed (by setting the pointer to 0) when the buffer wrapper
+// outlives the allocation.
+void iree_hal_cuda_buffer_set_device_pointer(iree_hal_buffer_t* buffer,
+                                             CUdeviceptr device_ptr);
+
 // Returns the CUDA host pointer for the given |buffer|, if available.
 void* iree_hal_cuda_buffer_host_pointer(const iree_hal_buffer_t* buffer);
 
@@ -17,11 +17,15 @@
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
 #include "iree/hal/drivers/cuda/cuda_event.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/event_semaphore.h"
 #include "iree/hal/drivers/cuda/graph_command_buffer.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
+#include "iree/hal/drivers/cuda/memory_pools.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/nop_executable_cache.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
+#include "iree/hal/drivers/cuda/staging_buffer.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 #include "iree/hal/drivers/cuda/stream_command_buffer.h"
 #include "iree/hal/drivers/cuda/tracing.h"
@@ -32,7 +36,35 @@
 // iree_hal_cuda_device_t
 //===----------------------------------------------------------------------===//
 
-typedef struct iree_hal_cuda_device_t {
+// A device queue backed by its own CUDA stream.
+typedef struct iree_hal_cuda_device_queue_t {
+  CUstream stream;
+  // Event recorded on |stream| when work issued to other queues needs to be
+  // ordered against work issued to this one with cuStreamWaitEvent.
+  // Only created when the device has more than one queue.
+  CUevent event;
+  // Stream collective operations are issued against so that they overlap with
+  // work issued to |stream|. Only created when async collectives are enabled.
+  CUstream collective_stream;
+  iree_hal_cuda_tracing_context_t* tracing_context;
+} iree_hal_cuda_device_queue_t;
+
+typedef struct iree_hal_cuda_device_t iree_hal_cuda_device_t;
+
+// Resources kept live until the work of a queue operation completes.
+// Completed submissions are posted by a CUDA host function and reclaimed later
+// by a host thread as host functions must not make CUDA calls.
+typedef struct iree_hal_cuda_device_submission_t {
+  struct iree_hal_cuda_device_submission_t* next;
+  iree_hal_cuda_device_t* device;
+  // Retained command buffers referenced by work on the stream.
+  iree_host_size_t command_buffer_count;
+  iree_hal_command_buffer_t** command_buffers;
+  // Retained semaphores signaled when the work completes.
+  iree_hal_semaphore_list_t signal_semaphore_list;
+} iree_hal_cuda_device_submission_t;
+
+struct iree_hal_cuda_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
 
@@ -49,16 +81,36 @@ typedef struct iree_hal_cuda_device_t {
 
   CUdevice device;
 
-  // TODO: support multiple streams.
-  CUstream stream;
   iree_hal_cuda_context_wrapper_t context_wrapper;
-  iree_hal_cuda_tracing_context_t* tracing_context;
   iree_hal_allocator_t* device_allocator;
 
-  // Cache of the direct stream command buffer initialized when in stream mode.
-  // TODO: have one cached per stream once there are multiple streams.
-  iree_hal_command_buffer_t* stream_command_buffer;
-} iree_hal_cuda_device_t;
+  // Whether |memory_pools| was initialized and can be used for queue-ordered
+  // allocations. Devices without memory pool support fall back to synchronous
+  // allocations.
+  bool supports_memory_pools;
+  // Memory pools used for stream-ordered queue allocations.
+  iree_hal_cuda_memory_pools_t memory_pools;
+
+  // Cache of instantiated graphs reused across graph command buffers.
+  iree_hal_cuda_graph_exec_cache_t graph_exec_cache;
+
+  // Events used by semaphores to order stream work against signals.
+  iree_hal_cuda_event_pool_t event_pool;
+  // Pinned host memory used for synchronous transfers with host memory.
+  iree_hal_cuda_staging_buffer_t staging_buffer;
+  // Posted whenever any semaphore created by the device changes value.
+  iree_notification_t semaphore_notification;
+
+  // Submissions whose work has completed and whose resources can be released.
+  iree_slim_mutex_t completion_mutex;
+  iree_hal_cuda_device_submission_t* completed_head;
+
+  // Queues selected by queue affinity, each with its own stream. Work issued
+  // to different queues may execute concurrently. The first queue is also used
+  // by the allocator and memory pools for work not issued to a queue.
+  iree_host_size_t queue_count;
+  iree_hal_cuda_device_queue_t queues[];
+};
 
 static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable;
 
@@ -74,8 +126,14 @@ IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 1;
   out_params->command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->graph_exec_cache_capacity = 64;
+  out_params->staging_buffer_size = 8 * 1024 * 1024;
   out_params->allow_inline_execution = false;
   out_params->stream_tracing = false;
+  out_params->graph_tracing = false;
+  out_params->async_allocations = true;
+  out_params->async_collectives = true;
+  out_params->memory_pools.device_local.release_threshold = UINT64_MAX;
 }
 
 static iree_status_t iree_hal_cuda_device_check_params(
@@ -88,42 +146,112 @@ static iree_status_t iree_hal_cuda_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "at least one queue is required");
   }
+  if (params->queue_count > sizeof(iree_hal_queue_affinity_t) * 8) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue count %" PRIhsz
+                            " exceeds the number of queue affinity bits",
+                            params->queue_count);
+  }
+  if (params->staging_buffer_size != 0 && params->staging_buffer_size < 4096) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "staging buffer size too small (< 4096 bytes)");
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_cuda_device_create_queue(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue) {
+  iree_hal_cuda_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  IREE_RETURN_IF_ERROR(CU_RESULT_TO_STATUS(
+      syms, cuStreamCreate(&queue->stream, CU_STREAM_NON_BLOCKING)));
+
+  if (device->queue_count > 1) {
+    IREE_RETURN_IF_ERROR(CU_RESULT_TO_STATUS(
+        syms, cuEventCreate(&queue->event, CU_EVENT_DISABLE_TIMING)));
+  }
+
+  if (device->params.async_collectives) {
+    IREE_RETURN_IF_ERROR(CU_RESULT_TO_STATUS(
+        syms,
+        cuStreamCreate(&queue->collective_stream, CU_STREAM_NON_BLOCKING)));
+  }
+
+  // Enable tracing for the stream - no-op if disabled.
+  if (device->params.stream_tracing) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_tracing_context_allocate(
+        &device->context_wrapper, device->identifier, queue->stream,
+        &device->block_pool, device->context_wrapper.host_allocator,
+        &queue->tracing_context));
+  }
   return iree_ok_status();
 }
 
+static void iree_hal_cuda_device_destroy_queue(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue) {
+  iree_hal_cuda_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  iree_hal_cuda_tracing_context_free(queue->tracing_context);
+  if (queue->event) {
+    CUDA_IGNORE_ERROR(syms, cuEventDestroy(queue->event));
+  }
+  if (queue->collective_stream) {
+    CUDA_IGNORE_ERROR(syms, cuStreamDestroy(queue->collective_stream));
+  }
+  if (queue->stream) {
+    CUDA_IGNORE_ERROR(syms, cuStreamDestroy(queue->stream));
+  }
+}
+
+// Takes ownership of the retained primary |context| of |cu_device|.
 static iree_status_t iree_hal_cuda_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params, CUdevice cu_device,
-    CUstream stream, CUcontext context, iree_hal_cuda_dynamic_symbols_t* syms,
+    CUcontext context, iree_hal_cuda_dynamic_symbols_t* syms,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_cuda_device_t* device = NULL;
-  iree_host_size_t total_size = iree_sizeof_struct(*device) + identifier.size;
-  IREE_RETURN_IF_ERROR(
-      iree_allocator_malloc(host_allocator, total_size, (void**)&device));
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*device) +
+      params->queue_count * sizeof(device->queues[0]) + identifier.size;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, total_size, (void**)&device);
+  if (!iree_status_is_ok(status)) {
+    syms->cuDevicePrimaryCtxRelease(cu_device);
+    return status;
+  }
   memset(device, 0, total_size);
   iree_hal_resource_initialize(&iree_hal_cuda_device_vtable, &device->resource);
   device->driver = driver;
   iree_hal_driver_retain(device->driver);
   iree_string_view_append_to_buffer(
       identifier, &device->identifier,
-      (char*)device + iree_sizeof_struct(*device));
+      (char*)device + iree_sizeof_struct(*device) +
+          params->queue_count * sizeof(device->queues[0]));
   device->params = *params;
   device->device = cu_device;
-  device->stream = stream;
   device->context_wrapper.cu_device = cu_device;
   device->context_wrapper.cu_context = context;
   device->context_wrapper.host_allocator = host_allocator;
   iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                    &device->block_pool);
   device->context_wrapper.syms = syms;
-
-  // Enable tracing for the (currently only) stream - no-op if disabled.
-  iree_status_t status = iree_ok_status();
-  if (device->params.stream_tracing) {
-    status = iree_hal_cuda_tracing_context_allocate(
-        &device->context_wrapper, device->identifier, stream,
-        &device->block_pool, host_allocator, &device->tracing_context);
+  iree_hal_cuda_event_pool_initialize(&device->context_wrapper,
+                                      &device->event_pool);
+  iree_hal_cuda_staging_buffer_initialize(&device->context_wrapper,
+                                          params->staging_buffer_size,
+                                          &device->staging_buffer);
+  iree_notification_initialize(&device->semaphore_notification);
+  iree_slim_mutex_initialize(&device->completion_mutex);
+
+  status = iree_hal_cuda_graph_exec_cache_initialize(
+      &device->context_wrapper, params->graph_exec_cache_capacity,
+      &device->graph_exec_cache);
+
+  // Queues are created in order so that a failure leaves a prefix to destroy.
+  device->queue_count = params->queue_count;
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < device->queue_count; ++i) {
+    status = iree_hal_cuda_device_create_queue(device, &device->queues[i]);
   }
+  CUstream stream = device->queues[0].stream;
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_allocator_create((iree_hal_device_t*)device,
@@ -131,15 +259,19 @@ static iree_status_t iree_hal_cuda_device_create_internal(
                                             stream, &device->device_allocator);
   }
 
-  if (iree_status_is_ok(status) &&
-      params->command_buffer_mode == IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM) {
-    status = iree_hal_cuda_stream_command_buffer_create(
-        (iree_hal_device_t*)device, &device->context_wrapper,
-        device->tracing_context,
-        IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
-            IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
-        IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/0, device->stream,
-        &device->block_pool, &device->stream_command_buffer);
+  // Memory pools are optional and only used for queue-ordered allocations; if
+  // unsupported (or disabled) we fall back to synchronous allocations.
+  if (iree_status_is_ok(status) && params->async_allocations) {
+    iree_status_t pools_status = iree_hal_cuda_memory_pools_initialize(
+        &device->context_wrapper, cu_device, stream, &params->memory_pools,
+        &device->memory_pools);
+    if (iree_status_is_ok(pools_status)) {
+      device->supports_memory_pools = true;
+    } else if (iree_status_is_unavailable(pools_status)) {
+      iree_status_ignore(pools_status);
+    } else {
+      status = pools_status;
+    }
   }
 
   if (iree_status_is_ok(status)) {
@@ -159,25 +291,20 @@ iree_status_t iree_hal_cuda_device_create(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
                                     iree_hal_cuda_device_check_params(params));
+  // Drivers only resolve the symbols needed for enumeration; resolve the rest
+  // now that they are needed (no-op after the first device).
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_dynamic_symbols_resolve_device(syms));
   CUcontext context;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
       CU_RESULT_TO_STATUS(syms, cuDevicePrimaryCtxRetain(&context, device)));
   iree_status_t status = CU_RESULT_TO_STATUS(syms, cuCtxSetCurrent(context));
-  CUstream stream;
-  if (iree_status_is_ok(status)) {
-    status = CU_RESULT_TO_STATUS(
-        syms, cuStreamCreate(&stream, CU_STREAM_NON_BLOCKING));
-  }
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_device_create_internal(driver, identifier, params,
-                                                  device, stream, context, syms,
+                                                  device, context, syms,
                                                   host_allocator, out_device);
-  }
-  if (!iree_status_is_ok(status)) {
-    if (stream) {
-      syms->cuStreamDestroy(stream);
-    }
+  } else {
     syms->cuDevicePrimaryCtxRelease(device);
   }
   IREE_TRACE_ZONE_END(z0);
@@ -198,20 +325,70 @@ iree_status_t iree_hal_cuda_device_get_context(iree_hal_device_t* base_device,
   return iree_ok_status();
 }
 
+static void iree_hal_cuda_device_submission_release(
+    iree_hal_cuda_device_submission_t* submission) {
+  iree_allocator_t host_allocator =
+      submission->device->context_wrapper.host_allocator;
+  for (iree_host_size_t i = 0; i < submission->command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(submission->command_buffers[i]);
+  }
+  for (iree_host_size_t i = 0; i < submission->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_release(submission->signal_semaphore_list.semaphores[i]);
+  }
+  iree_allocator_free(host_allocator, submission);
+}
+
+// Releases the resources of all submissions that have completed.
+static void iree_hal_cuda_device_reclaim_submissions(
+    iree_hal_cuda_device_t* device) {
+  iree_slim_mutex_lock(&device->completion_mutex);
+  iree_hal_cuda_device_submission_t* submission = device->completed_head;
+  device->completed_head = NULL;
+  iree_slim_mutex_unlock(&device->completion_mutex);
+  if (!submission) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  while (submission) {
+    iree_hal_cuda_device_submission_t* next = submission->next;
+    iree_hal_cuda_device_submission_release(submission);
+    submission = next;
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
 static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_command_buffer_release(device->stream_command_buffer);
+  // Wait for all in-flight work (including host functions posting completed
+  // submissions) so that nothing references the device after this returns.
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    if (!device->queues[i].stream) continue;
+    CUDA_IGNORE_ERROR(device->context_wrapper.syms,
+                      cuStreamSynchronize(device->queues[i].stream));
+  }
+  iree_hal_cuda_device_reclaim_submissions(device);
 
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
 
-  // TODO: support multiple streams.
-  iree_hal_cuda_tracing_context_free(device->tracing_context);
-  CUDA_IGNORE_ERROR(device->context_wrapper.syms,
-                    cuStreamDestroy(device->stream));
+  // Destroy memory pools that hold on to reserved memory. Outstanding
+  // stream-ordered frees have completed above.
+  if (device->supports_memory_pools) {
+    iree_hal_cuda_memory_pools_deinitialize(&device->memory_pools);
+  }
+
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_cuda_device_destroy_queue(device, &device->queues[i]);
+  }
+
+  iree_hal_cuda_graph_exec_cache_deinitialize(&device->graph_exec_cache);
+  iree_hal_cuda_staging_buffer_deinitialize(&device->staging_buffer);
+
+  iree_slim_mutex_deinitialize(&device->completion_mutex);
+  iree_notification_deinitialize(&device->semaphore_notification);
+  iree_hal_cuda_event_pool_deinitialize(&device->event_pool);
 
   iree_arena_block_pool_deinitialize(&device->block_pool);
 
@@ -254,8 +431,14 @@ static void iree_hal_cuda_replace_device_allocator(
 
 static iree_status_t iree_hal_cuda_device_trim(iree_hal_device_t* base_device) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_device_reclaim_submissions(device);
   iree_arena_block_pool_trim(&device->block_pool);
-  return iree_hal_allocator_trim(device->device_allocator);
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
+  if (device->supports_memory_pools) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_memory_pools_trim(
+        &device->memory_pools, &device->params.memory_pools));
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_device_query_i64(
@@ -359,6 +542,50 @@ static iree_status_t iree_hal_cuda_device_create_channel(
       &device->context_wrapper, &id, params.rank, params.count, out_channel);
 }
 
+// Returns the queue to issue work to based on the |queue_affinity|.
+// Work with equivalent affinities always maps to the same queue.
+static iree_hal_cuda_device_queue_t* iree_hal_cuda_device_select_queue(
+    iree_hal_cuda_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  return &device->queues[queue_affinity % device->queue_count];
+}
+
+// Orders all work subsequently issued to the other queues of |device| after
+// the work issued to |queue| so far.
+static iree_status_t iree_hal_cuda_device_publish_queue(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue) {
+  if (device->queue_count == 1) return iree_ok_status();
+  iree_hal_cuda_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  CUDA_RETURN_IF_ERROR(syms, cuEventRecord(queue->event, queue->stream),
+                       "cuEventRecord");
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_cuda_device_queue_t* other_queue = &device->queues[i];
+    if (other_queue == queue) continue;
+    CUDA_RETURN_IF_ERROR(
+        syms, cuStreamWaitEvent(other_queue->stream, queue->event, 0),
+        "cuStreamWaitEvent");
+  }
+  return iree_ok_status();
+}
+
+// Orders all work subsequently issued to |queue| after the work issued to the
+// other queues of |device| so far.
+static iree_status_t iree_hal_cuda_device_join_queues(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue) {
+  if (device->queue_count == 1) return iree_ok_status();
+  iree_hal_cuda_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_hal_cuda_device_queue_t* other_queue = &device->queues[i];
+    if (other_queue == queue) continue;
+    CUDA_RETURN_IF_ERROR(
+        syms, cuEventRecord(other_queue->event, other_queue->stream),
+        "cuEventRecord");
+    CUDA_RETURN_IF_ERROR(
+        syms, cuStreamWaitEvent(queue->stream, other_queue->event, 0),
+        "cuStreamWaitEvent");
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_cuda_device_create_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
@@ -372,17 +599,20 @@ static iree_status_t iree_hal_cuda_device_create_command_buffer(
     // recorded, implying that the command buffer cannot be reused and doesn't
     // need to be persisted. This lets us lower the execution delay as we can
     // directly route commands to a CUDA stream and let it eagerly flush.
+    iree_hal_cuda_device_queue_t* queue =
+        iree_hal_cuda_device_select_queue(device, queue_affinity);
     return iree_hal_cuda_stream_command_buffer_create(
-        base_device, &device->context_wrapper, device->tracing_context, mode,
-        command_categories, binding_capacity, device->stream,
-        &device->block_pool, out_command_buffer);
+        base_device, &device->context_wrapper, queue->tracing_context, mode,
+        command_categories, binding_capacity, queue->stream,
+        queue->collective_stream, &device->event_pool, &device->block_pool,
+        out_command_buffer);
   }
   switch (device->params.command_buffer_mode) {
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH:
       return iree_hal_cuda_graph_command_buffer_create(
           base_device, &device->context_wrapper, mode, command_categories,
-          queue_affinity, binding_capacity, &device->block_pool,
-          out_command_buffer);
+          queue_affinity, binding_capacity, device->params.graph_tracing,
+          &device->block_pool, &device->graph_exec_cache, out_command_buffer);
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM:
       return iree_hal_deferred_command_buffer_create(
           base_device, mode, command_categories, binding_capacity,
@@ -435,17 +665,175 @@ static iree_status_t iree_hal_cuda_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
-  return iree_hal_cuda_semaphore_create(&device->context_wrapper, initial_value,
-                                        out_semaphore);
+  return iree_hal_cuda_semaphore_create(
+      &device->context_wrapper, &device->event_pool,
+      &device->semaphore_notification, initial_value, out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
 iree_hal_cuda_device_query_semaphore_compatibility(
     iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
-  // TODO: implement CUDA semaphores.
+  // CUDA semaphores can be waited on and signaled by streams. Other semaphores
+  // are waited on the host prior to issuing work.
+  if (iree_hal_cuda_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
+  }
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
+// Allocates a submission able to retain up to |command_buffer_capacity|
+// command buffers and the semaphores in |signal_semaphore_list|.
+static iree_status_t iree_hal_cuda_device_submission_allocate(
+    iree_hal_cuda_device_t* device, iree_host_size_t command_buffer_capacity,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_cuda_device_submission_t** out_submission) {
+  *out_submission = NULL;
+  iree_hal_cuda_device_submission_t* submission = NULL;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*submission) +
+      command_buffer_capacity * sizeof(*submission->command_buffers) +
+      signal_semaphore_list.count *
+          (sizeof(*signal_semaphore_list.semaphores) +
+           sizeof(*signal_semaphore_list.payload_values));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->context_wrapper.host_allocator, total_size, (void**)&submission));
+  memset(submission, 0, total_size);
+  submission->device = device;
+  uint8_t* ptr = (uint8_t*)submission + iree_sizeof_struct(*submission);
+  submission->command_buffers = (iree_hal_command_buffer_t**)ptr;
+  ptr += command_buffer_capacity * sizeof(*submission->command_buffers);
+  submission->signal_semaphore_list.count = signal_semaphore_list.count;
+  submission->signal_semaphore_list.semaphores = (iree_hal_semaphore_t**)ptr;
+  ptr +=
+      signal_semaphore_list.count * sizeof(*signal_semaphore_list.semaphores);
+  submission->signal_semaphore_list.payload_values = (uint64_t*)ptr;
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    submission->signal_semaphore_list.semaphores[i] =
+        signal_semaphore_list.semaphores[i];
+    iree_hal_semaphore_retain(signal_semaphore_list.semaphores[i]);
+    submission->signal_semaphore_list.payload_values[i] =
+        signal_semaphore_list.payload_values[i];
+  }
+  *out_submission = submission;
+  return iree_ok_status();
+}
+
+// Orders work subsequently issued to |queue| after |wait_semaphore_list| is
+// satisfied. CUDA semaphores with signals issued to a stream are waited on by
+// the stream; all others are waited on the host and block the caller until
+// they are signaled.
+static iree_status_t iree_hal_cuda_device_queue_wait(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+    uint64_t value = wait_semaphore_list.payload_values[i];
+    bool waited = false;
+    if (iree_hal_cuda_semaphore_isa(semaphore)) {
+      IREE_RETURN_IF_ERROR(iree_hal_cuda_semaphore_stream_wait(
+          semaphore, value, queue->stream, &waited));
+    }
+    if (!waited) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_semaphore_wait(semaphore, value, iree_infinite_timeout()));
+    }
+  }
+  return iree_ok_status();
+}
+
+// Called by CUDA once all work issued to a stream prior to a submission has
+// completed. Must not make CUDA calls: semaphores are advanced and waiters
+// woken but resources are released later by the host.
+static void CUDA_CB iree_hal_cuda_device_complete_submission(void* user_data) {
+  iree_hal_cuda_device_submission_t* submission =
+      (iree_hal_cuda_device_submission_t*)user_data;
+  iree_hal_cuda_device_t* device = submission->device;
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    if (iree_hal_cuda_semaphore_isa(list->semaphores[i])) {
+      iree_hal_cuda_semaphore_notify_signaled(list->semaphores[i],
+                                              list->payload_values[i]);
+    } else {
+      iree_status_t status = iree_hal_semaphore_signal(list->semaphores[i],
+                                                       list->payload_values[i]);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_semaphore_fail(list->semaphores[i], status);
+      }
+    }
+  }
+  iree_slim_mutex_lock(&device->completion_mutex);
+  submission->next = device->completed_head;
+  device->completed_head = submission;
+  iree_slim_mutex_unlock(&device->completion_mutex);
+}
+
+// Signals the semaphores of |submission| and releases its resources once the
+// work issued to |queue| so far completes. Takes ownership of |submission|
+// regardless of success.
+static iree_status_t iree_hal_cuda_device_queue_signal(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue,
+    iree_hal_cuda_device_submission_t* submission) {
+  const iree_hal_semaphore_list_t* list = &submission->signal_semaphore_list;
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; iree_status_is_ok(status) && i < list->count;
+       ++i) {
+    if (iree_hal_cuda_semaphore_isa(list->semaphores[i])) {
+      status = iree_hal_cuda_semaphore_stream_signal(
+          list->semaphores[i], list->payload_values[i], queue->stream);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    status = CU_RESULT_TO_STATUS(
+        device->context_wrapper.syms,
+        cuLaunchHostFunc(queue->stream,
+                         iree_hal_cuda_device_complete_submission, submission),
+        "cuLaunchHostFunc");
+  }
+  if (!iree_status_is_ok(status)) {
+    // Work referencing the submission resources may still be in flight.
+    CUDA_IGNORE_ERROR(device->context_wrapper.syms,
+                      cuStreamSynchronize(queue->stream));
+    iree_hal_cuda_device_submission_release(submission);
+  }
+  return status;
+}
+
+// Returns true if |buffer| is host memory or a buffer that can be mapped.
+static bool iree_hal_cuda_transfer_buffer_is_mappable(
+    iree_hal_transfer_buffer_t buffer) {
+  if (!buffer.device_buffer) return true;
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer.device_buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer.device_buffer),
+                           IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED);
+}
+
+static iree_status_t iree_hal_cuda_device_transfer_range(
+    iree_hal_device_t* base_device, iree_hal_transfer_buffer_t source,
+    iree_device_size_t source_offset, iree_hal_transfer_buffer_t target,
+    iree_device_size_t target_offset, iree_device_size_t data_length,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (device->params.staging_buffer_size == 0) {
+    return iree_hal_device_submit_transfer_range_and_wait(
+        base_device, source, source_offset, target, target_offset,
+        data_length, flags, timeout);
+  }
+  if (iree_hal_cuda_transfer_buffer_is_mappable(source) &&
+      iree_hal_cuda_transfer_buffer_is_mappable(target)) {
+    // Host-visible memory can be copied directly without device copies.
+    return iree_hal_device_transfer_mappable_range(
+        base_device, source, source_offset, target, target_offset,
+        data_length, flags, timeout);
+  }
+  // Device-local buffers are copied on the staging stream through pinned
+  // memory. The transfer completes before returning and the timeout is not
+  // observed as the copies are bounded by the transfer size.
+  return iree_hal_cuda_staging_buffer_transfer(&device->staging_buffer, source,
+                                               source_offset, target,
+                                               target_offset, data_length);
+}
+
 static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -453,15 +841,57 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  // TODO(benvanik): tracing of the allocations (just for sequencing).
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
-      iree_hal_device_allocator(base_device), params, allocation_size,
-      iree_const_byte_span_empty(), out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_device_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
+  iree_hal_cuda_device_reclaim_submissions(device);
+
+  // The allocation is ordered with respect to prior and subsequent work by the
+  // stream. As the buffer may be used by work issued to any queue the other
+  // queues are made to wait on the allocation.
+  iree_hal_cuda_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_status_t status =
+      iree_hal_cuda_device_queue_wait(device, queue, wait_semaphore_list);
+
+  // Try to allocate from the stream-ordered memory pools; if the memory type
+  // isn't supported by the pools we fall back to a synchronous allocation.
+  if (iree_status_is_ok(status)) {
+    status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+    if (device->supports_memory_pools) {
+      status = iree_hal_cuda_memory_pools_alloca(&device->memory_pools,
+                                                 queue->stream, pool, params,
+                                                 allocation_size, out_buffer);
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_cuda_device_publish_queue(device, queue);
+        if (!iree_status_is_ok(status)) {
+          iree_hal_buffer_release(*out_buffer);
+          *out_buffer = NULL;
+        }
+      }
+    }
+    if (iree_status_is_unavailable(status)) {
+      iree_status_ignore(status);
+      status = iree_hal_allocator_allocate_buffer(
+          iree_hal_device_allocator(base_device), params, allocation_size,
+          iree_const_byte_span_empty(), out_buffer);
+    }
+  }
+
+  // Signal; any work we issue that depends on the allocation will be ordered
+  // after it on the stream.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_device_queue_signal(device, queue, submission);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_buffer_release(*out_buffer);
+      *out_buffer = NULL;
+    }
+  } else {
+    iree_hal_cuda_device_submission_release(submission);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_device_queue_dealloca(
@@ -469,11 +899,79 @@ static iree_status_t iree_hal_cuda_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  // TODO(benvanik): tracing of the allocations (just for sequencing).
-  IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_device_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
+  iree_hal_cuda_device_reclaim_submissions(device);
+
+  iree_hal_cuda_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_device_submission_allocate(
+      device, /*command_buffer_capacity=*/0, signal_semaphore_list,
+      &submission));
+  iree_status_t status =
+      iree_hal_cuda_device_queue_wait(device, queue, wait_semaphore_list);
+
+  // Schedule the free on the stream so that it happens after all prior work
+  // using the buffer has completed on any queue. Synchronously allocated
+  // buffers are freed when they are released.
+  if (iree_status_is_ok(status) && device->supports_memory_pools) {
+    status = iree_hal_cuda_device_join_queues(device, queue);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_memory_pools_dealloca(&device->memory_pools,
+                                                   queue->stream, buffer);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_device_queue_signal(device, queue, submission);
+  } else {
+    iree_hal_cuda_device_submission_release(submission);
+  }
+  return status;
+}
+
+// Issues the work of |command_buffer| to |queue| and retains any command
+// buffers it requires in |submission|.
+static iree_status_t iree_hal_cuda_device_issue_command_buffer(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_device_queue_t* queue,
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_cuda_device_submission_t* submission) {
+  iree_hal_command_buffer_retain(command_buffer);
+  submission->command_buffers[submission->command_buffer_count++] =
+      command_buffer;
+  if (iree_hal_cuda_stream_command_buffer_isa(command_buffer)) {
+    // Nothing to do for an inline command buffer; all the work has already
+    // been submitted and we do not have to worry about any waits: if there
+    // were waits we wouldn't have been able to execute inline!
+    return iree_ok_status();
+  } else if (iree_hal_cuda_graph_command_buffer_isa(command_buffer)) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_graph_command_buffer_prepare_launch(
+        command_buffer, queue->tracing_context));
+    CUgraphExec exec =
+        iree_hal_cuda_graph_command_buffer_handle(command_buffer);
+    CUDA_RETURN_IF_ERROR(device->context_wrapper.syms,
+                         cuGraphLaunch(exec, queue->stream), "cuGraphLaunch");
+    return iree_ok_status();
+  }
+
+  // Deferred command buffers are replayed into a stream command buffer that
+  // is kept live until the work completes as its arena holds inline data
+  // referenced by the issued work.
+  iree_hal_command_buffer_t* stream_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_create(
+      (iree_hal_device_t*)device, &device->context_wrapper,
+      queue->tracing_context,
+      IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+          IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/0, queue->stream,
+      queue->collective_stream, &device->event_pool, &device->block_pool,
+      &stream_command_buffer));
+  submission->command_buffers[submission->command_buffer_count++] =
+      stream_command_buffer;
+  return iree_hal_deferred_command_buffer_apply(
+      command_buffer, stream_command_buffer,
+      iree_hal_buffer_binding_table_empty());
 }
 
 static iree_status_t iree_hal_cuda_device_queue_execute(
@@ -483,39 +981,38 @@ static iree_status_t iree_hal_cuda_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_device_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
+  iree_hal_cuda_device_reclaim_submissions(device);
 
   // TODO(benvanik): trace around the entire submission.
 
-  for (iree_host_size_t i = 0; i < command_buffer_count; i++) {
-    iree_hal_command_buffer_t* command_buffer = command_buffers[i];
-    if (iree_hal_cuda_stream_command_buffer_isa(command_buffer)) {
-      // Nothing to do for an inline command buffer; all the work has already
-      // been submitted. When we support semaphores we'll still need to signal
-      // their completion but do not have to worry about any waits: if there
-      // were waits we wouldn't have been able to execute inline!
-    } else if (iree_hal_cuda_graph_command_buffer_isa(command_buffer)) {
-      CUgraphExec exec =
-          iree_hal_cuda_graph_command_buffer_handle(command_buffers[i]);
-      CUDA_RETURN_IF_ERROR(device->context_wrapper.syms,
-                           cuGraphLaunch(exec, device->stream),
-                           "cuGraphLaunch");
-    } else {
-      IREE_RETURN_IF_ERROR(iree_hal_deferred_command_buffer_apply(
-          command_buffers[i], device->stream_command_buffer,
-          iree_hal_buffer_binding_table_empty()));
-    }
+  // Each command buffer may need an additional stream command buffer to replay
+  // into.
+  iree_hal_cuda_device_submission_t* submission = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_device_submission_allocate(
+      device, command_buffer_count * 2, signal_semaphore_list, &submission));
+  iree_status_t status =
+      iree_hal_cuda_device_queue_wait(device, queue, wait_semaphore_list);
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < command_buffer_count; i++) {
+    status = iree_hal_cuda_device_issue_command_buffer(
+        device, queue, command_buffers[i], submission);
   }
 
-  // TODO(thomasraoux): implement semaphores - for now this conservatively
-  // synchronizes after every submit.
-  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "cuStreamSynchronize");
-  CUDA_RETURN_IF_ERROR(device->context_wrapper.syms,
-                       cuStreamSynchronize(device->stream),
-                       "cuStreamSynchronize");
-  iree_hal_cuda_tracing_context_collect(device->tracing_context);
-  IREE_TRACE_ZONE_END(z0);
+  // The submission completes asynchronously; semaphores are signaled and
+  // resources released once the stream reaches this point.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_device_queue_signal(device, queue, submission);
+  } else {
+    CUDA_IGNORE_ERROR(device->context_wrapper.syms,
+                      cuStreamSynchronize(queue->stream));
+    iree_hal_cuda_device_submission_release(submission);
+  }
 
-  return iree_ok_status();
+  iree_hal_cuda_tracing_context_collect(queue->tracing_context);
+
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_device_queue_flush(
@@ -527,8 +1024,34 @@ static iree_status_t iree_hal_cuda_device_queue_flush(
 static iree_status_t iree_hal_cuda_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "semaphore not implemented");
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  bool all_cuda = true;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    all_cuda &= iree_hal_cuda_semaphore_isa(semaphore_list.semaphores[i]);
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (all_cuda) {
+    status = iree_hal_cuda_semaphore_multi_wait(
+        wait_mode, semaphore_list, timeout, &device->semaphore_notification);
+  } else if (wait_mode == IREE_HAL_WAIT_MODE_ALL ||
+             semaphore_list.count == 1) {
+    // Semaphores from other devices can only be waited on individually.
+    timeout = iree_make_deadline(iree_timeout_as_deadline_ns(timeout));
+    for (iree_host_size_t i = 0;
+         iree_status_is_ok(status) && i < semaphore_list.count; ++i) {
+      status = iree_hal_semaphore_wait(semaphore_list.semaphores[i],
+                                       semaphore_list.payload_values[i],
+                                       timeout);
+    }
+  } else {
+    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "wait-any on semaphores not created by the CUDA "
+                              "device is not supported");
+  }
+
+  iree_hal_cuda_device_reclaim_submissions(device);
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_begin(
@@ -563,9 +1086,10 @@ static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable = {
     .create_semaphore = iree_hal_cuda_device_create_semaphore,
     .query_semaphore_compatibility =
         iree_hal_cuda_device_query_semaphore_compatibility,
-    .transfer_range = iree_hal_device_submit_transfer_range_and_wait,
+    .transfer_range = iree_hal_cuda_device_transfer_range,
     .queue_alloca = iree_hal_cuda_device_queue_alloca,
     .queue_dealloca = iree_hal_cuda_device_queue_dealloca,
+    .queue_read = iree_hal_device_queue_read_streaming,
     .queue_execute = iree_hal_cuda_device_queue_execute,
     .queue_flush = iree_hal_cuda_device_queue_flush,
     .wait_semaphores = iree_hal_cuda_device_wait_semaphores,
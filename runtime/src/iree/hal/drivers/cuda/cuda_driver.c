@@ -241,24 +241,24 @@ static iree_status_t iree_hal_cuda_driver_select_default_device(
     iree_hal_driver_t* base_driver, iree_hal_cuda_dynamic_symbols_t* syms,
     int default_device_index, iree_allocator_t host_allocator,
     CUdevice* out_device) {
-  iree_hal_device_info_t* device_infos = NULL;
-  iree_host_size_t device_count = 0;
-  IREE_RETURN_IF_ERROR(iree_hal_cuda_driver_query_available_devices(
-      base_driver, host_allocator, &device_count, &device_infos));
-  iree_status_t status = iree_ok_status();
+  // Only the default device is looked up as populating the info of every
+  // device (names, UUIDs, etc) is not required to create one. All devices are
+  // valid today; if iree_hal_cuda_is_valid_device starts filtering then this
+  // will need to skip the invalid ones.
+  int device_count = 0;
+  CUDA_RETURN_IF_ERROR(syms, cuDeviceGetCount(&device_count),
+                       "cuDeviceGetCount");
   if (device_count == 0) {
-    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
-                              "no compatible CUDA devices were found");
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "no compatible CUDA devices were found");
   } else if (default_device_index >= device_count) {
-    status = iree_make_status(IREE_STATUS_NOT_FOUND,
-                              "default device %d not found (of %ld enumerated)",
-                              default_device_index, device_count);
-  } else {
-    *out_device =
-        DEVICE_ID_TO_CUDEVICE(device_infos[default_device_index].device_id);
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "default device %d not found (of %d enumerated)",
+                            default_device_index, device_count);
   }
-  iree_allocator_free(host_allocator, device_infos);
-  return status;
+  CUDA_RETURN_IF_ERROR(syms, cuDeviceGet(out_device, default_device_index),
+                       "cuDeviceGet");
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_driver_create_device_by_id(
@@ -24,6 +24,10 @@ CU_PFN_DECL(cuEventRecord, CUevent, CUstream)
 CU_PFN_DECL(cuEventSynchronize, CUevent)
 CU_PFN_DECL(cuGetErrorName, CUresult, const char**)
 CU_PFN_DECL(cuGetErrorString, CUresult, const char**)
+CU_PFN_DECL(cuGraphAddChildGraphNode, CUgraphNode*, CUgraph, const CUgraphNode*,
+            size_t, CUgraph)
+CU_PFN_DECL(cuGraphAddEventRecordNode, CUgraphNode*, CUgraph,
+            const CUgraphNode*, size_t, CUevent)
 CU_PFN_DECL(cuGraphAddMemcpyNode, CUgraphNode*, CUgraph, const CUgraphNode*,
             size_t, const CUDA_MEMCPY3D*, CUcontext)
 CU_PFN_DECL(cuGraphAddMemsetNode, CUgraphNode*, CUgraph, const CUgraphNode*,
@@ -33,6 +37,12 @@ CU_PFN_DECL(cuGraphAddKernelNode, CUgraphNode*, CUgraph, const CUgraphNode*,
 CU_PFN_DECL(cuGraphCreate, CUgraph*, unsigned int)
 CU_PFN_DECL(cuGraphDestroy, CUgraph)
 CU_PFN_DECL(cuGraphExecDestroy, CUgraphExec)
+CU_PFN_DECL(cuGraphExecEventRecordNodeSetEvent, CUgraphExec, CUgraphNode,
+            CUevent)
+// CUDA 12 drivers export a cuGraphExecUpdate_v2 with a different signature
+// than the one declared by the headers we build against.
+CU_PFN_DECL_V1(cuGraphExecUpdate, CUgraphExec, CUgraph, CUgraphNode*,
+               CUgraphExecUpdateResult*)
 CU_PFN_DECL(cuGraphGetNodes, CUgraph, CUgraphNode*, size_t*)
 CU_PFN_DECL(cuGraphInstantiate, CUgraphExec*, CUgraph, CUgraphNode*, char*,
             size_t)
@@ -43,6 +53,13 @@ CU_PFN_DECL(cuMemPrefetchAsync, CUdeviceptr, size_t, CUdevice, CUstream)
 CU_PFN_DECL(cuMemAlloc, CUdeviceptr*, size_t)
 CU_PFN_DECL(cuMemFree, CUdeviceptr)
 CU_PFN_DECL(cuMemFreeHost, void*)
+CU_PFN_DECL(cuMemAllocFromPoolAsync, CUdeviceptr*, size_t, CUmemoryPool,
+            CUstream)
+CU_PFN_DECL(cuMemFreeAsync, CUdeviceptr, CUstream)
+CU_PFN_DECL(cuMemPoolCreate, CUmemoryPool*, const CUmemPoolProps*)
+CU_PFN_DECL(cuMemPoolDestroy, CUmemoryPool)
+CU_PFN_DECL(cuMemPoolSetAttribute, CUmemoryPool, CUmemPool_attribute, void*)
+CU_PFN_DECL(cuMemPoolTrimTo, CUmemoryPool, size_t)
 CU_PFN_DECL(cuMemHostAlloc, void**, size_t, unsigned int)
 CU_PFN_DECL(cuMemHostRegister, void*, size_t, unsigned int)
 CU_PFN_DECL(cuMemHostUnregister, void*)
@@ -51,8 +68,10 @@ CU_PFN_DECL(cuModuleGetFunction, CUfunction*, CUmodule, const char*)
 CU_PFN_DECL(cuModuleLoadDataEx, CUmodule*, const void*, unsigned int,
             CUjit_option*, void**)
 CU_PFN_DECL(cuModuleUnload, CUmodule)
+CU_PFN_DECL(cuStreamBeginCapture, CUstream, CUstreamCaptureMode)
 CU_PFN_DECL(cuStreamCreate, CUstream*, unsigned int)
 CU_PFN_DECL(cuStreamDestroy, CUstream)
+CU_PFN_DECL(cuStreamEndCapture, CUstream, CUgraph*)
 CU_PFN_DECL(cuStreamSynchronize, CUstream)
 CU_PFN_DECL(cuStreamWaitEvent, CUstream, CUevent, unsigned int)
 CU_PFN_DECL(cuMemsetD32Async, unsigned long long, unsigned int, size_t,
@@ -67,6 +86,7 @@ CU_PFN_DECL(cuFuncSetAttribute, CUfunction, CUfunction_attribute, int)
 CU_PFN_DECL(cuLaunchKernel, CUfunction, unsigned int, unsigned int,
             unsigned int, unsigned int, unsigned int, unsigned int,
             unsigned int, CUstream, void**, void**)
+CU_PFN_DECL(cuLaunchHostFunc, CUstream, CUhostFn, void*)
 
 // NCCL
 
@@ -106,3 +126,31 @@ NCCL_PFN_DECL(ncclRecv, void*, size_t, ncclDataType_t, int, ncclComm_t,
               cudaStream_t)
 NCCL_PFN_DECL(ncclGroupStart)
 NCCL_PFN_DECL(ncclGroupEnd)
+
+// cuBLASLt
+
+CUBLASLT_PFN_DECL(cublasLtCreate, cublasLtHandle_t*)
+CUBLASLT_PFN_DECL(cublasLtDestroy, cublasLtHandle_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulDescCreate, cublasLtMatmulDesc_t*,
+                  cublasComputeType_t, cudaDataType_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulDescDestroy, cublasLtMatmulDesc_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulDescSetAttribute, cublasLtMatmulDesc_t,
+                  cublasLtMatmulDescAttributes_t, const void*, size_t)
+CUBLASLT_PFN_DECL(cublasLtMatrixLayoutCreate, cublasLtMatrixLayout_t*,
+                  cudaDataType_t, uint64_t, uint64_t, int64_t)
+CUBLASLT_PFN_DECL(cublasLtMatrixLayoutDestroy, cublasLtMatrixLayout_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulPreferenceCreate, cublasLtMatmulPreference_t*)
+CUBLASLT_PFN_DECL(cublasLtMatmulPreferenceDestroy, cublasLtMatmulPreference_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulPreferenceSetAttribute,
+                  cublasLtMatmulPreference_t,
+                  cublasLtMatmulPreferenceAttributes_t, const void*, size_t)
+CUBLASLT_PFN_DECL(cublasLtMatmulAlgoGetHeuristic, cublasLtHandle_t,
+                  cublasLtMatmulDesc_t, cublasLtMatrixLayout_t,
+                  cublasLtMatrixLayout_t, cublasLtMatrixLayout_t,
+                  cublasLtMatrixLayout_t, cublasLtMatmulPreference_t, int,
+                  cublasLtMatmulHeuristicResult_t*, int*)
+CUBLASLT_PFN_DECL(cublasLtMatmul, cublasLtHandle_t, cublasLtMatmulDesc_t,
+                  const void*, const void*, cublasLtMatrixLayout_t, const void*,
+                  cublasLtMatrixLayout_t, const void*, const void*,
+                  cublasLtMatrixLayout_t, void*, cublasLtMatrixLayout_t,
+                  const cublasLtMatmulAlgo_t*, void*, size_t, CUstream)
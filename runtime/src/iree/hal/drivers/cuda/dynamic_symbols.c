@@ -29,27 +29,67 @@ static const char* kNCCLLoaderSearchNames[] = {
 #endif  // IREE_PLATFORM_WINDOWS
 };
 
-#define concat(A, B) A B
+static const char* kCUBLASLtLoaderSearchNames[] = {
+#if defined(IREE_PLATFORM_WINDOWS)
+    "cublasLt64_12.dll",
+    "cublasLt64_11.dll",
+#else
+    "libcublasLt.so",
+    "libcublasLt.so.12",
+    "libcublasLt.so.11",
+#endif  // IREE_PLATFORM_WINDOWS
+};
 
-// Load CUDA entry points, prefer _v2 version if it exists.
+// Resolves a CUDA entry point into |out_fn|, preferring the _v2 version
+// named |symbol_name_v2| if it exists.
+static iree_status_t iree_hal_cuda_dynamic_symbols_resolve_symbol(
+    iree_dynamic_library_t* library, const char* symbol_name,
+    const char* symbol_name_v2, void** out_fn) {
+  IREE_RETURN_IF_ERROR(
+      iree_dynamic_library_lookup_symbol(library, symbol_name, out_fn));
+  void* fn_v2 = NULL;
+  iree_status_ignore(
+      iree_dynamic_library_lookup_symbol(library, symbol_name_v2, &fn_v2));
+  if (fn_v2) *out_fn = fn_v2;
+  return iree_ok_status();
+}
+
+#define IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cudaSymbolName)                  \
+  iree_hal_cuda_dynamic_symbols_resolve_symbol(                             \
+      (syms)->cuda_library, #cudaSymbolName, #cudaSymbolName "_v2",         \
+      (void**)&(syms)->cudaSymbolName)
+
+// Load the CUDA entry points used to initialize CUDA and enumerate devices.
+// These must be a subset of dynamic_symbol_tables.h.
+static iree_status_t iree_hal_cuda_dynamic_symbols_resolve_driver(
+    iree_hal_cuda_dynamic_symbols_t* syms) {
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuGetErrorName));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuGetErrorString));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuInit));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuDeviceGet));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuDeviceGetCount));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuDeviceGetName));
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cuDeviceGetUuid));
+  return iree_ok_status();
+}
+
+// Load all CUDA entry points.
 static iree_status_t iree_hal_cuda_dynamic_symbols_resolve_all(
     iree_hal_cuda_dynamic_symbols_t* syms) {
-#define CU_PFN_DECL(cudaSymbolName, ...)                                     \
-  {                                                                          \
-    static const char* kName = #cudaSymbolName;                              \
-    IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(                 \
-        syms->cuda_library, kName, (void**)&syms->cudaSymbolName));          \
-    static const char* kNameV2 = concat(#cudaSymbolName, "_v2");             \
-    void* funV2;                                                             \
-    iree_dynamic_library_lookup_symbol(syms->cuda_library, kNameV2, &funV2); \
-    if (funV2) syms->cudaSymbolName = funV2;                                 \
-  }
+#define CU_PFN_DECL(cudaSymbolName, ...) \
+  IREE_RETURN_IF_ERROR(IREE_HAL_CUDA_RESOLVE_SYMBOL(syms, cudaSymbolName));
+#define CU_PFN_DECL_V1(cudaSymbolName, ...)                         \
+  IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(          \
+      syms->cuda_library, #cudaSymbolName, (void**)&syms->cudaSymbolName));
 #define NCCL_PFN_DECL(ncclSymbolName, ...)
 #define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...)
+#define CUBLASLT_PFN_DECL(cublasLtSymbolName, ...)
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
 #undef CU_PFN_DECL
+#undef CU_PFN_DECL_V1
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUBLASLT_PFN_DECL
   return iree_ok_status();
 }
 
@@ -57,6 +97,7 @@ static iree_status_t iree_hal_cuda_dynamic_symbols_resolve_all(
 static iree_status_t iree_hal_cuda_nccl_dynamic_symbols_resolve_all(
     iree_hal_cuda_dynamic_symbols_t* syms) {
 #define CU_PFN_DECL(cudaSymbolName, ...)
+#define CU_PFN_DECL_V1(cudaSymbolName, ...)
 #define NCCL_PFN_DECL(ncclSymbolName, ...)                          \
   {                                                                 \
     static const char* kName = #ncclSymbolName;                     \
@@ -69,10 +110,35 @@ static iree_status_t iree_hal_cuda_nccl_dynamic_symbols_resolve_all(
     IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(        \
         syms->nccl_library, kName, (void**)&syms->ncclSymbolName)); \
   }
+#define CUBLASLT_PFN_DECL(cublasLtSymbolName, ...)
+#include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
+#undef CU_PFN_DECL
+#undef CU_PFN_DECL_V1
+#undef NCCL_PFN_DECL
+#undef NCCL_PFN_DECL_STR_RETURN
+#undef CUBLASLT_PFN_DECL
+  return iree_ok_status();
+}
+
+// Load cuBLASLt entry points.
+static iree_status_t iree_hal_cuda_cublaslt_dynamic_symbols_resolve_all(
+    iree_hal_cuda_dynamic_symbols_t* syms) {
+#define CU_PFN_DECL(cudaSymbolName, ...)
+#define CU_PFN_DECL_V1(cudaSymbolName, ...)
+#define NCCL_PFN_DECL(ncclSymbolName, ...)
+#define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...)
+#define CUBLASLT_PFN_DECL(cublasLtSymbolName, ...)                          \
+  {                                                                         \
+    static const char* kName = #cublasLtSymbolName;                         \
+    IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(                \
+        syms->cublaslt_library, kName, (void**)&syms->cublasLtSymbolName)); \
+  }
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
 #undef CU_PFN_DECL
+#undef CU_PFN_DECL_V1
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUBLASLT_PFN_DECL
   return iree_ok_status();
 }
 
@@ -81,18 +147,21 @@ iree_status_t iree_hal_cuda_dynamic_symbols_initialize(
     iree_hal_cuda_dynamic_symbols_t* out_syms) {
   IREE_TRACE_ZONE_BEGIN(z0);
   memset(out_syms, 0, sizeof(*out_syms));
+  iree_slim_mutex_initialize(&out_syms->device_mutex);
+  iree_slim_mutex_initialize(&out_syms->cublaslt_mutex);
   iree_status_t status = iree_dynamic_library_load_from_files(
       IREE_ARRAYSIZE(kCUDALoaderSearchNames), kCUDALoaderSearchNames,
       IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator, &out_syms->cuda_library);
   if (iree_status_is_not_found(status)) {
     iree_status_ignore(status);
+    iree_hal_cuda_dynamic_symbols_deinitialize(out_syms);
     IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_UNAVAILABLE,
                             "CUDA runtime library not available; ensure "
                             "installed and on path");
   }
   if (iree_status_is_ok(status)) {
-    status = iree_hal_cuda_dynamic_symbols_resolve_all(out_syms);
+    status = iree_hal_cuda_dynamic_symbols_resolve_driver(out_syms);
   }
   if (!iree_status_is_ok(status)) {
     iree_hal_cuda_dynamic_symbols_deinitialize(out_syms);
@@ -101,6 +170,21 @@ iree_status_t iree_hal_cuda_dynamic_symbols_initialize(
   return status;
 }
 
+iree_status_t iree_hal_cuda_dynamic_symbols_resolve_device(
+    iree_hal_cuda_dynamic_symbols_t* syms) {
+  IREE_ASSERT_ARGUMENT(syms);
+  iree_slim_mutex_lock(&syms->device_mutex);
+  iree_status_t status = iree_ok_status();
+  if (!syms->device_resolved) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    status = iree_hal_cuda_dynamic_symbols_resolve_all(syms);
+    syms->device_resolved = iree_status_is_ok(status);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_slim_mutex_unlock(&syms->device_mutex);
+  return status;
+}
+
 iree_status_t iree_hal_cuda_nccl_dynamic_symbols_initialize(
     iree_allocator_t host_allocator,
     iree_hal_cuda_dynamic_symbols_t* out_syms) {
@@ -163,11 +247,47 @@ iree_status_t iree_hal_cuda_nccl_dynamic_symbols_initialize(
   return status;
 }
 
+iree_status_t iree_hal_cuda_cublaslt_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* syms) {
+  IREE_ASSERT_ARGUMENT(syms);
+  iree_slim_mutex_lock(&syms->cublaslt_mutex);
+  if (!syms->cublaslt_attempted) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    syms->cublaslt_attempted = true;
+    iree_status_t status = iree_dynamic_library_load_from_files(
+        IREE_ARRAYSIZE(kCUBLASLtLoaderSearchNames), kCUBLASLtLoaderSearchNames,
+        IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator,
+        &syms->cublaslt_library);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_cublaslt_dynamic_symbols_resolve_all(syms);
+    }
+    syms->cublaslt_status_code = iree_status_code(status);
+    iree_status_ignore(status);
+    if (syms->cublaslt_status_code != IREE_STATUS_OK) {
+      iree_dynamic_library_release(syms->cublaslt_library);
+      syms->cublaslt_library = NULL;
+    }
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_status_code_t status_code = syms->cublaslt_status_code;
+  iree_slim_mutex_unlock(&syms->cublaslt_mutex);
+  if (status_code != IREE_STATUS_OK) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "cuBLASLt library not available (%s); ensure "
+                            "installed and on path",
+                            iree_status_code_string(status_code));
+  }
+  return iree_ok_status();
+}
+
 void iree_hal_cuda_dynamic_symbols_deinitialize(
     iree_hal_cuda_dynamic_symbols_t* syms) {
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_dynamic_library_release(syms->cuda_library);
   iree_dynamic_library_release(syms->nccl_library);
+  iree_dynamic_library_release(syms->cublaslt_library);
+  iree_slim_mutex_deinitialize(&syms->device_mutex);
+  iree_slim_mutex_deinitialize(&syms->cublaslt_mutex);
   memset(syms, 0, sizeof(*syms));
   IREE_TRACE_ZONE_END(z0);
 }
@@ -9,6 +9,8 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/dynamic_library.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cublaslt_headers.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
 #include "third_party/nccl/nccl.h"
 
@@ -16,38 +18,77 @@
 extern "C" {
 #endif  // __cplusplus
 
-// DynamicSymbols allow loading dynamically a subset of CUDA driver and NCCL
-// API. It loads all the function declared in `dynamic_symbol_tables.h` and fail
-// if any of the symbol is not available. The functions signatures are matching
-// the declarations in `cuda.h` and `nccl.h"`.
+// DynamicSymbols allow loading dynamically a subset of CUDA driver, NCCL, and
+// cuBLASLt API. It loads all the function declared in `dynamic_symbol_tables.h`
+// and fail if any of the symbol is not available. The functions signatures are
+// matching the declarations in `cuda.h`, `nccl.h`, and `cublasLt.h`.
+//
+// Only the few CUDA functions required to initialize CUDA and enumerate devices
+// are resolved when initialized. The remaining functions are resolved by
+// iree_hal_cuda_dynamic_symbols_resolve_device when the first device is created
+// so that processes that only query devices or fail early don't pay for them.
 typedef struct iree_hal_cuda_dynamic_symbols_t {
   iree_dynamic_library_t* cuda_library;
   iree_dynamic_library_t* nccl_library;
+  iree_dynamic_library_t* cublaslt_library;
+
+  // Guards the lazy resolution of device functions.
+  iree_slim_mutex_t device_mutex;
+  // True once all CUDA functions have been resolved.
+  bool device_resolved;
+
+  // Guards the lazy loading of cuBLASLt.
+  iree_slim_mutex_t cublaslt_mutex;
+  // Status of the first cuBLASLt load attempt; sticky so that we only try to
+  // load the library once.
+  bool cublaslt_attempted;
+  iree_status_code_t cublaslt_status_code;
 
 #define CU_PFN_DECL(cudaSymbolName, ...) \
   CUresult (*cudaSymbolName)(__VA_ARGS__);
+#define CU_PFN_DECL_V1(cudaSymbolName, ...) \
+  CUresult (*cudaSymbolName)(__VA_ARGS__);
 #define NCCL_PFN_DECL(ncclSymbolName, ...) \
   ncclResult_t (*ncclSymbolName)(__VA_ARGS__);
 #define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...) \
   const char* (*ncclSymbolName)(__VA_ARGS__);
+#define CUBLASLT_PFN_DECL(cublasLtSymbolName, ...) \
+  cublasStatus_t (*cublasLtSymbolName)(__VA_ARGS__);
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: export
 #undef CU_PFN_DECL
+#undef CU_PFN_DECL_V1
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUBLASLT_PFN_DECL
 } iree_hal_cuda_dynamic_symbols_t;
 
 // Initializes |out_syms| in-place with dynamically loaded CUDA symbols.
+// Only functions used to initialize CUDA and query devices are resolved and
+// iree_hal_cuda_dynamic_symbols_resolve_device must be called before any
+// other function is used.
 // iree_hal_cuda_dynamic_symbols_deinitialize must be used to release the
 // library resources.
 iree_status_t iree_hal_cuda_dynamic_symbols_initialize(
     iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* out_syms);
 
+// Resolves all remaining CUDA symbols in |syms| required to create and use
+// devices. Thread-safe and a no-op once it has succeeded.
+iree_status_t iree_hal_cuda_dynamic_symbols_resolve_device(
+    iree_hal_cuda_dynamic_symbols_t* syms);
+
 // Initializes |out_syms| in-place with dynamically loaded NCCL symbols.
 // iree_hal_cuda_dynamic_symbols_deinitialize must be used to release the
 // library resources.
 iree_status_t iree_hal_cuda_nccl_dynamic_symbols_initialize(
     iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* out_syms);
 
+// Loads cuBLASLt and resolves its symbols in |syms| on first use.
+// Thread-safe and a no-op once it has succeeded. cuBLASLt is optional and only
+// required by executables using library calls so failures are returned as
+// IREE_STATUS_UNAVAILABLE and are sticky.
+iree_status_t iree_hal_cuda_cublaslt_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* syms);
+
 // Deinitializes |syms| by unloading the backing library. All function pointers
 // will be invalidated. They _may_ still work if there are other reasons the
 // library remains loaded so be careful.
@@ -44,6 +44,29 @@ TEST(DynamicSymbolsTest, CreateFromSystemLoader) {
   iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
 }
 
+TEST(DynamicSymbolsTest, ResolveDevice) {
+  iree_hal_cuda_dynamic_symbols_t symbols;
+  iree_status_t status = iree_hal_cuda_dynamic_symbols_initialize(
+      iree_allocator_system(), &symbols);
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_ignore(status);
+    std::cerr << "Symbols cannot be loaded, skipping test.";
+    GTEST_SKIP();
+  }
+
+  // Device functions are only resolved on demand.
+  EXPECT_EQ(nullptr, symbols.cuDevicePrimaryCtxRetain);
+  status = iree_hal_cuda_dynamic_symbols_resolve_device(&symbols);
+  ASSERT_TRUE(iree_status_is_ok(status));
+  EXPECT_NE(nullptr, symbols.cuDevicePrimaryCtxRetain);
+  // Resolving again is a no-op.
+  status = iree_hal_cuda_dynamic_symbols_resolve_device(&symbols);
+  ASSERT_TRUE(iree_status_is_ok(status));
+
+  iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
+}
+
 #define NCCL_CHECK_ERRORS(expr)     \
   {                                 \
     ncclResult_t status = expr;     \
@@ -66,6 +89,7 @@ TEST(NCCLDynamicSymbolsTest, CreateFromSystemLoader) {
   if (!iree_status_is_ok(status)) {
     iree_status_fprint(stderr, status);
     iree_status_ignore(status);
+    iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
     std::cerr << "CUDA NCCL symbols cannot be loaded, skipping test.";
     GTEST_SKIP();
   }
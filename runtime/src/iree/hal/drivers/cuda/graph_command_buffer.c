@@ -14,6 +14,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/library_call.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
@@ -25,6 +26,28 @@
 // Kernel arguments contains binding and push constants.
 #define IREE_HAL_CUDA_MAX_KERNEL_ARG 128
 
+// Dispatch zones can only be emitted when tracing instrumentation is enabled.
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+#define IREE_HAL_CUDA_GRAPH_TRACING_ENABLE 1
+#else
+#define IREE_HAL_CUDA_GRAPH_TRACING_ENABLE 0
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+// FNV-1a offset basis and prime used to hash the recorded graph structure.
+#define IREE_HAL_CUDA_GRAPH_STRUCTURE_KEY_INITIAL 0xCBF29CE484222325ull
+#define IREE_HAL_CUDA_GRAPH_STRUCTURE_KEY_PRIME 0x100000001B3ull
+
+// A traced dispatch bracketed by event record nodes in the graph.
+typedef struct iree_hal_cuda_graph_trace_zone_t {
+  struct iree_hal_cuda_graph_trace_zone_t* next;
+  // Event record nodes before and after the dispatch kernel node.
+  CUgraphNode begin_node;
+  CUgraphNode end_node;
+  // Name of the zone; references the executable retained by the command
+  // buffer.
+  iree_string_view_t name;
+} iree_hal_cuda_graph_trace_zone_t;
+
 // Command buffer implementation that directly maps to cuda graph.
 // This records the commands on the calling thread without additional threading
 // indirection.
@@ -44,13 +67,33 @@ typedef struct iree_hal_cuda_graph_command_buffer_t {
   CUgraph graph;
   CUgraphExec exec;
 
+  // Device cache the exec is acquired from and returned to.
+  iree_hal_cuda_graph_exec_cache_t* exec_cache;
+  // Structural hash of the nodes recorded into the graph used to find cached
+  // execs that can be updated instead of instantiating a new one. Only includes
+  // node parameters that cuGraphExecUpdate cannot change.
+  uint64_t structure_key;
+
   // Keep track of the last node added to the command buffer as we are currently
   // serializing all the nodes (each node depends on the previous one).
   CUgraphNode last_node;
 
+  // Stream library calls are captured on to produce their child graphs.
+  // Created on first use.
+  CUstream capture_stream;
+
   // Iteratively constructed batch of collective operations.
   iree_hal_collective_batch_t collective_batch;
 
+  // Whether dispatches are wrapped in event record nodes for tracing.
+  bool trace_dispatches;
+  // Event the event record nodes are recorded with; replaced in the exec with
+  // tracing events on each launch.
+  CUevent trace_placeholder_event;
+  // Traced dispatches in the order they were recorded.
+  iree_hal_cuda_graph_trace_zone_t* trace_zone_head;
+  iree_hal_cuda_graph_trace_zone_t* trace_zone_tail;
+
   int32_t push_constant[IREE_HAL_CUDA_MAX_PUSH_CONSTANT_COUNT];
 
   // Keep track of the current set of kernel arguments.
@@ -71,10 +114,12 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_arena_block_pool_t* block_pool,
+    bool graph_tracing, iree_arena_block_pool_t* block_pool,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(block_pool);
+  IREE_ASSERT_ARGUMENT(exec_cache);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
@@ -100,7 +145,18 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_arena_initialize(block_pool, &command_buffer->arena);
     command_buffer->graph = NULL;
     command_buffer->exec = NULL;
+    command_buffer->exec_cache = exec_cache;
+    command_buffer->structure_key = IREE_HAL_CUDA_GRAPH_STRUCTURE_KEY_INITIAL;
     command_buffer->last_node = NULL;
+    command_buffer->capture_stream = NULL;
+    // Nested graphs are cloned into their parents and their nodes cannot be
+    // patched in the parent exec.
+    command_buffer->trace_dispatches =
+        IREE_HAL_CUDA_GRAPH_TRACING_ENABLE && graph_tracing &&
+        !iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED);
+    command_buffer->trace_placeholder_event = NULL;
+    command_buffer->trace_zone_head = NULL;
+    command_buffer->trace_zone_tail = NULL;
 
     CUdeviceptr* device_ptrs =
         (CUdeviceptr*)(command_buffer->current_descriptor +
@@ -142,11 +198,28 @@ static void iree_hal_cuda_graph_command_buffer_destroy(
     command_buffer->graph = NULL;
   }
   if (command_buffer->exec != NULL) {
-    CUDA_IGNORE_ERROR(command_buffer->context->syms,
-                      cuGraphExecDestroy(command_buffer->exec));
+    if (command_buffer->trace_zone_head) {
+      // Traced execs are not shareable as they reference our graph nodes.
+      CUDA_IGNORE_ERROR(command_buffer->context->syms,
+                        cuGraphExecDestroy(command_buffer->exec));
+    } else {
+      iree_hal_cuda_graph_exec_cache_release(command_buffer->exec_cache,
+                                             command_buffer->structure_key,
+                                             command_buffer->exec);
+    }
     command_buffer->exec = NULL;
   }
   command_buffer->last_node = NULL;
+  if (command_buffer->capture_stream != NULL) {
+    CUDA_IGNORE_ERROR(command_buffer->context->syms,
+                      cuStreamDestroy(command_buffer->capture_stream));
+    command_buffer->capture_stream = NULL;
+  }
+  if (command_buffer->trace_placeholder_event != NULL) {
+    CUDA_IGNORE_ERROR(command_buffer->context->syms,
+                      cuEventDestroy(command_buffer->trace_placeholder_event));
+    command_buffer->trace_placeholder_event = NULL;
+  }
 
   iree_hal_collective_batch_deinitialize(&command_buffer->collective_batch);
   iree_hal_resource_set_free(command_buffer->resource_set);
@@ -165,6 +238,43 @@ CUgraphExec iree_hal_cuda_graph_command_buffer_handle(
   return command_buffer->exec;
 }
 
+iree_status_t iree_hal_cuda_graph_command_buffer_prepare_launch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_cuda_tracing_context_t* tracing_context) {
+  iree_hal_cuda_graph_command_buffer_t* command_buffer =
+      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
+  if (!tracing_context || !command_buffer->trace_zone_head) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Zones are begun in recording order which matches the order the graph
+  // records their events on the stream.
+  iree_status_t status = iree_ok_status();
+  for (iree_hal_cuda_graph_trace_zone_t* zone = command_buffer->trace_zone_head;
+       zone != NULL && iree_status_is_ok(status); zone = zone->next) {
+    CUevent begin_event = IREE_CUDA_TRACE_GRAPH_ZONE_BEGIN_EXTERNAL(
+        tracing_context, zone->name.data, zone->name.size, /*line=*/0,
+        /*func_name=*/NULL, 0, zone->name.data, zone->name.size);
+    CUevent end_event = IREE_CUDA_TRACE_GRAPH_ZONE_END(tracing_context);
+    status = CU_RESULT_TO_STATUS(
+        command_buffer->context->syms,
+        cuGraphExecEventRecordNodeSetEvent(command_buffer->exec,
+                                           zone->begin_node, begin_event),
+        "cuGraphExecEventRecordNodeSetEvent");
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(
+          command_buffer->context->syms,
+          cuGraphExecEventRecordNodeSetEvent(command_buffer->exec,
+                                             zone->end_node, end_event),
+          "cuGraphExecEventRecordNodeSetEvent");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 bool iree_hal_cuda_graph_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer) {
   return iree_hal_command_buffer_dyn_cast(
@@ -180,6 +290,31 @@ static void* iree_hal_cuda_graph_command_buffer_dyn_cast(
   return NULL;
 }
 
+// Kinds of nodes recorded into the graph structure key.
+typedef enum iree_hal_cuda_graph_node_kind_e {
+  IREE_HAL_CUDA_GRAPH_NODE_KIND_MEMSET = 1,
+  IREE_HAL_CUDA_GRAPH_NODE_KIND_MEMCPY = 2,
+  IREE_HAL_CUDA_GRAPH_NODE_KIND_KERNEL = 3,
+  IREE_HAL_CUDA_GRAPH_NODE_KIND_CHILD_GRAPH = 4,
+  IREE_HAL_CUDA_GRAPH_NODE_KIND_EVENT_RECORD = 5,
+} iree_hal_cuda_graph_node_kind_t;
+
+// Mixes a node of |kind| with the immutable |value| into the structure key.
+// Parameters that cuGraphExecUpdate can change (pointers, sizes, grid
+// dimensions, and kernel arguments) must not be included so that graphs that
+// only differ in their bindings or shapes share the same cached exec.
+static void iree_hal_cuda_graph_command_buffer_hash_node(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
+    iree_hal_cuda_graph_node_kind_t kind, uint64_t value) {
+  uint64_t key = command_buffer->structure_key;
+  const uint64_t words[2] = {(uint64_t)kind, value};
+  const uint8_t* bytes = (const uint8_t*)words;
+  for (iree_host_size_t i = 0; i < sizeof(words); ++i) {
+    key = (key ^ bytes[i]) * IREE_HAL_CUDA_GRAPH_STRUCTURE_KEY_PRIME;
+  }
+  command_buffer->structure_key = key;
+}
+
 // Flushes any pending batched collective operations.
 // Must be called before any other non-collective nodes are added to the graph
 // or a barrier is encountered.
@@ -221,6 +356,35 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_flush_collectives(
   return status;
 }
 
+// Adds an event record node after the last node marking a trace zone boundary.
+// The placeholder event is replaced in the exec before each launch.
+static iree_status_t iree_hal_cuda_graph_command_buffer_add_trace_node(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
+    CUgraphNode* out_node) {
+  if (command_buffer->trace_placeholder_event == NULL) {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuEventCreate(&command_buffer->trace_placeholder_event,
+                      CU_EVENT_DEFAULT),
+        "cuEventCreate");
+  }
+  iree_hal_cuda_graph_command_buffer_hash_node(
+      command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_EVENT_RECORD, 0);
+
+  // Serialize all the nodes for now.
+  CUgraphNode dep[] = {command_buffer->last_node};
+  size_t numNode = command_buffer->last_node ? 1 : 0;
+
+  CUDA_RETURN_IF_ERROR(
+      command_buffer->context->syms,
+      cuGraphAddEventRecordNode(&command_buffer->last_node,
+                                command_buffer->graph, dep, numNode,
+                                command_buffer->trace_placeholder_event),
+      "cuGraphAddEventRecordNode");
+  *out_node = command_buffer->last_node;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_cuda_graph_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_cuda_graph_command_buffer_t* command_buffer =
@@ -252,14 +416,31 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
   // Reset state used during recording.
   command_buffer->last_node = NULL;
 
-  // Compile the graph.
-  CUgraphNode error_node = NULL;
-  iree_status_t status =
-      CU_RESULT_TO_STATUS(command_buffer->context->syms,
-                          cuGraphInstantiate(&command_buffer->exec,
-                                             command_buffer->graph, &error_node,
-                                             /*logBuffer=*/NULL,
-                                             /*bufferSize=*/0));
+  // Nested command buffers are only ever added as child graphs of other graph
+  // command buffers and cannot be launched themselves. Retain the graph so that
+  // it can be cloned into parents and skip instantiation.
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+    return iree_ok_status();
+  }
+
+  // Traced graphs retain their graph as the event record nodes are patched in
+  // the exec on each launch and always instantiate a new exec so that the
+  // nodes are those it was instantiated from.
+  if (command_buffer->trace_zone_head) {
+    CUgraphNode error_node = NULL;
+    return CU_RESULT_TO_STATUS(
+        command_buffer->context->syms,
+        cuGraphInstantiate(&command_buffer->exec, command_buffer->graph,
+                           &error_node, /*logBuffer=*/NULL,
+                           /*bufferSize=*/0),
+        "cuGraphInstantiate");
+  }
+
+  // Compile the graph or update a cached exec with the same structure.
+  iree_status_t status = iree_hal_cuda_graph_exec_cache_acquire(
+      command_buffer->exec_cache, command_buffer->structure_key,
+      command_buffer->graph, &command_buffer->exec);
   if (iree_status_is_ok(status)) {
     // No longer need the source graph used for construction.
     CUDA_IGNORE_ERROR(command_buffer->context->syms,
@@ -267,7 +448,7 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
     command_buffer->graph = NULL;
   }
 
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_cuda_graph_command_buffer_begin_debug_group(
@@ -405,6 +586,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_fill_buffer(
       .height = 1,
       .value = dword_pattern,
   };
+  iree_hal_cuda_graph_command_buffer_hash_node(
+      command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_MEMSET, pattern_length);
+
   // Serialize all the nodes for now.
   CUgraphNode dep[] = {command_buffer->last_node};
   size_t numNode = command_buffer->last_node ? 1 : 0;
@@ -453,6 +637,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_update_buffer(
       .Height = 1,
       .Depth = 1,
   };
+  iree_hal_cuda_graph_command_buffer_hash_node(
+      command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_MEMCPY,
+      ((uint64_t)params.srcMemoryType << 32) | params.dstMemoryType);
 
   // Serialize all the nodes for now.
   CUgraphNode dep[] = {command_buffer->last_node};
@@ -500,6 +687,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_copy_buffer(
       .Height = 1,
       .Depth = 1,
   };
+  iree_hal_cuda_graph_command_buffer_hash_node(
+      command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_MEMCPY,
+      ((uint64_t)params.srcMemoryType << 32) | params.dstMemoryType);
 
   // Serialize all the nodes for now.
   CUgraphNode dep[] = {command_buffer->last_node};
@@ -595,13 +785,66 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_push_descriptor_set(
             : 0;
     *((CUdeviceptr*)command_buffer->current_descriptor[i + base_binding]) =
         device_ptr;
-    if (binding->buffer) {
-      IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-          command_buffer->resource_set, 1, &binding->buffer));
-    }
   }
 
-  return iree_ok_status();
+  return iree_hal_resource_set_insert_strided(
+      command_buffer->resource_set, binding_count, bindings,
+      offsetof(iree_hal_descriptor_set_binding_t, buffer), sizeof(*bindings));
+}
+
+// Adds |library_call| to the graph as a child graph node captured from the
+// work the library issues on a stream. Library calls do not expose their
+// kernels so capturing is the only way to record them into graphs.
+static iree_status_t iree_hal_cuda_graph_command_buffer_add_library_call_node(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
+    iree_hal_cuda_library_call_t* library_call) {
+  iree_hal_cuda_dynamic_symbols_t* syms = command_buffer->context->syms;
+  if (!command_buffer->capture_stream) {
+    CUDA_RETURN_IF_ERROR(syms,
+                         cuStreamCreate(&command_buffer->capture_stream,
+                                        CU_STREAM_NON_BLOCKING),
+                         "cuStreamCreate");
+  }
+
+  CUDA_RETURN_IF_ERROR(
+      syms,
+      cuStreamBeginCapture(command_buffer->capture_stream,
+                           CU_STREAM_CAPTURE_MODE_THREAD_LOCAL),
+      "cuStreamBeginCapture");
+  iree_status_t status = iree_hal_cuda_library_call_issue(
+      command_buffer->context, library_call, command_buffer->capture_stream,
+      command_buffer->current_descriptor);
+  // Capture must always be ended to return the stream to normal operation.
+  CUgraph child_graph = NULL;
+  status = iree_status_join(
+      status,
+      CU_RESULT_TO_STATUS(
+          syms, cuStreamEndCapture(command_buffer->capture_stream, &child_graph),
+          "cuStreamEndCapture"));
+
+  if (iree_status_is_ok(status)) {
+    // The captured kernels depend on the algorithm selected for the call but
+    // not on the bound pointers.
+    iree_hal_cuda_graph_command_buffer_hash_node(
+        command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_CHILD_GRAPH,
+        (uint64_t)(uintptr_t)library_call);
+
+    // Serialize all the nodes for now.
+    CUgraphNode dep[] = {command_buffer->last_node};
+    size_t numNode = command_buffer->last_node ? 1 : 0;
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuGraphAddChildGraphNode(&command_buffer->last_node,
+                                 command_buffer->graph, dep, numNode,
+                                 child_graph),
+        "cuGraphAddChildGraphNode");
+  }
+
+  // The child graph is cloned into the parent graph.
+  if (child_graph) {
+    CUDA_IGNORE_ERROR(syms, cuGraphDestroy(child_graph));
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
@@ -623,6 +866,17 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &executable));
 
+  // Bracket the kernel node with event record nodes to time it when traced.
+  iree_hal_cuda_graph_trace_zone_t* trace_zone = NULL;
+  if (command_buffer->trace_dispatches) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, sizeof(*trace_zone), (void**)&trace_zone));
+    memset(trace_zone, 0, sizeof(*trace_zone));
+    IREE_TRACE(trace_zone->name = kernel_params.function_name);
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_graph_command_buffer_add_trace_node(
+        command_buffer, &trace_zone->begin_node));
+  }
+
   // Patch the push constants in the kernel arguments.
   iree_host_size_t num_constants =
       iree_hal_cuda_pipeline_layout_num_constants(kernel_params.layout);
@@ -633,27 +887,48 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
         command_buffer->push_constant[i];
   }
 
-  CUDA_KERNEL_NODE_PARAMS params = {
-      .func = kernel_params.function,
-      .blockDimX = kernel_params.block_size[0],
-      .blockDimY = kernel_params.block_size[1],
-      .blockDimZ = kernel_params.block_size[2],
-      .gridDimX = workgroup_x,
-      .gridDimY = workgroup_y,
-      .gridDimZ = workgroup_z,
-      .kernelParams = command_buffer->current_descriptor,
-      .sharedMemBytes = kernel_params.shared_memory_size,
-  };
-
-  // Serialize all the nodes for now.
-  CUgraphNode dep[] = {command_buffer->last_node};
-  size_t numNodes = command_buffer->last_node ? 1 : 0;
+  if (kernel_params.library_call) {
+    // Library calls ignore the workgroup count and size the work themselves.
+    IREE_RETURN_IF_ERROR(
+        iree_hal_cuda_graph_command_buffer_add_library_call_node(
+            command_buffer, kernel_params.library_call));
+  } else {
+    CUDA_KERNEL_NODE_PARAMS params = {
+        .func = kernel_params.function,
+        .blockDimX = kernel_params.block_size[0],
+        .blockDimY = kernel_params.block_size[1],
+        .blockDimZ = kernel_params.block_size[2],
+        .gridDimX = workgroup_x,
+        .gridDimY = workgroup_y,
+        .gridDimZ = workgroup_z,
+        .kernelParams = command_buffer->current_descriptor,
+        .sharedMemBytes = kernel_params.shared_memory_size,
+    };
+    iree_hal_cuda_graph_command_buffer_hash_node(
+        command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_KERNEL,
+        (uint64_t)(uintptr_t)params.func);
+
+    // Serialize all the nodes for now.
+    CUgraphNode dep[] = {command_buffer->last_node};
+    size_t numNodes = command_buffer->last_node ? 1 : 0;
+
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuGraphAddKernelNode(&command_buffer->last_node,
+                             command_buffer->graph, dep, numNodes, &params),
+        "cuGraphAddKernelNode");
+  }
 
-  CUDA_RETURN_IF_ERROR(
-      command_buffer->context->syms,
-      cuGraphAddKernelNode(&command_buffer->last_node, command_buffer->graph,
-                           dep, numNodes, &params),
-      "cuGraphAddKernelNode");
+  if (trace_zone) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_graph_command_buffer_add_trace_node(
+        command_buffer, &trace_zone->end_node));
+    if (command_buffer->trace_zone_tail) {
+      command_buffer->trace_zone_tail->next = trace_zone;
+    } else {
+      command_buffer->trace_zone_head = trace_zone;
+    }
+    command_buffer->trace_zone_tail = trace_zone;
+  }
 
   return iree_ok_status();
 }
@@ -671,13 +946,50 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers by adding subgraph nodes and
-  // tracking the binding table for future cuGraphExecKernelNodeSetParams usage.
-  // Need to look into how to update the params of the subgraph nodes - is the
-  // graph exec the outer one and if so will it allow node handles from the
-  // subgraphs?
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+  iree_hal_cuda_graph_command_buffer_t* command_buffer =
+      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
+
+  // TODO(#10144): support indirect command buffers by tracking the binding
+  // table for future cuGraphExecKernelNodeSetParams usage on the child nodes.
+  if (binding_table.count > 0) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "indirect command buffers not yet implemented");
+  }
+  iree_hal_cuda_graph_command_buffer_t* commands =
+      (iree_hal_cuda_graph_command_buffer_t*)iree_hal_command_buffer_dyn_cast(
+          base_commands, &iree_hal_cuda_graph_command_buffer_vtable);
+  if (!commands || !commands->graph) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "only recorded nested CUDA graph command buffers can be executed");
+  }
+
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
+
+  // The child graph is cloned into the parent but the resources it references
+  // are owned by the nested command buffer.
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &base_commands));
+
+  // The nested structure key covers all nodes in the child graph such that
+  // parents only share cached execs when their children are updatable.
+  iree_hal_cuda_graph_command_buffer_hash_node(
+      command_buffer, IREE_HAL_CUDA_GRAPH_NODE_KIND_CHILD_GRAPH,
+      commands->structure_key);
+
+  // Serialize all the nodes for now.
+  CUgraphNode dep[] = {command_buffer->last_node};
+  size_t numNode = command_buffer->last_node ? 1 : 0;
+
+  CUDA_RETURN_IF_ERROR(
+      command_buffer->context->syms,
+      cuGraphAddChildGraphNode(&command_buffer->last_node,
+                               command_buffer->graph, dep, numNode,
+                               commands->graph),
+      "cuGraphAddChildGraphNode");
+
+  return iree_ok_status();
 }
 
 static const iree_hal_command_buffer_vtable_t
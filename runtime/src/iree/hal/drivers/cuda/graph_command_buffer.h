@@ -12,6 +12,8 @@
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
+#include "iree/hal/drivers/cuda/tracing.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,15 +22,27 @@ extern "C" {
 typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
 
 // Creates a command buffer that records into a CUDA graph.
+// The graph is instantiated with an exec from |exec_cache| when recording ends
+// and the exec is returned to the cache for reuse when the command buffer is
+// destroyed. Command buffers created with IREE_HAL_COMMAND_BUFFER_MODE_NESTED
+// are not instantiated and instead retain their graph so that they can be
+// added as child graph nodes by iree_hal_command_buffer_execute_commands.
 //
-// NOTE: the |block_pool| must remain live for the lifetime of the command
-// buffers that use it.
+// If |graph_tracing| is set and IREE tracing instrumentation is enabled each
+// dispatch is wrapped in event record nodes that are patched with tracing
+// events by iree_hal_cuda_graph_command_buffer_prepare_launch. Traced graphs
+// are always instantiated and do not use the |exec_cache| as the nodes must be
+// retained to patch them.
+//
+// NOTE: the |block_pool| and |exec_cache| must remain live for the lifetime of
+// the command buffers that use them.
 iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_arena_block_pool_t* block_pool,
+    bool graph_tracing, iree_arena_block_pool_t* block_pool,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns true if |command_buffer| is a CUDA graph-based command buffer.
@@ -39,6 +53,15 @@ bool iree_hal_cuda_graph_command_buffer_isa(
 CUgraphExec iree_hal_cuda_graph_command_buffer_handle(
     iree_hal_command_buffer_t* command_buffer);
 
+// Prepares the graph exec of |command_buffer| to be launched on the stream
+// traced by |tracing_context| by beginning a GPU zone for each traced dispatch
+// and patching the event record nodes to use the zone events.
+// Must be called immediately prior to each launch. No-op if |tracing_context|
+// is NULL or the command buffer was not recorded with graph tracing.
+iree_status_t iree_hal_cuda_graph_command_buffer_prepare_launch(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_cuda_tracing_context_t* tracing_context);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
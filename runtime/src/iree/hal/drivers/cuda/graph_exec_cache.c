@@ -0,0 +1,137 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
+
+#include <string.h>
+
+#include "iree/base/tracing.h"
+#include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+iree_status_t iree_hal_cuda_graph_exec_cache_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_host_size_t capacity,
+    iree_hal_cuda_graph_exec_cache_t* out_cache) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_cache, 0, sizeof(*out_cache));
+  out_cache->context = context;
+  out_cache->capacity = capacity;
+  iree_status_t status = iree_ok_status();
+  if (capacity > 0) {
+    status = iree_allocator_malloc(context->host_allocator,
+                                   capacity * sizeof(out_cache->entries[0]),
+                                   (void**)&out_cache->entries);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_slim_mutex_initialize(&out_cache->mutex);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_graph_exec_cache_deinitialize(
+    iree_hal_cuda_graph_exec_cache_t* cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  for (iree_host_size_t i = 0; i < cache->count; ++i) {
+    CUDA_IGNORE_ERROR(cache->context->syms,
+                      cuGraphExecDestroy(cache->entries[i].exec));
+  }
+  cache->count = 0;
+  iree_allocator_free(cache->context->host_allocator, cache->entries);
+  cache->entries = NULL;
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  cache->capacity = 0;
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Removes the most recently released exec matching |key| from the cache.
+// Returns NULL if no exec with |key| is cached.
+static CUgraphExec iree_hal_cuda_graph_exec_cache_take(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t key) {
+  if (cache->capacity == 0) return NULL;
+  CUgraphExec exec = NULL;
+  iree_slim_mutex_lock(&cache->mutex);
+  for (iree_host_size_t i = cache->count; i > 0; --i) {
+    if (cache->entries[i - 1].key != key) continue;
+    exec = cache->entries[i - 1].exec;
+    memmove(&cache->entries[i - 1], &cache->entries[i],
+            (cache->count - i) * sizeof(cache->entries[0]));
+    --cache->count;
+    break;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  return exec;
+}
+
+iree_status_t iree_hal_cuda_graph_exec_cache_acquire(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t key, CUgraph graph,
+    CUgraphExec* out_exec) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(graph);
+  IREE_ASSERT_ARGUMENT(out_exec);
+  *out_exec = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Try to update a cached exec with the new node parameters. Updates fail if
+  // the topology or immutable node parameters differ from the exec (such as
+  // on a key collision) and the exec is then no longer usable.
+  CUgraphExec exec = iree_hal_cuda_graph_exec_cache_take(cache, key);
+  if (exec != NULL) {
+    CUgraphNode error_node = NULL;
+    CUgraphExecUpdateResult update_result = CU_GRAPH_EXEC_UPDATE_SUCCESS;
+    CUresult result = cache->context->syms->cuGraphExecUpdate(
+        exec, graph, &error_node, &update_result);
+    if (result == CUDA_SUCCESS &&
+        update_result == CU_GRAPH_EXEC_UPDATE_SUCCESS) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+      *out_exec = exec;
+      IREE_TRACE_ZONE_END(z0);
+      return iree_ok_status();
+    }
+    CUDA_IGNORE_ERROR(cache->context->syms, cuGraphExecDestroy(exec));
+  }
+
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+  CUgraphNode error_node = NULL;
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      cache->context->syms,
+      cuGraphInstantiate(out_exec, graph, &error_node,
+                         /*logBuffer=*/NULL,
+                         /*bufferSize=*/0),
+      "cuGraphInstantiate");
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_graph_exec_cache_release(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t key, CUgraphExec exec) {
+  if (exec == NULL) return;
+  if (cache->capacity == 0) {
+    CUDA_IGNORE_ERROR(cache->context->syms, cuGraphExecDestroy(exec));
+    return;
+  }
+
+  // Evict the least recently released exec if the cache is full. It is
+  // destroyed outside of the lock as destruction may be slow.
+  CUgraphExec evicted_exec = NULL;
+  iree_slim_mutex_lock(&cache->mutex);
+  if (cache->count == cache->capacity) {
+    evicted_exec = cache->entries[0].exec;
+    memmove(&cache->entries[0], &cache->entries[1],
+            (cache->count - 1) * sizeof(cache->entries[0]));
+    --cache->count;
+  }
+  cache->entries[cache->count].key = key;
+  cache->entries[cache->count].exec = exec;
+  ++cache->count;
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  if (evicted_exec != NULL) {
+    CUDA_IGNORE_ERROR(cache->context->syms, cuGraphExecDestroy(evicted_exec));
+  }
+}
@@ -0,0 +1,83 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+#define IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A free graph exec and the structural key of the graph it was instantiated
+// from or last updated with.
+typedef struct iree_hal_cuda_graph_exec_cache_entry_t {
+  uint64_t key;
+  CUgraphExec exec;
+} iree_hal_cuda_graph_exec_cache_entry_t;
+
+// Cache of instantiated CUDA graph execs keyed by the structure of the graphs
+// they were instantiated from.
+//
+// Instantiating a graph is expensive (100's of us) and programs that record the
+// same command buffer on each invocation with different buffers produce graphs
+// that only differ in their node parameters. Graph command buffers return their
+// execs to the cache when destroyed and new command buffers with the same
+// structural key update a cached exec in-place with cuGraphExecUpdate instead
+// of instantiating a new one.
+//
+// Keys are only used to find candidates: cuGraphExecUpdate verifies that the
+// topology matches and a failed update falls back to instantiation so key
+// collisions are safe.
+//
+// Thread-safe: command buffers may be created and destroyed from any thread.
+typedef struct iree_hal_cuda_graph_exec_cache_t {
+  iree_hal_cuda_context_wrapper_t* context;
+
+  // Guards the entry list.
+  iree_slim_mutex_t mutex;
+
+  // Maximum number of free execs retained in |entries|.
+  iree_host_size_t capacity;
+  // Total number of free execs in |entries|.
+  iree_host_size_t count;
+  // Free execs ordered from least to most recently released.
+  iree_hal_cuda_graph_exec_cache_entry_t* entries;
+} iree_hal_cuda_graph_exec_cache_t;
+
+// Initializes |out_cache| to retain up to |capacity| free graph execs.
+// A |capacity| of 0 disables caching and all execs are instantiated.
+iree_status_t iree_hal_cuda_graph_exec_cache_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_host_size_t capacity,
+    iree_hal_cuda_graph_exec_cache_t* out_cache);
+
+// Destroys all cached execs and deinitializes |cache|.
+// All command buffers using the cache must have been destroyed.
+void iree_hal_cuda_graph_exec_cache_deinitialize(
+    iree_hal_cuda_graph_exec_cache_t* cache);
+
+// Returns an exec for |graph| in |out_exec| that must be released back to the
+// cache with iree_hal_cuda_graph_exec_cache_release.
+// A cached exec with a matching |key| is updated in-place to match |graph| if
+// possible and otherwise a new exec is instantiated.
+iree_status_t iree_hal_cuda_graph_exec_cache_acquire(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t key, CUgraph graph,
+    CUgraphExec* out_exec);
+
+// Returns |exec| to the cache for reuse by graphs with the same |key|.
+// The least recently released exec is destroyed if the cache is full.
+void iree_hal_cuda_graph_exec_cache_release(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t key, CUgraphExec exec);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
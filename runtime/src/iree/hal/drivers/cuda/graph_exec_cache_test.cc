@@ -0,0 +1,204 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
+
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace cuda {
+namespace {
+
+#define CUDA_CHECK_ERRORS(expr)      \
+  {                                  \
+    CUresult status = expr;          \
+    ASSERT_EQ(CUDA_SUCCESS, status); \
+  }
+
+// Number of uint32_t elements written by the test graphs.
+static const size_t kElementCount = 64;
+
+class GraphExecCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_status_t status = iree_hal_cuda_dynamic_symbols_initialize(
+        iree_allocator_system(), &symbols_);
+    if (iree_status_is_ok(status)) {
+      symbols_loaded_ = true;
+      status = iree_hal_cuda_dynamic_symbols_resolve_device(&symbols_);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_status_fprint(stderr, status);
+      iree_status_ignore(status);
+      GTEST_SKIP() << "Symbols cannot be loaded, skipping test.";
+    }
+    int device_count = 0;
+    if (symbols_.cuInit(0) != CUDA_SUCCESS ||
+        symbols_.cuDeviceGetCount(&device_count) != CUDA_SUCCESS ||
+        device_count == 0) {
+      GTEST_SKIP() << "No CUDA devices available, skipping test.";
+    }
+    CUDA_CHECK_ERRORS(symbols_.cuDeviceGet(&context_.cu_device, 0));
+    CUDA_CHECK_ERRORS(
+        symbols_.cuCtxCreate(&context_.cu_context, 0, context_.cu_device));
+    context_.host_allocator = iree_allocator_system();
+    context_.syms = &symbols_;
+    CUDA_CHECK_ERRORS(
+        symbols_.cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING));
+    for (CUdeviceptr& ptr : ptrs_) {
+      CUDA_CHECK_ERRORS(symbols_.cuMemAllocManaged(
+          &ptr, kElementCount * sizeof(uint32_t), CU_MEM_ATTACH_GLOBAL));
+    }
+  }
+
+  void TearDown() override {
+    for (CUdeviceptr ptr : ptrs_) {
+      if (ptr) symbols_.cuMemFree(ptr);
+    }
+    if (stream_) symbols_.cuStreamDestroy(stream_);
+    if (context_.cu_context) symbols_.cuCtxDestroy(context_.cu_context);
+    if (symbols_loaded_) iree_hal_cuda_dynamic_symbols_deinitialize(&symbols_);
+  }
+
+  // Creates a graph with one memset node writing |value| to each of |ptrs|.
+  // Graphs with the same pointer count have the same topology.
+  CUgraph CreateMemsetGraph(const CUdeviceptr* ptrs, size_t ptr_count,
+                            uint32_t value) {
+    CUgraph graph = NULL;
+    EXPECT_EQ(CUDA_SUCCESS, symbols_.cuGraphCreate(&graph, 0));
+    for (size_t i = 0; i < ptr_count; ++i) {
+      CUDA_MEMSET_NODE_PARAMS params = {};
+      params.dst = ptrs[i];
+      params.elementSize = sizeof(uint32_t);
+      params.width = kElementCount;
+      params.height = 1;
+      params.value = value;
+      CUgraphNode node = NULL;
+      EXPECT_EQ(CUDA_SUCCESS,
+                symbols_.cuGraphAddMemsetNode(&node, graph, NULL, 0, &params,
+                                              context_.cu_context));
+    }
+    return graph;
+  }
+
+  // Launches |exec| and returns true if every element of |ptr| is |value|.
+  bool LaunchAndCheck(CUgraphExec exec, CUdeviceptr ptr, uint32_t value) {
+    EXPECT_EQ(CUDA_SUCCESS, symbols_.cuGraphLaunch(exec, stream_));
+    EXPECT_EQ(CUDA_SUCCESS, symbols_.cuStreamSynchronize(stream_));
+    const uint32_t* data = (const uint32_t*)ptr;
+    for (size_t i = 0; i < kElementCount; ++i) {
+      if (data[i] != value) return false;
+    }
+    return true;
+  }
+
+  bool symbols_loaded_ = false;
+  iree_hal_cuda_dynamic_symbols_t symbols_;
+  iree_hal_cuda_context_wrapper_t context_ = {};
+  CUstream stream_ = NULL;
+  CUdeviceptr ptrs_[3] = {0, 0, 0};
+};
+
+// A cached exec is updated in-place with the parameters of a new graph with
+// the same key and topology.
+TEST_F(GraphExecCacheTest, HitUpdatesExec) {
+  iree_hal_cuda_graph_exec_cache_t cache;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_initialize(&context_, 4, &cache));
+
+  CUgraph graph_a = CreateMemsetGraph(&ptrs_[0], 1, 0x11);
+  CUgraphExec exec_a = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 1, graph_a, &exec_a));
+  EXPECT_TRUE(LaunchAndCheck(exec_a, ptrs_[0], 0x11));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 1, exec_a);
+  EXPECT_EQ(1u, cache.count);
+
+  // Same topology with different parameters reuses the exec.
+  CUgraph graph_b = CreateMemsetGraph(&ptrs_[1], 1, 0x22);
+  CUgraphExec exec_b = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 1, graph_b, &exec_b));
+  EXPECT_EQ(exec_a, exec_b);
+  EXPECT_EQ(0u, cache.count);
+  EXPECT_TRUE(LaunchAndCheck(exec_b, ptrs_[1], 0x22));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 1, exec_b);
+
+  CUDA_CHECK_ERRORS(symbols_.cuGraphDestroy(graph_a));
+  CUDA_CHECK_ERRORS(symbols_.cuGraphDestroy(graph_b));
+  iree_hal_cuda_graph_exec_cache_deinitialize(&cache);
+}
+
+// A cached exec whose topology does not match the graph (a key collision) is
+// dropped and a new exec is instantiated.
+TEST_F(GraphExecCacheTest, MismatchedTopologyInstantiates) {
+  iree_hal_cuda_graph_exec_cache_t cache;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_initialize(&context_, 4, &cache));
+
+  CUgraph graph_a = CreateMemsetGraph(&ptrs_[0], 1, 0x11);
+  CUgraphExec exec_a = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 7, graph_a, &exec_a));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 7, exec_a);
+
+  CUgraph graph_b = CreateMemsetGraph(&ptrs_[1], 2, 0x33);
+  CUgraphExec exec_b = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 7, graph_b, &exec_b));
+  EXPECT_EQ(0u, cache.count);
+  EXPECT_TRUE(LaunchAndCheck(exec_b, ptrs_[1], 0x33));
+  EXPECT_TRUE(LaunchAndCheck(exec_b, ptrs_[2], 0x33));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 7, exec_b);
+
+  CUDA_CHECK_ERRORS(symbols_.cuGraphDestroy(graph_a));
+  CUDA_CHECK_ERRORS(symbols_.cuGraphDestroy(graph_b));
+  iree_hal_cuda_graph_exec_cache_deinitialize(&cache);
+}
+
+// Releasing into a full cache evicts the least recently released exec.
+TEST_F(GraphExecCacheTest, EvictsLeastRecentlyReleased) {
+  iree_hal_cuda_graph_exec_cache_t cache;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_initialize(&context_, 1, &cache));
+
+  CUgraph graph = CreateMemsetGraph(&ptrs_[0], 1, 0x44);
+  CUgraphExec exec_1 = NULL;
+  CUgraphExec exec_2 = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 1, graph, &exec_1));
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 2, graph, &exec_2));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 1, exec_1);
+  iree_hal_cuda_graph_exec_cache_release(&cache, 2, exec_2);
+  ASSERT_EQ(1u, cache.count);
+  EXPECT_EQ(2u, cache.entries[0].key);
+  EXPECT_EQ(exec_2, cache.entries[0].exec);
+
+  // Key 1 was evicted and must be instantiated again.
+  CUgraphExec exec_3 = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_cuda_graph_exec_cache_acquire(&cache, 1, graph, &exec_3));
+  EXPECT_EQ(1u, cache.count);
+  EXPECT_TRUE(LaunchAndCheck(exec_3, ptrs_[0], 0x44));
+  iree_hal_cuda_graph_exec_cache_release(&cache, 1, exec_3);
+  EXPECT_EQ(1u, cache.count);
+  EXPECT_EQ(1u, cache.entries[0].key);
+
+  CUDA_CHECK_ERRORS(symbols_.cuGraphDestroy(graph));
+  iree_hal_cuda_graph_exec_cache_deinitialize(&cache);
+}
+
+}  // namespace
+}  // namespace cuda
+}  // namespace hal
+}  // namespace iree
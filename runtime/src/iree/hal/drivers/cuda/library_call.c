@@ -0,0 +1,266 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/library_call.h"
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/drivers/cuda/dynamic_symbols.h"
+
+// Converts a cublasStatus_t returned by |expr| to an iree_status_t.
+#define CUBLASLT_RESULT_TO_STATUS(syms, expr, message) \
+  iree_hal_cuda_cublaslt_result_to_status(((syms)->expr), (message))
+
+static iree_status_t iree_hal_cuda_cublaslt_result_to_status(
+    cublasStatus_t result, const char* message) {
+  if (IREE_LIKELY(result == CUBLAS_STATUS_SUCCESS)) return iree_ok_status();
+  return iree_make_status(IREE_STATUS_INTERNAL,
+                          "cuBLASLt error %d returned from %s", (int)result,
+                          message);
+}
+
+static iree_status_t iree_hal_cuda_library_element_type(
+    iree_CUDALibraryElementTypeDef_enum_t element_type,
+    cudaDataType_t* out_type) {
+  switch (element_type) {
+    case iree_CUDALibraryElementTypeDef_F32:
+      *out_type = CUDA_R_32F;
+      return iree_ok_status();
+    case iree_CUDALibraryElementTypeDef_F16:
+      *out_type = CUDA_R_16F;
+      return iree_ok_status();
+    case iree_CUDALibraryElementTypeDef_BF16:
+      *out_type = CUDA_R_16BF;
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unsupported library call element type %u",
+                              (uint32_t)element_type);
+  }
+}
+
+static iree_status_t iree_hal_cuda_library_epilogue(
+    iree_CUDALibraryEpilogueDef_enum_t epilogue,
+    cublasLtEpilogue_t* out_epilogue, bool* out_has_bias) {
+  *out_has_bias = false;
+  switch (epilogue) {
+    case iree_CUDALibraryEpilogueDef_NONE:
+      *out_epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+      return iree_ok_status();
+    case iree_CUDALibraryEpilogueDef_RELU:
+      *out_epilogue = CUBLASLT_EPILOGUE_RELU;
+      return iree_ok_status();
+    case iree_CUDALibraryEpilogueDef_BIAS:
+      *out_epilogue = CUBLASLT_EPILOGUE_BIAS;
+      *out_has_bias = true;
+      return iree_ok_status();
+    case iree_CUDALibraryEpilogueDef_RELU_BIAS:
+      *out_epilogue = CUBLASLT_EPILOGUE_RELU_BIAS;
+      *out_has_bias = true;
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unsupported library call epilogue %u",
+                              (uint32_t)epilogue);
+  }
+}
+
+// Creates the descriptors for a row-major matmul. cuBLASLt is column-major so
+// we compute out^T = rhs^T * lhs^T which has the same memory layout as the
+// row-major out = lhs * rhs without needing any transposes of our own.
+static iree_status_t iree_hal_cuda_library_call_initialize_matmul(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_CUDAMatmulDef_table_t matmul_def,
+    iree_hal_cuda_library_call_t* call) {
+  iree_hal_cuda_dynamic_symbols_t* syms = context->syms;
+  const uint64_t m = iree_CUDAMatmulDef_m_get(matmul_def);
+  const uint64_t n = iree_CUDAMatmulDef_n_get(matmul_def);
+  const uint64_t k = iree_CUDAMatmulDef_k_get(matmul_def);
+  const bool transpose_lhs = iree_CUDAMatmulDef_transpose_lhs_get(matmul_def);
+  const bool transpose_rhs = iree_CUDAMatmulDef_transpose_rhs_get(matmul_def);
+
+  cudaDataType_t element_type = CUDA_R_32F;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_library_element_type(
+      iree_CUDAMatmulDef_element_type_get(matmul_def), &element_type));
+  cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+  bool has_bias = false;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_library_epilogue(
+      iree_CUDAMatmulDef_epilogue_get(matmul_def), &epilogue, &has_bias));
+  call->binding_count = has_bias ? 4 : 3;
+
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatmulDescCreate(&call->matmul_desc, CUBLAS_COMPUTE_32F,
+                               CUDA_R_32F),
+      "cublasLtMatmulDescCreate"));
+  // cuBLASLt A is our rhs and B is our lhs.
+  cublasOperation_t transa = transpose_rhs ? CUBLAS_OP_T : CUBLAS_OP_N;
+  cublasOperation_t transb = transpose_lhs ? CUBLAS_OP_T : CUBLAS_OP_N;
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatmulDescSetAttribute(call->matmul_desc,
+                                     CUBLASLT_MATMUL_DESC_TRANSA, &transa,
+                                     sizeof(transa)),
+      "cublasLtMatmulDescSetAttribute"));
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatmulDescSetAttribute(call->matmul_desc,
+                                     CUBLASLT_MATMUL_DESC_TRANSB, &transb,
+                                     sizeof(transb)),
+      "cublasLtMatmulDescSetAttribute"));
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatmulDescSetAttribute(call->matmul_desc,
+                                     CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue,
+                                     sizeof(epilogue)),
+      "cublasLtMatmulDescSetAttribute"));
+
+  // Layouts describe the stored (pre-op) column-major matrices.
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatrixLayoutCreate(&call->rhs_layout, element_type,
+                                 transpose_rhs ? k : n, transpose_rhs ? n : k,
+                                 (int64_t)(transpose_rhs ? k : n)),
+      "cublasLtMatrixLayoutCreate"));
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatrixLayoutCreate(&call->lhs_layout, element_type,
+                                 transpose_lhs ? m : k, transpose_lhs ? k : m,
+                                 (int64_t)(transpose_lhs ? m : k)),
+      "cublasLtMatrixLayoutCreate"));
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatrixLayoutCreate(&call->out_layout, element_type, n, m,
+                                 (int64_t)n),
+      "cublasLtMatrixLayoutCreate"));
+
+  // Pick the best algorithm once; no workspace is provided for now.
+  cublasLtMatmulPreference_t preference = NULL;
+  IREE_RETURN_IF_ERROR(CUBLASLT_RESULT_TO_STATUS(
+      syms, cublasLtMatmulPreferenceCreate(&preference),
+      "cublasLtMatmulPreferenceCreate"));
+  uint64_t max_workspace_size = 0;
+  iree_status_t status = CUBLASLT_RESULT_TO_STATUS(
+      syms,
+      cublasLtMatmulPreferenceSetAttribute(
+          preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+          &max_workspace_size, sizeof(max_workspace_size)),
+      "cublasLtMatmulPreferenceSetAttribute");
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  memset(&heuristic_result, 0, sizeof(heuristic_result));
+  int heuristic_result_count = 0;
+  if (iree_status_is_ok(status)) {
+    status = CUBLASLT_RESULT_TO_STATUS(
+        syms,
+        cublasLtMatmulAlgoGetHeuristic(
+            call->handle, call->matmul_desc, call->rhs_layout,
+            call->lhs_layout, call->out_layout, call->out_layout, preference,
+            /*requestedAlgoCount=*/1, &heuristic_result,
+            &heuristic_result_count),
+        "cublasLtMatmulAlgoGetHeuristic");
+  }
+  if (iree_status_is_ok(status) && heuristic_result_count == 0) {
+    status = iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "cuBLASLt has no algorithm for a %" PRIu64 "x%" PRIu64 "x%" PRIu64
+        " matmul on this device",
+        m, n, k);
+  }
+  if (iree_status_is_ok(status)) {
+    call->algo = heuristic_result.algo;
+  }
+  iree_status_ignore(CUBLASLT_RESULT_TO_STATUS(
+      syms, cublasLtMatmulPreferenceDestroy(preference),
+      "cublasLtMatmulPreferenceDestroy"));
+  return status;
+}
+
+iree_status_t iree_hal_cuda_library_call_initialize(
+    iree_hal_cuda_context_wrapper_t* context, cublasLtHandle_t handle,
+    iree_CUDALibraryCallDef_table_t library_call_def,
+    iree_hal_cuda_library_call_t* out_call) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(library_call_def);
+  IREE_ASSERT_ARGUMENT(out_call);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_call, 0, sizeof(*out_call));
+  out_call->handle = handle;
+  iree_slim_mutex_initialize(&out_call->mutex);
+
+  iree_status_t status = iree_ok_status();
+  iree_CUDAMatmulDef_table_t matmul_def =
+      iree_CUDALibraryCallDef_matmul_get(library_call_def);
+  if (matmul_def) {
+    status = iree_hal_cuda_library_call_initialize_matmul(context, matmul_def,
+                                                          out_call);
+  } else {
+    status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "library call has no operation");
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_cuda_library_call_deinitialize(context, out_call);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_library_call_deinitialize(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_library_call_t* call) {
+  iree_hal_cuda_dynamic_symbols_t* syms = context->syms;
+  if (call->out_layout) syms->cublasLtMatrixLayoutDestroy(call->out_layout);
+  if (call->lhs_layout) syms->cublasLtMatrixLayoutDestroy(call->lhs_layout);
+  if (call->rhs_layout) syms->cublasLtMatrixLayoutDestroy(call->rhs_layout);
+  if (call->matmul_desc) syms->cublasLtMatmulDescDestroy(call->matmul_desc);
+  iree_slim_mutex_deinitialize(&call->mutex);
+  memset(call, 0, sizeof(*call));
+}
+
+iree_status_t iree_hal_cuda_library_call_issue(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_library_call_t* call, CUstream stream,
+    void** kernel_args) {
+  iree_hal_cuda_dynamic_symbols_t* syms = context->syms;
+  const bool has_bias = call->binding_count == 4;
+  CUdeviceptr lhs = *(CUdeviceptr*)kernel_args[0];
+  CUdeviceptr rhs = *(CUdeviceptr*)kernel_args[1];
+  CUdeviceptr bias = has_bias ? *(CUdeviceptr*)kernel_args[2] : 0;
+  CUdeviceptr out = *(CUdeviceptr*)kernel_args[call->binding_count - 1];
+
+  // The bias pointer is part of the shared descriptor so it is updated and
+  // consumed under the lock. cuBLASLt reads the descriptor when the call is
+  // enqueued (or captured) and not when it executes.
+  const float alpha = 1.0f;
+  const float beta = 0.0f;
+  iree_slim_mutex_lock(&call->mutex);
+  iree_status_t status = iree_ok_status();
+  if (has_bias) {
+    void* bias_ptr = (void*)(uintptr_t)bias;
+    status = CUBLASLT_RESULT_TO_STATUS(
+        syms,
+        cublasLtMatmulDescSetAttribute(call->matmul_desc,
+                                       CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                       &bias_ptr, sizeof(bias_ptr)),
+        "cublasLtMatmulDescSetAttribute");
+  }
+  if (iree_status_is_ok(status)) {
+    status = CUBLASLT_RESULT_TO_STATUS(
+        syms,
+        cublasLtMatmul(call->handle, call->matmul_desc, &alpha,
+                       (const void*)(uintptr_t)rhs, call->rhs_layout,
+                       (const void*)(uintptr_t)lhs, call->lhs_layout, &beta,
+                       (const void*)(uintptr_t)out, call->out_layout,
+                       (void*)(uintptr_t)out, call->out_layout, &call->algo,
+                       /*workspace=*/NULL, /*workspaceSizeInBytes=*/0, stream),
+        "cublasLtMatmul");
+  }
+  iree_slim_mutex_unlock(&call->mutex);
+  return status;
+}
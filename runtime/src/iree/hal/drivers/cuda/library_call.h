@@ -0,0 +1,65 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_LIBRARY_CALL_H_
+#define IREE_HAL_DRIVERS_CUDA_LIBRARY_CALL_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cublaslt_headers.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+// flatcc schemas:
+#include "iree/schemas/cuda_executable_def_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// An executable entry point implemented by cuBLASLt instead of a kernel.
+// The matmul descriptor, matrix layouts, and algorithm chosen by the cuBLASLt
+// heuristics are all created once when the executable is loaded so that
+// recording a dispatch only needs to issue the cublasLtMatmul call.
+typedef struct iree_hal_cuda_library_call_t {
+  // Handle shared by all library calls in the executable; unowned.
+  cublasLtHandle_t handle;
+  cublasLtMatmulDesc_t matmul_desc;
+  cublasLtMatrixLayout_t lhs_layout;
+  cublasLtMatrixLayout_t rhs_layout;
+  cublasLtMatrixLayout_t out_layout;
+  cublasLtMatmulAlgo_t algo;
+  // Number of bindings used: lhs, rhs, [bias], out.
+  uint32_t binding_count;
+  // Guards the per-issue descriptor attributes (the bias pointer) as the same
+  // executable may be recorded into multiple command buffers concurrently.
+  iree_slim_mutex_t mutex;
+} iree_hal_cuda_library_call_t;
+
+// Initializes |out_call| for |library_call_def| by creating its cuBLASLt
+// descriptors with |handle| and querying the heuristics for an algorithm.
+iree_status_t iree_hal_cuda_library_call_initialize(
+    iree_hal_cuda_context_wrapper_t* context, cublasLtHandle_t handle,
+    iree_CUDALibraryCallDef_table_t library_call_def,
+    iree_hal_cuda_library_call_t* out_call);
+
+// Deinitializes |call| and releases its cuBLASLt descriptors.
+void iree_hal_cuda_library_call_deinitialize(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_library_call_t* call);
+
+// Issues |call| on |stream| with the binding device pointers referenced by
+// |kernel_args| in the same layout used for kernel launches.
+iree_status_t iree_hal_cuda_library_call_issue(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_library_call_t* call, CUstream stream,
+    void** kernel_args);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_LIBRARY_CALL_H_
@@ -0,0 +1,236 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/memory_pools.h"
+
+#include <string.h>
+
+#include "iree/base/tracing.h"
+#include "iree/hal/drivers/cuda/cuda_buffer.h"
+#include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+static const char* IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID =
+    "CUDA pool: device-local reserved";
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
+static iree_status_t iree_hal_cuda_create_memory_pool(
+    iree_hal_cuda_context_wrapper_t* context, CUdevice device,
+    iree_hal_cuda_memory_pool_params_t params,
+    CUmemoryPool* IREE_RESTRICT out_pool) {
+  *out_pool = NULL;
+
+  CUmemPoolProps pool_props = {
+      .allocType = CU_MEM_ALLOCATION_TYPE_PINNED,
+      // TODO: allow sharing of certain pool memory types by fd/HANDLE.
+      .handleTypes = CU_MEM_HANDLE_TYPE_NONE,
+      .location =
+          {
+              .type = CU_MEM_LOCATION_TYPE_DEVICE,
+              .id = device,
+          },
+      .win32SecurityAttributes = NULL,
+      .reserved = {0},
+  };
+
+  CUmemoryPool pool = NULL;
+  CUDA_RETURN_IF_ERROR(context->syms, cuMemPoolCreate(&pool, &pool_props),
+                       "cuMemPoolCreate");
+
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      context->syms,
+      cuMemPoolSetAttribute(pool, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD,
+                            &params.release_threshold),
+      "cuMemPoolSetAttribute");
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    CUDA_IGNORE_ERROR(context->syms, cuMemPoolDestroy(pool));
+  }
+  return status;
+}
+
+iree_status_t iree_hal_cuda_memory_pools_initialize(
+    iree_hal_cuda_context_wrapper_t* context, CUdevice device, CUstream stream,
+    const iree_hal_cuda_memory_pooling_params_t* pooling_params,
+    iree_hal_cuda_memory_pools_t* IREE_RESTRICT out_pools) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(pooling_params);
+  IREE_ASSERT_ARGUMENT(out_pools);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_pools, 0, sizeof(*out_pools));
+  out_pools->context = context;
+  out_pools->stream = stream;
+
+  // Stream-ordered allocators were added in CUDA 11.2 and are optional on some
+  // platforms (and always unavailable on others).
+  int memory_pools_supported = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, CU_RESULT_TO_STATUS(
+              context->syms,
+              cuDeviceGetAttribute(&memory_pools_supported,
+                                   CU_DEVICE_ATTRIBUTE_MEMORY_POOLS_SUPPORTED,
+                                   device),
+              "cuDeviceGetAttribute"));
+  if (!memory_pools_supported) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device does not support CUDA memory pools");
+  }
+
+  iree_status_t status = iree_hal_cuda_create_memory_pool(
+      context, device, pooling_params->device_local, &out_pools->device_local);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_memory_pools_deinitialize(
+    iree_hal_cuda_memory_pools_t* pools) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (pools->device_local) {
+    CUDA_IGNORE_ERROR(pools->context->syms,
+                      cuMemPoolDestroy(pools->device_local));
+    pools->device_local = NULL;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_memory_pools_trim(
+    iree_hal_cuda_memory_pools_t* pools,
+    const iree_hal_cuda_memory_pooling_params_t* pooling_params) {
+  CUDA_RETURN_IF_ERROR(
+      pools->context->syms,
+      cuMemPoolTrimTo(pools->device_local,
+                      pooling_params->device_local.minimum_capacity),
+      "cuMemPoolTrimTo");
+  return iree_ok_status();
+}
+
+// NOTE: this only frees memory if the buffer is destroyed without having been
+// scheduled for deallocation asynchronously. When a buffer is scheduled we
+// clear its device pointer so that we don't double-free here.
+static void iree_hal_cuda_async_buffer_release_callback(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_memory_pools_t* pools =
+      (iree_hal_cuda_memory_pools_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(buffer);
+  if (device_ptr) {
+    IREE_TRACE_FREE_NAMED(IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID,
+                          (void*)device_ptr);
+    CUDA_IGNORE_ERROR(pools->context->syms,
+                      cuMemFreeAsync(device_ptr, pools->stream));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_memory_pools_alloca(
+    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
+    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  // Guard against the corner case where the requested buffer size is 0 to
+  // match the behavior of the synchronous allocator.
+  if (allocation_size == 0) allocation_size = 4;
+
+  // Zero-initialized params (such as an unspecified access) get the same
+  // defaults as they would from the device allocator.
+  iree_hal_buffer_params_canonicalize(&params);
+
+  // TODO: more pools and better selection; this is coarsely deciding between
+  // only device local (variables, constants, transients) and other (staging,
+  // external) but could use more buffer properties (including usage/export
+  // flags) to better isolate the different usage patterns and keep the pools
+  // operating with reasonable limits. We should be using the |pool| arg.
+  CUmemoryPool memory_pool =
+      iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) &&
+              !iree_any_bit_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)
+          ? pools->device_local
+          : NULL;
+  if (!memory_pool) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no memory pool available for the requested memory type");
+  }
+
+  CUdeviceptr device_ptr = 0;
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      pools->context->syms,
+      cuMemAllocFromPoolAsync(&device_ptr, (size_t)allocation_size,
+                              memory_pool, stream),
+      "cuMemAllocFromPoolAsync");
+
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_hal_cuda_async_buffer_release_callback,
+        .user_data = pools,
+    };
+    status = iree_hal_cuda_buffer_wrap(
+        /*allocator=*/NULL, pools->context->host_allocator,
+        params.type & ~IREE_HAL_MEMORY_TYPE_OPTIMAL, params.access,
+        params.usage, allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, IREE_HAL_CUDA_BUFFER_TYPE_ASYNC,
+        device_ptr, /*host_ptr=*/NULL, release_callback, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED(IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID,
+                           (void*)device_ptr, allocation_size);
+    *out_buffer = buffer;
+  } else if (device_ptr) {
+    CUDA_IGNORE_ERROR(pools->context->syms, cuMemFreeAsync(device_ptr, stream));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_memory_pools_dealloca(
+    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
+    iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0,
+                               (int64_t)iree_hal_buffer_allocation_size(buffer));
+
+  // Only process the request if the buffer came from an async pool.
+  // We may get requests for deallocations on ones that didn't if one part of
+  // the application allocated the buffer synchronously and another deallocated
+  // it asynchronously; those will be freed when they are released.
+  iree_status_t status = iree_ok_status();
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (iree_hal_cuda_buffer_type(allocated_buffer) ==
+      IREE_HAL_CUDA_BUFFER_TYPE_ASYNC) {
+    CUdeviceptr device_ptr =
+        iree_hal_cuda_buffer_device_pointer(allocated_buffer);
+    if (device_ptr) {
+      // Clear the pointer first so that the release callback doesn't try to
+      // free the memory again when the buffer wrapper is destroyed.
+      iree_hal_cuda_buffer_set_device_pointer(allocated_buffer, 0);
+      IREE_TRACE_FREE_NAMED(IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID,
+                            (void*)device_ptr);
+      status = CU_RESULT_TO_STATUS(pools->context->syms,
+                                   cuMemFreeAsync(device_ptr, stream),
+                                   "cuMemFreeAsync");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -9,6 +9,7 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/status_util.h"
@@ -23,6 +24,10 @@ typedef struct iree_hal_cuda_native_executable_t {
   iree_hal_cuda_context_wrapper_t* context;
   iree_hal_pipeline_layout_t** pipeline_layouts;
   CUmodule module;
+  // cuBLASLt handle shared by all |library_calls|, if any.
+  cublasLtHandle_t cublaslt_handle;
+  iree_host_size_t library_call_count;
+  iree_hal_cuda_library_call_t* library_calls;
   iree_host_size_t entry_point_count;
   iree_hal_cuda_kernel_params_t entry_points[];
 } iree_hal_cuda_native_executable_t;
@@ -30,12 +35,161 @@ typedef struct iree_hal_cuda_native_executable_t {
 static const iree_hal_executable_vtable_t
     iree_hal_cuda_native_executable_vtable;
 
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+// Process-wide counts of modules loaded from embedded cubins and of modules
+// that fell back to JIT compiling PTX, plotted to show the cubin hit rate.
+static iree_atomic_int64_t iree_hal_cuda_cubin_load_count =
+    IREE_ATOMIC_VAR_INIT(0);
+static iree_atomic_int64_t iree_hal_cuda_ptx_jit_count =
+    IREE_ATOMIC_VAR_INIT(0);
+#define IREE_HAL_CUDA_PLOT_MODULE_LOAD(counter, plot_name_literal)         \
+  IREE_TRACE_PLOT_VALUE_I64(                                              \
+      plot_name_literal,                                                  \
+      iree_atomic_fetch_add_int64(&(counter), 1, iree_memory_order_relaxed) \
+          + 1)
+#else
+#define IREE_HAL_CUDA_PLOT_MODULE_LOAD(counter, plot_name_literal)
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
 static iree_hal_cuda_native_executable_t* iree_hal_cuda_native_executable_cast(
     iree_hal_executable_t* base_value) {
   IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_cuda_native_executable_vtable);
   return (iree_hal_cuda_native_executable_t*)base_value;
 }
 
+// Selects the cubin in |cubin_images| that best matches |cu_device|.
+// cubins are only binary compatible with devices of the same major compute
+// capability and an equal or newer minor version so the newest compatible one
+// is chosen. Returns NULL if none are compatible.
+static iree_CUDACubinDef_table_t iree_hal_cuda_select_cubin(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_CUDACubinDef_vec_t cubin_images) {
+  const iree_host_size_t cubin_count = iree_CUDACubinDef_vec_len(cubin_images);
+  if (cubin_count == 0) return NULL;
+
+  int major = 0;
+  int minor = 0;
+  if (context->syms->cuDeviceGetAttribute(
+          &major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR,
+          context->cu_device) != CUDA_SUCCESS ||
+      context->syms->cuDeviceGetAttribute(
+          &minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR,
+          context->cu_device) != CUDA_SUCCESS) {
+    return NULL;
+  }
+  const uint32_t device_sm_version = (uint32_t)(major * 10 + minor);
+
+  iree_CUDACubinDef_table_t best_cubin = NULL;
+  uint32_t best_sm_version = 0;
+  for (iree_host_size_t i = 0; i < cubin_count; ++i) {
+    iree_CUDACubinDef_table_t cubin = iree_CUDACubinDef_vec_at(cubin_images, i);
+    uint32_t sm_version = iree_CUDACubinDef_sm_version_get(cubin);
+    if (sm_version / 10 != device_sm_version / 10) continue;
+    if (sm_version > device_sm_version) continue;
+    if (flatbuffers_uint8_vec_len(iree_CUDACubinDef_data_get(cubin)) == 0) {
+      continue;
+    }
+    if (!best_cubin || sm_version > best_sm_version) {
+      best_cubin = cubin;
+      best_sm_version = sm_version;
+    }
+  }
+  return best_cubin;
+}
+
+// Loads the module from the best compatible cubin in |executable_def|, if any,
+// and otherwise JIT compiles the PTX image.
+static iree_status_t iree_hal_cuda_native_executable_load_module(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_CUDAExecutableDef_table_t executable_def, CUmodule* out_module) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_CUDACubinDef_table_t cubin = iree_hal_cuda_select_cubin(
+      context, iree_CUDAExecutableDef_cubin_images_get(executable_def));
+  if (cubin) {
+    IREE_TRACE_ZONE_APPEND_VALUE(
+        z0, (int64_t)iree_CUDACubinDef_sm_version_get(cubin));
+    // The driver may still reject the cubin (for example when it was produced
+    // by a newer toolkit) in which case the PTX is used instead.
+    CUresult result = context->syms->cuModuleLoadDataEx(
+        out_module, iree_CUDACubinDef_data_get(cubin), 0, NULL, NULL);
+    if (result == CUDA_SUCCESS) {
+      IREE_HAL_CUDA_PLOT_MODULE_LOAD(iree_hal_cuda_cubin_load_count,
+                                     "iree-hal-cuda-cubin-loads");
+      IREE_TRACE_ZONE_END(z0);
+      return iree_ok_status();
+    }
+  }
+
+  // Load the PTX image - this will fail if the device cannot handle the
+  // contents. The driver may satisfy this from its own JIT cache but we cannot
+  // observe that from here.
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "ptx");
+  flatbuffers_string_t ptx_image =
+      iree_CUDAExecutableDef_ptx_image_get(executable_def);
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      context->syms, cuModuleLoadDataEx(out_module, ptx_image, 0, NULL, NULL),
+      "cuModuleLoadDataEx");
+  if (iree_status_is_ok(status)) {
+    IREE_HAL_CUDA_PLOT_MODULE_LOAD(iree_hal_cuda_ptx_jit_count,
+                                   "iree-hal-cuda-ptx-jit-loads");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Creates the cuBLASLt plans for each entry point in |library_calls_vec| and
+// links them to their entry points in |executable|.
+static iree_status_t iree_hal_cuda_native_executable_initialize_library_calls(
+    iree_hal_cuda_native_executable_t* executable,
+    iree_CUDALibraryCallDef_vec_t library_calls_vec) {
+  iree_hal_cuda_context_wrapper_t* context = executable->context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t library_call_count =
+      iree_CUDALibraryCallDef_vec_len(library_calls_vec);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)library_call_count);
+  iree_status_t status = iree_hal_cuda_cublaslt_dynamic_symbols_initialize(
+      context->host_allocator, context->syms);
+  if (iree_status_is_ok(status) &&
+      context->syms->cublasLtCreate(&executable->cublaslt_handle) !=
+          CUBLAS_STATUS_SUCCESS) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "failed to create a cuBLASLt handle");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(
+        context->host_allocator,
+        library_call_count * sizeof(executable->library_calls[0]),
+        (void**)&executable->library_calls);
+  }
+  for (iree_host_size_t i = 0; i < library_call_count; ++i) {
+    if (!iree_status_is_ok(status)) break;
+    iree_CUDALibraryCallDef_table_t library_call_def =
+        iree_CUDALibraryCallDef_vec_at(library_calls_vec, i);
+    uint32_t entry_point =
+        iree_CUDALibraryCallDef_entry_point_get(library_call_def);
+    if (entry_point >= executable->entry_point_count ||
+        executable->entry_points[entry_point].library_call) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "library call %" PRIhsz
+                                " has an invalid entry point ordinal %u",
+                                i, entry_point);
+      break;
+    }
+    iree_hal_cuda_library_call_t* library_call = &executable->library_calls[i];
+    status = iree_hal_cuda_library_call_initialize(
+        context, executable->cublaslt_handle, library_call_def, library_call);
+    if (!iree_status_is_ok(status)) break;
+    executable->library_call_count = i + 1;
+    executable->entry_points[entry_point].library_call = library_call;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 iree_status_t iree_hal_cuda_native_executable_create(
     iree_hal_cuda_context_wrapper_t* context,
     const iree_hal_executable_params_t* executable_params,
@@ -54,8 +208,6 @@ iree_status_t iree_hal_cuda_native_executable_create(
   iree_CUDAExecutableDef_table_t executable_def =
       iree_CUDAExecutableDef_as_root(executable_params->executable_data.data);
 
-  flatbuffers_string_t ptx_image =
-      iree_CUDAExecutableDef_ptx_image_get(executable_def);
   flatbuffers_uint32_vec_t shared_memory_sizes =
       iree_CUDAExecutableDef_shared_memory_size_get(executable_def);
   flatbuffers_string_vec_t entry_points_vec =
@@ -64,6 +216,10 @@ iree_status_t iree_hal_cuda_native_executable_create(
       iree_CUDAExecutableDef_block_sizes_get(executable_def);
   iree_host_size_t entry_point_count =
       flatbuffers_string_vec_len(entry_points_vec);
+  iree_CUDALibraryCallDef_vec_t library_calls_vec =
+      iree_CUDAExecutableDef_library_calls_get(executable_def);
+  iree_host_size_t library_call_count =
+      iree_CUDALibraryCallDef_vec_len(library_calls_vec);
 
   // Calculate the total number of characters across all entry point names. This
   // is only required when tracing so that we can store copies of the names as
@@ -92,22 +248,42 @@ iree_status_t iree_hal_cuda_native_executable_create(
     iree_hal_resource_initialize(&iree_hal_cuda_native_executable_vtable,
                                  &executable->resource);
     executable->context = context;
+    executable->entry_point_count = entry_point_count;
+
+    // Executables that only contain library calls have no module to load.
+    if (library_call_count < entry_point_count) {
+      status = iree_hal_cuda_native_executable_load_module(
+          context, executable_def, &executable->module);
+    }
+  }
 
-    // Load the PTX image - this will fail if the device cannot handle the
-    // contents. We could check this prior to creating
-    status = CU_RESULT_TO_STATUS(
-        context->syms,
-        cuModuleLoadDataEx(&executable->module, ptx_image, 0, NULL, NULL),
-        "cuModuleLoadDataEx");
+  if (iree_status_is_ok(status) && library_call_count > 0) {
+    status = iree_hal_cuda_native_executable_initialize_library_calls(
+        executable, library_calls_vec);
   }
 
   if (iree_status_is_ok(status)) {
-    executable->entry_point_count = entry_point_count;
     for (iree_host_size_t i = 0; i < entry_point_count; i++) {
+      iree_hal_cuda_kernel_params_t* params = &executable->entry_points[i];
+      params->layout = executable_params->pipeline_layouts[i];
+      iree_hal_pipeline_layout_retain(params->layout);
+      const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
+
+      // Stash the entry point name in the string table for use when tracing.
+      IREE_TRACE({
+        iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
+        memcpy(string_table_buffer, entry_name, entry_name_length);
+        params->function_name =
+            iree_make_string_view(string_table_buffer, entry_name_length);
+        string_table_buffer += entry_name_length;
+      });
+
+      // Library calls have no function or launch parameters.
+      if (params->library_call) continue;
+
       // Lookup the function in the module; this should always succeed but we
       // cannot trust that the input was generated by our compiler.
       CUfunction function = NULL;
-      const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
       status = CU_RESULT_TO_STATUS(
           context->syms,
           cuModuleGetFunction(&function, executable->module, entry_name),
@@ -145,23 +321,11 @@ iree_status_t iree_hal_cuda_native_executable_create(
       if (!iree_status_is_ok(status)) break;
 
       // Package required parameters for kernel launches for each entry point.
-      iree_hal_cuda_kernel_params_t* params = &executable->entry_points[i];
-      params->layout = executable_params->pipeline_layouts[i];
-      iree_hal_pipeline_layout_retain(params->layout);
       params->function = function;
       params->block_size[0] = block_sizes_vec[i].x;
       params->block_size[1] = block_sizes_vec[i].y;
       params->block_size[2] = block_sizes_vec[i].z;
       params->shared_memory_size = shared_memory_sizes[i];
-
-      // Stash the entry point name in the string table for use when tracing.
-      IREE_TRACE({
-        iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
-        memcpy(string_table_buffer, entry_name, entry_name_length);
-        params->function_name =
-            iree_make_string_view(string_table_buffer, entry_name_length);
-        string_table_buffer += entry_name_length;
-      });
     }
   }
 
@@ -185,6 +349,14 @@ static void iree_hal_cuda_native_executable_destroy(
   for (iree_host_size_t i = 0; i < executable->entry_point_count; ++i) {
     iree_hal_pipeline_layout_release(executable->entry_points[i].layout);
   }
+  for (iree_host_size_t i = 0; i < executable->library_call_count; ++i) {
+    iree_hal_cuda_library_call_deinitialize(executable->context,
+                                            &executable->library_calls[i]);
+  }
+  iree_allocator_free(host_allocator, executable->library_calls);
+  if (executable->cublaslt_handle) {
+    executable->context->syms->cublasLtDestroy(executable->cublaslt_handle);
+  }
   if (executable->module) {
     CUDA_IGNORE_ERROR(executable->context->syms,
                       cuModuleUnload(executable->module));
@@ -14,6 +14,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/library_call.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +25,9 @@ typedef struct iree_hal_cuda_kernel_params_t {
   CUfunction function;
   uint32_t block_size[3];
   uint32_t shared_memory_size;
+  // Non-NULL if the entry point is served by a library call instead of
+  // |function|. Owned by the executable.
+  iree_hal_cuda_library_call_t* library_call;
   IREE_TRACE(iree_string_view_t function_name;)
 } iree_hal_cuda_kernel_params_t;
 
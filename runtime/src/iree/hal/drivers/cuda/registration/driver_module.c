@@ -20,6 +20,11 @@ IREE_FLAG(
     bool, cuda_use_streams, true,
     "Use CUDA streams for executing command buffers (instead of graphs).");
 
+IREE_FLAG(int32_t, cuda_queue_count, 1,
+          "Number of queues exposed on each CUDA device, each backed by its "
+          "own CUDA stream. Work with different queue affinities may "
+          "overlap.");
+
 IREE_FLAG(bool, cuda_allow_inline_execution, false,
           "Allow command buffers to execute inline against CUDA streams when "
           "possible.");
@@ -29,6 +34,28 @@ IREE_FLAG(bool, cuda_tracing, true,
           "enabled. Severely impacts benchmark timings and should only be used "
           "when analyzing dispatch timings.");
 
+IREE_FLAG(bool, cuda_graph_tracing, false,
+          "Enables tracing of dispatches within graph command buffers when "
+          "--cuda_tracing is enabled. Traced graphs are not cached and are "
+          "instantiated for each command buffer.");
+
+IREE_FLAG(bool, cuda_async_allocations, true,
+          "Enables stream-ordered queue allocations using CUDA memory pools "
+          "when supported by the device.");
+IREE_FLAG(bool, cuda_async_collectives, true,
+          "Issues collective operations on a dedicated stream that overlaps "
+          "with independent work on the queue stream.");
+IREE_FLAG(int64_t, cuda_async_allocation_release_threshold, -1,
+          "Soft maximum number of bytes of reserved memory retained by the "
+          "device-local memory pool across synchronizations. Reserved memory in "
+          "excess of this is released back to the system. Negative values "
+          "retain all reserved memory until the device is trimmed.");
+
+IREE_FLAG(int64_t, cuda_staging_buffer_size, 8 * 1024 * 1024,
+          "Size in bytes of the pinned host staging buffer used for "
+          "synchronous transfers with device-local buffers. 0 disables staging "
+          "and uses queue transfers.");
+
 IREE_FLAG(int32_t, cuda_default_index, 0, "Index of the default CUDA device.");
 
 IREE_FLAG(int32_t, cuda_nccl_default_rank, 0,
@@ -105,8 +132,18 @@ static iree_status_t iree_hal_cuda_driver_factory_try_create(
     default_params.command_buffer_mode =
         IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
   }
+  default_params.queue_count = (iree_host_size_t)FLAG_cuda_queue_count;
   default_params.allow_inline_execution = FLAG_cuda_allow_inline_execution;
   default_params.stream_tracing = FLAG_cuda_tracing;
+  default_params.graph_tracing = FLAG_cuda_graph_tracing;
+  default_params.async_allocations = FLAG_cuda_async_allocations;
+  default_params.async_collectives = FLAG_cuda_async_collectives;
+  if (FLAG_cuda_async_allocation_release_threshold >= 0) {
+    default_params.memory_pools.device_local.release_threshold =
+        (uint64_t)FLAG_cuda_async_allocation_release_threshold;
+  }
+  default_params.staging_buffer_size =
+      (iree_host_size_t)FLAG_cuda_staging_buffer_size;
 
   // Only setup channels if we're running collectives. Setting this will require
   // NCCL to be available at runtime.
@@ -0,0 +1,233 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/staging_buffer.h"
+
+#include <string.h>
+
+#include "iree/base/tracing.h"
+#include "iree/hal/drivers/cuda/cuda_buffer.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+void iree_hal_cuda_staging_buffer_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_host_size_t capacity,
+    iree_hal_cuda_staging_buffer_t* out_staging_buffer) {
+  memset(out_staging_buffer, 0, sizeof(*out_staging_buffer));
+  out_staging_buffer->context = context;
+  out_staging_buffer->capacity = capacity;
+  iree_slim_mutex_initialize(&out_staging_buffer->mutex);
+}
+
+void iree_hal_cuda_staging_buffer_deinitialize(
+    iree_hal_cuda_staging_buffer_t* staging_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_cuda_dynamic_symbols_t* syms = staging_buffer->context->syms;
+  for (iree_host_size_t i = 0; i < IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT;
+       ++i) {
+    if (staging_buffer->slot_events[i]) {
+      CUDA_IGNORE_ERROR(syms, cuEventDestroy(staging_buffer->slot_events[i]));
+    }
+  }
+  if (staging_buffer->host_ptr) {
+    CUDA_IGNORE_ERROR(syms, cuMemFreeHost(staging_buffer->host_ptr));
+  }
+  if (staging_buffer->stream) {
+    CUDA_IGNORE_ERROR(syms, cuStreamDestroy(staging_buffer->stream));
+  }
+  iree_slim_mutex_deinitialize(&staging_buffer->mutex);
+  memset(staging_buffer, 0, sizeof(*staging_buffer));
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Creates the stream, pinned memory, and slot events on first use.
+static iree_status_t iree_hal_cuda_staging_buffer_ensure_initialized(
+    iree_hal_cuda_staging_buffer_t* staging_buffer) {
+  if (staging_buffer->host_ptr) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_cuda_dynamic_symbols_t* syms = staging_buffer->context->syms;
+
+  iree_status_t status = iree_ok_status();
+  if (!staging_buffer->stream) {
+    status = CU_RESULT_TO_STATUS(
+        syms, cuStreamCreate(&staging_buffer->stream, CU_STREAM_NON_BLOCKING),
+        "cuStreamCreate");
+  }
+  for (iree_host_size_t i = 0;
+       i < IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT && iree_status_is_ok(status);
+       ++i) {
+    if (staging_buffer->slot_events[i]) continue;
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuEventCreate(&staging_buffer->slot_events[i], CU_EVENT_DISABLE_TIMING),
+        "cuEventCreate");
+  }
+  if (iree_status_is_ok(status)) {
+    // Not write-combined as the buffer is also read from by the host.
+    void* host_ptr = NULL;
+    status = CU_RESULT_TO_STATUS(
+        syms, cuMemHostAlloc(&host_ptr, staging_buffer->capacity, 0),
+        "cuMemHostAlloc");
+    if (iree_status_is_ok(status)) staging_buffer->host_ptr = host_ptr;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static CUdeviceptr iree_hal_cuda_staging_buffer_device_pointer(
+    iree_hal_buffer_t* buffer, iree_device_size_t offset) {
+  return iree_hal_cuda_buffer_device_pointer(
+             iree_hal_buffer_allocated_buffer(buffer)) +
+         iree_hal_buffer_byte_offset(buffer) + offset;
+}
+
+// Uploads |data_length| bytes from |source| to |target| by copying each chunk
+// into a free slot and issuing its device copy before filling the next slot.
+static iree_status_t iree_hal_cuda_staging_buffer_upload(
+    iree_hal_cuda_staging_buffer_t* staging_buffer, const uint8_t* source,
+    CUdeviceptr target, iree_device_size_t data_length) {
+  iree_hal_cuda_dynamic_symbols_t* syms = staging_buffer->context->syms;
+  iree_host_size_t slot_size =
+      staging_buffer->capacity / IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT;
+  iree_status_t status = iree_ok_status();
+  iree_device_size_t offset = 0;
+  for (iree_host_size_t i = 0; offset < data_length; ++i) {
+    iree_host_size_t slot = i % IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT;
+    iree_host_size_t length =
+        (iree_host_size_t)iree_min(slot_size, data_length - offset);
+    uint8_t* slot_ptr = staging_buffer->host_ptr + slot * slot_size;
+    if (i >= IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT) {
+      // Wait for the previous copy out of the slot before overwriting it.
+      status = CU_RESULT_TO_STATUS(
+          syms, cuEventSynchronize(staging_buffer->slot_events[slot]),
+          "cuEventSynchronize");
+      if (!iree_status_is_ok(status)) break;
+    }
+    memcpy(slot_ptr, source + offset, length);
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuMemcpyAsync(target + offset, (CUdeviceptr)slot_ptr, length,
+                      staging_buffer->stream),
+        "cuMemcpyAsync");
+    if (!iree_status_is_ok(status)) break;
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuEventRecord(staging_buffer->slot_events[slot],
+                      staging_buffer->stream),
+        "cuEventRecord");
+    if (!iree_status_is_ok(status)) break;
+    offset += length;
+  }
+  return status;
+}
+
+// Downloads |data_length| bytes from |source| to |target| by issuing the device
+// copy of each chunk before draining the previously copied chunk on the host.
+static iree_status_t iree_hal_cuda_staging_buffer_download(
+    iree_hal_cuda_staging_buffer_t* staging_buffer, CUdeviceptr source,
+    uint8_t* target, iree_device_size_t data_length) {
+  iree_hal_cuda_dynamic_symbols_t* syms = staging_buffer->context->syms;
+  iree_host_size_t slot_size =
+      staging_buffer->capacity / IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT;
+  iree_status_t status = iree_ok_status();
+  iree_device_size_t offset = 0;
+  // The chunk copied into a slot but not yet drained to |target|, if any.
+  bool has_pending = false;
+  iree_host_size_t pending_slot = 0;
+  iree_device_size_t pending_offset = 0;
+  iree_host_size_t pending_length = 0;
+  for (iree_host_size_t i = 0; has_pending || offset < data_length; ++i) {
+    iree_host_size_t slot = i % IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT;
+    iree_host_size_t length = 0;
+    if (offset < data_length) {
+      length = (iree_host_size_t)iree_min(slot_size, data_length - offset);
+      uint8_t* slot_ptr = staging_buffer->host_ptr + slot * slot_size;
+      status = CU_RESULT_TO_STATUS(
+          syms,
+          cuMemcpyAsync((CUdeviceptr)slot_ptr, source + offset, length,
+                        staging_buffer->stream),
+          "cuMemcpyAsync");
+      if (!iree_status_is_ok(status)) break;
+      status = CU_RESULT_TO_STATUS(
+          syms,
+          cuEventRecord(staging_buffer->slot_events[slot],
+                        staging_buffer->stream),
+          "cuEventRecord");
+      if (!iree_status_is_ok(status)) break;
+    }
+    if (has_pending) {
+      status = CU_RESULT_TO_STATUS(
+          syms, cuEventSynchronize(staging_buffer->slot_events[pending_slot]),
+          "cuEventSynchronize");
+      if (!iree_status_is_ok(status)) break;
+      memcpy(target + pending_offset,
+             staging_buffer->host_ptr + pending_slot * slot_size,
+             pending_length);
+    }
+    has_pending = length > 0;
+    pending_slot = slot;
+    pending_offset = offset;
+    pending_length = length;
+    offset += length;
+  }
+  return status;
+}
+
+iree_status_t iree_hal_cuda_staging_buffer_transfer(
+    iree_hal_cuda_staging_buffer_t* staging_buffer,
+    iree_hal_transfer_buffer_t source, iree_device_size_t source_offset,
+    iree_hal_transfer_buffer_t target, iree_device_size_t target_offset,
+    iree_device_size_t data_length) {
+  if (data_length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)data_length);
+  iree_hal_cuda_dynamic_symbols_t* syms = staging_buffer->context->syms;
+
+  iree_slim_mutex_lock(&staging_buffer->mutex);
+  iree_status_t status =
+      iree_hal_cuda_staging_buffer_ensure_initialized(staging_buffer);
+  if (iree_status_is_ok(status)) {
+    if (!source.device_buffer && !target.device_buffer) {
+      memcpy((uint8_t*)target.host_buffer.data + target_offset,
+             (const uint8_t*)source.host_buffer.data + source_offset,
+             (iree_host_size_t)data_length);
+    } else if (source.device_buffer && target.device_buffer) {
+      status = CU_RESULT_TO_STATUS(
+          syms,
+          cuMemcpyAsync(iree_hal_cuda_staging_buffer_device_pointer(
+                            target.device_buffer, target_offset),
+                        iree_hal_cuda_staging_buffer_device_pointer(
+                            source.device_buffer, source_offset),
+                        data_length, staging_buffer->stream),
+          "cuMemcpyAsync");
+    } else if (!source.device_buffer) {
+      status = iree_hal_cuda_staging_buffer_upload(
+          staging_buffer,
+          (const uint8_t*)source.host_buffer.data + source_offset,
+          iree_hal_cuda_staging_buffer_device_pointer(target.device_buffer,
+                                                      target_offset),
+          data_length);
+    } else {
+      status = iree_hal_cuda_staging_buffer_download(
+          staging_buffer,
+          iree_hal_cuda_staging_buffer_device_pointer(source.device_buffer,
+                                                      source_offset),
+          (uint8_t*)target.host_buffer.data + target_offset, data_length);
+    }
+  }
+  if (staging_buffer->stream) {
+    // Always drain the stream so that no copies referencing the slots remain
+    // in flight, even if issuing a later copy failed.
+    status = iree_status_join(
+        status, CU_RESULT_TO_STATUS(
+                    syms, cuStreamSynchronize(staging_buffer->stream),
+                    "cuStreamSynchronize"));
+  }
+  iree_slim_mutex_unlock(&staging_buffer->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
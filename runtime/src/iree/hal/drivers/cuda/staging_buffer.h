@@ -0,0 +1,70 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_STAGING_BUFFER_H_
+#define IREE_HAL_DRIVERS_CUDA_STAGING_BUFFER_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Number of slots the staging buffer is split into. Transfers alternate
+// between slots so that host copies into/out of one slot overlap with the
+// device copy of the other.
+#define IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT 2
+
+// A persistent pinned host staging buffer and copy stream used to transfer
+// between host memory and device-local buffers.
+//
+// Host memory passed to transfers is usually pageable and CUDA copies from it
+// are synchronous and slow. Staging through pinned memory allows the copies to
+// be issued asynchronously on a dedicated stream while the host fills or
+// drains the other slot. The pinned memory and stream are created on first use
+// and reused by all subsequent transfers.
+typedef struct iree_hal_cuda_staging_buffer_t {
+  iree_hal_cuda_context_wrapper_t* context;
+  // Total capacity of the pinned allocation split across all slots.
+  iree_host_size_t capacity;
+  // Guards all fields below; only one transfer is in flight at a time.
+  iree_slim_mutex_t mutex;
+  // Stream used for staging copies. Created on first use.
+  CUstream stream;
+  // Pinned host allocation of |capacity| bytes. Allocated on first use.
+  uint8_t* host_ptr;
+  // Events recorded after the last copy using each slot.
+  CUevent slot_events[IREE_HAL_CUDA_STAGING_BUFFER_SLOT_COUNT];
+} iree_hal_cuda_staging_buffer_t;
+
+// Initializes |out_staging_buffer| with a total |capacity| in bytes. No CUDA
+// resources are created until the first transfer.
+void iree_hal_cuda_staging_buffer_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_host_size_t capacity,
+    iree_hal_cuda_staging_buffer_t* out_staging_buffer);
+
+// Deinitializes |staging_buffer| and releases its CUDA resources.
+void iree_hal_cuda_staging_buffer_deinitialize(
+    iree_hal_cuda_staging_buffer_t* staging_buffer);
+
+// Transfers |data_length| bytes from |source| to |target| and returns after
+// the transfer has completed. Either side may be host memory or a CUDA buffer.
+// Host memory is staged through the pinned buffer in slot-sized chunks.
+iree_status_t iree_hal_cuda_staging_buffer_transfer(
+    iree_hal_cuda_staging_buffer_t* staging_buffer,
+    iree_hal_transfer_buffer_t source, iree_device_size_t source_offset,
+    iree_hal_transfer_buffer_t target, iree_device_size_t target_offset,
+    iree_device_size_t data_length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_STAGING_BUFFER_H_
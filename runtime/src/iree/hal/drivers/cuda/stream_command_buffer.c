@@ -9,23 +9,41 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_event.h"
+#include "iree/hal/drivers/cuda/library_call.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 #include "iree/hal/utils/collective_batch.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 #define IREE_HAL_CUDA_MAX_BINDING_COUNT 64
 // Kernel arguments contains binding and push constants.
 #define IREE_HAL_CUDA_MAX_KERNEL_ARG 128
 
+// An event acquired from the event pool and released on destroy.
+typedef struct iree_hal_cuda_stream_command_buffer_event_t {
+  struct iree_hal_cuda_stream_command_buffer_event_t* next;
+  CUevent event;
+} iree_hal_cuda_stream_command_buffer_event_t;
+
 typedef struct {
   iree_hal_command_buffer_t base;
   iree_hal_cuda_context_wrapper_t* context;
   iree_hal_cuda_tracing_context_t* tracing_context;
   CUstream stream;
 
+  // Optional stream collectives are issued against to overlap with |stream|.
+  CUstream collective_stream;
+  // Pool of events used to order |stream| and |collective_stream|.
+  iree_hal_cuda_event_pool_t* event_pool;
+  // Events acquired from |event_pool| that are released on destroy.
+  iree_hal_cuda_stream_command_buffer_event_t* event_list_head;
+  // Recorded on |collective_stream| after the last issued collective batch if
+  // |stream| has not yet waited on it.
+  CUevent pending_collective_event;
+
   // Maintains a reference to all resources used within the command buffer.
   // Reset on each begin.
   iree_hal_resource_set_t* resource_set;
@@ -61,10 +79,12 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
+    CUstream collective_stream, iree_hal_cuda_event_pool_t* event_pool,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(!collective_stream || event_pool);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
@@ -88,6 +108,8 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     command_buffer->context = context;
     command_buffer->tracing_context = tracing_context;
     command_buffer->stream = stream;
+    command_buffer->collective_stream = collective_stream;
+    command_buffer->event_pool = event_pool;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     for (size_t i = 0; i < IREE_HAL_CUDA_MAX_KERNEL_ARG; i++) {
       command_buffer->current_descriptor[i] = &command_buffer->device_ptrs[i];
@@ -114,6 +136,12 @@ static void iree_hal_cuda_stream_command_buffer_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_collective_batch_deinitialize(&command_buffer->collective_batch);
+  for (iree_hal_cuda_stream_command_buffer_event_t* entry =
+           command_buffer->event_list_head;
+       entry != NULL; entry = entry->next) {
+    iree_hal_cuda_event_pool_release(command_buffer->event_pool, entry->event);
+  }
+  command_buffer->event_list_head = NULL;
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_allocator_free(command_buffer->context->host_allocator, command_buffer);
@@ -136,6 +164,70 @@ static void* iree_hal_cuda_stream_command_buffer_dyn_cast(
   return NULL;
 }
 
+// Acquires an event from the pool that is retained until destruction.
+static iree_status_t iree_hal_cuda_stream_command_buffer_acquire_event(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer, CUevent* out_event) {
+  iree_hal_cuda_stream_command_buffer_event_t* entry = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*entry), (void**)&entry));
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_event_pool_acquire(
+      command_buffer->event_pool, &entry->event));
+  entry->next = command_buffer->event_list_head;
+  command_buffer->event_list_head = entry;
+  *out_event = entry->event;
+  return iree_ok_status();
+}
+
+// Makes |stream| wait for any collectives issued against |collective_stream|.
+// Must be called before any barrier or event signal so that commands ordered
+// after it observe the results of the collectives.
+static iree_status_t iree_hal_cuda_stream_command_buffer_join_collectives(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer) {
+  if (IREE_LIKELY(!command_buffer->pending_collective_event)) {
+    return iree_ok_status();
+  }
+  CUDA_RETURN_IF_ERROR(
+      command_buffer->context->syms,
+      cuStreamWaitEvent(command_buffer->stream,
+                        command_buffer->pending_collective_event, 0),
+      "cuStreamWaitEvent");
+  command_buffer->pending_collective_event = NULL;
+  return iree_ok_status();
+}
+
+// Issues |batch| against the collective stream after all work previously
+// issued to the command buffer stream. Commands issued to the command buffer
+// stream after this may execute concurrently with the collectives until
+// joined with iree_hal_cuda_stream_command_buffer_join_collectives.
+static iree_status_t iree_hal_cuda_stream_command_buffer_issue_collectives(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer) {
+  iree_hal_cuda_dynamic_symbols_t* syms = command_buffer->context->syms;
+  CUevent ready_event = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_acquire_event(
+      command_buffer, &ready_event));
+  CUDA_RETURN_IF_ERROR(syms, cuEventRecord(ready_event, command_buffer->stream),
+                       "cuEventRecord");
+  CUDA_RETURN_IF_ERROR(
+      syms,
+      cuStreamWaitEvent(command_buffer->collective_stream, ready_event, 0),
+      "cuStreamWaitEvent");
+
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_nccl_submit_batch(
+      command_buffer->context, command_buffer->tracing_context,
+      &command_buffer->collective_batch, command_buffer->collective_stream));
+
+  // Collectives are serialized on the collective stream so only the most
+  // recently issued batch needs to be joined.
+  CUevent done_event = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_acquire_event(
+      command_buffer, &done_event));
+  CUDA_RETURN_IF_ERROR(
+      syms, cuEventRecord(done_event, command_buffer->collective_stream),
+      "cuEventRecord");
+  command_buffer->pending_collective_event = done_event;
+  return iree_ok_status();
+}
+
 // Flushes any pending batched collective operations.
 // Must be called before any other non-collective nodes are added to the graph
 // or a barrier is encountered.
@@ -149,9 +241,15 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_flush_collectives(
     return iree_ok_status();
   }
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_status_t status = iree_hal_cuda_nccl_submit_batch(
-      command_buffer->context, command_buffer->tracing_context,
-      &command_buffer->collective_batch, command_buffer->stream);
+  iree_status_t status = iree_ok_status();
+  if (command_buffer->collective_stream) {
+    status =
+        iree_hal_cuda_stream_command_buffer_issue_collectives(command_buffer);
+  } else {
+    status = iree_hal_cuda_nccl_submit_batch(
+        command_buffer->context, command_buffer->tracing_context,
+        &command_buffer->collective_batch, command_buffer->stream);
+  }
   iree_hal_collective_batch_reset(&command_buffer->collective_batch);
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -179,6 +277,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_end(
 
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_collectives(command_buffer));
 
   IREE_CUDA_TRACE_ZONE_END(command_buffer->tracing_context,
                            command_buffer->stream);
@@ -228,6 +328,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_execution_barrier(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_collectives(command_buffer));
   // TODO(jinchen62): implement CUDA barrier
   return iree_ok_status();
 }
@@ -239,6 +341,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_signal_event(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_collectives(command_buffer));
   // TODO(jinchen62): implement CUDA barrier
   return iree_ok_status();
 }
@@ -506,14 +610,21 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
         command_buffer->push_constant[i];
   }
 
-  CUDA_RETURN_IF_ERROR(
-      command_buffer->context->syms,
-      cuLaunchKernel(kernel_params.function, workgroup_x, workgroup_y,
-                     workgroup_z, kernel_params.block_size[0],
-                     kernel_params.block_size[1], kernel_params.block_size[2],
-                     kernel_params.shared_memory_size, command_buffer->stream,
-                     command_buffer->current_descriptor, NULL),
-      "cuLaunchKernel");
+  if (kernel_params.library_call) {
+    // Library calls ignore the workgroup count and size the work themselves.
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_library_call_issue(
+        command_buffer->context, kernel_params.library_call,
+        command_buffer->stream, command_buffer->current_descriptor));
+  } else {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuLaunchKernel(kernel_params.function, workgroup_x, workgroup_y,
+                       workgroup_z, kernel_params.block_size[0],
+                       kernel_params.block_size[1], kernel_params.block_size[2],
+                       kernel_params.shared_memory_size, command_buffer->stream,
+                       command_buffer->current_descriptor, NULL),
+        "cuLaunchKernel");
+  }
 
   IREE_CUDA_TRACE_ZONE_END(command_buffer->tracing_context,
                            command_buffer->stream);
@@ -534,10 +645,37 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers with deferred command
-  // buffers or graphs. We likely just want to switch to graphs.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+  iree_hal_cuda_stream_command_buffer_t* command_buffer =
+      iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
+
+  // Streams have no native nesting; deferred command buffers (as created in
+  // stream mode) are replayed directly into the parent stream with the binding
+  // table resolving their indirect bindings.
+  if (!iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "only deferred command buffers can be executed from CUDA streams");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &base_commands));
+
+  // Nested commands set their own descriptor and push constant state and the
+  // parent state must be preserved across them.
+  CUdeviceptr* parent_device_ptrs[IREE_ARRAYSIZE(command_buffer->device_ptrs)];
+  int32_t parent_push_constants[IREE_ARRAYSIZE(command_buffer->push_constant)];
+  memcpy(parent_device_ptrs, command_buffer->device_ptrs,
+         sizeof(parent_device_ptrs));
+  memcpy(parent_push_constants, command_buffer->push_constant,
+         sizeof(parent_push_constants));
+
+  iree_status_t status = iree_hal_deferred_command_buffer_apply_inline(
+      base_commands, base_command_buffer, binding_table);
+
+  memcpy(command_buffer->device_ptrs, parent_device_ptrs,
+         sizeof(parent_device_ptrs));
+  memcpy(command_buffer->push_constant, parent_push_constants,
+         sizeof(parent_push_constants));
+  return status;
 }
 
 static const iree_hal_command_buffer_vtable_t
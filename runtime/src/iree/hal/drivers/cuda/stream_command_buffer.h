@@ -12,6 +12,7 @@
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 
 #ifdef __cplusplus
@@ -29,12 +30,20 @@ extern "C" {
 // perform inline execution. When replaying the scratch data required for things
 // like buffer updates is retained by the source deferred command buffer and as
 // such the |block_pool| and can be NULL to avoid a double copy.
+//
+// If |collective_stream| is non-NULL collective operations are issued against
+// it instead of |stream| so that they overlap with commands recorded after
+// them. |stream| waits for the collectives to complete at the next barrier,
+// event signal, or the end of the command buffer. Events used to order the
+// streams are acquired from |event_pool| and released when the command buffer
+// is destroyed.
 iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
     iree_hal_cuda_tracing_context_t* tracing_context,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
+    CUstream collective_stream, iree_hal_cuda_event_pool_t* event_pool,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -220,8 +220,9 @@ void iree_hal_cuda_tracing_context_collect(
   IREE_TRACE_ZONE_END(z0);
 }
 
-static uint16_t iree_hal_cuda_tracing_context_insert_query(
-    iree_hal_cuda_tracing_context_t* context, CUstream stream) {
+// Reserves the next event in the pool for a query and returns its ID.
+static uint16_t iree_hal_cuda_tracing_context_reserve_query(
+    iree_hal_cuda_tracing_context_t* context) {
   // Allocate an event from the pool for use by the query.
   uint32_t query_id = context->query_head;
   context->query_head = (context->query_head + 1) % context->query_capacity;
@@ -234,9 +235,14 @@ static uint16_t iree_hal_cuda_tracing_context_insert_query(
   // For now we just allow the overlap and tracing results will be inconsistent.
   IREE_ASSERT_NE(context->query_head, context->query_tail);
 
+  return (uint16_t)query_id;
+}
+
+static uint16_t iree_hal_cuda_tracing_context_insert_query(
+    iree_hal_cuda_tracing_context_t* context, CUstream stream) {
+  uint16_t query_id = iree_hal_cuda_tracing_context_reserve_query(context);
   CUevent event = context->event_pool[query_id];
   CUDA_IGNORE_ERROR(context->cuda_context->syms, cuEventRecord(event, stream));
-
   return query_id;
 }
 
@@ -275,6 +281,26 @@ void iree_hal_cuda_tracing_zone_end_impl(
   iree_tracing_gpu_zone_end(context->id, query_id);
 }
 
+CUevent iree_hal_cuda_tracing_graph_zone_begin_external_impl(
+    iree_hal_cuda_tracing_context_t* context, const char* file_name,
+    size_t file_name_length, uint32_t line, const char* function_name,
+    size_t function_name_length, const char* name, size_t name_length) {
+  if (!context) return NULL;
+  uint16_t query_id = iree_hal_cuda_tracing_context_reserve_query(context);
+  iree_tracing_gpu_zone_begin_external(context->id, query_id, file_name,
+                                       file_name_length, line, function_name,
+                                       function_name_length, name, name_length);
+  return context->event_pool[query_id];
+}
+
+CUevent iree_hal_cuda_tracing_graph_zone_end_impl(
+    iree_hal_cuda_tracing_context_t* context) {
+  if (!context) return NULL;
+  uint16_t query_id = iree_hal_cuda_tracing_context_reserve_query(context);
+  iree_tracing_gpu_zone_end(context->id, query_id);
+  return context->event_pool[query_id];
+}
+
 #else
 
 iree_status_t iree_hal_cuda_tracing_context_allocate(
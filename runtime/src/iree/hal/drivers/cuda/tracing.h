@@ -34,10 +34,10 @@ extern "C" {
 // NOTE: timestamps can have non-trivial side-effecting behavior and may
 // introduce serialization in graph execution.
 //
-// TODO(benvanik): expose CUevent reservation separate from recording. For
-// graphs we will need to insert the events but in order to reuse the graphs
-// we'll need to reserve and patch new events each graph launch. For now we
-// don't instrument graphs.
+// Graphs record events with event record nodes instead of on the stream. As
+// graphs may be launched many times the IREE_CUDA_TRACE_GRAPH_ZONE_* macros
+// only reserve the events for a zone and return them so that the event record
+// nodes of the graph exec can be patched to use them prior to each launch.
 //
 // Thread-compatible: external synchronization is required if using from
 // multiple threads (same as with CUstream itself).
@@ -81,6 +81,19 @@ void iree_hal_cuda_tracing_zone_begin_external_impl(
 void iree_hal_cuda_tracing_zone_end_impl(
     iree_hal_cuda_tracing_context_t* context, CUstream stream);
 
+// Begins an external zone like iree_hal_cuda_tracing_zone_begin_external_impl
+// but instead of recording the begin event on a stream returns it. The caller
+// must record the event (such as from a graph event record node) in the order
+// it was reserved relative to all other zones of the context.
+CUevent iree_hal_cuda_tracing_graph_zone_begin_external_impl(
+    iree_hal_cuda_tracing_context_t* context, const char* file_name,
+    size_t file_name_length, uint32_t line, const char* function_name,
+    size_t function_name_length, const char* name, size_t name_length);
+
+// Ends the current zone and returns the event the caller must record.
+CUevent iree_hal_cuda_tracing_graph_zone_end_impl(
+    iree_hal_cuda_tracing_context_t* context);
+
 // Begins a new zone with the parent function name.
 #define IREE_CUDA_TRACE_ZONE_BEGIN(context, stream)                           \
   static const iree_tracing_location_t TracyConcat(                           \
@@ -103,6 +116,20 @@ void iree_hal_cuda_tracing_zone_end_impl(
 #define IREE_CUDA_TRACE_ZONE_END(context, stream) \
   iree_hal_cuda_tracing_zone_end_impl(context, stream)
 
+// Begins an externally defined zone whose begin event is recorded by a graph.
+// Returns the CUevent that must be recorded or NULL if tracing is disabled.
+#define IREE_CUDA_TRACE_GRAPH_ZONE_BEGIN_EXTERNAL(               \
+    context, file_name, file_name_length, line, function_name,   \
+    function_name_length, name, name_length)                     \
+  iree_hal_cuda_tracing_graph_zone_begin_external_impl(          \
+      context, file_name, file_name_length, line, function_name, \
+      function_name_length, name, name_length)
+
+// Ends the current zone with an event recorded by a graph.
+// Returns the CUevent that must be recorded or NULL if tracing is disabled.
+#define IREE_CUDA_TRACE_GRAPH_ZONE_END(context) \
+  iree_hal_cuda_tracing_graph_zone_end_impl(context)
+
 #else
 
 #define IREE_CUDA_TRACE_ZONE_BEGIN(context, stream)
@@ -110,6 +137,11 @@ void iree_hal_cuda_tracing_zone_end_impl(
     context, stream, file_name, file_name_length, line, function_name, \
     function_name_length, name, name_length)
 #define IREE_CUDA_TRACE_ZONE_END(context, stream)
+#define IREE_CUDA_TRACE_GRAPH_ZONE_BEGIN_EXTERNAL(             \
+    context, file_name, file_name_length, line, function_name, \
+    function_name_length, name, name_length)                   \
+  ((CUevent)NULL)
+#define IREE_CUDA_TRACE_GRAPH_ZONE_END(context) ((CUevent)NULL)
 
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
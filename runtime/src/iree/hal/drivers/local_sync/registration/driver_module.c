@@ -10,9 +10,16 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/base/internal/large_page_allocator.h"
 #include "iree/hal/drivers/local_sync/sync_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 
+IREE_FLAG(
+    bool, local_sync_large_page_buffers, false,
+    "Backs large device buffers with transparent huge pages where supported.\n"
+    "Reduces TLB misses when streaming through buffers of many megabytes.\n");
+
 static iree_status_t iree_hal_local_sync_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -46,8 +53,11 @@ static iree_status_t iree_hal_local_sync_driver_factory_try_create(
 
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
+    iree_allocator_t data_allocator = FLAG_local_sync_large_page_buffers
+                                          ? iree_allocator_large_page()
+                                          : host_allocator;
     status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
+                                            data_allocator, host_allocator,
                                             &device_allocator);
   }
 
@@ -17,8 +17,10 @@
 #include "iree/hal/drivers/local_sync/sync_semaphore.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/inline_command_buffer.h"
+#include "iree/hal/local/local_channel.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/profiling.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 
@@ -200,8 +202,9 @@ static iree_status_t iree_hal_sync_device_query_i64(
 static iree_status_t iree_hal_sync_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_channel_create(params, device->host_allocator,
+                                       out_channel);
 }
 
 static iree_status_t iree_hal_sync_device_create_command_buffer(
@@ -325,10 +328,13 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
   for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
     iree_hal_command_buffer_t* command_buffer = command_buffers[i];
     if (iree_hal_deferred_command_buffer_isa(command_buffer)) {
+      // The inline command buffer only lives for this one replay and is always
+      // one-shot even if the deferred command buffer is reusable.
       iree_hal_command_buffer_t* inline_command_buffer = NULL;
       IREE_RETURN_IF_ERROR(iree_hal_inline_command_buffer_initialize(
           (iree_hal_device_t*)device,
           iree_hal_command_buffer_mode(command_buffer) |
+              IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
               IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
           IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
           /*binding_capacity=*/0, device->host_allocator, storage,
@@ -389,23 +395,21 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
 }
 
 static iree_status_t iree_hal_sync_device_profiling_begin(
-    iree_hal_device_t* device,
+    iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
+  // Dispatch counters and timestamps are captured by the shared local
+  // executable profiling. Other modes are unimplemented (and that's ok).
+  if (options->mode & (IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+                       IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS)) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_profiling_begin(
+        base_device, options, iree_hal_device_host_allocator(base_device)));
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_sync_device_profiling_end(
-    iree_hal_device_t* device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+    iree_hal_device_t* base_device) {
+  return iree_hal_local_profiling_end(base_device);
 }
 
 static const iree_hal_device_vtable_t iree_hal_sync_device_vtable = {
@@ -429,6 +433,7 @@ static const iree_hal_device_vtable_t iree_hal_sync_device_vtable = {
     .transfer_range = iree_hal_device_transfer_mappable_range,
     .queue_alloca = iree_hal_sync_device_queue_alloca,
     .queue_dealloca = iree_hal_sync_device_queue_dealloca,
+    .queue_read = iree_hal_device_queue_read_streaming,
     .queue_execute = iree_hal_sync_device_queue_execute,
     .queue_flush = iree_hal_sync_device_queue_flush,
     .wait_semaphores = iree_hal_sync_device_wait_semaphores,
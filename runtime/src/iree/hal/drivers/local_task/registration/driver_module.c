@@ -10,10 +10,63 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/base/internal/large_page_allocator.h"
 #include "iree/hal/drivers/local_task/task_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/task/api.h"
 
+IREE_FLAG(
+    bool, local_task_large_page_buffers, false,
+    "Backs large device buffers with transparent huge pages where supported.\n"
+    "Reduces TLB misses when streaming through buffers of many megabytes.\n");
+
+IREE_FLAG(
+    int32_t, local_task_dispatch_ring_capacity, 0,
+    "Number of recently executed dispatches recorded by each device for\n"
+    "inspection at runtime. 0 disables dispatch recording.\n");
+IREE_FLAG(
+    int32_t, local_task_dispatch_ring_sample_interval, 1,
+    "Records one of every N dispatches when dispatch recording is enabled.\n");
+
+IREE_FLAG(
+    string, local_task_queue_priorities, "",
+    "Comma-separated scheduling priority of each device queue in order.\n"
+    "One of 'low', 'normal' or 'high'; unspecified queues are 'normal'.\n"
+    "Dispatches on lower-priority queues yield to higher-priority work at\n"
+    "tile chunk boundaries.\n");
+
+// Parses --local_task_queue_priorities= into |out_params|.
+static iree_status_t iree_hal_local_task_parse_queue_priorities(
+    iree_string_view_t value, iree_hal_task_device_params_t* out_params) {
+  iree_host_size_t queue_index = 0;
+  while (!iree_string_view_is_empty(value)) {
+    iree_string_view_t priority_str = iree_string_view_empty();
+    iree_string_view_split(value, ',', &priority_str, &value);
+    priority_str = iree_string_view_trim(priority_str);
+    if (queue_index >= IREE_ARRAYSIZE(out_params->queue_priorities)) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "at most %d queue priorities may be specified",
+                              IREE_HAL_TASK_DEVICE_MAX_QUEUE_PRIORITY_COUNT);
+    }
+    iree_task_priority_t priority = IREE_TASK_PRIORITY_NORMAL;
+    if (iree_string_view_equal(priority_str, IREE_SV("low"))) {
+      priority = IREE_TASK_PRIORITY_LOW;
+    } else if (iree_string_view_equal(priority_str, IREE_SV("normal"))) {
+      priority = IREE_TASK_PRIORITY_NORMAL;
+    } else if (iree_string_view_equal(priority_str, IREE_SV("high"))) {
+      priority = IREE_TASK_PRIORITY_HIGH;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unknown queue priority '%.*s'; expected one of "
+                              "'low', 'normal' or 'high'",
+                              (int)priority_str.size, priority_str.data);
+    }
+    out_params->queue_priorities[queue_index++] = priority;
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -40,6 +93,19 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
 
   iree_hal_task_device_params_t default_params;
   iree_hal_task_device_params_initialize(&default_params);
+  if (FLAG_local_task_dispatch_ring_capacity < 0 ||
+      FLAG_local_task_dispatch_ring_sample_interval < 1) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "dispatch ring capacity must be >= 0 and sample interval >= 1");
+  }
+  default_params.dispatch_ring_capacity =
+      (iree_host_size_t)FLAG_local_task_dispatch_ring_capacity;
+  default_params.dispatch_ring_sample_interval =
+      (uint32_t)FLAG_local_task_dispatch_ring_sample_interval;
+  IREE_RETURN_IF_ERROR(iree_hal_local_task_parse_queue_priorities(
+      iree_make_cstring_view(FLAG_local_task_queue_priorities),
+      &default_params));
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
@@ -61,8 +127,11 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   // TODO(benvanik): allow this to be injected to share across drivers.
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
+    iree_allocator_t data_allocator = FLAG_local_task_large_page_buffers
+                                          ? iree_allocator_large_page()
+                                          : host_allocator;
     status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
+                                            data_allocator, host_allocator,
                                             &device_allocator);
   }
 
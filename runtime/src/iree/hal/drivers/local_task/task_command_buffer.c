@@ -12,21 +12,61 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/local/dispatch_ring.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_channel.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/profiling.h"
+#include "iree/hal/utils/collective_batch.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/list.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
+#if defined(IREE_ARCH_X86_64)
+#include <emmintrin.h>
+#endif  // IREE_ARCH_X86_64
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+// A task recorded into a command buffer. Only tracked for reusable command
+// buffers so that the template can be captured when recording ends.
+typedef struct iree_hal_task_command_buffer_recorded_task_t {
+  struct iree_hal_task_command_buffer_recorded_task_t* next;
+  iree_task_t* task;
+} iree_hal_task_command_buffer_recorded_task_t;
+
+// Initial state of a task in a reusable command buffer template. Executing a
+// task consumes its dependency count, completion task link, and some flags and
+// these are restored from the snapshot prior to each issue.
+typedef struct iree_hal_task_command_buffer_task_snapshot_t {
+  iree_task_t* task;
+  iree_task_t* completion_task;
+  int32_t pending_dependency_count;
+  iree_task_flags_t flags;
+  // Only valid for IREE_TASK_TYPE_DISPATCH tasks: issuing an indirect dispatch
+  // replaces the workgroup count pointer with the value it references.
+  union {
+    uint32_t value[3];
+    const uint32_t* ptr;
+  } workgroup_count;
+} iree_hal_task_command_buffer_task_snapshot_t;
+
+// Task joining all leaf tasks of a reusable command buffer template.
+// Its cleanup marks the command buffer as available for reissue.
+typedef struct iree_hal_task_command_buffer_replay_retire_t {
+  iree_task_nop_t task;
+  struct iree_hal_task_command_buffer_t* command_buffer;
+} iree_hal_task_command_buffer_replay_retire_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
@@ -41,6 +81,9 @@ typedef struct iree_hal_task_command_buffer_t {
 
   iree_task_scope_t* scope;
 
+  // Optional device ring that sampled dispatches are recorded into.
+  iree_hal_local_dispatch_ring_t* dispatch_ring;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -60,6 +103,26 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // Immutable task DAG template used by reusable (non-ONE_SHOT) command
+  // buffers. Instead of re-recording each submission the template is reset
+  // to its recorded state and the root tasks are enqueued again. Executions of
+  // the same command buffer may not overlap as the tasks are reused in-place.
+  struct {
+    // Snapshots of all tasks in the DAG including the retire task.
+    iree_host_size_t task_count;
+    iree_hal_task_command_buffer_task_snapshot_t* tasks;
+
+    // Tasks at the root of the DAG that are enqueued on each issue.
+    iree_host_size_t root_task_count;
+    iree_task_t** root_tasks;
+
+    // Joins all leaves and is chained to the submission retire task.
+    iree_hal_task_command_buffer_replay_retire_t* retire_task;
+
+    // Nonzero while an issued execution of the template is outstanding.
+    iree_atomic_int32_t in_flight;
+  } replay;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
@@ -76,9 +139,17 @@ typedef struct iree_hal_task_command_buffer_t {
     // allocate storage for the task list without needing to walk the list.
     iree_host_size_t open_task_count;
 
+    // All tasks recorded in reverse order when the command buffer is reusable.
+    iree_hal_task_command_buffer_recorded_task_t* recorded_tasks;
+    iree_host_size_t recorded_task_count;
+
     // All execution tasks emitted that must execute after |open_barrier|.
     iree_task_list_t open_tasks;
 
+    // Collectives recorded since the last barrier. They are flushed as a
+    // single task executing them in order when the barrier scope closes.
+    iree_hal_collective_batch_t collective_batch;
+
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
     // represent the fully-translated binding data pointer.
@@ -111,28 +182,19 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_ring_t* dispatch_ring,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
   if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
+    // Task command buffers resolve binding pointers as they are recorded and
+    // indirect bindings are only supported on nested command buffers, which
+    // the device records as deferred command buffers.
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "task command buffers do not support indirect "
+                            "bindings; use a nested command buffer");
   }
 
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -146,14 +208,19 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->dispatch_ring = dispatch_ring;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
+    memset(&command_buffer->replay, 0, sizeof(command_buffer->replay));
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
   }
   if (iree_status_is_ok(status)) {
+    iree_hal_collective_batch_initialize(
+        &command_buffer->arena, command_buffer->resource_set,
+        &command_buffer->state.collective_batch);
     *out_command_buffer = &command_buffer->base;
   } else {
     iree_hal_command_buffer_release(&command_buffer->base);
@@ -170,6 +237,8 @@ static void iree_hal_task_command_buffer_destroy(
   iree_allocator_t host_allocator = command_buffer->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_collective_batch_deinitialize(
+      &command_buffer->state.collective_batch);
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
   iree_task_list_discard(&command_buffer->root_tasks);
   iree_task_list_discard(&command_buffer->leaf_tasks);
@@ -202,11 +271,42 @@ static void* iree_hal_task_command_buffer_dyn_cast(
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
 
+static iree_status_t iree_hal_task_command_buffer_flush_collectives(
+    iree_hal_task_command_buffer_t* command_buffer);
+
+static iree_status_t iree_hal_task_command_buffer_build_replay_template(
+    iree_hal_task_command_buffer_t* command_buffer);
+
+// Returns true if the command buffer may be issued multiple times.
+static bool iree_hal_task_command_buffer_is_reusable(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(command_buffer->base.mode,
+                            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+}
+
+// Tracks |task| as part of the command buffer template if reusable.
+static iree_status_t iree_hal_task_command_buffer_record_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  if (!iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_command_buffer_recorded_task_t* recorded_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*recorded_task),
+                                           (void**)&recorded_task));
+  recorded_task->next = command_buffer->state.recorded_tasks;
+  recorded_task->task = task;
+  command_buffer->state.recorded_tasks = recorded_task;
+  ++command_buffer->state.recorded_task_count;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  if (!iree_task_list_is_empty(&command_buffer->root_tasks)) {
+  if (!iree_task_list_is_empty(&command_buffer->root_tasks) ||
+      command_buffer->replay.root_task_count > 0) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                             "command buffer cannot be re-recorded");
   }
@@ -230,6 +330,111 @@ static iree_status_t iree_hal_task_command_buffer_end(
                         &command_buffer->root_tasks);
   }
 
+  // Capture the recorded DAG as an immutable template we can reissue.
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_build_replay_template(command_buffer));
+  }
+
+  return iree_ok_status();
+}
+
+// Cleanup for the replay retire task that marks the template as available.
+// Called both when the execution retires successfully and when it is
+// discarded due to failure.
+static void iree_hal_task_command_buffer_replay_retire_cleanup(
+    iree_task_t* task, iree_status_code_t status_code) {
+  iree_hal_task_command_buffer_replay_retire_t* retire_task =
+      (iree_hal_task_command_buffer_replay_retire_t*)task;
+  iree_atomic_store_int32(&retire_task->command_buffer->replay.in_flight, 0,
+                          iree_memory_order_release);
+}
+
+// Builds the replay template from the tasks recorded in |command_buffer|.
+// All leaf tasks are joined to a NOP retire task and the initial state of every
+// task is snapshotted so that it can be restored on each issue. Ownership of
+// the tasks moves from the root/leaf lists to the template.
+static iree_status_t iree_hal_task_command_buffer_build_replay_template(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  // Empty command buffers are no-ops and need no template.
+  if (iree_task_list_is_empty(&command_buffer->root_tasks)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_task_command_buffer_replay_retire_t* retire_task = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena, sizeof(*retire_task),
+                              (void**)&retire_task));
+  iree_task_nop_initialize(command_buffer->scope, &retire_task->task);
+  iree_task_set_cleanup_fn(&retire_task->task.header,
+                           iree_hal_task_command_buffer_replay_retire_cleanup);
+  retire_task->command_buffer = command_buffer;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_task_command_buffer_record_task(command_buffer,
+                                                   &retire_task->task.header));
+
+  // Join the leaves (or the roots if there is only a single layer).
+  iree_task_list_t* leaf_list =
+      iree_task_list_is_empty(&command_buffer->leaf_tasks)
+          ? &command_buffer->root_tasks
+          : &command_buffer->leaf_tasks;
+  for (iree_task_t* task = leaf_list->head; task != NULL;
+       task = task->next_task) {
+    iree_task_set_completion_task(task, &retire_task->task.header);
+  }
+
+  iree_host_size_t root_task_count =
+      iree_task_list_calculate_size(&command_buffer->root_tasks);
+  iree_task_t** root_tasks = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena,
+                              root_task_count * sizeof(*root_tasks),
+                              (void**)&root_tasks));
+  iree_host_size_t root_index = 0;
+  for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
+       task = task->next_task) {
+    root_tasks[root_index++] = task;
+  }
+
+  iree_host_size_t task_count = command_buffer->state.recorded_task_count;
+  iree_hal_task_command_buffer_task_snapshot_t* snapshots = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena,
+                              task_count * sizeof(*snapshots),
+                              (void**)&snapshots));
+  iree_hal_task_command_buffer_recorded_task_t* recorded_task =
+      command_buffer->state.recorded_tasks;
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    iree_task_t* task = recorded_task->task;
+    iree_hal_task_command_buffer_task_snapshot_t* snapshot = &snapshots[i];
+    snapshot->task = task;
+    snapshot->completion_task = task->completion_task;
+    snapshot->pending_dependency_count = iree_atomic_load_int32(
+        &task->pending_dependency_count, iree_memory_order_relaxed);
+    snapshot->flags = task->flags;
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      memcpy(&snapshot->workgroup_count,
+             &((iree_task_dispatch_t*)task)->workgroup_count,
+             sizeof(snapshot->workgroup_count));
+    }
+    recorded_task = recorded_task->next;
+  }
+
+  command_buffer->replay.task_count = task_count;
+  command_buffer->replay.tasks = snapshots;
+  command_buffer->replay.root_task_count = root_task_count;
+  command_buffer->replay.root_tasks = root_tasks;
+  command_buffer->replay.retire_task = retire_task;
+  command_buffer->state.recorded_tasks = NULL;
+  command_buffer->state.recorded_task_count = 0;
+
+  // The template now owns the tasks. The intrusive task links will be reused by
+  // the executor when the tasks are issued and the lists must not be walked.
+  iree_task_list_initialize(&command_buffer->root_tasks);
+  iree_task_list_initialize(&command_buffer->leaf_tasks);
+
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
@@ -240,6 +445,10 @@ static iree_status_t iree_hal_task_command_buffer_end(
 // tasks that will be recorded after (if any).
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer) {
+  // Collectives batched in the closing barrier scope execute as part of it.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_flush_collectives(command_buffer));
+
   iree_task_barrier_t* open_barrier = command_buffer->state.open_barrier;
   if (open_barrier != NULL) {
     // There is an open barrier we need to fixup the fork out to all of the open
@@ -304,6 +513,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
                                            sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_record_task(command_buffer, &barrier->header));
 
   // If there were previous tasks then join them to the barrier.
   for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
@@ -336,6 +547,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
 // scope (after state.open_barrier and before the next barrier).
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
     iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_record_task(command_buffer, task));
   if (command_buffer->state.open_barrier == NULL) {
     // If there is no open barrier then we are at the head and going right into
     // the task DAG.
@@ -352,6 +565,64 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+// Resets the replay template of a reusable |command_buffer| and enqueues its
+// root tasks into |pending_submission| such that |retire_task| is notified when
+// the execution completes.
+static iree_status_t iree_hal_task_command_buffer_issue_replay(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (command_buffer->replay.root_task_count == 0) {
+    return iree_ok_status();
+  }
+
+  // The tasks are reused in-place and we can't have two executions in flight.
+  int32_t expected_in_flight = 0;
+  if (!iree_atomic_compare_exchange_strong_int32(
+          &command_buffer->replay.in_flight, &expected_in_flight, 1,
+          iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "reusable command buffer is already executing; executions of the same "
+        "command buffer must be ordered with semaphores");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, command_buffer->replay.task_count);
+
+  // Restore all tasks to their recorded state.
+  for (iree_host_size_t i = 0; i < command_buffer->replay.task_count; ++i) {
+    const iree_hal_task_command_buffer_task_snapshot_t* snapshot =
+        &command_buffer->replay.tasks[i];
+    iree_task_t* task = snapshot->task;
+    task->next_task = NULL;
+    task->completion_task = snapshot->completion_task;
+    task->flags = snapshot->flags;
+    iree_atomic_store_int32(&task->pending_dependency_count,
+                            snapshot->pending_dependency_count,
+                            iree_memory_order_relaxed);
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      memcpy(&((iree_task_dispatch_t*)task)->workgroup_count,
+             &snapshot->workgroup_count, sizeof(snapshot->workgroup_count));
+    }
+  }
+
+  // Chain the template to this particular submission.
+  iree_task_set_completion_task(
+      &command_buffer->replay.retire_task->task.header, retire_task);
+
+  // Enqueue all root tasks that are ready to run immediately. The executor
+  // will publish them with release semantics so the resets above are visible.
+  for (iree_host_size_t i = 0; i < command_buffer->replay.root_task_count;
+       ++i) {
+    iree_task_submission_enqueue(pending_submission,
+                                 command_buffer->replay.root_tasks[i]);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -361,6 +632,11 @@ iree_status_t iree_hal_task_command_buffer_issue(
                                        &iree_hal_task_command_buffer_vtable);
   IREE_ASSERT_TRUE(command_buffer);
 
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_hal_task_command_buffer_issue_replay(
+        command_buffer, retire_task, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
@@ -482,16 +758,89 @@ static iree_status_t iree_hal_task_command_buffer_discard_buffer(
 }
 
 //===----------------------------------------------------------------------===//
-// iree_hal_command_buffer_fill_buffer
+// Bulk transfer utilities
 //===----------------------------------------------------------------------===//
-// NOTE: for large copies we dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; filling a 200KB
-// buffer: maybe not, filling a 200MB buffer: yeah. For now we just do
-// arbitrarily sized chunks.
+// Fills and copies are dispatched as tiles of a fixed slice length so that
+// large transfers are spread across all workers: a single core is not able to
+// saturate memory bandwidth on most systems. Transfers smaller than a slice
+// are a single tile and run on one worker as a plain call would.
+//
+// Transfers larger than the last level cache stream through memory with
+// non-temporal stores: the data written will have been evicted by the time it
+// is read anyway and bypassing the cache avoids both the read-for-ownership of
+// the target lines and evicting the working set of the other workers.
+
+// Length of each tile of fill/copy commands. Must be aligned to the fill
+// pattern length so pick a power of two.
+// TODO(benvanik): make this a configurable setting.
+#define IREE_HAL_CMD_TRANSFER_SLICE_LENGTH (128 * 1024)
+
+// Minimum total fill/copy length that uses non-temporal stores.
+#define IREE_HAL_CMD_NONTEMPORAL_MIN_LENGTH (8 * 1024 * 1024)
+
+#if defined(IREE_ARCH_X86_64)
+#define IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES 1
+#else
+#define IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES 0
+#endif  // IREE_ARCH_X86_64
+
+// Returns the workgroup count used to split |length| bytes into slices.
+static uint32_t iree_hal_cmd_transfer_slice_count(iree_device_size_t length) {
+  iree_device_size_t slice_count =
+      (length + IREE_HAL_CMD_TRANSFER_SLICE_LENGTH - 1) /
+      IREE_HAL_CMD_TRANSFER_SLICE_LENGTH;
+  return (uint32_t)iree_max(1, slice_count);
+}
+
+#if IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+
+// Fills |length| bytes of |target| with the repeating |pattern| bypassing the
+// cache. |pattern_length| must be 1, 2, or 4.
+static void iree_hal_cmd_fill_nontemporal(uint8_t* target,
+                                          iree_host_size_t length,
+                                          const uint8_t* pattern,
+                                          iree_host_size_t pattern_length) {
+  // Unaligned head up to the first 16-byte boundary.
+  iree_host_size_t head_length =
+      iree_min(length, (16 - ((uintptr_t)target & 15)) & 15);
+  iree_host_size_t i = 0;
+  for (; i < head_length; ++i) target[i] = pattern[i % pattern_length];
+  // The vector starts at |head_length| and so must start at that pattern phase.
+  uint8_t vector_bytes[16];
+  for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(vector_bytes); ++j) {
+    vector_bytes[j] = pattern[(head_length + j) % pattern_length];
+  }
+  const __m128i vector = _mm_loadu_si128((const __m128i*)vector_bytes);
+  for (; i + 16 <= length; i += 16) {
+    _mm_stream_si128((__m128i*)(target + i), vector);
+  }
+  for (; i < length; ++i) target[i] = pattern[i % pattern_length];
+  // Non-temporal stores are weakly ordered and must be fenced before the
+  // task completes and dependent tasks read the memory.
+  _mm_sfence();
+}
+
+// Copies |length| bytes from |source| to |target| bypassing the cache.
+static void iree_hal_cmd_copy_nontemporal(uint8_t* target,
+                                          const uint8_t* source,
+                                          iree_host_size_t length) {
+  iree_host_size_t head_length =
+      iree_min(length, (16 - ((uintptr_t)target & 15)) & 15);
+  memcpy(target, source, head_length);
+  iree_host_size_t i = head_length;
+  for (; i + 16 <= length; i += 16) {
+    _mm_stream_si128((__m128i*)(target + i),
+                     _mm_loadu_si128((const __m128i*)(source + i)));
+  }
+  memcpy(target + i, source + i, length - i);
+  _mm_sfence();
+}
 
-// TODO(benvanik): make this a configurable setting. Must be aligned to pattern
-// length so pick a power of two.
-#define IREE_HAL_CMD_FILL_SLICE_LENGTH (128 * 1024)
+#endif  // IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+
+//===----------------------------------------------------------------------===//
+// iree_hal_command_buffer_fill_buffer
+//===----------------------------------------------------------------------===//
 
 typedef struct iree_hal_cmd_fill_buffer_t {
   iree_task_dispatch_t task;
@@ -517,6 +866,24 @@ static iree_status_t iree_hal_cmd_fill_tile(
       iree_min(length_per_slice, remaining_length);
   IREE_TRACE_ZONE_APPEND_VALUE(z0, (uint64_t)slice_length);
 
+#if IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+  if (cmd->length >= IREE_HAL_CMD_NONTEMPORAL_MIN_LENGTH) {
+    iree_hal_buffer_mapping_t target_mapping = {{0}};
+    iree_status_t status = iree_hal_buffer_map_range(
+        cmd->target_buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+        cmd->target_offset + slice_offset, slice_length, &target_mapping);
+    if (iree_status_is_ok(status)) {
+      iree_hal_cmd_fill_nontemporal(target_mapping.contents.data,
+                                    target_mapping.contents.data_length,
+                                    cmd->pattern, cmd->pattern_length);
+      status = iree_hal_buffer_unmap_range(&target_mapping);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+#endif  // IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+
   iree_status_t status = iree_hal_buffer_map_fill(
       cmd->target_buffer, cmd->target_offset + slice_offset, slice_length,
       cmd->pattern, cmd->pattern_length);
@@ -541,12 +908,12 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
-      /*x=*/IREE_HAL_CMD_FILL_SLICE_LENGTH,
+      /*x=*/IREE_HAL_CMD_TRANSFER_SLICE_LENGTH,
       /*y=*/1,
       /*z=*/1,
   };
   const uint32_t workgroup_count[3] = {
-      /*x=*/length / workgroup_size[0] + 1,
+      /*x=*/iree_hal_cmd_transfer_slice_count(length),
       /*y=*/1,
       /*z=*/1,
   };
@@ -623,14 +990,6 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_copy_buffer
 //===----------------------------------------------------------------------===//
-// NOTE: for large copies we dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; copying a 200KB
-// buffer: maybe not, copying a 200MB buffer: yeah. For now we just do
-// arbitrarily sized chunks.
-
-// TODO(benvanik): make this a configurable setting. Must be aligned to pattern
-// length so pick a power of two.
-#define IREE_HAL_CMD_COPY_SLICE_LENGTH (128 * 1024)
 
 typedef struct iree_hal_cmd_copy_buffer_t {
   iree_task_dispatch_t task;
@@ -656,6 +1015,33 @@ static iree_status_t iree_hal_cmd_copy_tile(
       iree_min(length_per_slice, remaining_length);
   IREE_TRACE_ZONE_APPEND_VALUE(z0, (uint64_t)slice_length);
 
+#if IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+  if (cmd->length >= IREE_HAL_CMD_NONTEMPORAL_MIN_LENGTH) {
+    iree_hal_buffer_mapping_t source_mapping = {{0}};
+    iree_hal_buffer_mapping_t target_mapping = {{0}};
+    iree_status_t status = iree_hal_buffer_map_range(
+        cmd->source_buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_READ, cmd->source_offset + slice_offset,
+        slice_length, &source_mapping);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_range(
+          cmd->target_buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+          IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+          cmd->target_offset + slice_offset, slice_length, &target_mapping);
+      if (iree_status_is_ok(status)) {
+        iree_hal_cmd_copy_nontemporal(target_mapping.contents.data,
+                                      source_mapping.contents.data,
+                                      slice_length);
+        status = iree_hal_buffer_unmap_range(&target_mapping);
+      }
+      status = iree_status_join(status,
+                                iree_hal_buffer_unmap_range(&source_mapping));
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+#endif  // IREE_HAL_CMD_HAVE_NONTEMPORAL_STORES
+
   iree_status_t status = iree_hal_buffer_map_copy(
       cmd->source_buffer, cmd->source_offset + slice_offset, cmd->target_buffer,
       cmd->target_offset + slice_offset, slice_length);
@@ -681,12 +1067,12 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
-      /*x=*/IREE_HAL_CMD_COPY_SLICE_LENGTH,
+      /*x=*/IREE_HAL_CMD_TRANSFER_SLICE_LENGTH,
       /*y=*/1,
       /*z=*/1,
   };
   const uint32_t workgroup_count[3] = {
-      /*x=*/length / workgroup_size[0] + 1,
+      /*x=*/iree_hal_cmd_transfer_slice_count(length),
       /*y=*/1,
       /*z=*/1,
   };
@@ -708,31 +1094,68 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
 // iree_hal_command_buffer_collective
 //===----------------------------------------------------------------------===//
 
+typedef struct iree_hal_cmd_collective_batch_t {
+  iree_task_call_t task;
+  iree_host_size_t entry_count;
+  iree_hal_collective_batch_entry_t entries[];
+} iree_hal_cmd_collective_batch_t;
+
+static iree_status_t iree_hal_cmd_collective_batch(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_collective_batch_t* cmd =
+      (const iree_hal_cmd_collective_batch_t*)user_context;
+  return iree_hal_local_channel_execute_batch(cmd->entry_count, cmd->entries);
+}
+
+// Emits a single task executing all collectives batched within the current
+// barrier scope in their recorded order. Collectives block until every rank
+// participates and all ranks must issue them in the same order: if they were
+// separate tasks the executor could run them concurrently in any order and
+// deadlock ranks that picked different ones first.
+static iree_status_t iree_hal_task_command_buffer_flush_collectives(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  iree_hal_collective_batch_t* batch = &command_buffer->state.collective_batch;
+  if (iree_hal_collective_batch_is_empty(batch)) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, batch->count);
+
+  // The batch storage is reused after the reset so the entries are copied.
+  iree_hal_cmd_collective_batch_t* cmd = NULL;
+  const iree_host_size_t total_cmd_size =
+      sizeof(*cmd) + batch->count * sizeof(*cmd->entries);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena, total_cmd_size,
+                              (void**)&cmd));
+  iree_task_call_initialize(
+      command_buffer->scope,
+      iree_task_make_call_closure(iree_hal_cmd_collective_batch, (void*)cmd),
+      &cmd->task);
+  cmd->entry_count = batch->count;
+  memcpy(cmd->entries, batch->entries, batch->count * sizeof(*cmd->entries));
+  iree_hal_collective_batch_reset(batch);
+
+  iree_status_t status = iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_task_command_buffer_collective(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  // The channel can be used as a vtable if we want to inject collective APIs -
-  // the device creation function would set up the channel once and we'll
-  // receive it here each time. When interacting with the task system we want to
-  // get wait handles we can model with iree_task_wait_t.
-  //
-  // An example basic flow:
-  //   insert iree_task_call_t:
-  //     chains with prior commands and makes the collective API call
-  //   insert iree_task_wait_t with API wait handle or our event:
-  //     chains with call
-  //
-  // What we probably want to do, though, is group the commands based on
-  // execution barriers. When a new collective command comes in we should
-  // reserve an event from the event pool, create the call to issue the
-  // collective operation, and then track the event in the command buffer state.
-  // When another collective call comes in we'll do the same and append the
-  // event. At the next execution barrier (or non-collective command) we'd
-  // flush to a multi-wait on all of the pending events.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on the task system");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (!iree_hal_local_channel_isa(channel)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "task system collectives require channels created by a local device");
+  }
+  return iree_hal_collective_batch_append(
+      &command_buffer->state.collective_batch, channel, op, param, send_binding,
+      recv_binding, element_count);
 }
 
 //===----------------------------------------------------------------------===//
@@ -778,6 +1201,10 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
                             "set %u out of bounds", set);
   }
 
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_strided(
+      command_buffer->resource_set, binding_count, bindings,
+      offsetof(iree_hal_descriptor_set_binding_t, buffer), sizeof(*bindings)));
+
   iree_host_size_t binding_base =
       set * IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT;
   for (iree_host_size_t i = 0; i < binding_count; ++i) {
@@ -788,10 +1215,6 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
     }
     iree_host_size_t binding_ordinal = binding_base + bindings[i].binding;
 
-    // TODO(benvanik): batch insert by getting the resources in their own list.
-    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-        command_buffer->resource_set, 1, &bindings[i].buffer));
-
     // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
     iree_hal_buffer_mapping_t buffer_mapping = {{0}};
     if (bindings[i].buffer) {
@@ -817,11 +1240,51 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
 // iree_hal_command_buffer_dispatch
 //===----------------------------------------------------------------------===//
 
+// Approximate per-worker arithmetic throughput and memory bandwidth used to
+// convert the estimated dispatch costs provided by executables into execution
+// time. These are deliberately conservative: the estimates only guide how
+// dispatches are distributed and never affect their results.
+#if !defined(IREE_HAL_TASK_DISPATCH_OPS_PER_NS)
+#define IREE_HAL_TASK_DISPATCH_OPS_PER_NS 16
+#endif  // !IREE_HAL_TASK_DISPATCH_OPS_PER_NS
+#if !defined(IREE_HAL_TASK_DISPATCH_BYTES_PER_NS)
+#define IREE_HAL_TASK_DISPATCH_BYTES_PER_NS 8
+#endif  // !IREE_HAL_TASK_DISPATCH_BYTES_PER_NS
+
+// Returns the estimated time in nanoseconds to execute one workgroup with the
+// given |cost| or 0 if unknown. Workgroups are assumed to be bound by whichever
+// of arithmetic or memory accesses takes the longest.
+static uint64_t iree_hal_cmd_estimate_workgroup_cost_ns(
+    const iree_hal_executable_dispatch_cost_v0_t* cost) {
+  const uint64_t ops_ns = (cost->workgroup_ops +
+                           (IREE_HAL_TASK_DISPATCH_OPS_PER_NS - 1)) /
+                          IREE_HAL_TASK_DISPATCH_OPS_PER_NS;
+  const uint64_t bytes_ns = (cost->workgroup_bytes +
+                             (IREE_HAL_TASK_DISPATCH_BYTES_PER_NS - 1)) /
+                            IREE_HAL_TASK_DISPATCH_BYTES_PER_NS;
+  return iree_max(ops_ns, bytes_ns);
+}
+
 typedef struct iree_hal_cmd_dispatch_t {
   iree_task_dispatch_t task;
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Time the first workgroup of the dispatch began when dispatch timestamps
+  // are being profiled or 0 if no workgroup has run yet. Reset on retire so
+  // that reusable command buffers record each execution.
+  iree_atomic_int64_t begin_time_ns;
+
+  // Ring the dispatch is recorded into when sampled, or NULL.
+  iree_hal_local_dispatch_ring_t* dispatch_ring;
+  // Time the first workgroup of a sampled dispatch began, -1 if the dispatch
+  // has started but was not sampled, or 0 if no workgroup has run yet. Reset on
+  // retire like |begin_time_ns|.
+  iree_atomic_int64_t ring_begin_time_ns;
+  // Workgroup count of a sampled dispatch, captured from the first workgroup
+  // as indirect dispatches only resolve their count when issued.
+  uint32_t ring_workgroup_count[3];
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -843,6 +1306,36 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
       (const iree_hal_cmd_dispatch_t*)user_context;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (iree_hal_local_profiling_timestamps_are_active()) {
+    iree_atomic_int64_t* begin_time_ns =
+        (iree_atomic_int64_t*)&cmd->begin_time_ns;
+    int64_t expected_time_ns = 0;
+    if (iree_atomic_load_int64(begin_time_ns, iree_memory_order_relaxed) ==
+        0) {
+      iree_atomic_compare_exchange_strong_int64(
+          begin_time_ns, &expected_time_ns, iree_time_now(),
+          iree_memory_order_relaxed, iree_memory_order_relaxed);
+    }
+  }
+
+  // The first workgroup decides whether the dispatch is sampled. Unsampled
+  // dispatches cost all other workgroups a single relaxed load.
+  if (cmd->dispatch_ring) {
+    iree_hal_cmd_dispatch_t* mutable_cmd = (iree_hal_cmd_dispatch_t*)cmd;
+    int64_t expected_time_ns = 0;
+    if (iree_atomic_load_int64(&mutable_cmd->ring_begin_time_ns,
+                               iree_memory_order_relaxed) == 0 &&
+        iree_atomic_compare_exchange_strong_int64(
+            &mutable_cmd->ring_begin_time_ns, &expected_time_ns, -1,
+            iree_memory_order_relaxed, iree_memory_order_relaxed) &&
+        iree_hal_local_dispatch_ring_should_sample(cmd->dispatch_ring)) {
+      memcpy(mutable_cmd->ring_workgroup_count, tile_context->workgroup_count,
+             sizeof(mutable_cmd->ring_workgroup_count));
+      iree_atomic_store_int64(&mutable_cmd->ring_begin_time_ns,
+                              iree_time_now(), iree_memory_order_relaxed);
+    }
+  }
+
   // We could share this across all workgroups in a dispatch and reduce cache
   // pressure as all cores would be hitting the same hot read-only cache line.
   // It'd grow the size of iree_hal_cmd_dispatch_t by a few dozen bytes, though,
@@ -886,6 +1379,36 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   return status;
 }
 
+// Records the wall time of the dispatch from its first workgroup to its
+// retirement when dispatch timestamps are being profiled or the dispatch was
+// sampled into the device dispatch ring.
+static void iree_hal_cmd_dispatch_cleanup(iree_task_t* task,
+                                          iree_status_code_t status_code) {
+  iree_hal_cmd_dispatch_t* cmd = (iree_hal_cmd_dispatch_t*)task;
+  const iree_time_t begin_time_ns = (iree_time_t)iree_atomic_exchange_int64(
+      &cmd->begin_time_ns, 0, iree_memory_order_relaxed);
+  const iree_time_t ring_begin_time_ns =
+      cmd->dispatch_ring
+          ? (iree_time_t)iree_atomic_exchange_int64(
+                &cmd->ring_begin_time_ns, 0, iree_memory_order_relaxed)
+          : 0;
+  if (status_code != IREE_STATUS_OK) return;
+  if (!begin_time_ns && ring_begin_time_ns <= 0) return;
+  const iree_time_t end_time_ns = iree_time_now();
+  if (begin_time_ns && iree_hal_local_profiling_timestamps_are_active()) {
+    iree_hal_local_profiling_record_dispatch(cmd->executable, cmd->ordinal,
+                                             begin_time_ns, end_time_ns);
+  }
+  if (ring_begin_time_ns > 0) {
+    const char* name = cmd->executable->export_names
+                           ? cmd->executable->export_names[cmd->ordinal]
+                           : NULL;
+    iree_hal_local_dispatch_ring_append(
+        cmd->dispatch_ring, cmd->executable, (uint32_t)cmd->ordinal, name,
+        cmd->ring_workgroup_count, ring_begin_time_ns, end_time_ns);
+  }
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -902,6 +1425,9 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
         "layouts not provided during executable creation; cannot dispatch");
   }
 
+  // Executables may defer loading until their first dispatch.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(local_executable));
+
   iree_hal_local_pipeline_layout_t* local_layout =
       (iree_hal_local_pipeline_layout_t*)
           local_executable->pipeline_layouts[entry_point];
@@ -927,6 +1453,10 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
+  iree_atomic_store_int64(&cmd->begin_time_ns, 0, iree_memory_order_relaxed);
+  cmd->dispatch_ring = command_buffer->dispatch_ring;
+  iree_atomic_store_int64(&cmd->ring_begin_time_ns, 0,
+                          iree_memory_order_relaxed);
   cmd->push_constant_count = push_constant_count;
   cmd->binding_count = used_binding_count;
 
@@ -937,6 +1467,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       command_buffer->scope,
       iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
       workgroup_size, workgroup_count, &cmd->task);
+  iree_task_set_cleanup_fn(&cmd->task.header, iree_hal_cmd_dispatch_cleanup);
 
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
@@ -947,6 +1478,25 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Pass along the per-workgroup cost estimates (if any) so that the task
+  // system can pick how many workers to use and how many workgroups each
+  // claims at a time.
+  const iree_hal_executable_dispatch_cost_v0_t* dispatch_cost =
+      local_executable->dispatch_costs
+          ? &local_executable->dispatch_costs[entry_point]
+          : NULL;
+  if (dispatch_cost) {
+    cmd->task.tile_cost_ns = (uint32_t)iree_min(
+        iree_hal_cmd_estimate_workgroup_cost_ns(dispatch_cost), UINT32_MAX);
+    cmd->task.shard_tile_min = dispatch_cost->tiles_per_worker;
+  }
+
+  // Executables with cost estimates are compiled libraries that keep no
+  // per-worker state and cheap dispatches can run on the submitting thread.
+  if (dispatch_cost && cmd->task.tile_cost_ns > 0) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  }
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -1034,16 +1584,53 @@ static iree_status_t iree_hal_task_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers by using deferred command
-  // buffers or caching the task topology (probably not worth the tracking).
-  // If we could separate the topology that referenced the binding table we'd
-  // be able to reissue but not concurrently (as each task can only be in flight
-  // as a singleton) - which may be enough in many cases but adds complexity to
-  // tracking as we'd need to either enforce serialization of subsequent
-  // submissions or copy-on-write-style clone the topology for each additional
-  // concurrent submission.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+
+  // Nested command buffers are recorded as deferred command buffers by the
+  // device (see iree_hal_task_device_create_command_buffer) and we replay them
+  // into ourselves with their indirect bindings resolved against the binding
+  // table. The tasks produced are indistinguishable from ones recorded directly
+  // and reusable primary command buffers capture them in their template.
+  //
+  // NOTE: an alternative would be to cache the task topology of the nested
+  // command buffer and only patch the binding pointers but as tasks can only be
+  // in flight as singletons that requires serializing executions or cloning
+  // the topology per execution; replay is simpler and records no more tasks.
+  if (!iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "nested command buffers must be created from the same device");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &base_commands));
+
+  // Nested commands set their own descriptor and push constant state and the
+  // parent state must be preserved across them.
+  void* parent_bindings[IREE_ARRAYSIZE(command_buffer->state.bindings)];
+  iree_device_size_t
+      parent_binding_lengths[IREE_ARRAYSIZE(command_buffer->state.bindings)];
+  uint32_t parent_push_constants[IREE_ARRAYSIZE(
+      command_buffer->state.push_constants)];
+  memcpy(parent_bindings, command_buffer->state.bindings,
+         sizeof(parent_bindings));
+  memcpy(parent_binding_lengths, command_buffer->state.binding_lengths,
+         sizeof(parent_binding_lengths));
+  memcpy(parent_push_constants, command_buffer->state.push_constants,
+         sizeof(parent_push_constants));
+
+  // The commands are recorded as if they were recorded directly into the
+  // parent including any barriers the nested command buffer has.
+  iree_status_t status = iree_hal_deferred_command_buffer_apply_inline(
+      base_commands, base_command_buffer, binding_table);
+
+  memcpy(command_buffer->state.bindings, parent_bindings,
+         sizeof(parent_bindings));
+  memcpy(command_buffer->state.binding_lengths, parent_binding_lengths,
+         sizeof(parent_binding_lengths));
+  memcpy(command_buffer->state.push_constants, parent_push_constants,
+         sizeof(parent_push_constants));
+  return status;
 }
 
 //===----------------------------------------------------------------------===//
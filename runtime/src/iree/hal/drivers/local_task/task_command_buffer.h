@@ -11,6 +11,7 @@
 #include "iree/base/internal/arena.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/local_task/task_queue_state.h"
+#include "iree/hal/local/dispatch_ring.h"
 #include "iree/task/scope.h"
 #include "iree/task/task.h"
 
@@ -18,11 +19,21 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Creates a command buffer that records directly into a task DAG.
+//
+// Command buffers without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT keep the
+// recorded DAG as a template that is reset and reissued on each submission
+// without re-recording. Executions of the same reusable command buffer must be
+// ordered (such as via semaphores) as the tasks are reused in-place.
+//
+// When |dispatch_ring| is provided dispatches are sampled into it as they
+// retire. The ring must remain valid for the lifetime of the command buffer.
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_ring_t* dispatch_ring,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -0,0 +1,210 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Fills and copies at least this long are streamed with non-temporal stores
+// on targets that support them.
+constexpr iree_device_size_t kLargeTransferLength = 8 * 1024 * 1024;
+
+class TaskCommandBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    iree_task_executor_t* executor = NULL;
+    IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                             host_allocator, &executor));
+    iree_task_topology_deinitialize(&topology);
+
+    iree_hal_allocator_t* device_allocator = NULL;
+    iree_status_t status = iree_hal_allocator_create_heap(
+        iree_make_cstring_view("test"), host_allocator, host_allocator,
+        &device_allocator);
+    if (iree_status_is_ok(status)) {
+      iree_hal_task_device_params_t params;
+      iree_hal_task_device_params_initialize(&params);
+      status = iree_hal_task_device_create(
+          iree_make_cstring_view("test"), &params, /*queue_count=*/1,
+          &executor, /*loader_count=*/0, /*loaders=*/NULL, device_allocator,
+          host_allocator, &device_);
+    }
+    iree_hal_allocator_release(device_allocator);
+    iree_task_executor_release(executor);
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override { iree_hal_device_release(device_); }
+
+  // Allocates a mappable buffer of |length| bytes filled with |value|.
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t length, uint8_t value) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_), params, length,
+        iree_const_byte_span_empty(), &buffer));
+    IREE_CHECK_OK(iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER,
+                                           &value, sizeof(value)));
+    return buffer;
+  }
+
+  // Returns the full contents of |buffer|.
+  std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> data(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, data.data(), data.size()));
+    return data;
+  }
+
+  // Records the transfer commands issued by |record| into a one-shot command
+  // buffer and executes it to completion.
+  template <typename F>
+  iree_status_t RecordAndExecute(F record) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    iree_hal_semaphore_t* semaphore = NULL;
+    iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+    if (iree_status_is_ok(status)) status = record(command_buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_command_buffer_end(command_buffer);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_create(device_, 0ull, &semaphore);
+    }
+    if (iree_status_is_ok(status)) {
+      uint64_t signal_value = 1ull;
+      iree_hal_semaphore_list_t signal_semaphores = {
+          /*count=*/1,
+          /*semaphores=*/&semaphore,
+          /*payload_values=*/&signal_value,
+      };
+      status = iree_hal_device_queue_execute(
+          device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+          iree_hal_semaphore_list_empty(), signal_semaphores,
+          /*command_buffer_count=*/1, &command_buffer);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout());
+    }
+    iree_hal_semaphore_release(semaphore);
+    iree_hal_command_buffer_release(command_buffer);
+    return status;
+  }
+
+  iree_hal_device_t* device_ = NULL;
+};
+
+// Large fills at unaligned offsets and lengths write exactly the target range.
+TEST_F(TaskCommandBufferTest, LargeFillUnaligned) {
+  const iree_device_size_t buffer_length = kLargeTransferLength + 64;
+  const iree_device_size_t target_offset = 3;
+  const iree_device_size_t fill_length = kLargeTransferLength + 37;
+  iree_hal_buffer_t* buffer = AllocateBuffer(buffer_length, 0xEE);
+  const uint8_t pattern = 0x5A;
+  IREE_ASSERT_OK(RecordAndExecute([&](iree_hal_command_buffer_t* cb) {
+    return iree_hal_command_buffer_fill_buffer(
+        cb, buffer, target_offset, fill_length, &pattern, sizeof(pattern));
+  }));
+
+  std::vector<uint8_t> data = ReadBuffer(buffer);
+  for (iree_device_size_t i = 0; i < buffer_length; ++i) {
+    const bool in_range =
+        i >= target_offset && i < target_offset + fill_length;
+    ASSERT_EQ(in_range ? pattern : 0xEE, data[i]) << "at offset " << i;
+  }
+  iree_hal_buffer_release(buffer);
+}
+
+// Large fills of a multi-byte pattern that start partway into a 16-byte line
+// must resume the pattern at the right byte once the aligned stores begin. The
+// target is a subspan starting 2 bytes into its allocation so that the
+// unaligned head is not a whole number of pattern repeats.
+TEST_F(TaskCommandBufferTest, LargeFillPatternPhase) {
+  const iree_device_size_t allocation_length = kLargeTransferLength + 64;
+  iree_hal_buffer_t* allocation = AllocateBuffer(allocation_length, 0xEE);
+  const iree_device_size_t subspan_offset = 2;
+  const iree_device_size_t subspan_length = kLargeTransferLength + 32;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(allocation, subspan_offset,
+                                         subspan_length, &buffer));
+
+  const iree_device_size_t target_offset = 4;
+  const iree_device_size_t fill_length = kLargeTransferLength + 20;
+  const uint8_t pattern[4] = {0x01, 0x02, 0x03, 0x04};
+  IREE_ASSERT_OK(RecordAndExecute([&](iree_hal_command_buffer_t* cb) {
+    return iree_hal_command_buffer_fill_buffer(
+        cb, buffer, target_offset, fill_length, pattern, sizeof(pattern));
+  }));
+
+  std::vector<uint8_t> data = ReadBuffer(allocation);
+  const iree_device_size_t fill_begin = subspan_offset + target_offset;
+  for (iree_device_size_t i = 0; i < allocation_length; ++i) {
+    const bool in_range = i >= fill_begin && i < fill_begin + fill_length;
+    ASSERT_EQ(in_range ? pattern[(i - fill_begin) % sizeof(pattern)] : 0xEE,
+              data[i])
+        << "at offset " << i;
+  }
+  iree_hal_buffer_release(buffer);
+  iree_hal_buffer_release(allocation);
+}
+
+// Large copies between unaligned offsets with an unaligned length copy exactly
+// the source range.
+TEST_F(TaskCommandBufferTest, LargeCopyUnaligned) {
+  const iree_device_size_t buffer_length = kLargeTransferLength + 64;
+  const iree_device_size_t source_offset = 5;
+  const iree_device_size_t target_offset = 3;
+  const iree_device_size_t copy_length = kLargeTransferLength + 13;
+  iree_hal_buffer_t* source_buffer = AllocateBuffer(buffer_length, 0);
+  std::vector<uint8_t> source_data(buffer_length);
+  for (iree_device_size_t i = 0; i < buffer_length; ++i) {
+    source_data[i] = (uint8_t)(i * 31 + i / 251);
+  }
+  IREE_ASSERT_OK(iree_hal_buffer_map_write(source_buffer, 0,
+                                           source_data.data(), buffer_length));
+  iree_hal_buffer_t* target_buffer = AllocateBuffer(buffer_length, 0xEE);
+  IREE_ASSERT_OK(RecordAndExecute([&](iree_hal_command_buffer_t* cb) {
+    return iree_hal_command_buffer_copy_buffer(cb, source_buffer, source_offset,
+                                               target_buffer, target_offset,
+                                               copy_length);
+  }));
+
+  std::vector<uint8_t> data = ReadBuffer(target_buffer);
+  for (iree_device_size_t i = 0; i < buffer_length; ++i) {
+    const bool in_range =
+        i >= target_offset && i < target_offset + copy_length;
+    ASSERT_EQ(in_range ? source_data[i - target_offset + source_offset] : 0xEE,
+              data[i])
+        << "at offset " << i;
+  }
+  iree_hal_buffer_release(target_buffer);
+  iree_hal_buffer_release(source_buffer);
+}
+
+}  // namespace
@@ -18,9 +18,12 @@
 #include "iree/hal/drivers/local_task/task_queue.h"
 #include "iree/hal/drivers/local_task/task_semaphore.h"
 #include "iree/hal/local/executable_environment.h"
+#include "iree/hal/local/local_channel.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/profiling.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 
 typedef struct iree_hal_task_device_t {
   iree_hal_resource_t resource;
@@ -39,6 +42,9 @@ typedef struct iree_hal_task_device_t {
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
+  // Ring of sampled dispatch records or NULL if dispatch recording is disabled.
+  iree_hal_local_dispatch_ring_t* dispatch_ring;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -54,6 +60,12 @@ static iree_hal_task_device_t* iree_hal_task_device_cast(
 void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
+  out_params->dispatch_ring_capacity = 0;
+  out_params->dispatch_ring_sample_interval = 1;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_params->queue_priorities);
+       ++i) {
+    out_params->queue_priorities[i] = IREE_TASK_PRIORITY_NORMAL;
+  }
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -62,10 +74,23 @@ static iree_status_t iree_hal_task_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "arena block size too small (< 4096 bytes)");
   }
+  if (params->dispatch_ring_capacity > 0 &&
+      params->dispatch_ring_sample_interval == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch ring sample interval must be >= 1");
+  }
   if (queue_count == 0) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "must have at least one queue");
   }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(params->queue_priorities);
+       ++i) {
+    if (params->queue_priorities[i] >= IREE_TASK_PRIORITY_COUNT) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "queue %" PRIhsz " has an invalid priority %d", i,
+                              (int)params->queue_priorities[i]);
+    }
+  }
   return iree_ok_status();
 }
 
@@ -128,12 +153,23 @@ iree_status_t iree_hal_task_device_create(
     device->queue_count = queue_count;
     for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
       // TODO(benvanik): add a number to each queue ID.
-      iree_hal_task_queue_initialize(device->identifier, queue_executors[i],
+      const iree_task_priority_t priority =
+          i < IREE_ARRAYSIZE(params->queue_priorities)
+              ? params->queue_priorities[i]
+              : IREE_TASK_PRIORITY_NORMAL;
+      iree_hal_task_queue_initialize(device->identifier, priority,
+                                     queue_executors[i],
                                      &device->small_block_pool,
                                      &device->queues[i]);
     }
   }
 
+  if (iree_status_is_ok(status) && params->dispatch_ring_capacity > 0) {
+    status = iree_hal_local_dispatch_ring_allocate(
+        params->dispatch_ring_capacity, params->dispatch_ring_sample_interval,
+        host_allocator, &device->dispatch_ring);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -155,6 +191,7 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
   iree_hal_allocator_release(device->device_allocator);
+  iree_hal_local_dispatch_ring_free(device->dispatch_ring);
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
   iree_arena_block_pool_deinitialize(&device->small_block_pool);
   iree_allocator_free(host_allocator, device);
@@ -257,8 +294,9 @@ static iree_host_size_t iree_hal_task_device_select_queue(
 static iree_status_t iree_hal_task_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_local_channel_create(params, device->host_allocator,
+                                       out_channel);
 }
 
 static iree_status_t iree_hal_task_device_create_command_buffer(
@@ -267,12 +305,21 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+    // Nested command buffers are recorded as deferred command lists and
+    // replayed into their parent command buffer when executed. This lets their
+    // indirect bindings be resolved against the binding table provided at
+    // execution time instead of when the nested commands are recorded.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->large_block_pool, device->host_allocator, out_command_buffer);
+  }
   iree_host_size_t queue_index = iree_hal_task_device_select_queue(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, binding_capacity, &device->large_block_pool,
-      device->host_allocator, out_command_buffer);
+      queue_affinity, binding_capacity, device->dispatch_ring,
+      &device->large_block_pool, device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_task_device_create_descriptor_set_layout(
@@ -351,14 +398,20 @@ static iree_status_t iree_hal_task_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
-      iree_hal_device_allocator(base_device), params, allocation_size,
-      iree_const_byte_span_empty(), out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  // Each queue has a single transient pool.
+  if (pool != IREE_HAL_ALLOCATOR_POOL_DEFAULT) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "only the default allocator pool is supported; "
+                            "requested pool %u",
+                            pool);
+  }
+  iree_host_size_t queue_index = iree_hal_task_device_select_queue(
+      device, IREE_HAL_COMMAND_CATEGORY_ANY, queue_affinity);
+  return iree_hal_task_queue_submit_alloca(
+      &device->queues[queue_index], device->device_allocator,
+      wait_semaphore_list, signal_semaphore_list, params, allocation_size,
+      out_buffer);
 }
 
 static iree_status_t iree_hal_task_device_queue_dealloca(
@@ -366,10 +419,12 @@ static iree_status_t iree_hal_task_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  iree_host_size_t queue_index = iree_hal_task_device_select_queue(
+      device, IREE_HAL_COMMAND_CATEGORY_ANY, queue_affinity);
+  return iree_hal_task_queue_submit_dealloca(&device->queues[queue_index],
+                                             wait_semaphore_list,
+                                             signal_semaphore_list, buffer);
 }
 
 static iree_status_t iree_hal_task_device_queue_execute(
@@ -408,22 +463,48 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
 }
 
 static iree_status_t iree_hal_task_device_profiling_begin(
-    iree_hal_device_t* device,
+    iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
+  // Dispatch counters and timestamps are captured by the shared local
+  // executable profiling. Other modes are unimplemented (and that's ok).
+  if (options->mode & (IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+                       IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS)) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_profiling_begin(
+        base_device, options, iree_hal_device_host_allocator(base_device)));
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_task_device_profiling_end(
-    iree_hal_device_t* device) {
-  // Unimplemented (and that's ok).
+    iree_hal_device_t* base_device) {
+  return iree_hal_local_profiling_end(base_device);
+}
+
+iree_status_t iree_hal_task_device_read_dispatch_records(
+    iree_hal_device_t* base_device, uint64_t* inout_cursor,
+    iree_host_size_t record_capacity,
+    iree_hal_local_dispatch_record_t* out_records,
+    iree_host_size_t* out_record_count, uint64_t* out_dropped_count) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(inout_cursor);
+  IREE_ASSERT_ARGUMENT(!record_capacity || out_records);
+  IREE_ASSERT_ARGUMENT(out_record_count);
+  IREE_ASSERT_ARGUMENT(out_dropped_count);
+  *out_record_count = 0;
+  *out_dropped_count = 0;
+  if (!iree_hal_resource_is(base_device, &iree_hal_task_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a local-task device");
+  }
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (!device->dispatch_ring) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "dispatch recording is not enabled on the device; "
+                            "set a nonzero dispatch_ring_capacity");
+  }
+  iree_hal_local_dispatch_ring_read(device->dispatch_ring, inout_cursor,
+                                    record_capacity, out_records,
+                                    out_record_count, out_dropped_count);
   return iree_ok_status();
 }
 
@@ -448,6 +529,7 @@ static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
     .transfer_range = iree_hal_device_transfer_mappable_range,
     .queue_alloca = iree_hal_task_device_queue_alloca,
     .queue_dealloca = iree_hal_task_device_queue_dealloca,
+    .queue_read = iree_hal_device_queue_read_streaming,
     .queue_execute = iree_hal_task_device_queue_execute,
     .queue_flush = iree_hal_task_device_queue_flush,
     .wait_semaphores = iree_hal_task_device_wait_semaphores,
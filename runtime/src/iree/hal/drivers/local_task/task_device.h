@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_ring.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/task/executor.h"
 
@@ -16,6 +17,9 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Maximum number of device queues that may have their priority configured.
+#define IREE_HAL_TASK_DEVICE_MAX_QUEUE_PRIORITY_COUNT 16
+
 // Parameters configuring an iree_hal_task_device_t.
 // Must be initialized with iree_hal_task_device_params_initialize prior to use.
 typedef struct iree_hal_task_device_params_t {
@@ -23,6 +27,22 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Number of recently executed dispatch records retained by the device for
+  // iree_hal_task_device_read_dispatch_records. 0 disables dispatch recording.
+  iree_host_size_t dispatch_ring_capacity;
+
+  // Records one of every N dispatches when dispatch recording is enabled.
+  // Larger intervals reduce the overhead of recording in hot loops.
+  uint32_t dispatch_ring_sample_interval;
+
+  // Scheduling priority of the tasks submitted to each device queue. Workers
+  // drain higher-priority queues first and lower-priority dispatches yield at
+  // tile chunk boundaries when higher-priority work arrives on their worker.
+  // Queues beyond IREE_HAL_TASK_DEVICE_MAX_QUEUE_PRIORITY_COUNT use
+  // IREE_TASK_PRIORITY_NORMAL.
+  iree_task_priority_t
+      queue_priorities[IREE_HAL_TASK_DEVICE_MAX_QUEUE_PRIORITY_COUNT];
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -46,6 +66,22 @@ iree_status_t iree_hal_task_device_create(
     iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Reads up to |record_capacity| of the most recently sampled dispatches from a
+// device created with a nonzero dispatch_ring_capacity. Reading may happen at
+// any time from any thread, including while dispatches are executing.
+//
+// |inout_cursor| tracks the read position and should start at 0. Records
+// overwritten before they could be read (or still being written) are counted
+// in |out_dropped_count|.
+//
+// Returns IREE_STATUS_FAILED_PRECONDITION if dispatch recording is not enabled
+// on the device.
+iree_status_t iree_hal_task_device_read_dispatch_records(
+    iree_hal_device_t* device, uint64_t* inout_cursor,
+    iree_host_size_t record_capacity,
+    iree_hal_local_dispatch_record_t* out_records,
+    iree_host_size_t* out_record_count, uint64_t* out_dropped_count);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
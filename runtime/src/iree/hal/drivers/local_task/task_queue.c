@@ -284,6 +284,12 @@ typedef struct iree_hal_task_queue_retire_cmd_t {
   // A list of semaphores to signal upon retiring.
   iree_hal_semaphore_list_t signal_semaphores;
 
+  // Optional buffer deallocated by the submission. Retained until retired and
+  // then returned to |transient_pool| prior to signaling so that allocations
+  // waiting on the signal can reuse the storage.
+  iree_hal_task_transient_pool_t* transient_pool;
+  iree_hal_buffer_t* dealloca_buffer;
+
   // Command buffers retained until all have retired.
   // We could release them earlier but that would require tracking individual
   // command buffer task completion.
@@ -308,6 +314,15 @@ static iree_status_t iree_hal_task_queue_retire_cmd(
     cmd->command_buffers[i] = NULL;
   }
 
+  // Recycle the deallocated buffer (if any) now that all work that may have
+  // been using it has completed. The pool takes our reference and only reuses
+  // the buffer if it was the last one.
+  if (cmd->dealloca_buffer) {
+    iree_hal_task_transient_pool_recycle(cmd->transient_pool,
+                                         cmd->dealloca_buffer);
+    cmd->dealloca_buffer = NULL;
+  }
+
   // Signal all semaphores to their new values.
   // Note that if any signal fails then the whole command will fail and all
   // semaphores will be signaled to the failure state.
@@ -339,6 +354,11 @@ static void iree_hal_task_queue_retire_cmd_cleanup(
     cmd->command_buffers[i] = NULL;
   }
 
+  // Drop the deallocated buffer if we failed before recycling it. We don't know
+  // whether prior work using it completed and can't safely reuse the storage.
+  iree_hal_buffer_release(cmd->dealloca_buffer);
+  cmd->dealloca_buffer = NULL;
+
   // If the command failed then fail all semaphores to ensure future
   // submissions fail as well (including those on other queues).
   if (IREE_UNLIKELY(status_code != IREE_STATUS_OK)) {
@@ -364,7 +384,8 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
     iree_task_scope_t* scope, iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers,
     const iree_hal_semaphore_list_t* signal_semaphores,
-    iree_arena_block_pool_t* block_pool,
+    iree_hal_task_transient_pool_t* transient_pool,
+    iree_hal_buffer_t* dealloca_buffer, iree_arena_block_pool_t* block_pool,
     iree_hal_task_queue_retire_cmd_t** out_cmd) {
   // Make an arena we'll use for allocating the command itself.
   iree_arena_allocator_t arena;
@@ -395,6 +416,11 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
     // Transfer ownership of the arena to command.
     memcpy(&cmd->arena, &arena, sizeof(cmd->arena));
 
+    // Retain the buffer being deallocated (if any).
+    cmd->transient_pool = transient_pool;
+    cmd->dealloca_buffer = dealloca_buffer;
+    iree_hal_buffer_retain(cmd->dealloca_buffer);
+
     // Retain command buffers.
     cmd->command_buffer_count = command_buffer_count;
     for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
@@ -414,6 +440,7 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
 //===----------------------------------------------------------------------===//
 
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
+                                    iree_task_priority_t priority,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* block_pool,
                                     iree_hal_task_queue_t* out_queue) {
@@ -427,9 +454,12 @@ void iree_hal_task_queue_initialize(iree_string_view_t identifier,
   out_queue->block_pool = block_pool;
 
   iree_task_scope_initialize(identifier, &out_queue->scope);
+  iree_task_scope_set_priority(&out_queue->scope, priority);
 
   iree_hal_task_queue_state_initialize(&out_queue->state);
 
+  iree_hal_task_transient_pool_initialize(&out_queue->transient_pool);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -439,6 +469,7 @@ void iree_hal_task_queue_deinitialize(iree_hal_task_queue_t* queue) {
   iree_status_ignore(
       iree_task_scope_wait_idle(&queue->scope, IREE_TIME_INFINITE_FUTURE));
 
+  iree_hal_task_transient_pool_deinitialize(&queue->transient_pool);
   iree_hal_task_queue_state_deinitialize(&queue->state);
   iree_task_scope_deinitialize(&queue->scope);
   iree_task_executor_release(queue->executor);
@@ -448,18 +479,21 @@ void iree_hal_task_queue_deinitialize(iree_hal_task_queue_t* queue) {
 
 void iree_hal_task_queue_trim(iree_hal_task_queue_t* queue) {
   IREE_ASSERT_ARGUMENT(queue);
+  iree_hal_task_transient_pool_trim(&queue->transient_pool);
   iree_task_executor_trim(queue->executor);
 }
 
 static iree_status_t iree_hal_task_queue_submit_batch(
-    iree_hal_task_queue_t* queue, const iree_hal_submission_batch_t* batch) {
+    iree_hal_task_queue_t* queue, const iree_hal_submission_batch_t* batch,
+    iree_hal_buffer_t* dealloca_buffer) {
   // Task to retire the submission and free the transient memory allocated for
   // it (including the command itself). We allocate this first so it can get an
   // arena which we will use to allocate all other commands.
   iree_hal_task_queue_retire_cmd_t* retire_cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_queue_retire_cmd_allocate(
       &queue->scope, batch->command_buffer_count, batch->command_buffers,
-      &batch->signal_semaphores, queue->block_pool, &retire_cmd));
+      &batch->signal_semaphores, &queue->transient_pool, dealloca_buffer,
+      queue->block_pool, &retire_cmd));
 
   // NOTE: if we fail from here on we must drop the retire_cmd arena.
   iree_status_t status = iree_ok_status();
@@ -525,7 +559,8 @@ static iree_status_t iree_hal_task_queue_submit_batches(
   // build the whole DAG prior to submitting.
   for (iree_host_size_t i = 0; i < batch_count; ++i) {
     const iree_hal_submission_batch_t* batch = &batches[i];
-    IREE_RETURN_IF_ERROR(iree_hal_task_queue_submit_batch(queue, batch));
+    IREE_RETURN_IF_ERROR(iree_hal_task_queue_submit_batch(
+        queue, batch, /*dealloca_buffer=*/NULL));
   }
   return iree_ok_status();
 }
@@ -545,6 +580,70 @@ iree_status_t iree_hal_task_queue_submit(
   return status;
 }
 
+iree_status_t iree_hal_task_queue_submit_alloca(
+    iree_hal_task_queue_t* queue, iree_hal_allocator_t* device_allocator,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  // Reserve the storage immediately: any buffer in the pool was returned by a
+  // retired dealloca and is no longer in use by the timeline. Work using the
+  // allocation is ordered after the signal we schedule below and will not
+  // begin until the waits have been satisfied.
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_task_transient_pool_acquire(
+      &queue->transient_pool, device_allocator, params, allocation_size,
+      &buffer);
+
+  // Schedule the wait->signal on the queue without blocking the caller.
+  if (iree_status_is_ok(status)) {
+    const iree_hal_submission_batch_t batch = {
+        .wait_semaphores = wait_semaphore_list,
+        .command_buffer_count = 0,
+        .command_buffers = NULL,
+        .signal_semaphores = signal_semaphore_list,
+    };
+    status = iree_hal_task_queue_submit_batch(queue, &batch,
+                                              /*dealloca_buffer=*/NULL);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_task_executor_flush(queue->executor);
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_task_queue_submit_dealloca(
+    iree_hal_task_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The buffer is recycled into the transient pool when the submission retires
+  // after all waits (and thus all prior users of the buffer) have completed.
+  const iree_hal_submission_batch_t batch = {
+      .wait_semaphores = wait_semaphore_list,
+      .command_buffer_count = 0,
+      .command_buffers = NULL,
+      .signal_semaphores = signal_semaphore_list,
+  };
+  iree_status_t status = iree_hal_task_queue_submit_batch(queue, &batch, buffer);
+  if (iree_status_is_ok(status)) {
+    iree_task_executor_flush(queue->executor);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 iree_status_t iree_hal_task_queue_wait_idle(iree_hal_task_queue_t* queue,
                                             iree_timeout_t timeout) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -14,6 +14,7 @@
 #include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/local_task/task_queue_state.h"
+#include "iree/hal/drivers/local_task/task_transient_pool.h"
 #include "iree/task/executor.h"
 #include "iree/task/scope.h"
 #include "iree/task/task.h"
@@ -37,9 +38,14 @@ typedef struct iree_hal_task_queue_t {
   // The intra-queue synchronization (barriers/events) carries across command
   // buffers and this is used to rendezvous the tasks in each set.
   iree_hal_task_queue_state_t state;
+
+  // Pool of transient buffers used to service queue-ordered allocations.
+  // Buffers are returned to the pool by deallocas as they retire.
+  iree_hal_task_transient_pool_t transient_pool;
 } iree_hal_task_queue_t;
 
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
+                                    iree_task_priority_t priority,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* block_pool,
                                     iree_hal_task_queue_t* out_queue);
@@ -52,6 +58,26 @@ iree_status_t iree_hal_task_queue_submit(
     iree_hal_task_queue_t* queue, iree_host_size_t batch_count,
     const iree_hal_submission_batch_t* batches);
 
+// Reserves a transient buffer from the queue pool (or |device_allocator| if no
+// free buffer is available) and schedules the |signal_semaphore_list| to be
+// signaled once |wait_semaphore_list| has been reached. Never blocks the
+// calling thread on outstanding work.
+iree_status_t iree_hal_task_queue_submit_alloca(
+    iree_hal_task_queue_t* queue, iree_hal_allocator_t* device_allocator,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Schedules |buffer| to be returned to the queue transient pool once
+// |wait_semaphore_list| has been reached and then signals
+// |signal_semaphore_list|.
+iree_status_t iree_hal_task_queue_submit_dealloca(
+    iree_hal_task_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer);
+
 iree_status_t iree_hal_task_queue_wait_idle(iree_hal_task_queue_t* queue,
                                             iree_timeout_t timeout);
 
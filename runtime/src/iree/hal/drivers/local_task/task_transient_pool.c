@@ -0,0 +1,154 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_transient_pool.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/tracing.h"
+
+void iree_hal_task_transient_pool_initialize(
+    iree_hal_task_transient_pool_t* out_pool) {
+  memset(out_pool, 0, sizeof(*out_pool));
+  iree_slim_mutex_initialize(&out_pool->mutex);
+}
+
+void iree_hal_task_transient_pool_deinitialize(
+    iree_hal_task_transient_pool_t* pool) {
+  iree_hal_task_transient_pool_trim(pool);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+}
+
+// Removes the buffer at index |i| from the |pool| free list and returns
+// ownership to the caller.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_task_transient_pool_take_buffer_at(
+    iree_hal_task_transient_pool_t* pool, iree_host_size_t i) {
+  iree_hal_buffer_t* buffer = pool->free_buffers[i];
+  if (i < pool->free_count - 1) {
+    // Shift the list down to keep it dense and in ascending recency order.
+    memmove(&pool->free_buffers[i], &pool->free_buffers[i + 1],
+            (pool->free_count - i - 1) * sizeof(pool->free_buffers[0]));
+  }
+  --pool->free_count;
+  pool->free_allocated_size -= iree_hal_buffer_allocation_size(buffer);
+  return buffer;
+}
+
+void iree_hal_task_transient_pool_trim(iree_hal_task_transient_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Steal the free list so that we don't hold the lock while releasing; buffer
+  // deallocation can route through arbitrarily expensive device allocators.
+  iree_hal_buffer_t* dead_buffers[IREE_HAL_TASK_TRANSIENT_POOL_CAPACITY];
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_host_size_t dead_count = pool->free_count;
+  memcpy(dead_buffers, pool->free_buffers,
+         dead_count * sizeof(pool->free_buffers[0]));
+  pool->free_count = 0;
+  pool->free_allocated_size = 0;
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)dead_count);
+  for (iree_host_size_t i = 0; i < dead_count; ++i) {
+    iree_hal_buffer_release(dead_buffers[i]);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_task_transient_pool_acquire(
+    iree_hal_task_transient_pool_t* pool,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  // Allocators are free to drop the optimal bit once they've picked the memory
+  // type and we don't want to miss reusing their buffers because of it.
+  const iree_hal_memory_type_t required_type =
+      params.type & ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
+
+  // Walk backwards so that we check the most recently released buffers first as
+  // they are most likely to still be warm in the cache.
+  iree_hal_buffer_t* existing_buffer = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  for (int i = (int)pool->free_count - 1; i >= 0; --i) {
+    iree_hal_buffer_t* buffer = pool->free_buffers[i];
+    if (iree_hal_buffer_byte_length(buffer) == allocation_size &&
+        iree_all_bits_set(iree_hal_buffer_memory_type(buffer), required_type) &&
+        iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                          params.usage) &&
+        iree_all_bits_set(iree_hal_buffer_allowed_access(buffer),
+                          params.access)) {
+      existing_buffer = iree_hal_task_transient_pool_take_buffer_at(pool, i);
+      break;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (existing_buffer) {
+    *out_buffer = existing_buffer;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // Nothing reusable: allocate a new buffer. This is outside of the lock as the
+  // underlying allocator may be slow.
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, params, allocation_size, iree_const_byte_span_empty(),
+      out_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns true if the caller holds the only reference to |buffer|. No other
+// reference can be created concurrently as nothing else has the pointer.
+static bool iree_hal_task_transient_pool_is_last_reference(
+    iree_hal_buffer_t* buffer) {
+  return iree_atomic_ref_count_load(
+             &((iree_hal_resource_t*)buffer)->ref_count) == 1;
+}
+
+void iree_hal_task_transient_pool_recycle(iree_hal_task_transient_pool_t* pool,
+                                          iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  if (!buffer) return;
+
+  // Subspans alias storage that may still be in use through other references
+  // and cannot be recycled independently of their allocated buffer. Buffers
+  // referenced elsewhere may still be used by their owners.
+  if (iree_hal_buffer_allocated_buffer(buffer) != buffer ||
+      !iree_hal_task_transient_pool_is_last_reference(buffer)) {
+    iree_hal_buffer_release(buffer);
+    return;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(
+      z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
+
+  // If the pool is full we evict the least recently released buffer.
+  iree_hal_buffer_t* evicted_buffer = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool->free_count == IREE_ARRAYSIZE(pool->free_buffers)) {
+    evicted_buffer = iree_hal_task_transient_pool_take_buffer_at(pool, 0);
+  }
+  pool->free_buffers[pool->free_count++] = buffer;
+  pool->free_allocated_size += iree_hal_buffer_allocation_size(buffer);
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  // Drop the evicted buffer without holding the lock.
+  iree_hal_buffer_release(evicted_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
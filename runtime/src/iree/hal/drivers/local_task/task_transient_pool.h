@@ -0,0 +1,81 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_LOCAL_TASK_TASK_TRANSIENT_POOL_H_
+#define IREE_HAL_DRIVERS_LOCAL_TASK_TASK_TRANSIENT_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Maximum number of free transient buffers retained by a single pool.
+// Programs using async-exec typically only have a handful of live transients
+// per queue and anything beyond this bound is returned to the device allocator.
+#define IREE_HAL_TASK_TRANSIENT_POOL_CAPACITY 32
+
+// A pool of transient buffers used to service queue-ordered allocations.
+//
+// Buffers are only returned to the pool once the queue has retired the
+// dealloca that released them: any work that used the buffer prior to the
+// dealloca must have been waited on by the dealloca and a buffer taken from the
+// pool by a subsequent alloca is therefore safe to reuse in timeline order
+// without any additional synchronization. Buffers still referenced when their
+// dealloca retires are not recycled so that a double dealloca or an
+// application holding on to the buffer can never observe it being reused.
+//
+// Thread-safe: allocas are made from the submitting thread while deallocas are
+// retired from executor workers.
+typedef struct iree_hal_task_transient_pool_t {
+  // Guards the free list; never held during device allocator operations.
+  iree_slim_mutex_t mutex;
+
+  // Total size, in bytes, of all buffers in the free list.
+  iree_device_size_t free_allocated_size;
+
+  // Flat MRU list of available buffers sorted by ascending recency (the higher
+  // the index the more recently released). Each buffer is retained.
+  iree_host_size_t free_count;
+  iree_hal_buffer_t* free_buffers[IREE_HAL_TASK_TRANSIENT_POOL_CAPACITY];
+} iree_hal_task_transient_pool_t;
+
+// Initializes an empty transient pool in |out_pool|.
+void iree_hal_task_transient_pool_initialize(
+    iree_hal_task_transient_pool_t* out_pool);
+
+// Deinitializes |pool| and releases all free buffers.
+void iree_hal_task_transient_pool_deinitialize(
+    iree_hal_task_transient_pool_t* pool);
+
+// Releases all free buffers in |pool| back to their allocators.
+void iree_hal_task_transient_pool_trim(iree_hal_task_transient_pool_t* pool);
+
+// Acquires a buffer compatible with |params| of |allocation_size| from the
+// |pool|. If no free buffer is available a new one is allocated from
+// |device_allocator|. Never blocks on outstanding queue work.
+iree_status_t iree_hal_task_transient_pool_acquire(
+    iree_hal_task_transient_pool_t* pool,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer);
+
+// Recycles |buffer| into the |pool| for reuse by future acquisitions and
+// consumes the caller's reference.
+// Must only be called once all work using the buffer has completed. Buffers are
+// only recycled when the caller holds the last reference: a buffer still
+// referenced elsewhere (by the application or another pending dealloca) may
+// still be used and is released instead. Buffers that cannot be pooled
+// (subspans, etc) are released as well.
+void iree_hal_task_transient_pool_recycle(iree_hal_task_transient_pool_t* pool,
+                                          iree_hal_buffer_t* buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_LOCAL_TASK_TASK_TRANSIENT_POOL_H_
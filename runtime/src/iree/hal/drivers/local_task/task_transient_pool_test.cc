@@ -0,0 +1,106 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_transient_pool.h"
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class TaskTransientPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("test"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    iree_hal_task_transient_pool_initialize(&pool_);
+  }
+
+  void TearDown() override {
+    iree_hal_task_transient_pool_deinitialize(&pool_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_hal_buffer_t* Acquire(iree_device_size_t allocation_size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_task_transient_pool_acquire(
+        &pool_, device_allocator_, params, allocation_size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_task_transient_pool_t pool_;
+};
+
+// Buffers recycled with their last reference are reused.
+TEST_F(TaskTransientPoolTest, RecycleLastReferenceReuses) {
+  iree_hal_buffer_t* buffer = Acquire(128);
+  iree_hal_task_transient_pool_recycle(&pool_, buffer);
+  EXPECT_EQ(pool_.free_count, 1u);
+
+  iree_hal_buffer_t* reused_buffer = Acquire(128);
+  EXPECT_EQ(reused_buffer, buffer);
+  EXPECT_EQ(pool_.free_count, 0u);
+  iree_hal_buffer_release(reused_buffer);
+}
+
+// Buffers of other sizes are not reused.
+TEST_F(TaskTransientPoolTest, RecycleSizeMismatch) {
+  iree_hal_buffer_t* buffer = Acquire(128);
+  iree_hal_task_transient_pool_recycle(&pool_, buffer);
+
+  iree_hal_buffer_t* other_buffer = Acquire(256);
+  EXPECT_NE(other_buffer, buffer);
+  EXPECT_EQ(pool_.free_count, 1u);
+  iree_hal_buffer_release(other_buffer);
+}
+
+// Buffers still referenced elsewhere are released instead of reused.
+TEST_F(TaskTransientPoolTest, RecycleWhileReferencedDoesNotReuse) {
+  iree_hal_buffer_t* buffer = Acquire(128);
+  iree_hal_buffer_retain(buffer);  // held by the application
+  iree_hal_task_transient_pool_recycle(&pool_, buffer);
+  EXPECT_EQ(pool_.free_count, 0u);
+
+  iree_hal_buffer_t* other_buffer = Acquire(128);
+  EXPECT_NE(other_buffer, buffer);
+  iree_hal_buffer_release(other_buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+// Recycling a buffer twice (a double dealloca) only pools it once.
+TEST_F(TaskTransientPoolTest, DoubleRecycleOnlyPoolsOnce) {
+  iree_hal_buffer_t* buffer = Acquire(128);
+  iree_hal_buffer_retain(buffer);  // second dealloca
+  iree_hal_task_transient_pool_recycle(&pool_, buffer);
+  iree_hal_task_transient_pool_recycle(&pool_, buffer);
+  EXPECT_EQ(pool_.free_count, 1u);
+
+  iree_hal_buffer_t* buffer_a = Acquire(128);
+  iree_hal_buffer_t* buffer_b = Acquire(128);
+  EXPECT_EQ(buffer_a, buffer);
+  EXPECT_NE(buffer_a, buffer_b);
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_buffer_release(buffer_b);
+}
+
+// Subspans alias their allocated buffer and are never pooled.
+TEST_F(TaskTransientPoolTest, RecycleSubspanDoesNotReuse) {
+  iree_hal_buffer_t* buffer = Acquire(128);
+  iree_hal_buffer_t* subspan = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(buffer, 0, 64, &subspan));
+  iree_hal_buffer_release(buffer);
+  iree_hal_task_transient_pool_recycle(&pool_, subspan);
+  EXPECT_EQ(pool_.free_count, 0u);
+}
+
+}  // namespace
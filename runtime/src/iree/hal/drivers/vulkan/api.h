@@ -168,6 +168,12 @@ enum iree_hal_vulkan_device_flag_bits_t {
   // IREE execution to run asynchronously with the graphics workloads.
   // See: https://gpuopen.com/learn/concurrent-execution-asynchronous-queues/
   IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE = 1u << 0,
+
+  // Disables the unified memory fast path on integrated GPUs. By default when
+  // the device has memory that is DEVICE_LOCAL | HOST_VISIBLE | HOST_COHERENT
+  // all device-local buffers are placed there and mapped directly by the host
+  // instead of going through staging copies.
+  IREE_HAL_VULKAN_DEVICE_FLAG_DISABLE_UNIFIED_MEMORY = 1u << 1,
 };
 typedef uint32_t iree_hal_vulkan_device_flags_t;
 
@@ -181,6 +187,19 @@ typedef struct iree_hal_vulkan_device_options_t {
   // much.
   // NOTE: this is temporary and likely to get removed in the future.
   iree_device_size_t large_heap_block_size;
+
+  // Path of a file used to persist the device VkPipelineCache. When set, the
+  // cache is seeded from the file (if it exists) on device creation and the
+  // file is overwritten with the cache contents on device destruction. The
+  // driver ignores data that does not match the device. Empty to keep the
+  // pipeline cache in memory only.
+  iree_string_view_t pipeline_cache_path;
+
+  // Maximum number of threads used to create the pipelines of a single
+  // executable. Entry points are split across threads that each create their
+  // share of the pipelines concurrently. 0 or 1 creates all pipelines on the
+  // calling thread.
+  iree_host_size_t pipeline_creation_thread_count;
 } iree_hal_vulkan_device_options_t;
 
 IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
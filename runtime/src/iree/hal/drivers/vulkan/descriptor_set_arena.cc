@@ -105,10 +105,28 @@ static VkDescriptorSetAllocateInfo PopulateDescriptorSetsAllocateInfo(
 
 }  // namespace
 
+size_t DescriptorSetArena::CacheKeyHash::operator()(
+    const CacheKey& key) const {
+  // FNV-1a over the key fields.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  auto mix = [&](uint64_t value) {
+    hash = (hash ^ value) * 0x100000001B3ull;
+  };
+  mix((uint64_t)key.set_layout);
+  for (const auto& binding : key.bindings) {
+    mix(binding.binding);
+    mix((uint64_t)binding.buffer);
+    mix(binding.offset);
+    mix(binding.range);
+  }
+  return static_cast<size_t>(hash);
+}
+
 DescriptorSetArena::DescriptorSetArena(
-    DescriptorPoolCache* descriptor_pool_cache)
+    DescriptorPoolCache* descriptor_pool_cache, bool retain_descriptor_sets)
     : logical_device_(descriptor_pool_cache->logical_device()),
-      descriptor_pool_cache_(descriptor_pool_cache) {}
+      descriptor_pool_cache_(descriptor_pool_cache),
+      retain_descriptor_sets_(retain_descriptor_sets) {}
 
 DescriptorSetArena::~DescriptorSetArena() {
   if (!used_descriptor_pools_.empty()) {
@@ -134,6 +152,33 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
 
   auto* set_layout =
       iree_hal_vulkan_native_pipeline_layout_set(pipeline_layout, set);
+  VkDescriptorSetLayout set_layout_handle =
+      iree_hal_vulkan_native_descriptor_set_layout_handle(set_layout);
+
+  // Get a list of VkWriteDescriptorSet structs with all bound buffers. The
+  // destination set is filled in below if a new set needs to be written.
+  iree_host_size_t write_info_count = 0;
+  VkWriteDescriptorSet* write_infos = NULL;
+  PopulateDescriptorSetWriteInfos(binding_count, bindings, VK_NULL_HANDLE,
+                                  &scratch_arena_, &write_info_count,
+                                  &write_infos);
+
+  // Reuse a set with identical contents if one has already been written.
+  lookup_key_.set_layout = set_layout_handle;
+  lookup_key_.bindings.resize(write_info_count);
+  for (iree_host_size_t i = 0; i < write_info_count; ++i) {
+    const VkDescriptorBufferInfo* buffer_info = write_infos[i].pBufferInfo;
+    lookup_key_.bindings[i] = {write_infos[i].dstBinding, buffer_info->buffer,
+                               buffer_info->offset, buffer_info->range};
+  }
+  auto it = cache_.find(lookup_key_);
+  if (it != cache_.end()) {
+    syms().vkCmdBindDescriptorSets(
+        command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout), set, 1,
+        &it->second, 0, nullptr);
+    return iree_ok_status();
+  }
 
   // Pick a bucket based on the number of descriptors required.
   // NOTE: right now we are 1:1 with bindings.
@@ -161,8 +206,6 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
   allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
   allocate_info.pNext = nullptr;
   allocate_info.descriptorPool = descriptor_pool.handle;
-  VkDescriptorSetLayout set_layout_handle =
-      iree_hal_vulkan_native_descriptor_set_layout_handle(set_layout);
   allocate_info.descriptorSetCount = 1;
   allocate_info.pSetLayouts = &set_layout_handle;
 
@@ -191,12 +234,9 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
                        "vkAllocateDescriptorSets");
   }
 
-  // Get a list of VkWriteDescriptorSet structs with all bound buffers.
-  iree_host_size_t write_info_count = 0;
-  VkWriteDescriptorSet* write_infos = NULL;
-  PopulateDescriptorSetWriteInfos(binding_count, bindings, descriptor_set,
-                                  &scratch_arena_, &write_info_count,
-                                  &write_infos);
+  for (iree_host_size_t i = 0; i < write_info_count; ++i) {
+    write_infos[i].dstSet = descriptor_set;
+  }
 
   // This is the reason why push descriptor sets are good.
   // We can't batch these effectively as we don't know prior to recording what
@@ -206,6 +246,7 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
   syms().vkUpdateDescriptorSets(*logical_device_,
                                 static_cast<uint32_t>(write_info_count),
                                 write_infos, 0, nullptr);
+  cache_.emplace(lookup_key_, descriptor_set);
 
   // Bind the descriptor set.
   syms().vkCmdBindDescriptorSets(
@@ -241,11 +282,12 @@ void DescriptorSetArena::PushDescriptorSet(
 DescriptorSetGroup DescriptorSetArena::Flush() {
   IREE_TRACE_SCOPE0("DescriptorSetArena::Flush");
 
-  if (used_descriptor_pools_.empty()) {
-    // No resources to free.
+  if (used_descriptor_pools_.empty() || retain_descriptor_sets_) {
+    // No resources to free or the arena keeps them for reuse.
     return DescriptorSetGroup{};
   }
 
+  cache_.clear();
   for (auto& bucket : descriptor_pool_buckets_) {
     bucket = {};
   }
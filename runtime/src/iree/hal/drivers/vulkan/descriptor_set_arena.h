@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "iree/base/api.h"
@@ -26,14 +27,27 @@ namespace hal {
 namespace vulkan {
 
 // A reusable arena for allocating descriptor sets and batching updates.
+//
+// Descriptor sets are content-addressed by their layout and the buffer ranges
+// bound to them: binding the same contents again reuses the set that was
+// already allocated and written instead of allocating and updating a new one.
+// Callers must keep all bound buffers live for as long as the arena may reuse
+// sets referencing them.
 class DescriptorSetArena final {
  public:
-  explicit DescriptorSetArena(DescriptorPoolCache* descriptor_pool_cache);
+  // When |retain_descriptor_sets| is true the descriptor sets (and their pools)
+  // are kept across Flush calls so that re-recording reuses them. This is only
+  // valid when the sets are used by a single owner whose prior uses have
+  // completed before the sets are bound again, such as a reusable command
+  // buffer.
+  explicit DescriptorSetArena(DescriptorPoolCache* descriptor_pool_cache,
+                              bool retain_descriptor_sets = false);
   ~DescriptorSetArena();
 
   // Allocates and binds a descriptor set from the arena.
   // The command buffer will have the descriptor set containing |bindings| bound
-  // to it.
+  // to it. A previously allocated set with identical contents is reused if
+  // available.
   iree_status_t BindDescriptorSet(
       VkCommandBuffer command_buffer,
       iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
@@ -42,10 +56,35 @@ class DescriptorSetArena final {
 
   // Flushes all pending writes to descriptor sets allocated from the arena and
   // returns a group that - when dropped - will release the descriptor sets
-  // back to the pools they were allocated from.
+  // back to the pools they were allocated from. When retaining descriptor sets
+  // the arena keeps ownership of them and the returned group is empty.
   DescriptorSetGroup Flush();
 
  private:
+  // A single buffer range bound in a descriptor set.
+  struct CachedBinding {
+    uint32_t binding;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize range;
+    bool operator==(const CachedBinding& other) const {
+      return binding == other.binding && buffer == other.buffer &&
+             offset == other.offset && range == other.range;
+    }
+  };
+
+  // Identifies the contents of a descriptor set.
+  struct CacheKey {
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    std::vector<CachedBinding> bindings;
+    bool operator==(const CacheKey& other) const {
+      return set_layout == other.set_layout && bindings == other.bindings;
+    }
+  };
+  struct CacheKeyHash {
+    size_t operator()(const CacheKey& key) const;
+  };
+
   const DynamicSymbols& syms() const { return *logical_device_->syms(); }
 
   // Pushes the descriptor set to the command buffer, if supported.
@@ -66,6 +105,15 @@ class DescriptorSetArena final {
 
   // All pools that have been used during allocation.
   std::vector<DescriptorPool> used_descriptor_pools_;
+
+  // Whether sets are retained across Flush calls.
+  bool retain_descriptor_sets_;
+
+  // Descriptor sets allocated from |used_descriptor_pools_| by contents.
+  std::unordered_map<CacheKey, VkDescriptorSet, CacheKeyHash> cache_;
+
+  // Scratch key reused across lookups to avoid allocations on cache hits.
+  CacheKey lookup_key_;
 };
 
 }  // namespace vulkan
@@ -25,6 +25,24 @@
 
 using namespace iree::hal::vulkan;
 
+// Bindings pushed with a pipeline layout that can pass them as buffer device
+// addresses. Whether they get bound as descriptor sets or pushed as device
+// addresses depends on the executable dispatched and is resolved on dispatch.
+typedef struct iree_hal_vulkan_deferred_bindings_t {
+  // Pipeline layout the bindings were pushed with or NULL if none.
+  iree_hal_pipeline_layout_t* pipeline_layout;
+  // Bitmask of sets pushed since they were last bound as descriptor sets.
+  uint32_t dirty_set_mask;
+  // True if the addresses changed since they were last pushed.
+  bool dirty_addresses;
+  iree_host_size_t binding_counts[IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT];
+  iree_hal_descriptor_set_binding_t
+      bindings[IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT]
+              [IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_COUNT];
+  // Device addresses of the bindings in pipeline layout slot order.
+  VkDeviceAddress addresses[IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_COUNT];
+} iree_hal_vulkan_deferred_bindings_t;
+
 // Command buffer implementation that directly maps to VkCommandBuffer.
 // This records the commands on the calling thread without additional threading
 // indirection.
@@ -37,12 +55,18 @@ typedef struct iree_hal_vulkan_direct_command_buffer_t {
   VkCommandPoolHandle* command_pool;
   VkCommandBuffer handle;
 
+  // Categories of the commands actually recorded since the last begin. This
+  // may differ from the categories declared at creation as transfer commands
+  // may be emulated with dispatches and tracing inserts timestamp queries.
+  iree_hal_command_category_t recorded_categories;
+
   DynamicSymbols* syms;
 
   // Maintains a reference to all resources used within the command buffer.
   // Reset on each begin.
   iree_hal_resource_set_t* resource_set;
 
+  // Descriptor sets are reused when bound with identical contents.
   // TODO(benvanik): may grow large - should try to reclaim or reuse.
   DescriptorSetArena descriptor_set_arena;
 
@@ -59,6 +83,10 @@ typedef struct iree_hal_vulkan_direct_command_buffer_t {
   // TODO(scotttodd): use [maxPushConstantsSize - 16, maxPushConstantsSize]
   //                  instead of [0, 16] to reduce frequency of updates
   uint8_t push_constants_storage[IREE_HAL_VULKAN_BUILTIN_PUSH_CONSTANT_COUNT];
+
+  // Bindings waiting for the next dispatch to be bound, when the device
+  // supports buffer device addresses.
+  iree_hal_vulkan_deferred_bindings_t deferred_bindings;
 } iree_hal_vulkan_direct_command_buffer_t;
 
 namespace {
@@ -127,11 +155,17 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     command_buffer->handle = handle;
     command_buffer->syms = logical_device->syms().get();
 
-    new (&command_buffer->descriptor_set_arena)
-        DescriptorSetArena(descriptor_pool_cache);
+    // Reusable command buffers keep their descriptor sets for their lifetime
+    // so that sets with identical contents are shared across recordings.
+    new (&command_buffer->descriptor_set_arena) DescriptorSetArena(
+        descriptor_pool_cache,
+        /*retain_descriptor_sets=*/!iree_all_bits_set(
+            mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT));
     new (&command_buffer->descriptor_set_group) DescriptorSetGroup();
 
     command_buffer->builtin_executables = builtin_executables;
+    memset(&command_buffer->deferred_bindings, 0,
+           sizeof(command_buffer->deferred_bindings));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
   }
@@ -191,6 +225,14 @@ VkCommandBuffer iree_hal_vulkan_direct_command_buffer_handle(
   return command_buffer->handle;
 }
 
+iree_hal_command_category_t
+iree_hal_vulkan_direct_command_buffer_recorded_categories(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_vulkan_direct_command_buffer_t* command_buffer =
+      iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
+  return command_buffer->recorded_categories;
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
@@ -208,6 +250,12 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_begin(
                          command_buffer->handle, &begin_info),
                      "vkBeginCommandBuffer");
 
+  // Timestamp queries are recorded against the tracing context of a dispatch
+  // queue and the command buffer must be executed there.
+  command_buffer->recorded_categories =
+      command_buffer->tracing_context ? IREE_HAL_COMMAND_CATEGORY_DISPATCH : 0;
+  command_buffer->deferred_bindings.pipeline_layout = NULL;
+
   IREE_VULKAN_TRACE_ZONE_BEGIN_EXTERNAL(
       command_buffer->tracing_context, command_buffer->handle,
       /*file_name=*/NULL, 0,
@@ -551,8 +599,9 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
   // vkCmdFillBuffer requires a 4 byte alignment for the offset, pattern, and
   // length. We use a polyfill here that fills the unaligned start and end of
   // fill operations, if needed.
-
+  command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_TRANSFER;
   if (target_offset % 4 != 0 || length % 4 != 0) {
+    command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
     // TODO(scotttodd): only restore push constants that have been modified?
     //                  (this can pass uninitialized memory right now, which
     //                   *should* be safe but is wasteful)
@@ -561,6 +610,9 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
             command_buffer->handle, &(command_buffer->descriptor_set_arena),
             target_buffer, target_offset, length, pattern, pattern_length,
             command_buffer->push_constants_storage));
+    // Only the push constants were restored, not any device addresses after
+    // them.
+    command_buffer->deferred_bindings.dirty_addresses = true;
 
     // Continue using vkCmdFillBuffer below, but only for the inner aligned
     // portion of the fill operation.
@@ -604,6 +656,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_update_buffer(
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &target_buffer));
+  command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_TRANSFER;
 
   // Vulkan only allows updates of <= 65536 because you really, really, really
   // shouldn't do large updates like this (as it wastes command buffer space and
@@ -642,6 +695,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_copy_buffer(
   const iree_hal_buffer_t* buffers[2] = {source_buffer, target_buffer};
   IREE_RETURN_IF_ERROR(
       iree_hal_resource_set_insert(command_buffer->resource_set, 2, buffers));
+  command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_TRANSFER;
 
   VkBufferCopy region;
   region.srcOffset = iree_hal_buffer_byte_offset(source_buffer) + source_offset;
@@ -686,6 +740,52 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_push_constants(
   return iree_ok_status();
 }
 
+// Records the |bindings| of |set| to be bound on the next dispatch, computing
+// their device addresses in case the executable takes them that way.
+static iree_status_t iree_hal_vulkan_direct_command_buffer_defer_descriptor_set(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout,
+    const iree_hal_vulkan_device_address_layout_t* device_addresses,
+    uint32_t set, iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  iree_hal_vulkan_deferred_bindings_t* deferred =
+      &command_buffer->deferred_bindings;
+  if (deferred->pipeline_layout != pipeline_layout) {
+    deferred->pipeline_layout = pipeline_layout;
+    deferred->dirty_set_mask = 0;
+    memset(deferred->addresses, 0, sizeof(deferred->addresses));
+  }
+
+  if (IREE_UNLIKELY(set >= IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT ||
+                    binding_count > device_addresses->set_counts[set])) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "%zu bindings exceed the layout of set %u",
+                            binding_count, set);
+  }
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    const iree_hal_descriptor_set_binding_t* binding = &bindings[i];
+    if (IREE_UNLIKELY(binding->binding >= device_addresses->set_counts[set])) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "binding %u is not in the layout of set %u",
+                              binding->binding, set);
+    }
+    VkDeviceAddress address = 0;
+    if (binding->buffer) {
+      address = iree_hal_vulkan_vma_buffer_device_address(
+                    command_buffer->logical_device,
+                    iree_hal_buffer_allocated_buffer(binding->buffer)) +
+                iree_hal_buffer_byte_offset(binding->buffer) + binding->offset;
+    }
+    deferred->addresses[device_addresses->set_bases[set] + binding->binding] =
+        address;
+  }
+  memcpy(deferred->bindings[set], bindings, binding_count * sizeof(*bindings));
+  deferred->binding_counts[set] = binding_count;
+  deferred->dirty_set_mask |= 1u << set;
+  deferred->dirty_addresses = true;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_push_descriptor_set(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
@@ -694,13 +794,20 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_push_descriptor_set(
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
 
-  // TODO(benvanik): batch insert by getting the resources in their own list.
-  for (iree_host_size_t i = 0; i < binding_count; ++i) {
-    if (bindings[i].buffer) {
-      IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-          command_buffer->resource_set, 1, &bindings[i].buffer));
-    }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_strided(
+      command_buffer->resource_set, binding_count, bindings,
+      offsetof(iree_hal_descriptor_set_binding_t, buffer), sizeof(*bindings)));
+
+  // Defer binding until dispatch when the bindings may be passed as buffer
+  // device addresses.
+  const iree_hal_vulkan_device_address_layout_t* device_addresses =
+      iree_hal_vulkan_native_pipeline_layout_device_addresses(pipeline_layout);
+  if (device_addresses->count > 0) {
+    return iree_hal_vulkan_direct_command_buffer_defer_descriptor_set(
+        command_buffer, pipeline_layout, device_addresses, set, binding_count,
+        bindings);
   }
+  command_buffer->deferred_bindings.pipeline_layout = NULL;
 
   // Either allocate, update, and bind a descriptor set or use push descriptor
   // sets to use the command buffer pool when supported.
@@ -708,6 +815,42 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_push_descriptor_set(
       command_buffer->handle, pipeline_layout, set, binding_count, bindings);
 }
 
+// Binds the bindings deferred by push_descriptor_set for |executable|, either
+// as device addresses in push constants or as descriptor sets.
+static iree_status_t
+iree_hal_vulkan_direct_command_buffer_flush_deferred_bindings(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_executable_t* executable) {
+  iree_hal_vulkan_deferred_bindings_t* deferred =
+      &command_buffer->deferred_bindings;
+  if (!deferred->pipeline_layout) return iree_ok_status();
+
+  if (iree_hal_vulkan_native_executable_uses_device_addresses(executable)) {
+    if (!deferred->dirty_addresses) return iree_ok_status();
+    const iree_hal_vulkan_device_address_layout_t* device_addresses =
+        iree_hal_vulkan_native_pipeline_layout_device_addresses(
+            deferred->pipeline_layout);
+    command_buffer->syms->vkCmdPushConstants(
+        command_buffer->handle,
+        iree_hal_vulkan_native_pipeline_layout_handle(
+            deferred->pipeline_layout),
+        VK_SHADER_STAGE_COMPUTE_BIT, device_addresses->offset,
+        device_addresses->count * sizeof(VkDeviceAddress),
+        deferred->addresses);
+    deferred->dirty_addresses = false;
+    return iree_ok_status();
+  }
+
+  while (deferred->dirty_set_mask) {
+    uint32_t set = iree_math_count_trailing_zeros_u32(deferred->dirty_set_mask);
+    IREE_RETURN_IF_ERROR(command_buffer->descriptor_set_arena.BindDescriptorSet(
+        command_buffer->handle, deferred->pipeline_layout, set,
+        deferred->binding_counts[set], deferred->bindings[set]));
+    deferred->dirty_set_mask &= ~(1u << set);
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -728,6 +871,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch(
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &executable));
+  command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
 
   // Get the compiled and linked pipeline for the specified entry point and
   // bind it to the command buffer.
@@ -737,6 +881,9 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch(
           executable, entry_point, &pipeline_handle));
   command_buffer->syms->vkCmdBindPipeline(
       command_buffer->handle, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_handle);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_flush_deferred_bindings(
+          command_buffer, executable));
 
   command_buffer->syms->vkCmdDispatch(command_buffer->handle, workgroup_x,
                                       workgroup_y, workgroup_z);
@@ -758,6 +905,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch_indirect(
   const void* resources[2] = {executable, workgroups_buffer};
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, IREE_ARRAYSIZE(resources), resources));
+  command_buffer->recorded_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
 
   iree_hal_vulkan_source_location_t source_location;
   iree_hal_vulkan_native_executable_entry_point_source_location(
@@ -776,6 +924,9 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch_indirect(
           executable, entry_point, &pipeline_handle));
   command_buffer->syms->vkCmdBindPipeline(
       command_buffer->handle, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_handle);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_flush_deferred_bindings(
+          command_buffer, executable));
 
   VkBuffer workgroups_device_buffer = iree_hal_vulkan_vma_buffer_handle(
       iree_hal_buffer_allocated_buffer(workgroups_buffer));
@@ -814,6 +965,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execute_commands(
 
   iree_hal_vulkan_direct_command_buffer_t* commands =
       iree_hal_vulkan_direct_command_buffer_cast(base_commands);
+  command_buffer->recorded_categories |= commands->recorded_categories;
 
   command_buffer->syms->vkCmdExecuteCommands(command_buffer->handle, 1,
                                              &commands->handle);
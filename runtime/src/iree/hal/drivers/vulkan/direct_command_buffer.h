@@ -41,6 +41,13 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
 VkCommandBuffer iree_hal_vulkan_direct_command_buffer_handle(
     iree_hal_command_buffer_t* command_buffer);
 
+// Returns the categories of the commands recorded into |command_buffer| since
+// it was last begun. Command buffers that only contain transfer commands may
+// be executed on transfer queues.
+iree_hal_command_category_t
+iree_hal_vulkan_direct_command_buffer_recorded_categories(
+    iree_hal_command_buffer_t* command_buffer);
+
 // Returns true if |command_buffer| is a Vulkan command buffer.
 bool iree_hal_vulkan_direct_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer);
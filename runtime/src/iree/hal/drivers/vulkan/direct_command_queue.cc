@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/vulkan/direct_command_queue.h"
 
 #include <cstdint>
+#include <utility>
 
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/vulkan/direct_command_buffer.h"
@@ -23,9 +24,39 @@ namespace vulkan {
 DirectCommandQueue::DirectCommandQueue(
     VkDeviceHandle* logical_device,
     iree_hal_command_category_t supported_categories, VkQueue queue)
-    : CommandQueue(logical_device, supported_categories, queue) {}
+    : CommandQueue(logical_device, supported_categories, queue) {
+  iree_slim_mutex_initialize(&pending_mutex_);
+}
+
+DirectCommandQueue::~DirectCommandQueue() {
+  iree_slim_mutex_deinitialize(&pending_mutex_);
+}
 
-DirectCommandQueue::~DirectCommandQueue() = default;
+// Appends |semaphore_list| to the |handles| and |values| arrays with one entry
+// per unique semaphore carrying the maximum payload value requested of it.
+// Returns the number of entries written.
+static iree_host_size_t MergeSemaphoreList(
+    const iree_hal_semaphore_list_t* semaphore_list, VkSemaphore* handles,
+    uint64_t* values) {
+  iree_host_size_t count = 0;
+  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    VkSemaphore handle = iree_hal_vulkan_native_semaphore_handle(
+        semaphore_list->semaphores[i]);
+    uint64_t value = semaphore_list->payload_values[i];
+    iree_host_size_t j = 0;
+    for (; j < count; ++j) {
+      if (handles[j] == handle) break;
+    }
+    if (j == count) {
+      handles[count] = handle;
+      values[count] = value;
+      ++count;
+    } else if (value > values[j]) {
+      values[j] = value;
+    }
+  }
+  return count;
+}
 
 iree_status_t DirectCommandQueue::TranslateBatchInfo(
     const iree_hal_submission_batch_t* batch, VkSubmitInfo* submit_info,
@@ -36,16 +67,19 @@ iree_status_t DirectCommandQueue::TranslateBatchInfo(
   VkPipelineStageFlags dst_stage_mask =
       VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
+  // Multiple waits or signals of the same timeline semaphore are merged into
+  // one using the largest value: waiting on it implies all smaller values and
+  // the payload only ever advances to the largest signaled value.
   auto wait_semaphore_handles =
       arena->AllocateSpan<VkSemaphore>(batch->wait_semaphores.count);
   auto wait_semaphore_values =
       arena->AllocateSpan<uint64_t>(batch->wait_semaphores.count);
+  iree_host_size_t wait_count =
+      MergeSemaphoreList(&batch->wait_semaphores, wait_semaphore_handles.data(),
+                         wait_semaphore_values.data());
   auto wait_dst_stage_masks =
-      arena->AllocateSpan<VkPipelineStageFlags>(batch->wait_semaphores.count);
-  for (iree_host_size_t i = 0; i < batch->wait_semaphores.count; ++i) {
-    wait_semaphore_handles[i] = iree_hal_vulkan_native_semaphore_handle(
-        batch->wait_semaphores.semaphores[i]);
-    wait_semaphore_values[i] = batch->wait_semaphores.payload_values[i];
+      arena->AllocateSpan<VkPipelineStageFlags>(wait_count);
+  for (iree_host_size_t i = 0; i < wait_count; ++i) {
     wait_dst_stage_masks[i] = dst_stage_mask;
   }
 
@@ -53,11 +87,9 @@ iree_status_t DirectCommandQueue::TranslateBatchInfo(
       arena->AllocateSpan<VkSemaphore>(batch->signal_semaphores.count);
   auto signal_semaphore_values =
       arena->AllocateSpan<uint64_t>(batch->signal_semaphores.count);
-  for (iree_host_size_t i = 0; i < batch->signal_semaphores.count; ++i) {
-    signal_semaphore_handles[i] = iree_hal_vulkan_native_semaphore_handle(
-        batch->signal_semaphores.semaphores[i]);
-    signal_semaphore_values[i] = batch->signal_semaphores.payload_values[i];
-  }
+  iree_host_size_t signal_count = MergeSemaphoreList(
+      &batch->signal_semaphores, signal_semaphore_handles.data(),
+      signal_semaphore_values.data());
 
   auto command_buffer_handles =
       arena->AllocateSpan<VkCommandBuffer>(batch->command_buffer_count);
@@ -68,25 +100,23 @@ iree_status_t DirectCommandQueue::TranslateBatchInfo(
 
   submit_info->sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit_info->pNext = timeline_submit_info;
-  submit_info->waitSemaphoreCount =
-      static_cast<uint32_t>(wait_semaphore_handles.size());
+  submit_info->waitSemaphoreCount = static_cast<uint32_t>(wait_count);
   submit_info->pWaitSemaphores = wait_semaphore_handles.data();
   submit_info->pWaitDstStageMask = wait_dst_stage_masks.data();
   submit_info->commandBufferCount =
       static_cast<uint32_t>(command_buffer_handles.size());
   submit_info->pCommandBuffers = command_buffer_handles.data();
-  submit_info->signalSemaphoreCount =
-      static_cast<uint32_t>(signal_semaphore_handles.size());
+  submit_info->signalSemaphoreCount = static_cast<uint32_t>(signal_count);
   submit_info->pSignalSemaphores = signal_semaphore_handles.data();
 
   timeline_submit_info->sType =
       VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
   timeline_submit_info->pNext = nullptr;
   timeline_submit_info->waitSemaphoreValueCount =
-      static_cast<uint32_t>(wait_semaphore_values.size());
+      static_cast<uint32_t>(wait_count);
   timeline_submit_info->pWaitSemaphoreValues = wait_semaphore_values.data();
   timeline_submit_info->signalSemaphoreValueCount =
-      static_cast<uint32_t>(signal_semaphore_values.size());
+      static_cast<uint32_t>(signal_count);
   timeline_submit_info->pSignalSemaphoreValues = signal_semaphore_values.data();
 
   return iree_ok_status();
@@ -96,27 +126,60 @@ iree_status_t DirectCommandQueue::Submit(
     iree_host_size_t batch_count, const iree_hal_submission_batch_t* batches) {
   IREE_TRACE_SCOPE0("DirectCommandQueue::Submit");
 
-  // Map the submission batches to VkSubmitInfos.
+  // Map the submission batches to VkSubmitInfos appended to the pending list.
   // Note that we must keep all arrays referenced alive until submission
   // completes and since there are a bunch of them we use an arena.
-  Arena arena(4 * 1024);
-  auto submit_infos = arena.AllocateSpan<VkSubmitInfo>(batch_count);
+  iree_slim_mutex_lock(&pending_mutex_);
   auto timeline_submit_infos =
-      arena.AllocateSpan<VkTimelineSemaphoreSubmitInfo>(batch_count);
-  for (int i = 0; i < batch_count; ++i) {
-    IREE_RETURN_IF_ERROR(TranslateBatchInfo(&batches[i], &submit_infos[i],
-                                            &timeline_submit_infos[i], &arena));
+      pending_arena_->AllocateSpan<VkTimelineSemaphoreSubmitInfo>(batch_count);
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    VkSubmitInfo submit_info;
+    iree_status_t status =
+        TranslateBatchInfo(&batches[i], &submit_info,
+                           &timeline_submit_infos[i], pending_arena_);
+    if (!iree_status_is_ok(status)) {
+      // Batches translated so far are dropped; the arena is reclaimed on the
+      // next submission.
+      pending_submit_infos_.resize(pending_submit_infos_.size() - i);
+      iree_slim_mutex_unlock(&pending_mutex_);
+      return status;
+    }
+    pending_submit_infos_.push_back(submit_info);
   }
+  uint64_t ticket = ++enqueued_ticket_;
+  iree_slim_mutex_unlock(&pending_mutex_);
 
+  // Only one thread may submit to the queue at a time. Threads that enqueue
+  // while another is submitting wait here and the first to acquire the queue
+  // submits on behalf of all of them.
   iree_slim_mutex_lock(&queue_mutex_);
-  iree_status_t status = VK_RESULT_TO_STATUS(
-      syms()->vkQueueSubmit(queue_, static_cast<uint32_t>(submit_infos.size()),
-                            submit_infos.data(), VK_NULL_HANDLE),
-      "vkQueueSubmit");
+  iree_slim_mutex_lock(&pending_mutex_);
+  if (submitted_ticket_ >= ticket) {
+    // Another thread submitted our batches while we were waiting.
+    VkResult result = submit_result_;
+    iree_slim_mutex_unlock(&pending_mutex_);
+    iree_slim_mutex_unlock(&queue_mutex_);
+    return VK_RESULT_TO_STATUS(result, "vkQueueSubmit");
+  }
+  std::swap(pending_arena_, submitting_arena_);
+  pending_submit_infos_.swap(submitting_submit_infos_);
+  uint64_t last_ticket = enqueued_ticket_;
+  iree_slim_mutex_unlock(&pending_mutex_);
+
+  VkResult result = syms()->vkQueueSubmit(
+      queue_, static_cast<uint32_t>(submitting_submit_infos_.size()),
+      submitting_submit_infos_.data(), VK_NULL_HANDLE);
+  submitting_submit_infos_.clear();
+  submitting_arena_->Reset();
+
+  iree_slim_mutex_lock(&pending_mutex_);
+  submitted_ticket_ = last_ticket;
+  if (submit_result_ == VK_SUCCESS) submit_result_ = result;
+  result = submit_result_;
+  iree_slim_mutex_unlock(&pending_mutex_);
   iree_slim_mutex_unlock(&queue_mutex_);
-  IREE_RETURN_IF_ERROR(status);
 
-  return iree_ok_status();
+  return VK_RESULT_TO_STATUS(result, "vkQueueSubmit");
 }
 
 iree_status_t DirectCommandQueue::WaitIdle(iree_timeout_t timeout) {
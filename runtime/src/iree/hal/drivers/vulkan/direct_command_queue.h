@@ -7,7 +7,10 @@
 #ifndef IREE_HAL_DRIVERS_VULKAN_DIRECT_COMMAND_QUEUE_H_
 #define IREE_HAL_DRIVERS_VULKAN_DIRECT_COMMAND_QUEUE_H_
 
+#include <vector>
+
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/vulkan/command_queue.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
@@ -18,6 +21,12 @@ namespace hal {
 namespace vulkan {
 
 // Command queue implementation directly maps to VkQueue.
+//
+// Submissions made concurrently from multiple threads are coalesced: batches
+// are translated into a pending list and whichever thread acquires the queue
+// next submits all pending batches with a single vkQueueSubmit. Translation
+// storage is reused across submissions so that steady-state submission does
+// not allocate.
 class DirectCommandQueue final : public CommandQueue {
  public:
   DirectCommandQueue(VkDeviceHandle* logical_device,
@@ -34,6 +43,26 @@ class DirectCommandQueue final : public CommandQueue {
   iree_status_t TranslateBatchInfo(
       const iree_hal_submission_batch_t* batch, VkSubmitInfo* submit_info,
       VkTimelineSemaphoreSubmitInfo* timeline_submit_info, Arena* arena);
+
+  // Guards the pending submission state below. When both are held this is
+  // always acquired after |queue_mutex_|.
+  iree_slim_mutex_t pending_mutex_;
+  // Storage for the translated batches in |pending_submit_infos_| and for
+  // those currently being submitted. Swapped each submission.
+  Arena arenas_[2];
+  Arena* pending_arena_ IREE_GUARDED_BY(pending_mutex_) = &arenas_[0];
+  Arena* submitting_arena_ IREE_GUARDED_BY(queue_mutex_) = &arenas_[1];
+  std::vector<VkSubmitInfo> pending_submit_infos_
+      IREE_GUARDED_BY(pending_mutex_);
+  std::vector<VkSubmitInfo> submitting_submit_infos_
+      IREE_GUARDED_BY(queue_mutex_);
+  // Monotonic tickets identifying each Submit call. All calls with tickets up
+  // to and including |submitted_ticket_| have been submitted.
+  uint64_t enqueued_ticket_ IREE_GUARDED_BY(pending_mutex_) = 0;
+  uint64_t submitted_ticket_ IREE_GUARDED_BY(pending_mutex_) = 0;
+  // First failure returned by vkQueueSubmit, if any. Failures are sticky as
+  // they cannot be attributed to individual coalesced batches.
+  VkResult submit_result_ IREE_GUARDED_BY(pending_mutex_) = VK_SUCCESS;
 };
 
 }  // namespace vulkan
@@ -217,6 +217,7 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkGetAccelerationStructureHandleNV)                 \
   DEV_PFN(EXCLUDED, vkGetAccelerationStructureMemoryRequirementsNV)     \
   DEV_PFN(EXCLUDED, vkGetBufferDeviceAddressEXT)                        \
+  DEV_PFN(OPTIONAL, vkGetBufferDeviceAddressKHR)                        \
   DEV_PFN(REQUIRED, vkGetBufferMemoryRequirements)                      \
   DEV_PFN(EXCLUDED, vkGetBufferMemoryRequirements2)                     \
   DEV_PFN(EXCLUDED, vkGetBufferMemoryRequirements2KHR)                  \
@@ -244,7 +245,7 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkGetImageViewHandleNVX)                            \
   DEV_PFN(EXCLUDED, vkGetMemoryFdKHR)                                   \
   DEV_PFN(EXCLUDED, vkGetMemoryFdPropertiesKHR)                         \
-  DEV_PFN(EXCLUDED, vkGetMemoryHostPointerPropertiesEXT)                \
+  DEV_PFN(OPTIONAL, vkGetMemoryHostPointerPropertiesEXT)                \
   DEV_PFN(EXCLUDED, vkGetPastPresentationTimingGOOGLE)                  \
   DEV_PFN(REQUIRED, vkGetPipelineCacheData)                             \
   DEV_PFN(REQUIRED, vkGetQueryPoolResults)                              \
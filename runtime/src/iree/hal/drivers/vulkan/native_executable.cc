@@ -11,6 +11,7 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
@@ -57,8 +58,82 @@ static void iree_hal_vulkan_destroy_shader_module(
                                                 logical_device->allocator());
 }
 
+// A contiguous range of pipelines created with a single
+// vkCreateComputePipelines call, possibly on a worker thread.
+typedef struct iree_hal_vulkan_pipeline_batch_t {
+  VkDeviceHandle* logical_device;
+  VkPipelineCache pipeline_cache;
+  uint32_t count;
+  const VkComputePipelineCreateInfo* create_infos;
+  VkPipeline* pipelines;
+  VkResult result;
+} iree_hal_vulkan_pipeline_batch_t;
+
+static int iree_hal_vulkan_pipeline_batch_create(void* entry_arg) {
+  IREE_TRACE_SCOPE();
+  iree_hal_vulkan_pipeline_batch_t* batch =
+      (iree_hal_vulkan_pipeline_batch_t*)entry_arg;
+  batch->result = batch->logical_device->syms()->vkCreateComputePipelines(
+      *batch->logical_device, batch->pipeline_cache, batch->count,
+      batch->create_infos, batch->logical_device->allocator(),
+      batch->pipelines);
+  return 0;
+}
+
+// Creates |pipeline_count| pipelines in |batch_count| batches of |batch_size|.
+// The first batch is created on the calling thread while the others are
+// created on short-lived worker threads; pipeline cache access is internally
+// synchronized by the implementation. Batches that fail to get a worker thread
+// are created on the calling thread instead.
+static iree_status_t iree_hal_vulkan_create_pipeline_batches(
+    VkDeviceHandle* logical_device, VkPipelineCache pipeline_cache,
+    iree_host_size_t batch_count, iree_host_size_t batch_size,
+    iree_host_size_t pipeline_count,
+    const VkComputePipelineCreateInfo* create_infos, VkPipeline* pipelines) {
+  iree_hal_vulkan_pipeline_batch_t* batches =
+      (iree_hal_vulkan_pipeline_batch_t*)iree_alloca(batch_count *
+                                                     sizeof(*batches));
+  iree_thread_t** threads =
+      (iree_thread_t**)iree_alloca(batch_count * sizeof(*threads));
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    iree_host_size_t base_ordinal = i * batch_size;
+    batches[i].logical_device = logical_device;
+    batches[i].pipeline_cache = pipeline_cache;
+    batches[i].count =
+        (uint32_t)iree_min(batch_size, pipeline_count - base_ordinal);
+    batches[i].create_infos = &create_infos[base_ordinal];
+    batches[i].pipelines = &pipelines[base_ordinal];
+    batches[i].result = VK_SUCCESS;
+    threads[i] = NULL;
+  }
+
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = iree_make_cstring_view("iree-vk-pipelines");
+  for (iree_host_size_t i = 1; i < batch_count; ++i) {
+    iree_status_ignore(iree_thread_create(
+        iree_hal_vulkan_pipeline_batch_create, &batches[i], thread_params,
+        logical_device->host_allocator(), &threads[i]));
+  }
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    if (!threads[i]) iree_hal_vulkan_pipeline_batch_create(&batches[i]);
+  }
+  for (iree_host_size_t i = 1; i < batch_count; ++i) {
+    // Releasing the last reference joins the thread.
+    if (threads[i]) iree_thread_release(threads[i]);
+  }
+
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    if (batches[i].result != VK_SUCCESS) {
+      return VK_RESULT_TO_STATUS(batches[i].result, "vkCreateComputePipelines");
+    }
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_vulkan_create_pipelines(
     VkDeviceHandle* logical_device, VkPipelineCache pipeline_cache,
+    iree_host_size_t max_thread_count,
     const iree_hal_executable_params_t* executable_params,
     iree_SpirVExecutableDef_table_t executable_def,
     VkShaderModule shader_module, iree_host_size_t pipeline_count,
@@ -97,6 +172,14 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
     spec_map_entries[i].size = sizeof(uint32_t);
   }
 
+  // Pipelines derive from the first pipeline in their batch as derivatives
+  // may only reference pipelines created by the same call.
+  iree_host_size_t batch_count =
+      iree_max(1, iree_min(max_thread_count, pipeline_count));
+  iree_host_size_t batch_size =
+      iree_max(1, (pipeline_count + batch_count - 1) / batch_count);
+  batch_count = (pipeline_count + batch_size - 1) / batch_size;
+
   flatbuffers_string_vec_t entry_points_vec =
       iree_SpirVExecutableDef_entry_points_get(executable_def);
   flatbuffers_uint32_vec_t subgroup_sizes_vec =
@@ -112,7 +195,7 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
             IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_OPTIMIZATION)) {
       create_info->flags |= VK_PIPELINE_CREATE_DISABLE_OPTIMIZATION_BIT;
     }
-    if (entry_ordinal == 0) {
+    if (entry_ordinal % batch_size == 0) {
       create_info->flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
     } else {
       create_info->flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
@@ -150,15 +233,17 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
 
   VkPipeline* pipelines =
       (VkPipeline*)iree_alloca(pipeline_count * sizeof(VkPipeline));
-  iree_status_t status = VK_RESULT_TO_STATUS(
-      logical_device->syms()->vkCreateComputePipelines(
-          *logical_device, pipeline_cache, (uint32_t)pipeline_count,
-          create_infos, logical_device->allocator(), pipelines),
-      "vkCreateComputePipelines");
+  memset(pipelines, 0, pipeline_count * sizeof(VkPipeline));
+  iree_status_t status = iree_hal_vulkan_create_pipeline_batches(
+      logical_device, pipeline_cache, batch_count, batch_size, pipeline_count,
+      create_infos, pipelines);
+  // Pipelines that were created are owned by the entry points (and destroyed
+  // with the executable) even if other pipelines failed.
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    out_entry_points[i].pipeline = pipelines[i];
+  }
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
-      out_entry_points[i].pipeline = pipelines[i];
-
       // Set pipeline name for tooling.
       if (PFN_vkSetDebugUtilsObjectNameEXT set_name =
               logical_device->syms()->vkSetDebugUtilsObjectNameEXT) {
@@ -252,9 +337,48 @@ static iree_status_t iree_hal_spirv_executable_flatbuffer_verify(
   return iree_ok_status();
 }
 
+// Verifies that buffer device addresses can be passed to an executable using
+// the pipeline layouts in |executable_params|.
+static iree_status_t iree_hal_vulkan_verify_device_address_layouts(
+    VkDeviceHandle* logical_device,
+    const iree_hal_executable_params_t* executable_params) {
+  if (!logical_device->enabled_extensions().buffer_device_address) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "executable takes bindings as buffer device addresses but the device "
+        "does not support VK_KHR_buffer_device_address; recompile without "
+        "buffer device addresses");
+  }
+  for (iree_host_size_t i = 0; i < executable_params->pipeline_layout_count;
+       ++i) {
+    iree_hal_pipeline_layout_t* pipeline_layout =
+        executable_params->pipeline_layouts[i];
+    const iree_hal_vulkan_device_address_layout_t* device_addresses =
+        iree_hal_vulkan_native_pipeline_layout_device_addresses(
+            pipeline_layout);
+    iree_host_size_t set_count =
+        iree_hal_vulkan_native_pipeline_layout_set_count(pipeline_layout);
+    bool fits = set_count <= IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT;
+    if (fits && set_count > 0) {
+      fits = device_addresses->count ==
+             device_addresses->set_bases[set_count - 1] +
+                 device_addresses->set_counts[set_count - 1];
+    }
+    if (!fits) {
+      return iree_make_status(
+          IREE_STATUS_FAILED_PRECONDITION,
+          "pipeline layout of entry point %zu has no room for the buffer "
+          "device addresses of its bindings",
+          i);
+    }
+  }
+  return iree_ok_status();
+}
+
 typedef struct iree_hal_vulkan_native_executable_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
+  bool uses_device_addresses;
   iree_host_size_t entry_point_count;
   iree_hal_vulkan_entry_point_t entry_points[];
 } iree_hal_vulkan_native_executable_t;
@@ -272,7 +396,7 @@ iree_hal_vulkan_native_executable_cast(iree_hal_executable_t* base_value) {
 
 iree_status_t iree_hal_vulkan_native_executable_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkPipelineCache pipeline_cache,
+    VkPipelineCache pipeline_cache, iree_host_size_t max_thread_count,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(logical_device);
@@ -289,6 +413,16 @@ iree_status_t iree_hal_vulkan_native_executable_create(
   iree_SpirVExecutableDef_table_t executable_def =
       iree_SpirVExecutableDef_as_root(executable_params->executable_data.data);
 
+  // Executables taking bindings as buffer device addresses need the device to
+  // support them and the pipeline layouts to have room for them.
+  bool uses_device_addresses =
+      iree_SpirVExecutableDef_buffer_device_addresses_get(executable_def);
+  if (uses_device_addresses) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_vulkan_verify_device_address_layouts(logical_device,
+                                                          executable_params));
+  }
+
   // Create the shader module.
   flatbuffers_uint32_vec_t code_vec =
       iree_SpirVExecutableDef_code_get(executable_def);
@@ -317,13 +451,15 @@ iree_status_t iree_hal_vulkan_native_executable_create(
     iree_hal_resource_initialize(&iree_hal_vulkan_native_executable_vtable,
                                  &executable->resource);
     executable->logical_device = logical_device;
+    executable->uses_device_addresses = uses_device_addresses;
     executable->entry_point_count = entry_point_count;
     memset(executable->entry_points, 0,
            entry_point_count * sizeof(*executable->entry_points));
   }
   if (iree_status_is_ok(status)) {
     status = iree_hal_vulkan_create_pipelines(
-        logical_device, pipeline_cache, executable_params, executable_def,
+        logical_device, pipeline_cache, max_thread_count, executable_params,
+        executable_def,
         shader_module, executable->entry_point_count, executable->entry_points);
   }
   iree_hal_vulkan_destroy_shader_module(logical_device, shader_module);
@@ -396,6 +532,13 @@ iree_status_t iree_hal_vulkan_native_executable_pipeline_for_entry_point(
   return iree_ok_status();
 }
 
+bool iree_hal_vulkan_native_executable_uses_device_addresses(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_vulkan_native_executable_t* executable =
+      iree_hal_vulkan_native_executable_cast(base_executable);
+  return executable->uses_device_addresses;
+}
+
 namespace {
 const iree_hal_executable_vtable_t iree_hal_vulkan_native_executable_vtable = {
     /*.destroy=*/iree_hal_vulkan_native_executable_destroy,
@@ -28,9 +28,12 @@ typedef struct iree_hal_vulkan_source_location_t {
 // Creates a wrapper for one or more VkPipelines that are sourced from the same
 // IREE executable. Each of the pipelines will share the same shader module
 // and just differs by the entry point into the shader module they reference.
+//
+// Pipelines are created using up to |max_thread_count| threads (including the
+// calling thread) that each create a contiguous range of the entry points.
 iree_status_t iree_hal_vulkan_native_executable_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkPipelineCache pipeline_cache,
+    VkPipelineCache pipeline_cache, iree_host_size_t max_thread_count,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable);
 
@@ -45,6 +48,11 @@ iree_status_t iree_hal_vulkan_native_executable_pipeline_for_entry_point(
     iree_hal_executable_t* executable, iree_host_size_t entry_ordinal,
     VkPipeline* out_pipeline_handle);
 
+// Returns true if the executable takes its bindings as buffer device addresses
+// in push constants instead of through descriptor sets.
+bool iree_hal_vulkan_native_executable_uses_device_addresses(
+    iree_hal_executable_t* executable);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
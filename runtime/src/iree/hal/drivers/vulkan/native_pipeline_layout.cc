@@ -27,6 +27,8 @@ typedef struct iree_hal_vulkan_native_descriptor_set_layout_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
   VkDescriptorSetLayout handle;
+  // One more than the largest binding ordinal in the set.
+  uint32_t binding_slot_count;
 } iree_hal_vulkan_native_descriptor_set_layout_t;
 
 namespace {
@@ -128,6 +130,11 @@ iree_status_t iree_hal_vulkan_native_descriptor_set_layout_create(
         &descriptor_set_layout->resource);
     descriptor_set_layout->logical_device = logical_device;
     descriptor_set_layout->handle = handle;
+    descriptor_set_layout->binding_slot_count = 0;
+    for (iree_host_size_t i = 0; i < binding_count; ++i) {
+      descriptor_set_layout->binding_slot_count = iree_max(
+          descriptor_set_layout->binding_slot_count, bindings[i].binding + 1);
+    }
     *out_descriptor_set_layout =
         (iree_hal_descriptor_set_layout_t*)descriptor_set_layout;
   } else {
@@ -177,6 +184,7 @@ typedef struct iree_hal_vulkan_native_pipeline_layout_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
   VkPipelineLayout handle;
+  iree_hal_vulkan_device_address_layout_t device_addresses;
   iree_host_size_t set_layout_count;
   iree_hal_descriptor_set_layout_t* set_layouts[];
 } iree_hal_vulkan_native_pipeline_layout_t;
@@ -194,9 +202,37 @@ iree_hal_vulkan_native_pipeline_layout_cast(
   return (iree_hal_vulkan_native_pipeline_layout_t*)base_value;
 }
 
+// Computes where buffer device addresses are placed after |push_constant_count|
+// push constants, leaving the count 0 if they are not supported.
+static void iree_hal_vulkan_compute_device_address_layout(
+    VkDeviceHandle* logical_device, iree_host_size_t push_constant_count,
+    iree_host_size_t set_layout_count,
+    iree_hal_descriptor_set_layout_t* const* set_layouts,
+    iree_hal_vulkan_device_address_layout_t* out_layout) {
+  memset(out_layout, 0, sizeof(*out_layout));
+  out_layout->offset = (uint32_t)(push_constant_count * sizeof(uint32_t));
+  if (!logical_device->enabled_extensions().buffer_device_address ||
+      set_layout_count > IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT) {
+    return;
+  }
+  uint32_t count = 0;
+  for (iree_host_size_t i = 0; i < set_layout_count; ++i) {
+    uint32_t set_count =
+        iree_hal_vulkan_native_descriptor_set_layout_cast(set_layouts[i])
+            ->binding_slot_count;
+    out_layout->set_bases[i] = count;
+    out_layout->set_counts[i] = set_count;
+    count += set_count;
+  }
+  if (out_layout->offset + count * sizeof(uint64_t) <=
+      IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_PUSH_CONSTANT_SIZE) {
+    out_layout->count = count;
+  }
+}
+
 static iree_status_t iree_hal_vulkan_create_pipeline_layout(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    iree_host_size_t push_constant_count, iree_host_size_t set_layout_count,
+    iree_host_size_t push_constant_size, iree_host_size_t set_layout_count,
     iree_hal_descriptor_set_layout_t* const* set_layouts,
     VkPipelineLayout* out_handle) {
   VkDescriptorSetLayout* set_layout_handles =
@@ -210,8 +246,7 @@ static iree_status_t iree_hal_vulkan_create_pipeline_layout(
   VkPushConstantRange push_constant_ranges[1];
   push_constant_ranges[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
   push_constant_ranges[0].offset = 0;
-  push_constant_ranges[0].size =
-      (uint32_t)(push_constant_count * sizeof(uint32_t));
+  push_constant_ranges[0].size = (uint32_t)push_constant_size;
 
   VkPipelineLayoutCreateInfo create_info;
   create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -219,7 +254,7 @@ static iree_status_t iree_hal_vulkan_create_pipeline_layout(
   create_info.flags = 0;
   create_info.setLayoutCount = (uint32_t)set_layout_count;
   create_info.pSetLayouts = set_layout_handles;
-  create_info.pushConstantRangeCount = push_constant_count > 0 ? 1 : 0;
+  create_info.pushConstantRangeCount = push_constant_size > 0 ? 1 : 0;
   create_info.pPushConstantRanges = push_constant_ranges;
 
   return VK_RESULT_TO_STATUS(logical_device->syms()->vkCreatePipelineLayout(
@@ -246,10 +281,18 @@ iree_status_t iree_hal_vulkan_native_pipeline_layout_create(
   *out_pipeline_layout = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Reserve room for buffer device addresses after the push constants.
+  iree_hal_vulkan_device_address_layout_t device_addresses;
+  iree_hal_vulkan_compute_device_address_layout(
+      logical_device, push_constant_count, set_layout_count, set_layouts,
+      &device_addresses);
+  iree_host_size_t push_constant_size =
+      device_addresses.offset + device_addresses.count * sizeof(uint64_t);
+
   VkPipelineLayout handle = VK_NULL_HANDLE;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_vulkan_create_pipeline_layout(
-              logical_device, push_constant_count, set_layout_count,
+              logical_device, push_constant_size, set_layout_count,
               set_layouts, &handle));
 
   iree_hal_vulkan_native_pipeline_layout_t* pipeline_layout = NULL;
@@ -263,6 +306,7 @@ iree_status_t iree_hal_vulkan_native_pipeline_layout_create(
                                  &pipeline_layout->resource);
     pipeline_layout->logical_device = logical_device;
     pipeline_layout->handle = handle;
+    pipeline_layout->device_addresses = device_addresses;
     pipeline_layout->set_layout_count = set_layout_count;
     for (iree_host_size_t i = 0; i < set_layout_count; ++i) {
       pipeline_layout->set_layouts[i] = set_layouts[i];
@@ -302,6 +346,14 @@ VkPipelineLayout iree_hal_vulkan_native_pipeline_layout_handle(
   return pipeline_layout->handle;
 }
 
+const iree_hal_vulkan_device_address_layout_t*
+iree_hal_vulkan_native_pipeline_layout_device_addresses(
+    iree_hal_pipeline_layout_t* base_pipeline_layout) {
+  iree_hal_vulkan_native_pipeline_layout_t* pipeline_layout =
+      iree_hal_vulkan_native_pipeline_layout_cast(base_pipeline_layout);
+  return &pipeline_layout->device_addresses;
+}
+
 iree_host_size_t iree_hal_vulkan_native_pipeline_layout_set_count(
     iree_hal_pipeline_layout_t* base_pipeline_layout) {
   iree_hal_vulkan_native_pipeline_layout_t* pipeline_layout =
@@ -39,6 +39,36 @@ VkDescriptorSetLayout iree_hal_vulkan_native_descriptor_set_layout_handle(
 // iree_hal_vulkan_native_pipeline_layout_t
 //===----------------------------------------------------------------------===//
 
+// Maximum size in bytes of the push constant range of pipeline layouts passing
+// bindings as buffer device addresses. This is the minimum
+// maxPushConstantsSize required by Vulkan and must match the compiler.
+#define IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_PUSH_CONSTANT_SIZE 128
+
+// Maximum number of buffer device addresses in a pipeline layout.
+#define IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_COUNT \
+  (IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_PUSH_CONSTANT_SIZE / sizeof(uint64_t))
+
+// Maximum number of descriptor sets whose bindings may be passed as buffer
+// device addresses.
+#define IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT 4
+
+// Describes where the buffer device addresses of bindings are placed in the
+// push constant range for executables taking their bindings that way.
+// The addresses follow the push constants with each descriptor set reserving
+// one address slot per binding ordinal up to its largest binding, in set order.
+typedef struct iree_hal_vulkan_device_address_layout_t {
+  // Byte offset of the first address in the push constant range.
+  uint32_t offset;
+  // Total number of address slots or 0 if the layout has no bindings or they
+  // don't fit in the push constant range. The per-set slots below are still
+  // populated when the bindings don't fit.
+  uint32_t count;
+  // First slot of each descriptor set.
+  uint32_t set_bases[IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT];
+  // Number of slots of each descriptor set.
+  uint32_t set_counts[IREE_HAL_VULKAN_MAX_DEVICE_ADDRESS_SET_COUNT];
+} iree_hal_vulkan_device_address_layout_t;
+
 // Creates a VkPipelineLayout-based pipeline layout composed of one or more
 // descriptor set layouts.
 iree_status_t iree_hal_vulkan_native_pipeline_layout_create(
@@ -51,6 +81,13 @@ iree_status_t iree_hal_vulkan_native_pipeline_layout_create(
 VkPipelineLayout iree_hal_vulkan_native_pipeline_layout_handle(
     iree_hal_pipeline_layout_t* pipeline_layout);
 
+// Returns how buffer device addresses are passed to executables using the
+// pipeline layout. The count is 0 if the device doesn't support buffer device
+// addresses or the bindings don't fit in the push constant range.
+const iree_hal_vulkan_device_address_layout_t*
+iree_hal_vulkan_native_pipeline_layout_device_addresses(
+    iree_hal_pipeline_layout_t* pipeline_layout);
+
 // Returns the total number of descriptor sets within the layout.
 iree_host_size_t iree_hal_vulkan_native_pipeline_layout_set_count(
     iree_hal_pipeline_layout_t* pipeline_layout);
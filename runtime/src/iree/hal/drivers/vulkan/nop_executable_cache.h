@@ -15,12 +15,13 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
-// This is useful to isolate pipeline caching behavior and verify compilation
-// behavior.
+// Creates a no-op executable cache that does not cache executables itself.
+// Pipelines are created through |pipeline_cache| (if not VK_NULL_HANDLE) using
+// up to |pipeline_creation_thread_count| threads per executable.
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    iree_string_view_t identifier,
+    iree_string_view_t identifier, VkPipelineCache pipeline_cache,
+    iree_host_size_t pipeline_creation_thread_count,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
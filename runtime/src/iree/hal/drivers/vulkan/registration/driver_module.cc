@@ -37,10 +37,18 @@ IREE_FLAG(bool, vulkan_robust_buffer_access, false,
 IREE_FLAG(
     bool, vulkan_dedicated_compute_queue, false,
     "Use a dedicated queue with VK_QUEUE_COMPUTE_BIT for dispatch workloads.");
+IREE_FLAG(bool, vulkan_unified_memory, true,
+          "Places device-local buffers in host-visible memory on integrated "
+          "GPUs so that they can be mapped without staging copies.");
 IREE_FLAG(
     int64_t, vulkan_large_heap_block_size, 0,
     "Preferred allocator block size for large allocations in bytes. Sets the "
     "minimum bound on memory consumption.");
+IREE_FLAG(string, vulkan_pipeline_cache_path, "",
+          "File used to persist the Vulkan pipeline cache across runs.");
+IREE_FLAG(int32_t, vulkan_pipeline_creation_threads, 1,
+          "Maximum number of threads used to create the pipelines of each "
+          "executable.");
 
 static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
@@ -83,10 +91,20 @@ static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     driver_options.device_options.flags |=
         IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE;
   }
+  if (!FLAG_vulkan_unified_memory) {
+    driver_options.device_options.flags |=
+        IREE_HAL_VULKAN_DEVICE_FLAG_DISABLE_UNIFIED_MEMORY;
+  }
   if (FLAG_vulkan_large_heap_block_size) {
     driver_options.device_options.large_heap_block_size =
         FLAG_vulkan_large_heap_block_size;
   }
+  driver_options.device_options.pipeline_cache_path =
+      iree_make_cstring_view(FLAG_vulkan_pipeline_cache_path);
+  if (FLAG_vulkan_pipeline_creation_threads > 0) {
+    driver_options.device_options.pipeline_creation_thread_count =
+        (iree_host_size_t)FLAG_vulkan_pipeline_creation_threads;
+  }
 
   // Load the Vulkan library. This will fail if the library cannot be found or
   // does not have the expected functions.
@@ -0,0 +1,316 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/vulkan/transient_buffer_pool.h"
+
+#include <iterator>
+#include <utility>
+
+#include "iree/base/tracing.h"
+#include "iree/hal/drivers/vulkan/vma_allocator.h"
+#include "iree/hal/drivers/vulkan/vma_buffer.h"
+
+namespace iree {
+namespace hal {
+namespace vulkan {
+
+namespace {
+
+// Returns true if the caller holds the only reference to |buffer|. No other
+// reference can be created concurrently as nothing else has the pointer.
+bool IsLastReference(iree_hal_buffer_t* buffer) {
+  return iree_atomic_ref_count_load(
+             &((iree_hal_resource_t*)buffer)->ref_count) == 1;
+}
+
+// Returns true if |buffer| can service an allocation of |allocation_size| with
+// the given |params|.
+bool IsBufferCompatible(iree_hal_buffer_t* buffer,
+                        const iree_hal_buffer_params_t& params,
+                        iree_device_size_t allocation_size) {
+  // Allocators are free to drop the optimal bit once they've picked the memory
+  // type and we don't want to miss reusing their buffers because of it.
+  const iree_hal_memory_type_t required_type =
+      params.type & ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
+  return iree_hal_buffer_byte_length(buffer) == allocation_size &&
+         iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           required_type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params.usage) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_access(buffer),
+                           params.access);
+}
+
+// Returns true if the memory of |buffer| can be aliased by a new buffer of
+// |allocation_size| with the given |params|.
+bool IsBufferAliasable(iree_hal_buffer_t* buffer,
+                       const iree_hal_buffer_params_t& params,
+                       iree_device_size_t allocation_size) {
+  const iree_hal_memory_type_t required_type =
+      params.type & ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
+  const iree_device_size_t buffer_size = iree_hal_buffer_byte_length(buffer);
+  return buffer_size >= allocation_size &&
+         buffer_size / TransientBufferPool::kMaxAliasWasteRatio <=
+             allocation_size &&
+         iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           required_type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params.usage) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_access(buffer),
+                           params.access) &&
+         iree_hal_vulkan_vma_buffer_is_aliasable(buffer);
+}
+
+}  // namespace
+
+TransientBufferPool::TransientBufferPool() {
+  iree_slim_mutex_initialize(&mutex_);
+}
+
+TransientBufferPool::~TransientBufferPool() {
+  // The device must be idle by the time the pool is destroyed so any pending
+  // buffers can be released immediately.
+  for (auto& pending_buffer : pending_buffers_) {
+    for (auto& timepoint : pending_buffer.timepoints) {
+      iree_hal_semaphore_release(timepoint.semaphore);
+    }
+    iree_hal_buffer_release(pending_buffer.buffer);
+  }
+  pending_buffers_.clear();
+  for (auto* buffer : free_buffers_) {
+    iree_hal_buffer_release(buffer);
+  }
+  free_buffers_.clear();
+  iree_slim_mutex_deinitialize(&mutex_);
+}
+
+void TransientBufferPool::ReclaimRetiredLocked(
+    std::vector<iree_hal_buffer_t*>* dead_buffers) {
+  auto it = pending_buffers_.begin();
+  while (it != pending_buffers_.end()) {
+    bool retired = true;
+    bool failed = false;
+    for (auto& timepoint : it->timepoints) {
+      uint64_t current_value = 0;
+      iree_status_t status =
+          iree_hal_semaphore_query(timepoint.semaphore, &current_value);
+      if (!iree_status_is_ok(status)) {
+        // A failed semaphore will never reach the value and the device may
+        // have abandoned work referencing the buffer: don't reuse it.
+        iree_status_ignore(status);
+        failed = true;
+        break;
+      } else if (current_value < timepoint.value) {
+        retired = false;
+        break;
+      }
+    }
+    if (!failed && !retired) {
+      ++it;
+      continue;
+    }
+    for (auto& timepoint : it->timepoints) {
+      iree_hal_semaphore_release(timepoint.semaphore);
+    }
+    // Buffers are released to the pool by a dealloca while the caller still
+    // holds them and they only become reusable once the pool holds the last
+    // reference. A buffer still referenced (the program kept using it, it was
+    // deallocated more than once, or an aliasing buffer carved from it is
+    // still live) is dropped instead so that its memory is never handed to a
+    // second live transient.
+    if (failed || !IsLastReference(it->buffer)) {
+      dead_buffers->push_back(it->buffer);
+    } else {
+      free_buffers_.push_back(it->buffer);
+    }
+    it = pending_buffers_.erase(it);
+  }
+}
+
+bool TransientBufferPool::IsTrackedLocked(iree_hal_buffer_t* buffer) {
+  for (auto& pending_buffer : pending_buffers_) {
+    if (pending_buffer.buffer == buffer) return true;
+  }
+  for (auto* free_buffer : free_buffers_) {
+    if (free_buffer == buffer) return true;
+  }
+  return false;
+}
+
+iree_status_t TransientBufferPool::Acquire(
+    iree_hal_allocator_t* device_allocator,
+    const iree_hal_buffer_params_t& params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  std::vector<iree_hal_buffer_t*> dead_buffers;
+  iree_hal_buffer_t* existing_buffer = NULL;
+  iree_hal_buffer_t* aliased_buffer = NULL;
+  iree_slim_mutex_lock(&mutex_);
+  ReclaimRetiredLocked(&dead_buffers);
+  // Walk backwards so that we check the most recently retired buffers first.
+  for (auto it = free_buffers_.rbegin(); it != free_buffers_.rend(); ++it) {
+    if (IsBufferCompatible(*it, params, allocation_size)) {
+      existing_buffer = *it;
+      free_buffers_.erase(std::next(it).base());
+      break;
+    }
+  }
+  if (!existing_buffer) {
+    // No exact match: pick the smallest retired buffer that is large enough
+    // and alias its memory. This lets transients of different sizes (such as
+    // from different programs sharing the device) reuse the same memory.
+    auto best_it = free_buffers_.end();
+    for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+      if (!IsBufferAliasable(*it, params, allocation_size)) continue;
+      if (best_it == free_buffers_.end() ||
+          iree_hal_buffer_byte_length(*it) <
+              iree_hal_buffer_byte_length(*best_it)) {
+        best_it = it;
+      }
+    }
+    if (best_it != free_buffers_.end()) {
+      aliased_buffer = *best_it;
+      free_buffers_.erase(best_it);
+    }
+  }
+  iree_slim_mutex_unlock(&mutex_);
+
+  // Release any abandoned buffers outside of the lock as VMA may be slow.
+  for (auto* buffer : dead_buffers) {
+    iree_hal_buffer_release(buffer);
+  }
+
+  if (existing_buffer) {
+    *out_buffer = existing_buffer;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  if (aliased_buffer) {
+    // The aliasing buffer retains the backing buffer and hands it back to us
+    // in Release. If aliasing fails we just drop the backing buffer as its
+    // memory is probably better spent on the new allocation.
+    iree_status_t status = iree_hal_vulkan_vma_allocator_create_aliasing_buffer(
+        aliased_buffer, &params, allocation_size, out_buffer);
+    iree_hal_buffer_release(aliased_buffer);
+    if (iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, params, allocation_size, iree_const_byte_span_empty(),
+      out_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void TransientBufferPool::Release(
+    iree_hal_buffer_t* buffer, const iree_hal_semaphore_list_t& timepoints) {
+  if (!buffer) return;
+
+  // Buffers aliasing pooled memory return the memory they alias to the pool.
+  // The aliasing buffer itself is dropped with its last reference and until
+  // then it keeps the memory it aliases referenced so that the memory is not
+  // reused while the alias is live (see ReclaimRetiredLocked).
+  iree_hal_buffer_t* aliased_buffer =
+      iree_hal_vulkan_vma_buffer_aliased_buffer(buffer);
+  if (aliased_buffer) buffer = aliased_buffer;
+
+  // Subspans alias storage that may still be in use through other references
+  // and cannot be recycled independently of their allocated buffer. Without
+  // any timepoint we have no way of knowing when the device is done with the
+  // buffer and leave it to the normal buffer lifetime.
+  if (iree_hal_buffer_allocated_buffer(buffer) != buffer ||
+      timepoints.count == 0) {
+    return;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(
+      z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
+
+  PendingBuffer pending_buffer;
+  pending_buffer.buffer = buffer;
+  pending_buffer.timepoints.reserve(timepoints.count);
+  for (iree_host_size_t i = 0; i < timepoints.count; ++i) {
+    pending_buffer.timepoints.push_back(
+        {timepoints.semaphores[i], timepoints.payload_values[i]});
+  }
+
+  iree_hal_buffer_retain(buffer);
+  for (auto& timepoint : pending_buffer.timepoints) {
+    iree_hal_semaphore_retain(timepoint.semaphore);
+  }
+
+  // If the pool is full we evict the least recently retired free buffer. If
+  // there are no free buffers then everything is still in-flight and the new
+  // buffer is not tracked.
+  bool tracked = true;
+  iree_hal_buffer_t* evicted_buffer = NULL;
+  iree_slim_mutex_lock(&mutex_);
+  if (IsTrackedLocked(buffer)) {
+    // Already released (a double dealloca or another alias of the same
+    // memory): the existing entry covers it.
+    tracked = false;
+  } else if (pending_buffers_.size() + free_buffers_.size() >=
+             kMaxRetainedBuffers) {
+    if (!free_buffers_.empty()) {
+      evicted_buffer = free_buffers_.front();
+      free_buffers_.erase(free_buffers_.begin());
+    } else {
+      tracked = false;
+    }
+  }
+  if (tracked) {
+    pending_buffers_.push_back(std::move(pending_buffer));
+  }
+  iree_slim_mutex_unlock(&mutex_);
+
+  // Drop the evicted or untracked buffer without holding the lock.
+  if (!tracked) {
+    for (auto& timepoint : pending_buffer.timepoints) {
+      iree_hal_semaphore_release(timepoint.semaphore);
+    }
+    evicted_buffer = pending_buffer.buffer;
+  }
+  iree_hal_buffer_release(evicted_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void TransientBufferPool::Trim() {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Only free buffers are dropped; pending buffers may still be in use by the
+  // device and must wait for their timepoints.
+  std::vector<iree_hal_buffer_t*> dead_buffers;
+  iree_slim_mutex_lock(&mutex_);
+  ReclaimRetiredLocked(&dead_buffers);
+  dead_buffers.insert(dead_buffers.end(), free_buffers_.begin(),
+                      free_buffers_.end());
+  free_buffers_.clear();
+  iree_slim_mutex_unlock(&mutex_);
+
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)dead_buffers.size());
+  for (auto* buffer : dead_buffers) {
+    iree_hal_buffer_release(buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+}  // namespace vulkan
+}  // namespace hal
+}  // namespace iree
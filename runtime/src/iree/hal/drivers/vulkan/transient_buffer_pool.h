@@ -0,0 +1,107 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_VULKAN_TRANSIENT_BUFFER_POOL_H_
+#define IREE_HAL_DRIVERS_VULKAN_TRANSIENT_BUFFER_POOL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+
+namespace iree {
+namespace hal {
+namespace vulkan {
+
+// A timeline-aware pool of transient buffers used to service queue-ordered
+// allocations without going back to the device allocator (and VMA).
+//
+// Buffers released by queue deallocations are tracked alongside the timeline
+// semaphore values signaled by the deallocation. Once all of the semaphores
+// have reached their values the device has finished with the buffer and it can
+// be handed out again to a subsequent allocation. In steady-state execution
+// where transient sizes repeat across invocations this results in no
+// allocator calls at all.
+//
+// When no retired buffer matches the requested size exactly the pool aliases
+// the memory of the smallest retired buffer that is large enough with
+// vmaCreateAliasingBuffer. Transients of different sizes, such as those of
+// several programs sharing the device, then bind to the same device memory
+// instead of each holding their own allocation.
+//
+// Thread-safe: allocations and deallocations may be issued from any thread.
+class TransientBufferPool final {
+ public:
+  // Maximum number of buffers retained by the pool (free or pending).
+  // Releases beyond this limit evict the least recently freed buffer.
+  static constexpr iree_host_size_t kMaxRetainedBuffers = 64;
+
+  // Retired buffers are only aliased by allocations at least 1/N their size
+  // to avoid pinning large allocations behind small ones.
+  static constexpr iree_device_size_t kMaxAliasWasteRatio = 2;
+
+  TransientBufferPool();
+  ~TransientBufferPool();
+
+  TransientBufferPool(const TransientBufferPool&) = delete;
+  TransientBufferPool& operator=(const TransientBufferPool&) = delete;
+
+  // Acquires a buffer of |allocation_size| compatible with |params|.
+  // Reuses or aliases a buffer whose deallocation has completed on the device
+  // timeline if available and otherwise allocates a new one from
+  // |device_allocator|.
+  iree_status_t Acquire(iree_hal_allocator_t* device_allocator,
+                        const iree_hal_buffer_params_t& params,
+                        iree_device_size_t allocation_size,
+                        iree_hal_buffer_t** out_buffer);
+
+  // Releases |buffer| to the pool. The buffer is retained and will only be
+  // reused once all semaphores in |timepoints| have reached their payload
+  // values and the pool holds the last reference to it. Buffers without any
+  // timepoint cannot be tracked and are not pooled. Releasing a buffer that is
+  // already in the pool is a no-op.
+  void Release(iree_hal_buffer_t* buffer,
+               const iree_hal_semaphore_list_t& timepoints);
+
+  // Releases all buffers that are no longer in use by the device.
+  void Trim();
+
+ private:
+  struct Timepoint {
+    iree_hal_semaphore_t* semaphore;
+    uint64_t value;
+  };
+  struct PendingBuffer {
+    iree_hal_buffer_t* buffer;
+    std::vector<Timepoint> timepoints;
+  };
+
+  // Returns true if |buffer| is already pending or free in the pool.
+  bool IsTrackedLocked(iree_hal_buffer_t* buffer);
+
+  // Moves all pending buffers whose timepoints have been reached to the free
+  // list. Buffers whose semaphores have failed or that are still referenced
+  // outside of the pool are dropped into |dead_buffers| for release outside of
+  // the lock.
+  void ReclaimRetiredLocked(std::vector<iree_hal_buffer_t*>* dead_buffers);
+
+  iree_slim_mutex_t mutex_;
+
+  // Buffers released by deallocations that may still be in use by the device,
+  // in release order.
+  std::vector<PendingBuffer> pending_buffers_ IREE_GUARDED_BY(mutex_);
+
+  // Buffers available for reuse sorted by ascending recency.
+  std::vector<iree_hal_buffer_t*> free_buffers_ IREE_GUARDED_BY(mutex_);
+};
+
+}  // namespace vulkan
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_DRIVERS_VULKAN_TRANSIENT_BUFFER_POOL_H_
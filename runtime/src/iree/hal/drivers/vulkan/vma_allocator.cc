@@ -118,6 +118,43 @@ static void iree_hal_vulkan_populate_dispatch_memory_types(
   out_types->dispatch_idx = least_bits_idx;
 }
 
+// Returns the memory type index usable for all operations on unified memory
+// architectures (integrated GPUs/CPUs) or -1 if the device is not UMA.
+// Such types are DEVICE_LOCAL | HOST_VISIBLE | HOST_COHERENT in a device-local
+// heap and let the host access buffers directly without staging. Discrete
+// devices with resizable BAR expose the same flags but accessing that memory
+// from the host goes over the bus so we only consider integrated devices.
+static int iree_hal_vulkan_find_unified_memory_type(
+    const VkPhysicalDeviceProperties* device_props,
+    const VkPhysicalDeviceMemoryProperties* memory_props) {
+  if (device_props->deviceType != VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU &&
+      device_props->deviceType != VK_PHYSICAL_DEVICE_TYPE_CPU) {
+    return -1;
+  }
+  const VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  int least_bits_count = 0;
+  int least_bits_idx = -1;
+  for (uint32_t i = 0; i < memory_props->memoryTypeCount; ++i) {
+    VkMemoryPropertyFlags flags = memory_props->memoryTypes[i].propertyFlags;
+    if (!iree_hal_vulkan_is_heap_device_local(memory_props, i) ||
+        !iree_hal_vulkan_is_memory_type_usable(flags) ||
+        !iree_all_bits_set(flags, required_flags)) {
+      continue;
+    }
+    // Same policy as dispatch memory: prefer uncached (write-combined) over
+    // cached as dispatches are the common consumer.
+    int bit_count = iree_math_count_ones_u32(flags);
+    if (least_bits_idx == -1 || bit_count < least_bits_count) {
+      least_bits_count = bit_count;
+      least_bits_idx = (int)i;
+    }
+  }
+  return least_bits_idx;
+}
+
 static void iree_hal_vulkan_find_transfer_memory_types(
     const VkPhysicalDeviceProperties* device_props,
     const VkPhysicalDeviceMemoryProperties* memory_props,
@@ -222,11 +259,17 @@ static void iree_hal_vulkan_populate_transfer_memory_types(
 //   - DEVICE_LOCAL | HOST_VISIBLE | HOST_CACHED (staging download)
 //   - HOST_VISIBLE | HOST_COHERENT (upload)
 //   - HOST_VISIBLE | HOST_CACHED (download)
+//
+// When |allow_unified_memory| is set and the device is an integrated one with
+// host-coherent device-local memory all dispatch memory is placed there and
+// |out_unified_memory| is set to true.
 static iree_status_t iree_hal_vulkan_populate_memory_types(
     const VkPhysicalDeviceProperties* device_props,
     const VkPhysicalDeviceMemoryProperties* memory_props,
-    iree_hal_vulkan_memory_types_t* out_memory_types) {
+    bool allow_unified_memory, iree_hal_vulkan_memory_types_t* out_memory_types,
+    bool* out_unified_memory) {
   IREE_TRACE_ZONE_BEGIN(z0);
+  *out_unified_memory = false;
 
   // NOT_FOUND sentinel.
   for (size_t i = 0; i < IREE_ARRAYSIZE(out_memory_types->indices); ++i) {
@@ -238,6 +281,18 @@ static iree_status_t iree_hal_vulkan_populate_memory_types(
   iree_hal_vulkan_populate_dispatch_memory_types(device_props, memory_props,
                                                  out_memory_types);
 
+  // On unified memory systems the host can directly access the same memory as
+  // the device so we use a host-visible type for dispatches. Host I/O then
+  // maps buffers directly instead of staging through transfer memory.
+  if (allow_unified_memory) {
+    int unified_idx =
+        iree_hal_vulkan_find_unified_memory_type(device_props, memory_props);
+    if (unified_idx != -1) {
+      out_memory_types->dispatch_idx = unified_idx;
+      *out_unified_memory = true;
+    }
+  }
+
   // Find the memory types for upload/download.
   iree_hal_vulkan_populate_transfer_memory_types(device_props, memory_props,
                                                  out_memory_types);
@@ -245,6 +300,7 @@ static iree_status_t iree_hal_vulkan_populate_memory_types(
   // Because this is all bananas we trace out what indices we chose; this will
   // let us correlate the memory types with vulkan-info and see if we got the
   // "right" ones.
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, *out_unified_memory ? "unified" : "discrete");
   IREE_TRACE_ZONE_APPEND_TEXT(z0, "dispatch:");
   IREE_TRACE_ZONE_APPEND_VALUE(z0, out_memory_types->dispatch_idx);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, "bulk-upload:");
@@ -280,11 +336,21 @@ typedef struct iree_hal_vulkan_vma_allocator_t {
   iree_hal_resource_t resource;
   iree_hal_device_t* device;  // unretained to avoid cycles
   iree_allocator_t host_allocator;
+  VkDeviceHandle* logical_device;  // unretained; owned by the device
   VmaAllocator vma;
 
+  // Required alignment of host pointers and sizes imported with
+  // VK_EXT_external_memory_host or 0 if the extension is not available.
+  VkDeviceSize min_imported_host_pointer_alignment;
+
   // Used to quickly look up the memory type index used for a particular usage.
   iree_hal_vulkan_memory_types_t memory_types;
 
+  // True if |memory_types.dispatch_idx| is host-visible and host-coherent
+  // device-local memory on a unified memory architecture. All device-local
+  // buffers are allocated from it and persistently mapped.
+  bool unified_memory;
+
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_vulkan_vma_allocator_t;
 
@@ -363,8 +429,26 @@ iree_status_t iree_hal_vulkan_vma_allocator_create(
                                &allocator->resource);
   allocator->host_allocator = host_allocator;
   allocator->device = device;
+  allocator->logical_device = logical_device;
+  allocator->unified_memory = false;
 
   const auto& syms = logical_device->syms();
+
+  // Query the import constraints for host allocations, if supported.
+  allocator->min_imported_host_pointer_alignment = 0;
+  if (logical_device->enabled_extensions().external_memory_host) {
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT external_memory_host_props;
+    memset(&external_memory_host_props, 0, sizeof(external_memory_host_props));
+    external_memory_host_props.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 device_props2;
+    memset(&device_props2, 0, sizeof(device_props2));
+    device_props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    device_props2.pNext = &external_memory_host_props;
+    syms->vkGetPhysicalDeviceProperties2(physical_device, &device_props2);
+    allocator->min_imported_host_pointer_alignment =
+        external_memory_host_props.minImportedHostPointerAlignment;
+  }
   VmaVulkanFunctions vulkan_fns;
   memset(&vulkan_fns, 0, sizeof(vulkan_fns));
   vulkan_fns.vkGetPhysicalDeviceProperties =
@@ -400,6 +484,9 @@ iree_status_t iree_hal_vulkan_vma_allocator_create(
   VmaAllocatorCreateInfo create_info;
   memset(&create_info, 0, sizeof(create_info));
   create_info.flags = 0;
+  if (logical_device->enabled_extensions().buffer_device_address) {
+    create_info.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+  }
   create_info.physicalDevice = physical_device;
   create_info.device = *logical_device;
   create_info.instance = instance;
@@ -420,8 +507,12 @@ iree_status_t iree_hal_vulkan_vma_allocator_create(
     vmaGetPhysicalDeviceProperties(allocator->vma, &device_props);
     const VkPhysicalDeviceMemoryProperties* memory_props = NULL;
     vmaGetMemoryProperties(allocator->vma, &memory_props);
-    status = iree_hal_vulkan_populate_memory_types(device_props, memory_props,
-                                                   &allocator->memory_types);
+    status = iree_hal_vulkan_populate_memory_types(
+        device_props, memory_props,
+        /*allow_unified_memory=*/
+        !iree_all_bits_set(options->flags,
+                           IREE_HAL_VULKAN_DEVICE_FLAG_DISABLE_UNIFIED_MEMORY),
+        &allocator->memory_types, &allocator->unified_memory);
   }
 
   if (iree_status_is_ok(status)) {
@@ -582,6 +673,9 @@ iree_hal_vulkan_vma_allocator_query_buffer_compatibility(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     iree_hal_buffer_params_t* IREE_RESTRICT params,
     iree_device_size_t* IREE_RESTRICT allocation_size) {
+  iree_hal_vulkan_vma_allocator_t* allocator =
+      iree_hal_vulkan_vma_allocator_cast(base_allocator);
+
   // TODO(benvanik): check to ensure the allocator can serve the memory type.
 
   // All buffers can be allocated on the heap.
@@ -600,6 +694,16 @@ iree_hal_vulkan_vma_allocator_query_buffer_compatibility(
     }
   }
 
+  // On unified memory systems all device-local memory is also host-visible
+  // and coherent so we let the host map it directly. Transfers to and from
+  // the host then take the mapping path instead of staging.
+  if (allocator->unified_memory &&
+      iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    params->type |=
+        IREE_HAL_MEMORY_TYPE_HOST_VISIBLE | IREE_HAL_MEMORY_TYPE_HOST_COHERENT;
+    params->usage |= IREE_HAL_BUFFER_USAGE_MAPPING;
+  }
+
   // We are now optimal.
   params->type &= ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
 
@@ -615,6 +719,25 @@ iree_hal_vulkan_vma_allocator_query_buffer_compatibility(
   return compatibility;
 }
 
+// Returns the VkBufferUsageFlags required for buffers with |usage|.
+static VkBufferUsageFlags iree_hal_vulkan_select_buffer_usage_flags(
+    VkDeviceHandle* logical_device, iree_hal_buffer_usage_t usage) {
+  VkBufferUsageFlags usage_flags = 0;
+  if (iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_TRANSFER)) {
+    usage_flags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    usage_flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  }
+  if (iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
+    usage_flags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    usage_flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    usage_flags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    if (logical_device->enabled_extensions().buffer_device_address) {
+      usage_flags |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
+  }
+  return usage_flags;
+}
+
 static iree_status_t iree_hal_vulkan_vma_allocator_allocate_internal(
     iree_hal_vulkan_vma_allocator_t* IREE_RESTRICT allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -626,17 +749,8 @@ static iree_status_t iree_hal_vulkan_vma_allocator_allocate_internal(
   buffer_create_info.pNext = NULL;
   buffer_create_info.flags = 0;
   buffer_create_info.size = allocation_size;
-  buffer_create_info.usage = 0;
-  if (iree_all_bits_set(params->usage, IREE_HAL_BUFFER_USAGE_TRANSFER)) {
-    buffer_create_info.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    buffer_create_info.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-  }
-  if (iree_all_bits_set(params->usage,
-                        IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
-    buffer_create_info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    buffer_create_info.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    buffer_create_info.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
-  }
+  buffer_create_info.usage = iree_hal_vulkan_select_buffer_usage_flags(
+      allocator->logical_device, params->usage);
   buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
   buffer_create_info.queueFamilyIndexCount = 0;
   buffer_create_info.pQueueFamilyIndices = NULL;
@@ -681,8 +795,16 @@ static iree_status_t iree_hal_vulkan_vma_allocator_allocate_internal(
     allocation_create_info.requiredFlags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
   }
 
-  // TODO(benvanik): if on a unified memory system and initial data is present
-  // we could set the mapping bit and ensure a much more efficient upload.
+  // On unified memory systems device-local buffers always come from the
+  // unified memory type and stay mapped for their lifetime so that mapping is
+  // just pointer arithmetic. Initial data uploads below then resolve to a
+  // memcpy into the mapped memory.
+  if (allocator->unified_memory &&
+      iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    allocation_create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocation_create_info.memoryTypeBits =
+        1u << allocator->memory_types.dispatch_idx;
+  }
 
   VkBuffer handle = VK_NULL_HANDLE;
   VmaAllocation allocation = VK_NULL_HANDLE;
@@ -748,6 +870,63 @@ static iree_status_t iree_hal_vulkan_vma_allocator_allocate_buffer(
       /*flags=*/0, out_buffer);
 }
 
+iree_status_t iree_hal_vulkan_vma_allocator_create_aliasing_buffer(
+    iree_hal_buffer_t* backing_buffer, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(backing_buffer);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (!iree_hal_vulkan_vma_buffer_is_aliasable(backing_buffer)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "buffer does not own a VMA allocation to alias");
+  } else if (allocation_size >
+             iree_hal_buffer_allocation_size(backing_buffer)) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "aliasing buffer of %" PRIdsz " bytes exceeds the %" PRIdsz
+        " byte allocation",
+        allocation_size, iree_hal_buffer_allocation_size(backing_buffer));
+  }
+  iree_hal_vulkan_vma_allocator_t* allocator =
+      iree_hal_vulkan_vma_allocator_cast(backing_buffer->device_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  // Use the same usage as the backing buffer so that the memory requirements
+  // of the two match; the caller-visible usage is still limited to |params|.
+  VkBufferCreateInfo buffer_create_info;
+  memset(&buffer_create_info, 0, sizeof(buffer_create_info));
+  buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_create_info.size = allocation_size;
+  buffer_create_info.usage = iree_hal_vulkan_select_buffer_usage_flags(
+      allocator->logical_device,
+      iree_hal_buffer_allowed_usage(backing_buffer));
+  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  VkBuffer handle = VK_NULL_HANDLE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, VK_RESULT_TO_STATUS(
+              vmaCreateAliasingBuffer(
+                  allocator->vma,
+                  iree_hal_vulkan_vma_buffer_allocation(backing_buffer),
+                  &buffer_create_info, &handle),
+              "vmaCreateAliasingBuffer"));
+
+  VkDeviceHandle* logical_device = allocator->logical_device;
+  iree_status_t status = iree_hal_vulkan_vma_buffer_wrap_aliasing(
+      (iree_hal_allocator_t*)allocator,
+      iree_hal_buffer_memory_type(backing_buffer), params->access,
+      params->usage, allocation_size, logical_device, handle, backing_buffer,
+      out_buffer);
+  if (!iree_status_is_ok(status)) {
+    logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
+                                            logical_device->allocator());
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_hal_vulkan_vma_allocator_deallocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
@@ -755,15 +934,200 @@ static void iree_hal_vulkan_vma_allocator_deallocate_buffer(
   iree_hal_buffer_destroy(base_buffer);
 }
 
+// Selects a memory type from |memory_type_bits| that can serve |params| for
+// imported host memory. Returns -1 if no compatible type is available.
+static int iree_hal_vulkan_select_imported_memory_type(
+    const VkPhysicalDeviceMemoryProperties* memory_props,
+    uint32_t memory_type_bits, const iree_hal_buffer_params_t* params) {
+  // Imported memory is always host memory and we don't track flushes on it.
+  VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  if (iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // Only unified memory systems are able to provide device-local host
+    // memory; discrete devices will fail here and the caller will copy.
+    required_flags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  }
+  int selected_idx = -1;
+  for (uint32_t i = 0; i < memory_props->memoryTypeCount; ++i) {
+    if (!(memory_type_bits & (1u << i))) continue;
+    VkMemoryPropertyFlags flags = memory_props->memoryTypes[i].propertyFlags;
+    if (!iree_all_bits_set(flags, required_flags) ||
+        !iree_hal_vulkan_is_memory_type_usable(flags)) {
+      continue;
+    }
+    // Prefer device-local types when available as they are likely faster.
+    if (selected_idx == -1 ||
+        iree_all_bits_set(flags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      selected_idx = (int)i;
+    }
+  }
+  return selected_idx;
+}
+
+// Imports a host allocation using VK_EXT_external_memory_host.
+// The memory is aliased by the device and no copies are performed.
+static iree_status_t iree_hal_vulkan_vma_allocator_import_host_allocation(
+    iree_hal_vulkan_vma_allocator_t* IREE_RESTRICT allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params, void* host_ptr,
+    iree_device_size_t size,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  VkDeviceHandle* logical_device = allocator->logical_device;
+  const auto& syms = logical_device->syms();
+  const VkDeviceSize alignment = allocator->min_imported_host_pointer_alignment;
+  if (!alignment) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "VK_EXT_external_memory_host not available");
+  }
+
+  // Imports must start and end at the required alignment (usually a page). We
+  // import the enclosing aligned range and offset the buffer into it. Pages
+  // are the unit of host memory protection so the widened range is always
+  // addressable; implementations requiring alignments larger than a page may
+  // reject the import in which case the caller falls back to copying.
+  uintptr_t aligned_ptr = (uintptr_t)host_ptr & ~(uintptr_t)(alignment - 1);
+  iree_device_size_t byte_offset = (uintptr_t)host_ptr - aligned_ptr;
+  VkDeviceSize aligned_size =
+      iree_device_align(byte_offset + size, (iree_device_size_t)alignment);
+
+  VkMemoryHostPointerPropertiesEXT host_pointer_props;
+  memset(&host_pointer_props, 0, sizeof(host_pointer_props));
+  host_pointer_props.sType =
+      VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+  VK_RETURN_IF_ERROR(syms->vkGetMemoryHostPointerPropertiesEXT(
+                         *logical_device,
+                         VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                         (void*)aligned_ptr, &host_pointer_props),
+                     "vkGetMemoryHostPointerPropertiesEXT");
+
+  VkExternalMemoryBufferCreateInfo external_create_info;
+  memset(&external_create_info, 0, sizeof(external_create_info));
+  external_create_info.sType =
+      VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+  external_create_info.handleTypes =
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+  VkBufferCreateInfo buffer_create_info;
+  memset(&buffer_create_info, 0, sizeof(buffer_create_info));
+  buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_create_info.pNext = &external_create_info;
+  buffer_create_info.size = aligned_size;
+  buffer_create_info.usage =
+      iree_hal_vulkan_select_buffer_usage_flags(logical_device, params->usage);
+  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  VkBuffer handle = VK_NULL_HANDLE;
+  VK_RETURN_IF_ERROR(
+      syms->vkCreateBuffer(*logical_device, &buffer_create_info,
+                           logical_device->allocator(), &handle),
+      "vkCreateBuffer");
+
+  VkMemoryRequirements memory_requirements;
+  syms->vkGetBufferMemoryRequirements(*logical_device, handle,
+                                      &memory_requirements);
+  const VkPhysicalDeviceMemoryProperties* memory_props = NULL;
+  vmaGetMemoryProperties(allocator->vma, &memory_props);
+  int memory_type_idx = iree_hal_vulkan_select_imported_memory_type(
+      memory_props,
+      memory_requirements.memoryTypeBits & host_pointer_props.memoryTypeBits,
+      params);
+  if (memory_type_idx == -1) {
+    syms->vkDestroyBuffer(*logical_device, handle, logical_device->allocator());
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no memory type compatible with the requested parameters can import "
+        "the host allocation");
+  }
+
+  VkImportMemoryHostPointerInfoEXT import_info;
+  memset(&import_info, 0, sizeof(import_info));
+  import_info.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+  import_info.handleType =
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+  import_info.pHostPointer = (void*)aligned_ptr;
+  // Buffers with device addresses must be bound to memory allocated with them.
+  VkMemoryAllocateFlagsInfo allocate_flags_info;
+  memset(&allocate_flags_info, 0, sizeof(allocate_flags_info));
+  allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  if (iree_all_bits_set(buffer_create_info.usage,
+                        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)) {
+    allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    import_info.pNext = &allocate_flags_info;
+  }
+  VkMemoryAllocateInfo allocate_info;
+  memset(&allocate_info, 0, sizeof(allocate_info));
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = &import_info;
+  allocate_info.allocationSize = aligned_size;
+  allocate_info.memoryTypeIndex = (uint32_t)memory_type_idx;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      syms->vkAllocateMemory(*logical_device, &allocate_info,
+                             logical_device->allocator(), &memory),
+      "vkAllocateMemory");
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms->vkBindBufferMemory(*logical_device, handle, memory, 0),
+        "vkBindBufferMemory");
+  }
+
+  // Reflect the memory type we actually got back to the caller.
+  VkMemoryPropertyFlags flags =
+      memory_props->memoryTypes[memory_type_idx].propertyFlags;
+  iree_hal_memory_type_t memory_type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  if (iree_all_bits_set(flags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+    memory_type |= IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  } else {
+    memory_type |= IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  }
+  if (iree_all_bits_set(flags, VK_MEMORY_PROPERTY_HOST_CACHED_BIT)) {
+    memory_type |= IREE_HAL_MEMORY_TYPE_HOST_CACHED;
+  }
+
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_vma_buffer_wrap_imported(
+        (iree_hal_allocator_t*)allocator, memory_type, params->access,
+        params->usage, aligned_size, byte_offset, size, logical_device, handle,
+        memory, (void*)aligned_ptr, release_callback, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    if (memory) {
+      syms->vkFreeMemory(*logical_device, memory, logical_device->allocator());
+    }
+    syms->vkDestroyBuffer(*logical_device, handle, logical_device->allocator());
+  }
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_vma_allocator_import_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
     iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
     iree_hal_buffer_release_callback_t release_callback,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(#7242): use VK_EXT_external_memory_host to import memory.
-  return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                          "importing from external buffers not supported");
+  iree_hal_vulkan_vma_allocator_t* allocator =
+      iree_hal_vulkan_vma_allocator_cast(base_allocator);
+
+  // Coerce options into those required by the current device.
+  iree_hal_buffer_params_t compat_params = *params;
+  iree_device_size_t allocation_size = external_buffer->size;
+  iree_hal_vulkan_vma_allocator_query_buffer_compatibility(
+      base_allocator, &compat_params, &allocation_size);
+
+  switch (external_buffer->type) {
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION:
+      return iree_hal_vulkan_vma_allocator_import_host_allocation(
+          allocator, &compat_params,
+          external_buffer->handle.host_allocation.ptr, external_buffer->size,
+          release_callback, out_buffer);
+    default:
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "importing from external buffer type %d not "
+                              "supported",
+                              (int)external_buffer->type);
+  }
 }
 
 static iree_status_t iree_hal_vulkan_vma_allocator_export_buffer(
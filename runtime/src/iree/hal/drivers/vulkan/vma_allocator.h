@@ -39,6 +39,18 @@ iree_status_t iree_hal_vulkan_vma_allocator_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
     iree_hal_device_t* device, iree_hal_allocator_t** out_allocator);
 
+// Creates a buffer of |allocation_size| bytes that aliases the device memory
+// of |backing_buffer|, which must have been allocated by a VMA allocator.
+// The new buffer retains |backing_buffer| and reuses its memory without any
+// new device allocation. The caller must ensure that the two buffers are never
+// in use by the device at the same time (such as by only aliasing buffers that
+// have been retired on the device timeline).
+//
+// Returns IREE_STATUS_UNAVAILABLE if |backing_buffer| cannot be aliased.
+iree_status_t iree_hal_vulkan_vma_allocator_create_aliasing_buffer(
+    iree_hal_buffer_t* backing_buffer, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -25,6 +25,25 @@ typedef struct iree_hal_vulkan_vma_buffer_t {
   VkBuffer handle;
   VmaAllocation allocation;
   VmaAllocationInfo allocation_info;
+
+  // Device address of |handle| queried on first use, or 0 if not yet queried.
+  VkDeviceAddress device_address;
+
+  // Only used for buffers aliasing the VMA allocation of another buffer.
+  // The VkBuffer |handle| is owned by this buffer while |vma|, |allocation|,
+  // and |allocation_info| are borrowed from the retained |buffer|.
+  struct {
+    iree::hal::vulkan::VkDeviceHandle* logical_device;
+    iree_hal_buffer_t* buffer;
+  } aliased;
+
+  // Only used for buffers wrapping imported memory (where |vma| is NULL).
+  struct {
+    iree::hal::vulkan::VkDeviceHandle* logical_device;
+    VkDeviceMemory memory;
+    void* host_ptr;
+    iree_hal_buffer_release_callback_t release_callback;
+  } imported;
 } iree_hal_vulkan_vma_buffer_t;
 
 namespace {
@@ -66,6 +85,9 @@ iree_status_t iree_hal_vulkan_vma_buffer_wrap(
     buffer->handle = handle;
     buffer->allocation = allocation;
     buffer->allocation_info = allocation_info;
+    buffer->device_address = 0;
+    memset(&buffer->aliased, 0, sizeof(buffer->aliased));
+    memset(&buffer->imported, 0, sizeof(buffer->imported));
 
     // TODO(benvanik): set debug name instead and use the
     //     VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT flag.
@@ -83,6 +105,95 @@ iree_status_t iree_hal_vulkan_vma_buffer_wrap(
   return iree_ok_status();
 }
 
+iree_status_t iree_hal_vulkan_vma_buffer_wrap_imported(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkDeviceMemory memory, void* host_ptr,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(memory);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(allocator);
+  iree_hal_vulkan_vma_buffer_t* buffer = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_initialize(
+        host_allocator, allocator, &buffer->base, allocation_size, byte_offset,
+        byte_length, memory_type, allowed_access, allowed_usage,
+        &iree_hal_vulkan_vma_buffer_vtable, &buffer->base);
+    buffer->vma = VK_NULL_HANDLE;
+    buffer->handle = handle;
+    buffer->allocation = VK_NULL_HANDLE;
+    memset(&buffer->allocation_info, 0, sizeof(buffer->allocation_info));
+    buffer->device_address = 0;
+    memset(&buffer->aliased, 0, sizeof(buffer->aliased));
+    buffer->imported.logical_device = logical_device;
+    buffer->imported.memory = memory;
+    buffer->imported.host_ptr = host_ptr;
+    buffer->imported.release_callback = release_callback;
+    *out_buffer = &buffer->base;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_vulkan_vma_buffer_wrap_aliasing(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    iree_hal_buffer_t* aliased_buffer, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(aliased_buffer);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)allocation_size);
+
+  iree_hal_vulkan_vma_buffer_t* source =
+      iree_hal_vulkan_vma_buffer_cast(aliased_buffer);
+  IREE_ASSERT(source->vma && !source->aliased.buffer);
+
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(allocator);
+  iree_hal_vulkan_vma_buffer_t* buffer = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_initialize(
+        host_allocator, allocator, &buffer->base, allocation_size,
+        /*byte_offset=*/0, /*byte_length=*/allocation_size, memory_type,
+        allowed_access, allowed_usage, &iree_hal_vulkan_vma_buffer_vtable,
+        &buffer->base);
+    buffer->vma = source->vma;
+    buffer->handle = handle;
+    buffer->allocation = source->allocation;
+    buffer->allocation_info = source->allocation_info;
+    buffer->device_address = 0;
+    buffer->aliased.logical_device = logical_device;
+    buffer->aliased.buffer = aliased_buffer;
+    iree_hal_buffer_retain(aliased_buffer);
+    memset(&buffer->imported, 0, sizeof(buffer->imported));
+    *out_buffer = &buffer->base;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_hal_vulkan_vma_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   iree_hal_vulkan_vma_buffer_t* buffer =
       iree_hal_vulkan_vma_buffer_cast(base_buffer);
@@ -91,10 +202,27 @@ static void iree_hal_vulkan_vma_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   IREE_TRACE_ZONE_APPEND_VALUE(
       z0, (int64_t)iree_hal_buffer_allocation_size(base_buffer));
 
-  IREE_TRACE_FREE_NAMED(IREE_HAL_VULKAN_VMA_ALLOCATOR_ID,
-                        (void*)buffer->handle);
-
-  vmaDestroyBuffer(buffer->vma, buffer->handle, buffer->allocation);
+  if (buffer->aliased.buffer) {
+    // Only the aliasing handle is ours; the memory stays with the source.
+    auto* logical_device = buffer->aliased.logical_device;
+    logical_device->syms()->vkDestroyBuffer(*logical_device, buffer->handle,
+                                            logical_device->allocator());
+    iree_hal_buffer_release(buffer->aliased.buffer);
+  } else if (buffer->vma) {
+    IREE_TRACE_FREE_NAMED(IREE_HAL_VULKAN_VMA_ALLOCATOR_ID,
+                          (void*)buffer->handle);
+    vmaDestroyBuffer(buffer->vma, buffer->handle, buffer->allocation);
+  } else {
+    auto* logical_device = buffer->imported.logical_device;
+    logical_device->syms()->vkDestroyBuffer(*logical_device, buffer->handle,
+                                            logical_device->allocator());
+    logical_device->syms()->vkFreeMemory(
+        *logical_device, buffer->imported.memory, logical_device->allocator());
+    if (buffer->imported.release_callback.fn) {
+      buffer->imported.release_callback.fn(
+          buffer->imported.release_callback.user_data, base_buffer);
+    }
+  }
   iree_allocator_free(host_allocator, buffer);
 
   IREE_TRACE_ZONE_END(z0);
@@ -106,6 +234,50 @@ VkBuffer iree_hal_vulkan_vma_buffer_handle(iree_hal_buffer_t* base_buffer) {
   return buffer->handle;
 }
 
+bool iree_hal_vulkan_vma_buffer_is_aliasable(iree_hal_buffer_t* base_buffer) {
+  if (!iree_hal_resource_is(base_buffer, &iree_hal_vulkan_vma_buffer_vtable)) {
+    return false;
+  }
+  iree_hal_vulkan_vma_buffer_t* buffer =
+      (iree_hal_vulkan_vma_buffer_t*)base_buffer;
+  return buffer->vma && !buffer->aliased.buffer;
+}
+
+iree_hal_buffer_t* iree_hal_vulkan_vma_buffer_aliased_buffer(
+    iree_hal_buffer_t* base_buffer) {
+  if (!iree_hal_resource_is(base_buffer, &iree_hal_vulkan_vma_buffer_vtable)) {
+    return NULL;
+  }
+  iree_hal_vulkan_vma_buffer_t* buffer =
+      (iree_hal_vulkan_vma_buffer_t*)base_buffer;
+  return buffer->aliased.buffer;
+}
+
+VmaAllocation iree_hal_vulkan_vma_buffer_allocation(
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_vulkan_vma_buffer_t* buffer =
+      iree_hal_vulkan_vma_buffer_cast(base_buffer);
+  return buffer->allocation;
+}
+
+VkDeviceAddress iree_hal_vulkan_vma_buffer_device_address(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_vulkan_vma_buffer_t* buffer =
+      iree_hal_vulkan_vma_buffer_cast(base_buffer);
+  if (IREE_UNLIKELY(!buffer->device_address)) {
+    // Racing queries return the same address so no synchronization is needed.
+    VkBufferDeviceAddressInfo address_info;
+    memset(&address_info, 0, sizeof(address_info));
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.buffer = buffer->handle;
+    buffer->device_address =
+        logical_device->syms()->vkGetBufferDeviceAddressKHR(*logical_device,
+                                                            &address_info);
+  }
+  return buffer->device_address;
+}
+
 static iree_status_t iree_hal_vulkan_vma_buffer_map_range(
     iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
     iree_hal_memory_access_t memory_access,
@@ -123,9 +295,19 @@ static iree_status_t iree_hal_vulkan_vma_buffer_map_range(
                                      IREE_HAL_BUFFER_USAGE_MAPPING));
 
   uint8_t* data_ptr = nullptr;
-  VK_RETURN_IF_ERROR(
-      vmaMapMemory(buffer->vma, buffer->allocation, (void**)&data_ptr),
-      "vmaMapMemory");
+  if (buffer->allocation_info.pMappedData) {
+    // Persistently mapped (unified memory); no need to go through VMA.
+    data_ptr = (uint8_t*)buffer->allocation_info.pMappedData;
+  } else if (buffer->vma) {
+    VK_RETURN_IF_ERROR(
+        vmaMapMemory(buffer->vma, buffer->allocation, (void**)&data_ptr),
+        "vmaMapMemory");
+  } else if (buffer->imported.host_ptr) {
+    data_ptr = (uint8_t*)buffer->imported.host_ptr;
+  } else {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "imported buffer has no host pointer to map");
+  }
   mapping->contents =
       iree_make_byte_span(data_ptr + local_byte_offset, local_byte_length);
 
@@ -147,7 +329,9 @@ static iree_status_t iree_hal_vulkan_vma_buffer_unmap_range(
     iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
   iree_hal_vulkan_vma_buffer_t* buffer =
       iree_hal_vulkan_vma_buffer_cast(base_buffer);
-  vmaUnmapMemory(buffer->vma, buffer->allocation);
+  if (buffer->vma && !buffer->allocation_info.pMappedData) {
+    vmaUnmapMemory(buffer->vma, buffer->allocation);
+  }
   return iree_ok_status();
 }
 
@@ -156,6 +340,8 @@ static iree_status_t iree_hal_vulkan_vma_buffer_invalidate_range(
     iree_device_size_t local_byte_length) {
   iree_hal_vulkan_vma_buffer_t* buffer =
       iree_hal_vulkan_vma_buffer_cast(base_buffer);
+  // Imported host memory is only ever bound to host-coherent memory types.
+  if (!buffer->vma) return iree_ok_status();
   VK_RETURN_IF_ERROR(
       vmaInvalidateAllocation(buffer->vma, buffer->allocation,
                               local_byte_offset, local_byte_length),
@@ -168,6 +354,8 @@ static iree_status_t iree_hal_vulkan_vma_buffer_flush_range(
     iree_device_size_t local_byte_length) {
   iree_hal_vulkan_vma_buffer_t* buffer =
       iree_hal_vulkan_vma_buffer_cast(base_buffer);
+  // Imported host memory is only ever bound to host-coherent memory types.
+  if (!buffer->vma) return iree_ok_status();
   VK_RETURN_IF_ERROR(vmaFlushAllocation(buffer->vma, buffer->allocation,
                                         local_byte_offset, local_byte_length),
                      "vmaFlushAllocation");
@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/vulkan/handle_util.h"
 #include "iree/hal/drivers/vulkan/internal_vk_mem_alloc.h"
 
 #ifdef __cplusplus
@@ -25,11 +26,59 @@ iree_status_t iree_hal_vulkan_vma_buffer_wrap(
     VmaAllocator vma, VkBuffer handle, VmaAllocation allocation,
     VmaAllocationInfo allocation_info, iree_hal_buffer_t** out_buffer);
 
+// Wraps imported external |memory| bound to |handle| in an iree_hal_buffer_t.
+// The memory is not managed by VMA and is freed along with the buffer handle
+// when the buffer is released, after which |release_callback| is issued so
+// that the owner of the external memory can release it. |host_ptr| is the
+// host pointer the memory was imported from, if any, and is used for mapping.
+iree_status_t iree_hal_vulkan_vma_buffer_wrap_imported(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkDeviceMemory memory, void* host_ptr,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** out_buffer);
+
+// Wraps |handle|, a VkBuffer bound to the same VMA allocation as
+// |aliased_buffer| with vmaCreateAliasingBuffer, in an iree_hal_buffer_t.
+// |aliased_buffer| is retained for the lifetime of the new buffer and only
+// |handle| is destroyed when it is released. The caller must ensure the two
+// buffers are never in use by the device at the same time.
+iree_status_t iree_hal_vulkan_vma_buffer_wrap_aliasing(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    iree_hal_buffer_t* aliased_buffer, iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a VMA buffer owning its allocation such that
+// other buffers may be bound to alias its memory.
+bool iree_hal_vulkan_vma_buffer_is_aliasable(iree_hal_buffer_t* buffer);
+
+// Returns the buffer whose memory |buffer| aliases or NULL if |buffer| is not
+// an aliasing VMA buffer.
+iree_hal_buffer_t* iree_hal_vulkan_vma_buffer_aliased_buffer(
+    iree_hal_buffer_t* buffer);
+
+// Returns the VMA allocation backing the given |buffer| or NULL if the buffer
+// wraps imported memory.
+VmaAllocation iree_hal_vulkan_vma_buffer_allocation(iree_hal_buffer_t* buffer);
+
 // Returns the Vulkan handle backing the given |buffer|.
 // This is the entire allocated_buffer and must be offset by the buffer
 // byte_offset and byte_length when used.
 VkBuffer iree_hal_vulkan_vma_buffer_handle(iree_hal_buffer_t* buffer);
 
+// Returns the device address of the Vulkan buffer backing the given |buffer|.
+// As with the handle this is the address of the entire allocated_buffer. The
+// buffer must have been allocated with device addresses enabled on
+// |logical_device|.
+VkDeviceAddress iree_hal_vulkan_vma_buffer_device_address(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_buffer_t* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
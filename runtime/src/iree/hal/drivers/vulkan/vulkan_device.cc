@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/file_io.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/vulkan/api.h"
@@ -29,6 +30,7 @@
 #include "iree/hal/drivers/vulkan/nop_executable_cache.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/tracing.h"
+#include "iree/hal/drivers/vulkan/transient_buffer_pool.h"
 #include "iree/hal/drivers/vulkan/util/arena.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
 #include "iree/hal/drivers/vulkan/vma_allocator.h"
@@ -198,6 +200,13 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
 
+  // VK_EXT_external_memory_host:
+  // Allows importing host allocations such as constants mapped from the
+  // module file without copying them into device memory. When not present
+  // the compiler-emitted fallback allocates and copies.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+
   //===--------------------------------------------------------------------===//
   // Vulkan forward-compatibility shims
   //===--------------------------------------------------------------------===//
@@ -220,6 +229,13 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
 
+  // VK_KHR_buffer_device_address:
+  // This extension allows executables compiled to take their bindings as
+  // buffer device addresses in push constants to skip descriptor set updates
+  // entirely. It's promoted to core since Vulkan v1.2.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+
   //===--------------------------------------------------------------------===//
   // Optional debugging features
   //===--------------------------------------------------------------------===//
@@ -305,8 +321,7 @@ static uint32_t iree_hal_vulkan_find_first_queue_family_with_flags(
 }
 
 // Selects queue family indices for compute and transfer queues.
-// Note that both queue families may be the same if there is only one family
-// available.
+// Transfer queues, if any, are always in the dispatch queue family.
 static iree_status_t iree_hal_vulkan_select_queue_families(
     const iree_hal_vulkan_device_options_t* options,
     VkPhysicalDevice physical_device, iree::hal::vulkan::DynamicSymbols* syms,
@@ -355,55 +370,29 @@ static iree_status_t iree_hal_vulkan_select_queue_families(
         IREE_STATUS_NOT_FOUND,
         "unable to find any queue family support compute operations");
   }
-  out_family_info->dispatch_queue_count =
-      queue_family_properties[out_family_info->dispatch_index].queueCount;
-
-  // Try to find a dedicated transfer queue (no compute or graphics caps).
-  // Not all devices have one, and some have only a queue family for
-  // everything and possibly a queue family just for compute/etc. If that
-  // fails then fallback to any queue that supports transfer. Finally, if
-  // /that/ fails then we just won't create a transfer queue and instead use
-  // the compute queue for all operations.
-  out_family_info->transfer_index =
-      iree_hal_vulkan_find_first_queue_family_with_flags(
-          queue_family_count, queue_family_properties, VK_QUEUE_TRANSFER_BIT,
-          VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT);
-  if (out_family_info->transfer_index ==
-      IREE_HAL_VULKAN_INVALID_QUEUE_FAMILY_INDEX) {
-    out_family_info->transfer_index =
-        iree_hal_vulkan_find_first_queue_family_with_flags(
-            queue_family_count, queue_family_properties, VK_QUEUE_TRANSFER_BIT,
-            VK_QUEUE_GRAPHICS_BIT);
-  }
-  if (out_family_info->transfer_index ==
-      IREE_HAL_VULKAN_INVALID_QUEUE_FAMILY_INDEX) {
-    out_family_info->transfer_index =
-        iree_hal_vulkan_find_first_queue_family_with_flags(
-            queue_family_count, queue_family_properties, VK_QUEUE_TRANSFER_BIT,
-            0);
-  }
-  if (out_family_info->transfer_index !=
-      IREE_HAL_VULKAN_INVALID_QUEUE_FAMILY_INDEX) {
-    out_family_info->transfer_queue_count =
-        queue_family_properties[out_family_info->transfer_index].queueCount;
-  }
 
-  // Ensure that we don't share the dispatch queues with transfer queues if
-  // that would put us over the queue count.
-  if (out_family_info->dispatch_index == out_family_info->transfer_index) {
-    out_family_info->transfer_queue_count = iree_min(
-        queue_family_properties[out_family_info->dispatch_index].queueCount -
-            out_family_info->dispatch_queue_count,
-        out_family_info->transfer_queue_count);
+  // Transfer queues are taken from the spare queues of the dispatch family.
+  // Command buffers are allocated from the dispatch family command pool and
+  // buffers are created with exclusive sharing so a dedicated transfer family
+  // would require queue family ownership transfers on every use. Queues within
+  // a family are still scheduled independently by the device and transfers
+  // submitted to them overlap with dispatches. If there are no spare queues
+  // then we just won't create a transfer queue and instead use the compute
+  // queues for all operations.
+  uint32_t family_queue_count =
+      queue_family_properties[out_family_info->dispatch_index].queueCount;
+  if (family_queue_count > 1) {
+    out_family_info->transfer_index = out_family_info->dispatch_index;
+    out_family_info->transfer_queue_count = 1;
   }
+  out_family_info->dispatch_queue_count =
+      family_queue_count - out_family_info->transfer_queue_count;
 
   // Limit the number of queues we create (for now).
   // We may want to allow this to grow, but each queue adds overhead and we
   // need to measure to make sure we can effectively use them all.
   out_family_info->dispatch_queue_count =
       iree_min(2u, out_family_info->dispatch_queue_count);
-  out_family_info->transfer_queue_count =
-      iree_min(1u, out_family_info->transfer_queue_count);
 
   return iree_ok_status();
 }
@@ -433,7 +422,7 @@ static iree_status_t iree_hal_vulkan_build_queue_sets(
   uint32_t base_queue_index = 0;
   if (queue_family_info.dispatch_index == queue_family_info.transfer_index) {
     // Sharing a family, so transfer queues follow compute queues.
-    base_queue_index = queue_family_info.dispatch_index;
+    base_queue_index = (uint32_t)queue_family_info.dispatch_queue_count;
   }
   for (iree_host_size_t i = 0; i < queue_family_info.transfer_queue_count;
        ++i) {
@@ -484,8 +473,20 @@ typedef struct iree_hal_vulkan_device_t {
 
   DescriptorPoolCache* descriptor_pool_cache;
 
+  // Buffers recycled from queue-ordered deallocations for reuse by subsequent
+  // queue-ordered allocations.
+  TransientBufferPool* transient_buffer_pool;
+
+  // Command pool for all command buffers. Transfer queues share the dispatch
+  // queue family and can execute command buffers allocated from it.
   VkCommandPoolHandle* dispatch_command_pool;
-  VkCommandPoolHandle* transfer_command_pool;
+
+  // Pipeline cache shared by all executables created on the device.
+  VkPipelineCache pipeline_cache;
+  // NUL-terminated path the pipeline cache is persisted to, if any.
+  iree_string_view_t pipeline_cache_path;
+  // Maximum number of threads used to create the pipelines of an executable.
+  iree_host_size_t pipeline_creation_thread_count;
 
   // Block pool used for command buffers with a larger block size (as command
   // buffers can contain inlined data uploads).
@@ -513,6 +514,8 @@ IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
   memset(out_options, 0, sizeof(*out_options));
   out_options->flags = 0;
   out_options->large_heap_block_size = 64 * 1024 * 1024;
+  out_options->pipeline_cache_path = iree_string_view_empty();
+  out_options->pipeline_creation_thread_count = 1;
 }
 
 // Creates a transient command pool for the given queue family.
@@ -553,6 +556,72 @@ static CommandQueue* iree_hal_vulkan_device_create_queue(
   return new DirectCommandQueue(logical_device, command_category, queue);
 }
 
+// Creates the device pipeline cache, seeding it with the contents of the file
+// at |device->pipeline_cache_path| if one exists. Implementations validate the
+// data header and ignore data from a different device or driver version.
+static iree_status_t iree_hal_vulkan_device_create_pipeline_cache(
+    iree_hal_vulkan_device_t* device) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_file_contents_t* contents = NULL;
+  if (!iree_string_view_is_empty(device->pipeline_cache_path) &&
+      iree_status_is_ok(iree_file_exists(device->pipeline_cache_path.data))) {
+    // A cache that cannot be read is treated as empty and rebuilt.
+    iree_status_ignore(iree_file_read_contents(
+        device->pipeline_cache_path.data, IREE_FILE_READ_FLAG_DEFAULT,
+        device->host_allocator, &contents));
+  }
+
+  VkPipelineCacheCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.pNext = NULL;
+  create_info.flags = 0;
+  create_info.initialDataSize =
+      contents ? contents->const_buffer.data_length : 0;
+  create_info.pInitialData = contents ? contents->const_buffer.data : NULL;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      device->logical_device->syms()->vkCreatePipelineCache(
+          *device->logical_device, &create_info,
+          device->logical_device->allocator(), &device->pipeline_cache),
+      "vkCreatePipelineCache");
+  iree_file_contents_free(contents);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Writes the contents of the device pipeline cache to
+// |device->pipeline_cache_path|, if set. Failures are ignored as the cache
+// will be rebuilt on the next run.
+static void iree_hal_vulkan_device_persist_pipeline_cache(
+    iree_hal_vulkan_device_t* device) {
+  if (device->pipeline_cache == VK_NULL_HANDLE ||
+      iree_string_view_is_empty(device->pipeline_cache_path)) {
+    return;
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const auto& syms = device->logical_device->syms();
+  size_t data_size = 0;
+  VkResult result = syms->vkGetPipelineCacheData(
+      *device->logical_device, device->pipeline_cache, &data_size, NULL);
+  void* data = NULL;
+  if (result == VK_SUCCESS && data_size > 0 &&
+      iree_status_is_ok(iree_allocator_malloc(device->host_allocator,
+                                              data_size, &data))) {
+    result = syms->vkGetPipelineCacheData(
+        *device->logical_device, device->pipeline_cache, &data_size, data);
+    if (result == VK_SUCCESS) {
+      iree_status_ignore(iree_file_write_contents(
+          device->pipeline_cache_path.data,
+          iree_make_const_byte_span(data, data_size)));
+    }
+    iree_allocator_free(device->host_allocator, data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 // Creates command queues for the given sets of queues and populates the
 // device queue lists.
 static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
@@ -573,6 +642,12 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
       iree_math_count_ones_u64(compute_queue_set->queue_indices);
   uint64_t transfer_queue_count =
       iree_math_count_ones_u64(transfer_queue_set->queue_indices);
+  if (transfer_queue_set->queue_family_index !=
+      compute_queue_set->queue_family_index) {
+    // Command buffers are only allocated from the dispatch family command
+    // pool and cannot execute on queues of other families.
+    transfer_queue_count = 0;
+  }
   for (iree_host_size_t i = 0; i < compute_queue_count; ++i) {
     if (!(compute_queue_set->queue_indices & (1ull << i))) continue;
 
@@ -611,8 +686,12 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
       queue->set_tracing_context(device->queue_tracing_contexts[queue_index]);
     }
   }
-  for (iree_host_size_t i = 0; i < transfer_queue_count; ++i) {
-    if (!(transfer_queue_set->queue_indices & (1ull << i))) continue;
+  // Transfer queues sharing the dispatch family follow the compute queues.
+  uint64_t transfer_queue_indices =
+      transfer_queue_count ? transfer_queue_set->queue_indices : 0;
+  while (transfer_queue_indices) {
+    uint32_t i = iree_math_count_trailing_zeros_u64(transfer_queue_indices);
+    transfer_queue_indices &= transfer_queue_indices - 1;
 
     char queue_name_buffer[32];
     int queue_name_length =
@@ -662,6 +741,7 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   iree_hal_vulkan_device_t* device = NULL;
   iree_host_size_t total_size =
       sizeof(*device) + identifier.size +
+      options->pipeline_cache_path.size + /*NUL=*/1 +
       total_queue_count * sizeof(device->queues[0]) +
       total_queue_count * sizeof(device->dispatch_queues[0]) +
       total_queue_count * sizeof(device->transfer_queues[0]) +
@@ -677,7 +757,13 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   uint8_t* buffer_ptr = (uint8_t*)device + sizeof(*device);
   buffer_ptr += iree_string_view_append_to_buffer(
       identifier, &device->identifier, (char*)buffer_ptr);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      options->pipeline_cache_path, &device->pipeline_cache_path,
+      (char*)buffer_ptr);
+  *buffer_ptr++ = 0;  // NUL terminator for file APIs.
   device->flags = options->flags;
+  device->pipeline_creation_thread_count =
+      iree_max(1, options->pipeline_creation_thread_count);
 
   device->device_extensions = *device_extensions;
   device->instance = instance;
@@ -706,6 +792,7 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
 
   device->descriptor_pool_cache =
       new DescriptorPoolCache(device->logical_device);
+  device->transient_buffer_pool = new TransientBufferPool();
 
   // Create the device memory allocator that will service all buffer
   // allocation requests.
@@ -713,21 +800,19 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
       options, instance, physical_device, logical_device,
       (iree_hal_device_t*)device, &device->device_allocator);
 
-  // Create command pools for each queue family. If we don't have a transfer
-  // queue then we'll ignore that one and just use the dispatch pool.
-  // If we wanted to expose the pools through the HAL to allow the VM to more
-  // effectively manage them (pool per fiber, etc) we could, however I doubt
-  // the overhead of locking the pool will be even a blip.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_device_create_pipeline_cache(device);
+  }
+
+  // Create the command pool for the dispatch queue family. If we wanted to
+  // expose the pools through the HAL to allow the VM to more effectively
+  // manage them (pool per fiber, etc) we could, however I doubt the overhead
+  // of locking the pool will be even a blip.
   if (iree_status_is_ok(status)) {
     status = iree_hal_vulkan_create_transient_command_pool(
         device->logical_device, compute_queue_set->queue_family_index,
         &device->dispatch_command_pool);
   }
-  if (transfer_queue_set->queue_indices != 0 && iree_status_is_ok(status)) {
-    status = iree_hal_vulkan_create_transient_command_pool(
-        device->logical_device, transfer_queue_set->queue_family_index,
-        &device->transfer_command_pool);
-  }
 
   // Initialize queues now that we've completed the rest of the device
   // initialization; this happens last as the queues require the pools allocated
@@ -766,13 +851,23 @@ static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
   // Drop command pools now that we know there are no more outstanding command
   // buffers.
   delete device->dispatch_command_pool;
-  delete device->transfer_command_pool;
 
   // Now that no commands are outstanding we can release all resources that may
   // have been in use.
   delete device->builtin_executables;
   delete device->descriptor_pool_cache;
 
+  // No more pipelines will be created so the cache contents are final.
+  iree_hal_vulkan_device_persist_pipeline_cache(device);
+  if (device->pipeline_cache != VK_NULL_HANDLE) {
+    device->logical_device->syms()->vkDestroyPipelineCache(
+        *device->logical_device, device->pipeline_cache,
+        device->logical_device->allocator());
+  }
+
+  // Release all pooled transient buffers back to the allocator.
+  delete device->transient_buffer_pool;
+
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
 
@@ -942,6 +1037,19 @@ iree_status_t iree_hal_vulkan_device_create(
     subgroup_control_features.subgroupSizeControl = VK_TRUE;
   }
 
+  // The bufferDeviceAddress feature must be supported by all implementations
+  // exposing the extension.
+  VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address_features;
+  if (enabled_device_extensions.buffer_device_address) {
+    memset(&buffer_device_address_features, 0,
+           sizeof(buffer_device_address_features));
+    buffer_device_address_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+    buffer_device_address_features.pNext = features2.pNext;
+    features2.pNext = &buffer_device_address_features;
+    buffer_device_address_features.bufferDeviceAddress = VK_TRUE;
+  }
+
   auto logical_device = new VkDeviceHandle(
       instance_syms, enabled_device_extensions,
       /*owns_device=*/true, host_allocator, /*allocator=*/NULL);
@@ -954,6 +1062,20 @@ iree_status_t iree_hal_vulkan_device_create(
   if (iree_status_is_ok(status)) {
     status = logical_device->syms()->LoadFromDevice(instance,
                                                     logical_device->value());
+    if (!iree_status_is_ok(status)) {
+      // LoadFromDevice overwrites the function pointers as it goes and may
+      // have left vkDestroyDevice null. Destroy the device here with a
+      // directly queried pointer so that the handle does not try to call
+      // through a null one when it is released.
+      PFN_vkDestroyDevice destroy_device =
+          reinterpret_cast<PFN_vkDestroyDevice>(
+              instance_syms->vkGetInstanceProcAddr(instance,
+                                                   "vkDestroyDevice"));
+      if (destroy_device) {
+        destroy_device(logical_device->value(), logical_device->allocator());
+      }
+      *logical_device->mutable_value() = VK_NULL_HANDLE;
+    }
   }
 
   // Select queue indices and create command queues with them.
@@ -1061,6 +1183,7 @@ static iree_status_t iree_hal_vulkan_device_trim(
     iree_hal_device_t* base_device) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
+  device->transient_buffer_pool->Trim();
   return iree_hal_allocator_trim(device->device_allocator);
 }
 
@@ -1087,26 +1210,20 @@ static iree_status_t iree_hal_vulkan_device_query_i64(
 }
 
 // Returns the queue to submit work to based on the |queue_affinity|.
+// Work containing only transfer commands is placed on transfer queues (if any)
+// so that it may overlap with dispatches. The lowest bit set in the affinity
+// selects among the queues of the chosen category.
 static CommandQueue* iree_hal_vulkan_device_select_queue(
     iree_hal_vulkan_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // TODO(benvanik): meaningful heuristics for affinity. We don't generate
-  // anything from the compiler that uses multiple queues and until we do it's
-  // best not to do anything too clever here.
+  iree_host_size_t queue_ordinal =
+      queue_affinity ? iree_math_count_trailing_zeros_u64(queue_affinity) : 0;
   if (command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER) {
     return device
-        ->transfer_queues[queue_affinity % device->transfer_queue_count];
+        ->transfer_queues[queue_ordinal % device->transfer_queue_count];
   }
-  return device->dispatch_queues[queue_affinity % device->dispatch_queue_count];
+  return device->dispatch_queues[queue_ordinal % device->dispatch_queue_count];
 }
 
 static iree_status_t iree_hal_vulkan_device_create_channel(
@@ -1123,36 +1240,18 @@ static iree_status_t iree_hal_vulkan_device_create_command_buffer(
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
 
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // Select the command pool to used based on the types of commands used.
-  // Note that we may not have a dedicated transfer command pool if there are
-  // no dedicated transfer queues.
-  VkCommandPoolHandle* command_pool = NULL;
-  if (device->transfer_command_pool &&
-      !iree_all_bits_set(command_categories,
-                         IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
-    command_pool = device->transfer_command_pool;
-  } else {
-    command_pool = device->dispatch_command_pool;
-  }
-
   // The tracing context is tied to a particular queue so we must select here
-  // even though ideally we'd do it during submission. This is informational
-  // only and if the user does provide a different queue affinity during
-  // submission it just means the commands will be attributed to the wrong
-  // queue.
+  // even though ideally we'd do it during submission. Traced command buffers
+  // always execute on dispatch queues as transfer commands may be emulated
+  // with dispatches and the queue is only known once recording completes.
+  // This is informational only and if the user does provide a different queue
+  // affinity during submission it just means the commands will be attributed
+  // to the wrong queue.
   CommandQueue* queue = iree_hal_vulkan_device_select_queue(
-      device, command_categories, queue_affinity);
+      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
 
   return iree_hal_vulkan_direct_command_buffer_allocate(
-      base_device, device->logical_device, command_pool, mode,
+      base_device, device->logical_device, device->dispatch_command_pool, mode,
       command_categories, queue_affinity, binding_capacity,
       queue->tracing_context(), device->descriptor_pool_cache,
       device->builtin_executables, &device->block_pool, out_command_buffer);
@@ -1181,7 +1280,8 @@ static iree_status_t iree_hal_vulkan_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   return iree_hal_vulkan_nop_executable_cache_create(
-      device->logical_device, identifier, out_executable_cache);
+      device->logical_device, identifier, device->pipeline_cache,
+      device->pipeline_creation_thread_count, out_executable_cache);
 }
 
 static iree_status_t iree_hal_vulkan_device_create_pipeline_layout(
@@ -1224,14 +1324,21 @@ static iree_status_t iree_hal_vulkan_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
-      iree_hal_device_allocator(base_device), params, allocation_size,
-      iree_const_byte_span_empty(), out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // Reuse a buffer whose deallocation has completed on the device timeline or
+  // allocate a new one. The buffer is available immediately on the host but
+  // the caller may only use it once the signal semaphores are reached so we
+  // order the signal after the waits with a barrier instead of blocking.
+  IREE_RETURN_IF_ERROR(device->transient_buffer_pool->Acquire(
+      device->device_allocator, params, allocation_size, out_buffer));
+  iree_status_t status = iree_hal_device_queue_barrier(
+      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(*out_buffer);
+    *out_buffer = NULL;
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_dealloca(
@@ -1239,9 +1346,13 @@ static iree_status_t iree_hal_vulkan_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // The buffer may still be in use by work prior to the wait semaphores so it
+  // can only be reused once the signal semaphores have been reached.
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
+  device->transient_buffer_pool->Release(buffer, signal_semaphore_list);
   return iree_ok_status();
 }
 
@@ -1252,9 +1363,19 @@ static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  // NOTE: today we are not discriminating queues based on command type.
+
+  // Route based on what was actually recorded: command buffers declared as
+  // dispatch may only contain transfers and those declared as transfer may
+  // contain emulated fills. Submissions without command buffers are ordered on
+  // the dispatch queues.
+  iree_hal_command_category_t command_categories = 0;
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    command_categories |=
+        iree_hal_vulkan_direct_command_buffer_recorded_categories(
+            command_buffers[i]);
+  }
   CommandQueue* queue = iree_hal_vulkan_device_select_queue(
-      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
+      device, command_categories, queue_affinity);
   iree_hal_submission_batch_t batch = {
       /*.wait_semaphores=*/wait_semaphore_list,
       /*.command_buffer_count=*/command_buffer_count,
@@ -1368,6 +1489,7 @@ const iree_hal_device_vtable_t iree_hal_vulkan_device_vtable = {
     /*.transfer_range=*/iree_hal_device_submit_transfer_range_and_wait,
     /*.queue_alloca=*/iree_hal_vulkan_device_queue_alloca,
     /*.queue_dealloca=*/iree_hal_vulkan_device_queue_dealloca,
+    /*.queue_read=*/iree_hal_device_queue_read_streaming,
     /*.queue_execute=*/iree_hal_vulkan_device_queue_execute,
     /*.queue_flush=*/iree_hal_vulkan_device_queue_flush,
     /*.wait_semaphores=*/iree_hal_vulkan_device_wait_semaphores,
@@ -0,0 +1,147 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/file.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/tracing.h"
+#include "iree/hal/detail.h"
+#include "iree/hal/resource.h"
+
+#define _VTABLE_DISPATCH(file, method_name) \
+  IREE_HAL_VTABLE_DISPATCH(file, iree_hal_file, method_name)
+
+IREE_HAL_API_RETAIN_RELEASE(file);
+
+IREE_API_EXPORT iree_hal_memory_access_t
+iree_hal_file_allowed_access(iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, allowed_access)(file);
+}
+
+IREE_API_EXPORT uint64_t iree_hal_file_length(iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, length)(file);
+}
+
+IREE_API_EXPORT iree_byte_span_t
+iree_hal_file_host_contents(iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, host_contents)(file);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_file_read(iree_hal_file_t* file,
+                                                 uint64_t offset,
+                                                 iree_byte_span_t buffer) {
+  IREE_ASSERT_ARGUMENT(file);
+  IREE_ASSERT_ARGUMENT(!buffer.data_length || buffer.data);
+  if (!iree_any_bit_set(iree_hal_file_allowed_access(file),
+                        IREE_HAL_MEMORY_ACCESS_READ)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file does not allow read access");
+  }
+  const uint64_t length = iree_hal_file_length(file);
+  if (offset > length || buffer.data_length > length - offset) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "file read range [%" PRIu64 ", %" PRIu64
+                            ") out of bounds of file length %" PRIu64,
+                            offset, offset + (uint64_t)buffer.data_length,
+                            length);
+  }
+  if (!buffer.data_length) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)buffer.data_length);
+  iree_status_t status = _VTABLE_DISPATCH(file, read)(file, offset, buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_memory_file_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_memory_file_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_memory_access_t access;
+  iree_byte_span_t contents;
+  iree_hal_file_release_callback_t release_callback;
+} iree_hal_memory_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_memory_file_vtable;
+
+static iree_hal_memory_file_t* iree_hal_memory_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  return (iree_hal_memory_file_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_memory_file_wrap(
+    iree_hal_memory_access_t access, iree_byte_span_t contents,
+    iree_hal_file_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(!contents.data_length || contents.data);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_memory_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  iree_hal_resource_initialize(&iree_hal_memory_file_vtable, &file->resource);
+  file->host_allocator = host_allocator;
+  file->access = access;
+  file->contents = contents;
+  file->release_callback = release_callback;
+
+  *out_file = (iree_hal_file_t*)file;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_memory_file_destroy(iree_hal_file_t* base_file) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (file->release_callback.fn) {
+    file->release_callback.fn(file->release_callback.user_data, base_file);
+  }
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_memory_access_t iree_hal_memory_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  return iree_hal_memory_file_cast(base_file)->access;
+}
+
+static uint64_t iree_hal_memory_file_length(iree_hal_file_t* base_file) {
+  return (uint64_t)iree_hal_memory_file_cast(base_file)->contents.data_length;
+}
+
+static iree_byte_span_t iree_hal_memory_file_host_contents(
+    iree_hal_file_t* base_file) {
+  return iree_hal_memory_file_cast(base_file)->contents;
+}
+
+static iree_status_t iree_hal_memory_file_read(iree_hal_file_t* base_file,
+                                               uint64_t offset,
+                                               iree_byte_span_t buffer) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+  memcpy(buffer.data, file->contents.data + offset, buffer.data_length);
+  return iree_ok_status();
+}
+
+static const iree_hal_file_vtable_t iree_hal_memory_file_vtable = {
+    .destroy = iree_hal_memory_file_destroy,
+    .allowed_access = iree_hal_memory_file_allowed_access,
+    .length = iree_hal_memory_file_length,
+    .host_contents = iree_hal_memory_file_host_contents,
+    .read = iree_hal_memory_file_read,
+};
@@ -0,0 +1,121 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_FILE_H_
+#define IREE_HAL_FILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/buffer.h"
+#include "iree/hal/resource.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_file_t
+//===----------------------------------------------------------------------===//
+
+// A file that can be used as a source or target of queue-ordered transfer
+// operations such as iree_hal_device_queue_read.
+//
+// Files are an abstraction over the storage backing the contents and may
+// represent host memory (including memory-mapped files), platform file handles,
+// or device-specific handles that allow direct storage-to-device transfers.
+// Implementations that can service reads natively (io_uring, GPU direct
+// storage, etc) may do so while all others fall back to staging the contents
+// through host memory.
+//
+// Thread-safe: files may be used by multiple queue operations concurrently.
+// The contents of a file must not be modified while any operation referencing
+// it is in-flight.
+typedef struct iree_hal_file_t iree_hal_file_t;
+
+typedef void(IREE_API_PTR* iree_hal_file_release_fn_t)(void* user_data,
+                                                        iree_hal_file_t* file);
+
+// A callback issued when a file is released.
+typedef struct {
+  // Callback function pointer.
+  iree_hal_file_release_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_hal_file_release_callback_t;
+
+// Returns a no-op file release callback that implies that no cleanup is
+// required.
+static inline iree_hal_file_release_callback_t
+iree_hal_file_release_callback_null(void) {
+  iree_hal_file_release_callback_t callback = {NULL, NULL};
+  return callback;
+}
+
+// Wraps a host memory |contents| span in a file handle.
+// |release_callback| will be issued when the file is destroyed and can be used
+// to unmap or free the contents. The contents must remain valid until then.
+//
+// Devices are able to transfer directly from the host memory into device
+// buffers without additional staging and this is the preferred way of
+// streaming memory-mapped parameter files.
+IREE_API_EXPORT iree_status_t iree_hal_memory_file_wrap(
+    iree_hal_memory_access_t access, iree_byte_span_t contents,
+    iree_hal_file_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file);
+
+// Retains the given |file| for the caller.
+IREE_API_EXPORT void iree_hal_file_retain(iree_hal_file_t* file);
+
+// Releases the given |file| from the caller.
+IREE_API_EXPORT void iree_hal_file_release(iree_hal_file_t* file);
+
+// Returns the memory access allowed to the file.
+IREE_API_EXPORT iree_hal_memory_access_t
+iree_hal_file_allowed_access(iree_hal_file_t* file);
+
+// Returns the total length of the file contents in bytes.
+IREE_API_EXPORT uint64_t iree_hal_file_length(iree_hal_file_t* file);
+
+// Returns the host memory backing the file contents, if any.
+// Returns an empty span if the file is not backed by host-accessible memory
+// and iree_hal_file_read must be used instead.
+IREE_API_EXPORT iree_byte_span_t
+iree_hal_file_host_contents(iree_hal_file_t* file);
+
+// Synchronously reads |buffer|.data_length bytes of the file starting at
+// |offset| into |buffer|. This is a blocking operation intended for use by
+// emulated queue operations and not for use on latency-sensitive paths.
+IREE_API_EXPORT iree_status_t iree_hal_file_read(iree_hal_file_t* file,
+                                                 uint64_t offset,
+                                                 iree_byte_span_t buffer);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_file_t implementation details
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_file_vtable_t {
+  void(IREE_API_PTR* destroy)(iree_hal_file_t* file);
+
+  iree_hal_memory_access_t(IREE_API_PTR* allowed_access)(iree_hal_file_t* file);
+
+  uint64_t(IREE_API_PTR* length)(iree_hal_file_t* file);
+
+  iree_byte_span_t(IREE_API_PTR* host_contents)(iree_hal_file_t* file);
+
+  iree_status_t(IREE_API_PTR* read)(iree_hal_file_t* file, uint64_t offset,
+                                    iree_byte_span_t buffer);
+} iree_hal_file_vtable_t;
+IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_file_vtable_t);
+
+IREE_API_EXPORT void iree_hal_file_destroy(iree_hal_file_t* file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_FILE_H_
@@ -0,0 +1,171 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_ring.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+
+// A slot in the ring guarded by a sequence lock. |version| is 0 when the slot
+// has never been written, 2*sequence+1 while the record with |sequence| is
+// being written, and 2*sequence+2 once it has been written.
+typedef struct iree_hal_local_dispatch_ring_slot_t {
+  iree_atomic_int64_t version;
+  iree_hal_local_dispatch_record_t record;
+} iree_hal_local_dispatch_ring_slot_t;
+
+struct iree_hal_local_dispatch_ring_t {
+  iree_allocator_t host_allocator;
+  uint32_t sample_interval;
+  // Dispatches seen by iree_hal_local_dispatch_ring_should_sample.
+  iree_atomic_int64_t sample_counter;
+  // Sequence number of the next record to append.
+  iree_atomic_int64_t head;
+  // Slot count (a power of two) - 1.
+  uint64_t slot_mask;
+  iree_hal_local_dispatch_ring_slot_t slots[];
+};
+
+iree_status_t iree_hal_local_dispatch_ring_allocate(
+    iree_host_size_t capacity, uint32_t sample_interval,
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_ring_t** out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  *out_ring = NULL;
+  const iree_host_size_t max_capacity =
+      (IREE_HOST_SIZE_MAX >> 1) / sizeof(iree_hal_local_dispatch_ring_slot_t);
+  if (capacity == 0 || capacity > max_capacity) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch ring capacity %" PRIhsz " out of range",
+                            capacity);
+  }
+  if (sample_interval == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch ring sample interval must be >= 1");
+  }
+  const iree_host_size_t slot_count =
+      (iree_host_size_t)iree_math_round_up_to_pow2_u64(capacity);
+  const iree_host_size_t total_size =
+      sizeof(iree_hal_local_dispatch_ring_t) +
+      slot_count * sizeof(iree_hal_local_dispatch_ring_slot_t);
+
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&ring));
+  memset(ring, 0, total_size);
+  ring->host_allocator = host_allocator;
+  ring->sample_interval = sample_interval;
+  ring->slot_mask = slot_count - 1;
+  *out_ring = ring;
+  return iree_ok_status();
+}
+
+void iree_hal_local_dispatch_ring_free(iree_hal_local_dispatch_ring_t* ring) {
+  if (!ring) return;
+  iree_allocator_free(ring->host_allocator, ring);
+}
+
+bool iree_hal_local_dispatch_ring_should_sample(
+    iree_hal_local_dispatch_ring_t* ring) {
+  if (ring->sample_interval == 1) return true;
+  const int64_t count = iree_atomic_fetch_add_int64(&ring->sample_counter, 1,
+                                                    iree_memory_order_relaxed);
+  return (uint64_t)count % ring->sample_interval == 0;
+}
+
+void iree_hal_local_dispatch_ring_append(iree_hal_local_dispatch_ring_t* ring,
+                                         const void* executable,
+                                         uint32_t ordinal, const char* name,
+                                         const uint32_t workgroup_count[3],
+                                         iree_time_t begin_time_ns,
+                                         iree_time_t end_time_ns) {
+  const int64_t sequence =
+      iree_atomic_fetch_add_int64(&ring->head, 1, iree_memory_order_relaxed);
+  iree_hal_local_dispatch_ring_slot_t* slot =
+      &ring->slots[(uint64_t)sequence & ring->slot_mask];
+
+  // Claim the slot. If another writer is still writing it (only possible when
+  // writers lap the ring within the time it takes to write a record) the record
+  // is dropped instead of waiting; readers will see it as missing.
+  int64_t version =
+      iree_atomic_load_int64(&slot->version, iree_memory_order_relaxed);
+  if ((version & 1) != 0 ||
+      !iree_atomic_compare_exchange_strong_int64(
+          &slot->version, &version, 2 * sequence + 1,
+          iree_memory_order_acquire, iree_memory_order_relaxed)) {
+    return;
+  }
+
+  iree_hal_local_dispatch_record_t* record = &slot->record;
+  record->sequence = (uint64_t)sequence;
+  record->executable = executable;
+  record->ordinal = ordinal;
+  memcpy(record->workgroup_count, workgroup_count,
+         sizeof(record->workgroup_count));
+  record->begin_time_ns = begin_time_ns;
+  record->end_time_ns = end_time_ns;
+  if (name) {
+    snprintf(record->name, sizeof(record->name), "%s", name);
+  } else {
+    record->name[0] = 0;
+  }
+
+  iree_atomic_store_int64(&slot->version, 2 * sequence + 2,
+                          iree_memory_order_release);
+}
+
+void iree_hal_local_dispatch_ring_read(
+    iree_hal_local_dispatch_ring_t* ring, uint64_t* inout_cursor,
+    iree_host_size_t record_capacity,
+    iree_hal_local_dispatch_record_t* out_records,
+    iree_host_size_t* out_record_count, uint64_t* out_dropped_count) {
+  IREE_ASSERT_ARGUMENT(inout_cursor);
+  IREE_ASSERT_ARGUMENT(!record_capacity || out_records);
+  IREE_ASSERT_ARGUMENT(out_record_count);
+  IREE_ASSERT_ARGUMENT(out_dropped_count);
+  *out_record_count = 0;
+  *out_dropped_count = 0;
+
+  // Records older than one ring capacity behind the head have been overwritten.
+  const uint64_t head =
+      (uint64_t)iree_atomic_load_int64(&ring->head, iree_memory_order_acquire);
+  const uint64_t slot_count = ring->slot_mask + 1;
+  const uint64_t oldest = head > slot_count ? head - slot_count : 0;
+  uint64_t sequence = *inout_cursor;
+  if (sequence < oldest) {
+    *out_dropped_count += oldest - sequence;
+    sequence = oldest;
+  }
+
+  iree_host_size_t record_count = 0;
+  for (; sequence < head && record_count < record_capacity; ++sequence) {
+    iree_hal_local_dispatch_ring_slot_t* slot =
+        &ring->slots[sequence & ring->slot_mask];
+    const int64_t expected_version = 2 * (int64_t)sequence + 2;
+    if (iree_atomic_load_int64(&slot->version, iree_memory_order_acquire) !=
+        expected_version) {
+      // Not yet written, dropped, or already overwritten.
+      ++*out_dropped_count;
+      continue;
+    }
+    iree_hal_local_dispatch_record_t* record = &out_records[record_count];
+    memcpy(record, &slot->record, sizeof(*record));
+    iree_atomic_thread_fence(iree_memory_order_acquire);
+    if (iree_atomic_load_int64(&slot->version, iree_memory_order_relaxed) !=
+        expected_version) {
+      // Overwritten while we were copying it.
+      ++*out_dropped_count;
+      continue;
+    }
+    ++record_count;
+  }
+
+  *out_record_count = record_count;
+  *inout_cursor = sequence;
+}
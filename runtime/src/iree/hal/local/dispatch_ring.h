@@ -0,0 +1,92 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_RING_H_
+#define IREE_HAL_LOCAL_DISPATCH_RING_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_ring_t
+//===----------------------------------------------------------------------===//
+//
+// A fixed-size lock-free ring buffer of recently executed dispatches intended
+// to be left enabled in production. Dispatches are sampled at a fixed interval
+// so that the cost of unsampled dispatches is a single atomic increment and
+// sampled dispatches add two timestamp queries and a ring slot write.
+//
+// Any number of threads may append records concurrently with any number of
+// readers. Readers track their position with a cursor and are told how many
+// records they missed because they were overwritten (the reader fell more than
+// the ring capacity behind) or were being written at the time of the read.
+
+// Maximum length of the export name copied into each record, including NUL.
+#define IREE_HAL_LOCAL_DISPATCH_RECORD_NAME_LENGTH 64
+
+// A single executed dispatch.
+typedef struct iree_hal_local_dispatch_record_t {
+  // Sequence number of the record in the order records were appended.
+  uint64_t sequence;
+  // Executable the dispatch was issued from. Only usable as a key as the
+  // executable may have been released since the dispatch executed.
+  const void* executable;
+  // Export ordinal within the executable.
+  uint32_t ordinal;
+  // Workgroup count along each dimension.
+  uint32_t workgroup_count[3];
+  // Time the first workgroup began and the dispatch completed.
+  iree_time_t begin_time_ns;
+  iree_time_t end_time_ns;
+  // Export name, if available, or empty.
+  char name[IREE_HAL_LOCAL_DISPATCH_RECORD_NAME_LENGTH];
+} iree_hal_local_dispatch_record_t;
+
+typedef struct iree_hal_local_dispatch_ring_t iree_hal_local_dispatch_ring_t;
+
+// Allocates a ring holding the most recent |capacity| records (rounded up to a
+// power of two) that samples one of every |sample_interval| dispatches.
+iree_status_t iree_hal_local_dispatch_ring_allocate(
+    iree_host_size_t capacity, uint32_t sample_interval,
+    iree_allocator_t host_allocator, iree_hal_local_dispatch_ring_t** out_ring);
+
+// Frees |ring|. There must be no concurrent appends or reads.
+void iree_hal_local_dispatch_ring_free(iree_hal_local_dispatch_ring_t* ring);
+
+// Returns true if the next dispatch should be sampled and appended.
+bool iree_hal_local_dispatch_ring_should_sample(
+    iree_hal_local_dispatch_ring_t* ring);
+
+// Appends a record of a dispatch of |ordinal| in |executable| named |name|
+// (which may be NULL).
+void iree_hal_local_dispatch_ring_append(iree_hal_local_dispatch_ring_t* ring,
+                                         const void* executable,
+                                         uint32_t ordinal, const char* name,
+                                         const uint32_t workgroup_count[3],
+                                         iree_time_t begin_time_ns,
+                                         iree_time_t end_time_ns);
+
+// Reads up to |record_capacity| records with sequence numbers starting from
+// |inout_cursor| into |out_records| in sequence order. Upon return
+// |out_record_count| contains the number of records read, |out_dropped_count|
+// the number of records between the cursor and the last record read that are
+// no longer (or not yet) available, and |inout_cursor| the sequence number to
+// continue reading from. Start from a cursor of 0 to read the oldest records
+// available.
+void iree_hal_local_dispatch_ring_read(
+    iree_hal_local_dispatch_ring_t* ring, uint64_t* inout_cursor,
+    iree_host_size_t record_capacity,
+    iree_hal_local_dispatch_record_t* out_records,
+    iree_host_size_t* out_record_count, uint64_t* out_dropped_count);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_RING_H_
@@ -0,0 +1,225 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_ring.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+static const uint32_t kWorkgroupCount[3] = {4, 2, 1};
+
+static void AppendRecords(iree_hal_local_dispatch_ring_t* ring,
+                          uint32_t base_ordinal, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_local_dispatch_ring_append(ring, /*executable=*/ring,
+                                        base_ordinal + i, "dispatch",
+                                        kWorkgroupCount, /*begin_time_ns=*/i,
+                                        /*end_time_ns=*/i + 1);
+  }
+}
+
+TEST(DispatchRing, InvalidArguments) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  EXPECT_THAT(Status(iree_hal_local_dispatch_ring_allocate(
+                  0, 1, iree_allocator_system(), &ring)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_hal_local_dispatch_ring_allocate(
+                  8, 0, iree_allocator_system(), &ring)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(ring, nullptr);
+}
+
+TEST(DispatchRing, AppendAndRead) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      8, 1, iree_allocator_system(), &ring));
+
+  uint64_t cursor = 0;
+  iree_hal_local_dispatch_record_t records[8];
+  iree_host_size_t record_count = 0;
+  uint64_t dropped_count = 0;
+  iree_hal_local_dispatch_ring_read(ring, &cursor, IREE_ARRAYSIZE(records),
+                                    records, &record_count, &dropped_count);
+  EXPECT_EQ(record_count, 0);
+  EXPECT_EQ(dropped_count, 0);
+  EXPECT_EQ(cursor, 0);
+
+  AppendRecords(ring, 0, 3);
+  iree_hal_local_dispatch_ring_read(ring, &cursor, IREE_ARRAYSIZE(records),
+                                    records, &record_count, &dropped_count);
+  ASSERT_EQ(record_count, 3);
+  EXPECT_EQ(dropped_count, 0);
+  EXPECT_EQ(cursor, 3);
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(records[i].sequence, i);
+    EXPECT_EQ(records[i].ordinal, i);
+    EXPECT_EQ(records[i].workgroup_count[0], 4);
+    EXPECT_EQ(records[i].workgroup_count[1], 2);
+    EXPECT_EQ(records[i].workgroup_count[2], 1);
+    EXPECT_EQ(records[i].end_time_ns - records[i].begin_time_ns, 1);
+    EXPECT_EQ(std::string(records[i].name), "dispatch");
+  }
+
+  // Reading again from the cursor only returns new records.
+  AppendRecords(ring, 3, 1);
+  iree_hal_local_dispatch_ring_read(ring, &cursor, IREE_ARRAYSIZE(records),
+                                    records, &record_count, &dropped_count);
+  ASSERT_EQ(record_count, 1);
+  EXPECT_EQ(records[0].ordinal, 3);
+  EXPECT_EQ(cursor, 4);
+
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+TEST(DispatchRing, ReadInBatches) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      8, 1, iree_allocator_system(), &ring));
+  AppendRecords(ring, 0, 5);
+
+  uint64_t cursor = 0;
+  iree_hal_local_dispatch_record_t records[2];
+  iree_host_size_t record_count = 0;
+  uint64_t dropped_count = 0;
+  for (uint32_t expected_ordinal = 0; expected_ordinal < 5;) {
+    iree_hal_local_dispatch_ring_read(ring, &cursor, IREE_ARRAYSIZE(records),
+                                      records, &record_count, &dropped_count);
+    ASSERT_GT(record_count, 0);
+    EXPECT_EQ(dropped_count, 0);
+    for (iree_host_size_t i = 0; i < record_count; ++i) {
+      EXPECT_EQ(records[i].ordinal, expected_ordinal++);
+    }
+  }
+  EXPECT_EQ(cursor, 5);
+
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+TEST(DispatchRing, OverwriteReportsDropped) {
+  // Capacity is rounded up to 8.
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      5, 1, iree_allocator_system(), &ring));
+  AppendRecords(ring, 0, 20);
+
+  uint64_t cursor = 0;
+  iree_hal_local_dispatch_record_t records[16];
+  iree_host_size_t record_count = 0;
+  uint64_t dropped_count = 0;
+  iree_hal_local_dispatch_ring_read(ring, &cursor, IREE_ARRAYSIZE(records),
+                                    records, &record_count, &dropped_count);
+  ASSERT_EQ(record_count, 8);
+  EXPECT_EQ(dropped_count, 12);
+  EXPECT_EQ(cursor, 20);
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    EXPECT_EQ(records[i].sequence, 12 + i);
+    EXPECT_EQ(records[i].ordinal, 12 + i);
+  }
+
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+TEST(DispatchRing, LongNamesAreTruncated) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      1, 1, iree_allocator_system(), &ring));
+  std::string long_name(IREE_HAL_LOCAL_DISPATCH_RECORD_NAME_LENGTH * 2, 'x');
+  iree_hal_local_dispatch_ring_append(ring, NULL, 0, long_name.c_str(),
+                                      kWorkgroupCount, 0, 0);
+  iree_hal_local_dispatch_ring_append(ring, NULL, 1, NULL, kWorkgroupCount, 0,
+                                      0);
+
+  uint64_t cursor = 0;
+  iree_hal_local_dispatch_record_t record;
+  iree_host_size_t record_count = 0;
+  uint64_t dropped_count = 0;
+  iree_hal_local_dispatch_ring_read(ring, &cursor, 1, &record, &record_count,
+                                    &dropped_count);
+  ASSERT_EQ(record_count, 1);
+  EXPECT_EQ(dropped_count, 1);
+  EXPECT_EQ(record.ordinal, 1);
+  EXPECT_EQ(record.name[0], 0);
+
+  cursor = 0;
+  iree_hal_local_dispatch_ring_t* large_ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      1, 1, iree_allocator_system(), &large_ring));
+  iree_hal_local_dispatch_ring_append(large_ring, NULL, 0, long_name.c_str(),
+                                      kWorkgroupCount, 0, 0);
+  iree_hal_local_dispatch_ring_read(large_ring, &cursor, 1, &record,
+                                    &record_count, &dropped_count);
+  ASSERT_EQ(record_count, 1);
+  EXPECT_EQ(strlen(record.name),
+            IREE_HAL_LOCAL_DISPATCH_RECORD_NAME_LENGTH - 1);
+
+  iree_hal_local_dispatch_ring_free(large_ring);
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+TEST(DispatchRing, SampleInterval) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      8, 4, iree_allocator_system(), &ring));
+  int sampled_count = 0;
+  for (int i = 0; i < 16; ++i) {
+    if (iree_hal_local_dispatch_ring_should_sample(ring)) ++sampled_count;
+  }
+  EXPECT_EQ(sampled_count, 4);
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+TEST(DispatchRing, ConcurrentAppends) {
+  iree_hal_local_dispatch_ring_t* ring = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_ring_allocate(
+      1024, 1, iree_allocator_system(), &ring));
+
+  static const int kThreadCount = 4;
+  static const uint32_t kRecordsPerThread = 256;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back(
+        [ring]() { AppendRecords(ring, 0, kRecordsPerThread); });
+  }
+
+  // Read concurrently with the writers; every sequence number must be
+  // accounted for as either read or dropped.
+  uint64_t cursor = 0;
+  uint64_t total_count = 0;
+  std::vector<iree_hal_local_dispatch_record_t> records(64);
+  while (cursor < kThreadCount * kRecordsPerThread) {
+    const uint64_t start_cursor = cursor;
+    iree_host_size_t record_count = 0;
+    uint64_t dropped_count = 0;
+    iree_hal_local_dispatch_ring_read(ring, &cursor, records.size(),
+                                      records.data(), &record_count,
+                                      &dropped_count);
+    for (iree_host_size_t i = 0; i < record_count; ++i) {
+      EXPECT_GE(records[i].sequence, start_cursor);
+      EXPECT_LT(records[i].sequence, cursor);
+      EXPECT_LT(records[i].ordinal, kRecordsPerThread);
+    }
+    EXPECT_EQ(start_cursor + record_count + dropped_count, cursor);
+    total_count += record_count + dropped_count;
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(total_count, kThreadCount * kRecordsPerThread);
+
+  iree_hal_local_dispatch_ring_free(ring);
+}
+
+}  // namespace
@@ -7,6 +7,7 @@
 #include "iree/hal/local/elf/elf_module.h"
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/target_platform.h"
@@ -234,8 +235,8 @@ static iree_byte_range_t iree_elf_module_calculate_vaddr_range(
 // Allocates space for and loads all DT_LOAD segments into the host virtual
 // address space.
 static iree_status_t iree_elf_module_load_segments(
-    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state,
-    iree_elf_module_t* module) {
+    iree_const_byte_span_t raw_data, iree_elf_module_flags_t flags,
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module) {
   // Calculate the total internally-aligned vaddr range.
   iree_byte_range_t vaddr_range =
       iree_elf_module_calculate_vaddr_range(load_state);
@@ -244,9 +245,13 @@ static iree_status_t iree_elf_module_load_segments(
   // uncommitted by default as the ELF may only sparsely use the address space.
   module->vaddr_size = iree_page_align_end(
       vaddr_range.length, load_state->memory_info.normal_page_size);
+  iree_memory_view_flags_t view_flags = IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE;
+  if (iree_all_bits_set(flags, IREE_ELF_MODULE_FLAG_LARGE_PAGES)) {
+    view_flags |= IREE_MEMORY_VIEW_FLAG_LARGE_PAGES;
+  }
   IREE_RETURN_IF_ERROR(iree_memory_view_reserve(
-      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, module->vaddr_size,
-      module->host_allocator, (void**)&module->vaddr_base));
+      view_flags, module->vaddr_size, module->host_allocator,
+      (void**)&module->vaddr_base));
   module->vaddr_bias = module->vaddr_base - vaddr_range.offset;
 
   // Commit and load all of the segments.
@@ -289,6 +294,20 @@ static iree_status_t iree_elf_module_load_segments(
   return iree_ok_status();
 }
 
+// Interprets the access bits of a PT_LOAD segment and widens them to the
+// implicit allowable permissions. See Table 7-37:
+// https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
+static iree_memory_access_t iree_elf_module_segment_access(
+    const iree_elf_phdr_t* phdr) {
+  iree_memory_access_t access = 0;
+  if (phdr->p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
+  if (phdr->p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
+  if (phdr->p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
+  if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
+  if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+  return access;
+}
+
 // Applies segment memory protection attributes.
 // This will make pages read-only and must only be performed after relocation
 // (which writes to pages of all types). Executable pages will be flushed from
@@ -300,15 +319,7 @@ static iree_status_t iree_elf_module_protect_segments(
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
 
-    // Interpret the access bits and widen to the implicit allowable
-    // permissions. See Table 7-37:
-    // https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
-    iree_memory_access_t access = 0;
-    if (phdr->p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
-    if (phdr->p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
-    if (phdr->p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
-    if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
-    if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+    iree_memory_access_t access = iree_elf_module_segment_access(phdr);
 
     // We only support R+X (no W).
     if ((phdr->p_flags & IREE_ELF_PF_X) && (phdr->p_flags & IREE_ELF_PF_W)) {
@@ -366,10 +377,8 @@ static void iree_elf_module_unload_segments(iree_elf_module_t* module) {
 // NOTE: this happens *after* allocation and loading as the .dynsym and related
 // segments are allocated and loaded in virtual address space.
 
-// Parses, verifies, and populates dynamic symbol related tables for runtime
-// use. These tables are all in allocated memory and use fully rebased virtual
-// addresses.
-static iree_status_t iree_elf_module_parse_dynamic_tables(
+// Finds the dynamic table in the loaded module.
+static iree_status_t iree_elf_module_find_dynamic_table(
     iree_elf_module_load_state_t* load_state, iree_elf_module_t* module) {
   // By the spec there must only be one PT_DYNAMIC.
   // Note that we are getting the one in the loaded virtual address space.
@@ -389,7 +398,16 @@ static iree_status_t iree_elf_module_parse_dynamic_tables(
   }
   load_state->dyn_table = dyn_table;
   load_state->dyn_table_count = dyn_table_count;
+  return iree_ok_status();
+}
 
+// Parses, verifies, and populates dynamic symbol related tables for runtime
+// use. These tables are all in allocated memory and use fully rebased virtual
+// addresses.
+static iree_status_t iree_elf_module_parse_dynamic_tables(
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module) {
+  const iree_elf_dyn_t* dyn_table = load_state->dyn_table;
+  iree_host_size_t dyn_table_count = load_state->dyn_table_count;
   for (iree_host_size_t i = 0; i < dyn_table_count; ++i) {
     const iree_elf_dyn_t* dyn = &dyn_table[i];
     switch (dyn->d_tag) {
@@ -568,14 +586,336 @@ static const iree_elf_sym_t* iree_elf_module_lookup_global_symbol(
   return NULL;
 }
 
+//==============================================================================
+// Persistent module images
+//==============================================================================
+
+// 'IEIM' in little-endian byte order.
+#define IREE_ELF_MODULE_IMAGE_MAGIC 0x4D494549u
+
+// Bumped whenever the image layout or the loader changes in ways that would
+// make previously written images invalid.
+#define IREE_ELF_MODULE_IMAGE_VERSION 1u
+
+// File offset of the first image page. Large enough to hold the header and a
+// multiple of all page sizes we expect to run with (4KiB-64KiB).
+#define IREE_ELF_MODULE_IMAGE_DATA_OFFSET (64 * 1024)
+
+// Maximum number of ranges in an image; modules we produce have 3-5.
+#define IREE_ELF_MODULE_IMAGE_MAX_RANGES 16
+
+enum iree_elf_module_image_range_flag_bits_t {
+  // Range pages are mapped from the file. Otherwise only the access of pages
+  // mapped by prior ranges is changed (as for PT_GNU_RELRO).
+  IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED = 1u << 0,
+};
+
+// A page-aligned range of the module address space.
+typedef struct iree_elf_module_image_range_t {
+  // Offset from the base of the address space reservation.
+  uint64_t offset;
+  uint64_t length;
+  iree_memory_access_t access;
+  uint32_t flags;
+} iree_elf_module_image_range_t;
+
+// Header at file offset 0 of an image. Host-endian as images never move
+// between hosts.
+typedef struct iree_elf_module_image_header_t {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t machine;  // e_machine of the ELF
+  uint32_t range_count;
+  uint64_t page_size;
+  // Identifies the ELF the image was loaded from.
+  uint64_t source_length;
+  uint64_t source_hash;
+  // Address space reservation the image was relocated for.
+  uint64_t vaddr_base;
+  uint64_t vaddr_size;
+  // vaddr_base - vaddr_bias.
+  uint64_t vaddr_bias_offset;
+  // PT_DYNAMIC table as an offset from vaddr_bias and entry count.
+  uint64_t dyn_table_offset;
+  uint64_t dyn_table_count;
+  // Hashes of the mapped range contents in order and of this header with
+  // header_hash set to 0.
+  uint64_t image_hash;
+  uint64_t header_hash;
+  iree_elf_module_image_range_t ranges[IREE_ELF_MODULE_IMAGE_MAX_RANGES];
+} iree_elf_module_image_header_t;
+static_assert(sizeof(iree_elf_module_image_header_t) <=
+                  IREE_ELF_MODULE_IMAGE_DATA_OFFSET,
+              "image header must fit before the image data");
+
+bool iree_elf_module_images_supported(void) {
+  iree_memory_info_t memory_info;
+  iree_memory_query_info(&memory_info);
+  return memory_info.can_allocate_executable_pages &&
+         memory_info.can_map_executable_files;
+}
+
+uint64_t iree_elf_module_image_hash(iree_const_byte_span_t data,
+                                    uint64_t seed) {
+  // FNV-1a over 64-bit words, with an extra shift so that the high bits of
+  // each word influence the low bits of the hash. Images are hashed in full
+  // when mapped so this needs to run at close to memory bandwidth.
+  uint64_t hash = seed ^ 0xCBF29CE484222325ull;
+  const uint8_t* p = data.data;
+  iree_host_size_t length = data.data_length;
+  for (; length >= sizeof(uint64_t); length -= sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, p, sizeof(word));
+    p += sizeof(word);
+    hash = (hash ^ word) * 0x100000001B3ull;
+    hash ^= hash >> 29;
+  }
+  for (; length > 0; --length) {
+    hash = (hash ^ *p++) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+static uint64_t iree_elf_module_image_header_hash(
+    const iree_elf_module_image_header_t* header) {
+  iree_elf_module_image_header_t header_copy = *header;
+  header_copy.header_hash = 0;
+  return iree_elf_module_image_hash(
+      iree_make_const_byte_span(&header_copy, sizeof(header_copy)), 0);
+}
+
+// Appends a range covering the pages overlapping the segment |phdr| to
+// |header|.
+static iree_status_t iree_elf_module_image_append_range(
+    iree_elf_module_t* module, const iree_elf_phdr_t* phdr,
+    iree_memory_access_t access, uint32_t flags,
+    iree_elf_module_image_header_t* header) {
+  if (header->range_count >= IREE_ELF_MODULE_IMAGE_MAX_RANGES) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many segments for a module image (max %d)",
+                            IREE_ELF_MODULE_IMAGE_MAX_RANGES);
+  }
+  iree_byte_range_t byte_range = {
+      .offset = phdr->p_vaddr,
+      .length = phdr->p_memsz,
+  };
+  void* range_start = NULL;
+  iree_host_size_t range_length = 0;
+  iree_page_align_range(module->vaddr_bias, byte_range,
+                        (iree_host_size_t)header->page_size, &range_start,
+                        &range_length);
+  iree_elf_module_image_range_t* range =
+      &header->ranges[header->range_count++];
+  range->offset = (uint64_t)((uint8_t*)range_start - module->vaddr_base);
+  range->length = range_length;
+  range->access = access;
+  range->flags = flags;
+  return iree_ok_status();
+}
+
+// Writes the image of |module| to |file|. Must be called after relocation and
+// while all segment pages are still readable.
+static iree_status_t iree_elf_module_write_image(
+    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state,
+    iree_elf_module_t* module, FILE* file) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_elf_module_image_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = IREE_ELF_MODULE_IMAGE_MAGIC;
+  header.version = IREE_ELF_MODULE_IMAGE_VERSION;
+  header.machine = load_state->ehdr->e_machine;
+  header.page_size = load_state->memory_info.normal_page_size;
+  header.source_length = raw_data.data_length;
+  header.source_hash = iree_elf_module_image_hash(raw_data, 0);
+  header.vaddr_base = (uint64_t)(uintptr_t)module->vaddr_base;
+  header.vaddr_size = module->vaddr_size;
+  header.vaddr_bias_offset =
+      (uint64_t)(uintptr_t)(module->vaddr_base - module->vaddr_bias);
+  header.dyn_table_offset =
+      (uint64_t)(uintptr_t)((const uint8_t*)load_state->dyn_table -
+                            module->vaddr_bias);
+  header.dyn_table_count = load_state->dyn_table_count;
+
+  // PT_LOAD segments are mapped in order and PT_GNU_RELRO applied afterward,
+  // matching iree_elf_module_protect_segments.
+  iree_status_t status = iree_ok_status();
+  for (iree_elf_half_t i = 0;
+       i < load_state->ehdr->e_phnum && iree_status_is_ok(status); ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+    status = iree_elf_module_image_append_range(
+        module, phdr, iree_elf_module_segment_access(phdr),
+        IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED, &header);
+  }
+  for (iree_elf_half_t i = 0;
+       i < load_state->ehdr->e_phnum && iree_status_is_ok(status); ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_GNU_RELRO) continue;
+    status = iree_elf_module_image_append_range(
+        module, phdr, IREE_MEMORY_ACCESS_READ, /*flags=*/0, &header);
+  }
+
+  // Write the pages of each mapped range at their offset in the address space.
+  // Unmapped gaps between ranges become holes in the file.
+  for (uint32_t i = 0; i < header.range_count && iree_status_is_ok(status);
+       ++i) {
+    const iree_elf_module_image_range_t* range = &header.ranges[i];
+    if (!(range->flags & IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED)) continue;
+    iree_const_byte_span_t range_data = iree_make_const_byte_span(
+        module->vaddr_base + range->offset, (iree_host_size_t)range->length);
+    header.image_hash = iree_elf_module_image_hash(range_data,
+                                                   header.image_hash);
+    if (fseek(file, (long)(IREE_ELF_MODULE_IMAGE_DATA_OFFSET + range->offset),
+              SEEK_SET) != 0 ||
+        fwrite(range_data.data, 1, range_data.data_length, file) !=
+            range_data.data_length) {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "failed to write module image pages");
+    }
+  }
+
+  // Write the header last so that partially written images fail to verify.
+  if (iree_status_is_ok(status)) {
+    header.header_hash = iree_elf_module_image_header_hash(&header);
+    if (fseek(file, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, file) != 1 || fflush(file) != 0) {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "failed to write module image header");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Reads and verifies the header of the image in |file| against |raw_data| and
+// the host.
+static iree_status_t iree_elf_module_read_image_header(
+    iree_const_byte_span_t raw_data, FILE* file,
+    const iree_memory_info_t* memory_info,
+    iree_elf_module_image_header_t* out_header) {
+  if (fseek(file, 0, SEEK_SET) != 0 ||
+      fread(out_header, sizeof(*out_header), 1, file) != 1) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image header truncated");
+  }
+  if (out_header->magic != IREE_ELF_MODULE_IMAGE_MAGIC ||
+      out_header->header_hash !=
+          iree_elf_module_image_header_hash(out_header)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image header corrupt");
+  }
+  if (out_header->version != IREE_ELF_MODULE_IMAGE_VERSION ||
+      !iree_elf_machine_is_valid((iree_elf_half_t)out_header->machine) ||
+      out_header->page_size == 0 ||
+      out_header->page_size % memory_info->normal_page_size != 0 ||
+      out_header->vaddr_base % memory_info->normal_page_granularity != 0 ||
+      out_header->vaddr_size > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image was written for a different host "
+                            "or runtime version");
+  }
+  if (out_header->source_length != raw_data.data_length ||
+      out_header->source_hash != iree_elf_module_image_hash(raw_data, 0)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image was written for a different ELF");
+  }
+
+  // Ensure every range lies within the reservation and every mapped range
+  // within the file: accessing pages mapped past the end of a file faults.
+  if (out_header->range_count > IREE_ELF_MODULE_IMAGE_MAX_RANGES ||
+      out_header->dyn_table_offset < out_header->vaddr_bias_offset ||
+      out_header->dyn_table_offset + out_header->dyn_table_count *
+                                         sizeof(iree_elf_dyn_t) >
+          out_header->vaddr_bias_offset + out_header->vaddr_size) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image layout invalid");
+  }
+  if (fseek(file, 0, SEEK_END) != 0) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image length unavailable");
+  }
+  long file_length = ftell(file);
+  for (uint32_t i = 0; i < out_header->range_count; ++i) {
+    const iree_elf_module_image_range_t* range = &out_header->ranges[i];
+    if (range->offset % out_header->page_size != 0 ||
+        range->offset + range->length > out_header->vaddr_size) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "module image range out of bounds");
+    }
+    if ((range->flags & IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED) &&
+        (file_length < 0 ||
+         IREE_ELF_MODULE_IMAGE_DATA_OFFSET + range->offset + range->length >
+             (uint64_t)file_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "module image pages truncated");
+    }
+  }
+  return iree_ok_status();
+}
+
+// Maps the pages of the image in |file| described by |header| at the address
+// they were relocated for.
+static iree_status_t iree_elf_module_map_image(
+    const iree_elf_module_image_header_t* header, FILE* file,
+    iree_elf_module_t* module) {
+  IREE_RETURN_IF_ERROR(iree_memory_view_reserve_at(
+      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE,
+      (void*)(uintptr_t)header->vaddr_base,
+      (iree_host_size_t)header->vaddr_size, module->host_allocator));
+  module->vaddr_base = (uint8_t*)(uintptr_t)header->vaddr_base;
+  module->vaddr_size = (iree_host_size_t)header->vaddr_size;
+  module->vaddr_bias = module->vaddr_base - header->vaddr_bias_offset;
+
+  // Map with final access directly: the pages were relocated when written and
+  // are never modified here. The kernel keeps the instruction cache coherent
+  // for pages it maps executable so no flush is needed.
+  uint64_t image_hash = 0;
+  for (uint32_t i = 0; i < header->range_count; ++i) {
+    const iree_elf_module_image_range_t* range = &header->ranges[i];
+    if (!(range->flags & IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED)) continue;
+    iree_byte_range_t byte_range = {
+        .offset = (iree_host_size_t)range->offset,
+        .length = (iree_host_size_t)range->length,
+    };
+    IREE_RETURN_IF_ERROR(iree_memory_view_map_file_ranges(
+        module->vaddr_base, 1, &byte_range, file,
+        IREE_ELF_MODULE_IMAGE_DATA_OFFSET, range->access));
+    image_hash = iree_elf_module_image_hash(
+        iree_make_const_byte_span(module->vaddr_base + byte_range.offset,
+                                  byte_range.length),
+        image_hash);
+  }
+  if (image_hash != header->image_hash) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "module image pages corrupt");
+  }
+
+  for (uint32_t i = 0; i < header->range_count; ++i) {
+    const iree_elf_module_image_range_t* range = &header->ranges[i];
+    if (range->flags & IREE_ELF_MODULE_IMAGE_RANGE_FLAG_MAPPED) continue;
+    iree_byte_range_t byte_range = {
+        .offset = (iree_host_size_t)range->offset,
+        .length = (iree_host_size_t)range->length,
+    };
+    IREE_RETURN_IF_ERROR(iree_memory_view_protect_ranges(
+        module->vaddr_base, 1, &byte_range, range->access));
+  }
+  return iree_ok_status();
+}
+
 //==============================================================================
 // API
 //==============================================================================
 
-iree_status_t iree_elf_module_initialize_from_memory(
+// Loads the module from |raw_data| and, if |image_file| is not NULL, writes its
+// image to the file once relocated.
+static iree_status_t iree_elf_module_initialize_from_memory_impl(
     iree_const_byte_span_t raw_data,
-    const iree_elf_import_table_t* import_table,
-    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+    const iree_elf_import_table_t* import_table, iree_elf_module_flags_t flags,
+    FILE* image_file, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
   IREE_ASSERT_ARGUMENT(raw_data.data);
   IREE_ASSERT_ARGUMENT(out_module);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -598,11 +938,15 @@ iree_status_t iree_elf_module_initialize_from_memory(
   // Allocate and load the ELF into memory.
   iree_memory_jit_context_begin();
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_load_segments(raw_data, &load_state, out_module);
+    status = iree_elf_module_load_segments(raw_data, flags, &load_state,
+                                           out_module);
   }
 
   // Parse required dynamic symbol tables in loaded memory. These are used for
   // runtime symbol resolution and relocation.
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_find_dynamic_table(&load_state, out_module);
+  }
   if (iree_status_is_ok(status)) {
     status = iree_elf_module_parse_dynamic_tables(&load_state, out_module);
   }
@@ -618,6 +962,13 @@ iree_status_t iree_elf_module_initialize_from_memory(
     status = iree_elf_module_apply_relocations(&load_state, out_module);
   }
 
+  // Snapshot the relocated pages while they are all still readable and before
+  // initializers have had a chance to modify them.
+  if (iree_status_is_ok(status) && image_file) {
+    status = iree_elf_module_write_image(raw_data, &load_state, out_module,
+                                         image_file);
+  }
+
   // Apply final protections to the loaded pages now that relocations have been
   // performed.
   if (iree_status_is_ok(status)) {
@@ -639,6 +990,91 @@ iree_status_t iree_elf_module_initialize_from_memory(
   return status;
 }
 
+iree_status_t iree_elf_module_initialize_from_memory(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  return iree_elf_module_initialize_from_memory_impl(
+      raw_data, import_table, IREE_ELF_MODULE_FLAG_NONE, /*image_file=*/NULL,
+      host_allocator, out_module);
+}
+
+iree_status_t iree_elf_module_initialize_from_memory_with_flags(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, iree_elf_module_flags_t flags,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  return iree_elf_module_initialize_from_memory_impl(
+      raw_data, import_table, flags, /*image_file=*/NULL, host_allocator,
+      out_module);
+}
+
+iree_status_t iree_elf_module_initialize_and_write_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, iree_elf_module_flags_t flags,
+    FILE* image_file, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
+  IREE_ASSERT_ARGUMENT(image_file);
+  return iree_elf_module_initialize_from_memory_impl(
+      raw_data, import_table, flags, image_file, host_allocator, out_module);
+}
+
+iree_status_t iree_elf_module_initialize_from_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, FILE* image_file,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  IREE_ASSERT_ARGUMENT(raw_data.data);
+  IREE_ASSERT_ARGUMENT(image_file);
+  IREE_ASSERT_ARGUMENT(out_module);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_module, 0, sizeof(*out_module));
+  out_module->host_allocator = host_allocator;
+
+  // Images are keyed on the ELF selected for this architecture.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
+                                    iree_fatelf_select(raw_data, &raw_data));
+
+  iree_elf_module_load_state_t load_state;
+  memset(&load_state, 0, sizeof(load_state));
+  iree_memory_query_info(&load_state.memory_info);
+  if (!load_state.memory_info.can_map_executable_files) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "module images not supported on this host");
+  }
+
+  iree_elf_module_image_header_t header;
+  iree_status_t status = iree_elf_module_read_image_header(
+      raw_data, image_file, &load_state.memory_info, &header);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_map_image(&header, image_file, out_module);
+  }
+
+  // The dynamic tables are in the mapped pages at the same location they were
+  // found when the image was written.
+  if (iree_status_is_ok(status)) {
+    load_state.dyn_table =
+        (const iree_elf_dyn_t*)(out_module->vaddr_bias +
+                                header.dyn_table_offset);
+    load_state.dyn_table_count = (iree_host_size_t)header.dyn_table_count;
+    status = iree_elf_module_parse_dynamic_tables(&load_state, out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_verify_no_imports(&load_state, out_module);
+  }
+
+  // Initializers did not run before the image was written.
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_run_initializers(&load_state, out_module);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(out_module);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 void iree_elf_module_deinitialize(iree_elf_module_t* module) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -8,6 +8,7 @@
 #define IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
 
 #include <stdint.h>
+#include <stdio.h>
 
 #include "iree/base/api.h"
 #include "iree/hal/local/elf/arch.h"       // IWYU pragma: export
@@ -58,6 +59,17 @@ typedef struct iree_elf_module_t {
   iree_host_size_t dynsym_count;  // DT_SYMENT (bytes) / sizeof(iree_elf_sym_t)
 } iree_elf_module_t;
 
+// Controls how modules are loaded.
+enum iree_elf_module_flag_bits_t {
+  IREE_ELF_MODULE_FLAG_NONE = 0u,
+  // Backs the module pages with large pages where the host supports them to
+  // reduce iTLB misses in large modules. Only the parts of segments covering
+  // whole large pages benefit and the module reservation is aligned to the
+  // large page size.
+  IREE_ELF_MODULE_FLAG_LARGE_PAGES = 1u << 0,
+};
+typedef uint32_t iree_elf_module_flags_t;
+
 // Initializes an ELF module from the ELF |raw_data| in memory.
 // |raw_data| only needs to remain valid for the initialization of the module
 // and may be discarded afterward.
@@ -77,6 +89,13 @@ iree_status_t iree_elf_module_initialize_from_memory(
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module);
 
+// Initializes an ELF module as with iree_elf_module_initialize_from_memory
+// using the given |flags|.
+iree_status_t iree_elf_module_initialize_from_memory_with_flags(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, iree_elf_module_flags_t flags,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module);
+
 // Deinitializes a |module|, releasing any allocated executable or data pages.
 // Invalidates all symbol pointers previous retrieved from the module and any
 // pointer to data that may have been in the module text or rwdata.
@@ -89,4 +108,52 @@ iree_status_t iree_elf_module_lookup_export(iree_elf_module_t* module,
                                             const char* symbol_name,
                                             void** out_export);
 
+//==============================================================================
+// Persistent module images
+//==============================================================================
+// A module image is a file holding the pages of a module as loaded at a fixed
+// address, after relocation and before initializers run. Mapping the image in
+// a later process at the same address skips the page allocation, copies, and
+// relocation of a load from memory and lets the kernel share and lazily page
+// in the code.
+
+// Returns true if the host supports iree_elf_module_initialize_from_image.
+bool iree_elf_module_images_supported(void);
+
+// Returns a non-cryptographic 64-bit hash of |data| combined with |seed|.
+// Used to checksum images and usable by callers to key them.
+uint64_t iree_elf_module_image_hash(iree_const_byte_span_t data,
+                                    uint64_t seed);
+
+// Initializes |out_module| as with
+// iree_elf_module_initialize_from_memory_with_flags and writes the image of the
+// module to |image_file|, which must be opened for binary writing. The image is
+// only valid for |raw_data| on the host it was written on.
+//
+// Modules initialized from the image are backed by the file pages and do not
+// use large pages even if IREE_ELF_MODULE_FLAG_LARGE_PAGES is set here.
+iree_status_t iree_elf_module_initialize_and_write_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, iree_elf_module_flags_t flags,
+    FILE* image_file, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module);
+
+// Initializes |out_module| by mapping the image of the ELF |raw_data| written
+// by iree_elf_module_initialize_and_write_image to |image_file|, which must be
+// opened for binary reading and may be closed once this returns.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the image cannot be mapped in this
+// process, such as when its address range is in use, and
+// IREE_STATUS_DATA_LOSS if the image is corrupt or was written for different
+// ELF data or a different host. Callers should fall back to
+// iree_elf_module_initialize_from_memory in both cases.
+//
+// WARNING: images contain native code that is only verified against a
+// checksum before being executed. They must be stored where only trusted
+// users can write.
+iree_status_t iree_elf_module_initialize_from_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table, FILE* image_file,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module);
+
 #endif  // IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
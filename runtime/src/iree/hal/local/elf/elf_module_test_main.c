@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <stdio.h>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/cpu.h"
 #include "iree/base/target_platform.h"
@@ -52,23 +54,15 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
-  iree_elf_import_table_t import_table;
-  memset(&import_table, 0, sizeof(import_table));
-  iree_elf_module_t module;
-  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
-      file_data, &import_table, iree_allocator_system(), &module));
-
+// Runs the test module's dispatch function from |module| and checks results.
+static iree_status_t run_module(iree_elf_module_t* module) {
   iree_hal_executable_environment_v0_t environment;
   iree_hal_executable_environment_initialize(iree_allocator_system(),
                                              &environment);
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
+      module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
   union {
     const iree_hal_executable_library_header_t** header;
@@ -151,13 +145,77 @@ static iree_status_t run_test() {
       break;
     }
   }
+  return status;
+}
+
+static iree_status_t run_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
 
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module));
+  iree_status_t status = run_module(&module);
   iree_elf_module_deinitialize(&module);
   return status;
 }
 
+// Writes an image of the module and maps it back in place of a load.
+static iree_status_t run_image_test() {
+  if (!iree_elf_module_images_supported()) return iree_ok_status();
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  FILE* image_file = tmpfile();
+  if (!image_file) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "unable to create a temporary file");
+  }
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module;
+  iree_status_t status = iree_elf_module_initialize_and_write_image(
+      file_data, &import_table, IREE_ELF_MODULE_FLAG_NONE, image_file,
+      iree_allocator_system(), &module);
+  if (iree_status_is_ok(status)) {
+    status = run_module(&module);
+    // Frees the address range the image was written for.
+    iree_elf_module_deinitialize(&module);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_initialize_from_image(
+        file_data, &import_table, image_file, iree_allocator_system(),
+        &module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = run_module(&module);
+    iree_elf_module_deinitialize(&module);
+  }
+
+  // Images must not be used for other ELF data.
+  if (iree_status_is_ok(status)) {
+    iree_const_byte_span_t other_data =
+        iree_make_const_byte_span(file_data.data, file_data.data_length - 1);
+    iree_status_t other_status = iree_elf_module_initialize_from_image(
+        other_data, &import_table, image_file, iree_allocator_system(),
+        &module);
+    if (!iree_status_is_data_loss(other_status)) {
+      status = iree_make_status(IREE_STATUS_INTERNAL,
+                                "image accepted for mismatched ELF data");
+    }
+    iree_status_ignore(other_status);
+  }
+
+  fclose(image_file);
+  return status;
+}
+
 int main() {
-  const iree_status_t result = run_test();
+  iree_status_t result = run_test();
+  if (iree_status_is_ok(result)) result = run_image_test();
   int ret = (int)iree_status_code(result);
   if (!iree_status_is_ok(result)) {
     iree_status_fprint(stderr, result);
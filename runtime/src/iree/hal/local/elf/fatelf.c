@@ -8,10 +8,111 @@
 
 #include "iree/base/target_platform.h"
 #include "iree/hal/local/elf/arch.h"
+#include "iree/schemas/cpu_data.h"
 
-iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
-                                 iree_const_byte_span_t* out_elf_data) {
+//===----------------------------------------------------------------------===//
+// CPU feature requirements
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_fatelf_feature_info_t {
+  iree_elf64_half_t machine;
+  iree_fatelf_features_t feature;
+  const char* name;
+  // Bits that must be set in the CPU data field 0 to support the feature.
+  uint64_t cpu_data0;
+} iree_fatelf_feature_info_t;
+
+static const iree_fatelf_feature_info_t iree_fatelf_feature_infos[] = {
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AVX2, "avx2",
+     IREE_CPU_DATA0_X86_64_AVX | IREE_CPU_DATA0_X86_64_AVX2 |
+         IREE_CPU_DATA0_X86_64_FMA | IREE_CPU_DATA0_X86_64_F16C},
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AVX512, "avx512",
+     IREE_CPU_DATA0_X86_64_AVX512F | IREE_CPU_DATA0_X86_64_AVX512CD |
+         IREE_CPU_DATA0_X86_64_AVX512VL | IREE_CPU_DATA0_X86_64_AVX512DQ |
+         IREE_CPU_DATA0_X86_64_AVX512BW},
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AVX512VNNI, "avx512vnni",
+     IREE_CPU_DATA0_X86_64_AVX512VNNI},
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AVX512BF16, "avx512bf16",
+     IREE_CPU_DATA0_X86_64_AVX512BF16},
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AVX512FP16, "avx512fp16",
+     IREE_CPU_DATA0_X86_64_AVX512FP16},
+    {0x3E, IREE_FATELF_FEATURE_X86_64_AMX, "amx",
+     IREE_CPU_DATA0_X86_64_AMXTILE | IREE_CPU_DATA0_X86_64_AMXINT8 |
+         IREE_CPU_DATA0_X86_64_AMXBF16},
+    {0xB7, IREE_FATELF_FEATURE_ARM_64_DOTPROD, "dotprod",
+     IREE_CPU_DATA0_ARM_64_DOTPROD},
+    {0xB7, IREE_FATELF_FEATURE_ARM_64_I8MM, "i8mm", IREE_CPU_DATA0_ARM_64_I8MM},
+    {0xB7, IREE_FATELF_FEATURE_ARM_64_SVE, "sve", IREE_CPU_DATA0_ARM_64_SVE},
+    {0xB7, IREE_FATELF_FEATURE_ARM_64_SVE2, "sve2", IREE_CPU_DATA0_ARM_64_SVE2},
+    {0xB7, IREE_FATELF_FEATURE_ARM_64_SME, "sme", IREE_CPU_DATA0_ARM_64_SME},
+    {0xF3, IREE_FATELF_FEATURE_RISCV_64_V, "v", IREE_CPU_DATA0_RISCV_64_V},
+};
+
+iree_status_t iree_fatelf_lookup_feature(iree_elf64_half_t machine,
+                                         iree_string_view_t name,
+                                         iree_fatelf_features_t* out_feature) {
+  *out_feature = 0;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(iree_fatelf_feature_infos);
+       ++i) {
+    const iree_fatelf_feature_info_t* info = &iree_fatelf_feature_infos[i];
+    if (info->machine == machine &&
+        iree_string_view_equal(name, iree_make_cstring_view(info->name))) {
+      *out_feature = info->feature;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "FatELF feature '%.*s' not defined for machine %d",
+                          (int)name.size, name.data, machine);
+}
+
+const char* iree_fatelf_feature_name(iree_elf64_half_t machine,
+                                     iree_fatelf_features_t feature) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(iree_fatelf_feature_infos);
+       ++i) {
+    const iree_fatelf_feature_info_t* info = &iree_fatelf_feature_infos[i];
+    if (info->machine == machine && info->feature == feature) {
+      return info->name;
+    }
+  }
+  return NULL;
+}
+
+// Resolves the |features| of a |machine| record to the CPU data field 0 bits
+// required to support them. Returns false if any feature is not defined.
+static bool iree_fatelf_features_to_cpu_data0(iree_elf64_half_t machine,
+                                              iree_fatelf_features_t features,
+                                              uint64_t* out_cpu_data0) {
+  *out_cpu_data0 = 0;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(iree_fatelf_feature_infos);
+       ++i) {
+    const iree_fatelf_feature_info_t* info = &iree_fatelf_feature_infos[i];
+    if (info->machine == machine && (features & info->feature)) {
+      *out_cpu_data0 |= info->cpu_data0;
+      features &= ~info->feature;
+    }
+  }
+  return features == 0;
+}
+
+// Returns the number of bits set in |value|.
+static int iree_fatelf_count_ones(uint64_t value) {
+  int count = 0;
+  for (; value; value &= value - 1) ++count;
+  return count;
+}
+
+//===----------------------------------------------------------------------===//
+// ELF selection
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_fatelf_select_for_cpu(iree_const_byte_span_t file_data,
+                                         iree_host_size_t cpu_data_field_count,
+                                         const uint64_t* cpu_data_fields,
+                                         iree_const_byte_span_t* out_elf_data) {
   *out_elf_data = iree_const_byte_span_empty();
+  const uint64_t host_cpu_data0 =
+      cpu_data_field_count > 0 ? cpu_data_fields[0] : 0;
 
   // If there's not enough room for the header and a single record then don't
   // bother checking.
@@ -59,9 +160,12 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                             required_bytes, file_data.data_length);
   }
 
-  // Scan record table to find one that matches.
+  // Scan record table to find the most capable one that matches. Capability is
+  // approximated by the number of CPU features required and ties go to the
+  // record listed first.
   iree_elf64_off_t selected_offset = 0;
   iree_elf64_xword_t selected_size = 0;
+  int selected_feature_count = -1;
   for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
     const iree_fatelf_record_t* raw_record = &raw_header->records[i];
     const iree_fatelf_record_t host_record = {
@@ -70,8 +174,7 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
-        .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
+        .features = iree_unaligned_load_le_u16(&raw_record->features),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
     };
@@ -92,14 +195,24 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
 #else
     if (host_record.byte_order != IREE_FATELF_BYTE_ORDER_MSB) continue;
 #endif  // IREE_ENDIANNESS_LITTLE
+    uint64_t required_cpu_data0 = 0;
+    if (!iree_fatelf_features_to_cpu_data0(host_record.machine,
+                                           host_record.features,
+                                           &required_cpu_data0)) {
+      // Features from a newer tool that we can't check for.
+      continue;
+    }
+    if (!iree_all_bits_set(host_cpu_data0, required_cpu_data0)) continue;
+    int feature_count = iree_fatelf_count_ones(required_cpu_data0);
+    if (feature_count <= selected_feature_count) continue;
     selected_offset = host_record.offset;
     selected_size = host_record.size;
-    break;
+    selected_feature_count = feature_count;
   }
   if (!selected_offset || !selected_size) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "no ELFs matching the runtime architecture or "
-                            "Linux ABI found in the FatELF");
+                            "no ELFs matching the runtime architecture, "
+                            "Linux ABI, or CPU features found in the FatELF");
   }
 
   // Bounds check the file range - the caller expects valid pointers.
@@ -117,3 +230,9 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                             selected_size);
   return iree_ok_status();
 }
+
+iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
+                                 iree_const_byte_span_t* out_elf_data) {
+  return iree_fatelf_select_for_cpu(file_data, /*cpu_data_field_count=*/0,
+                                    /*cpu_data_fields=*/NULL, out_elf_data);
+}
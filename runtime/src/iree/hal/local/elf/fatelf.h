@@ -9,6 +9,10 @@
 
 #include "iree/hal/local/elf/elf_types.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
 // This file contains the basic headers and types used in FatELF.
 // https://icculus.org/fatelf/
 // https://github.com/icculus/fatelf
@@ -28,6 +32,8 @@
 //
 // To create a FatELF file from several ELFs:
 //   iree-fatelf join elf_a.so elf_b.so elf_c.so > fatelf.sos
+// To tag ELFs with the CPU features they require:
+//   iree-fatelf join elf.so elf_avx512.so@avx512,avx512vnni > fatelf.sos
 // To extract all ELFs from a FatELF file:
 //   iree-fatelf split fatelf.sos
 //
@@ -39,9 +45,8 @@
 #define IREE_FATELF_MAGIC 0x1F0E70FA  // FA700E1F 'fat' 'elf' lol
 
 // Only version 1 is defined. We may end up with our own versions if we diverge.
-// FatELF doesn't have any architectural feature requirement bits which makes it
-// difficult to support specialized ELFs based on things like instruction set
-// support and we may want to add that.
+// FatELF doesn't have any architectural feature requirement bits so we store
+// our own in the reserved bytes of each record (see iree_fatelf_features_t).
 #define IREE_FATELF_FORMAT_VERSION 1
 
 enum {
@@ -54,6 +59,30 @@ enum {
   IREE_FATELF_BYTE_ORDER_LSB = 1,  // IREE_ELF_ELFDATA2LSB - little-endian
 };
 
+// Bitfield of CPU features required by the ELF referenced by a record.
+// Bits are interpreted based on the record machine and each maps to one or more
+// bits of field 0 in iree/schemas/cpu_data.h. These are stored in bytes that
+// are reserved in the FatELF spec and zeroed by the original tools such that
+// their records have no requirements and are compatible with any CPU.
+typedef iree_elf64_half_t iree_fatelf_features_t;
+enum iree_fatelf_feature_bits_e {
+  // EM_X86_64:
+  IREE_FATELF_FEATURE_X86_64_AVX2 = 1u << 0,    // avx, avx2, fma, f16c
+  IREE_FATELF_FEATURE_X86_64_AVX512 = 1u << 1,  // avx512f/cd/vl/dq/bw
+  IREE_FATELF_FEATURE_X86_64_AVX512VNNI = 1u << 2,
+  IREE_FATELF_FEATURE_X86_64_AVX512BF16 = 1u << 3,
+  IREE_FATELF_FEATURE_X86_64_AVX512FP16 = 1u << 4,
+  IREE_FATELF_FEATURE_X86_64_AMX = 1u << 5,  // amx-tile, amx-int8, amx-bf16
+  // EM_AARCH64:
+  IREE_FATELF_FEATURE_ARM_64_DOTPROD = 1u << 0,
+  IREE_FATELF_FEATURE_ARM_64_I8MM = 1u << 1,
+  IREE_FATELF_FEATURE_ARM_64_SVE = 1u << 2,
+  IREE_FATELF_FEATURE_ARM_64_SVE2 = 1u << 3,
+  IREE_FATELF_FEATURE_ARM_64_SME = 1u << 4,
+  // EM_RISCV:
+  IREE_FATELF_FEATURE_RISCV_64_V = 1u << 0,
+};
+
 // An individual record in the FatELF record table.
 // This has some of the fields from the iree_elf_ehdr_t and references a header-
 // relative file range of where the corresponding ELF file can be found.
@@ -63,8 +92,7 @@ typedef struct {
   iree_elf64_byte_t osabi_version;  // e_ident[EI_ABIVERSION]
   iree_elf64_byte_t word_size;      // e_ident[EI_CLASS]
   iree_elf64_byte_t byte_order;     // e_ident[EI_DATA]
-  iree_elf64_byte_t reserved0;
-  iree_elf64_byte_t reserved1;
+  iree_fatelf_features_t features;  // reserved in the FatELF spec
   iree_elf64_off_t offset;
   iree_elf64_xword_t size;
 } iree_fatelf_record_t;
@@ -80,11 +108,37 @@ typedef struct {
 } iree_fatelf_header_t;
 static_assert(sizeof(iree_fatelf_header_t) == 8, "must be packed");
 
+// Looks up the feature bit of |machine| records with the given |name|, such as
+// `avx512vnni` or `sve`. Fails if the machine has no feature with that name.
+iree_status_t iree_fatelf_lookup_feature(iree_elf64_half_t machine,
+                                         iree_string_view_t name,
+                                         iree_fatelf_features_t* out_feature);
+
+// Returns the name of the single |feature| bit of |machine| records or NULL if
+// the bit is not defined for the machine.
+const char* iree_fatelf_feature_name(iree_elf64_half_t machine,
+                                     iree_fatelf_features_t feature);
+
+// Scans |file_data| for a FatELF header and if present selects the ELF for the
+// current system with the most CPU features supported by |cpu_data_fields|
+// (as returned by iree_cpu_data_fields). Records with feature requirements are
+// skipped if |cpu_data_field_count| is 0.
+// Upon return |out_elf_data| will either be the entire file if no FatELF header
+// was found or just the bytes of the selected ELF.
+iree_status_t iree_fatelf_select_for_cpu(iree_const_byte_span_t file_data,
+                                         iree_host_size_t cpu_data_field_count,
+                                         const uint64_t* cpu_data_fields,
+                                         iree_const_byte_span_t* out_elf_data);
+
 // Scans |file_data| for a FatELF header and if present selects the matching ELF
-// for the current system if available.
+// for the current system that has no CPU feature requirements.
 // Upon return |out_elf_data| will either be the entire file if no FatELF header
 // was found or just the bytes of the selected ELF.
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                  iree_const_byte_span_t* out_elf_data);
 
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
 #endif  // IREE_HAL_LOCAL_ELF_FATELF_H_
@@ -0,0 +1,163 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/elf/fatelf.h"
+
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/schemas/cpu_data.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Features of the host machine used to build records the runtime will accept.
+// |kFeatureA| is a prerequisite of |kFeatureB| on real hardware.
+#if defined(IREE_ARCH_X86_64)
+#define IREE_FATELF_TEST_HOST_MACHINE 0x3E
+static const iree_fatelf_features_t kFeatureA =
+    IREE_FATELF_FEATURE_X86_64_AVX2;
+static const uint64_t kCpuDataA =
+    IREE_CPU_DATA0_X86_64_AVX | IREE_CPU_DATA0_X86_64_AVX2 |
+    IREE_CPU_DATA0_X86_64_FMA | IREE_CPU_DATA0_X86_64_F16C;
+static const iree_fatelf_features_t kFeatureB =
+    IREE_FATELF_FEATURE_X86_64_AVX512;
+static const uint64_t kCpuDataB =
+    IREE_CPU_DATA0_X86_64_AVX512F | IREE_CPU_DATA0_X86_64_AVX512CD |
+    IREE_CPU_DATA0_X86_64_AVX512VL | IREE_CPU_DATA0_X86_64_AVX512DQ |
+    IREE_CPU_DATA0_X86_64_AVX512BW;
+#elif defined(IREE_ARCH_ARM_64)
+#define IREE_FATELF_TEST_HOST_MACHINE 0xB7
+static const iree_fatelf_features_t kFeatureA =
+    IREE_FATELF_FEATURE_ARM_64_DOTPROD;
+static const uint64_t kCpuDataA = IREE_CPU_DATA0_ARM_64_DOTPROD;
+static const iree_fatelf_features_t kFeatureB =
+    IREE_FATELF_FEATURE_ARM_64_I8MM;
+static const uint64_t kCpuDataB = IREE_CPU_DATA0_ARM_64_I8MM;
+#endif  // IREE_ARCH_*
+
+// Builds a FatELF with one record per entry of |features| on the host machine.
+// Each record references 16 bytes filled with the record index.
+static std::vector<uint8_t> MakeFatELF(
+    const std::vector<iree_fatelf_features_t>& features,
+    iree_elf64_half_t machine) {
+  const size_t record_count = features.size();
+  const size_t header_size = sizeof(iree_fatelf_header_t) +
+                             record_count * sizeof(iree_fatelf_record_t);
+  const size_t elf_size = 16;
+  std::vector<uint8_t> file(header_size + record_count * elf_size);
+  iree_fatelf_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = IREE_FATELF_MAGIC;
+  header.version = IREE_FATELF_FORMAT_VERSION;
+  header.record_count = (iree_elf64_byte_t)record_count;
+  memcpy(file.data(), &header, sizeof(header));
+  for (size_t i = 0; i < record_count; ++i) {
+    iree_fatelf_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.machine = machine;
+    record.osabi = IREE_ELF_ELFOSABI_NONE;
+#if defined(IREE_PTR_SIZE_32)
+    record.word_size = IREE_FATELF_WORD_SIZE_32;
+#else
+    record.word_size = IREE_FATELF_WORD_SIZE_64;
+#endif  // IREE_PTR_SIZE_32
+    record.byte_order = IREE_FATELF_BYTE_ORDER_LSB;
+    record.features = features[i];
+    record.offset = header_size + i * elf_size;
+    record.size = elf_size;
+    memcpy(file.data() + sizeof(header) + i * sizeof(record), &record,
+           sizeof(record));
+    memset(file.data() + record.offset, (int)i, elf_size);
+  }
+  return file;
+}
+
+// Returns the index of the record selected from |file| for |cpu_data0|.
+static int SelectRecord(const std::vector<uint8_t>& file, uint64_t cpu_data0) {
+  iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
+  iree_status_t status = iree_fatelf_select_for_cpu(
+      iree_make_const_byte_span(file.data(), file.size()),
+      /*cpu_data_field_count=*/1, &cpu_data0, &elf_data);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return -1;
+  }
+  return elf_data.data[0];
+}
+
+TEST(FatELFTest, LookupFeature) {
+  iree_fatelf_features_t feature = 0;
+  IREE_ASSERT_OK(iree_fatelf_lookup_feature(
+      0x3E, iree_make_cstring_view("avx512vnni"), &feature));
+  EXPECT_EQ(IREE_FATELF_FEATURE_X86_64_AVX512VNNI, feature);
+  EXPECT_STREQ("avx512vnni", iree_fatelf_feature_name(0x3E, feature));
+  IREE_ASSERT_OK(iree_fatelf_lookup_feature(
+      0xB7, iree_make_cstring_view("sve"), &feature));
+  EXPECT_EQ(IREE_FATELF_FEATURE_ARM_64_SVE, feature);
+  EXPECT_STREQ("sve", iree_fatelf_feature_name(0xB7, feature));
+}
+
+TEST(FatELFTest, LookupFeatureWrongMachine) {
+  iree_fatelf_features_t feature = 0;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND,
+                        iree_fatelf_lookup_feature(
+                            0xB7, iree_make_cstring_view("avx2"), &feature));
+  EXPECT_EQ(NULL, iree_fatelf_feature_name(0xB7, 1u << 15));
+}
+
+TEST(FatELFTest, PassThroughNonFatELF) {
+  std::vector<uint8_t> file(64, 0x7F);
+  iree_const_byte_span_t file_data =
+      iree_make_const_byte_span(file.data(), file.size());
+  iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
+  IREE_ASSERT_OK(iree_fatelf_select(file_data, &elf_data));
+  EXPECT_EQ(file_data.data, elf_data.data);
+  EXPECT_EQ(file_data.data_length, elf_data.data_length);
+}
+
+#if defined(IREE_FATELF_TEST_HOST_MACHINE) && IREE_ENDIANNESS_LITTLE
+
+// Without CPU data only records without requirements can be selected.
+TEST(FatELFTest, SelectWithoutCpuData) {
+  auto file = MakeFatELF({kFeatureA, 0}, IREE_FATELF_TEST_HOST_MACHINE);
+  iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
+  IREE_ASSERT_OK(iree_fatelf_select(
+      iree_make_const_byte_span(file.data(), file.size()), &elf_data));
+  EXPECT_EQ(1, elf_data.data[0]);
+}
+
+TEST(FatELFTest, SelectMostCapable) {
+  auto file = MakeFatELF({0, kFeatureA | kFeatureB, kFeatureA},
+                         IREE_FATELF_TEST_HOST_MACHINE);
+  EXPECT_EQ(0, SelectRecord(file, 0));
+  EXPECT_EQ(2, SelectRecord(file, kCpuDataA));
+  EXPECT_EQ(0, SelectRecord(file, kCpuDataB));
+  EXPECT_EQ(1, SelectRecord(file, kCpuDataA | kCpuDataB));
+}
+
+// Ties go to the first record in the table.
+TEST(FatELFTest, SelectFirstOfEqual) {
+  auto file = MakeFatELF({kFeatureA, kFeatureA}, IREE_FATELF_TEST_HOST_MACHINE);
+  EXPECT_EQ(0, SelectRecord(file, kCpuDataA));
+}
+
+TEST(FatELFTest, SelectNoneCompatible) {
+  auto file = MakeFatELF({kFeatureA}, IREE_FATELF_TEST_HOST_MACHINE);
+  EXPECT_EQ(-1, SelectRecord(file, 0));
+}
+
+// Records requiring features unknown to this runtime are never selected.
+TEST(FatELFTest, SelectSkipsUnknownFeatures) {
+  auto file = MakeFatELF({0, 1u << 15}, IREE_FATELF_TEST_HOST_MACHINE);
+  EXPECT_EQ(0, SelectRecord(file, ~0ull));
+}
+
+#endif  // IREE_FATELF_TEST_HOST_MACHINE && IREE_ENDIANNESS_LITTLE
+
+}  // namespace
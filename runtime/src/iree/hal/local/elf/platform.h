@@ -7,6 +7,8 @@
 #ifndef IREE_HAL_LOCAL_ELF_PLATFORM_H_
 #define IREE_HAL_LOCAL_ELF_PLATFORM_H_
 
+#include <stdio.h>
+
 #include "iree/base/api.h"
 
 // TODO(benvanik): move some of this to iree/base/internal/. A lot of this code
@@ -70,15 +72,20 @@ typedef struct iree_memory_info_t {
   // allocated.
   iree_host_size_t normal_page_granularity;
 
-  // The minimum page size and granularity for large pages or 0 if unavailable.
-  // To use large pages the size and alignment must be a multiple of this value
-  // and the IREE_MEMORY_VIEW_FLAG_LARGE_PAGES must be set.
+  // The minimum page size and granularity for large pages or the normal page
+  // size if unavailable. Only the ranges of views reserved with
+  // IREE_MEMORY_VIEW_FLAG_LARGE_PAGES that are aligned to this value may be
+  // backed by large pages.
   iree_host_size_t large_page_granularity;
 
   // Indicates whether executable pages may be allocated within the process.
   // Some platforms or release environments have restrictions on whether
   // executable pages may be allocated from user code (such as iOS).
   bool can_allocate_executable_pages;
+
+  // Indicates whether file contents may be mapped executable into the process
+  // with iree_memory_view_map_file_ranges.
+  bool can_map_executable_files;
 } iree_memory_info_t;
 
 // Queries the system platform/environment memory information.
@@ -128,6 +135,14 @@ enum iree_memory_view_flag_bits_t {
   // Indicates that the memory may be used to execute code.
   // May be used to ask for special privileges (like MAP_JIT on MacOS).
   IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE = 1u << 10,
+
+  // Requests that the view be backed by large pages where possible to reduce
+  // TLB pressure. This is a hint: reservations smaller than
+  // iree_memory_info_t::large_page_granularity or on hosts without large page
+  // support use normal pages. Views still have normal page granularity for
+  // commitment and protection though the host may split large pages to apply
+  // them.
+  IREE_MEMORY_VIEW_FLAG_LARGE_PAGES = 1u << 11,
 };
 typedef uint32_t iree_memory_view_flags_t;
 
@@ -146,6 +161,17 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
                                        iree_allocator_t host_allocator,
                                        void** out_base_address);
 
+// Reserves a range of virtual address space at exactly |base_address|, with
+// the same semantics as iree_memory_view_reserve otherwise. |base_address|
+// must be aligned to the page granularity.
+//
+// Returns IREE_STATUS_UNAVAILABLE if any part of the range is already in use
+// and IREE_STATUS_UNIMPLEMENTED if the platform cannot reserve fixed ranges.
+iree_status_t iree_memory_view_reserve_at(iree_memory_view_flags_t flags,
+                                          void* base_address,
+                                          iree_host_size_t total_length,
+                                          iree_allocator_t host_allocator);
+
 // Releases a range of virtual address
 void iree_memory_view_release(void* base_address, iree_host_size_t total_length,
                               iree_allocator_t host_allocator);
@@ -169,6 +195,22 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
                                               const iree_byte_range_t* ranges,
                                               iree_memory_access_t new_access);
 
+// Maps pages overlapping the byte ranges defined by |byte_ranges| from |file|
+// with |access|, replacing any prior contents. Byte |offset| of the view maps
+// to byte |file_offset| + |offset| of the file, which must be aligned to the
+// page granularity. Mappings are private: writes are never visible in the file
+// and the file may be closed, renamed, or deleted after mapping. The file must
+// not be truncated while mapped.
+//
+// Returns IREE_STATUS_UNIMPLEMENTED if
+// iree_memory_info_t::can_map_executable_files is false.
+//
+// Implemented by mmap+MAP_PRIVATE|MAP_FIXED.
+iree_status_t iree_memory_view_map_file_ranges(
+    void* base_address, iree_host_size_t range_count,
+    const iree_byte_range_t* ranges, FILE* file, uint64_t file_offset,
+    iree_memory_access_t access);
+
 // Flushes the CPU instruction cache for a given range of bytes.
 // May be a no-op depending on architecture, but must be called prior to
 // executing code from any pages that have been written during load.
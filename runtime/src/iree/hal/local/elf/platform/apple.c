@@ -106,6 +106,16 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   return status;
 }
 
+iree_status_t iree_memory_view_reserve_at(iree_memory_view_flags_t flags,
+                                          void* base_address,
+                                          iree_host_size_t total_length,
+                                          iree_allocator_t host_allocator) {
+  // Only used for mapping files, which is not supported; see
+  // iree_memory_view_map_file_ranges.
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "fixed address reservations not implemented");
+}
+
 void iree_memory_view_release(void* base_address, iree_host_size_t total_length,
                               iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -169,6 +179,16 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file_ranges(
+    void* base_address, iree_host_size_t range_count,
+    const iree_byte_range_t* ranges, FILE* file, uint64_t file_offset,
+    iree_memory_access_t access) {
+  // The hardened runtime only allows executing file-backed pages that are
+  // code signed, which files written at runtime are not.
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "executable file mapping not supported");
+}
+
 void sys_icache_invalidate(void* start, size_t len);
 
 void iree_memory_view_flush_icache(void* base_address,
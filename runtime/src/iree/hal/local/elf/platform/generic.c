@@ -51,6 +51,15 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   return status;
 }
 
+iree_status_t iree_memory_view_reserve_at(iree_memory_view_flags_t flags,
+                                          void* base_address,
+                                          iree_host_size_t total_length,
+                                          iree_allocator_t host_allocator) {
+  // Generic platforms have no virtual memory.
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "fixed address reservations not implemented");
+}
+
 void iree_memory_view_release(void* base_address, iree_host_size_t total_length,
                               iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -73,6 +82,15 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return iree_ok_status();
 }
 
+iree_status_t iree_memory_view_map_file_ranges(
+    void* base_address, iree_host_size_t range_count,
+    const iree_byte_range_t* ranges, FILE* file, uint64_t file_offset,
+    iree_memory_access_t access) {
+  // Generic platforms have no virtual memory.
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "executable file mapping not implemented");
+}
+
 // IREE_ELF_CLEAR_CACHE can be defined externally to override this default
 // behavior.
 #if !defined(IREE_ELF_CLEAR_CACHE)
@@ -25,16 +25,19 @@ void iree_memory_query_info(iree_memory_info_t* out_info) {
   out_info->normal_page_size = page_size;
   out_info->normal_page_granularity = page_size;
 
-  // Large pages arent't currently used so we aren't introducing the build goo
-  // to detect and use them yet.
-  // https://linux.die.net/man/3/gethugepagesizes
-  // http://manpages.ubuntu.com/manpages/bionic/man3/gethugepagesize.3.html
-  // Would be:
-  //   #include <hugetlbfs.h>
-  //   out_info->large_page_granularity = gethugepagesize();
+  // Large pages are transparent huge pages requested with madvise. Their size
+  // is that of a page table directory entry: one page of 8-byte entries each
+  // mapping a normal page (2MB with 4KB pages on x86_64 and aarch64). If THP
+  // is disabled system-wide the advice is ignored and normal pages are used.
+  // hugetlbfs is not used as it requires a preallocated pool.
   out_info->large_page_granularity = page_size;
+#if defined(MADV_HUGEPAGE)
+  out_info->large_page_granularity =
+      (iree_host_size_t)page_size * page_size / 8;
+#endif  // MADV_HUGEPAGE
 
   out_info->can_allocate_executable_pages = true;
+  out_info->can_map_executable_files = true;
 }
 
 void iree_memory_jit_context_begin(void) {}
@@ -63,18 +66,86 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   int mmap_prot = PROT_NONE;
   int mmap_flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
 
+  // Large pages can only back ranges aligned to the large page size so we
+  // over-reserve and trim to get an aligned base.
+  iree_host_size_t alignment = 0;
+#if defined(MADV_HUGEPAGE)
+  if (iree_all_bits_set(flags, IREE_MEMORY_VIEW_FLAG_LARGE_PAGES)) {
+    iree_memory_info_t memory_info;
+    iree_memory_query_info(&memory_info);
+    if (memory_info.large_page_granularity > memory_info.normal_page_size &&
+        total_length >= memory_info.large_page_granularity) {
+      alignment = memory_info.large_page_granularity;
+    }
+  }
+#endif  // MADV_HUGEPAGE
+  iree_host_size_t reserve_length =
+      alignment ? total_length + alignment : total_length;
+
   iree_status_t status = iree_ok_status();
-  void* base_address = mmap(NULL, total_length, mmap_prot, mmap_flags, -1, 0);
+  void* base_address = mmap(NULL, reserve_length, mmap_prot, mmap_flags, -1, 0);
   if (base_address == MAP_FAILED) {
     status = iree_make_status(iree_status_code_from_errno(errno),
                               "mmap reservation failed");
   }
 
+#if defined(MADV_HUGEPAGE)
+  if (iree_status_is_ok(status) && alignment) {
+    uint8_t* reserve_base = (uint8_t*)base_address;
+    uint8_t* aligned_base = (uint8_t*)iree_host_align(
+        (iree_host_size_t)reserve_base, alignment);
+    if (aligned_base > reserve_base) {
+      munmap(reserve_base, aligned_base - reserve_base);
+    }
+    uint8_t* aligned_end = aligned_base + total_length;
+    uint8_t* reserve_end = reserve_base + reserve_length;
+    if (reserve_end > aligned_end) {
+      munmap(aligned_end, reserve_end - aligned_end);
+    }
+    base_address = aligned_base;
+    // Advice failures (such as THP being compiled out) just mean normal pages.
+    madvise(base_address, total_length, MADV_HUGEPAGE);
+  }
+#endif  // MADV_HUGEPAGE
+
   *out_base_address = base_address;
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+iree_status_t iree_memory_view_reserve_at(iree_memory_view_flags_t flags,
+                                          void* base_address,
+                                          iree_host_size_t total_length,
+                                          iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int mmap_prot = PROT_NONE;
+  int mmap_flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
+#if defined(MAP_FIXED_NOREPLACE)
+  // Kernels prior to 4.17 ignore the flag and treat the address as a hint, in
+  // which case the address check below catches the mapping landing elsewhere.
+  mmap_flags |= MAP_FIXED_NOREPLACE;
+#endif  // MAP_FIXED_NOREPLACE
+
+  iree_status_t status = iree_ok_status();
+  void* result =
+      mmap(base_address, total_length, mmap_prot, mmap_flags, -1, 0);
+  if (result == MAP_FAILED) {
+    status = errno == EEXIST
+                 ? iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                    "address range already in use")
+                 : iree_make_status(iree_status_code_from_errno(errno),
+                                    "mmap reservation failed");
+  } else if (result != base_address) {
+    munmap(result, total_length);
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "address range already in use");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 void iree_memory_view_release(void* base_address, iree_host_size_t total_length,
                               iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -138,6 +209,38 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file_ranges(
+    void* base_address, iree_host_size_t range_count,
+    const iree_byte_range_t* ranges, FILE* file, uint64_t file_offset,
+    iree_memory_access_t access) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int mmap_prot = iree_memory_access_to_prot(access);
+  int mmap_flags = MAP_PRIVATE | MAP_FIXED;
+  int fd = fileno(file);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    void* range_start = NULL;
+    iree_host_size_t aligned_length = 0;
+    iree_page_align_range(base_address, ranges[i], getpagesize(), &range_start,
+                          &aligned_length);
+    off_t range_file_offset =
+        (off_t)(file_offset +
+                ((uintptr_t)range_start - (uintptr_t)base_address));
+    void* result = mmap(range_start, aligned_length, mmap_prot, mmap_flags, fd,
+                        range_file_offset);
+    if (result == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "mmap of file range failed");
+      break;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // IREE_ELF_CLEAR_CACHE can be defined externally to override this default
 // behavior.
 #if !defined(IREE_ELF_CLEAR_CACHE)
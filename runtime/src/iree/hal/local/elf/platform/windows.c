@@ -75,6 +75,9 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
 
   iree_status_t status = iree_ok_status();
 
+  // TODO: support IREE_MEMORY_VIEW_FLAG_LARGE_PAGES. MEM_LARGE_PAGES requires
+  // SeLockMemoryPrivilege and committing the whole range at reservation time,
+  // neither of which fit the reserve/commit model here, so it's ignored.
   void* base_address =
       VirtualAlloc(NULL, total_length, MEM_RESERVE, PAGE_NOACCESS);
   if (base_address == NULL) {
@@ -87,6 +90,24 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   return status;
 }
 
+iree_status_t iree_memory_view_reserve_at(iree_memory_view_flags_t flags,
+                                          void* base_address,
+                                          iree_host_size_t total_length,
+                                          iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  void* result =
+      VirtualAlloc(base_address, total_length, MEM_RESERVE, PAGE_NOACCESS);
+  if (result == NULL) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "address range already in use");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 void iree_memory_view_release(void* base_address, iree_host_size_t total_length,
                               iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -144,6 +165,16 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file_ranges(
+    void* base_address, iree_host_size_t range_count,
+    const iree_byte_range_t* ranges, FILE* file, uint64_t file_offset,
+    iree_memory_access_t access) {
+  // TODO: implement with MapViewOfFile3 into the reservation
+  // placeholders (Windows 10 1803+).
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "executable file mapping not implemented");
+}
+
 void iree_memory_view_flush_icache(void* base_address,
                                    iree_host_size_t length) {
   FlushInstructionCache(GetCurrentProcess(), base_address, length);
@@ -31,3 +31,92 @@ void iree_hal_executable_environment_initialize(
 
   IREE_TRACE_ZONE_END(z0);
 }
+
+//===----------------------------------------------------------------------===//
+// Export variant selection
+//===----------------------------------------------------------------------===//
+
+// Returns true if |processor| has all of the bits set in |requirements|.
+static bool iree_hal_processor_meets_requirements(
+    const iree_hal_processor_v0_t* processor,
+    const iree_hal_processor_v0_t* requirements) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(processor->data); ++i) {
+    if (!iree_all_bits_set(processor->data[i], requirements->data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+iree_status_t iree_hal_executable_library_select_export_ptrs(
+    const iree_hal_executable_library_v0_t* library,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_allocator_t host_allocator,
+    const iree_hal_executable_dispatch_v0_t** out_ptrs) {
+  IREE_ASSERT_ARGUMENT(library);
+  IREE_ASSERT_ARGUMENT(environment);
+  IREE_ASSERT_ARGUMENT(out_ptrs);
+  *out_ptrs = library->exports.ptrs;
+  if (!iree_all_bits_set(library->header->features,
+                         IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS)) {
+    return iree_ok_status();
+  }
+  const iree_hal_executable_export_variant_table_v0_t* variants =
+      &library->variants;
+  if (!variants->count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (uint64_t)variants->count);
+
+  // Allocated on the first usable variant; bits in |selected| track which
+  // exports already have their (most preferred) variant.
+  iree_hal_executable_dispatch_v0_t* ptrs = NULL;
+  uint64_t* selected = NULL;
+  const uint32_t export_count = library->exports.count;
+  const iree_host_size_t selected_words = (export_count + 63) / 64;
+  iree_status_t status = iree_ok_status();
+  for (uint32_t i = 0; i < variants->count; ++i) {
+    const uint32_t ordinal = variants->ordinals[i];
+    if (IREE_UNLIKELY(ordinal >= export_count)) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "export variant %u implements export %u but "
+                                "the library only has %u exports",
+                                i, ordinal, export_count);
+      break;
+    }
+    if (selected && (selected[ordinal / 64] & (1ull << (ordinal % 64)))) {
+      continue;
+    }
+    if (!iree_hal_processor_meets_requirements(&environment->processor,
+                                               &variants->requirements[i])) {
+      continue;
+    }
+    if (!ptrs) {
+      status = iree_allocator_malloc(
+          host_allocator,
+          export_count * sizeof(*ptrs) + selected_words * sizeof(*selected),
+          (void**)&ptrs);
+      if (!iree_status_is_ok(status)) break;
+      memcpy(ptrs, library->exports.ptrs, export_count * sizeof(*ptrs));
+      selected = (uint64_t*)(ptrs + export_count);
+      memset(selected, 0, selected_words * sizeof(*selected));
+    }
+    ptrs[ordinal] = variants->ptrs[i];
+    selected[ordinal / 64] |= 1ull << (ordinal % 64);
+  }
+
+  if (iree_status_is_ok(status)) {
+    if (ptrs) *out_ptrs = ptrs;
+  } else {
+    iree_allocator_free(host_allocator, ptrs);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_executable_library_release_export_ptrs(
+    const iree_hal_executable_library_v0_t* library,
+    const iree_hal_executable_dispatch_v0_t* ptrs,
+    iree_allocator_t host_allocator) {
+  if (!library || !ptrs || ptrs == library->exports.ptrs) return;
+  iree_allocator_free(host_allocator, (void*)ptrs);
+}
@@ -28,6 +28,46 @@ void iree_hal_executable_environment_initialize(
     iree_allocator_t temp_allocator,
     iree_hal_executable_environment_v0_t* out_environment);
 
+//===----------------------------------------------------------------------===//
+// Export variant selection
+//===----------------------------------------------------------------------===//
+
+// Selects the function implementing each export of |library| on the processor
+// described by |environment|, preferring the library export variants (if any)
+// over the export table entries.
+//
+// If no variant is usable |out_ptrs| is set to the library export table and
+// nothing is allocated. Otherwise it is set to a table of exports.count
+// function pointers allocated from |host_allocator| that must be freed with
+// iree_hal_executable_library_release_export_ptrs.
+iree_status_t iree_hal_executable_library_select_export_ptrs(
+    const iree_hal_executable_library_v0_t* library,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_allocator_t host_allocator,
+    const iree_hal_executable_dispatch_v0_t** out_ptrs);
+
+// Frees |ptrs| as returned by iree_hal_executable_library_select_export_ptrs
+// for |library|, if it was allocated.
+void iree_hal_executable_library_release_export_ptrs(
+    const iree_hal_executable_library_v0_t* library,
+    const iree_hal_executable_dispatch_v0_t* ptrs,
+    iree_allocator_t host_allocator);
+
+//===----------------------------------------------------------------------===//
+// Export cost hints
+//===----------------------------------------------------------------------===//
+
+// Returns the estimated dispatch costs table of |library| 1:1 with its exports
+// or NULL if the library has none.
+static inline const iree_hal_executable_dispatch_cost_v0_t*
+iree_hal_executable_library_export_costs(
+    const iree_hal_executable_library_v0_t* library) {
+  return iree_all_bits_set(library->header->features,
+                           IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_COSTS)
+             ? library->costs
+             : NULL;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
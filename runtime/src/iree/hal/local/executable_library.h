@@ -40,6 +40,13 @@
 // Defines a bitfield of features that the library requires or supports.
 enum iree_hal_executable_library_feature_bits_t {
   IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE = 0u,
+  // The library has an iree_hal_executable_library_v0_t::variants table.
+  // Libraries without this feature end at the constants table.
+  IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS = 1u << 0,
+  // The library has an iree_hal_executable_library_v0_t::costs table. The
+  // variants table must also be present (zeroed if the library does not declare
+  // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS) as it precedes it.
+  IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_COSTS = 1u << 1,
   // TODO(benvanik): declare features for debugging/coverage/printf/etc.
   // These will control which symbols are injected into the library at runtime.
 };
@@ -388,6 +395,24 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
+// Statically estimated cost of exported dispatch functions used by runtimes as
+// scheduling hints. Estimates are approximate and may be 0 if unknown; they
+// must never affect the results of a dispatch.
+typedef struct iree_hal_executable_dispatch_cost_v0_t {
+  // Approximate number of arithmetic operations (counting each vector lane)
+  // performed by a single workgroup.
+  uint64_t workgroup_ops;
+  // Approximate number of bytes loaded and stored by a single workgroup.
+  uint64_t workgroup_bytes;
+  // Preferred minimum number of workgroups each worker should execute when the
+  // dispatch is distributed across workers. Smaller dispatches use fewer
+  // workers such that the cost of waking and synchronizing them is amortized.
+  uint32_t tiles_per_worker;
+  // Must be 0.
+  uint32_t reserved;
+} iree_hal_executable_dispatch_cost_v0_t;
+static_assert(sizeof(iree_hal_executable_dispatch_cost_v0_t) == 24, "");
+
 // Source location information for a dispatch function indicating what code was
 // used to generate it. This only represents a single source snapshot, of which
 // there may be multiple valid possibilities (source program in Python, imported
@@ -439,6 +464,32 @@ typedef struct iree_hal_executable_constant_table_v0_t {
   // We could add more metadata here if we wanted to enable reflection.
 } iree_hal_executable_constant_table_v0_t;
 
+// A table of alternative implementations of exported functions specialized
+// for processors with particular features, arranged as a struct-of-arrays like
+// iree_hal_executable_export_table_v0_t. Each subarray has |count| entries.
+//
+// The runtime selects the implementation of each export once when loading the
+// library: the first variant of the export whose requirements are met by
+// iree_hal_executable_environment_v0_t::processor is used in place of the
+// export table entry. Variants of an export should therefore be ordered from
+// most to least preferred. The export table entry remains the fallback and
+// must run on any processor the library supports.
+typedef struct iree_hal_executable_export_variant_table_v0_t {
+  // Total number of variants in the table.
+  uint32_t count;
+
+  // Ordinal of the export in the export table implemented by each variant.
+  const uint32_t* ordinals;
+
+  // Processor data bits required by each variant: a variant is only usable if
+  // all bits set in each data field are also set in the corresponding field of
+  // the environment processor. See iree/schemas/cpu_data.h.
+  const iree_hal_processor_v0_t* requirements;
+
+  // Function pointers for each variant.
+  const iree_hal_executable_dispatch_v0_t* ptrs;
+} iree_hal_executable_export_variant_table_v0_t;
+
 // Structure used for v0 library interfaces.
 // The entire structure is designed to be read-only and able to live embedded in
 // the binary .rdata section.
@@ -462,6 +513,18 @@ typedef struct iree_hal_executable_library_v0_t {
 
   // Table of executable-level constants.
   iree_hal_executable_constant_table_v0_t constants;
+
+  // Table of processor-specific export implementations.
+  // Only present if the header declares
+  // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS and must not be
+  // accessed otherwise.
+  iree_hal_executable_export_variant_table_v0_t variants;
+
+  // Optional table of estimated dispatch costs 1:1 with exports.ptrs.
+  // Only present if the header declares
+  // IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_COSTS and must not be accessed
+  // otherwise. May be NULL if no estimates are available.
+  const iree_hal_executable_dispatch_cost_v0_t* costs;
 } iree_hal_executable_library_v0_t;
 
 #endif  // IREE_HAL_LOCAL_EXECUTABLE_LIBRARY_H_
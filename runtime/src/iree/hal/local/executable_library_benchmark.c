@@ -159,8 +159,9 @@ static iree_status_t iree_hal_executable_library_run(
 
   // Load the executable data.
   iree_file_contents_t* file_contents = NULL;
-  IREE_RETURN_IF_ERROR(iree_file_read_contents(FLAG_executable_file,
-                                               host_allocator, &file_contents));
+  IREE_RETURN_IF_ERROR(
+      iree_file_read_contents(FLAG_executable_file, IREE_FILE_READ_FLAG_DEFAULT,
+                              host_allocator, &file_contents));
   executable_params.executable_data = file_contents->const_buffer;
 
   // Setup the layouts defining how each entry point is interpreted.
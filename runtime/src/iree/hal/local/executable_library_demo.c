@@ -36,6 +36,16 @@ static int dispatch_tile_a(
   return 0;
 }
 
+// A variant of dispatch_tile_a the runtime uses instead on processors meeting
+// its requirements. Variants would usually be generated from the same source
+// with additional CPU features enabled and must produce the same results.
+static int dispatch_tile_a_variant(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  return dispatch_tile_a(environment, dispatch_state, workgroup_state);
+}
+
 // Just another entry point.
 static int dispatch_tile_b(
     const iree_hal_executable_environment_v0_t* environment,
@@ -52,7 +62,9 @@ static const iree_hal_executable_library_header_t header = {
     .version = IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST,
     // Name used for logging/diagnostics and rendezvous.
     .name = "demo_library",
-    .features = IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    // Declares that the library has export variant and cost tables.
+    .features = IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_VARIANTS |
+                IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_EXPORT_COSTS,
     .sanitizer = IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
 };
 // Table of export function entry points.
@@ -81,6 +93,39 @@ static const char* entry_point_tags[2] = {
     "matmul+div",
     "conv2d[512x512]",
 };
+// Alternative implementations of exports ordered by preference. The first
+// variant requires a processor data bit no processor sets so the runtime will
+// always skip it while the second variant has no requirements.
+static const uint32_t variant_ordinals[2] = {
+    0,
+    0,
+};
+static const iree_hal_processor_v0_t variant_requirements[2] = {
+    {
+        .data = {0, 0, 0, 0, 0, 0, 0, 1ull << 63},
+    },
+    {
+        .data = {0},
+    },
+};
+static const iree_hal_executable_dispatch_v0_t variant_ptrs[2] = {
+    dispatch_tile_b,
+    dispatch_tile_a_variant,
+};
+// Optional estimated costs of each dispatch function used by the runtime to
+// decide how to distribute workgroups. Estimates are only hints and may be
+// omitted for some or all dispatch functions by leaving them 0.
+static const iree_hal_executable_dispatch_cost_v0_t entry_costs[2] = {
+    {
+        .workgroup_ops = 1,
+        .workgroup_bytes = 2 * sizeof(float),
+        .tiles_per_worker = 64,
+    },
+    {
+        .workgroup_ops = 0,
+        .workgroup_bytes = 0,
+    },
+};
 static const iree_hal_executable_library_v0_t library = {
     .header = &header,
     .imports =
@@ -100,6 +145,14 @@ static const iree_hal_executable_library_v0_t library = {
         {
             .count = 0,
         },
+    .variants =
+        {
+            .count = 2,
+            .ordinals = variant_ordinals,
+            .requirements = variant_requirements,
+            .ptrs = variant_ptrs,
+        },
+    .costs = entry_costs,
 };
 
 // The primary access point to the executable: in a static library this is
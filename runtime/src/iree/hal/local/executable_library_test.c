@@ -77,9 +77,25 @@ int main(int argc, char** argv) {
       ret0,
   };
 
+  // Select the implementation of each export best suited to the processor.
+  // The export table entries are used unless the library provides variants
+  // for the processor.
+  const iree_hal_executable_dispatch_v0_t* export_ptrs = NULL;
+  IREE_CHECK_OK(iree_hal_executable_library_select_export_ptrs(
+      library.v0, &environment, iree_allocator_system(), &export_ptrs));
+  IREE_ASSERT(export_ptrs[0] != library.v0->exports.ptrs[0],
+              "expected the demo variant without requirements to be selected");
+  IREE_ASSERT(export_ptrs[1] == library.v0->exports.ptrs[1],
+              "expected exports without variants to be unchanged");
+
+  // Cost estimates are optional scheduling hints.
+  const iree_hal_executable_dispatch_cost_v0_t* export_costs =
+      iree_hal_executable_library_export_costs(library.v0);
+  IREE_ASSERT(export_costs && export_costs[0].tiles_per_worker > 0,
+              "expected the demo cost estimates to be present");
+
   // Resolve the entry point by ordinal.
-  const iree_hal_executable_dispatch_v0_t entry_fn_ptr =
-      library.v0->exports.ptrs[0];
+  const iree_hal_executable_dispatch_v0_t entry_fn_ptr = export_ptrs[0];
 
   // Dispatch each workgroup with the same state.
   const iree_hal_executable_dispatch_state_v0_t dispatch_state = {
@@ -115,6 +131,9 @@ int main(int argc, char** argv) {
     }
   }
 
+  iree_hal_executable_library_release_export_ptrs(
+      library.v0, export_ptrs, iree_allocator_system());
+
   // Ensure it worked.
   bool all_match = true;
   for (size_t i = 0; i < IREE_ARRAYSIZE(ret0_expected); ++i) {
@@ -6,6 +6,12 @@
 
 #include "iree/hal/local/executable_loader.h"
 
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+
 #if defined(IREE_HAL_EXECUTABLE_IMPORT_PROVIDER_DEFAULT_FN)
 
 // Defined by the user and linked in to the binary:
@@ -58,6 +64,141 @@ iree_status_t iree_hal_executable_import_provider_resolve(
   return status;
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_library_t
+//===----------------------------------------------------------------------===//
+
+// Process-wide registry of shared libraries. Libraries are expected to number
+// in the tens to hundreds and are only looked up when creating executables so
+// a list is sufficient.
+typedef struct iree_hal_shared_library_registry_t {
+  // Guards the list and all library reference counts.
+  iree_slim_mutex_t mutex;
+  iree_hal_shared_library_t* head;
+} iree_hal_shared_library_registry_t;
+
+static iree_hal_shared_library_registry_t iree_hal_shared_library_registry_;
+static iree_once_flag iree_hal_shared_library_registry_flag_ =
+    IREE_ONCE_FLAG_INIT;
+static void iree_hal_shared_library_registry_initialize(void) {
+  memset(&iree_hal_shared_library_registry_, 0,
+         sizeof(iree_hal_shared_library_registry_));
+  iree_slim_mutex_initialize(&iree_hal_shared_library_registry_.mutex);
+}
+
+static iree_hal_shared_library_registry_t* iree_hal_shared_library_registry(
+    void) {
+  iree_call_once(&iree_hal_shared_library_registry_flag_,
+                 iree_hal_shared_library_registry_initialize);
+  return &iree_hal_shared_library_registry_;
+}
+
+static bool iree_hal_shared_library_key_equal(
+    const iree_hal_shared_library_key_t* lhs,
+    const iree_hal_shared_library_key_t* rhs) {
+  return lhs->loader_id == rhs->loader_id && lhs->flags == rhs->flags &&
+         lhs->data_length == rhs->data_length &&
+         lhs->data_hashes[0] == rhs->data_hashes[0] &&
+         lhs->data_hashes[1] == rhs->data_hashes[1];
+}
+
+// Returns a new reference to the library registered under |key| or NULL.
+// Expects the registry lock to be held.
+static iree_hal_shared_library_t* iree_hal_shared_library_registry_lookup(
+    iree_hal_shared_library_registry_t* registry,
+    const iree_hal_shared_library_key_t* key) {
+  for (iree_hal_shared_library_t* library = registry->head; library;
+       library = library->next) {
+    if (iree_hal_shared_library_key_equal(&library->key, key)) {
+      ++library->ref_count;
+      return library;
+    }
+  }
+  return NULL;
+}
+
+void iree_hal_shared_library_initialize(
+    void(IREE_API_PTR* destroy)(iree_hal_shared_library_t* library),
+    iree_hal_shared_library_t* out_library) {
+  memset(out_library, 0, sizeof(*out_library));
+  out_library->ref_count = 1;
+  out_library->destroy = destroy;
+}
+
+iree_status_t iree_hal_shared_library_acquire(
+    const iree_hal_shared_library_key_t* key,
+    iree_hal_shared_library_load_fn_t load_fn, void* user_data,
+    iree_hal_shared_library_t** out_library) {
+  IREE_ASSERT_ARGUMENT(load_fn);
+  IREE_ASSERT_ARGUMENT(out_library);
+  *out_library = NULL;
+  if (!key) return load_fn(user_data, out_library);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_shared_library_registry_t* registry =
+      iree_hal_shared_library_registry();
+  iree_slim_mutex_lock(&registry->mutex);
+  iree_hal_shared_library_t* library =
+      iree_hal_shared_library_registry_lookup(registry, key);
+  iree_slim_mutex_unlock(&registry->mutex);
+  if (library) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "shared");
+    *out_library = library;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // Load without holding the lock as this may take a while.
+  iree_hal_shared_library_t* new_library = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, load_fn(user_data, &new_library));
+
+  // Another thread may have registered the same library while we were loading
+  // in which case we use theirs for consistency.
+  iree_slim_mutex_lock(&registry->mutex);
+  library = iree_hal_shared_library_registry_lookup(registry, key);
+  if (!library) {
+    new_library->key = *key;
+    new_library->is_registered = true;
+    new_library->next = registry->head;
+    registry->head = new_library;
+    library = new_library;
+    new_library = NULL;
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+  if (new_library) new_library->destroy(new_library);
+
+  *out_library = library;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_shared_library_release(iree_hal_shared_library_t* library) {
+  if (IREE_UNLIKELY(!library)) return;
+  if (!library->is_registered) {
+    // Unregistered libraries are never shared and need no locking.
+    if (--library->ref_count == 0) library->destroy(library);
+    return;
+  }
+  iree_hal_shared_library_registry_t* registry =
+      iree_hal_shared_library_registry();
+  iree_slim_mutex_lock(&registry->mutex);
+  bool is_last = --library->ref_count == 0;
+  if (is_last) {
+    // Unlink so that no new references can be acquired.
+    iree_hal_shared_library_t** link = &registry->head;
+    while (*link != library) link = &(*link)->next;
+    *link = library->next;
+    library->next = NULL;
+    library->is_registered = false;
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+  if (is_last) library->destroy(library);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_loader_t
+//===----------------------------------------------------------------------===//
+
 void iree_hal_executable_loader_initialize(
     const void* vtable, iree_hal_executable_import_provider_t import_provider,
     iree_hal_executable_loader_t* out_base_loader) {
@@ -66,6 +66,79 @@ iree_status_t iree_hal_executable_import_provider_resolve(
     const iree_hal_executable_import_provider_t import_provider,
     iree_string_view_t symbol_name, void** out_fn_ptr, void** out_fn_context);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_library_t
+//===----------------------------------------------------------------------===//
+
+// Identifies a loaded library in the process-wide shared library registry.
+// Libraries loaded by the same loader implementation with the same flags from
+// identical executable data are interchangeable and may be shared by all
+// executables created from that data, even across loaders, devices, and
+// contexts.
+typedef struct iree_hal_shared_library_key_t {
+  // Unique pointer identifying the loader implementation (such as the address
+  // of a static in the loader) so that loaders never share one another's
+  // libraries.
+  const void* loader_id;
+  // Loader-defined flags that change how the library is loaded.
+  uint32_t flags;
+  // Length and two independently seeded hashes of the executable data.
+  iree_host_size_t data_length;
+  uint64_t data_hashes[2];
+} iree_hal_shared_library_key_t;
+
+typedef struct iree_hal_shared_library_t iree_hal_shared_library_t;
+
+// Base type of a loaded library that may be shared by multiple executables.
+// Loaders embed this at the start of their own library type.
+//
+// Libraries must not be modified after loading as any number of executables
+// (with their own environments) may be using them concurrently.
+struct iree_hal_shared_library_t {
+  // Number of references held by executables. Guarded by the registry lock.
+  iree_host_size_t ref_count;
+  // Next library in the registry list or NULL if not registered.
+  iree_hal_shared_library_t* next;
+  // True if the library is in the registry under |key|.
+  bool is_registered;
+  iree_hal_shared_library_key_t key;
+  // Unloads and frees the library once the last reference is released.
+  void(IREE_API_PTR* destroy)(iree_hal_shared_library_t* library);
+};
+
+// Loads a new library and returns it with a single reference in
+// |out_library|. The library must be initialized with
+// iree_hal_shared_library_initialize.
+typedef iree_status_t(IREE_API_PTR* iree_hal_shared_library_load_fn_t)(
+    void* user_data, iree_hal_shared_library_t** out_library);
+
+// Initializes the base iree_hal_shared_library_t type with a single reference.
+// Called by loaders upon allocating their library.
+void iree_hal_shared_library_initialize(
+    void(IREE_API_PTR* destroy)(iree_hal_shared_library_t* library),
+    iree_hal_shared_library_t* out_library);
+
+// Returns a new reference to the library registered under |key| in
+// |out_library|, loading it with |load_fn| and registering it if there is none.
+// If |key| is NULL the library is loaded and returned without being registered
+// so that it is never shared.
+//
+// Loading happens outside of the registry lock so that unrelated libraries can
+// load concurrently. If multiple threads load the same library at the same
+// time all but the first library registered are discarded.
+//
+// Thread-safe.
+iree_status_t iree_hal_shared_library_acquire(
+    const iree_hal_shared_library_key_t* key,
+    iree_hal_shared_library_load_fn_t load_fn, void* user_data,
+    iree_hal_shared_library_t** out_library);
+
+// Releases a reference to |library| returned by iree_hal_shared_library_acquire
+// and unloads it if it was the last one.
+//
+// Thread-safe.
+void iree_hal_shared_library_release(iree_hal_shared_library_t* library);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_loader_t
 //===----------------------------------------------------------------------===//
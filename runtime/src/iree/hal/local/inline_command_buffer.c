@@ -16,8 +16,10 @@
 #include "iree/base/internal/math.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_channel.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_inline_command_buffer_t
@@ -367,8 +369,16 @@ static iree_status_t iree_hal_inline_command_buffer_collective(
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on CPU");
+  // Collectives block until all ranks participate and are executed inline.
+  const iree_hal_collective_batch_entry_t entry = {
+      .channel = channel,
+      .op = op,
+      .param = param,
+      .send_binding = send_binding,
+      .recv_binding = recv_binding,
+      .element_count = element_count,
+  };
+  return iree_hal_local_channel_execute_batch(1, &entry);
 }
 
 //===----------------------------------------------------------------------===//
@@ -460,6 +470,9 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
         "layouts not provided during executable creation; cannot dispatch");
   }
 
+  // Executables may defer loading until their first dispatch.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(local_executable));
+
   iree_hal_local_pipeline_layout_t* local_layout =
       (iree_hal_local_pipeline_layout_t*)
           local_executable->pipeline_layouts[entry_point];
@@ -588,12 +601,44 @@ static iree_status_t iree_hal_inline_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): decide how to execute the inline command buffer; it is
-  // definitely a deferred command buffer but we don't want to force that
-  // dependency here. We could allow injection of a function to call to execute
-  // command buffers so that the device can decide how it wants to handle them.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+  iree_hal_inline_command_buffer_t* command_buffer =
+      iree_hal_inline_command_buffer_cast(base_command_buffer);
+
+  // Nested command buffers are recorded as deferred command buffers by the
+  // devices that use us (see iree_hal_sync_device_create_command_buffer) and we
+  // replay them into ourselves with their indirect bindings resolved against
+  // the binding table. As we execute inline the commands have completed upon
+  // return.
+  if (!iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "nested command buffers must be created from the same device");
+  }
+
+  // Nested commands set their own descriptor and push constant state and the
+  // parent state must be preserved across them.
+  void* parent_bindings[IREE_ARRAYSIZE(command_buffer->state.full_bindings)];
+  size_t parent_binding_lengths[IREE_ARRAYSIZE(
+      command_buffer->state.full_binding_lengths)];
+  uint32_t parent_push_constants[IREE_ARRAYSIZE(
+      command_buffer->state.push_constants)];
+  memcpy(parent_bindings, command_buffer->state.full_bindings,
+         sizeof(parent_bindings));
+  memcpy(parent_binding_lengths, command_buffer->state.full_binding_lengths,
+         sizeof(parent_binding_lengths));
+  memcpy(parent_push_constants, command_buffer->state.push_constants,
+         sizeof(parent_push_constants));
+
+  iree_status_t status = iree_hal_deferred_command_buffer_apply_inline(
+      base_commands, base_command_buffer, binding_table);
+
+  memcpy(command_buffer->state.full_bindings, parent_bindings,
+         sizeof(parent_bindings));
+  memcpy(command_buffer->state.full_binding_lengths, parent_binding_lengths,
+         sizeof(parent_binding_lengths));
+  memcpy(command_buffer->state.push_constants, parent_push_constants,
+         sizeof(parent_push_constants));
+  return status;
 }
 
 //===----------------------------------------------------------------------===//
@@ -6,16 +6,37 @@
 
 #include "iree/hal/local/loaders/embedded_elf_loader.h"
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/elf/elf_module.h"
+#include "iree/hal/local/elf/fatelf.h"
+#include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 
+//===----------------------------------------------------------------------===//
+// iree_hal_elf_shared_module_t
+//===----------------------------------------------------------------------===//
+
+// Loaded ELF module that may be shared by multiple executables.
+typedef struct iree_hal_elf_shared_module_t {
+  iree_hal_shared_library_t base;
+  iree_allocator_t host_allocator;
+  iree_elf_module_t module;
+} iree_hal_elf_shared_module_t;
+
+// Identifies embedded ELF modules in the shared library registry.
+static const char iree_hal_elf_shared_module_loader_id = 0;
+
 //===----------------------------------------------------------------------===//
 // iree_hal_elf_executable_t
 //===----------------------------------------------------------------------===//
@@ -23,8 +44,8 @@
 typedef struct iree_hal_elf_executable_t {
   iree_hal_local_executable_t base;
 
-  // Loaded ELF module.
-  iree_elf_module_t module;
+  // Loaded ELF module, possibly shared with other executables.
+  iree_hal_elf_shared_module_t* module;
 
   // Name used for the file field in tracy and debuggers.
   iree_string_view_t identifier;
@@ -35,6 +56,23 @@ typedef struct iree_hal_elf_executable_t {
     const iree_hal_executable_library_v0_t* v0;
   } library;
 
+  // Function pointers of each export selected for the host processor.
+  const iree_hal_executable_dispatch_v0_t* export_ptrs;
+
+  // State captured for iree_hal_elf_executable_prepare. The executable data is
+  // only referenced until the executable is prepared and the cache path is
+  // stored inline after the constants.
+  iree_hal_executable_caching_mode_t caching_mode;
+  iree_elf_module_flags_t module_flags;
+  bool share_module;
+  iree_const_byte_span_t executable_data;
+  iree_host_size_t constant_count;
+  iree_hal_executable_import_provider_t import_provider;
+  iree_string_view_t cache_path;
+
+  // Next executable in the loader background warmup queue, if enqueued.
+  struct iree_hal_elf_executable_t* warmup_next;
+
   iree_hal_pipeline_layout_t* layouts[];
 } iree_hal_elf_executable_t;
 
@@ -45,7 +83,7 @@ static iree_status_t iree_hal_elf_executable_query_library(
   // Get the exported symbol used to get the library metadata.
   iree_hal_executable_library_query_fn_t query_fn = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &executable->module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
+      &executable->module->module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
       (void**)&query_fn));
 
   // Query for a compatible version of the library.
@@ -81,6 +119,9 @@ static iree_status_t iree_hal_elf_executable_query_library(
   executable->identifier = iree_make_cstring_view(header->name);
 
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.dispatch_costs =
+      iree_hal_executable_library_export_costs(executable->library.v0);
+  executable->base.export_names = executable->library.v0->exports.names;
 
   return iree_ok_status();
 }
@@ -132,7 +173,228 @@ static iree_status_t iree_hal_elf_executable_resolve_imports(
   return iree_ok_status();
 }
 
+// Loads the module from the cached image at |image_path|, if valid, or from the
+// executable data otherwise. Cache failures are never fatal; at worst the
+// module is loaded as if caching were disabled.
+static iree_status_t iree_hal_elf_executable_load_cached_module(
+    const char* image_path, iree_const_byte_span_t executable_data,
+    iree_elf_module_flags_t module_flags, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
+  FILE* image_file = fopen(image_path, "rb");
+  if (image_file) {
+    iree_status_t status = iree_elf_module_initialize_from_image(
+        executable_data, /*import_table=*/NULL, image_file, host_allocator,
+        out_module);
+    fclose(image_file);
+    if (iree_status_is_ok(status)) return status;
+    // Images that can't be mapped in this process are still valid for others;
+    // anything else is stale or corrupt and gets replaced below.
+    bool replace_image = !iree_status_is_unavailable(status);
+    iree_status_ignore(status);
+    if (!replace_image) {
+      return iree_elf_module_initialize_from_memory_with_flags(
+          executable_data, /*import_table=*/NULL, module_flags, host_allocator,
+          out_module);
+    }
+  }
+
+  // Write the new image under a unique temporary name and rename it into place
+  // once complete so that concurrent processes never see partial images.
+  char temp_path[512];
+  snprintf(temp_path, sizeof(temp_path), "%s.%016" PRIx64 ".tmp", image_path,
+           (uint64_t)iree_time_now() ^ (uint64_t)(uintptr_t)out_module);
+  FILE* temp_file = fopen(temp_path, "wb");
+  if (!temp_file) {
+    return iree_elf_module_initialize_from_memory_with_flags(
+        executable_data, /*import_table=*/NULL, module_flags, host_allocator,
+        out_module);
+  }
+  iree_status_t status = iree_elf_module_initialize_and_write_image(
+      executable_data, /*import_table=*/NULL, module_flags, temp_file,
+      host_allocator, out_module);
+  bool write_ok = fclose(temp_file) == 0 && iree_status_is_ok(status);
+  if (!write_ok || rename(temp_path, image_path) != 0) {
+    remove(temp_path);
+  }
+  if (!iree_status_is_ok(status)) {
+    // Retry without the image to report the load failure, if any, without
+    // caching noise.
+    iree_status_ignore(status);
+    status = iree_elf_module_initialize_from_memory_with_flags(
+        executable_data, /*import_table=*/NULL, module_flags, host_allocator,
+        out_module);
+  }
+  return status;
+}
+
+// Loads the ELF module of the executable, using the persistent cache in
+// |cache_path| if enabled.
+static iree_status_t iree_hal_elf_executable_load_module(
+    iree_string_view_t cache_path,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_const_byte_span_t executable_data,
+    iree_elf_module_flags_t module_flags, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
+  if (iree_string_view_is_empty(cache_path) ||
+      !iree_all_bits_set(
+          caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING) ||
+      !iree_elf_module_images_supported()) {
+    return iree_elf_module_initialize_from_memory_with_flags(
+        executable_data, /*import_table=*/NULL, module_flags, host_allocator,
+        out_module);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Key images by the executable contents and CPU features. The images
+  // themselves verify that they match the contents (guarding against key
+  // collisions) and the host page size and runtime version.
+  uint64_t key = iree_elf_module_image_hash(
+      iree_make_const_byte_span(
+          iree_cpu_data_fields(),
+          IREE_CPU_DATA_FIELD_COUNT * sizeof(iree_cpu_data_fields()[0])),
+      0);
+  key = iree_elf_module_image_hash(executable_data, key);
+  char image_path[512];
+  int image_path_length =
+      snprintf(image_path, sizeof(image_path), "%.*s/%016" PRIx64 ".elfimage",
+               (int)cache_path.size, cache_path.data, key);
+
+  iree_status_t status = iree_ok_status();
+  if (image_path_length <= 0 ||
+      image_path_length + 32 >= (int)sizeof(image_path)) {
+    // Leave room for the temporary file suffix.
+    status = iree_elf_module_initialize_from_memory_with_flags(
+        executable_data, /*import_table=*/NULL, module_flags, host_allocator,
+        out_module);
+  } else {
+    status = iree_hal_elf_executable_load_cached_module(
+        image_path, executable_data, module_flags, host_allocator, out_module);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_elf_shared_module_destroy(
+    iree_hal_shared_library_t* base_library) {
+  iree_hal_elf_shared_module_t* shared_module =
+      (iree_hal_elf_shared_module_t*)base_library;
+  iree_elf_module_deinitialize(&shared_module->module);
+  iree_allocator_free(shared_module->host_allocator, shared_module);
+}
+
+static iree_status_t iree_hal_elf_shared_module_load(
+    void* user_data, iree_hal_shared_library_t** out_library) {
+  iree_hal_elf_executable_t* executable =
+      (iree_hal_elf_executable_t*)user_data;
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  iree_hal_elf_shared_module_t* shared_module = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*shared_module), (void**)&shared_module));
+  iree_hal_shared_library_initialize(iree_hal_elf_shared_module_destroy,
+                                     &shared_module->base);
+  shared_module->host_allocator = host_allocator;
+  iree_status_t status = iree_hal_elf_executable_load_module(
+      executable->cache_path, executable->caching_mode,
+      executable->executable_data, executable->module_flags, host_allocator,
+      &shared_module->module);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, shared_module);
+    return status;
+  }
+  *out_library = &shared_module->base;
+  return iree_ok_status();
+}
+
+// Loads the module of the executable or acquires the identical module already
+// loaded by another executable if sharing is enabled.
+static iree_status_t iree_hal_elf_executable_acquire_module(
+    iree_hal_elf_executable_t* executable) {
+  iree_hal_shared_library_key_t key;
+  if (executable->share_module) {
+    memset(&key, 0, sizeof(key));
+    key.loader_id = &iree_hal_elf_shared_module_loader_id;
+    key.flags = executable->module_flags;
+    key.data_length = executable->executable_data.data_length;
+    key.data_hashes[0] =
+        iree_elf_module_image_hash(executable->executable_data, 0);
+    key.data_hashes[1] = iree_elf_module_image_hash(
+        executable->executable_data, 0x9E3779B97F4A7C15ull);
+  }
+  iree_hal_shared_library_t* library = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_shared_library_acquire(
+      executable->share_module ? &key : NULL, iree_hal_elf_shared_module_load,
+      executable, &library));
+  executable->module = (iree_hal_elf_shared_module_t*)library;
+  return iree_ok_status();
+}
+
+// Loads and links the executable module. Called once by
+// iree_hal_local_executable_prepare either during creation or on first use.
+static iree_status_t iree_hal_elf_executable_prepare(
+    iree_hal_local_executable_t* base_executable) {
+  iree_hal_elf_executable_t* executable =
+      (iree_hal_elf_executable_t*)base_executable;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Attempt to load the ELF module.
+  iree_status_t status = iree_hal_elf_executable_acquire_module(executable);
+  if (iree_status_is_ok(status)) {
+    // Query metadata and get the entry point function pointers.
+    status = iree_hal_elf_executable_query_library(executable);
+  }
+  if (iree_status_is_ok(status)) {
+    // Resolve imports, if any.
+    status = iree_hal_elf_executable_resolve_imports(
+        executable, executable->import_provider);
+  }
+  if (iree_status_is_ok(status)) {
+    // Pick the export variants best suited to the processor, if any.
+    status = iree_hal_executable_library_select_export_ptrs(
+        executable->library.v0, &executable->base.environment,
+        executable->base.host_allocator, &executable->export_ptrs);
+  }
+
+  // TODO(benvanik): move alloc and verification to an executable_library_util.
+  const bool disable_verification =
+      iree_all_bits_set(executable->caching_mode,
+                        IREE_HAL_EXECUTABLE_CACHING_MODE_DISABLE_VERIFICATION);
+  const iree_host_size_t pipeline_layout_count =
+      executable->base.pipeline_layout_count;
+  if (iree_status_is_ok(status) &&
+      (!disable_verification && pipeline_layout_count > 0)) {
+    // NOTE: pipeline layouts are optional but if provided must be consistent.
+    if (executable->library.v0->exports.count != pipeline_layout_count) {
+      status =
+          iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                           "executable provides %u entry points but caller "
+                           "provided %zu; must match",
+                           executable->library.v0->exports.count,
+                           pipeline_layout_count);
+    }
+  }
+  if (iree_status_is_ok(status) && !disable_verification) {
+    // Check to make sure that the constant table has values for all constants.
+    if (executable->library.v0->constants.count !=
+        executable->constant_count) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "executable requires %u constants but caller "
+                                "provided %zu; must match",
+                                executable->library.v0->constants.count,
+                                executable->constant_count);
+    }
+  }
+
+  // The module no longer references the source data once loaded.
+  executable->executable_data = iree_const_byte_span_empty();
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_elf_executable_create(
+    iree_hal_embedded_elf_loader_flags_t flags, iree_string_view_t cache_path,
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
@@ -151,10 +413,12 @@ static iree_status_t iree_hal_elf_executable_create(
   // allocating so that we know the import count. Today since we allocate first
   // we need an additional allocation once we've seen the import table.
   iree_hal_elf_executable_t* executable = NULL;
+  const iree_host_size_t constants_size =
+      executable_params->constant_count * sizeof(*executable_params->constants);
   iree_host_size_t total_size =
       sizeof(*executable) +
       executable_params->pipeline_layout_count * sizeof(*executable->layouts) +
-      executable_params->constant_count * sizeof(*executable_params->constants);
+      constants_size + cache_path.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&executable);
   if (iree_status_is_ok(status)) {
@@ -165,60 +429,45 @@ static iree_status_t iree_hal_elf_executable_create(
         host_allocator, &executable->base);
 
     // Copy executable constants so we own them.
+    uint8_t* trailing_ptr = (uint8_t*)executable + sizeof(*executable) +
+                            executable_params->pipeline_layout_count *
+                                sizeof(*executable->layouts);
     if (executable_params->constant_count > 0) {
-      uint32_t* target_constants =
-          (uint32_t*)((uint8_t*)executable + sizeof(*executable) +
-                      executable_params->pipeline_layout_count *
-                          sizeof(*executable->layouts));
-      memcpy(target_constants, executable_params->constants,
-             executable_params->constant_count *
-                 sizeof(*executable_params->constants));
-      executable->base.environment.constants = target_constants;
+      memcpy(trailing_ptr, executable_params->constants, constants_size);
+      executable->base.environment.constants = (const uint32_t*)trailing_ptr;
     }
-  }
-  if (iree_status_is_ok(status)) {
-    // Attempt to load the ELF module.
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
-  }
-  if (iree_status_is_ok(status)) {
-    // Query metadata and get the entry point function pointers.
-    status = iree_hal_elf_executable_query_library(executable);
-  }
-  if (iree_status_is_ok(status)) {
-    // Resolve imports, if any.
-    status =
-        iree_hal_elf_executable_resolve_imports(executable, import_provider);
-  }
+    trailing_ptr += constants_size;
 
-  // TODO(benvanik): move alloc and verification to an executable_library_util.
-  const bool disable_verification =
-      iree_all_bits_set(executable_params->caching_mode,
-                        IREE_HAL_EXECUTABLE_CACHING_MODE_DISABLE_VERIFICATION);
-  if (iree_status_is_ok(status) &&
-      (!disable_verification && executable_params->pipeline_layout_count > 0)) {
-    // NOTE: pipeline layouts are optional but if provided must be consistent.
-    if (executable->library.v0->exports.count !=
-        executable_params->pipeline_layout_count) {
-      status =
-          iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
-                           "executable provides %u entry points but caller "
-                           "provided %zu; must match",
-                           executable->library.v0->exports.count,
-                           executable_params->pipeline_layout_count);
+    // Capture what's needed to prepare the executable later.
+    executable->caching_mode = executable_params->caching_mode;
+    if (iree_all_bits_set(flags,
+                          IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES)) {
+      executable->module_flags |= IREE_ELF_MODULE_FLAG_LARGE_PAGES;
     }
+    executable->share_module = iree_all_bits_set(
+        flags, IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_SHARE_MODULES);
+    executable->constant_count = executable_params->constant_count;
+    executable->import_provider = import_provider;
+    iree_string_view_append_to_buffer(cache_path, &executable->cache_path,
+                                      (char*)trailing_ptr);
+
+    // If the executable is a FatELF then select the ELF for the most capable
+    // CPU variant now so that module sharing and caching are keyed on it.
+    const iree_hal_processor_v0_t* processor =
+        &executable->base.environment.processor;
+    status = iree_fatelf_select_for_cpu(
+        executable_params->executable_data, IREE_ARRAYSIZE(processor->data),
+        processor->data, &executable->executable_data);
   }
-  if (iree_status_is_ok(status) && !disable_verification) {
-    // Check to make sure that the constant table has values for all constants.
-    if (executable->library.v0->constants.count !=
-        executable_params->constant_count) {
-      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
-                                "executable requires %u constants but caller "
-                                "provided %zu; must match",
-                                executable->library.v0->constants.count,
-                                executable_params->constant_count);
-    }
+
+  // Lazy preparation requires that the executable data outlive the call.
+  const bool lazy_preparation =
+      iree_all_bits_set(flags,
+                        IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LAZY_PREPARATION) &&
+      iree_all_bits_set(executable_params->caching_mode,
+                        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA);
+  if (iree_status_is_ok(status) && !lazy_preparation) {
+    status = iree_hal_local_executable_prepare(&executable->base);
   }
 
   if (iree_status_is_ok(status)) {
@@ -237,7 +486,11 @@ static void iree_hal_elf_executable_destroy(
   iree_allocator_t host_allocator = executable->base.host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_elf_module_deinitialize(&executable->module);
+  iree_hal_executable_library_release_export_ptrs(
+      executable->library.v0, executable->export_ptrs, host_allocator);
+  if (executable->module) {
+    iree_hal_shared_library_release(&executable->module->base);
+  }
 
   if (executable->base.environment.import_funcs != NULL) {
     iree_allocator_free(host_allocator,
@@ -302,7 +555,7 @@ static iree_status_t iree_hal_elf_executable_issue_call(
   }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  int ret = iree_elf_call_i_ppp(library->exports.ptrs[ordinal],
+  int ret = iree_elf_call_i_ppp(executable->export_ptrs[ordinal],
                                 (void*)&base_executable->environment,
                                 (void*)dispatch_state, (void*)workgroup_state);
 
@@ -321,6 +574,7 @@ static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
             {
                 .destroy = iree_hal_elf_executable_destroy,
             },
+        .prepare = iree_hal_elf_executable_prepare,
         .issue_call = iree_hal_elf_executable_issue_call,
 };
 
@@ -331,30 +585,160 @@ static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
 typedef struct iree_hal_embedded_elf_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
+  iree_hal_embedded_elf_loader_flags_t flags;
+  // Persistent cache directory or empty if disabled. Stored inline after the
+  // struct.
+  iree_string_view_t cache_path;
+
+  // Background warmup thread, if enabled, preparing the executables in the
+  // FIFO warmup queue. Each queued executable is retained by the queue.
+  iree_thread_t* warmup_thread;
+  iree_notification_t warmup_notification;
+  // Guards the warmup queue and exit request.
+  iree_slim_mutex_t warmup_mutex;
+  iree_hal_elf_executable_t* warmup_head;
+  iree_hal_elf_executable_t* warmup_tail;
+  bool warmup_exit;
 } iree_hal_embedded_elf_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
     iree_hal_embedded_elf_loader_vtable;
 
+static bool iree_hal_embedded_elf_loader_has_warmup_work(void* arg) {
+  iree_hal_embedded_elf_loader_t* executable_loader =
+      (iree_hal_embedded_elf_loader_t*)arg;
+  iree_slim_mutex_lock(&executable_loader->warmup_mutex);
+  bool has_work =
+      executable_loader->warmup_head || executable_loader->warmup_exit;
+  iree_slim_mutex_unlock(&executable_loader->warmup_mutex);
+  return has_work;
+}
+
+// Pops the next executable in the warmup queue, transferring the reference to
+// the caller. Returns NULL if the queue is empty. Must be called with the
+// warmup_mutex held.
+static iree_hal_elf_executable_t* iree_hal_embedded_elf_loader_pop_warmup(
+    iree_hal_embedded_elf_loader_t* executable_loader) {
+  iree_hal_elf_executable_t* executable = executable_loader->warmup_head;
+  if (executable) {
+    executable_loader->warmup_head = executable->warmup_next;
+    if (!executable_loader->warmup_head) executable_loader->warmup_tail = NULL;
+    executable->warmup_next = NULL;
+  }
+  return executable;
+}
+
+static int iree_hal_embedded_elf_loader_warmup_main(void* arg) {
+  iree_hal_embedded_elf_loader_t* executable_loader =
+      (iree_hal_embedded_elf_loader_t*)arg;
+  for (;;) {
+    iree_notification_await(&executable_loader->warmup_notification,
+                            iree_hal_embedded_elf_loader_has_warmup_work,
+                            executable_loader, iree_infinite_timeout());
+    iree_slim_mutex_lock(&executable_loader->warmup_mutex);
+    iree_hal_elf_executable_t* executable =
+        executable_loader->warmup_exit
+            ? NULL
+            : iree_hal_embedded_elf_loader_pop_warmup(executable_loader);
+    bool exit = executable_loader->warmup_exit;
+    iree_slim_mutex_unlock(&executable_loader->warmup_mutex);
+    if (exit) break;
+    if (!executable) continue;
+
+    // Failures are sticky on the executable and reported by its first
+    // dispatch. Executables already prepared by a dispatch return immediately.
+    iree_status_ignore(iree_hal_local_executable_prepare(&executable->base));
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
+  }
+  return 0;
+}
+
+// Enqueues |executable| for preparation on the warmup thread.
+static void iree_hal_embedded_elf_loader_push_warmup(
+    iree_hal_embedded_elf_loader_t* executable_loader,
+    iree_hal_elf_executable_t* executable) {
+  iree_hal_executable_retain((iree_hal_executable_t*)executable);
+  iree_slim_mutex_lock(&executable_loader->warmup_mutex);
+  if (executable_loader->warmup_tail) {
+    executable_loader->warmup_tail->warmup_next = executable;
+  } else {
+    executable_loader->warmup_head = executable;
+  }
+  executable_loader->warmup_tail = executable;
+  iree_slim_mutex_unlock(&executable_loader->warmup_mutex);
+  iree_notification_post(&executable_loader->warmup_notification,
+                         IREE_ALL_WAITERS);
+}
+
+void iree_hal_embedded_elf_loader_params_initialize(
+    iree_hal_embedded_elf_loader_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->cache_path = iree_string_view_empty();
+}
+
 iree_status_t iree_hal_embedded_elf_loader_create(
     iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_embedded_elf_loader_params_t params;
+  iree_hal_embedded_elf_loader_params_initialize(&params);
+  return iree_hal_embedded_elf_loader_create_with_params(
+      &params, import_provider, host_allocator, out_executable_loader);
+}
+
+iree_status_t iree_hal_embedded_elf_loader_create_with_params(
+    const iree_hal_embedded_elf_loader_params_t* params,
+    iree_hal_executable_import_provider_t import_provider,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(out_executable_loader);
   *out_executable_loader = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_embedded_elf_loader_t* executable_loader = NULL;
-  iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
+  iree_host_size_t total_size =
+      sizeof(*executable_loader) + params->cache_path.size;
+  iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
+                                               (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(&iree_hal_embedded_elf_loader_vtable,
                                           import_provider,
                                           &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
-    *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
+    executable_loader->flags = params->flags;
+    if (iree_all_bits_set(
+            params->flags,
+            IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_BACKGROUND_WARMUP)) {
+      executable_loader->flags |=
+          IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LAZY_PREPARATION;
+    }
+    iree_string_view_append_to_buffer(
+        params->cache_path, &executable_loader->cache_path,
+        (char*)executable_loader + sizeof(*executable_loader));
+    iree_slim_mutex_initialize(&executable_loader->warmup_mutex);
+    iree_notification_initialize(&executable_loader->warmup_notification);
   }
 
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(params->flags,
+                        IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_BACKGROUND_WARMUP)) {
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof(thread_params));
+    thread_params.name = IREE_SV("iree-elf-warmup");
+    thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+    status = iree_thread_create(iree_hal_embedded_elf_loader_warmup_main,
+                                executable_loader, thread_params,
+                                host_allocator,
+                                &executable_loader->warmup_thread);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
+  } else if (executable_loader) {
+    iree_hal_executable_loader_release(
+        (iree_hal_executable_loader_t*)executable_loader);
+  }
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -366,6 +750,26 @@ static void iree_hal_embedded_elf_loader_destroy(
   iree_allocator_t host_allocator = executable_loader->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Stop the warmup thread (joined on release) and drop any executables it
+  // didn't get to; they'll be prepared on first dispatch instead.
+  if (executable_loader->warmup_thread) {
+    iree_slim_mutex_lock(&executable_loader->warmup_mutex);
+    executable_loader->warmup_exit = true;
+    iree_slim_mutex_unlock(&executable_loader->warmup_mutex);
+    iree_notification_post(&executable_loader->warmup_notification,
+                           IREE_ALL_WAITERS);
+    iree_thread_release(executable_loader->warmup_thread);
+  }
+  iree_hal_elf_executable_t* executable = NULL;
+  do {
+    iree_slim_mutex_lock(&executable_loader->warmup_mutex);
+    executable = iree_hal_embedded_elf_loader_pop_warmup(executable_loader);
+    iree_slim_mutex_unlock(&executable_loader->warmup_mutex);
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
+  } while (executable);
+  iree_notification_deinitialize(&executable_loader->warmup_notification);
+  iree_slim_mutex_deinitialize(&executable_loader->warmup_mutex);
+
   iree_allocator_free(host_allocator, executable_loader);
 
   IREE_TRACE_ZONE_END(z0);
@@ -389,9 +793,21 @@ static iree_status_t iree_hal_embedded_elf_loader_try_load(
 
   // Perform the load of the ELF and wrap it in an executable handle.
   iree_status_t status = iree_hal_elf_executable_create(
+      executable_loader->flags, executable_loader->cache_path,
       executable_params, base_executable_loader->import_provider,
       executable_loader->host_allocator, out_executable);
 
+  // Hand lazily prepared executables to the warmup thread, if any.
+  if (iree_status_is_ok(status) && executable_loader->warmup_thread) {
+    iree_hal_elf_executable_t* executable =
+        (iree_hal_elf_executable_t*)*out_executable;
+    if (iree_atomic_load_int32(&executable->base.prepare_state,
+                               iree_memory_order_relaxed) ==
+        IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_PENDING) {
+      iree_hal_embedded_elf_loader_push_warmup(executable_loader, executable);
+    }
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -17,6 +17,68 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Controls how executables are loaded and linked.
+enum iree_hal_embedded_elf_loader_flag_bits_t {
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_NONE = 0u,
+  // Defers loading, relocating, and import resolution of executables until
+  // their first dispatch. Only applies to executables prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA as the data must
+  // remain valid after preparation; others are loaded immediately.
+  //
+  // Errors that would have been reported when preparing the executable
+  // (invalid ELF data, missing imports, mismatched layouts) are instead
+  // reported by the first dispatch. The import provider must remain valid for
+  // the lifetime of the executables.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LAZY_PREPARATION = 1u << 0,
+  // Prepares lazily prepared executables on a low-priority background thread
+  // in the order they were created, so that later first dispatches are less
+  // likely to pay the load cost. Implies LAZY_PREPARATION.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_BACKGROUND_WARMUP = 1u << 1,
+  // Backs executable code and data with large pages where supported (see
+  // IREE_ELF_MODULE_FLAG_LARGE_PAGES). Reduces iTLB misses in executables
+  // with multiple megabytes of code at the cost of aligning each executable
+  // reservation to the large page size.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES = 1u << 2,
+  // Shares loaded modules across all executables created from identical
+  // executable data by any embedded ELF loader in the process with the same
+  // flags (see iree_hal_shared_library_acquire). Loading a program into
+  // several devices (such as one per NUMA node or tenant) then loads and
+  // relocates each executable once and keeps a single copy of its code.
+  //
+  // Shared modules are freed with the host allocator of the executable that
+  // loaded them, which must remain valid until all executables sharing them
+  // have been released.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_SHARE_MODULES = 1u << 3,
+};
+typedef uint32_t iree_hal_embedded_elf_loader_flags_t;
+
+// Parameters for configuring an embedded ELF loader.
+typedef struct iree_hal_embedded_elf_loader_params_t {
+  // Flags controlling executable loading.
+  iree_hal_embedded_elf_loader_flags_t flags;
+
+  // Directory in which loaded executables are persistently cached for reuse by
+  // later processes, or empty to disable caching. Only executables prepared
+  // with IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING are cached
+  // and only on hosts that can map executable files (see
+  // iree_elf_module_images_supported).
+  //
+  // Entries are keyed by the executable contents and host CPU features and
+  // hold the executable relocated for the address it was first loaded at.
+  // Later loads map the entry at that address directly, skipping the copies
+  // and relocation of a normal load, and fall back to a normal load if the
+  // address is in use or the entry fails verification.
+  //
+  // WARNING: entries contain native code that is executed after only checksum
+  // verification. The directory must exist and only be writable by trusted
+  // users.
+  iree_string_view_t cache_path;
+} iree_hal_embedded_elf_loader_params_t;
+
+// Initializes |out_params| to default values.
+void iree_hal_embedded_elf_loader_params_initialize(
+    iree_hal_embedded_elf_loader_params_t* out_params);
+
 // Creates an executable loader that can load minimally-featured ELF dynamic
 // libraries on any platform. This allows us to use a single file format across
 // all operating systems at the cost of some missing debugging/profiling
@@ -26,6 +88,14 @@ iree_status_t iree_hal_embedded_elf_loader_create(
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
+// Creates an embedded ELF loader as with iree_hal_embedded_elf_loader_create
+// configured with |params|. |params| need only remain valid for the call.
+iree_status_t iree_hal_embedded_elf_loader_create_with_params(
+    const iree_hal_embedded_elf_loader_params_t* params,
+    iree_hal_executable_import_provider_t import_provider,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -16,7 +16,54 @@
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
+#include "iree/base/internal/flags.h"
 #include "iree/hal/local/loaders/embedded_elf_loader.h"
+
+IREE_FLAG(
+    string, embedded_elf_cache_path, "",
+    "Directory used to persist relocated embedded ELF executable images\n"
+    "across process launches. Empty disables the cache. The directory must\n"
+    "exist and only be writable by trusted users.");
+IREE_FLAG(
+    bool, embedded_elf_lazy_preparation, false,
+    "Defers loading and linking embedded ELF executables until their first\n"
+    "dispatch.");
+IREE_FLAG(
+    bool, embedded_elf_background_warmup, false,
+    "Prepares lazily loaded embedded ELF executables on a background thread.\n"
+    "Implies --embedded_elf_lazy_preparation.");
+IREE_FLAG(
+    bool, embedded_elf_large_pages, false,
+    "Backs embedded ELF executable code and data with large (huge) pages\n"
+    "where supported to reduce iTLB misses in large executables.");
+IREE_FLAG(
+    bool, embedded_elf_share_modules, false,
+    "Shares loaded embedded ELF executables across all devices in the\n"
+    "process that load identical executables instead of loading a copy for\n"
+    "each device.");
+
+static iree_status_t iree_hal_embedded_elf_loader_create_from_flags(
+    iree_hal_executable_import_provider_t import_provider,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_embedded_elf_loader_params_t params;
+  iree_hal_embedded_elf_loader_params_initialize(&params);
+  params.cache_path = iree_make_cstring_view(FLAG_embedded_elf_cache_path);
+  if (FLAG_embedded_elf_lazy_preparation) {
+    params.flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LAZY_PREPARATION;
+  }
+  if (FLAG_embedded_elf_background_warmup) {
+    params.flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_BACKGROUND_WARMUP;
+  }
+  if (FLAG_embedded_elf_large_pages) {
+    params.flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES;
+  }
+  if (FLAG_embedded_elf_share_modules) {
+    params.flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_SHARE_MODULES;
+  }
+  return iree_hal_embedded_elf_loader_create_with_params(
+      &params, import_provider, host_allocator, out_executable_loader);
+}
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_VMVX_MODULE)
@@ -59,7 +106,7 @@ IREE_API_EXPORT iree_status_t iree_hal_create_all_available_executable_loaders(
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_status_is_ok(status)) {
-    status = iree_hal_embedded_elf_loader_create(
+    status = iree_hal_embedded_elf_loader_create_from_flags(
         import_provider, host_allocator, &loaders[count++]);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
@@ -89,8 +136,8 @@ IREE_API_EXPORT iree_status_t iree_hal_create_executable_loader_by_name(
     iree_hal_executable_loader_t** out_executable_loader) {
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_string_view_starts_with(name, IREE_SV("embedded-elf"))) {
-    return iree_hal_embedded_elf_loader_create(import_provider, host_allocator,
-                                               out_executable_loader);
+    return iree_hal_embedded_elf_loader_create_from_flags(
+        import_provider, host_allocator, out_executable_loader);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
@@ -22,7 +22,8 @@ extern "C" {
 // capacity. Loaders are retained upon return and must be released by the
 // caller.
 //
-// Default options are used to create the loaders. If customization is required
+// Default options are used to create the loaders, except for those exposed as
+// flags (such as --embedded_elf_cache_path). If customization is required
 // then callers should create the loaders themselves.
 //
 // Usage:
@@ -31,6 +31,9 @@ typedef struct iree_hal_static_executable_t {
     const iree_hal_executable_library_v0_t* v0;
   } library;
 
+  // Function pointers of each export selected for the host processor.
+  const iree_hal_executable_dispatch_v0_t* export_ptrs;
+
   iree_hal_pipeline_layout_t* layouts[];
 } iree_hal_static_executable_t;
 
@@ -68,6 +71,9 @@ static iree_status_t iree_hal_static_executable_create(
     executable->library.header = library_header;
     executable->identifier = iree_make_cstring_view((*library_header)->name);
     executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+    executable->base.dispatch_costs =
+        iree_hal_executable_library_export_costs(executable->library.v0);
+    executable->base.export_names = executable->library.v0->exports.names;
 
     // Copy executable constants so we own them.
     if (executable_params->constant_count > 0) {
@@ -90,6 +96,12 @@ static iree_status_t iree_hal_static_executable_create(
                            "directly link against the functions they require");
     }
   }
+  if (iree_status_is_ok(status)) {
+    // Pick the export variants best suited to the processor, if any.
+    status = iree_hal_executable_library_select_export_ptrs(
+        executable->library.v0, &executable->base.environment, host_allocator,
+        &executable->export_ptrs);
+  }
 
   if (iree_status_is_ok(status)) {
     *out_executable = (iree_hal_executable_t*)executable;
@@ -107,6 +119,8 @@ static void iree_hal_static_executable_destroy(
   iree_allocator_t host_allocator = executable->base.host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_executable_library_release_export_ptrs(
+      executable->library.v0, executable->export_ptrs, host_allocator);
   iree_hal_local_executable_deinitialize(
       (iree_hal_local_executable_t*)base_executable);
   iree_allocator_free(host_allocator, executable);
@@ -161,8 +175,8 @@ static iree_status_t iree_hal_static_executable_issue_call(
   }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  int ret = library->exports.ptrs[ordinal](&base_executable->environment,
-                                           dispatch_state, workgroup_state);
+  int ret = executable->export_ptrs[ordinal](&base_executable->environment,
+                                             dispatch_state, workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -13,6 +13,7 @@
 #include "iree/base/internal/dynamic_library.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 
@@ -88,6 +89,9 @@ typedef struct iree_hal_system_executable_t {
     const iree_hal_executable_library_v0_t* v0;
   } library;
 
+  // Function pointers of each export selected for the host processor.
+  const iree_hal_executable_dispatch_v0_t* export_ptrs;
+
   iree_hal_pipeline_layout_t* layouts[];
 } iree_hal_system_executable_t;
 
@@ -201,6 +205,9 @@ static iree_status_t iree_hal_system_executable_query_library(
   executable->identifier = iree_make_cstring_view(header->name);
 
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.dispatch_costs =
+      iree_hal_executable_library_export_costs(executable->library.v0);
+  executable->base.export_names = executable->library.v0->exports.names;
 
   return iree_ok_status();
 }
@@ -312,6 +319,12 @@ static iree_status_t iree_hal_system_executable_create(
     status =
         iree_hal_system_executable_resolve_imports(executable, import_provider);
   }
+  if (iree_status_is_ok(status)) {
+    // Pick the export variants best suited to the processor, if any.
+    status = iree_hal_executable_library_select_export_ptrs(
+        executable->library.v0, &executable->base.environment, host_allocator,
+        &executable->export_ptrs);
+  }
 
   // TODO(benvanik): move alloc and verification to an executable_library_util.
   const bool disable_verification =
@@ -358,6 +371,8 @@ static void iree_hal_system_executable_destroy(
   iree_allocator_t host_allocator = executable->base.host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_executable_library_release_export_ptrs(
+      executable->library.v0, executable->export_ptrs, host_allocator);
   iree_dynamic_library_release(executable->handle);
 
   if (executable->base.environment.import_funcs != NULL) {
@@ -423,8 +438,8 @@ static iree_status_t iree_hal_system_executable_issue_call(
   }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  int ret = library->exports.ptrs[ordinal](&base_executable->environment,
-                                           dispatch_state, workgroup_state);
+  int ret = executable->export_ptrs[ordinal](&base_executable->environment,
+                                             dispatch_state, workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -120,6 +120,20 @@ typedef struct iree_hal_vmvx_worker_state_t {
   // Pointer into the VMVX module state for the worker context.
   // This is used to update module state directly.
   iree_vm_module_state_t* vmvx_module_state;
+
+  // VM stack reused by all calls made by the worker and reset after each.
+  iree_vm_stack_t* stack;
+
+  // Bindings of the most recent dispatch issued by the worker. The workgroups
+  // of a dispatch all reuse the same VM buffers and list instead of rewrapping
+  // the binding memory for every call. Bindings are matched by pointer and
+  // length only and the memory is never accessed outside of a call.
+  iree_host_size_t binding_capacity;
+  iree_host_size_t binding_count;
+  void** binding_ptrs;
+  size_t* binding_lengths;
+  iree_vm_buffer_t* binding_buffers;
+  iree_vm_list_t* binding_list;
 } iree_hal_vmvx_worker_state_t;
 
 static iree_status_t iree_hal_vmvx_worker_state_initialize(
@@ -152,20 +166,129 @@ static iree_status_t iree_hal_vmvx_worker_state_initialize(
         executable_params->constants, host_allocator);
   }
 
+  // Allocate the stack and binding list reused across calls.
+  iree_vm_stack_t* stack = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_allocate(IREE_VM_INVOCATION_FLAG_TRACE_INLINE,
+                                    iree_vm_context_state_resolver(context),
+                                    host_allocator, &stack);
+  }
+  iree_vm_list_t* binding_list = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_vm_type_def_t buffer_type =
+        iree_vm_make_ref_type_def(iree_vm_buffer_type());
+    status = iree_vm_list_create(buffer_type, /*initial_capacity=*/0,
+                                 host_allocator, &binding_list);
+  }
+
   if (iree_status_is_ok(status)) {
     out_state->context = context;
     out_state->vmvx_module_state = vmvx_module_state;
+    out_state->stack = stack;
+    out_state->binding_list = binding_list;
   } else {
+    iree_vm_list_release(binding_list);
+    if (stack) iree_vm_stack_free(stack);
     iree_vm_context_release(context);
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
-static void iree_hal_vmvx_worker_state_deinitialize(
+// Releases the VM buffers wrapping the cached bindings of |state|.
+static void iree_hal_vmvx_worker_state_reset_bindings(
     iree_hal_vmvx_worker_state_t* state) {
+  if (state->binding_list) iree_vm_list_clear(state->binding_list);
+  for (iree_host_size_t i = 0; i < state->binding_count; ++i) {
+    // Aborts if the program retained a binding beyond its call.
+    iree_vm_buffer_deinitialize(&state->binding_buffers[i]);
+  }
+  state->binding_count = 0;
+}
+
+// Updates the cached bindings of |state| to those of |dispatch_state|.
+// No-op if the worker last issued a workgroup with the same bindings.
+static iree_status_t iree_hal_vmvx_worker_state_bind(
+    iree_hal_vmvx_worker_state_t* state,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_allocator_t host_allocator) {
+  const iree_host_size_t binding_count = dispatch_state->binding_count;
+  if (IREE_LIKELY(state->binding_count == binding_count)) {
+    bool matches = true;
+    for (iree_host_size_t i = 0; i < binding_count && matches; ++i) {
+      matches = state->binding_ptrs[i] == dispatch_state->binding_ptrs[i] &&
+                state->binding_lengths[i] == dispatch_state->binding_lengths[i];
+    }
+    if (matches) return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_vmvx_worker_state_reset_bindings(state);
+
+  // Grow the binding tables; they are never shrunk.
+  if (binding_count > state->binding_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(binding_count, state->binding_capacity * 2);
+    iree_host_size_t binding_size = sizeof(*state->binding_ptrs) +
+                                    sizeof(*state->binding_lengths) +
+                                    sizeof(*state->binding_buffers);
+    uint8_t* storage = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(host_allocator, new_capacity * binding_size,
+                                  (void**)&storage));
+    iree_allocator_free(host_allocator, state->binding_buffers);
+    state->binding_capacity = new_capacity;
+    // Buffers first as the storage is freed by that pointer.
+    state->binding_buffers = (iree_vm_buffer_t*)storage;
+    storage += new_capacity * sizeof(*state->binding_buffers);
+    state->binding_ptrs = (void**)storage;
+    storage += new_capacity * sizeof(*state->binding_ptrs);
+    state->binding_lengths = (size_t*)storage;
+  }
+
+  // Map bindings into VMVX buffers.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    iree_vm_buffer_t* binding_buffer = &state->binding_buffers[i];
+    // TODO(benvanik): pipeline layout contains the required access
+    // information. We will likely want to encode a bitmap of mutable bindings
+    // such that we can quickly set the access bit, though.
+    iree_vm_buffer_access_t access =
+        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST;
+    iree_vm_buffer_initialize(
+        access,
+        iree_make_byte_span(dispatch_state->binding_ptrs[i],
+                            dispatch_state->binding_lengths[i]),
+        iree_allocator_null(), binding_buffer);
+    state->binding_ptrs[i] = dispatch_state->binding_ptrs[i];
+    state->binding_lengths[i] = dispatch_state->binding_lengths[i];
+    ++state->binding_count;
+    iree_vm_ref_t ref = {0};
+    status =
+        iree_vm_ref_wrap_assign(binding_buffer, iree_vm_buffer_type(), &ref);
+    if (!iree_status_is_ok(status)) break;
+    status = iree_vm_list_push_ref_retain(state->binding_list, &ref);
+    if (!iree_status_is_ok(status)) break;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_vmvx_worker_state_reset_bindings(state);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_vmvx_worker_state_deinitialize(
+    iree_hal_vmvx_worker_state_t* state, iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(state);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_vmvx_worker_state_reset_bindings(state);
+  iree_allocator_free(host_allocator, state->binding_buffers);
+  iree_vm_list_release(state->binding_list);
+  state->binding_list = NULL;
+  if (state->stack) {
+    iree_vm_stack_free(state->stack);
+    state->stack = NULL;
+  }
   if (state->context) {
     iree_vm_context_release(state->context);
     state->context = NULL;
@@ -342,7 +465,8 @@ static void iree_hal_vmvx_executable_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   for (iree_host_size_t i = 0; i < executable->worker_capacity; ++i) {
-    iree_hal_vmvx_worker_state_deinitialize(&executable->worker_states[i]);
+    iree_hal_vmvx_worker_state_deinitialize(&executable->worker_states[i],
+                                            host_allocator);
   }
   iree_hal_local_executable_deinitialize(
       (iree_hal_local_executable_t*)base_executable);
@@ -381,49 +505,11 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
   iree_vmvx_module_state_update_workgroup_state(worker_state->vmvx_module_state,
                                                 workgroup_state->processor_id);
 
-  // On-stack interface local to this invocation.
-  // Note that we _could_ share this across all invocations in a dispatch, but
-  // it's tricky to find a good place when threading is happening and it's
-  // intentionally fairly cheap to construct by matching the dispatch_state.
-  // The list would only need to be constructed once and we could avoid the
-  // extraneous retain/releases and mappings.
-  iree_vm_type_def_t buffer_type =
-      iree_vm_make_ref_type_def(iree_vm_buffer_type());
-  iree_host_size_t binding_list_size =
-      iree_vm_list_storage_size(&buffer_type, dispatch_state->binding_count);
-  void* binding_list_storage = iree_alloca(binding_list_size);
-  iree_vm_list_t* binding_list = NULL;
-  IREE_RETURN_IF_ERROR(iree_vm_list_initialize(
-      iree_make_byte_span(binding_list_storage, binding_list_size),
-      &buffer_type, dispatch_state->binding_count, &binding_list));
-
-  // Map bindings into on-stack VMVX buffers.
-  iree_status_t status = iree_ok_status();
-  iree_vm_buffer_t* binding_buffers = (iree_vm_buffer_t*)iree_alloca(
-      dispatch_state->binding_count * sizeof(iree_vm_buffer_t));
-  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
-    iree_vm_buffer_t* binding_buffer = &binding_buffers[i];
-    // TODO(benvanik): pipeline layout contains the required access
-    // information. We will likely want to encode a bitmap of mutable bindings
-    // such that we can quickly set the access bit, though.
-    iree_vm_buffer_access_t access =
-        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST;
-    iree_vm_buffer_initialize(
-        access,
-        iree_make_byte_span(dispatch_state->binding_ptrs[i],
-                            dispatch_state->binding_lengths[i]),
-        iree_allocator_null(), binding_buffer);
-    iree_vm_ref_t ref = {0};
-    status =
-        iree_vm_ref_wrap_assign(binding_buffer, iree_vm_buffer_type(), &ref);
-    if (!iree_status_is_ok(status)) break;
-    status = iree_vm_list_push_ref_retain(binding_list, &ref);
-    if (!iree_status_is_ok(status)) break;
-  }
-  if (!iree_status_is_ok(status)) {
-    iree_vm_list_deinitialize(binding_list);
-    return status;
-  }
+  // Reuse the bindings wrapped by the last workgroup issued by this worker;
+  // that is usually one of the same dispatch.
+  IREE_RETURN_IF_ERROR(iree_hal_vmvx_worker_state_bind(
+      worker_state, dispatch_state, executable->base.host_allocator));
+  iree_vm_list_t* binding_list = worker_state->binding_list;
 
   // Acquire workgroup local memory for the dispatch.
   iree_vm_buffer_t local_memory_buffer;
@@ -507,14 +593,8 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
   iree_vm_buffer_retain(&local_memory_buffer);  // for call
   iree_vm_buffer_retain(&constants_buffer);     // for call
 
-  // VM stack stored on native stack. We really do abuse the stack too much
-  // here but it's 8KB and that should be reasonable given that there isn't too
-  // much above us in the stack.
-  // TODO(benvanik): pass in an iree_arena_t that can be used for this.
-  IREE_VM_INLINE_STACK_INITIALIZE(
-      stack, IREE_VM_INVOCATION_FLAG_TRACE_INLINE,
-      iree_vm_context_state_resolver(worker_state->context),
-      executable->base.host_allocator);
+  // The worker stack is empty between calls.
+  iree_vm_stack_t* stack = worker_state->stack;
 
   // Direct call interface.
   // This only works because we know the exact signature and that these will
@@ -524,17 +604,14 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
   call.function = entry_fn;
   call.arguments = iree_make_byte_span(&call_args, sizeof(call_args));
   call.results = iree_make_byte_span(NULL, 0);
-  status = entry_fn.module->begin_call(entry_fn.module->self, stack, call);
+  iree_status_t status =
+      entry_fn.module->begin_call(entry_fn.module->self, stack, call);
 
   // Clean up the stack if needed, such as when the call fails.
-  iree_vm_stack_deinitialize(stack);
+  iree_vm_stack_reset(stack);
 
   iree_vm_buffer_deinitialize(&local_memory_buffer);
   iree_vm_buffer_deinitialize(&constants_buffer);
-  iree_vm_list_deinitialize(binding_list);
-  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
-    iree_vm_buffer_deinitialize(&binding_buffers[i]);
-  }
 
   return status;
 }
@@ -0,0 +1,736 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_channel.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/threading.h"
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_APPLE)
+#define IREE_HAL_LOCAL_CHANNEL_HAVE_SHM 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+
+//===----------------------------------------------------------------------===//
+// Shared memory segment layout
+//===----------------------------------------------------------------------===//
+// The segment starts with a header containing the barrier state followed by
+// one input slot per rank and a single output slot. Each collective is split
+// into chunks that fit in a slot and each chunk is exchanged by writing the
+// local contribution into the rank's own slot, meeting at a barrier, and then
+// reading (or reducing) the slots of the other ranks. A trailing barrier after
+// each chunk ensures no rank overwrites its slot while others are still
+// reading it.
+
+typedef struct iree_hal_local_channel_header_t {
+  // Number of ranks that have arrived at the current barrier generation.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_atomic_int32_t arrival_count;
+  // Incremented by the last rank to arrive at a barrier to release the others.
+  // Kept on its own cache line so that waiters spinning on it are not
+  // disturbed by arrivals.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_atomic_int32_t generation;
+} iree_hal_local_channel_header_t;
+
+#define IREE_HAL_LOCAL_CHANNEL_HEADER_SIZE                   \
+  iree_host_align(sizeof(iree_hal_local_channel_header_t), \
+                  iree_hardware_destructive_interference_size)
+
+typedef struct iree_hal_local_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // This participant's rank in the channel.
+  int32_t rank;
+  // Total number of participants in the channel.
+  int32_t count;
+
+  // Mapped shared memory segment or NULL if the channel has a single
+  // participant.
+  uint8_t* segment;
+  iree_host_size_t segment_size;
+} iree_hal_local_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_local_channel_vtable;
+
+static iree_hal_local_channel_t* iree_hal_local_channel_cast(
+    iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_channel_vtable);
+  return (iree_hal_local_channel_t*)base_value;
+}
+
+static iree_hal_local_channel_header_t* iree_hal_local_channel_header(
+    iree_hal_local_channel_t* channel) {
+  return (iree_hal_local_channel_header_t*)channel->segment;
+}
+
+// Returns the input slot of |rank|.
+static uint8_t* iree_hal_local_channel_slot(iree_hal_local_channel_t* channel,
+                                            int32_t rank) {
+  return channel->segment + IREE_HAL_LOCAL_CHANNEL_HEADER_SIZE +
+         (iree_host_size_t)rank * IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE;
+}
+
+// Returns the output slot shared by all ranks.
+static uint8_t* iree_hal_local_channel_output_slot(
+    iree_hal_local_channel_t* channel) {
+  return iree_hal_local_channel_slot(channel, channel->count);
+}
+
+// Blocks until all ranks have arrived at the barrier.
+// Memory written by any rank prior to the barrier is visible to all ranks
+// after it.
+static void iree_hal_local_channel_barrier(iree_hal_local_channel_t* channel) {
+  iree_hal_local_channel_header_t* header =
+      iree_hal_local_channel_header(channel);
+  // The generation cannot advance until this rank arrives so it must be read
+  // before arriving.
+  const int32_t generation =
+      iree_atomic_load_int32(&header->generation, iree_memory_order_acquire);
+  if (iree_atomic_fetch_add_int32(&header->arrival_count, 1,
+                                  iree_memory_order_acq_rel) +
+          1 ==
+      channel->count) {
+    // Last to arrive: reset for the next barrier and release the others. No
+    // rank can arrive again until the generation changes.
+    iree_atomic_store_int32(&header->arrival_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int32(&header->generation, 1,
+                                iree_memory_order_release);
+    return;
+  }
+  while (iree_atomic_load_int32(&header->generation,
+                                iree_memory_order_acquire) == generation) {
+    iree_thread_yield();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_t
+//===----------------------------------------------------------------------===//
+
+// FNV-1a over the channel ID and group used to derive the segment name.
+static uint64_t iree_hal_local_channel_hash(uint64_t hash,
+                                            iree_const_byte_span_t data) {
+  for (iree_host_size_t i = 0; i < data.data_length; ++i) {
+    hash ^= data.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+#if defined(IREE_HAL_LOCAL_CHANNEL_HAVE_SHM)
+
+static iree_status_t iree_hal_local_channel_map_segment(
+    iree_hal_local_channel_t* channel, iree_hal_channel_params_t params) {
+  uint64_t hash = iree_hal_local_channel_hash(0xCBF29CE484222325ull, params.id);
+  hash = iree_hal_local_channel_hash(
+      hash, iree_make_const_byte_span(params.group.data, params.group.size));
+  char name[32];
+  snprintf(name, sizeof(name), "/iree-%016" PRIx64, hash);
+
+  channel->segment_size =
+      IREE_HAL_LOCAL_CHANNEL_HEADER_SIZE +
+      ((iree_host_size_t)channel->count + 1) * IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE;
+
+  // All ranks race to create the segment; whoever gets there first creates it
+  // zero-filled and the others open the existing one. Resizing to the same
+  // size is idempotent.
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open shared memory segment %s", name);
+  }
+  if (ftruncate(fd, (off_t)channel->segment_size) == -1) {
+    const int error = errno;
+    close(fd);
+    return iree_make_status(
+        iree_status_code_from_errno(error),
+        "failed to size shared memory segment %s to %" PRIhsz " bytes", name,
+        channel->segment_size);
+  }
+  void* segment = mmap(NULL, channel->segment_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (segment == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "failed to map shared memory segment %s", name);
+  }
+  channel->segment = (uint8_t*)segment;
+
+  // Wait for all ranks to attach before removing the name so that later
+  // channels with the same ID get a fresh segment.
+  iree_hal_local_channel_barrier(channel);
+  if (channel->rank == 0) shm_unlink(name);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_channel_unmap_segment(
+    iree_hal_local_channel_t* channel) {
+  if (channel->segment) munmap(channel->segment, channel->segment_size);
+  channel->segment = NULL;
+}
+
+#else
+
+static iree_status_t iree_hal_local_channel_map_segment(
+    iree_hal_local_channel_t* channel, iree_hal_channel_params_t params) {
+  return iree_make_status(
+      IREE_STATUS_UNIMPLEMENTED,
+      "multi-participant CPU collective channels require POSIX shared memory");
+}
+
+static void iree_hal_local_channel_unmap_segment(
+    iree_hal_local_channel_t* channel) {}
+
+#endif  // IREE_HAL_LOCAL_CHANNEL_HAVE_SHM
+
+iree_status_t iree_hal_local_channel_create(iree_hal_channel_params_t params,
+                                            iree_allocator_t host_allocator,
+                                            iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+
+  int32_t rank = params.rank;
+  int32_t count = params.count;
+  if (rank == IREE_HAL_CHANNEL_RANK_DEFAULT &&
+      count == IREE_HAL_CHANNEL_COUNT_DEFAULT) {
+    rank = 0;
+    count = 1;
+  } else if (rank == IREE_HAL_CHANNEL_RANK_DEFAULT ||
+             count == IREE_HAL_CHANNEL_COUNT_DEFAULT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "CPU collective channels require both an explicit "
+                            "rank and count or neither");
+  }
+  if (count < 1 || rank < 0 || rank >= count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "rank %d out of range of channel count %d", rank,
+                            count);
+  }
+  if (count > 1 && iree_const_byte_span_is_empty(params.id)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "multi-participant CPU collective channels require an ID shared by "
+        "all ranks");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, rank);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, count);
+
+  iree_hal_local_channel_t* channel = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel),
+                                (void**)&channel));
+  iree_hal_resource_initialize(&iree_hal_local_channel_vtable,
+                               &channel->resource);
+  channel->host_allocator = host_allocator;
+  channel->rank = rank;
+  channel->count = count;
+  channel->segment = NULL;
+  channel->segment_size = 0;
+
+  iree_status_t status = iree_ok_status();
+  if (count > 1) {
+    status = iree_hal_local_channel_map_segment(channel, params);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_channel = (iree_hal_channel_t*)channel;
+  } else {
+    iree_hal_channel_release((iree_hal_channel_t*)channel);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_local_channel_destroy(iree_hal_channel_t* base_channel) {
+  iree_hal_local_channel_t* channel = iree_hal_local_channel_cast(base_channel);
+  iree_allocator_t host_allocator = channel->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_local_channel_unmap_segment(channel);
+  iree_allocator_free(host_allocator, channel);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_local_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_local_channel_vtable);
+}
+
+static void iree_hal_local_channel_query_rank_and_count(
+    const iree_hal_channel_t* base_channel, int32_t* out_rank,
+    int32_t* out_count) {
+  iree_hal_local_channel_t* channel =
+      iree_hal_local_channel_cast((iree_hal_channel_t*)base_channel);
+  *out_rank = channel->rank;
+  *out_count = channel->count;
+}
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+
+// Returns the size in bytes of |element_type| or 0 if it is not supported.
+static iree_host_size_t iree_hal_local_channel_element_size(
+    iree_hal_collective_element_type_t element_type) {
+  switch (element_type) {
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8:
+      return 1;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16:
+      return 2;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32:
+      return 4;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_64:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_64:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static inline float iree_hal_local_channel_bf16_to_f32(uint16_t value) {
+  const uint32_t bits = (uint32_t)value << 16;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static inline uint16_t iree_hal_local_channel_f32_to_bf16(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+    return (uint16_t)((bits >> 16) | 0x0040u);  // quiet NaN
+  }
+  // Round to nearest even.
+  bits += 0x7FFFu + ((bits >> 16) & 1u);
+  return (uint16_t)(bits >> 16);
+}
+
+#define IREE_HAL_LOCAL_CHANNEL_IDENTITY(value) (value)
+#define IREE_HAL_LOCAL_CHANNEL_OP_SUM(lhs, rhs) ((lhs) + (rhs))
+#define IREE_HAL_LOCAL_CHANNEL_OP_PRODUCT(lhs, rhs) ((lhs) * (rhs))
+#define IREE_HAL_LOCAL_CHANNEL_OP_MINIMUM(lhs, rhs) iree_min(lhs, rhs)
+#define IREE_HAL_LOCAL_CHANNEL_OP_MAXIMUM(lhs, rhs) iree_max(lhs, rhs)
+#define IREE_HAL_LOCAL_CHANNEL_FINAL_NONE(acc, acc_t, count) (acc)
+#define IREE_HAL_LOCAL_CHANNEL_FINAL_AVERAGE(acc, acc_t, count) \
+  ((acc) / (acc_t)(count))
+
+// dst[i] = OP(src[0 * src_stride + i], ..., src[(count - 1) * src_stride + i])
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, acc_t, LOAD, STORE, OP, FINAL) \
+  for (iree_host_size_t i = 0; i < element_count; ++i) {                     \
+    acc_t acc = LOAD(((const T*)src)[i]);                                    \
+    for (int32_t r = 1; r < count; ++r) {                                    \
+      acc = OP(acc, LOAD(((const T*)(src + r * src_stride))[i]));            \
+    }                                                                        \
+    ((T*)dst)[i] = STORE(FINAL(acc, acc_t, count));                          \
+  }
+
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(name, T, acc_t, LOAD, STORE)      \
+  static void iree_hal_local_channel_reduce_##name(                          \
+      iree_hal_collective_reduction_t reduction, int32_t count,              \
+      const uint8_t* src, iree_host_size_t src_stride, uint8_t* dst,         \
+      iree_host_size_t element_count) {                                      \
+    switch (reduction) {                                                     \
+      case IREE_HAL_COLLECTIVE_REDUCTION_SUM:                                \
+        IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, acc_t, LOAD, STORE,            \
+                                           IREE_HAL_LOCAL_CHANNEL_OP_SUM,    \
+                                           IREE_HAL_LOCAL_CHANNEL_FINAL_NONE) \
+        break;                                                               \
+      case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:                            \
+        IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(                                  \
+            T, acc_t, LOAD, STORE, IREE_HAL_LOCAL_CHANNEL_OP_PRODUCT,        \
+            IREE_HAL_LOCAL_CHANNEL_FINAL_NONE)                               \
+        break;                                                               \
+      case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:                            \
+        IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(                                  \
+            T, acc_t, LOAD, STORE, IREE_HAL_LOCAL_CHANNEL_OP_MINIMUM,        \
+            IREE_HAL_LOCAL_CHANNEL_FINAL_NONE)                               \
+        break;                                                               \
+      case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:                            \
+        IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(                                  \
+            T, acc_t, LOAD, STORE, IREE_HAL_LOCAL_CHANNEL_OP_MAXIMUM,        \
+            IREE_HAL_LOCAL_CHANNEL_FINAL_NONE)                               \
+        break;                                                               \
+      case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:                            \
+        IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(                                  \
+            T, acc_t, LOAD, STORE, IREE_HAL_LOCAL_CHANNEL_OP_SUM,            \
+            IREE_HAL_LOCAL_CHANNEL_FINAL_AVERAGE)                            \
+        break;                                                               \
+    }                                                                        \
+  }
+
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(i8, int8_t, int8_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(u8, uint8_t, uint8_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(i16, int16_t, int16_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(u16, uint16_t, uint16_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(i32, int32_t, int32_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(u32, uint32_t, uint32_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(i64, int64_t, int64_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(u64, uint64_t, uint64_t,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(f16, uint16_t, float, iree_math_f16_to_f32,
+                                   iree_math_f32_to_f16);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(f32, float, float,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(f64, double, double,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                   IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+IREE_HAL_LOCAL_CHANNEL_REDUCE_TYPE(bf16, uint16_t, float,
+                                   iree_hal_local_channel_bf16_to_f32,
+                                   iree_hal_local_channel_f32_to_bf16);
+
+// Reduces |count| arrays of |element_count| elements spaced |src_stride| bytes
+// apart starting at |src| into |dst|.
+static void iree_hal_local_channel_reduce(iree_hal_collective_op_t op,
+                                          int32_t count, const uint8_t* src,
+                                          iree_host_size_t src_stride,
+                                          uint8_t* dst,
+                                          iree_host_size_t element_count) {
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(type, name)                    \
+  case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_##type:                           \
+    iree_hal_local_channel_reduce_##name(op.reduction, count, src,        \
+                                         src_stride, dst, element_count); \
+    break;
+  switch (op.element_type) {
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(SINT_8, i8)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(UINT_8, u8)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(SINT_16, i16)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(UINT_16, u16)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(SINT_32, i32)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(UINT_32, u32)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(SINT_64, i64)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(UINT_64, u64)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(FLOAT_16, f16)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(FLOAT_32, f32)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(FLOAT_64, f64)
+    IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE(BFLOAT_16, bf16)
+    default:
+      break;
+  }
+#undef IREE_HAL_LOCAL_CHANNEL_REDUCE_CASE
+}
+
+//===----------------------------------------------------------------------===//
+// Collectives
+//===----------------------------------------------------------------------===//
+
+static void iree_hal_local_channel_all_gather(
+    iree_hal_local_channel_t* channel, iree_host_size_t element_size,
+    const uint8_t* send_ptr, uint8_t* recv_ptr,
+    iree_host_size_t element_count) {
+  const iree_host_size_t total_length = element_count * element_size;
+  uint8_t* slot = iree_hal_local_channel_slot(channel, channel->rank);
+  for (iree_host_size_t offset = 0; offset < total_length;
+       offset += IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE) {
+    const iree_host_size_t length =
+        iree_min(total_length - offset, IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE);
+    memcpy(slot, send_ptr + offset, length);
+    iree_hal_local_channel_barrier(channel);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(recv_ptr + r * total_length + offset,
+             iree_hal_local_channel_slot(channel, r), length);
+    }
+    iree_hal_local_channel_barrier(channel);
+  }
+}
+
+// Each rank reduces its 1/count share of every chunk into the output slot so
+// that the reduction work is split evenly across ranks.
+static void iree_hal_local_channel_all_reduce(
+    iree_hal_local_channel_t* channel, iree_hal_collective_op_t op,
+    iree_host_size_t element_size, const uint8_t* send_ptr, uint8_t* recv_ptr,
+    iree_host_size_t element_count) {
+  const iree_host_size_t chunk_capacity =
+      IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE / element_size;
+  uint8_t* slot = iree_hal_local_channel_slot(channel, channel->rank);
+  uint8_t* output_slot = iree_hal_local_channel_output_slot(channel);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += chunk_capacity) {
+    const iree_host_size_t chunk_count =
+        iree_min(element_count - base, chunk_capacity);
+    memcpy(slot, send_ptr + base * element_size, chunk_count * element_size);
+    iree_hal_local_channel_barrier(channel);
+    const iree_host_size_t begin = chunk_count * channel->rank / channel->count;
+    const iree_host_size_t end =
+        chunk_count * (channel->rank + 1) / channel->count;
+    if (end > begin) {
+      iree_hal_local_channel_reduce(
+          op, channel->count,
+          iree_hal_local_channel_slot(channel, 0) + begin * element_size,
+          IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE, output_slot + begin * element_size,
+          end - begin);
+    }
+    iree_hal_local_channel_barrier(channel);
+    memcpy(recv_ptr + base * element_size, output_slot,
+           chunk_count * element_size);
+    iree_hal_local_channel_barrier(channel);
+  }
+}
+
+static void iree_hal_local_channel_broadcast(
+    iree_hal_local_channel_t* channel, int32_t root, const uint8_t* send_ptr,
+    uint8_t* recv_ptr, iree_host_size_t total_length) {
+  uint8_t* slot = iree_hal_local_channel_slot(channel, 0);
+  for (iree_host_size_t offset = 0; offset < total_length;
+       offset += IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE) {
+    const iree_host_size_t length =
+        iree_min(total_length - offset, IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE);
+    if (channel->rank == root) memcpy(slot, send_ptr + offset, length);
+    iree_hal_local_channel_barrier(channel);
+    if (channel->rank != root) memcpy(recv_ptr + offset, slot, length);
+    iree_hal_local_channel_barrier(channel);
+  }
+}
+
+static void iree_hal_local_channel_reduce_to_root(
+    iree_hal_local_channel_t* channel, iree_hal_collective_op_t op,
+    int32_t root, iree_host_size_t element_size, const uint8_t* send_ptr,
+    uint8_t* recv_ptr, iree_host_size_t element_count) {
+  const iree_host_size_t chunk_capacity =
+      IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE / element_size;
+  uint8_t* slot = iree_hal_local_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += chunk_capacity) {
+    const iree_host_size_t chunk_count =
+        iree_min(element_count - base, chunk_capacity);
+    memcpy(slot, send_ptr + base * element_size, chunk_count * element_size);
+    iree_hal_local_channel_barrier(channel);
+    if (channel->rank == root) {
+      iree_hal_local_channel_reduce(
+          op, channel->count, iree_hal_local_channel_slot(channel, 0),
+          IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE, recv_ptr + base * element_size,
+          chunk_count);
+    }
+    iree_hal_local_channel_barrier(channel);
+  }
+}
+
+// Each slot holds |count| blocks of up to a slot's share of elements, one per
+// target rank, and each rank reduces its own block across all slots.
+static void iree_hal_local_channel_reduce_scatter(
+    iree_hal_local_channel_t* channel, iree_hal_collective_op_t op,
+    iree_host_size_t element_size, const uint8_t* send_ptr, uint8_t* recv_ptr,
+    iree_host_size_t element_count) {
+  const iree_host_size_t chunk_capacity =
+      IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE / element_size / channel->count;
+  uint8_t* slot = iree_hal_local_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += chunk_capacity) {
+    const iree_host_size_t chunk_count =
+        iree_min(element_count - base, chunk_capacity);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(slot + r * chunk_count * element_size,
+             send_ptr + (r * element_count + base) * element_size,
+             chunk_count * element_size);
+    }
+    iree_hal_local_channel_barrier(channel);
+    iree_hal_local_channel_reduce(
+        op, channel->count,
+        iree_hal_local_channel_slot(channel, 0) +
+            channel->rank * chunk_count * element_size,
+        IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE, recv_ptr + base * element_size,
+        chunk_count);
+    iree_hal_local_channel_barrier(channel);
+  }
+}
+
+// Performs |op| when the channel has a single participant and collectives
+// degenerate into copies (or nothing at all when in-place).
+static iree_status_t iree_hal_local_channel_execute_single(
+    iree_hal_collective_op_t op, const void* send_ptr, void* recv_ptr,
+    iree_host_size_t total_length) {
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      if (send_ptr != recv_ptr) memmove(recv_ptr, send_ptr, total_length);
+      return iree_ok_status();
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+      // The only rank is the source and its recv_binding is unused.
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported collective operation");
+  }
+}
+
+iree_status_t iree_hal_local_channel_execute(iree_hal_channel_t* base_channel,
+                                             iree_hal_collective_op_t op,
+                                             uint32_t param,
+                                             const void* send_ptr,
+                                             void* recv_ptr,
+                                             iree_device_size_t element_count) {
+  iree_hal_local_channel_t* channel = iree_hal_local_channel_cast(base_channel);
+
+  const iree_host_size_t element_size =
+      iree_hal_local_channel_element_size(op.element_type);
+  if (IREE_UNLIKELY(element_size == 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported collective element type %u",
+                            op.element_type);
+  }
+  const bool is_reduction = op.kind == IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE ||
+                            op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE ||
+                            op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER;
+  if (is_reduction &&
+      (op.reduction == IREE_HAL_COLLECTIVE_REDUCTION_NONE ||
+       op.reduction > IREE_HAL_COLLECTIVE_REDUCTION_MAX_VALUE)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported collective reduction %u",
+                            op.reduction);
+  }
+  const bool has_root = op.kind == IREE_HAL_COLLECTIVE_KIND_BROADCAST ||
+                        op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE;
+  if (has_root && param >= (uint32_t)channel->count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "root rank %u out of range of channel count %d",
+                            param, channel->count);
+  }
+  if (IREE_UNLIKELY(op.kind == IREE_HAL_COLLECTIVE_KIND_SEND ||
+                    op.kind == IREE_HAL_COLLECTIVE_KIND_RECV)) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "point-to-point send/recv not implemented on CPU collective channels");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, op.kind);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, element_count);
+
+  iree_status_t status = iree_ok_status();
+  const iree_host_size_t count = (iree_host_size_t)element_count;
+  if (channel->count == 1) {
+    status = iree_hal_local_channel_execute_single(op, send_ptr, recv_ptr,
+                                                   count * element_size);
+  } else {
+    switch (op.kind) {
+      case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+        iree_hal_local_channel_all_gather(channel, element_size, send_ptr,
+                                          recv_ptr, count);
+        break;
+      case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+        iree_hal_local_channel_all_reduce(channel, op, element_size, send_ptr,
+                                          recv_ptr, count);
+        break;
+      case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+        iree_hal_local_channel_broadcast(channel, (int32_t)param, send_ptr,
+                                         recv_ptr, count * element_size);
+        break;
+      case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+        iree_hal_local_channel_reduce_to_root(channel, op, (int32_t)param,
+                                              element_size, send_ptr, recv_ptr,
+                                              count);
+        break;
+      case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+        iree_hal_local_channel_reduce_scatter(channel, op, element_size,
+                                              send_ptr, recv_ptr, count);
+        break;
+      default:
+        status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                  "unsupported collective operation %u",
+                                  op.kind);
+        break;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_local_channel_map_binding(
+    iree_hal_buffer_binding_t binding, iree_hal_buffer_mapping_t* out_mapping) {
+  memset(out_mapping, 0, sizeof(*out_mapping));
+  if (!binding.buffer) return iree_ok_status();
+  return iree_hal_buffer_map_range(binding.buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+                                   IREE_HAL_MEMORY_ACCESS_ANY, binding.offset,
+                                   binding.length, out_mapping);
+}
+
+iree_status_t iree_hal_local_channel_execute_batch(
+    iree_host_size_t entry_count,
+    const iree_hal_collective_batch_entry_t* entries) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, entry_count);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < entry_count && iree_status_is_ok(status);
+       ++i) {
+    const iree_hal_collective_batch_entry_t* entry = &entries[i];
+    if (!iree_hal_local_channel_isa(entry->channel)) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "CPU collectives require channels created by "
+                                "a local device");
+      break;
+    }
+    iree_hal_buffer_mapping_t send_mapping;
+    iree_hal_buffer_mapping_t recv_mapping;
+    status = iree_hal_local_channel_map_binding(entry->send_binding,
+                                                &send_mapping);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_local_channel_map_binding(entry->recv_binding,
+                                                  &recv_mapping);
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_local_channel_execute(
+            entry->channel, entry->op, entry->param,
+            send_mapping.contents.data, recv_mapping.contents.data,
+            entry->element_count);
+        if (recv_mapping.buffer) {
+          status = iree_status_join(
+              status, iree_hal_buffer_unmap_range(&recv_mapping));
+        }
+      }
+      if (send_mapping.buffer) {
+        status = iree_status_join(status,
+                                  iree_hal_buffer_unmap_range(&send_mapping));
+      }
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_local_channel_vtable = {
+    .destroy = iree_hal_local_channel_destroy,
+    .query_rank_and_count = iree_hal_local_channel_query_rank_and_count,
+};
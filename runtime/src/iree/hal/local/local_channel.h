@@ -0,0 +1,68 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LOCAL_CHANNEL_H_
+#define IREE_HAL_LOCAL_LOCAL_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/collective_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Size in bytes of the shared memory slot each rank exchanges data through.
+// Collectives larger than a slot are processed in slot-sized chunks. Must be a
+// multiple of the largest collective element type.
+#if !defined(IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE)
+#define IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE (256 * 1024)
+#endif  // !IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE
+
+// Creates a CPU collective channel for the rank and count in |params|.
+//
+// Channels with more than one participant rendezvous through a POSIX shared
+// memory segment named after |params|.id and |params|.group and may be used
+// across processes on the same host (or across threads within a process).
+// All participants must use the same ID and group and creation blocks until
+// all |params|.count ranks have created their channel. IDs must be unique per
+// channel instance, such as a random value generated by one rank and shared
+// with the others, as segments left behind by crashed processes are reused.
+//
+// If both the rank and count are IREE_HAL_*_DEFAULT the channel has a single
+// participant and collectives are local copies.
+//
+// Collectives execute synchronously on the calling thread, which blocks until
+// all ranks have participated. All ranks must issue the same collectives in
+// the same order. Point-to-point send/recv is not supported.
+iree_status_t iree_hal_local_channel_create(iree_hal_channel_params_t params,
+                                            iree_allocator_t host_allocator,
+                                            iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| is a local channel.
+bool iree_hal_local_channel_isa(iree_hal_channel_t* channel);
+
+// Performs the collective |op| with host pointers. |send_ptr| and |recv_ptr|
+// may be NULL when unused by the operation as defined by
+// iree_hal_collective_kind_t.
+iree_status_t iree_hal_local_channel_execute(iree_hal_channel_t* channel,
+                                             iree_hal_collective_op_t op,
+                                             uint32_t param,
+                                             const void* send_ptr,
+                                             void* recv_ptr,
+                                             iree_device_size_t element_count);
+
+// Maps the bindings of each of the |entry_count| |entries| and performs their
+// collectives in order using iree_hal_local_channel_execute.
+iree_status_t iree_hal_local_channel_execute_batch(
+    iree_host_size_t entry_count,
+    const iree_hal_collective_batch_entry_t* entries);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LOCAL_CHANNEL_H_
@@ -0,0 +1,243 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_channel.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_APPLE)
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+
+namespace {
+
+static iree_hal_collective_op_t MakeOp(
+    iree_hal_collective_kind_t kind,
+    iree_hal_collective_element_type_t element_type,
+    iree_hal_collective_reduction_t reduction =
+        IREE_HAL_COLLECTIVE_REDUCTION_NONE) {
+  iree_hal_collective_op_t op;
+  op.packed = 0;
+  op.kind = kind;
+  op.reduction = reduction;
+  op.element_type = element_type;
+  return op;
+}
+
+// Runs |fn| on |count| threads each with their own channel rank.
+// Threads stand in for processes as the channel does not distinguish them.
+static void RunRanks(const char* name, int32_t count,
+                     std::function<void(iree_hal_channel_t*, int32_t)> fn) {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_APPLE)
+  // Unique per test process so that concurrent test runs don't collide.
+  const std::string id = std::string(name) + "-" + std::to_string(getpid());
+#else
+  const std::string id = name;
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+  std::vector<std::thread> threads;
+  for (int32_t rank = 0; rank < count; ++rank) {
+    threads.emplace_back([&, rank]() {
+      iree_hal_channel_params_t params = {};
+      params.id = iree_make_const_byte_span(id.data(), id.size());
+      params.group = iree_make_cstring_view("test");
+      params.rank = rank;
+      params.count = count;
+      iree_hal_channel_t* channel = NULL;
+      IREE_ASSERT_OK(iree_hal_local_channel_create(
+          params, iree_allocator_system(), &channel));
+      fn(channel, rank);
+      iree_hal_channel_release(channel);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+TEST(LocalChannelTest, SingleParticipant) {
+  iree_hal_channel_params_t params = {};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_local_channel_create(params, iree_allocator_system(), &channel));
+  EXPECT_TRUE(iree_hal_local_channel_isa(channel));
+  int32_t rank = -1, count = -1;
+  iree_hal_channel_query_rank_and_count(channel, &rank, &count);
+  EXPECT_EQ(0, rank);
+  EXPECT_EQ(1, count);
+
+  std::vector<float> send = {1.0f, 2.0f, 3.0f};
+  std::vector<float> recv(send.size(), 0.0f);
+  IREE_ASSERT_OK(iree_hal_local_channel_execute(
+      channel,
+      MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+             IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32,
+             IREE_HAL_COLLECTIVE_REDUCTION_SUM),
+      /*param=*/0, send.data(), recv.data(), send.size()));
+  EXPECT_EQ(send, recv);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNIMPLEMENTED,
+      iree_hal_local_channel_execute(
+          channel,
+          MakeOp(IREE_HAL_COLLECTIVE_KIND_SEND,
+                 IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32),
+          /*param=*/0, send.data(), NULL, send.size()));
+  iree_hal_channel_release(channel);
+}
+
+TEST(LocalChannelTest, InvalidParams) {
+  iree_hal_channel_params_t params = {};
+  params.rank = 0;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = NULL;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_hal_local_channel_create(params, iree_allocator_system(), &channel));
+
+  // Multiple participants require an ID to rendezvous with.
+  params.count = 2;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_hal_local_channel_create(params, iree_allocator_system(), &channel));
+}
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_APPLE)
+
+// Larger than a slot so that the collective is processed in chunks.
+static constexpr iree_host_size_t kLargeCount =
+    IREE_HAL_LOCAL_CHANNEL_SLOT_SIZE / sizeof(int32_t) * 2 + 123;
+
+TEST(LocalChannelTest, AllReduceSumI32) {
+  static constexpr int32_t kCount = 3;
+  RunRanks("AllReduceSumI32", kCount,
+           [](iree_hal_channel_t* channel, int32_t rank) {
+             std::vector<int32_t> send(kLargeCount);
+             for (size_t i = 0; i < send.size(); ++i) {
+               send[i] = (int32_t)i + rank;
+             }
+             std::vector<int32_t> recv(kLargeCount, -1);
+             IREE_ASSERT_OK(iree_hal_local_channel_execute(
+                 channel,
+                 MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+                        IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32,
+                        IREE_HAL_COLLECTIVE_REDUCTION_SUM),
+                 /*param=*/0, send.data(), recv.data(), send.size()));
+             for (size_t i = 0; i < recv.size(); ++i) {
+               ASSERT_EQ((int32_t)i * kCount + 0 + 1 + 2, recv[i]);
+             }
+           });
+}
+
+TEST(LocalChannelTest, AllReduceInPlaceMaxF32) {
+  static constexpr int32_t kCount = 4;
+  RunRanks("AllReduceInPlaceMaxF32", kCount,
+           [](iree_hal_channel_t* channel, int32_t rank) {
+             std::vector<float> data = {(float)rank, -(float)rank, 0.5f};
+             IREE_ASSERT_OK(iree_hal_local_channel_execute(
+                 channel,
+                 MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+                        IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32,
+                        IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM),
+                 /*param=*/0, data.data(), data.data(), data.size()));
+             EXPECT_EQ(std::vector<float>({3.0f, 0.0f, 0.5f}), data);
+           });
+}
+
+TEST(LocalChannelTest, AllGather) {
+  static constexpr int32_t kCount = 3;
+  RunRanks("AllGather", kCount, [](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<int32_t> send(kLargeCount, rank);
+    std::vector<int32_t> recv(kLargeCount * kCount, -1);
+    IREE_ASSERT_OK(iree_hal_local_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_GATHER,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32),
+        /*param=*/0, send.data(), recv.data(), send.size()));
+    for (size_t i = 0; i < recv.size(); ++i) {
+      ASSERT_EQ((int32_t)(i / kLargeCount), recv[i]);
+    }
+  });
+}
+
+TEST(LocalChannelTest, Broadcast) {
+  static constexpr int32_t kCount = 3;
+  RunRanks("Broadcast", kCount, [](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<uint8_t> data(1000, (uint8_t)rank);
+    IREE_ASSERT_OK(iree_hal_local_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_BROADCAST,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8),
+        /*param=*/1, data.data(), data.data(), data.size()));
+    EXPECT_EQ(std::vector<uint8_t>(1000, 1), data);
+  });
+}
+
+TEST(LocalChannelTest, ReduceAverageF16) {
+  static constexpr int32_t kCount = 2;
+  RunRanks("ReduceAverageF16", kCount,
+           [](iree_hal_channel_t* channel, int32_t rank) {
+             // 1.0 and 3.0 in IEEE half precision.
+             std::vector<uint16_t> send(8, rank == 0 ? 0x3C00 : 0x4200);
+             std::vector<uint16_t> recv(8, 0);
+             IREE_ASSERT_OK(iree_hal_local_channel_execute(
+                 channel,
+                 MakeOp(IREE_HAL_COLLECTIVE_KIND_REDUCE,
+                        IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_16,
+                        IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE),
+                 /*param=*/0, send.data(), recv.data(), send.size()));
+             // 2.0 in IEEE half precision on the root only.
+             EXPECT_EQ(std::vector<uint16_t>(8, rank == 0 ? 0x4000 : 0), recv);
+           });
+}
+
+TEST(LocalChannelTest, ReduceScatter) {
+  static constexpr int32_t kCount = 3;
+  RunRanks("ReduceScatter", kCount,
+           [](iree_hal_channel_t* channel, int32_t rank) {
+             std::vector<int32_t> send(kLargeCount * kCount);
+             for (size_t i = 0; i < send.size(); ++i) {
+               send[i] = (int32_t)i * (rank + 1);
+             }
+             std::vector<int32_t> recv(kLargeCount, -1);
+             IREE_ASSERT_OK(iree_hal_local_channel_execute(
+                 channel,
+                 MakeOp(IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER,
+                        IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32,
+                        IREE_HAL_COLLECTIVE_REDUCTION_SUM),
+                 /*param=*/0, send.data(), recv.data(), recv.size()));
+             for (size_t i = 0; i < recv.size(); ++i) {
+               ASSERT_EQ((int32_t)(rank * kLargeCount + i) * (1 + 2 + 3),
+                         recv[i]);
+             }
+           });
+}
+
+// Channels with the same ID created after a prior one has been fully
+// established must get a fresh segment.
+TEST(LocalChannelTest, ReuseId) {
+  for (int i = 0; i < 3; ++i) {
+    RunRanks("ReuseId", 2, [](iree_hal_channel_t* channel, int32_t rank) {
+      int64_t value = rank + 1;
+      IREE_ASSERT_OK(iree_hal_local_channel_execute(
+          channel,
+          MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+                 IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_64,
+                 IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT),
+          /*param=*/0, &value, &value, 1));
+      EXPECT_EQ(2, value);
+    });
+  }
+}
+
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+
+}  // namespace
@@ -8,6 +8,7 @@
 
 #include "iree/base/tracing.h"
 #include "iree/hal/local/executable_environment.h"
+#include "iree/hal/local/profiling.h"
 
 void iree_hal_local_executable_initialize(
     const iree_hal_local_executable_vtable_t* vtable,
@@ -28,10 +29,22 @@ void iree_hal_local_executable_initialize(
 
   // Function attributes are optional and populated by the parent type.
   out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->dispatch_costs = NULL;
+  out_base_executable->export_names = NULL;
 
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
                                              &out_base_executable->environment);
+
+  // Executables without deferred preparation are ready once initialized by
+  // the parent type.
+  iree_atomic_store_int32(&out_base_executable->prepare_state,
+                          vtable->prepare
+                              ? IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_PENDING
+                              : IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_READY,
+                          iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&out_base_executable->prepare_mutex);
+  out_base_executable->prepare_status = iree_ok_status();
 }
 
 void iree_hal_local_executable_deinitialize(
@@ -40,6 +53,8 @@ void iree_hal_local_executable_deinitialize(
        ++i) {
     iree_hal_pipeline_layout_release(base_executable->pipeline_layouts[i]);
   }
+  iree_status_ignore(base_executable->prepare_status);
+  iree_slim_mutex_deinitialize(&base_executable->prepare_mutex);
 }
 
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
@@ -47,6 +62,35 @@ iree_hal_local_executable_t* iree_hal_local_executable_cast(
   return (iree_hal_local_executable_t*)base_value;
 }
 
+iree_status_t iree_hal_local_executable_prepare_slow(
+    iree_hal_local_executable_t* executable) {
+  IREE_ASSERT_ARGUMENT(executable);
+  iree_slim_mutex_lock(&executable->prepare_mutex);
+  int32_t state = iree_atomic_load_int32(&executable->prepare_state,
+                                         iree_memory_order_relaxed);
+  if (state == IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_PENDING) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    iree_status_t status = ((const iree_hal_local_executable_vtable_t*)
+                                executable->resource.vtable)
+                               ->prepare(executable);
+    if (iree_status_is_ok(status)) {
+      state = IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_READY;
+    } else {
+      executable->prepare_status = status;
+      state = IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_FAILED;
+    }
+    iree_atomic_store_int32(&executable->prepare_state, state,
+                            iree_memory_order_release);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_status_t status =
+      state == IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_FAILED
+          ? iree_status_clone(executable->prepare_status)
+          : iree_ok_status();
+  iree_slim_mutex_unlock(&executable->prepare_mutex);
+  return status;
+}
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -55,6 +99,10 @@ iree_status_t iree_hal_local_executable_issue_call(
   IREE_ASSERT_ARGUMENT(executable);
   IREE_ASSERT_ARGUMENT(dispatch_state);
   IREE_ASSERT_ARGUMENT(workgroup_state);
+  if (iree_hal_local_profiling_is_active()) {
+    return iree_hal_local_profiling_issue_call(
+        executable, ordinal, dispatch_state, workgroup_state, worker_id);
+  }
   return ((const iree_hal_local_executable_vtable_t*)
               executable->resource.vtable)
       ->issue_call(executable, ordinal, dispatch_state, workgroup_state,
@@ -65,6 +113,7 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     uint32_t processor_id, iree_byte_span_t local_memory) {
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(executable));
   IREE_TRACE_ZONE_BEGIN(z0);
   // TODO(benvanik): annotate with executable name to calculate total time.
 
@@ -84,6 +133,8 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
 #endif  // IREE_HAL_VERBOSE_TRACING_ENABLE
 
   iree_status_t status = iree_ok_status();
+  const bool record_dispatch = iree_hal_local_profiling_timestamps_are_active();
+  const iree_time_t begin_time_ns = record_dispatch ? iree_time_now() : 0;
 
   iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
       .workgroup_id_x = 0,
@@ -107,6 +158,11 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     }
   }
 
+  if (record_dispatch && iree_status_is_ok(status)) {
+    iree_hal_local_profiling_record_dispatch(executable, ordinal,
+                                             begin_time_ns, iree_time_now());
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
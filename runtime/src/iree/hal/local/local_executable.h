@@ -8,6 +8,8 @@
 #define IREE_HAL_LOCAL_LOCAL_EXECUTABLE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
 
@@ -35,13 +37,34 @@ typedef struct iree_hal_local_executable_t {
   // of memory required by the function.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional per-export estimated dispatch costs 1:1 with the entry points.
+  // Only used as scheduling hints and NULL if the executable has none.
+  const iree_hal_executable_dispatch_cost_v0_t* dispatch_costs;
+
+  // Optional export names 1:1 with the entry points used to attribute
+  // profiling results. NULL if the executable has none.
+  const char* const* export_names;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
+
+  // iree_hal_local_executable_prepare_state_e of the executable. Executables
+  // with no prepare function in their vtable start prepared.
+  iree_atomic_int32_t prepare_state;
+  // Serializes preparation of lazily prepared executables.
+  iree_slim_mutex_t prepare_mutex;
+  // Sticky preparation failure returned to all callers once failed.
+  iree_status_t prepare_status;
 } iree_hal_local_executable_t;
 
 typedef struct iree_hal_local_executable_vtable_t {
   iree_hal_executable_vtable_t base;
 
+  // Optional. Finishes deferred preparation of the executable (loading,
+  // linking, and populating dispatch_attrs/costs/environment). Called at most
+  // once under the prepare_mutex by iree_hal_local_executable_prepare.
+  iree_status_t(IREE_API_PTR* prepare)(iree_hal_local_executable_t* executable);
+
   iree_status_t(IREE_API_PTR* issue_call)(
       iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -67,6 +90,32 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+enum iree_hal_local_executable_prepare_state_e {
+  IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_PENDING = 0,
+  IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_READY = 1,
+  IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_FAILED = 2,
+};
+
+iree_status_t iree_hal_local_executable_prepare_slow(
+    iree_hal_local_executable_t* executable);
+
+// Ensures that |executable| is ready to have its dispatch_attrs queried and
+// its entry points called. Executables may defer loading until first use and
+// this performs that work exactly once, blocking concurrent callers until
+// complete. Safe to call from any thread. If preparation fails the same error
+// is returned from all subsequent calls.
+static inline iree_status_t iree_hal_local_executable_prepare(
+    iree_hal_local_executable_t* executable) {
+  if (IREE_LIKELY(iree_atomic_load_int32(&executable->prepare_state,
+                                         iree_memory_order_acquire) ==
+                  IREE_HAL_LOCAL_EXECUTABLE_PREPARE_STATE_READY)) {
+    return iree_ok_status();
+  }
+  return iree_hal_local_executable_prepare_slow(executable);
+}
+
+// Issues a call to the entry point |ordinal|. The executable must have been
+// prepared with iree_hal_local_executable_prepare.
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -0,0 +1,671 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/profiling.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/local/local_executable.h"
+
+#if defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENTS 1
+#endif  // IREE_PLATFORM_LINUX
+
+// Hardware counters captured for each workgroup.
+typedef enum iree_hal_local_profiling_counter_e {
+  IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES = 0,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_INSTRUCTIONS,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_REFERENCES,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_MISSES,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT,
+} iree_hal_local_profiling_counter_t;
+
+// Assumed size of the memory traffic caused by each last-level cache miss.
+#define IREE_HAL_LOCAL_PROFILING_CACHE_LINE_SIZE 64
+
+// Initial capacity of each per-thread entry table. Must be a power of two.
+#define IREE_HAL_LOCAL_PROFILING_INITIAL_ENTRY_CAPACITY 64
+
+// Accumulated measurements of one executable export.
+typedef struct iree_hal_local_profiling_entry_t {
+  // Executable and export the entry measures or NULL if the entry is unused.
+  // The executable may be released before the capture ends and is only used
+  // as a key.
+  const void* executable;
+  uint32_t ordinal;
+  // Export name copied when the entry is created as the executable (and the
+  // library holding its names) may be unloaded before the capture ends.
+  char name[128];
+  uint64_t workgroup_count;
+  uint64_t time_ns;
+  uint64_t counters[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  // Dispatches recorded with iree_hal_local_profiling_record_dispatch and
+  // their total wall time.
+  uint64_t dispatch_count;
+  uint64_t dispatch_time_ns;
+} iree_hal_local_profiling_entry_t;
+
+// State of a thread that issued workgroups during the capture. Only accessed
+// by its thread until the capture ends.
+typedef struct iree_hal_local_profiling_thread_t {
+  struct iree_hal_local_profiling_thread_t* next;
+  // Counter file descriptors in perf group order with the group leader first.
+  // counter_ids maps each group position to the counter it measures.
+  iree_host_size_t counter_count;
+  int counter_fds[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  iree_hal_local_profiling_counter_t
+      counter_ids[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  // Open addressed table of entries with a power of two capacity.
+  iree_host_size_t entry_count;
+  iree_host_size_t entry_capacity;
+  iree_hal_local_profiling_entry_t* entries;
+} iree_hal_local_profiling_thread_t;
+
+typedef struct iree_hal_local_profiling_session_t {
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+  // Owner of the active capture or NULL if there is none.
+  const void* owner;
+  // Dispatch counter and/or timestamp modes captured.
+  iree_hal_device_profiling_mode_t mode;
+  iree_allocator_t host_allocator;
+  // Output file path or empty to write to stderr. Allocated from
+  // host_allocator.
+  char* file_path;
+  // Reason the hardware counters are unavailable, if they are.
+  char counters_unavailable_reason[128];
+  // All threads that have issued workgroups during the capture.
+  iree_hal_local_profiling_thread_t* thread_head;
+} iree_hal_local_profiling_session_t;
+
+iree_atomic_int32_t iree_hal_local_profiling_active_ = IREE_ATOMIC_VAR_INIT(0);
+iree_atomic_int32_t iree_hal_local_profiling_timestamps_active_ =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Incremented by each capture so that threads can tell whether their state
+// belongs to the active capture without dereferencing it.
+static iree_atomic_int32_t iree_hal_local_profiling_session_id_ =
+    IREE_ATOMIC_VAR_INIT(0);
+
+static iree_hal_local_profiling_session_t iree_hal_local_profiling_session_;
+static iree_once_flag iree_hal_local_profiling_session_flag_ =
+    IREE_ONCE_FLAG_INIT;
+static void iree_hal_local_profiling_session_initialize(void) {
+  memset(&iree_hal_local_profiling_session_, 0,
+         sizeof(iree_hal_local_profiling_session_));
+  iree_slim_mutex_initialize(&iree_hal_local_profiling_session_.mutex);
+}
+
+static iree_hal_local_profiling_session_t* iree_hal_local_profiling_session(
+    void) {
+  iree_call_once(&iree_hal_local_profiling_session_flag_,
+                 iree_hal_local_profiling_session_initialize);
+  return &iree_hal_local_profiling_session_;
+}
+
+static IREE_THREAD_LOCAL int32_t iree_hal_local_profiling_thread_session_id_ =
+    0;
+static IREE_THREAD_LOCAL iree_hal_local_profiling_thread_t*
+    iree_hal_local_profiling_thread_ = NULL;
+
+//===----------------------------------------------------------------------===//
+// Hardware counters
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENTS)
+
+static const uint64_t iree_hal_local_profiling_perf_configs[] = {
+    [IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES] = PERF_COUNT_HW_CPU_CYCLES,
+    [IREE_HAL_LOCAL_PROFILING_COUNTER_INSTRUCTIONS] =
+        PERF_COUNT_HW_INSTRUCTIONS,
+    [IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_REFERENCES] =
+        PERF_COUNT_HW_CACHE_REFERENCES,
+    [IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_MISSES] = PERF_COUNT_HW_CACHE_MISSES,
+};
+
+// Opens |counter| on the calling thread in the group led by |group_fd| or as
+// a new group leader if -1. Returns -1 and sets errno on failure.
+static int iree_hal_local_profiling_open_counter(
+    iree_hal_local_profiling_counter_t counter, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = iree_hal_local_profiling_perf_configs[counter];
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int)syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                      group_fd, /*flags=*/0);
+}
+
+// Opens as many counters as are available on the calling thread into
+// |thread|. Returns false with errno set if none could be opened.
+static bool iree_hal_local_profiling_open_counters(
+    iree_hal_local_profiling_thread_t* thread) {
+  thread->counter_count = 0;
+  int group_fd = -1;
+  for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+    int fd = iree_hal_local_profiling_open_counter(
+        (iree_hal_local_profiling_counter_t)i, group_fd);
+    if (fd < 0) continue;
+    if (group_fd < 0) group_fd = fd;
+    thread->counter_fds[thread->counter_count] = fd;
+    thread->counter_ids[thread->counter_count] =
+        (iree_hal_local_profiling_counter_t)i;
+    ++thread->counter_count;
+  }
+  return thread->counter_count > 0;
+}
+
+static void iree_hal_local_profiling_close_counters(
+    iree_hal_local_profiling_thread_t* thread) {
+  // Members must be closed before the leader.
+  for (iree_host_size_t i = thread->counter_count; i > 0; --i) {
+    close(thread->counter_fds[i - 1]);
+  }
+  thread->counter_count = 0;
+}
+
+// Reads the current counter values of |thread| into |out_values| indexed by
+// counter. Counters that are unavailable are left unchanged.
+static void iree_hal_local_profiling_read_counters(
+    iree_hal_local_profiling_thread_t* thread, uint64_t* out_values) {
+  if (!thread->counter_count) return;
+  // PERF_FORMAT_GROUP: u64 nr followed by nr values in group order.
+  uint64_t buffer[1 + IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  ssize_t length = read(thread->counter_fds[0], buffer, sizeof(buffer));
+  if (length < (ssize_t)sizeof(uint64_t)) return;
+  iree_host_size_t count = iree_min((iree_host_size_t)buffer[0],
+                                    thread->counter_count);
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    out_values[thread->counter_ids[i]] = buffer[1 + i];
+  }
+}
+
+#else
+
+static bool iree_hal_local_profiling_open_counters(
+    iree_hal_local_profiling_thread_t* thread) {
+  thread->counter_count = 0;
+  return false;
+}
+
+static void iree_hal_local_profiling_close_counters(
+    iree_hal_local_profiling_thread_t* thread) {}
+
+static void iree_hal_local_profiling_read_counters(
+    iree_hal_local_profiling_thread_t* thread, uint64_t* out_values) {}
+
+#endif  // IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENTS
+
+//===----------------------------------------------------------------------===//
+// Per-thread state
+//===----------------------------------------------------------------------===//
+
+// Returns the state of the calling thread in the active capture, creating it
+// if this is the first workgroup the thread issues. Returns NULL if the state
+// could not be allocated in which case the workgroup is not recorded.
+static iree_hal_local_profiling_thread_t* iree_hal_local_profiling_thread(
+    void) {
+  int32_t session_id = iree_atomic_load_int32(
+      &iree_hal_local_profiling_session_id_, iree_memory_order_acquire);
+  if (IREE_LIKELY(iree_hal_local_profiling_thread_session_id_ == session_id)) {
+    return iree_hal_local_profiling_thread_;
+  }
+
+  iree_hal_local_profiling_session_t* session =
+      iree_hal_local_profiling_session();
+  iree_hal_local_profiling_thread_t* thread = NULL;
+  iree_slim_mutex_lock(&session->mutex);
+  if (session->owner &&
+      iree_status_is_ok(iree_allocator_malloc(
+          session->host_allocator, sizeof(*thread), (void**)&thread))) {
+    memset(thread, 0, sizeof(*thread));
+    if (session->mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS) {
+      iree_hal_local_profiling_open_counters(thread);
+    }
+    thread->next = session->thread_head;
+    session->thread_head = thread;
+  }
+  iree_slim_mutex_unlock(&session->mutex);
+
+  // Failures are not retried for the rest of the capture.
+  iree_hal_local_profiling_thread_session_id_ = session_id;
+  iree_hal_local_profiling_thread_ = thread;
+  return thread;
+}
+
+static iree_host_size_t iree_hal_local_profiling_entry_hash(
+    const void* executable, uint32_t ordinal) {
+  uint64_t hash = (uint64_t)(uintptr_t)executable ^
+                  ((uint64_t)ordinal * 0x9E3779B97F4A7C15ull);
+  hash ^= hash >> 31;
+  hash *= 0xBF58476D1CE4E5B9ull;
+  hash ^= hash >> 29;
+  return (iree_host_size_t)hash;
+}
+
+// Inserts |entry| into the table of |thread|, which must have room for it.
+static iree_hal_local_profiling_entry_t*
+iree_hal_local_profiling_thread_insert(
+    iree_hal_local_profiling_thread_t* thread, const void* executable,
+    uint32_t ordinal) {
+  iree_host_size_t mask = thread->entry_capacity - 1;
+  iree_host_size_t i =
+      iree_hal_local_profiling_entry_hash(executable, ordinal) & mask;
+  for (;;) {
+    iree_hal_local_profiling_entry_t* entry = &thread->entries[i];
+    if (!entry->executable ||
+        (entry->executable == executable && entry->ordinal == ordinal)) {
+      return entry;
+    }
+    i = (i + 1) & mask;
+  }
+}
+
+// Grows the table of |thread| to hold at least one more entry.
+static bool iree_hal_local_profiling_thread_reserve(
+    iree_hal_local_profiling_thread_t* thread) {
+  // Keep the load factor under 3/4.
+  if ((thread->entry_count + 1) * 4 <= thread->entry_capacity * 3) return true;
+  iree_host_size_t new_capacity =
+      thread->entry_capacity ? thread->entry_capacity * 2
+                             : IREE_HAL_LOCAL_PROFILING_INITIAL_ENTRY_CAPACITY;
+  iree_hal_local_profiling_session_t* session =
+      iree_hal_local_profiling_session();
+  iree_hal_local_profiling_entry_t* new_entries = NULL;
+  if (!iree_status_is_ok(iree_allocator_malloc(
+          session->host_allocator, new_capacity * sizeof(*new_entries),
+          (void**)&new_entries))) {
+    return false;
+  }
+  memset(new_entries, 0, new_capacity * sizeof(*new_entries));
+  iree_hal_local_profiling_entry_t* old_entries = thread->entries;
+  iree_host_size_t old_capacity = thread->entry_capacity;
+  thread->entries = new_entries;
+  thread->entry_capacity = new_capacity;
+  for (iree_host_size_t i = 0; i < old_capacity; ++i) {
+    if (!old_entries[i].executable) continue;
+    *iree_hal_local_profiling_thread_insert(thread, old_entries[i].executable,
+                                            old_entries[i].ordinal) =
+        old_entries[i];
+  }
+  iree_allocator_free(session->host_allocator, old_entries);
+  return true;
+}
+
+// Returns the entry of |thread| for the export |ordinal| of |executable|,
+// creating it if needed. Returns NULL if the table could not be grown.
+static iree_hal_local_profiling_entry_t* iree_hal_local_profiling_thread_lookup(
+    iree_hal_local_profiling_thread_t* thread,
+    iree_hal_local_executable_t* executable, uint32_t ordinal) {
+  if (thread->entry_capacity) {
+    iree_hal_local_profiling_entry_t* entry =
+        iree_hal_local_profiling_thread_insert(thread, executable, ordinal);
+    if (entry->executable) return entry;
+  }
+  if (!iree_hal_local_profiling_thread_reserve(thread)) return NULL;
+  iree_hal_local_profiling_entry_t* entry =
+      iree_hal_local_profiling_thread_insert(thread, executable, ordinal);
+  entry->executable = executable;
+  entry->ordinal = ordinal;
+  const char* name =
+      executable->export_names ? executable->export_names[ordinal] : NULL;
+  if (name) {
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+  } else {
+    snprintf(entry->name, sizeof(entry->name), "executable_%p_export_%u",
+             (const void*)executable, ordinal);
+  }
+  ++thread->entry_count;
+  return entry;
+}
+
+iree_status_t iree_hal_local_profiling_issue_call(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  iree_hal_local_profiling_thread_t* thread = iree_hal_local_profiling_thread();
+  if (!thread) {
+    return vtable->issue_call(executable, ordinal, dispatch_state,
+                              workgroup_state, worker_id);
+  }
+
+  uint64_t begin_counters[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT] = {0};
+  uint64_t end_counters[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT] = {0};
+  iree_hal_local_profiling_read_counters(thread, begin_counters);
+  iree_time_t begin_time = iree_time_now();
+  iree_status_t status = vtable->issue_call(
+      executable, ordinal, dispatch_state, workgroup_state, worker_id);
+  iree_time_t end_time = iree_time_now();
+  iree_hal_local_profiling_read_counters(thread, end_counters);
+
+  iree_hal_local_profiling_entry_t* entry =
+      iree_hal_local_profiling_thread_lookup(thread, executable,
+                                             (uint32_t)ordinal);
+  if (entry) {
+    ++entry->workgroup_count;
+    entry->time_ns += (uint64_t)(end_time - begin_time);
+    for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+      entry->counters[i] += end_counters[i] - begin_counters[i];
+    }
+  }
+  return status;
+}
+
+void iree_hal_local_profiling_record_dispatch(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    iree_time_t begin_time_ns, iree_time_t end_time_ns) {
+  iree_hal_local_profiling_thread_t* thread = iree_hal_local_profiling_thread();
+  if (!thread) return;
+  iree_hal_local_profiling_entry_t* entry =
+      iree_hal_local_profiling_thread_lookup(thread, executable,
+                                             (uint32_t)ordinal);
+  if (!entry) return;
+  ++entry->dispatch_count;
+  entry->dispatch_time_ns += (uint64_t)(end_time_ns - begin_time_ns);
+}
+
+//===----------------------------------------------------------------------===//
+// Capture
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_local_profiling_begin(
+    const void* owner, const iree_hal_device_profiling_options_t* options,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(owner);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_local_profiling_session_t* session =
+      iree_hal_local_profiling_session();
+
+  // Copy the file path so that the options need not outlive the call.
+  iree_host_size_t file_path_length =
+      options->file_path ? strlen(options->file_path) : 0;
+  char* file_path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, file_path_length + 1,
+                                (void**)&file_path));
+  memcpy(file_path, options->file_path, file_path_length);
+  file_path[file_path_length] = 0;
+
+  iree_slim_mutex_lock(&session->mutex);
+  if (session->owner) {
+    iree_slim_mutex_unlock(&session->mutex);
+    iree_allocator_free(host_allocator, file_path);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "a dispatch profiling capture is already active "
+                            "in this process; only one device may profile "
+                            "dispatches at a time");
+  }
+  session->owner = owner;
+  session->mode = options->mode &
+                  (IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+                   IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS);
+  session->host_allocator = host_allocator;
+  session->file_path = file_path;
+  session->thread_head = NULL;
+
+  // Probe the counters on this thread so that we can explain missing values.
+  session->counters_unavailable_reason[0] = 0;
+  iree_hal_local_profiling_thread_t probe_thread;
+  memset(&probe_thread, 0, sizeof(probe_thread));
+  if (!(session->mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    // Counters are not captured.
+  } else if (iree_hal_local_profiling_open_counters(&probe_thread)) {
+    iree_hal_local_profiling_close_counters(&probe_thread);
+  } else {
+#if defined(IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENTS)
+    int error = errno;
+    snprintf(session->counters_unavailable_reason,
+             sizeof(session->counters_unavailable_reason),
+             "perf_event_open failed: %s%s", strerror(error),
+             error == EACCES || error == EPERM
+                 ? " (check /proc/sys/kernel/perf_event_paranoid)"
+                 : "");
+#else
+    snprintf(session->counters_unavailable_reason,
+             sizeof(session->counters_unavailable_reason),
+             "not supported on this platform");
+#endif  // IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENTS
+  }
+
+  iree_atomic_fetch_add_int32(&iree_hal_local_profiling_session_id_, 1,
+                              iree_memory_order_release);
+  if (session->mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS) {
+    iree_atomic_store_int32(&iree_hal_local_profiling_active_, 1,
+                            iree_memory_order_release);
+  }
+  if (session->mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS) {
+    iree_atomic_store_int32(&iree_hal_local_profiling_timestamps_active_, 1,
+                            iree_memory_order_release);
+  }
+  iree_slim_mutex_unlock(&session->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static int iree_hal_local_profiling_compare_keys(const void* lhs_ptr,
+                                                 const void* rhs_ptr) {
+  const iree_hal_local_profiling_entry_t* lhs =
+      (const iree_hal_local_profiling_entry_t*)lhs_ptr;
+  const iree_hal_local_profiling_entry_t* rhs =
+      (const iree_hal_local_profiling_entry_t*)rhs_ptr;
+  if (lhs->executable != rhs->executable) {
+    return (uintptr_t)lhs->executable < (uintptr_t)rhs->executable ? -1 : 1;
+  }
+  if (lhs->ordinal != rhs->ordinal) return lhs->ordinal < rhs->ordinal ? -1 : 1;
+  return strcmp(lhs->name, rhs->name);
+}
+
+// Sorts the most expensive entries first by cycles and then by time.
+static int iree_hal_local_profiling_compare_costs(const void* lhs_ptr,
+                                                  const void* rhs_ptr) {
+  const iree_hal_local_profiling_entry_t* lhs =
+      (const iree_hal_local_profiling_entry_t*)lhs_ptr;
+  const iree_hal_local_profiling_entry_t* rhs =
+      (const iree_hal_local_profiling_entry_t*)rhs_ptr;
+  uint64_t lhs_cycles = lhs->counters[IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES];
+  uint64_t rhs_cycles = rhs->counters[IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES];
+  if (lhs_cycles != rhs_cycles) return lhs_cycles > rhs_cycles ? -1 : 1;
+  if (lhs->time_ns != rhs->time_ns) return lhs->time_ns > rhs->time_ns ? -1 : 1;
+  return 0;
+}
+
+// Sorts the entries with the most total dispatch time first.
+static int iree_hal_local_profiling_compare_dispatch_times(
+    const void* lhs_ptr, const void* rhs_ptr) {
+  const iree_hal_local_profiling_entry_t* lhs =
+      (const iree_hal_local_profiling_entry_t*)lhs_ptr;
+  const iree_hal_local_profiling_entry_t* rhs =
+      (const iree_hal_local_profiling_entry_t*)rhs_ptr;
+  if (lhs->dispatch_time_ns != rhs->dispatch_time_ns) {
+    return lhs->dispatch_time_ns > rhs->dispatch_time_ns ? -1 : 1;
+  }
+  return 0;
+}
+
+static void iree_hal_local_profiling_write_entries(
+    FILE* file, const char* counters_unavailable_reason,
+    const iree_hal_local_profiling_entry_t* entries,
+    iree_host_size_t entry_count) {
+  if (counters_unavailable_reason[0]) {
+    fprintf(file, "# hardware counters unavailable: %s\n",
+            counters_unavailable_reason);
+  }
+  fprintf(file,
+          "export,workgroups,time_ns,cycles,instructions,ipc,llc_references,"
+          "llc_misses,llc_miss_bytes,llc_miss_gbps\n");
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    const iree_hal_local_profiling_entry_t* entry = &entries[i];
+    if (!entry->workgroup_count) continue;
+    const uint64_t* counters = entry->counters;
+    uint64_t cycles = counters[IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES];
+    uint64_t instructions =
+        counters[IREE_HAL_LOCAL_PROFILING_COUNTER_INSTRUCTIONS];
+    uint64_t llc_misses = counters[IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_MISSES];
+    uint64_t llc_miss_bytes =
+        llc_misses * IREE_HAL_LOCAL_PROFILING_CACHE_LINE_SIZE;
+    // Bytes per nanosecond is GB/s.
+    fprintf(file,
+            "%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.3f,%" PRIu64
+            ",%" PRIu64 ",%" PRIu64 ",%.3f\n",
+            entry->name, entry->workgroup_count, entry->time_ns, cycles,
+            instructions, cycles ? (double)instructions / cycles : 0.0,
+            counters[IREE_HAL_LOCAL_PROFILING_COUNTER_LLC_REFERENCES],
+            llc_misses, llc_miss_bytes,
+            entry->time_ns ? (double)llc_miss_bytes / entry->time_ns : 0.0);
+  }
+}
+
+static void iree_hal_local_profiling_write_dispatch_times(
+    FILE* file, const iree_hal_local_profiling_entry_t* entries,
+    iree_host_size_t entry_count) {
+  uint64_t total_time_ns = 0;
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    total_time_ns += entries[i].dispatch_time_ns;
+  }
+  fprintf(file, "export,dispatches,time_ns,mean_time_ns,percent\n");
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    const iree_hal_local_profiling_entry_t* entry = &entries[i];
+    if (!entry->dispatch_count) continue;
+    fprintf(file, "%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.2f\n", entry->name,
+            entry->dispatch_count, entry->dispatch_time_ns,
+            entry->dispatch_time_ns / entry->dispatch_count,
+            total_time_ns ? 100.0 * entry->dispatch_time_ns / total_time_ns
+                          : 0.0);
+  }
+}
+
+iree_status_t iree_hal_local_profiling_end(const void* owner) {
+  IREE_ASSERT_ARGUMENT(owner);
+  iree_hal_local_profiling_session_t* session =
+      iree_hal_local_profiling_session();
+  iree_slim_mutex_lock(&session->mutex);
+  if (session->owner != owner) {
+    iree_slim_mutex_unlock(&session->mutex);
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_atomic_store_int32(&iree_hal_local_profiling_active_, 0,
+                          iree_memory_order_release);
+  iree_atomic_store_int32(&iree_hal_local_profiling_timestamps_active_, 0,
+                          iree_memory_order_release);
+  iree_hal_device_profiling_mode_t mode = session->mode;
+  iree_allocator_t host_allocator = session->host_allocator;
+  iree_hal_local_profiling_thread_t* thread_head = session->thread_head;
+  char* file_path = session->file_path;
+  char counters_unavailable_reason[sizeof(
+      session->counters_unavailable_reason)];
+  memcpy(counters_unavailable_reason, session->counters_unavailable_reason,
+         sizeof(counters_unavailable_reason));
+  session->owner = NULL;
+  session->mode = IREE_HAL_DEVICE_PROFILING_MODE_NONE;
+  session->file_path = NULL;
+  session->thread_head = NULL;
+  iree_slim_mutex_unlock(&session->mutex);
+
+  // Gather all entries from all threads and release the threads.
+  iree_host_size_t total_entry_count = 0;
+  for (iree_hal_local_profiling_thread_t* thread = thread_head; thread;
+       thread = thread->next) {
+    total_entry_count += thread->entry_count;
+  }
+  iree_hal_local_profiling_entry_t* entries = NULL;
+  iree_status_t status = iree_ok_status();
+  if (total_entry_count > 0) {
+    status = iree_allocator_malloc(host_allocator,
+                                   total_entry_count * sizeof(*entries),
+                                   (void**)&entries);
+  }
+  iree_host_size_t entry_count = 0;
+  while (thread_head) {
+    iree_hal_local_profiling_thread_t* thread = thread_head;
+    thread_head = thread->next;
+    for (iree_host_size_t i = 0; entries && i < thread->entry_capacity; ++i) {
+      if (thread->entries[i].executable) {
+        entries[entry_count++] = thread->entries[i];
+      }
+    }
+    iree_hal_local_profiling_close_counters(thread);
+    iree_allocator_free(host_allocator, thread->entries);
+    iree_allocator_free(host_allocator, thread);
+  }
+
+  // Merge the entries of each export across threads.
+  if (entry_count > 0) {
+    qsort(entries, entry_count, sizeof(*entries),
+          iree_hal_local_profiling_compare_keys);
+    iree_host_size_t merged_count = 0;
+    for (iree_host_size_t i = 0; i < entry_count; ++i) {
+      iree_hal_local_profiling_entry_t* merged =
+          merged_count ? &entries[merged_count - 1] : NULL;
+      if (merged &&
+          iree_hal_local_profiling_compare_keys(merged, &entries[i]) == 0) {
+        merged->workgroup_count += entries[i].workgroup_count;
+        merged->time_ns += entries[i].time_ns;
+        for (int j = 0; j < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++j) {
+          merged->counters[j] += entries[i].counters[j];
+        }
+        merged->dispatch_count += entries[i].dispatch_count;
+        merged->dispatch_time_ns += entries[i].dispatch_time_ns;
+      } else {
+        entries[merged_count++] = entries[i];
+      }
+    }
+    entry_count = merged_count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    FILE* file = stderr;
+    if (file_path[0]) {
+      file = fopen(file_path, "w");
+      if (!file) {
+        status = iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                                  "failed to open dispatch profiling output "
+                                  "file '%s'",
+                                  file_path);
+      }
+    }
+    if (file && (mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+      if (entry_count > 0) {
+        qsort(entries, entry_count, sizeof(*entries),
+              iree_hal_local_profiling_compare_costs);
+      }
+      iree_hal_local_profiling_write_entries(file, counters_unavailable_reason,
+                                             entries, entry_count);
+    }
+    if (file && (mode & IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS)) {
+      if (entry_count > 0) {
+        qsort(entries, entry_count, sizeof(*entries),
+              iree_hal_local_profiling_compare_dispatch_times);
+      }
+      iree_hal_local_profiling_write_dispatch_times(file, entries, entry_count);
+    }
+    if (file && file != stderr) fclose(file);
+  }
+
+  iree_allocator_free(host_allocator, entries);
+  iree_allocator_free(host_allocator, file_path);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
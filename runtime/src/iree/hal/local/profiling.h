@@ -0,0 +1,117 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_PROFILING_H_
+#define IREE_HAL_LOCAL_PROFILING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_hal_local_executable_t iree_hal_local_executable_t;
+
+//===----------------------------------------------------------------------===//
+// Dispatch counter profiling
+//===----------------------------------------------------------------------===//
+
+// Shared implementation of IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS
+// for local devices.
+//
+// While a capture is active every workgroup issued through
+// iree_hal_local_executable_issue_call is measured on the thread executing it
+// and attributed to its executable export. On Linux/Android each thread lazily
+// opens a group of perf_event_open counters for itself the first time it
+// issues a workgroup (cycles, instructions, and last-level cache references
+// and misses, all excluding the kernel); elsewhere, or if the counters cannot
+// be opened (such as with a restrictive perf_event_paranoid), only time is
+// measured.
+//
+// When the capture ends one row per export is written as CSV to the profiling
+// options file_path, or stderr if none, sorted by cycles (or time) with the
+// most expensive exports first:
+//   export,workgroups,time_ns,cycles,instructions,ipc,llc_references,
+//   llc_misses,llc_miss_bytes,llc_miss_gbps
+// llc_miss_bytes approximates the DRAM traffic of the export by assuming one
+// cache line of traffic for each last-level cache miss.
+//
+// Counters are read before and after each workgroup, adding two counter reads
+// and two clock queries to every workgroup of the profiled program: use this to
+// find the expensive exports and not to measure end-to-end performance.
+//
+// Only one capture can be active in the process at a time and it measures the
+// dispatches of all local devices. All local devices must be idle when the
+// capture begins and ends.
+//
+// The same capture also implements
+// IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS. Command buffers measure
+// the wall time of each dispatch from when its first workgroup begins to when
+// its last workgroup ends and report it with
+// iree_hal_local_profiling_record_dispatch. At the end of the capture one row
+// per export is written sorted by total time with the most expensive first:
+//   export,dispatches,time_ns,mean_time_ns,percent
+// Workgroups are not measured individually in this mode and the overhead is
+// two clock queries per dispatch.
+
+// Nonzero while a capture is active. Use iree_hal_local_profiling_is_active.
+extern iree_atomic_int32_t iree_hal_local_profiling_active_;
+
+// Nonzero while a capture is recording dispatch timestamps. Use
+// iree_hal_local_profiling_timestamps_are_active.
+extern iree_atomic_int32_t iree_hal_local_profiling_timestamps_active_;
+
+// Returns true if a capture is active and workgroups should be issued with
+// iree_hal_local_profiling_issue_call.
+static inline bool iree_hal_local_profiling_is_active(void) {
+  return IREE_UNLIKELY(iree_atomic_load_int32(&iree_hal_local_profiling_active_,
+                                              iree_memory_order_relaxed) != 0);
+}
+
+// Returns true if a capture is active and dispatches should be reported with
+// iree_hal_local_profiling_record_dispatch.
+static inline bool iree_hal_local_profiling_timestamps_are_active(void) {
+  return IREE_UNLIKELY(
+      iree_atomic_load_int32(&iree_hal_local_profiling_timestamps_active_,
+                             iree_memory_order_relaxed) != 0);
+}
+
+// Begins a process-wide capture of the dispatch counters and/or timestamps
+// requested by |options| owned by |owner| (usually the device). Fails if
+// another owner has a capture active.
+iree_status_t iree_hal_local_profiling_begin(
+    const void* owner, const iree_hal_device_profiling_options_t* options,
+    iree_allocator_t host_allocator);
+
+// Ends the capture begun by |owner| and writes the results. No-op if |owner|
+// has no capture active.
+iree_status_t iree_hal_local_profiling_end(const void* owner);
+
+// Issues a workgroup as with iree_hal_local_executable_issue_call and records
+// its counters in the active capture.
+iree_status_t iree_hal_local_profiling_issue_call(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id);
+
+// Records a dispatch of the export |ordinal| of |executable| that ran from
+// |begin_time_ns| to |end_time_ns| in the active capture.
+void iree_hal_local_profiling_record_dispatch(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    iree_time_t begin_time_ns, iree_time_t end_time_ns);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_PROFILING_H_
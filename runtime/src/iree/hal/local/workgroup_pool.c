@@ -0,0 +1,261 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/workgroup_pool.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/base/tracing.h"
+
+typedef struct iree_hal_local_workgroup_worker_t {
+  iree_hal_local_workgroup_pool_t* pool;
+  uint32_t worker_id;
+  iree_thread_t* thread;
+} iree_hal_local_workgroup_worker_t;
+
+struct iree_hal_local_workgroup_pool_t {
+  iree_allocator_t host_allocator;
+
+  // Serializes runs so that only one grid is in flight at a time.
+  iree_slim_mutex_t run_mutex;
+
+  // Incremented to publish a new run to the workers.
+  iree_atomic_int32_t epoch;
+  // Set when the workers should exit.
+  iree_atomic_int32_t exit_requested;
+  // Posted when |epoch| or |exit_requested| change.
+  iree_notification_t work_notification;
+
+  // Number of workers that have not yet finished the current run.
+  iree_atomic_int32_t pending_worker_count;
+  // Posted when |pending_worker_count| reaches 0.
+  iree_notification_t done_notification;
+
+  // Current run. Only valid between publishing a new epoch and all workers
+  // completing it.
+  iree_hal_local_workgroup_fn_t workgroup_fn;
+  void* user_data;
+  uint32_t workgroup_count[3];
+  int64_t workgroup_total;
+  // Linearized index of the next workgroup to be claimed by a worker.
+  iree_atomic_int64_t next_workgroup;
+  // First failure of the current run, if any.
+  iree_slim_mutex_t status_mutex;
+  iree_status_t status;
+
+  iree_host_size_t worker_count;
+  iree_hal_local_workgroup_worker_t workers[];
+};
+
+// Executes workgroups of the current run on |worker_id| until none remain.
+static void iree_hal_local_workgroup_pool_execute(
+    iree_hal_local_workgroup_pool_t* pool, uint32_t worker_id) {
+  const uint32_t count_x = pool->workgroup_count[0];
+  const uint32_t count_y = pool->workgroup_count[1];
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state;
+  memset(&workgroup_state, 0, sizeof(workgroup_state));
+  workgroup_state.processor_id = iree_cpu_query_processor_id();
+  while (true) {
+    int64_t index = iree_atomic_fetch_add_int64(&pool->next_workgroup, 1,
+                                                iree_memory_order_relaxed);
+    if (index >= pool->workgroup_total) break;
+    workgroup_state.workgroup_id_x = (uint32_t)(index % count_x);
+    workgroup_state.workgroup_id_y = (uint32_t)((index / count_x) % count_y);
+    workgroup_state.workgroup_id_z = (uint32_t)(index / count_x / count_y);
+    iree_status_t status =
+        pool->workgroup_fn(pool->user_data, &workgroup_state, worker_id);
+    if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+      // Skip all remaining workgroups; ones already claimed will finish.
+      iree_atomic_store_int64(&pool->next_workgroup, pool->workgroup_total,
+                              iree_memory_order_relaxed);
+      iree_slim_mutex_lock(&pool->status_mutex);
+      if (iree_status_is_ok(pool->status)) {
+        pool->status = status;
+      } else {
+        iree_status_ignore(status);
+      }
+      iree_slim_mutex_unlock(&pool->status_mutex);
+      break;
+    }
+  }
+}
+
+static int iree_hal_local_workgroup_worker_main(
+    iree_hal_local_workgroup_worker_t* worker) {
+  iree_hal_local_workgroup_pool_t* pool = worker->pool;
+  int32_t last_epoch = 0;
+  while (true) {
+    // Wait for a new run or a request to exit.
+    int32_t epoch = 0;
+    while (true) {
+      iree_wait_token_t wait_token =
+          iree_notification_prepare_wait(&pool->work_notification);
+      if (iree_atomic_load_int32(&pool->exit_requested,
+                                 iree_memory_order_acquire)) {
+        iree_notification_cancel_wait(&pool->work_notification);
+        return 0;
+      }
+      epoch = iree_atomic_load_int32(&pool->epoch, iree_memory_order_acquire);
+      if (epoch != last_epoch) {
+        iree_notification_cancel_wait(&pool->work_notification);
+        break;
+      }
+      iree_notification_commit_wait(&pool->work_notification, wait_token,
+                                    IREE_DURATION_ZERO,
+                                    IREE_TIME_INFINITE_FUTURE);
+    }
+    last_epoch = epoch;
+
+    iree_hal_local_workgroup_pool_execute(pool, worker->worker_id);
+
+    if (iree_atomic_fetch_sub_int32(&pool->pending_worker_count, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+// Requests all workers exit and waits for them to do so.
+static void iree_hal_local_workgroup_pool_join(
+    iree_hal_local_workgroup_pool_t* pool) {
+  iree_atomic_store_int32(&pool->exit_requested, 1, iree_memory_order_release);
+  iree_notification_post(&pool->work_notification, IREE_ALL_WAITERS);
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    // Releasing the last reference joins the thread.
+    iree_thread_release(pool->workers[i].thread);
+    pool->workers[i].thread = NULL;
+  }
+}
+
+static void iree_hal_local_workgroup_pool_destroy(
+    iree_hal_local_workgroup_pool_t* pool) {
+  iree_hal_local_workgroup_pool_join(pool);
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->work_notification);
+  iree_slim_mutex_deinitialize(&pool->status_mutex);
+  iree_slim_mutex_deinitialize(&pool->run_mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+}
+
+iree_status_t iree_hal_local_workgroup_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_local_workgroup_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)worker_count);
+
+  iree_hal_local_workgroup_pool_t* pool = NULL;
+  iree_host_size_t total_size =
+      sizeof(*pool) + worker_count * sizeof(pool->workers[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&pool));
+  memset(pool, 0, total_size);
+  pool->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&pool->run_mutex);
+  iree_notification_initialize(&pool->work_notification);
+  iree_notification_initialize(&pool->done_notification);
+  iree_slim_mutex_initialize(&pool->status_mutex);
+  pool->status = iree_ok_status();
+
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = iree_make_cstring_view("iree-workgroup");
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_hal_local_workgroup_worker_t* worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->worker_id = (uint32_t)(i + 1);
+    status = iree_thread_create(
+        (iree_thread_entry_t)iree_hal_local_workgroup_worker_main, worker,
+        thread_params, host_allocator, &worker->thread);
+    if (!iree_status_is_ok(status)) break;
+    // Only count workers that were created so that teardown joins them.
+    pool->worker_count = i + 1;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_local_workgroup_pool_destroy(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_local_workgroup_pool_free(iree_hal_local_workgroup_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_local_workgroup_pool_destroy(pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_host_size_t iree_hal_local_workgroup_pool_worker_capacity(
+    const iree_hal_local_workgroup_pool_t* pool) {
+  return pool->worker_count + 1;
+}
+
+static bool iree_hal_local_workgroup_pool_is_done(
+    iree_hal_local_workgroup_pool_t* pool) {
+  return iree_atomic_load_int32(&pool->pending_worker_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+iree_status_t iree_hal_local_workgroup_pool_run(
+    iree_hal_local_workgroup_pool_t* pool, const uint32_t workgroup_count[3],
+    iree_hal_local_workgroup_fn_t workgroup_fn, void* user_data) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(workgroup_fn);
+  int64_t workgroup_total = (int64_t)workgroup_count[0] *
+                            (int64_t)workgroup_count[1] *
+                            (int64_t)workgroup_count[2];
+  if (workgroup_total == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, workgroup_total);
+
+  iree_slim_mutex_lock(&pool->run_mutex);
+
+  pool->workgroup_fn = workgroup_fn;
+  pool->user_data = user_data;
+  memcpy(pool->workgroup_count, workgroup_count,
+         sizeof(pool->workgroup_count));
+  pool->workgroup_total = workgroup_total;
+  iree_atomic_store_int64(&pool->next_workgroup, 0, iree_memory_order_relaxed);
+
+  // Wake workers only when there is more than one workgroup to share.
+  const bool use_workers = pool->worker_count > 0 && workgroup_total > 1;
+  if (use_workers) {
+    iree_atomic_store_int32(&pool->pending_worker_count,
+                            (int32_t)pool->worker_count,
+                            iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int32(&pool->epoch, 1, iree_memory_order_acq_rel);
+    iree_notification_post(&pool->work_notification, IREE_ALL_WAITERS);
+  }
+
+  iree_hal_local_workgroup_pool_execute(pool, /*worker_id=*/0);
+
+  if (use_workers) {
+    iree_notification_await(
+        &pool->done_notification,
+        (iree_condition_fn_t)iree_hal_local_workgroup_pool_is_done, pool,
+        iree_infinite_timeout());
+  }
+
+  iree_status_t status = pool->status;
+  pool->status = iree_ok_status();
+  pool->workgroup_fn = NULL;
+  pool->user_data = NULL;
+
+  iree_slim_mutex_unlock(&pool->run_mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
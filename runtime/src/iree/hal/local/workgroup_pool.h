@@ -0,0 +1,68 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_WORKGROUP_POOL_H_
+#define IREE_HAL_LOCAL_WORKGROUP_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_library.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_workgroup_pool_t
+//===----------------------------------------------------------------------===//
+//
+// A small fixed set of threads that cooperatively execute the workgroups of a
+// single dispatch grid. This is a lightweight alternative to the iree/task
+// system for synchronous execution models (such as the inline HAL loader
+// module) that want to use more than one core on a dispatch without any
+// scheduling, queuing, or dependency tracking.
+//
+// The calling thread always participates as worker 0 and the pool threads as
+// workers 1 to worker_count. Workgroups are claimed one at a time from a shared
+// counter so uneven workgroup costs balance across workers. Only one grid is
+// executed at a time; concurrent runs from multiple threads are serialized.
+
+typedef struct iree_hal_local_workgroup_pool_t iree_hal_local_workgroup_pool_t;
+
+// Executes a single workgroup of a grid on the worker with |worker_id|.
+// The workgroup state is only valid for the duration of the call.
+typedef iree_status_t(IREE_API_PTR* iree_hal_local_workgroup_fn_t)(
+    void* user_data,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id);
+
+// Creates a pool with |worker_count| threads in addition to the caller.
+// A |worker_count| of 0 is valid and executes all workgroups on the caller.
+iree_status_t iree_hal_local_workgroup_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_local_workgroup_pool_t** out_pool);
+
+// Waits for the pool threads to exit and frees |pool|.
+// There must be no runs in progress.
+void iree_hal_local_workgroup_pool_free(iree_hal_local_workgroup_pool_t* pool);
+
+// Returns the total number of workers including the calling thread. Worker IDs
+// passed to workgroup functions are in the range [0, worker capacity).
+iree_host_size_t iree_hal_local_workgroup_pool_worker_capacity(
+    const iree_hal_local_workgroup_pool_t* pool);
+
+// Executes |workgroup_fn| for every workgroup in the |workgroup_count| grid
+// distributed across all workers and returns once they have all completed.
+// If any workgroup fails the remaining unstarted workgroups are skipped and the
+// first failure is returned.
+iree_status_t iree_hal_local_workgroup_pool_run(
+    iree_hal_local_workgroup_pool_t* pool, const uint32_t workgroup_count[3],
+    iree_hal_local_workgroup_fn_t workgroup_fn, void* user_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_WORKGROUP_POOL_H_
@@ -0,0 +1,125 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/workgroup_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+struct GridState {
+  uint32_t workgroup_count[3];
+  iree_host_size_t worker_capacity;
+  std::vector<std::atomic<int>> visits;
+  std::atomic<bool> bad_worker_id{false};
+  // Linearized workgroup index that fails, or -1.
+  int64_t failing_workgroup = -1;
+
+  GridState(uint32_t x, uint32_t y, uint32_t z, iree_host_size_t capacity)
+      : workgroup_count{x, y, z}, worker_capacity(capacity), visits(x * y * z) {
+    for (auto& visit : visits) visit = 0;
+  }
+
+  static iree_status_t Execute(
+      void* user_data,
+      const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+      uint32_t worker_id) {
+    auto* state = reinterpret_cast<GridState*>(user_data);
+    if (worker_id >= state->worker_capacity) state->bad_worker_id = true;
+    int64_t index = workgroup_state->workgroup_id_x +
+                    state->workgroup_count[0] *
+                        (workgroup_state->workgroup_id_y +
+                         state->workgroup_count[1] *
+                             (int64_t)workgroup_state->workgroup_id_z);
+    ++state->visits[index];
+    if (index == state->failing_workgroup) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS, "workgroup failed");
+    }
+    return iree_ok_status();
+  }
+};
+
+// Worker counts each test is run with; 0 executes only on the caller.
+static const iree_host_size_t kWorkerCounts[] = {0, 1, 3};
+
+class WorkgroupPoolTest : public ::testing::Test {
+ protected:
+  void TearDown() override { DestroyPool(); }
+
+  void CreatePool(iree_host_size_t worker_count) {
+    DestroyPool();
+    IREE_ASSERT_OK(iree_hal_local_workgroup_pool_create(
+        worker_count, iree_allocator_system(), &pool_));
+  }
+
+  void DestroyPool() {
+    iree_hal_local_workgroup_pool_free(pool_);
+    pool_ = NULL;
+  }
+
+  iree_host_size_t worker_capacity() const {
+    return iree_hal_local_workgroup_pool_worker_capacity(pool_);
+  }
+
+  iree_hal_local_workgroup_pool_t* pool_ = NULL;
+};
+
+TEST_F(WorkgroupPoolTest, WorkerCapacity) {
+  for (iree_host_size_t worker_count : kWorkerCounts) {
+    CreatePool(worker_count);
+    EXPECT_EQ(worker_count + 1, worker_capacity());
+  }
+}
+
+TEST_F(WorkgroupPoolTest, EmptyGrid) {
+  for (iree_host_size_t worker_count : kWorkerCounts) {
+    CreatePool(worker_count);
+    GridState state(4, 0, 2, worker_capacity());
+    IREE_ASSERT_OK(iree_hal_local_workgroup_pool_run(
+        pool_, state.workgroup_count, GridState::Execute, &state));
+  }
+}
+
+// Every workgroup executes exactly once across repeated runs.
+TEST_F(WorkgroupPoolTest, VisitsEachWorkgroupOnce) {
+  for (iree_host_size_t worker_count : kWorkerCounts) {
+    CreatePool(worker_count);
+    for (int run = 0; run < 16; ++run) {
+      GridState state(7, 5, 3, worker_capacity());
+      IREE_ASSERT_OK(iree_hal_local_workgroup_pool_run(
+          pool_, state.workgroup_count, GridState::Execute, &state));
+      for (auto& visit : state.visits) EXPECT_EQ(1, visit.load());
+      EXPECT_FALSE(state.bad_worker_id);
+    }
+  }
+}
+
+// Failures are returned and do not prevent subsequent runs.
+TEST_F(WorkgroupPoolTest, Failure) {
+  for (iree_host_size_t worker_count : kWorkerCounts) {
+    CreatePool(worker_count);
+    GridState failing_state(64, 1, 1, worker_capacity());
+    failing_state.failing_workgroup = 3;
+    IREE_EXPECT_STATUS_IS(
+        IREE_STATUS_DATA_LOSS,
+        iree_hal_local_workgroup_pool_run(pool_, failing_state.workgroup_count,
+                                          GridState::Execute, &failing_state));
+    for (auto& visit : failing_state.visits) EXPECT_LE(visit.load(), 1);
+
+    GridState state(64, 1, 1, worker_capacity());
+    IREE_ASSERT_OK(iree_hal_local_workgroup_pool_run(
+        pool_, state.workgroup_count, GridState::Execute, &state));
+    for (auto& visit : state.visits) EXPECT_EQ(1, visit.load());
+  }
+}
+
+}  // namespace
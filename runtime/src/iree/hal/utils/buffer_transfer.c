@@ -447,3 +447,198 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_emulated_unmap_range(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_hal_device_queue_read implementations
+//===----------------------------------------------------------------------===//
+
+// Maximum size of the host staging buffer used when streaming files that are
+// not backed by host memory. Larger chunks amortize the per-transfer overhead
+// at the cost of more host memory held during the read.
+#define IREE_HAL_QUEUE_READ_STAGING_CHUNK_SIZE (16 * 1024 * 1024)
+
+static iree_status_t iree_hal_device_validate_file_read(
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_device_size_t length) {
+  if (!iree_any_bit_set(iree_hal_file_allowed_access(source_file),
+                        IREE_HAL_MEMORY_ACCESS_READ)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "source file does not allow read access");
+  }
+  const uint64_t file_length = iree_hal_file_length(source_file);
+  if (source_offset > file_length || length > file_length - source_offset) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "file read range [%" PRIu64 ", %" PRIu64
+                            ") out of bounds of file length %" PRIu64,
+                            source_offset, source_offset + (uint64_t)length,
+                            file_length);
+  }
+  return iree_ok_status();
+}
+
+static void iree_hal_file_import_release(void* user_data,
+                                         iree_hal_buffer_t* buffer) {
+  iree_hal_file_release((iree_hal_file_t*)user_data);
+}
+
+// Imports the |host_contents| range of |source_file| as a buffer usable as a
+// transfer source on |device|. The file is retained until the buffer is
+// released. Fails if the device allocator cannot import host memory.
+static iree_status_t iree_hal_device_import_file_range(
+    iree_hal_device_t* device, iree_hal_file_t* source_file,
+    iree_byte_span_t host_contents, iree_hal_buffer_t** out_buffer) {
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+              IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+      .access = IREE_HAL_MEMORY_ACCESS_READ,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE,
+  };
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = 0,
+      .size = host_contents.data_length,
+      .handle.host_allocation.ptr = host_contents.data,
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_hal_file_import_release,
+      .user_data = source_file,
+  };
+  iree_hal_file_retain(source_file);
+  iree_status_t status = iree_hal_allocator_import_buffer(
+      iree_hal_device_allocator(device), params, &external_buffer,
+      release_callback, out_buffer);
+  if (!iree_status_is_ok(status)) iree_hal_file_release(source_file);
+  return status;
+}
+
+// Issues a queue-ordered copy from the imported |source_buffer| into
+// |target_buffer| that waits on |wait_semaphore_list| and signals
+// |signal_semaphore_list| without blocking the caller.
+static iree_status_t iree_hal_device_queue_copy(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* source_buffer, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
+  const iree_hal_transfer_command_t transfer_command = {
+      .type = IREE_HAL_TRANSFER_COMMAND_TYPE_COPY,
+      .copy =
+          {
+              .source_buffer = source_buffer,
+              .source_offset = 0,
+              .target_buffer = target_buffer,
+              .target_offset = target_offset,
+              .length = length,
+          },
+  };
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  iree_status_t status = iree_hal_create_transfer_command_buffer(
+      device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT, queue_affinity,
+      /*transfer_count=*/1, &transfer_command, &command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_execute(
+        device, queue_affinity, wait_semaphore_list, signal_semaphore_list, 1,
+        &command_buffer);
+  }
+
+  // The command buffer retains the source buffer until the copy has completed.
+  iree_hal_command_buffer_release(command_buffer);
+  return status;
+}
+
+static iree_status_t iree_hal_device_read_file_and_wait(
+    iree_hal_device_t* device, iree_hal_file_t* source_file,
+    uint64_t source_offset, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
+  if (!length) return iree_ok_status();
+
+  // Files backed by host memory can be transferred directly from the contents
+  // without any additional copies.
+  iree_byte_span_t host_contents = iree_hal_file_host_contents(source_file);
+  if (host_contents.data) {
+    return iree_hal_device_transfer_h2d(
+        device, host_contents.data + source_offset, target_buffer,
+        target_offset, length, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout());
+  }
+
+  // Stage the file contents through a bounded host buffer.
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(device);
+  iree_host_size_t chunk_size = (iree_host_size_t)iree_min(
+      length, (iree_device_size_t)IREE_HAL_QUEUE_READ_STAGING_CHUNK_SIZE);
+  uint8_t* staging_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, chunk_size,
+                                             (void**)&staging_buffer));
+  iree_status_t status = iree_ok_status();
+  for (iree_device_size_t offset = 0;
+       offset < length && iree_status_is_ok(status); offset += chunk_size) {
+    iree_host_size_t chunk_length =
+        (iree_host_size_t)iree_min(length - offset, chunk_size);
+    status = iree_hal_file_read(
+        source_file, source_offset + offset,
+        iree_make_byte_span(staging_buffer, chunk_length));
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_device_transfer_h2d(
+          device, staging_buffer, target_buffer, target_offset + offset,
+          chunk_length, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+          iree_infinite_timeout());
+    }
+  }
+  iree_allocator_free(host_allocator, staging_buffer);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_read_flags_t flags) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)length);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_device_validate_file_read(source_file, source_offset,
+                                             length));
+
+  // Host-backed files the device can import are read with a copy on the queue
+  // so that the read is ordered by the semaphores like any other queue work.
+  // Import failures are not errors: the read falls back to the blocking path.
+  iree_byte_span_t host_contents = iree_hal_file_host_contents(source_file);
+  iree_hal_buffer_t* source_buffer = NULL;
+  if (host_contents.data && length > 0 &&
+      iree_status_consume_code(iree_hal_device_import_file_range(
+          device, source_file,
+          iree_make_byte_span(host_contents.data + source_offset,
+                              (iree_host_size_t)length),
+          &source_buffer)) == IREE_STATUS_OK) {
+    iree_status_t status = iree_hal_device_queue_copy(
+        device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        source_buffer, target_buffer, target_offset, length);
+    iree_hal_buffer_release(source_buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Otherwise the read is performed synchronously once the waits are
+  // satisfied. This blocks the caller.
+  iree_status_t status = iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                                      iree_infinite_timeout());
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_read_file_and_wait(device, source_file,
+                                                source_offset, target_buffer,
+                                                target_offset, length);
+  }
+
+  // Propagate the result to any waiters so that failures are observed on the
+  // timeline in the same way as asynchronous queue failures.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+  } else {
+    iree_hal_semaphore_list_fail(signal_semaphore_list,
+                                 iree_status_clone(status));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
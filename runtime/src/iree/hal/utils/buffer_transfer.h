@@ -62,6 +62,31 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_emulated_unmap_range(
     iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
     iree_hal_buffer_mapping_t* mapping);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_device_queue_read implementations
+//===----------------------------------------------------------------------===//
+
+// Generic implementation of iree_hal_device_queue_read for devices without a
+// native storage-to-device path.
+//
+// Files backed by host memory (such as memory-mapped files) whose contents the
+// device allocator can import are read with a copy command buffer submitted
+// with the wait and signal semaphores and the call returns without blocking.
+//
+// All other reads are not queue-ordered: the wait semaphores are waited on
+// from the calling thread and the file contents are then staged through a
+// bounded host buffer in chunks before the call returns. The signal semaphores
+// are signaled once the transfer has completed or failed with the error if it
+// has not. Devices with asynchronous queues should prefer a native
+// implementation.
+IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_read_flags_t flags);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,12 +6,58 @@
 
 #include "iree/hal/utils/caching_allocator.h"
 
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
 
 // Default capacity of a pool free list when not specified by the user.
 #define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY 64
 
+// log2 of the smallest size class; all smaller allocations share the class.
+#define IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2 8
+
+//===----------------------------------------------------------------------===//
+// Size classes
+//===----------------------------------------------------------------------===//
+
+// Returns the index of the size class that |size| rounds up to.
+// Classes are powers of two subdivided into four steps such that the classes
+// between 2^e and 2^(e+1) are 1.25*2^e, 1.5*2^e, 1.75*2^e, and 2^(e+1).
+static iree_host_size_t iree_hal_caching_allocator_size_class_index(
+    iree_device_size_t size) {
+  if (size <= (1ull << IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2)) {
+    return 0;
+  }
+  const uint64_t n = (uint64_t)size - 1;
+  const int e = 63 - iree_math_count_leading_zeros_u64(n);
+  const uint64_t m = (n >> (e - 2)) & 3;
+  const int octave = e - IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2;
+  return 1 + (iree_host_size_t)octave * 4 + (iree_host_size_t)m;
+}
+
+// Returns the allocation size of the size class at |index| or 0 if the class
+// is not representable.
+static iree_device_size_t iree_hal_caching_allocator_size_class_size(
+    iree_host_size_t index) {
+  if (index == 0) {
+    return 1ull << IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2;
+  }
+  const int e =
+      IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2 + (int)((index - 1) / 4);
+  const uint64_t m = (index - 1) % 4;
+  if (e > 63 || (e == 63 && m == 3)) return 0;
+  return (iree_device_size_t)((4 + m + 1) << (e - 2));
+}
+
+// Rounds |size| up to its size class if representable and no larger than
+// |max_size|. Sizes whose class would exceed |max_size| are left unrounded.
+static iree_device_size_t iree_hal_caching_allocator_round_to_size_class(
+    iree_device_size_t size, iree_device_size_t max_size) {
+  iree_device_size_t class_size = iree_hal_caching_allocator_size_class_size(
+      iree_hal_caching_allocator_size_class_index(size));
+  return class_size >= size && class_size <= max_size ? class_size : size;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_caching_allocator_pool_t
 //===----------------------------------------------------------------------===//
@@ -29,8 +75,38 @@ void iree_hal_caching_allocator_pool_params_initialize(
   out_params->max_allocation_capacity = IREE_DEVICE_SIZE_MAX;
   out_params->max_free_allocation_count =
       IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY;
+  out_params->flags = IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_NONE;
+  out_params->max_free_age = IREE_DURATION_INFINITE;
 }
 
+// A free buffer tracked by a size class pool.
+// Entries are linked into both their size class bucket and the pool-wide LRU
+// list so that lookups and age-based trimming are both constant-time.
+typedef struct iree_hal_caching_allocator_entry_t {
+  // Retained free buffer.
+  iree_hal_buffer_t* buffer;
+  // Time the buffer was released to the pool.
+  iree_time_t release_time;
+  // Doubly-linked bucket list with the most recently released at the head.
+  // When the entry is unused bucket_next links the pool unused entry list.
+  struct iree_hal_caching_allocator_entry_t* bucket_prev;
+  struct iree_hal_caching_allocator_entry_t* bucket_next;
+  // Doubly-linked pool list with the most recently released at the head.
+  struct iree_hal_caching_allocator_entry_t* lru_prev;
+  struct iree_hal_caching_allocator_entry_t* lru_next;
+} iree_hal_caching_allocator_entry_t;
+
+// Free buffers of a single size class.
+typedef struct iree_hal_caching_allocator_bucket_t {
+  // Most recently released entry in the bucket.
+  iree_hal_caching_allocator_entry_t* head;
+  // Total number of free entries in the bucket.
+  iree_host_size_t free_count;
+  // Allocations serviced from the bucket and that missed in the bucket.
+  uint64_t hit_count;
+  uint64_t miss_count;
+} iree_hal_caching_allocator_bucket_t;
+
 // Pool of arbitrarily-sized device allocations for a particular heap.
 // This maintains a free list of blocks available for use but does not track
 // outstanding allocations.
@@ -64,6 +140,20 @@ typedef iree_alignas(
   // Total size, in bytes, of all free buffers currently in this pool.
   iree_device_size_t free_allocated_size;
 
+  // Total number of allocations serviced from a free buffer in the pool and
+  // the total number that required a new underlying allocation.
+  uint64_t hit_count;
+  uint64_t miss_count;
+
+  // Size class state when IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES is
+  // set. Entries and buckets are stored in the trailing pool storage in place
+  // of the flat free list.
+  iree_host_size_t bucket_count;
+  iree_hal_caching_allocator_bucket_t* buckets;
+  iree_hal_caching_allocator_entry_t* unused_entries;
+  iree_hal_caching_allocator_entry_t* lru_head;
+  iree_hal_caching_allocator_entry_t* lru_tail;
+
   // Flat MRU list of available buffers with max_free_allocation_count slots.
   // Sorted by ascending recency (the higher the index the more recent).
   // If we really cared about optimizing the interior removal then we'd want
@@ -76,8 +166,42 @@ typedef iree_alignas(
 static void iree_hal_caching_allocator_pool_trim(
     iree_hal_caching_allocator_pool_t* pool);
 
+static bool iree_hal_caching_allocator_pool_uses_size_classes(
+    const iree_hal_caching_allocator_pool_params_t* params) {
+  return iree_all_bits_set(params->flags,
+                           IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES);
+}
+
+// Returns the number of size class buckets required by a pool with |params|.
+static iree_host_size_t iree_hal_caching_allocator_pool_bucket_count(
+    const iree_hal_caching_allocator_pool_params_t* params) {
+  if (!iree_hal_caching_allocator_pool_uses_size_classes(params)) return 0;
+  return iree_hal_caching_allocator_size_class_index(
+             params->max_allocation_size) +
+         1;
+}
+
+// Returns the total size in bytes of a pool with |params| including its
+// trailing free list storage.
+static iree_host_size_t iree_hal_caching_allocator_pool_storage_size(
+    const iree_hal_caching_allocator_pool_params_t* params) {
+  iree_hal_caching_allocator_pool_t* pool = NULL;
+  iree_host_size_t storage_size = 0;
+  if (iree_hal_caching_allocator_pool_uses_size_classes(params)) {
+    storage_size = sizeof(iree_hal_caching_allocator_entry_t) *
+                       params->max_free_allocation_count +
+                   sizeof(iree_hal_caching_allocator_bucket_t) *
+                       iree_hal_caching_allocator_pool_bucket_count(params);
+  } else {
+    storage_size =
+        sizeof(pool->free_buffers[0]) * params->max_free_allocation_count;
+  }
+  return iree_host_align(sizeof(*pool) + storage_size, iree_max_align_t);
+}
+
 // Initializes a buffer pool in |out_pool|.
 // Buffer device storage will be allocated from |device_allocator|.
+// |out_pool| must have iree_hal_caching_allocator_pool_storage_size bytes.
 static void iree_hal_caching_allocator_pool_initialize(
     iree_hal_caching_allocator_pool_params_t params,
     iree_hal_allocator_t* device_allocator,
@@ -89,8 +213,33 @@ static void iree_hal_caching_allocator_pool_initialize(
   iree_slim_mutex_initialize(&out_pool->mutex);
   out_pool->total_allocated_size = 0;
   out_pool->free_allocated_size = 0;
+  out_pool->hit_count = 0;
+  out_pool->miss_count = 0;
+  out_pool->bucket_count = 0;
+  out_pool->buckets = NULL;
+  out_pool->unused_entries = NULL;
+  out_pool->lru_head = NULL;
+  out_pool->lru_tail = NULL;
   out_pool->free_count = 0;
 
+  if (iree_hal_caching_allocator_pool_uses_size_classes(&params)) {
+    // Entries come first in the trailing storage followed by the buckets.
+    iree_hal_caching_allocator_entry_t* entries =
+        (iree_hal_caching_allocator_entry_t*)out_pool->free_buffers;
+    for (iree_host_size_t i = 0; i < params.max_free_allocation_count; ++i) {
+      entries[i].buffer = NULL;
+      entries[i].bucket_next = out_pool->unused_entries;
+      out_pool->unused_entries = &entries[i];
+    }
+    out_pool->bucket_count =
+        iree_hal_caching_allocator_pool_bucket_count(&params);
+    out_pool->buckets =
+        (iree_hal_caching_allocator_bucket_t*)&entries
+            [params.max_free_allocation_count];
+    memset(out_pool->buckets, 0,
+           out_pool->bucket_count * sizeof(out_pool->buckets[0]));
+  }
+
   IREE_TRACE_SET_PLOT_TYPE(IREE_HAL_CACHING_ALLOCATOR_ID,
                            IREE_TRACING_PLOT_TYPE_MEMORY, /*step=*/true,
                            /*fill=*/true, /*color=*/0);
@@ -120,21 +269,62 @@ static void iree_hal_caching_allocator_pool_deinitialize(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns the bucket that buffers of |allocation_size| are stored in.
+// Sizes beyond the largest class share the last bucket.
+static iree_hal_caching_allocator_bucket_t*
+iree_hal_caching_allocator_pool_select_bucket(
+    iree_hal_caching_allocator_pool_t* pool,
+    iree_device_size_t allocation_size) {
+  iree_host_size_t index =
+      iree_hal_caching_allocator_size_class_index(allocation_size);
+  return &pool->buckets[iree_min(index, pool->bucket_count - 1)];
+}
+
+// Returns the largest size that allocations from |pool| may be rounded up to.
+// Rounding must not push an allocation past the limits of the pool or its heap.
+static iree_device_size_t iree_hal_caching_allocator_pool_max_rounded_size(
+    const iree_hal_caching_allocator_pool_t* pool) {
+  return iree_min(pool->params.max_allocation_size,
+                  pool->params.heap.max_allocation_size);
+}
+
 // Pushes |buffer| on to the pool free list as the most recently used.
 // The buffer will be retained in the list.
 //
 // Must be called with the pool mutex held.
 static void iree_hal_caching_allocator_pool_push_buffer(
-    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer) {
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer,
+    iree_time_t release_time) {
   // Retain the buffer; the caller must release it to complete the ownership
   // transfer.
   iree_hal_buffer_retain(buffer);
 
   IREE_ASSERT_LT(pool->free_count, pool->params.max_free_allocation_count);
-
-  // Add to the end of the list (the most recent).
-  iree_host_size_t i = pool->free_count++;
-  pool->free_buffers[i] = buffer;
+  ++pool->free_count;
+
+  if (pool->buckets) {
+    // Link into the head of both the bucket and pool lists (the most recent).
+    iree_hal_caching_allocator_entry_t* entry = pool->unused_entries;
+    pool->unused_entries = entry->bucket_next;
+    entry->buffer = buffer;
+    entry->release_time = release_time;
+    iree_hal_caching_allocator_bucket_t* bucket =
+        iree_hal_caching_allocator_pool_select_bucket(pool,
+                                                      buffer->allocation_size);
+    entry->bucket_prev = NULL;
+    entry->bucket_next = bucket->head;
+    if (bucket->head) bucket->head->bucket_prev = entry;
+    bucket->head = entry;
+    ++bucket->free_count;
+    entry->lru_prev = NULL;
+    entry->lru_next = pool->lru_head;
+    if (pool->lru_head) pool->lru_head->lru_prev = entry;
+    pool->lru_head = entry;
+    if (!pool->lru_tail) pool->lru_tail = entry;
+  } else {
+    // Add to the end of the list (the most recent).
+    pool->free_buffers[pool->free_count - 1] = buffer;
+  }
 
   // Track that we're now retaining unused memory.
   pool->free_allocated_size += buffer->allocation_size;
@@ -162,47 +352,144 @@ static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_buffer_at(
   return buffer;
 }
 
+// Unlinks |entry| from the size class |pool| and returns ownership of its
+// buffer.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_entry(
+    iree_hal_caching_allocator_pool_t* pool,
+    iree_hal_caching_allocator_entry_t* entry) {
+  iree_hal_buffer_t* buffer = entry->buffer;
+  iree_hal_caching_allocator_bucket_t* bucket =
+      iree_hal_caching_allocator_pool_select_bucket(pool,
+                                                    buffer->allocation_size);
+  if (entry->bucket_prev) {
+    entry->bucket_prev->bucket_next = entry->bucket_next;
+  } else {
+    bucket->head = entry->bucket_next;
+  }
+  if (entry->bucket_next) entry->bucket_next->bucket_prev = entry->bucket_prev;
+  --bucket->free_count;
+  if (entry->lru_prev) {
+    entry->lru_prev->lru_next = entry->lru_next;
+  } else {
+    pool->lru_head = entry->lru_next;
+  }
+  if (entry->lru_next) {
+    entry->lru_next->lru_prev = entry->lru_prev;
+  } else {
+    pool->lru_tail = entry->lru_prev;
+  }
+
+  entry->buffer = NULL;
+  entry->bucket_next = pool->unused_entries;
+  pool->unused_entries = entry;
+
+  --pool->free_count;
+  pool->free_allocated_size -= buffer->allocation_size;
+  IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
+                            pool->free_allocated_size);
+  return buffer;
+}
+
+// Returns true if |buffer| can service a request with |params|.
+static bool iree_hal_caching_allocator_buffer_matches(
+    iree_hal_buffer_t* buffer, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  // NOTE: we are not currently checking alignment as we don't really have it.
+  // We assume programs will use consistent alignments for a particular heap
+  // (as the heap has a min alignment).
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage) &&
+         iree_hal_buffer_allocation_size(buffer) == allocation_size;
+}
+
 // Scans the |pool| free list for a buffer matching the given requirements and
-// returns ownership.
+// returns ownership. Size class pools only scan the bucket of
+// |allocation_size|.
 //
 // Must be called with the pool mutex held.
 static iree_hal_buffer_t* iree_hal_caching_allocator_pool_find_and_take_buffer(
     iree_hal_caching_allocator_pool_t* pool,
     const iree_hal_buffer_params_t* params,
     iree_device_size_t allocation_size) {
-  // Walk backwards so that we check the most recently released buffers first.
-  for (int i = (int)pool->free_count - 1; i >= 0; --i) {
-    // NOTE: we are not currently checking alignment as we don't really have it.
-    // We assume programs will use consistent alignments for a particular heap
-    // (as the heap has a min alignment).
-    iree_hal_buffer_t* buffer = pool->free_buffers[i];
-    if (iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
-        iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
-                          params->usage) &&
-        iree_hal_buffer_allocation_size(buffer) == allocation_size) {
-      return iree_hal_caching_allocator_pool_take_buffer_at(pool, i);
+  iree_hal_buffer_t* buffer = NULL;
+  if (pool->buckets) {
+    // Bucket lists are in descending recency so the most recently released
+    // buffers are checked first.
+    iree_hal_caching_allocator_bucket_t* bucket =
+        iree_hal_caching_allocator_pool_select_bucket(pool, allocation_size);
+    for (iree_hal_caching_allocator_entry_t* entry = bucket->head; entry;
+         entry = entry->bucket_next) {
+      if (iree_hal_caching_allocator_buffer_matches(entry->buffer, params,
+                                                    allocation_size)) {
+        buffer = iree_hal_caching_allocator_pool_take_entry(pool, entry);
+        break;
+      }
+    }
+    if (buffer) {
+      ++bucket->hit_count;
+    } else {
+      ++bucket->miss_count;
     }
+  } else {
+    // Walk backwards so that we check the most recently released buffers first.
+    for (int i = (int)pool->free_count - 1; i >= 0; --i) {
+      if (iree_hal_caching_allocator_buffer_matches(pool->free_buffers[i],
+                                                    params, allocation_size)) {
+        buffer = iree_hal_caching_allocator_pool_take_buffer_at(pool, i);
+        break;
+      }
+    }
+  }
+  if (buffer) {
+    ++pool->hit_count;
+  } else {
+    ++pool->miss_count;
   }
-  return NULL;  // nothing found
+  return buffer;
 }
 
-// Trims |pool| down to at most |target_size| of available allocations.
-// The oldest allocations will be trimmed first.
+// Takes the next buffer to be trimmed from |pool| if it was released before
+// |min_release_time| or |force| is set and returns ownership.
+// Returns NULL if there are no buffers that can be trimmed.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_trim_candidate(
+    iree_hal_caching_allocator_pool_t* pool, iree_time_t min_release_time,
+    bool force) {
+  if (pool->buckets) {
+    // The tail of the LRU list is the oldest free buffer.
+    iree_hal_caching_allocator_entry_t* entry = pool->lru_tail;
+    if (!entry || (!force && entry->release_time >= min_release_time)) {
+      return NULL;
+    }
+    return iree_hal_caching_allocator_pool_take_entry(pool, entry);
+  }
+  // Flat free lists do not track release times and are only trimmed by size.
+  if (!pool->free_count || !force) return NULL;
+  return iree_hal_caching_allocator_pool_take_buffer_at(pool,
+                                                        pool->free_count - 1);
+}
+
+// Trims |pool| down to at most |target_size| of available allocations and
+// releases any allocations that were released to the pool before
+// |min_release_time|. The oldest allocations will be trimmed first.
 //
 // Thread-safe; multiple threads may concurrently access the |pool|.
-static void iree_hal_caching_allocator_pool_trim_to_size(
-    iree_hal_caching_allocator_pool_t* pool, iree_device_size_t target_size) {
+static void iree_hal_caching_allocator_pool_trim_to(
+    iree_hal_caching_allocator_pool_t* pool, iree_device_size_t target_size,
+    iree_time_t min_release_time) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)target_size);
 
   iree_slim_mutex_lock(&pool->mutex);
 
-  while (pool->free_count > 0 && pool->total_allocated_size > target_size) {
-    // Take the oldest buffer in the list.
-    iree_hal_buffer_t* dead_buffer =
-        iree_hal_caching_allocator_pool_take_buffer_at(pool,
-                                                       pool->free_count - 1);
-
+  iree_hal_buffer_t* dead_buffer = NULL;
+  while ((dead_buffer = iree_hal_caching_allocator_pool_take_trim_candidate(
+              pool, min_release_time,
+              /*force=*/pool->total_allocated_size > target_size))) {
     // NOTE: we've removed the buffer but have not subtracted the size from
     // the total yet - we want to do that only after releasing the buffer.
     // If we didn't it's possible for another thread to start an allocation
@@ -225,6 +512,16 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Trims |pool| down to at most |target_size| of available allocations.
+// The oldest allocations will be trimmed first.
+//
+// Thread-safe; multiple threads may concurrently access the |pool|.
+static void iree_hal_caching_allocator_pool_trim_to_size(
+    iree_hal_caching_allocator_pool_t* pool, iree_device_size_t target_size) {
+  iree_hal_caching_allocator_pool_trim_to(pool, target_size,
+                                          IREE_TIME_INFINITE_PAST);
+}
+
 // Releases all unused buffers in |pool| to the underlying device allocator.
 //
 // The pool mutex must not be held by the caller.
@@ -233,6 +530,26 @@ static void iree_hal_caching_allocator_pool_trim(
   iree_hal_caching_allocator_pool_trim_to_size(pool, 0);
 }
 
+// Returns the time before which free buffers in |pool| are considered aged
+// relative to |now|.
+static iree_time_t iree_hal_caching_allocator_pool_min_release_time(
+    iree_hal_caching_allocator_pool_t* pool, iree_time_t now) {
+  const iree_duration_t max_free_age = pool->params.max_free_age;
+  if (max_free_age == IREE_DURATION_INFINITE ||
+      now == IREE_TIME_INFINITE_PAST) {
+    return IREE_TIME_INFINITE_PAST;
+  }
+  return now - max_free_age;
+}
+
+// Returns the current time if |pool| needs release times for aging.
+static iree_time_t iree_hal_caching_allocator_pool_now(
+    iree_hal_caching_allocator_pool_t* pool) {
+  return pool->buckets && pool->params.max_free_age != IREE_DURATION_INFINITE
+             ? iree_time_now()
+             : IREE_TIME_INFINITE_PAST;
+}
+
 // Acquires a buffer of |allocation_size| from the |pool|.
 // The buffer will have a memory type and usage compatible with the given types.
 // Fails if the pool is empty and the underlying device fails the allocation.
@@ -277,9 +594,13 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
     return status;
   }
 
-  // Trim first before allocating so that we don't go over peak.
-  iree_hal_caching_allocator_pool_trim_to_size(
-      pool, pool->params.max_allocation_capacity);
+  // Trim first before allocating so that we don't go over peak. Buffers that
+  // have aged out are released here as well as we're already paying for an
+  // underlying allocation.
+  iree_hal_caching_allocator_pool_trim_to(
+      pool, pool->params.max_allocation_capacity,
+      iree_hal_caching_allocator_pool_min_release_time(
+          pool, iree_hal_caching_allocator_pool_now(pool)));
 
   // No existing buffer was found that could be used and we'll need to allocate
   // one. Note that we do this without holding the lock as the underlying
@@ -312,6 +633,8 @@ static void iree_hal_caching_allocator_pool_release(
   IREE_TRACE_ZONE_APPEND_VALUE(
       z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
 
+  const iree_time_t now = iree_hal_caching_allocator_pool_now(pool);
+
   // Try to add the buffer to the pool. If the pool is at capacity we'll just
   // release it back to the allocator.
   iree_slim_mutex_lock(&pool->mutex);
@@ -323,7 +646,7 @@ static void iree_hal_caching_allocator_pool_release(
   const bool under_count =
       pool->free_count + 1 <= pool->params.max_free_allocation_count;
   if (under_capacity && under_count) {
-    iree_hal_caching_allocator_pool_push_buffer(pool, buffer);
+    iree_hal_caching_allocator_pool_push_buffer(pool, buffer, now);
     buffer = NULL;
   }
 
@@ -336,8 +659,19 @@ static void iree_hal_caching_allocator_pool_release(
     pool->total_allocated_size -= allocation_size;
   }
 
+  // Release any buffers that have gone unused for too long.
+  const iree_time_t min_release_time =
+      iree_hal_caching_allocator_pool_min_release_time(pool, now);
+  const bool any_aged = pool->lru_tail &&
+                        pool->lru_tail->release_time < min_release_time;
+
   iree_slim_mutex_unlock(&pool->mutex);
 
+  if (any_aged) {
+    iree_hal_caching_allocator_pool_trim_to(pool, IREE_DEVICE_SIZE_MAX,
+                                            min_release_time);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -418,11 +752,8 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
       iree_sizeof_struct(*allocator) + pool_list_size, iree_max_align_t);
   iree_host_size_t pool_offset = total_size;
   for (iree_host_size_t i = 0; i < pool_count; ++i) {
-    iree_hal_caching_allocator_pool_t* pool = NULL;
-    total_size += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
-                            pool_params[i].max_free_allocation_count,
-        iree_max_align_t);
+    total_size +=
+        iree_hal_caching_allocator_pool_storage_size(&pool_params[i]);
   }
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
@@ -441,10 +772,7 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
   for (iree_host_size_t i = 0; i < pool_count; ++i) {
     iree_hal_caching_allocator_pool_t* pool =
         (iree_hal_caching_allocator_pool_t*)pool_ptr;
-    pool_ptr += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
-                            pool_params[i].max_free_allocation_count,
-        iree_max_align_t);
+    pool_ptr += iree_hal_caching_allocator_pool_storage_size(&pool_params[i]);
     allocator->pools[i] = pool;
     iree_hal_caching_allocator_pool_initialize(pool_params[i], device_allocator,
                                                pool);
@@ -561,12 +889,16 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t max_allocation_size_str = iree_string_view_empty();
     iree_string_view_t max_allocation_capacity_str = iree_string_view_empty();
     iree_string_view_t max_free_allocation_count_str = iree_string_view_empty();
+    iree_string_view_t mode_str = iree_string_view_empty();
+    iree_string_view_t max_free_age_str = iree_string_view_empty();
     iree_string_view_split(pool_config, ';', &max_allocation_size_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_allocation_capacity_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_free_allocation_count_str,
                            &pool_config);
+    iree_string_view_split(pool_config, ';', &mode_str, &pool_config);
+    iree_string_view_split(pool_config, ';', &max_free_age_str, &pool_config);
     max_allocation_size_str = iree_string_view_trim(max_allocation_size_str);
     if (!iree_string_view_is_empty(max_allocation_size_str) &&
         !iree_string_view_equal(max_allocation_size_str, IREE_SV("*"))) {
@@ -598,6 +930,29 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
       }
       pool_params->max_free_allocation_count = max_free_allocation_count;
     }
+    mode_str = iree_string_view_trim(mode_str);
+    if (iree_string_view_equal(mode_str, IREE_SV("size_classes"))) {
+      pool_params->flags |= IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES;
+    } else if (!iree_string_view_is_empty(mode_str) &&
+               !iree_string_view_equal(mode_str, IREE_SV("*")) &&
+               !iree_string_view_equal(mode_str, IREE_SV("flat"))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid pool mode '%.*s'; expected 'flat' or "
+                              "'size_classes'",
+                              (int)mode_str.size, mode_str.data);
+    }
+    max_free_age_str = iree_string_view_trim(max_free_age_str);
+    if (!iree_string_view_is_empty(max_free_age_str) &&
+        !iree_string_view_equal(max_free_age_str, IREE_SV("*"))) {
+      uint32_t max_free_age_ms = 0;
+      if (!iree_string_view_atoi_uint32(max_free_age_str, &max_free_age_ms)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid max free age '%.*s'",
+                                (int)max_free_age_str.size,
+                                max_free_age_str.data);
+      }
+      pool_params->max_free_age = (iree_duration_t)max_free_age_ms * 1000000;
+    }
   } while (!iree_string_view_is_empty(config_pairs));
   return iree_hal_caching_allocator_create_with_pools(
       pool_count, pool_params_storage, device_allocator, host_allocator,
@@ -647,6 +1002,50 @@ static void iree_hal_caching_allocator_query_statistics(
       iree_hal_caching_allocator_cast(base_allocator);
   iree_hal_allocator_query_statistics(allocator->device_allocator,
                                       out_statistics);
+  IREE_STATISTICS({
+    for (iree_host_size_t i = 0; i < allocator->pool_count; ++i) {
+      iree_hal_caching_allocator_pool_t* pool = allocator->pools[i];
+      iree_slim_mutex_lock(&pool->mutex);
+      out_statistics->cache_hit_count += pool->hit_count;
+      out_statistics->cache_miss_count += pool->miss_count;
+      out_statistics->cache_bytes_free += pool->free_allocated_size;
+      iree_slim_mutex_unlock(&pool->mutex);
+    }
+  });
+}
+
+iree_status_t iree_hal_caching_allocator_query_bucket_statistics(
+    iree_hal_allocator_t* base_allocator, iree_host_size_t pool_index,
+    iree_host_size_t capacity,
+    iree_hal_caching_allocator_bucket_statistics_t* out_buckets,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(!capacity || out_buckets);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_hal_caching_allocator_t* allocator =
+      iree_hal_caching_allocator_cast(base_allocator);
+  if (pool_index >= allocator->pool_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "pool index %" PRIhsz " out of range (%" PRIhsz
+                            " pools)",
+                            pool_index, allocator->pool_count);
+  }
+  iree_hal_caching_allocator_pool_t* pool = allocator->pools[pool_index];
+  *out_count = pool->bucket_count;
+  if (capacity < pool->bucket_count) {
+    // NOTE: lightweight as this is hit in normal pre-sizing usage.
+    return iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  }
+  iree_slim_mutex_lock(&pool->mutex);
+  for (iree_host_size_t i = 0; i < pool->bucket_count; ++i) {
+    const iree_hal_caching_allocator_bucket_t* bucket = &pool->buckets[i];
+    out_buckets[i].size_class = iree_hal_caching_allocator_size_class_size(i);
+    out_buckets[i].hit_count = bucket->hit_count;
+    out_buckets[i].miss_count = bucket->miss_count;
+    out_buckets[i].free_count = bucket->free_count;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
@@ -662,19 +1061,6 @@ static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
                                                capacity, heaps, out_count);
 }
 
-static iree_hal_buffer_compatibility_t
-iree_hal_caching_allocator_query_buffer_compatibility(
-    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
-    iree_hal_buffer_params_t* IREE_RESTRICT params,
-    iree_device_size_t* IREE_RESTRICT allocation_size) {
-  // Defer to the base allocator.
-  iree_hal_caching_allocator_t* allocator =
-      iree_hal_caching_allocator_cast(base_allocator);
-  return iree_hal_allocator_query_buffer_compatibility(
-      allocator->device_allocator, *params, *allocation_size, params,
-      allocation_size);
-}
-
 static iree_hal_caching_allocator_pool_t* iree_hal_caching_allocator_find_pool(
     iree_hal_caching_allocator_t* allocator, iree_hal_memory_type_t type,
     iree_hal_buffer_usage_t allowed_usage) {
@@ -689,6 +1075,34 @@ static iree_hal_caching_allocator_pool_t* iree_hal_caching_allocator_find_pool(
   return NULL;
 }
 
+static iree_hal_buffer_compatibility_t
+iree_hal_caching_allocator_query_buffer_compatibility(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t* IREE_RESTRICT allocation_size) {
+  // Defer to the base allocator.
+  iree_hal_caching_allocator_t* allocator =
+      iree_hal_caching_allocator_cast(base_allocator);
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_allocator_query_buffer_compatibility(
+          allocator->device_allocator, *params, *allocation_size, params,
+          allocation_size);
+
+  // Size class pools will round up the allocation size; report that so users
+  // can make use of the additional space.
+  iree_hal_caching_allocator_pool_t* pool =
+      iree_hal_caching_allocator_find_pool(allocator, params->type,
+                                           params->usage);
+  if (pool && pool->buckets &&
+      *allocation_size <= pool->params.max_allocation_size) {
+    *allocation_size = iree_hal_caching_allocator_round_to_size_class(
+        *allocation_size,
+        iree_hal_caching_allocator_pool_max_rounded_size(pool));
+  }
+
+  return compatibility;
+}
+
 static iree_status_t iree_hal_caching_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -746,13 +1160,21 @@ static iree_status_t iree_hal_caching_allocator_allocate_buffer(
   iree_hal_caching_allocator_pool_t* pool =
       iree_hal_caching_allocator_find_pool(allocator, compat_params.type,
                                            compat_params.usage);
-  if (!pool) {
+  if (!pool || allocation_size > pool->params.max_allocation_size) {
     // Fallback to the underlying allocator.
     return iree_hal_allocator_allocate_buffer(allocator->device_allocator,
                                               compat_params, allocation_size,
                                               initial_data, out_buffer);
   }
 
+  // Size class pools round up so that allocations of similar sizes can reuse
+  // the same buffers.
+  if (pool->buckets) {
+    allocation_size = iree_hal_caching_allocator_round_to_size_class(
+        allocation_size,
+        iree_hal_caching_allocator_pool_max_rounded_size(pool));
+  }
+
   // Acquire the buffer from the pool.
   IREE_RETURN_IF_ERROR(iree_hal_caching_allocator_pool_acquire(
       pool, &compat_params, allocation_size, initial_data, out_buffer));
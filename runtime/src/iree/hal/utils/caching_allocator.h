@@ -26,6 +26,20 @@ extern "C" {
 // manipulated from multiple threads.
 typedef struct iree_hal_caching_allocator_t iree_hal_caching_allocator_t;
 
+// Controls how a pool organizes its free allocations.
+enum iree_hal_caching_allocator_pool_flag_bits_t {
+  IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_NONE = 0u,
+
+  // Buckets free allocations by size class instead of keeping a single flat
+  // free list. Allocation sizes are rounded up to the nearest class where
+  // classes are powers of two subdivided into quarter steps (1, 1.25, 1.5,
+  // 1.75, 2, 2.5, ...) and lookup is a constant-time bucket index. Rounding
+  // wastes at most 25% of each allocation but allows programs with many
+  // distinct (dynamically shaped) sizes to reuse allocations of similar size.
+  IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES = 1u << 0,
+};
+typedef uint32_t iree_hal_caching_allocator_pool_flags_t;
+
 // Parameters used to configure an iree_hal_caching_allocator_t pool.
 // These cannot be changed once the allocator has been created.
 typedef struct iree_hal_caching_allocator_pool_params_t {
@@ -49,6 +63,16 @@ typedef struct iree_hal_caching_allocator_pool_params_t {
   // This is used to allocate storage for the free list and should be reasonably
   // bounded (~64-1024).
   iree_host_size_t max_free_allocation_count;
+
+  // Flags controlling the pool organization.
+  iree_hal_caching_allocator_pool_flags_t flags;
+
+  // Maximum duration a free allocation will be retained without being reused.
+  // Allocations that remain unused for longer are released back to the
+  // underlying allocator, least-recently-used first, as the pool is used.
+  // IREE_DURATION_INFINITE retains allocations until explicitly trimmed.
+  // Only used with IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES.
+  iree_duration_t max_free_age;
 } iree_hal_caching_allocator_pool_params_t;
 
 // Initializes |out_params| to the default values using |heap| for storage.
@@ -100,15 +124,47 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
 // than 100MB can be retained. Wildcards can be used to indicate max values or
 // defaults.
 //
+// An optional pool mode of `flat` (default) or `size_classes` and a maximum
+// age in milliseconds that free allocations will be retained can follow the
+// limits.
+//
 // Expected form:
-//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count
+//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count[;mode[;max_free_age_ms]]
 // Example:
 //   device_local=1gib;1gib;8
 //   host_local=*;*;32
+//   device_local=*;4gib;1024;size_classes;5000
 iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Statistics for a single size class bucket of a caching allocator pool.
+typedef struct iree_hal_caching_allocator_bucket_statistics_t {
+  // Allocation size in bytes of buffers in the bucket.
+  iree_device_size_t size_class;
+  // Total number of allocations serviced from a free buffer in the bucket.
+  uint64_t hit_count;
+  // Total number of allocations that required a new underlying allocation.
+  uint64_t miss_count;
+  // Current number of free buffers retained in the bucket.
+  iree_host_size_t free_count;
+} iree_hal_caching_allocator_bucket_statistics_t;
+
+// Queries per-bucket statistics of the pool at |pool_index| in |allocator|.
+// Aggregate hit/miss counts across all pools are reported by
+// iree_hal_allocator_query_statistics.
+//
+// Returns the total bucket count in |out_count| and if |capacity| is large
+// enough will fill |out_buckets| with the bucket statistics in ascending size
+// class order. Pools without IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES
+// have no buckets.
+// Returns IREE_STATUS_OUT_OF_RANGE if |capacity| is too small.
+iree_status_t iree_hal_caching_allocator_query_bucket_statistics(
+    iree_hal_allocator_t* allocator, iree_host_size_t pool_index,
+    iree_host_size_t capacity,
+    iree_hal_caching_allocator_bucket_statistics_t* out_buckets,
+    iree_host_size_t* out_count);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,252 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/caching_allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &heap_allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(heap_allocator_); }
+
+  // Creates a caching allocator with a single pool over the heap. A
+  // |max_allocation_size| of 0 uses the heap limit.
+  iree_hal_allocator_t* CreateAllocator(
+      iree_hal_caching_allocator_pool_flags_t flags,
+      iree_host_size_t max_free_allocation_count, iree_duration_t max_free_age,
+      iree_device_size_t max_allocation_size = 0) {
+    iree_hal_allocator_memory_heap_t heap;
+    iree_host_size_t heap_count = 0;
+    IREE_CHECK_OK(iree_hal_allocator_query_memory_heaps(heap_allocator_, 1,
+                                                        &heap, &heap_count));
+    iree_hal_caching_allocator_pool_params_t params;
+    iree_hal_caching_allocator_pool_params_initialize(heap, &params);
+    params.max_free_allocation_count = max_free_allocation_count;
+    params.flags = flags;
+    params.max_free_age = max_free_age;
+    if (max_allocation_size) params.max_allocation_size = max_allocation_size;
+    iree_hal_allocator_t* allocator = NULL;
+    IREE_CHECK_OK(iree_hal_caching_allocator_create_with_pools(
+        1, &params, heap_allocator_, iree_allocator_system(), &allocator));
+    return allocator;
+  }
+
+  static iree_hal_buffer_t* Allocate(iree_hal_allocator_t* allocator,
+                                     iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator, params, size, iree_const_byte_span_empty(), &buffer));
+    return buffer;
+  }
+
+  static std::vector<iree_hal_caching_allocator_bucket_statistics_t>
+  QueryBuckets(iree_hal_allocator_t* allocator) {
+    iree_host_size_t count = 0;
+    iree_status_t status = iree_hal_caching_allocator_query_bucket_statistics(
+        allocator, 0, 0, NULL, &count);
+    if (count) {
+      EXPECT_TRUE(iree_status_is_out_of_range(status));
+    }
+    iree_status_ignore(status);
+    std::vector<iree_hal_caching_allocator_bucket_statistics_t> buckets(count);
+    IREE_CHECK_OK(iree_hal_caching_allocator_query_bucket_statistics(
+        allocator, 0, buckets.size(), buckets.data(), &count));
+    return buckets;
+  }
+
+  iree_hal_allocator_t* heap_allocator_ = NULL;
+};
+
+TEST_F(CachingAllocatorTest, FlatReuse) {
+  iree_hal_allocator_t* allocator =
+      CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_NONE, 8,
+                      IREE_DURATION_INFINITE);
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1000);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer0), 1000);
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 1000);
+  EXPECT_EQ(buffer1, buffer0);
+  iree_hal_buffer_release(buffer1);
+  EXPECT_TRUE(QueryBuckets(allocator).empty());
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, SizeClassRounding) {
+  iree_hal_allocator_t* allocator =
+      CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES, 8,
+                      IREE_DURATION_INFINITE);
+  struct {
+    iree_device_size_t size;
+    iree_device_size_t expected_size;
+  } cases[] = {
+      {1, 256},     {256, 256},   {257, 320},   {320, 320},
+      {321, 384},   {448, 448},   {449, 512},   {513, 640},
+      {4096, 4096}, {4097, 5120}, {6000, 6144}, {7169, 8192},
+  };
+  for (const auto& c : cases) {
+    iree_hal_buffer_t* buffer = Allocate(allocator, c.size);
+    EXPECT_EQ(iree_hal_buffer_allocation_size(buffer), c.expected_size)
+        << "size " << c.size;
+    iree_hal_buffer_release(buffer);
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+// Sizes whose class would exceed the pool limit are not rounded up, both when
+// allocating and when reporting compatibility.
+TEST_F(CachingAllocatorTest, SizeClassRoundingClampedToMaxSize) {
+  iree_hal_allocator_t* allocator = CreateAllocator(
+      IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES, 8,
+      IREE_DURATION_INFINITE, /*max_allocation_size=*/5000);
+  struct {
+    iree_device_size_t size;
+    iree_device_size_t expected_size;
+  } cases[] = {
+      {4000, 4096},
+      {4097, 4097},
+      {5000, 5000},
+  };
+  for (const auto& c : cases) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_device_size_t allocation_size = 0;
+    EXPECT_TRUE(iree_all_bits_set(
+        iree_hal_allocator_query_buffer_compatibility(
+            allocator, params, c.size, &params, &allocation_size),
+        IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE));
+    EXPECT_EQ(allocation_size, c.expected_size) << "size " << c.size;
+    iree_hal_buffer_t* buffer = Allocate(allocator, c.size);
+    EXPECT_EQ(iree_hal_buffer_allocation_size(buffer), c.expected_size)
+        << "size " << c.size;
+    iree_hal_buffer_release(buffer);
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, SizeClassReuseAcrossSizes) {
+  iree_hal_allocator_t* allocator =
+      CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES, 8,
+                      IREE_DURATION_INFINITE);
+
+  // Distinct sizes within the same class reuse the same buffer.
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1100);
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 1200);
+  EXPECT_EQ(buffer1, buffer0);
+
+  // A size in another class misses.
+  iree_hal_buffer_t* buffer2 = Allocate(allocator, 2000);
+  EXPECT_NE(buffer2, buffer0);
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer2);
+
+  auto buckets = QueryBuckets(allocator);
+  uint64_t total_hits = 0, total_misses = 0;
+  iree_host_size_t total_free = 0;
+  for (const auto& bucket : buckets) {
+    total_hits += bucket.hit_count;
+    total_misses += bucket.miss_count;
+    total_free += bucket.free_count;
+    if (bucket.size_class == 1280) {
+      EXPECT_EQ(bucket.hit_count, 1);
+      EXPECT_EQ(bucket.miss_count, 1);
+      EXPECT_EQ(bucket.free_count, 1);
+    }
+  }
+  EXPECT_EQ(total_hits, 1);
+  EXPECT_EQ(total_misses, 2);
+  EXPECT_EQ(total_free, 2);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.cache_hit_count, 1);
+  EXPECT_EQ(statistics.cache_miss_count, 2);
+  EXPECT_EQ(statistics.cache_bytes_free, 1280 + 2048);
+#endif  // IREE_STATISTICS_ENABLE
+
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator));
+  for (const auto& bucket : QueryBuckets(allocator)) {
+    EXPECT_EQ(bucket.free_count, 0);
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, SizeClassFreeCountLimit) {
+  iree_hal_allocator_t* allocator =
+      CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES, 2,
+                      IREE_DURATION_INFINITE);
+  iree_hal_buffer_t* buffers[3] = {
+      Allocate(allocator, 512),
+      Allocate(allocator, 512),
+      Allocate(allocator, 512),
+  };
+  for (auto* buffer : buffers) iree_hal_buffer_release(buffer);
+  iree_host_size_t total_free = 0;
+  for (const auto& bucket : QueryBuckets(allocator)) {
+    total_free += bucket.free_count;
+  }
+  EXPECT_EQ(total_free, 2);
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, SizeClassAgedTrim) {
+  // Any free buffer is immediately considered aged.
+  iree_hal_allocator_t* allocator = CreateAllocator(
+      IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES, 8, /*max_free_age=*/0);
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 512);
+  iree_hal_buffer_release(buffer0);
+
+  // Using the pool again after the age has elapsed trims the older buffer.
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 8192);
+  iree_wait_until(iree_time_now() + 1000000);
+  iree_hal_buffer_release(buffer1);
+  for (const auto& bucket : QueryBuckets(allocator)) {
+    if (bucket.size_class == 512) {
+      EXPECT_EQ(bucket.free_count, 0);
+    }
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, SpecParsing) {
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_caching_allocator_create_from_spec(
+      IREE_SV("*=*;*;16;size_classes;100"), heap_allocator_,
+      iree_allocator_system(), &allocator));
+  EXPECT_FALSE(QueryBuckets(allocator).empty());
+  iree_hal_allocator_release(allocator);
+
+  iree_status_t status = iree_hal_caching_allocator_create_from_spec(
+      IREE_SV("*=*;*;16;bogus"), heap_allocator_, iree_allocator_system(),
+      &allocator);
+  EXPECT_TRUE(iree_status_is_invalid_argument(status));
+  iree_status_ignore(status);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -58,6 +58,12 @@ typedef iree_status_t (*iree_hal_cmd_apply_fn_t)(
     iree_hal_buffer_binding_table_t binding_table,
     iree_hal_cmd_header_t* cmd_header);
 
+// A command in a replay plan with its apply function already resolved.
+typedef struct iree_hal_cmd_plan_step_t {
+  iree_hal_cmd_apply_fn_t apply;
+  iree_hal_cmd_header_t* cmd;
+} iree_hal_cmd_plan_step_t;
+
 //===----------------------------------------------------------------------===//
 // Command list allocation and storage
 //===----------------------------------------------------------------------===//
@@ -72,6 +78,12 @@ typedef struct iree_hal_cmd_list_t {
   iree_hal_cmd_header_t* head;
   // Tail of the command list (may be head).
   iree_hal_cmd_header_t* tail;
+  // Total number of commands in the list.
+  iree_host_size_t count;
+
+  // Replay plan with one step per command in list order or NULL if the list
+  // has not been compiled. Allocated from |arena| and reset with the list.
+  iree_hal_cmd_plan_step_t* plan;
 } iree_hal_cmd_list_t;
 
 // Initializes a new command list that allocates from the given |block_pool|.
@@ -81,6 +93,8 @@ static void iree_hal_cmd_list_initialize(iree_arena_block_pool_t* block_pool,
   iree_arena_initialize(block_pool, &out_cmd_list->arena);
   out_cmd_list->head = NULL;
   out_cmd_list->tail = NULL;
+  out_cmd_list->count = 0;
+  out_cmd_list->plan = NULL;
 }
 
 // Returns true if the |cmd_list| is empty.
@@ -97,6 +111,8 @@ static void iree_hal_cmd_list_reset(iree_hal_cmd_list_t* cmd_list) {
   iree_arena_reset(&cmd_list->arena);
   cmd_list->head = NULL;
   cmd_list->tail = NULL;
+  cmd_list->count = 0;
+  cmd_list->plan = NULL;
 }
 
 // Deinitializes the command list, preparing for destruction.
@@ -120,6 +136,7 @@ static iree_status_t iree_hal_cmd_list_append_command(
     cmd_list->tail->next = header;
   }
   cmd_list->tail = header;
+  ++cmd_list->count;
   *out_cmd = header;
   return iree_ok_status();
 }
@@ -156,6 +173,8 @@ typedef struct iree_hal_deferred_command_buffer_t {
 static const iree_hal_command_buffer_vtable_t
     iree_hal_deferred_command_buffer_vtable;
 
+static iree_status_t iree_hal_cmd_list_compile(iree_hal_cmd_list_t* cmd_list);
+
 static iree_hal_deferred_command_buffer_t*
 iree_hal_deferred_command_buffer_cast(iree_hal_command_buffer_t* base_value) {
   IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_deferred_command_buffer_vtable);
@@ -239,7 +258,15 @@ static iree_status_t iree_hal_deferred_command_buffer_begin(
 
 static iree_status_t iree_hal_deferred_command_buffer_end(
     iree_hal_command_buffer_t* base_command_buffer) {
-  return iree_ok_status();
+  iree_hal_deferred_command_buffer_t* command_buffer =
+      iree_hal_deferred_command_buffer_cast(base_command_buffer);
+  // One-shot command buffers are replayed once and walking the list directly is
+  // cheaper than compiling a plan that is immediately discarded.
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_ok_status();
+  }
+  return iree_hal_cmd_list_compile(&command_buffer->cmd_list);
 }
 
 //===----------------------------------------------------------------------===//
@@ -702,6 +729,8 @@ typedef struct iree_hal_cmd_push_descriptor_set_t {
   iree_hal_cmd_header_t header;
   iree_hal_pipeline_layout_t* pipeline_layout;
   uint32_t set;
+  // Number of bindings resolved against the binding table during replay.
+  iree_host_size_t indirect_binding_count;
   iree_host_size_t binding_count;
   iree_hal_descriptor_set_binding_t bindings[];
 } iree_hal_cmd_push_descriptor_set_t;
@@ -722,25 +751,61 @@ static iree_status_t iree_hal_deferred_command_buffer_push_descriptor_set(
       sizeof(*cmd) + sizeof(cmd->bindings[0]) * binding_count, (void**)&cmd));
   cmd->pipeline_layout = pipeline_layout;
   cmd->set = set;
+  cmd->indirect_binding_count = 0;
   cmd->binding_count = binding_count;
+  memcpy(cmd->bindings, bindings, sizeof(cmd->bindings[0]) * binding_count);
   for (iree_host_size_t i = 0; i < binding_count; ++i) {
-    iree_hal_descriptor_set_binding_t binding = bindings[i];
-    cmd->bindings[i] = binding;
-    if (binding.buffer) {
-      IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-          command_buffer->resource_set, 1, &binding.buffer));
-    }
+    cmd->indirect_binding_count += bindings[i].buffer == NULL;
   }
-  return iree_ok_status();
+  return iree_hal_resource_set_insert_strided(
+      command_buffer->resource_set, binding_count, bindings,
+      offsetof(iree_hal_descriptor_set_binding_t, buffer), sizeof(*bindings));
 }
 
 static iree_status_t iree_hal_deferred_command_buffer_apply_push_descriptor_set(
     iree_hal_command_buffer_t* target_command_buffer,
     iree_hal_buffer_binding_table_t binding_table,
     const iree_hal_cmd_push_descriptor_set_t* cmd) {
+  // Fast path for when all bindings are direct.
+  if (cmd->indirect_binding_count == 0) {
+    return iree_hal_command_buffer_push_descriptor_set(
+        target_command_buffer, cmd->pipeline_layout, cmd->set,
+        cmd->binding_count, cmd->bindings);
+  }
+
+  // Resolve indirect bindings against the binding table. Offsets are relative
+  // to the binding table entry and whole-buffer lengths take the entry length.
+  iree_hal_descriptor_set_binding_t* bindings =
+      (iree_hal_descriptor_set_binding_t*)iree_alloca(
+          cmd->binding_count * sizeof(iree_hal_descriptor_set_binding_t));
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    iree_hal_descriptor_set_binding_t binding = cmd->bindings[i];
+    if (!binding.buffer) {
+      if (IREE_UNLIKELY(binding.buffer_slot >= binding_table.count)) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "indirect binding %" PRIhsz
+                                " references slot %u but the binding table "
+                                "only has %" PRIhsz " entries",
+                                i, binding.buffer_slot, binding_table.count);
+      }
+      const iree_hal_buffer_binding_t* table_binding =
+          &binding_table.bindings[binding.buffer_slot];
+      if (IREE_UNLIKELY(!table_binding->buffer)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "binding table slot %u has no buffer",
+                                binding.buffer_slot);
+      }
+      binding.buffer = table_binding->buffer;
+      binding.offset += table_binding->offset;
+      if (binding.length == IREE_WHOLE_BUFFER) {
+        binding.length = table_binding->length;
+      }
+    }
+    bindings[i] = binding;
+  }
   return iree_hal_command_buffer_push_descriptor_set(
-      target_command_buffer, cmd->pipeline_layout, cmd->set, cmd->binding_count,
-      cmd->bindings);
+      target_command_buffer, cmd->pipeline_layout, cmd->set,
+      cmd->binding_count, bindings);
 }
 
 //===----------------------------------------------------------------------===//
@@ -912,6 +977,52 @@ static const iree_hal_cmd_apply_fn_t iree_hal_cmd_apply_table[] = {
         iree_hal_deferred_command_buffer_apply_execute_commands,
 };
 
+// Compiles |cmd_list| into a replay plan stored in the list arena.
+// The plan is a dense array of steps with the apply function of each command
+// resolved so that replays do not chase the list across arena blocks or
+// dispatch on the command type. Commands must not be appended after compiling.
+static iree_status_t iree_hal_cmd_list_compile(iree_hal_cmd_list_t* cmd_list) {
+  if (cmd_list->count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, cmd_list->count);
+  iree_hal_cmd_plan_step_t* plan = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&cmd_list->arena,
+                              cmd_list->count * sizeof(*plan), (void**)&plan));
+  iree_host_size_t step_count = 0;
+  for (iree_hal_cmd_header_t* cmd = cmd_list->head; cmd != NULL;
+       cmd = cmd->next) {
+    plan[step_count].apply = iree_hal_cmd_apply_table[cmd->type];
+    plan[step_count].cmd = cmd;
+    ++step_count;
+  }
+  IREE_ASSERT_EQ(step_count, cmd_list->count);
+  cmd_list->plan = plan;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Applies all commands in |cmd_list| to |target_command_buffer| in order.
+static iree_status_t iree_hal_cmd_list_apply(
+    const iree_hal_cmd_list_t* cmd_list,
+    iree_hal_command_buffer_t* target_command_buffer,
+    iree_hal_buffer_binding_table_t binding_table) {
+  if (cmd_list->plan) {
+    const iree_hal_cmd_plan_step_t* plan = cmd_list->plan;
+    for (iree_host_size_t i = 0; i < cmd_list->count; ++i) {
+      IREE_RETURN_IF_ERROR(
+          plan[i].apply(target_command_buffer, binding_table, plan[i].cmd));
+    }
+    return iree_ok_status();
+  }
+  for (iree_hal_cmd_header_t* cmd = cmd_list->head; cmd != NULL;
+       cmd = cmd->next) {
+    IREE_RETURN_IF_ERROR(iree_hal_cmd_apply_table[cmd->type](
+        target_command_buffer, binding_table, cmd));
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* target_command_buffer,
@@ -925,12 +1036,8 @@ IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply(
 
   iree_status_t status = iree_hal_command_buffer_begin(target_command_buffer);
   if (iree_status_is_ok(status)) {
-    for (iree_hal_cmd_header_t* cmd = cmd_list->head; cmd != NULL;
-         cmd = cmd->next) {
-      status = iree_hal_cmd_apply_table[cmd->type](target_command_buffer,
-                                                   binding_table, cmd);
-      if (!iree_status_is_ok(status)) break;
-    }
+    status =
+        iree_hal_cmd_list_apply(cmd_list, target_command_buffer, binding_table);
   }
   if (iree_status_is_ok(status)) {
     status = iree_hal_command_buffer_end(target_command_buffer);
@@ -950,6 +1057,20 @@ IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply_inline(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_command_buffer_t* target_command_buffer,
+    iree_hal_buffer_binding_table_t binding_table) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_deferred_command_buffer_t* command_buffer =
+      (iree_hal_deferred_command_buffer_t*)iree_hal_command_buffer_dyn_cast(
+          base_command_buffer, &iree_hal_deferred_command_buffer_vtable);
+  iree_status_t status = iree_hal_cmd_list_apply(
+      &command_buffer->cmd_list, target_command_buffer, binding_table);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static const iree_hal_command_buffer_vtable_t
     iree_hal_deferred_command_buffer_vtable = {
         .destroy = iree_hal_deferred_command_buffer_destroy,
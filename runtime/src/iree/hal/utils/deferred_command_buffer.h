@@ -40,7 +40,10 @@ typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
 //
 // After recording iree_hal_deferred_command_buffer_apply can be used to replay
 // the sequence of commands against a target command buffer implementation.
-// The command buffer can be replayed multiple times.
+// The command buffer can be replayed multiple times. Command buffers not
+// recorded with IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT compile their commands
+// into a replay plan when recording ends so that each replay is a linear walk
+// over pre-resolved commands.
 IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_create(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
@@ -61,6 +64,17 @@ IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply(
     iree_hal_command_buffer_t* target_command_buffer,
     iree_hal_buffer_binding_table_t binding_table);
 
+// Replays a recorded |command_buffer| into a |target_command_buffer| that is
+// already recording. Unlike iree_hal_deferred_command_buffer_apply the target
+// is not begun or ended and the commands are not reset if one-shot. This can be
+// used to implement iree_hal_command_buffer_execute_commands on targets that
+// cannot natively nest command buffers. The provided |binding_table| will be
+// used for indirect bindings referenced in the command buffer.
+IREE_API_EXPORT iree_status_t iree_hal_deferred_command_buffer_apply_inline(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_command_buffer_t* target_command_buffer,
+    iree_hal_buffer_binding_table_t binding_table);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,316 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/deferred_command_buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+using ::testing::ElementsAre;
+
+//===----------------------------------------------------------------------===//
+// Test resources
+//===----------------------------------------------------------------------===//
+
+// Stand-in for pipeline layouts, buffers, and executables. The deferred command
+// buffer only retains and forwards them so no type-specific state is needed.
+typedef struct iree_hal_test_resource_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+} iree_hal_test_resource_t;
+
+typedef struct iree_hal_test_resource_vtable_t {
+  void(IREE_API_PTR* destroy)(iree_hal_test_resource_t* resource);
+} iree_hal_test_resource_vtable_t;
+IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_test_resource_vtable_t);
+
+extern const iree_hal_test_resource_vtable_t iree_hal_test_resource_vtable;
+
+static iree_status_t iree_hal_test_resource_create(
+    iree_allocator_t host_allocator, iree_hal_resource_t** out_resource) {
+  iree_hal_test_resource_t* test_resource = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*test_resource), (void**)&test_resource));
+  iree_hal_resource_initialize(&iree_hal_test_resource_vtable,
+                               &test_resource->resource);
+  test_resource->host_allocator = host_allocator;
+  *out_resource = (iree_hal_resource_t*)test_resource;
+  return iree_ok_status();
+}
+
+static void iree_hal_test_resource_destroy(iree_hal_test_resource_t* resource) {
+  iree_allocator_free(resource->host_allocator, resource);
+}
+
+const iree_hal_test_resource_vtable_t iree_hal_test_resource_vtable = {
+    /*.destroy=*/iree_hal_test_resource_destroy,
+};
+
+//===----------------------------------------------------------------------===//
+// Recording target command buffer
+//===----------------------------------------------------------------------===//
+
+// Target command buffer that logs each command it receives.
+typedef struct iree_hal_recording_command_buffer_t {
+  iree_hal_command_buffer_t base;
+  std::vector<std::string>* log;
+} iree_hal_recording_command_buffer_t;
+
+static iree_hal_recording_command_buffer_t* iree_hal_recording_command_buffer(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  return (iree_hal_recording_command_buffer_t*)base_command_buffer;
+}
+
+static void iree_hal_recording_command_buffer_destroy(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  delete iree_hal_recording_command_buffer(base_command_buffer);
+}
+
+static iree_status_t iree_hal_recording_command_buffer_begin(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_recording_command_buffer(base_command_buffer)->log->push_back(
+      "begin");
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_recording_command_buffer_end(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_recording_command_buffer(base_command_buffer)->log->push_back("end");
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_recording_command_buffer_push_constants(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, iree_host_size_t offset,
+    const void* values, iree_host_size_t values_length) {
+  iree_hal_recording_command_buffer(base_command_buffer)
+      ->log->push_back("push_constants " + std::to_string(offset) + " " +
+                       std::to_string(((const uint32_t*)values)[0]));
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_recording_command_buffer_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  std::string entry = "push_descriptor_set " + std::to_string(set);
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    entry += bindings[i].buffer ? " buffer" : " null";
+    entry += "+" + std::to_string(bindings[i].offset);
+  }
+  iree_hal_recording_command_buffer(base_command_buffer)->log->push_back(entry);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_recording_command_buffer_dispatch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_hal_recording_command_buffer(base_command_buffer)
+      ->log->push_back("dispatch " + std::to_string(entry_point) + " " +
+                       std::to_string(workgroup_x) + "x" +
+                       std::to_string(workgroup_y) + "x" +
+                       std::to_string(workgroup_z));
+  return iree_ok_status();
+}
+
+static iree_hal_command_buffer_vtable_t
+iree_hal_recording_command_buffer_vtable() {
+  iree_hal_command_buffer_vtable_t vtable = {};
+  vtable.destroy = iree_hal_recording_command_buffer_destroy;
+  vtable.begin = iree_hal_recording_command_buffer_begin;
+  vtable.end = iree_hal_recording_command_buffer_end;
+  vtable.push_constants = iree_hal_recording_command_buffer_push_constants;
+  vtable.push_descriptor_set =
+      iree_hal_recording_command_buffer_push_descriptor_set;
+  vtable.dispatch = iree_hal_recording_command_buffer_dispatch;
+  return vtable;
+}
+
+static const iree_hal_command_buffer_vtable_t
+    kRecordingCommandBufferVTable = iree_hal_recording_command_buffer_vtable();
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+struct DeferredCommandBufferTest : public ::testing::Test {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_arena_block_pool_t block_pool;
+  iree_hal_pipeline_layout_t* pipeline_layout = NULL;
+  iree_hal_buffer_t* buffer = NULL;
+  iree_hal_executable_t* executable = NULL;
+  std::vector<std::string> log;
+  iree_hal_command_buffer_t* target_command_buffer = NULL;
+
+  void SetUp() override {
+    memset(&block_pool, 0, sizeof(block_pool));
+    iree_arena_block_pool_initialize(256, host_allocator, &block_pool);
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        host_allocator, (iree_hal_resource_t**)&pipeline_layout));
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        host_allocator, (iree_hal_resource_t**)&buffer));
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        host_allocator, (iree_hal_resource_t**)&executable));
+
+    auto* recording = new iree_hal_recording_command_buffer_t();
+    iree_hal_command_buffer_initialize(
+        /*device=*/NULL, IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+        IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &kRecordingCommandBufferVTable,
+        &recording->base);
+    recording->log = &log;
+    target_command_buffer = &recording->base;
+  }
+
+  void TearDown() override {
+    iree_hal_command_buffer_release(target_command_buffer);
+    iree_hal_resource_release(executable);
+    iree_hal_resource_release(buffer);
+    iree_hal_resource_release(pipeline_layout);
+    iree_arena_block_pool_deinitialize(&block_pool);
+  }
+
+  iree_hal_command_buffer_t* CreateDeferred(
+      iree_hal_command_buffer_mode_t mode) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_CHECK_OK(iree_hal_deferred_command_buffer_create(
+        /*device=*/NULL, mode | IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+        IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/4, &block_pool,
+        host_allocator, &command_buffer));
+    return command_buffer;
+  }
+
+  // Records a push constant, a descriptor set with one direct and one indirect
+  // (slot 1) binding, and |dispatch_count| dispatches.
+  void Record(iree_hal_command_buffer_t* command_buffer, int dispatch_count) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+    uint32_t value = 7;
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_constants(
+        command_buffer, pipeline_layout, 0, &value, sizeof(value)));
+    iree_hal_descriptor_set_binding_t bindings[2] = {
+        {/*binding=*/0, /*buffer_slot=*/0, buffer, /*offset=*/16,
+         /*length=*/64},
+        {/*binding=*/1, /*buffer_slot=*/1, /*buffer=*/NULL, /*offset=*/8,
+         /*length=*/IREE_WHOLE_BUFFER},
+    };
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+        command_buffer, pipeline_layout, 0, IREE_ARRAYSIZE(bindings),
+        bindings));
+    for (int i = 0; i < dispatch_count; ++i) {
+      IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(command_buffer,
+                                                      executable, i, 1, 2, 3));
+    }
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  }
+
+  // Returns a binding table with |buffer| in slot 1 at offset 100.
+  iree_hal_buffer_binding_table_t BindingTable(
+      iree_hal_buffer_binding_t (&storage)[2]) {
+    storage[0] = {NULL, 0, 0};
+    storage[1] = {buffer, 100, 32};
+    return {IREE_ARRAYSIZE(storage), storage};
+  }
+};
+
+// Reusable command buffers replay the same commands on every apply.
+TEST_F(DeferredCommandBufferTest, ReplayReusable) {
+  iree_hal_command_buffer_t* command_buffer =
+      CreateDeferred(/*mode=*/0);
+  // Enough dispatches to span multiple arena blocks.
+  Record(command_buffer, 32);
+
+  iree_hal_buffer_binding_t storage[2];
+  iree_hal_buffer_binding_table_t binding_table = BindingTable(storage);
+  IREE_ASSERT_OK(iree_hal_deferred_command_buffer_apply(
+      command_buffer, target_command_buffer, binding_table));
+  std::vector<std::string> first_log = log;
+  ASSERT_EQ(first_log.size(), 32 + 4);
+  EXPECT_EQ(first_log[0], "begin");
+  EXPECT_EQ(first_log[1], "push_constants 0 7");
+  EXPECT_EQ(first_log[2], "push_descriptor_set 0 buffer+16 buffer+108");
+  EXPECT_EQ(first_log[3], "dispatch 0 1x2x3");
+  EXPECT_EQ(first_log[34], "dispatch 31 1x2x3");
+  EXPECT_EQ(first_log[35], "end");
+
+  log.clear();
+  IREE_ASSERT_OK(iree_hal_deferred_command_buffer_apply(
+      command_buffer, target_command_buffer, binding_table));
+  EXPECT_EQ(log, first_log);
+
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// One-shot command buffers apply once and then drop their commands.
+TEST_F(DeferredCommandBufferTest, ReplayOneShot) {
+  iree_hal_command_buffer_t* command_buffer =
+      CreateDeferred(IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+  Record(command_buffer, 2);
+
+  iree_hal_buffer_binding_t storage[2];
+  IREE_ASSERT_OK(iree_hal_deferred_command_buffer_apply(
+      command_buffer, target_command_buffer, BindingTable(storage)));
+  EXPECT_THAT(log, ElementsAre("begin", "push_constants 0 7",
+                               "push_descriptor_set 0 buffer+16 buffer+108",
+                               "dispatch 0 1x2x3", "dispatch 1 1x2x3", "end"));
+
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// Nested replay uses the plan without beginning or ending the target.
+TEST_F(DeferredCommandBufferTest, ApplyInline) {
+  iree_hal_command_buffer_t* command_buffer =
+      CreateDeferred(/*mode=*/0);
+  Record(command_buffer, 1);
+
+  iree_hal_buffer_binding_t storage[2];
+  iree_hal_buffer_binding_table_t binding_table = BindingTable(storage);
+  for (int i = 0; i < 2; ++i) {
+    IREE_ASSERT_OK(iree_hal_deferred_command_buffer_apply_inline(
+        command_buffer, target_command_buffer, binding_table));
+  }
+  EXPECT_THAT(log, ElementsAre("push_constants 0 7",
+                               "push_descriptor_set 0 buffer+16 buffer+108",
+                               "dispatch 0 1x2x3", "push_constants 0 7",
+                               "push_descriptor_set 0 buffer+16 buffer+108",
+                               "dispatch 0 1x2x3"));
+
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// Indirect bindings referencing slots beyond the binding table fail to apply.
+TEST_F(DeferredCommandBufferTest, IndirectBindingOutOfRange) {
+  iree_hal_command_buffer_t* command_buffer =
+      CreateDeferred(/*mode=*/0);
+  Record(command_buffer, 1);
+
+  iree_hal_buffer_binding_t storage[1] = {{buffer, 0, 32}};
+  iree_hal_buffer_binding_table_t binding_table = {IREE_ARRAYSIZE(storage),
+                                                   storage};
+  EXPECT_THAT(Status(iree_hal_deferred_command_buffer_apply(
+                  command_buffer, target_command_buffer, binding_table)),
+              StatusIs(StatusCode::kOutOfRange));
+
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,358 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/paged_buffer.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_paged_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_paged_buffer_pool_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Device buffer holding all pages.
+  iree_hal_buffer_t* storage;
+  iree_device_size_t page_size;
+  uint32_t page_capacity;
+
+  // Guards the page bookkeeping shared by all page tables.
+  iree_slim_mutex_t mutex;
+
+  // Stack of free page ordinals; the top of the stack is the most recently
+  // freed page as it is the most likely to still be resident in caches.
+  uint32_t free_count IREE_GUARDED_BY(mutex);
+  uint32_t* free_pages IREE_GUARDED_BY(mutex);
+
+  // Number of page tables referencing each page. 0 for free pages.
+  uint32_t* page_ref_counts IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_paged_buffer_pool_create(
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    iree_device_size_t page_size, uint32_t page_capacity,
+    iree_allocator_t host_allocator, iree_hal_paged_buffer_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  if (page_size == 0 || page_capacity == 0 || page_capacity == UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "paged buffer pools require a nonzero page size "
+                            "and capacity");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)page_size);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)page_capacity);
+
+  iree_hal_paged_buffer_pool_t* pool = NULL;
+  const iree_host_size_t total_size =
+      sizeof(*pool) + 2 * page_capacity * sizeof(uint32_t);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&pool));
+  memset(pool, 0, total_size);
+  iree_atomic_ref_count_init(&pool->ref_count);
+  pool->host_allocator = host_allocator;
+  pool->page_size = page_size;
+  pool->page_capacity = page_capacity;
+  iree_slim_mutex_initialize(&pool->mutex);
+  pool->free_pages = (uint32_t*)((uint8_t*)pool + sizeof(*pool));
+  pool->page_ref_counts = pool->free_pages + page_capacity;
+
+  // Push pages in reverse so that the lowest ordinals are allocated first.
+  pool->free_count = page_capacity;
+  for (uint32_t i = 0; i < page_capacity; ++i) {
+    pool->free_pages[i] = page_capacity - 1 - i;
+  }
+
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, params, page_size * page_capacity,
+      iree_const_byte_span_empty(), &pool->storage);
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_paged_buffer_pool_release(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_paged_buffer_pool_destroy(
+    iree_hal_paged_buffer_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_release(pool->storage);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_paged_buffer_pool_retain(iree_hal_paged_buffer_pool_t* pool) {
+  if (IREE_LIKELY(pool)) {
+    iree_atomic_ref_count_inc(&pool->ref_count);
+  }
+}
+
+void iree_hal_paged_buffer_pool_release(iree_hal_paged_buffer_pool_t* pool) {
+  if (IREE_LIKELY(pool) && iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_hal_paged_buffer_pool_destroy(pool);
+  }
+}
+
+iree_hal_buffer_t* iree_hal_paged_buffer_pool_storage(
+    iree_hal_paged_buffer_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->storage;
+}
+
+iree_device_size_t iree_hal_paged_buffer_pool_page_size(
+    const iree_hal_paged_buffer_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->page_size;
+}
+
+uint32_t iree_hal_paged_buffer_pool_page_capacity(
+    const iree_hal_paged_buffer_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->page_capacity;
+}
+
+uint32_t iree_hal_paged_buffer_pool_free_page_count(
+    iree_hal_paged_buffer_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_slim_mutex_lock(&pool->mutex);
+  const uint32_t free_count = pool->free_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  return free_count;
+}
+
+// Acquires |page_count| free pages into |out_pages| or fails without acquiring
+// any if not enough are available.
+static iree_status_t iree_hal_paged_buffer_pool_acquire_pages(
+    iree_hal_paged_buffer_pool_t* pool, uint32_t page_count,
+    uint32_t* out_pages) {
+  iree_slim_mutex_lock(&pool->mutex);
+  if (page_count > pool->free_count) {
+    const uint32_t free_count = pool->free_count;
+    iree_slim_mutex_unlock(&pool->mutex);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "paged buffer pool exhausted; %u pages requested "
+                            "but only %u of %u are free",
+                            page_count, free_count, pool->page_capacity);
+  }
+  for (uint32_t i = 0; i < page_count; ++i) {
+    const uint32_t page = pool->free_pages[--pool->free_count];
+    pool->page_ref_counts[page] = 1;
+    out_pages[i] = page;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  return iree_ok_status();
+}
+
+// Adds a reference to each of the |page_count| |pages|.
+static void iree_hal_paged_buffer_pool_retain_pages(
+    iree_hal_paged_buffer_pool_t* pool, uint32_t page_count,
+    const uint32_t* pages) {
+  iree_slim_mutex_lock(&pool->mutex);
+  for (uint32_t i = 0; i < page_count; ++i) {
+    ++pool->page_ref_counts[pages[i]];
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+// Drops a reference to each of the |page_count| |pages| and returns those no
+// longer referenced to the free list. Pages are released last to first so that
+// re-appending to a truncated table reacquires the same pages.
+static void iree_hal_paged_buffer_pool_release_pages(
+    iree_hal_paged_buffer_pool_t* pool, uint32_t page_count,
+    const uint32_t* pages) {
+  iree_slim_mutex_lock(&pool->mutex);
+  for (uint32_t i = page_count; i-- > 0;) {
+    const uint32_t page = pages[i];
+    IREE_ASSERT_GT(pool->page_ref_counts[page], 0);
+    if (--pool->page_ref_counts[page] == 0) {
+      pool->free_pages[pool->free_count++] = page;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_page_table_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_page_table_t {
+  iree_allocator_t host_allocator;
+  iree_hal_paged_buffer_pool_t* pool;
+  uint32_t page_count;
+  uint32_t page_capacity;
+  uint32_t* pages;
+};
+
+iree_status_t iree_hal_page_table_create(iree_hal_paged_buffer_pool_t* pool,
+                                         iree_allocator_t host_allocator,
+                                         iree_hal_page_table_t** out_table) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_table);
+  *out_table = NULL;
+  iree_hal_page_table_t* table = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, sizeof(*table), (void**)&table));
+  memset(table, 0, sizeof(*table));
+  table->host_allocator = host_allocator;
+  table->pool = pool;
+  iree_hal_paged_buffer_pool_retain(pool);
+  *out_table = table;
+  return iree_ok_status();
+}
+
+void iree_hal_page_table_free(iree_hal_page_table_t* table) {
+  if (!table) return;
+  iree_hal_paged_buffer_pool_release_pages(table->pool, table->page_count,
+                                           table->pages);
+  iree_hal_paged_buffer_pool_release(table->pool);
+  iree_allocator_free(table->host_allocator, table->pages);
+  iree_allocator_free(table->host_allocator, table);
+}
+
+iree_hal_paged_buffer_pool_t* iree_hal_page_table_pool(
+    const iree_hal_page_table_t* table) {
+  IREE_ASSERT_ARGUMENT(table);
+  return table->pool;
+}
+
+uint32_t iree_hal_page_table_page_count(const iree_hal_page_table_t* table) {
+  IREE_ASSERT_ARGUMENT(table);
+  return table->page_count;
+}
+
+const uint32_t* iree_hal_page_table_pages(const iree_hal_page_table_t* table) {
+  IREE_ASSERT_ARGUMENT(table);
+  return table->pages;
+}
+
+// Grows the page list storage of |table| to hold at least |page_capacity|.
+static iree_status_t iree_hal_page_table_reserve(iree_hal_page_table_t* table,
+                                                 uint32_t page_capacity) {
+  if (page_capacity <= table->page_capacity) return iree_ok_status();
+  const uint32_t new_capacity =
+      iree_max(page_capacity, iree_max(table->page_capacity * 2, 16u));
+  IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+      table->host_allocator, new_capacity * sizeof(table->pages[0]),
+      (void**)&table->pages));
+  table->page_capacity = new_capacity;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_page_table_append(iree_hal_page_table_t* table,
+                                         uint32_t page_count) {
+  IREE_ASSERT_ARGUMENT(table);
+  if (page_count == 0) return iree_ok_status();
+  if (page_count > table->pool->page_capacity - table->page_count) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "page table would exceed the pool capacity of %u "
+                            "pages",
+                            table->pool->page_capacity);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_page_table_reserve(table, table->page_count + page_count));
+  IREE_RETURN_IF_ERROR(iree_hal_paged_buffer_pool_acquire_pages(
+      table->pool, page_count, table->pages + table->page_count));
+  table->page_count += page_count;
+  return iree_ok_status();
+}
+
+void iree_hal_page_table_truncate(iree_hal_page_table_t* table,
+                                  uint32_t page_count) {
+  IREE_ASSERT_ARGUMENT(table);
+  if (page_count >= table->page_count) return;
+  iree_hal_paged_buffer_pool_release_pages(table->pool,
+                                           table->page_count - page_count,
+                                           table->pages + page_count);
+  table->page_count = page_count;
+}
+
+iree_status_t iree_hal_page_table_fork(const iree_hal_page_table_t* table,
+                                       iree_allocator_t host_allocator,
+                                       iree_hal_page_table_t** out_table) {
+  IREE_ASSERT_ARGUMENT(table);
+  IREE_ASSERT_ARGUMENT(out_table);
+  *out_table = NULL;
+  iree_hal_page_table_t* forked_table = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_page_table_create(table->pool, host_allocator, &forked_table));
+  iree_status_t status =
+      iree_hal_page_table_reserve(forked_table, table->page_count);
+  if (iree_status_is_ok(status)) {
+    iree_hal_paged_buffer_pool_retain_pages(table->pool, table->page_count,
+                                            table->pages);
+    if (table->page_count) {
+      memcpy(forked_table->pages, table->pages,
+             table->page_count * sizeof(table->pages[0]));
+    }
+    forked_table->page_count = table->page_count;
+    *out_table = forked_table;
+  } else {
+    iree_hal_page_table_free(forked_table);
+  }
+  return status;
+}
+
+iree_status_t iree_hal_page_table_make_writable(iree_hal_page_table_t* table,
+                                                uint32_t page_index,
+                                                uint32_t* out_source_page) {
+  IREE_ASSERT_ARGUMENT(table);
+  IREE_ASSERT_ARGUMENT(out_source_page);
+  *out_source_page = UINT32_MAX;
+  if (page_index >= table->page_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "page index %u out of range of %u pages",
+                            page_index, table->page_count);
+  }
+  iree_hal_paged_buffer_pool_t* pool = table->pool;
+  const uint32_t source_page = table->pages[page_index];
+
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool->page_ref_counts[source_page] == 1) {
+    // Exclusively owned by this table already.
+    iree_slim_mutex_unlock(&pool->mutex);
+    return iree_ok_status();
+  }
+  if (pool->free_count == 0) {
+    iree_slim_mutex_unlock(&pool->mutex);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "paged buffer pool exhausted; no free page to "
+                            "copy shared page %u into",
+                            source_page);
+  }
+  // Swap the shared page for a new one. The source page remains referenced by
+  // the other tables sharing it so its contents are valid for the copy.
+  const uint32_t target_page = pool->free_pages[--pool->free_count];
+  pool->page_ref_counts[target_page] = 1;
+  --pool->page_ref_counts[source_page];
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  table->pages[page_index] = target_page;
+  *out_source_page = source_page;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_page_table_write(const iree_hal_page_table_t* table,
+                                        iree_hal_buffer_t* target_buffer,
+                                        iree_device_size_t target_offset) {
+  IREE_ASSERT_ARGUMENT(table);
+  IREE_ASSERT_ARGUMENT(target_buffer);
+  if (table->page_count == 0) return iree_ok_status();
+  return iree_hal_buffer_map_write(
+      target_buffer, target_offset, table->pages,
+      table->page_count * sizeof(table->pages[0]));
+}
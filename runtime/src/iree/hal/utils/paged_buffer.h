@@ -0,0 +1,144 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_PAGED_BUFFER_H_
+#define IREE_HAL_UTILS_PAGED_BUFFER_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_paged_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+// A pool of fixed-size pages carved out of a single device buffer.
+//
+// Intended for data that grows incrementally per logical sequence such as the
+// key/value caches of autoregressive decoding. Instead of storing each
+// sequence as a contiguous tensor that must be reallocated or copied as it
+// grows every sequence owns an iree_hal_page_table_t listing the pages holding
+// its contents in order. Dispatches bind the pool storage buffer and the page
+// table (written into a buffer of uint32_t page ordinals) and gather through
+// the table. As all pages are the same size the pool never fragments and pages
+// freed by one sequence can be immediately reused by any other.
+//
+// Pages are reference counted so that sequences can be forked (such as for
+// beam search or shared prompt prefixes) without copying. Pages shared by
+// multiple tables must be made writable with iree_hal_page_table_make_writable
+// before being modified.
+//
+// Thread-safe: page tables from the same pool may be manipulated concurrently
+// from multiple threads. Individual page tables are not thread-safe.
+typedef struct iree_hal_paged_buffer_pool_t iree_hal_paged_buffer_pool_t;
+
+// Creates a pool of |page_capacity| pages of |page_size| bytes each allocated
+// from |device_allocator| with the given buffer |params|.
+iree_status_t iree_hal_paged_buffer_pool_create(
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    iree_device_size_t page_size, uint32_t page_capacity,
+    iree_allocator_t host_allocator, iree_hal_paged_buffer_pool_t** out_pool);
+
+// Retains the given |pool| for the caller.
+void iree_hal_paged_buffer_pool_retain(iree_hal_paged_buffer_pool_t* pool);
+
+// Releases the given |pool| from the caller.
+// The pool is destroyed once all page tables allocated from it are freed.
+void iree_hal_paged_buffer_pool_release(iree_hal_paged_buffer_pool_t* pool);
+
+// Returns the buffer backing all pages in the pool. Page N is located at byte
+// offset N * page_size. The buffer remains valid for the lifetime of the pool.
+iree_hal_buffer_t* iree_hal_paged_buffer_pool_storage(
+    iree_hal_paged_buffer_pool_t* pool);
+
+// Returns the size in bytes of each page in the pool.
+iree_device_size_t iree_hal_paged_buffer_pool_page_size(
+    const iree_hal_paged_buffer_pool_t* pool);
+
+// Returns the total number of pages in the pool.
+uint32_t iree_hal_paged_buffer_pool_page_capacity(
+    const iree_hal_paged_buffer_pool_t* pool);
+
+// Returns the number of pages not currently referenced by any page table.
+uint32_t iree_hal_paged_buffer_pool_free_page_count(
+    iree_hal_paged_buffer_pool_t* pool);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_page_table_t
+//===----------------------------------------------------------------------===//
+
+// An ordered list of pages from an iree_hal_paged_buffer_pool_t holding the
+// contents of a single sequence.
+typedef struct iree_hal_page_table_t iree_hal_page_table_t;
+
+// Creates an empty page table referencing pages from |pool|.
+iree_status_t iree_hal_page_table_create(iree_hal_paged_buffer_pool_t* pool,
+                                         iree_allocator_t host_allocator,
+                                         iree_hal_page_table_t** out_table);
+
+// Frees |table| and returns any pages no longer referenced to the pool.
+void iree_hal_page_table_free(iree_hal_page_table_t* table);
+
+// Returns the pool the pages in |table| are allocated from.
+iree_hal_paged_buffer_pool_t* iree_hal_page_table_pool(
+    const iree_hal_page_table_t* table);
+
+// Returns the number of pages in |table|.
+uint32_t iree_hal_page_table_page_count(const iree_hal_page_table_t* table);
+
+// Returns the ordinals of the pages in |table| in sequence order.
+// The returned pointer is invalidated when the table is modified.
+const uint32_t* iree_hal_page_table_pages(const iree_hal_page_table_t* table);
+
+// Appends |page_count| newly allocated pages to the end of |table|.
+// Page contents are undefined. Either all pages are appended or the table is
+// left unmodified and IREE_STATUS_RESOURCE_EXHAUSTED is returned if the pool
+// does not have enough free pages.
+iree_status_t iree_hal_page_table_append(iree_hal_page_table_t* table,
+                                         uint32_t page_count);
+
+// Drops pages from the end of |table| such that it has at most |page_count|
+// pages. Pages no longer referenced by any table are returned to the pool.
+void iree_hal_page_table_truncate(iree_hal_page_table_t* table,
+                                  uint32_t page_count);
+
+// Creates a new page table sharing all of the pages in |table|.
+// Neither table may modify a shared page without first calling
+// iree_hal_page_table_make_writable.
+iree_status_t iree_hal_page_table_fork(const iree_hal_page_table_t* table,
+                                       iree_allocator_t host_allocator,
+                                       iree_hal_page_table_t** out_table);
+
+// Ensures that the page at |page_index| in |table| is not shared with any other
+// page table so that it can be modified.
+//
+// If the page is shared a new page is allocated to replace it in |table| and
+// |out_source_page| is set to the ordinal of the shared page. The caller must
+// copy the contents of the source page into the new page (such as with
+// iree_hal_command_buffer_copy_buffer on the pool storage) before modifying it
+// and before the other tables sharing the source page release it. If the page
+// was not shared |out_source_page| is set to UINT32_MAX and no copy is
+// required.
+iree_status_t iree_hal_page_table_make_writable(iree_hal_page_table_t* table,
+                                                uint32_t page_index,
+                                                uint32_t* out_source_page);
+
+// Writes the page ordinals of |table| as uint32_t values into host-mappable
+// |target_buffer| at |target_offset| for use as a dispatch binding.
+// Device-local tables can be updated with iree_hal_command_buffer_update_buffer
+// using the contents of iree_hal_page_table_pages instead.
+iree_status_t iree_hal_page_table_write(const iree_hal_page_table_t* table,
+                                        iree_hal_buffer_t* target_buffer,
+                                        iree_device_size_t target_offset);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_PAGED_BUFFER_H_
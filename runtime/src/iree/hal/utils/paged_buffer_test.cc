@@ -0,0 +1,176 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/paged_buffer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+static constexpr iree_device_size_t kPageSize = 256;
+static constexpr uint32_t kPageCapacity = 8;
+
+class PagedBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    IREE_ASSERT_OK(iree_hal_paged_buffer_pool_create(
+        device_allocator_, params, kPageSize, kPageCapacity,
+        iree_allocator_system(), &pool_));
+  }
+
+  void TearDown() override {
+    iree_hal_paged_buffer_pool_release(pool_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_hal_page_table_t* CreateTable() {
+    iree_hal_page_table_t* table = NULL;
+    IREE_CHECK_OK(
+        iree_hal_page_table_create(pool_, iree_allocator_system(), &table));
+    return table;
+  }
+
+  static std::vector<uint32_t> Pages(const iree_hal_page_table_t* table) {
+    const uint32_t* pages = iree_hal_page_table_pages(table);
+    return std::vector<uint32_t>(
+        pages, pages + iree_hal_page_table_page_count(table));
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_paged_buffer_pool_t* pool_ = NULL;
+};
+
+TEST_F(PagedBufferTest, Storage) {
+  EXPECT_EQ(kPageSize, iree_hal_paged_buffer_pool_page_size(pool_));
+  EXPECT_EQ(kPageCapacity, iree_hal_paged_buffer_pool_page_capacity(pool_));
+  EXPECT_EQ(kPageCapacity, iree_hal_paged_buffer_pool_free_page_count(pool_));
+  EXPECT_EQ(kPageSize * kPageCapacity,
+            iree_hal_buffer_byte_length(
+                iree_hal_paged_buffer_pool_storage(pool_)));
+}
+
+TEST_F(PagedBufferTest, AppendTruncate) {
+  iree_hal_page_table_t* table = CreateTable();
+  IREE_ASSERT_OK(iree_hal_page_table_append(table, 3));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}), Pages(table));
+  EXPECT_EQ(kPageCapacity - 3,
+            iree_hal_paged_buffer_pool_free_page_count(pool_));
+
+  // Freed pages are reused first.
+  iree_hal_page_table_truncate(table, 1);
+  EXPECT_EQ(std::vector<uint32_t>({0}), Pages(table));
+  IREE_ASSERT_OK(iree_hal_page_table_append(table, 1));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1}), Pages(table));
+
+  iree_hal_page_table_free(table);
+  EXPECT_EQ(kPageCapacity, iree_hal_paged_buffer_pool_free_page_count(pool_));
+}
+
+// Pages freed by one sequence can be used by any other without fragmentation.
+TEST_F(PagedBufferTest, InterleavedSequences) {
+  iree_hal_page_table_t* table_a = CreateTable();
+  iree_hal_page_table_t* table_b = CreateTable();
+  for (int i = 0; i < 4; ++i) {
+    IREE_ASSERT_OK(iree_hal_page_table_append(table_a, 1));
+    IREE_ASSERT_OK(iree_hal_page_table_append(table_b, 1));
+  }
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_RESOURCE_EXHAUSTED,
+                        iree_hal_page_table_append(table_a, 1));
+  EXPECT_EQ(4, iree_hal_page_table_page_count(table_a));
+
+  iree_hal_page_table_free(table_a);
+  IREE_ASSERT_OK(iree_hal_page_table_append(table_b, 4));
+  EXPECT_EQ(0, iree_hal_paged_buffer_pool_free_page_count(pool_));
+  iree_hal_page_table_free(table_b);
+  EXPECT_EQ(kPageCapacity, iree_hal_paged_buffer_pool_free_page_count(pool_));
+}
+
+// Appends that cannot be fully satisfied must not acquire any pages.
+TEST_F(PagedBufferTest, AppendExhausted) {
+  iree_hal_page_table_t* table = CreateTable();
+  IREE_ASSERT_OK(iree_hal_page_table_append(table, kPageCapacity - 1));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_RESOURCE_EXHAUSTED,
+                        iree_hal_page_table_append(table, 2));
+  EXPECT_EQ(kPageCapacity - 1, iree_hal_page_table_page_count(table));
+  EXPECT_EQ(1, iree_hal_paged_buffer_pool_free_page_count(pool_));
+  iree_hal_page_table_free(table);
+}
+
+TEST_F(PagedBufferTest, ForkCopyOnWrite) {
+  iree_hal_page_table_t* parent = CreateTable();
+  IREE_ASSERT_OK(iree_hal_page_table_append(parent, 2));
+
+  iree_hal_page_table_t* child = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_page_table_fork(parent, iree_allocator_system(), &child));
+  EXPECT_EQ(Pages(parent), Pages(child));
+  EXPECT_EQ(kPageCapacity - 2,
+            iree_hal_paged_buffer_pool_free_page_count(pool_));
+
+  // Shared pages are replaced and the caller is told what to copy from.
+  uint32_t source_page = 0;
+  IREE_ASSERT_OK(iree_hal_page_table_make_writable(child, 1, &source_page));
+  EXPECT_EQ(1, source_page);
+  EXPECT_EQ(std::vector<uint32_t>({0, 2}), Pages(child));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1}), Pages(parent));
+
+  // Pages only referenced by the parent no longer need copying.
+  IREE_ASSERT_OK(iree_hal_page_table_make_writable(parent, 1, &source_page));
+  EXPECT_EQ(UINT32_MAX, source_page);
+
+  // Shared pages are only returned to the pool once all tables release them.
+  iree_hal_page_table_free(parent);
+  EXPECT_EQ(kPageCapacity - 2,
+            iree_hal_paged_buffer_pool_free_page_count(pool_));
+  iree_hal_page_table_free(child);
+  EXPECT_EQ(kPageCapacity, iree_hal_paged_buffer_pool_free_page_count(pool_));
+}
+
+TEST_F(PagedBufferTest, WritePageTable) {
+  iree_hal_page_table_t* table = CreateTable();
+  IREE_ASSERT_OK(iree_hal_page_table_append(table, 3));
+  iree_hal_page_table_truncate(table, 2);
+  IREE_ASSERT_OK(iree_hal_page_table_append(table, 2));
+
+  iree_hal_buffer_params_t params = {0};
+  params.type =
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  iree_hal_buffer_t* table_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, params, 8 * sizeof(uint32_t),
+      iree_const_byte_span_empty(), &table_buffer));
+  IREE_ASSERT_OK(iree_hal_page_table_write(table, table_buffer,
+                                           /*target_offset=*/sizeof(uint32_t)));
+  std::vector<uint32_t> contents(4);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(table_buffer, sizeof(uint32_t),
+                                          contents.data(),
+                                          contents.size() * sizeof(uint32_t)));
+  EXPECT_EQ(Pages(table), contents);
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3}), contents);
+
+  iree_hal_buffer_release(table_buffer);
+  iree_hal_page_table_free(table);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
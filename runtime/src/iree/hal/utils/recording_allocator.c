@@ -0,0 +1,686 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/recording_allocator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// Utilities
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+// Tracy retains plot names for the lifetime of the process so they must be
+// literals.
+static const char* iree_hal_recording_allocator_plot_names
+    [IREE_HAL_RECORDING_ALLOCATOR_MAX_HEAPS] = {
+        "Live Memory (heap 0)", "Live Memory (heap 1)", "Live Memory (heap 2)",
+        "Live Memory (heap 3)", "Live Memory (heap 4)", "Live Memory (heap 5)",
+        "Live Memory (heap 6)", "Live Memory (heap 7)",
+};
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+static const char* iree_hal_recording_allocator_source_names
+    [IREE_HAL_RECORDING_ALLOCATOR_SOURCE_COUNT] = {
+        "allocator",
+        "queue_alloca",
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_recording_allocator_t
+//===----------------------------------------------------------------------===//
+
+// A live allocation made through the recording allocator.
+typedef struct iree_hal_recording_allocator_entry_t {
+  // Buffer returned to the user or NULL if the entry is unused.
+  iree_hal_buffer_t* buffer;
+  // Allocator the underlying allocator pointed the buffer at for deallocation.
+  // The buffer is pointed at the recording allocator while live and restored
+  // when released.
+  iree_hal_allocator_t* device_allocator;
+  // Bytes requested by the user.
+  iree_device_size_t requested_size;
+  // Bytes of the allocation as reported by the buffer.
+  iree_device_size_t allocation_size;
+  uint8_t heap_ordinal;
+  uint8_t source;
+} iree_hal_recording_allocator_entry_t;
+
+// A change in the live bytes of a heap.
+typedef struct iree_hal_recording_allocator_event_t {
+  // Time since the allocator was created.
+  iree_duration_t time_ns;
+  // Live bytes in the heap after the event.
+  iree_device_size_t live_bytes;
+  // Bytes allocated (positive) or freed (negative).
+  int64_t delta_bytes;
+  uint8_t heap_ordinal;
+  uint8_t source;
+} iree_hal_recording_allocator_event_t;
+
+struct iree_hal_recording_allocator_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_allocator_t* device_allocator;
+  iree_time_t base_time_ns;
+  iree_host_size_t max_event_count;
+  // Points into the trailing storage of the allocator.
+  iree_string_view_t summary_path;
+
+  iree_host_size_t heap_count;
+  iree_hal_allocator_memory_heap_t
+      heaps[IREE_HAL_RECORDING_ALLOCATOR_MAX_HEAPS];
+
+  // Guards all mutable state below.
+  iree_slim_mutex_t mutex;
+
+  iree_hal_recording_allocator_heap_statistics_t
+      heap_statistics[IREE_HAL_RECORDING_ALLOCATOR_MAX_HEAPS];
+
+  // Open-addressed table of live allocations keyed by buffer pointer.
+  // The capacity is a power of two kept at least twice the live count.
+  iree_host_size_t entry_capacity;
+  iree_host_size_t entry_count;
+  iree_hal_recording_allocator_entry_t* entries;
+
+  // Recorded timeline; grows up to max_event_count.
+  iree_host_size_t event_capacity;
+  iree_host_size_t event_count;
+  uint64_t dropped_event_count;
+  iree_hal_recording_allocator_event_t* events;
+};
+
+static const iree_hal_allocator_vtable_t iree_hal_recording_allocator_vtable;
+
+static iree_hal_recording_allocator_t* iree_hal_recording_allocator_cast(
+    iree_hal_allocator_t* IREE_RESTRICT base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_recording_allocator_vtable);
+  return (iree_hal_recording_allocator_t*)base_value;
+}
+
+void iree_hal_recording_allocator_options_initialize(
+    iree_hal_recording_allocator_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->max_event_count = 64 * 1024;
+  out_options->summary_path = iree_string_view_empty();
+}
+
+iree_status_t iree_hal_recording_allocator_create(
+    const iree_hal_recording_allocator_options_t* options,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  *out_allocator = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Query the heaps from the underlying allocator first so that we can
+  // attribute allocations to them.
+  iree_hal_allocator_memory_heap_t heaps[16];
+  iree_host_size_t heap_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_allocator_query_memory_heaps(
+              device_allocator, IREE_ARRAYSIZE(heaps), heaps, &heap_count));
+  heap_count =
+      iree_max(1, iree_min(heap_count, IREE_HAL_RECORDING_ALLOCATOR_MAX_HEAPS));
+
+  iree_hal_recording_allocator_t* allocator = NULL;
+  iree_host_size_t total_size =
+      sizeof(*allocator) + options->summary_path.size + /*NUL*/ 1;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&allocator));
+  memset(allocator, 0, sizeof(*allocator));
+  iree_hal_resource_initialize(&iree_hal_recording_allocator_vtable,
+                               &allocator->resource);
+  allocator->host_allocator = host_allocator;
+  allocator->device_allocator = device_allocator;
+  iree_hal_allocator_retain(allocator->device_allocator);
+  allocator->base_time_ns = iree_time_now();
+  allocator->max_event_count = options->max_event_count;
+
+  char* summary_path = (char*)allocator + sizeof(*allocator);
+  memcpy(summary_path, options->summary_path.data, options->summary_path.size);
+  summary_path[options->summary_path.size] = 0;
+  allocator->summary_path =
+      iree_make_string_view(summary_path, options->summary_path.size);
+
+  allocator->heap_count = heap_count;
+  memcpy(allocator->heaps, heaps, heap_count * sizeof(heaps[0]));
+  for (iree_host_size_t i = 0; i < heap_count; ++i) {
+    allocator->heap_statistics[i].type = heaps[i].type;
+    IREE_TRACE_SET_PLOT_TYPE(iree_hal_recording_allocator_plot_names[i],
+                             IREE_TRACING_PLOT_TYPE_MEMORY, /*step=*/true,
+                             /*fill=*/true, /*color=*/0);
+    IREE_TRACE_PLOT_VALUE_I64(iree_hal_recording_allocator_plot_names[i], 0);
+  }
+
+  iree_slim_mutex_initialize(&allocator->mutex);
+
+  *out_allocator = (iree_hal_allocator_t*)allocator;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_recording_allocator_create_from_spec(
+    iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  iree_hal_recording_allocator_options_t options;
+  iree_hal_recording_allocator_options_initialize(&options);
+  while (!iree_string_view_is_empty(config_pairs)) {
+    iree_string_view_t config_pair = iree_string_view_empty();
+    iree_string_view_split(config_pairs, ',', &config_pair, &config_pairs);
+    iree_string_view_t key = iree_string_view_empty();
+    iree_string_view_t value = iree_string_view_empty();
+    iree_string_view_split(config_pair, '=', &key, &value);
+    key = iree_string_view_trim(key);
+    value = iree_string_view_trim(value);
+    if (iree_string_view_equal(key, IREE_SV("max_events"))) {
+      uint64_t max_event_count = 0;
+      if (!iree_string_view_atoi_uint64(value, &max_event_count)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid max_events value '%.*s'",
+                                (int)value.size, value.data);
+      }
+      options.max_event_count = (iree_host_size_t)max_event_count;
+    } else if (iree_string_view_equal(key, IREE_SV("path"))) {
+      options.summary_path = value;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unrecognized recording allocator key '%.*s'",
+                              (int)key.size, key.data);
+    }
+  }
+  return iree_hal_recording_allocator_create(&options, device_allocator,
+                                             host_allocator, out_allocator);
+}
+
+static iree_status_t iree_hal_recording_allocator_write_summary(
+    iree_hal_recording_allocator_t* allocator) {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(allocator->host_allocator, &builder);
+  iree_status_t status = iree_hal_recording_allocator_format_json(
+      (iree_hal_allocator_t*)allocator, &builder);
+  if (iree_status_is_ok(status)) {
+    if (iree_string_view_equal(allocator->summary_path, IREE_SV("-"))) {
+      fwrite(iree_string_builder_buffer(&builder), 1,
+             iree_string_builder_size(&builder), stdout);
+      fflush(stdout);
+    } else {
+      // The path is NUL terminated in the allocator storage.
+      status = iree_file_write_contents(
+          allocator->summary_path.data,
+          iree_make_const_byte_span(iree_string_builder_buffer(&builder),
+                                    iree_string_builder_size(&builder)));
+    }
+  }
+  iree_string_builder_deinitialize(&builder);
+  return status;
+}
+
+static void iree_hal_recording_allocator_destroy(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  iree_allocator_t host_allocator = allocator->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!iree_string_view_is_empty(allocator->summary_path)) {
+    iree_status_t status =
+        iree_hal_recording_allocator_write_summary(allocator);
+    if (!iree_status_is_ok(status)) {
+      fprintf(stderr, "failed to write allocation summary to '%.*s': ",
+              (int)allocator->summary_path.size, allocator->summary_path.data);
+      iree_status_fprint(stderr, status);
+      iree_status_ignore(status);
+    }
+  }
+
+  IREE_ASSERT_EQ(allocator->entry_count, 0, "buffers outlived the allocator");
+  iree_allocator_free(host_allocator, allocator->entries);
+  iree_allocator_free(host_allocator, allocator->events);
+  iree_slim_mutex_deinitialize(&allocator->mutex);
+  iree_hal_allocator_release(allocator->device_allocator);
+  iree_allocator_free(host_allocator, allocator);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_allocator_t iree_hal_recording_allocator_host_allocator(
+    const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_recording_allocator_t* allocator =
+      (iree_hal_recording_allocator_t*)base_allocator;
+  return allocator->host_allocator;
+}
+
+static iree_status_t iree_hal_recording_allocator_trim(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  return iree_hal_allocator_trim(allocator->device_allocator);
+}
+
+static void iree_hal_recording_allocator_query_statistics(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_allocator_statistics_t* IREE_RESTRICT out_statistics) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  iree_hal_allocator_query_statistics(allocator->device_allocator,
+                                      out_statistics);
+}
+
+static iree_status_t iree_hal_recording_allocator_query_memory_heaps(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_host_size_t capacity,
+    iree_hal_allocator_memory_heap_t* IREE_RESTRICT heaps,
+    iree_host_size_t* IREE_RESTRICT out_count) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_memory_heaps(allocator->device_allocator,
+                                               capacity, heaps, out_count);
+}
+
+static iree_hal_buffer_compatibility_t
+iree_hal_recording_allocator_query_buffer_compatibility(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t* IREE_RESTRICT allocation_size) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_buffer_compatibility(
+      allocator->device_allocator, *params, *allocation_size, params,
+      allocation_size);
+}
+
+// Returns the ordinal of the heap sharing the most memory type bits with
+// |memory_type|, preferring heaps reported earlier by the allocator.
+static uint8_t iree_hal_recording_allocator_select_heap(
+    iree_hal_recording_allocator_t* allocator,
+    iree_hal_memory_type_t memory_type) {
+  uint8_t best_ordinal = 0;
+  int best_count = -1;
+  for (iree_host_size_t i = 0; i < allocator->heap_count; ++i) {
+    int count =
+        iree_math_count_ones_u32(allocator->heaps[i].type & memory_type);
+    if (count > best_count) {
+      best_ordinal = (uint8_t)i;
+      best_count = count;
+    }
+  }
+  return best_ordinal;
+}
+
+static iree_host_size_t iree_hal_recording_allocator_hash(
+    const iree_hal_buffer_t* buffer) {
+  uint64_t value = (uint64_t)(uintptr_t)buffer;
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDull;
+  value ^= value >> 33;
+  return (iree_host_size_t)value;
+}
+
+// Returns the index of the entry for |buffer| or the empty slot it would be
+// inserted into.
+//
+// Must be called with the allocator mutex held.
+static iree_host_size_t iree_hal_recording_allocator_probe(
+    iree_hal_recording_allocator_t* allocator,
+    const iree_hal_buffer_t* buffer) {
+  const iree_host_size_t mask = allocator->entry_capacity - 1;
+  iree_host_size_t i = iree_hal_recording_allocator_hash(buffer) & mask;
+  while (allocator->entries[i].buffer &&
+         allocator->entries[i].buffer != buffer) {
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+// Grows the entry table such that at least one more entry can be inserted.
+//
+// Must be called with the allocator mutex held.
+static iree_status_t iree_hal_recording_allocator_reserve_entry(
+    iree_hal_recording_allocator_t* allocator) {
+  if ((allocator->entry_count + 1) * 2 <= allocator->entry_capacity) {
+    return iree_ok_status();
+  }
+  iree_host_size_t old_capacity = allocator->entry_capacity;
+  iree_hal_recording_allocator_entry_t* old_entries = allocator->entries;
+  iree_host_size_t new_capacity = iree_max(64, old_capacity * 2);
+  iree_hal_recording_allocator_entry_t* new_entries = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator->host_allocator, new_capacity * sizeof(new_entries[0]),
+      (void**)&new_entries));
+  memset(new_entries, 0, new_capacity * sizeof(new_entries[0]));
+  allocator->entry_capacity = new_capacity;
+  allocator->entries = new_entries;
+  for (iree_host_size_t i = 0; i < old_capacity; ++i) {
+    if (!old_entries[i].buffer) continue;
+    iree_host_size_t j =
+        iree_hal_recording_allocator_probe(allocator, old_entries[i].buffer);
+    new_entries[j] = old_entries[i];
+  }
+  iree_allocator_free(allocator->host_allocator, old_entries);
+  return iree_ok_status();
+}
+
+// Removes the entry at |index| and shifts back any entries that probed past it
+// so that lookups do not require tombstones.
+//
+// Must be called with the allocator mutex held.
+static void iree_hal_recording_allocator_erase_entry(
+    iree_hal_recording_allocator_t* allocator, iree_host_size_t index) {
+  const iree_host_size_t mask = allocator->entry_capacity - 1;
+  iree_host_size_t hole = index;
+  iree_host_size_t i = (index + 1) & mask;
+  while (allocator->entries[i].buffer) {
+    iree_host_size_t home =
+        iree_hal_recording_allocator_hash(allocator->entries[i].buffer) & mask;
+    // Move the entry into the hole if its home slot is not within (hole, i].
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      allocator->entries[hole] = allocator->entries[i];
+      hole = i;
+    }
+    i = (i + 1) & mask;
+  }
+  memset(&allocator->entries[hole], 0, sizeof(allocator->entries[hole]));
+  --allocator->entry_count;
+}
+
+// Records a change of |delta_bytes| in the live bytes of |heap_ordinal|.
+//
+// Must be called with the allocator mutex held.
+static void iree_hal_recording_allocator_record_event(
+    iree_hal_recording_allocator_t* allocator, uint8_t heap_ordinal,
+    uint8_t source, int64_t delta_bytes) {
+  iree_hal_recording_allocator_heap_statistics_t* heap =
+      &allocator->heap_statistics[heap_ordinal];
+  const iree_duration_t time_ns = iree_time_now() - allocator->base_time_ns;
+  if (heap->live_bytes > heap->peak_live_bytes) {
+    heap->peak_live_bytes = heap->live_bytes;
+    heap->peak_time_ns = time_ns;
+  }
+  IREE_TRACE_PLOT_VALUE_I64(
+      iree_hal_recording_allocator_plot_names[heap_ordinal],
+      (int64_t)heap->live_bytes);
+
+  if (allocator->event_count == allocator->event_capacity) {
+    iree_host_size_t new_capacity =
+        iree_min(allocator->max_event_count,
+                 iree_max(256, allocator->event_capacity * 2));
+    if (new_capacity <= allocator->event_capacity ||
+        !iree_status_is_ok(iree_allocator_realloc(
+            allocator->host_allocator,
+            new_capacity * sizeof(allocator->events[0]),
+            (void**)&allocator->events))) {
+      // The statistics remain accurate; only the timeline is truncated.
+      ++allocator->dropped_event_count;
+      return;
+    }
+    allocator->event_capacity = new_capacity;
+  }
+  allocator->events[allocator->event_count++] =
+      (iree_hal_recording_allocator_event_t){
+          .time_ns = time_ns,
+          .live_bytes = heap->live_bytes,
+          .delta_bytes = delta_bytes,
+          .heap_ordinal = heap_ordinal,
+          .source = source,
+      };
+}
+
+static iree_status_t iree_hal_recording_allocator_allocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size, iree_const_byte_span_t initial_data,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  const uint8_t source = (uint8_t)iree_hal_allocation_source_current();
+
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      allocator->device_allocator, *params, allocation_size, initial_data,
+      out_buffer));
+  iree_hal_buffer_t* buffer = *out_buffer;
+
+  iree_slim_mutex_lock(&allocator->mutex);
+  iree_status_t status = iree_hal_recording_allocator_reserve_entry(allocator);
+  if (iree_status_is_ok(status)) {
+    const iree_device_size_t buffer_size =
+        iree_hal_buffer_allocation_size(buffer);
+    const uint8_t heap_ordinal = iree_hal_recording_allocator_select_heap(
+        allocator, iree_hal_buffer_memory_type(buffer));
+    iree_hal_recording_allocator_entry_t* entry =
+        &allocator->entries[iree_hal_recording_allocator_probe(allocator,
+                                                               buffer)];
+    *entry = (iree_hal_recording_allocator_entry_t){
+        .buffer = buffer,
+        .device_allocator = buffer->device_allocator,
+        .requested_size = allocation_size,
+        .allocation_size = buffer_size,
+        .heap_ordinal = heap_ordinal,
+        .source = source,
+    };
+    ++allocator->entry_count;
+
+    iree_hal_recording_allocator_heap_statistics_t* heap =
+        &allocator->heap_statistics[heap_ordinal];
+    heap->live_bytes += buffer_size;
+    heap->live_requested_bytes += allocation_size;
+    ++heap->allocation_count[source];
+    heap->allocation_bytes[source] += buffer_size;
+    iree_hal_recording_allocator_record_event(allocator, heap_ordinal, source,
+                                              (int64_t)buffer_size);
+
+    // Point the buffer back to us so that we observe its deallocation.
+    buffer->device_allocator = base_allocator;
+  }
+  iree_slim_mutex_unlock(&allocator->mutex);
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(buffer);
+    *out_buffer = NULL;
+  }
+  return status;
+}
+
+static void iree_hal_recording_allocator_deallocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+
+  iree_slim_mutex_lock(&allocator->mutex);
+  iree_host_size_t index =
+      iree_hal_recording_allocator_probe(allocator, buffer);
+  iree_hal_recording_allocator_entry_t entry = allocator->entries[index];
+  IREE_ASSERT(entry.buffer == buffer, "buffer not allocated by the recorder");
+  iree_hal_recording_allocator_erase_entry(allocator, index);
+  iree_hal_recording_allocator_heap_statistics_t* heap =
+      &allocator->heap_statistics[entry.heap_ordinal];
+  heap->live_bytes -= entry.allocation_size;
+  heap->live_requested_bytes -= entry.requested_size;
+  ++heap->free_count;
+  iree_hal_recording_allocator_record_event(allocator, entry.heap_ordinal,
+                                            entry.source,
+                                            -(int64_t)entry.allocation_size);
+  iree_slim_mutex_unlock(&allocator->mutex);
+
+  // Return the buffer to the allocator that produced it; this may be a pool
+  // that retains it or may destroy it outright.
+  buffer->device_allocator = entry.device_allocator;
+  if (entry.device_allocator) {
+    iree_hal_allocator_deallocate_buffer(entry.device_allocator, buffer);
+  } else {
+    iree_hal_buffer_destroy(buffer);
+  }
+}
+
+static iree_status_t iree_hal_recording_allocator_import_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  // Imported memory is owned by the user and not recorded.
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  return iree_hal_allocator_import_buffer(allocator->device_allocator, *params,
+                                          external_buffer, release_callback,
+                                          out_buffer);
+}
+
+static iree_status_t iree_hal_recording_allocator_export_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer,
+    iree_hal_external_buffer_type_t requested_type,
+    iree_hal_external_buffer_flags_t requested_flags,
+    iree_hal_external_buffer_t* IREE_RESTRICT out_external_buffer) {
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  return iree_hal_allocator_export_buffer(allocator->device_allocator, buffer,
+                                          requested_type, requested_flags,
+                                          out_external_buffer);
+}
+
+iree_status_t iree_hal_recording_allocator_query_heap_statistics(
+    iree_hal_allocator_t* base_allocator, iree_host_size_t capacity,
+    iree_hal_recording_allocator_heap_statistics_t* out_heaps,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  *out_count = allocator->heap_count;
+  if (capacity < allocator->heap_count) {
+    // NOTE: lightweight as this is hit in normal pre-sizing usage.
+    return iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  }
+  iree_slim_mutex_lock(&allocator->mutex);
+  memcpy(out_heaps, allocator->heap_statistics,
+         allocator->heap_count * sizeof(out_heaps[0]));
+  iree_slim_mutex_unlock(&allocator->mutex);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_recording_allocator_format_heap_json(
+    const iree_hal_recording_allocator_heap_statistics_t* heap,
+    iree_host_size_t ordinal, iree_string_builder_t* builder) {
+  iree_bitfield_string_temp_t temp;
+  iree_string_view_t type = iree_hal_memory_type_format(heap->type, &temp);
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "    {\"ordinal\": %" PRIhsz ", \"type\": \"%.*s\", \"live_bytes\": "
+      "%" PRIu64 ", \"live_requested_bytes\": %" PRIu64
+      ", \"peak_live_bytes\": %" PRIu64 ", \"peak_time_ns\": %" PRIi64
+      ", \"free_count\": %" PRIu64 ", \"allocations\": {",
+      ordinal, (int)type.size, type.data, (uint64_t)heap->live_bytes,
+      (uint64_t)heap->live_requested_bytes, (uint64_t)heap->peak_live_bytes,
+      (int64_t)heap->peak_time_ns, heap->free_count));
+  for (iree_host_size_t i = 0; i < IREE_HAL_RECORDING_ALLOCATOR_SOURCE_COUNT;
+       ++i) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%s\"%s\": {\"count\": %" PRIu64 ", \"bytes\": %" PRIu64 "}",
+        i ? ", " : "", iree_hal_recording_allocator_source_names[i],
+        heap->allocation_count[i], (uint64_t)heap->allocation_bytes[i]));
+  }
+  return iree_string_builder_append_cstring(builder, "}}");
+}
+
+static iree_status_t iree_hal_recording_allocator_format_cache_json(
+    iree_hal_recording_allocator_t* allocator, iree_string_builder_t* builder) {
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator->device_allocator, &statistics);
+  const uint64_t request_count =
+      statistics.cache_hit_count + statistics.cache_miss_count;
+  return iree_string_builder_append_format(
+      builder,
+      "  \"cache\": {\"hit_count\": %" PRIu64 ", \"miss_count\": %" PRIu64
+      ", \"hit_rate\": %.4f, \"bytes_free\": %" PRIu64 "},\n",
+      statistics.cache_hit_count, statistics.cache_miss_count,
+      request_count ? (double)statistics.cache_hit_count / request_count : 0.0,
+      (uint64_t)statistics.cache_bytes_free);
+#else
+  return iree_ok_status();
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+iree_status_t iree_hal_recording_allocator_format_json(
+    iree_hal_allocator_t* base_allocator, iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_hal_recording_allocator_t* allocator =
+      iree_hal_recording_allocator_cast(base_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Cache statistics are queried without holding our lock as they may take
+  // locks in the underlying allocators.
+  iree_status_t status = iree_string_builder_append_cstring(builder, "{\n");
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_recording_allocator_format_cache_json(allocator, builder);
+  }
+
+  iree_slim_mutex_lock(&allocator->mutex);
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_cstring(builder, "  \"heaps\": [\n");
+  }
+  for (iree_host_size_t i = 0;
+       i < allocator->heap_count && iree_status_is_ok(status); ++i) {
+    status = iree_hal_recording_allocator_format_heap_json(
+        &allocator->heap_statistics[i], i, builder);
+    if (iree_status_is_ok(status)) {
+      status = iree_string_builder_append_cstring(
+          builder, i + 1 < allocator->heap_count ? ",\n" : "\n");
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_format(
+        builder, "  ],\n  \"dropped_event_count\": %" PRIu64
+                 ",\n  \"timeline\": [\n",
+        allocator->dropped_event_count);
+  }
+  for (iree_host_size_t i = 0;
+       i < allocator->event_count && iree_status_is_ok(status); ++i) {
+    const iree_hal_recording_allocator_event_t* event = &allocator->events[i];
+    status = iree_string_builder_append_format(
+        builder,
+        "    {\"time_ns\": %" PRIi64 ", \"heap\": %u, \"source\": \"%s\", "
+        "\"delta_bytes\": %" PRIi64 ", \"live_bytes\": %" PRIu64 "}%s\n",
+        (int64_t)event->time_ns, (unsigned)event->heap_ordinal,
+        iree_hal_recording_allocator_source_names[event->source],
+        event->delta_bytes, (uint64_t)event->live_bytes,
+        i + 1 < allocator->event_count ? "," : "");
+  }
+  iree_slim_mutex_unlock(&allocator->mutex);
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_cstring(builder, "  ]\n}\n");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_allocator_vtable_t iree_hal_recording_allocator_vtable = {
+    .destroy = iree_hal_recording_allocator_destroy,
+    .host_allocator = iree_hal_recording_allocator_host_allocator,
+    .trim = iree_hal_recording_allocator_trim,
+    .query_statistics = iree_hal_recording_allocator_query_statistics,
+    .query_memory_heaps = iree_hal_recording_allocator_query_memory_heaps,
+    .query_buffer_compatibility =
+        iree_hal_recording_allocator_query_buffer_compatibility,
+    .allocate_buffer = iree_hal_recording_allocator_allocate_buffer,
+    .deallocate_buffer = iree_hal_recording_allocator_deallocate_buffer,
+    .import_buffer = iree_hal_recording_allocator_import_buffer,
+    .export_buffer = iree_hal_recording_allocator_export_buffer,
+};
@@ -0,0 +1,122 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_RECORDING_ALLOCATOR_H_
+#define IREE_HAL_UTILS_RECORDING_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Maximum number of heaps of the underlying allocator that are tracked
+// independently. Allocations from any additional heaps are tracked with the
+// last heap.
+#define IREE_HAL_RECORDING_ALLOCATOR_MAX_HEAPS 8
+
+// Number of iree_hal_allocation_source_t values tracked.
+#define IREE_HAL_RECORDING_ALLOCATOR_SOURCE_COUNT 2
+
+// A HAL buffer allocator that records a timeline of the live bytes in each
+// heap of the allocator it wraps. Each allocation is attributed to the API it
+// was made through (iree_hal_allocator_allocate_buffer or
+// iree_hal_device_queue_alloca) and the peak concurrent usage of each heap is
+// tracked along with the bytes lost to rounding and alignment in the
+// underlying allocators.
+//
+// The live bytes of each heap are plotted in Tracy when tracing is enabled and
+// a JSON summary of the recording, including the hit rate of any caching
+// allocators being wrapped, can be produced with
+// iree_hal_recording_allocator_format_json. This is intended for tuning
+// memory usage (batch sizes, cache limits, etc) and adds a lock and a hash
+// lookup to each allocation and deallocation.
+//
+// Buffers must be released before the allocator is destroyed.
+//
+// Thread-safe: the allocator can be shared across multiple user-level devices
+// manipulated from multiple threads.
+typedef struct iree_hal_recording_allocator_t iree_hal_recording_allocator_t;
+
+// Parameters used to configure an iree_hal_recording_allocator_t.
+typedef struct iree_hal_recording_allocator_options_t {
+  // Maximum number of allocation and deallocation events retained in the
+  // timeline. Events past the limit are counted but not recorded. Heap
+  // statistics are tracked regardless of the limit.
+  iree_host_size_t max_event_count;
+  // Path of a file the JSON summary is written to when the allocator is
+  // destroyed, or empty to not write one. `-` writes to stdout.
+  iree_string_view_t summary_path;
+} iree_hal_recording_allocator_options_t;
+
+// Initializes |out_options| to the default values.
+void iree_hal_recording_allocator_options_initialize(
+    iree_hal_recording_allocator_options_t* out_options);
+
+// Creates a recording allocator intercepting all |device_allocator|
+// allocations.
+iree_status_t iree_hal_recording_allocator_create(
+    const iree_hal_recording_allocator_options_t* options,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+// Creates a recording allocator with the given key-value |config_pairs|.
+//
+// Expected form:
+//   [max_events=count][,path=file]
+// Example:
+//   max_events=100000,path=/tmp/allocations.json
+iree_status_t iree_hal_recording_allocator_create_from_spec(
+    iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+
+// Statistics for a single heap of a recording allocator.
+typedef struct iree_hal_recording_allocator_heap_statistics_t {
+  // Memory type of the heap as reported by the underlying allocator.
+  iree_hal_memory_type_t type;
+  // Bytes currently allocated from the heap.
+  iree_device_size_t live_bytes;
+  // Bytes requested by the live allocations. Any difference from |live_bytes|
+  // was added by rounding (such as caching allocator size classes) and
+  // alignment in the underlying allocators.
+  iree_device_size_t live_requested_bytes;
+  // Maximum bytes concurrently allocated from the heap.
+  iree_device_size_t peak_live_bytes;
+  // Time since the allocator was created at which |peak_live_bytes| was first
+  // reached.
+  iree_duration_t peak_time_ns;
+  // Total allocations and allocated bytes by iree_hal_allocation_source_t.
+  uint64_t allocation_count[IREE_HAL_RECORDING_ALLOCATOR_SOURCE_COUNT];
+  iree_device_size_t
+      allocation_bytes[IREE_HAL_RECORDING_ALLOCATOR_SOURCE_COUNT];
+  // Total deallocations.
+  uint64_t free_count;
+} iree_hal_recording_allocator_heap_statistics_t;
+
+// Queries the per-heap statistics of |allocator|.
+//
+// Returns the total heap count in |out_count| and if |capacity| is large
+// enough will fill |out_heaps| with the heap statistics in the order the
+// underlying allocator reports its heaps.
+// Returns IREE_STATUS_OUT_OF_RANGE if |capacity| is too small.
+iree_status_t iree_hal_recording_allocator_query_heap_statistics(
+    iree_hal_allocator_t* allocator, iree_host_size_t capacity,
+    iree_hal_recording_allocator_heap_statistics_t* out_heaps,
+    iree_host_size_t* out_count);
+
+// Appends a JSON summary of the recording of |allocator| to |builder|.
+// The summary contains the statistics of each heap, the aggregate caching
+// statistics of the underlying allocators (when IREE_STATISTICS_ENABLE), and
+// the recorded timeline of live bytes per heap.
+iree_status_t iree_hal_recording_allocator_format_json(
+    iree_hal_allocator_t* allocator, iree_string_builder_t* builder);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_RECORDING_ALLOCATOR_H_
@@ -0,0 +1,186 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/recording_allocator.h"
+
+#include <cstdint>
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/caching_allocator.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::testing::HasSubstr;
+
+class RecordingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &heap_allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(heap_allocator_); }
+
+  static iree_hal_allocator_t* CreateAllocator(
+      iree_hal_allocator_t* device_allocator) {
+    iree_hal_recording_allocator_options_t options;
+    iree_hal_recording_allocator_options_initialize(&options);
+    iree_hal_allocator_t* allocator = NULL;
+    IREE_CHECK_OK(iree_hal_recording_allocator_create(
+        &options, device_allocator, iree_allocator_system(), &allocator));
+    return allocator;
+  }
+
+  static iree_hal_buffer_t* Allocate(iree_hal_allocator_t* allocator,
+                                     iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator, params, size, iree_const_byte_span_empty(), &buffer));
+    return buffer;
+  }
+
+  static iree_hal_recording_allocator_heap_statistics_t QueryHeap(
+      iree_hal_allocator_t* allocator) {
+    iree_hal_recording_allocator_heap_statistics_t heap;
+    iree_host_size_t count = 0;
+    IREE_CHECK_OK(iree_hal_recording_allocator_query_heap_statistics(
+        allocator, 1, &heap, &count));
+    EXPECT_EQ(count, 1);
+    return heap;
+  }
+
+  static std::string FormatJson(iree_hal_allocator_t* allocator) {
+    iree_string_builder_t builder;
+    iree_string_builder_initialize(iree_allocator_system(), &builder);
+    IREE_CHECK_OK(
+        iree_hal_recording_allocator_format_json(allocator, &builder));
+    std::string json(iree_string_builder_buffer(&builder),
+                     iree_string_builder_size(&builder));
+    iree_string_builder_deinitialize(&builder);
+    return json;
+  }
+
+  iree_hal_allocator_t* heap_allocator_ = NULL;
+};
+
+TEST_F(RecordingAllocatorTest, TracksPeakLiveBytes) {
+  iree_hal_allocator_t* allocator = CreateAllocator(heap_allocator_);
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1000);
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 2000);
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_t* buffer2 = Allocate(allocator, 500);
+
+  auto heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.live_bytes, 2500);
+  EXPECT_EQ(heap.live_requested_bytes, 2500);
+  EXPECT_EQ(heap.peak_live_bytes, 3000);
+  EXPECT_EQ(heap.allocation_count[IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR], 3);
+  EXPECT_EQ(heap.allocation_bytes[IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR], 3500);
+  EXPECT_EQ(heap.allocation_count[IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA], 0);
+  EXPECT_EQ(heap.free_count, 1);
+
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer2);
+  heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.live_bytes, 0);
+  EXPECT_EQ(heap.peak_live_bytes, 3000);
+  EXPECT_EQ(heap.free_count, 3);
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(RecordingAllocatorTest, AttributesQueueAllocations) {
+  iree_hal_allocator_t* allocator = CreateAllocator(heap_allocator_);
+  iree_hal_allocation_source_t prior_source =
+      iree_hal_allocation_source_exchange(
+          IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA);
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1000);
+  iree_hal_allocation_source_exchange(prior_source);
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 100);
+
+  auto heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.allocation_count[IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA], 1);
+  EXPECT_EQ(heap.allocation_bytes[IREE_HAL_ALLOCATION_SOURCE_QUEUE_ALLOCA],
+            1000);
+  EXPECT_EQ(heap.allocation_count[IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR], 1);
+  EXPECT_EQ(heap.allocation_bytes[IREE_HAL_ALLOCATION_SOURCE_ALLOCATOR], 100);
+
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_release(buffer1);
+  std::string json = FormatJson(allocator);
+  EXPECT_THAT(json, HasSubstr("\"source\": \"queue_alloca\", "
+                              "\"delta_bytes\": 1000, \"live_bytes\": 1000"));
+  EXPECT_THAT(json, HasSubstr("\"source\": \"queue_alloca\", "
+                              "\"delta_bytes\": -1000, \"live_bytes\": 100}"));
+  EXPECT_THAT(json, HasSubstr("\"dropped_event_count\": 0"));
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(RecordingAllocatorTest, TruncatesTimeline) {
+  iree_hal_recording_allocator_options_t options;
+  iree_hal_recording_allocator_options_initialize(&options);
+  options.max_event_count = 0;
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_recording_allocator_create(
+      &options, heap_allocator_, iree_allocator_system(), &allocator));
+  iree_hal_buffer_release(Allocate(allocator, 1000));
+  auto heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.peak_live_bytes, 1000);
+  EXPECT_THAT(FormatJson(allocator), HasSubstr("\"dropped_event_count\": 2"));
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(RecordingAllocatorTest, WrapsCachingAllocator) {
+  iree_hal_allocator_memory_heap_t memory_heap;
+  iree_host_size_t heap_count = 0;
+  IREE_ASSERT_OK(iree_hal_allocator_query_memory_heaps(
+      heap_allocator_, 1, &memory_heap, &heap_count));
+  iree_hal_caching_allocator_pool_params_t params;
+  iree_hal_caching_allocator_pool_params_initialize(memory_heap, &params);
+  params.flags = IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES;
+  iree_hal_allocator_t* caching_allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_caching_allocator_create_with_pools(
+      1, &params, heap_allocator_, iree_allocator_system(),
+      &caching_allocator));
+  iree_hal_allocator_t* allocator = CreateAllocator(caching_allocator);
+  iree_hal_allocator_release(caching_allocator);
+
+  // Rounding to the 320 byte size class is reported as the difference between
+  // live and requested bytes.
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 257);
+  auto heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.live_bytes, 320);
+  EXPECT_EQ(heap.live_requested_bytes, 257);
+
+  // Freed buffers return to the cache and are reused.
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 300);
+  EXPECT_EQ(buffer1, buffer0);
+  iree_hal_buffer_release(buffer1);
+  heap = QueryHeap(allocator);
+  EXPECT_EQ(heap.live_bytes, 0);
+  EXPECT_EQ(heap.peak_live_bytes, 320);
+
+#if IREE_STATISTICS_ENABLE
+  EXPECT_THAT(FormatJson(allocator),
+              HasSubstr("\"hit_count\": 1, \"miss_count\": 1, "
+                        "\"hit_rate\": 0.5000"));
+#endif  // IREE_STATISTICS_ENABLE
+  iree_hal_allocator_release(allocator);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
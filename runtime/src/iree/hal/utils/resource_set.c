@@ -6,6 +6,7 @@
 
 #include "iree/hal/utils/resource_set.h"
 
+#include "iree/base/internal/math.h"
 #include "iree/base/tracing.h"
 
 // Inlines the first chunk into the block using all of the remaining space.
@@ -59,6 +60,14 @@ static void iree_hal_resource_set_release_blocks(iree_hal_resource_set_t* set,
   // that isn't worth the complexity.
   iree_arena_block_t* block_head = NULL;
   iree_arena_block_t* block_tail = NULL;
+
+  // The hash table only references resources retained by the chunks.
+  if (set->hash_slots) {
+    iree_allocator_free(set->block_pool->block_allocator, set->hash_slots);
+    set->hash_slots = NULL;
+    set->hash_capacity = 0;
+  }
+
   iree_hal_resource_set_chunk_t* chunk = set->chunk_head;
   while (chunk) {
     // Release all resources in the chunk.
@@ -132,6 +141,141 @@ static iree_status_t iree_hal_resource_set_insert_retain(
   // Retain and insert into the chunk.
   chunk->resources[chunk->count++] = resource;
   iree_hal_resource_retain(resource);
+  ++set->unique_count;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Hash table
+//===----------------------------------------------------------------------===//
+// The table is a power-of-two array of resource pointers split into groups of
+// IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE slots. A resource hashes to a group and
+// the whole group is compared at once; if neither the resource nor an empty
+// slot is found the next group is probed. The load factor is kept <= 50% so
+// probe sequences are almost always a single group (one cache line).
+//
+// The group comparison is written as a fixed-length loop producing bitmasks so
+// that compilers can lower it to SIMD compares on targets that support them.
+
+// Initial capacity of the hash table when the set crosses the threshold.
+#define IREE_HAL_RESOURCE_SET_HASH_MIN_CAPACITY \
+  (IREE_HAL_RESOURCE_SET_HASH_THRESHOLD * 4)
+
+static_assert(IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE <= 32,
+              "group masks are stored in 32-bit values");
+
+// Returns the group index |resource| starts probing at in a table with
+// |group_mask| + 1 groups.
+static inline iree_host_size_t iree_hal_resource_set_hash_group(
+    iree_hal_resource_t* resource, iree_host_size_t group_mask) {
+  // Fibonacci hashing: resource pointers are aligned and their low bits carry
+  // no information so we use the high bits of the product.
+  uint64_t hash = (uint64_t)(uintptr_t)resource * 0x9E3779B97F4A7C15ull;
+  return (iree_host_size_t)(hash >> 32) & group_mask;
+}
+
+// Probes |slots| for |resource| and returns the slot index containing it or the
+// first empty slot it should be stored in. |out_found| indicates which.
+static iree_host_size_t iree_hal_resource_set_hash_probe(
+    iree_hal_resource_t** slots, iree_host_size_t capacity,
+    iree_hal_resource_t* resource, bool* out_found) {
+  const iree_host_size_t group_mask =
+      capacity / IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE - 1;
+  iree_host_size_t group =
+      iree_hal_resource_set_hash_group(resource, group_mask);
+  for (;;) {
+    iree_hal_resource_t** group_slots =
+        &slots[group * IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE];
+    uint32_t match_mask = 0;
+    uint32_t empty_mask = 0;
+    for (iree_host_size_t i = 0; i < IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE;
+         ++i) {
+      match_mask |= (uint32_t)(group_slots[i] == resource) << i;
+      empty_mask |= (uint32_t)(group_slots[i] == NULL) << i;
+    }
+    if (match_mask) {
+      *out_found = true;
+      return group * IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE +
+             iree_math_count_trailing_zeros_u32(match_mask);
+    } else if (empty_mask) {
+      *out_found = false;
+      return group * IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE +
+             iree_math_count_trailing_zeros_u32(empty_mask);
+    }
+    group = (group + 1) & group_mask;
+  }
+}
+
+// Reallocates the set hash table to |new_capacity| slots and inserts all
+// resources from the existing table or, if there is no table yet, the chunks.
+static iree_status_t iree_hal_resource_set_hash_resize(
+    iree_hal_resource_set_t* set, iree_host_size_t new_capacity) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)new_capacity);
+
+  iree_allocator_t allocator = set->block_pool->block_allocator;
+  iree_hal_resource_t** new_slots = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, new_capacity * sizeof(*new_slots),
+                                (void**)&new_slots));
+
+  bool found = false;
+  if (set->hash_slots) {
+    for (iree_host_size_t i = 0; i < set->hash_capacity; ++i) {
+      iree_hal_resource_t* resource = set->hash_slots[i];
+      if (!resource) continue;
+      new_slots[iree_hal_resource_set_hash_probe(new_slots, new_capacity,
+                                                 resource, &found)] = resource;
+    }
+    iree_allocator_free(allocator, set->hash_slots);
+  } else {
+    // Redundant insertions that missed the MRU dedupe here; they remain
+    // retained by the chunks but are only counted once from now on.
+    iree_host_size_t unique_count = 0;
+    for (iree_hal_resource_set_chunk_t* chunk = set->chunk_head; chunk;
+         chunk = iree_hal_resource_set_chunk_is_stored_inline(chunk)
+                     ? NULL
+                     : chunk->next_chunk) {
+      for (iree_host_size_t i = 0; i < chunk->count; ++i) {
+        iree_hal_resource_t* resource = chunk->resources[i];
+        iree_host_size_t slot = iree_hal_resource_set_hash_probe(
+            new_slots, new_capacity, resource, &found);
+        if (!found) {
+          new_slots[slot] = resource;
+          ++unique_count;
+        }
+      }
+    }
+    set->unique_count = unique_count;
+  }
+  set->hash_slots = new_slots;
+  set->hash_capacity = new_capacity;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Inserts |resource| into the set using the hash table for deduplication.
+// The resource is retained if it is not already present.
+static iree_status_t iree_hal_resource_set_insert_hashed(
+    iree_hal_resource_set_t* set, iree_hal_resource_t* resource) {
+  bool found = false;
+  iree_host_size_t slot = iree_hal_resource_set_hash_probe(
+      set->hash_slots, set->hash_capacity, resource, &found);
+  if (found) return iree_ok_status();
+
+  // Grow before inserting if we'd exceed the maximum load factor. The probe
+  // must be reissued as slots move when rehashing.
+  if ((set->unique_count + 1) * 2 > set->hash_capacity) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_resource_set_hash_resize(set, set->hash_capacity * 2));
+    slot = iree_hal_resource_set_hash_probe(set->hash_slots,
+                                            set->hash_capacity, resource,
+                                            &found);
+  }
+
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  set->hash_slots[slot] = resource;
   return iree_ok_status();
 }
 
@@ -235,7 +379,18 @@ static iree_status_t iree_hal_resource_set_insert_1(
   // Miss - insert into the main list (slow path).
   // Note that we do this before updating the MRU in case allocation fails - we
   // don't want to keep the pointer around unless we've really retained it.
-  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  if (set->hash_slots) {
+    // Large set: check the hash table to avoid a redundant retain.
+    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_hashed(set, resource));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+    if (IREE_UNLIKELY(set->unique_count >
+                      IREE_HAL_RESOURCE_SET_HASH_THRESHOLD)) {
+      // Crossed the threshold; build the table from all retained resources.
+      IREE_RETURN_IF_ERROR(iree_hal_resource_set_hash_resize(
+          set, IREE_HAL_RESOURCE_SET_HASH_MIN_CAPACITY));
+    }
+  }
 
   // Shift the MRU down and insert the new item at the head.
   memmove(&set->mru[1], &set->mru[0],
@@ -261,3 +416,19 @@ iree_hal_resource_set_insert(iree_hal_resource_set_t* set,
   }
   return iree_ok_status();
 }
+
+IREE_API_EXPORT iree_status_t iree_hal_resource_set_insert_strided(
+    iree_hal_resource_set_t* set, iree_host_size_t count, const void* elements,
+    iree_host_size_t element_offset, iree_host_size_t element_stride) {
+  const uint8_t* element_ptr = (const uint8_t*)elements + element_offset;
+  iree_hal_resource_t* last_resource = NULL;
+  for (iree_host_size_t i = 0; i < count; ++i, element_ptr += element_stride) {
+    iree_hal_resource_t* resource = *(iree_hal_resource_t* const*)element_ptr;
+    // Binding tables commonly reference the same buffer in adjacent bindings
+    // (or have unused bindings) and we can skip the MRU entirely for those.
+    if (!resource || resource == last_resource) continue;
+    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_1(set, resource));
+    last_resource = resource;
+  }
+  return iree_ok_status();
+}
@@ -66,6 +66,17 @@ typedef struct iree_hal_resource_set_chunk_t {
 #define IREE_HAL_RESOURCE_SET_MRU_SIZE \
   (iree_hardware_constructive_interference_size / sizeof(uintptr_t))
 
+// Number of resources a set will retain before switching from MRU-only
+// deduplication to precise deduplication with a hash table. Sets below this
+// size avoid the table entirely as the MRU catches most redundant insertions
+// and the occasional redundant retain is cheaper than maintaining the table.
+#define IREE_HAL_RESOURCE_SET_HASH_THRESHOLD 64
+
+// Number of slots in each group of the resource set hash table. Probing scans
+// an entire group at a time and we size groups to match the MRU so that a group
+// occupies a single cache line.
+#define IREE_HAL_RESOURCE_SET_HASH_GROUP_SIZE IREE_HAL_RESOURCE_SET_MRU_SIZE
+
 // "Efficient" append-only set for retaining a set of resources.
 // This is a non-deterministic data structure that tries to reduce the amount of
 // overhead involved in tracking a reasonably-sized set of resources (~dozens to
@@ -74,6 +85,10 @@ typedef struct iree_hal_resource_set_chunk_t {
 // redundant insertions with the expense of an additional atomic operation.
 //
 // This tries to elide insertions by maintaining a most-recently-used list.
+// Once a set grows beyond IREE_HAL_RESOURCE_SET_HASH_THRESHOLD resources MRU
+// misses are additionally checked against a hash table of all retained
+// resources so that large sets (command buffers with thousands of dispatches
+// over hundreds of buffers) don't accumulate redundant retains.
 // This optimizes for temporal locality of resources used (the same executables,
 // same buffers, etc) and is implemented to have a fixed cost regardless of
 // whether the values are found and should hopefully trigger enough to avoid the
@@ -111,6 +126,17 @@ typedef struct iree_hal_resource_set_t {
 
   // Linked list of storage chunks.
   iree_hal_resource_set_chunk_t* chunk_head;
+
+  // Number of resources retained by the set. Prior to the hash table being
+  // created this may include redundant insertions that missed the MRU.
+  iree_host_size_t unique_count;
+
+  // Open-addressed table of all retained resources with |hash_capacity| slots
+  // or NULL if the set has not yet grown beyond
+  // IREE_HAL_RESOURCE_SET_HASH_THRESHOLD resources. Allocated from the block
+  // pool block allocator as it may need to grow beyond the block size.
+  iree_hal_resource_t** hash_slots;
+  iree_host_size_t hash_capacity;
 } iree_hal_resource_set_t;
 
 // TODO(benvanik): add an allocation method that allows for placement; in many
@@ -133,6 +159,21 @@ IREE_API_EXPORT iree_status_t
 iree_hal_resource_set_insert(iree_hal_resource_set_t* set,
                              iree_host_size_t count, const void* resources);
 
+// Inserts the resources referenced by |count| elements of a strided array.
+// The resource pointer of each element is loaded from |element_offset| bytes
+// into the element and elements are |element_stride| bytes apart. NULL
+// resources are ignored. This allows binding tables and other structures
+// embedding resources to be inserted in a single call.
+//
+// Example:
+//   iree_hal_resource_set_insert_strided(
+//       set, binding_count, bindings,
+//       offsetof(iree_hal_descriptor_set_binding_t, buffer),
+//       sizeof(iree_hal_descriptor_set_binding_t));
+IREE_API_EXPORT iree_status_t iree_hal_resource_set_insert_strided(
+    iree_hal_resource_set_t* set, iree_host_size_t count, const void* elements,
+    iree_host_size_t element_offset, iree_host_size_t element_stride);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -96,7 +96,9 @@ static iree_status_t iree_hal_resource_set_benchmark_lifecycle_n(
 
 // Tests insertion performance when either the MRU is used (n < MRU size) or
 // the worst-case performance when all resources are unique and guaranteed to
-// miss the MRU. Expect to see a cliff where we spill the MRU.
+// miss the MRU. Expect to see a cliff where we spill the MRU and then a
+// plateau once the set exceeds IREE_HAL_RESOURCE_SET_HASH_THRESHOLD and misses
+// are resolved by the hash table.
 //
 // user_data is a count of unique elements to insert.
 static iree_status_t iree_hal_resource_set_benchmark_insert_n(
@@ -250,6 +252,12 @@ int main(int argc, char** argv) {
     benchmark_def.user_data = (void*)64u;
     iree_benchmark_register(iree_make_cstring_view("insert_64"),
                             &benchmark_def);
+    benchmark_def.user_data = (void*)256u;
+    iree_benchmark_register(iree_make_cstring_view("insert_256"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)1024u;
+    iree_benchmark_register(iree_make_cstring_view("insert_1024"),
+                            &benchmark_def);
   }
 
   // iree_hal_resource_set_benchmark_randomized_n
@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
@@ -252,6 +253,79 @@ TEST_F(ResourceSetTest, RedundantInsertion) {
   EXPECT_EQ(live_bitmap, 0u);
 }
 
+// Tests that large sets deduplicate precisely once they switch to hashing.
+TEST_F(ResourceSetTest, HashedDeduplication) {
+  auto resource_set = make_resource_set(&block_pool);
+
+  // Allocate enough resources to cross the hash threshold and force the table
+  // to grow a few times. Each group of 32 shares a live bitmap.
+  constexpr iree_host_size_t kResourceCount = 32 * 32;
+  static_assert(kResourceCount > IREE_HAL_RESOURCE_SET_HASH_THRESHOLD * 8,
+                "need enough resources to grow the hash table");
+  std::vector<iree_hal_resource_t*> resources(kResourceCount);
+  uint32_t live_bitmaps[kResourceCount / 32] = {0};
+  for (iree_host_size_t i = 0; i < resources.size(); ++i) {
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        i % 32, &live_bitmaps[i / 32], host_allocator, &resources[i]));
+  }
+
+  // Insert all resources several times; only the first insertion of each
+  // should retain once the table has been created.
+  for (int pass = 0; pass < 3; ++pass) {
+    IREE_ASSERT_OK(iree_hal_resource_set_insert(
+        resource_set.get(), resources.size(), resources.data()));
+  }
+  EXPECT_NE(resource_set->hash_slots, nullptr);
+  EXPECT_EQ(resource_set->unique_count, kResourceCount);
+  for (auto* resource : resources) {
+    EXPECT_EQ(iree_atomic_ref_count_load(&resource->ref_count), 2);
+  }
+
+  for (auto* resource : resources) iree_hal_resource_release(resource);
+  for (uint32_t live_bitmap : live_bitmaps) {
+    EXPECT_EQ(live_bitmap, 0xFFFFFFFFu);
+  }
+
+  // Ensure the set releases the resources.
+  resource_set.reset();
+  for (uint32_t live_bitmap : live_bitmaps) EXPECT_EQ(live_bitmap, 0u);
+}
+
+// Tests inserting resources embedded in a strided array of structures.
+TEST_F(ResourceSetTest, InsertStrided) {
+  auto resource_set = make_resource_set(&block_pool);
+
+  iree_hal_resource_t* resources[4] = {NULL};
+  uint32_t live_bitmap = 0u;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        i, &live_bitmap, host_allocator, &resources[i]));
+  }
+
+  // Table with NULL entries and adjacent duplicates like a binding table.
+  struct binding_t {
+    uint32_t ordinal;
+    iree_hal_resource_t* resource;
+    uint64_t length;
+  } bindings[] = {
+      {0, resources[0], 16}, {1, resources[0], 16}, {2, NULL, 0},
+      {3, resources[1], 16}, {4, resources[2], 16}, {5, resources[0], 16},
+      {6, resources[3], 16}, {7, NULL, 0},
+  };
+  IREE_ASSERT_OK(iree_hal_resource_set_insert_strided(
+      resource_set.get(), IREE_ARRAYSIZE(bindings), bindings,
+      offsetof(binding_t, resource), sizeof(bindings[0])));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    EXPECT_EQ(iree_atomic_ref_count_load(&resources[i]->ref_count), 2);
+    iree_hal_resource_release(resources[i]);
+  }
+  EXPECT_EQ(live_bitmap, 0xFu);
+
+  // Ensure the set releases the resources.
+  resource_set.reset();
+  EXPECT_EQ(live_bitmap, 0u);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
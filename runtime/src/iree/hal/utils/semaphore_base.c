@@ -34,6 +34,31 @@ static void iree_hal_semaphore_timepoint_list_push_back(
   list->tail = timepoint;
 }
 
+// Inserts |timepoint| into |list| after all timepoints with a minimum value
+// less than or equal to its own. Waiters usually arrive with increasing values
+// and we search from the tail so that the common case is constant-time.
+static void iree_hal_semaphore_timepoint_list_insert_sorted(
+    iree_hal_semaphore_timepoint_list_t* list,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  iree_hal_semaphore_timepoint_t* prev = list->tail;
+  while (prev && prev->minimum_value > timepoint->minimum_value) {
+    prev = prev->prev;
+  }
+  timepoint->prev = prev;
+  if (prev) {
+    timepoint->next = prev->next;
+    prev->next = timepoint;
+  } else {
+    timepoint->next = list->head;
+    list->head = timepoint;
+  }
+  if (timepoint->next) {
+    timepoint->next->prev = timepoint;
+  } else {
+    list->tail = timepoint;
+  }
+}
+
 // Erases |timepoint| from |list|.
 static void iree_hal_semaphore_timepoint_list_erase(
     iree_hal_semaphore_timepoint_list_t* list,
@@ -65,13 +90,44 @@ static void iree_hal_semaphore_timepoint_list_take_all(
   available_list->tail = NULL;
 }
 
+// Returns true if |timepoint| has a finite deadline and may expire.
+static inline bool iree_hal_semaphore_timepoint_has_deadline(
+    const iree_hal_semaphore_timepoint_t* timepoint) {
+  return timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE;
+}
+
+// Moves the prefix of the sorted |list| containing all timepoints satisfied by
+// |new_value| into |ready_list|. Only the satisfied timepoints are visited.
+// Returns the number of moved timepoints that had finite deadlines.
+static iree_host_size_t iree_hal_semaphore_timepoint_list_split_satisfied(
+    iree_hal_semaphore_timepoint_list_t* list, uint64_t new_value,
+    iree_hal_semaphore_timepoint_list_t* ready_list) {
+  iree_host_size_t deadline_count = 0;
+  iree_hal_semaphore_timepoint_t* last_ready = NULL;
+  for (iree_hal_semaphore_timepoint_t* timepoint = list->head;
+       timepoint != NULL && timepoint->minimum_value <= new_value;
+       timepoint = timepoint->next) {
+    if (iree_hal_semaphore_timepoint_has_deadline(timepoint)) ++deadline_count;
+    last_ready = timepoint;
+  }
+  if (!last_ready) return 0;
+  ready_list->head = list->head;
+  ready_list->tail = last_ready;
+  list->head = last_ready->next;
+  last_ready->next = NULL;
+  if (list->head) {
+    list->head->prev = NULL;
+  } else {
+    list->tail = NULL;
+  }
+  return deadline_count;
+}
+
 // Issues the callback for the given |timepoint| and resets it.
 static void iree_hal_semaphore_issue_timepoint_callback(
     iree_hal_semaphore_t* semaphore, uint64_t new_value,
     iree_status_code_t new_status_code,
     iree_hal_semaphore_timepoint_t* timepoint) {
-  IREE_TRACE_ZONE_BEGIN(z0);
-
   // Clean up the timepoint.
   // We do this before the callback so that the handler can reuse the
   // timepoint storage if it wants. After this we can't rely on it being
@@ -86,17 +142,17 @@ static void iree_hal_semaphore_issue_timepoint_callback(
   // Release semaphore that was retained by the timepoint.
   // This _shouldn't_ be the last owner as the caller has to have a reference.
   iree_hal_semaphore_release(semaphore);
-
-  IREE_TRACE_ZONE_END(z0);
 }
 
-// Issues callbacks for all timepoints in the |list|.
+// Issues callbacks for all timepoints in the |list| as a single batch.
 // Timepoints are released and the list is emptied upon return.
 static void iree_hal_semaphore_issue_timepoint_callbacks(
     iree_hal_semaphore_t* semaphore, uint64_t new_value,
     iree_status_code_t new_status_code,
     iree_hal_semaphore_timepoint_list_t* list) {
   if (iree_hal_semaphore_timepoint_list_is_empty(list)) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  int64_t callback_count = 0;
   for (iree_hal_semaphore_timepoint_t* timepoint = list->head;
        timepoint != NULL;) {
     list->head = timepoint->next;
@@ -104,9 +160,40 @@ static void iree_hal_semaphore_issue_timepoint_callbacks(
     timepoint->prev = NULL;
     iree_hal_semaphore_issue_timepoint_callback(semaphore, new_value,
                                                 new_status_code, timepoint);
+    ++callback_count;
     timepoint = list->head;
   }
   list->tail = NULL;
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, callback_count);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Moves all timepoints in the semaphore list whose deadline has passed into
+// |expired_list|. Only scans the list if the earliest deadline has been reached
+// and recomputes the earliest deadline of the remaining timepoints.
+// NOTE: semaphore timepoint lock must be held.
+static void iree_hal_semaphore_take_expired_timepoints(
+    iree_hal_semaphore_t* semaphore,
+    iree_hal_semaphore_timepoint_list_t* expired_list) {
+  if (semaphore->deadline_timepoint_count == 0) return;
+  iree_time_t now_ns = iree_time_now();
+  if (now_ns < semaphore->earliest_deadline_ns) return;
+  iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  for (iree_hal_semaphore_timepoint_t* timepoint =
+           semaphore->timepoint_list.head;
+       timepoint != NULL;) {
+    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
+    if (timepoint->deadline_ns <= now_ns) {
+      iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
+                                              timepoint);
+      iree_hal_semaphore_timepoint_list_push_back(expired_list, timepoint);
+      --semaphore->deadline_timepoint_count;
+    } else if (timepoint->deadline_ns < earliest_deadline_ns) {
+      earliest_deadline_ns = timepoint->deadline_ns;
+    }
+    timepoint = next_timepoint;
+  }
+  semaphore->earliest_deadline_ns = earliest_deadline_ns;
 }
 
 // NOTE: semaphore timepoint lock must not be held.
@@ -114,7 +201,6 @@ static void iree_hal_semaphore_resolve_timepoints(
     iree_hal_semaphore_t* semaphore, uint64_t new_value) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_semaphore_timepoint_list_t pending_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t ready_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t expired_list = {NULL, NULL};
 
@@ -126,33 +212,19 @@ static void iree_hal_semaphore_resolve_timepoints(
     return;
   }
 
-  // Scan through the list and divvy up timepoints into still-pending, ready to
-  // resolve, and expired buckets.
-  iree_time_t now_ns = iree_time_now();
-  for (iree_hal_semaphore_timepoint_t* timepoint =
-           semaphore->timepoint_list.head;
-       timepoint != NULL;) {
-    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
-    timepoint->next = NULL;
-
-    if (timepoint->minimum_value <= new_value) {
-      // Reached the timepoint; even if the deadline has been reached we'll
-      // still consider this a hit.
-      iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
-    } else if (timepoint->deadline_ns <= now_ns) {
-      // Deadline expired before the timepoint was reached.
-      iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
-    } else {
-      // Still pending.
-      iree_hal_semaphore_timepoint_list_push_back(&pending_list, timepoint);
-    }
-
-    timepoint = next_timepoint;
+  // Take all timepoints that have been reached; even if their deadlines have
+  // been reached we'll still consider them hits. As the list is sorted this
+  // only visits the timepoints being resolved.
+  semaphore->deadline_timepoint_count -=
+      iree_hal_semaphore_timepoint_list_split_satisfied(
+          &semaphore->timepoint_list, new_value, &ready_list);
+
+  // Take any still-pending timepoints whose deadlines have expired.
+  iree_hal_semaphore_take_expired_timepoints(semaphore, &expired_list);
+  if (semaphore->deadline_timepoint_count == 0) {
+    semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
   }
 
-  // Preserve pending timepoints.
-  semaphore->timepoint_list = pending_list;
-
   // Issue callbacks for all successes and failures.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, new_value,
                                                IREE_STATUS_OK, &ready_list);
@@ -175,6 +247,8 @@ static void iree_hal_semaphore_reject_timepoints(
   iree_hal_semaphore_timepoint_list_t failed_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_take_all(&semaphore->timepoint_list,
                                              &failed_list);
+  semaphore->deadline_timepoint_count = 0;
+  semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
 
   // Issue failure callbacks for all timepoints.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, UINT64_MAX,
@@ -197,6 +271,8 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
   iree_slim_mutex_initialize(&out_semaphore->timepoint_mutex);
   memset(&out_semaphore->timepoint_list, 0,
          sizeof(out_semaphore->timepoint_list));
+  out_semaphore->deadline_timepoint_count = 0;
+  out_semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
 }
 
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -228,8 +304,13 @@ IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
   // After we release the lock the callback may be issued immediately as another
   // thread may be waiting to signal the timepoint.
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
-  iree_hal_semaphore_timepoint_list_push_back(&semaphore->timepoint_list,
-                                              out_timepoint);
+  iree_hal_semaphore_timepoint_list_insert_sorted(&semaphore->timepoint_list,
+                                                  out_timepoint);
+  if (iree_hal_semaphore_timepoint_has_deadline(out_timepoint)) {
+    ++semaphore->deadline_timepoint_count;
+    semaphore->earliest_deadline_ns = iree_min(semaphore->earliest_deadline_ns,
+                                               out_timepoint->deadline_ns);
+  }
   iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
 
   IREE_TRACE_ZONE_END(z0);
@@ -252,6 +333,10 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
     // callback.
     iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
                                             timepoint);
+    if (iree_hal_semaphore_timepoint_has_deadline(timepoint) &&
+        --semaphore->deadline_timepoint_count == 0) {
+      semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+    }
 
     // Neuter the timepoint so that it is never called.
     // Other threads may be sitting and waiting for the lock and we need to
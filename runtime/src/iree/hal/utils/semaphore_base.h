@@ -66,9 +66,9 @@ typedef struct iree_hal_semaphore_timepoint_t {
   iree_hal_semaphore_callback_t callback;
 } iree_hal_semaphore_timepoint_t;
 
-// A doubly-linked FIFO list of timepoints.
-// The order of the timepoints does *not* match increasing payload values but
-// instead the order they were added to the list.
+// A doubly-linked list of timepoints sorted by increasing minimum value.
+// Timepoints with equal minimum values are kept in the order they were added to
+// the list so that waiters on the same value are resolved first-in first-out.
 //
 // Note that the timepoints are not owned by the list - this just nicely
 // stitches together timepoints for easier management.
@@ -95,14 +95,21 @@ struct iree_hal_semaphore_t {
   // Non-recursive mutex guarding access to the timepoint list.
   iree_slim_mutex_t timepoint_mutex;
 
-  // Timepoint list in insertion order.
-  // There are probably better orderings we could use here that allow us to
-  // walk the entire list less frequently, though target payload value is not
-  // enough as deadlines still require the scan. We could sort by non-infinite
-  // deadlines first and then infinite ones last but given the common timepoint
-  // counts (0..1) it's not worth the complexity today.
+  // Timepoint list sorted by minimum value.
+  // Notifying a new value only visits the satisfied prefix of the list and
+  // since waiters are usually added with increasing values insertion from the
+  // tail is usually constant-time.
   iree_hal_semaphore_timepoint_list_t timepoint_list
       IREE_GUARDED_BY(timepoint_mutex);
+
+  // Total number of timepoints in the list with a finite deadline.
+  // When zero no scan for expired timepoints is required.
+  iree_host_size_t deadline_timepoint_count IREE_GUARDED_BY(timepoint_mutex);
+
+  // Lower bound on the earliest deadline of any timepoint in the list.
+  // This may be stale (earlier than any remaining deadline) after timepoints
+  // are removed and is recomputed whenever the list is scanned for expiration.
+  iree_time_t earliest_deadline_ns IREE_GUARDED_BY(timepoint_mutex);
 };
 
 // Initializes the base |out_semaphore| resource.
@@ -0,0 +1,139 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
+#include "iree/testing/benchmark.h"
+
+typedef struct iree_hal_test_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+} iree_hal_test_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable;
+
+static iree_status_t iree_hal_test_semaphore_create(
+    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_test_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*semaphore),
+                                             (void**)&semaphore));
+  iree_hal_semaphore_initialize(&iree_hal_test_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  *out_semaphore = &semaphore->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_test_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_test_semaphore_t* semaphore =
+      (iree_hal_test_semaphore_t*)base_semaphore;
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(host_allocator, semaphore);
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable = {
+    .destroy = iree_hal_test_semaphore_destroy,
+};
+
+static iree_status_t iree_hal_semaphore_benchmark_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  ++*(uint64_t*)user_data;
+  return iree_ok_status();
+}
+
+// Tests the cost of resolving a single timepoint while N other timepoints are
+// pending on later values of the same timeline. This models many in-flight
+// requests waiting on a shared timeline where each signal only satisfies one.
+//
+// user_data is a count of pending timepoints.
+static iree_status_t iree_hal_semaphore_benchmark_notify_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  // Pending timepoints far in the future of the timeline that are never hit.
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints = NULL;
+  if (count > 0) {
+    IREE_CHECK_OK(iree_allocator_malloc(host_allocator,
+                                        sizeof(*timepoints) * count,
+                                        (void**)&timepoints));
+  }
+  uint64_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      iree_hal_semaphore_benchmark_callback,
+      &callback_count,
+  };
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_acquire_timepoint(semaphore, UINT64_MAX - count + i,
+                                         iree_infinite_timeout(), callback,
+                                         &timepoints[i]);
+  }
+
+  // Acquire and resolve one timepoint on each step of the timeline.
+  uint64_t value = 0;
+  iree_hal_semaphore_timepoint_t timepoint;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    ++value;
+    iree_hal_semaphore_acquire_timepoint(semaphore, value,
+                                         iree_infinite_timeout(), callback,
+                                         &timepoint);
+    iree_hal_semaphore_notify(semaphore, value, IREE_STATUS_OK);
+  }
+  IREE_ASSERT_EQ(callback_count, value);
+
+  // Cleanup.
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i]);
+  }
+  iree_allocator_free(host_allocator, timepoints);
+  iree_hal_semaphore_release(semaphore);
+
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_semaphore_benchmark_notify_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_notify_n,
+    };
+    benchmark_def.user_data = (void*)0u;
+    iree_benchmark_register(iree_make_cstring_view("notify_0"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)16u;
+    iree_benchmark_register(iree_make_cstring_view("notify_16"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)256u;
+    iree_benchmark_register(iree_make_cstring_view("notify_256"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)4096u;
+    iree_benchmark_register(iree_make_cstring_view("notify_4096"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
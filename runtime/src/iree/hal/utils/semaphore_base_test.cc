@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/wait_handle.h"
@@ -374,6 +375,120 @@ TEST_F(TrackingSemaphoreTest, CancelResolvedTimepoint) {
   iree_hal_semaphore_release(*semaphore);
 }
 
+// Tests that timepoints acquired out of order are resolved by value.
+TEST_F(TrackingSemaphoreTest, ResolveOutOfOrderTimepoints) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState states[4];
+  iree_hal_semaphore_timepoint_t timepoints[4];
+  const uint64_t values[4] = {3ull, 1ull, 2ull, 1ull};
+  for (int i = 0; i < 4; ++i) {
+    iree_hal_semaphore_acquire_timepoint(*semaphore, values[i],
+                                         iree_infinite_timeout(),
+                                         MakeCallback(&states[i]),
+                                         &timepoints[i]);
+  }
+
+  // Only the timepoints waiting on 1 are resolved.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 1ull));
+  EXPECT_EQ(states[0].callback_count, 0);
+  EXPECT_EQ(states[1].callback_count, 1);
+  EXPECT_EQ(states[2].callback_count, 0);
+  EXPECT_EQ(states[3].callback_count, 1);
+
+  // Signaling beyond all remaining timepoints resolves them together.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 3ull));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(states[i].callback_count, 1);
+    EXPECT_EQ(states[i].status_code, IREE_STATUS_OK);
+  }
+  EXPECT_EQ(states[0].value, 3ull);
+  EXPECT_EQ(states[2].value, 3ull);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests that timepoints with expired deadlines are rejected while others on
+// the same value remain pending.
+TEST_F(TrackingSemaphoreTest, ExpireTimepoint) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState expired_state;
+  iree_hal_semaphore_timepoint_t expired_timepoint;
+  iree_hal_semaphore_acquire_timepoint(*semaphore, 2ull,
+                                       iree_immediate_timeout(),
+                                       MakeCallback(&expired_state),
+                                       &expired_timepoint);
+  CallbackState pending_state;
+  iree_hal_semaphore_timepoint_t pending_timepoint;
+  iree_hal_semaphore_acquire_timepoint(*semaphore, 2ull,
+                                       iree_infinite_timeout(),
+                                       MakeCallback(&pending_state),
+                                       &pending_timepoint);
+
+  // Signaling a value that does not satisfy the timepoints expires the one
+  // with a deadline.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 1ull));
+  EXPECT_EQ(expired_state.callback_count, 1);
+  EXPECT_EQ(expired_state.status_code, IREE_STATUS_DEADLINE_EXCEEDED);
+  EXPECT_EQ(pending_state.callback_count, 0);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  EXPECT_EQ(expired_state.callback_count, 1);
+  EXPECT_EQ(pending_state.callback_count, 1);
+  EXPECT_EQ(pending_state.status_code, IREE_STATUS_OK);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests cancelling a timepoint in the middle of the pending timepoints.
+TEST_F(TrackingSemaphoreTest, CancelInterleavedTimepoint) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState states[3];
+  iree_hal_semaphore_timepoint_t timepoints[3];
+  for (int i = 0; i < 3; ++i) {
+    iree_hal_semaphore_acquire_timepoint(
+        *semaphore, i + 1ull, iree_make_timeout_ms(60 * 1000),
+        MakeCallback(&states[i]), &timepoints[i]);
+  }
+  iree_hal_semaphore_cancel_timepoint(*semaphore, &timepoints[1]);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 3ull));
+  EXPECT_EQ(states[0].callback_count, 1);
+  EXPECT_EQ(states[1].callback_count, 0);
+  EXPECT_EQ(states[2].callback_count, 1);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests signaling a timeline with many pending timepoints where each signal
+// only resolves a few of them. Each signal should only issue the callbacks of
+// the timepoints it satisfies regardless of how many are pending.
+TEST_F(TrackingSemaphoreTest, ScaleManyTimepoints) {
+  for (int count : {16, 256, 4096}) {
+    auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+    // Each value has two waiters to test coalescing of equal values.
+    CallbackState state;
+    std::vector<iree_hal_semaphore_timepoint_t> timepoints(count);
+    for (int i = 0; i < count; ++i) {
+      iree_hal_semaphore_acquire_timepoint(*semaphore, i / 2 + 1ull,
+                                           iree_infinite_timeout(),
+                                           MakeCallback(&state),
+                                           &timepoints[i]);
+    }
+
+    for (int i = 0; i < count / 2; ++i) {
+      IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, i + 1ull));
+      ASSERT_EQ(state.callback_count, (i + 1) * 2);
+      ASSERT_EQ(state.value, i + 1ull);
+    }
+
+    iree_hal_semaphore_release(*semaphore);
+  }
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -0,0 +1,319 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_archive.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_t
+//===----------------------------------------------------------------------===//
+
+struct iree_io_parameter_archive_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Archive contents referenced by all parameters.
+  iree_const_byte_span_t contents;
+  // Used to free |contents| when the archive is destroyed.
+  iree_allocator_t contents_deallocator;
+  // Parameters sorted by key for lookup.
+  iree_host_size_t parameter_count;
+  iree_io_parameter_t parameters[];
+};
+
+static int iree_io_parameter_compare(const void* lhs, const void* rhs) {
+  return iree_string_view_compare(((const iree_io_parameter_t*)lhs)->key,
+                                  ((const iree_io_parameter_t*)rhs)->key);
+}
+
+// Returns true if the range [offset, offset + length) is within |contents|.
+static bool iree_io_parameter_archive_range_is_valid(
+    iree_const_byte_span_t contents, uint64_t offset, uint64_t length) {
+  return offset <= contents.data_length &&
+         length <= contents.data_length - offset;
+}
+
+// Reads the records of the archive in |contents| into |out_parameters|, which
+// must have capacity for |parameter_count| parameters.
+static iree_status_t iree_io_parameter_archive_parse_records(
+    iree_const_byte_span_t contents, iree_host_size_t parameter_count,
+    iree_io_parameter_t* out_parameters) {
+  const iree_io_parameter_archive_record_t* records =
+      (const iree_io_parameter_archive_record_t*)(
+          contents.data + sizeof(iree_io_parameter_archive_header_t));
+  for (iree_host_size_t i = 0; i < parameter_count; ++i) {
+    const iree_io_parameter_archive_record_t* record = &records[i];
+    uint64_t key_offset = iree_unaligned_load_le_u64(&record->key_offset);
+    uint64_t key_length = iree_unaligned_load_le_u64(&record->key_length);
+    uint64_t data_offset = iree_unaligned_load_le_u64(&record->data_offset);
+    uint64_t data_length = iree_unaligned_load_le_u64(&record->data_length);
+    if (!iree_io_parameter_archive_range_is_valid(contents, key_offset,
+                                                  key_length) ||
+        !iree_io_parameter_archive_range_is_valid(contents, data_offset,
+                                                  data_length)) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "parameter archive record %" PRIhsz
+                              " references data outside of the archive",
+                              i);
+    }
+    out_parameters[i].key =
+        iree_make_string_view((const char*)contents.data + key_offset,
+                              (iree_host_size_t)key_length);
+    out_parameters[i].data = iree_make_const_byte_span(
+        contents.data + data_offset, (iree_host_size_t)data_length);
+  }
+
+  qsort(out_parameters, parameter_count, sizeof(out_parameters[0]),
+        iree_io_parameter_compare);
+  for (iree_host_size_t i = 1; i < parameter_count; ++i) {
+    if (iree_string_view_equal(out_parameters[i - 1].key,
+                               out_parameters[i].key)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "parameter archive has duplicate key '%.*s'",
+                              (int)out_parameters[i].key.size,
+                              out_parameters[i].key.data);
+    }
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_wrap(
+    iree_const_byte_span_t contents, iree_allocator_t contents_deallocator,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_archive_t** out_archive) {
+  IREE_ASSERT_ARGUMENT(out_archive);
+  *out_archive = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)contents.data_length);
+
+  if (contents.data_length < sizeof(iree_io_parameter_archive_header_t)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter archive too small for header");
+  }
+  const iree_io_parameter_archive_header_t* header =
+      (const iree_io_parameter_archive_header_t*)contents.data;
+  if (iree_unaligned_load_le_u32(&header->magic) !=
+      IREE_IO_PARAMETER_ARCHIVE_MAGIC) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter archive magic mismatch");
+  }
+  uint32_t version = iree_unaligned_load_le_u32(&header->version);
+  if (version != IREE_IO_PARAMETER_ARCHIVE_FORMAT_VERSION) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "parameter archive version %u not supported",
+                            version);
+  }
+  uint64_t entry_count = iree_unaligned_load_le_u64(&header->entry_count);
+  if (entry_count > (contents.data_length - sizeof(*header)) /
+                        sizeof(iree_io_parameter_archive_record_t)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "parameter archive record table truncated");
+  }
+  iree_host_size_t parameter_count = (iree_host_size_t)entry_count;
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)parameter_count);
+
+  iree_io_parameter_archive_t* archive = NULL;
+  iree_host_size_t total_size =
+      sizeof(*archive) + parameter_count * sizeof(archive->parameters[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&archive));
+  iree_atomic_ref_count_init(&archive->ref_count);
+  archive->host_allocator = host_allocator;
+  archive->contents = contents;
+  archive->contents_deallocator = iree_allocator_null();
+  archive->parameter_count = parameter_count;
+
+  iree_status_t status = iree_io_parameter_archive_parse_records(
+      contents, parameter_count, archive->parameters);
+
+  if (iree_status_is_ok(status)) {
+    archive->contents_deallocator = contents_deallocator;
+    *out_archive = archive;
+  } else {
+    iree_io_parameter_archive_release(archive);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_open_file(
+    const char* path, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_t** out_archive) {
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(out_archive);
+  *out_archive = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path);
+
+  iree_file_contents_t* file_contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_file_read_contents(path, IREE_FILE_READ_FLAG_MMAP,
+                                  host_allocator, &file_contents));
+
+  iree_status_t status = iree_io_parameter_archive_wrap(
+      file_contents->const_buffer,
+      iree_file_contents_deallocator(file_contents), host_allocator,
+      out_archive);
+  if (!iree_status_is_ok(status)) {
+    iree_file_contents_free(file_contents);
+    status = iree_status_annotate_f(status, "opening parameter archive '%s'",
+                                    path);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_io_parameter_archive_destroy(
+    iree_io_parameter_archive_t* archive) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = archive->host_allocator;
+  iree_allocator_free(archive->contents_deallocator,
+                      (void*)archive->contents.data);
+  iree_allocator_free(host_allocator, archive);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_retain(
+    iree_io_parameter_archive_t* archive) {
+  if (IREE_LIKELY(archive)) {
+    iree_atomic_ref_count_inc(&archive->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_release(
+    iree_io_parameter_archive_t* archive) {
+  if (IREE_LIKELY(archive) &&
+      iree_atomic_ref_count_dec(&archive->ref_count) == 1) {
+    iree_io_parameter_archive_destroy(archive);
+  }
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_io_parameter_archive_count(const iree_io_parameter_archive_t* archive) {
+  IREE_ASSERT_ARGUMENT(archive);
+  return archive->parameter_count;
+}
+
+IREE_API_EXPORT const iree_io_parameter_t* iree_io_parameter_archive_at(
+    const iree_io_parameter_archive_t* archive, iree_host_size_t index) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_LT(index, archive->parameter_count);
+  return &archive->parameters[index];
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_lookup(
+    const iree_io_parameter_archive_t* archive, iree_string_view_t key,
+    iree_host_size_t* out_index) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_ARGUMENT(out_index);
+  *out_index = 0;
+  iree_host_size_t low = 0;
+  iree_host_size_t high = archive->parameter_count;
+  while (low < high) {
+    iree_host_size_t mid = low + (high - low) / 2;
+    int cmp = iree_string_view_compare(archive->parameters[mid].key, key);
+    if (cmp == 0) {
+      *out_index = mid;
+      return iree_ok_status();
+    } else if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "parameter '%.*s' not found in archive",
+                          (int)key.size, key.data);
+}
+
+//===----------------------------------------------------------------------===//
+// Archive construction
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_build(
+    iree_host_size_t parameter_count, const iree_io_parameter_t* parameters,
+    iree_allocator_t allocator, iree_byte_span_t* out_contents) {
+  IREE_ASSERT_ARGUMENT(!parameter_count || parameters);
+  IREE_ASSERT_ARGUMENT(out_contents);
+  *out_contents = iree_make_byte_span(NULL, 0);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)parameter_count);
+
+  for (iree_host_size_t i = 0; i < parameter_count; ++i) {
+    for (iree_host_size_t j = i + 1; j < parameter_count; ++j) {
+      if (iree_string_view_equal(parameters[i].key, parameters[j].key)) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "duplicate parameter key '%.*s'",
+                                (int)parameters[i].key.size,
+                                parameters[i].key.data);
+      }
+    }
+  }
+
+  // Compute the layout: header, records, keys, then aligned data.
+  iree_host_size_t key_offset =
+      sizeof(iree_io_parameter_archive_header_t) +
+      parameter_count * sizeof(iree_io_parameter_archive_record_t);
+  iree_host_size_t data_offset = key_offset;
+  for (iree_host_size_t i = 0; i < parameter_count; ++i) {
+    data_offset += parameters[i].key.size;
+  }
+  iree_host_size_t total_size = data_offset;
+  for (iree_host_size_t i = 0; i < parameter_count; ++i) {
+    total_size = iree_host_align(total_size,
+                                 IREE_IO_PARAMETER_ARCHIVE_DATA_ALIGNMENT) +
+                 parameters[i].data.data_length;
+  }
+
+  uint8_t* contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&contents));
+  memset(contents, 0, total_size);
+
+  iree_io_parameter_archive_header_t* header =
+      (iree_io_parameter_archive_header_t*)contents;
+  iree_unaligned_store_le_u32(&header->magic, IREE_IO_PARAMETER_ARCHIVE_MAGIC);
+  iree_unaligned_store_le_u32(&header->version,
+                              IREE_IO_PARAMETER_ARCHIVE_FORMAT_VERSION);
+  iree_unaligned_store_le_u64(&header->entry_count, parameter_count);
+  iree_io_parameter_archive_record_t* records =
+      (iree_io_parameter_archive_record_t*)(contents + sizeof(*header));
+  for (iree_host_size_t i = 0; i < parameter_count; ++i) {
+    const iree_io_parameter_t* parameter = &parameters[i];
+    data_offset =
+        iree_host_align(data_offset, IREE_IO_PARAMETER_ARCHIVE_DATA_ALIGNMENT);
+    iree_unaligned_store_le_u64(&records[i].key_offset, key_offset);
+    iree_unaligned_store_le_u64(&records[i].key_length, parameter->key.size);
+    iree_unaligned_store_le_u64(&records[i].data_offset, data_offset);
+    iree_unaligned_store_le_u64(&records[i].data_length,
+                                parameter->data.data_length);
+    if (parameter->key.size) {
+      memcpy(contents + key_offset, parameter->key.data, parameter->key.size);
+    }
+    if (parameter->data.data_length) {
+      memcpy(contents + data_offset, parameter->data.data,
+             parameter->data.data_length);
+    }
+    key_offset += parameter->key.size;
+    data_offset += parameter->data.data_length;
+  }
+
+  *out_contents = iree_make_byte_span(contents, total_size);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
@@ -0,0 +1,132 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_ARCHIVE_H_
+#define IREE_IO_PARAMETER_ARCHIVE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Parameter archive file format
+//===----------------------------------------------------------------------===//
+//
+// A parameter archive is an indexed set of named byte blobs (usually model
+// weights) stored outside of compiled modules so that any number of modules,
+// contexts, and processes can share a single copy. Archives are designed to be
+// memory-mapped: entry data is aligned such that it can be imported directly
+// as device buffers on devices that support host memory import.
+//
+// File layout (all fields little-endian):
+//   iree_io_parameter_archive_header_t
+//   iree_io_parameter_archive_record_t[entry_count]
+//   key storage (keys are not NUL terminated)
+//   entry data, each aligned to IREE_IO_PARAMETER_ARCHIVE_DATA_ALIGNMENT
+//
+// All offsets are absolute from the start of the file. Keys must be unique.
+
+// Little-endian magic bytes used to identify parameter archives.
+#define IREE_IO_PARAMETER_ARCHIVE_MAGIC 0x41505249  // 'IRPA'
+
+// Only version 0 is defined.
+#define IREE_IO_PARAMETER_ARCHIVE_FORMAT_VERSION 0
+
+// Alignment of each entry's data relative to the start of the file.
+// Mapped files are page aligned so this is also the alignment in memory.
+#define IREE_IO_PARAMETER_ARCHIVE_DATA_ALIGNMENT 64
+
+typedef struct iree_io_parameter_archive_header_t {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t entry_count;
+} iree_io_parameter_archive_header_t;
+static_assert(sizeof(iree_io_parameter_archive_header_t) == 16,
+              "header is part of the file format");
+
+typedef struct iree_io_parameter_archive_record_t {
+  uint64_t key_offset;
+  uint64_t key_length;
+  uint64_t data_offset;
+  uint64_t data_length;
+} iree_io_parameter_archive_record_t;
+static_assert(sizeof(iree_io_parameter_archive_record_t) == 32,
+              "record is part of the file format");
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_t
+//===----------------------------------------------------------------------===//
+
+// A named parameter referencing its data within an archive.
+typedef struct iree_io_parameter_t {
+  iree_string_view_t key;
+  iree_const_byte_span_t data;
+} iree_io_parameter_t;
+
+// A reference-counted index over the contents of a parameter archive.
+// Parameters reference the archive contents directly and remain valid for as
+// long as the archive is retained. Archives are immutable and thread-safe.
+typedef struct iree_io_parameter_archive_t iree_io_parameter_archive_t;
+
+// Creates an archive index over |contents| in memory.
+// On success the archive takes ownership of |contents| and frees it with
+// |contents_deallocator| (which may be iree_allocator_null() if the contents
+// are externally owned and outlive the archive). On failure ownership remains
+// with the caller.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_wrap(
+    iree_const_byte_span_t contents, iree_allocator_t contents_deallocator,
+    iree_allocator_t host_allocator, iree_io_parameter_archive_t** out_archive);
+
+// Memory-maps the archive file at |path| read-only and creates an index over
+// it. Pages are shared with the system page cache so multiple processes
+// mapping the same file only keep one copy resident.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_open_file(
+    const char* path, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_t** out_archive);
+
+// Retains the given |archive| for the caller.
+IREE_API_EXPORT void iree_io_parameter_archive_retain(
+    iree_io_parameter_archive_t* archive);
+
+// Releases the given |archive| from the caller.
+IREE_API_EXPORT void iree_io_parameter_archive_release(
+    iree_io_parameter_archive_t* archive);
+
+// Returns the total number of parameters in |archive|.
+IREE_API_EXPORT iree_host_size_t
+iree_io_parameter_archive_count(const iree_io_parameter_archive_t* archive);
+
+// Returns the parameter at |index| in the range [0, count).
+// Parameters are ordered by key.
+IREE_API_EXPORT const iree_io_parameter_t* iree_io_parameter_archive_at(
+    const iree_io_parameter_archive_t* archive, iree_host_size_t index);
+
+// Looks up the parameter with |key| and returns its index in |out_index|.
+// Returns IREE_STATUS_NOT_FOUND if the archive has no such parameter.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_lookup(
+    const iree_io_parameter_archive_t* archive, iree_string_view_t key,
+    iree_host_size_t* out_index);
+
+//===----------------------------------------------------------------------===//
+// Archive construction
+//===----------------------------------------------------------------------===//
+
+// Serializes |parameters| into a new archive allocated from |allocator|.
+// The caller must free |out_contents| with the same allocator.
+// Fails with IREE_STATUS_INVALID_ARGUMENT if any keys are duplicated.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_build(
+    iree_host_size_t parameter_count, const iree_io_parameter_t* parameters,
+    iree_allocator_t allocator, iree_byte_span_t* out_contents);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_ARCHIVE_H_
@@ -0,0 +1,127 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_archive.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class ParameterArchiveTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    iree_io_parameter_archive_release(archive_);
+    iree_allocator_free(iree_allocator_system(), contents_.data);
+  }
+
+  // Builds an archive from |keys| where each parameter contains its key.
+  void Build(const std::vector<std::string>& keys) {
+    std::vector<iree_io_parameter_t> parameters;
+    for (const auto& key : keys) {
+      iree_io_parameter_t parameter;
+      parameter.key = iree_make_string_view(key.data(), key.size());
+      parameter.data = iree_make_const_byte_span(key.data(), key.size());
+      parameters.push_back(parameter);
+    }
+    IREE_ASSERT_OK(iree_io_parameter_archive_build(
+        parameters.size(), parameters.data(), iree_allocator_system(),
+        &contents_));
+  }
+
+  iree_status_t Wrap() {
+    return iree_io_parameter_archive_wrap(
+        iree_make_const_byte_span(contents_.data, contents_.data_length),
+        iree_allocator_null(), iree_allocator_system(), &archive_);
+  }
+
+  iree_byte_span_t contents_ = iree_make_byte_span(NULL, 0);
+  iree_io_parameter_archive_t* archive_ = NULL;
+};
+
+TEST_F(ParameterArchiveTest, Empty) {
+  Build({});
+  IREE_ASSERT_OK(Wrap());
+  EXPECT_EQ(0, iree_io_parameter_archive_count(archive_));
+  iree_host_size_t index = 0;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_io_parameter_archive_lookup(archive_, IREE_SV("a"), &index));
+}
+
+TEST_F(ParameterArchiveTest, Lookup) {
+  Build({"weight.2", "", "weight.0", "bias"});
+  IREE_ASSERT_OK(Wrap());
+  ASSERT_EQ(4, iree_io_parameter_archive_count(archive_));
+  for (const char* key : {"weight.2", "", "weight.0", "bias"}) {
+    iree_host_size_t index = 0;
+    IREE_ASSERT_OK(iree_io_parameter_archive_lookup(
+        archive_, iree_make_cstring_view(key), &index));
+    const iree_io_parameter_t* parameter =
+        iree_io_parameter_archive_at(archive_, index);
+    EXPECT_TRUE(
+        iree_string_view_equal(parameter->key, iree_make_cstring_view(key)));
+    ASSERT_EQ(strlen(key), parameter->data.data_length);
+    EXPECT_EQ(0, memcmp(key, parameter->data.data, strlen(key)));
+  }
+  iree_host_size_t index = 0;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_io_parameter_archive_lookup(archive_, IREE_SV("weight.1"), &index));
+}
+
+// Parameters are ordered by key and their data is aligned for import.
+TEST_F(ParameterArchiveTest, OrderedAndAligned) {
+  Build({"c", "a", "b"});
+  IREE_ASSERT_OK(Wrap());
+  const char* expected_keys[] = {"a", "b", "c"};
+  for (iree_host_size_t i = 0; i < 3; ++i) {
+    const iree_io_parameter_t* parameter =
+        iree_io_parameter_archive_at(archive_, i);
+    EXPECT_TRUE(iree_string_view_equal(
+        parameter->key, iree_make_cstring_view(expected_keys[i])));
+    EXPECT_EQ(0, (parameter->data.data - contents_.data) %
+                     IREE_IO_PARAMETER_ARCHIVE_DATA_ALIGNMENT);
+  }
+}
+
+TEST_F(ParameterArchiveTest, BuildDuplicateKeys) {
+  iree_io_parameter_t parameters[2] = {
+      {IREE_SV("a"), iree_const_byte_span_empty()},
+      {IREE_SV("a"), iree_const_byte_span_empty()},
+  };
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_io_parameter_archive_build(IREE_ARRAYSIZE(parameters), parameters,
+                                      iree_allocator_system(), &contents_));
+}
+
+TEST_F(ParameterArchiveTest, WrapInvalidMagic) {
+  Build({"a"});
+  contents_.data[0] ^= 0xFF;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT, Wrap());
+  EXPECT_EQ(NULL, archive_);
+}
+
+TEST_F(ParameterArchiveTest, WrapTruncated) {
+  Build({"a", "b"});
+  contents_.data_length = sizeof(iree_io_parameter_archive_header_t) +
+                          sizeof(iree_io_parameter_archive_record_t);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, Wrap());
+}
+
+TEST_F(ParameterArchiveTest, WrapDataOutOfRange) {
+  Build({"a"});
+  contents_.data_length -= 1;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, Wrap());
+}
+
+}  // namespace
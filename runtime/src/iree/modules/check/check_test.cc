@@ -546,6 +546,19 @@ TEST_F(CheckTest, ExpectAlmostEqDifferentContents3DFullMessageFailure) {
       "    2x2x2xf32=[[1 2][3 42]][[5 6][7 8]]");
 }
 
+TEST_F(CheckTest, ExpectAlmostEqDifferentContentsStatsFailure) {
+  vm::ref<iree_hal_buffer_view_t> lhs;
+  vm::ref<iree_hal_buffer_view_t> rhs;
+  float lhs_contents[] = {1, 2, 3, 4};
+  float rhs_contents[] = {1, 2.5, 3, 3};
+  iree_hal_dim_t shape[] = {4};
+  ASSERT_NO_FATAL_FAILURE(CreateFloat32BufferView(lhs_contents, shape, &lhs));
+  ASSERT_NO_FATAL_FAILURE(CreateFloat32BufferView(rhs_contents, shape, &rhs));
+  EXPECT_NONFATAL_FAILURE(
+      IREE_ASSERT_OK(Invoke("expect_almost_eq", {lhs, rhs})),
+      "  2 of 4 elements mismatched; max abs error 1 at index 3");
+}
+
 TEST_F(CheckTest, ExpectAlmostEqIdenticalBufferF16Success) {
   vm::ref<iree_hal_buffer_view_t> lhs;
   vm::ref<iree_hal_buffer_view_t> rhs;
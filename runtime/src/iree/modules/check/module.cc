@@ -18,10 +18,10 @@
 #include <vector>
 
 #include "iree/base/api.h"
-#include "iree/base/internal/math.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/module.h"
 #include "iree/testing/gtest.h"
+#include "iree/tooling/buffer_view_matchers.h"
 #include "iree/vm/api.h"
 #include "iree/vm/native_module_cc.h"
 
@@ -66,56 +66,63 @@ bool EqByteSpan(iree_byte_span_t lhs_bytes, iree_byte_span_t rhs_bytes) {
          memcmp(lhs_bytes.data, rhs_bytes.data, lhs_bytes.data_length) == 0;
 }
 
-static constexpr float kF32PrecisionThreshold = 0.0001f;
-
-template <typename T>
-bool AlmostEqByteSpan(iree_byte_span_t lhs_bytes, iree_byte_span_t rhs_bytes) {
-  auto lhs_span = ToSpan<T>(lhs_bytes);
-  auto rhs_span = ToSpan<T>(rhs_bytes);
-  assert(lhs_span.size() == rhs_span.size());
-  for (int i = 0; i < lhs_span.size(); ++i) {
-    if (fabs(lhs_span[i] - rhs_span[i]) > kF32PrecisionThreshold) {
-      return false;
-    }
-  }
-  return true;
-}
-
-static constexpr float kF16PrecisionThreshold = 0.001f;
-
-bool AlmostEqByteSpanF16(iree_byte_span_t lhs_bytes,
-                         iree_byte_span_t rhs_bytes) {
-  auto lhs_span = ToSpan<uint16_t>(lhs_bytes);
-  auto rhs_span = ToSpan<uint16_t>(rhs_bytes);
-  assert(lhs_span.size() == rhs_span.size());
-  for (int i = 0; i < lhs_span.size(); ++i) {
-    if (fabs(iree_math_f16_to_f32(lhs_span[i]) -
-             iree_math_f16_to_f32(rhs_span[i])) > kF16PrecisionThreshold) {
-      return false;
-    }
-  }
-  return true;
-}
+static constexpr iree_hal_buffer_equality_t kAlmostEquality = {
+    IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE,
+    /*f16_threshold=*/0.001f,
+    /*f32_threshold=*/0.0001f,
+    /*f64_threshold=*/0.0001,
+};
 
+// Compares |lhs_bytes| and |rhs_bytes| with an absolute tolerance. When the
+// contents do not match error statistics are written to |out_summary|.
 StatusOr<bool> AlmostEqByteSpan(iree_byte_span_t lhs_bytes,
                                 iree_byte_span_t rhs_bytes,
-                                iree_hal_element_type_t element_type) {
+                                iree_hal_element_type_t element_type,
+                                std::string* out_summary) {
   switch (element_type) {
     case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
-      return AlmostEqByteSpan<float>(lhs_bytes, rhs_bytes);
     case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
-      return AlmostEqByteSpan<double>(lhs_bytes, rhs_bytes);
     case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
-      return AlmostEqByteSpanF16(lhs_bytes, rhs_bytes);
-    default:
-      // TODO(gcmn): Consider supporting fuzzy matching for quantized integers.
       break;
+    default: {
+      // TODO(gcmn): Consider supporting fuzzy matching for quantized integers.
+      char element_type_str[16];
+      IREE_RETURN_IF_ERROR(iree_hal_format_element_type(
+          element_type, sizeof(element_type_str), element_type_str, nullptr));
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unsupported element type %s", element_type_str);
+    }
   }
-  char element_type_str[16];
-  IREE_RETURN_IF_ERROR(iree_hal_format_element_type(
-      element_type, sizeof(element_type_str), element_type_str, nullptr));
-  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                          "unsupported element type %s", element_type_str);
+  assert(lhs_bytes.data_length == rhs_bytes.data_length);
+  iree_host_size_t element_count =
+      lhs_bytes.data_length / iree_hal_element_dense_byte_count(element_type);
+  iree_const_byte_span_t lhs_span =
+      iree_make_const_byte_span(lhs_bytes.data, lhs_bytes.data_length);
+  iree_const_byte_span_t rhs_span =
+      iree_make_const_byte_span(rhs_bytes.data, rhs_bytes.data_length);
+  iree_host_size_t index = 0;
+  if (iree_hal_compare_buffer_elements_elementwise(
+          kAlmostEquality, element_type, element_count, lhs_span, rhs_span,
+          &index)) {
+    return true;
+  }
+
+  // Only pay for the full statistics pass once a mismatch is known.
+  iree_hal_buffer_element_stats_t stats;
+  IREE_RETURN_IF_ERROR(iree_hal_compute_buffer_element_stats(
+      kAlmostEquality, element_type, element_count, lhs_span, rhs_span,
+      iree_allocator_system(), &stats));
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  iree_status_t status =
+      iree_hal_append_buffer_element_stats_string(&stats, &builder);
+  if (iree_status_is_ok(status)) {
+    out_summary->assign(iree_string_builder_buffer(&builder),
+                        iree_string_builder_size(&builder));
+  }
+  iree_string_builder_deinitialize(&builder);
+  IREE_RETURN_IF_ERROR(status);
+  return false;
 }
 
 Status ExpectAllTrue(iree_byte_span_t bytes,
@@ -313,11 +320,13 @@ class CheckModuleState final {
     bool shape_eq = lhs_shape == rhs_shape;
     // Only check contents if shape and element type match. Otherwise we can't.
     bool contents_could_be_almost_eq = true;
+    std::string contents_summary;
     if (element_types_eq && shape_eq) {
       IREE_ASSIGN_OR_RETURN(
           contents_could_be_almost_eq,
           AlmostEqByteSpan(lhs_mapped_memory.contents,
-                           rhs_mapped_memory.contents, lhs_element_type));
+                           rhs_mapped_memory.contents, lhs_element_type,
+                           &contents_summary));
     }
     iree_status_ignore(iree_hal_buffer_unmap_range(&lhs_mapped_memory));
     iree_status_ignore(iree_hal_buffer_unmap_range(&rhs_mapped_memory));
@@ -347,6 +356,13 @@ class CheckModuleState final {
       IREE_ASSIGN_OR_RETURN(auto rhs_str, BufferViewToString(rhs));
       os << rhs_str;
 
+      // The buffer views are truncated when printed so summarize all elements.
+      if (!contents_summary.empty()) {
+        os << "\n"
+              "  "
+           << contents_summary;
+      }
+
       // TODO(gcmn): Use ADD_FAILURE_AT to propagate source location.
       ADD_FAILURE() << os.str();
     }
@@ -69,6 +69,9 @@ EXPORT_FN("device.queue.dealloca", iree_hal_module_device_queue_dealloca, rIrrr,
 EXPORT_FN("device.queue.execute", iree_hal_module_device_queue_execute, rIrrCrD, v)
 EXPORT_FN("device.queue.flush", iree_hal_module_device_queue_flush, rI, v)
 
+EXPORT_FN("devices.count", iree_hal_module_devices_count, v, i)
+EXPORT_FN("devices.get", iree_hal_module_devices_get, i, r)
+
 EXPORT_FN("ex.shared_device", iree_hal_module_ex_shared_device, v, r)
 
 EXPORT_FN("executable.create", iree_hal_module_executable_create, rrrrCrD, r)
@@ -10,6 +10,8 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/profiling.h"
+#include "iree/hal/local/workgroup_pool.h"
 #include "iree/vm/api.h"
 
 #define IREE_HAL_LOADER_MODULE_VERSION_0_0 0x00000000u
@@ -22,6 +24,9 @@
 typedef struct iree_hal_loader_module_t {
   iree_allocator_t host_allocator;
   iree_hal_loader_module_flags_t flags;
+  // Optional pool used to distribute dispatch workgroups across threads.
+  // When NULL dispatches execute serially on the calling thread.
+  iree_hal_local_workgroup_pool_t* workgroup_pool;
   // TODO(benvanik): types.
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
@@ -41,6 +46,7 @@ static void IREE_API_PTR iree_hal_loader_module_destroy(void* base_module) {
   for (iree_host_size_t i = 0; i < module->loader_count; ++i) {
     iree_hal_executable_loader_release(module->loaders[i]);
   }
+  iree_hal_local_workgroup_pool_free(module->workgroup_pool);
 }
 
 static iree_status_t IREE_API_PTR
@@ -155,8 +161,13 @@ static iree_status_t iree_hal_loader_module_try_load(
     // The loader _may_ handle the executable; if the specific executable is not
     // supported then the try will fail with IREE_STATUS_CANCELLED and we should
     // continue trying other loaders.
+    iree_host_size_t worker_capacity =
+        loader_module->workgroup_pool
+            ? iree_hal_local_workgroup_pool_worker_capacity(
+                  loader_module->workgroup_pool)
+            : 1;
     iree_status_t status = iree_hal_executable_loader_try_load(
-        loader, executable_params, /*worker_capacity=*/1, out_executable);
+        loader, executable_params, worker_capacity, out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
       return status;
@@ -238,6 +249,58 @@ typedef struct {
   const iree_vm_abi_rII_t* bindings;
 } iree_hal_loader_dispatch_args_t;
 
+typedef struct iree_hal_loader_workgroup_args_t {
+  iree_hal_local_executable_t* executable;
+  iree_host_size_t ordinal;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state;
+} iree_hal_loader_workgroup_args_t;
+
+static iree_status_t iree_hal_loader_module_issue_workgroup(
+    void* user_data,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  const iree_hal_loader_workgroup_args_t* args =
+      (const iree_hal_loader_workgroup_args_t*)user_data;
+  return iree_hal_local_executable_issue_call(args->executable, args->ordinal,
+                                              args->dispatch_state,
+                                              workgroup_state, worker_id);
+}
+
+// Issues all workgroups of the dispatch across the threads in |pool|.
+// Equivalent to iree_hal_local_executable_issue_dispatch_inline but with
+// workgroups executed concurrently.
+static iree_status_t iree_hal_loader_module_issue_dispatch_parallel(
+    iree_hal_local_workgroup_pool_t* pool,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(executable));
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const bool record_dispatch = iree_hal_local_profiling_timestamps_are_active();
+  const iree_time_t begin_time_ns = record_dispatch ? iree_time_now() : 0;
+
+  const uint32_t workgroup_count[3] = {
+      dispatch_state->workgroup_count_x,
+      dispatch_state->workgroup_count_y,
+      dispatch_state->workgroup_count_z,
+  };
+  iree_hal_loader_workgroup_args_t args = {
+      .executable = executable,
+      .ordinal = ordinal,
+      .dispatch_state = dispatch_state,
+  };
+  iree_status_t status = iree_hal_local_workgroup_pool_run(
+      pool, workgroup_count, iree_hal_loader_module_issue_workgroup, &args);
+
+  if (record_dispatch && iree_status_is_ok(status)) {
+    iree_hal_local_profiling_record_dispatch(executable, ordinal,
+                                             begin_time_ns, iree_time_now());
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_loader_module_executable_dispatch(
     iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
     iree_hal_loader_module_state_t* IREE_RESTRICT state,
@@ -270,6 +333,9 @@ static iree_status_t iree_hal_loader_module_executable_dispatch(
     binding_lengths[i] = span.data_length;
   }
 
+  iree_hal_loader_module_t* loader_module = IREE_HAL_LOADER_MODULE_CAST(module);
+  iree_hal_local_workgroup_pool_t* workgroup_pool =
+      loader_module->workgroup_pool;
   const iree_hal_executable_dispatch_state_v0_t dispatch_state = {
       .workgroup_size_x = 1,
       .workgroup_size_y = 1,
@@ -278,13 +344,23 @@ static iree_status_t iree_hal_loader_module_executable_dispatch(
       .workgroup_count_x = args->workgroup_x,
       .workgroup_count_y = args->workgroup_y,
       .workgroup_count_z = args->workgroup_z,
-      .max_concurrency = 1,
+      .max_concurrency =
+          workgroup_pool
+              ? (uint32_t)iree_hal_local_workgroup_pool_worker_capacity(
+                    workgroup_pool)
+              : 1,
       .binding_count = args->binding_count,
       .push_constants = args->push_constants,
       .binding_ptrs = binding_ptrs,
       .binding_lengths = binding_lengths,
   };
 
+  if (workgroup_pool) {
+    return iree_hal_loader_module_issue_dispatch_parallel(
+        workgroup_pool, (iree_hal_local_executable_t*)executable,
+        args->entry_point, &dispatch_state);
+  }
+
   // TODO(benvanik): environmental information.
   uint32_t processor_id = 0;
   iree_byte_span_t local_memory = iree_byte_span_empty();
@@ -393,6 +469,16 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  return iree_hal_loader_module_create_with_workers(
+      instance, flags, /*worker_count=*/0, loader_count, loaders,
+      host_allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_workers(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    iree_host_size_t worker_count, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -431,6 +517,15 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_hal_executable_loader_retain(loaders[i]);
   }
 
+  if (worker_count > 0) {
+    status = iree_hal_local_workgroup_pool_create(
+        worker_count, host_allocator, &module->workgroup_pool);
+    if (!iree_status_is_ok(status)) {
+      iree_vm_module_release(base_module);
+      return status;
+    }
+  }
+
   *out_module = base_module;
   return iree_ok_status();
 }
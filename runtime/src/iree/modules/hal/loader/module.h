@@ -30,6 +30,17 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module);
 
+// Creates the dynamic HAL executable loader module for local execution with
+// dispatch workgroups distributed across |worker_count| threads in addition to
+// the calling thread. Dispatches still complete synchronously before returning
+// to the caller. A |worker_count| of 0 is equivalent to
+// iree_hal_loader_module_create.
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_workers(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    iree_host_size_t worker_count, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -32,6 +32,11 @@
 // provided.
 #define IREE_HAL_MODULE_MAX_COMMAND_BUFFER_BINDING_COUNT ((iree_host_size_t)256)
 
+// Maximum number of free buffer views retained by each context for reuse.
+// Programs usually have a handful of results per invocation and this only needs
+// to cover those that are live at the same time.
+#define IREE_HAL_MODULE_BUFFER_VIEW_POOL_CAPACITY ((iree_host_size_t)64)
+
 //===----------------------------------------------------------------------===//
 // Module type definitions
 //===----------------------------------------------------------------------===//
@@ -39,7 +44,11 @@
 typedef struct iree_hal_module_t {
   iree_allocator_t host_allocator;
   iree_hal_module_flags_t flags;
-  iree_hal_device_t* shared_device;
+  // Devices shared with all contexts using the module, retained. The first
+  // device is the default used by programs not assigning work to specific
+  // devices.
+  iree_host_size_t device_count;
+  iree_hal_device_t** devices;
   // TODO(benvanik): types.
 } iree_hal_module_t;
 
@@ -53,10 +62,12 @@ typedef struct iree_hal_module_state_t {
   // application. All instantiations of a module share the same flags.
   iree_hal_module_flags_t flags;
 
-  // HACK: today we only support a single device per context - in the future
-  // this should be a set of available devices that the module is able to pick
-  // from - the module will then hang on to them and use them as native globals
-  // instead of storing anything in module state here.
+  // Devices available to the context, retained. Programs select devices by
+  // index with hal.devices.get and shared_device is the first device.
+  // TODO(benvanik): have modules hang on to the devices they use as native
+  // globals instead of storing anything in module state here.
+  iree_host_size_t device_count;
+  iree_hal_device_t** devices;
   iree_hal_device_t* shared_device;
 
   // TODO(benvanik): add iree_loop_t to module constructor.
@@ -64,18 +75,27 @@ typedef struct iree_hal_module_state_t {
   // instead be taking a loop upon creation and scheduling work against that.
   iree_status_t loop_status;
 
-  // Shared executable cache for all executables created in the context.
-  // We could have multiple to allow for modules to create distinct sets of
-  // executables like ones for training vs inference in the same model, or just
-  // always use this.
-  iree_hal_executable_cache_t* executable_cache;
+  // Shared executable caches for all executables created in the context, one
+  // per device in |devices|. We could have multiple per device to allow for
+  // modules to create distinct sets of executables like ones for training vs
+  // inference in the same model, or just always use these.
+  iree_hal_executable_cache_t** executable_caches;
+
+  // Pool of buffer views created by the program. Buffer views are frequently
+  // created for invocation results and reusing them avoids host allocations.
+  iree_hal_buffer_view_pool_t* buffer_view_pool;
 } iree_hal_module_state_t;
 
 static void IREE_API_PTR iree_hal_module_destroy(void* base_module) {
   iree_hal_module_t* module = IREE_HAL_MODULE_CAST(base_module);
-  iree_hal_device_release(module->shared_device);
+  for (iree_host_size_t i = 0; i < module->device_count; ++i) {
+    iree_hal_device_release(module->devices[i]);
+  }
 }
 
+static void IREE_API_PTR
+iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state);
+
 static iree_status_t IREE_API_PTR
 iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
                             iree_vm_module_state_t** out_module_state) {
@@ -83,24 +103,45 @@ iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
 
   iree_hal_module_t* module = IREE_HAL_MODULE_CAST(self);
   iree_hal_module_state_t* state = NULL;
+  iree_host_size_t total_size =
+      sizeof(*state) + module->device_count * sizeof(state->devices[0]) +
+      module->device_count * sizeof(state->executable_caches[0]);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(host_allocator, sizeof(*state), (void**)&state));
-  memset(state, 0, sizeof(*state));
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&state));
+  memset(state, 0, total_size);
   state->host_allocator = host_allocator;
   state->flags = module->flags;
-  state->shared_device = module->shared_device;
-  iree_hal_device_retain(state->shared_device);
+  state->device_count = module->device_count;
+  state->devices = (iree_hal_device_t**)((uint8_t*)state + sizeof(*state));
+  state->executable_caches =
+      (iree_hal_executable_cache_t**)(state->devices + state->device_count);
+  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+    state->devices[i] = module->devices[i];
+    iree_hal_device_retain(state->devices[i]);
+  }
+  state->shared_device = state->devices[0];
 
   state->loop_status = iree_ok_status();
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_executable_cache_create(
-              state->shared_device, iree_string_view_empty(),
-              iree_loop_inline(&state->loop_status), &state->executable_cache));
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < state->device_count && iree_status_is_ok(status); ++i) {
+    status = iree_hal_executable_cache_create(
+        state->devices[i], iree_string_view_empty(),
+        iree_loop_inline(&state->loop_status), &state->executable_caches[i]);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_view_pool_create(
+        IREE_HAL_MODULE_BUFFER_VIEW_POOL_CAPACITY, host_allocator,
+        &state->buffer_view_pool);
+  }
 
-  *out_module_state = (iree_vm_module_state_t*)state;
+  if (iree_status_is_ok(status)) {
+    *out_module_state = (iree_vm_module_state_t*)state;
+  } else {
+    iree_hal_module_free_state(self, (iree_vm_module_state_t*)state);
+  }
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void IREE_API_PTR
@@ -108,9 +149,12 @@ iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
-  iree_hal_executable_cache_release(state->executable_cache);
+  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+    iree_hal_executable_cache_release(state->executable_caches[i]);
+    iree_hal_device_release(state->devices[i]);
+  }
+  iree_hal_buffer_view_pool_release(state->buffer_view_pool);
   iree_status_ignore(state->loop_status);
-  iree_hal_device_release(state->shared_device);
   iree_allocator_free(state->host_allocator, state);
 
   IREE_TRACE_ZONE_END(z0);
@@ -122,7 +166,11 @@ static iree_status_t IREE_API_PTR iree_hal_module_notify(
   switch (signal) {
     case IREE_VM_SIGNAL_SUSPEND:
     case IREE_VM_SIGNAL_LOW_MEMORY:
-      return iree_hal_device_trim(state->shared_device);
+      iree_hal_buffer_view_pool_trim(state->buffer_view_pool);
+      for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+        IREE_RETURN_IF_ERROR(iree_hal_device_trim(state->devices[i]));
+      }
+      return iree_ok_status();
     default:
       return iree_ok_status();
   }
@@ -445,11 +493,12 @@ IREE_VM_ABI_EXPORT(iree_hal_module_buffer_view_create,  //
   }
 
   iree_hal_buffer_view_t* buffer_view = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_view_create(
-      subspan_buffer ? subspan_buffer : source_buffer, shape_rank, shape_dims,
-      element_type, encoding_type, state->host_allocator, &buffer_view));
+  iree_status_t status = iree_hal_buffer_view_pool_acquire(
+      state->buffer_view_pool, subspan_buffer ? subspan_buffer : source_buffer,
+      shape_rank, shape_dims, element_type, encoding_type, &buffer_view);
 
   iree_hal_buffer_release(subspan_buffer);
+  IREE_RETURN_IF_ERROR(status);
 
   rets->r0 = iree_hal_buffer_view_move_ref(buffer_view);
   return iree_ok_status();
@@ -593,6 +642,10 @@ IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_create,  //
   iree_hal_command_category_t command_categories =
       (iree_hal_command_category_t)args->i2;
   iree_host_size_t binding_capacity = (iree_host_size_t)args->i3;
+  if (iree_all_bits_set(state->flags,
+                        IREE_HAL_MODULE_FLAG_VALIDATE_COMMAND_BUFFERS)) {
+    modes &= ~IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED;
+  }
 
   if (IREE_UNLIKELY(binding_capacity >
                     IREE_HAL_MODULE_MAX_COMMAND_BUFFER_BINDING_COUNT)) {
@@ -1007,15 +1060,58 @@ IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_flush,  //
   return iree_hal_device_queue_flush(device, queue_affinity);
 }
 
+//===--------------------------------------------------------------------===//
+// iree_hal_device_t list
+//===--------------------------------------------------------------------===//
+
+IREE_VM_ABI_EXPORT(iree_hal_module_devices_count,  //
+                   iree_hal_module_state_t,        //
+                   v, i) {
+  rets->i0 = (int32_t)state->device_count;
+  return iree_ok_status();
+}
+
+IREE_VM_ABI_EXPORT(iree_hal_module_devices_get,  //
+                   iree_hal_module_state_t,      //
+                   i, r) {
+  if (args->i0 < 0 || (iree_host_size_t)args->i0 >= state->device_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "device index %d out of range (%" PRIhsz
+                            " devices available)",
+                            args->i0, state->device_count);
+  }
+  rets->r0 = iree_hal_device_retain_ref(state->devices[args->i0]);
+  return iree_ok_status();
+}
+
 //===--------------------------------------------------------------------===//
 // iree_hal_executable_t
 //===--------------------------------------------------------------------===//
 
+// Returns the executable cache of |device| in the module state.
+static iree_status_t iree_hal_module_state_lookup_executable_cache(
+    iree_hal_module_state_t* state, iree_hal_device_t* device,
+    iree_hal_executable_cache_t** out_executable_cache) {
+  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+    if (state->devices[i] == device) {
+      *out_executable_cache = state->executable_caches[i];
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "device is not one of the %" PRIhsz
+                          " devices available to the context",
+                          state->device_count);
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_executable_create,  //
                    iree_hal_module_state_t,            //
                    rrrrCrD, r) {
   iree_hal_device_t* device = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_device_check_deref(args->r0, &device));
+  iree_hal_executable_cache_t* executable_cache = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_module_state_lookup_executable_cache(
+      state, device, &executable_cache));
   iree_vm_buffer_t* executable_format = NULL;
   IREE_RETURN_IF_ERROR(
       iree_vm_buffer_check_deref(args->r1, &executable_format));
@@ -1067,7 +1163,7 @@ IREE_VM_ABI_EXPORT(iree_hal_module_executable_create,  //
     executable_params.constant_count = constant_count;
     executable_params.constants = constants;
     status = iree_hal_executable_cache_prepare_executable(
-        state->executable_cache, &executable_params, &executable);
+        executable_cache, &executable_params, &executable);
   }
 
   iree_allocator_free(state->host_allocator, pipeline_layouts);
@@ -1434,10 +1530,30 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
     iree_vm_instance_t* instance, iree_hal_device_t* device,
     iree_hal_module_flags_t flags, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module) {
-  IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(device);
+  return iree_hal_module_create_with_devices(instance, /*device_count=*/1,
+                                             &device, flags, host_allocator,
+                                             out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_module_create_with_devices(
+    iree_vm_instance_t* instance, iree_host_size_t device_count,
+    iree_hal_device_t* const* devices, iree_hal_module_flags_t flags,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  IREE_ASSERT_ARGUMENT(instance);
+  IREE_ASSERT_ARGUMENT(devices);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
+  if (device_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "at least one device is required");
+  }
+  for (iree_host_size_t i = 0; i < device_count; ++i) {
+    if (!devices[i]) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "device %" PRIhsz " is NULL", i);
+    }
+  }
 
   // Setup the interface with the functions we implement ourselves. Any function
   // we omit will be handled by the base native module.
@@ -1448,9 +1564,10 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
       .notify = iree_hal_module_notify,
   };
 
-  // Allocate shared module state.
-  iree_host_size_t total_size =
-      iree_vm_native_module_size() + sizeof(iree_hal_module_t);
+  // Allocate shared module state with the device list stored inline.
+  iree_host_size_t total_size = iree_vm_native_module_size() +
+                                sizeof(iree_hal_module_t) +
+                                device_count * sizeof(iree_hal_device_t*);
   iree_vm_module_t* base_module = NULL;
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(host_allocator, total_size, (void**)&base_module));
@@ -1467,8 +1584,12 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
   module->host_allocator = host_allocator;
   // TODO(benvanik): fix vm yield with result storage.
   module->flags = flags | IREE_HAL_MODULE_FLAG_SYNCHRONOUS;
-  module->shared_device = device;
-  iree_hal_device_retain(module->shared_device);
+  module->device_count = device_count;
+  module->devices = (iree_hal_device_t**)((uint8_t*)module + sizeof(*module));
+  for (iree_host_size_t i = 0; i < device_count; ++i) {
+    module->devices[i] = devices[i];
+    iree_hal_device_retain(module->devices[i]);
+  }
 
   *out_module = base_module;
   return iree_ok_status();
@@ -1479,3 +1600,16 @@ IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device(
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
   return state->shared_device;
 }
+
+IREE_API_EXPORT iree_host_size_t
+iree_hal_module_state_device_count(iree_vm_module_state_t* module_state) {
+  iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
+  return state->device_count;
+}
+
+IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device_at(
+    iree_vm_module_state_t* module_state, iree_host_size_t index) {
+  iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
+  if (index >= state->device_count) return NULL;
+  return state->devices[index];
+}
@@ -23,6 +23,12 @@ enum iree_hal_module_flag_bits_t {
 
   // Forces HAL methods to block instead of yielding as a coroutine.
   IREE_HAL_MODULE_FLAG_SYNCHRONOUS = 1u << 0,
+
+  // Validates all command buffers recorded by programs even if they request
+  // IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED. Compiler-generated command
+  // buffers are unvalidated by default and this can be used to debug them.
+  // Has no effect if IREE_HAL_COMMAND_BUFFER_VALIDATION_ENABLE is 0.
+  IREE_HAL_MODULE_FLAG_VALIDATE_COMMAND_BUFFERS = 1u << 1,
 };
 typedef uint32_t iree_hal_module_flags_t;
 
@@ -34,11 +40,30 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
     iree_hal_module_flags_t flags, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module);
 
-// Returns the device currently in use by the HAL module.
+// Creates the HAL module initialized to use the given |devices|.
+// Each context using this module will share the devices and have compatible
+// allocations. Programs select devices by index with hal.devices.get and the
+// first device is the default used by programs that don't assign work to
+// specific devices.
+IREE_API_EXPORT iree_status_t iree_hal_module_create_with_devices(
+    iree_vm_instance_t* instance, iree_host_size_t device_count,
+    iree_hal_device_t* const* devices, iree_hal_module_flags_t flags,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module);
+
+// Returns the default (first) device in use by the HAL module.
 // Returns NULL if no device has been initialized yet.
 IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device(
     iree_vm_module_state_t* module_state);
 
+// Returns the number of devices in use by the HAL module.
+IREE_API_EXPORT iree_host_size_t
+iree_hal_module_state_device_count(iree_vm_module_state_t* module_state);
+
+// Returns the device at |index| in use by the HAL module or NULL if out of
+// range.
+IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device_at(
+    iree_vm_module_state_t* module_state, iree_host_size_t index);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,207 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/hal/utils/ref_codec.h"
+
+#include <string.h>
+
+#include "iree/modules/hal/types.h"
+
+// Buffer allocation parameters stored in snapshots.
+typedef struct iree_hal_ref_codec_buffer_header_t {
+  uint32_t memory_type;
+  uint32_t allowed_usage;
+  uint32_t allowed_access;
+  uint32_t reserved;
+  uint64_t byte_length;
+} iree_hal_ref_codec_buffer_header_t;
+
+// Buffer view metadata stored in snapshots. The shape dimensions follow in
+// their own blob.
+typedef struct iree_hal_ref_codec_buffer_view_header_t {
+  uint32_t element_type;
+  uint32_t encoding_type;
+  uint64_t shape_rank;
+} iree_hal_ref_codec_buffer_view_header_t;
+
+// Reads the next blob from |reader| into |out_value| of |value_size| bytes.
+static iree_status_t iree_hal_ref_codec_read_value(
+    iree_vm_state_reader_t* reader, void* out_value,
+    iree_host_size_t value_size) {
+  iree_const_byte_span_t data = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(reader->read(reader->self, &data));
+  if (data.data_length != value_size) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed snapshot value; expected %" PRIhsz
+                            " bytes but got %" PRIhsz,
+                            value_size, data.data_length);
+  }
+  memcpy(out_value, data.data, value_size);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_ref_codec_encode_buffer(
+    iree_hal_device_t* device, iree_hal_buffer_t* buffer,
+    iree_vm_state_writer_t* writer) {
+  iree_hal_ref_codec_buffer_header_t header = {
+      .memory_type = (uint32_t)iree_hal_buffer_memory_type(buffer),
+      .allowed_usage = (uint32_t)iree_hal_buffer_allowed_usage(buffer),
+      .allowed_access = (uint32_t)iree_hal_buffer_allowed_access(buffer),
+      .reserved = 0,
+      .byte_length = (uint64_t)iree_hal_buffer_byte_length(buffer),
+  };
+  IREE_RETURN_IF_ERROR(writer->write(
+      writer->self, iree_make_const_byte_span(&header, sizeof(header))));
+
+  // Read the contents back to the host. This works for any buffer regardless
+  // of whether it is host-visible.
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(device);
+  iree_host_size_t byte_length = (iree_host_size_t)header.byte_length;
+  void* contents = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, byte_length, &contents));
+  iree_status_t status = iree_hal_device_transfer_d2h(
+      device, buffer, 0, contents, byte_length,
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout());
+  if (iree_status_is_ok(status)) {
+    status = writer->write(writer->self,
+                           iree_make_const_byte_span(contents, byte_length));
+  }
+  iree_allocator_free(host_allocator, contents);
+  return status;
+}
+
+static iree_status_t iree_hal_ref_codec_decode_buffer(
+    iree_hal_device_t* device, iree_vm_state_reader_t* reader,
+    iree_hal_buffer_t** out_buffer) {
+  iree_hal_ref_codec_buffer_header_t header;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_ref_codec_read_value(reader, &header, sizeof(header)));
+  iree_const_byte_span_t contents = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(reader->read(reader->self, &contents));
+  if (contents.data_length != header.byte_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed snapshot buffer contents");
+  }
+  iree_hal_buffer_params_t params = {
+      .type = (iree_hal_memory_type_t)header.memory_type,
+      .usage = (iree_hal_buffer_usage_t)header.allowed_usage,
+      .access = (iree_hal_memory_access_t)header.allowed_access,
+  };
+  return iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(device), params,
+      (iree_device_size_t)header.byte_length, contents, out_buffer);
+}
+
+static iree_status_t iree_hal_ref_codec_encode_buffer_view(
+    iree_hal_buffer_view_t* buffer_view, iree_vm_state_writer_t* writer) {
+  iree_hal_ref_codec_buffer_view_header_t header = {
+      .element_type =
+          (uint32_t)iree_hal_buffer_view_element_type(buffer_view),
+      .encoding_type =
+          (uint32_t)iree_hal_buffer_view_encoding_type(buffer_view),
+      .shape_rank = (uint64_t)iree_hal_buffer_view_shape_rank(buffer_view),
+  };
+  IREE_RETURN_IF_ERROR(writer->write(
+      writer->self, iree_make_const_byte_span(&header, sizeof(header))));
+  IREE_RETURN_IF_ERROR(writer->write(
+      writer->self,
+      iree_make_const_byte_span(
+          iree_hal_buffer_view_shape_dims(buffer_view),
+          sizeof(iree_hal_dim_t) * (iree_host_size_t)header.shape_rank)));
+  iree_vm_ref_t buffer_ref =
+      iree_hal_buffer_retain_ref(iree_hal_buffer_view_buffer(buffer_view));
+  iree_status_t status = writer->write_ref(writer->self, &buffer_ref);
+  iree_vm_ref_release(&buffer_ref);
+  return status;
+}
+
+static iree_status_t iree_hal_ref_codec_decode_buffer_view(
+    iree_hal_device_t* device, iree_vm_state_reader_t* reader,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  iree_hal_ref_codec_buffer_view_header_t header;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_ref_codec_read_value(reader, &header, sizeof(header)));
+  iree_const_byte_span_t shape_data = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(reader->read(reader->self, &shape_data));
+  if (shape_data.data_length != sizeof(iree_hal_dim_t) * header.shape_rank) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed snapshot buffer view shape");
+  }
+  iree_vm_ref_t buffer_ref = iree_vm_ref_null();
+  IREE_RETURN_IF_ERROR(reader->read_ref(reader->self, &buffer_ref));
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_buffer_check_deref(buffer_ref, &buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_view_create(
+        buffer, (iree_host_size_t)header.shape_rank,
+        (const iree_hal_dim_t*)shape_data.data,
+        (iree_hal_element_type_t)header.element_type,
+        (iree_hal_encoding_type_t)header.encoding_type,
+        iree_hal_device_host_allocator(device), out_buffer_view);
+  }
+  iree_vm_ref_release(&buffer_ref);
+  return status;
+}
+
+static iree_status_t iree_hal_ref_codec_encode(void* self,
+                                               const iree_vm_ref_t* ref,
+                                               iree_vm_state_writer_t* writer) {
+  iree_hal_device_t* device = (iree_hal_device_t*)self;
+  if (iree_hal_buffer_isa(*ref)) {
+    return iree_hal_ref_codec_encode_buffer(device, iree_hal_buffer_deref(*ref),
+                                            writer);
+  } else if (iree_hal_buffer_view_isa(*ref)) {
+    return iree_hal_ref_codec_encode_buffer_view(
+        iree_hal_buffer_view_deref(*ref), writer);
+  } else if (iree_hal_device_isa(*ref) || iree_hal_allocator_isa(*ref)) {
+    // Rebound to the device provided when restoring.
+    return iree_ok_status();
+  }
+  iree_string_view_t type_name = iree_vm_ref_type_name(ref->type);
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "'%.*s' values cannot be snapshotted",
+                          (int)type_name.size, type_name.data);
+}
+
+static iree_status_t iree_hal_ref_codec_decode(void* self,
+                                               iree_vm_ref_type_t type,
+                                               iree_vm_state_reader_t* reader,
+                                               iree_vm_ref_t* out_ref) {
+  iree_hal_device_t* device = (iree_hal_device_t*)self;
+  iree_vm_ref_t ref = iree_vm_ref_null();
+  if (type == iree_hal_buffer_type()) {
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_ref_codec_decode_buffer(device, reader, &buffer));
+    ref = iree_hal_buffer_move_ref(buffer);
+  } else if (type == iree_hal_buffer_view_type()) {
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_ref_codec_decode_buffer_view(device, reader, &buffer_view));
+    ref = iree_hal_buffer_view_move_ref(buffer_view);
+  } else if (type == iree_hal_device_type()) {
+    ref = iree_hal_device_retain_ref(device);
+  } else if (type == iree_hal_allocator_type()) {
+    ref = iree_hal_allocator_retain_ref(iree_hal_device_allocator(device));
+  } else {
+    iree_string_view_t type_name = iree_vm_ref_type_name(type);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "'%.*s' values cannot be restored",
+                            (int)type_name.size, type_name.data);
+  }
+  iree_vm_ref_move(&ref, out_ref);
+  return iree_ok_status();
+}
+
+iree_vm_ref_codec_t iree_hal_module_ref_codec(iree_hal_device_t* device) {
+  iree_vm_ref_codec_t codec = {
+      .self = device,
+      .encode = iree_hal_ref_codec_encode,
+      .decode = iree_hal_ref_codec_decode,
+  };
+  return codec;
+}
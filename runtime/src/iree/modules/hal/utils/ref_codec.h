@@ -0,0 +1,38 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_HAL_UTILS_REF_CODEC_H_
+#define IREE_MODULES_HAL_UTILS_REF_CODEC_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns a ref codec for snapshotting and restoring HAL values in VM context
+// state with iree_vm_context_snapshot and
+// iree_vm_context_register_modules_from_snapshot.
+//
+// Supported types:
+//   !hal.buffer: contents are read back to the host when snapshotting and
+//                uploaded into a new buffer allocated from |device| with the
+//                same memory type and usage when restoring.
+//   !hal.buffer_view: metadata plus the nested buffer.
+//   !hal.device/!hal.allocator: restored as |device| and its allocator.
+// Other HAL types (executables, command buffers, semaphores, etc) cannot be
+// snapshotted and fail with IREE_STATUS_UNIMPLEMENTED.
+//
+// |device| is not retained and must remain valid while the codec is in use.
+iree_vm_ref_codec_t iree_hal_module_ref_codec(iree_hal_device_t* device);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_MODULES_HAL_UTILS_REF_CODEC_H_
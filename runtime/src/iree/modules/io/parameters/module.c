@@ -0,0 +1,402 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/io/parameters/module.h"
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/api.h"
+#include "iree/modules/hal/types.h"
+#include "iree/vm/api.h"
+
+#define IREE_IO_PARAMETERS_MODULE_VERSION_0_0 0x00000000u
+#define IREE_IO_PARAMETERS_MODULE_VERSION_LATEST \
+  IREE_IO_PARAMETERS_MODULE_VERSION_0_0
+
+//===----------------------------------------------------------------------===//
+// Module type definitions
+//===----------------------------------------------------------------------===//
+
+// A buffer loaded from a parameter for a particular allocator.
+typedef struct iree_io_parameters_module_cache_entry_t {
+  iree_hal_allocator_t* allocator;
+  iree_hal_buffer_t* buffer;
+} iree_io_parameters_module_cache_entry_t;
+
+typedef struct iree_io_parameters_module_scope_t {
+  iree_string_view_t name;
+  iree_io_parameter_archive_t* archive;
+  // One entry per archive parameter; populated on first load.
+  iree_io_parameters_module_cache_entry_t* cache;
+} iree_io_parameters_module_scope_t;
+
+typedef struct iree_io_parameters_module_t {
+  iree_allocator_t host_allocator;
+  // Guards the scope caches which are shared by all module states.
+  iree_slim_mutex_t cache_mutex;
+  iree_host_size_t scope_count;
+  iree_io_parameters_module_scope_t scopes[];
+} iree_io_parameters_module_t;
+
+#define IREE_IO_PARAMETERS_MODULE_CAST(module)        \
+  (iree_io_parameters_module_t*)((uint8_t*)(module) + \
+                                 iree_vm_native_module_size());
+
+typedef struct iree_io_parameters_module_state_t {
+  iree_allocator_t host_allocator;
+  iree_io_parameters_module_t* module;
+} iree_io_parameters_module_state_t;
+
+static void IREE_API_PTR iree_io_parameters_module_destroy(void* base_module) {
+  iree_io_parameters_module_t* module =
+      IREE_IO_PARAMETERS_MODULE_CAST(base_module);
+  for (iree_host_size_t i = 0; i < module->scope_count; ++i) {
+    iree_io_parameters_module_scope_t* scope = &module->scopes[i];
+    if (scope->cache) {
+      iree_host_size_t parameter_count =
+          iree_io_parameter_archive_count(scope->archive);
+      for (iree_host_size_t j = 0; j < parameter_count; ++j) {
+        iree_hal_buffer_release(scope->cache[j].buffer);
+        iree_hal_allocator_release(scope->cache[j].allocator);
+      }
+      iree_allocator_free(module->host_allocator, scope->cache);
+    }
+    iree_io_parameter_archive_release(scope->archive);
+  }
+  module->scope_count = 0;
+  iree_slim_mutex_deinitialize(&module->cache_mutex);
+}
+
+static iree_status_t IREE_API_PTR iree_io_parameters_module_alloc_state(
+    void* self, iree_allocator_t host_allocator,
+    iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_parameters_module_t* module = IREE_IO_PARAMETERS_MODULE_CAST(self);
+  iree_io_parameters_module_state_t* state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->host_allocator = host_allocator;
+  state->module = module;
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void IREE_API_PTR iree_io_parameters_module_free_state(
+    void* self, iree_vm_module_state_t* module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_parameters_module_state_t* state =
+      (iree_io_parameters_module_state_t*)module_state;
+  iree_allocator_free(state->host_allocator, state);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t IREE_API_PTR iree_io_parameters_module_notify(
+    void* self, iree_vm_module_state_t* module_state, iree_vm_signal_t signal) {
+  switch (signal) {
+    case IREE_VM_SIGNAL_SUSPEND:
+    case IREE_VM_SIGNAL_LOW_MEMORY:
+    default:
+      return iree_ok_status();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Parameter lookup and loading
+//===----------------------------------------------------------------------===//
+
+// Finds the parameter with |key| in the first archive of |scope_name| that
+// contains it.
+static iree_status_t iree_io_parameters_module_resolve(
+    iree_io_parameters_module_t* module, iree_string_view_t scope_name,
+    iree_string_view_t key, iree_io_parameters_module_scope_t** out_scope,
+    iree_host_size_t* out_index) {
+  for (iree_host_size_t i = 0; i < module->scope_count; ++i) {
+    iree_io_parameters_module_scope_t* scope = &module->scopes[i];
+    if (!iree_string_view_equal(scope->name, scope_name)) continue;
+    iree_status_t status =
+        iree_io_parameter_archive_lookup(scope->archive, key, out_index);
+    if (iree_status_is_ok(status)) {
+      *out_scope = scope;
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "parameter '%.*s' not found in scope '%.*s'",
+                          (int)key.size, key.data, (int)scope_name.size,
+                          scope_name.data);
+}
+
+static void iree_io_parameters_module_release_archive(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_io_parameter_archive_release((iree_io_parameter_archive_t*)user_data);
+}
+
+// Creates a buffer from |allocator| with the contents of |parameter|.
+// The archive contents are imported without copying when the allocator
+// supports it and otherwise are uploaded into a new buffer.
+static iree_status_t iree_io_parameters_module_load_buffer(
+    iree_hal_allocator_t* allocator, iree_io_parameter_archive_t* archive,
+    const iree_io_parameter_t* parameter, iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, parameter->key.data, parameter->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)parameter->data.data_length);
+
+  // Imported buffers keep the archive (and its mapping) alive for as long as
+  // they are in use, which may be longer than the module.
+  const iree_hal_buffer_params_t import_params = {
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE_READ |
+               IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE |
+               IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED,
+      .access = IREE_HAL_MEMORY_ACCESS_READ,
+      .type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+  };
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = 0,
+      .size = (iree_device_size_t)parameter->data.data_length,
+      .handle.host_allocation.ptr = (void*)parameter->data.data,
+  };
+  const iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_io_parameters_module_release_archive,
+      .user_data = archive,
+  };
+  iree_io_parameter_archive_retain(archive);
+  iree_status_t status = iree_hal_allocator_import_buffer(
+      allocator, import_params, &external_buffer, release_callback,
+      out_buffer);
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "import");
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  iree_io_parameter_archive_release(archive);
+  iree_status_ignore(status);
+
+  // Upload into device memory. The buffer is writable only so that the
+  // allocator can initialize it; programs treat parameters as immutable.
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "upload");
+  const iree_hal_buffer_params_t upload_params = {
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE_READ |
+               IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE,
+      .access = IREE_HAL_MEMORY_ACCESS_ALL,
+      .type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE,
+  };
+  status = iree_hal_allocator_allocate_buffer(
+      allocator, upload_params,
+      (iree_device_size_t)parameter->data.data_length, parameter->data,
+      out_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Exported functions
+//===----------------------------------------------------------------------===//
+
+IREE_VM_ABI_EXPORT(iree_io_parameters_module_exists,  //
+                   iree_io_parameters_module_state_t,  //
+                   rr, i) {
+  iree_vm_buffer_t* scope = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(args->r0, &scope));
+  iree_vm_buffer_t* key = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(args->r1, &key));
+
+  iree_io_parameters_module_scope_t* resolved_scope = NULL;
+  iree_host_size_t index = 0;
+  iree_status_t status = iree_io_parameters_module_resolve(
+      state->module, iree_vm_buffer_as_string(scope),
+      iree_vm_buffer_as_string(key), &resolved_scope, &index);
+  rets->i0 = iree_status_consume_code(status) == IREE_STATUS_OK ? 1 : 0;
+  return iree_ok_status();
+}
+
+IREE_VM_ABI_EXPORT(iree_io_parameters_module_load,     //
+                   iree_io_parameters_module_state_t,  //
+                   rrr, r) {
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_check_deref(args->r0, &allocator));
+  iree_vm_buffer_t* scope_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(args->r1, &scope_buffer));
+  iree_vm_buffer_t* key_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(args->r2, &key_buffer));
+
+  iree_io_parameters_module_scope_t* scope = NULL;
+  iree_host_size_t index = 0;
+  IREE_RETURN_IF_ERROR(iree_io_parameters_module_resolve(
+      state->module, iree_vm_buffer_as_string(scope_buffer),
+      iree_vm_buffer_as_string(key_buffer), &scope, &index));
+
+  // Loads happen under the lock so that concurrent contexts requesting the
+  // same parameter wait for a single upload instead of each making a copy.
+  iree_slim_mutex_lock(&state->module->cache_mutex);
+  iree_io_parameters_module_cache_entry_t* entry = &scope->cache[index];
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_ok_status();
+  if (entry->buffer && entry->allocator == allocator) {
+    buffer = entry->buffer;
+    iree_hal_buffer_retain(buffer);
+  } else {
+    status = iree_io_parameters_module_load_buffer(
+        allocator, scope->archive,
+        iree_io_parameter_archive_at(scope->archive, index), &buffer);
+    if (iree_status_is_ok(status) && !entry->buffer) {
+      // Only the first allocator to load a parameter is cached; programs
+      // rarely use more than one and this keeps the cache bounded.
+      entry->allocator = allocator;
+      iree_hal_allocator_retain(allocator);
+      entry->buffer = buffer;
+      iree_hal_buffer_retain(buffer);
+    }
+  }
+  iree_slim_mutex_unlock(&state->module->cache_mutex);
+  IREE_RETURN_IF_ERROR(status);
+
+  rets->r0 = iree_hal_buffer_move_ref(buffer);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// VM module interface implementation
+//===----------------------------------------------------------------------===//
+
+// NOTE: this must match the ordering of the iree_io_parameters_module_exports_
+// table.
+static const iree_vm_native_function_ptr_t
+    iree_io_parameters_module_funcs_[] = {
+#define EXPORT_FN(name, target_fn, arg_types, ret_types)       \
+  {                                                            \
+      .shim = (iree_vm_native_function_shim_t)                 \
+          iree_vm_shim_##arg_types##_##ret_types,              \
+      .target = (iree_vm_native_function_target_t)(target_fn), \
+  },
+#include "iree/modules/io/parameters/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+
+// NOTE: 0 length, but can't express that in C.
+static const iree_vm_native_import_descriptor_t
+    iree_io_parameters_module_imports_[1];
+
+static const iree_vm_native_export_descriptor_t
+    iree_io_parameters_module_exports_[] = {
+#define EXPORT_FN(name, target_fn, arg_types, ret_types)           \
+  {                                                                \
+      .local_name = iree_string_view_literal(name),                \
+      .calling_convention =                                        \
+          iree_string_view_literal("0" #arg_types "_" #ret_types), \
+      .attr_count = 0,                                             \
+      .attrs = NULL,                                               \
+  },
+#include "iree/modules/io/parameters/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+static_assert(IREE_ARRAYSIZE(iree_io_parameters_module_funcs_) ==
+                  IREE_ARRAYSIZE(iree_io_parameters_module_exports_),
+              "function pointer table must be 1:1 with exports");
+
+static const iree_vm_native_module_descriptor_t
+    iree_io_parameters_module_descriptor_ = {
+        .name = iree_string_view_literal("io_parameters"),
+        .version = IREE_IO_PARAMETERS_MODULE_VERSION_LATEST,
+        .attr_count = 0,
+        .attrs = NULL,
+        .dependency_count = 0,
+        .dependencies = NULL,
+        .import_count = 0,  // workaround for 0-length C struct
+        .imports = iree_io_parameters_module_imports_,
+        .export_count = IREE_ARRAYSIZE(iree_io_parameters_module_exports_),
+        .exports = iree_io_parameters_module_exports_,
+        .function_count = IREE_ARRAYSIZE(iree_io_parameters_module_funcs_),
+        .functions = iree_io_parameters_module_funcs_,
+};
+
+IREE_API_EXPORT iree_status_t iree_io_parameters_module_create(
+    iree_vm_instance_t* instance, iree_host_size_t archive_count,
+    const iree_io_parameters_module_archive_t* archives,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  IREE_ASSERT_ARGUMENT(instance);
+  IREE_ASSERT_ARGUMENT(!archive_count || archives);
+  IREE_ASSERT_ARGUMENT(out_module);
+  *out_module = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)archive_count);
+
+  // Setup the interface with the functions we implement ourselves. Any function
+  // we omit will be handled by the base native module.
+  static const iree_vm_module_t interface = {
+      .destroy = iree_io_parameters_module_destroy,
+      .alloc_state = iree_io_parameters_module_alloc_state,
+      .free_state = iree_io_parameters_module_free_state,
+      .notify = iree_io_parameters_module_notify,
+  };
+
+  // Allocate shared module state with the scope names stored inline.
+  iree_host_size_t total_size =
+      iree_vm_native_module_size() + sizeof(iree_io_parameters_module_t) +
+      archive_count * sizeof(iree_io_parameters_module_scope_t);
+  for (iree_host_size_t i = 0; i < archive_count; ++i) {
+    total_size += archives[i].scope.size;
+  }
+  iree_vm_module_t* base_module = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&base_module));
+  memset(base_module, 0, total_size);
+  iree_status_t status = iree_vm_native_module_initialize(
+      &interface, &iree_io_parameters_module_descriptor_, instance,
+      host_allocator, base_module);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, base_module);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_io_parameters_module_t* module =
+      IREE_IO_PARAMETERS_MODULE_CAST(base_module);
+  module->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&module->cache_mutex);
+  char* string_table = (char*)&module->scopes[archive_count];
+  for (iree_host_size_t i = 0; i < archive_count; ++i) {
+    iree_io_parameters_module_scope_t* scope = &module->scopes[i];
+    memcpy(string_table, archives[i].scope.data, archives[i].scope.size);
+    scope->name = iree_make_string_view(string_table, archives[i].scope.size);
+    string_table += archives[i].scope.size;
+    scope->archive = archives[i].archive;
+    iree_io_parameter_archive_retain(scope->archive);
+    module->scope_count = i + 1;
+    iree_host_size_t cache_size =
+        iree_io_parameter_archive_count(scope->archive) *
+        sizeof(scope->cache[0]);
+    if (cache_size == 0) continue;
+    status = iree_allocator_malloc(host_allocator, cache_size,
+                                   (void**)&scope->cache);
+    if (!iree_status_is_ok(status)) break;
+    memset(scope->cache, 0, cache_size);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_module = base_module;
+  } else {
+    iree_vm_module_release(base_module);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
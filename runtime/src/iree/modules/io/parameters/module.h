@@ -0,0 +1,49 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_IO_PARAMETERS_MODULE_H_
+#define IREE_MODULES_IO_PARAMETERS_MODULE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_archive.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A parameter archive made available to programs under a scope name.
+// Multiple archives may share a scope in which case they are searched in the
+// order provided.
+typedef struct iree_io_parameters_module_archive_t {
+  iree_string_view_t scope;
+  iree_io_parameter_archive_t* archive;
+} iree_io_parameters_module_archive_t;
+
+// Creates the `io_parameters` module serving parameters from |archives| as
+// read-only HAL buffers. Archives are retained by the module and may be shared
+// with any number of other modules.
+//
+// Programs request parameters with `io_parameters.load(allocator, scope, key)`.
+// If the allocator can import host memory the returned buffer directly
+// references the archive contents without a copy and otherwise the parameter
+// is uploaded into a new device buffer. Loaded buffers are cached per allocator
+// so that all contexts sharing the module share a single copy.
+//
+// The HAL types must have been registered (such as with
+// iree_hal_module_register_all_types) prior to creating the module.
+IREE_API_EXPORT iree_status_t iree_io_parameters_module_create(
+    iree_vm_instance_t* instance, iree_host_size_t archive_count,
+    const iree_io_parameters_module_archive_t* archives,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_MODULES_IO_PARAMETERS_MODULE_H_
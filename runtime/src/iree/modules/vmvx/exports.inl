@@ -42,7 +42,12 @@ EXPORT_FN("floor.2d.f32", iree_uk_x32u_floorf_2d, ukernel_x32u_2d, rIIIrIIIII, v
 EXPORT_FN("log.2d.f32", iree_uk_x32u_logf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("matmul.f32f32f32", iree_vmvx_matmul_f32f32f32, matmul, rIIrIIrIIIIIi, v)
 EXPORT_FN("matmul.i8i8i32", iree_vmvx_matmul_i8i8i32, matmul, rIIrIIrIIIIIi, v)
+EXPORT_FN("mmt4d.bf16bf16bf16", iree_vmvx_mmt4d_bf16bf16bf16, mmt4d, rIIrIIrIIIIIiiii, v)
+EXPORT_FN("mmt4d.bf16bf16f32", iree_vmvx_mmt4d_bf16bf16f32, mmt4d, rIIrIIrIIIIIiiii, v)
+EXPORT_FN("mmt4d.f16f16f16", iree_vmvx_mmt4d_f16f16f16, mmt4d, rIIrIIrIIIIIiiii, v)
+EXPORT_FN("mmt4d.f16f16f32", iree_vmvx_mmt4d_f16f16f32, mmt4d, rIIrIIrIIIIIiiii, v)
 EXPORT_FN("mmt4d.f32f32f32", iree_vmvx_mmt4d_f32f32f32, mmt4d, rIIrIIrIIIIIiiii, v)
+EXPORT_FN("mmt4d.i8i4i32", iree_vmvx_mmt4d_i8i4i32, mmt4d, rIIrIIrIIIIIiiii, v)
 EXPORT_FN("mmt4d.i8i8i32", iree_vmvx_mmt4d_i8i8i32, mmt4d, rIIrIIrIIIIIiiii, v)
 EXPORT_FN("mul.2d.f32", iree_uk_x32b_mulf_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
 EXPORT_FN("mul.2d.i32", iree_uk_x32b_muli_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
@@ -662,8 +662,21 @@ static iree_status_t iree_vmvx_mmt4d(iree_uk_mmt4d_type_t type,
   iree_host_size_t rhs_tile_size = N0 * K0;
   iree_host_size_t out_tile_size = M0 * N0;
   int lhs_elem_size = iree_uk_type_size(iree_uk_mmt4d_lhs_type(type));
-  int rhs_elem_size = iree_uk_type_size(iree_uk_mmt4d_rhs_type(type));
   int out_elem_size = iree_uk_type_size(iree_uk_mmt4d_out_type(type));
+  // Sub-byte RHS types (i4) are mapped as bytes, so the RHS offset, stride and
+  // size, which are counted in elements, must be whole numbers of bytes.
+  int rhs_elem_bits = iree_uk_type_bit_count(iree_uk_mmt4d_rhs_type(type));
+  int rhs_elem_size = rhs_elem_bits < 8 ? 1 : rhs_elem_bits / 8;
+  int64_t rhs_elems_per_byte = rhs_elem_bits < 8 ? 8 / rhs_elem_bits : 1;
+  if ((args->rhs_offset % rhs_elems_per_byte) ||
+      (args->rhs_row_stride % rhs_elems_per_byte) ||
+      ((K * rhs_tile_size) % rhs_elems_per_byte)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "sub-byte rhs is not byte-aligned");
+  }
+  int64_t rhs_byte_offset = args->rhs_offset / rhs_elems_per_byte;
+  int64_t rhs_byte_row_stride = args->rhs_row_stride / rhs_elems_per_byte;
   // Here are abusing the 2D-specific macros MAP_BUFFER_2D_* to query 4D arrays.
   // Thanks to the requirement that all dimensions but the outer-most one are
   // contiguous row-major, the outer-most stride is the only nontrivial stride,
@@ -679,11 +692,11 @@ static iree_status_t iree_vmvx_mmt4d(iree_uk_mmt4d_type_t type,
                            /*size1=*/K * lhs_tile_size);
   MAP_BUFFER_2D_UNTYPED_RO(rhs, /*dtype_size=*/rhs_elem_size,
                            /*buffer_ref=*/args->rhs_ref,
-                           /*offset=*/args->rhs_offset,
-                           /*stride0=*/args->rhs_row_stride,
+                           /*offset=*/rhs_byte_offset,
+                           /*stride0=*/rhs_byte_row_stride,
                            /*stride1=*/1,
                            /*size0=*/N,
-                           /*size1=*/K * rhs_tile_size);
+                           /*size1=*/K * rhs_tile_size / rhs_elems_per_byte);
   MAP_BUFFER_2D_UNTYPED_RW(out, /*dtype_size=*/out_elem_size,
                            /*buffer_ref=*/args->out_ref,
                            /*offset=*/args->out_offset,
@@ -698,7 +711,7 @@ static iree_status_t iree_vmvx_mmt4d(iree_uk_mmt4d_type_t type,
       .rhs_buffer = rhs,
       .out_buffer = out,
       .lhs_stride = lhs_stride0,
-      .rhs_stride = rhs_stride0,
+      .rhs_stride = rhs_stride0 * rhs_elems_per_byte,
       .out_stride = out_stride0,
       .M = M,
       .N = N,
@@ -721,6 +734,26 @@ IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_i8i8i32, mmt4d, v) {
   return iree_vmvx_mmt4d(iree_uk_mmt4d_type_i8i8i32, args);
 }
 
+IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_i8i4i32, mmt4d, v) {
+  return iree_vmvx_mmt4d(iree_uk_mmt4d_type_i8i4i32, args);
+}
+
+IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_f16f16f32, mmt4d, v) {
+  return iree_vmvx_mmt4d(iree_uk_mmt4d_type_f16f16f32, args);
+}
+
+IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_f16f16f16, mmt4d, v) {
+  return iree_vmvx_mmt4d(iree_uk_mmt4d_type_f16f16f16, args);
+}
+
+IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_bf16bf16f32, mmt4d, v) {
+  return iree_vmvx_mmt4d(iree_uk_mmt4d_type_bf16bf16f32, args);
+}
+
+IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d_bf16bf16bf16, mmt4d, v) {
+  return iree_vmvx_mmt4d(iree_uk_mmt4d_type_bf16bf16bf16, args);
+}
+
 //===----------------------------------------------------------------------===//
 // Exported pack function definitions
 //===----------------------------------------------------------------------===//
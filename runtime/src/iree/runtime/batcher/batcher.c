@@ -0,0 +1,617 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/batcher/batcher.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/base/tracing.h"
+#include "iree/modules/hal/types.h"
+#include "iree/runtime/call.h"
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_options_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->max_batch_size = 32;
+  out_options->max_latency = 1000000;  // 1ms
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_request_t
+//===----------------------------------------------------------------------===//
+
+// A queued request to invoke the function with one set of inputs.
+typedef struct iree_runtime_batcher_request_t {
+  // Next request in the queue or batch.
+  struct iree_runtime_batcher_request_t* next;
+  // Time the request was enqueued, used for the latency deadline.
+  iree_time_t enqueue_time_ns;
+  // Outer dimension shared by all inputs.
+  iree_hal_dim_t batch_size;
+  iree_runtime_batcher_callback_t callback;
+  // Retained inputs, one per function argument.
+  iree_host_size_t input_count;
+  iree_hal_buffer_view_t* inputs[];
+} iree_runtime_batcher_request_t;
+
+static void iree_runtime_batcher_request_free(
+    iree_runtime_batcher_request_t* request, iree_allocator_t host_allocator) {
+  for (iree_host_size_t i = 0; i < request->input_count; ++i) {
+    iree_hal_buffer_view_release(request->inputs[i]);
+  }
+  iree_allocator_free(host_allocator, request);
+}
+
+// Returns true if the inputs of |request| have the same element types and
+// inner dimensions as those of |head| such that they can be batched together.
+static bool iree_runtime_batcher_request_is_compatible(
+    const iree_runtime_batcher_request_t* head,
+    const iree_runtime_batcher_request_t* request) {
+  for (iree_host_size_t i = 0; i < head->input_count; ++i) {
+    iree_hal_buffer_view_t* a = head->inputs[i];
+    iree_hal_buffer_view_t* b = request->inputs[i];
+    if (iree_hal_buffer_view_element_type(a) !=
+            iree_hal_buffer_view_element_type(b) ||
+        iree_hal_buffer_view_encoding_type(a) !=
+            iree_hal_buffer_view_encoding_type(b) ||
+        iree_hal_buffer_view_shape_rank(a) !=
+            iree_hal_buffer_view_shape_rank(b)) {
+      return false;
+    }
+    for (iree_host_size_t j = 1; j < iree_hal_buffer_view_shape_rank(a); ++j) {
+      if (iree_hal_buffer_view_shape_dim(a, j) !=
+          iree_hal_buffer_view_shape_dim(b, j)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+struct iree_runtime_batcher_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_runtime_batcher_options_t options;
+
+  // Session the function is invoked in; retained.
+  iree_runtime_session_t* session;
+  // Reusable call state. Only accessed from the batcher thread.
+  iree_runtime_call_t call;
+  // Number of function arguments and results.
+  iree_host_size_t input_count;
+  iree_host_size_t output_count;
+
+  // Thread coalescing and invoking the queued requests.
+  iree_thread_t* thread;
+
+  // Guards the queue state below.
+  iree_slim_mutex_t mutex;
+  // Posted when requests are enqueued or the batcher is shutting down.
+  iree_notification_t notification;
+  // FIFO of requests waiting to be invoked.
+  iree_runtime_batcher_request_t* queue_head IREE_GUARDED_BY(mutex);
+  iree_runtime_batcher_request_t* queue_tail IREE_GUARDED_BY(mutex);
+  // Total batch size of the queued requests.
+  iree_host_size_t queue_batch_size IREE_GUARDED_BY(mutex);
+  // Set when the last reference has been released. Queued requests are
+  // invoked without waiting for their deadlines and the thread exits.
+  bool exit_requested IREE_GUARDED_BY(mutex);
+  // Set by the thread after it has drained the queue and will no longer touch
+  // the batcher.
+  bool exited IREE_GUARDED_BY(mutex);
+};
+
+static int iree_runtime_batcher_main(void* entry_arg);
+static bool iree_runtime_batcher_has_exited(void* arg);
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_batcher);
+  *out_batcher = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Only functions taking and returning buffer views can be batched.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t arguments;
+  iree_string_view_t results;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(&signature, &arguments,
+                                                    &results));
+  iree_host_size_t input_count = 0;
+  iree_host_size_t output_count = 0;
+  for (iree_host_size_t i = 0; i < arguments.size; ++i) {
+    if (arguments.data[i] == IREE_VM_CCONV_TYPE_VOID) continue;
+    ++input_count;
+    if (arguments.data[i] != IREE_VM_CCONV_TYPE_REF) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "batched functions must only take buffer views; "
+                              "argument %" PRIhsz " is '%c'",
+                              i, arguments.data[i]);
+    }
+  }
+  for (iree_host_size_t i = 0; i < results.size; ++i) {
+    if (results.data[i] == IREE_VM_CCONV_TYPE_VOID) continue;
+    ++output_count;
+    if (results.data[i] != IREE_VM_CCONV_TYPE_REF) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "batched functions must only return buffer "
+                              "views; result %" PRIhsz " is '%c'",
+                              i, results.data[i]);
+    }
+  }
+  if (input_count == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "batched functions must take at least one "
+                            "argument to carry the batch dimension");
+  }
+  if (options->max_batch_size == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "max_batch_size must be at least 1");
+  }
+
+  iree_runtime_batcher_t* batcher = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*batcher),
+                                (void**)&batcher));
+  memset(batcher, 0, sizeof(*batcher));
+  iree_atomic_ref_count_init(&batcher->ref_count);
+  batcher->host_allocator = host_allocator;
+  batcher->options = *options;
+  batcher->session = session;
+  iree_runtime_session_retain(session);
+  batcher->input_count = input_count;
+  batcher->output_count = output_count;
+  iree_slim_mutex_initialize(&batcher->mutex);
+  iree_notification_initialize(&batcher->notification);
+
+  iree_status_t status =
+      iree_runtime_call_initialize(session, function, &batcher->call);
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_call_prepare(&batcher->call);
+  } else {
+    // The call cleans up after itself on failure.
+    memset(&batcher->call, 0, sizeof(batcher->call));
+  }
+  if (iree_status_is_ok(status)) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = iree_make_cstring_view("iree-batcher");
+    status = iree_thread_create(iree_runtime_batcher_main, batcher, params,
+                                host_allocator, &batcher->thread);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_batcher = batcher;
+  } else {
+    iree_runtime_batcher_release(batcher);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_runtime_batcher_destroy(iree_runtime_batcher_t* batcher) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = batcher->host_allocator;
+
+  // Ask the thread to drain the queue and wait for it to exit. The thread may
+  // not have started running yet and only once it has exited is our reference
+  // the last one such that releasing it joins the thread.
+  if (batcher->thread) {
+    iree_slim_mutex_lock(&batcher->mutex);
+    batcher->exit_requested = true;
+    iree_slim_mutex_unlock(&batcher->mutex);
+    iree_notification_post(&batcher->notification, IREE_ALL_WAITERS);
+    iree_notification_await(&batcher->notification,
+                            iree_runtime_batcher_has_exited, batcher,
+                            iree_infinite_timeout());
+    iree_thread_release(batcher->thread);
+  }
+
+  if (batcher->call.session) {
+    iree_runtime_call_deinitialize(&batcher->call);
+  }
+  iree_runtime_session_release(batcher->session);
+  iree_notification_deinitialize(&batcher->notification);
+  iree_slim_mutex_deinitialize(&batcher->mutex);
+  iree_allocator_free(host_allocator, batcher);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher) {
+    iree_atomic_ref_count_inc(&batcher->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher && iree_atomic_ref_count_dec(&batcher->ref_count) == 1) {
+    iree_runtime_batcher_destroy(batcher);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_enqueue(
+    iree_runtime_batcher_t* batcher, iree_host_size_t input_count,
+    iree_hal_buffer_view_t* const* inputs,
+    iree_runtime_batcher_callback_t callback) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  IREE_ASSERT_ARGUMENT(!input_count || inputs);
+  if (input_count != batcher->input_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "function takes %" PRIhsz
+                            " inputs but %" PRIhsz " were provided",
+                            batcher->input_count, input_count);
+  }
+  for (iree_host_size_t i = 0; i < input_count; ++i) {
+    if (!inputs[i] || iree_hal_buffer_view_shape_rank(inputs[i]) == 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "input %" PRIhsz
+                              " must be a buffer view with a batch dimension",
+                              i);
+    }
+  }
+  iree_hal_dim_t batch_size = iree_hal_buffer_view_shape_dim(inputs[0], 0);
+  for (iree_host_size_t i = 1; i < input_count; ++i) {
+    if (iree_hal_buffer_view_shape_dim(inputs[i], 0) != batch_size) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "input %" PRIhsz " has batch size %" PRIdim
+          " but input 0 has batch size %" PRIdim,
+          i, iree_hal_buffer_view_shape_dim(inputs[i], 0), batch_size);
+    }
+  }
+  if (batch_size == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "requests must have a batch size of at least 1");
+  }
+
+  iree_runtime_batcher_request_t* request = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      batcher->host_allocator,
+      sizeof(*request) + input_count * sizeof(request->inputs[0]),
+      (void**)&request));
+  request->next = NULL;
+  request->enqueue_time_ns = iree_time_now();
+  request->batch_size = batch_size;
+  request->callback = callback;
+  request->input_count = input_count;
+  for (iree_host_size_t i = 0; i < input_count; ++i) {
+    request->inputs[i] = inputs[i];
+    iree_hal_buffer_view_retain(inputs[i]);
+  }
+
+  iree_slim_mutex_lock(&batcher->mutex);
+  if (batcher->queue_tail) {
+    batcher->queue_tail->next = request;
+  } else {
+    batcher->queue_head = request;
+  }
+  batcher->queue_tail = request;
+  batcher->queue_batch_size += batch_size;
+  iree_slim_mutex_unlock(&batcher->mutex);
+  iree_notification_post(&batcher->notification, IREE_ALL_WAITERS);
+
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Batch execution
+//===----------------------------------------------------------------------===//
+
+// Gathers input |input_index| of each request in |batch| into a new batched
+// buffer view with an outer dimension of |total_batch_size|.
+static iree_status_t iree_runtime_batcher_gather_input(
+    iree_runtime_batcher_t* batcher, iree_runtime_batcher_request_t* batch,
+    iree_host_size_t input_index, iree_hal_dim_t total_batch_size,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  iree_hal_device_t* device = iree_runtime_session_device(batcher->session);
+  iree_hal_buffer_view_t* like_view = batch->inputs[input_index];
+  iree_device_size_t row_length =
+      iree_hal_buffer_view_byte_length(like_view) / batch->batch_size;
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      iree_runtime_session_device_allocator(batcher->session), params,
+      row_length * total_batch_size, iree_const_byte_span_empty(), &buffer));
+
+  iree_status_t status = iree_ok_status();
+  iree_device_size_t offset = 0;
+  for (iree_runtime_batcher_request_t* request = batch;
+       request && iree_status_is_ok(status); request = request->next) {
+    iree_hal_buffer_view_t* input = request->inputs[input_index];
+    iree_device_size_t length = iree_hal_buffer_view_byte_length(input);
+    status = iree_hal_device_transfer_d2d(
+        device, iree_hal_buffer_view_buffer(input), 0, buffer, offset, length,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout());
+    offset += length;
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_host_size_t shape_rank = iree_hal_buffer_view_shape_rank(like_view);
+    iree_hal_dim_t* shape =
+        (iree_hal_dim_t*)iree_alloca(shape_rank * sizeof(iree_hal_dim_t));
+    memcpy(shape, iree_hal_buffer_view_shape_dims(like_view),
+           shape_rank * sizeof(shape[0]));
+    shape[0] = total_batch_size;
+    status = iree_hal_buffer_view_create(
+        buffer, shape_rank, shape, iree_hal_buffer_view_element_type(like_view),
+        iree_hal_buffer_view_encoding_type(like_view), batcher->host_allocator,
+        out_buffer_view);
+  }
+  iree_hal_buffer_release(buffer);
+  return status;
+}
+
+// Creates a buffer view over the |row_count| rows of |output| starting at
+// |row_offset| without copying.
+static iree_status_t iree_runtime_batcher_slice_output(
+    iree_runtime_batcher_t* batcher, iree_hal_buffer_view_t* output,
+    iree_hal_dim_t row_offset, iree_hal_dim_t row_count,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  iree_hal_dim_t total_batch_size = iree_hal_buffer_view_shape_dim(output, 0);
+  iree_device_size_t row_length =
+      iree_hal_buffer_view_byte_length(output) / total_batch_size;
+  iree_hal_buffer_t* subspan = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_subspan(
+      iree_hal_buffer_view_buffer(output), row_offset * row_length,
+      row_count * row_length, &subspan));
+  iree_host_size_t shape_rank = iree_hal_buffer_view_shape_rank(output);
+  iree_hal_dim_t* shape =
+      (iree_hal_dim_t*)iree_alloca(shape_rank * sizeof(iree_hal_dim_t));
+  memcpy(shape, iree_hal_buffer_view_shape_dims(output),
+         shape_rank * sizeof(shape[0]));
+  shape[0] = row_count;
+  iree_status_t status = iree_hal_buffer_view_create(
+      subspan, shape_rank, shape, iree_hal_buffer_view_element_type(output),
+      iree_hal_buffer_view_encoding_type(output), batcher->host_allocator,
+      out_buffer_view);
+  iree_hal_buffer_release(subspan);
+  return status;
+}
+
+// Issues the callback of |request| with rows starting at |row_offset| of each
+// batched output in the call outputs.
+static iree_status_t iree_runtime_batcher_scatter_outputs(
+    iree_runtime_batcher_t* batcher, iree_runtime_batcher_request_t* request,
+    iree_hal_dim_t row_offset, bool is_whole_batch) {
+  iree_vm_list_t* batch_outputs = iree_runtime_call_outputs(&batcher->call);
+  iree_vm_list_t* outputs = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                           batcher->output_count,
+                                           batcher->host_allocator, &outputs));
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < batcher->output_count && iree_status_is_ok(status); ++i) {
+    iree_hal_buffer_view_t* output =
+        iree_vm_list_get_buffer_view_assign(batch_outputs, i);
+    iree_hal_buffer_view_t* slice = NULL;
+    if (is_whole_batch) {
+      // Pass through results of requests invoked on their own.
+      slice = output;
+      iree_hal_buffer_view_retain(slice);
+    } else {
+      status = iree_runtime_batcher_slice_output(
+          batcher, output, row_offset, request->batch_size, &slice);
+    }
+    if (iree_status_is_ok(status)) {
+      iree_vm_ref_t slice_ref = iree_hal_buffer_view_move_ref(slice);
+      status = iree_vm_list_push_ref_move(outputs, &slice_ref);
+      iree_vm_ref_release(&slice_ref);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    request->callback.fn(request->callback.user_data, iree_ok_status(),
+                         outputs);
+  }
+  iree_vm_list_release(outputs);
+  return status;
+}
+
+// Invokes the function with the |batch| of requests and returns the outputs in
+// the call outputs.
+static iree_status_t iree_runtime_batcher_invoke(
+    iree_runtime_batcher_t* batcher, iree_runtime_batcher_request_t* batch,
+    iree_hal_dim_t total_batch_size) {
+  iree_runtime_call_reset(&batcher->call);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < batcher->input_count && iree_status_is_ok(status); ++i) {
+    iree_hal_buffer_view_t* input = NULL;
+    if (batch->next == NULL) {
+      input = batch->inputs[i];
+      iree_hal_buffer_view_retain(input);
+    } else {
+      status = iree_runtime_batcher_gather_input(batcher, batch, i,
+                                                 total_batch_size, &input);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_runtime_call_inputs_push_back_buffer_view(&batcher->call,
+                                                              input);
+    }
+    iree_hal_buffer_view_release(input);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_call_invoke(&batcher->call, /*flags=*/0);
+  }
+
+  // Verify the results carry the batch dimension so they can be scattered.
+  iree_vm_list_t* outputs = iree_runtime_call_outputs(&batcher->call);
+  for (iree_host_size_t i = 0;
+       i < batcher->output_count && iree_status_is_ok(status); ++i) {
+    iree_hal_buffer_view_t* output =
+        iree_vm_list_get_buffer_view_assign(outputs, i);
+    if (!output || iree_hal_buffer_view_shape_rank(output) == 0 ||
+        iree_hal_buffer_view_shape_dim(output, 0) != total_batch_size) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "result %" PRIhsz
+                                " must be a buffer view with an outer "
+                                "dimension of the batch size %" PRIdim,
+                                i, total_batch_size);
+    }
+  }
+  return status;
+}
+
+// Invokes the |batch| of requests and issues their callbacks.
+static void iree_runtime_batcher_execute(iree_runtime_batcher_t* batcher,
+                                         iree_runtime_batcher_request_t* batch,
+                                         iree_hal_dim_t total_batch_size) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, total_batch_size);
+
+  iree_status_t status =
+      iree_runtime_batcher_invoke(batcher, batch, total_batch_size);
+
+  iree_hal_dim_t row_offset = 0;
+  while (batch) {
+    iree_runtime_batcher_request_t* request = batch;
+    batch = request->next;
+    if (iree_status_is_ok(status)) {
+      status = iree_runtime_batcher_scatter_outputs(
+          batcher, request, row_offset,
+          /*is_whole_batch=*/row_offset == 0 && batch == NULL);
+      row_offset += request->batch_size;
+    }
+    if (!iree_status_is_ok(status)) {
+      // Failures are reported to every remaining request of the batch.
+      request->callback.fn(request->callback.user_data,
+                           iree_status_clone(status), /*outputs=*/NULL);
+    }
+    iree_runtime_batcher_request_free(request, batcher->host_allocator);
+  }
+  iree_status_ignore(status);
+
+  // Drop the batched I/O so that buffers are not retained while idle.
+  iree_runtime_call_reset(&batcher->call);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// Batcher thread
+//===----------------------------------------------------------------------===//
+
+static bool iree_runtime_batcher_has_work(void* arg) {
+  iree_runtime_batcher_t* batcher = (iree_runtime_batcher_t*)arg;
+  iree_slim_mutex_lock(&batcher->mutex);
+  bool has_work = batcher->queue_head != NULL || batcher->exit_requested;
+  iree_slim_mutex_unlock(&batcher->mutex);
+  return has_work;
+}
+
+static bool iree_runtime_batcher_has_exited(void* arg) {
+  iree_runtime_batcher_t* batcher = (iree_runtime_batcher_t*)arg;
+  iree_slim_mutex_lock(&batcher->mutex);
+  bool has_exited = batcher->exited;
+  iree_slim_mutex_unlock(&batcher->mutex);
+  return has_exited;
+}
+
+static bool iree_runtime_batcher_is_batch_ready(void* arg) {
+  iree_runtime_batcher_t* batcher = (iree_runtime_batcher_t*)arg;
+  iree_slim_mutex_lock(&batcher->mutex);
+  bool is_ready =
+      batcher->queue_batch_size >= batcher->options.max_batch_size ||
+      batcher->exit_requested;
+  iree_slim_mutex_unlock(&batcher->mutex);
+  return is_ready;
+}
+
+// Pops the oldest request and as many compatible requests following it as fit
+// in the maximum batch size. Returns NULL if the queue is empty.
+static iree_runtime_batcher_request_t* iree_runtime_batcher_pop_batch(
+    iree_runtime_batcher_t* batcher, iree_hal_dim_t* out_total_batch_size) {
+  *out_total_batch_size = 0;
+  iree_slim_mutex_lock(&batcher->mutex);
+  iree_runtime_batcher_request_t* batch = batcher->queue_head;
+  iree_runtime_batcher_request_t* batch_tail = batch;
+  iree_hal_dim_t total_batch_size = batch ? batch->batch_size : 0;
+  while (batch_tail && batch_tail->next) {
+    iree_runtime_batcher_request_t* request = batch_tail->next;
+    if (total_batch_size + request->batch_size >
+            batcher->options.max_batch_size ||
+        !iree_runtime_batcher_request_is_compatible(batch, request)) {
+      break;
+    }
+    total_batch_size += request->batch_size;
+    batch_tail = request;
+  }
+  if (batch_tail) {
+    batcher->queue_head = batch_tail->next;
+    if (!batcher->queue_head) batcher->queue_tail = NULL;
+    batch_tail->next = NULL;
+    batcher->queue_batch_size -= total_batch_size;
+  }
+  iree_slim_mutex_unlock(&batcher->mutex);
+  *out_total_batch_size = total_batch_size;
+  return batch;
+}
+
+static int iree_runtime_batcher_main(void* entry_arg) {
+  iree_runtime_batcher_t* batcher = (iree_runtime_batcher_t*)entry_arg;
+  while (true) {
+    iree_notification_await(&batcher->notification,
+                            iree_runtime_batcher_has_work, batcher,
+                            iree_infinite_timeout());
+
+    // Give the batch until the deadline of the oldest request to fill.
+    iree_slim_mutex_lock(&batcher->mutex);
+    bool exit_requested = batcher->exit_requested;
+    iree_time_t deadline_ns =
+        batcher->queue_head ? batcher->queue_head->enqueue_time_ns +
+                                  batcher->options.max_latency
+                            : IREE_TIME_INFINITE_PAST;
+    iree_slim_mutex_unlock(&batcher->mutex);
+    if (!exit_requested) {
+      iree_notification_await(&batcher->notification,
+                              iree_runtime_batcher_is_batch_ready, batcher,
+                              iree_make_deadline(deadline_ns));
+    }
+
+    iree_hal_dim_t total_batch_size = 0;
+    iree_runtime_batcher_request_t* batch =
+        iree_runtime_batcher_pop_batch(batcher, &total_batch_size);
+    if (batch) {
+      iree_runtime_batcher_execute(batcher, batch, total_batch_size);
+    } else if (exit_requested) {
+      break;
+    }
+  }
+
+  // The owner joins the thread after observing the exit so the batcher
+  // remains live until we return.
+  iree_slim_mutex_lock(&batcher->mutex);
+  batcher->exited = true;
+  iree_slim_mutex_unlock(&batcher->mutex);
+  iree_notification_post(&batcher->notification, IREE_ALL_WAITERS);
+  return 0;
+}
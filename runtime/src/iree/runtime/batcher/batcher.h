@@ -0,0 +1,114 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_RUNTIME_BATCHER_BATCHER_H_
+#define IREE_RUNTIME_BATCHER_BATCHER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/runtime/session.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+// Options controlling how requests are coalesced into batched invocations.
+typedef struct iree_runtime_batcher_options_t {
+  // Maximum total batch size of a single invocation, summed across the
+  // coalesced requests. Requests larger than this are invoked on their own.
+  iree_host_size_t max_batch_size;
+  // Maximum time the oldest queued request waits for the batch to fill before
+  // the queued requests are invoked with whatever batch size is available.
+  // IREE_DURATION_ZERO invokes as soon as the batcher is idle, which still
+  // coalesces all requests that arrived during the prior invocation.
+  iree_duration_t max_latency;
+} iree_runtime_batcher_options_t;
+
+// Initializes |out_options| to its default values.
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options);
+
+// A callback issued when a request completes.
+//
+// |outputs| contains one buffer view per function result holding the rows of
+// the batched result produced for the request. The buffer views alias the
+// batched result buffers and are retained by the list; callers wanting to
+// keep them must retain them. Ownership of |status| transfers to the callback.
+//
+// Callbacks are issued from the batcher thread and must not block; long
+// running work should be scheduled elsewhere so the next batch can start.
+typedef void(IREE_API_PTR* iree_runtime_batcher_callback_fn_t)(
+    void* user_data, iree_status_t status, iree_vm_list_t* outputs);
+typedef struct iree_runtime_batcher_callback_t {
+  // Callback function pointer.
+  iree_runtime_batcher_callback_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_runtime_batcher_callback_t;
+
+// Dynamic batching of requests to a single function within a session.
+//
+// Requests are queued from any thread and a dedicated thread coalesces them
+// into one invocation of the function up to the maximum batch size or latency
+// deadline. The function must take and return only buffer views whose outer
+// dimension is the batch dimension (such as functions compiled with a dynamic
+// batch dimension); all other dimensions and element types of each argument
+// must match for requests to be coalesced. Requests that don't match the
+// oldest queued request are invoked in a later batch, preserving order.
+//
+// The arguments of coalesced requests are gathered into contiguous batched
+// buffers with device transfers; requests invoked on their own pass their
+// arguments to the function directly. Results are scattered back to each
+// request as subspans of the batched result buffers without copies. Queuing
+// happens while prior batches execute so invocations are issued back-to-back
+// under load.
+//
+// Only one batcher may use a session at a time and the session must not be
+// invoked by other threads while the batcher is live: VM contexts are
+// thread-compatible. Use one session per batcher to serve multiple functions.
+//
+// Thread-safe: requests may be enqueued from any thread.
+typedef struct iree_runtime_batcher_t iree_runtime_batcher_t;
+
+// Creates a batcher invoking |function| within |session|.
+// The batcher thread is started immediately and waits for requests.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher);
+
+// Retains the given |batcher| for the caller.
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher);
+
+// Releases the given |batcher| from the caller.
+// When the last reference is released all queued requests are invoked and
+// their callbacks issued before the batcher thread exits.
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher);
+
+// Enqueues a request invoking the function with |inputs|.
+// Each input must have the same outer (batch) dimension, which is the batch
+// size of the request. The inputs are retained until the request completes and
+// |callback| is issued with the results. Fails without issuing the callback if
+// the inputs don't match the function signature.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_enqueue(
+    iree_runtime_batcher_t* batcher, iree_host_size_t input_count,
+    iree_hal_buffer_view_t* const* inputs,
+    iree_runtime_batcher_callback_t callback);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_RUNTIME_BATCHER_BATCHER_H_
@@ -0,0 +1,385 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/batcher/batcher.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/modules/hal/types.h"
+#include "iree/runtime/instance.h"
+#include "iree/runtime/session.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/native_module_cc.h"
+
+namespace iree {
+namespace {
+
+// Shape of the input of one invocation of the test function.
+struct Invocation {
+  iree_hal_dim_t batch_size;
+  iree_hal_dim_t inner_size;
+};
+
+// Invocations of the test function. Written from the batcher thread.
+struct InvocationLog {
+  std::mutex mutex;
+  std::vector<Invocation> invocations;
+};
+
+// Per-context state of the test module.
+class TestState final {
+ public:
+  TestState(iree_hal_device_t* device, InvocationLog* log)
+      : device_(device), log_(log) {}
+
+  // Returns a buffer view of the same shape as |input| with each i32 element
+  // doubled and records the shape it was invoked with.
+  StatusOr<vm::ref<iree_hal_buffer_view_t>> Double(
+      const vm::ref<iree_hal_buffer_view_t> input) {
+    iree_hal_dim_t batch_size = iree_hal_buffer_view_shape_dim(input.get(), 0);
+    iree_hal_dim_t inner_size = iree_hal_buffer_view_shape_dim(input.get(), 1);
+    {
+      std::lock_guard<std::mutex> lock(log_->mutex);
+      log_->invocations.push_back({batch_size, inner_size});
+    }
+
+    std::vector<int32_t> data(batch_size * inner_size);
+    IREE_RETURN_IF_ERROR(iree_hal_device_transfer_d2h(
+        device_, iree_hal_buffer_view_buffer(input.get()), 0, data.data(),
+        data.size() * sizeof(int32_t), IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    for (int32_t& value : data) value *= 2;
+
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    vm::ref<iree_hal_buffer_view_t> output;
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_view_allocate_buffer(
+        iree_hal_device_allocator(device_),
+        iree_hal_buffer_view_shape_rank(input.get()),
+        iree_hal_buffer_view_shape_dims(input.get()),
+        IREE_HAL_ELEMENT_TYPE_INT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, params,
+        iree_make_const_byte_span(data.data(), data.size() * sizeof(int32_t)),
+        &output));
+    return std::move(output);
+  }
+
+ private:
+  iree_hal_device_t* device_;
+  InvocationLog* log_;
+};
+
+static const vm::NativeFunction<TestState> kTestFunctions[] = {
+    vm::MakeNativeFunction("double", &TestState::Double),
+};
+
+class TestModule final : public vm::NativeModule<TestState> {
+ public:
+  TestModule(iree_vm_instance_t* instance, iree_allocator_t host_allocator,
+             iree_hal_device_t* device, InvocationLog* log)
+      : vm::NativeModule<TestState>(
+            "test", /*version=*/0, instance, host_allocator,
+            iree::span<const vm::NativeFunction<TestState>>(kTestFunctions)),
+        device_(device),
+        log_(log) {}
+
+  StatusOr<std::unique_ptr<TestState>> CreateState(
+      iree_allocator_t host_allocator) override {
+    return std::make_unique<TestState>(device_, log_);
+  }
+
+ private:
+  iree_hal_device_t* device_;
+  InvocationLog* log_;
+};
+
+// Results of a single request as recorded by its callback.
+struct RequestResult {
+  iree_status_code_t status_code = IREE_STATUS_UNKNOWN;
+  iree_hal_buffer_view_t* output = NULL;
+};
+
+class BatcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_runtime_instance_options_t instance_options;
+    iree_runtime_instance_options_initialize(&instance_options);
+    IREE_ASSERT_OK(iree_runtime_instance_create(&instance_options,
+                                                host_allocator, &instance_));
+
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+    iree_hal_sync_device_params_t device_params;
+    iree_hal_sync_device_params_initialize(&device_params);
+    iree_status_t status = iree_hal_sync_device_create(
+        iree_make_cstring_view("local-sync"), &device_params,
+        /*loader_count=*/0, /*loaders=*/NULL, device_allocator, host_allocator,
+        &device_);
+    iree_hal_allocator_release(device_allocator);
+    IREE_ASSERT_OK(status);
+
+    iree_runtime_session_options_t session_options;
+    iree_runtime_session_options_initialize(&session_options);
+    IREE_ASSERT_OK(iree_runtime_session_create_with_device(
+        instance_, &session_options, device_, host_allocator, &session_));
+
+    auto module = std::make_unique<TestModule>(
+        iree_runtime_instance_vm_instance(instance_), host_allocator, device_,
+        &log_);
+    iree_vm_module_t* module_ptr = module.release()->interface();
+    status = iree_runtime_session_append_module(session_, module_ptr);
+    iree_vm_module_release(module_ptr);
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override {
+    iree_runtime_batcher_release(batcher_);
+    for (RequestResult& result : results_) {
+      iree_hal_buffer_view_release(result.output);
+    }
+    iree_runtime_session_release(session_);
+    iree_hal_device_release(device_);
+    iree_runtime_instance_release(instance_);
+  }
+
+  void CreateBatcher(iree_host_size_t max_batch_size,
+                     iree_duration_t max_latency) {
+    iree_vm_function_t function;
+    IREE_ASSERT_OK(iree_runtime_session_lookup_function(
+        session_, iree_make_cstring_view("test.double"), &function));
+    iree_runtime_batcher_options_t options;
+    iree_runtime_batcher_options_initialize(&options);
+    options.max_batch_size = max_batch_size;
+    options.max_latency = max_latency;
+    IREE_ASSERT_OK(iree_runtime_batcher_create(
+        session_, function, &options, iree_allocator_system(), &batcher_));
+  }
+
+  // Value of element |j| of row |i| of the input of request |index|.
+  static int32_t InputValue(iree_host_size_t index, iree_hal_dim_t i,
+                            iree_hal_dim_t j) {
+    return (int32_t)(index * 1000 + i * 100 + j);
+  }
+
+  // Enqueues a request with a |batch_size|x|inner_size| i32 input.
+  // Returns the index of the request in |results_|.
+  iree_host_size_t Enqueue(iree_hal_dim_t batch_size,
+                           iree_hal_dim_t inner_size) {
+    iree_host_size_t index = 0;
+    {
+      std::lock_guard<std::mutex> lock(results_mutex_);
+      index = results_.size();
+      results_.emplace_back();
+      callback_args_.push_back(
+          std::unique_ptr<CallbackArg>(new CallbackArg{this, index}));
+    }
+    std::vector<int32_t> data(batch_size * inner_size);
+    for (iree_hal_dim_t i = 0; i < batch_size; ++i) {
+      for (iree_hal_dim_t j = 0; j < inner_size; ++j) {
+        data[i * inner_size + j] = InputValue(index, i, j);
+      }
+    }
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_dim_t shape[2] = {batch_size, inner_size};
+    iree_hal_buffer_view_t* input = NULL;
+    IREE_CHECK_OK(iree_hal_buffer_view_allocate_buffer(
+        iree_hal_device_allocator(device_), IREE_ARRAYSIZE(shape), shape,
+        IREE_HAL_ELEMENT_TYPE_INT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        params,
+        iree_make_const_byte_span(data.data(), data.size() * sizeof(int32_t)),
+        &input));
+    iree_runtime_batcher_callback_t callback = {RecordResult,
+                                                callback_args_.back().get()};
+    IREE_CHECK_OK(iree_runtime_batcher_enqueue(batcher_, 1, &input, callback));
+    iree_hal_buffer_view_release(input);
+    return index;
+  }
+
+  // Waits until all enqueued requests have completed.
+  bool WaitForResults() {
+    std::unique_lock<std::mutex> lock(results_mutex_);
+    return results_cv_.wait_for(lock, std::chrono::seconds(30), [this]() {
+      return completed_count_ == results_.size();
+    });
+  }
+
+  // Verifies request |index| succeeded with its input rows doubled.
+  void CheckResult(iree_host_size_t index, iree_hal_dim_t batch_size,
+                   iree_hal_dim_t inner_size) {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    const RequestResult& result = results_[index];
+    ASSERT_EQ(IREE_STATUS_OK, result.status_code);
+    ASSERT_NE(nullptr, result.output);
+    ASSERT_EQ(2, iree_hal_buffer_view_shape_rank(result.output));
+    EXPECT_EQ(batch_size, iree_hal_buffer_view_shape_dim(result.output, 0));
+    EXPECT_EQ(inner_size, iree_hal_buffer_view_shape_dim(result.output, 1));
+    std::vector<int32_t> data(batch_size * inner_size);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, iree_hal_buffer_view_buffer(result.output), 0, data.data(),
+        data.size() * sizeof(int32_t), IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    for (iree_hal_dim_t i = 0; i < batch_size; ++i) {
+      for (iree_hal_dim_t j = 0; j < inner_size; ++j) {
+        EXPECT_EQ(InputValue(index, i, j) * 2, data[i * inner_size + j]);
+      }
+    }
+  }
+
+  iree_host_size_t CompletedCount() {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    return completed_count_;
+  }
+
+  std::vector<Invocation> Invocations() {
+    std::lock_guard<std::mutex> lock(log_.mutex);
+    return log_.invocations;
+  }
+
+  iree_runtime_instance_t* instance_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_runtime_session_t* session_ = NULL;
+  iree_runtime_batcher_t* batcher_ = NULL;
+  InvocationLog log_;
+
+ private:
+  struct CallbackArg {
+    BatcherTest* test;
+    iree_host_size_t index;
+  };
+
+  static void RecordResult(void* user_data, iree_status_t status,
+                           iree_vm_list_t* outputs) {
+    auto* arg = (CallbackArg*)user_data;
+    BatcherTest* test = arg->test;
+    std::lock_guard<std::mutex> lock(test->results_mutex_);
+    RequestResult& result = test->results_[arg->index];
+    result.status_code = iree_status_consume_code(status);
+    if (outputs) {
+      result.output = iree_vm_list_get_buffer_view_retain(outputs, 0);
+    }
+    ++test->completed_count_;
+    test->results_cv_.notify_all();
+  }
+
+  std::mutex results_mutex_;
+  std::condition_variable results_cv_;
+  std::vector<RequestResult> results_;
+  std::vector<std::unique_ptr<CallbackArg>> callback_args_;
+  iree_host_size_t completed_count_ = 0;
+};
+
+// Effectively infinite latency so batches are only formed when full (or when
+// the batcher is released).
+static const iree_duration_t kLongLatency = 60 * 1000000000ll;
+
+// Requests arriving while a batch fills are coalesced into one invocation and
+// each request receives its own rows of the result.
+TEST_F(BatcherTest, Coalesces) {
+  CreateBatcher(/*max_batch_size=*/4, kLongLatency);
+  for (int i = 0; i < 4; ++i) Enqueue(/*batch_size=*/1, /*inner_size=*/2);
+  ASSERT_TRUE(WaitForResults());
+
+  std::vector<Invocation> invocations = Invocations();
+  ASSERT_EQ(1u, invocations.size());
+  EXPECT_EQ(4, invocations[0].batch_size);
+  for (int i = 0; i < 4; ++i) CheckResult(i, 1, 2);
+}
+
+// Batches never exceed max_batch_size; a request that would overflow the batch
+// starts the next one.
+TEST_F(BatcherTest, MaxBatchSizeCutoff) {
+  CreateBatcher(/*max_batch_size=*/4, kLongLatency);
+  Enqueue(/*batch_size=*/3, /*inner_size=*/2);
+  Enqueue(/*batch_size=*/2, /*inner_size=*/2);
+  Enqueue(/*batch_size=*/2, /*inner_size=*/2);
+  ASSERT_TRUE(WaitForResults());
+
+  std::vector<Invocation> invocations = Invocations();
+  ASSERT_EQ(2u, invocations.size());
+  EXPECT_EQ(3, invocations[0].batch_size);
+  EXPECT_EQ(4, invocations[1].batch_size);
+  CheckResult(0, 3, 2);
+  CheckResult(1, 2, 2);
+  CheckResult(2, 2, 2);
+}
+
+// A partial batch is invoked once the oldest request reaches the latency
+// deadline.
+TEST_F(BatcherTest, DeadlineFlush) {
+  const iree_duration_t max_latency = 50 * 1000000ll;  // 50ms
+  CreateBatcher(/*max_batch_size=*/32, max_latency);
+  iree_time_t start_ns = iree_time_now();
+  Enqueue(/*batch_size=*/1, /*inner_size=*/2);
+  Enqueue(/*batch_size=*/2, /*inner_size=*/2);
+  ASSERT_TRUE(WaitForResults());
+  iree_time_t end_ns = iree_time_now();
+
+  std::vector<Invocation> invocations = Invocations();
+  ASSERT_EQ(1u, invocations.size());
+  EXPECT_EQ(3, invocations[0].batch_size);
+  EXPECT_GE(end_ns - start_ns, max_latency / 2);
+  CheckResult(0, 1, 2);
+  CheckResult(1, 2, 2);
+}
+
+// Requests whose inner dimensions differ are never merged into a batch and
+// are invoked in order.
+TEST_F(BatcherTest, IncompatibleShapesNotMerged) {
+  CreateBatcher(/*max_batch_size=*/4, kLongLatency);
+  Enqueue(/*batch_size=*/1, /*inner_size=*/4);
+  Enqueue(/*batch_size=*/1, /*inner_size=*/8);
+  Enqueue(/*batch_size=*/2, /*inner_size=*/4);
+  Enqueue(/*batch_size=*/2, /*inner_size=*/4);
+  ASSERT_TRUE(WaitForResults());
+
+  std::vector<Invocation> invocations = Invocations();
+  ASSERT_EQ(3u, invocations.size());
+  EXPECT_EQ(1, invocations[0].batch_size);
+  EXPECT_EQ(4, invocations[0].inner_size);
+  EXPECT_EQ(1, invocations[1].batch_size);
+  EXPECT_EQ(8, invocations[1].inner_size);
+  EXPECT_EQ(4, invocations[2].batch_size);
+  EXPECT_EQ(4, invocations[2].inner_size);
+  CheckResult(0, 1, 4);
+  CheckResult(1, 1, 8);
+  CheckResult(2, 2, 4);
+  CheckResult(3, 2, 4);
+}
+
+// Releasing the batcher invokes all pending requests before it returns.
+TEST_F(BatcherTest, ReleaseDrainsPendingRequests) {
+  CreateBatcher(/*max_batch_size=*/32, kLongLatency);
+  Enqueue(/*batch_size=*/1, /*inner_size=*/2);
+  Enqueue(/*batch_size=*/1, /*inner_size=*/2);
+  iree_runtime_batcher_release(batcher_);
+  batcher_ = NULL;
+
+  // Callbacks must have been issued before the release returned.
+  EXPECT_EQ(2u, CompletedCount());
+  std::vector<Invocation> invocations = Invocations();
+  ASSERT_EQ(1u, invocations.size());
+  EXPECT_EQ(2, invocations[0].batch_size);
+  CheckResult(0, 1, 2);
+  CheckResult(1, 1, 2);
+}
+
+}  // namespace
+}  // namespace iree
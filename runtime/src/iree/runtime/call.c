@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/tracing.h"
 #include "iree/modules/hal/module.h"
 #include "iree/runtime/session.h"
 
@@ -69,6 +70,12 @@ IREE_API_EXPORT iree_status_t iree_runtime_call_initialize_by_name(
 
 IREE_API_EXPORT void iree_runtime_call_deinitialize(iree_runtime_call_t* call) {
   IREE_ASSERT_ARGUMENT(call);
+  if (call->prepared) {
+    iree_vm_prepared_invoke_deinitialize(call->prepared);
+    iree_allocator_free(iree_runtime_session_host_allocator(call->session),
+                        call->prepared);
+    call->prepared = NULL;
+  }
   iree_vm_list_release(call->inputs);
   iree_vm_list_release(call->outputs);
   iree_runtime_session_release(call->session);
@@ -92,12 +99,56 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
   return call->outputs;
 }
 
+IREE_API_EXPORT iree_status_t
+iree_runtime_call_prepare(iree_runtime_call_t* call) {
+  IREE_ASSERT_ARGUMENT(call);
+  if (call->prepared) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The prepared state embeds the initial VM stack storage and is too large to
+  // embed in the call (which is commonly stack-local).
+  iree_allocator_t host_allocator =
+      iree_runtime_session_host_allocator(call->session);
+  iree_vm_prepared_invoke_t* prepared = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*prepared),
+                                (void**)&prepared));
+  iree_status_t status = iree_vm_prepared_invoke_initialize(
+      iree_runtime_session_context(call->session), call->function,
+      IREE_VM_INVOCATION_FLAG_NONE, host_allocator, prepared);
+  if (iree_status_is_ok(status)) {
+    call->prepared = prepared;
+  } else {
+    iree_allocator_free(host_allocator, prepared);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags) {
+  if (call->prepared) {
+    return iree_vm_invoke_prepared(call->prepared, call->inputs, call->outputs);
+  }
   return iree_runtime_session_call(call->session, &call->function, call->inputs,
                                    call->outputs);
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data) {
+  IREE_ASSERT_ARGUMENT(call);
+  if (IREE_UNLIKELY(flags != IREE_RUNTIME_CALL_FLAG_RESERVED)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported call flags 0x%08X", flags);
+  }
+  return iree_runtime_session_call_async(call->session, &call->function,
+                                         call->inputs, call->outputs, loop,
+                                         state, callback, user_data);
+}
+
 //===----------------------------------------------------------------------===//
 // Helpers for defining call I/O
 //===----------------------------------------------------------------------===//
@@ -48,6 +48,8 @@ typedef struct iree_runtime_call_t {
   iree_vm_function_t function;
   iree_vm_list_t* inputs;
   iree_vm_list_t* outputs;
+  // Optional prepared invocation state; see iree_runtime_call_prepare.
+  iree_vm_prepared_invoke_t* prepared;
 } iree_runtime_call_t;
 
 // Initializes call state for a call to |function| within |session|.
@@ -86,12 +88,35 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_inputs(
 IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
     const iree_runtime_call_t* call);
 
+// Prepares the call for repeated invocation.
+// The function calling convention, ABI storage, and VM stack are allocated once
+// and reused by subsequent iree_runtime_call_invoke calls. When the inputs are
+// updated in-place (such as with iree_vm_list_set_value) and the outputs are
+// consumed without popping them from the list steady-state invocations perform
+// no heap allocations. A no-op if the call has already been prepared.
+IREE_API_EXPORT iree_status_t iree_runtime_call_prepare(
+    iree_runtime_call_t* call);
+
 // Synchronously invokes the call and returns the status.
 // The inputs list will remain unchanged to allow for subsequent reuse and the
 // output list will be populated with the results of the call.
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags);
 
+// Asynchronously invokes the call on |loop| and issues |callback| with
+// |user_data| when it completes. See iree_runtime_session_call_async for which
+// waits performed by the program yield to |loop|. |flags| must be
+// IREE_RUNTIME_CALL_FLAG_RESERVED.
+//
+// The call and |state| must remain live and unmodified until the callback is
+// issued. The outputs list passed to the callback is the call outputs list with
+// an additional reference that the callback must release. Prepared invocation
+// state is not used as each asynchronous invocation owns its own VM stack.
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data);
+
 //===----------------------------------------------------------------------===//
 // Helpers for defining call I/O
 //===----------------------------------------------------------------------===//
@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "iree/base/internal/atomics.h"
+#include "iree/base/internal/slab_allocator.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/init.h"
@@ -64,6 +65,11 @@ IREE_API_EXPORT iree_status_t iree_runtime_instance_create(
   *out_instance = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (options->host_allocator_type ==
+      IREE_RUNTIME_INSTANCE_HOST_ALLOCATOR_SLAB) {
+    host_allocator = iree_allocator_slab();
+  }
+
   // Allocate the instance state.
   iree_runtime_instance_t* instance = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
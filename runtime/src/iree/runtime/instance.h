@@ -50,6 +50,18 @@ typedef struct iree_runtime_instance_t iree_runtime_instance_t;
 // iree_runtime_instance_options_t
 //===----------------------------------------------------------------------===//
 
+// Selects the host allocator used by an instance and its resources.
+typedef enum iree_runtime_instance_host_allocator_e {
+  // Uses the host allocator passed to iree_runtime_instance_create.
+  IREE_RUNTIME_INSTANCE_HOST_ALLOCATOR_DEFAULT = 0,
+  // Uses the built-in thread-caching size-class allocator in place of the host
+  // allocator passed to iree_runtime_instance_create. This reduces lock
+  // contention and fragmentation in the system allocator when many threads
+  // create and destroy small VM and HAL objects, such as when serving many
+  // concurrent invocations. Slab memory is retained by the process for reuse.
+  IREE_RUNTIME_INSTANCE_HOST_ALLOCATOR_SLAB = 1,
+} iree_runtime_instance_host_allocator_t;
+
 // Options used to configure instance creation.
 typedef struct iree_runtime_instance_options_t {
   // TODO(benvanik): inject logging hooks.
@@ -58,6 +70,9 @@ typedef struct iree_runtime_instance_options_t {
   // When not provided a device must be specified when creating sessions via
   // iree_runtime_session_create_with_device.
   iree_hal_driver_registry_t* driver_registry;
+
+  // Host allocator used by the instance and all resources created from it.
+  iree_runtime_instance_host_allocator_t host_allocator_type;
 } iree_runtime_instance_options_t;
 
 // Initializes |out_options| to its default values.
@@ -82,7 +97,8 @@ IREE_API_EXPORT void iree_runtime_instance_options_use_all_available_drivers(
 // managed correctly.
 //
 // |host_allocator| will be used to allocate the instance and any associated
-// resources. |out_instance| must be released by the caller.
+// resources unless overridden by |options|. |out_instance| must be released by
+// the caller.
 IREE_API_EXPORT iree_status_t iree_runtime_instance_create(
     const iree_runtime_instance_options_t* options,
     iree_allocator_t host_allocator, iree_runtime_instance_t** out_instance);
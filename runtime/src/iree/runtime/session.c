@@ -67,9 +67,20 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
     iree_runtime_instance_t* instance,
     const iree_runtime_session_options_t* options, iree_hal_device_t* device,
     iree_allocator_t host_allocator, iree_runtime_session_t** out_session) {
+  IREE_ASSERT_ARGUMENT(device);
+  return iree_runtime_session_create_with_devices(
+      instance, options, /*device_count=*/1, &device, host_allocator,
+      out_session);
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_devices(
+    iree_runtime_instance_t* instance,
+    const iree_runtime_session_options_t* options,
+    iree_host_size_t device_count, iree_hal_device_t* const* devices,
+    iree_allocator_t host_allocator, iree_runtime_session_t** out_session) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(options);
-  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(devices);
   IREE_ASSERT_ARGUMENT(out_session);
   *out_session = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -94,9 +105,9 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
   // Lower-level usage of the VM can avoid the HAL if it's not required.
   iree_vm_module_t* hal_module = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_module_create(iree_runtime_instance_vm_instance(instance),
-                                    device, IREE_HAL_MODULE_FLAG_NONE,
-                                    host_allocator, &hal_module);
+    status = iree_hal_module_create_with_devices(
+        iree_runtime_instance_vm_instance(instance), device_count, devices,
+        IREE_HAL_MODULE_FLAG_NONE, host_allocator, &hal_module);
   }
   if (iree_status_is_ok(status)) {
     status = iree_vm_context_register_modules(
@@ -167,6 +178,18 @@ IREE_API_EXPORT iree_hal_device_t* iree_runtime_session_device(
   return iree_hal_module_state_device(session->hal_module_state);
 }
 
+IREE_API_EXPORT iree_host_size_t
+iree_runtime_session_device_count(const iree_runtime_session_t* session) {
+  IREE_ASSERT_ARGUMENT(session);
+  return iree_hal_module_state_device_count(session->hal_module_state);
+}
+
+IREE_API_EXPORT iree_hal_device_t* iree_runtime_session_device_at(
+    const iree_runtime_session_t* session, iree_host_size_t index) {
+  IREE_ASSERT_ARGUMENT(session);
+  return iree_hal_module_state_device_at(session->hal_module_state, index);
+}
+
 IREE_API_EXPORT iree_hal_allocator_t* iree_runtime_session_device_allocator(
     const iree_runtime_session_t* session) {
   iree_hal_device_t* device = iree_runtime_session_device(session);
@@ -200,6 +223,21 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_append_module(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_session_append_modules(
+    iree_runtime_session_t* session, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_loop_t loop) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(!module_count || modules);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)module_count);
+
+  iree_status_t status = iree_vm_context_register_modules_concurrently(
+      iree_runtime_session_context(session), module_count, modules, loop);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t
 iree_runtime_session_append_bytecode_module_from_memory(
     iree_runtime_session_t* session, iree_const_byte_span_t flatbuffer_data,
@@ -234,11 +272,11 @@ iree_runtime_session_append_bytecode_module_from_file(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, file_path);
 
-  // TODO(#3909): actually map the memory here. For now we just load the
-  // contents.
+  // Map the file so that only the pages of the module actually used are paged
+  // in (large rodata such as parameters may be touched lazily or never).
   iree_file_contents_t* flatbuffer_contents = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_file_read_contents(file_path,
+      z0, iree_file_read_contents(file_path, IREE_FILE_READ_FLAG_MMAP,
                                   iree_runtime_session_host_allocator(session),
                                   &flatbuffer_contents));
 
@@ -306,6 +344,26 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_async(
+    iree_runtime_session_t* session, const iree_vm_function_t* function,
+    iree_vm_list_t* input_list, iree_vm_list_t* output_list, iree_loop_t loop,
+    iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(function);
+  IREE_ASSERT_ARGUMENT(state);
+  IREE_ASSERT_ARGUMENT(callback);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_vm_async_invoke(
+      loop, state, iree_runtime_session_context(session), *function,
+      IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL, input_list, output_list,
+      iree_runtime_session_host_allocator(session), callback, user_data);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_runtime_session_call_by_name(
     iree_runtime_session_t* session, iree_string_view_t full_name,
     iree_vm_list_t* input_list, iree_vm_list_t* output_list) {
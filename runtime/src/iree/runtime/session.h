@@ -88,6 +88,19 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
     const iree_runtime_session_options_t* options, iree_hal_device_t* device,
     iree_allocator_t host_allocator, iree_runtime_session_t** out_session);
 
+// Creates a new session spanning the given |devices|.
+// Programs compiled for multiple devices select them by index in the order
+// provided (such as when partitioned across devices for pipeline parallelism)
+// and the first device is the default used by programs compiled for a single
+// device and returned by iree_runtime_session_device.
+//
+// See iree_runtime_session_create_with_device for more information.
+IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_devices(
+    iree_runtime_instance_t* instance,
+    const iree_runtime_session_options_t* options,
+    iree_host_size_t device_count, iree_hal_device_t* const* devices,
+    iree_allocator_t host_allocator, iree_runtime_session_t** out_session);
+
 // Retains the given |session| for the caller.
 IREE_API_EXPORT void iree_runtime_session_retain(
     iree_runtime_session_t* session);
@@ -113,12 +126,22 @@ IREE_API_EXPORT iree_vm_context_t* iree_runtime_session_context(
     const iree_runtime_session_t* session);
 
 // Returns the HAL device being used for execution.
+// Sessions spanning multiple devices return the first (default) device.
 //
 // NOTE: this device will not be available until initialized by a user module
 // and will return NULL if queried prior.
 IREE_API_EXPORT iree_hal_device_t* iree_runtime_session_device(
     const iree_runtime_session_t* session);
 
+// Returns the number of HAL devices the session spans.
+IREE_API_EXPORT iree_host_size_t
+iree_runtime_session_device_count(const iree_runtime_session_t* session);
+
+// Returns the HAL device at |index| in the devices the session spans or NULL
+// if out of range.
+IREE_API_EXPORT iree_hal_device_t* iree_runtime_session_device_at(
+    const iree_runtime_session_t* session, iree_host_size_t index);
+
 // Returns the device allocator used to allocate compatible buffers.
 // Buffers from other allocators may not be compatible and require importing
 // prior to being usable by the session.
@@ -143,6 +166,20 @@ iree_runtime_session_trim(iree_runtime_session_t* session);
 IREE_API_EXPORT iree_status_t iree_runtime_session_append_module(
     iree_runtime_session_t* session, iree_vm_module_t* module);
 
+// Appends the given |modules| to the context in order.
+// The modules will be retained by the context.
+//
+// Unlike appending each module individually the module initializers of
+// modules that do not import from one another (such as multiple user modules
+// that only import from the HAL) are issued together on |loop| and may run
+// concurrently. See iree_vm_context_register_modules_concurrently for details.
+//
+// NOTE: only valid if the context is not yet frozen; see
+// iree_vm_context_freeze for more information.
+IREE_API_EXPORT iree_status_t iree_runtime_session_append_modules(
+    iree_runtime_session_t* session, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_loop_t loop);
+
 // Appends a bytecode module to the context loaded from the given memory blob.
 // If the module exists as a file prefer instead to use
 // iree_runtime_session_append_bytecode_module_from_file to use memory mapped
@@ -208,6 +245,34 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call(
     iree_runtime_session_t* session, const iree_vm_function_t* function,
     iree_vm_list_t* input_list, iree_vm_list_t* output_list);
 
+// Asynchronously issues a generic function call on |loop|.
+// Returns immediately with the call pending on the loop and issues |callback|
+// with |user_data| from within the loop once the call completes or fails.
+// Note that the |callback| may be issued before this function returns (such as
+// when using an inline loop or one running on another thread).
+//
+// Waits performed by modules that support yielding (such as native modules
+// returning a wait source) yield back to |loop| as wait operations and the call
+// resumes when they are satisfied. NOTE: the HAL module is always created with
+// IREE_HAL_MODULE_FLAG_SYNCHRONOUS today and hal.fence.await blocks the thread
+// running |loop| until the fences are reached; only the scheduling of the call
+// onto |loop| is asynchronous for programs that wait on device work.
+//
+// |state| is opaque storage that must remain live until the callback is issued.
+// |input_list| will be retained until no longer needed by the call.
+// |output_list| is retained until the callback is issued and is passed to it;
+// the callback must release it. Either may be NULL if the function has no
+// inputs or outputs respectively.
+//
+// Calls may overlap on the same session only if it was created with the
+// IREE_VM_CONTEXT_FLAG_CONCURRENT context flag. See iree_vm_async_invoke for
+// more information.
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_async(
+    iree_runtime_session_t* session, const iree_vm_function_t* function,
+    iree_vm_list_t* input_list, iree_vm_list_t* output_list, iree_loop_t loop,
+    iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data);
+
 // Synchronously issues a generic function call by fully-qualified name.
 // This is equivalent to performing a iree_runtime_session_lookup_function
 // followed by a iree_runtime_session_call. When calling the same function
@@ -0,0 +1,199 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/session.h"
+
+#include <memory>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/runtime/call.h"
+#include "iree/runtime/instance.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/native_module_cc.h"
+
+namespace iree {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Per-context state of the test module.
+class TestState final {
+ public:
+  StatusOr<int32_t> Add(int32_t lhs, int32_t rhs) { return lhs + rhs; }
+
+  // Yields to the loop until a short delay has elapsed and then returns the
+  // sum.
+  StatusOr<vm::Async<int32_t>> AddDelayed(int32_t lhs, int32_t rhs) {
+    return vm::Async<int32_t>(
+        iree_wait_source_delay(iree_time_now() + 1000000),
+        [lhs, rhs]() -> StatusOr<int32_t> { return lhs + rhs; });
+  }
+};
+
+static const vm::NativeFunction<TestState> kTestFunctions[] = {
+    vm::MakeNativeFunction("add", &TestState::Add),
+    vm::MakeNativeFunction("add_delayed", &TestState::AddDelayed),
+};
+
+class TestModule final : public vm::NativeModule<TestState> {
+ public:
+  using vm::NativeModule<TestState>::NativeModule;
+  StatusOr<std::unique_ptr<TestState>> CreateState(
+      iree_allocator_t host_allocator) override {
+    return std::make_unique<TestState>();
+  }
+};
+
+// Results recorded by the async call callback.
+struct CallResult {
+  int callback_count = 0;
+  iree_status_code_t status_code = IREE_STATUS_UNKNOWN;
+  int32_t value = 0;
+};
+
+static iree_status_t RecordCallResult(void* user_data, iree_loop_t loop,
+                                      iree_status_t status,
+                                      iree_vm_list_t* outputs) {
+  auto* result = (CallResult*)user_data;
+  ++result->callback_count;
+  result->status_code = iree_status_consume_code(status);
+  if (result->status_code == IREE_STATUS_OK) {
+    iree_vm_value_t value;
+    iree_status_t get_status = iree_vm_list_get_value(outputs, 0, &value);
+    if (iree_status_is_ok(get_status)) result->value = value.i32;
+    iree_status_ignore(get_status);
+  }
+  iree_vm_list_release(outputs);
+  return iree_ok_status();
+}
+
+class SessionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_runtime_instance_options_t instance_options;
+    iree_runtime_instance_options_initialize(&instance_options);
+    IREE_ASSERT_OK(iree_runtime_instance_create(&instance_options,
+                                                host_allocator, &instance_));
+
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+    iree_hal_sync_device_params_t device_params;
+    iree_hal_sync_device_params_initialize(&device_params);
+    iree_hal_device_t* device = NULL;
+    iree_status_t status = iree_hal_sync_device_create(
+        iree_make_cstring_view("local-sync"), &device_params,
+        /*loader_count=*/0, /*loaders=*/NULL, device_allocator, host_allocator,
+        &device);
+    iree_hal_allocator_release(device_allocator);
+    IREE_ASSERT_OK(status);
+
+    iree_runtime_session_options_t session_options;
+    iree_runtime_session_options_initialize(&session_options);
+    status = iree_runtime_session_create_with_device(
+        instance_, &session_options, device, host_allocator, &session_);
+    iree_hal_device_release(device);
+    IREE_ASSERT_OK(status);
+
+    auto module = std::make_unique<TestModule>(
+        "test", /*version=*/0, iree_runtime_instance_vm_instance(instance_),
+        host_allocator, iree::span<const vm::NativeFunction<TestState>>(
+                            kTestFunctions));
+    iree_vm_module_t* module_ptr = module.release()->interface();
+    status = iree_runtime_session_append_module(session_, module_ptr);
+    iree_vm_module_release(module_ptr);
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override {
+    iree_runtime_session_release(session_);
+    iree_runtime_instance_release(instance_);
+  }
+
+  // Initializes |out_call| for |name| with i32 inputs |lhs| and |rhs|.
+  void InitializeCall(const char* name, int32_t lhs, int32_t rhs,
+                      iree_runtime_call_t* out_call) {
+    IREE_ASSERT_OK(iree_runtime_call_initialize_by_name(
+        session_, iree_make_cstring_view(name), out_call));
+    iree_vm_value_t lhs_value = iree_vm_value_make_i32(lhs);
+    IREE_ASSERT_OK(iree_vm_list_push_value(out_call->inputs, &lhs_value));
+    iree_vm_value_t rhs_value = iree_vm_value_make_i32(rhs);
+    IREE_ASSERT_OK(iree_vm_list_push_value(out_call->inputs, &rhs_value));
+  }
+
+  iree_runtime_instance_t* instance_ = NULL;
+  iree_runtime_session_t* session_ = NULL;
+};
+
+TEST_F(SessionTest, CallAsyncInline) {
+  iree_runtime_call_t call;
+  InitializeCall("test.add", 1, 2, &call);
+
+  iree_loop_inline_storage_t loop_storage;
+  iree_vm_async_invoke_state_t state;
+  CallResult result;
+  IREE_ASSERT_OK(iree_runtime_call_invoke_async(
+      &call, IREE_RUNTIME_CALL_FLAG_RESERVED,
+      iree_loop_inline_initialize(&loop_storage), &state, RecordCallResult,
+      &result));
+  IREE_EXPECT_OK(loop_storage.status);
+  iree_loop_inline_deinitialize(&loop_storage);
+
+  EXPECT_EQ(1, result.callback_count);
+  EXPECT_EQ(IREE_STATUS_OK, result.status_code);
+  EXPECT_EQ(3, result.value);
+
+  iree_runtime_call_deinitialize(&call);
+}
+
+// A native function that yields is resumed by the loop once its wait resolves.
+TEST_F(SessionTest, CallAsyncInlineYield) {
+  iree_runtime_call_t call;
+  InitializeCall("test.add_delayed", 3, 4, &call);
+
+  iree_loop_inline_storage_t loop_storage;
+  iree_vm_async_invoke_state_t state;
+  CallResult result;
+  IREE_ASSERT_OK(iree_runtime_call_invoke_async(
+      &call, IREE_RUNTIME_CALL_FLAG_RESERVED,
+      iree_loop_inline_initialize(&loop_storage), &state, RecordCallResult,
+      &result));
+  IREE_EXPECT_OK(loop_storage.status);
+  iree_loop_inline_deinitialize(&loop_storage);
+
+  EXPECT_EQ(1, result.callback_count);
+  EXPECT_EQ(IREE_STATUS_OK, result.status_code);
+  EXPECT_EQ(7, result.value);
+
+  iree_runtime_call_deinitialize(&call);
+}
+
+TEST_F(SessionTest, CallAsyncRejectsUnknownFlags) {
+  iree_runtime_call_t call;
+  InitializeCall("test.add", 1, 2, &call);
+
+  iree_loop_inline_storage_t loop_storage;
+  iree_vm_async_invoke_state_t state;
+  CallResult result;
+  EXPECT_THAT(Status(iree_runtime_call_invoke_async(
+                  &call, /*flags=*/1u,
+                  iree_loop_inline_initialize(&loop_storage), &state,
+                  RecordCallResult, &result)),
+              StatusIs(StatusCode::kInvalidArgument));
+  iree_loop_inline_deinitialize(&loop_storage);
+  EXPECT_EQ(0, result.callback_count);
+
+  iree_runtime_call_deinitialize(&call);
+}
+
+}  // namespace
+}  // namespace iree
@@ -73,4 +73,23 @@ enum iree_cpu_data_field_0_e {
 
 };
 
+// Processor data field 1 identifies the processor model, for use as a key in
+// performance tuning tables (e.g. iree/builtins/ukernel/tuned_tile_sizes.inl).
+// It must never be used to infer ISA features, which is what data field 0 is
+// for: the same model may have features disabled by the OS or the hypervisor.
+// Zero means that the model is unknown.
+//
+// x86_64: the vendor and the "display" family and model, i.e. as computed by
+// combining the base and extended family and model fields of CPUID leaf 1.
+#define IREE_CPU_DATA1_X86_64_VENDOR_INTEL 1
+#define IREE_CPU_DATA1_X86_64_VENDOR_AMD 2
+#define IREE_CPU_DATA1_X86_64_MODEL(vendor, family, model)         \
+  ((((vendor) & 0xFFull) << 32) | (((family) & 0xFFFFull) << 16) | \
+   ((model) & 0xFFFFull))
+// arm_64: the implementer and part number fields of MIDR_EL1 of the core that
+// initialized the processor data. On heterogeneous (big.LITTLE) systems that is
+// only one of the core types.
+#define IREE_CPU_DATA1_ARM_64_MODEL(implementer, part_num) \
+  ((((implementer) & 0xFFull) << 16) | ((part_num) & 0xFFFull))
+
 #endif  // IREE_SCHEMAS_CPU_DATA_H_
@@ -53,6 +53,16 @@
 // enumeration here.
 IREE_CPU_FEATURE_BIT(ARM_64, 0, 0, DOTPROD, "dotprod")
 IREE_CPU_FEATURE_BIT(ARM_64, 0, 1, I8MM, "i8mm")
+IREE_CPU_FEATURE_BIT(ARM_64, 0, 2, SVE, "sve")
+IREE_CPU_FEATURE_BIT(ARM_64, 0, 3, SVE2, "sve2")
+IREE_CPU_FEATURE_BIT(ARM_64, 0, 4, SME, "sme")
+
+//===----------------------------------------------------------------------===//
+// IREE_ARCH_RISCV_64 / riscv64
+//===----------------------------------------------------------------------===//
+
+// Vector extension (RVV 1.0).
+IREE_CPU_FEATURE_BIT(RISCV_64, 0, 0, V, "v")
 
 //===----------------------------------------------------------------------===//
 // IREE_ARCH_X86_64 / x86-64
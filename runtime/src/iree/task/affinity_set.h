@@ -7,6 +7,10 @@
 #ifndef IREE_TASK_AFFINITY_SET_H_
 #define IREE_TASK_AFFINITY_SET_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/math.h"
 #include "iree/task/tuning.h"
@@ -25,6 +29,10 @@ extern "C" {
 // iree_task_affinity_set_t
 //===----------------------------------------------------------------------===//
 
+// A compact affinity hint carried on each task.
+// In executors with more than 64 workers each bit selects all workers with a
+// local index congruent to the bit index modulo 64; executors with 64 or fewer
+// workers map bits 1:1 with their workers.
 typedef uint64_t iree_task_affinity_set_t;
 
 // Allows for only a specific worker to be selected.
@@ -80,6 +88,196 @@ static inline iree_task_affinity_set_t iree_atomic_task_affinity_set_fetch_or(
   return iree_atomic_fetch_or_int64(set, value, order);
 }
 
+//===----------------------------------------------------------------------===//
+// iree_task_worker_set_t
+//===----------------------------------------------------------------------===//
+
+// Total number of bits in each word of a worker set.
+#define IREE_TASK_WORKER_SET_WORD_BIT_COUNT 64
+
+// Total number of words required to represent all workers in an executor.
+#define IREE_TASK_WORKER_SET_WORD_COUNT                                      \
+  ((IREE_TASK_EXECUTOR_MAX_WORKER_COUNT + IREE_TASK_WORKER_SET_WORD_BIT_COUNT - \
+    1) /                                                                     \
+   IREE_TASK_WORKER_SET_WORD_BIT_COUNT)
+
+// Total number of workers that can be represented in a worker set.
+#define IREE_TASK_WORKER_SET_BIT_COUNT \
+  (IREE_TASK_WORKER_SET_WORD_COUNT * IREE_TASK_WORKER_SET_WORD_BIT_COUNT)
+
+// A set of workers within an executor with one bit per local worker index.
+//
+// The set is stored as a two-level hierarchy of 64-bit words and bits within
+// those words. Operations that walk the set skip empty words entirely and then
+// use ctz/popcnt within each word such that their cost scales with the number
+// of set bits (plus one step per 64 workers) instead of the worker count.
+typedef struct iree_task_worker_set_t {
+  uint64_t words[IREE_TASK_WORKER_SET_WORD_COUNT];
+} iree_task_worker_set_t;
+
+// Clears all bits in |out_set|.
+static inline void iree_task_worker_set_clear(iree_task_worker_set_t* out_set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_set->words[i] = 0;
+  }
+}
+
+// Sets all bits in |out_set|.
+static inline void iree_task_worker_set_fill(iree_task_worker_set_t* out_set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_set->words[i] = UINT64_MAX;
+  }
+}
+
+// Returns true if no bits are set in |set|.
+static inline bool iree_task_worker_set_is_empty(
+    const iree_task_worker_set_t* set) {
+  uint64_t any_bits = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    any_bits |= set->words[i];
+  }
+  return any_bits == 0;
+}
+
+// Returns true if all bits are set in |set|.
+static inline bool iree_task_worker_set_is_full(
+    const iree_task_worker_set_t* set) {
+  uint64_t all_bits = UINT64_MAX;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    all_bits &= set->words[i];
+  }
+  return all_bits == UINT64_MAX;
+}
+
+// Returns true if |worker_index| is set in |set|.
+static inline bool iree_task_worker_set_contains(
+    const iree_task_worker_set_t* set, iree_host_size_t worker_index) {
+  return (set->words[worker_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT] >>
+          (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT)) &
+         1;
+}
+
+// Sets |worker_index| in |set|.
+static inline void iree_task_worker_set_insert(iree_task_worker_set_t* set,
+                                               iree_host_size_t worker_index) {
+  set->words[worker_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT] |=
+      1ull << (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT);
+}
+
+// Clears |worker_index| in |set|.
+static inline void iree_task_worker_set_remove(iree_task_worker_set_t* set,
+                                               iree_host_size_t worker_index) {
+  set->words[worker_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT] &=
+      ~(1ull << (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT));
+}
+
+// Returns the total number of bits set in |set|.
+static inline int iree_task_worker_set_count_ones(
+    const iree_task_worker_set_t* set) {
+  int count = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    count += iree_math_count_ones_u64(set->words[i]);
+  }
+  return count;
+}
+
+// Stores |lhs| & |rhs| in |out_set|. |out_set| may alias either input.
+static inline void iree_task_worker_set_and(const iree_task_worker_set_t* lhs,
+                                            const iree_task_worker_set_t* rhs,
+                                            iree_task_worker_set_t* out_set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_set->words[i] = lhs->words[i] & rhs->words[i];
+  }
+}
+
+// Stores |lhs| & ~|rhs| in |out_set|. |out_set| may alias either input.
+static inline void iree_task_worker_set_and_not(
+    const iree_task_worker_set_t* lhs, const iree_task_worker_set_t* rhs,
+    iree_task_worker_set_t* out_set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_set->words[i] = lhs->words[i] & ~rhs->words[i];
+  }
+}
+
+// Stores the workers in |set| that are selected by the task |affinity_set| in
+// |out_set|. |out_set| may alias |set|.
+static inline void iree_task_worker_set_and_affinity(
+    const iree_task_worker_set_t* set, iree_task_affinity_set_t affinity_set,
+    iree_task_worker_set_t* out_set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_set->words[i] = set->words[i] & affinity_set;
+  }
+}
+
+// Returns the index of the first bit set in |set| at or after |start_index| or
+// -1 if there are no more bits set.
+//
+// Usage:
+//  for (int i = iree_task_worker_set_find_next(&set, 0); i >= 0;
+//       i = iree_task_worker_set_find_next(&set, i + 1)) { ... }
+static inline int iree_task_worker_set_find_next(
+    const iree_task_worker_set_t* set, iree_host_size_t start_index) {
+  iree_host_size_t word_index =
+      start_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT;
+  if (word_index >= IREE_TASK_WORKER_SET_WORD_COUNT) return -1;
+  uint64_t word = set->words[word_index] &
+                  (UINT64_MAX << (start_index %
+                                  IREE_TASK_WORKER_SET_WORD_BIT_COUNT));
+  while (!word) {
+    if (++word_index >= IREE_TASK_WORKER_SET_WORD_COUNT) return -1;
+    word = set->words[word_index];
+  }
+  return (int)(word_index * IREE_TASK_WORKER_SET_WORD_BIT_COUNT +
+               iree_math_count_trailing_zeros_u64(word));
+}
+
+//===----------------------------------------------------------------------===//
+// iree_atomic_task_worker_set_t
+//===----------------------------------------------------------------------===//
+
+// An iree_task_worker_set_t that can be accessed atomically word-by-word.
+// Loads of the entire set are not atomic across words and callers must treat
+// the results as hints.
+typedef struct iree_atomic_task_worker_set_t {
+  iree_atomic_int64_t words[IREE_TASK_WORKER_SET_WORD_COUNT];
+} iree_atomic_task_worker_set_t;
+
+static inline void iree_atomic_task_worker_set_load(
+    iree_atomic_task_worker_set_t* set, iree_memory_order_t order,
+    iree_task_worker_set_t* out_value) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_value->words[i] = (uint64_t)iree_atomic_load_int64(&set->words[i], order);
+  }
+}
+
+static inline void iree_atomic_task_worker_set_store(
+    iree_atomic_task_worker_set_t* set, const iree_task_worker_set_t* value,
+    iree_memory_order_t order) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    iree_atomic_store_int64(&set->words[i], (int64_t)value->words[i], order);
+  }
+}
+
+// Sets |worker_index| in |set|. Only the word containing the bit is touched.
+static inline void iree_atomic_task_worker_set_insert(
+    iree_atomic_task_worker_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  iree_atomic_fetch_or_int64(
+      &set->words[worker_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT],
+      (int64_t)(1ull << (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT)),
+      order);
+}
+
+// Clears |worker_index| in |set|. Only the word containing the bit is touched.
+static inline void iree_atomic_task_worker_set_remove(
+    iree_atomic_task_worker_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  iree_atomic_fetch_and_int64(
+      &set->words[worker_index / IREE_TASK_WORKER_SET_WORD_BIT_COUNT],
+      (int64_t)~(1ull << (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT)),
+      order);
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,117 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/affinity_set.h"
+
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+// Returns all indices set in |set| in ascending order.
+std::vector<int> CollectIndices(const iree_task_worker_set_t& set) {
+  std::vector<int> indices;
+  for (int i = iree_task_worker_set_find_next(&set, 0); i >= 0;
+       i = iree_task_worker_set_find_next(&set, i + 1)) {
+    indices.push_back(i);
+  }
+  return indices;
+}
+
+TEST(WorkerSetTest, Empty) {
+  iree_task_worker_set_t set;
+  iree_task_worker_set_clear(&set);
+  EXPECT_TRUE(iree_task_worker_set_is_empty(&set));
+  EXPECT_FALSE(iree_task_worker_set_is_full(&set));
+  EXPECT_EQ(0, iree_task_worker_set_count_ones(&set));
+  EXPECT_EQ(-1, iree_task_worker_set_find_next(&set, 0));
+  EXPECT_EQ(-1, iree_task_worker_set_find_next(
+                    &set, IREE_TASK_WORKER_SET_BIT_COUNT));
+}
+
+TEST(WorkerSetTest, Full) {
+  iree_task_worker_set_t set;
+  iree_task_worker_set_fill(&set);
+  EXPECT_FALSE(iree_task_worker_set_is_empty(&set));
+  EXPECT_TRUE(iree_task_worker_set_is_full(&set));
+  EXPECT_EQ(IREE_TASK_WORKER_SET_BIT_COUNT,
+            iree_task_worker_set_count_ones(&set));
+}
+
+TEST(WorkerSetTest, InsertRemove) {
+  iree_task_worker_set_t set;
+  iree_task_worker_set_clear(&set);
+  const iree_host_size_t last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_task_worker_set_insert(&set, 0);
+  iree_task_worker_set_insert(&set, last_index);
+  EXPECT_TRUE(iree_task_worker_set_contains(&set, 0));
+  EXPECT_FALSE(iree_task_worker_set_contains(&set, 1));
+  EXPECT_TRUE(iree_task_worker_set_contains(&set, last_index));
+  EXPECT_EQ(2, iree_task_worker_set_count_ones(&set));
+  iree_task_worker_set_remove(&set, 0);
+  EXPECT_FALSE(iree_task_worker_set_contains(&set, 0));
+  EXPECT_EQ(std::vector<int>({(int)last_index}), CollectIndices(set));
+}
+
+TEST(WorkerSetTest, FindNextAcrossWords) {
+  iree_task_worker_set_t set;
+  iree_task_worker_set_clear(&set);
+  std::vector<int> expected = {3, 63};
+  if (IREE_TASK_WORKER_SET_WORD_COUNT > 1) {
+    expected.push_back(64);
+    expected.push_back(IREE_TASK_WORKER_SET_BIT_COUNT - 1);
+  }
+  for (int i : expected) iree_task_worker_set_insert(&set, i);
+  EXPECT_EQ(expected, CollectIndices(set));
+  EXPECT_EQ(63, iree_task_worker_set_find_next(&set, 4));
+}
+
+TEST(WorkerSetTest, Logic) {
+  iree_task_worker_set_t lhs, rhs, result;
+  iree_task_worker_set_clear(&lhs);
+  iree_task_worker_set_clear(&rhs);
+  iree_task_worker_set_insert(&lhs, 1);
+  iree_task_worker_set_insert(&lhs, 2);
+  iree_task_worker_set_insert(&rhs, 2);
+  iree_task_worker_set_insert(&rhs, 3);
+  iree_task_worker_set_and(&lhs, &rhs, &result);
+  EXPECT_EQ(std::vector<int>({2}), CollectIndices(result));
+  iree_task_worker_set_and_not(&lhs, &rhs, &result);
+  EXPECT_EQ(std::vector<int>({1}), CollectIndices(result));
+}
+
+TEST(WorkerSetTest, AndAffinity) {
+  // Affinity bits select workers modulo 64 in each word.
+  iree_task_worker_set_t set;
+  iree_task_worker_set_fill(&set);
+  iree_task_worker_set_and_affinity(&set, iree_task_affinity_for_worker(5),
+                                    &set);
+  std::vector<int> expected;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    expected.push_back((int)(i * IREE_TASK_WORKER_SET_WORD_BIT_COUNT + 5));
+  }
+  EXPECT_EQ(expected, CollectIndices(set));
+}
+
+TEST(AtomicWorkerSetTest, InsertRemove) {
+  iree_task_worker_set_t initial_set;
+  iree_task_worker_set_clear(&initial_set);
+  iree_atomic_task_worker_set_t atomic_set;
+  iree_atomic_task_worker_set_store(&atomic_set, &initial_set,
+                                    iree_memory_order_relaxed);
+  const iree_host_size_t last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_atomic_task_worker_set_insert(&atomic_set, 1, iree_memory_order_relaxed);
+  iree_atomic_task_worker_set_insert(&atomic_set, last_index,
+                                     iree_memory_order_relaxed);
+  iree_atomic_task_worker_set_remove(&atomic_set, 1, iree_memory_order_relaxed);
+  iree_task_worker_set_t set;
+  iree_atomic_task_worker_set_load(&atomic_set, iree_memory_order_relaxed,
+                                   &set);
+  EXPECT_EQ(std::vector<int>({(int)last_index}), CollectIndices(set));
+}
+
+}  // namespace
@@ -12,6 +12,7 @@
 #include "iree/base/internal/flags.h"
 #include "iree/base/tracing.h"
 #include "iree/task/topology.h"
+#include "iree/task/tuning.h"
 
 //===----------------------------------------------------------------------===//
 // Executor configuration
@@ -25,6 +26,15 @@ IREE_FLAG(
     "when latency is the #1 priority (vs. thermals, system-wide scheduling,\n"
     "etc).");
 
+IREE_FLAG(
+    bool, task_worker_adaptive_spin, false,
+    "Enables adaptive spinning where each worker learns how long to spin\n"
+    "waiting for additional work based on how soon work has recently arrived\n"
+    "after it went idle. Workers that see work arrive within a futex\n"
+    "round-trip will spin (up to --task_worker_spin_us, if non-zero) and\n"
+    "otherwise park immediately. Trades some power for lower dispatch latency\n"
+    "in latency-sensitive small-batch workloads.");
+
 IREE_FLAG(
     int32_t, task_worker_stack_size, 128 * 1024,
     "Minimum size in bytes of each worker thread stack.\n"
@@ -45,16 +55,29 @@ IREE_FLAG(
     "only use a specific maximum amount of local memory and the runtime must\n"
     "be configured to make at least that amount of local memory available.");
 
+IREE_FLAG(
+    int32_t, task_inline_dispatch_max_us,
+    IREE_TASK_DISPATCH_INLINE_MAX_NS / 1000,
+    "Maximum estimated duration in microseconds of a dispatch that is\n"
+    "executed on the thread that readies it instead of being distributed to\n"
+    "workers. Only applies to dispatches with cost hints from the executable.\n"
+    "Set to 0 to always distribute dispatches to workers.");
+
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
   IREE_ASSERT_ARGUMENT(out_options);
   iree_task_executor_options_initialize(out_options);
+  if (FLAG_task_worker_adaptive_spin) {
+    out_options->scheduling_mode |= IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN;
+  }
   out_options->worker_spin_ns =
       (iree_duration_t)FLAG_task_worker_spin_us * 1000;
   out_options->worker_stack_size =
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
       (iree_host_size_t)FLAG_task_worker_local_memory;
+  out_options->inline_dispatch_max_ns =
+      (iree_duration_t)FLAG_task_inline_dispatch_max_us * 1000;
   return iree_ok_status();
 }
 
@@ -69,6 +92,14 @@ IREE_FLAG(
     "flags. 'all' can be used to indicate all available NUMA nodes and\n"
     "'current' will inherit the node of the calling thread.");
 
+IREE_FLAG(
+    string, task_topology, "",
+    "A serialized topology as printed by --dump_task_topologies. When set a\n"
+    "single executor is created with the topology and the machine is not\n"
+    "queried; all other --task_topology_* flags are ignored. Use this to\n"
+    "skip topology discovery in short-lived processes that run repeatedly on\n"
+    "the same machine (for example by caching the value in a --flagfile=).");
+
 IREE_FLAG(
     string, task_topology_mode, "physical_cores",
     "Available modes:\n"
@@ -77,7 +108,10 @@ IREE_FLAG(
     "   All threads will be unpinned and run on system-determined processors.\n"
     " 'physical_cores':\n"
     "   Creates one group per physical core in each NUMA node up to\n"
-    "   the value specified by --task_topology_max_group_count=.");
+    "   the value specified by --task_topology_max_group_count=.\n"
+    " 'performance_cores':\n"
+    "   Like 'physical_cores' but only uses the most capable cores on\n"
+    "   heterogeneous (big.LITTLE) systems.");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -94,6 +128,34 @@ IREE_FLAG(
     "detected and used when --task_topology_group_count=0 and is ignored\n"
     "otherwise.");
 
+IREE_FLAG(
+    string, task_worker_priority, "normal",
+    "Scheduling priority class hint for task system workers. One of\n"
+    "'lowest', 'low', 'normal', 'high' or 'highest'. Raising the priority\n"
+    "may require additional process permissions and is ignored otherwise.");
+
+// Parses a --task_worker_priority= |value| into |out_priority_class|.
+static iree_status_t iree_task_parse_priority_class(
+    const char* value, iree_thread_priority_class_t* out_priority_class) {
+  if (strcmp(value, "lowest") == 0) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_LOWEST;
+  } else if (strcmp(value, "low") == 0) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+  } else if (strcmp(value, "normal") == 0) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  } else if (strcmp(value, "high") == 0) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_HIGH;
+  } else if (strcmp(value, "highest") == 0) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_HIGHEST;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --task_worker_priority=%s; expected one "
+                            "of 'lowest', 'low', 'normal', 'high', 'highest'",
+                            value);
+  }
+  return iree_ok_status();
+}
+
 // Builds a bitmask of NUMA nodes that topologies should be created for.
 //
 // NOTE: because of the mask being 64-bits we have a 64-node limit.
@@ -106,6 +168,13 @@ static iree_status_t iree_task_topologies_select_nodes_from_flags(
   IREE_ASSERT_ARGUMENT(out_node_mask);
   *out_node_mask = 0ull;
 
+  // A serialized topology defines a single executor and avoids querying the
+  // machine. The node is only used for iteration and is otherwise ignored.
+  if (strlen(FLAG_task_topology) > 0) {
+    *out_node_mask = 1ull;
+    return iree_ok_status();
+  }
+
   // Query the total number of NUMA nodes in the system. On implementations
   // where this information isn't available this will return 1.
   const iree_host_size_t available_node_count =
@@ -152,6 +221,12 @@ iree_status_t iree_task_topology_initialize_from_flags(
   IREE_ASSERT_ARGUMENT(out_topology);
   iree_task_topology_initialize(out_topology);
 
+  if (strlen(FLAG_task_topology) > 0) {
+    // Previously discovered topology; used as-is.
+    return iree_task_topology_parse(iree_make_cstring_view(FLAG_task_topology),
+                                    out_topology);
+  }
+
   if (FLAG_task_topology_group_count != 0) {
     // Unpinned topology. Let the system try to figure it out.
     iree_task_topology_initialize_from_group_count(
@@ -160,6 +235,10 @@ iree_status_t iree_task_topology_initialize_from_flags(
     // Physical cores sourced from a specific NUMA node.
     iree_task_topology_initialize_from_physical_cores(
         node_id, FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "performance_cores") == 0) {
+    // The most capable physical cores sourced from a specific NUMA node.
+    iree_task_topology_initialize_from_performance_cores(
+        node_id, FLAG_task_topology_max_group_count, out_topology);
   } else {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -168,6 +247,12 @@ iree_status_t iree_task_topology_initialize_from_flags(
         FLAG_task_topology_mode);
   }
 
+  iree_thread_priority_class_t priority_class =
+      IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  IREE_RETURN_IF_ERROR(iree_task_parse_priority_class(
+      FLAG_task_worker_priority, &priority_class));
+  iree_task_topology_set_priority_class(out_topology, priority_class);
+
   return iree_ok_status();
 }
 
@@ -227,26 +312,54 @@ static iree_status_t iree_task_flags_dump_task_topologies(
       }
       fprintf(stdout, "\n");
       fprintf(stdout, "#  cache sharing: ");
-      if (group->constructive_sharing_mask == 0) {
+      const iree_task_topology_group_mask_t* sharing_mask =
+          &group->constructive_sharing_mask;
+      if (iree_task_worker_set_is_empty(sharing_mask)) {
         fprintf(stdout, "(none)\n");
-      } else if (group->constructive_sharing_mask ==
-                 IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) {
+      } else if (iree_task_worker_set_is_full(sharing_mask)) {
         fprintf(stdout, "(all/undefined)\n");
       } else {
         fprintf(stdout, "%d group(s): ",
-                iree_math_count_ones_u64(group->constructive_sharing_mask));
-        for (iree_host_size_t ic = 0, jc = 0;
-             ic < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT; ++ic) {
-          if ((group->constructive_sharing_mask >> ic) & 1) {
-            if (jc > 0) fprintf(stdout, ", ");
-            fprintf(stdout, "%" PRIhsz, ic);
-            ++jc;
-          }
+                iree_task_worker_set_count_ones(sharing_mask));
+        for (int ic = iree_task_worker_set_find_next(sharing_mask, 0), jc = 0;
+             ic >= 0; ic = iree_task_worker_set_find_next(sharing_mask, ic + 1),
+                 ++jc) {
+          if (jc > 0) fprintf(stdout, ", ");
+          fprintf(stdout, "%d", ic);
         }
         fprintf(stdout, "\n");
       }
+      fprintf(stdout, "#            llc: ");
+      if (group->llc_id == IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN) {
+        fprintf(stdout, "(unknown)\n");
+      } else {
+        fprintf(stdout, "%u\n", group->llc_id);
+      }
+      fprintf(stdout, "#           node: ");
+      if (group->node_id == IREE_TASK_TOPOLOGY_NODE_ID_ANY) {
+        fprintf(stdout, "(unknown)\n");
+      } else {
+        fprintf(stdout, "%u\n", group->node_id);
+      }
+      fprintf(stdout, "#       capacity: ");
+      if (group->capacity == IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN) {
+        fprintf(stdout, "(unknown)\n");
+      } else {
+        fprintf(stdout, "%u\n", group->capacity);
+      }
+      fprintf(stdout, "#       priority: %d\n", (int)group->priority_class);
       fprintf(stdout, "#\n");
     }
+    iree_host_size_t serialized_length = 0;
+    iree_task_topology_format(&topology, 0, NULL, &serialized_length);
+    char* serialized = NULL;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        iree_allocator_system(), serialized_length + 1, (void**)&serialized));
+    iree_task_topology_format(&topology, serialized_length + 1, serialized,
+                              &serialized_length);
+    fprintf(stdout, "# --task_topology=%s\n", serialized);
+    fprintf(stdout, "#\n");
+    iree_allocator_free(iree_allocator_system(), serialized);
   }
 
   exit(0);
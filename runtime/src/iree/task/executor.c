@@ -27,6 +27,7 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor);
 void iree_task_executor_options_initialize(
     iree_task_executor_options_t* out_options) {
   memset(out_options, 0, sizeof(*out_options));
+  out_options->inline_dispatch_max_ns = IREE_TASK_DISPATCH_INLINE_MAX_NS;
 }
 
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
@@ -37,7 +38,8 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   if (worker_count > IREE_TASK_EXECUTOR_MAX_WORKER_COUNT) {
     return iree_make_status(
         IREE_STATUS_RESOURCE_EXHAUSTED,
-        "requested %zu workers but a maximum of %d is allowed", worker_count,
+        "requested %" PRIhsz " workers but a maximum of %d is allowed",
+        worker_count,
         IREE_TASK_EXECUTOR_MAX_WORKER_COUNT);
   }
 
@@ -53,12 +55,13 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   IREE_ASSERT_ARGUMENT(out_executor);
   *out_executor = NULL;
 
-  // The executor is followed in memory by worker[] + worker_local_memory[].
-  // The whole point is that we don't want destructive sharing between workers
-  // so ensure we are aligned to at least the destructive interference size.
+  // The executor is followed in memory by worker[]. Worker local memory is
+  // allocated separately and each block is page-aligned so that no pages are
+  // shared between workers: this both avoids destructive sharing and allows
+  // each worker to first-touch its own pages from the node it runs on.
   options.worker_local_memory_size =
       iree_host_align(options.worker_local_memory_size,
-                      iree_hardware_destructive_interference_size);
+                      IREE_TASK_EXECUTOR_WORKER_LOCAL_MEMORY_ALIGNMENT);
   IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)options.worker_local_memory_size);
   iree_host_size_t executor_base_size =
       iree_host_align(sizeof(iree_task_executor_t),
@@ -66,18 +69,27 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   iree_host_size_t worker_list_size =
       iree_host_align(worker_count * sizeof(iree_task_worker_t),
                       iree_hardware_destructive_interference_size);
-  iree_host_size_t executor_size =
-      executor_base_size + worker_list_size +
-      worker_count * options.worker_local_memory_size;
+  iree_host_size_t executor_size = executor_base_size + worker_list_size;
 
+  // The executor and workers keep fields written by different threads on
+  // separate cache lines, which requires the base to be line-aligned.
   iree_task_executor_t* executor = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(allocator, executor_size, (void**)&executor));
+      z0, iree_allocator_malloc_aligned(
+              allocator, executor_size,
+              iree_hardware_destructive_interference_size, 0,
+              (void**)&executor));
   memset(executor, 0, executor_size);
   iree_atomic_ref_count_init(&executor->ref_count);
   executor->allocator = allocator;
   executor->scheduling_mode = options.scheduling_mode;
   executor->worker_spin_ns = options.worker_spin_ns;
+  if ((options.scheduling_mode & IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN) &&
+      executor->worker_spin_ns == IREE_DURATION_ZERO) {
+    executor->worker_spin_ns = IREE_TASK_WORKER_ADAPTIVE_SPIN_MAX_NS;
+  }
+  executor->inline_dispatch_max_ns = options.inline_dispatch_max_ns;
+  executor->node_id = topology->node_id;
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
 
@@ -93,14 +105,28 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(&seed_prng),
                                   &executor->donation_theft_prng);
 
+  // Worker local memory is not touched here; each worker clears its own block
+  // during startup so the pages are placed near it. The allocator is
+  // guaranteed to return zeroed memory but large allocations are satisfied
+  // with untouched zero pages and faulted in on first write.
   iree_status_t status = iree_ok_status();
+  const iree_host_size_t worker_local_memory_total_size =
+      worker_count * options.worker_local_memory_size;
+  if (worker_local_memory_total_size > 0) {
+    status = iree_allocator_malloc_aligned(
+        allocator, worker_local_memory_total_size,
+        IREE_TASK_EXECUTOR_WORKER_LOCAL_MEMORY_ALIGNMENT, 0,
+        (void**)&executor->worker_local_memory);
+  }
 
   // Pool used for system events; exposed to users of the task system to ensure
   // we minimize the number of live events and reduce overheads in
   // high-frequency transient parking operations.
   if (iree_status_is_ok(status)) {
-    status = iree_event_pool_allocate(IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY,
-                                      allocator, &executor->event_pool);
+    status = iree_event_pool_allocate(
+        IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY,
+        IREE_TASK_EXECUTOR_EVENT_POOL_MAX_CAPACITY, allocator,
+        &executor->event_pool);
   }
 
   // Pool used for all fanout tasks. These only live within the executor and
@@ -132,19 +158,19 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
     executor->worker_count = worker_count;
     executor->workers =
         (iree_task_worker_t*)((uint8_t*)executor + executor_base_size);
-    uint8_t* worker_local_memory =
-        (uint8_t*)executor->workers + worker_list_size;
+    uint8_t* worker_local_memory = executor->worker_local_memory;
 
-    iree_task_affinity_set_t worker_idle_mask = 0;
-    iree_task_affinity_set_t worker_live_mask = 0;
+    iree_task_worker_set_t worker_idle_mask;
+    iree_task_worker_set_t worker_live_mask;
+    iree_task_worker_set_clear(&worker_idle_mask);
+    iree_task_worker_set_clear(&worker_live_mask);
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
-      iree_task_affinity_set_t worker_bit = iree_task_affinity_for_worker(i);
-      worker_idle_mask |= worker_bit;
-      worker_live_mask |= worker_bit;
+      iree_task_worker_set_insert(&worker_idle_mask, i);
+      iree_task_worker_set_insert(&worker_live_mask, i);
 
       iree_task_worker_t* worker = &executor->workers[i];
       status = iree_task_worker_initialize(
-          executor, i, iree_task_topology_get_group(topology, i),
+          executor, i, topology,
           options.worker_stack_size,
           iree_make_byte_span(worker_local_memory,
                               options.worker_local_memory_size),
@@ -153,12 +179,12 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
       if (!iree_status_is_ok(status)) break;
     }
     // The masks are accessed with 'relaxed' order because they are just hints.
-    iree_atomic_task_affinity_set_store(&executor->worker_idle_mask,
-                                        worker_idle_mask,
-                                        iree_memory_order_relaxed);
-    iree_atomic_task_affinity_set_store(&executor->worker_live_mask,
-                                        worker_live_mask,
-                                        iree_memory_order_relaxed);
+    iree_atomic_task_worker_set_store(&executor->worker_idle_mask,
+                                      &worker_idle_mask,
+                                      iree_memory_order_relaxed);
+    iree_atomic_task_worker_set_store(&executor->worker_live_mask,
+                                      &worker_live_mask,
+                                      iree_memory_order_relaxed);
   }
 
   if (!iree_status_is_ok(status)) {
@@ -211,7 +237,11 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
   iree_atomic_task_slist_deinitialize(&executor->incoming_ready_slist);
   iree_task_pool_deinitialize(&executor->transient_task_pool);
-  iree_allocator_free(executor->allocator, executor);
+  if (executor->worker_local_memory) {
+    iree_allocator_free_aligned(executor->allocator,
+                                executor->worker_local_memory);
+  }
+  iree_allocator_free_aligned(executor->allocator, executor);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -229,6 +259,9 @@ void iree_task_executor_release(iree_task_executor_t* executor) {
 }
 
 void iree_task_executor_trim(iree_task_executor_t* executor) {
+  // The event pool is safe to trim with events outstanding.
+  iree_event_pool_trim(executor->event_pool);
+
   // TODO(benvanik): figure out a good way to do this; the pools require that
   // no tasks are in-flight to trim but our caller can't reliably make that
   // guarantee. We'd need some global executor lock that we did here and
@@ -237,6 +270,11 @@ void iree_task_executor_trim(iree_task_executor_t* executor) {
   // iree_task_pool_trim(&executor->transient_task_pool);
 }
 
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor) {
+  return executor->node_id;
+}
+
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor) {
   return executor->worker_count;
@@ -275,6 +313,68 @@ static void iree_task_executor_relay_to_worker(
   iree_task_post_batch_enqueue(post_batch, worker_index, task);
 }
 
+// Returns true if |task| is a dispatch that allows inline execution on
+// |current_worker| (or the calling non-worker thread if NULL) and is estimated
+// to be cheaper to execute there than to issue to workers.
+static bool iree_task_executor_can_execute_inline(
+    iree_task_executor_t* executor, iree_task_worker_t* current_worker,
+    iree_task_t* task) {
+  if (executor->inline_dispatch_max_ns <= 0) return false;
+  if (task->type != IREE_TASK_TYPE_DISPATCH) return false;
+  if (!(task->flags & IREE_TASK_FLAG_DISPATCH_INLINE) ||
+      (task->flags &
+       (IREE_TASK_FLAG_DISPATCH_INDIRECT | IREE_TASK_FLAG_DISPATCH_RETIRE))) {
+    return false;
+  }
+  if (!task->scope || iree_task_scope_has_failed(task->scope) ||
+      iree_task_scope_has_expired(task->scope)) {
+    return false;
+  }
+  const iree_task_dispatch_t* dispatch_task = (const iree_task_dispatch_t*)task;
+  if (!dispatch_task->tile_cost_ns) return false;
+  if (current_worker) {
+    // Workers may only run dispatches they could have been assigned shards of
+    // and must have enough local memory for the tiles.
+    const iree_host_size_t worker_index = current_worker->local_worker_index;
+    if (!((task->affinity_set >>
+           (worker_index % IREE_TASK_WORKER_SET_WORD_BIT_COUNT)) &
+          1)) {
+      return false;
+    }
+    if (dispatch_task->local_memory_size >
+        current_worker->local_memory.data_length) {
+      return false;
+    }
+  } else if (dispatch_task->local_memory_size > 0) {
+    return false;
+  }
+  const uint32_t* workgroup_count = dispatch_task->workgroup_count.value;
+  const uint64_t tile_count = (uint64_t)workgroup_count[0] *
+                              workgroup_count[1] * workgroup_count[2];
+  return tile_count > 0 && tile_count * dispatch_task->tile_cost_ns <=
+                               (uint64_t)executor->inline_dispatch_max_ns;
+}
+
+bool iree_task_executor_try_execute_inline(
+    iree_task_executor_t* executor, iree_task_worker_t* current_worker,
+    iree_task_t* task, iree_task_submission_t* pending_submission) {
+  if (!iree_task_executor_can_execute_inline(executor, current_worker, task)) {
+    return false;
+  }
+  iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+  if (current_worker) {
+    iree_task_dispatch_execute_inline(
+        dispatch_task, current_worker->processor_id,
+        current_worker->worker_index, current_worker->local_memory,
+        pending_submission);
+  } else {
+    iree_task_dispatch_execute_inline(
+        dispatch_task, iree_cpu_query_processor_id(), /*worker_id=*/0,
+        iree_byte_span_empty(), pending_submission);
+  }
+  return true;
+}
+
 // Schedules all ready tasks in the |pending_submission| list.
 // Task may enqueue zero or more new tasks (or newly-ready/waiting tasks) to
 // |pending_submission| or queue work for posting to workers via the
@@ -292,11 +392,12 @@ void iree_task_executor_schedule_ready_tasks(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_task_t* task = NULL;
   while ((task = iree_task_list_pop_front(&pending_submission->ready_list))) {
-    // If the scope has been marked as failing then we abort the task.
-    // This needs to happen as a poll here because one or more of the tasks we
-    // are joining may have failed.
+    // If the scope has been marked as failing or its deadline has elapsed then
+    // we abort the task. This needs to happen as a poll here because one or
+    // more of the tasks we are joining may have failed.
     if (IREE_UNLIKELY(!task->scope ||
-                      iree_task_scope_has_failed(task->scope))) {
+                      iree_task_scope_has_failed(task->scope) ||
+                      iree_task_scope_has_expired(task->scope))) {
       iree_task_list_t discard_worklist;
       iree_task_list_initialize(&discard_worklist);
       iree_task_discard(task, &discard_worklist);
@@ -342,9 +443,16 @@ void iree_task_executor_schedule_ready_tasks(
       case IREE_TASK_TYPE_DISPATCH: {
         // Dispatches may need to be issued (fanning out the tiles to workers)
         // or retired (after all tiles have completed).
+        // Small dispatches may instead be executed inline on the coordinating
+        // thread; tasks they ready are pushed to the front of the submission
+        // and scheduled next.
         if (task->flags & IREE_TASK_FLAG_DISPATCH_RETIRE) {
           iree_task_dispatch_retire((iree_task_dispatch_t*)task,
                                     pending_submission);
+        } else if (iree_task_executor_try_execute_inline(
+                       executor, post_batch->current_worker, task,
+                       pending_submission)) {
+          // Executed and retired inline.
         } else {
           iree_task_dispatch_issue((iree_task_dispatch_t*)task,
                                    &executor->transient_task_pool,
@@ -378,10 +486,89 @@ void iree_task_executor_merge_submission(iree_task_executor_t* executor,
   iree_task_submission_reset(submission);
 }
 
+#if IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
+// Returns true if |task| is a dispatch small enough that it can be directly
+// issued to worker mailboxes from the submitting thread.
+static bool iree_task_executor_can_issue_direct(iree_task_executor_t* executor,
+                                                iree_task_t* task) {
+  if (task->type != IREE_TASK_TYPE_DISPATCH) return false;
+  // Indirect dispatches need their workgroup count resolved and retiring
+  // dispatches need to propagate to dependents: both go through coordination.
+  if (task->flags &
+      (IREE_TASK_FLAG_DISPATCH_INDIRECT | IREE_TASK_FLAG_DISPATCH_RETIRE)) {
+    return false;
+  }
+  // Let the coordinator handle discarding when the scope has failed.
+  if (!task->scope || iree_task_scope_has_failed(task->scope) ||
+      iree_task_scope_has_expired(task->scope)) {
+    return false;
+  }
+  const uint32_t* workgroup_count =
+      ((iree_task_dispatch_t*)task)->workgroup_count.value;
+  const uint64_t tile_count = (uint64_t)workgroup_count[0] *
+                              workgroup_count[1] * workgroup_count[2];
+  return tile_count > 0 && tile_count <= executor->worker_count;
+}
+
+// Issues tiny dispatches in the ready list of |submission| directly to worker
+// mailboxes without going through the coordinator. Each such dispatch has no
+// more tiles than there are workers and would be split into single-tile shards
+// anyway; doing it here avoids a trip through the incoming queue and the
+// coordinator lock that can otherwise dominate the cost of micro-dispatches.
+// Dispatches cheaper than waking a worker are executed on the calling thread
+// instead. All other tasks are left in the submission in their original order.
+static void iree_task_executor_issue_direct_dispatches(
+    iree_task_executor_t* executor, iree_task_submission_t* submission) {
+  iree_task_post_batch_t* post_batch = NULL;
+  iree_task_list_t remaining_list;
+  iree_task_list_initialize(&remaining_list);
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(&submission->ready_list))) {
+    if (iree_task_executor_try_execute_inline(executor, /*current_worker=*/NULL,
+                                              task, submission)) {
+      // Tasks readied by the dispatch retiring are pushed to the front of the
+      // ready list and will be visited next.
+      continue;
+    }
+    if (!iree_task_executor_can_issue_direct(executor, task)) {
+      iree_task_list_push_back(&remaining_list, task);
+      continue;
+    }
+    if (!post_batch) {
+      post_batch =
+          iree_alloca(sizeof(iree_task_post_batch_t) +
+                      executor->worker_count * IREE_TASK_PRIORITY_COUNT *
+                      sizeof(iree_task_list_t));
+      iree_task_post_batch_initialize(executor, /*current_worker=*/NULL,
+                                      post_batch);
+    }
+    // Dispatches with tiles never retire inline during issue so the
+    // submission will not be modified.
+    iree_task_dispatch_issue((iree_task_dispatch_t*)task,
+                             &executor->transient_task_pool, submission,
+                             post_batch);
+  }
+  iree_task_list_move(&remaining_list, &submission->ready_list);
+  if (post_batch) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0,
+                                "iree_task_executor_issue_direct_dispatches");
+    iree_task_post_batch_submit(post_batch);
+    IREE_TRACE_ZONE_END(z0);
+  }
+}
+
+#endif  // IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
 void iree_task_executor_submit(iree_task_executor_t* executor,
                                iree_task_submission_t* submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+#if IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+  // Bypass coordination for tiny dispatches that are ready to run.
+  iree_task_executor_issue_direct_dispatches(executor, submission);
+#endif  // IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
   // Concatenate the submitted tasks onto our primary LIFO incoming lists.
   iree_task_executor_merge_submission(executor, submission);
 
@@ -454,7 +641,8 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // a cache miss by making them live here in the stack of the chosen thread.
     iree_task_post_batch_t* post_batch =
         iree_alloca(sizeof(iree_task_post_batch_t) +
-                    executor->worker_count * sizeof(iree_task_list_t));
+                    executor->worker_count * IREE_TASK_PRIORITY_COUNT *
+                    sizeof(iree_task_list_t));
     iree_task_post_batch_initialize(executor, current_worker, post_batch);
 
     // Schedule all ready tasks in this batch. Some may complete inline (such
@@ -478,34 +666,20 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
   IREE_TRACE_ZONE_END(z0);
 }
 
-static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
-    iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
-    uint32_t max_theft_attempts, int rotation_offset,
-    iree_task_queue_t* local_task_queue) {
-  if (!victim_mask) return NULL;
-  max_theft_attempts = iree_min(max_theft_attempts,
-                                iree_task_affinity_set_count_ones(victim_mask));
-  victim_mask = iree_task_affinity_set_rotr(victim_mask, rotation_offset);
-
-  int worker_index = rotation_offset;
-  iree_task_affinity_set_t mask =
-      iree_task_affinity_set_rotr(victim_mask, worker_index);
-  for (uint32_t i = 0; i < max_theft_attempts; ++i) {
-    // Find the last set bit and skip to it. This avoids the need for doing
-    // a full O(n) scan and instead gets us at O(popcnt) * O(ctz).
-    //
-    // Example: sharing mask = 0b01010101
-    //          mask_rotation = 3 (randomly selected)
-    //          mask = 0b01010101 rotr 3 = 0b10101010
-    //          for (i = 0; i < 4; ++i)
-    //            offset = ctz(0b10101010) = 1
-    //            mask_rotation += 1 = 4
-    //            mask >>= 1 = 0b01010101
-    //            victim_index = 4 % 64 = 4
-    int offset = iree_task_affinity_set_count_trailing_zeros(mask);
-    int victim_index = (worker_index + offset) % executor->worker_count;
-    worker_index += offset + 1;
-    mask = iree_shr(mask, offset + 1);
+static iree_task_t* iree_task_executor_try_steal_task_from_worker_set(
+    iree_task_executor_t* executor, const iree_task_worker_set_t* victim_set,
+    uint32_t max_theft_attempts, iree_host_size_t start_index,
+    iree_task_queue_t local_task_queues[IREE_TASK_PRIORITY_COUNT]) {
+  // Walk the set bits starting at |start_index| and wrapping around. Empty
+  // words are skipped entirely and within each word we jump directly to the
+  // next set bit so this is O(popcnt) * O(ctz) plus one step per 64 workers
+  // instead of a full O(n) scan.
+  int victim_index = iree_task_worker_set_find_next(victim_set, start_index);
+  if (victim_index < 0) {
+    victim_index = iree_task_worker_set_find_next(victim_set, 0);
+  }
+  const int first_victim_index = victim_index;
+  for (uint32_t i = 0; i < max_theft_attempts && victim_index >= 0; ++i) {
     iree_task_worker_t* victim_worker = &executor->workers[victim_index];
     if (iree_atomic_load_int32(&victim_worker->state,
                                iree_memory_order_acquire) !=
@@ -520,23 +694,34 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     // thievery taking ~half of the tasks each time (across all queues) will
     // lead to a relatively even distribution.
     iree_task_t* task = iree_task_worker_try_steal_task(
-        victim_worker, local_task_queue,
+        victim_worker, local_task_queues,
         /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
     if (task) return task;
+
+    victim_index = iree_task_worker_set_find_next(victim_set, victim_index + 1);
+    if (victim_index < 0) {
+      victim_index = iree_task_worker_set_find_next(victim_set, 0);
+    }
+    if (victim_index == first_victim_index) break;
   }
 
-  // No tasks found in victim_mask.
+  // No tasks found in victim_set.
   return NULL;
 }
 
 // Tries to steal an entire task from a sibling worker (based on topology).
-// Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// Returns a task that is available (has not yet begun processing at all or is
+// a dispatch shard that yielded and can be resumed anywhere).
+// May steal multiple tasks and add them to the |local_task_queues| of the same
+// priority.
 //
-// We do a scan through ideal victims indicated by the
-// |constructive_sharing_mask|; these are the workers most likely to have some
-// cache benefits to taking their work as they share some level of the cache
-// hierarchy and should be better to steal from than any random worker.
+// Victims are tried in tiers defined by the |sharing_masks| of the thief:
+// first workers sharing low-level caches, then those sharing the last-level
+// cache, then those on the same NUMA node, and only then any remaining worker.
+// Workers nearer in the hierarchy are the most likely to have some cache
+// benefits to taking their work and should be better to steal from than any
+// random worker; stealing across a last-level cache or node boundary drags the
+// victim's operands along with the task.
 //
 // To prevent biasing any particular victim we use a fast prng function to
 // select where in the set of potential victims defined by the topology
@@ -545,45 +730,67 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // our search and then go in-order.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
+    const iree_task_worker_set_t
+        sharing_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT],
     uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_queue_t local_task_queues[IREE_TASK_PRIORITY_COUNT]) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // The masks are accessed with 'relaxed' order because they are just hints.
-  iree_task_affinity_set_t worker_live_mask =
-      iree_atomic_task_affinity_set_load(&executor->worker_live_mask,
-                                         iree_memory_order_relaxed);
-  iree_task_affinity_set_t worker_idle_mask =
-      iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
-                                         iree_memory_order_relaxed);
+  iree_task_worker_set_t worker_live_mask;
+  iree_atomic_task_worker_set_load(&executor->worker_live_mask,
+                                   iree_memory_order_relaxed, &worker_live_mask);
+  iree_task_worker_set_t worker_idle_mask;
+  iree_atomic_task_worker_set_load(&executor->worker_idle_mask,
+                                   iree_memory_order_relaxed, &worker_idle_mask);
   // Limit the workers we will steal from to the ones that are currently live
   // and not idle.
-  iree_task_affinity_set_t victim_mask = worker_live_mask & ~worker_idle_mask;
+  iree_task_worker_set_t victim_mask;
+  iree_task_worker_set_and_not(&worker_live_mask, &worker_idle_mask,
+                               &victim_mask);
 
   // TODO(benvanik): it may be possible to rework this such that we better
-  // use the prng; for example, instead of all this rotating stuff we could just
-  // generate an 8-bit number (or even split it into two 4-bit numbers) per
-  // theft attempt. The current rotation strategy is biased toward the same try
-  // ordering vs. what we may really want with an unbiased random selection.
-  int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng) &
-                        (8 * sizeof(iree_task_affinity_set_t) - 1);
-
-  // Try first with the workers we may have some caches shared with. This
+  // use the prng; for example, instead of selecting a starting point and going
+  // in-order we could generate a new index per theft attempt. The current
+  // strategy is biased toward the same try ordering vs. what we may really
+  // want with an unbiased random selection.
+  const iree_host_size_t start_index =
+      (((iree_host_size_t)iree_prng_minilcg128_next_uint8(theft_prng) << 8) |
+       iree_prng_minilcg128_next_uint8(theft_prng)) %
+      executor->worker_count;
+
+  // Try each level of the hierarchy in order from nearest to farthest. This
   // helps to prevent cache invalidations/availability updates as it's likely
   // that we won't need to go back to main memory (or higher cache tiers) in the
   // event that the thief and victim are running close to each other in time.
-  iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
-  if (task) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
-  } else {
-    task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+  iree_task_t* task = NULL;
+  for (iree_host_size_t i = 0; i < IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT;
+       ++i) {
+    iree_task_worker_set_t level_victim_mask;
+    iree_task_worker_set_and(&victim_mask, &sharing_masks[i],
+                             &level_victim_mask);
+    task = iree_task_executor_try_steal_task_from_worker_set(
+        executor, &level_victim_mask, max_theft_attempts, start_index,
+        local_task_queues);
+    if (task) {
+      IREE_TRACE_ZONE_APPEND_TEXT(
+          z0, iree_task_topology_sharing_level_name(
+                  (iree_task_topology_sharing_level_t)i));
+      break;
+    }
+    // Drop the level from the set so that the remaining victims are all
+    // farther away.
+    iree_task_worker_set_and_not(&victim_mask, &sharing_masks[i],
+                                 &victim_mask);
+  }
+
+  // Fall back to any remaining worker (remote nodes or unknown topology).
+  if (!task) {
+    task = iree_task_executor_try_steal_task_from_worker_set(
+        executor, &victim_mask, max_theft_attempts, start_index,
+        local_task_queues);
     if (task) {
-      IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "remote");
     }
   }
 
@@ -127,26 +127,30 @@ extern "C" {
 //      in LIFO order.
 //
 //   c. iree_task_post_batch_submit: per-worker tasks are pushed to their
-//      respective iree_task_worker_t mailbox_slist and the workers with new
-//      tasks are notified to wake up (if not already awake).
+//      respective iree_task_worker_t mailbox_slists (one per scope priority)
+//      and the workers with new tasks are notified to wake up (if not already
+//      awake).
 //
 // 4. iree_task_worker_main_pump_once (LIFO mailbox -> FIFO thread-local list)
 //    When either woken or after completing all available thread-local work
-//    each worker will check its mailbox_slist to see if any tasks have been
-//    posted.
+//    each worker will check its mailbox_slists to see if any tasks have been
+//    posted. Each step below is performed for each priority from highest to
+//    lowest and the first task found is executed.
 //
-//    a. Tasks are flushed from the LIFO mailbox into the local_task_queue FIFO
-//       for the particular worker.
+//    a. Tasks are flushed from the LIFO mailbox into the local_task_queues FIFO
+//       of the same priority for the particular worker.
 //
-//    b. If the mailbox is empty the worker *may* attempt to steal work from
+//    b. If the mailboxes are empty the worker *may* attempt to steal work from
 //       another nearby worker in the topology.
 //
-//    c. Any tasks in the local_task_queue are executed until empty.
+//    c. Any tasks in the local_task_queues are executed until empty.
 //       Tasks are retired and dependent tasks (via completion_task or barriers)
 //       are made ready and placed in the executor incoming_ready_slist as with
-//       iree_task_executor_submit.
+//       iree_task_executor_submit. Dispatch shards yield at tile chunk
+//       boundaries if higher-priority tasks are posted to the worker mailbox
+//       and are re-queued to resume once the higher-priority tasks complete.
 //
-//    d. If no more thread-local work is available and the mailbox_slist is
+//    d. If no more thread-local work is available and the mailbox_slists are
 //       empty the worker will self-nominate for coordination and attempt to don
 //       the coordinator hat with iree_task_executor_coordinate. If new work
 //       becomes available after coordination step 5 repeats.
@@ -265,6 +269,15 @@ enum iree_task_scheduling_mode_bits_t {
   // reach peak utilization or artificially limiting which tasks we allow
   // through to keep certain CPU cores asleep unless absolutely required.
   IREE_TASK_SCHEDULING_MODE_RESERVED = 0u,
+
+  // Workers adapt how long they spin before parking based on the recent idle
+  // durations they have observed. When new work tends to arrive shortly after
+  // a worker runs out it will spin (yielding the processor) to avoid the cost
+  // of sleeping in the kernel and being woken; when work arrives infrequently
+  // the worker will park immediately. worker_spin_ns, if non-zero, bounds the
+  // maximum spin duration and otherwise
+  // IREE_TASK_WORKER_ADAPTIVE_SPIN_MAX_NS is used.
+  IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN = 1u << 0,
 };
 typedef uint32_t iree_task_scheduling_mode_t;
 
@@ -285,7 +298,9 @@ typedef struct iree_task_executor_options_t {
   // additional work. In almost all cases this should be IREE_DURATION_ZERO as
   // spinning is often extremely harmful to system health. Only set to non-zero
   // values when latency is the #1 priority (over thermals, system-wide
-  // scheduling, and the environment).
+  // scheduling, and the environment). When
+  // IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN is set this is the upper bound on
+  // the adaptive spin duration.
   iree_duration_t worker_spin_ns;
 
   // Minimum size in bytes of each worker thread stack.
@@ -302,6 +317,13 @@ typedef struct iree_task_executor_options_t {
   // for their invocations and no more. May be 0 if no worker local memory is
   // required.
   iree_host_size_t worker_local_memory_size;
+
+  // Maximum estimated duration in nanoseconds of a dispatch with the
+  // IREE_TASK_FLAG_DISPATCH_INLINE flag that is executed on the thread that
+  // readies it instead of being distributed to workers. Ready dispatches are
+  // executed inline by the thread submitting them or by the worker retiring
+  // their last dependency. 0 disables inline execution.
+  iree_duration_t inline_dispatch_max_ns;
 } iree_task_executor_options_t;
 
 // Initializes |out_options| to default values.
@@ -330,6 +352,12 @@ void iree_task_executor_release(iree_task_executor_t* executor);
 // Trims pools and caches used by the executor and its workers.
 void iree_task_executor_trim(iree_task_executor_t* executor);
 
+// Returns the NUMA node the executor workers are pinned to or
+// IREE_TASK_TOPOLOGY_NODE_ID_ANY if they may run on any node.
+// Memory allocated for use by the executor should ideally come from this node.
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor);
+
 // Returns the number of live workers usable by the executor.
 // The actual number used for any particular operation is dynamic.
 iree_host_size_t iree_task_executor_worker_count(
@@ -360,6 +388,13 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
 // Safe to call from any thread. Wait-free but may block for a small duration
 // during initial scheduling of the submitted tasks.
 //
+// Ready dispatches with no more tiles than there are workers are issued
+// directly to worker mailboxes from the calling thread and do not wait for the
+// next flush (see IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE). Ready dispatches
+// with IREE_TASK_FLAG_DISPATCH_INLINE that are estimated to take less than
+// iree_task_executor_options_t::inline_dispatch_max_ns are executed on the
+// calling thread before returning.
+//
 // NOTE: it's possible for all work in the submission to complete prior to this
 // function returning.
 void iree_task_executor_submit(iree_task_executor_t* executor,
@@ -0,0 +1,393 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Microbenchmarks of task executor scheduling overheads.
+// Each benchmark is registered once per worker count and builds its own
+// executor so that the results reflect the cost of the scheduling primitives
+// themselves (submission, coordination, wake-up, stealing, and retirement)
+// and not any real work.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/wait_handle.h"
+#include "iree/task/api.h"
+#include "iree/testing/benchmark.h"
+
+// Number of tasks issued per benchmark step by the batched benchmarks.
+#define IREE_TASK_BENCHMARK_BATCH_SIZE 64
+
+// Number of workgroups per worker in the empty dispatch benchmark.
+#define IREE_TASK_BENCHMARK_TILES_PER_WORKER 16
+
+// Spin iterations performed by each task in the work stealing benchmark.
+// Large enough that the workers not owning the tasks have time to steal them.
+#define IREE_TASK_BENCHMARK_STEAL_SPIN_COUNT 2000
+
+typedef struct iree_task_benchmark_t {
+  iree_task_executor_t* executor;
+  iree_task_scope_t scope;
+} iree_task_benchmark_t;
+
+static void iree_task_benchmark_initialize(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state,
+    iree_task_benchmark_t* out_benchmark) {
+  const iree_host_size_t worker_count =
+      (iree_host_size_t)(uintptr_t)benchmark_def->user_data;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(worker_count, &topology);
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  IREE_CHECK_OK(iree_task_executor_create(options, &topology,
+                                          benchmark_state->host_allocator,
+                                          &out_benchmark->executor));
+  iree_task_topology_deinitialize(&topology);
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             &out_benchmark->scope);
+}
+
+static void iree_task_benchmark_deinitialize(iree_task_benchmark_t* benchmark) {
+  iree_task_scope_deinitialize(&benchmark->scope);
+  iree_task_executor_release(benchmark->executor);
+}
+
+// Returns a pooled fence that tracks the scope until all of the tasks
+// it is set as the completion task of have retired. The scope only waits
+// on fences so every benchmark step must end in one.
+static iree_task_fence_t* iree_task_benchmark_acquire_fence(
+    iree_task_benchmark_t* benchmark) {
+  iree_task_fence_t* fence = NULL;
+  IREE_CHECK_OK(iree_task_executor_acquire_fence(benchmark->executor,
+                                                 &benchmark->scope, &fence));
+  return fence;
+}
+
+// Submits |submission| and waits for the scope to go idle.
+static void iree_task_benchmark_submit_and_wait(
+    iree_task_benchmark_t* benchmark, iree_task_submission_t* submission) {
+  iree_task_executor_submit(benchmark->executor, submission);
+  iree_task_executor_flush(benchmark->executor);
+  IREE_CHECK_OK(
+      iree_task_scope_wait_idle(&benchmark->scope, IREE_TIME_INFINITE_FUTURE));
+}
+
+// Submits the DAG beginning at |head_task| and ending at |tail_task| and waits
+// for it to complete.
+static void iree_task_benchmark_submit_and_wait_on(
+    iree_task_benchmark_t* benchmark, iree_task_t* head_task,
+    iree_task_t* tail_task) {
+  iree_task_fence_t* fence = iree_task_benchmark_acquire_fence(benchmark);
+  iree_task_set_completion_task(tail_task, &fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, head_task);
+  iree_task_benchmark_submit_and_wait(benchmark, &submission);
+}
+
+static iree_status_t iree_task_benchmark_call_nop(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_benchmark_call_spin(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  volatile uint32_t counter = 0;
+  for (uint32_t i = 0; i < IREE_TASK_BENCHMARK_STEAL_SPIN_COUNT; ++i) {
+    counter = counter + 1;
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_benchmark_tile_nop(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Submission
+//===----------------------------------------------------------------------===//
+
+// Measures the per-task cost of submitting, coordinating, and retiring a batch
+// of independent nop tasks. Nops are retired by the coordinator without ever
+// being posted to a worker.
+static iree_status_t iree_task_benchmark_submit_nop_batch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  iree_task_nop_t tasks[IREE_TASK_BENCHMARK_BATCH_SIZE];
+  int64_t step_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_fence_t* fence = iree_task_benchmark_acquire_fence(&benchmark);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+      iree_task_nop_initialize(&benchmark.scope, &tasks[i]);
+      iree_task_set_completion_task(&tasks[i].header, &fence->header);
+      iree_task_submission_enqueue(&submission, &tasks[i].header);
+    }
+    iree_task_benchmark_submit_and_wait(&benchmark, &submission);
+    ++step_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state,
+                                     step_count * IREE_ARRAYSIZE(tasks));
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+// Measures the round-trip latency of a single call task from submission through
+// the coordinator to a worker and back to the waiting caller while the workers
+// are warm.
+static iree_status_t iree_task_benchmark_call_roundtrip(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_call_t task;
+    iree_task_call_initialize(
+        &benchmark.scope,
+        iree_task_make_call_closure(iree_task_benchmark_call_nop, NULL), &task);
+    iree_task_benchmark_submit_and_wait_on(&benchmark, &task.header,
+                                           &task.header);
+  }
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+// Measures the latency of waking parked workers to run a single call task.
+// Each step first idles long enough for the workers to stop spinning and
+// go to sleep (with the timer paused).
+static iree_status_t iree_task_benchmark_wake_from_idle(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_benchmark_pause_timing(benchmark_state);
+    iree_wait_until(iree_time_now() + 2 * 1000000ll);
+    iree_benchmark_resume_timing(benchmark_state);
+
+    iree_task_call_t task;
+    iree_task_call_initialize(
+        &benchmark.scope,
+        iree_task_make_call_closure(iree_task_benchmark_call_nop, NULL), &task);
+    iree_task_benchmark_submit_and_wait_on(&benchmark, &task.header,
+                                           &task.header);
+  }
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Distribution
+//===----------------------------------------------------------------------===//
+
+// Measures the throughput of distributing workgroups of a dispatch that does
+// no work across all workers.
+static iree_status_t iree_task_benchmark_empty_dispatch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {
+      (uint32_t)iree_task_executor_worker_count(benchmark.executor) *
+          IREE_TASK_BENCHMARK_TILES_PER_WORKER,
+      1, 1};
+  int64_t step_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &benchmark.scope,
+        iree_task_make_dispatch_closure(iree_task_benchmark_tile_nop, NULL),
+        workgroup_size, workgroup_count, &task);
+    iree_task_benchmark_submit_and_wait_on(&benchmark, &task.header,
+                                           &task.header);
+    ++step_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state,
+                                     step_count * workgroup_count[0]);
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+// Measures a fan-out from a barrier to a batch of call tasks that all fan back
+// in to a single join task, as is produced for command buffer barriers.
+static iree_status_t iree_task_benchmark_fanout_fanin(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  iree_task_call_t tasks[IREE_TASK_BENCHMARK_BATCH_SIZE];
+  iree_task_t* task_ptrs[IREE_TASK_BENCHMARK_BATCH_SIZE];
+  int64_t step_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_nop_t join_task;
+    iree_task_nop_initialize(&benchmark.scope, &join_task);
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+      iree_task_call_initialize(
+          &benchmark.scope,
+          iree_task_make_call_closure(iree_task_benchmark_call_nop, NULL),
+          &tasks[i]);
+      iree_task_set_completion_task(&tasks[i].header, &join_task.header);
+      task_ptrs[i] = &tasks[i].header;
+    }
+    iree_task_barrier_t fanout_task;
+    iree_task_barrier_initialize(&benchmark.scope, IREE_ARRAYSIZE(task_ptrs),
+                                 task_ptrs, &fanout_task);
+    iree_task_benchmark_submit_and_wait_on(&benchmark, &fanout_task.header,
+                                           &join_task.header);
+    ++step_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state,
+                                     step_count * IREE_ARRAYSIZE(tasks));
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+// Measures work stealing by posting a batch of small call tasks to worker 0
+// only. Any speedup over a single worker comes from the other workers stealing
+// tasks out of worker 0's queue.
+static iree_status_t iree_task_benchmark_steal(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  iree_task_call_t tasks[IREE_TASK_BENCHMARK_BATCH_SIZE];
+  int64_t step_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_fence_t* fence = iree_task_benchmark_acquire_fence(&benchmark);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+      iree_task_call_initialize(
+          &benchmark.scope,
+          iree_task_make_call_closure(iree_task_benchmark_call_spin, NULL),
+          &tasks[i]);
+      tasks[i].header.affinity_set = iree_task_affinity_for_worker(0);
+      iree_task_set_completion_task(&tasks[i].header, &fence->header);
+      iree_task_submission_enqueue(&submission, &tasks[i].header);
+    }
+    iree_task_benchmark_submit_and_wait(&benchmark, &submission);
+    ++step_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state,
+                                     step_count * IREE_ARRAYSIZE(tasks));
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Synchronization
+//===----------------------------------------------------------------------===//
+
+// Measures a fence round-trip: a fence task signaling a system event that the
+// caller blocks on, as is done for queue submissions waited on by the host.
+static iree_status_t iree_task_benchmark_fence_roundtrip(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_benchmark_t benchmark;
+  iree_task_benchmark_initialize(benchmark_def, benchmark_state, &benchmark);
+
+  iree_event_t event;
+  IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &event));
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_event_reset(&event);
+    iree_task_call_t call_task;
+    iree_task_call_initialize(
+        &benchmark.scope,
+        iree_task_make_call_closure(iree_task_benchmark_call_nop, NULL),
+        &call_task);
+    iree_task_fence_t fence_task;
+    iree_task_fence_initialize(
+        &benchmark.scope, iree_make_wait_primitive(event.type, event.value),
+        &fence_task);
+    iree_task_set_completion_task(&call_task.header, &fence_task.header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call_task.header);
+    iree_task_executor_submit(benchmark.executor, &submission);
+    iree_task_executor_flush(benchmark.executor);
+    IREE_CHECK_OK(iree_wait_one(&event, IREE_TIME_INFINITE_FUTURE));
+
+    // The event is set before the fence retires and the task storage must
+    // outlive its retirement.
+    IREE_CHECK_OK(
+        iree_task_scope_wait_idle(&benchmark.scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  iree_event_deinitialize(&event);
+
+  iree_task_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Registration
+//===----------------------------------------------------------------------===//
+
+static void iree_task_benchmark_register(
+    const char* name,
+    iree_status_t (*run)(const iree_benchmark_def_t* benchmark_def,
+                         iree_benchmark_state_t* benchmark_state)) {
+  static const uintptr_t worker_counts[] = {1, 2, 4, 8};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(worker_counts); ++i) {
+    const iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = run,
+        .user_data = (void*)worker_counts[i],
+    };
+    char full_name[64];
+    snprintf(full_name, sizeof(full_name), "%s/workers:%u", name,
+             (unsigned)worker_counts[i]);
+    iree_benchmark_register(iree_make_cstring_view(full_name), &benchmark_def);
+  }
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  iree_task_benchmark_register("submit_nop_batch",
+                               iree_task_benchmark_submit_nop_batch);
+  iree_task_benchmark_register("call_roundtrip",
+                               iree_task_benchmark_call_roundtrip);
+  iree_task_benchmark_register("wake_from_idle",
+                               iree_task_benchmark_wake_from_idle);
+  iree_task_benchmark_register("empty_dispatch",
+                               iree_task_benchmark_empty_dispatch);
+  iree_task_benchmark_register("fanout_fanin",
+                               iree_task_benchmark_fanout_fanin);
+  iree_task_benchmark_register("steal", iree_task_benchmark_steal);
+  iree_task_benchmark_register("fence_roundtrip",
+                               iree_task_benchmark_fence_roundtrip);
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -26,51 +26,32 @@
 extern "C" {
 #endif  // __cplusplus
 
+// NOTE: fields are grouped by which threads write them and how often. Fields
+// that are read on every post or coordination but rarely written come first
+// and each group of frequently-written fields starts on its own cache line so
+// that, for example, workers toggling their idle bits don't invalidate the
+// line holding the worker list every other worker reads. See the 'LAYOUT'
+// comments below.
 struct iree_task_executor_t {
+  //===--------------------------------------------------------------------===//
+  // Read-mostly configuration
+  //===--------------------------------------------------------------------===//
+
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
 
-  // Defines how work is selected across queues.
-  // TODO(benvanik): make mutable; currently always the same reserved value.
+  // Defines how work is selected across queues and how workers idle.
+  // TODO(benvanik): make mutable.
   iree_task_scheduling_mode_t scheduling_mode;
 
   // Time each worker should spin before parking itself to wait for more work.
-  // IREE_DURATION_ZERO is used to disable spinning.
+  // IREE_DURATION_ZERO is used to disable spinning. When adaptive spinning is
+  // enabled this is the maximum duration any worker will spin for.
   iree_duration_t worker_spin_ns;
 
-  // State used by the work-stealing operations performed by donated threads.
-  // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
-  // much care about the precise selection of workers enough to mind any tears
-  // we get in the PRNG state that lives inside. Cache write-back order and
-  // incidental cache line availability/visibility update frequency is like an
-  // extra layer of PRNG anyway ;)
-  iree_prng_minilcg128_state_t donation_theft_prng;
-
-  // Pools of transient dispatch tasks shared across all workers.
-  // Depending on configuration the task pool may allocate after creation using
-  // the allocator provided upon executor creation.
-  //
-  // Sized to be able to fit at least:
-  //   iree_task_fence_t
-  //   iree_task_dispatch_shard_t
-  // Increasing the size larger than these will waste memory.
-  iree_task_pool_t transient_task_pool;
-
-  // A list of incoming tasks that are ready to execute immediately.
-  // The list is LIFO and we require that task lists are reversed by the
-  // submitter so we can use iree_atomic_slist_concat to quickly prepend the
-  // LIFO list to the atomic slist. By doing this we can construct the task
-  // lists in LIFO order prior to submission, concat with a pointer swap into
-  // this list, flush from the list in LIFO order during coordination, and do a
-  // single LIFO->FIFO conversion while distributing work. What could have been
-  // half a dozen task list pointer walks and inverted sequential memory access
-  // becomes one.
-  //
-  // Example:
-  //   existing tasks: C B A
-  //        new tasks: 1 2 3
-  //    updated tasks: 3 2 1 C B A
-  iree_atomic_task_slist_t incoming_ready_slist;
+  // Maximum estimated duration of dispatches executed inline on the thread
+  // readying them. See iree_task_executor_options_t::inline_dispatch_max_ns.
+  iree_duration_t inline_dispatch_max_ns;
 
   // iree_event_t pool used to acquire system wait handles.
   // Many subsystems interacting with the executor will need events to park
@@ -79,17 +60,6 @@ struct iree_task_executor_t {
   // them.
   iree_event_pool_t* event_pool;
 
-  // Guards coordination logic; only one thread at a time may be acting as the
-  // coordinator.
-  iree_slim_mutex_t coordinator_mutex;
-
-  // Wait task polling and wait thread manager.
-  // This handles all system waits so that we can keep the syscalls off the
-  // worker threads and lower wake latencies (the wait thread can enqueue
-  // completed waits immediately after they resolve instead of waiting for
-  // existing computation on the workers to finish).
-  iree_task_poller_t poller;
-
   // A bitset indicating which workers are likely to be live and usable; all
   // attempts to push work onto a particular worker should check first with this
   // mask. This may change over time either automatically or by user request
@@ -99,18 +69,10 @@ struct iree_task_executor_t {
   // be OK with getting slightly out-of-date information. The only way to get
   // an authoritative answer to the question "is this worker live" is to
   // atomically query worker->state. This mask is for usage patterns where one
-  // needs a cheap (single relaxed atomic op) approximation of all N workers'
-  // live state without having to perform N expensive atomic ops.
-  iree_atomic_task_affinity_set_t worker_live_mask;
-
-  // A bitset indicating which workers are currently idle. Used to bias incoming
-  // tasks to workers that aren't doing much else. This is a balance of latency
-  // to wake the idle workers vs. latency to wait for existing work to complete
-  // on already woken workers.
-  //
-  // This mask is just a hint, accessed with memory_order_relaxed. See the
-  // comment on worker_live_mask.
-  iree_atomic_task_affinity_set_t worker_idle_mask;
+  // needs a cheap (one relaxed atomic op per 64 workers) approximation of all
+  // N workers' live state without having to perform N expensive atomic ops.
+  // LAYOUT: read on every post and only written when workers start or exit.
+  iree_atomic_task_worker_set_t worker_live_mask;
 
   // Base value added to each executor-local worker index.
   // This allows workers to uniquely identify themselves in multi-executor
@@ -122,7 +84,99 @@ struct iree_task_executor_t {
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // NUMA node the workers are pinned to, if any.
+  iree_task_topology_node_id_t node_id;
+
+  // Page-aligned storage for all worker local memory blocks. Allocated
+  // separately from the executor so that pages are first-touched by the
+  // workers that own them instead of the thread creating the executor.
+  uint8_t* worker_local_memory;  // [worker_count * worker_local_memory_size]
+
+  //===--------------------------------------------------------------------===//
+  // Frequently written by workers and submitters
+  //===--------------------------------------------------------------------===//
+
+  // A bitset indicating which workers are currently idle. Used to bias incoming
+  // tasks to workers that aren't doing much else. This is a balance of latency
+  // to wake the idle workers vs. latency to wait for existing work to complete
+  // on already woken workers.
+  //
+  // This mask is just a hint, accessed with memory_order_relaxed. See the
+  // comment on worker_live_mask. Workers only ever touch the word containing
+  // their own bit when transitioning between idle and active.
+  // LAYOUT: on its own cache line as workers write it each time they go idle.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_atomic_task_worker_set_t worker_idle_mask;
+
+  // A list of incoming tasks that are ready to execute immediately.
+  // The list is LIFO and we require that task lists are reversed by the
+  // submitter so we can use iree_atomic_slist_concat to quickly prepend the
+  // LIFO list to the atomic slist. By doing this we can construct the task
+  // lists in LIFO order prior to submission, concat with a pointer swap into
+  // this list, flush from the list in LIFO order during coordination, and do a
+  // single LIFO->FIFO conversion while distributing work. What could have been
+  // half a dozen task list pointer walks and inverted sequential memory access
+  // becomes one.
+  //
+  // Example:
+  //   existing tasks: C B A
+  //        new tasks: 1 2 3
+  //    updated tasks: 3 2 1 C B A
+  // LAYOUT: on its own cache line as any thread may submit at any time.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_atomic_task_slist_t incoming_ready_slist;
+
+  // Guards coordination logic; only one thread at a time may be acting as the
+  // coordinator.
+  // LAYOUT: on its own cache line as workers contend for it when they run out
+  //         of work, independently of submitters pushing incoming tasks.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_slim_mutex_t coordinator_mutex;
+
+  // State used by the work-stealing operations performed by donated threads.
+  // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
+  // much care about the precise selection of workers enough to mind any tears
+  // we get in the PRNG state that lives inside. Cache write-back order and
+  // incidental cache line availability/visibility update frequency is like an
+  // extra layer of PRNG anyway ;)
+  // LAYOUT: on its own cache line as donors write it without synchronization.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_prng_minilcg128_state_t donation_theft_prng;
+
+  // Pools of transient dispatch tasks shared across all workers.
+  // Depending on configuration the task pool may allocate after creation using
+  // the allocator provided upon executor creation.
+  //
+  // Sized to be able to fit at least:
+  //   iree_task_fence_t
+  //   iree_task_dispatch_shard_t
+  // Increasing the size larger than these will waste memory.
+  // LAYOUT: on its own cache lines as every issued dispatch acquires shards.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_task_pool_t transient_task_pool;
+
+  // Wait task polling and wait thread manager.
+  // This handles all system waits so that we can keep the syscalls off the
+  // worker threads and lower wake latencies (the wait thread can enqueue
+  // completed waits immediately after they resolve instead of waiting for
+  // existing computation on the workers to finish).
+  // LAYOUT: on its own cache lines as the wait thread updates it
+  //         independently of the workers.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_task_poller_t poller;
 };
+static_assert(offsetof(iree_task_executor_t, worker_idle_mask) %
+                          iree_hardware_destructive_interference_size ==
+                      0 &&
+                  offsetof(iree_task_executor_t, incoming_ready_slist) %
+                          iree_hardware_destructive_interference_size ==
+                      0 &&
+                  offsetof(iree_task_executor_t, coordinator_mutex) %
+                          iree_hardware_destructive_interference_size ==
+                      0,
+              "frequently written executor fields must start on their own "
+              "cache lines");
 
 // Merges a submission into the primary FIFO queues.
 // Coordinators will fetch items from here as workers demand them but otherwise
@@ -138,6 +192,15 @@ void iree_task_executor_schedule_ready_tasks(
     iree_task_executor_t* executor, iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch);
 
+// Executes |task| on the calling thread if it is a dispatch that allows
+// inline execution and is estimated to be cheaper than distributing it to
+// workers. |current_worker| is the worker the caller is running on or NULL if
+// called from a non-worker thread. Returns true if the task was executed and
+// retired, in which case tasks it readied are added to |pending_submission|.
+bool iree_task_executor_try_execute_inline(
+    iree_task_executor_t* executor, iree_task_worker_t* current_worker,
+    iree_task_t* task, iree_task_submission_t* pending_submission);
+
 // Dispatches tasks in the global submission queue to workers.
 // |current_worker| will be NULL if called from a non-worker thread and
 // otherwise be the current worker; used to avoid round-tripping through the
@@ -151,13 +214,16 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker);
 
 // Tries to steal an entire task from a sibling worker (based on topology).
-// Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// Returns a task that is available (has not yet begun processing at all or is
+// a dispatch shard that yielded and can be resumed anywhere).
+// May steal multiple tasks and add them to the |local_task_queues| of the same
+// priority.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
+    const iree_task_worker_set_t
+        sharing_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT],
     uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_queue_t local_task_queues[IREE_TASK_PRIORITY_COUNT]);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -6,8 +6,10 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
 #include <cstddef>
 
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -133,4 +135,400 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Tests serialized submission with adaptive worker spinning enabled. The
+// back-to-back submissions should train workers to spin and the executor must
+// continue to make progress regardless of whether they spin or park.
+TEST(ExecutorTest, AdaptiveSpinSubmission) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.scheduling_mode |= IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  static std::atomic<int> call_count = {0};
+  for (int i = 0; i < 500; ++i) {
+    iree_task_call_t call;
+    iree_task_call_initialize(
+        &scope,
+        iree_task_make_call_closure(
+            [](void* user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              ++call_count;
+              return iree_ok_status();
+            },
+            NULL),
+        &call);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&call.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  EXPECT_EQ(500, call_count);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that executors with more workers than fit in a single word of the
+// worker sets can distribute work across all of them.
+TEST(ExecutorTest, MultiWordWorkerSets) {
+  static_assert(IREE_TASK_EXECUTOR_MAX_WORKER_COUNT > 64,
+                "test requires multi-word worker sets");
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 4 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/96,
+                                                 &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  EXPECT_EQ(96, iree_task_executor_worker_count(executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  static std::atomic<int> tile_count = {0};
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {1024, 4, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            ++tile_count;
+            return iree_ok_status();
+          },
+          NULL),
+      workgroup_size, workgroup_count, &dispatch);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(1024 * 4, tile_count);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatch shards yield to higher-priority work posted while they
+// are executing. With a single worker the high-priority call can only run
+// before the dispatch completes if the shard yields at a chunk boundary.
+TEST(ExecutorTest, PriorityPreemption) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t low_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("low"), &low_scope);
+  iree_task_scope_set_priority(&low_scope, IREE_TASK_PRIORITY_LOW);
+  iree_task_scope_t high_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("high"), &high_scope);
+  iree_task_scope_set_priority(&high_scope, IREE_TASK_PRIORITY_HIGH);
+
+  static std::atomic<int> tile_count = {0};
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {256, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &low_scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            ++tile_count;
+            iree_wait_until(iree_time_now() + 200000);
+            return iree_ok_status();
+          },
+          NULL),
+      workgroup_size, workgroup_count, &dispatch);
+  // Expensive tiles are reserved in small chunks so there are many chances to
+  // yield.
+  dispatch.tile_cost_ns = UINT32_MAX;
+
+  iree_task_fence_t* low_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &low_scope, &low_fence));
+  iree_task_set_completion_task(&dispatch.header, &low_fence->header);
+  iree_task_submission_t low_submission;
+  iree_task_submission_initialize(&low_submission);
+  iree_task_submission_enqueue(&low_submission, &dispatch.header);
+  iree_task_executor_submit(executor, &low_submission);
+  iree_task_executor_flush(executor);
+
+  // Wait until the dispatch is running on the worker.
+  while (tile_count == 0) {
+    iree_wait_until(iree_time_now() + 100000);
+  }
+
+  static std::atomic<int> tiles_before_call = {-1};
+  iree_task_call_t call;
+  iree_task_call_initialize(
+      &high_scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            tiles_before_call = tile_count.load();
+            return iree_ok_status();
+          },
+          NULL),
+      &call);
+  iree_task_fence_t* high_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &high_scope, &high_fence));
+  iree_task_set_completion_task(&call.header, &high_fence->header);
+  iree_task_submission_t high_submission;
+  iree_task_submission_initialize(&high_submission);
+  iree_task_submission_enqueue(&high_submission, &call.header);
+  iree_task_executor_submit(executor, &high_submission);
+  iree_task_executor_flush(executor);
+
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&high_scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&low_scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(256, tile_count);
+  EXPECT_GT(tiles_before_call, 0);
+  EXPECT_LT(tiles_before_call, 256);
+
+  iree_task_scope_deinitialize(&high_scope);
+  iree_task_scope_deinitialize(&low_scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that work in a scope is dropped once the scope deadline elapses.
+// The call expires the scope so that the dispatch it readies is never issued.
+TEST(ExecutorTest, ExpiredScopeDropsWork) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  iree_task_call_t call;
+  iree_task_call_initialize(
+      &scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            iree_task_scope_set_deadline(task->scope, iree_time_now());
+            return iree_ok_status();
+          },
+          NULL),
+      &call);
+
+  static std::atomic<int> tile_count = {0};
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            ++tile_count;
+            return iree_ok_status();
+          },
+          NULL),
+      workgroup_size, workgroup_count, &dispatch);
+  iree_task_set_completion_task(&call.header, &dispatch.header);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &call.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(0, tile_count);
+  iree_status_t status = iree_task_scope_consume_status(&scope);
+  EXPECT_TRUE(iree_status_is_deadline_exceeded(status));
+  iree_status_ignore(status);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+#if IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
+// Tests that ready dispatches with no more tiles than there are workers are
+// issued directly to workers on submit. No flush is performed so the dispatch
+// can only complete if it bypassed the coordinator.
+TEST(ExecutorTest, DirectDispatch) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  static std::atomic<int> tile_count = {0};
+  for (int i = 0; i < 100; ++i) {
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {2, 2, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              ++tile_count;
+              return iree_ok_status();
+            },
+            NULL),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  EXPECT_EQ(100 * 4, tile_count);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that direct dispatches issued while no workers are idle are posted to
+// busy workers and run once they free up. Dispatches with more tiles than
+// workers still take the coordinator path and run after the flush.
+TEST(ExecutorTest, DirectDispatchNoIdleWorkers) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  // Occupy every worker with a tile that blocks until released.
+  static std::atomic<int> blocked_count = {0};
+  static std::atomic<bool> release_blocked = {false};
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t blocking_workgroup_count[3] = {4, 1, 1};
+  iree_task_dispatch_t blocking_dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            ++blocked_count;
+            while (!release_blocked) {
+              iree_wait_until(iree_time_now() + 100000);
+            }
+            return iree_ok_status();
+          },
+          NULL),
+      workgroup_size, blocking_workgroup_count, &blocking_dispatch);
+  iree_task_fence_t* blocking_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &scope, &blocking_fence));
+  iree_task_set_completion_task(&blocking_dispatch.header,
+                                &blocking_fence->header);
+  iree_task_submission_t blocking_submission;
+  iree_task_submission_initialize(&blocking_submission);
+  iree_task_submission_enqueue(&blocking_submission, &blocking_dispatch.header);
+  iree_task_executor_submit(executor, &blocking_submission);
+  while (blocked_count < 4) {
+    iree_wait_until(iree_time_now() + 100000);
+  }
+
+  static std::atomic<int> tile_count = {0};
+  iree_task_dispatch_closure_t closure = iree_task_make_dispatch_closure(
+      [](void* user_context, const iree_task_tile_context_t* tile_context,
+         iree_task_submission_t* pending_submission) {
+        tile_count += (int)(uintptr_t)user_context;
+        return iree_ok_status();
+      },
+      NULL);
+
+  // Small enough to be issued directly to the busy workers.
+  const uint32_t direct_workgroup_count[3] = {3, 1, 1};
+  iree_task_dispatch_t direct_dispatch;
+  closure.user_context = (void*)(uintptr_t)1;
+  iree_task_dispatch_initialize(&scope, closure, workgroup_size,
+                                direct_workgroup_count, &direct_dispatch);
+  // Too large to be issued directly and routed through the coordinator.
+  const uint32_t coordinated_workgroup_count[3] = {16, 1, 1};
+  iree_task_dispatch_t coordinated_dispatch;
+  closure.user_context = (void*)(uintptr_t)1000;
+  iree_task_dispatch_initialize(&scope, closure, workgroup_size,
+                                coordinated_workgroup_count,
+                                &coordinated_dispatch);
+
+  iree_task_fence_t* direct_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &scope, &direct_fence));
+  iree_task_set_completion_task(&direct_dispatch.header,
+                                &direct_fence->header);
+  iree_task_fence_t* coordinated_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &scope, &coordinated_fence));
+  iree_task_set_completion_task(&coordinated_dispatch.header,
+                                &coordinated_fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &direct_dispatch.header);
+  iree_task_submission_enqueue(&submission, &coordinated_dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  EXPECT_EQ(0, tile_count);
+
+  release_blocked = true;
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(3 + 16 * 1000, tile_count);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+#endif  // IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
 }  // namespace
@@ -42,12 +42,11 @@ iree_status_t iree_task_poller_initialize(
       &out_poller->wake_event);
 
   // Wait set used to batch syscalls for polling/waiting on wait handles.
-  // This is currently limited to a relatively small max to make bad behavior
-  // clearer with nice RESOURCE_EXHAUSTED errors. If we start to hit that limit
-  // (~63+ simultaneous system waits) we'll need to shard out the wait sets -
-  // possibly with multiple wait threads (one per set).
+  // This starts small and grows as more simultaneous system waits are needed.
   if (iree_status_is_ok(status)) {
-    status = iree_wait_set_allocate(IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS,
+    out_poller->wait_set_capacity =
+        IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS;
+    status = iree_wait_set_allocate(out_poller->wait_set_capacity,
                                     executor->allocator, &out_poller->wait_set);
   }
   if (iree_status_is_ok(status)) {
@@ -170,9 +169,55 @@ void iree_task_poller_enqueue(iree_task_poller_t* poller,
   IREE_TRACE_ZONE_END(z0);
 }
 
-// Acquires a wait handle for |task| and inserts it into |wait_set|.
+// Reallocates the wait set of |poller| with a larger capacity and inserts the
+// wake event and the wait handles of all exported wait tasks into it.
+static iree_status_t iree_task_poller_grow_wait_set(
+    iree_task_poller_t* poller) {
+  if (poller->wait_set_capacity >= IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "maximum of %d outstanding waits reached",
+                            IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Grow geometrically to amortize the reinsertion of all handles.
+  iree_host_size_t new_capacity =
+      iree_min(poller->wait_set_capacity * 2 + 1,
+               (iree_host_size_t)IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)new_capacity);
+  iree_wait_set_t* new_wait_set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_wait_set_allocate(new_capacity, poller->executor->allocator,
+                                 &new_wait_set));
+
+  iree_status_t status = iree_wait_set_insert(new_wait_set, poller->wake_event);
+  for (iree_task_t* task = iree_task_list_front(&poller->wait_list);
+       task != NULL && iree_status_is_ok(status); task = task->next_task) {
+    if (!iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_EXPORTED)) {
+      continue;
+    }
+    iree_wait_handle_t* wait_handle =
+        iree_wait_handle_from_source(&((iree_task_wait_t*)task)->wait_source);
+    if (wait_handle) {
+      status = iree_wait_set_insert(new_wait_set, *wait_handle);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_wait_set_free(poller->wait_set);
+    poller->wait_set = new_wait_set;
+    poller->wait_set_capacity = new_capacity;
+  } else {
+    iree_wait_set_free(new_wait_set);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Acquires a wait handle for |task| and inserts it into the |poller| wait set.
+// The task must already be marked as IREE_TASK_FLAG_WAIT_EXPORTED.
 static iree_status_t iree_task_poller_insert_wait_handle(
-    iree_wait_set_t* wait_set, iree_task_wait_t* task) {
+    iree_task_poller_t* poller, iree_task_wait_t* task) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_status_t status = iree_ok_status();
@@ -199,7 +244,12 @@ static iree_status_t iree_task_poller_insert_wait_handle(
   }
 
   if (iree_status_is_ok(status)) {
-    status = iree_wait_set_insert(wait_set, wait_handle);
+    status = iree_wait_set_insert(poller->wait_set, wait_handle);
+    if (iree_status_is_resource_exhausted(status)) {
+      // Growing the wait set reinserts all exported tasks including this one.
+      iree_status_ignore(status);
+      status = iree_task_poller_grow_wait_set(poller);
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -293,7 +343,7 @@ static iree_task_poller_prepare_result_t iree_task_poller_prepare_task(
       if (!iree_all_bits_set(task->header.flags,
                              IREE_TASK_FLAG_WAIT_EXPORTED)) {
         task->header.flags |= IREE_TASK_FLAG_WAIT_EXPORTED;
-        status = iree_task_poller_insert_wait_handle(poller->wait_set, task);
+        status = iree_task_poller_insert_wait_handle(poller, task);
       }
       *earliest_deadline_ns =
           iree_min(*earliest_deadline_ns, task->deadline_ns);
@@ -102,6 +102,10 @@ typedef struct {
   // This may only contain a subset of the wait_list in cases where some of
   // the wait tasks do not have full system handles.
   iree_wait_set_t* wait_set;
+
+  // Capacity of |wait_set|. The wait set is reallocated with a larger capacity
+  // when full up to IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS.
+  iree_host_size_t wait_set_capacity;
 } iree_task_poller_t;
 
 // Initializes |out_poller| with a new poller.
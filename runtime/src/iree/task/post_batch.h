@@ -37,9 +37,10 @@ typedef struct iree_task_post_batch_t {
 
   // A bitmask of workers indicating which have pending tasks in their lists.
   // Used to quickly scan the lists and perform the posts only when required.
-  iree_task_affinity_set_t worker_pending_mask;
+  iree_task_worker_set_t worker_pending_mask;
 
-  // A per-worker LIFO task list waiting to be posted.
+  // A per-worker per-priority LIFO task list waiting to be posted.
+  // Indexed by worker_index * IREE_TASK_PRIORITY_COUNT + priority.
   iree_task_list_t worker_pending_lifos[0];
 } iree_task_post_batch_t;
 
@@ -57,7 +58,8 @@ iree_host_size_t iree_task_post_batch_select_worker(
 
 // Enqueues a task to the given worker. Note that the pending work lists for
 // each work is kept in LIFO order so that we can easily concatenate it with the
-// worker mailbox slist that's in LIFO order.
+// worker mailbox slist that's in LIFO order. Tasks are routed to the mailbox
+// matching the priority of their scope.
 void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
                                   iree_host_size_t worker_index,
                                   iree_task_t* task);
@@ -29,6 +29,10 @@ void iree_task_scope_initialize(iree_string_view_t name,
 
   iree_notification_initialize(&out_scope->idle_notification);
 
+  out_scope->priority = IREE_TASK_PRIORITY_NORMAL;
+  iree_atomic_store_int64(&out_scope->deadline_ns, IREE_TIME_INFINITE_FUTURE,
+                          iree_memory_order_relaxed);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -63,6 +67,12 @@ iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope) {
   return iree_make_cstring_view(scope->name);
 }
 
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority) {
+  IREE_ASSERT_LT(priority, IREE_TASK_PRIORITY_COUNT);
+  scope->priority = priority;
+}
+
 iree_task_dispatch_statistics_t iree_task_scope_consume_statistics(
     iree_task_scope_t* scope) {
   iree_task_dispatch_statistics_t result = scope->dispatch_statistics;
@@ -114,6 +124,28 @@ static void iree_task_scope_try_set_status(iree_task_scope_t* scope,
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_task_scope_set_deadline(iree_task_scope_t* scope,
+                                  iree_time_t deadline_ns) {
+  iree_atomic_store_int64(&scope->deadline_ns, deadline_ns,
+                          iree_memory_order_relaxed);
+}
+
+bool iree_task_scope_has_expired(iree_task_scope_t* scope) {
+  // relaxed order because the deadline is only a hint; tasks racing with the
+  // deadline being set may run or be dropped.
+  const iree_time_t deadline_ns =
+      iree_atomic_load_int64(&scope->deadline_ns, iree_memory_order_relaxed);
+  if (IREE_LIKELY(deadline_ns == IREE_TIME_INFINITE_FUTURE)) return false;
+  if (iree_time_now() < deadline_ns) return false;
+  if (!iree_task_scope_has_failed(scope)) {
+    iree_task_scope_try_set_status(
+        scope, iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                                "scope deadline elapsed before all tasks were "
+                                "issued"));
+  }
+  return true;
+}
+
 void iree_task_scope_abort(iree_task_scope_t* scope) {
   iree_status_t status =
       iree_make_status(IREE_STATUS_ABORTED, "entire scope aborted by user");
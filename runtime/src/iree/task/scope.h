@@ -73,6 +73,14 @@ typedef struct iree_task_scope_t {
   // tasks or completes all pending tasks after a failure.
   iree_notification_t idle_notification;
   iree_atomic_int32_t pending_idle_notification_posts;
+
+  // Scheduling priority of all tasks within the scope.
+  // Must only be changed while the scope is idle.
+  iree_task_priority_t priority;
+
+  // Absolute time in nanoseconds after which pending tasks within the scope are
+  // dropped or IREE_TIME_INFINITE_FUTURE if the scope has no deadline.
+  iree_atomic_int64_t deadline_ns;
 } iree_task_scope_t;
 
 // Initializes a caller-allocated scope.
@@ -89,6 +97,36 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope);
 // string.
 iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope);
 
+// Sets the scheduling priority of all tasks subsequently submitted within the
+// scope. Scopes default to IREE_TASK_PRIORITY_NORMAL.
+// Must only be called while the scope is idle.
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority);
+
+// Returns the scheduling priority of tasks within |scope|. A NULL scope is
+// treated as IREE_TASK_PRIORITY_NORMAL.
+static inline iree_task_priority_t iree_task_scope_priority(
+    const iree_task_scope_t* scope) {
+  return scope ? scope->priority : IREE_TASK_PRIORITY_NORMAL;
+}
+
+// Sets the absolute |deadline_ns| after which tasks within the scope that have
+// not yet been issued are dropped. Executors check the deadline before issuing
+// each task and dispatch shard and the scope fails with
+// IREE_STATUS_DEADLINE_EXCEEDED once it is observed to have elapsed. In-flight
+// tasks are not interrupted. IREE_TIME_INFINITE_FUTURE clears the deadline.
+//
+// May be called from any thread at any time, such as when a client request
+// times out or is cancelled after its work has been submitted.
+void iree_task_scope_set_deadline(iree_task_scope_t* scope,
+                                  iree_time_t deadline_ns);
+
+// Returns true if the deadline of |scope| has elapsed. The first time this is
+// observed the scope enters a permanent IREE_STATUS_DEADLINE_EXCEEDED failure
+// state and all pending tasks will be aborted as with iree_task_scope_fail.
+// Cheap when the scope has no deadline.
+bool iree_task_scope_has_expired(iree_task_scope_t* scope);
+
 // Returns and resets the statistics for the scope.
 // Statistics may experience tearing (non-atomic update across fields) if this
 // is performed while tasks are in-flight.
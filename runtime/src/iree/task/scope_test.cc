@@ -76,6 +76,34 @@ TEST(ScopeTest, FailEmpty) {
   iree_task_scope_deinitialize(&scope);
 }
 
+TEST(ScopeTest, DeadlineExpires) {
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope_a"), &scope);
+
+  // Scopes have no deadline by default.
+  EXPECT_FALSE(iree_task_scope_has_expired(&scope));
+
+  // Deadlines in the future don't change the scope state.
+  iree_task_scope_set_deadline(&scope, iree_time_now() + 60000000000ll);
+  EXPECT_FALSE(iree_task_scope_has_expired(&scope));
+  EXPECT_FALSE(iree_task_scope_has_failed(&scope));
+
+  // Elapsed deadlines fail the scope once observed.
+  iree_task_scope_set_deadline(&scope, iree_time_now());
+  EXPECT_TRUE(iree_task_scope_has_expired(&scope));
+  EXPECT_TRUE(iree_task_scope_has_failed(&scope));
+  iree_status_t consumed_status = iree_task_scope_consume_status(&scope);
+  EXPECT_TRUE(iree_status_is_deadline_exceeded(consumed_status));
+  iree_status_ignore(consumed_status);
+
+  // Ensure expired state is sticky even if the deadline is cleared.
+  iree_task_scope_set_deadline(&scope, IREE_TIME_INFINITE_FUTURE);
+  EXPECT_TRUE(iree_status_is_deadline_exceeded(
+      iree_task_scope_consume_status(&scope)));
+
+  iree_task_scope_deinitialize(&scope);
+}
+
 // NOTE: only the first failure is recorded and made sticky; subsequent failure
 // calls are ignored.
 TEST(ScopeTest, FailAgain) {
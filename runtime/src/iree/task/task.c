@@ -531,6 +531,8 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->local_memory_size = 0;
+  out_task->tile_cost_ns = 0;
+  out_task->shard_tile_min = 0;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
 
@@ -577,8 +579,9 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
     // indirection buffer have been satisfied and its safe to read. We perform
     // the indirection here and convert the dispatch to a direct one such that
     // following code can read the value.
-    // TODO(benvanik): non-one-shot command buffers won't be able to do this as
-    // the intent is that they can be dynamic per execution.
+    // Reusable command buffers restore the indirect flag and pointer from
+    // their recorded template before each issue so that the value is re-read
+    // on every execution.
     const uint32_t* source_ptr = dispatch_task->workgroup_count.ptr;
     memcpy(dispatch_task->workgroup_count.value, source_ptr,
            sizeof(dispatch_task->workgroup_count.value));
@@ -609,17 +612,42 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   iree_host_size_t shard_count =
       iree_min(dispatch_task->tile_count, worker_count);
 
+  // Cheap dispatches may not have enough work to be worth waking all workers.
+  // Limit the shard count such that each shard gets at least the preferred
+  // number of tiles and enough work to amortize waking its worker.
+  uint32_t shard_tile_min = dispatch_task->shard_tile_min;
+  if (dispatch_task->tile_cost_ns > 0) {
+    shard_tile_min =
+        iree_max(shard_tile_min, IREE_TASK_DISPATCH_MIN_SHARD_NS /
+                                     dispatch_task->tile_cost_ns);
+  }
+  if (shard_tile_min > 1) {
+    shard_count = iree_min(
+        shard_count, iree_max(1, dispatch_task->tile_count / shard_tile_min));
+  }
+
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
   // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (dispatch_task->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+  // Reservations start large and shrink toward tile_chunk_min as the grid is
+  // consumed.
+  if (dispatch_task->tile_cost_ns > 0) {
+    // Size the minimum chunk such that it takes around the target duration to
+    // execute so that cheap tiles don't hammer the shared tile_index.
+    dispatch_task->tile_chunk_min = (uint32_t)iree_max(
+        1, iree_min(IREE_TASK_DISPATCH_TARGET_CHUNK_NS /
+                        dispatch_task->tile_cost_ns,
+                    IREE_TASK_DISPATCH_MAX_TILES_PER_CHUNK));
+  } else if (dispatch_task->tile_count <
+             worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
     // Grid is small - allow it to be eagerly sliced up.
-    dispatch_task->tiles_per_reservation = 1;
+    dispatch_task->tile_chunk_min = 1;
   } else {
-    dispatch_task->tiles_per_reservation =
+    dispatch_task->tile_chunk_min =
         IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
   }
+  dispatch_task->tile_chunk_divisor =
+      (uint32_t)iree_max(1, shard_count * IREE_TASK_DISPATCH_GUIDED_CHUNK_FACTOR);
 
   // Randomize starting worker.
   iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
@@ -710,9 +738,109 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
-void iree_task_dispatch_shard_execute(
+// Reserves the next chunk of tiles from |dispatch_task| using guided
+// self-scheduling. Returns the number of tiles reserved starting at
+// |out_tile_base| or 0 if the grid has been exhausted.
+static uint32_t iree_task_dispatch_reserve_tiles(
+    iree_task_dispatch_t* dispatch_task, uint32_t* out_tile_base) {
+  const uint32_t tile_count = dispatch_task->tile_count;
+  // relaxed order because we only care about atomic updates, not about
+  // ordering of tile_index accesses w.r.t. other memory accesses.
+  int32_t tile_base = iree_atomic_load_int32(&dispatch_task->tile_index,
+                                             iree_memory_order_relaxed);
+  uint32_t tile_chunk = 0;
+  do {
+    if ((uint32_t)tile_base >= tile_count) return 0;
+    const uint32_t remaining = tile_count - (uint32_t)tile_base;
+    tile_chunk = iree_max(remaining / dispatch_task->tile_chunk_divisor,
+                          dispatch_task->tile_chunk_min);
+    tile_chunk = iree_min(tile_chunk, remaining);
+  } while (!iree_atomic_compare_exchange_weak_int32(
+      &dispatch_task->tile_index, &tile_base,
+      tile_base + (int32_t)tile_chunk, iree_memory_order_relaxed,
+      iree_memory_order_relaxed));
+  *out_tile_base = (uint32_t)tile_base;
+  return tile_chunk;
+}
+
+// Executes tiles of |dispatch_task| with |tile_context| until the grid has
+// been exhausted or a tile fails. Failures are propagated to the dispatch.
+//
+// If |yield_mask| is provided it is checked after each reserved chunk of tiles
+// and execution stops early if any of |yield_bits| are set. Returns true if
+// execution yielded with tiles potentially remaining in the grid.
+static bool iree_task_dispatch_execute_tiles(
+    iree_task_dispatch_t* dispatch_task, iree_task_tile_context_t* tile_context,
+    iree_atomic_int32_t* yield_mask, int32_t yield_bits,
+    iree_task_submission_t* pending_submission) {
+  const uint32_t workgroup_count_x = tile_context->workgroup_count[0];
+  const uint32_t workgroup_count_y = tile_context->workgroup_count[1];
+  uint32_t tile_base = 0;
+  uint32_t tile_chunk = 0;
+  while ((tile_chunk =
+              iree_task_dispatch_reserve_tiles(dispatch_task, &tile_base))) {
+    const uint32_t tile_range = tile_base + tile_chunk;
+    for (uint32_t tile_index = tile_base; tile_index < tile_range;
+         ++tile_index) {
+      // TODO(benvanik): faster math here, especially knowing we pull off N
+      // sequential indices per reservation.
+      uint32_t tile_i = tile_index;
+      tile_context->workgroup_xyz[0] = tile_i % workgroup_count_x;
+      tile_i /= workgroup_count_x;
+      tile_context->workgroup_xyz[1] = tile_i % workgroup_count_y;
+      tile_i /= workgroup_count_y;
+      tile_context->workgroup_xyz[2] = tile_i;
+
+      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
+                                  "iree_task_dispatch_shard_execute_tile");
+      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(tile_context));
+
+#ifndef NDEBUG
+      // NOTE: these are useful for debugging but dramatically increase our
+      // cost here; only enable if needed for tracking work distribution:
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context->workgroup_xyz[0]);
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context->workgroup_xyz[1]);
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context->workgroup_xyz[2]);
+      // IREE_TRACE_ZONE_APPEND_VALUE(z_tile, (uint64_t)task->closure.fn);
+#endif  // !NDEBUG
+
+      iree_status_t status =
+          dispatch_task->closure.fn(dispatch_task->closure.user_context,
+                                    tile_context, pending_submission);
+
+      IREE_TRACE_ZONE_END(z_tile);
+
+      // If any tile fails we bail early from the loop. This doesn't match
+      // what an accelerator would do but saves some unneeded work.
+      // Note that other shards may have completed execution, be executing
+      // concurrently with this one, or still be pending - this does not
+      // have any influence on them and they may continue to execute even
+      // after we bail from here.
+      if (!iree_status_is_ok(status)) {
+        // Propagate failures to the dispatch task.
+        iree_task_try_set_status(&dispatch_task->status, status);
+        return false;
+      }
+    }
+
+    // Yield at chunk boundaries if higher-priority work has arrived. Any
+    // remaining tiles stay in the grid for other shards or for this one to
+    // pick up once resumed.
+    // relaxed order because this is only a hint; the worker synchronizes with
+    // the posted work when it flushes its mailbox.
+    if (yield_mask &&
+        (iree_atomic_load_int32(yield_mask, iree_memory_order_relaxed) &
+         yield_bits)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* yield_mask,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -735,19 +863,29 @@ void iree_task_dispatch_shard_execute(
                          worker_local_memory.data_length));
     iree_task_retire(&task->header, pending_submission, iree_ok_status());
     IREE_TRACE_ZONE_END(z0);
-    return;
+    return false;
   }
   iree_byte_span_t local_memory = iree_make_byte_span(
       worker_local_memory.data, dispatch_task->local_memory_size);
 
+  // Drop the shard without executing any tiles if the scope failed or expired
+  // after the dispatch was issued. The coordinator discards the dependents of
+  // the dispatch once all shards have retired.
+  iree_task_scope_t* scope = task->header.scope;
+  if (IREE_UNLIKELY(scope && (iree_task_scope_has_failed(scope) ||
+                              iree_task_scope_has_expired(scope)))) {
+    iree_task_retire(&task->header, pending_submission, iree_ok_status());
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "dropped");
+    IREE_TRACE_ZONE_END(z0);
+    return false;
+  }
+
   // Prepare context shared for all tiles in the shard.
   iree_task_tile_context_t tile_context;
   memcpy(&tile_context.workgroup_size, dispatch_task->workgroup_size,
          sizeof(tile_context.workgroup_size));
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
-  uint32_t workgroup_count_x = tile_context.workgroup_count[0];
-  uint32_t workgroup_count_y = tile_context.workgroup_count[1];
   tile_context.worker_id = worker_id;
   tile_context.local_memory = local_memory;
 
@@ -761,75 +899,71 @@ void iree_task_dispatch_shard_execute(
   // Hint as to which processor we are running on.
   tile_context.processor_id = processor_id;
 
-  // Loop over all tiles until they are all processed.
-  const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
-  // relaxed order because we only care about atomic increments, not about
-  // ordering of tile_index accesses w.r.t. other memory accesses.
-  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                                   tiles_per_reservation,
-                                                   iree_memory_order_relaxed);
-  while (tile_base < tile_count) {
-    const uint32_t tile_range =
-        iree_min(tile_base + tiles_per_reservation, tile_count);
-    for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
-      // TODO(benvanik): faster math here, especially knowing we pull off N
-      // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
-      tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
-      tile_i /= workgroup_count_x;
-      tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
-      tile_i /= workgroup_count_y;
-      tile_context.workgroup_xyz[2] = tile_i;
-
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
-                                  "iree_task_dispatch_shard_execute_tile");
-      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
-
-#ifndef NDEBUG
-      // NOTE: these are useful for debugging but dramatically increase our
-      // cost here; only enable if needed for tracking work distribution:
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[0]);
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[1]);
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[2]);
-      // IREE_TRACE_ZONE_APPEND_VALUE(z_tile, (uint64_t)task->closure.fn);
-#endif  // !NDEBUG
-
-      iree_status_t status =
-          dispatch_task->closure.fn(dispatch_task->closure.user_context,
-                                    &tile_context, pending_submission);
-
-      IREE_TRACE_ZONE_END(z_tile);
-
-      // If any tile fails we bail early from the loop. This doesn't match
-      // what an accelerator would do but saves some unneeded work.
-      // Note that other shards may have completed execution, be executing
-      // concurrently with this one, or still be pending - this does not
-      // have any influence on them and they may continue to execute even
-      // after we bail from here.
-      if (!iree_status_is_ok(status)) {
-        // Propagate failures to the dispatch task.
-        iree_task_try_set_status(&dispatch_task->status, status);
-        goto abort_shard;  // out of the while-for nest
-      }
-    }
-
-    // Try to grab the next slice of tiles.
-    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                            tiles_per_reservation,
-                                            iree_memory_order_relaxed);
-  }
-abort_shard:
+  // Loop over all tiles until they are all processed or we have to yield to
+  // work posted at a higher priority than the dispatch.
+  const int32_t yield_bits =
+      ~((1 << (iree_task_scope_priority(task->header.scope) + 1)) - 1);
+  const bool yielded = iree_task_dispatch_execute_tiles(
+      dispatch_task, &tile_context, yield_mask, yield_bits,
+      pending_submission);
 
   // Push aggregate statistics up to the dispatch.
   // Note that we may have partial information here if we errored out of the
-  // loop but that's still useful to know.
+  // loop or yielded but that's still useful to know.
   iree_task_dispatch_statistics_merge(&shard_statistics,
                                       &dispatch_task->statistics);
 
+  // Yielded shards remain outstanding and must be resumed by the caller.
+  if (yielded) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "yielded");
+    IREE_TRACE_ZONE_END(z0);
+    return true;
+  }
+
   // NOTE: even if an error was hit we retire OK - the error has already been
   // propagated to the dispatch and it'll clean up after all shards are joined.
   iree_task_retire(&task->header, pending_submission, iree_ok_status());
   IREE_TRACE_ZONE_END(z0);
+  return false;
+}
+
+void iree_task_dispatch_execute_inline(
+    iree_task_dispatch_t* dispatch_task, iree_cpu_processor_id_t processor_id,
+    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_task_submission_t* pending_submission) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, dispatch_task->dispatch_id);
+  IREE_TRACE_ZONE_SET_COLOR(
+      z0, iree_math_ptr_to_xrgb(dispatch_task->closure.user_context));
+
+  // Mark the dispatch as issued as if it had been fanned out to shards.
+  dispatch_task->header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+
+  // The calling thread reserves the entire grid at once.
+  const uint32_t* workgroup_count = dispatch_task->workgroup_count.value;
+  iree_atomic_store_int32(&dispatch_task->tile_index, 0,
+                          iree_memory_order_relaxed);
+  dispatch_task->tile_count =
+      workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
+  dispatch_task->tile_chunk_min = dispatch_task->tile_count;
+  dispatch_task->tile_chunk_divisor = 1;
+
+  iree_task_tile_context_t tile_context;
+  memcpy(&tile_context.workgroup_size, dispatch_task->workgroup_size,
+         sizeof(tile_context.workgroup_size));
+  memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
+         sizeof(tile_context.workgroup_count));
+  tile_context.worker_id = worker_id;
+  tile_context.local_memory = iree_make_byte_span(
+      worker_local_memory.data, dispatch_task->local_memory_size);
+  tile_context.statistics = &dispatch_task->statistics;
+  tile_context.processor_id = processor_id;
+  iree_task_dispatch_execute_tiles(dispatch_task, &tile_context,
+                                   /*yield_mask=*/NULL, /*yield_bits=*/0,
+                                   pending_submission);
+
+  // Retire immediately as there are no shards to wait for. Any tasks this
+  // readies are added to |pending_submission|.
+  iree_task_dispatch_retire(dispatch_task, pending_submission);
+  IREE_TRACE_ZONE_END(z0);
 }
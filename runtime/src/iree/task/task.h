@@ -75,6 +75,19 @@ enum iree_task_type_bits_t {
 };
 typedef uint8_t iree_task_type_t;
 
+// Scheduling priority of a task as inherited from its scope.
+// Workers always drain higher-priority work first and dispatch shards yield at
+// tile chunk boundaries when higher-priority work is posted to their worker so
+// that latency-sensitive producers are not stuck behind long-running bulk
+// dispatches. Priorities are only a scheduling hint and never reorder tasks
+// with respect to their dependencies.
+typedef enum iree_task_priority_e {
+  IREE_TASK_PRIORITY_LOW = 0,
+  IREE_TASK_PRIORITY_NORMAL = 1,
+  IREE_TASK_PRIORITY_HIGH = 2,
+  IREE_TASK_PRIORITY_COUNT,
+} iree_task_priority_t;
+
 enum iree_task_flag_bits_t {
   IREE_TASK_FLAG_NONE = 0u,
 
@@ -117,6 +130,14 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // The dispatch may be executed entirely on the thread submitting it when its
+  // estimated cost (tile_count * tile_cost_ns) is less than that of waking
+  // workers to execute it (see IREE_TASK_DISPATCH_INLINE_MAX_NS). Tiles
+  // executed inline are passed a worker_id of 0 and so the flag must only be
+  // set on dispatches that do not rely on per-worker state. Dispatches
+  // requiring local memory or without a cost hint are never executed inline.
+  IREE_TASK_FLAG_DISPATCH_INLINE = 1u << 6,
 };
 typedef uint16_t iree_task_flags_t;
 
@@ -628,34 +649,68 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // dispatch closure.
   uint32_t local_memory_size;
 
-  // Resulting status from the dispatch available once all workgroups have
-  // completed (or would have completed). If multiple shards processing the
-  // workgroups hit an error the first will be taken and the result ignored. A
-  // dispatch with a non-ok status will mark the parent task scope as failing
-  // when it retires.
-  iree_atomic_intptr_t status;
+  // Optional approximate cost in nanoseconds of executing a single tile or 0 if
+  // unknown. Used to select how many tiles each shard reserves at a time: cheap
+  // tiles are reserved in larger chunks to reduce contention on tile_index.
+  uint32_t tile_cost_ns;
 
-  // Statistics storage used for aggregating counters across all shards.
-  iree_task_dispatch_statistics_t statistics;
+  // Optional minimum number of tiles each shard should execute or 0 if unknown.
+  // Dispatches with too few tiles to give every worker this many are split
+  // into fewer shards such that the cost of waking workers is amortized.
+  uint32_t shard_tile_min;
 
   // The total number of tiles in the dispatch bounding tile_index.
   uint32_t tile_count;
 
-  // Maximum number of tiles to fetch per tile reservation from the grid.
-  // Bounded by IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a
-  // reasonable number chosen based on the tile and shard counts.
-  uint32_t tiles_per_reservation;
+  // Guided self-scheduling parameters selected when the dispatch is issued.
+  // Each reservation takes max(remaining / tile_chunk_divisor, tile_chunk_min)
+  // tiles such that early reservations are large (low overhead) and they
+  // decrease in size toward the tail of the grid (better load balance).
+  uint32_t tile_chunk_min;
+  uint32_t tile_chunk_divisor;
+
+  // Incrementing process-lifetime dispatch identifier.
+  IREE_TRACE(int64_t dispatch_id;)
+
+  // LAYOUT: the fields above are written when the dispatch is initialized and
+  // issued and then only read by the shards, while the fields below are
+  // written by all shards concurrently. Dispatch tasks are embedded in
+  // commands allocated from arenas that only guarantee iree_max_align_t so
+  // padding is used instead of alignment to keep tile_index from sharing a
+  // cache line with the read-only fields or with whatever follows the dispatch
+  // in memory.
+  uint8_t shared_head_padding[iree_hardware_destructive_interference_size -
+                              sizeof(iree_atomic_int32_t)];
 
   // The tail tile index; the next reservation will start from here.
   // This is used by shards to slice off the work to perform in their inner
-  // loop. Ideally we'd have no destructive interference with other shared data
-  // in this structure but the shared parts (status/statistics) are updated once
-  // per shard instead of once per slice and are less of a concern.
+  // loop. The shared status/statistics are updated once per shard instead of
+  // once per slice and are less of a concern.
   iree_atomic_int32_t tile_index;
 
-  // Incrementing process-lifetime dispatch identifier.
-  IREE_TRACE(int64_t dispatch_id;)
+  // Resulting status from the dispatch available once all workgroups have
+  // completed (or would have completed). If multiple shards processing the
+  // workgroups hit an error the first will be taken and the result ignored. A
+  // dispatch with a non-ok status will mark the parent task scope as failing
+  // when it retires.
+  iree_atomic_intptr_t status;
+
+  // Statistics storage used for aggregating counters across all shards.
+  iree_task_dispatch_statistics_t statistics;
+
+  uint8_t shared_tail_padding[iree_hardware_destructive_interference_size -
+                              sizeof(iree_atomic_int32_t)];
 } iree_task_dispatch_t;
+static_assert(offsetof(iree_task_dispatch_t, tile_index) -
+                      offsetof(iree_task_dispatch_t, shared_head_padding) >=
+                  iree_hardware_destructive_interference_size -
+                      sizeof(iree_atomic_int32_t),
+              "tile_index must not share a cache line with read-only fields");
+static_assert(sizeof(iree_task_dispatch_t) -
+                      offsetof(iree_task_dispatch_t, tile_index) >=
+                  iree_hardware_destructive_interference_size,
+              "tile_index must not share a cache line with what follows the "
+              "dispatch in memory");
 
 void iree_task_dispatch_initialize(iree_task_scope_t* scope,
                                    iree_task_dispatch_closure_t closure,
@@ -92,6 +92,19 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_submission_t* pending_submission,
                               iree_task_post_batch_t* post_batch);
 
+// Executes all tiles of a ready dispatch on the calling thread and retires it
+// without issuing any shards. Used for dispatches with the
+// IREE_TASK_FLAG_DISPATCH_INLINE flag that are cheaper to execute than to
+// distribute. Tiles are passed |worker_id| and |worker_local_memory| as if
+// executed by a single shard on that worker.
+//
+// The dispatch must not be indirect, must have a non-empty grid, and must not
+// require more local memory than |worker_local_memory| provides.
+void iree_task_dispatch_execute_inline(
+    iree_task_dispatch_t* dispatch_task, iree_cpu_processor_id_t processor_id,
+    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_task_submission_t* pending_submission);
+
 // Retires a dispatch when all issued shards have completed executing.
 //
 // Only called during coordination and expects the coordinator lock to be held.
@@ -118,11 +131,19 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
 //
+// |yield_mask| is an optional bitmask of iree_task_priority_t levels with
+// pending work on the executing thread. If any bit above the priority of the
+// shard is set after a chunk of tiles completes the shard stops early and
+// returns true without retiring; the caller must re-queue the shard so that
+// it resumes once the higher-priority work has been processed. Tiles not yet
+// reserved remain available to the other shards of the dispatch.
+//
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
-void iree_task_dispatch_shard_execute(
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* yield_mask,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
@@ -71,7 +71,9 @@ class TaskDispatchTest : public TaskTest {
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
                              const uint32_t workgroup_count[3],
-                             uint32_t dispatch_flags) {
+                             uint32_t dispatch_flags,
+                             uint32_t tile_cost_ns = 0,
+                             uint32_t shard_tile_min = 0) {
     IREE_TRACE_SCOPE();
     GridCoverage coverage(workgroup_count);
     iree_task_dispatch_t task;
@@ -80,6 +82,8 @@ class TaskDispatchTest : public TaskTest {
         iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
         workgroup_size, workgroup_count, &task);
     task.header.flags |= dispatch_flags;
+    task.tile_cost_ns = tile_cost_ns;
+    task.shard_tile_min = shard_tile_min;
     IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
     EXPECT_TRUE(coverage.Verify());
   }
@@ -113,6 +117,103 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+// Large enough grid that guided scheduling will shrink chunks over several
+// reservations.
+TEST_F(TaskDispatchTest, IssueLarge) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {97, 31, 7};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+TEST_F(TaskDispatchTest, IssueLargeCheapTiles) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {97, 31, 7};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                        /*tile_cost_ns=*/10);
+}
+
+TEST_F(TaskDispatchTest, IssueLargeExpensiveTiles) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {97, 31, 7};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                        /*tile_cost_ns=*/UINT32_MAX);
+}
+
+// Cheap grid that is split into fewer shards than there are workers.
+TEST_F(TaskDispatchTest, IssueShardTileMin) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {97, 31, 7};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                        /*tile_cost_ns=*/10, /*shard_tile_min=*/1000);
+}
+
+// Cheap grid that is executed on the submitting thread.
+TEST_F(TaskDispatchTest, IssueInline) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_INLINE, /*tile_cost_ns=*/1);
+}
+
+// Grid too expensive to be executed inline even though it allows it.
+TEST_F(TaskDispatchTest, IssueInlineExpensiveTiles) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_INLINE,
+                        /*tile_cost_ns=*/UINT32_MAX);
+}
+
+// Cheap grid readied by a call on a worker that is executed inline by the
+// coordinator and readies its own dependent call.
+TEST_F(TaskDispatchTest, IssueInlineChained) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  GridCoverage coverage(kWorkgroupCount);
+
+  auto call = [](void* user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+    IREE_TRACE_SCOPE();
+    ++(*(int*)user_context);
+    return iree_ok_status();
+  };
+  int pre_call_count = 0;
+  iree_task_call_t pre_call_task;
+  iree_task_call_initialize(&scope_,
+                            iree_task_make_call_closure(call, &pre_call_count),
+                            &pre_call_task);
+
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+      kWorkgroupSize, kWorkgroupCount, &dispatch_task);
+  dispatch_task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  dispatch_task.tile_cost_ns = 1;
+  iree_task_set_completion_task(&pre_call_task.header, &dispatch_task.header);
+
+  int post_call_count = 0;
+  iree_task_call_t post_call_task;
+  iree_task_call_initialize(&scope_,
+                            iree_task_make_call_closure(call, &post_call_count),
+                            &post_call_task);
+  iree_task_set_completion_task(&dispatch_task.header, &post_call_task.header);
+
+  IREE_ASSERT_OK(
+      SubmitTasksAndWaitIdle(&pre_call_task.header, &post_call_task.header));
+  EXPECT_EQ(1, pre_call_count);
+  EXPECT_TRUE(coverage.Verify());
+  EXPECT_EQ(1, post_call_count);
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -214,4 +315,47 @@ TEST_F(TaskDispatchTest, IssueFailureChained) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+TEST_F(TaskDispatchTest, IssueInlineFailureChained) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 1, 1};
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    return tile_context->workgroup_xyz[0] == 32
+               ? iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!")
+               : iree_ok_status();
+  };
+
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope_, iree_task_make_dispatch_closure(tile, NULL), kWorkgroupSize,
+      kWorkgroupCount, &dispatch_task);
+  dispatch_task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  dispatch_task.tile_cost_ns = 1;
+
+  int did_call = 0;
+  iree_task_call_t call_task;
+  iree_task_call_initialize(&scope_,
+                            iree_task_make_call_closure(
+                                [](void* user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  IREE_TRACE_SCOPE();
+                                  int* did_call_ptr = (int*)user_context;
+                                  ++(*did_call_ptr);
+                                  return iree_ok_status();
+                                },
+                                &did_call),
+                            &call_task);
+  iree_task_set_completion_task(&dispatch_task.header, &call_task.header);
+
+  IREE_ASSERT_OK(
+      SubmitTasksAndWaitIdle(&dispatch_task.header, &call_task.header));
+  EXPECT_EQ(0, did_call);
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
 }  // namespace
@@ -7,9 +7,11 @@
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -197,6 +199,50 @@ TEST_F(TaskWaitTest, WaitAllTimeout) {
   iree_event_deinitialize(&event_b);
 }
 
+// Issues more concurrent waits than the poller wait set initially holds so
+// that it has to grow while the earlier waits are still outstanding.
+TEST_F(TaskWaitTest, WaitAllGrowsWaitSet) {
+  IREE_TRACE_SCOPE();
+
+  static const iree_host_size_t kWaitCount =
+      IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS * 2 + 2;
+  std::vector<iree_event_t> events(kWaitCount);
+  std::vector<iree_task_wait_t> wait_tasks(kWaitCount);
+  std::vector<iree_task_t*> wait_task_ptrs(kWaitCount);
+
+  iree_task_fence_t fence;
+  iree_task_fence_initialize(&scope_, iree_wait_primitive_immediate(), &fence);
+  for (iree_host_size_t i = 0; i < kWaitCount; ++i) {
+    iree_event_initialize(/*initial_state=*/false, &events[i]);
+    iree_task_wait_initialize(&scope_, iree_event_await(&events[i]),
+                              IREE_TIME_INFINITE_FUTURE, &wait_tasks[i]);
+    iree_task_set_completion_task(&wait_tasks[i].header, &fence.header);
+    wait_task_ptrs[i] = &wait_tasks[i].header;
+  }
+
+  iree_task_barrier_t barrier;
+  iree_task_barrier_initialize(&scope_, kWaitCount, wait_task_ptrs.data(),
+                               &barrier);
+
+  // Signal only after all waits have had a chance to be exported to the wait
+  // set. Signaling in reverse order retires waits inserted after growth first.
+  std::thread signal_thread([&]() {
+    IREE_TRACE_SCOPE();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (iree_host_size_t i = kWaitCount; i > 0; --i) {
+      iree_event_set(&events[i - 1]);
+    }
+  });
+
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&barrier.header, &fence.header));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+
+  signal_thread.join();
+  for (iree_host_size_t i = 0; i < kWaitCount; ++i) {
+    iree_event_deinitialize(&events[i]);
+  }
+}
+
 // Issues multiple waits that join on a single task in wait-any mode.
 // This means that if one wait finishes all other waits will be cancelled and
 // the completion task will continue.
@@ -6,6 +6,7 @@
 
 #include "iree/task/topology.h"
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -14,39 +15,235 @@
 #include "iree/base/tracing.h"
 
 void iree_task_topology_group_initialize(
-    uint8_t group_index, iree_task_topology_group_t* out_group) {
+    uint16_t group_index, iree_task_topology_group_t* out_group) {
   memset(out_group, 0, sizeof(*out_group));
   out_group->group_index = group_index;
   snprintf(out_group->name, IREE_ARRAYSIZE(out_group->name), "iree-worker-%u",
            group_index);
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
-  out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+  iree_task_worker_set_fill(&out_group->constructive_sharing_mask);
+  out_group->llc_id = IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN;
+  out_group->node_id = IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+  out_group->capacity = IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN;
+  out_group->priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
 }
 
 void iree_task_topology_initialize(iree_task_topology_t* out_topology) {
   IREE_ASSERT_ARGUMENT(out_topology);
   memset(out_topology, 0, sizeof(*out_topology));
+  out_topology->node_id = IREE_TASK_TOPOLOGY_NODE_ID_ANY;
 }
 
 void iree_task_topology_deinitialize(iree_task_topology_t* topology) {
   IREE_ASSERT_ARGUMENT(topology);
 }
 
+// Parses an optional uint32 |value| where '-' indicates |unknown_value|.
+static bool iree_task_topology_parse_optional_uint32(iree_string_view_t value,
+                                                     uint32_t unknown_value,
+                                                     uint32_t* out_value) {
+  if (iree_string_view_equal(value, IREE_SV("-"))) {
+    *out_value = unknown_value;
+    return true;
+  }
+  return iree_string_view_atoi_uint32(value, out_value);
+}
+
+// Parses a thread affinity of the form `-` (unspecified) or `group.id` with an
+// optional `s` suffix indicating the entire SMT set should be reserved.
+static bool iree_task_topology_parse_affinity(
+    iree_string_view_t value, iree_thread_affinity_t* out_affinity) {
+  memset(out_affinity, 0, sizeof(*out_affinity));
+  if (iree_string_view_equal(value, IREE_SV("-"))) {
+    iree_thread_affinity_set_any(out_affinity);
+    return true;
+  }
+  if (iree_string_view_consume_suffix(&value, IREE_SV("s"))) {
+    out_affinity->smt = 1;
+  }
+  iree_string_view_t group_value, id_value;
+  if (iree_string_view_split(value, '.', &group_value, &id_value) == -1) {
+    return false;
+  }
+  uint32_t group = 0, id = 0;
+  if (!iree_string_view_atoi_uint32(group_value, &group) ||
+      !iree_string_view_atoi_uint32(id_value, &id) || group >= (1u << 7) ||
+      id >= (1u << 23)) {
+    return false;
+  }
+  out_affinity->specified = 1;
+  out_affinity->group = group;
+  out_affinity->id = id;
+  return true;
+}
+
+// Parses a group mask of the form `*` (all), `-` (none), or `+`-separated
+// group indices.
+static bool iree_task_topology_parse_group_mask(
+    iree_string_view_t value, iree_task_topology_group_mask_t* out_mask) {
+  iree_task_worker_set_clear(out_mask);
+  if (iree_string_view_equal(value, IREE_SV("*"))) {
+    iree_task_worker_set_fill(out_mask);
+    return true;
+  } else if (iree_string_view_equal(value, IREE_SV("-"))) {
+    return true;
+  }
+  while (!iree_string_view_is_empty(value)) {
+    iree_string_view_t index_value;
+    iree_string_view_split(value, '+', &index_value, &value);
+    uint32_t index = 0;
+    if (!iree_string_view_atoi_uint32(index_value, &index) ||
+        index >= IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
+      return false;
+    }
+    iree_task_worker_set_insert(out_mask, index);
+  }
+  return true;
+}
+
+// Parses a group of the form:
+//   processor:affinity:llc:node:capacity:priority:sharing
+static iree_status_t iree_task_topology_parse_group(
+    iree_string_view_t value, iree_task_topology_group_t* group) {
+  iree_string_view_t fields[7];
+  iree_host_size_t field_count = 0;
+  iree_string_view_t remaining = value;
+  while (!iree_string_view_is_empty(remaining) &&
+         field_count < IREE_ARRAYSIZE(fields)) {
+    iree_string_view_split(remaining, ':', &fields[field_count++], &remaining);
+  }
+  int32_t priority_class = 0;
+  if (field_count != IREE_ARRAYSIZE(fields) ||
+      !iree_string_view_is_empty(remaining) ||
+      !iree_string_view_atoi_uint32(fields[0], &group->processor_index) ||
+      !iree_task_topology_parse_affinity(fields[1],
+                                         &group->ideal_thread_affinity) ||
+      !iree_task_topology_parse_optional_uint32(
+          fields[2], IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN, &group->llc_id) ||
+      !iree_task_topology_parse_optional_uint32(
+          fields[3], IREE_TASK_TOPOLOGY_NODE_ID_ANY, &group->node_id) ||
+      !iree_string_view_atoi_uint32(fields[4], &group->capacity) ||
+      !iree_string_view_atoi_int32(fields[5], &priority_class) ||
+      priority_class < IREE_THREAD_PRIORITY_CLASS_LOWEST ||
+      priority_class > IREE_THREAD_PRIORITY_CLASS_HIGHEST ||
+      !iree_task_topology_parse_group_mask(
+          fields[6], &group->constructive_sharing_mask)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid topology group %u '%.*s'",
+                            group->group_index, (int)value.size, value.data);
+  }
+  group->priority_class = (iree_thread_priority_class_t)priority_class;
+  return iree_ok_status();
+}
+
 iree_status_t iree_task_topology_parse(iree_string_view_t value,
                                        iree_task_topology_t* out_topology) {
-  // TODO(benvanik): define a format that is generally useful alongside cpuinfo.
-  // Maybe colon-separated group-id values from thread affinities? Like:
-  //   0.0:0.2:0.4:0.8 to indicate cores 0,2,4,8 on group 0
-  //   0.0:0.1:1.0:1.1 to indicate cores 0,1 of both groups 0,1
-  // etc
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+  IREE_ASSERT_ARGUMENT(out_topology);
+  iree_task_topology_initialize(out_topology);
+  value = iree_string_view_trim(value);
+
+  iree_string_view_t node_value;
+  iree_string_view_split(value, ';', &node_value, &value);
+  if (!iree_task_topology_parse_optional_uint32(node_value,
+                                                IREE_TASK_TOPOLOGY_NODE_ID_ANY,
+                                                &out_topology->node_id)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid topology node ID '%.*s'",
+                            (int)node_value.size, node_value.data);
+  }
+
+  while (!iree_string_view_is_empty(value)) {
+    if (out_topology->group_count + 1 > IREE_ARRAYSIZE(out_topology->groups)) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "group capacity exceeded");
+    }
+    iree_string_view_t group_value;
+    iree_string_view_split(value, ';', &group_value, &value);
+    iree_task_topology_group_t* group =
+        &out_topology->groups[out_topology->group_count];
+    iree_task_topology_group_initialize(out_topology->group_count, group);
+    IREE_RETURN_IF_ERROR(iree_task_topology_parse_group(group_value, group));
+    ++out_topology->group_count;
+  }
+  return iree_ok_status();
+}
+
+// Appends a formatted string to |buffer| if it fits and adds the length of the
+// formatted string to |buffer_length| regardless.
+static void iree_task_topology_append_format(iree_host_size_t buffer_capacity,
+                                             char* buffer,
+                                             iree_host_size_t* buffer_length,
+                                             const char* format, ...) {
+  va_list varargs;
+  va_start(varargs, format);
+  const bool has_space = buffer && *buffer_length < buffer_capacity;
+  int length = vsnprintf(has_space ? buffer + *buffer_length : NULL,
+                         has_space ? buffer_capacity - *buffer_length : 0,
+                         format, varargs);
+  va_end(varargs);
+  if (length > 0) *buffer_length += (iree_host_size_t)length;
+}
+
+// Appends |value| or '-' if it is |unknown_value|.
+static void iree_task_topology_append_optional_uint32(
+    iree_host_size_t buffer_capacity, char* buffer,
+    iree_host_size_t* buffer_length, uint32_t value, uint32_t unknown_value) {
+  if (value == unknown_value) {
+    iree_task_topology_append_format(buffer_capacity, buffer, buffer_length,
+                                     "-");
+  } else {
+    iree_task_topology_append_format(buffer_capacity, buffer, buffer_length,
+                                     "%u", value);
+  }
 }
 
 bool iree_task_topology_format(const iree_task_topology_t* topology,
                                iree_host_size_t buffer_capacity, char* buffer,
                                iree_host_size_t* out_buffer_length) {
-  // TODO(benvanik): formatting to match parsing.
-  return false;
+  IREE_ASSERT_ARGUMENT(topology);
+  iree_host_size_t length = 0;
+  iree_task_topology_append_optional_uint32(buffer_capacity, buffer, &length,
+                                            topology->node_id,
+                                            IREE_TASK_TOPOLOGY_NODE_ID_ANY);
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    const iree_task_topology_group_t* group = &topology->groups[i];
+    iree_task_topology_append_format(buffer_capacity, buffer, &length, ";%u:",
+                                     group->processor_index);
+    const iree_thread_affinity_t* affinity = &group->ideal_thread_affinity;
+    if (affinity->specified) {
+      iree_task_topology_append_format(buffer_capacity, buffer, &length,
+                                       "%u.%u%s", affinity->group, affinity->id,
+                                       affinity->smt ? "s" : "");
+    } else {
+      iree_task_topology_append_format(buffer_capacity, buffer, &length, "-");
+    }
+    iree_task_topology_append_format(buffer_capacity, buffer, &length, ":");
+    iree_task_topology_append_optional_uint32(
+        buffer_capacity, buffer, &length, group->llc_id,
+        IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN);
+    iree_task_topology_append_format(buffer_capacity, buffer, &length, ":");
+    iree_task_topology_append_optional_uint32(buffer_capacity, buffer, &length,
+                                              group->node_id,
+                                              IREE_TASK_TOPOLOGY_NODE_ID_ANY);
+    iree_task_topology_append_format(buffer_capacity, buffer, &length,
+                                     ":%u:%d:", group->capacity,
+                                     (int)group->priority_class);
+    const iree_task_topology_group_mask_t* mask =
+        &group->constructive_sharing_mask;
+    if (iree_task_worker_set_is_full(mask)) {
+      iree_task_topology_append_format(buffer_capacity, buffer, &length, "*");
+    } else if (iree_task_worker_set_is_empty(mask)) {
+      iree_task_topology_append_format(buffer_capacity, buffer, &length, "-");
+    } else {
+      for (int j = iree_task_worker_set_find_next(mask, 0), k = 0; j >= 0;
+           j = iree_task_worker_set_find_next(mask, j + 1), ++k) {
+        iree_task_topology_append_format(buffer_capacity, buffer, &length,
+                                         k > 0 ? "+%d" : "%d", j);
+      }
+    }
+  }
+  if (out_buffer_length) *out_buffer_length = length;
+  return buffer && length < buffer_capacity;
 }
 
 iree_host_size_t iree_task_topology_group_capacity(
@@ -78,6 +275,40 @@ iree_status_t iree_task_topology_push_group(
   return iree_ok_status();
 }
 
+void iree_task_topology_calculate_sharing_masks(
+    const iree_task_topology_t* topology, iree_host_size_t group_index,
+    iree_task_topology_group_mask_t
+        out_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT]) {
+  const iree_task_topology_group_t* group = &topology->groups[group_index];
+
+  // Nearest level comes directly from the topology.
+  iree_task_topology_group_mask_t* cache_mask =
+      &out_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_CACHE];
+  *cache_mask = group->constructive_sharing_mask;
+  iree_task_worker_set_remove(cache_mask, group_index);
+
+  // Farther levels only include the groups not already in a nearer level.
+  iree_task_topology_group_mask_t* llc_mask =
+      &out_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_LLC];
+  iree_task_topology_group_mask_t* node_mask =
+      &out_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_NODE];
+  iree_task_worker_set_clear(llc_mask);
+  iree_task_worker_set_clear(node_mask);
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    if (i == group_index || iree_task_worker_set_contains(cache_mask, i)) {
+      continue;
+    }
+    const iree_task_topology_group_t* other_group = &topology->groups[i];
+    if (group->llc_id != IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN &&
+        group->llc_id == other_group->llc_id) {
+      iree_task_worker_set_insert(llc_mask, i);
+    } else if (group->node_id != IREE_TASK_TOPOLOGY_NODE_ID_ANY &&
+               group->node_id == other_group->node_id) {
+      iree_task_worker_set_insert(node_mask, i);
+    }
+  }
+}
+
 void iree_task_topology_initialize_from_group_count(
     iree_host_size_t group_count, iree_task_topology_t* out_topology) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -92,3 +323,11 @@ void iree_task_topology_initialize_from_group_count(
 
   IREE_TRACE_ZONE_END(z0);
 }
+
+void iree_task_topology_set_priority_class(
+    iree_task_topology_t* topology,
+    iree_thread_priority_class_t priority_class) {
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    topology->groups[i].priority_class = priority_class;
+  }
+}
@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/threading.h"
+#include "iree/task/affinity_set.h"
 #include "iree/task/tuning.h"
 
 #ifdef __cplusplus
@@ -43,11 +44,46 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void);
 
 // A bitmask indicating which other groups from 0 to N may constructively share
 // caches. For example, a value of 0b1100 indicates that group 2 and 3 share.
-typedef uint64_t iree_task_topology_group_mask_t;
-
-#define IREE_TASK_TOPOLOGY_GROUP_MASK_ALL UINT64_MAX
-#define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT \
-  (sizeof(iree_task_topology_group_mask_t) * 8)
+// Group indices map 1:1 with the local worker indices of the executor created
+// from the topology.
+typedef iree_task_worker_set_t iree_task_topology_group_mask_t;
+
+#define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT IREE_TASK_WORKER_SET_BIT_COUNT
+
+// Indicates that a cache identifier is unknown and not shared with any group.
+#define IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN UINT32_MAX
+
+// Indicates that the relative capacity of a processor is unknown.
+#define IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN 0
+
+// Levels of the memory hierarchy that groups may share ordered from nearest to
+// farthest. Work stealing prefers victims at nearer levels so that stolen tasks
+// are likely to find their operands in caches the thief can also reach.
+typedef enum iree_task_topology_sharing_level_e {
+  // Groups share some low-level cache (L1/L2) as defined by the group
+  // constructive_sharing_mask.
+  IREE_TASK_TOPOLOGY_SHARING_LEVEL_CACHE = 0,
+  // Groups share the last-level cache (such as the L3 of an AMD CCX).
+  IREE_TASK_TOPOLOGY_SHARING_LEVEL_LLC,
+  // Groups are on the same NUMA node.
+  IREE_TASK_TOPOLOGY_SHARING_LEVEL_NODE,
+  IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT,
+} iree_task_topology_sharing_level_t;
+
+// Returns a short human-readable name for |level| used in tracing/dumps.
+static inline const char* iree_task_topology_sharing_level_name(
+    iree_task_topology_sharing_level_t level) {
+  switch (level) {
+    case IREE_TASK_TOPOLOGY_SHARING_LEVEL_CACHE:
+      return "cache";
+    case IREE_TASK_TOPOLOGY_SHARING_LEVEL_LLC:
+      return "llc";
+    case IREE_TASK_TOPOLOGY_SHARING_LEVEL_NODE:
+      return "node";
+    default:
+      return "remote";
+  }
+}
 
 // Information about a particular group within the topology.
 // Groups may be of varying levels of granularity even within the same topology
@@ -55,10 +91,10 @@ typedef uint64_t iree_task_topology_group_mask_t;
 typedef struct iree_task_topology_group_t {
   // Group index within the topology matching a particular bit in
   // iree_task_topology_group_mask_t.
-  uint8_t group_index;
+  uint16_t group_index;
 
   // A name assigned to executor workers used for logging/tracing.
-  char name[32 - /*group_index*/ 1];
+  char name[32 - /*group_index*/ sizeof(uint16_t)];
 
   // Processor index in the cpuinfo set.
   uint32_t processor_index;
@@ -72,12 +108,31 @@ typedef struct iree_task_topology_group_t {
   // hierarchy. Workers of this group are more likely to constructively share
   // some cache levels higher up with these other groups. For example, if the
   // workers in a group all share an L2 cache then the groups indicated here may
-  // all share the same L3 cache.
+  // all share the same L3 cache. All bits are set if the sharing is unknown.
   iree_task_topology_group_mask_t constructive_sharing_mask;
+
+  // Identifier of the last-level cache the group's processor uses. Groups with
+  // the same identifier share the cache. IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN
+  // if not known.
+  uint32_t llc_id;
+
+  // NUMA node the group's processor belongs to or
+  // IREE_TASK_TOPOLOGY_NODE_ID_ANY if not known.
+  iree_task_topology_node_id_t node_id;
+
+  // Relative compute capacity of the group's processor as reported by the
+  // system or IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN. Only comparable with other
+  // groups from the same system: on heterogeneous (big.LITTLE) systems the
+  // performance cores have a higher capacity than the efficiency cores.
+  uint32_t capacity;
+
+  // Scheduling priority class hint for threads within this group. Defaults to
+  // IREE_THREAD_PRIORITY_CLASS_NORMAL.
+  iree_thread_priority_class_t priority_class;
 } iree_task_topology_group_t;
 
 // Initializes |out_group| with a |group_index| derived name.
-void iree_task_topology_group_initialize(uint8_t group_index,
+void iree_task_topology_group_initialize(uint16_t group_index,
                                          iree_task_topology_group_t* out_group);
 
 //===----------------------------------------------------------------------===//
@@ -102,6 +157,9 @@ void iree_task_topology_group_initialize(uint8_t group_index,
 // We can add the more common heuristics over time to the core and leave the
 // edge cases for applications to construct.
 typedef struct iree_task_topology_t {
+  // NUMA node all groups in the topology are pinned to or
+  // IREE_TASK_TOPOLOGY_NODE_ID_ANY if the groups may span nodes.
+  iree_task_topology_node_id_t node_id;
   iree_host_size_t group_count;
   iree_task_topology_group_t groups[IREE_TASK_EXECUTOR_MAX_WORKER_COUNT];
 } iree_task_topology_t;
@@ -113,11 +171,28 @@ void iree_task_topology_initialize(iree_task_topology_t* out_topology);
 void iree_task_topology_deinitialize(iree_task_topology_t* topology);
 
 // Parses a serialized topology in string form.
+//
+// The topology node ID is followed by one `;`-separated entry per group:
+//   node;processor:affinity:llc:node:capacity:priority:sharing;...
+// where:
+//   affinity: `group.id` with an `s` suffix to reserve the whole SMT set
+//   priority: iree_thread_priority_class_t value
+//   sharing:  `+`-separated constructive sharing group indices
+// Unknown/unspecified values are `-` and a full sharing mask is `*`. Group
+// names are derived from the group index.
+//
+// Example with two groups on node 0 that share a cache:
+//   0;0:0.0s:0:0:1024:0:1;2:0.2s:0:0:1024:0:0
 iree_status_t iree_task_topology_parse(iree_string_view_t value,
                                        iree_task_topology_t* out_topology);
 
 // Formats the topology as a string value that can be parsed with
-// iree_task_topology_parse.
+// iree_task_topology_parse. Discovered topologies can be formatted once and
+// cached by applications to skip querying the machine in later processes.
+// |out_buffer_length| is set to the formatted length excluding the NUL
+// terminator regardless of whether it fits. Returns false if |buffer| is
+// NULL or |buffer_capacity| is insufficient to hold the string and its NUL
+// terminator.
 bool iree_task_topology_format(const iree_task_topology_t* topology,
                                iree_host_size_t buffer_capacity, char* buffer,
                                iree_host_size_t* out_buffer_length);
@@ -139,6 +214,15 @@ const iree_task_topology_group_t* iree_task_topology_get_group(
 iree_status_t iree_task_topology_push_group(
     iree_task_topology_t* topology, const iree_task_topology_group_t* group);
 
+// Calculates the groups that share each level of the memory hierarchy with the
+// group at |group_index|. Each group is included only in the nearest level it
+// shares and the group itself is never included. Groups that share no level
+// are in none of the masks.
+void iree_task_topology_calculate_sharing_masks(
+    const iree_task_topology_t* topology, iree_host_size_t group_index,
+    iree_task_topology_group_mask_t
+        out_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT]);
+
 //===----------------------------------------------------------------------===//
 // Topology initialization helpers
 //===----------------------------------------------------------------------===//
@@ -159,6 +243,21 @@ void iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
     iree_task_topology_t* out_topology);
 
+// Initializes a topology with one group for each of the most capable physical
+// cores with the given NUMA node ID. Up to |max_core_count| physical cores will
+// be selected from the node. Use this to keep latency-critical work off of the
+// efficiency cores of heterogeneous systems. Identical to
+// iree_task_topology_initialize_from_physical_cores when core capacities are
+// unknown or uniform.
+void iree_task_topology_initialize_from_performance_cores(
+    iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology);
+
+// Sets the priority class of all groups in |topology| to |priority_class|.
+void iree_task_topology_set_priority_class(
+    iree_task_topology_t* topology,
+    iree_thread_priority_class_t priority_class);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/call_once.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
@@ -41,6 +42,12 @@ void iree_task_topology_initialize_from_physical_cores(
   iree_task_topology_initialize_fallback(max_core_count, out_topology);
 }
 
+void iree_task_topology_initialize_from_performance_cores(
+    iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology) {
+  iree_task_topology_initialize_fallback(max_core_count, out_topology);
+}
+
 #else
 
 #include <cpuinfo.h>
@@ -133,33 +140,87 @@ static void iree_task_topology_set_affinity_from_processor(
 #endif  // cpuinfo-like platform field
 }
 
-// Returns a bitset with all *processors* that share the same |cache|.
-static uint64_t iree_task_topology_calculate_cache_bits(
-    const struct cpuinfo_cache* cache) {
-  if (!cache) return 0;
-  uint64_t mask = 0;
-  for (uint32_t processor_i = 0; processor_i < cache->processor_count;
-       ++processor_i) {
-    uint32_t i = cache->processor_start + processor_i;
-    if (i < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
-      mask |= 1ull << i;
+// Returns the relative compute capacity of |processor| or
+// IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN if the platform doesn't report it.
+static uint32_t iree_task_topology_query_processor_capacity(
+    const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+  // The kernel scheduler's view of each CPU's capacity, normalized to 1024 for
+  // the most capable CPUs. Only present on heterogeneous architectures such as
+  // ARM big.LITTLE/DynamIQ.
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpu_capacity",
+           processor->linux_id);
+  FILE* file = fopen(path, "r");
+  if (!file) return IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN;
+  unsigned int capacity = IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN;
+  if (fscanf(file, "%u", &capacity) != 1) {
+    capacity = IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN;
+  }
+  fclose(file);
+  return (uint32_t)capacity;
+#else
+  // TODO(benvanik): query core types on darwin (hw.perflevel*) and Windows
+  // (EfficiencyClass from GetLogicalProcessorInformationEx).
+  return IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN;
+#endif  // cpuinfo-like platform field
+}
+
+// Capacity of each core indexed by cpuinfo core index. Populated on first use
+// and retained for the lifetime of the process as the capacities do not change
+// and querying them takes a file open/read per core. NULL if the cache could
+// not be allocated in which case capacities are queried on demand.
+static iree_once_flag iree_task_topology_core_capacities_once_ =
+    IREE_ONCE_FLAG_INIT;
+static uint32_t* iree_task_topology_core_capacities_ = NULL;
+
+static void iree_task_topology_initialize_core_capacities(void) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const uint32_t core_count = cpuinfo_get_cores_count();
+  uint32_t* capacities = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      iree_allocator_system(), core_count * sizeof(*capacities),
+      (void**)&capacities);
+  if (iree_status_is_ok(status)) {
+    for (uint32_t i = 0; i < core_count; ++i) {
+      capacities[i] = iree_task_topology_query_processor_capacity(
+          cpuinfo_get_processor(cpuinfo_get_core(i)->processor_start));
     }
+    iree_task_topology_core_capacities_ = capacities;
+  } else {
+    iree_status_ignore(status);
   }
-  return mask;
+  IREE_TRACE_ZONE_END(z0);
 }
 
-// Constructs a constructive sharing mask for all *processors* that share the
-// same cache as the specified |processor|.
-static uint64_t iree_task_topology_calculate_constructive_sharing_mask(
-    const struct cpuinfo_processor* processor) {
-  uint64_t mask = 0;
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1i);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1d);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l2);
+// Returns the capacity of |core| based on its first processor.
+static uint32_t iree_task_topology_query_core_capacity(
+    const struct cpuinfo_core* core) {
+  iree_call_once(&iree_task_topology_core_capacities_once_,
+                 iree_task_topology_initialize_core_capacities);
+  if (iree_task_topology_core_capacities_) {
+    return iree_task_topology_core_capacities_[core - cpuinfo_get_cores()];
+  }
+  return iree_task_topology_query_processor_capacity(
+      cpuinfo_get_processor(core->processor_start));
+}
+
+// Returns true if |lhs| and |rhs| share the same |cache| instance.
+static bool iree_task_topology_caches_match(const struct cpuinfo_cache* lhs,
+                                            const struct cpuinfo_cache* rhs) {
+  return lhs && lhs == rhs;
+}
+
+// Returns true if the *processors* |lhs| and |rhs| share any of the caches we
+// consider for constructive sharing.
+static bool iree_task_topology_processors_share_cache(
+    const struct cpuinfo_processor* lhs, const struct cpuinfo_processor* rhs) {
   // TODO(benvanik): include L3 here too (for systems that have it)? Or use L3
   // info purely for distribution and focus the group mask on lower-latency
   // caches?
-  return mask;
+  return iree_task_topology_caches_match(lhs->cache.l1i, rhs->cache.l1i) ||
+         iree_task_topology_caches_match(lhs->cache.l1d, rhs->cache.l1d) ||
+         iree_task_topology_caches_match(lhs->cache.l2, rhs->cache.l2);
 }
 
 // Populates |our_group| with the information from |core|.
@@ -178,6 +239,14 @@ static void iree_task_topology_group_initialize_from_core(
       cpuinfo_get_processor(processor_i);
   iree_task_topology_set_affinity_from_processor(
       processor, &out_group->ideal_thread_affinity);
+
+  // Caches partition processors so the first processor sharing the cache is a
+  // unique identifier for it.
+  if (processor->cache.l3) {
+    out_group->llc_id = processor->cache.l3->processor_start;
+  }
+  out_group->node_id = processor->cluster->cluster_id;
+  out_group->capacity = iree_task_topology_query_core_capacity(core);
 }
 
 // Fixes constructive_sharing_mask values such that they represent other chosen
@@ -186,23 +255,23 @@ static void iree_task_topology_group_initialize_from_core(
 // processor IDs a particular group is mapped to.
 static void iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_t* topology) {
-  // O(n^2), but n is always <= 64 (and often <= 8).
+  // O(n^2), but n is always <= IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (and often
+  // <= 8).
   for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
     iree_task_topology_group_t* group = &topology->groups[i];
+    const struct cpuinfo_processor* processor =
+        cpuinfo_get_processor(group->processor_index);
 
-    // Compute the processors that we can constructively share with.
-    uint64_t constructive_sharing_mask =
-        iree_task_topology_calculate_constructive_sharing_mask(
-            cpuinfo_get_processor(group->processor_index));
-
-    iree_task_topology_group_mask_t group_mask = 0;
+    // Compute the other groups that we can constructively share with.
+    iree_task_topology_group_mask_t group_mask;
+    iree_task_worker_set_clear(&group_mask);
     for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
       if (i == j) continue;
       const iree_task_topology_group_t* other_group = &topology->groups[j];
-      uint64_t group_processor_bits =
-          iree_math_rotl_u64(1ull, other_group->processor_index);
-      if (constructive_sharing_mask & group_processor_bits) {
-        group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
+      if (iree_task_topology_processors_share_cache(
+              processor,
+              cpuinfo_get_processor(other_group->processor_index))) {
+        iree_task_worker_set_insert(&group_mask, other_group->group_index);
       }
     }
 
@@ -229,6 +298,26 @@ static bool iree_task_topology_core_filter_by_cluster_id(
   return core->cluster->cluster_id == cluster_id;
 }
 
+// Filter data for iree_task_topology_core_filter_by_capacity.
+typedef struct iree_task_topology_capacity_filter_t {
+  // NUMA node the cores must belong to or IREE_TASK_TOPOLOGY_NODE_ID_ANY.
+  iree_task_topology_node_id_t node_id;
+  // Minimum capacity the cores must have.
+  uint32_t min_capacity;
+} iree_task_topology_capacity_filter_t;
+
+// Matches all cores in the filter node with at least the filter capacity.
+// |user_data| is a pointer to an iree_task_topology_capacity_filter_t.
+static bool iree_task_topology_core_filter_by_capacity(
+    const struct cpuinfo_core* core, uintptr_t user_data) {
+  const iree_task_topology_capacity_filter_t* filter =
+      (const iree_task_topology_capacity_filter_t*)user_data;
+  if (!iree_task_topology_core_filter_by_cluster_id(core, filter->node_id)) {
+    return false;
+  }
+  return iree_task_topology_query_core_capacity(core) >= filter->min_capacity;
+}
+
 // Initializes a topology with one group for each core that matches |filter_fn|.
 //
 // If cpuinfo is not available this falls back to the same behavior as
@@ -236,7 +325,8 @@ static bool iree_task_topology_core_filter_by_cluster_id(
 static void iree_task_topology_initialize_from_physical_cores_with_filter(
     iree_task_topology_core_filter_t filter_fn, uintptr_t filter_fn_data,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
-  max_core_count = iree_min(max_core_count, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
+  max_core_count =
+      iree_min(max_core_count, IREE_ARRAYSIZE(out_topology->groups));
   if (!iree_task_topology_is_cpuinfo_available()) {
     iree_task_topology_initialize_fallback(max_core_count, out_topology);
     return;
@@ -285,6 +375,36 @@ void iree_task_topology_initialize_from_physical_cores(
   iree_task_topology_initialize_from_physical_cores_with_filter(
       iree_task_topology_core_filter_by_cluster_id, (uintptr_t)node_id,
       max_core_count, out_topology);
+  if (iree_task_topology_is_cpuinfo_available()) {
+    out_topology->node_id = node_id;
+  }
+}
+
+void iree_task_topology_initialize_from_performance_cores(
+    iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology) {
+  // Find the most capable cores in the node. If capacities are unknown then
+  // all cores match and this is the same as selecting all physical cores.
+  iree_task_topology_capacity_filter_t filter = {
+      .node_id = node_id,
+      .min_capacity = IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN,
+  };
+  if (iree_task_topology_is_cpuinfo_available()) {
+    for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+      const struct cpuinfo_core* core = cpuinfo_get_core(i);
+      if (!iree_task_topology_core_filter_by_cluster_id(core, node_id)) {
+        continue;
+      }
+      filter.min_capacity = iree_max(
+          filter.min_capacity, iree_task_topology_query_core_capacity(core));
+    }
+  }
+  iree_task_topology_initialize_from_physical_cores_with_filter(
+      iree_task_topology_core_filter_by_capacity, (uintptr_t)&filter,
+      max_core_count, out_topology);
+  if (iree_task_topology_is_cpuinfo_available()) {
+    out_topology->node_id = node_id;
+  }
 }
 
 #endif  // IREE_TASK_CPUINFO_DISABLED
@@ -7,6 +7,7 @@
 #include "iree/task/topology.h"
 
 #include <cstddef>
+#include <cstring>
 
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -20,6 +21,7 @@ TEST(TopologyTest, Lifetime) {
   iree_task_topology_initialize(&topology);
   EXPECT_GT(iree_task_topology_group_capacity(&topology), 0);
   EXPECT_EQ(0, iree_task_topology_group_count(&topology));
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY, topology.node_id);
   iree_task_topology_deinitialize(&topology);
 }
 
@@ -35,11 +37,109 @@ TEST(TopologyTest, Empty) {
 }
 
 TEST(TopologyTest, Parsing) {
-  // TODO(benvanik): implement parsing.
+  iree_task_topology_t topology;
+  IREE_ASSERT_OK(iree_task_topology_parse(
+      IREE_SV("1;4:1.4s:2:1:512:1:1+2;6:-:-:-:0:0:*;8:1.8:2:1:1024:-2:-"),
+      &topology));
+  EXPECT_EQ(1, topology.node_id);
+  ASSERT_EQ(3, iree_task_topology_group_count(&topology));
+
+  const iree_task_topology_group_t* group0 =
+      iree_task_topology_get_group(&topology, 0);
+  EXPECT_EQ(0, group0->group_index);
+  EXPECT_STREQ("iree-worker-0", group0->name);
+  EXPECT_EQ(4, group0->processor_index);
+  EXPECT_EQ(1, group0->ideal_thread_affinity.specified);
+  EXPECT_EQ(1, group0->ideal_thread_affinity.group);
+  EXPECT_EQ(4, group0->ideal_thread_affinity.id);
+  EXPECT_EQ(1, group0->ideal_thread_affinity.smt);
+  EXPECT_EQ(2, group0->llc_id);
+  EXPECT_EQ(1, group0->node_id);
+  EXPECT_EQ(512, group0->capacity);
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_HIGH, group0->priority_class);
+  EXPECT_EQ(2, iree_task_worker_set_count_ones(
+                   &group0->constructive_sharing_mask));
+  EXPECT_TRUE(
+      iree_task_worker_set_contains(&group0->constructive_sharing_mask, 1));
+  EXPECT_TRUE(
+      iree_task_worker_set_contains(&group0->constructive_sharing_mask, 2));
+
+  const iree_task_topology_group_t* group1 =
+      iree_task_topology_get_group(&topology, 1);
+  EXPECT_EQ(0, group1->ideal_thread_affinity.specified);
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN, group1->llc_id);
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY, group1->node_id);
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_CAPACITY_UNKNOWN, group1->capacity);
+  EXPECT_TRUE(iree_task_worker_set_is_full(&group1->constructive_sharing_mask));
+
+  const iree_task_topology_group_t* group2 =
+      iree_task_topology_get_group(&topology, 2);
+  EXPECT_EQ(0, group2->ideal_thread_affinity.smt);
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_LOWEST, group2->priority_class);
+  EXPECT_TRUE(
+      iree_task_worker_set_is_empty(&group2->constructive_sharing_mask));
+
+  iree_task_topology_deinitialize(&topology);
+
+  // No groups.
+  IREE_ASSERT_OK(iree_task_topology_parse(IREE_SV("-"), &topology));
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY, topology.node_id);
+  EXPECT_EQ(0, iree_task_topology_group_count(&topology));
+
+  // Malformed groups.
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        iree_task_topology_parse(IREE_SV("x"), &topology));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_task_topology_parse(IREE_SV("0;1:-:-:-:0:0"), &topology));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_task_topology_parse(IREE_SV("0;1:-:-:-:0:9:*"), &topology));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_task_topology_parse(IREE_SV("0;1:1:-:-:0:0:*"), &topology));
 }
 
 TEST(TopologyTest, Formatting) {
-  // TODO(benvanik): implement formatting.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(2, &topology);
+  topology.node_id = 0;
+  topology.groups[0].processor_index = 3;
+  topology.groups[0].ideal_thread_affinity.specified = 1;
+  topology.groups[0].ideal_thread_affinity.group = 0;
+  topology.groups[0].ideal_thread_affinity.id = 3;
+  topology.groups[0].ideal_thread_affinity.smt = 1;
+  topology.groups[0].llc_id = 0;
+  topology.groups[0].node_id = 0;
+  topology.groups[0].capacity = 1024;
+  iree_task_worker_set_clear(&topology.groups[0].constructive_sharing_mask);
+  iree_task_worker_set_insert(&topology.groups[0].constructive_sharing_mask,
+                              1);
+  topology.groups[1].priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+  iree_task_worker_set_clear(&topology.groups[1].constructive_sharing_mask);
+
+  const char* expected = "0;3:0.3s:0:0:1024:0:1;0:-:-:-:0:-1:-";
+  iree_host_size_t length = 0;
+  EXPECT_FALSE(iree_task_topology_format(&topology, 0, NULL, &length));
+  EXPECT_EQ(strlen(expected), length);
+  char buffer[128];
+  EXPECT_FALSE(iree_task_topology_format(&topology, length, buffer, &length));
+  ASSERT_TRUE(
+      iree_task_topology_format(&topology, sizeof(buffer), buffer, &length));
+  EXPECT_STREQ(expected, buffer);
+
+  // Round-trips through parsing.
+  iree_task_topology_t parsed_topology;
+  IREE_ASSERT_OK(iree_task_topology_parse(iree_make_cstring_view(buffer),
+                                          &parsed_topology));
+  ASSERT_EQ(2, iree_task_topology_group_count(&parsed_topology));
+  EXPECT_EQ(0, memcmp(&topology.groups[0], &parsed_topology.groups[0],
+                      sizeof(topology.groups[0])));
+  EXPECT_EQ(0, memcmp(&topology.groups[1], &parsed_topology.groups[1],
+                      sizeof(topology.groups[1])));
+
+  iree_task_topology_deinitialize(&parsed_topology);
+  iree_task_topology_deinitialize(&topology);
 }
 
 TEST(TopologyTest, Construction) {
@@ -117,6 +217,56 @@ TEST(TopologyTest, FromGroupCount) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, SharingMasks) {
+  // 8 groups: 2 nodes, each with 2 LLCs, each with 2 groups sharing L2.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  for (iree_host_size_t i = 0; i < 8; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    iree_task_worker_set_clear(&group.constructive_sharing_mask);
+    iree_task_worker_set_insert(&group.constructive_sharing_mask, i & ~1);
+    iree_task_worker_set_insert(&group.constructive_sharing_mask, i | 1);
+    group.llc_id = (uint32_t)(i / 2);
+    group.node_id = (iree_task_topology_node_id_t)(i / 4);
+    IREE_EXPECT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+
+  iree_task_topology_group_mask_t masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT];
+  iree_task_topology_calculate_sharing_masks(&topology, 2, masks);
+  const iree_task_topology_group_mask_t& cache_mask =
+      masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_CACHE];
+  const iree_task_topology_group_mask_t& llc_mask =
+      masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_LLC];
+  const iree_task_topology_group_mask_t& node_mask =
+      masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_NODE];
+
+  // The group itself is never included and the L2 sibling takes precedence
+  // over the LLC it also shares.
+  EXPECT_EQ(1, iree_task_worker_set_count_ones(&cache_mask));
+  EXPECT_TRUE(iree_task_worker_set_contains(&cache_mask, 3));
+  EXPECT_TRUE(iree_task_worker_set_is_empty(&llc_mask));
+  EXPECT_EQ(2, iree_task_worker_set_count_ones(&node_mask));
+  EXPECT_TRUE(iree_task_worker_set_contains(&node_mask, 0));
+  EXPECT_TRUE(iree_task_worker_set_contains(&node_mask, 1));
+
+  // Without L2 sharing the sibling falls into the LLC level.
+  iree_task_worker_set_clear(&topology.groups[2].constructive_sharing_mask);
+  iree_task_topology_calculate_sharing_masks(&topology, 2, masks);
+  EXPECT_TRUE(iree_task_worker_set_is_empty(&cache_mask));
+  EXPECT_EQ(1, iree_task_worker_set_count_ones(&llc_mask));
+  EXPECT_TRUE(iree_task_worker_set_contains(&llc_mask, 3));
+
+  // Unknown IDs leave everything for the remote fallback.
+  topology.groups[2].llc_id = IREE_TASK_TOPOLOGY_CACHE_ID_UNKNOWN;
+  topology.groups[2].node_id = IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+  iree_task_topology_calculate_sharing_masks(&topology, 2, masks);
+  EXPECT_TRUE(iree_task_worker_set_is_empty(&llc_mask));
+  EXPECT_TRUE(iree_task_worker_set_is_empty(&node_mask));
+
+  iree_task_topology_deinitialize(&topology);
+}
+
 // Verifies only that the |topology| is usable.
 // If we actually checked the contents here then we'd just be validating that
 // cpuinfo was working and the tests would become machine-dependent.
@@ -144,4 +294,26 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, FromPerformanceCores) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  iree_task_topology_initialize_from_performance_cores(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, kMaxGroupCount, &topology);
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+
+  // All selected groups must have the same (highest) capacity.
+  for (iree_host_size_t i = 1; i < topology.group_count; ++i) {
+    EXPECT_EQ(topology.groups[0].capacity, topology.groups[i].capacity);
+  }
+
+  iree_task_topology_set_priority_class(&topology,
+                                        IREE_THREAD_PRIORITY_CLASS_HIGH);
+  for (iree_host_size_t i = 0; i < topology.group_count; ++i) {
+    EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_HIGH,
+              topology.groups[i].priority_class);
+  }
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
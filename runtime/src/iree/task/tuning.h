@@ -12,10 +12,20 @@ extern "C" {
 #endif  // __cplusplus
 
 // Maximum number of workers that an executor can manage.
-// A 64 worker hard limit is based on us using uint64_t as a bitmask to select
-// workers. It's easy to go smaller (just use fewer bits) if it's known that
-// only <64 will ever be used (such as for devices with 2 cores).
-#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (64)
+// Workers are tracked in multi-word bitsets (iree_task_worker_set_t) sized to
+// this value and each additional 64 workers adds one word to every set. It's
+// easy to go smaller if it's known that only <=64 will ever be used (such as
+// for devices with 2 cores) in order to keep all sets in a single word.
+#if !defined(IREE_TASK_EXECUTOR_MAX_WORKER_COUNT)
+#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (256)
+#endif  // !IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
+
+// Alignment of each worker's local memory block in bytes.
+// Blocks are page-aligned so that no page is shared between workers and each
+// worker can first-touch its own pages from its own (pinned) thread. On systems
+// with a first-touch NUMA policy (the Linux default) this places worker local
+// memory on the node the worker is running on.
+#define IREE_TASK_EXECUTOR_WORKER_LOCAL_MEMORY_ALIGNMENT (4096)
 
 // Initial number of shard tasks that are allocated in the executor pool.
 // Increasing this number will decrease initial allocation storms in cases of
@@ -23,28 +33,42 @@ extern "C" {
 // at the cost of a higher minimum memory consumption.
 #define IREE_TASK_EXECUTOR_INITIAL_SHARD_RESERVATION_PER_WORKER (4)
 
-// Maximum number of events retained by the executor event pool.
+// Number of events created up-front and always retained by the executor event
+// pool.
 #define IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY 64
 
-// Maximum number of simultaneous waits an executor may perform as part of a
-// wait-any operation. A larger value may enable better wake coalescing by the
-// kernel. This is only a count limiting wait tasks that have been scheduled and
-// been promoted to the root executor waiting list. There may be any number of
-// waits deeper in the pipeline so long as they don't all become ready
-// simultaneously.
-//
-// Realistically, though, if we have more than 64 outstanding **root** waits
-// it's hard to reason about if/when the executor queue could make forward
-// progress and indicates a possible error in task assignment.
+// Maximum number of events retained by the executor event pool. The pool grows
+// to the largest number of events outstanding at once up to this limit so
+// that semaphore-heavy workloads don't create and destroy an OS event per
+// wait. iree_task_executor_trim releases events retained beyond the initial
+// capacity.
+#define IREE_TASK_EXECUTOR_EVENT_POOL_MAX_CAPACITY 1024
+
+// Initial number of simultaneous waits an executor may perform as part of a
+// wait-any operation. This is only a count limiting wait tasks that have been
+// scheduled and been promoted to the root executor waiting list. There may be
+// any number of waits deeper in the pipeline so long as they don't all become
+// ready simultaneously.
 //
-// Also, the underlying iree_wait_set_t may not support more than 64 handles on
-// certain platforms without emulation. Trying to keep us on the fast-path
-// with a reasonable number seems fine for now until we have a need for more.
+// The wait set starts with this capacity to stay on the fast-path for common
+// programs and grows on demand up to IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS.
 //
 // NOTE: we reserve 1 wait handle for our own internal use. This allows us to
 // wake the coordination worker when new work is submitted from external
 // sources.
-#define IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS (64 - 1)
+#define IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS (64 - 1)
+
+// Maximum number of simultaneous waits an executor may perform as part of a
+// wait-any operation. Host-device interop with many concurrently exported
+// fences (one per in-flight request) can require many more than the initial
+// capacity.
+//
+// The underlying iree_wait_set_t may not support more than 64 handles on
+// certain platforms (such as WaitForMultipleObjects on Windows) and waits
+// beyond that will fail with RESOURCE_EXHAUSTED there regardless of this limit.
+//
+// NOTE: this includes the 1 wait handle reserved for internal use.
+#define IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS (16 * 1024 - 1)
 
 // Amount of time that can remain in a delay task while still retiring.
 // This prevents additional system sleeps when the remaining time before the
@@ -77,12 +101,33 @@ extern "C" {
 // In real-time systems too few tasks is better (slightly more work for much
 // lower variance in execution) while in batch mode systems too many tasks is
 // better (as latencies don't matter so long as throughput is maximized).
-#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT \
-  IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
+#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT (64)
 
-// Number of tiles that will be batched into a single reservation from the grid.
-// This is a maximum; if there are fewer tiles that would otherwise allow for
-// maximum parallelism then this may be ignored.
+// Default maximum duration in nanoseconds a worker will spin waiting for new
+// work when IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN is enabled and no explicit
+// worker_spin_ns is provided. This should be around the cost of a futex
+// wait/wake round-trip on the target system: idle periods shorter than this are
+// cheaper to spin through than to sleep through.
+#define IREE_TASK_WORKER_ADAPTIVE_SPIN_MAX_NS (50 /*us*/ * 1000)
+
+// Weight (as a power-of-two shift) given to the running idle duration estimate
+// each worker keeps when adaptively spinning. Each new observation contributes
+// 1/(1<<shift) to the estimate; larger values adapt more slowly but are less
+// sensitive to outliers.
+#define IREE_TASK_WORKER_ADAPTIVE_SPIN_HISTORY_SHIFT (2)
+
+// Enables issuing ready dispatches with no more tiles than there are workers
+// directly from iree_task_executor_submit to worker mailboxes instead of
+// routing them through the coordinator. This reduces the latency of
+// micro-dispatches (such as those in decoder-style models) at the cost of the
+// submitting thread doing the shard allocation and posting.
+#if !defined(IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE)
+#define IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE 1
+#endif  // !IREE_TASK_EXECUTOR_DIRECT_DISPATCH_ENABLE
+
+// Minimum number of tiles that will be batched into a single reservation from
+// the grid when the dispatch provides no cost hint. If there are fewer tiles
+// that would otherwise allow for maximum parallelism then this may be ignored.
 //
 // The more tiles reserved at a time the higher the chance for latency to
 // increase as many reserved tiles are held up on one worker while another may
@@ -94,6 +139,36 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Divisor applied to the number of shards in a dispatch when computing the
+// guided self-scheduling chunk size: each reservation takes
+// remaining_tiles / (shard_count * factor) tiles (bounded below by the minimum
+// chunk size). Larger values produce smaller initial chunks.
+#define IREE_TASK_DISPATCH_GUIDED_CHUNK_FACTOR (2)
+
+// Target duration in nanoseconds of the smallest chunk of tiles reserved at a
+// time when a dispatch provides a per-tile cost hint. Tiles cheaper than this
+// will be reserved in groups that take approximately this long to execute.
+#define IREE_TASK_DISPATCH_TARGET_CHUNK_NS (10 /*us*/ * 1000)
+
+// Maximum minimum-chunk size derived from a per-tile cost hint. This bounds
+// the tail imbalance of dispatches with very cheap or mispredicted tiles.
+#define IREE_TASK_DISPATCH_MAX_TILES_PER_CHUNK (256)
+
+// Minimum estimated duration in nanoseconds of the work given to each shard of
+// a dispatch that provides a per-tile cost hint. Dispatches with less total
+// work are split into fewer shards than there are workers as waking a worker
+// and joining it back costs on the order of a futex round-trip.
+#define IREE_TASK_DISPATCH_MIN_SHARD_NS (20 /*us*/ * 1000)
+
+// Default maximum estimated duration in nanoseconds of a ready dispatch with
+// the IREE_TASK_FLAG_DISPATCH_INLINE flag that is executed on the thread
+// readying it (the submitting thread or the coordinator) instead of being
+// issued to workers. See iree_task_executor_options_t::inline_dispatch_max_ns.
+// Set to 0 to disable by default.
+#if !defined(IREE_TASK_DISPATCH_INLINE_MAX_NS)
+#define IREE_TASK_DISPATCH_INLINE_MAX_NS (5 /*us*/ * 1000)
+#endif  // !IREE_TASK_DISPATCH_INLINE_MAX_NS
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
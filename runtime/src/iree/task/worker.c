@@ -14,6 +14,7 @@
 #include "iree/base/tracing.h"
 #include "iree/task/executor_impl.h"
 #include "iree/task/post_batch.h"
+#include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task_impl.h"
 #include "iree/task/tuning.h"
@@ -24,17 +25,19 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
-    const iree_task_topology_group_t* topology_group,
+    const iree_task_topology_t* topology,
     iree_host_size_t stack_size, iree_byte_span_t local_memory,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
   out_worker->worker_index = executor->worker_base_index + worker_index;
-  out_worker->worker_bit = iree_task_affinity_for_worker(worker_index);
+  out_worker->local_worker_index = worker_index;
+  const iree_task_topology_group_t* topology_group =
+      iree_task_topology_get_group(topology, worker_index);
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
-  out_worker->constructive_sharing_mask =
-      topology_group->constructive_sharing_mask;
+  iree_task_topology_calculate_sharing_masks(topology, worker_index,
+                                             out_worker->sharing_masks);
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
@@ -42,11 +45,16 @@ iree_status_t iree_task_worker_initialize(
   out_worker->local_memory = local_memory;
   out_worker->processor_id = 0;
   out_worker->processor_tag = 0;
+  out_worker->idle_estimate_ns = 0;
 
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
-  iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
-  iree_task_queue_initialize(&out_worker->local_task_queue);
+  iree_atomic_store_int32(&out_worker->pending_priority_mask, 0,
+                          iree_memory_order_relaxed);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_atomic_task_slist_initialize(&out_worker->mailbox_slists[i]);
+    iree_task_queue_initialize(&out_worker->local_task_queues[i]);
+  }
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   iree_atomic_store_int32(&out_worker->state, initial_state,
@@ -56,7 +64,7 @@ iree_status_t iree_task_worker_initialize(
   memset(&thread_params, 0, sizeof(thread_params));
   thread_params.name = iree_make_cstring_view(topology_group->name);
   thread_params.create_suspended = false;
-  thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  thread_params.priority_class = topology_group->priority_class;
   thread_params.initial_affinity = out_worker->ideal_thread_affinity;
   thread_params.stack_size =
       iree_max(IREE_TASK_WORKER_MIN_STACK_SIZE, stack_size);
@@ -130,44 +138,64 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // Release unfinished tasks by flushing the mailbox (which if we're here can't
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
-  iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_atomic_task_slist_discard(&worker->mailbox_slists[i]);
+    iree_task_list_discard(&worker->local_task_queues[i].list);
+  }
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
-  iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
-  iree_task_queue_deinitialize(&worker->local_task_queue);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_atomic_task_slist_deinitialize(&worker->mailbox_slists[i]);
+    iree_task_queue_deinitialize(&worker->local_task_queues[i]);
+  }
 
   IREE_TRACE_ZONE_END(z0);
 }
 
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
+                                 iree_task_priority_t priority,
                                  iree_task_list_t* list) {
   // Move the list into the mailbox. Note that the mailbox is LIFO and this list
   // is concatenated with its current order preserved (which should be LIFO).
-  iree_atomic_task_slist_concat(&worker->mailbox_slist, list->head, list->tail);
+  iree_atomic_task_slist_concat(&worker->mailbox_slists[priority], list->head,
+                                list->tail);
   memset(list, 0, sizeof(*list));
-}
-
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks) {
-  // Try to grab tasks from the worker; if more than one task is stolen then the
-  // first will be returned and the remaining will be added to the target queue.
-  iree_task_t* task = iree_task_queue_try_steal(&worker->local_task_queue,
-                                                target_queue, max_tasks);
-  if (task) return task;
 
-  // If we still didn't steal any tasks then let's try the slist instead.
-  task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
-  if (task) return task;
+  // Flag the priority as pending after the tasks are visible in the mailbox so
+  // that if the worker observes the bit the tasks are there to be flushed.
+  iree_atomic_fetch_or_int32(&worker->pending_priority_mask, 1 << priority,
+                             iree_memory_order_release);
+}
 
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker,
+    iree_task_queue_t target_queues[IREE_TASK_PRIORITY_COUNT],
+    iree_host_size_t max_tasks) {
+  for (int priority = IREE_TASK_PRIORITY_COUNT - 1; priority >= 0;
+       --priority) {
+    // Try to grab tasks from the worker; if more than one task is stolen then
+    // the first will be returned and the remaining will be added to the target
+    // queue of the same priority.
+    iree_task_t* task = iree_task_queue_try_steal(
+        &worker->local_task_queues[priority], &target_queues[priority],
+        max_tasks);
+    if (task) return task;
+
+    // If we still didn't steal any tasks then let's try the slist instead.
+    task = iree_atomic_task_slist_pop(&worker->mailbox_slists[priority]);
+    if (task) return task;
+  }
   return NULL;
 }
 
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
 // handled by the coordinator during scheduling.
+//
+// Dispatch shards may yield to higher-priority work posted to the worker while
+// they execute. Yielded shards are placed back at the front of the local queue
+// for their priority and resume after the higher-priority work is drained.
 static void iree_task_worker_execute(
     iree_task_worker_t* worker, iree_task_t* task,
     iree_task_submission_t* pending_submission) {
@@ -178,16 +206,21 @@ static void iree_task_worker_execute(
   // TODO(benvanik): think a bit more about this timing; this ensures we have
   // BFS behavior at the cost of the additional merge overhead - it's probably
   // worth it?
-  // TODO(benvanik): handle partial tasks and re-queuing.
   switch (task->type) {
     case IREE_TASK_TYPE_CALL: {
       iree_task_call_execute((iree_task_call_t*)task, pending_submission);
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
+      const bool yielded = iree_task_dispatch_shard_execute(
           (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+          worker->worker_index, worker->local_memory,
+          &worker->pending_priority_mask, pending_submission);
+      if (yielded) {
+        iree_task_queue_push_front(
+            &worker->local_task_queues[iree_task_scope_priority(task->scope)],
+            task);
+      }
       break;
     }
     default:
@@ -206,23 +239,35 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Check the local work queue for any work we know we should start
-  // processing immediately. Other workers may try to steal some of this work
-  // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
-
-  // Check the mailbox to see if we have incoming work that has been posted.
-  // We try to greedily move it to our local work list so that we can work
-  // with the full thread-local pending task list.
-  if (!task) {
+  // Walk each priority from highest to lowest and take the first task found.
+  // Any newly posted higher-priority work is picked up on the next pump as
+  // lower-priority dispatch shards yield to it.
+  iree_task_t* task = NULL;
+  for (int priority = IREE_TASK_PRIORITY_COUNT - 1; !task && priority >= 0;
+       --priority) {
+    iree_task_queue_t* local_task_queue = &worker->local_task_queues[priority];
+
+    // Check the local work queue for any work we know we should start
+    // processing immediately. Other workers may try to steal some of this work
+    // if we take too long.
+    task = iree_task_queue_pop_front(local_task_queue);
+    if (task) break;
+
+    // Check the mailbox to see if we have incoming work that has been posted.
+    // We try to greedily move it to our local work list so that we can work
+    // with the full thread-local pending task list. The pending bit is cleared
+    // first so that any post racing with the flush sets it again.
+    //
     // NOTE: there's a potential for theft pessimization if the queue runs too
     // low and there's nothing there when a thief goes to grab some tasks. A
     // standout there would indicate that we weren't scheduling very well in the
     // first place (large uneven workloads for various workers, bad distribution
     // in the face of heterogenous multi-core architectures where some workers
     // complete tasks faster than others, etc).
-    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
-                                                 &worker->mailbox_slist);
+    iree_atomic_fetch_and_int32(&worker->pending_priority_mask,
+                                ~(1 << priority), iree_memory_order_acquire);
+    task = iree_task_queue_flush_from_lifo_slist(
+        local_task_queue, &worker->mailbox_slists[priority]);
   }
 
 #if IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
@@ -232,9 +277,9 @@ static bool iree_task_worker_pump_once(
   // the first task in the queue is popped off and returned.
   if (!task) {
     task = iree_task_executor_try_steal_task(
-        worker->executor, worker->constructive_sharing_mask,
+        worker->executor, worker->sharing_masks,
         worker->max_theft_attempts, &worker->theft_prng,
-        &worker->local_task_queue);
+        worker->local_task_queues);
   }
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
@@ -252,11 +297,43 @@ static bool iree_task_worker_pump_once(
   return true;  // try again
 }
 
+// Returns true if any of the local task queues of |worker| have tasks.
+static bool iree_task_worker_has_local_tasks(iree_task_worker_t* worker) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    if (!iree_task_queue_is_empty(&worker->local_task_queues[i])) return true;
+  }
+  return false;
+}
+
 // Updates the cached processor ID field in the worker.
 static void iree_task_worker_update_processor_id(iree_task_worker_t* worker) {
   iree_cpu_requery_processor_id(&worker->processor_tag, &worker->processor_id);
 }
 
+// Returns the duration the worker should spin for before parking when
+// adaptive spinning is enabled. If recent idle periods have been short enough
+// that spinning would have caught the next piece of work then we spin for a
+// bit longer than the expected idle duration; otherwise we park immediately.
+static iree_duration_t iree_task_worker_select_spin_duration(
+    iree_task_worker_t* worker) {
+  const iree_duration_t max_spin_ns = worker->executor->worker_spin_ns;
+  const iree_duration_t estimate_ns = worker->idle_estimate_ns;
+  if (estimate_ns > max_spin_ns) return IREE_DURATION_ZERO;
+  return iree_min(estimate_ns * 2, max_spin_ns);
+}
+
+// Folds an observed |idle_ns| duration into the worker's idle estimate.
+// Observations are clamped so a single long sleep does not take a long series
+// of short idle periods to recover from.
+static void iree_task_worker_record_idle_duration(iree_task_worker_t* worker,
+                                                  iree_duration_t idle_ns) {
+  const iree_duration_t max_sample_ns = worker->executor->worker_spin_ns * 2;
+  idle_ns = iree_min(iree_max(idle_ns, 0), max_sample_ns);
+  worker->idle_estimate_ns +=
+      (idle_ns - worker->idle_estimate_ns) >>
+      IREE_TASK_WORKER_ADAPTIVE_SPIN_HISTORY_SHIFT;
+}
+
 // Alternates between pumping ready tasks in the worker queue and waiting
 // for more tasks to arrive. Only returns when the worker has been asked by
 // the executor to exit.
@@ -266,6 +343,10 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
   // be able to process it with the proper processor ID immediately.
   iree_task_worker_update_processor_id(worker);
 
+  const bool adaptive_spin = iree_all_bits_set(
+      worker->executor->scheduling_mode,
+      IREE_TASK_SCHEDULING_MODE_ADAPTIVE_SPIN);
+
   // Pump the thread loop to process more tasks.
   while (true) {
     // If we fail to find any work to do we'll wait at the end of this loop.
@@ -276,9 +357,9 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     iree_wait_token_t wait_token =
         iree_notification_prepare_wait(&worker->wake_notification);
     // The masks are accessed with 'relaxed' order because they are just hints.
-    iree_atomic_task_affinity_set_fetch_and(&worker->executor->worker_idle_mask,
-                                            ~worker->worker_bit,
-                                            iree_memory_order_relaxed);
+    iree_atomic_task_worker_set_remove(&worker->executor->worker_idle_mask,
+                                       worker->local_worker_index,
+                                       iree_memory_order_relaxed);
 
     // Check state to see if we've been asked to exit.
     if (iree_atomic_load_int32(&worker->state, iree_memory_order_acquire) ==
@@ -309,9 +390,9 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // We've finished all the work we have scheduled so set our idle flag.
     // This ensures that if any other thread comes in and wants to give us
     // work we will properly coordinate/wake below.
-    iree_atomic_task_affinity_set_fetch_or(&worker->executor->worker_idle_mask,
-                                           worker->worker_bit,
-                                           iree_memory_order_relaxed);
+    iree_atomic_task_worker_set_insert(&worker->executor->worker_idle_mask,
+                                       worker->local_worker_index,
+                                       iree_memory_order_relaxed);
 
     // When we encounter a complete lack of work we can self-nominate to check
     // the global work queue and distribute work to other threads. Only one
@@ -326,8 +407,7 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // If nothing has been enqueued since we started this loop (so even
     // coordination didn't find anything) we go idle. Otherwise we fall
     // through and try the loop again.
-    if (schedule_dirty ||
-        !iree_task_queue_is_empty(&worker->local_task_queue)) {
+    if (schedule_dirty || iree_task_worker_has_local_tasks(worker)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
     } else {
@@ -335,10 +415,22 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
       // just using it as a pulse.
       IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
                                   "iree_task_worker_main_pump_wake_wait");
-      iree_notification_commit_wait(
-          &worker->wake_notification, wait_token,
-          /*spin_ns=*/worker->executor->worker_spin_ns,
-          /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+      if (adaptive_spin) {
+        const iree_duration_t spin_ns =
+            iree_task_worker_select_spin_duration(worker);
+        IREE_TRACE_ZONE_APPEND_VALUE(z_wait, (int64_t)spin_ns);
+        const iree_time_t idle_start_ns = iree_time_now();
+        iree_notification_commit_wait(
+            &worker->wake_notification, wait_token, spin_ns,
+            /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+        iree_task_worker_record_idle_duration(
+            worker, iree_time_now() - idle_start_ns);
+      } else {
+        iree_notification_commit_wait(
+            &worker->wake_notification, wait_token,
+            /*spin_ns=*/worker->executor->worker_spin_ns,
+            /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+      }
       IREE_TRACE_ZONE_END(z_wait);
 
       // Woke from a wait - query the processor ID in case we migrated during
@@ -364,6 +456,15 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
   // TODO(benvanik): call this after waking in case CPU hotplugging happens.
   iree_thread_request_affinity(worker->thread, worker->ideal_thread_affinity);
 
+  // Touch our local memory from this thread now that we are pinned so that
+  // first-touch NUMA policies place the pages on our node. The memory is
+  // already zeroed but by writing it here instead of on the executor creation
+  // thread the pages are faulted in locally. Note that our stack is already
+  // allocated lazily by the thread as it is used.
+  if (worker->local_memory.data_length > 0) {
+    memset(worker->local_memory.data, 0, worker->local_memory.data_length);
+  }
+
   // Enter the running state immediately. Note that we could have been requested
   // to exit while suspended/still starting up, so check that here before we
   // mess with any data structures.
@@ -51,18 +51,34 @@ typedef enum iree_task_worker_state_e {
 // A worker within the executor pool.
 //
 // NOTE: fields in here are touched from multiple threads with lock-free
-// techniques. The alignment of the entire iree_task_worker_t as well as the
-// alignment and padding between particular fields is carefully (though perhaps
-// not yet correctly) selected; see the 'LAYOUT' comments below.
-typedef struct iree_task_worker_t {
-  // A LIFO mailbox used by coordinators to post tasks to this worker.
-  // As workers self-nominate to be coordinators and fan out dispatch shards
-  // they can directly emplace those shards into the workers that should execute
-  // them based on the work distribution policy. When workers go to look for
-  // more work after their local queue empties they will flush this list and
-  // move all of the tasks into their local queue and restart processing.
-  // LAYOUT: must be 64b away from local_task_queue.
-  iree_atomic_task_slist_t mailbox_slist;
+// techniques. Fields are grouped by which threads write them and each group
+// starts on its own cache line so that writes to one group don't invalidate
+// the lines holding another. The entire iree_task_worker_t is aligned to the
+// same boundary so that workers stored contiguously in the executor don't
+// share lines either; see the 'LAYOUT' comments below.
+typedef iree_alignas(iree_hardware_destructive_interference_size) struct
+    iree_task_worker_t {
+  //===--------------------------------------------------------------------===//
+  // Written by other threads posting work or changing the worker state.
+  //===--------------------------------------------------------------------===//
+
+  // A bitmask of iree_task_priority_t levels with tasks posted to the mailbox
+  // since the worker last flushed them. Posters set the bit after posting and
+  // the worker clears it prior to flushing the matching mailbox. Dispatch
+  // shards executing at a lower priority poll this to yield to new work.
+  // LAYOUT: next to mailbox_slists as posters touch both together.
+  iree_atomic_int32_t pending_priority_mask;
+
+  // LIFO mailboxes used by coordinators to post tasks to this worker, one per
+  // iree_task_priority_t level. As workers self-nominate to be coordinators and
+  // fan out dispatch shards they can directly emplace those shards into the
+  // workers that should execute them based on the work distribution policy.
+  // When workers go to look for more work after their local queue empties they
+  // will flush these lists and move all of the tasks into their local queues
+  // and restart processing.
+  // LAYOUT: must start in the first cache line, away from the worker-owned
+  //         fields and local_task_queues.
+  iree_atomic_task_slist_t mailbox_slists[IREE_TASK_PRIORITY_COUNT];
 
   // Current state of the worker (iree_task_worker_state_t).
   // LAYOUT: frequent access; next to wake_notification as they are always
@@ -71,33 +87,40 @@ typedef struct iree_task_worker_t {
 
   // Notification signaled when the worker should wake (if it is idle).
   // LAYOUT: next to state for similar access patterns; when posting other
-  //         threads will touch mailbox_slist and then send a wake
+  //         threads will touch mailbox_slists and then send a wake
   //         notification.
   iree_notification_t wake_notification;
 
   // Notification signaled when the worker changes any state.
   iree_notification_t state_notification;
 
+  //===--------------------------------------------------------------------===//
+  // Only written by the worker thread or when the worker is created.
+  //===--------------------------------------------------------------------===//
+
   // Parent executor that can be used to access the global work queue or task
   // pool. Executors always outlive the workers they own.
-  iree_task_executor_t* executor;
+  // LAYOUT: starts the worker-owned cache lines so that posts to the mailbox
+  //         don't invalidate the fields the worker reads while processing.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_task_executor_t* executor;
 
   // Globally unique worker index (worker_base_index + local worker_index).
   iree_host_size_t worker_index;
 
-  // Bit the worker represents in the various worker bitsets.
-  // Local to the executor owning the worker.
-  iree_task_affinity_set_t worker_bit;
+  // Index of the worker within the executor owning it. This is the bit the
+  // worker represents in the various executor worker sets.
+  iree_host_size_t local_worker_index;
 
   // Ideal thread affinity for the worker thread.
   iree_thread_affinity_t ideal_thread_affinity;
 
-  // A bitmask of other group indices that share some level of the cache
-  // hierarchy. Workers of this group are more likely to constructively share
-  // some cache levels higher up with these other groups. For example, if the
-  // workers in a group all share an L2 cache then the groups indicated here may
-  // all share the same L3 cache.
-  iree_task_affinity_set_t constructive_sharing_mask;
+  // Other workers in the executor that share each level of the memory
+  // hierarchy with this worker (iree_task_topology_sharing_level_t), nearest
+  // first. Each worker appears in at most one level. Workers in nearer levels
+  // are more likely to constructively share caches with this worker and are
+  // preferred when stealing.
+  iree_task_worker_set_t sharing_masks[IREE_TASK_TOPOLOGY_SHARING_LEVEL_COUNT];
 
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
@@ -121,37 +144,45 @@ typedef struct iree_task_worker_t {
   // An opaque tag used to reduce the cost of processor ID queries.
   iree_cpu_processor_tag_t processor_tag;
 
-  // Destructive interference padding between the mailbox and local task queue
-  // to ensure that the worker - who is pounding on local_task_queue - doesn't
-  // contend with submissions or coordinators dropping new tasks in the mailbox.
-  //
-  // Today we don't need this, however on 32-bit systems or if we adjust the
-  // size of iree_task_affinity_t/iree_task_affinity_set_t/etc we may need to
-  // add it back.
-  //
-  // NOTE: due to the layout requirements of this structure (to avoid cache
-  // interference) this is the only place padding should be added.
-  // uint8_t _padding[8];
+  // Running estimate of how long the worker remains idle before new work
+  // arrives, used to derive the spin duration when adaptive spinning is
+  // enabled. Only ever touched by the worker thread.
+  iree_duration_t idle_estimate_ns;
 
   // Pointer to local memory available for use exclusively by the worker.
   // The base address should be aligned to avoid false sharing with other
   // workers.
   iree_byte_span_t local_memory;
 
-  // Worker-local FIFO queue containing the tasks that will be processed by the
-  // worker. This queue supports work-stealing by other workers if they run out
-  // of work of their own.
-  // LAYOUT: must be 64b away from mailbox_slist.
-  iree_task_queue_t local_task_queue;
+  //===--------------------------------------------------------------------===//
+  // Written by the worker thread and by other workers stealing tasks.
+  //===--------------------------------------------------------------------===//
+
+  // Worker-local FIFO queues containing the tasks that will be processed by
+  // the worker, one per iree_task_priority_t level. Higher-priority queues are
+  // always drained first. These queues support work-stealing by other workers
+  // if they run out of work of their own.
+  // LAYOUT: on their own cache lines so that thieves locking the queues don't
+  //         contend with posts to mailbox_slists or with the worker-owned
+  //         fields.
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_task_queue_t local_task_queues[IREE_TASK_PRIORITY_COUNT];
 } iree_task_worker_t;
-static_assert(offsetof(iree_task_worker_t, mailbox_slist) +
-                      sizeof(iree_atomic_task_slist_t) <
-                  iree_hardware_constructive_interference_size,
-              "mailbox_slist must be in the first cache line");
-static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
-                  iree_hardware_constructive_interference_size,
-              "local_task_queue must be separated from mailbox_slist by "
-              "at least a cache line");
+static_assert(offsetof(iree_task_worker_t, mailbox_slists) <
+                  iree_hardware_destructive_interference_size,
+              "mailbox_slists must start in the first cache line");
+static_assert(offsetof(iree_task_worker_t, executor) %
+                      iree_hardware_destructive_interference_size ==
+                  0,
+              "worker-owned fields must start on their own cache line");
+static_assert(offsetof(iree_task_worker_t, local_task_queues) %
+                      iree_hardware_destructive_interference_size ==
+                  0,
+              "local_task_queues must start on their own cache line");
+static_assert(sizeof(iree_task_worker_t) %
+                      iree_hardware_destructive_interference_size ==
+                  0,
+              "workers stored contiguously must not share cache lines");
 
 // Initializes a worker by creating its thread and configuring it for receiving
 // tasks. Where supported the worker will be created in a suspended state so
@@ -159,7 +190,7 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
-    const iree_task_topology_group_t* topology_group,
+    const iree_task_topology_t* topology,
     iree_host_size_t stack_size, iree_byte_span_t local_memory,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
 
@@ -184,21 +215,27 @@ void iree_task_worker_await_exit(iree_task_worker_t* worker);
 //  - deinitialize all workers
 void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 
-// Posts a FIFO list of tasks to the worker mailbox. The target worker takes
-// ownership of the tasks and will be woken if it is currently idle.
+// Posts a FIFO list of tasks all with the given |priority| to the worker
+// mailbox. The target worker takes ownership of the tasks and will be woken if
+// it is currently idle. If the worker is executing lower-priority dispatch
+// shards they will yield at their next tile chunk boundary.
 //
 // May be called from any thread (including the worker thread).
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
+                                 iree_task_priority_t priority,
                                  iree_task_list_t* list);
 
-// Tries to steal up to |max_tasks| from the back of the queue.
+// Tries to steal up to |max_tasks| from the back of the highest-priority
+// non-empty queue.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
-// that were at the tail of the worker FIFO will be moved to the |target_queue|
-// and the first of the stolen tasks is returned. While tasks from the FIFO
-// are preferred this may also steal tasks from the mailbox.
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks);
+// that were at the tail of the worker FIFO will be moved to the queue of the
+// same priority in |target_queues| and the first of the stolen tasks is
+// returned. While tasks from the FIFO are preferred this may also steal tasks
+// from the mailbox.
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker,
+    iree_task_queue_t target_queues[IREE_TASK_PRIORITY_COUNT],
+    iree_host_size_t max_tasks);
 
 #ifdef __cplusplus
 }  // extern "C"
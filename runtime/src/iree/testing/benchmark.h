@@ -78,6 +78,13 @@ void iree_benchmark_set_bytes_processed(iree_benchmark_state_t* state,
 void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
                                         int64_t items);
 
+// Adds a counter named |name| reported as |value| divided by the elapsed time
+// in seconds. Counters appear in the report line and in JSON output.
+//
+// REQUIRES: must only be called outside of the benchmark step loop.
+void iree_benchmark_set_rate_counter(iree_benchmark_state_t* state,
+                                     const char* name, double value);
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
@@ -135,6 +142,11 @@ void iree_benchmark_register(iree_string_view_t name,
 // Must be called before any other iree_benchmark_* functions.
 void iree_benchmark_initialize(int* argc, char** argv);
 
+// Adds a |key|/|value| pair to the context reported before all benchmarks and
+// in the "context" object of JSON output.
+// Must be called before iree_benchmark_run_specified.
+void iree_benchmark_add_context(const char* key, const char* value);
+
 // Runs all registered benchmarks specified by the command line flags.
 // Must be called after iree_benchmark_initialize and zero or more benchmarks
 // have been registered with iree_benchmark_register.
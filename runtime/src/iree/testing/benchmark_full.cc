@@ -69,6 +69,12 @@ void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
   s.SetItemsProcessed(items);
 }
 
+void iree_benchmark_set_rate_counter(iree_benchmark_state_t* state,
+                                     const char* name, double value) {
+  auto& s = GetBenchmarkState(state);
+  s.counters[name] = benchmark::Counter(value, benchmark::Counter::kIsRate);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
@@ -187,4 +193,8 @@ void iree_benchmark_initialize(int* argc, char** argv) {
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 }
 
+void iree_benchmark_add_context(const char* key, const char* value) {
+  benchmark::AddCustomContext(key, value);
+}
+
 void iree_benchmark_run_specified(void) { benchmark::RunSpecifiedBenchmarks(); }
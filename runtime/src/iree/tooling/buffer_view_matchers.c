@@ -9,6 +9,7 @@
 #include <math.h>
 
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 
 //===----------------------------------------------------------------------===//
@@ -56,124 +57,183 @@ static iree_status_t iree_hal_append_element_mismatch_string(
   return iree_ok_status();
 }
 
-static bool iree_hal_compare_strided_elements_exact(
-    iree_hal_element_type_t element_type, iree_host_size_t element_count,
-    iree_const_byte_span_t expected_elements, iree_host_size_t expected_stride,
-    iree_const_byte_span_t actual_elements, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  const iree_host_size_t element_size =
-      iree_hal_element_dense_byte_count(element_type);
-  const uint8_t* expected_ptr = expected_elements.data;
-  const uint8_t* actual_ptr = actual_elements.data;
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    int cmp = memcmp(expected_ptr, actual_ptr, element_size);
-    if (cmp != 0) {
-      *out_index = i;
-      return false;
-    }
-    expected_ptr += expected_stride * element_size;
-    actual_ptr += actual_stride * element_size;
+// Number of elements compared per block. Blocks are compared with branch-free
+// kernels that the compiler can vectorize and only blocks containing a mismatch
+// are rescanned to find the exact index.
+#define IREE_HAL_BUFFER_COMPARE_BLOCK_SIZE 4096
+
+// Number of elements processed per worker when computing error statistics.
+// Buffers smaller than this are processed on the calling thread.
+#define IREE_HAL_BUFFER_ELEMENT_STATS_CHUNK_SIZE (1024 * 1024)
+
+// Maximum number of threads used to compute error statistics.
+#define IREE_HAL_BUFFER_ELEMENT_STATS_MAX_WORKERS 8
+
+static inline float iree_hal_bf16_to_f32(uint16_t value) {
+  uint32_t bits = (uint32_t)value << 16;
+  float result = 0.0f;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+// Returns the number of elements in [0, |count|) that do not match. Expected
+// elements are read with |expected_stride| (0 for broadcasts or 1) while actual
+// elements are always contiguous.
+typedef iree_host_size_t (*iree_hal_count_mismatches_fn_t)(
+    double threshold, iree_host_size_t count, const void* expected,
+    iree_host_size_t expected_stride, const void* actual);
+
+#define IREE_HAL_DEFINE_COUNT_MISMATCHES_EXACT(bits)                         \
+  static iree_host_size_t iree_hal_count_mismatches_exact_##bits(           \
+      double threshold, iree_host_size_t count, const void* expected_ptr,   \
+      iree_host_size_t expected_stride, const void* actual_ptr) {           \
+    const uint##bits##_t* expected = (const uint##bits##_t*)expected_ptr;   \
+    const uint##bits##_t* actual = (const uint##bits##_t*)actual_ptr;       \
+    iree_host_size_t mismatch_count = 0;                                    \
+    if (expected_stride == 0) {                                             \
+      const uint##bits##_t value = expected[0];                             \
+      for (iree_host_size_t i = 0; i < count; ++i) {                        \
+        mismatch_count += actual[i] != value;                               \
+      }                                                                     \
+    } else {                                                                \
+      for (iree_host_size_t i = 0; i < count; ++i) {                        \
+        mismatch_count += actual[i] != expected[i];                         \
+      }                                                                     \
+    }                                                                       \
+    return mismatch_count;                                                  \
   }
-  return true;
-}
-
-static bool iree_hal_compare_strided_elements_approximate_absolute_f16(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const uint16_t* expected_ptr, iree_host_size_t expected_stride,
-    const uint16_t* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(iree_math_f16_to_f32(*expected_ptr) -
-              iree_math_f16_to_f32(*actual_ptr)) > equality.f16_threshold) {
-      *out_index = i;
-      return false;
-    }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
+IREE_HAL_DEFINE_COUNT_MISMATCHES_EXACT(8)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_EXACT(16)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_EXACT(32)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_EXACT(64)
+
+// NOTE: NaN differences compare as matching to preserve the historical
+// abs(a - b) <= threshold behavior.
+#define IREE_HAL_DEFINE_COUNT_MISMATCHES_APPROXIMATE(name, storage_t,        \
+                                                     compute_t, load, abs)  \
+  static iree_host_size_t iree_hal_count_mismatches_approximate_##name(     \
+      double threshold, iree_host_size_t count, const void* expected_ptr,   \
+      iree_host_size_t expected_stride, const void* actual_ptr) {           \
+    const storage_t* expected = (const storage_t*)expected_ptr;             \
+    const storage_t* actual = (const storage_t*)actual_ptr;                 \
+    const compute_t typed_threshold = (compute_t)threshold;                 \
+    iree_host_size_t mismatch_count = 0;                                    \
+    if (expected_stride == 0) {                                             \
+      const compute_t value = load(expected[0]);                            \
+      for (iree_host_size_t i = 0; i < count; ++i) {                        \
+        mismatch_count += abs(load(actual[i]) - value) > typed_threshold;   \
+      }                                                                     \
+    } else {                                                                \
+      for (iree_host_size_t i = 0; i < count; ++i) {                        \
+        mismatch_count +=                                                   \
+            abs(load(actual[i]) - load(expected[i])) > typed_threshold;     \
+      }                                                                     \
+    }                                                                       \
+    return mismatch_count;                                                  \
   }
-  return true;
-}
-
-static bool iree_hal_compare_strided_elements_approximate_absolute_f32(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const float* expected_ptr, iree_host_size_t expected_stride,
-    const float* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(*expected_ptr - *actual_ptr) > equality.f32_threshold) {
-      *out_index = i;
-      return false;
+#define IREE_HAL_LOAD_IDENTITY(value) (value)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_APPROXIMATE(f16, uint16_t, float,
+                                             iree_math_f16_to_f32, fabsf)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_APPROXIMATE(bf16, uint16_t, float,
+                                             iree_hal_bf16_to_f32, fabsf)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_APPROXIMATE(f32, float, float,
+                                             IREE_HAL_LOAD_IDENTITY, fabsf)
+IREE_HAL_DEFINE_COUNT_MISMATCHES_APPROXIMATE(f64, double, double,
+                                             IREE_HAL_LOAD_IDENTITY, fabs)
+
+// Selects the kernel used to compare elements of |element_type|.
+// Returns NULL if the element type is not a power-of-two byte size and must be
+// compared with memcmp.
+static iree_hal_count_mismatches_fn_t iree_hal_select_count_mismatches_fn(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    double* out_threshold) {
+  *out_threshold = 0.0;
+  if (equality.mode == IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE) {
+    switch (element_type) {
+      case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+        *out_threshold = equality.f16_threshold;
+        return iree_hal_count_mismatches_approximate_f16;
+      case IREE_HAL_ELEMENT_TYPE_BFLOAT_16:
+        *out_threshold = equality.f16_threshold;
+        return iree_hal_count_mismatches_approximate_bf16;
+      case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+        *out_threshold = equality.f32_threshold;
+        return iree_hal_count_mismatches_approximate_f32;
+      case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+        *out_threshold = equality.f64_threshold;
+        return iree_hal_count_mismatches_approximate_f64;
+      default:
+        break;  // exact
     }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
   }
-  return true;
+  if (!iree_hal_element_is_byte_aligned(element_type)) return NULL;
+  switch (iree_hal_element_dense_byte_count(element_type)) {
+    case 1:
+      return iree_hal_count_mismatches_exact_8;
+    case 2:
+      return iree_hal_count_mismatches_exact_16;
+    case 4:
+      return iree_hal_count_mismatches_exact_32;
+    case 8:
+      return iree_hal_count_mismatches_exact_64;
+    default:
+      return NULL;
+  }
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f64(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const double* expected_ptr, iree_host_size_t expected_stride,
-    const double* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
+static bool iree_hal_compare_strided_elements_memcmp(
+    iree_host_size_t element_size, iree_host_size_t element_count,
+    const uint8_t* expected_ptr, iree_host_size_t expected_stride,
+    const uint8_t* actual_ptr, iree_host_size_t* out_index) {
   for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabs(*expected_ptr - *actual_ptr) > equality.f64_threshold) {
+    if (memcmp(expected_ptr, actual_ptr, element_size) != 0) {
       *out_index = i;
       return false;
     }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
+    expected_ptr += expected_stride * element_size;
+    actual_ptr += element_size;
   }
   return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute(
-    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
-    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
-    iree_host_size_t expected_stride, iree_const_byte_span_t actual_elements,
-    iree_host_size_t actual_stride, iree_host_size_t* out_index) {
-  switch (element_type) {
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
-      return iree_hal_compare_strided_elements_approximate_absolute_f16(
-          equality, element_count, (const uint16_t*)expected_elements.data,
-          expected_stride, (const uint16_t*)actual_elements.data, actual_stride,
-          out_index);
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
-      return iree_hal_compare_strided_elements_approximate_absolute_f32(
-          equality, element_count, (const float*)expected_elements.data,
-          expected_stride, (const float*)actual_elements.data, actual_stride,
-          out_index);
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
-      return iree_hal_compare_strided_elements_approximate_absolute_f64(
-          equality, element_count, (const double*)expected_elements.data,
-          expected_stride, (const double*)actual_elements.data, actual_stride,
-          out_index);
-    default:
-      return iree_hal_compare_strided_elements_exact(
-          element_type, element_count, expected_elements, expected_stride,
-          actual_elements, actual_stride, out_index);
-  }
-}
-
 // Compares two buffers element by element.
-// The provided strides (in elements) are applied up to |element_count|.
+// The expected stride (in elements) is either 0 for broadcasts or 1.
 static bool iree_hal_compare_strided_elements(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_host_size_t expected_stride, iree_const_byte_span_t actual_elements,
-    iree_host_size_t actual_stride, iree_host_size_t* out_index) {
-  switch (equality.mode) {
-    case IREE_HAL_BUFFER_EQUALITY_EXACT:
-      return iree_hal_compare_strided_elements_exact(
-          element_type, element_count, expected_elements, expected_stride,
-          actual_elements, actual_stride, out_index);
-    case IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE:
-      return iree_hal_compare_strided_elements_approximate_absolute(
-          equality, element_type, element_count, expected_elements,
-          expected_stride, actual_elements, actual_stride, out_index);
-    default:
-      IREE_ASSERT(false && "unhandled equality mode");
-      return false;
+    iree_host_size_t* out_index) {
+  const iree_host_size_t element_size =
+      iree_hal_element_dense_byte_count(element_type);
+  double threshold = 0.0;
+  iree_hal_count_mismatches_fn_t count_mismatches =
+      iree_hal_select_count_mismatches_fn(equality, element_type, &threshold);
+  if (!count_mismatches) {
+    return iree_hal_compare_strided_elements_memcmp(
+        element_size, element_count, expected_elements.data, expected_stride,
+        actual_elements.data, out_index);
+  }
+  for (iree_host_size_t base = 0; base < element_count;
+       base += IREE_HAL_BUFFER_COMPARE_BLOCK_SIZE) {
+    const iree_host_size_t block_count =
+        iree_min(IREE_HAL_BUFFER_COMPARE_BLOCK_SIZE, element_count - base);
+    const uint8_t* expected_ptr =
+        expected_elements.data + base * expected_stride * element_size;
+    const uint8_t* actual_ptr = actual_elements.data + base * element_size;
+    if (IREE_LIKELY(count_mismatches(threshold, block_count, expected_ptr,
+                                     expected_stride, actual_ptr) == 0)) {
+      continue;
+    }
+    for (iree_host_size_t i = 0; i < block_count; ++i) {
+      if (count_mismatches(threshold, 1,
+                           expected_ptr + i * expected_stride * element_size,
+                           expected_stride, actual_ptr + i * element_size)) {
+        *out_index = base + i;
+        return false;
+      }
+    }
   }
+  return true;
 }
 
 bool iree_hal_compare_buffer_elements_broadcast(
@@ -185,7 +245,7 @@ bool iree_hal_compare_buffer_elements_broadcast(
       iree_make_const_byte_span(
           expected_element.storage,
           iree_hal_element_dense_byte_count(expected_element.type)),
-      /*expected_stride=*/0, actual_elements, /*actual_stride=*/1, out_index);
+      /*expected_stride=*/0, actual_elements, out_index);
 }
 
 bool iree_hal_compare_buffer_elements_elementwise(
@@ -194,7 +254,283 @@ bool iree_hal_compare_buffer_elements_elementwise(
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index) {
   return iree_hal_compare_strided_elements(
       equality, element_type, element_count, expected_elements,
-      /*expected_stride=*/1, actual_elements, /*actual_stride=*/1, out_index);
+      /*expected_stride=*/1, actual_elements, out_index);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_element_stats_t
+//===----------------------------------------------------------------------===//
+
+// Loads the element at |ptr| as a double for error computation and as an
+// integer ordinal where adjacent representable values differ by 1 (ULPs for
+// floating-point types).
+static void iree_hal_load_element_for_stats(
+    iree_hal_element_type_t element_type, const uint8_t* ptr,
+    double* out_value, int64_t* out_ordinal) {
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+    case IREE_HAL_ELEMENT_TYPE_BFLOAT_16: {
+      int16_t bits = 0;
+      memcpy(&bits, ptr, sizeof(bits));
+      *out_value = element_type == IREE_HAL_ELEMENT_TYPE_FLOAT_16
+                       ? iree_math_f16_to_f32((uint16_t)bits)
+                       : iree_hal_bf16_to_f32((uint16_t)bits);
+      *out_ordinal = bits < 0 ? (int64_t)INT16_MIN - bits : bits;
+      return;
+    }
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32: {
+      float value = 0.0f;
+      int32_t bits = 0;
+      memcpy(&value, ptr, sizeof(value));
+      memcpy(&bits, ptr, sizeof(bits));
+      *out_value = value;
+      *out_ordinal = bits < 0 ? (int64_t)INT32_MIN - bits : bits;
+      return;
+    }
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64: {
+      double value = 0.0;
+      int64_t bits = 0;
+      memcpy(&value, ptr, sizeof(value));
+      memcpy(&bits, ptr, sizeof(bits));
+      *out_value = value;
+      *out_ordinal = bits < 0 ? INT64_MIN - bits : bits;
+      return;
+    }
+    default:
+      break;
+  }
+  const bool is_unsigned = iree_hal_element_numerical_type_is_integer(
+                               element_type) &&
+                           iree_hal_element_numerical_type(element_type) ==
+                               IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED;
+  int64_t value = 0;
+  switch (iree_hal_element_dense_byte_count(element_type)) {
+    case 1:
+      value = is_unsigned ? (int64_t) * (const uint8_t*)ptr
+                          : (int64_t) * (const int8_t*)ptr;
+      break;
+    case 2: {
+      uint16_t bits = 0;
+      memcpy(&bits, ptr, sizeof(bits));
+      value = is_unsigned ? (int64_t)bits : (int64_t)(int16_t)bits;
+      break;
+    }
+    case 4: {
+      uint32_t bits = 0;
+      memcpy(&bits, ptr, sizeof(bits));
+      value = is_unsigned ? (int64_t)bits : (int64_t)(int32_t)bits;
+      break;
+    }
+    case 8:
+      memcpy(&value, ptr, sizeof(value));
+      break;
+    default:
+      break;
+  }
+  *out_value = (double)value;
+  *out_ordinal = value;
+}
+
+typedef struct iree_hal_buffer_element_stats_chunk_t {
+  iree_hal_count_mismatches_fn_t count_mismatches;
+  double threshold;
+  iree_hal_element_type_t element_type;
+  iree_host_size_t element_size;
+  iree_host_size_t base_index;
+  iree_host_size_t element_count;
+  const uint8_t* expected_ptr;
+  const uint8_t* actual_ptr;
+  iree_hal_buffer_element_stats_t stats;
+} iree_hal_buffer_element_stats_chunk_t;
+
+static void iree_hal_buffer_element_stats_reset(
+    iree_host_size_t element_count, iree_hal_buffer_element_stats_t* stats) {
+  memset(stats, 0, sizeof(*stats));
+  stats->element_count = element_count;
+  stats->first_mismatch_index = element_count;
+}
+
+static int iree_hal_buffer_element_stats_chunk_run(void* arg) {
+  iree_hal_buffer_element_stats_chunk_t* chunk =
+      (iree_hal_buffer_element_stats_chunk_t*)arg;
+  iree_hal_buffer_element_stats_t* stats = &chunk->stats;
+  iree_hal_buffer_element_stats_reset(chunk->element_count, stats);
+  for (iree_host_size_t i = 0; i < chunk->element_count; ++i) {
+    const uint8_t* expected_ptr = chunk->expected_ptr + i * chunk->element_size;
+    const uint8_t* actual_ptr = chunk->actual_ptr + i * chunk->element_size;
+    const iree_host_size_t index = chunk->base_index + i;
+    if (chunk->count_mismatches(chunk->threshold, 1, expected_ptr, 1,
+                                actual_ptr)) {
+      if (stats->mismatch_count++ == 0) stats->first_mismatch_index = index;
+    }
+    double expected_value = 0.0, actual_value = 0.0;
+    int64_t expected_ordinal = 0, actual_ordinal = 0;
+    iree_hal_load_element_for_stats(chunk->element_type, expected_ptr,
+                                    &expected_value, &expected_ordinal);
+    iree_hal_load_element_for_stats(chunk->element_type, actual_ptr,
+                                    &actual_value, &actual_ordinal);
+    const double abs_error = fabs(expected_value - actual_value);
+    if (abs_error > stats->max_abs_error) {
+      stats->max_abs_error = abs_error;
+      stats->max_abs_error_index = index;
+    }
+    if (expected_value != 0.0) {
+      stats->max_rel_error =
+          fmax(stats->max_rel_error, abs_error / fabs(expected_value));
+    }
+    const uint64_t distance =
+        expected_ordinal > actual_ordinal
+            ? (uint64_t)expected_ordinal - (uint64_t)actual_ordinal
+            : (uint64_t)actual_ordinal - (uint64_t)expected_ordinal;
+    const int bucket =
+        distance ? 64 - iree_math_count_leading_zeros_u64(distance) : 0;
+    ++stats->ulp_histogram[iree_min(
+        bucket, IREE_HAL_BUFFER_ELEMENT_STATS_ULP_BUCKET_COUNT - 1)];
+  }
+  return 0;
+}
+
+// Merges |chunk_stats| of a chunk following all chunks already in |stats|.
+static void iree_hal_buffer_element_stats_merge(
+    const iree_hal_buffer_element_stats_t* chunk_stats,
+    iree_hal_buffer_element_stats_t* stats) {
+  if (stats->mismatch_count == 0 && chunk_stats->mismatch_count > 0) {
+    stats->first_mismatch_index = chunk_stats->first_mismatch_index;
+  }
+  stats->mismatch_count += chunk_stats->mismatch_count;
+  if (chunk_stats->max_abs_error > stats->max_abs_error) {
+    stats->max_abs_error = chunk_stats->max_abs_error;
+    stats->max_abs_error_index = chunk_stats->max_abs_error_index;
+  }
+  stats->max_rel_error = fmax(stats->max_rel_error, chunk_stats->max_rel_error);
+  for (iree_host_size_t i = 0; i < IREE_HAL_BUFFER_ELEMENT_STATS_ULP_BUCKET_COUNT;
+       ++i) {
+    stats->ulp_histogram[i] += chunk_stats->ulp_histogram[i];
+  }
+}
+
+iree_status_t iree_hal_compute_buffer_element_stats(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_allocator_t host_allocator,
+    iree_hal_buffer_element_stats_t* out_stats) {
+  IREE_ASSERT_ARGUMENT(out_stats);
+  iree_hal_buffer_element_stats_reset(element_count, out_stats);
+  const iree_host_size_t element_size =
+      iree_hal_element_dense_byte_count(element_type);
+  if (expected_elements.data_length < element_count * element_size ||
+      actual_elements.data_length < element_count * element_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "element count %" PRIhsz
+                            " exceeds the provided buffer contents",
+                            element_count);
+  }
+  double threshold = 0.0;
+  iree_hal_count_mismatches_fn_t count_mismatches =
+      iree_hal_select_count_mismatches_fn(equality, element_type, &threshold);
+  const bool is_real_float =
+      iree_hal_element_numerical_type_is_float(element_type) &&
+      !iree_hal_element_numerical_type_is_complex_float(element_type);
+  const bool is_integer =
+      iree_hal_element_numerical_type_is_integer(element_type) ||
+      iree_hal_element_numerical_type_is_boolean(element_type);
+  if (!count_mismatches || !(is_real_float || is_integer)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "error statistics unsupported for element type");
+  }
+  if (element_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, element_count);
+
+  // Split the work into contiguous chunks with one thread per chunk. The first
+  // chunk is processed on the calling thread and any chunk that fails to get a
+  // thread is processed inline as well.
+  const iree_host_size_t chunk_count =
+      iree_max(1, iree_min(IREE_HAL_BUFFER_ELEMENT_STATS_MAX_WORKERS,
+                           element_count /
+                               IREE_HAL_BUFFER_ELEMENT_STATS_CHUNK_SIZE));
+  const iree_host_size_t chunk_size =
+      (element_count + chunk_count - 1) / chunk_count;
+  iree_hal_buffer_element_stats_chunk_t
+      chunks[IREE_HAL_BUFFER_ELEMENT_STATS_MAX_WORKERS];
+  iree_thread_t* threads[IREE_HAL_BUFFER_ELEMENT_STATS_MAX_WORKERS] = {NULL};
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    iree_hal_buffer_element_stats_chunk_t* chunk = &chunks[i];
+    chunk->count_mismatches = count_mismatches;
+    chunk->threshold = threshold;
+    chunk->element_type = element_type;
+    chunk->element_size = element_size;
+    chunk->base_index = i * chunk_size;
+    chunk->element_count =
+        iree_min(chunk_size, element_count - chunk->base_index);
+    chunk->expected_ptr =
+        expected_elements.data + chunk->base_index * element_size;
+    chunk->actual_ptr = actual_elements.data + chunk->base_index * element_size;
+  }
+  for (iree_host_size_t i = 1; i < chunk_count; ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-compare-worker");
+    iree_status_t status =
+        iree_thread_create(iree_hal_buffer_element_stats_chunk_run, &chunks[i],
+                           params, host_allocator, &threads[i]);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      threads[i] = NULL;
+      iree_hal_buffer_element_stats_chunk_run(&chunks[i]);
+    }
+  }
+  iree_hal_buffer_element_stats_chunk_run(&chunks[0]);
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    iree_thread_release(threads[i]);  // joins
+    iree_hal_buffer_element_stats_merge(&chunks[i].stats, out_stats);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_append_buffer_element_stats_string(
+    const iree_hal_buffer_element_stats_t* stats,
+    iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "%" PRIhsz " of %" PRIhsz
+      " elements mismatched; max abs error %g at index %" PRIhsz
+      ", max rel error %g, log2 ULP distance histogram [",
+      stats->mismatch_count, stats->element_count, stats->max_abs_error,
+      stats->max_abs_error_index, stats->max_rel_error));
+  // Trim trailing empty buckets to keep the report short.
+  iree_host_size_t bucket_count = IREE_HAL_BUFFER_ELEMENT_STATS_ULP_BUCKET_COUNT;
+  while (bucket_count > 1 && stats->ulp_histogram[bucket_count - 1] == 0) {
+    --bucket_count;
+  }
+  for (iree_host_size_t i = 0; i < bucket_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, i ? ", %" PRIhsz : "%" PRIhsz, stats->ulp_histogram[i]));
+  }
+  return iree_string_builder_append_string(builder, IREE_SV("]"));
+}
+
+// Appends "; <stats>" describing all mismatches between the two buffers.
+static iree_status_t iree_hal_append_elementwise_mismatch_stats_string(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_string_builder_t* builder) {
+  iree_hal_buffer_element_stats_t stats;
+  iree_status_t status = iree_hal_compute_buffer_element_stats(
+      equality, element_type, element_count, expected_elements,
+      actual_elements, iree_allocator_system(), &stats);
+  if (iree_status_is_unimplemented(status)) {
+    // Element types without kernels (sub-byte/complex) only get the first
+    // mismatch reported.
+    iree_status_ignore(status);
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(status);
+  IREE_RETURN_IF_ERROR(
+      iree_string_builder_append_string(builder, IREE_SV("; ")));
+  return iree_hal_append_buffer_element_stats_string(&stats, builder);
 }
 
 //===----------------------------------------------------------------------===//
@@ -511,18 +847,26 @@ iree_status_t iree_hal_buffer_view_array_matcher_match(
       matcher->equality, iree_hal_buffer_view_element_type(matchee),
       iree_hal_buffer_view_element_count(matchee), matcher->elements,
       actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), matcher->elements, i);
-
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
-
+  iree_status_t status = iree_ok_status();
   if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+    iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
+        iree_hal_buffer_view_element_type(matchee), actual_contents, i);
+    iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
+        iree_hal_buffer_view_element_type(matchee), matcher->elements, i);
+    status = iree_hal_append_element_mismatch_string(i, expected_element,
+                                                     actual_element, builder);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_append_elementwise_mismatch_stats_string(
+          matcher->equality, iree_hal_buffer_view_element_type(matchee),
+          iree_hal_buffer_view_element_count(matchee), matcher->elements,
+          actual_contents, builder);
+    }
   }
 
+  status = iree_status_join(status,
+                            iree_hal_buffer_unmap_range(&actual_mapping));
+  IREE_RETURN_IF_ERROR(status);
+
   *out_matched = all_match;
   return iree_ok_status();
 }
@@ -626,19 +970,27 @@ iree_status_t iree_hal_buffer_view_matcher_match(
       matcher->equality, iree_hal_buffer_view_element_type(matchee),
       iree_hal_buffer_view_element_count(matchee), expected_contents,
       actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), expected_contents, i);
-
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&expected_mapping));
-
   if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+    iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
+        iree_hal_buffer_view_element_type(matchee), actual_contents, i);
+    iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
+        iree_hal_buffer_view_element_type(matchee), expected_contents, i);
+    status = iree_hal_append_element_mismatch_string(i, expected_element,
+                                                     actual_element, builder);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_append_elementwise_mismatch_stats_string(
+          matcher->equality, iree_hal_buffer_view_element_type(matchee),
+          iree_hal_buffer_view_element_count(matchee), expected_contents,
+          actual_contents, builder);
+    }
   }
 
+  status = iree_status_join(status,
+                            iree_hal_buffer_unmap_range(&actual_mapping));
+  status = iree_status_join(status,
+                            iree_hal_buffer_unmap_range(&expected_mapping));
+  IREE_RETURN_IF_ERROR(status);
+
   *out_matched = all_match;
   return iree_ok_status();
 }
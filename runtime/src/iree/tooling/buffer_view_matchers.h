@@ -48,6 +48,7 @@ typedef struct {
   // TODO(benvanik): allow override in approximate modes (ULP, abs/rel diff).
   // For now we just have some hardcoded types that are used in place of
   // compile-time constants. Consider these provisional.
+  // f16_threshold is also used for bf16.
   float f16_threshold;
   float f32_threshold;
   double f64_threshold;
@@ -137,6 +138,48 @@ bool iree_hal_compare_buffer_elements_elementwise(
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_element_stats_t
+//===----------------------------------------------------------------------===//
+
+// Number of buckets in iree_hal_buffer_element_stats_t::ulp_histogram.
+#define IREE_HAL_BUFFER_ELEMENT_STATS_ULP_BUCKET_COUNT 24
+
+// Aggregate error statistics of an elementwise comparison.
+typedef struct {
+  // Total number of elements compared.
+  iree_host_size_t element_count;
+  // Number of elements that do not match based on the equality used.
+  iree_host_size_t mismatch_count;
+  // Index of the first mismatching element or element_count if none.
+  iree_host_size_t first_mismatch_index;
+  // Maximum abs(expected - actual) and the first index it occurs at.
+  double max_abs_error;
+  iree_host_size_t max_abs_error_index;
+  // Maximum abs(expected - actual) / abs(expected) where expected is nonzero.
+  double max_rel_error;
+  // Histogram of the distance between expected and actual values in units in
+  // the last place (or integer steps for integer types). Bucket 0 counts exact
+  // matches and bucket i counts distances in [2^(i-1), 2^i) with the last
+  // bucket also counting all larger distances.
+  iree_host_size_t ulp_histogram[IREE_HAL_BUFFER_ELEMENT_STATS_ULP_BUCKET_COUNT];
+} iree_hal_buffer_element_stats_t;
+
+// Computes error statistics over all |element_count| elements.
+// Large buffers are split into chunks processed on multiple threads allocated
+// from |host_allocator|. Returns IREE_STATUS_UNIMPLEMENTED for element types
+// that are not byte-aligned integers or real floating-point values.
+iree_status_t iree_hal_compute_buffer_element_stats(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_allocator_t host_allocator,
+    iree_hal_buffer_element_stats_t* out_stats);
+
+// Appends a human-readable summary of |stats| to |builder|.
+iree_status_t iree_hal_append_buffer_element_stats_string(
+    const iree_hal_buffer_element_stats_t* stats,
+    iree_string_builder_t* builder);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
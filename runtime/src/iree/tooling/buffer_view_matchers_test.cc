@@ -6,6 +6,8 @@
 
 #include "iree/tooling/buffer_view_matchers.h"
 
+#include <vector>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/internal/span.h"
@@ -410,6 +412,103 @@ TEST_F(BufferViewMatchersTest, CompareElementwiseF64NE) {
   EXPECT_EQ(index, 1);
 }
 
+TEST_F(BufferViewMatchersTest, CompareElementwiseBF16NE) {
+  // 1.0, 2.0, 4.0 vs 1.0, 3.0, 4.0 in bf16.
+  const uint16_t lhs[] = {0x3F80, 0x4000, 0x4080};
+  const uint16_t rhs[] = {0x3F80, 0x4040, 0x4080};
+  iree_host_size_t index = 0;
+  EXPECT_TRUE(iree_hal_compare_buffer_elements_elementwise(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_BFLOAT_16,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(lhs, sizeof(lhs)), &index));
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_BFLOAT_16,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+  EXPECT_EQ(index, 1);
+}
+
+// Tests that mismatches are found across and within comparison blocks.
+TEST_F(BufferViewMatchersTest, CompareElementwiseLargeF32NE) {
+  std::vector<float> lhs(100000, 1.0f);
+  std::vector<float> rhs = lhs;
+  rhs[54321] = 2.0f;
+  rhs[99999] = 3.0f;
+  iree_host_size_t index = 0;
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, lhs.size(),
+      iree_make_const_byte_span(lhs.data(), lhs.size() * sizeof(float)),
+      iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(float)),
+      &index));
+  EXPECT_EQ(index, 54321);
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_broadcast(
+      kExactEquality, iree_hal_make_buffer_element_f32(1.0f), rhs.size(),
+      iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(float)),
+      &index));
+  EXPECT_EQ(index, 54321);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_element_stats_t
+//===----------------------------------------------------------------------===//
+
+TEST_F(BufferViewMatchersTest, ElementStatsF32) {
+  const float lhs[] = {1.0f, 2.0f, 4.0f, 8.0f};
+  const float rhs[] = {1.0f, 2.00001f, 5.0f, 4.0f};
+  iree_hal_buffer_element_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compute_buffer_element_stats(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), iree_allocator_system(),
+      &stats));
+  EXPECT_EQ(stats.element_count, 4);
+  EXPECT_EQ(stats.mismatch_count, 2);
+  EXPECT_EQ(stats.first_mismatch_index, 2);
+  EXPECT_EQ(stats.max_abs_error, 4.0);
+  EXPECT_EQ(stats.max_abs_error_index, 3);
+  EXPECT_EQ(stats.max_rel_error, 0.5);
+  EXPECT_EQ(stats.ulp_histogram[0], 1);
+  auto sb = StringBuilder::MakeSystem();
+  IREE_ASSERT_OK(iree_hal_append_buffer_element_stats_string(&stats, sb));
+  EXPECT_THAT(sb.ToString(), HasSubstr("2 of 4 elements mismatched"));
+}
+
+TEST_F(BufferViewMatchersTest, ElementStatsI8) {
+  const int8_t lhs[] = {-1, 2, 3};
+  const int8_t rhs[] = {1, 2, 3};
+  iree_hal_buffer_element_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compute_buffer_element_stats(
+      kExactEquality, IREE_HAL_ELEMENT_TYPE_SINT_8, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), iree_allocator_system(),
+      &stats));
+  EXPECT_EQ(stats.mismatch_count, 1);
+  EXPECT_EQ(stats.first_mismatch_index, 0);
+  EXPECT_EQ(stats.max_abs_error, 2.0);
+  EXPECT_EQ(stats.ulp_histogram[0], 2);
+  EXPECT_EQ(stats.ulp_histogram[2], 1);  // distance 2 in [2, 4)
+}
+
+// Tests that statistics computed across multiple worker chunks are merged.
+TEST_F(BufferViewMatchersTest, ElementStatsLargeF32) {
+  std::vector<float> lhs(5 * 1024 * 1024, 1.0f);
+  std::vector<float> rhs = lhs;
+  rhs[3 * 1024 * 1024 + 7] = 1.5f;
+  rhs[4 * 1024 * 1024 + 1] = 3.0f;
+  rhs[5 * 1024 * 1024 - 1] = 1.25f;
+  iree_hal_buffer_element_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compute_buffer_element_stats(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, lhs.size(),
+      iree_make_const_byte_span(lhs.data(), lhs.size() * sizeof(float)),
+      iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(float)),
+      iree_allocator_system(), &stats));
+  EXPECT_EQ(stats.mismatch_count, 3);
+  EXPECT_EQ(stats.first_mismatch_index, 3 * 1024 * 1024 + 7);
+  EXPECT_EQ(stats.max_abs_error, 2.0);
+  EXPECT_EQ(stats.max_abs_error_index, 4 * 1024 * 1024 + 1);
+  EXPECT_EQ(stats.ulp_histogram[0], lhs.size() - 3);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
@@ -597,6 +696,7 @@ TEST_F(BufferViewMatchersTest, MismatchArrayContentsI32) {
       &match));
   EXPECT_FALSE(match);
   EXPECT_THAT(sb.ToString(), HasSubstr("element at index 1"));
+  EXPECT_THAT(sb.ToString(), HasSubstr("2 of 3 elements mismatched"));
 }
 
 //===----------------------------------------------------------------------===//
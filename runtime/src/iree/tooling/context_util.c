@@ -12,11 +12,14 @@
 
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/slab_allocator.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/loaders/registration/init.h"
+#include "iree/io/parameter_archive.h"
 #include "iree/modules/hal/inline/module.h"
 #include "iree/modules/hal/loader/module.h"
 #include "iree/modules/hal/module.h"
+#include "iree/modules/io/parameters/module.h"
 #include "iree/tooling/device_util.h"
 #include "iree/vm/bytecode/module.h"
 
@@ -24,6 +27,49 @@
 #include "iree/modules/vmvx/module.h"
 #endif  // IREE_HAVE_VMVX_MODULE
 
+//===----------------------------------------------------------------------===//
+// Host allocator selection
+//===----------------------------------------------------------------------===//
+
+static iree_allocator_ctl_fn_t iree_tooling_host_allocator_ctl =
+    iree_allocator_system_ctl;
+
+static iree_status_t iree_tooling_parse_host_allocator_flag(
+    iree_string_view_t flag_name, void* storage, iree_string_view_t value) {
+  iree_allocator_ctl_fn_t* ctl = (iree_allocator_ctl_fn_t*)storage;
+  if (iree_string_view_equal(value, IREE_SV("system"))) {
+    *ctl = iree_allocator_system_ctl;
+  } else if (iree_string_view_equal(value, IREE_SV("slab"))) {
+    *ctl = iree_allocator_slab_ctl;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown host allocator '%.*s'; expected 'system' "
+                            "or 'slab'",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+static void iree_tooling_print_host_allocator_flag(iree_string_view_t flag_name,
+                                                   void* storage, FILE* file) {
+  iree_allocator_ctl_fn_t ctl = *(iree_allocator_ctl_fn_t*)storage;
+  fprintf(file, "--%.*s=%s\n", (int)flag_name.size, flag_name.data,
+          ctl == iree_allocator_slab_ctl ? "slab" : "system");
+}
+
+IREE_FLAG_CALLBACK(
+    iree_tooling_parse_host_allocator_flag,
+    iree_tooling_print_host_allocator_flag, &iree_tooling_host_allocator_ctl,
+    host_allocator,
+    "Host allocator used for runtime data structures:\n"
+    "  system: the system allocator (malloc/free).\n"
+    "  slab: a thread-caching size-class allocator for small objects.");
+
+iree_allocator_t iree_tooling_host_allocator(void) {
+  iree_allocator_t allocator = {NULL, iree_tooling_host_allocator_ctl};
+  return allocator;
+}
+
 //===----------------------------------------------------------------------===//
 // Module loading
 //===----------------------------------------------------------------------===//
@@ -45,8 +91,8 @@ iree_status_t iree_tooling_load_module_from_flags(
   IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_module);
 
   // Fetch the file contents into memory.
-  // We could map the memory here if we wanted to and were coming from a file
-  // on disk.
+  // When coming from a file on disk we map it so that module load only pays
+  // for the pages actually touched instead of reading the whole file.
   iree_file_contents_t* file_contents = NULL;
   if (strcmp(FLAG_module, "-") == 0) {
     // Reading from stdin. We print it out here because people often get
@@ -57,7 +103,8 @@ iree_status_t iree_tooling_load_module_from_flags(
   } else {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0,
-        iree_file_read_contents(FLAG_module, host_allocator, &file_contents));
+        iree_file_read_contents(FLAG_module, IREE_FILE_READ_FLAG_MMAP,
+                                host_allocator, &file_contents));
   }
 
   // Try to load the module as bytecode (all we have today that we can use).
@@ -81,6 +128,10 @@ iree_status_t iree_tooling_load_module_from_flags(
 // HAL execution model management
 //===----------------------------------------------------------------------===//
 
+IREE_FLAG(bool, hal_validate_command_buffers, false,
+          "Validates compiler-generated command buffers that would otherwise "
+          "skip validation (if validation is enabled in the build).");
+
 static iree_status_t iree_tooling_load_hal_async_module(
     iree_vm_instance_t* instance, iree_string_view_t default_device_uri,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module,
@@ -121,6 +172,9 @@ static iree_status_t iree_tooling_load_hal_async_module(
 
   // Create HAL module wrapping the device created above.
   iree_hal_module_flags_t flags = IREE_HAL_MODULE_FLAG_NONE;
+  if (FLAG_hal_validate_command_buffers) {
+    flags |= IREE_HAL_MODULE_FLAG_VALIDATE_COMMAND_BUFFERS;
+  }
   iree_vm_module_t* module = NULL;
   iree_status_t status =
       iree_hal_module_create(instance, device, flags, host_allocator, &module);
@@ -194,6 +248,11 @@ static iree_status_t iree_tooling_load_hal_inline_module(
   return status;
 }
 
+IREE_FLAG(int32_t, hal_loader_worker_count, 0,
+          "Number of threads in addition to the calling thread used to "
+          "execute dispatch workgroups issued through the hal_loader module. "
+          "0 executes all workgroups serially on the calling thread.");
+
 static iree_status_t iree_tooling_load_hal_loader_module(
     iree_vm_instance_t* instance, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module) {
@@ -218,8 +277,13 @@ static iree_status_t iree_tooling_load_hal_loader_module(
   iree_vm_module_t* module = NULL;
   if (iree_status_is_ok(status)) {
     iree_hal_loader_module_flags_t flags = IREE_HAL_LOADER_MODULE_FLAG_NONE;
-    status = iree_hal_loader_module_create(instance, flags, loader_count,
-                                           loaders, host_allocator, &module);
+    iree_host_size_t worker_count =
+        FLAG_hal_loader_worker_count > 0
+            ? (iree_host_size_t)FLAG_hal_loader_worker_count
+            : 0;
+    status = iree_hal_loader_module_create_with_workers(
+        instance, flags, worker_count, loader_count, loaders, host_allocator,
+        &module);
   }
 
   // Always release loaders; loader module has retained them.
@@ -236,6 +300,81 @@ static iree_status_t iree_tooling_load_hal_loader_module(
   return status;
 }
 
+//===----------------------------------------------------------------------===//
+// Parameter management
+//===----------------------------------------------------------------------===//
+
+IREE_FLAG_LIST(
+    string, parameters,
+    "Specifies a parameter archive to serve to programs as `[scope=]path`.\n"
+    "Archives are memory-mapped once and shared by all contexts using the\n"
+    "io_parameters module. Multiple archives may share a scope in which\n"
+    "case they are searched in the order specified.");
+
+// Opens the parameter archive specified as `[scope=]path` in |value|.
+static iree_status_t iree_tooling_open_parameter_archive(
+    iree_string_view_t value, iree_allocator_t host_allocator,
+    iree_io_parameters_module_archive_t* out_archive) {
+  iree_string_view_t scope = iree_string_view_empty();
+  iree_string_view_t path = iree_string_view_empty();
+  if (iree_string_view_split(value, '=', &scope, &path) == -1) {
+    // No scope specified; the whole value is the path.
+    path = scope;
+    scope = iree_string_view_empty();
+  }
+  char path_str[2048];
+  if (path.size >= sizeof(path_str)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "parameter archive path too long");
+  }
+  memcpy(path_str, path.data, path.size);
+  path_str[path.size] = 0;
+  out_archive->scope = scope;
+  return iree_io_parameter_archive_open_file(path_str, host_allocator,
+                                             &out_archive->archive);
+}
+
+static iree_status_t iree_tooling_load_io_parameters_module(
+    iree_vm_instance_t* instance, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
+  IREE_ASSERT_ARGUMENT(instance);
+  IREE_ASSERT_ARGUMENT(out_module);
+  *out_module = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Parameters are returned as HAL buffers.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_module_register_all_types(instance));
+
+  const iree_flag_string_list_t parameters_list = FLAG_parameters_list();
+  iree_io_parameters_module_archive_t archives[32];
+  if (parameters_list.count > IREE_ARRAYSIZE(archives)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "at most %" PRIhsz
+                            " parameter archives may be specified",
+                            IREE_ARRAYSIZE(archives));
+  }
+  iree_host_size_t archive_count = 0;
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < parameters_list.count; ++i) {
+    status = iree_tooling_open_parameter_archive(
+        parameters_list.values[i], host_allocator, &archives[i]);
+    if (!iree_status_is_ok(status)) break;
+    ++archive_count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameters_module_create(instance, archive_count, archives,
+                                              host_allocator, out_module);
+  }
+  for (iree_host_size_t i = 0; i < archive_count; ++i) {
+    iree_io_parameter_archive_release(archives[i].archive);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Module management
 //===----------------------------------------------------------------------===//
@@ -323,6 +462,10 @@ static iree_status_t iree_tooling_resolve_module_dependency(
   } else if (iree_string_view_equal(dependency->name, IREE_SV("hal_loader"))) {
     IREE_RETURN_IF_ERROR(iree_tooling_load_hal_loader_module(
         state->instance, state->host_allocator, &module));
+  } else if (iree_string_view_equal(dependency->name,
+                                    IREE_SV("io_parameters"))) {
+    IREE_RETURN_IF_ERROR(iree_tooling_load_io_parameters_module(
+        state->instance, state->host_allocator, &module));
   } else if (iree_string_view_equal(dependency->name, IREE_SV("vmvx"))) {
     IREE_RETURN_IF_ERROR(iree_vmvx_module_create(
         state->instance, state->host_allocator, &module));
@@ -15,6 +15,14 @@
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// Host allocator selection
+//===----------------------------------------------------------------------===//
+
+// Returns the host allocator selected by the --host_allocator= flag.
+// Defaults to the system allocator.
+iree_allocator_t iree_tooling_host_allocator(void);
+
 //===----------------------------------------------------------------------===//
 // Module loading
 //===----------------------------------------------------------------------===//
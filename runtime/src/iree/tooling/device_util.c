@@ -374,8 +374,9 @@ iree_status_t iree_hal_create_device_from_flags(
 
 IREE_FLAG(
     string, device_profiling_mode, "",
-    "HAL device profiling mode (one of ['queue', 'dispatch', 'executable']) "
-    "or empty to disable profiling. HAL implementations may require additional "
+    "HAL device profiling mode (one of ['queue', 'dispatch', "
+    "'dispatch-timestamps', 'executable']) or empty to disable profiling. HAL "
+    "implementations may require additional "
     "flags in order to configure profiling support on "
     "their devices.");
 IREE_FLAG(
@@ -395,6 +396,8 @@ iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device) {
     options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_QUEUE_OPERATIONS;
   } else if (strcmp(FLAG_device_profiling_mode, "dispatch") == 0) {
     options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+  } else if (strcmp(FLAG_device_profiling_mode, "dispatch-timestamps") == 0) {
+    options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS;
   } else if (strcmp(FLAG_device_profiling_mode, "executable") == 0) {
     options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS;
   } else {
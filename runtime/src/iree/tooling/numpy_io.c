@@ -6,8 +6,19 @@
 
 #include "iree/tooling/numpy_io.h"
 
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_NUMPY_NPY_MMAP_POSIX 1
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_*
+
 //===----------------------------------------------------------------------===//
 // .npy (multiple values concatenated)
 //===----------------------------------------------------------------------===//
@@ -136,6 +147,138 @@ static iree_status_t iree_numpy_npy_read_into_mapping(
   return iree_ok_status();
 }
 
+// Minimum alignment of mapped ndarray contents. The npy header is padded such
+// that the contents of the first ndarray in a file meet this and compiled
+// executables may assume their bindings do.
+#define IREE_NUMPY_NPY_MAP_ALIGNMENT 64
+
+#if defined(IREE_NUMPY_NPY_MMAP_POSIX)
+
+// A mapping of the file pages containing an imported ndarray.
+typedef struct iree_numpy_npy_file_mapping_t {
+  iree_allocator_t host_allocator;
+  void* base;
+  size_t length;
+} iree_numpy_npy_file_mapping_t;
+
+static void iree_numpy_npy_file_mapping_release(void* user_data,
+                                                iree_hal_buffer_t* buffer) {
+  iree_numpy_npy_file_mapping_t* mapping =
+      (iree_numpy_npy_file_mapping_t*)user_data;
+  munmap(mapping->base, mapping->length);
+  iree_allocator_free(mapping->host_allocator, mapping);
+}
+
+// Tries to map the |contents_length| bytes at the current position of
+// |stream| into the process and import them into a buffer that references the
+// file pages directly. The mapping is private so that writes to the buffer are
+// copy-on-write and never reach the file.
+//
+// Returns OK with |out_buffer| NULL if the contents cannot be mapped (pipes,
+// misaligned contents, etc) or |device_allocator| cannot import them and the
+// caller must read them instead. On success the |stream| is positioned
+// immediately following the contents.
+static iree_status_t iree_numpy_npy_try_map_contents(
+    FILE* stream, iree_device_size_t contents_length,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (contents_length == 0 || contents_length > IREE_HOST_SIZE_MAX) {
+    return iree_ok_status();
+  }
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(device_allocator);
+
+  // The device must be able to use host memory directly.
+  iree_device_size_t allocation_size = contents_length;
+  if (!iree_all_bits_set(
+          iree_hal_allocator_query_buffer_compatibility(
+              device_allocator, buffer_params, contents_length,
+              &buffer_params, &allocation_size),
+          IREE_HAL_BUFFER_COMPATIBILITY_IMPORTABLE)) {
+    return iree_ok_status();
+  }
+
+  // Only regular files holding all of the contents can be mapped; truncated
+  // files are left to the read path to report.
+  off_t offset = ftello(stream);
+  struct stat file_stat;
+  if (offset < 0 || fstat(fileno(stream), &file_stat) != 0 ||
+      !S_ISREG(file_stat.st_mode) ||
+      file_stat.st_size - offset < (off_t)contents_length) {
+    return iree_ok_status();
+  }
+
+  // Mappings must start on a page boundary so we map from the page containing
+  // the start of the contents.
+  const off_t page_size = (off_t)sysconf(_SC_PAGESIZE);
+  const off_t page_offset = offset - (offset % page_size);
+  const size_t map_length =
+      (size_t)(offset - page_offset) + (size_t)contents_length;
+  void* base = mmap(NULL, map_length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    fileno(stream), page_offset);
+  if (base == MAP_FAILED) return iree_ok_status();
+  uint8_t* contents = (uint8_t*)base + (offset - page_offset);
+  if ((uintptr_t)contents % IREE_NUMPY_NPY_MAP_ALIGNMENT != 0) {
+    munmap(base, map_length);
+    return iree_ok_status();
+  }
+
+  iree_numpy_npy_file_mapping_t* mapping = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*mapping), (void**)&mapping);
+  if (!iree_status_is_ok(status)) {
+    munmap(base, map_length);
+    return status;
+  }
+  mapping->host_allocator = host_allocator;
+  mapping->base = base;
+  mapping->length = map_length;
+
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = contents_length,
+      .handle.host_allocation.ptr = contents,
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_numpy_npy_file_mapping_release,
+      .user_data = mapping,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  status = iree_hal_allocator_import_buffer(device_allocator, buffer_params,
+                                            &external_buffer, release_callback,
+                                            &buffer);
+  if (!iree_status_is_ok(status)) {
+    // Not all allocators that report compatibility can import every buffer;
+    // fall back to reading the contents.
+    iree_status_ignore(status);
+    iree_numpy_npy_file_mapping_release(mapping, NULL);
+    return iree_ok_status();
+  }
+
+  // Skip the stream over the contents we mapped.
+  if (fseeko(stream, offset + (off_t)contents_length, SEEK_SET) != 0) {
+    iree_hal_buffer_release(buffer);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to seek past npy contents");
+  }
+  *out_buffer = buffer;
+  return iree_ok_status();
+}
+
+#else
+
+static iree_status_t iree_numpy_npy_try_map_contents(
+    FILE* stream, iree_device_size_t contents_length,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  return iree_ok_status();
+}
+
+#endif  // IREE_NUMPY_NPY_MMAP_POSIX
+
 // Scans for the next key: value pair in |dict|.
 // |dict| will be set to the remaining |dict| string after the key and value.
 static iree_status_t iree_numpy_consume_dict_key_value(
@@ -370,10 +513,31 @@ iree_numpy_npy_load_ndarray(FILE* stream, iree_numpy_npy_load_options_t options,
     if (!iree_status_is_ok(status)) break;
   }
 
+  // Try to map the file contents directly into the buffer when requested so
+  // that large arrays are neither copied nor duplicated in memory.
+  iree_hal_buffer_t* mapped_buffer = NULL;
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE)) {
+    iree_device_size_t contents_length = 0;
+    status = iree_hal_buffer_compute_view_size(
+        shape_rank, shape, element_type, encoding_type, &contents_length);
+    if (iree_status_is_ok(status)) {
+      status = iree_numpy_npy_try_map_contents(
+          stream, contents_length, buffer_params, device_allocator,
+          &mapped_buffer);
+    }
+    if (iree_status_is_ok(status) && mapped_buffer) {
+      status = iree_hal_buffer_view_create(mapped_buffer, shape_rank, shape,
+                                           element_type, encoding_type,
+                                           host_allocator, out_buffer_view);
+      iree_hal_buffer_release(mapped_buffer);
+    }
+  }
+
   // Allocate the buffer view and directly read into the allocated memory.
   // On targets where we can perform host mapping this will be zero-copy; on
   // others it'll at least be _somewhat_ efficient.
-  if (iree_status_is_ok(status)) {
+  if (iree_status_is_ok(status) && !mapped_buffer) {
     iree_numpy_npy_read_params_t read_params = {
         .stream = stream,
     };
@@ -16,10 +16,10 @@
 // Pickled objects are not supported (similar to using `allow_pickle=False`) and
 // not all dtypes are supported.
 //
-// .npy and uncompressed .npz files can be mapped into host memory with
+// .npy files can be mapped into host memory with
 // IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE if the HAL device allocator
-// supports using such memory. On devices with discrete memory the contents will
-// be loaded into host memory and copied to the device.
+// supports importing such memory. On devices with discrete memory the contents
+// will be loaded into host memory and copied to the device.
 //
 // This current implementation is very basic; in the future it'd be nice to
 // support an iree_io_stream_t to allow for externalizing the file access.
@@ -54,9 +54,11 @@ enum iree_numpy_npy_load_options_bits_t {
   IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT = 0u,
 
   // Tries to map the file into memory and use the contents directly from the
-  // file system. Only available if the HAL device supports accessing mapped
-  // data.
-  // Like providing `mmap_mode` to `numpy.load`.
+  // file system. Only available if the HAL device supports importing host
+  // memory, the stream is a regular file, and the ndarray contents are aligned
+  // (the first ndarray in a file always is). The mapping is copy-on-write so
+  // the file is never modified.
+  // Like providing `mmap_mode='c'` to `numpy.load`.
   // May be ignored if the implementation does not support mapping.
   IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE = 1u << 0,
 };
@@ -73,8 +75,9 @@ typedef uint32_t iree_numpy_npy_save_options_t;
 // in the npy file allocated from the given |device_allocator|.
 //
 // If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is set and the
-// |device_allocator| supports mapping then the file will be mapped into the
-// host process. Otherwise the file will be loaded into a new allocation.
+// |device_allocator| supports importing host memory then the file will be
+// mapped into the host process and imported without copying. Otherwise the
+// file will be loaded into a new allocation.
 //
 // Upon return the |stream| will be positioned immediately following the
 // ndarray contents, which may be end-of-stream.
@@ -119,15 +119,16 @@ static void LoadArrayAndAssertContents(FILE* stream,
                                        std::vector<iree_hal_dim_t> shape,
                                        iree_hal_element_type_t element_type,
                                        iree_hal_encoding_type_t encoding_type,
-                                       std::vector<T> contents) {
+                                       std::vector<T> contents,
+                                       iree_numpy_npy_load_options_t options =
+                                           IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT) {
   iree_hal_buffer_params_t buffer_params = {};
   buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
   buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
   buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
   iree_hal_buffer_view_t* buffer_view = NULL;
   IREE_ASSERT_OK(iree_numpy_npy_load_ndarray(
-      stream, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params,
-      device_allocator, &buffer_view));
+      stream, options, buffer_params, device_allocator, &buffer_view));
   AssertBufferViewContents<T>(buffer_view, shape, element_type, encoding_type,
                               contents);
   iree_hal_buffer_view_release(buffer_view);
@@ -194,6 +195,35 @@ TEST_F(NumpyIOTest, LoadMultipleArrays) {
   fclose(stream);
 }
 
+// Tests loading multiple arrays from a concatenated file by mapping the file.
+// Only the first array is aligned such that it can be mapped and the others
+// must fall back to reading without losing the stream position.
+TEST_F(NumpyIOTest, LoadMultipleArraysMapped) {
+  FILE* stream = OpenInputFile("multiple.npy");
+
+  // np.array([1.1, 2.2, 3.3], dtype=np.float32)
+  LoadArrayAndAssertContents<float>(
+      stream, device_allocator_, {3}, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {1.1f, 2.2f, 3.3f},
+      IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE);
+
+  // np.array([[0, 1], [2, 3]], dtype=np.int32)
+  LoadArrayAndAssertContents<int32_t>(
+      stream, device_allocator_, {2, 2}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {0, 1, 2, 3},
+      IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE);
+
+  // np.array(42, dtype=np.int32)
+  LoadArrayAndAssertContents<int32_t>(
+      stream, device_allocator_, {}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {42},
+      IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE);
+
+  // Should have hit EOF.
+  ASSERT_TRUE(IsEOF(stream));
+  fclose(stream);
+}
+
 // Tests loading arrays with various shapes.
 TEST_F(NumpyIOTest, ArrayShapes) {
   FILE* stream = OpenInputFile("array_shapes.npy");
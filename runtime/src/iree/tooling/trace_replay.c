@@ -46,6 +46,8 @@ iree_status_t iree_trace_replay_initialize(
 
   out_replay->driver_registry = driver_registry;
 
+  out_replay->timestamp_origin_ns = iree_time_now();
+
   iree_status_t status = iree_ok_status();
   if (iree_status_is_ok(status)) {
     status = iree_vm_list_create(iree_vm_make_undefined_type_def(), 8u,
@@ -223,7 +225,8 @@ static iree_status_t iree_trace_replay_load_bytecode_module(
     IREE_RETURN_IF_ERROR(iree_file_path_join(
         replay->root_path, iree_yaml_node_as_string(path_node),
         replay->host_allocator, &full_path));
-    status = iree_file_read_contents(full_path, replay->host_allocator,
+    status = iree_file_read_contents(full_path, IREE_FILE_READ_FLAG_MMAP,
+                                     replay->host_allocator,
                                      &flatbuffer_contents);
     iree_allocator_free(replay->host_allocator, full_path);
   }
@@ -1227,6 +1230,32 @@ static iree_status_t iree_trace_replay_parse_result_item_sequence(
 // type: call
 //===----------------------------------------------------------------------===//
 
+// Waits until the recorded `timestamp` of |event_node| relative to the replay
+// timestamp origin, if the event has one.
+static iree_status_t iree_trace_replay_wait_for_timestamp(
+    iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* event_node) {
+  yaml_node_t* timestamp_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
+      document, event_node, IREE_SV("timestamp"), &timestamp_node));
+  if (!timestamp_node) return iree_ok_status();
+  double timestamp = 0.0;
+  if (timestamp_node->type != YAML_SCALAR_NODE ||
+      !iree_string_view_atod(iree_yaml_node_as_string(timestamp_node),
+                             &timestamp) ||
+      timestamp < 0.0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "(%zu): expected a non-negative timestamp in "
+                            "seconds",
+                            timestamp_node->start_mark.line);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_wait_until(replay->timestamp_origin_ns +
+                  (iree_time_t)(timestamp * 1000000000.0));
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_trace_replay_event_call_prepare(
     iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node, iree_vm_function_t* out_function,
@@ -1294,6 +1323,12 @@ iree_status_t iree_trace_replay_event_call(
     yaml_node_t* event_node, const iree_trace_replay_call_hooks_t* hooks) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (iree_all_bits_set(replay->replay_flags,
+                        IREE_TRACE_REPLAY_FLAG_HONOR_TIMESTAMPS)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_trace_replay_wait_for_timestamp(replay, document, event_node));
+  }
+
   iree_vm_function_t function;
   iree_vm_list_t* input_list = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -1464,7 +1499,7 @@ static iree_status_t iree_trace_replay_event_numpy_load(
       }
       iree_hal_buffer_view_t* buffer_view = NULL;
       status = iree_numpy_npy_load_ndarray(
-          file, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params,
+          file, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
           device_allocator, &buffer_view);
       if (!iree_status_is_ok(status)) break;
 
@@ -31,6 +31,11 @@ enum iree_trace_replay_flag_bits_e {
   // and destroyed when new contexts are loaded. Context-specific module state
   // is not preserved.
   IREE_TRACE_REPLAY_FLAG_REUSE_MODULES = 1u << 2,
+  // Delays each call with a recorded `timestamp` (in seconds since the start of
+  // the recording) until at least that much time has elapsed since
+  // |timestamp_origin_ns|. Calls recorded without timestamps run immediately.
+  // When omitted calls run back-to-back as fast as possible.
+  IREE_TRACE_REPLAY_FLAG_HONOR_TIMESTAMPS = 1u << 3,
 };
 typedef uint32_t iree_trace_replay_flags_t;
 
@@ -98,6 +103,12 @@ typedef struct iree_trace_replay_t {
 
   // Optional call hooks allowing reflection of calls and their I/O.
   iree_trace_replay_call_hooks_t call_hooks;
+
+  // Time corresponding to the start of the recording when
+  // IREE_TRACE_REPLAY_FLAG_HONOR_TIMESTAMPS is set. Defaults to the time the
+  // replay was initialized and may be overridden so that multiple replays of
+  // streams from the same recording running concurrently share a timeline.
+  iree_time_t timestamp_origin_ns;
 } iree_trace_replay_t;
 
 // Initializes a trace replay context.
@@ -149,7 +160,8 @@ iree_status_t iree_trace_replay_event_call_prepare(
 
 // Replays a `call` event against the replay context.
 // Optionally |hooks| may be specified to inspect the inputs and outputs of the
-// call operation.
+// call operation. If IREE_TRACE_REPLAY_FLAG_HONOR_TIMESTAMPS is set and the
+// event has a recorded `timestamp` the call is delayed until that time.
 iree_status_t iree_trace_replay_event_call(
     iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node, const iree_trace_replay_call_hooks_t* hooks);
@@ -51,7 +51,7 @@ static iree_status_t iree_tooling_load_ndarrays_from_file(
   while (iree_status_is_ok(status) && !iree_file_is_at(file, file_length)) {
     iree_hal_buffer_view_t* buffer_view = NULL;
     status = iree_numpy_npy_load_ndarray(
-        file, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params,
+        file, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
         device_allocator, &buffer_view);
     if (iree_status_is_ok(status)) {
       iree_vm_ref_t buffer_view_ref =
@@ -279,6 +279,23 @@ iree_status_t iree_tooling_parse_into_variant_list(
   return status;
 }
 
+bool iree_tooling_function_is_argument_donated(
+    const iree_vm_function_t* function, iree_host_size_t ordinal) {
+  iree_string_view_t donated_args = iree_vm_function_lookup_attr_by_name(
+      function, IREE_SV("iree.abi.donate"));
+  while (!iree_string_view_is_empty(donated_args)) {
+    iree_string_view_t donated_arg = iree_string_view_empty();
+    iree_string_view_split(donated_args, ',', &donated_arg, &donated_args);
+    uint64_t donated_ordinal = 0;
+    if (iree_string_view_atoi_uint64(iree_string_view_trim(donated_arg),
+                                     &donated_ordinal) &&
+        donated_ordinal == ordinal) {
+      return true;
+    }
+  }
+  return false;
+}
+
 iree_status_t iree_tooling_append_async_fence_inputs(
     iree_vm_list_t* list, const iree_vm_function_t* function,
     iree_hal_device_t* device, iree_hal_fence_t* wait_fence,
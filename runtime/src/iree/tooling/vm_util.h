@@ -54,6 +54,14 @@ iree_status_t iree_tooling_append_async_fence_inputs(
     iree_hal_device_t* device, iree_hal_fence_t* wait_fence,
     iree_hal_fence_t** out_signal_fence);
 
+// Returns true if the argument at |ordinal| of |function| is donated.
+// The contents of a buffer passed for a donated argument may be overwritten by
+// the invocation (the buffer provides the storage for a result) and it must not
+// be used by the caller afterward. Donated arguments are listed in the
+// `iree.abi.donate` reflection attribute.
+bool iree_tooling_function_is_argument_donated(
+    const iree_vm_function_t* function, iree_host_size_t ordinal);
+
 // Appends a variant list of VM scalars and buffers to |builder|.
 // |list_name| will be printed alongside each element ordinal.
 //
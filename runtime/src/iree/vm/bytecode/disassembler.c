@@ -1572,6 +1572,46 @@ iree_status_t iree_vm_bytecode_disassemble_op(
       break;
     }
 
+#define DISASM_OP_CORE_CMP_COND_BRANCH(op_name, op_type, op_mnemonic)  \
+  DISASM_OP(CORE, op_name) {                                           \
+    uint16_t lhs_reg = VM_ParseOperandReg##op_type("lhs");             \
+    uint16_t rhs_reg = VM_ParseOperandReg##op_type("rhs");             \
+    int32_t true_block_pc = VM_ParseBranchTarget("true_dest");         \
+    const iree_vm_register_remap_list_t* true_remap_list =             \
+        VM_ParseBranchOperands("true_operands");                       \
+    int32_t false_block_pc = VM_ParseBranchTarget("false_dest");       \
+    const iree_vm_register_remap_list_t* false_remap_list =            \
+        VM_ParseBranchOperands("false_operands");                      \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(            \
+        b, "vm.cond_br %s ", op_mnemonic));                            \
+    EMIT_##op_type##_REG_NAME(lhs_reg);                                \
+    EMIT_OPTIONAL_VALUE_##op_type(regs->i32[lhs_reg]);                 \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", ")); \
+    EMIT_##op_type##_REG_NAME(rhs_reg);                                \
+    EMIT_OPTIONAL_VALUE_##op_type(regs->i32[rhs_reg]);                 \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(            \
+        b, ", ^%08X(", true_block_pc));                                \
+    EMIT_REMAP_LIST(true_remap_list);                                  \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(            \
+        b, "), ^%08X(", false_block_pc));                              \
+    EMIT_REMAP_LIST(false_remap_list);                                 \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));  \
+    break;                                                             \
+  }
+
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, I32, "vm.cmp.eq.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, I32, "vm.cmp.ne.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, I32,
+                                   "vm.cmp.lt.i32.s");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, I32,
+                                   "vm.cmp.lt.i32.u");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, I64, "vm.cmp.eq.i64");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, I64, "vm.cmp.ne.i64");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, I64,
+                                   "vm.cmp.lt.i64.s");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, I64,
+                                   "vm.cmp.lt.i64.u");
+
     DISASM_OP(CORE, Call) {
       int32_t function_ordinal = VM_ParseFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
@@ -16,6 +16,13 @@
 #include "iree/vm/bytecode/module_impl.h"
 #include "iree/vm/ops.h"
 
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+// Control transfers remaining on this thread until the next pc sample is taken.
+// See IREE_DISPATCH_PROFILE_BRANCH.
+static IREE_THREAD_LOCAL uint32_t iree_vm_bytecode_profile_countdown =
+    IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL;
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
 //===----------------------------------------------------------------------===//
 // Register remapping utilities
 //===----------------------------------------------------------------------===//
@@ -440,16 +447,105 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   }
 }
 
+// Populates import call arguments using a precomputed |shuffle|.
+// Produces the same results as iree_vm_bytecode_populate_import_cconv_arguments
+// for non-variadic fragments. Every byte of |storage| is written so it need not
+// be zero initialized.
+static void iree_vm_bytecode_populate_import_shuffled_arguments(
+    iree_vm_bytecode_shuffle_t shuffle,
+    const iree_vm_registers_t caller_registers,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    iree_byte_span_t storage) {
+  uint8_t* IREE_RESTRICT p = storage.data;
+  uint64_t kinds = shuffle.kinds;
+  for (uint8_t i = 0; i < shuffle.length; ++i, kinds >>= 2) {
+    uint16_t src_reg = src_reg_list->registers[i];
+    switch (kinds & 0x3) {
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_32:
+        memcpy(p, &caller_registers.i32[src_reg], sizeof(int32_t));
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_64:
+        memcpy(p, &caller_registers.i32[src_reg], sizeof(int64_t));
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_REF:
+        // Arguments are borrowed by the callee and the storage is fresh so this
+        // is equivalent to an iree_vm_ref_assign into a NULL ref.
+        memcpy(p, &caller_registers.ref[src_reg & IREE_REF_REGISTER_MASK],
+               sizeof(iree_vm_ref_t));
+        p += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+}
+
+// Marshals import call results from the ABI |results| buffer into
+// |dst_reg_list| using a precomputed |shuffle|.
+static void iree_vm_bytecode_marshal_import_shuffled_results(
+    iree_vm_bytecode_shuffle_t shuffle, iree_byte_span_t results,
+    const iree_vm_registers_t caller_registers,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list) {
+  uint8_t* IREE_RESTRICT p = results.data;
+  uint64_t kinds = shuffle.kinds;
+  iree_host_size_t length = iree_min(shuffle.length, dst_reg_list->size);
+  for (iree_host_size_t i = 0; i < length; ++i, kinds >>= 2) {
+    uint16_t dst_reg = dst_reg_list->registers[i];
+    switch (kinds & 0x3) {
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_32:
+        memcpy(&caller_registers.i32[dst_reg], p, sizeof(int32_t));
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_64:
+        memcpy(&caller_registers.i32[dst_reg], p, sizeof(int64_t));
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_BYTECODE_SHUFFLE_KIND_REF:
+        iree_vm_ref_move(
+            (iree_vm_ref_t*)p,
+            &caller_registers.ref[dst_reg & IREE_REF_REGISTER_MASK]);
+        p += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+}
+
 // Issues a populated import call and marshals the results into |dst_reg_list|.
 static iree_status_t iree_vm_bytecode_issue_import_call(
     iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
+    const iree_vm_bytecode_import_t* import,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t* IREE_RESTRICT* out_caller_frame,
     iree_vm_registers_t* out_caller_registers) {
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  // Attribute the host time spent in the import to the calling module state.
+  iree_vm_bytecode_module_state_t* profile_state = NULL;
+  iree_time_t profile_start_ns = 0;
+  if (iree_vm_stack_invocation_flags(stack) &
+      IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION) {
+    iree_vm_stack_frame_t* caller_frame = iree_vm_stack_current_frame(stack);
+    profile_state =
+        (iree_vm_bytecode_module_state_t*)caller_frame->module_state;
+    profile_start_ns = iree_time_now();
+  }
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
   // Call external function.
   iree_status_t call_status =
       call.function.module->begin_call(call.function.module->self, stack, call);
+
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  if (profile_state) {
+    iree_vm_bytecode_profile_t* profile = profile_state->profile;
+    iree_vm_bytecode_import_profile_t* import_profile =
+        &profile->imports[import - profile_state->import_table];
+    iree_atomic_fetch_add_int64(&import_profile->call_count, 1,
+                                iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int64(&import_profile->total_duration_ns,
+                                iree_time_now() - profile_start_ns,
+                                iree_memory_order_relaxed);
+  }
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
   if (iree_status_is_deferred(call_status)) {
     if (!iree_byte_span_is_empty(call.results)) {
       iree_status_ignore(call_status);
@@ -472,6 +568,12 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
+  if (IREE_LIKELY(import->result_shuffle.length != UINT8_MAX)) {
+    iree_vm_bytecode_marshal_import_shuffled_results(
+        import->result_shuffle, call.results, caller_registers, dst_reg_list);
+    return iree_ok_status();
+  }
+  iree_string_view_t cconv_results = import->results;
   uint8_t* IREE_RESTRICT p = call.results.data;
   for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
        ++i) {
@@ -556,17 +658,23 @@ static iree_status_t iree_vm_bytecode_call_import(
   // Marshal inputs from registers to the ABI arguments buffer.
   call.arguments.data_length = import->argument_buffer_size;
   call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
-  iree_vm_bytecode_populate_import_cconv_arguments(
-      import->arguments, caller_registers,
-      /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  if (IREE_LIKELY(import->argument_shuffle.length != UINT8_MAX)) {
+    iree_vm_bytecode_populate_import_shuffled_arguments(
+        import->argument_shuffle, caller_registers, src_reg_list,
+        call.arguments);
+  } else {
+    memset(call.arguments.data, 0, call.arguments.data_length);
+    iree_vm_bytecode_populate_import_cconv_arguments(
+        import->arguments, caller_registers,
+        /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  }
 
   // Issue the call and handle results.
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, call, import, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -606,8 +714,8 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, call, import, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -680,6 +788,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
   IREE_BUILTIN_ASSUME_ALIGNED(regs_i32, 16);
   iree_vm_ref_t* IREE_RESTRICT regs_ref = regs.ref;
   IREE_BUILTIN_ASSUME_ALIGNED(regs_ref, 16);
+  const uint16_t ref_move_bit_mask = module->ref_move_bit_mask;
 
   iree_vm_source_offset_t pc = current_frame->pc;
   BEGIN_DISPATCH_CORE() {
@@ -1410,7 +1519,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
       iree_vm_ref_t* result = VM_DecResultRegRef("result", &result_is_move);
       if (index >= 0 && index < value_reg_list->size) {
         bool is_move =
-            value_reg_list->registers[index] & IREE_REF_REGISTER_MOVE_BIT;
+            (value_reg_list->registers[index] & ref_move_bit_mask) != 0;
         iree_vm_ref_t* new_value = &regs_ref[value_reg_list->registers[index] &
                                              IREE_REF_REGISTER_MASK];
         IREE_RETURN_IF_ERROR(iree_vm_ref_retain_or_move_checked(
@@ -1585,6 +1694,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, Block, {});
 
     DISPATCH_OP(CORE, Branch, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       int32_t block_pc = VM_DecBranchTarget("dest");
       const iree_vm_register_remap_list_t* remap_list =
           VM_DecBranchOperands("operands");
@@ -1596,6 +1706,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, CondBranch, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       int32_t condition = VM_DecOperandRegI32("condition");
       int32_t true_block_pc = VM_DecBranchTarget("true_dest");
       const iree_vm_register_remap_list_t* true_remap_list =
@@ -1618,7 +1729,54 @@ static iree_status_t iree_vm_bytecode_dispatch(
       }
     });
 
+    // Fused comparison and conditional branch superinstructions. These are
+    // equivalent to a vm.cmp.* followed by a vm.cond_br on its result but
+    // avoid the intermediate register write and second dispatch.
+#define DISPATCH_OP_CORE_CMP_COND_BRANCH(op_name, op_type, c_type, op_func)    \
+  DISPATCH_OP(CORE, op_name, {                                                 \
+    IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);                      \
+    c_type lhs = VM_DecOperandReg##op_type("lhs");                             \
+    c_type rhs = VM_DecOperandReg##op_type("rhs");                             \
+    int32_t true_block_pc = VM_DecBranchTarget("true_dest");                   \
+    const iree_vm_register_remap_list_t* true_remap_list =                     \
+        VM_DecBranchOperands("true_operands");                                 \
+    int32_t false_block_pc = VM_DecBranchTarget("false_dest");                 \
+    const iree_vm_register_remap_list_t* false_remap_list =                    \
+        VM_DecBranchOperands("false_operands");                                \
+    if (op_func(lhs, rhs)) {                                                   \
+      pc = true_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip block marker */  \
+      if (IREE_UNLIKELY(true_remap_list->size > 0)) {                          \
+        iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,   \
+                                                         true_remap_list);     \
+      }                                                                        \
+    } else {                                                                   \
+      pc = false_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip block marker */ \
+      if (IREE_UNLIKELY(false_remap_list->size > 0)) {                         \
+        iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,   \
+                                                         false_remap_list);    \
+      }                                                                        \
+    }                                                                          \
+  });
+
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, I32, int32_t,
+                                     vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, I32, int32_t,
+                                     vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, I32, int32_t,
+                                     vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, I32, int32_t,
+                                     vm_cmp_lt_i32u);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, I64, int64_t,
+                                     vm_cmp_eq_i64);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, I64, int64_t,
+                                     vm_cmp_ne_i64);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, I64, int64_t,
+                                     vm_cmp_lt_i64s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, I64, int64_t,
+                                     vm_cmp_lt_i64u);
+
     DISPATCH_OP(CORE, Call, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1655,6 +1813,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, CallVariadic, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
       int32_t function_ordinal = VM_DecFuncAttr("callee");
@@ -1691,6 +1850,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, Return, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
       current_frame->pc = pc;
@@ -1746,6 +1906,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
+      IREE_DISPATCH_PROFILE_BRANCH(IREE_VM_PC_OFFSET_CORE);
       // Perform branch before yielding; in this way we will resume at the
       // target without needing to retain any information about the yield.
       int32_t block_pc = VM_DecBranchTarget("dest");
@@ -11,6 +11,7 @@
 // that we can't run the full MLIR compiler stack on.
 
 #include "iree/base/api.h"
+#include "iree/base/loop_sync.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 #include "iree/vm/api.h"
@@ -153,5 +154,83 @@ TEST_F(VMBytecodeDispatchAsyncTest, YieldDivergent) {
   iree_vm_stack_deinitialize(stack);
 }
 
+// Tests that multiple async invocations in-flight on the same context and loop
+// interleave at their yields and each produce their own results.
+// See iree/vm/test/async_ops.mlir > @yield_sequence
+TEST_F(VMBytecodeDispatchAsyncTest, InterleavedInvocations) {
+  IREE_TRACE_SCOPE();
+
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+      bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      IREE_SV("yield_sequence"), &function));
+
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance_, IREE_VM_CONTEXT_FLAG_CONCURRENT, 1, &bytecode_module_,
+      iree_allocator_system(), &context));
+
+  iree_loop_sync_options_t options = {0};
+  options.max_queue_depth = 16;
+  options.max_wait_count = 16;
+  iree_loop_sync_t* loop_sync = nullptr;
+  IREE_ASSERT_OK(
+      iree_loop_sync_allocate(options, iree_allocator_system(), &loop_sync));
+  iree_loop_sync_scope_t scope;
+  iree_loop_sync_scope_initialize(loop_sync, /*error_fn=*/nullptr,
+                                  /*error_user_data=*/nullptr, &scope);
+  iree_loop_t loop = iree_loop_sync_scope(&scope);
+
+  struct Invocation {
+    iree_vm_async_invoke_state_t state;
+    uint32_t arg_value;
+    uint32_t ret_value;
+    iree_status_code_t status_code;
+  };
+  static constexpr int kInvocationCount = 4;
+  Invocation invocations[kInvocationCount];
+  auto callback = +[](void* user_data, iree_loop_t loop, iree_status_t status,
+                      iree_vm_list_t* outputs) -> iree_status_t {
+    Invocation* invocation = reinterpret_cast<Invocation*>(user_data);
+    invocation->status_code = iree_status_consume_code(status);
+    iree_vm_value_t value;
+    if (invocation->status_code == IREE_STATUS_OK &&
+        iree_status_is_ok(iree_vm_list_get_value(outputs, 0, &value))) {
+      invocation->ret_value = value.i32;
+    }
+    iree_vm_list_release(outputs);
+    return iree_ok_status();
+  };
+
+  // Begin all invocations before draining the loop so that they are all
+  // in-flight at the same time.
+  for (int i = 0; i < kInvocationCount; ++i) {
+    Invocation* invocation = &invocations[i];
+    invocation->arg_value = 100 * (i + 1);
+    invocation->ret_value = 0;
+    invocation->status_code = IREE_STATUS_UNKNOWN;
+    iree_vm_list_t* inputs = nullptr;
+    IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                       iree_allocator_system(), &inputs));
+    iree_vm_value_t arg = iree_vm_value_make_i32(invocation->arg_value);
+    IREE_ASSERT_OK(iree_vm_list_push_value(inputs, &arg));
+    IREE_ASSERT_OK(iree_vm_async_invoke(
+        loop, &invocation->state, context, function,
+        IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr, inputs,
+        /*outputs=*/nullptr, iree_allocator_system(), callback, invocation));
+    iree_vm_list_release(inputs);
+  }
+
+  IREE_ASSERT_OK(iree_loop_sync_wait_idle(loop_sync, iree_infinite_timeout()));
+  for (int i = 0; i < kInvocationCount; ++i) {
+    EXPECT_EQ(invocations[i].status_code, IREE_STATUS_OK);
+    EXPECT_EQ(invocations[i].ret_value, invocations[i].arg_value + 3);
+  }
+
+  iree_loop_sync_scope_deinitialize(&scope);
+  iree_loop_sync_free(loop_sync);
+  iree_vm_context_release(context);
+}
+
 }  // namespace
 }  // namespace iree
@@ -116,7 +116,33 @@ static inline iree_vm_type_def_t iree_vm_map_type(
 #define IREE_DISPATCH_TRACE_INSTRUCTION(...)
 #endif  // IREE_VM_EXECUTION_TRACING_ENABLE
 
-#if defined(IREE_COMPILER_CLANG) && \
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+// Counts down the control transfers remaining until the next sample and records
+// the pc of the current branch, call, or return when profiling the invocation.
+// Must be the first statement of the op body so that the pc is that of the op.
+// Charging once per transfer instead of per instruction keeps straight-line
+// code free of profiling overhead; each sample attributes to the terminator of
+// the block that was executing. The countdown is declared in dispatch.c and
+// unique per thread so that samples are taken at a fixed interval regardless
+// of how often the dispatch loop is entered.
+#define IREE_DISPATCH_PROFILE_BRANCH(pc_offset)                               \
+  if (IREE_UNLIKELY(--iree_vm_bytecode_profile_countdown == 0)) {             \
+    iree_vm_bytecode_profile_countdown =                                      \
+        IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL;                          \
+    if (iree_vm_stack_invocation_flags(stack) &                               \
+        IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION) {                          \
+      iree_vm_bytecode_profile_record_sample(                                 \
+          module_state->profile, current_frame, pc - (pc_offset));            \
+    }                                                                         \
+  }
+#else
+#define IREE_DISPATCH_PROFILE_BRANCH(...)
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Computed goto relies on the labels-as-values extension that both gcc and
+// clang implement. This only selects the dispatch mode of the interpreter; all
+// bytecode is still interpreted.
+#if defined(IREE_COMPILER_GCC_COMPAT) && \
     IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE
 #define IREE_DISPATCH_MODE_COMPUTED_GOTO 1
 #else
@@ -188,9 +214,12 @@ static inline const iree_vm_register_remap_list_t* VM_DecBranchOperandsImpl(
 #define VM_DecOperandRegF64(name)   \
   *((double*)&regs_i32[OP_I16(0)]); \
   pc += IREE_REGISTER_ORDINAL_SIZE;
-#define VM_DecOperandRegRef(name, out_is_move)                      \
-  &regs_ref[OP_I16(0) & IREE_REF_REGISTER_MASK];                    \
-  *(out_is_move) = 0; /*= OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT;*/ \
+// The compiler sets the move bit on the last use of a ref operand so ops that
+// consume the ref can steal it from the register instead of retaining it.
+// |ref_move_bit_mask| is 0 for modules whose move bits cannot be trusted.
+#define VM_DecOperandRegRef(name, out_is_move)           \
+  &regs_ref[OP_I16(0) & IREE_REF_REGISTER_MASK];         \
+  *(out_is_move) = (OP_I16(0) & ref_move_bit_mask) != 0; \
   pc += IREE_REGISTER_ORDINAL_SIZE;
 #define VM_DecVariadicOperands(name) \
   VM_DecVariadicOperandsImpl(bytecode_data, &pc)
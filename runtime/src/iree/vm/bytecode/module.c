@@ -8,11 +8,13 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "iree/base/tracing.h"
 #include "iree/vm/bytecode/archive.h"
 #include "iree/vm/bytecode/module_impl.h"
+#include "iree/vm/bytecode/utils/lz4.h"
 #include "iree/vm/bytecode/verifier.h"
 
 // Perform an strcmp between a FlatBuffers string and an IREE string view.
@@ -143,10 +145,83 @@ static iree_status_t iree_vm_bytecode_map_internal_ordinal(
   return iree_ok_status();
 }
 
+// Initializes the shared rodata segment references of |module| to point
+// directly at the FlatBuffer memory. Compressed segments are decompressed into
+// host allocations owned by their references.
+// |module| rodata_ref_count is updated as each reference is initialized so that
+// a partially initialized table can be deinitialized on failure.
+static iree_status_t iree_vm_bytecode_module_initialize_rodata(
+    iree_vm_bytecode_module_t* module, iree_host_size_t rodata_ref_count) {
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def);
+  for (iree_host_size_t i = 0; i < rodata_ref_count; ++i) {
+    iree_vm_RodataSegmentDef_table_t segment =
+        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    iree_byte_span_t byte_span = iree_byte_span_empty();
+    if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
+      // Data is embedded in the FlatBuffer.
+      byte_span = iree_make_byte_span(
+          (uint8_t*)iree_vm_RodataSegmentDef_embedded_data(segment),
+          flatbuffers_uint8_vec_len(
+              iree_vm_RodataSegmentDef_embedded_data(segment)));
+    } else {
+      // Data is concatenated with the FlatBuffer at some relative offset.
+      // Note that we've already verified the referenced range is in bounds.
+      byte_span = iree_make_byte_span(
+          (uint8_t*)module->archive_contents.data +
+              module->archive_rodata_offset +
+              iree_vm_RodataSegmentDef_external_data_offset(segment),
+          iree_vm_RodataSegmentDef_external_data_length(segment));
+    }
+    iree_vm_buffer_t* ref = &module->rodata_ref_table[i];
+    if (iree_vm_RodataSegmentDef_compression_type_type(segment) ==
+        iree_vm_CompressionTypeDef_LZ4BlockDataDef) {
+      // Compressed data cannot be referenced in place and is expanded into a
+      // host allocation that the reference frees when deinitialized.
+      iree_vm_LZ4BlockDataDef_table_t lz4_def =
+          (iree_vm_LZ4BlockDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment);
+      iree_host_size_t uncompressed_length =
+          (iree_host_size_t)iree_vm_LZ4BlockDataDef_uncompressed_length(
+              lz4_def);
+      uint8_t* uncompressed_data = NULL;
+      IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+          module->allocator, uncompressed_length, (void**)&uncompressed_data));
+      iree_byte_span_t uncompressed_span =
+          iree_make_byte_span(uncompressed_data, uncompressed_length);
+      iree_status_t status = iree_vm_bytecode_lz4_decompress_block(
+          iree_make_const_byte_span(byte_span.data, byte_span.data_length),
+          uncompressed_span);
+      if (!iree_status_is_ok(status)) {
+        iree_allocator_free(module->allocator, uncompressed_data);
+        return iree_status_annotate_f(status, "decompressing rodata[%zu]", i);
+      }
+      iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                                uncompressed_span, module->allocator, ref);
+    } else {
+      iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE, byte_span,
+                                iree_allocator_null(), ref);
+    }
+    module->rodata_ref_count = i + 1;
+  }
+  return iree_ok_status();
+}
+
+// Ensures all rodata references are unused and deinitializes them.
+static void iree_vm_bytecode_module_deinitialize_rodata(
+    iree_vm_bytecode_module_t* module) {
+  for (iree_host_size_t i = 0; i < module->rodata_ref_count; ++i) {
+    iree_vm_buffer_deinitialize(&module->rodata_ref_table[i]);
+  }
+  module->rodata_ref_count = 0;
+}
+
 static void iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_vm_bytecode_module_deinitialize_rodata(module);
+
   module->def = NULL;
   iree_allocator_free(module->archive_allocator,
                       (void*)module->archive_contents.data);
@@ -586,6 +661,263 @@ static iree_status_t iree_vm_bytecode_module_resolve_source_location(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// Execution profiling
+//===----------------------------------------------------------------------===//
+
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Maximum number of sample table slots probed before a sample is dropped.
+#define IREE_VM_BYTECODE_PROFILE_MAX_PROBE_COUNT 32
+
+static iree_status_t iree_vm_bytecode_profile_allocate(
+    iree_host_size_t import_count, iree_allocator_t allocator,
+    iree_vm_bytecode_profile_t** out_profile) {
+  iree_vm_bytecode_profile_t* profile = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, sizeof(*profile) + import_count * sizeof(profile->imports[0]),
+      (void**)&profile));
+  iree_slim_mutex_initialize(&profile->mutex);
+  profile->import_count = import_count;
+  *out_profile = profile;
+  return iree_ok_status();
+}
+
+static void iree_vm_bytecode_profile_free(iree_vm_bytecode_profile_t* profile,
+                                          iree_allocator_t allocator) {
+  if (!profile) return;
+  iree_slim_mutex_deinitialize(&profile->mutex);
+  iree_allocator_free(allocator, profile);
+}
+
+// Returns true if |lhs| and |rhs| are the same function.
+static bool iree_vm_bytecode_profile_function_equal(
+    const iree_vm_function_t* lhs, const iree_vm_function_t* rhs) {
+  return lhs->module == rhs->module && lhs->linkage == rhs->linkage &&
+         lhs->ordinal == rhs->ordinal;
+}
+
+// Returns true if |lhs| and |rhs| have the same call stack and pc.
+static bool iree_vm_bytecode_profile_sample_equal(
+    const iree_vm_bytecode_profile_sample_t* lhs,
+    const iree_vm_bytecode_profile_sample_t* rhs) {
+  if (lhs->depth != rhs->depth || lhs->truncated != rhs->truncated ||
+      lhs->pc != rhs->pc) {
+    return false;
+  }
+  for (uint16_t i = 0; i < lhs->depth; ++i) {
+    if (!iree_vm_bytecode_profile_function_equal(&lhs->frames[i],
+                                                 &rhs->frames[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void iree_vm_bytecode_profile_record_sample(iree_vm_bytecode_profile_t* profile,
+                                            const iree_vm_stack_frame_t* frame,
+                                            iree_vm_source_offset_t pc) {
+  // Capture the call stack outside of the lock. The sampled frame is always a
+  // bytecode function of this module referenced by internal ordinal; callers
+  // are recorded as-is and frames without a function (such as the external
+  // frame at the root of an invocation) are skipped.
+  iree_vm_bytecode_profile_sample_t key;
+  memset(&key, 0, sizeof(key));
+  key.pc = (uint32_t)pc;
+  key.frames[0].module = frame->function.module;
+  key.frames[0].linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+  key.frames[0].ordinal = frame->function.ordinal;
+  key.depth = 1;
+  uint32_t hash = ((uint32_t)pc * 0x85EBCA6Bu) ^
+                  ((uint32_t)frame->function.ordinal + 1) * 0x9E3779B1u;
+  for (const iree_vm_stack_frame_t* parent = iree_vm_stack_frame_parent(frame);
+       parent != NULL; parent = iree_vm_stack_frame_parent(parent)) {
+    if (!parent->function.module) continue;
+    if (key.depth == IREE_VM_BYTECODE_PROFILE_MAX_DEPTH) {
+      key.truncated = 1;
+      break;
+    }
+    iree_vm_function_t* function = &key.frames[key.depth++];
+    function->module = parent->function.module;
+    function->linkage = parent->function.linkage;
+    function->ordinal = parent->function.ordinal;
+    hash = (hash ^ (uint32_t)(uintptr_t)function->module ^
+            ((uint32_t)function->linkage << 16 | function->ordinal)) *
+           0x9E3779B1u;
+  }
+
+  iree_slim_mutex_lock(&profile->mutex);
+  ++profile->total_sample_count;
+  for (uint32_t i = 0; i < IREE_VM_BYTECODE_PROFILE_MAX_PROBE_COUNT; ++i) {
+    iree_vm_bytecode_profile_sample_t* sample =
+        &profile->samples[(hash + i) &
+                          (IREE_VM_BYTECODE_PROFILE_SAMPLE_CAPACITY - 1)];
+    if (sample->depth == 0) {
+      *sample = key;
+      sample->count = 1;
+      iree_slim_mutex_unlock(&profile->mutex);
+      return;
+    } else if (iree_vm_bytecode_profile_sample_equal(sample, &key)) {
+      ++sample->count;
+      iree_slim_mutex_unlock(&profile->mutex);
+      return;
+    }
+  }
+  ++profile->dropped_sample_count;
+  iree_slim_mutex_unlock(&profile->mutex);
+}
+
+// Sorts samples in descending order of count and then by pc for stability.
+static int iree_vm_bytecode_profile_sample_compare(const void* lhs_ptr,
+                                                   const void* rhs_ptr) {
+  const iree_vm_bytecode_profile_sample_t* lhs =
+      (const iree_vm_bytecode_profile_sample_t*)lhs_ptr;
+  const iree_vm_bytecode_profile_sample_t* rhs =
+      (const iree_vm_bytecode_profile_sample_t*)rhs_ptr;
+  if (lhs->count != rhs->count) return lhs->count > rhs->count ? -1 : 1;
+  if (lhs->frames[0].ordinal != rhs->frames[0].ordinal) {
+    return lhs->frames[0].ordinal < rhs->frames[0].ordinal ? -1 : 1;
+  }
+  if (lhs->pc != rhs->pc) return lhs->pc < rhs->pc ? -1 : 1;
+  return lhs->depth < rhs->depth ? -1 : (lhs->depth > rhs->depth ? 1 : 0);
+}
+
+// Appends `module.function` for the internal function |ordinal|, falling back
+// to the ordinal if the debug database has been stripped.
+static iree_status_t iree_vm_bytecode_profile_append_function_name(
+    iree_vm_bytecode_module_t* module, uint16_t ordinal,
+    iree_string_builder_t* builder) {
+  iree_string_view_t module_name = iree_vm_bytecode_module_name(module);
+  iree_string_view_t function_name = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_get_function(
+      module, IREE_VM_FUNCTION_LINKAGE_INTERNAL, ordinal, NULL,
+      &function_name, NULL));
+  if (iree_string_view_is_empty(function_name)) {
+    return iree_string_builder_append_format(
+        builder, "%.*s.<internal %u>", (int)module_name.size, module_name.data,
+        (uint32_t)ordinal);
+  }
+  return iree_string_builder_append_format(
+      builder, "%.*s.%.*s", (int)module_name.size, module_name.data,
+      (int)function_name.size, function_name.data);
+}
+
+// Appends `module.function` for a caller |function| in any module.
+static iree_status_t iree_vm_bytecode_profile_append_caller_name(
+    iree_vm_bytecode_module_t* module, const iree_vm_function_t* function,
+    iree_string_builder_t* builder) {
+  if (function->module == &module->interface &&
+      function->linkage == IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+    return iree_vm_bytecode_profile_append_function_name(
+        module, function->ordinal, builder);
+  }
+  iree_string_view_t module_name = iree_vm_module_name(function->module);
+  iree_string_view_t function_name = iree_vm_function_name(function);
+  if (iree_string_view_is_empty(function_name)) {
+    return iree_string_builder_append_format(
+        builder, "%.*s@%u", (int)module_name.size, module_name.data,
+        (uint32_t)function->ordinal);
+  }
+  return iree_string_builder_append_format(
+      builder, "%.*s.%.*s", (int)module_name.size, module_name.data,
+      (int)function_name.size, function_name.data);
+}
+
+// Appends the report for |samples| sorted in descending order of count.
+static iree_status_t iree_vm_bytecode_profile_append_samples(
+    iree_vm_bytecode_module_t* module,
+    const iree_vm_bytecode_profile_sample_t* samples,
+    iree_host_size_t sample_count, iree_string_builder_t* builder) {
+  // Samples in the collapsed stack format (`frame;frame count`) consumed by
+  // flame graph tools. Frames run from the root of the call stack to the
+  // sampled function with the sampled pc as an additional leaf frame.
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(
+      builder, "# samples (caller;...;function;function+pc count):\n"));
+  for (iree_host_size_t i = 0; i < sample_count; ++i) {
+    const iree_vm_bytecode_profile_sample_t* sample = &samples[i];
+    if (sample->truncated) {
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_cstring(builder, "[truncated];"));
+    }
+    for (uint16_t j = sample->depth; j > 0; --j) {
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_profile_append_caller_name(
+          module, &sample->frames[j - 1], builder));
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, ";"));
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_profile_append_function_name(
+        module, sample->frames[0].ordinal, builder));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "+0x%08X %" PRIu64 "\n", sample->pc, sample->count));
+  }
+
+#if IREE_VM_BACKTRACE_ENABLE
+  // Source locations of each sampled pc from the debug database, if present.
+  // Samples at the same pc reached through different call stacks repeat.
+  if (!iree_vm_BytecodeModuleDef_debug_database(module->def)) {
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(
+      builder, "# sample locations (function+pc: location):\n"));
+  for (iree_host_size_t i = 0; i < sample_count; ++i) {
+    const uint16_t ordinal = samples[i].frames[0].ordinal;
+    iree_vm_stack_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.type = IREE_VM_STACK_FRAME_BYTECODE;
+    frame.function.module = &module->interface;
+    frame.function.linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+    frame.function.ordinal = ordinal;
+    frame.pc = samples[i].pc;
+    iree_vm_source_location_t source_location;
+    iree_status_t status = iree_vm_bytecode_module_resolve_source_location(
+        module, &frame, &source_location);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      continue;
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_profile_append_function_name(
+        module, ordinal, builder));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "+0x%08X: ", samples[i].pc));
+    status = iree_vm_source_location_format(
+        &source_location, IREE_VM_SOURCE_LOCATION_FORMAT_FLAG_SINGLE_LINE,
+        builder);
+    if (iree_status_is_unavailable(status)) {
+      iree_status_ignore(status);
+      status = iree_string_builder_append_cstring(builder, "[unknown]");
+    }
+    IREE_RETURN_IF_ERROR(status);
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, "\n"));
+  }
+#endif  // IREE_VM_BACKTRACE_ENABLE
+
+  return iree_ok_status();
+}
+
+// Appends the report for all imports with at least one profiled call.
+static iree_status_t iree_vm_bytecode_profile_append_imports(
+    iree_vm_bytecode_module_t* module, iree_vm_bytecode_profile_t* profile,
+    iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(
+      builder, "# imports (import calls total_ns avg_ns):\n"));
+  for (iree_host_size_t i = 0; i < profile->import_count; ++i) {
+    int64_t call_count = iree_atomic_load_int64(
+        &profile->imports[i].call_count, iree_memory_order_relaxed);
+    if (call_count == 0) continue;
+    int64_t total_duration_ns = iree_atomic_load_int64(
+        &profile->imports[i].total_duration_ns, iree_memory_order_relaxed);
+    iree_string_view_t import_name = iree_string_view_empty();
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_get_function(
+        module, IREE_VM_FUNCTION_LINKAGE_IMPORT, i, NULL, &import_name, NULL));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%.*s %" PRId64 " %" PRId64 " %" PRId64 "\n",
+        (int)import_name.size, import_name.data, call_count, total_duration_ns,
+        total_duration_ns / call_count));
+  }
+  return iree_ok_status();
+}
+
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
 // Lays out the nested tables within a |state| structure.
 // Returns the total size of the structure and all tables with padding applied.
 // |state| may be null if only the structure size is required for allocation.
@@ -602,8 +934,6 @@ static iree_host_size_t iree_vm_bytecode_module_layout_state(
     global_ref_count =
         iree_vm_ModuleStateDef_global_ref_count(module_state_def);
   }
-  iree_host_size_t rodata_ref_count = iree_vm_RodataSegmentDef_vec_len(
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def));
   iree_host_size_t import_function_count = iree_vm_ImportFunctionDef_vec_len(
       iree_vm_BytecodeModuleDef_imported_functions(module_def));
 
@@ -623,12 +953,6 @@ static iree_host_size_t iree_vm_bytecode_module_layout_state(
   }
   offset += iree_host_align(global_ref_count * sizeof(iree_vm_ref_t), 16);
 
-  if (state) {
-    state->rodata_ref_count = rodata_ref_count;
-    state->rodata_ref_table = (iree_vm_buffer_t*)(base_ptr + offset);
-  }
-  offset += iree_host_align(rodata_ref_count * sizeof(iree_vm_buffer_t), 16);
-
   if (state) {
     state->import_count = import_function_count;
     state->import_table = (iree_vm_bytecode_import_t*)(base_ptr + offset);
@@ -663,32 +987,19 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   // Perform layout to get the pointers into the storage for each nested table.
   iree_vm_bytecode_module_layout_state(module_def, state);
 
-  // Setup rodata segments to point directly at the FlatBuffer memory.
-  iree_vm_RodataSegmentDef_vec_t rodata_segments =
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
-  for (int i = 0; i < state->rodata_ref_count; ++i) {
-    iree_vm_RodataSegmentDef_table_t segment =
-        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
-    iree_byte_span_t byte_span = iree_byte_span_empty();
-    if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
-      // Data is embedded in the FlatBuffer.
-      byte_span = iree_make_byte_span(
-          (uint8_t*)iree_vm_RodataSegmentDef_embedded_data(segment),
-          flatbuffers_uint8_vec_len(
-              iree_vm_RodataSegmentDef_embedded_data(segment)));
-    } else {
-      // Data is concatenated with the FlatBuffer at some relative offset.
-      // Note that we've already verified the referenced range is in bounds.
-      byte_span = iree_make_byte_span(
-          (uint8_t*)module->archive_contents.data +
-              module->archive_rodata_offset +
-              iree_vm_RodataSegmentDef_external_data_offset(segment),
-          iree_vm_RodataSegmentDef_external_data_length(segment));
-    }
-    iree_vm_buffer_t* ref = &state->rodata_ref_table[i];
-    iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE, byte_span,
-                              iree_allocator_null(), ref);
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  iree_status_t profile_status = iree_vm_bytecode_profile_allocate(
+      state->import_count, allocator, &state->profile);
+  if (!iree_status_is_ok(profile_status)) {
+    iree_allocator_free(allocator, state);
+    IREE_TRACE_ZONE_END(z0);
+    return profile_status;
   }
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
+  // Rodata is shared across all states.
+  state->rodata_ref_count = module->rodata_ref_count;
+  state->rodata_ref_table = module->rodata_ref_table;
 
   *out_module_state = (iree_vm_module_state_t*)state;
   IREE_TRACE_ZONE_END(z0);
@@ -708,17 +1019,124 @@ static void iree_vm_bytecode_module_free_state(
     iree_vm_ref_release(&state->global_ref_table[i]);
   }
 
-  // Ensure all rodata references are unused and deinitialized.
-  for (int i = 0; i < state->rodata_ref_count; ++i) {
-    iree_vm_buffer_t* ref = &state->rodata_ref_table[i];
-    iree_vm_buffer_deinitialize(ref);
-  }
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  iree_vm_bytecode_profile_free(state->profile, state->allocator);
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
 
   iree_allocator_free(state->allocator, module_state);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Snapshots the initialized globals of the module: the rwdata storage holding
+// primitive globals followed by each ref global.
+static iree_status_t iree_vm_bytecode_module_snapshot_state(
+    void* self, iree_vm_module_state_t* module_state,
+    iree_vm_state_writer_t* writer) {
+  iree_vm_bytecode_module_state_t* state =
+      (iree_vm_bytecode_module_state_t*)module_state;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, writer->write(writer->self,
+                        iree_make_const_byte_span(
+                            state->rwdata_storage.data,
+                            state->rwdata_storage.data_length)));
+  uint64_t global_ref_count = (uint64_t)state->global_ref_count;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, writer->write(writer->self,
+                        iree_make_const_byte_span(&global_ref_count,
+                                                  sizeof(global_ref_count))));
+  for (iree_host_size_t i = 0; i < state->global_ref_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, writer->write_ref(writer->self, &state->global_ref_table[i]),
+        "snapshotting ref global %" PRIhsz, i);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_bytecode_module_restore_state(
+    void* self, iree_vm_module_state_t* module_state,
+    iree_vm_state_reader_t* reader) {
+  iree_vm_bytecode_module_state_t* state =
+      (iree_vm_bytecode_module_state_t*)module_state;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_const_byte_span_t rwdata = iree_const_byte_span_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, reader->read(reader->self, &rwdata));
+  if (rwdata.data_length != state->rwdata_storage.data_length) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "snapshot rwdata size mismatch (snapshot=%" PRIhsz ", module=%" PRIhsz
+        "); snapshot was produced from a different module",
+        rwdata.data_length, state->rwdata_storage.data_length);
+  }
+  memcpy(state->rwdata_storage.data, rwdata.data, rwdata.data_length);
+
+  iree_const_byte_span_t count_data = iree_const_byte_span_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
+                                    reader->read(reader->self, &count_data));
+  uint64_t global_ref_count = 0;
+  if (count_data.data_length == sizeof(global_ref_count)) {
+    memcpy(&global_ref_count, count_data.data, sizeof(global_ref_count));
+  }
+  if (global_ref_count != (uint64_t)state->global_ref_count) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "snapshot ref global count mismatch (snapshot=%" PRIu64
+        ", module=%" PRIhsz "); snapshot was produced from a different module",
+        global_ref_count, state->global_ref_count);
+  }
+  for (iree_host_size_t i = 0; i < state->global_ref_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, reader->read_ref(reader->self, &state->global_ref_table[i]),
+        "restoring ref global %" PRIhsz, i);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Builds a marshaling shuffle for the given cconv |fragment|.
+// |out_shuffle| will have a length of UINT8_MAX if the fragment is variadic or
+// has more values than can be represented.
+static void iree_vm_bytecode_build_shuffle(
+    iree_string_view_t fragment, iree_vm_bytecode_shuffle_t* out_shuffle) {
+  out_shuffle->kinds = 0;
+  out_shuffle->length = UINT8_MAX;
+  uint64_t kinds = 0;
+  uint8_t length = 0;
+  for (iree_host_size_t i = 0; i < fragment.size; ++i) {
+    uint64_t kind = 0;
+    switch (fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_VOID:
+        continue;
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        kind = IREE_VM_BYTECODE_SHUFFLE_KIND_32;
+        break;
+      case IREE_VM_CCONV_TYPE_I64:
+      case IREE_VM_CCONV_TYPE_F64:
+        kind = IREE_VM_BYTECODE_SHUFFLE_KIND_64;
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        kind = IREE_VM_BYTECODE_SHUFFLE_KIND_REF;
+        break;
+      default:
+        return;  // variadic spans or unknown types use the slow path
+    }
+    if (length == IREE_VM_BYTECODE_SHUFFLE_MAX_LENGTH) return;
+    kinds |= kind << (2 * length);
+    ++length;
+  }
+  out_shuffle->kinds = kinds;
+  out_shuffle->length = length;
+}
+
 static iree_status_t iree_vm_bytecode_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -760,6 +1178,10 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Precompute the register shuffles used when calling the import.
+  iree_vm_bytecode_build_shuffle(import->arguments, &import->argument_shuffle);
+  iree_vm_bytecode_build_shuffle(import->results, &import->result_shuffle);
+
   return iree_ok_status();
 }
 
@@ -859,11 +1281,17 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   iree_vm_TypeDef_vec_t type_defs = iree_vm_BytecodeModuleDef_types(module_def);
   size_t type_table_size =
       iree_vm_TypeDef_vec_len(type_defs) * sizeof(iree_vm_type_def_t);
+  iree_host_size_t rodata_ref_count = iree_vm_RodataSegmentDef_vec_len(
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def));
+  iree_host_size_t rodata_table_offset = iree_host_align(
+      sizeof(iree_vm_bytecode_module_t) + type_table_size, iree_max_align_t);
 
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(allocator, sizeof(*module) + type_table_size,
-                                (void**)&module));
+      z0, iree_allocator_malloc(
+              allocator,
+              rodata_table_offset + rodata_ref_count * sizeof(iree_vm_buffer_t),
+              (void**)&module));
   module->allocator = allocator;
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
@@ -876,6 +1304,12 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
       iree_vm_BytecodeModuleDef_bytecode_data(module_def);
   module->bytecode_data = iree_make_const_byte_span(
       bytecode_data, flatbuffers_uint8_vec_len(bytecode_data));
+  const uint32_t bytecode_version_minor =
+      iree_vm_BytecodeModuleDef_bytecode_version(module_def) & 0xFFFF;
+  module->ref_move_bit_mask =
+      bytecode_version_minor >= IREE_VM_BYTECODE_VERSION_MINOR_REF_MOVES
+          ? IREE_REF_REGISTER_MOVE_BIT
+          : 0;
 
   module->archive_contents = archive_contents;
   module->archive_allocator = archive_allocator;
@@ -891,6 +1325,18 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     return resolve_status;
   }
 
+  module->rodata_ref_count = 0;
+  module->rodata_ref_table =
+      (iree_vm_buffer_t*)((uint8_t*)module + rodata_table_offset);
+  iree_status_t rodata_status =
+      iree_vm_bytecode_module_initialize_rodata(module, rodata_ref_count);
+  if (!iree_status_is_ok(rodata_status)) {
+    iree_vm_bytecode_module_deinitialize_rodata(module);
+    iree_allocator_free(allocator, module);
+    IREE_TRACE_ZONE_END(z0);
+    return rodata_status;
+  }
+
   iree_vm_module_initialize(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -910,6 +1356,8 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.notify = iree_vm_bytecode_module_notify;
+  module->interface.snapshot_state = iree_vm_bytecode_module_snapshot_state;
+  module->interface.restore_state = iree_vm_bytecode_module_restore_state;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
   module->interface.resume_call = iree_vm_bytecode_module_resume_call;
 
@@ -927,9 +1375,112 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   if (iree_status_is_ok(verify_status)) {
     *out_module = &module->interface;
   } else {
+    iree_vm_bytecode_module_deinitialize_rodata(module);
     iree_allocator_free(allocator, module);
   }
 
   IREE_TRACE_ZONE_END(z0);
   return verify_status;
 }
+
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Resolves the profile of bytecode |module| in |context|.
+static iree_status_t iree_vm_bytecode_module_resolve_profile(
+    iree_vm_context_t* context, iree_vm_module_t* module,
+    iree_vm_bytecode_profile_t** out_profile) {
+  *out_profile = NULL;
+  if (module->alloc_state != iree_vm_bytecode_module_alloc_state) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "module is not a bytecode module");
+  }
+  iree_vm_module_state_t* module_state = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_context_resolve_module_state(context, module, &module_state));
+  *out_profile = ((iree_vm_bytecode_module_state_t*)module_state)->profile;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_append_profile(
+    iree_vm_context_t* context, iree_vm_module_t* module,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(module);
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_vm_bytecode_profile_t* profile = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_resolve_profile(context, module, &profile));
+  iree_vm_bytecode_module_t* bytecode_module =
+      (iree_vm_bytecode_module_t*)module->self;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Snapshot the used sample slots so that formatting (which may be slow when
+  // resolving source locations) happens outside of the lock.
+  iree_vm_bytecode_profile_sample_t* samples = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      bytecode_module->allocator,
+      IREE_VM_BYTECODE_PROFILE_SAMPLE_CAPACITY * sizeof(*samples),
+      (void**)&samples);
+  iree_host_size_t sample_count = 0;
+  uint64_t total_sample_count = 0;
+  uint64_t dropped_sample_count = 0;
+  if (iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&profile->mutex);
+    for (iree_host_size_t i = 0; i < IREE_VM_BYTECODE_PROFILE_SAMPLE_CAPACITY;
+         ++i) {
+      if (profile->samples[i].depth == 0) continue;
+      samples[sample_count++] = profile->samples[i];
+    }
+    total_sample_count = profile->total_sample_count;
+    dropped_sample_count = profile->dropped_sample_count;
+    iree_slim_mutex_unlock(&profile->mutex);
+    qsort(samples, sample_count, sizeof(*samples),
+          iree_vm_bytecode_profile_sample_compare);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_string_view_t module_name =
+        iree_vm_bytecode_module_name(bytecode_module);
+    status = iree_string_builder_append_format(
+        builder,
+        "# module %.*s: %" PRIu64 " samples (%" PRIu64
+        " dropped) every %d branches\n",
+        (int)module_name.size, module_name.data, total_sample_count,
+        dropped_sample_count, IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_bytecode_profile_append_samples(bytecode_module, samples,
+                                                     sample_count, builder);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_bytecode_profile_append_imports(bytecode_module, profile,
+                                                     builder);
+  }
+
+  iree_allocator_free(bytecode_module->allocator, samples);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_reset_profile(
+    iree_vm_context_t* context, iree_vm_module_t* module) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(module);
+  iree_vm_bytecode_profile_t* profile = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_resolve_profile(context, module, &profile));
+  iree_slim_mutex_lock(&profile->mutex);
+  memset(profile->samples, 0, sizeof(profile->samples));
+  profile->total_sample_count = 0;
+  profile->dropped_sample_count = 0;
+  iree_slim_mutex_unlock(&profile->mutex);
+  for (iree_host_size_t i = 0; i < profile->import_count; ++i) {
+    iree_atomic_store_int64(&profile->imports[i].call_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&profile->imports[i].total_duration_ns, 0,
+                            iree_memory_order_relaxed);
+  }
+  return iree_ok_status();
+}
+
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
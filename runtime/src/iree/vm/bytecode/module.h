@@ -23,6 +23,26 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Appends a text report of the execution profile of bytecode |module| in
+// |context| to |builder|. Profiles are only recorded by invocations with the
+// IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION flag set.
+//
+// The report contains program counter samples in the collapsed stack format
+// consumed by flame graph tools, the source locations of the sampled pcs if
+// the module has a debug database, and the call count and host time of each
+// called import.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_append_profile(
+    iree_vm_context_t* context, iree_vm_module_t* module,
+    iree_string_builder_t* builder);
+
+// Clears the execution profile of bytecode |module| in |context|.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_reset_profile(
+    iree_vm_context_t* context, iree_vm_module_t* module);
+
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -11,6 +11,8 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/utils/isa.h"
 
@@ -34,6 +36,11 @@ typedef struct iree_vm_bytecode_module_t {
   // A pointer to the bytecode data embedded within the module.
   iree_const_byte_span_t bytecode_data;
 
+  // Mask applied to ref operand registers to test for the move bit.
+  // IREE_REF_REGISTER_MOVE_BIT if the bytecode version guarantees the move bits
+  // are only set on last uses and otherwise 0 so all operands are retained.
+  uint16_t ref_move_bit_mask;
+
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
 
@@ -49,11 +56,43 @@ typedef struct iree_vm_bytecode_module_t {
   // Loaded FlatBuffer module pointing into the archive contents.
   iree_vm_BytecodeModuleDef_table_t def;
 
+  // Initialized references to rodata segments.
+  // Rodata is immutable and shared by all contexts the module is used in so
+  // that per-context state only needs to hold mutable globals and imports.
+  // Stored in the module allocation following the type table.
+  iree_host_size_t rodata_ref_count;
+  iree_vm_buffer_t* rodata_ref_table;
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t type_table[];
 } iree_vm_bytecode_module_t;
 
+// Kind of value marshaled by one entry of an import shuffle.
+enum iree_vm_bytecode_shuffle_kind_e {
+  // 32-bit primitive value (i32/f32).
+  IREE_VM_BYTECODE_SHUFFLE_KIND_32 = 1u,
+  // 64-bit primitive value (i64/f64).
+  IREE_VM_BYTECODE_SHUFFLE_KIND_64 = 2u,
+  // iree_vm_ref_t value.
+  IREE_VM_BYTECODE_SHUFFLE_KIND_REF = 3u,
+};
+
+// Maximum number of values that can be marshaled with a precomputed shuffle.
+// Each value uses 2 bits of a uint64_t.
+#define IREE_VM_BYTECODE_SHUFFLE_MAX_LENGTH 32
+
+// A precomputed marshaling shuffle for a non-variadic cconv fragment.
+// Entry i (bits [2*i, 2*i+1]) of |kinds| is the iree_vm_bytecode_shuffle_kind_e
+// of the i-th register value. This avoids walking the cconv string (and its
+// void and type aliases) on every call.
+typedef struct iree_vm_bytecode_shuffle_t {
+  uint64_t kinds;
+  // Number of values in |kinds| or UINT8_MAX if the fragment could not be
+  // represented as a shuffle (variadic or too many values).
+  uint8_t length;
+} iree_vm_bytecode_shuffle_t;
+
 // A resolved and split import in the module state table.
 //
 // NOTE: a table of these are stored per module per context so ideally we'd
@@ -74,8 +113,69 @@ typedef struct iree_vm_bytecode_import_t {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Precomputed argument/result register shuffles used by vm.call to marshal
+  // values without parsing the cconv fragments.
+  iree_vm_bytecode_shuffle_t argument_shuffle;
+  iree_vm_bytecode_shuffle_t result_shuffle;
 } iree_vm_bytecode_import_t;
 
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Maximum number of unique sampled call stacks per module state.
+// Samples with new call stacks are counted as dropped once the table is full.
+// Must be a power of two.
+#define IREE_VM_BYTECODE_PROFILE_SAMPLE_CAPACITY 1024
+
+// Maximum number of frames recorded per sample. Deeper call stacks keep the
+// frames nearest to the sampled one and are reported as truncated.
+#define IREE_VM_BYTECODE_PROFILE_MAX_DEPTH 8
+
+// Number of samples taken with a single call stack and bytecode location.
+typedef struct iree_vm_bytecode_profile_sample_t {
+  // Number of frames in |frames| or 0 if the slot is unused.
+  uint16_t depth;
+  // Nonzero if frames beyond IREE_VM_BYTECODE_PROFILE_MAX_DEPTH were dropped.
+  uint16_t truncated;
+  // Offset of the sampled instruction within the bytecode of |frames[0]|.
+  uint32_t pc;
+  uint64_t count;
+  // Functions on the call stack from the sampled one (|frames[0]|, always an
+  // internal function of this module) towards the root. Callers may be in any
+  // module.
+  iree_vm_function_t frames[IREE_VM_BYTECODE_PROFILE_MAX_DEPTH];
+} iree_vm_bytecode_profile_sample_t;
+
+// Cumulative call count and host time spent in an import.
+// Time includes everything the import does before returning or yielding.
+typedef struct iree_vm_bytecode_import_profile_t {
+  iree_atomic_int64_t call_count;
+  iree_atomic_int64_t total_duration_ns;
+} iree_vm_bytecode_import_profile_t;
+
+// Execution profile of a module within a single context.
+// Thread-safe: invocations in concurrent contexts may record simultaneously.
+typedef struct iree_vm_bytecode_profile_t {
+  // Guards the sample table and counters.
+  iree_slim_mutex_t mutex;
+  uint64_t total_sample_count;
+  uint64_t dropped_sample_count;
+  // Open-addressed table of sample counts keyed by call stack and pc.
+  iree_vm_bytecode_profile_sample_t
+      samples[IREE_VM_BYTECODE_PROFILE_SAMPLE_CAPACITY];
+  // Import call profiles indexed by import ordinal.
+  iree_host_size_t import_count;
+  iree_vm_bytecode_import_profile_t imports[];
+} iree_vm_bytecode_profile_t;
+
+// Records a program counter sample at |pc| within the bytecode function
+// executing in |frame| along with the call stack leading to it.
+void iree_vm_bytecode_profile_record_sample(iree_vm_bytecode_profile_t* profile,
+                                            const iree_vm_stack_frame_t* frame,
+                                            iree_vm_source_offset_t pc);
+
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
 // Per-instance module state.
 // This is allocated with a provided allocator as a single flat allocation.
 // This struct is a prefix to the allocation pointing into the dynamic offsets
@@ -89,10 +189,8 @@ typedef struct iree_vm_bytecode_module_state_t {
   iree_host_size_t global_ref_count;
   iree_vm_ref_t* global_ref_table;
 
-  // TODO(benvanik): move to iree_vm_bytecode_module_t if always static.
-  // Initialized references to rodata segments.
-  // Right now these don't do much, however we can perform lazy caching and
-  // on-the-fly decompression using this information.
+  // References to the rodata segments shared across all states in
+  // iree_vm_bytecode_module_t::rodata_ref_table.
   iree_host_size_t rodata_ref_count;
   iree_vm_buffer_t* rodata_ref_table;
 
@@ -100,6 +198,11 @@ typedef struct iree_vm_bytecode_module_state_t {
   iree_host_size_t import_count;
   iree_vm_bytecode_import_t* import_table;
 
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  // Execution profile recorded by profiled invocations.
+  iree_vm_bytecode_profile_t* profile;
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
   // Allocator used for the state itself and any runtime allocations needed.
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
@@ -11,6 +11,7 @@
 #include "iree/vm/bytecode/module.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "iree/base/api.h"
@@ -18,6 +19,7 @@
 #include "iree/testing/status_matchers.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module_test_module_c.h"
+#include "iree/vm/native_module_cc.h"
 
 static bool operator==(const iree_vm_value_t& lhs,
                        const iree_vm_value_t& rhs) noexcept {
@@ -100,6 +102,7 @@ static std::vector<iree_vm_ref_t> MakeNullRefList(size_t count) {
 
 namespace {
 
+using iree::Status;
 using iree::StatusCode;
 using iree::StatusOr;
 using iree::testing::status::IsOkAndHolds;
@@ -107,6 +110,43 @@ using iree::testing::status::StatusIs;
 using iree::vm::ref;
 using testing::Eq;
 
+// Per-context state of the native module imported by the ref move tests.
+// Reports the reference count of a buffer owned by the test.
+class RefCountState final {
+ public:
+  explicit RefCountState(iree_vm_buffer_t* buffer) : buffer_(buffer) {}
+
+  StatusOr<int32_t> BufferRefCount() {
+    return iree_atomic_ref_count_load(&buffer_->ref_object.counter);
+  }
+
+ private:
+  iree_vm_buffer_t* buffer_;
+};
+
+static const iree::vm::NativeFunction<RefCountState> kRefCountFunctions[] = {
+    iree::vm::MakeNativeFunction("buffer_ref_count",
+                                 &RefCountState::BufferRefCount),
+};
+
+class RefCountModule final : public iree::vm::NativeModule<RefCountState> {
+ public:
+  RefCountModule(iree_vm_instance_t* instance, iree_vm_buffer_t* buffer)
+      : iree::vm::NativeModule<RefCountState>(
+            "native", /*version=*/0, instance, iree_allocator_system(),
+            iree::span<const iree::vm::NativeFunction<RefCountState>>(
+                kRefCountFunctions)),
+        buffer_(buffer) {}
+
+  StatusOr<std::unique_ptr<RefCountState>> CreateState(
+      iree_allocator_t host_allocator) override {
+    return std::make_unique<RefCountState>(buffer_);
+  }
+
+ private:
+  iree_vm_buffer_t* buffer_;
+};
+
 class VMBytecodeModuleTest : public ::testing::Test {
  protected:
   virtual void SetUp() {
@@ -203,6 +243,62 @@ class VMBytecodeModuleTest : public ::testing::Test {
     return outputs;
   }
 
+  // Replaces the context with one that resolves the optional native import
+  // used to observe the reference count of |buffer|.
+  Status UseRefCountModule(iree_vm_buffer_t* buffer) {
+    iree_vm_module_t* native_module =
+        (new RefCountModule(instance_, buffer))->interface();
+    iree_vm_context_release(context_);
+    context_ = nullptr;
+    iree_vm_module_t* modules[] = {native_module, bytecode_module_};
+    iree_status_t status = iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, IREE_ARRAYSIZE(modules), modules,
+        iree_allocator_system(), &context_);
+    iree_vm_module_release(native_module);
+    return status;
+  }
+
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+  // Invokes |function_name| (ProfileLoop or ProfileNested) for
+  // |iteration_count| iterations with |flags|.
+  Status RunProfileLoop(iree_vm_invocation_flags_t flags,
+                        int32_t iteration_count,
+                        const char* function_name = "ProfileLoop") {
+    ref<iree_vm_list_t> input_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             1, iree_allocator_system(),
+                                             &input_list));
+    iree_vm_value_t iteration_count_value =
+        iree_vm_value_make_i32(iteration_count);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_push_value(input_list.get(), &iteration_count_value));
+    ref<iree_vm_list_t> output_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             1, iree_allocator_system(),
+                                             &output_list));
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
+        bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view(function_name), &function));
+    return iree_vm_invoke(context_, function, flags, /*policy=*/nullptr,
+                          input_list.get(), output_list.get(),
+                          iree_allocator_system());
+  }
+
+  // Returns the profile report of the bytecode module in the context.
+  StatusOr<std::string> AppendProfile() {
+    iree_string_builder_t builder;
+    iree_string_builder_initialize(iree_allocator_system(), &builder);
+    iree_status_t status = iree_vm_bytecode_module_append_profile(
+        context_, bytecode_module_, &builder);
+    std::string report(iree_string_builder_buffer(&builder),
+                       iree_string_builder_size(&builder));
+    iree_string_builder_deinitialize(&builder);
+    IREE_RETURN_IF_ERROR(status);
+    return report;
+  }
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
   iree_vm_module_t* bytecode_module_ = nullptr;
@@ -228,4 +324,145 @@ TEST_F(VMBytecodeModuleTest, FuncIO600) {
               IsOkAndHolds(Eq(MakeNullRefList(600))));
 }
 
+TEST_F(VMBytecodeModuleTest, SnapshotRestore) {
+  IREE_ASSERT_OK(RunFunction("StateSet", MakeValuesList({123})).status());
+
+  iree_byte_span_t snapshot = iree_make_byte_span(NULL, 0);
+  IREE_ASSERT_OK(iree_vm_context_snapshot(context_, iree_vm_ref_codec_null(),
+                                          iree_allocator_system(), &snapshot));
+
+  // Replace the context with one restored from the snapshot; the globals
+  // should have the values set prior to the snapshot.
+  iree_vm_context_release(context_);
+  context_ = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create(instance_, IREE_VM_CONTEXT_FLAG_NONE,
+                                        iree_allocator_system(), &context_));
+  IREE_ASSERT_OK(iree_vm_context_register_modules_from_snapshot(
+      context_, 1, &bytecode_module_,
+      iree_make_const_byte_span(snapshot.data, snapshot.data_length),
+      iree_vm_ref_codec_null()));
+  iree_allocator_free(iree_allocator_system(), snapshot.data);
+
+  EXPECT_THAT(RunFunction("StateGet", std::vector<iree_vm_value_t>()),
+              IsOkAndHolds(Eq(MakeValuesList({123, 3}))));
+}
+
+// The argument register is moved into the global on its last use so the
+// reference count is one lower than when the register must stay live.
+TEST_F(VMBytecodeModuleTest, RefMoveLastUse) {
+  ref<iree_vm_buffer_t> buffer;
+  IREE_ASSERT_OK(iree_vm_buffer_create(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST, 4,
+                                       0, iree_allocator_system(), &buffer));
+  IREE_ASSERT_OK(UseRefCountModule(buffer.get()));
+
+  // While the call runs the buffer is referenced by the test, the input list,
+  // the global, and the argument register when it is not moved.
+  iree_vm_ref_t buffer_ref = iree_vm_buffer_retain_ref(buffer.get());
+  ref<iree_vm_list_t> input_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &input_list));
+  IREE_ASSERT_OK(iree_vm_list_push_ref_move(input_list.get(), &buffer_ref));
+  ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 2,
+                                     iree_allocator_system(), &output_list));
+
+  iree_vm_function_t last_use_function;
+  IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+      bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      IREE_SV("RefMoveLastUse"), &last_use_function));
+  IREE_ASSERT_OK(iree_vm_invoke(
+      context_, last_use_function, IREE_VM_INVOCATION_FLAG_NONE,
+      /*policy=*/nullptr, input_list.get(), output_list.get(),
+      iree_allocator_system()));
+  iree_vm_value_t last_use_count;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value(output_list.get(), 0, &last_use_count));
+
+  IREE_ASSERT_OK(iree_vm_list_resize(output_list.get(), 0));
+  iree_vm_function_t live_use_function;
+  IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+      bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      IREE_SV("RefMoveLiveUse"), &live_use_function));
+  IREE_ASSERT_OK(iree_vm_invoke(
+      context_, live_use_function, IREE_VM_INVOCATION_FLAG_NONE,
+      /*policy=*/nullptr, input_list.get(), output_list.get(),
+      iree_allocator_system()));
+  iree_vm_value_t live_use_count;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value(output_list.get(), 0, &live_use_count));
+  iree_vm_value_t live_use_length;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value(output_list.get(), 1, &live_use_length));
+
+  EXPECT_EQ(last_use_count.i32 + 1, live_use_count.i32);
+  // The non-moved argument survived the store and was still readable.
+  EXPECT_EQ(live_use_length.i32, 4);
+  // The global holds the reference.
+  EXPECT_THAT(RunFunction("RefMoveGet", std::vector<iree_vm_value_t>()),
+              IsOkAndHolds(Eq(MakeValuesList({4}))));
+}
+
+#if IREE_VM_EXECUTION_PROFILING_ENABLE
+
+// Only invocations with the profiling flag set record samples and import call
+// timings and resetting the profile clears both.
+TEST_F(VMBytecodeModuleTest, ProfileExecution) {
+  ref<iree_vm_buffer_t> buffer;
+  IREE_ASSERT_OK(iree_vm_buffer_create(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST, 4,
+                                       0, iree_allocator_system(), &buffer));
+  IREE_ASSERT_OK(UseRefCountModule(buffer.get()));
+
+  // Each iteration has a call and a branch and the loop runs for enough sample
+  // intervals that at least one sample lands regardless of where the thread
+  // countdown was left by prior invocations.
+  const int32_t iteration_count = IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL;
+
+  IREE_ASSERT_OK(RunProfileLoop(IREE_VM_INVOCATION_FLAG_NONE, iteration_count));
+  IREE_ASSERT_OK_AND_ASSIGN(std::string unprofiled_report, AppendProfile());
+  EXPECT_THAT(unprofiled_report, testing::HasSubstr(": 0 samples (0 dropped)"));
+  EXPECT_THAT(unprofiled_report,
+              testing::Not(testing::HasSubstr("native.buffer_ref_count")));
+
+  IREE_ASSERT_OK(RunProfileLoop(IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION,
+                                iteration_count));
+  IREE_ASSERT_OK_AND_ASSIGN(std::string profiled_report, AppendProfile());
+  EXPECT_THAT(profiled_report,
+              testing::Not(testing::HasSubstr(": 0 samples (0 dropped)")));
+  EXPECT_THAT(profiled_report,
+              testing::HasSubstr("bytecode_module_test.ProfileLoop;"
+                                 "bytecode_module_test.ProfileLoop+0x"));
+  EXPECT_THAT(profiled_report,
+              testing::HasSubstr("native.buffer_ref_count " +
+                                 std::to_string(iteration_count) + " "));
+
+  IREE_ASSERT_OK(
+      iree_vm_bytecode_module_reset_profile(context_, bytecode_module_));
+  IREE_ASSERT_OK_AND_ASSIGN(std::string reset_report, AppendProfile());
+  EXPECT_THAT(reset_report, testing::HasSubstr(": 0 samples (0 dropped)"));
+  EXPECT_THAT(reset_report,
+              testing::Not(testing::HasSubstr("native.buffer_ref_count")));
+}
+
+// Samples taken in a function called from another record the caller frames.
+TEST_F(VMBytecodeModuleTest, ProfileExecutionCallStack) {
+  ref<iree_vm_buffer_t> buffer;
+  IREE_ASSERT_OK(iree_vm_buffer_create(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST, 4,
+                                       0, iree_allocator_system(), &buffer));
+  IREE_ASSERT_OK(UseRefCountModule(buffer.get()));
+
+  const int32_t iteration_count = IREE_VM_EXECUTION_PROFILING_SAMPLE_INTERVAL;
+  IREE_ASSERT_OK(RunProfileLoop(IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION,
+                                iteration_count, "ProfileNested"));
+  IREE_ASSERT_OK_AND_ASSIGN(std::string report, AppendProfile());
+  EXPECT_THAT(report, testing::HasSubstr("bytecode_module_test.ProfileNested;"
+                                         "bytecode_module_test.ProfileLoop;"
+                                         "bytecode_module_test.ProfileLoop+0x"));
+  EXPECT_THAT(report,
+              testing::Not(testing::HasSubstr(
+                  "\nbytecode_module_test.ProfileLoop;"
+                  "bytecode_module_test.ProfileLoop+0x")));
+}
+
+#endif  // IREE_VM_EXECUTION_PROFILING_ENABLE
+
 }  // namespace
@@ -137,14 +137,14 @@ typedef enum {
   IREE_VM_OP_CORE_MinI64U = 0x7F,
   IREE_VM_OP_CORE_MaxI64S = 0x80,
   IREE_VM_OP_CORE_MaxI64U = 0x81,
-  IREE_VM_OP_CORE_RSV_0x82,
-  IREE_VM_OP_CORE_RSV_0x83,
-  IREE_VM_OP_CORE_RSV_0x84,
-  IREE_VM_OP_CORE_RSV_0x85,
-  IREE_VM_OP_CORE_RSV_0x86,
-  IREE_VM_OP_CORE_RSV_0x87,
-  IREE_VM_OP_CORE_RSV_0x88,
-  IREE_VM_OP_CORE_RSV_0x89,
+  IREE_VM_OP_CORE_CmpEQI32CondBranch = 0x82,
+  IREE_VM_OP_CORE_CmpNEI32CondBranch = 0x83,
+  IREE_VM_OP_CORE_CmpLTI32SCondBranch = 0x84,
+  IREE_VM_OP_CORE_CmpLTI32UCondBranch = 0x85,
+  IREE_VM_OP_CORE_CmpEQI64CondBranch = 0x86,
+  IREE_VM_OP_CORE_CmpNEI64CondBranch = 0x87,
+  IREE_VM_OP_CORE_CmpLTI64SCondBranch = 0x88,
+  IREE_VM_OP_CORE_CmpLTI64UCondBranch = 0x89,
   IREE_VM_OP_CORE_RSV_0x8A,
   IREE_VM_OP_CORE_RSV_0x8B,
   IREE_VM_OP_CORE_RSV_0x8C,
@@ -396,14 +396,14 @@ typedef enum {
     OPC(0x7F, MinI64U) \
     OPC(0x80, MaxI64S) \
     OPC(0x81, MaxI64U) \
-    RSV(0x82) \
-    RSV(0x83) \
-    RSV(0x84) \
-    RSV(0x85) \
-    RSV(0x86) \
-    RSV(0x87) \
-    RSV(0x88) \
-    RSV(0x89) \
+    OPC(0x82, CmpEQI32CondBranch) \
+    OPC(0x83, CmpNEI32CondBranch) \
+    OPC(0x84, CmpLTI32SCondBranch) \
+    OPC(0x85, CmpLTI32UCondBranch) \
+    OPC(0x86, CmpEQI64CondBranch) \
+    OPC(0x87, CmpNEI64CondBranch) \
+    OPC(0x88, CmpLTI64SCondBranch) \
+    OPC(0x89, CmpLTI64UCondBranch) \
     RSV(0x8A) \
     RSV(0x8B) \
     RSV(0x8C) \
@@ -39,7 +39,13 @@
 // Higher versions are disallowed as they occur when new ops are added that
 // otherwise cannot be executed by older runtimes.
 // Matches BytecodeEncoder::kVersionMinor in the compiler.
-#define IREE_VM_BYTECODE_VERSION_MINOR 0
+#define IREE_VM_BYTECODE_VERSION_MINOR 2
+
+// Minor bytecode version from which ref operand move bits are trusted.
+// Older compilers set move bits on operands that were still live and their
+// modules must always retain ref operands.
+// Matches BytecodeEncoder::kVersionMinorRefMoves in the compiler.
+#define IREE_VM_BYTECODE_VERSION_MINOR_REF_MOVES 2
 
 //===----------------------------------------------------------------------===//
 // Bytecode structural constants
@@ -0,0 +1,99 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/bytecode/utils/lz4.h"
+
+#include <string.h>
+
+// Minimum length of a match; encoded match lengths are relative to this.
+#define IREE_VM_LZ4_MIN_MATCH 4
+
+// Reads an extended length from |inout_ptr| and adds it to |inout_length|.
+// Extended lengths are a sequence of bytes terminated by one that is not 255.
+static bool iree_vm_lz4_read_length(const uint8_t** inout_ptr,
+                                    const uint8_t* end,
+                                    iree_host_size_t* inout_length) {
+  const uint8_t* ptr = *inout_ptr;
+  uint8_t value = 0;
+  do {
+    if (IREE_UNLIKELY(ptr >= end)) return false;
+    value = *ptr++;
+    *inout_length += value;
+  } while (value == 255);
+  *inout_ptr = ptr;
+  return true;
+}
+
+iree_status_t iree_vm_bytecode_lz4_decompress_block(
+    iree_const_byte_span_t source, iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* ip_end = source.data + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* op_end = target.data + target.data_length;
+  while (ip < ip_end) {
+    const uint8_t token = *ip++;
+
+    // Literals copied directly from the source.
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_vm_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "truncated LZ4 literal length");
+    }
+    if (IREE_UNLIKELY(literal_length > (iree_host_size_t)(ip_end - ip) ||
+                      literal_length > (iree_host_size_t)(op_end - op))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "LZ4 literals out of bounds");
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // The last sequence only contains literals.
+    if (ip == ip_end) break;
+
+    // Match copied from earlier in the output.
+    if (IREE_UNLIKELY(ip_end - ip < 2)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "truncated LZ4 match offset");
+    }
+    const iree_host_size_t offset = (iree_host_size_t)ip[0] |
+                                    ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (IREE_UNLIKELY(offset == 0 ||
+                      offset > (iree_host_size_t)(op - target.data))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "LZ4 match offset out of bounds");
+    }
+    iree_host_size_t match_length = token & 15;
+    if (match_length == 15 &&
+        !iree_vm_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "truncated LZ4 match length");
+    }
+    match_length += IREE_VM_LZ4_MIN_MATCH;
+    if (IREE_UNLIKELY(match_length > (iree_host_size_t)(op_end - op))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "LZ4 match out of bounds");
+    }
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+    } else {
+      // Overlapping matches repeat the last |offset| bytes.
+      for (iree_host_size_t i = 0; i < match_length; ++i) op[i] = match[i];
+    }
+    op += match_length;
+  }
+  if (IREE_UNLIKELY(op != op_end)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "LZ4 block decompressed to %" PRIhsz
+                            " bytes but expected %" PRIhsz,
+                            (iree_host_size_t)(op - target.data),
+                            target.data_length);
+  }
+  return iree_ok_status();
+}
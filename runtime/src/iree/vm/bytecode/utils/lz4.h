@@ -0,0 +1,29 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_VM_BYTECODE_UTILS_LZ4_H_
+#define IREE_VM_BYTECODE_UTILS_LZ4_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Decompresses a single LZ4 block (without a frame header or checksums) from
+// |source| into |target|. The block must decompress to exactly
+// |target.data_length| bytes. Malformed or truncated blocks are rejected
+// without reading or writing out of bounds.
+//
+// Format: https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+iree_status_t iree_vm_bytecode_lz4_decompress_block(
+    iree_const_byte_span_t source, iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_BYTECODE_UTILS_LZ4_H_
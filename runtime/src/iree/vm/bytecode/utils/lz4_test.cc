@@ -0,0 +1,90 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/bytecode/utils/lz4.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// "iree vm bytecode rodata " repeated 20 times followed by "tail!" as produced
+// by the reference lz4 tool. Contains extended literal and match lengths and
+// an overlapping match.
+static const uint8_t kBlock[] = {
+    0xff, 0x09, 0x69, 0x72, 0x65, 0x65, 0x20, 0x76, 0x6d, 0x20, 0x62, 0x79,
+    0x74, 0x65, 0x63, 0x6f, 0x64, 0x65, 0x20, 0x72, 0x6f, 0x64, 0x61, 0x74,
+    0x61, 0x20, 0x18, 0x00, 0xff, 0xb6, 0x50, 0x74, 0x61, 0x69, 0x6c, 0x21,
+};
+
+static std::string ExpectedContents() {
+  std::string contents;
+  for (int i = 0; i < 20; ++i) contents += "iree vm bytecode rodata ";
+  contents += "tail!";
+  return contents;
+}
+
+static iree_status_t Decompress(const std::vector<uint8_t>& block,
+                                std::vector<uint8_t>* target) {
+  return iree_vm_bytecode_lz4_decompress_block(
+      iree_make_const_byte_span(block.data(), block.size()),
+      iree_make_byte_span(target->data(), target->size()));
+}
+
+TEST(LZ4Test, Decompress) {
+  std::vector<uint8_t> block(kBlock, kBlock + sizeof(kBlock));
+  std::string expected = ExpectedContents();
+  std::vector<uint8_t> target(expected.size());
+  IREE_ASSERT_OK(Decompress(block, &target));
+  EXPECT_EQ(expected, std::string(target.begin(), target.end()));
+}
+
+TEST(LZ4Test, Empty) {
+  std::vector<uint8_t> block = {0x00};
+  std::vector<uint8_t> target;
+  IREE_EXPECT_OK(Decompress(block, &target));
+}
+
+// The decompressed size must match exactly.
+TEST(LZ4Test, SizeMismatch) {
+  std::vector<uint8_t> block(kBlock, kBlock + sizeof(kBlock));
+  std::vector<uint8_t> small_target(ExpectedContents().size() - 1);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        Decompress(block, &small_target));
+  std::vector<uint8_t> large_target(ExpectedContents().size() + 1);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        Decompress(block, &large_target));
+}
+
+TEST(LZ4Test, Truncated) {
+  std::vector<uint8_t> target(ExpectedContents().size());
+  for (size_t length = 1; length < sizeof(kBlock); ++length) {
+    std::vector<uint8_t> block(kBlock, kBlock + length);
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                          Decompress(block, &target));
+  }
+}
+
+// Matches may not reference data before the start of the output.
+TEST(LZ4Test, OffsetOutOfBounds) {
+  std::vector<uint8_t> block = {0x10, 'a', 0x02, 0x00, 0x00};
+  std::vector<uint8_t> target(5);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        Decompress(block, &target));
+  block[2] = 0x00;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        Decompress(block, &target));
+  block[2] = 0x01;
+  IREE_EXPECT_OK(Decompress(block, &target));
+  EXPECT_EQ("aaaaa", std::string(target.begin(), target.end()));
+}
+
+}  // namespace
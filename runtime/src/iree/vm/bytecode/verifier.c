@@ -65,6 +65,28 @@ iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
        ++i) {
     iree_vm_RodataSegmentDef_table_t segment =
         iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    switch (iree_vm_RodataSegmentDef_compression_type_type(segment)) {
+      case iree_vm_CompressionTypeDef_NONE:
+      case iree_vm_CompressionTypeDef_UncompressedDataDef:
+        break;
+      case iree_vm_CompressionTypeDef_LZ4BlockDataDef: {
+        iree_vm_LZ4BlockDataDef_table_t lz4_def =
+            (iree_vm_LZ4BlockDataDef_table_t)
+                iree_vm_RodataSegmentDef_compression_type(segment);
+        if (iree_vm_LZ4BlockDataDef_uncompressed_length(lz4_def) >
+            IREE_HOST_SIZE_MAX) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "rodata[%zu] uncompressed length exceeds the host size", i);
+        }
+        break;
+      }
+      default:
+        return iree_make_status(
+            IREE_STATUS_UNIMPLEMENTED,
+            "rodata[%zu] compression type %d unsupported", i,
+            (int)iree_vm_RodataSegmentDef_compression_type_type(segment));
+    }
     if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
       continue;  // embedded data is verified by FlatBuffers
     }
@@ -1545,6 +1567,26 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
       verify_state->in_block = 0;  // terminator
     });
 
+#define VERIFY_OP_CORE_CMP_COND_BRANCH(op_name, op_type) \
+  VERIFY_OP(CORE, op_name, {                             \
+    VM_VerifyOperandReg##op_type(lhs);                   \
+    VM_VerifyOperandReg##op_type(rhs);                   \
+    VM_VerifyBranchTarget(true_dest_pc);                 \
+    VM_VerifyBranchOperands(true_operands);              \
+    VM_VerifyBranchTarget(false_dest_pc);                \
+    VM_VerifyBranchOperands(false_operands);             \
+    verify_state->in_block = 0; /* terminator */         \
+  });
+
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, I64);
+
     VERIFY_OP(CORE, Call, {
       VM_VerifyFuncAttr(callee_ordinal);
       VM_VerifyVariadicOperandsAny(operands);
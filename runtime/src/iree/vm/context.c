@@ -12,7 +12,9 @@
 
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/debugging.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
+#include "iree/vm/buffer.h"
 
 struct iree_vm_context_t {
   iree_atomic_ref_count_t ref_count;
@@ -152,10 +154,29 @@ static iree_status_t iree_vm_context_check_module_dependency(
       (int)dependency->name.size, dependency->name.data);
 }
 
+// Returns the index of |module| in the |context| module list or -1 if the
+// module is not registered.
+static int iree_vm_context_module_index(const iree_vm_context_t* context,
+                                        const iree_vm_module_t* module) {
+  for (int i = 0; i < context->list.count; ++i) {
+    if (context->list.modules[i] == module) return i;
+  }
+  return -1;
+}
+
+// Resolves all imports of |module| against the modules already registered in
+// |context|.
+//
+// If |init_waves| is provided it contains the initialization wave of each
+// module in the context list (0 for modules that are already initialized) and
+// |out_init_wave| receives the wave after the latest module any import was
+// resolved from.
 static iree_status_t iree_vm_context_resolve_module_imports(
     iree_vm_context_t* context, iree_vm_module_t* module,
-    iree_vm_module_state_t* module_state) {
+    iree_vm_module_state_t* module_state, const iree_host_size_t* init_waves,
+    iree_host_size_t* out_init_wave) {
   IREE_TRACE_ZONE_BEGIN(z0);
+  if (out_init_wave) *out_init_wave = 1;
 
   // Check module presence/versions before individual imports.
   // This gives better error messages ("requires hal module version 4") than
@@ -236,6 +257,15 @@ static iree_status_t iree_vm_context_resolve_module_imports(
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, module->resolve_import(module->self, module_state, i,
                                    &import_function, &import_signature));
+
+    if (init_waves) {
+      int provider_index =
+          iree_vm_context_module_index(context, import_function.module);
+      if (provider_index >= 0 &&
+          init_waves[provider_index] + 1 > *out_init_wave) {
+        *out_init_wave = init_waves[provider_index] + 1;
+      }
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -412,10 +442,8 @@ IREE_API_EXPORT iree_vm_module_t* iree_vm_context_module_at(
   return context->list.modules[i];
 }
 
-IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
-    iree_vm_context_t* context, iree_host_size_t module_count,
-    iree_vm_module_t** modules) {
-  IREE_ASSERT_ARGUMENT(context);
+static iree_status_t iree_vm_context_verify_module_list(
+    iree_host_size_t module_count, iree_vm_module_t** modules) {
   if (!modules && module_count > 1) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "modules/module_count mismatch");
@@ -426,14 +454,14 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
                               "modules[%zu] is null", i);
     }
   }
-  if (!module_count) return iree_ok_status();
-
-  IREE_TRACE_ZONE_BEGIN(z0);
+  return iree_ok_status();
+}
 
-  // Try growing both our storage lists first, if needed.
+// Grows the context module storage lists to fit |module_count| more modules.
+static iree_status_t iree_vm_context_reserve_modules(
+    iree_vm_context_t* context, iree_host_size_t module_count) {
   if (context->list.count + module_count > context->list.capacity) {
     if (context->is_frozen) {
-      IREE_TRACE_ZONE_END(z0);
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "context was allocated as static and cannot "
                               "register modules after creation");
@@ -444,16 +472,17 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
       new_capacity = context->list.capacity * 2;
     }
     iree_vm_module_t** new_module_list = NULL;
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_allocator_malloc(context->allocator,
-                                  sizeof(iree_vm_module_t*) * new_capacity,
-                                  (void**)&new_module_list));
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        context->allocator, sizeof(iree_vm_module_t*) * new_capacity,
+        (void**)&new_module_list));
     iree_vm_module_state_t** new_module_state_list = NULL;
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0,
-        iree_allocator_malloc(context->allocator,
-                              sizeof(iree_vm_module_state_t*) * new_capacity,
-                              (void**)&new_module_state_list));
+    iree_status_t status = iree_allocator_malloc(
+        context->allocator, sizeof(iree_vm_module_state_t*) * new_capacity,
+        (void**)&new_module_state_list);
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(context->allocator, new_module_list);
+      return status;
+    }
     memcpy(new_module_list, context->list.modules,
            sizeof(iree_vm_module_t*) * context->list.count);
     memcpy(new_module_state_list, context->list.module_states,
@@ -468,6 +497,279 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
     context->list.module_states = new_module_state_list;
     context->list.capacity = new_capacity;
   }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Context snapshots
+//===----------------------------------------------------------------------===//
+// Snapshots are a header followed by a stream of length-prefixed blobs:
+//   header: iree_vm_context_snapshot_header_t
+//   per module supporting snapshots: blob(name), module-defined blobs...
+// Refs are written as blob(type name) followed by type-defined blobs; null refs
+// have an empty type name. Blob lengths are stored as uint64_t and both the
+// length and the contents are padded to IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT so
+// that the contents of a memory-mapped snapshot are suitably aligned.
+
+#define IREE_VM_CONTEXT_SNAPSHOT_MAGIC 0x53565249u  // 'IRVS'
+#define IREE_VM_CONTEXT_SNAPSHOT_VERSION 0u
+#define IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT 16
+
+typedef struct iree_vm_context_snapshot_header_t {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t reserved;
+} iree_vm_context_snapshot_header_t;
+static_assert(sizeof(iree_vm_context_snapshot_header_t) %
+                      IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT ==
+                  0,
+              "header must preserve blob alignment");
+
+typedef struct iree_vm_context_snapshot_writer_t {
+  iree_vm_context_t* context;
+  iree_vm_ref_codec_t ref_codec;
+  iree_allocator_t allocator;
+  // Snapshot contents; data_length is the used size.
+  iree_byte_span_t storage;
+  // Total allocated capacity of storage.
+  iree_host_size_t capacity;
+} iree_vm_context_snapshot_writer_t;
+
+// Appends |data| to the snapshot padded to the snapshot alignment.
+static iree_status_t iree_vm_context_snapshot_writer_append(
+    iree_vm_context_snapshot_writer_t* writer, iree_const_byte_span_t data) {
+  iree_host_size_t padded_length =
+      iree_host_align(data.data_length, IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT);
+  iree_host_size_t required_length =
+      writer->storage.data_length + padded_length;
+  if (required_length > writer->capacity) {
+    iree_host_size_t new_capacity = iree_max(
+        iree_max((iree_host_size_t)4096, writer->capacity * 2),
+        required_length);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        writer->allocator, new_capacity, (void**)&writer->storage.data));
+    writer->capacity = new_capacity;
+  }
+  uint8_t* target = writer->storage.data + writer->storage.data_length;
+  if (data.data_length > 0) memcpy(target, data.data, data.data_length);
+  memset(target + data.data_length, 0, padded_length - data.data_length);
+  writer->storage.data_length = required_length;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_context_snapshot_writer_write(
+    void* self, iree_const_byte_span_t data) {
+  iree_vm_context_snapshot_writer_t* writer =
+      (iree_vm_context_snapshot_writer_t*)self;
+  uint64_t length = (uint64_t)data.data_length;
+  IREE_RETURN_IF_ERROR(iree_vm_context_snapshot_writer_append(
+      writer, iree_make_const_byte_span(&length, sizeof(length))));
+  return iree_vm_context_snapshot_writer_append(writer, data);
+}
+
+static iree_status_t iree_vm_context_snapshot_writer_write_ref(
+    void* self, const iree_vm_ref_t* ref) {
+  iree_vm_context_snapshot_writer_t* writer =
+      (iree_vm_context_snapshot_writer_t*)self;
+  if (iree_vm_ref_is_null(ref)) {
+    return iree_vm_context_snapshot_writer_write(writer,
+                                                 iree_const_byte_span_empty());
+  }
+  iree_string_view_t type_name = iree_vm_ref_type_name(ref->type);
+  IREE_RETURN_IF_ERROR(iree_vm_context_snapshot_writer_write(
+      writer, iree_make_const_byte_span(type_name.data, type_name.size)));
+
+  // VM buffers are handled here as they are used for many constants.
+  if (iree_vm_buffer_isa(*ref)) {
+    iree_vm_buffer_t* buffer = iree_vm_buffer_deref(*ref);
+    uint32_t access = (uint32_t)buffer->access;
+    IREE_RETURN_IF_ERROR(iree_vm_context_snapshot_writer_write(
+        writer, iree_make_const_byte_span(&access, sizeof(access))));
+    return iree_vm_context_snapshot_writer_write(
+        writer, iree_make_const_byte_span(iree_vm_buffer_data(buffer),
+                                          iree_vm_buffer_length(buffer)));
+  }
+
+  if (!writer->ref_codec.encode) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "no ref codec provided to snapshot '%.*s' values",
+                            (int)type_name.size, type_name.data);
+  }
+  iree_vm_state_writer_t state_writer = {
+      .self = writer,
+      .write = iree_vm_context_snapshot_writer_write,
+      .write_ref = iree_vm_context_snapshot_writer_write_ref,
+  };
+  return writer->ref_codec.encode(writer->ref_codec.self, ref, &state_writer);
+}
+
+typedef struct iree_vm_context_snapshot_reader_t {
+  iree_vm_context_t* context;
+  iree_vm_ref_codec_t ref_codec;
+  // Remaining snapshot contents.
+  iree_const_byte_span_t remaining;
+} iree_vm_context_snapshot_reader_t;
+
+static iree_status_t iree_vm_context_snapshot_reader_initialize(
+    iree_vm_context_t* context, iree_const_byte_span_t snapshot,
+    iree_vm_ref_codec_t ref_codec,
+    iree_vm_context_snapshot_reader_t* out_reader) {
+  iree_vm_context_snapshot_header_t header;
+  if (snapshot.data_length < sizeof(header)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "snapshot too small to contain a header");
+  }
+  memcpy(&header, snapshot.data, sizeof(header));
+  if (header.magic != IREE_VM_CONTEXT_SNAPSHOT_MAGIC) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "snapshot magic mismatch; not a context snapshot");
+  }
+  if (header.version != IREE_VM_CONTEXT_SNAPSHOT_VERSION) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "snapshot version %u not supported (expected %u)",
+                            header.version, IREE_VM_CONTEXT_SNAPSHOT_VERSION);
+  }
+  out_reader->context = context;
+  out_reader->ref_codec = ref_codec;
+  out_reader->remaining = iree_make_const_byte_span(
+      snapshot.data + sizeof(header), snapshot.data_length - sizeof(header));
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_context_snapshot_reader_read(
+    void* self, iree_const_byte_span_t* out_data) {
+  iree_vm_context_snapshot_reader_t* reader =
+      (iree_vm_context_snapshot_reader_t*)self;
+  *out_data = iree_const_byte_span_empty();
+  uint64_t length = 0;
+  iree_host_size_t length_size = iree_host_align(
+      sizeof(length), IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT);
+  if (reader->remaining.data_length < length_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "snapshot truncated reading blob length");
+  }
+  memcpy(&length, reader->remaining.data, sizeof(length));
+  iree_host_size_t available = reader->remaining.data_length - length_size;
+  if (length > available ||
+      iree_host_align((iree_host_size_t)length,
+                      IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT) > available) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "snapshot truncated reading blob of %" PRIu64
+                            " bytes",
+                            length);
+  }
+  iree_host_size_t padded_length =
+      iree_host_align((iree_host_size_t)length,
+                      IREE_VM_CONTEXT_SNAPSHOT_ALIGNMENT);
+  *out_data = iree_make_const_byte_span(reader->remaining.data + length_size,
+                                        (iree_host_size_t)length);
+  reader->remaining.data += length_size + padded_length;
+  reader->remaining.data_length -= length_size + padded_length;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_context_snapshot_reader_read_ref(
+    void* self, iree_vm_ref_t* out_ref) {
+  iree_vm_context_snapshot_reader_t* reader =
+      (iree_vm_context_snapshot_reader_t*)self;
+  iree_const_byte_span_t type_name_data = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(
+      iree_vm_context_snapshot_reader_read(reader, &type_name_data));
+  if (type_name_data.data_length == 0) {
+    iree_vm_ref_release(out_ref);
+    return iree_ok_status();
+  }
+  iree_string_view_t type_name = iree_make_string_view(
+      (const char*)type_name_data.data, type_name_data.data_length);
+  iree_vm_ref_type_t type =
+      iree_vm_instance_lookup_type(reader->context->instance, type_name);
+  if (!type) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "snapshot ref type '%.*s' not registered",
+                            (int)type_name.size, type_name.data);
+  }
+
+  if (type == iree_vm_buffer_type()) {
+    iree_const_byte_span_t access_data = iree_const_byte_span_empty();
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_snapshot_reader_read(reader, &access_data));
+    uint32_t access = 0;
+    if (access_data.data_length != sizeof(access)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "malformed snapshot buffer access");
+    }
+    memcpy(&access, access_data.data, sizeof(access));
+    iree_const_byte_span_t contents = iree_const_byte_span_empty();
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_snapshot_reader_read(reader, &contents));
+    iree_vm_buffer_t* buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_vm_buffer_create(
+        (iree_vm_buffer_access_t)access, contents.data_length,
+        /*alignment=*/0, reader->context->allocator, &buffer));
+    memcpy(iree_vm_buffer_data(buffer), contents.data, contents.data_length);
+    iree_vm_ref_t buffer_ref = iree_vm_buffer_move_ref(buffer);
+    iree_vm_ref_move(&buffer_ref, out_ref);
+    return iree_ok_status();
+  }
+
+  if (!reader->ref_codec.decode) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "no ref codec provided to restore '%.*s' values",
+                            (int)type_name.size, type_name.data);
+  }
+  iree_vm_state_reader_t state_reader = {
+      .self = reader,
+      .read = iree_vm_context_snapshot_reader_read,
+      .read_ref = iree_vm_context_snapshot_reader_read_ref,
+  };
+  return reader->ref_codec.decode(reader->ref_codec.self, type, &state_reader,
+                                  out_ref);
+}
+
+// Restores the state of |module| from the next entry in |reader|.
+static iree_status_t iree_vm_context_restore_module_state(
+    iree_vm_context_t* context, iree_vm_module_t* module,
+    iree_vm_module_state_t* module_state, iree_vm_state_reader_t* reader) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_string_view_t module_name = iree_vm_module_name(module);
+  iree_const_byte_span_t name_data = iree_const_byte_span_empty();
+  iree_status_t status = reader->read(reader->self, &name_data);
+  if (iree_status_is_ok(status) &&
+      !iree_string_view_equal(
+          module_name, iree_make_string_view((const char*)name_data.data,
+                                             name_data.data_length))) {
+    status = iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "snapshot module order mismatch; expected '%.*s' but found '%.*s'",
+        (int)module_name.size, module_name.data, (int)name_data.data_length,
+        (const char*)name_data.data);
+  }
+  if (iree_status_is_ok(status)) {
+    status = module->restore_state(module->self, module_state, reader);
+  }
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(status, "restoring module '%.*s' state",
+                                    (int)module_name.size, module_name.data);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Registers |modules| with |context| and initializes them in order.
+// If |reader| is provided then modules that support restoring their state have
+// it read from the snapshot in place of running their __init function.
+static iree_status_t iree_vm_context_register_modules_internal(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_vm_state_reader_t* reader) {
+  IREE_RETURN_IF_ERROR(
+      iree_vm_context_verify_module_list(module_count, modules));
+  if (!module_count) return iree_ok_status();
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Try growing both our storage lists first, if needed.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_context_reserve_modules(context, module_count));
 
   // VM stack used to call into module __init methods.
   IREE_VM_INLINE_STACK_INITIALIZE(
@@ -500,8 +802,9 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
     context->list.module_states[original_count + i] = module_state;
 
     // Resolve imports for the modules.
-    status =
-        iree_vm_context_resolve_module_imports(context, module, module_state);
+    status = iree_vm_context_resolve_module_imports(
+        context, module, module_state, /*init_waves=*/NULL,
+        /*out_init_wave=*/NULL);
     if (!iree_status_is_ok(status)) {
       // Cleanup handled below.
       iree_string_view_t module_name = iree_vm_module_name(module);
@@ -513,11 +816,17 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
 
     ++context->list.count;
 
-    // Run module __init functions, if present.
+    // Restore module state from the snapshot or run module __init functions,
+    // if present.
     // As initialization functions may reference imports we need to perform
     // all of these after we have resolved the imports above.
-    status = iree_vm_context_run_function(context, stack, module,
-                                          iree_make_cstring_view("__init"));
+    if (reader && module->restore_state) {
+      status = iree_vm_context_restore_module_state(context, module,
+                                                    module_state, reader);
+    } else {
+      status = iree_vm_context_run_function(context, stack, module,
+                                            iree_make_cstring_view("__init"));
+    }
     if (!iree_status_is_ok(status)) {
       // Cleanup handled below.
       break;
@@ -538,6 +847,270 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules) {
+  IREE_ASSERT_ARGUMENT(context);
+  return iree_vm_context_register_modules_internal(context, module_count,
+                                                   modules, /*reader=*/NULL);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_context_register_modules_from_snapshot(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_const_byte_span_t snapshot,
+    iree_vm_ref_codec_t ref_codec) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_context_snapshot_reader_t snapshot_reader;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_context_snapshot_reader_initialize(
+              context, snapshot, ref_codec, &snapshot_reader));
+  iree_vm_state_reader_t reader = {
+      .self = &snapshot_reader,
+      .read = iree_vm_context_snapshot_reader_read,
+      .read_ref = iree_vm_context_snapshot_reader_read_ref,
+  };
+  iree_status_t status = iree_vm_context_register_modules_internal(
+      context, module_count, modules, &reader);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_context_snapshot(
+    iree_vm_context_t* context, iree_vm_ref_codec_t ref_codec,
+    iree_allocator_t allocator, iree_byte_span_t* out_snapshot) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_snapshot);
+  *out_snapshot = iree_make_byte_span(NULL, 0);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_context_snapshot_writer_t snapshot_writer = {
+      .context = context,
+      .ref_codec = ref_codec,
+      .allocator = allocator,
+      .storage = iree_make_byte_span(NULL, 0),
+      .capacity = 0,
+  };
+  iree_vm_state_writer_t writer = {
+      .self = &snapshot_writer,
+      .write = iree_vm_context_snapshot_writer_write,
+      .write_ref = iree_vm_context_snapshot_writer_write_ref,
+  };
+
+  // Header.
+  iree_vm_context_snapshot_header_t header = {
+      .magic = IREE_VM_CONTEXT_SNAPSHOT_MAGIC,
+      .version = IREE_VM_CONTEXT_SNAPSHOT_VERSION,
+      .reserved = 0,
+  };
+  iree_status_t status = iree_vm_context_snapshot_writer_append(
+      &snapshot_writer, iree_make_const_byte_span(&header, sizeof(header)));
+
+  // Each module that supports snapshots writes its name followed by its state.
+  for (iree_host_size_t i = 0;
+       i < context->list.count && iree_status_is_ok(status); ++i) {
+    iree_vm_module_t* module = context->list.modules[i];
+    if (!module->snapshot_state) continue;
+    iree_string_view_t module_name = iree_vm_module_name(module);
+    status = iree_vm_context_snapshot_writer_write(
+        &snapshot_writer,
+        iree_make_const_byte_span(module_name.data, module_name.size));
+    if (iree_status_is_ok(status)) {
+      status = module->snapshot_state(module->self,
+                                      context->list.module_states[i], &writer);
+    }
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(status, "snapshotting module '%.*s'",
+                                      (int)module_name.size, module_name.data);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    out_snapshot->data = snapshot_writer.storage.data;
+    out_snapshot->data_length = snapshot_writer.storage.data_length;
+  } else {
+    iree_allocator_free(allocator, snapshot_writer.storage.data);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// A set of modules whose __init functions run concurrently.
+typedef struct iree_vm_context_init_wave_t {
+  iree_vm_context_t* context;
+  iree_host_size_t module_count;
+  iree_vm_module_t** modules;
+  // Set by the dispatch completion callback.
+  bool is_done;
+  iree_status_t status;
+} iree_vm_context_init_wave_t;
+
+static iree_status_t iree_vm_context_init_wave_workgroup(
+    void* user_data, iree_loop_t loop, uint32_t workgroup_x,
+    uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_vm_context_init_wave_t* wave = (iree_vm_context_init_wave_t*)user_data;
+  iree_vm_context_t* context = wave->context;
+  iree_vm_module_t* module = wave->modules[workgroup_x];
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, iree_vm_module_name(module).data,
+                              iree_vm_module_name(module).size);
+
+  // Each initializer needs its own VM stack as they may run concurrently.
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack,
+      context->flags & IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION
+          ? IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION
+          : IREE_VM_INVOCATION_FLAG_NONE,
+      iree_vm_context_state_resolver(context), context->allocator);
+  iree_status_t status = iree_vm_context_run_function(
+      context, stack, module, iree_make_cstring_view("__init"));
+  iree_vm_stack_deinitialize(stack);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_vm_context_init_wave_complete(void* user_data,
+                                                        iree_loop_t loop,
+                                                        iree_status_t status) {
+  iree_vm_context_init_wave_t* wave = (iree_vm_context_init_wave_t*)user_data;
+  wave->status = status;
+  wave->is_done = true;
+  return iree_ok_status();
+}
+
+// Runs the __init functions of all modules in |wave| on |loop| and waits for
+// them to complete.
+static iree_status_t iree_vm_context_run_init_wave(
+    iree_vm_context_init_wave_t* wave, iree_loop_t loop) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)wave->module_count);
+  wave->is_done = false;
+  wave->status = iree_ok_status();
+  const uint32_t workgroup_count[3] = {(uint32_t)wave->module_count, 1, 1};
+  iree_status_t status = iree_loop_dispatch(
+      loop, workgroup_count, iree_vm_context_init_wave_workgroup,
+      iree_vm_context_init_wave_complete, wave);
+  if (iree_status_is_ok(status)) {
+    status = iree_loop_drain(loop, iree_infinite_timeout());
+  }
+  if (iree_status_is_ok(status) && !wave->is_done) {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "loop drained without completing module "
+                              "initialization; loop must support draining");
+  }
+  if (iree_status_is_ok(status)) {
+    status = wave->status;
+  } else {
+    iree_status_ignore(wave->status);
+  }
+  wave->status = iree_ok_status();
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_context_register_modules_concurrently(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_loop_t loop) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_RETURN_IF_ERROR(
+      iree_vm_context_verify_module_list(module_count, modules));
+  if (!module_count) return iree_ok_status();
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)module_count);
+
+  // Try growing both our storage lists first, if needed.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_context_reserve_modules(context, module_count));
+
+  // Scratch storage for the wave of each module in the list (with existing
+  // modules in wave 0) and the modules in the wave being initialized.
+  iree_host_size_t original_count = context->list.count;
+  iree_host_size_t* init_waves = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              context->allocator,
+              sizeof(iree_host_size_t) * (original_count + module_count) +
+                  sizeof(iree_vm_module_t*) * module_count,
+              (void**)&init_waves));
+  memset(init_waves, 0, sizeof(iree_host_size_t) * original_count);
+  iree_vm_module_t** wave_modules =
+      (iree_vm_module_t**)(init_waves + original_count + module_count);
+
+  // Retain all modules, allocate their state, and resolve imports. This is
+  // done in order as imports may only refer to modules registered earlier.
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t wave_count = 0;
+  iree_host_size_t i = 0;
+  for (i = 0; i < module_count; ++i) {
+    iree_vm_module_t* module = modules[i];
+    context->list.modules[original_count + i] = module;
+    context->list.module_states[original_count + i] = NULL;
+
+    iree_vm_module_retain(module);
+
+    // Allocate module state.
+    iree_vm_module_state_t* module_state = NULL;
+    status =
+        module->alloc_state(module->self, context->allocator, &module_state);
+    if (!iree_status_is_ok(status)) {
+      // Cleanup handled below.
+      break;
+    }
+    context->list.module_states[original_count + i] = module_state;
+
+    // Resolve imports for the modules and find the wave they initialize in.
+    iree_host_size_t init_wave = 0;
+    status = iree_vm_context_resolve_module_imports(
+        context, module, module_state, init_waves, &init_wave);
+    if (!iree_status_is_ok(status)) {
+      // Cleanup handled below.
+      iree_string_view_t module_name = iree_vm_module_name(module);
+      (void)module_name;
+      status = iree_status_annotate_f(status, "resolving module '%.*s' imports",
+                                      (int)module_name.size, module_name.data);
+      break;
+    }
+    init_waves[original_count + i] = init_wave;
+    if (init_wave > wave_count) wave_count = init_wave;
+
+    ++context->list.count;
+  }
+
+  // Run module __init functions, if present, one wave at a time.
+  iree_vm_context_init_wave_t wave;
+  memset(&wave, 0, sizeof(wave));
+  wave.context = context;
+  wave.modules = wave_modules;
+  for (iree_host_size_t w = 1; iree_status_is_ok(status) && w <= wave_count;
+       ++w) {
+    wave.module_count = 0;
+    for (iree_host_size_t j = 0; j < module_count; ++j) {
+      if (init_waves[original_count + j] == w) {
+        wave_modules[wave.module_count++] = modules[j];
+      }
+    }
+    if (wave.module_count > 0) {
+      status = iree_vm_context_run_init_wave(&wave, loop);
+    }
+  }
+
+  iree_allocator_free(context->allocator, init_waves);
+
+  // Cleanup for failure cases during module initialization; we need to
+  // ensure we release any modules we'd already initialized.
+  if (!iree_status_is_ok(status)) {
+    iree_vm_context_release_modules(
+        context, original_count,
+        original_count + iree_min(i, module_count - 1));
+    context->list.count = original_count;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t
 iree_vm_context_freeze(iree_vm_context_t* context) {
   IREE_ASSERT_ARGUMENT(context);
@@ -44,9 +44,12 @@ enum iree_vm_context_flag_bits_t {
   IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION = 1u << 0,
 
   // Context allows concurrent execution.
-  // Multiple OS threads may call into the context concurrently. Synchronization
-  // is not performed by the context and callers must ensure the executing
-  // programs support concurrency.
+  // Multiple OS threads may call into the context concurrently and multiple
+  // asynchronous invocations may be in-flight and interleaved at yield points
+  // on a single loop. Synchronization is not performed by the context and
+  // callers must ensure the executing programs support concurrency (such as by
+  // not mutating globals shared across invocations). Each invocation is traced
+  // as its own fiber.
   IREE_VM_CONTEXT_FLAG_CONCURRENT = 1u << 1,
 };
 typedef uint32_t iree_vm_context_flags_t;
@@ -102,6 +105,73 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
     iree_vm_context_t* context, iree_host_size_t module_count,
     iree_vm_module_t** modules);
 
+// Registers a list of modules with the context as with
+// iree_vm_context_register_modules but runs the module __init functions of
+// independent modules concurrently using |loop|.
+//
+// Imports are resolved for all modules in the order provided and the modules
+// are then grouped into waves: a module initializes in the wave after the last
+// module it imports functions from. Each wave is issued as a single
+// iree_loop_dispatch with one workgroup per module and must complete before the
+// next wave starts. Whether initializers actually overlap depends on the
+// |loop| implementation; loops that run dispatches serially give the same
+// results as iree_vm_context_register_modules.
+//
+// Initializers of modules in the same wave must be safe to run concurrently:
+// they may touch only their own state and thread-safe imported modules (such
+// as the HAL). |loop| must support iree_loop_drain (such as iree_loop_inline
+// and iree_loop_sync) as it is used to block until each wave has completed.
+IREE_API_EXPORT iree_status_t iree_vm_context_register_modules_concurrently(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_loop_t loop);
+
+// Encodes and decodes ref-typed values when snapshotting and restoring context
+// state. iree_vm_buffer_t values are handled by the context and all other types
+// are routed to the codec. Codecs should return IREE_STATUS_UNIMPLEMENTED for
+// types they do not support.
+typedef struct iree_vm_ref_codec_t {
+  void* self;
+  // Writes the non-null |ref| to |writer|. The ref type has already been
+  // written.
+  iree_status_t(IREE_API_PTR* encode)(void* self, const iree_vm_ref_t* ref,
+                                      iree_vm_state_writer_t* writer);
+  // Reads a ref of |type| from |reader| into |out_ref|.
+  iree_status_t(IREE_API_PTR* decode)(void* self, iree_vm_ref_type_t type,
+                                      iree_vm_state_reader_t* reader,
+                                      iree_vm_ref_t* out_ref);
+} iree_vm_ref_codec_t;
+
+// Returns a codec that supports no types beyond those handled by the context.
+static inline iree_vm_ref_codec_t iree_vm_ref_codec_null(void) {
+  iree_vm_ref_codec_t codec = {NULL, NULL, NULL};
+  return codec;
+}
+
+// Snapshots the initialized state of all modules in |context| that support
+// snapshots (such as bytecode modules) into |out_snapshot|. The snapshot
+// contains the primitive and ref globals of each module and can be passed to
+// iree_vm_context_register_modules_from_snapshot in another process to skip
+// running module initializers. Ref globals are serialized with |ref_codec| and
+// snapshotting fails with IREE_STATUS_UNIMPLEMENTED if any cannot be.
+// The snapshot memory is allocated from |allocator| and must be freed by the
+// caller.
+IREE_API_EXPORT iree_status_t iree_vm_context_snapshot(
+    iree_vm_context_t* context, iree_vm_ref_codec_t ref_codec,
+    iree_allocator_t allocator, iree_byte_span_t* out_snapshot);
+
+// Registers a list of modules with the context as with
+// iree_vm_context_register_modules but restores the state of modules that
+// support snapshots from |snapshot| instead of running their __init functions.
+// Modules without snapshot support are initialized normally. The modules must
+// match those used when producing the snapshot.
+//
+// |snapshot| may be memory-mapped and is only accessed during the call; all
+// values are copied or decoded by |ref_codec| into new storage.
+IREE_API_EXPORT iree_status_t iree_vm_context_register_modules_from_snapshot(
+    iree_vm_context_t* context, iree_host_size_t module_count,
+    iree_vm_module_t** modules, iree_const_byte_span_t snapshot,
+    iree_vm_ref_codec_t ref_codec);
+
 // Freezes a context such that no more modules can be registered.
 // This can be used to ensure that context contents cannot be modified by other
 // code as the context is made available to other parts of the program.
@@ -158,11 +158,12 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
     return iree_ok_status();
   }
 
-  // Resize the output list to hold all results (and kill anything that may
-  // have been in there).
-  // TODO(benvanik): list method for resetting to a new size.
-  IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, 0));
-  IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, expected_output_count));
+  // Resize the output list to hold all results. Every slot is overwritten
+  // below so lists reused across invocations that already have the expected
+  // size are left as-is to avoid releasing and reinitializing each element.
+  if (iree_vm_list_size(outputs) != expected_output_count) {
+    IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, expected_output_count));
+  }
 
   uint8_t* p = results.data;
   for (iree_host_size_t cconv_i = 0, arg_i = 0; cconv_i < cconv_results.size;
@@ -531,11 +532,19 @@ iree_vm_resume_invoke(iree_vm_invoke_state_t* state) {
   // return to the scheduler.
   do {
     if (iree_status_is_deferred(state->status)) {
-      // Wait required; top of the stack should be a wait frame.
-      IREE_ASSERT_EQ(iree_vm_stack_current_frame(state->stack)->type,
-                     IREE_VM_STACK_FRAME_WAIT);
-      return iree_status_from_code(IREE_STATUS_DEFERRED);
-    } else if (!iree_status_is_ok(state->status)) {
+      iree_vm_stack_frame_t* current_frame =
+          iree_vm_stack_current_frame(state->stack);
+      if (current_frame && current_frame->type == IREE_VM_STACK_FRAME_WAIT) {
+        // Wait required; the wait must be performed before resuming.
+        return iree_status_from_code(IREE_STATUS_DEFERRED);
+      }
+      // Cooperative yield without a wait; the invocation can resume
+      // immediately. This is what allows multiple invocations to interleave on
+      // the same loop.
+      iree_status_free(state->status);
+      state->status = iree_ok_status();
+    }
+    if (!iree_status_is_ok(state->status)) {
       // Invocation previously failed so return immediately. The user should
       // then call end() to get the result. By returning OK here we are telling
       // the user the resume operation succeeded.
@@ -699,6 +708,191 @@ IREE_API_EXPORT void iree_vm_abort_invoke(iree_vm_invoke_state_t* state) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+//===----------------------------------------------------------------------===//
+// Prepared synchronous invocation
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t iree_vm_prepared_invoke_initialize(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_allocator_t host_allocator,
+    iree_vm_prepared_invoke_t* out_prepared) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_prepared);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_prepared, 0, sizeof(*out_prepared));
+  iree_vm_invoke_state_t* state = &out_prepared->state;
+
+  // Force tracing if specified on the context.
+  if (iree_vm_context_flags(context) & IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION) {
+    flags |= IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION;
+  }
+
+  // Grab function metadata used for marshaling inputs/outputs. This is the
+  // work iree_vm_begin_invoke repeats on every call.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &out_prepared->cconv_arguments,
+              &state->cconv_results));
+  iree_host_size_t argument_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              out_prepared->cconv_arguments, /*segment_size_list=*/NULL,
+              &argument_size));
+  iree_host_size_t result_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              state->cconv_results, /*segment_size_list=*/NULL, &result_size));
+  out_prepared->function = function;
+  out_prepared->host_allocator = host_allocator;
+
+  // Allocate argument storage. Unlike iree_vm_begin_invoke we don't use the
+  // host stack as the storage outlives this call.
+  iree_status_t status = iree_ok_status();
+  if (argument_size > 0) {
+    status = iree_allocator_malloc(host_allocator, argument_size,
+                                   (void**)&out_prepared->arguments.data);
+    out_prepared->arguments.data_length = argument_size;
+  }
+
+  // Slice result storage off the bottom of the inlined stack storage if it
+  // fits as with iree_vm_begin_invoke.
+  iree_host_size_t reserved_storage_size = 0;
+  if (iree_status_is_ok(status) && result_size > 0) {
+    if (result_size <= sizeof(state->stack_storage) / 4) {
+      state->results.data = state->stack_storage;
+      reserved_storage_size = iree_host_align(result_size, iree_max_align_t);
+    } else {
+      status = iree_allocator_malloc(host_allocator, result_size,
+                                     (void**)&state->results.data);
+    }
+    state->results.data_length = result_size;
+  }
+
+  // Initialize the stack once; it is reset after each invocation.
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_initialize(
+        iree_make_byte_span(
+            state->stack_storage + reserved_storage_size,
+            sizeof(state->stack_storage) - reserved_storage_size),
+        flags, iree_vm_context_state_resolver(context), host_allocator,
+        &state->stack);
+  }
+
+  if (iree_status_is_ok(status)) {
+    state->context = context;
+    iree_vm_context_retain(context);
+  } else {
+    if (state->results.data && state->results.data != state->stack_storage) {
+      iree_allocator_free(host_allocator, state->results.data);
+    }
+    iree_allocator_free(host_allocator, out_prepared->arguments.data);
+    memset(out_prepared, 0, sizeof(*out_prepared));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_vm_prepared_invoke_deinitialize(
+    iree_vm_prepared_invoke_t* prepared) {
+  IREE_ASSERT_ARGUMENT(prepared);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_abort_invoke(&prepared->state);
+  iree_allocator_free(prepared->host_allocator, prepared->arguments.data);
+  prepared->arguments = iree_byte_span_empty();
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invoke_prepared(iree_vm_prepared_invoke_t* prepared,
+                        const iree_vm_list_t* inputs, iree_vm_list_t* outputs) {
+  IREE_ASSERT_ARGUMENT(prepared);
+  iree_vm_invoke_state_t* state = &prepared->state;
+  if (IREE_UNLIKELY(!state->stack)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "prepared invocation not initialized");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Marshal the inputs into the reused argument storage.
+  iree_byte_span_t arguments = prepared->arguments;
+  if (arguments.data_length > 0) {
+    memset(arguments.data, 0, arguments.data_length);
+  }
+  if (state->results.data_length > 0) {
+    memset(state->results.data, 0, state->results.data_length);
+  }
+  iree_status_t status =
+      iree_vm_invoke_marshal_inputs(prepared->cconv_arguments, inputs,
+                                    arguments);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invoke_release_io_refs(prepared->cconv_arguments, arguments);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Execute the target function; see iree_vm_begin_invoke.
+  iree_vm_function_call_t call = {
+      .function = prepared->function,
+      .arguments = arguments,
+      .results = state->results,
+  };
+  iree_vm_function_t function = prepared->function;
+  state->status = function.module->begin_call(function.module->self,
+                                              state->stack, call);
+  iree_vm_invoke_release_io_refs(prepared->cconv_arguments, arguments);
+  status = iree_status_is_deferred(state->status)
+               ? iree_status_from_code(IREE_STATUS_DEFERRED)
+               : iree_ok_status();
+
+  // Run until completion performing any waits synchronously; see
+  // iree_vm_invoke.
+  while (iree_status_is_deferred(status)) {
+    iree_vm_stack_frame_t* current_frame =
+        iree_vm_stack_current_frame(state->stack);
+    if (IREE_UNLIKELY(!current_frame)) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "unbalanced stack after yield");
+      break;
+    } else if (current_frame->type == IREE_VM_STACK_FRAME_WAIT) {
+      iree_vm_wait_frame_t* wait_frame =
+          (iree_vm_wait_frame_t*)iree_vm_stack_frame_storage(current_frame);
+      status =
+          iree_vm_wait_invoke(state, wait_frame, IREE_TIME_INFINITE_FUTURE);
+      if (!iree_status_is_ok(status)) break;
+    }
+    status = iree_vm_resume_invoke(state);
+  }
+
+  // Take the invocation result and marshal the outputs if it succeeded.
+  iree_status_t invoke_status = iree_ok_status();
+  if (iree_status_is_ok(status)) {
+    invoke_status = state->status;
+    state->status = iree_ok_status();
+    if (IREE_UNLIKELY(!iree_status_is_ok(invoke_status))) {
+      iree_vm_stack_suspend_trace_zones(state->stack);
+      invoke_status = IREE_VM_STACK_ANNOTATE_BACKTRACE_IF_ENABLED(
+          state->stack, invoke_status);
+    } else {
+      status = iree_vm_invoke_marshal_outputs(state->cconv_results,
+                                              state->results, outputs);
+    }
+  } else {
+    iree_vm_stack_suspend_trace_zones(state->stack);
+    iree_status_free(state->status);
+    state->status = iree_ok_status();
+  }
+
+  // Reset for the next invocation. Failed invocations may leave frames on the
+  // stack and results that were not moved into |outputs|.
+  iree_vm_stack_reset(state->stack);
+  iree_vm_invoke_release_io_refs(state->cconv_results, state->results);
+
+  IREE_TRACE_ZONE_END(z0);
+  return !iree_status_is_ok(invoke_status) ? invoke_status : status;
+}
+
 //===----------------------------------------------------------------------===//
 // Loop-based asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -122,7 +122,9 @@ IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
 
 // Resumes an invocation previously began with iree_vm_begin_invoke.
 // Only valid to call if a prior call to iree_vm_begin_invoke or
-// iree_vm_resume_invoke returned IREE_STATUS_DEFERRED.
+// iree_vm_resume_invoke returned IREE_STATUS_DEFERRED. Invocations that yielded
+// cooperatively without a wait frame may be resumed immediately while those
+// with a wait frame on the top of the stack must have the wait performed first.
 //
 // Returns OK if the invocation resumed regardless of the invocation result.
 // When OK iree_vm_end_invoke is used to retrieve the invocation result.
@@ -178,6 +180,64 @@ IREE_API_EXPORT iree_status_t iree_vm_end_invoke(iree_vm_invoke_state_t* state,
 // succeeded then iree_vm_end_invoke must be used instead.
 IREE_API_EXPORT void iree_vm_abort_invoke(iree_vm_invoke_state_t* state);
 
+//===----------------------------------------------------------------------===//
+// Prepared synchronous invocation
+//===----------------------------------------------------------------------===//
+
+// A function prepared for repeated synchronous invocation.
+// The function calling convention, ABI argument/result storage, and VM stack
+// are set up once and reused across invocations: steady-state calls with reused
+// input/output lists perform no heap allocations. Any storage the stack grows
+// into during one invocation is retained for subsequent invocations.
+//
+// Prepared invocations trace as if IREE_VM_INVOCATION_FLAG_TRACE_INLINE was
+// specified.
+//
+// Usage:
+//   iree_vm_prepared_invoke_t* prepared = malloc(sizeof(*prepared));
+//   iree_vm_prepared_invoke_initialize(context, function, ..., prepared);
+//   while (serving) {
+//     iree_vm_list_set_value(inputs, 0, ...);
+//     iree_vm_invoke_prepared(prepared, inputs, outputs);
+//   }
+//   iree_vm_prepared_invoke_deinitialize(prepared);
+//
+// Thread-compatible: only one invocation may be in-flight at a time.
+typedef struct iree_vm_prepared_invoke_t {
+  // Target function.
+  iree_vm_function_t function;
+  // Parsed calling convention arguments string for marshaling.
+  iree_string_view_t cconv_arguments;
+  // ABI argument storage reused across invocations.
+  iree_byte_span_t arguments;
+  // Allocator used for argument/result storage and stack growth.
+  iree_allocator_t host_allocator;
+  // Invocation state holding the retained context, result storage, and the
+  // stack. The stack is reset instead of reinitialized between invocations.
+  iree_vm_invoke_state_t state;
+} iree_vm_prepared_invoke_t;
+
+// Prepares |function| in |context| for repeated invocation with
+// iree_vm_invoke_prepared. |out_prepared| is caller-provided storage that must
+// be deinitialized with iree_vm_prepared_invoke_deinitialize. The storage is
+// large (it contains the initial VM stack) and should generally not be placed
+// on the host stack.
+IREE_API_EXPORT iree_status_t iree_vm_prepared_invoke_initialize(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_allocator_t host_allocator,
+    iree_vm_prepared_invoke_t* out_prepared);
+
+// Deinitializes |prepared| and releases its retained resources.
+IREE_API_EXPORT void iree_vm_prepared_invoke_deinitialize(
+    iree_vm_prepared_invoke_t* prepared);
+
+// Synchronously invokes the function prepared in |prepared|.
+// Behaves like iree_vm_invoke. If |outputs| already has one slot per function
+// result the slots are overwritten in-place without resizing the list.
+IREE_API_EXPORT iree_status_t
+iree_vm_invoke_prepared(iree_vm_prepared_invoke_t* prepared,
+                        const iree_vm_list_t* inputs, iree_vm_list_t* outputs);
+
 //===----------------------------------------------------------------------===//
 // Loop-based asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -258,7 +318,11 @@ typedef struct iree_vm_async_invoke_state_t {
 // IREE_STATUS_ABORTED and no new work can be scheduled to the provided loop.
 //
 // Multiple invocations to the same context are only allowed to overlap if the
-// context was created with the IREE_VM_CONTEXT_FLAG_CONCURRENT flag set.
+// context was created with the IREE_VM_CONTEXT_FLAG_CONCURRENT flag set. Each
+// invocation has its own VM stack and overlapping invocations scheduled on the
+// same loop interleave at their yield and wait points (such as HAL fence
+// waits): a single context can overlap the host work of one request with the
+// device work of another without requiring a context per in-flight request.
 //
 // Usage:
 //  iree_vm_async_invoke_state_t* state = malloc(...);
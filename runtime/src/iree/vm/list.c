@@ -780,6 +780,72 @@ iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value) {
   return iree_vm_list_set_value(list, i, value);
 }
 
+// Verifies that [offset, offset + count) is within |list| and that
+// |value_type| is a concrete value type, returning its size in
+// |out_value_size|.
+static iree_status_t iree_vm_list_verify_value_range(
+    const iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_host_size_t* out_value_size) {
+  *out_value_size =
+      iree_vm_value_type_size(iree_vm_make_value_type_def(value_type));
+  if (IREE_UNLIKELY(*out_value_size == 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  }
+  if (IREE_UNLIKELY(offset > list->count || count > list->count - offset)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "range [%zu, %zu) out of bounds (%zu)", offset,
+                            offset + count, list->count);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    iree_vm_value_type_t value_type, void* out_values) {
+  iree_host_size_t value_size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_value_range(
+      list, offset, count, value_type, &value_size));
+  if (list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VALUE &&
+      iree_vm_type_def_as_value(list->element_type) == value_type) {
+    memcpy(out_values,
+           (const uint8_t*)list->storage + offset * list->element_size,
+           count * value_size);
+    return iree_ok_status();
+  }
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_vm_value_t value;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_value_as(list, offset + i, value_type, &value));
+    memcpy((uint8_t*)out_values + i * value_size, value.value_storage,
+           value_size);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    iree_vm_value_type_t value_type, const void* values) {
+  iree_host_size_t value_size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_value_range(
+      list, offset, count, value_type, &value_size));
+  if (list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VALUE &&
+      iree_vm_type_def_as_value(list->element_type) == value_type) {
+    memcpy((uint8_t*)list->storage + offset * list->element_size, values,
+           count * value_size);
+    return iree_ok_status();
+  }
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_vm_value_t value;
+    value.type = value_type;
+    value.i64 = 0;
+    memcpy(value.value_storage, (const uint8_t*)values + i * value_size,
+           value_size);
+    IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, offset + i, &value));
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
                                                  iree_host_size_t i,
                                                  iree_vm_ref_type_t type) {
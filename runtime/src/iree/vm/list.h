@@ -157,6 +157,50 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
 IREE_API_EXPORT iree_status_t
 iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value);
 
+// Reads |count| elements starting at |offset| into the dense |out_values| array
+// of |value_type| elements. Lists storing |value_type| elements are copied with
+// a single memcpy and all others convert each element as with
+// iree_vm_list_get_value_as. Fails if any element in the range is not a value.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    iree_vm_value_type_t value_type, void* out_values);
+
+// Writes |count| elements starting at |offset| from the dense |values| array of
+// |value_type| elements. Lists storing |value_type| elements are copied with a
+// single memcpy and all others convert each element as with
+// iree_vm_list_set_value. The range must be within the current list size.
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    iree_vm_value_type_t value_type, const void* values);
+
+static inline iree_status_t iree_vm_list_get_values_i32(
+    const iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    int32_t* out_values) {
+  return iree_vm_list_get_values(list, offset, count, IREE_VM_VALUE_TYPE_I32,
+                                 out_values);
+}
+
+static inline iree_status_t iree_vm_list_get_values_i64(
+    const iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    int64_t* out_values) {
+  return iree_vm_list_get_values(list, offset, count, IREE_VM_VALUE_TYPE_I64,
+                                 out_values);
+}
+
+static inline iree_status_t iree_vm_list_set_values_i32(
+    iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    const int32_t* values) {
+  return iree_vm_list_set_values(list, offset, count, IREE_VM_VALUE_TYPE_I32,
+                                 values);
+}
+
+static inline iree_status_t iree_vm_list_set_values_i64(
+    iree_vm_list_t* list, iree_host_size_t offset, iree_host_size_t count,
+    const int64_t* values) {
+  return iree_vm_list_set_values(list, offset, count, IREE_VM_VALUE_TYPE_I64,
+                                 values);
+}
+
 // Returns a dereferenced pointer to the given type if the element at the
 // given index |i| matches the |type|. Returns NULL on error.
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
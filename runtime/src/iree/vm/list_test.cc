@@ -1251,6 +1251,63 @@ TEST_F(VMListTest, PushPopRef) {
   iree_vm_list_release(list);
 }
 
+// Tests bulk value get/set on typed lists (memcpy) and variant lists
+// (per-element conversion).
+TEST_F(VMListTest, GetSetValues) {
+  const int64_t values[4] = {0, 1, -2, INT64_C(1) << 40};
+
+  iree_vm_list_t* typed_list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(
+      iree_vm_make_value_type_def(IREE_VM_VALUE_TYPE_I64), 4,
+      iree_allocator_system(), &typed_list));
+  IREE_ASSERT_OK(iree_vm_list_resize(typed_list, 4));
+  IREE_ASSERT_OK(iree_vm_list_set_values_i64(typed_list, 0, 4, values));
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    iree_vm_value_t value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(typed_list, i, &value));
+    EXPECT_EQ(value, iree_vm_value_make_i64(values[i]));
+  }
+  int64_t typed_values[2] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values_i64(typed_list, 2, 2, typed_values));
+  EXPECT_EQ(typed_values[0], values[2]);
+  EXPECT_EQ(typed_values[1], values[3]);
+
+  // Narrowing conversion on the bulk path matches iree_vm_list_get_value_as.
+  int32_t narrow_values[4] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values_i32(typed_list, 0, 4, narrow_values));
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(narrow_values[i], (int32_t)values[i]);
+  }
+
+  EXPECT_THAT(
+      Status(iree_vm_list_get_values_i64(typed_list, 3, 2, typed_values)),
+      StatusIs(StatusCode::kOutOfRange));
+  EXPECT_THAT(Status(iree_vm_list_set_values_i64(typed_list, 5, 0, values)),
+              StatusIs(StatusCode::kOutOfRange));
+
+  iree_vm_list_t* variant_list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 4,
+                                     iree_allocator_system(), &variant_list));
+  IREE_ASSERT_OK(iree_vm_list_resize(variant_list, 4));
+  IREE_ASSERT_OK(iree_vm_list_set_values_i64(variant_list, 0, 4, values));
+  int64_t variant_values[4] = {0};
+  IREE_ASSERT_OK(
+      iree_vm_list_get_values_i64(variant_list, 0, 4, variant_values));
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(variant_values[i], values[i]);
+  }
+
+  // Refs in variant lists can't be read as values.
+  iree_vm_ref_t ref_a = MakeRef<A>(1.0f);
+  IREE_ASSERT_OK(iree_vm_list_set_ref_move(variant_list, 1, &ref_a));
+  EXPECT_THAT(
+      Status(iree_vm_list_get_values_i64(variant_list, 0, 4, variant_values)),
+      StatusIs(StatusCode::kFailedPrecondition));
+
+  iree_vm_list_release(variant_list);
+  iree_vm_list_release(typed_list);
+}
+
 // TODO(benvanik): test primitive variant get/set.
 
 // TODO(benvanik): test ref variant get/set.
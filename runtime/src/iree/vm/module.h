@@ -341,6 +341,34 @@ typedef enum iree_vm_signal_e {
   IREE_VM_SIGNAL_LOW_MEMORY = 2,
 } iree_vm_signal_t;
 
+// Writes serialized module state as a sequence of blobs.
+// Used by iree_vm_module_t::snapshot_state and implemented by the context.
+typedef struct iree_vm_state_writer_t {
+  void* self;
+
+  // Appends |data| as the next blob in the stream.
+  // Blob contents are aligned to iree_max_align_t in the stream.
+  iree_status_t(IREE_API_PTR* write)(void* self, iree_const_byte_span_t data);
+
+  // Appends |ref| (which may be null) to the stream.
+  // Returns IREE_STATUS_UNIMPLEMENTED if the ref type cannot be serialized.
+  iree_status_t(IREE_API_PTR* write_ref)(void* self, const iree_vm_ref_t* ref);
+} iree_vm_state_writer_t;
+
+// Reads serialized module state produced by iree_vm_state_writer_t.
+// Used by iree_vm_module_t::restore_state and implemented by the context.
+typedef struct iree_vm_state_reader_t {
+  void* self;
+
+  // Reads the next blob in the stream. The returned data references the
+  // snapshot storage and is valid only for the duration of the restore.
+  iree_status_t(IREE_API_PTR* read)(void* self,
+                                    iree_const_byte_span_t* out_data);
+
+  // Reads the next ref in the stream. |out_ref| receives ownership.
+  iree_status_t(IREE_API_PTR* read_ref)(void* self, iree_vm_ref_t* out_ref);
+} iree_vm_state_reader_t;
+
 // Defines an interface that can be used to reflect and execute functions on a
 // module.
 //
@@ -428,6 +456,20 @@ typedef struct iree_vm_module_t {
                                       iree_vm_module_state_t* module_state,
                                       iree_vm_signal_t signal);
 
+  // Serializes the initialized |module_state| to |writer| such that
+  // restore_state can reproduce it in another process without running the
+  // module initializer. Optional; modules without it are initialized normally
+  // when restoring a context from a snapshot.
+  iree_status_t(IREE_API_PTR* snapshot_state)(
+      void* self, iree_vm_module_state_t* module_state,
+      iree_vm_state_writer_t* writer);
+
+  // Restores a freshly allocated |module_state| from |reader| in place of
+  // running the module initializer. Imports have been resolved.
+  iree_status_t(IREE_API_PTR* restore_state)(
+      void* self, iree_vm_module_state_t* module_state,
+      iree_vm_state_reader_t* reader);
+
   // Begins a function call with the given |call| arguments.
   //
   // Returns OK if execution completes immediately. If the call completes
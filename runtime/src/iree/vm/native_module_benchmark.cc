@@ -4,15 +4,125 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <cstdint>
+#include <cstdlib>
+
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
 #include "iree/vm/module.h"
 #include "iree/vm/native_module.h"
 #include "iree/vm/native_module_test.h"
 #include "iree/vm/stack.h"
+#include "iree/vm/value.h"
 
 namespace {
 
-// TODO(benvanik): native module benchmarks.
+// Allocator that forwards to the system allocator and counts the number of
+// allocations made so benchmarks can report steady-state allocation behavior.
+static iree_status_t CountingAllocatorCtl(void* self,
+                                          iree_allocator_command_t command,
+                                          const void* params, void** inout_ptr) {
+  if (command == IREE_ALLOCATOR_COMMAND_MALLOC ||
+      command == IREE_ALLOCATOR_COMMAND_CALLOC ||
+      command == IREE_ALLOCATOR_COMMAND_REALLOC) {
+    ++*reinterpret_cast<int64_t*>(self);
+  }
+  return iree_allocator_system_ctl(/*self=*/NULL, command, params, inout_ptr);
+}
+
+// Holds a context with module_a from native_module_test.h and the I/O lists
+// used to call module_a.add_1.
+struct NativeModuleFixture {
+  NativeModuleFixture() {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                          iree_allocator_system(), &instance));
+    iree_vm_module_t* module_a = NULL;
+    IREE_CHECK_OK(
+        module_a_create(instance, iree_allocator_system(), &module_a));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance, IREE_VM_CONTEXT_FLAG_NONE, 1, &module_a,
+        iree_allocator_system(), &context));
+    iree_vm_module_release(module_a);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context, iree_make_cstring_view("module_a.add_1"), &function));
+
+    IREE_CHECK_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(0);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    IREE_CHECK_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                      iree_allocator_system(), &outputs));
+  }
+  ~NativeModuleFixture() {
+    iree_vm_list_release(inputs);
+    iree_vm_list_release(outputs);
+    iree_vm_context_release(context);
+    iree_vm_instance_release(instance);
+  }
+
+  // Updates the argument in-place in the reused input list.
+  void SetArgument(int32_t value) {
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(value);
+    IREE_CHECK_OK(iree_vm_list_set_value(inputs, 0, &arg0));
+  }
+
+  iree_allocator_t host_allocator() {
+    return {&allocation_count, CountingAllocatorCtl};
+  }
+
+  iree_vm_instance_t* instance = NULL;
+  iree_vm_context_t* context = NULL;
+  iree_vm_function_t function;
+  iree_vm_list_t* inputs = NULL;
+  iree_vm_list_t* outputs = NULL;
+  int64_t allocation_count = 0;
+};
+
+// Benchmarks iree_vm_invoke of a trivial native function. Each invocation
+// resolves the function signature and initializes a new stack.
+static void BM_InvokeNative(benchmark::State& state) {
+  NativeModuleFixture fixture;
+  int32_t i = 0;
+  for (auto _ : state) {
+    fixture.SetArgument(i++);
+    IREE_CHECK_OK(iree_vm_invoke(
+        fixture.context, fixture.function, IREE_VM_INVOCATION_FLAG_NONE,
+        /*policy=*/NULL, fixture.inputs, fixture.outputs,
+        fixture.host_allocator()));
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(fixture.allocation_count),
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_InvokeNative);
+
+// Benchmarks iree_vm_invoke_prepared of a trivial native function. The
+// signature, ABI storage, and stack are reused across invocations and no
+// allocations are expected in the loop.
+static void BM_InvokeNativePrepared(benchmark::State& state) {
+  NativeModuleFixture fixture;
+  iree_vm_prepared_invoke_t* prepared =
+      static_cast<iree_vm_prepared_invoke_t*>(malloc(sizeof(*prepared)));
+  IREE_CHECK_OK(iree_vm_prepared_invoke_initialize(
+      fixture.context, fixture.function, IREE_VM_INVOCATION_FLAG_NONE,
+      fixture.host_allocator(), prepared));
+  fixture.allocation_count = 0;
+  int32_t i = 0;
+  for (auto _ : state) {
+    fixture.SetArgument(i++);
+    IREE_CHECK_OK(
+        iree_vm_invoke_prepared(prepared, fixture.inputs, fixture.outputs));
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(fixture.allocation_count),
+      benchmark::Counter::kAvgIterations);
+  iree_vm_prepared_invoke_deinitialize(prepared);
+  free(prepared);
+}
+BENCHMARK(BM_InvokeNativePrepared);
 
 }  // namespace
@@ -37,6 +37,10 @@ namespace vm {
 // tuples of mixed types, or dynamic arrays (variadic arguments). Results may be
 // returned as either their type or an std::tuple/std::array of types.
 //
+// Functions that wait on external work (fences, I/O, RPCs) can return
+// StatusOr<vm::Async<T>> to yield the invocation to the scheduler instead of
+// blocking the calling thread; see vm::Async.
+//
 // Usage:
 //   // Per-context module state that must only be thread-compatible.
 //   // Define
@@ -91,7 +95,7 @@ class NativeModule {
     interface_.resolve_import = NativeModule::ModuleResolveImport;
     interface_.notify = NativeModule::ModuleNotify;
     interface_.begin_call = NativeModule::ModuleBeginCall;
-    // TODO(benvanik): resume_call
+    interface_.resume_call = NativeModule::ModuleResumeCall;
   }
 
   virtual ~NativeModule() { iree_vm_instance_release(instance_); }
@@ -260,18 +264,26 @@ class NativeModule {
     }
     const auto& info = module->dispatch_table_[call.function.ordinal];
 
-    // NOTE: VM stack is currently unused. We could stash things here for the
-    // debugger or use it for coroutine state.
+    // Async functions stash their continuation in the frame so that it
+    // survives until the call is resumed; synchronous functions need nothing.
     iree_host_size_t frame_size = 0;
+    iree_vm_stack_frame_cleanup_fn_t frame_cleanup_fn = nullptr;
+    if (info.is_async) {
+      frame_size = sizeof(packing::impl::AsyncFrameStorage);
+      frame_cleanup_fn = packing::impl::AsyncFrameCleanup;
+    }
 
     iree_vm_stack_frame_t* callee_frame = NULL;
     IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
         stack, &call.function, IREE_VM_STACK_FRAME_NATIVE, frame_size,
-        /*frame_cleanup_fn=*/nullptr, &callee_frame));
+        frame_cleanup_fn, &callee_frame));
 
     auto* state = FromStatePointer(callee_frame->module_state);
     iree_status_t status = info.call(info.ptr, state, stack, call);
-    if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    if (iree_status_is_deferred(status)) {
+      // Call yielded on a wait; preserve the frame until resumed.
+      return status;
+    } else if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
       status = iree_status_annotate_f(
           status, "while invoking C++ function %s.%.*s", module->name_,
           (int)info.name.size, info.name.data);
@@ -281,6 +293,27 @@ class NativeModule {
     return iree_vm_stack_function_leave(stack);
   }
 
+  static iree_status_t ModuleResumeCall(void* self, iree_vm_stack_t* stack,
+                                        iree_byte_span_t call_results) {
+    auto* module = FromModulePointer(self);
+    iree_vm_stack_frame_t* callee_frame = iree_vm_stack_top(stack);
+    if (IREE_UNLIKELY(!callee_frame)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "no frame at top of stack to resume");
+    }
+    const auto& info = module->dispatch_table_[callee_frame->function.ordinal];
+
+    iree_status_t status = packing::impl::ResumeAsync(stack, call_results);
+    if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+      status = iree_status_annotate_f(
+          status, "while resuming C++ function %s.%.*s", module->name_,
+          (int)info.name.size, info.name.data);
+      return status;
+    }
+
+    return iree_vm_stack_function_leave(stack);
+  }
+
   const char* name_;
   uint32_t version_;
   iree_vm_instance_t* instance_;
@@ -0,0 +1,166 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <memory>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/native_module_cc.h"
+
+namespace iree {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Per-context state of the test module. Each async function waits on a short
+// delay to force the invocation to yield before the continuation runs.
+class AsyncState final {
+ public:
+  // Synchronous function for comparison.
+  StatusOr<int32_t> AddSync(int32_t lhs, int32_t rhs) { return lhs + rhs; }
+
+  // Yields until a delay has elapsed and then returns the sum.
+  StatusOr<vm::Async<int32_t>> AddDelayed(int32_t lhs, int32_t rhs) {
+    return vm::Async<int32_t>(Delay(), [this, lhs, rhs]() -> StatusOr<int32_t> {
+      ++resume_count_;
+      return lhs + rhs;
+    });
+  }
+
+  // Completes inline as the wait source is already resolved.
+  StatusOr<vm::Async<int32_t>> AddImmediate(int32_t lhs, int32_t rhs) {
+    return vm::Async<int32_t>(iree_wait_source_immediate(),
+                              [lhs, rhs]() -> StatusOr<int32_t> {
+                                return lhs + rhs;
+                              });
+  }
+
+  // Yields and then fails from the continuation.
+  StatusOr<vm::Async<void>> FailDelayed() {
+    return vm::Async<void>(Delay(), []() -> Status {
+      return iree_make_status(IREE_STATUS_DATA_LOSS, "continuation failure");
+    });
+  }
+
+  // Returns the number of continuations run after a yield.
+  StatusOr<int32_t> ResumeCount() { return resume_count_; }
+
+ private:
+  static iree_wait_source_t Delay() {
+    return iree_wait_source_delay(iree_time_now() + 1000000);
+  }
+
+  int32_t resume_count_ = 0;
+};
+
+static const vm::NativeFunction<AsyncState> kAsyncFunctions[] = {
+    vm::MakeNativeFunction("add_sync", &AsyncState::AddSync),
+    vm::MakeNativeFunction("add_delayed", &AsyncState::AddDelayed),
+    vm::MakeNativeFunction("add_immediate", &AsyncState::AddImmediate),
+    vm::MakeNativeFunction("fail_delayed", &AsyncState::FailDelayed),
+    vm::MakeNativeFunction("resume_count", &AsyncState::ResumeCount),
+};
+
+class AsyncModule final : public vm::NativeModule<AsyncState> {
+ public:
+  using vm::NativeModule<AsyncState>::NativeModule;
+  StatusOr<std::unique_ptr<AsyncState>> CreateState(
+      iree_allocator_t host_allocator) override {
+    return std::make_unique<AsyncState>();
+  }
+};
+
+class VMNativeModuleCCTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                          iree_allocator_system(), &instance_));
+    auto module = std::make_unique<AsyncModule>(
+        "async", /*version=*/0, instance_, iree_allocator_system(),
+        iree::span<const vm::NativeFunction<AsyncState>>(kAsyncFunctions));
+    iree_vm_module_t* module_ptr = module.release()->interface();
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, 1, &module_ptr,
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(module_ptr);
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  StatusOr<std::vector<int32_t>> RunFunction(const char* function_name,
+                                             std::vector<int32_t> args) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(function_name), &function));
+
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             args.size(),
+                                             iree_allocator_system(),
+                                             &input_list));
+    for (int32_t arg : args) {
+      auto value = iree_vm_value_make_i32(arg);
+      IREE_RETURN_IF_ERROR(iree_vm_list_push_value(input_list.get(), &value));
+    }
+    vm::ref<iree_vm_list_t> output_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             1, iree_allocator_system(),
+                                             &output_list));
+
+    // Runs synchronously; waits are performed by the invocation loop.
+    IREE_RETURN_IF_ERROR(
+        iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+                       /*policy=*/nullptr, input_list.get(), output_list.get(),
+                       iree_allocator_system()));
+
+    std::vector<int32_t> results;
+    for (iree_host_size_t i = 0; i < iree_vm_list_size(output_list.get());
+         ++i) {
+      iree_vm_value_t value;
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_get_value(output_list.get(), i, &value));
+      results.push_back(value.i32);
+    }
+    return results;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+TEST_F(VMNativeModuleCCTest, SyncCall) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto results,
+                            RunFunction("async.add_sync", {1, 2}));
+  ASSERT_EQ(results, std::vector<int32_t>({3}));
+}
+
+TEST_F(VMNativeModuleCCTest, AsyncCallYields) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto results,
+                            RunFunction("async.add_delayed", {3, 4}));
+  ASSERT_EQ(results, std::vector<int32_t>({7}));
+  IREE_ASSERT_OK_AND_ASSIGN(results, RunFunction("async.resume_count", {}));
+  ASSERT_EQ(results, std::vector<int32_t>({1}));
+}
+
+TEST_F(VMNativeModuleCCTest, AsyncCallCompletesInline) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto results,
+                            RunFunction("async.add_immediate", {5, 6}));
+  ASSERT_EQ(results, std::vector<int32_t>({11}));
+}
+
+TEST_F(VMNativeModuleCCTest, AsyncCallFailure) {
+  EXPECT_THAT(RunFunction("async.fail_delayed", {}),
+              StatusIs(StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace iree
@@ -7,8 +7,10 @@
 #ifndef IREE_VM_MODULE_ABI_PACKING_H_
 #define IREE_VM_MODULE_ABI_PACKING_H_
 
+#include <functional>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,49 @@
 
 namespace iree {
 namespace vm {
+
+// Result of a native function that may complete asynchronously.
+// Functions return a |wait_source| (such as one from iree_hal_fence_await) and
+// a |continuation| that produces the function results once the wait source has
+// resolved. Until then the invocation yields to its scheduler with
+// IREE_STATUS_DEFERRED instead of blocking the calling thread so that other
+// invocations and device work can make progress. If the wait source has
+// already resolved the continuation is run inline as with a synchronous call.
+//
+// Call arguments are released when the function returns: any resources the
+// continuation or the wait source require must be captured by the
+// continuation.
+//
+// Usage:
+//   StatusOr<vm::Async<int32_t>> MyState::Read(vm::ref<iree_hal_fence_t> f) {
+//     iree_wait_source_t wait_source = iree_hal_fence_await(f.get());
+//     return vm::Async<int32_t>(wait_source, [f]() -> StatusOr<int32_t> {
+//       return 123;
+//     });
+//   }
+template <typename T>
+class Async {
+ public:
+  using Continuation =
+      typename std::conditional<std::is_void<T>::value, std::function<Status()>,
+                                std::function<StatusOr<T>()>>::type;
+
+  Async(iree_wait_source_t wait_source, Continuation continuation,
+        iree_timeout_t timeout = iree_infinite_timeout())
+      : wait_source_(wait_source),
+        timeout_(timeout),
+        continuation_(std::move(continuation)) {}
+
+  iree_wait_source_t wait_source() const { return wait_source_; }
+  iree_timeout_t timeout() const { return timeout_; }
+  Continuation release_continuation() { return std::move(continuation_); }
+
+ private:
+  iree_wait_source_t wait_source_;
+  iree_timeout_t timeout_;
+  Continuation continuation_;
+};
+
 namespace packing {
 
 namespace impl {
@@ -396,7 +441,7 @@ struct ParamUnpack<ref<T>> {
     auto* reg_ptr = reinterpret_cast<iree_vm_ref_t*>(ptr);
     ptr += sizeof(iree_vm_ref_t);
     if (reg_ptr->type == ref_type_descriptor<T>::type()) {
-      out_param = vm::retain_ref(reinterpret_cast<T*>(reg_ptr->ptr));
+      out_param = vm::assign_ref(reinterpret_cast<T*>(reg_ptr->ptr));
       memset(reg_ptr, 0, sizeof(*reg_ptr));
     } else if (IREE_UNLIKELY(reg_ptr->type != IREE_VM_REF_TYPE_NULL)) {
       status = iree_make_status(
@@ -421,7 +466,7 @@ struct ParamUnpack<const ref<T>> {
     auto* reg_ptr = reinterpret_cast<iree_vm_ref_t*>(ptr);
     ptr += sizeof(iree_vm_ref_t);
     if (reg_ptr->type == ref_type_descriptor<T>::type()) {
-      out_param = vm::retain_ref(reinterpret_cast<T*>(reg_ptr->ptr));
+      out_param = vm::assign_ref(reinterpret_cast<T*>(reg_ptr->ptr));
       memset(reg_ptr, 0, sizeof(*reg_ptr));
     } else if (IREE_UNLIKELY(reg_ptr->type != IREE_VM_REF_TYPE_NULL)) {
       status = iree_make_status(
@@ -628,6 +673,75 @@ struct ResultPack<std::tuple<Ts...>> {
 
 }  // namespace impl
 
+//===----------------------------------------------------------------------===//
+// Asynchronous calls
+//===----------------------------------------------------------------------===//
+
+namespace impl {
+
+// Type-erased continuation of a deferred call that stores the function results
+// into the ABI |results| buffer.
+using AsyncResumeFn = std::function<Status(iree_byte_span_t results)>;
+
+// Stack frame storage of native functions that may complete asynchronously.
+// The continuation is heap allocated as stack frames may be relocated while
+// the call is suspended.
+struct AsyncFrameStorage {
+  AsyncResumeFn* resume;
+};
+
+inline void AsyncFrameCleanup(iree_vm_stack_frame_t* frame) {
+  auto* storage =
+      reinterpret_cast<AsyncFrameStorage*>(iree_vm_stack_frame_storage(frame));
+  delete storage->resume;
+  storage->resume = nullptr;
+}
+
+// Completes the call on the top of |stack| inline if |wait_source| has already
+// resolved or otherwise stashes |resume| in the frame and enters a wait frame.
+// Returns IREE_STATUS_DEFERRED if the call must be resumed after the wait.
+inline Status BeginAsync(iree_vm_stack_t* stack, iree_byte_span_t results,
+                         iree_wait_source_t wait_source,
+                         iree_timeout_t timeout, AsyncResumeFn resume) {
+  iree_status_code_t wait_status_code = IREE_STATUS_OK;
+  if (!iree_wait_source_is_immediate(wait_source)) {
+    IREE_RETURN_IF_ERROR(
+        iree_wait_source_query(wait_source, &wait_status_code));
+  }
+  if (wait_status_code == IREE_STATUS_OK) {
+    return resume(results);
+  } else if (wait_status_code != IREE_STATUS_DEFERRED) {
+    return iree_make_status(wait_status_code, "async call wait source failed");
+  }
+
+  auto* storage = reinterpret_cast<AsyncFrameStorage*>(
+      iree_vm_stack_frame_storage(iree_vm_stack_top(stack)));
+  storage->resume = new AsyncResumeFn(std::move(resume));
+
+  iree_vm_wait_frame_t* wait_frame = nullptr;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_wait_enter(stack, IREE_VM_WAIT_ALL, 1,
+                                                timeout, 0, &wait_frame));
+  wait_frame->wait_sources[0] = wait_source;
+  return iree_status_from_code(IREE_STATUS_DEFERRED);
+}
+
+// Leaves the wait frame entered by BeginAsync and runs the stashed
+// continuation to store the function results into |results|.
+inline Status ResumeAsync(iree_vm_stack_t* stack, iree_byte_span_t results) {
+  iree_vm_wait_result_t wait_result;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_wait_leave(stack, &wait_result));
+  IREE_RETURN_IF_ERROR(wait_result.status);
+  auto* storage = reinterpret_cast<AsyncFrameStorage*>(
+      iree_vm_stack_frame_storage(iree_vm_stack_top(stack)));
+  if (IREE_UNLIKELY(!storage->resume)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no async call pending on the stack top");
+  }
+  return (*storage->resume)(results);
+}
+
+}  // namespace impl
+
 //===----------------------------------------------------------------------===//
 // Function wrapping
 //===----------------------------------------------------------------------===//
@@ -682,6 +796,65 @@ struct DispatchFunctorVoid {
   }
 };
 
+// A DispatchFunctor specialization for methods returning vm::Async results.
+template <typename Owner, typename Results, typename... Params>
+struct DispatchFunctorAsync {
+  using FnPtr = StatusOr<Async<Results>> (Owner::*)(Params...);
+
+  static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
+                     iree_vm_function_call_t call) {
+    IREE_ASSIGN_OR_RETURN(
+        auto params, impl::Unpacker::LoadSequence<Params...>(call.arguments));
+    IREE_ASSIGN_OR_RETURN(
+        auto async,
+        ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
+                std::make_index_sequence<sizeof...(Params)>()));
+    auto continuation = async.release_continuation();
+    return impl::BeginAsync(
+        stack, call.results, async.wait_source(), async.timeout(),
+        [continuation = std::move(continuation)](
+            iree_byte_span_t results) -> Status {
+          IREE_ASSIGN_OR_RETURN(auto values, continuation());
+          impl::result_ptr_t result_ptr = results.data;
+          impl::ResultPack<Results>::Store(result_ptr, std::move(values));
+          return OkStatus();
+        });
+  }
+
+  template <typename T, size_t... I>
+  static StatusOr<Async<Results>> ApplyFn(FnPtr ptr, Owner* self, T&& params,
+                                          std::index_sequence<I...>) {
+    return (self->*ptr)(std::move(std::get<I>(params))...);
+  }
+};
+
+// A DispatchFunctorAsync specialization for methods with no return values.
+template <typename Owner, typename... Params>
+struct DispatchFunctorAsyncVoid {
+  using FnPtr = StatusOr<Async<void>> (Owner::*)(Params...);
+
+  static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
+                     iree_vm_function_call_t call) {
+    IREE_ASSIGN_OR_RETURN(
+        auto params, impl::Unpacker::LoadSequence<Params...>(call.arguments));
+    IREE_ASSIGN_OR_RETURN(
+        auto async,
+        ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
+                std::make_index_sequence<sizeof...(Params)>()));
+    auto continuation = async.release_continuation();
+    return impl::BeginAsync(
+        stack, call.results, async.wait_source(), async.timeout(),
+        [continuation = std::move(continuation)](iree_byte_span_t results)
+            -> Status { return continuation(); });
+  }
+
+  template <typename T, size_t... I>
+  static StatusOr<Async<void>> ApplyFn(FnPtr ptr, Owner* self, T&& params,
+                                       std::index_sequence<I...>) {
+    return (self->*ptr)(std::move(std::get<I>(params))...);
+  }
+};
+
 }  // namespace packing
 
 template <typename Owner>
@@ -691,6 +864,8 @@ struct NativeFunction {
   void (Owner::*const ptr)();
   Status (*const call)(void (Owner::*ptr)(), Owner* self,
                        iree_vm_stack_t* stack, iree_vm_function_call_t call);
+  // True if the function may yield and must be resumed (returns vm::Async).
+  bool is_async;
 };
 
 template <typename Owner, typename Result, typename... Params>
@@ -699,7 +874,8 @@ constexpr NativeFunction<Owner> MakeNativeFunction(
   using dispatch_functor_t = packing::DispatchFunctor<Owner, Result, Params...>;
   return {iree_make_cstring_view(name),
           packing::cconv_storage<Result, sizeof...(Params), Params...>::value(),
-          (void (Owner::*)())fn, &dispatch_functor_t::Call};
+          (void (Owner::*)())fn, &dispatch_functor_t::Call,
+          /*is_async=*/false};
 }
 
 template <typename Owner, typename... Params>
@@ -708,7 +884,30 @@ constexpr NativeFunction<Owner> MakeNativeFunction(
   using dispatch_functor_t = packing::DispatchFunctorVoid<Owner, Params...>;
   return {iree_make_cstring_view(name),
           packing::cconv_storage_void<sizeof...(Params), Params...>::value(),
-          (void (Owner::*)())fn, &dispatch_functor_t::Call};
+          (void (Owner::*)())fn, &dispatch_functor_t::Call,
+          /*is_async=*/false};
+}
+
+template <typename Owner, typename Result, typename... Params>
+constexpr NativeFunction<Owner> MakeNativeFunction(
+    const char* name, StatusOr<Async<Result>> (Owner::*fn)(Params...)) {
+  using dispatch_functor_t =
+      packing::DispatchFunctorAsync<Owner, Result, Params...>;
+  return {iree_make_cstring_view(name),
+          packing::cconv_storage<Result, sizeof...(Params), Params...>::value(),
+          (void (Owner::*)())fn, &dispatch_functor_t::Call,
+          /*is_async=*/true};
+}
+
+template <typename Owner, typename... Params>
+constexpr NativeFunction<Owner> MakeNativeFunction(
+    const char* name, StatusOr<Async<void>> (Owner::*fn)(Params...)) {
+  using dispatch_functor_t =
+      packing::DispatchFunctorAsyncVoid<Owner, Params...>;
+  return {iree_make_cstring_view(name),
+          packing::cconv_storage_void<sizeof...(Params), Params...>::value(),
+          (void (Owner::*)())fn, &dispatch_functor_t::Call,
+          /*is_async=*/true};
 }
 
 }  // namespace vm
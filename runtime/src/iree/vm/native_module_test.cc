@@ -6,6 +6,7 @@
 
 #include "iree/vm/native_module_test.h"
 
+#include <cstdlib>
 #include <vector>
 
 #include "iree/base/api.h"
@@ -94,7 +95,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -111,5 +112,80 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Tests that a prepared invocation can be reused with in-place updated I/O
+// lists and that failed invocations leave it usable.
+TEST_F(VMNativeModuleTest, PreparedInvoke) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_b.entry"), &function));
+  auto* prepared = static_cast<iree_vm_prepared_invoke_t*>(
+      malloc(sizeof(iree_vm_prepared_invoke_t)));
+  IREE_ASSERT_OK(iree_vm_prepared_invoke_initialize(
+      context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+      iree_allocator_system(), prepared));
+
+  vm::ref<iree_vm_list_t> input_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &input_list));
+  auto arg0_value = iree_vm_value_make_i32(0);
+  IREE_ASSERT_OK(iree_vm_list_push_value(input_list.get(), &arg0_value));
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &output_list));
+
+  // Per-context state persists across calls as with iree_vm_invoke.
+  const int32_t expected_values[] = {1, 4, 8};
+  for (int32_t i = 0; i < IREE_ARRAYSIZE(expected_values); ++i) {
+    arg0_value = iree_vm_value_make_i32(i + 1);
+    IREE_ASSERT_OK(iree_vm_list_set_value(input_list.get(), 0, &arg0_value));
+    IREE_ASSERT_OK(
+        iree_vm_invoke_prepared(prepared, input_list.get(), output_list.get()));
+    iree_vm_value_t ret0_value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(output_list.get(), 0, &ret0_value));
+    EXPECT_EQ(ret0_value.i32, expected_values[i]);
+  }
+
+  // Mismatched inputs fail without corrupting the prepared state.
+  vm::ref<iree_vm_list_t> empty_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 0,
+                                     iree_allocator_system(), &empty_list));
+  iree_status_t status =
+      iree_vm_invoke_prepared(prepared, empty_list.get(), output_list.get());
+  EXPECT_TRUE(iree_status_is_invalid_argument(status));
+  iree_status_ignore(status);
+  IREE_ASSERT_OK(
+      iree_vm_invoke_prepared(prepared, input_list.get(), output_list.get()));
+
+  iree_vm_prepared_invoke_deinitialize(prepared);
+  free(prepared);
+}
+
+// Tests that module_b initializes after the module_a it imports from when the
+// modules are registered concurrently.
+TEST_F(VMNativeModuleTest, RegisterModulesConcurrently) {
+  iree_vm_module_t* module_a = nullptr;
+  IREE_ASSERT_OK(
+      module_a_create(instance_, iree_allocator_system(), &module_a));
+  iree_vm_module_t* module_b = nullptr;
+  IREE_ASSERT_OK(
+      module_b_create(instance_, iree_allocator_system(), &module_b));
+  iree_vm_context_release(context_);
+  IREE_ASSERT_OK(iree_vm_context_create(instance_, IREE_VM_CONTEXT_FLAG_NONE,
+                                        iree_allocator_system(), &context_));
+  std::vector<iree_vm_module_t*> modules = {module_a, module_b};
+  iree_status_t loop_status = iree_ok_status();
+  IREE_ASSERT_OK(iree_vm_context_register_modules_concurrently(
+      context_, modules.size(), modules.data(),
+      iree_loop_inline(&loop_status)));
+  IREE_ASSERT_OK(loop_status);
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+  EXPECT_EQ(2, iree_vm_context_module_count(context_));
+
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 1));
+  ASSERT_EQ(v0, 1);
+}
+
 }  // namespace
 }  // namespace iree
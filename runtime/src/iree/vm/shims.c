@@ -68,6 +68,7 @@ IREE_VM_ABI_DEFINE_SHIM(rIrrr, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrrCrD, v);
 IREE_VM_ABI_DEFINE_SHIM(CrID, r);
 IREE_VM_ABI_DEFINE_SHIM(CrD, r);
+IREE_VM_ABI_DEFINE_SHIM(i, r);
 IREE_VM_ABI_DEFINE_SHIM(iCrD, i);
 IREE_VM_ABI_DEFINE_SHIM(iI, rr);
 IREE_VM_ABI_DEFINE_SHIM(irII, rr);
@@ -637,6 +637,7 @@ IREE_VM_ABI_DECLARE_SHIM(rIrrr, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrrCrD, v);
 IREE_VM_ABI_DECLARE_SHIM(CrID, r);
 IREE_VM_ABI_DECLARE_SHIM(CrD, r);
+IREE_VM_ABI_DECLARE_SHIM(i, r);
 IREE_VM_ABI_DECLARE_SHIM(iCrD, i);
 IREE_VM_ABI_DECLARE_SHIM(iI, rr);
 IREE_VM_ABI_DECLARE_SHIM(irII, rr);
@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "iree/base/alignment.h"
@@ -322,6 +323,16 @@ IREE_API_EXPORT iree_vm_stack_frame_t* iree_vm_stack_parent_frame(
   return parent_header ? &parent_header->frame : NULL;
 }
 
+IREE_API_EXPORT iree_vm_stack_frame_t* iree_vm_stack_frame_parent(
+    const iree_vm_stack_frame_t* frame) {
+  const iree_vm_stack_frame_header_t* header =
+      (const iree_vm_stack_frame_header_t*)((const uint8_t*)frame -
+                                            offsetof(
+                                                iree_vm_stack_frame_header_t,
+                                                frame));
+  return header->parent ? &header->parent->frame : NULL;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_stack_query_module_state(
     iree_vm_stack_t* stack, iree_vm_module_t* module,
     iree_vm_module_state_t** out_module_state) {
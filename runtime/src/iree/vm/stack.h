@@ -53,6 +53,12 @@ enum iree_vm_invocation_flag_bits_t {
   // Attributes invocation timings to the caller instead of a context or
   // invocation-specific fiber.
   IREE_VM_INVOCATION_FLAG_TRACE_INLINE = 1u << 1,
+
+  // Enables sampling-based profiling of bytecode execution and import call
+  // timing for the invocation. See iree/base/config.h for the flags that
+  // control whether this functionality is available; specifically:
+  //   -DIREE_VM_EXECUTION_PROFILING_ENABLE=1
+  IREE_VM_INVOCATION_FLAG_PROFILE_EXECUTION = 1u << 2,
 };
 typedef uint32_t iree_vm_invocation_flags_t;
 
@@ -263,6 +269,12 @@ IREE_API_EXPORT iree_vm_stack_frame_t* iree_vm_stack_current_frame(
 IREE_API_EXPORT iree_vm_stack_frame_t* iree_vm_stack_parent_frame(
     iree_vm_stack_t* stack);
 
+// Returns the frame that called |frame| or nullptr if |frame| is the root.
+// Walking from iree_vm_stack_current_frame visits the whole call stack. Frame
+// pointers are invalidated by any operation that enters or leaves a frame.
+IREE_API_EXPORT iree_vm_stack_frame_t* iree_vm_stack_frame_parent(
+    const iree_vm_stack_frame_t* frame);
+
 // Queries the context-specific module state for the given module.
 IREE_API_EXPORT iree_status_t iree_vm_stack_query_module_state(
     iree_vm_stack_t* stack, iree_vm_module_t* module,
@@ -71,6 +71,45 @@ TEST(VMStackTest, Usage) {
   iree_vm_stack_deinitialize(stack);
 }
 
+// Tests walking from the current frame to the root of the stack.
+TEST(VMStackTest, FrameParentWalk) {
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  state_resolver, iree_allocator_system());
+
+  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_function_t function_b = {MODULE_B_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 1};
+  iree_vm_stack_frame_t* frame = nullptr;
+  IREE_EXPECT_OK(iree_vm_stack_function_enter(
+      stack, &function_a, IREE_VM_STACK_FRAME_NATIVE, 0, NULL, &frame));
+  EXPECT_EQ(nullptr, iree_vm_stack_frame_parent(frame));
+  IREE_EXPECT_OK(iree_vm_stack_function_enter(
+      stack, &function_b, IREE_VM_STACK_FRAME_NATIVE, 0, NULL, &frame));
+  IREE_EXPECT_OK(iree_vm_stack_function_enter(
+      stack, &function_a, IREE_VM_STACK_FRAME_NATIVE, 0, NULL, &frame));
+
+  // Frames are visited from the current frame (a) to the root (a).
+  int ordinals[4] = {-1, -1, -1, -1};
+  int depth = 0;
+  for (iree_vm_stack_frame_t* it = iree_vm_stack_current_frame(stack);
+       it != nullptr && depth < 4; it = iree_vm_stack_frame_parent(it)) {
+    ordinals[depth++] = it->function.ordinal;
+  }
+  EXPECT_EQ(3, depth);
+  EXPECT_EQ(0, ordinals[0]);
+  EXPECT_EQ(1, ordinals[1]);
+  EXPECT_EQ(0, ordinals[2]);
+  EXPECT_EQ(iree_vm_stack_parent_frame(stack),
+            iree_vm_stack_frame_parent(iree_vm_stack_current_frame(stack)));
+
+  IREE_EXPECT_OK(iree_vm_stack_function_leave(stack));
+  IREE_EXPECT_OK(iree_vm_stack_function_leave(stack));
+  IREE_EXPECT_OK(iree_vm_stack_function_leave(stack));
+  iree_vm_stack_deinitialize(stack);
+}
+
 // Tests stack cleanup with unpopped frames (like during failure teardown).
 TEST(VMStackTest, DeinitWithRemainingFrames) {
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
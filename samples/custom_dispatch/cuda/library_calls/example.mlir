@@ -0,0 +1,87 @@
+// RUN: iree-compile %s | \
+// RUN: iree-run-module \
+// RUN:     --device=cuda \
+// RUN:     --function=matmul_relu \
+// RUN:     --input=4x8xf32=1 \
+// RUN:     --input=8x16xf32=-0.5 \
+// RUN:     --input=4x16xf32=2 | \
+// RUN: FileCheck %s
+
+// The configuration used for executable compilation.
+#nvptx_sm_80_target = #hal.executable.target<"cuda", "cuda-nvptx-fb", {
+  target_arch = "sm_80"
+}>
+
+// The target devices that the program will run on.
+#cuda_target = #hal.device.target<"cuda", {
+  executable_targets = [
+    #nvptx_sm_80_target
+  ],
+  // HACK: CUDA target currently uses the legacy synchronous execution model.
+  legacy_sync
+}>
+
+module @example attributes {hal.device.targets = [#cuda_target]} {
+
+  // Executable whose exports are implemented by cuBLASLt instead of kernels.
+  // No objects are required when all exports are library calls; they can also
+  // be mixed with hand-authored kernels in the same executable as in the
+  // custom_dispatch/cuda/kernels sample.
+  //
+  // The runtime creates the cuBLASLt matmul descriptor and selects an
+  // algorithm with the cuBLASLt heuristics once when the executable is loaded
+  // and each dispatch only issues the cublasLtMatmul call. Command buffers
+  // recorded as CUDA graphs capture the call into a child graph.
+  hal.executable.source private @executable {
+
+    // `out = relu(lhs * rhs + bias)` with row-major lhs of 4x8, rhs of 8x16,
+    // and bias of 16 broadcast along the rows of the 4x16 result.
+    // Bindings must be declared in set 0 as lhs, rhs, [bias], out.
+    hal.executable.export public @matmul_bias_relu ordinal(0)
+        layout(#hal.pipeline.layout<push_constants = 0, sets = [
+          <0, bindings = [
+              <0, storage_buffer, ReadOnly>,
+              <1, storage_buffer, ReadOnly>,
+              <2, storage_buffer, ReadOnly>,
+              <3, storage_buffer>
+          ]>
+        ]>) attributes {
+      iree.cuda.library_call = {
+        op = "matmul",
+        m = 4 : i64, n = 16 : i64, k = 8 : i64,
+        element_type = f32,
+        epilogue = "relu_bias"
+      },
+      // Library calls size their own launches and ignore the workgroup size
+      // and count.
+      workgroup_size = [1 : index, 1 : index, 1 : index]
+    } {
+    ^bb0(%device: !hal.device):
+      %c1 = arith.constant 1 : index
+      hal.return %c1, %c1, %c1 : index, index, index
+    }
+
+  }  // hal.executable.source
+
+  // Function demonstrating a library call dispatch mixed with codegen.
+  // Invoke with:
+  //  --device=cuda
+  //  --function=matmul_relu
+  //  --input=4x8xf32=1
+  //  --input=8x16xf32=-0.5
+  //  --input=4x16xf32=2
+  // CHECK-LABEL: EXEC @matmul_relu
+  func.func @matmul_relu(%lhs: tensor<4x8xf32>, %rhs: tensor<8x16xf32>, %addend: tensor<4x16xf32>) -> tensor<4x16xf32> {
+    %bias = arith.constant dense<3.0> : tensor<16xf32>
+
+    // relu(1 * -0.5 * 8 + 3) = relu(-1) = 0
+    %0 = flow.dispatch @executable::@matmul_bias_relu(%lhs, %rhs, %bias) : (tensor<4x8xf32>, tensor<8x16xf32>, tensor<16xf32>) -> tensor<4x16xf32>
+
+    // Code generated ops consume the library call results as usual.
+    %1 = arith.addf %0, %addend : tensor<4x16xf32>
+
+    // CHECK: 4x16xf32=[2 2 2 2 2 2 2 2 2 2 2 2 2 2 2 2]
+    return %1 : tensor<4x16xf32>
+  }
+
+}  // module
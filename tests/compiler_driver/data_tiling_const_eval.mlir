@@ -0,0 +1,27 @@
+// RUN: iree-compile --compile-to=flow \
+// RUN:   --iree-hal-target-backends=llvm-cpu \
+// RUN:   --iree-llvmcpu-target-triple=x86_64-unknown-linux-gnu \
+// RUN:   --iree-flow-enable-data-tiling \
+// RUN:   --iree-opt-const-expr-hoisting \
+// RUN:   --iree-opt-const-eval %s | \
+// RUN: FileCheck %s --implicit-check-not=util.initializer \
+// RUN:   --implicit-check-not="tensor<2x3xf32> ->"
+
+// Data-tiled constant weights are packed by const-eval into rodata instead of
+// by a pack dispatch at startup or on every invocation. Only the activations
+// are packed at runtime.
+
+util.global private @rhs = dense<[[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]> : tensor<2x3xf32>
+
+// CHECK: util.global private @[[PACKED:[^ ]+]] {{.*}}= dense<{{.+}}> : tensor<{{.+}}xf32>
+// CHECK: func.func @matmul
+// CHECK:   util.global.load @[[PACKED]]
+func.func @matmul(%lhs: tensor<4x2xf32>) -> tensor<4x3xf32> {
+  %rhs = util.global.load @rhs : tensor<2x3xf32>
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<4x3xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<4x3xf32>) -> tensor<4x3xf32>
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<4x2xf32>, tensor<2x3xf32>)
+                     outs(%fill : tensor<4x3xf32>) -> tensor<4x3xf32>
+  return %0 : tensor<4x3xf32>
+}
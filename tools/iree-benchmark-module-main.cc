@@ -51,10 +51,33 @@
 // how the full program will run, though, and YMMV. Always verify timings with
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
-
+//
+// The benchmarks above are closed-loop: the next invocation is issued as soon
+// as the previous one completes and they measure peak throughput. Passing
+// --open_loop_qps=N or --open_loop_trace=file instead runs --function= in
+// open-loop mode where invocations are issued at fixed arrival times
+// independent of when earlier ones complete. This measures latency under load
+// and reports the achieved throughput and latency percentiles. As with real
+// request servers invocations arriving while all --open_loop_contexts are busy
+// are queued and the queueing delay counts toward their latency.
+//
+// Passing --dispatch_timing prints a table to stderr after the benchmarks
+// complete with the number of times each dispatch ran, its total and mean wall
+// time, and its share of the total dispatch time. This helps attribute the
+// end-to-end time to individual dispatches without attaching a profiler but
+// is only supported by HAL devices implementing the dispatch-timestamps
+// profiling mode (today the local-task and local-sync CPU devices); others
+// ignore it.
+
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <iterator>
+#include <memory>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -63,6 +86,7 @@
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/loop_sync.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/types.h"
@@ -84,6 +108,27 @@ IREE_FLAG(int32_t, batch_size, 1,
 IREE_FLAG(int32_t, batch_concurrency, 1,
           "Number of invocations within a batch that should run concurrently.");
 
+IREE_FLAG(double, open_loop_qps, 0.0,
+          "Runs --function= open-loop with invocations arriving at the given "
+          "rate in queries per second instead of running closed-loop "
+          "benchmarks.");
+IREE_FLAG(string, open_loop_arrivals, "poisson",
+          "Arrival process used with --open_loop_qps: 'poisson' for "
+          "exponentially distributed inter-arrival times or 'uniform' for a "
+          "fixed interval.");
+IREE_FLAG(string, open_loop_trace, "",
+          "Runs --function= open-loop with invocations arriving at the times "
+          "listed in the given file, one per line in milliseconds from the "
+          "start of the run.");
+IREE_FLAG(int32_t, open_loop_requests, 1000,
+          "Number of invocations issued with --open_loop_qps.");
+IREE_FLAG(int32_t, open_loop_contexts, 1,
+          "Number of contexts sharing the device that serve open-loop "
+          "invocations concurrently. Each context runs one invocation at a "
+          "time.");
+IREE_FLAG(int64_t, open_loop_seed, 0,
+          "Seed for the random arrival process used with --open_loop_qps.");
+
 IREE_FLAG(string, function, "",
           "Name of a function contained in the module specified by --module= "
           "to run. If this is not set, all the exported functions will be "
@@ -92,6 +137,10 @@ IREE_FLAG(string, function, "",
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(bool, dispatch_timing, false,
+          "Prints the wall time of each dispatch aggregated over the run to "
+          "stderr on exit. Overrides --device_profiling_mode.");
+
 IREE_FLAG_LIST(
     string, input,
     "An input value or buffer of the format:\n"
@@ -224,7 +273,7 @@ static void BenchmarkAsyncFunction(
     iree_vm_list_t* common_inputs, benchmark::State& state) {
   IREE_TRACE_SCOPE_DYNAMIC(benchmark_name.c_str());
   IREE_TRACE_FRAME_MARK();
-  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_allocator_t host_allocator = iree_tooling_host_allocator();
 
   // Round up batch size to some multiple of concurrency.
   batch_size = (int32_t)iree_host_align(batch_size, batch_concurrency);
@@ -403,6 +452,313 @@ void RegisterDispatchBenchmark(const std::string& function_name,
                                   : benchmark::kMicrosecond);
 }
 
+//===----------------------------------------------------------------------===//
+// Profiling
+//===----------------------------------------------------------------------===//
+
+// Begins profiling |device| with dispatch timestamps if --dispatch_timing is
+// set and otherwise with the --device_profiling_* flags.
+static iree_status_t BeginProfiling(iree_hal_device_t* device) {
+  if (!FLAG_dispatch_timing) return iree_hal_begin_profiling_from_flags(device);
+  iree_hal_device_profiling_options_t options = {0};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_TIMESTAMPS;
+  return iree_hal_device_profiling_begin(device, &options);
+}
+
+static iree_status_t EndProfiling(iree_hal_device_t* device) {
+  if (!FLAG_dispatch_timing) return iree_hal_end_profiling_from_flags(device);
+  return iree_hal_device_profiling_end(device);
+}
+
+//===----------------------------------------------------------------------===//
+// Open-loop load generation
+//===----------------------------------------------------------------------===//
+
+static bool IsOpenLoopEnabled() {
+  return FLAG_open_loop_qps > 0.0 || strlen(FLAG_open_loop_trace) > 0;
+}
+
+// Computes the arrival time of each invocation relative to the start of the
+// run from either --open_loop_trace or --open_loop_qps.
+static iree_status_t ComputeOpenLoopArrivals(
+    std::vector<iree_duration_t>* out_arrivals_ns) {
+  out_arrivals_ns->clear();
+  if (strlen(FLAG_open_loop_trace) > 0) {
+    FILE* file = fopen(FLAG_open_loop_trace, "r");
+    if (!file) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "unable to open arrival trace '%s'",
+                              FLAG_open_loop_trace);
+    }
+    double arrival_ms = 0.0;
+    while (fscanf(file, "%lf", &arrival_ms) == 1) {
+      out_arrivals_ns->push_back((iree_duration_t)(arrival_ms * 1e6));
+    }
+    fclose(file);
+    if (out_arrivals_ns->empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "arrival trace '%s' contains no arrivals",
+                              FLAG_open_loop_trace);
+    }
+    std::sort(out_arrivals_ns->begin(), out_arrivals_ns->end());
+    return iree_ok_status();
+  }
+
+  bool poisson = false;
+  if (strcmp(FLAG_open_loop_arrivals, "poisson") == 0) {
+    poisson = true;
+  } else if (strcmp(FLAG_open_loop_arrivals, "uniform") != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported arrival process '%s'; expected "
+                            "'poisson' or 'uniform'",
+                            FLAG_open_loop_arrivals);
+  }
+  if (FLAG_open_loop_requests <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--open_loop_requests must be positive");
+  }
+  std::mt19937_64 generator(FLAG_open_loop_seed);
+  std::exponential_distribution<double> interarrival_s(FLAG_open_loop_qps);
+  double arrival_s = 0.0;
+  for (int32_t i = 0; i < FLAG_open_loop_requests; ++i) {
+    out_arrivals_ns->push_back((iree_duration_t)(arrival_s * 1e9));
+    arrival_s += poisson ? interarrival_s(generator) : 1.0 / FLAG_open_loop_qps;
+  }
+  return iree_ok_status();
+}
+
+// Issues asynchronous invocations of |function| at |arrivals_ns| relative to
+// the start of the run. Each context runs at most one invocation at a time and
+// invocations arriving while all contexts are busy are queued. Latency is
+// measured from arrival to completion and so includes the queueing delay.
+//
+// Functions using the coarse-fences ABI are considered complete when their
+// signal fence is reached and not when the invocation returns.
+class OpenLoopRunner {
+ public:
+  OpenLoopRunner(iree_hal_device_t* device,
+                 const std::vector<iree_vm_context_t*>& contexts,
+                 iree_vm_function_t function, bool coarse_fences,
+                 iree_vm_list_t* common_inputs,
+                 std::vector<iree_duration_t> arrivals_ns)
+      : device_(device),
+        function_(function),
+        coarse_fences_(coarse_fences),
+        common_inputs_(common_inputs),
+        arrivals_ns_(std::move(arrivals_ns)) {
+    for (auto* context : contexts) {
+      auto slot = std::make_unique<Slot>();
+      slot->runner = this;
+      slot->context = context;
+      idle_slots_.push_back(slot.get());
+      slots_.push_back(std::move(slot));
+    }
+  }
+
+  iree_status_t Run() {
+    IREE_TRACE_SCOPE0("OpenLoopRunner::Run");
+    if (coarse_fences_) {
+      for (auto& slot : slots_) {
+        IREE_RETURN_IF_ERROR(
+            iree_hal_semaphore_create(device_, 0ull, &slot->semaphore));
+      }
+    }
+
+    // Each busy context has at most one pending operation and one wait.
+    iree_loop_sync_options_t options = {0};
+    options.max_queue_depth = 2 * slots_.size() + 8;
+    options.max_wait_count = slots_.size() + 8;
+    iree_loop_sync_t* loop_sync = nullptr;
+    IREE_RETURN_IF_ERROR(
+        iree_loop_sync_allocate(options, host_allocator_, &loop_sync));
+    iree_loop_sync_scope_t scope;
+    iree_loop_sync_scope_initialize(loop_sync, OnLoopError, this, &scope);
+    iree_loop_t loop = iree_loop_sync_scope(&scope);
+
+    start_time_ns_ = iree_time_now();
+    iree_status_t status = ScheduleNextArrival(loop);
+    if (iree_status_is_ok(status)) {
+      status = iree_loop_sync_wait_idle(loop_sync, iree_infinite_timeout());
+    }
+    iree_loop_sync_scope_deinitialize(&scope);
+    iree_loop_sync_free(loop_sync);
+    if (iree_status_is_ok(status)) {
+      status = loop_status_;
+      loop_status_ = iree_ok_status();
+    }
+    return status;
+  }
+
+  void PrintReport(benchmark::TimeUnit time_unit) const {
+    const char* unit_string = kMillisecondsUnitString;
+    double unit_ns = 1e6;
+    if (time_unit == benchmark::kMicrosecond) {
+      unit_string = kMicrosecondsUnitString;
+      unit_ns = 1e3;
+    } else if (time_unit == benchmark::kNanosecond) {
+      unit_string = kNanosecondsUnitString;
+      unit_ns = 1.0;
+    }
+
+    std::vector<iree_duration_t> latencies_ns = latencies_ns_;
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    double duration_s = (last_completion_time_ns_ - start_time_ns_) / 1e9;
+    double offered_duration_s = arrivals_ns_.back() / 1e9;
+    fprintf(stdout, "Open-loop: %zu invocations across %zu contexts\n",
+            latencies_ns.size(), slots_.size());
+    if (offered_duration_s > 0.0) {
+      fprintf(stdout, "  offered throughput:  %.2f QPS\n",
+              arrivals_ns_.size() / offered_duration_s);
+    }
+    if (duration_s > 0.0) {
+      fprintf(stdout, "  achieved throughput: %.2f QPS\n",
+              latencies_ns.size() / duration_s);
+    }
+    static const std::pair<const char*, double> kPercentiles[] = {
+        {"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p999", 0.999}};
+    for (const auto& [name, percentile] : kPercentiles) {
+      // Nearest-rank percentile.
+      size_t rank = (size_t)std::ceil(percentile * latencies_ns.size());
+      iree_duration_t latency_ns = latencies_ns[std::max<size_t>(rank, 1) - 1];
+      fprintf(stdout, "  latency %-4s: %.3f %s\n", name, latency_ns / unit_ns,
+              unit_string);
+    }
+  }
+
+ private:
+  // State of one context serving invocations.
+  struct Slot {
+    OpenLoopRunner* runner = nullptr;
+    iree_vm_context_t* context = nullptr;
+    // Storage for the in-flight invocation.
+    iree_vm_async_invoke_state_t state;
+    // Timeline the invocations on the context signal when using the
+    // coarse-fences ABI.
+    vm::ref<iree_hal_semaphore_t> semaphore;
+    uint64_t timeline_value = 0;
+    vm::ref<iree_hal_fence_t> signal_fence;
+    // Index of the in-flight invocation in |arrivals_ns_|.
+    size_t request = 0;
+  };
+
+  static void OnLoopError(void* user_data, iree_status_t status) {
+    auto* runner = reinterpret_cast<OpenLoopRunner*>(user_data);
+    if (iree_status_is_ok(runner->loop_status_)) {
+      runner->loop_status_ = status;
+    } else {
+      iree_status_ignore(status);
+    }
+  }
+
+  iree_status_t ScheduleNextArrival(iree_loop_t loop) {
+    if (next_arrival_ >= arrivals_ns_.size()) return iree_ok_status();
+    iree_time_t arrival_time_ns = start_time_ns_ + arrivals_ns_[next_arrival_];
+    return iree_loop_wait_until(loop, iree_make_deadline(arrival_time_ns),
+                                OnArrival, this);
+  }
+
+  static iree_status_t OnArrival(void* user_data, iree_loop_t loop,
+                                 iree_status_t status) {
+    IREE_RETURN_IF_ERROR(status);
+    auto* runner = reinterpret_cast<OpenLoopRunner*>(user_data);
+    runner->pending_requests_.push_back(runner->next_arrival_++);
+    IREE_RETURN_IF_ERROR(runner->ScheduleNextArrival(loop));
+    return runner->DispatchPending(loop);
+  }
+
+  // Starts queued invocations on idle contexts.
+  iree_status_t DispatchPending(iree_loop_t loop) {
+    while (!pending_requests_.empty() && !idle_slots_.empty()) {
+      Slot* slot = idle_slots_.back();
+      idle_slots_.pop_back();
+      slot->request = pending_requests_.front();
+      pending_requests_.pop_front();
+      IREE_RETURN_IF_ERROR(Invoke(slot, loop));
+    }
+    return iree_ok_status();
+  }
+
+  iree_status_t Invoke(Slot* slot, iree_loop_t loop) {
+    IREE_TRACE_SCOPE0("OpenLoopRunner::Invoke");
+    vm::ref<iree_vm_list_t> inputs = vm::retain_ref(common_inputs_);
+    if (coarse_fences_) {
+      // Clone common inputs and add the invocation-specific fences. The
+      // invocation waits on nothing and begins executing immediately.
+      if (common_inputs_) {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_list_clone(common_inputs_, host_allocator_, &inputs));
+      } else {
+        IREE_RETURN_IF_ERROR(iree_vm_list_create(
+            iree_vm_make_undefined_type_def(), 2, host_allocator_, &inputs));
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_fence_create_at(
+          slot->semaphore.get(), ++slot->timeline_value, host_allocator_,
+          &slot->signal_fence));
+      vm::ref<iree_hal_fence_t> wait_fence;
+      vm::ref<iree_hal_fence_t> signal_fence =
+          vm::retain_ref(slot->signal_fence);
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_ref_move(inputs.get(), wait_fence));
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_ref_move(inputs.get(), signal_fence));
+    }
+    return iree_vm_async_invoke(loop, &slot->state, slot->context, function_,
+                                IREE_VM_INVOCATION_FLAG_NONE,
+                                /*policy=*/nullptr, inputs.get(),
+                                /*outputs=*/nullptr, host_allocator_,
+                                OnInvokeComplete, slot);
+  }
+
+  static iree_status_t OnInvokeComplete(void* user_data, iree_loop_t loop,
+                                        iree_status_t status,
+                                        iree_vm_list_t* outputs) {
+    iree_vm_list_release(outputs);
+    IREE_RETURN_IF_ERROR(status);
+    auto* slot = reinterpret_cast<Slot*>(user_data);
+    if (slot->signal_fence) {
+      return iree_loop_wait_one(loop,
+                                iree_hal_fence_await(slot->signal_fence.get()),
+                                iree_infinite_timeout(), OnFenceSignaled, slot);
+    }
+    return slot->runner->Retire(slot, loop);
+  }
+
+  static iree_status_t OnFenceSignaled(void* user_data, iree_loop_t loop,
+                                       iree_status_t status) {
+    IREE_RETURN_IF_ERROR(status);
+    auto* slot = reinterpret_cast<Slot*>(user_data);
+    slot->signal_fence.reset();
+    return slot->runner->Retire(slot, loop);
+  }
+
+  // Records the latency of the completed invocation on |slot| and reuses the
+  // context for the next queued invocation, if any.
+  iree_status_t Retire(Slot* slot, iree_loop_t loop) {
+    last_completion_time_ns_ = iree_time_now();
+    latencies_ns_.push_back(last_completion_time_ns_ - start_time_ns_ -
+                            arrivals_ns_[slot->request]);
+    idle_slots_.push_back(slot);
+    return DispatchPending(loop);
+  }
+
+  iree_hal_device_t* device_ = nullptr;
+  iree_vm_function_t function_;
+  bool coarse_fences_ = false;
+  iree_vm_list_t* common_inputs_ = nullptr;
+  iree_allocator_t host_allocator_ = iree_allocator_system();
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::vector<Slot*> idle_slots_;
+  std::deque<size_t> pending_requests_;
+  std::vector<iree_duration_t> arrivals_ns_;
+  size_t next_arrival_ = 0;
+
+  iree_time_t start_time_ns_ = 0;
+  iree_time_t last_completion_time_ns_ = 0;
+  std::vector<iree_duration_t> latencies_ns_;
+  iree_status_t loop_status_ = iree_ok_status();
+};
+
 // The lifetime of IREEBenchmark should be as long as
 // ::benchmark::RunSpecifiedBenchmarks() where the resources are used during
 // benchmarking.
@@ -446,12 +802,78 @@ class IREEBenchmark {
     return iree_ok_status();
   }
 
+  // Runs --function= open-loop at the arrival times given by the
+  // --open_loop_* flags and prints the achieved throughput and latencies.
+  iree_status_t RunOpenLoop() {
+    IREE_TRACE_SCOPE0("IREEBenchmark::RunOpenLoop");
+
+    if (!instance_ || !device_allocator_ || !context_ || !main_module_) {
+      IREE_RETURN_IF_ERROR(Init());
+    }
+
+    auto function_name = std::string(FLAG_function);
+    if (function_name.empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--function= must be specified in open-loop "
+                              "mode");
+    }
+    if (FLAG_open_loop_contexts <= 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--open_loop_contexts must be positive");
+    }
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
+        main_module_.get(), IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function));
+    IREE_RETURN_IF_ERROR(iree_tooling_parse_to_variant_list(
+        device_allocator_.get(), FLAG_input_list().values,
+        FLAG_input_list().count, iree_vm_instance_allocator(instance_.get()),
+        &inputs_));
+    iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
+        &function, IREE_SV("iree.abi.model"));
+    bool coarse_fences =
+        iree_string_view_equal(invocation_model, IREE_SV("coarse-fences"));
+
+    std::vector<iree_duration_t> arrivals_ns;
+    IREE_RETURN_IF_ERROR(ComputeOpenLoopArrivals(&arrivals_ns));
+
+    // Additional contexts share the modules of the main context and through
+    // the HAL module the same device.
+    iree_host_size_t module_count =
+        iree_vm_context_module_count(context_.get());
+    std::vector<iree_vm_module_t*> modules;
+    for (iree_host_size_t i = 0; i < module_count; ++i) {
+      modules.push_back(iree_vm_context_module_at(context_.get(), i));
+    }
+    std::vector<iree::vm::ref<iree_vm_context_t>> extra_contexts;
+    std::vector<iree_vm_context_t*> contexts = {context_.get()};
+    for (int32_t i = 1; i < FLAG_open_loop_contexts; ++i) {
+      iree::vm::ref<iree_vm_context_t> context;
+      IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+          instance_.get(), IREE_VM_CONTEXT_FLAG_NONE, modules.size(),
+          modules.data(), iree_allocator_system(), &context));
+      contexts.push_back(context.get());
+      extra_contexts.push_back(std::move(context));
+    }
+
+    OpenLoopRunner runner(device_.get(), contexts, function, coarse_fences,
+                          inputs_.get(), std::move(arrivals_ns));
+    IREE_RETURN_IF_ERROR(BeginProfiling(device_.get()));
+    iree_status_t status = runner.Run();
+    IREE_RETURN_IF_ERROR(EndProfiling(device_.get()));
+    IREE_RETURN_IF_ERROR(status);
+    runner.PrintReport(FLAG_time_unit.first ? FLAG_time_unit.second
+                                            : benchmark::kMillisecond);
+    return iree_ok_status();
+  }
+
  private:
   iree_status_t Init() {
     IREE_TRACE_SCOPE0("IREEBenchmark::Init");
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
 
-    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_allocator_t host_allocator = iree_tooling_host_allocator();
     IREE_RETURN_IF_ERROR(
         iree_tooling_create_instance(host_allocator, &instance_));
 
@@ -585,14 +1007,17 @@ int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
 
   iree::IREEBenchmark iree_benchmark;
-  iree_status_t status = iree_benchmark.Register();
+  const bool open_loop = iree::IsOpenLoopEnabled();
+  iree_status_t status =
+      open_loop ? iree_benchmark.RunOpenLoop() : iree_benchmark.Register();
   if (!iree_status_is_ok(status)) {
     int ret = static_cast<int>(iree_status_code(status));
     printf("%s\n", iree::Status(std::move(status)).ToString().c_str());
     return ret;
   }
-  IREE_CHECK_OK(iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
+  if (open_loop) return 0;
+  IREE_CHECK_OK(iree::BeginProfiling(iree_benchmark.device()));
   ::benchmark::RunSpecifiedBenchmarks();
-  IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  IREE_CHECK_OK(iree::EndProfiling(iree_benchmark.device()));
   return 0;
 }
@@ -100,7 +100,8 @@ iree_status_t Run(std::string module_file_path, iree_allocator_t host_allocator,
         iree_stdin_read_contents(host_allocator, &flatbuffer_contents));
   } else {
     IREE_RETURN_IF_ERROR(iree_file_read_contents(
-        module_file_path.c_str(), host_allocator, &flatbuffer_contents));
+        module_file_path.c_str(), IREE_FILE_READ_FLAG_MMAP, host_allocator,
+        &flatbuffer_contents));
   }
   iree_vm_module_t* main_module = nullptr;
   IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
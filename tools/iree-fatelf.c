@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/path.h"
 #include "iree/hal/local/elf/fatelf.h"
@@ -35,10 +36,16 @@ static int print_usage() {
   fprintf(stderr, "Join multiple ELFs into a FatELF:\n");
   fprintf(stderr, "  iree-fatelf join elf_a.so elf_b.so > fatelf.sos\n");
   fprintf(stderr, "\n");
+  fprintf(stderr, "Join ELFs requiring CPU features (such as avx512,\n");
+  fprintf(stderr, "avx512vnni, dotprod, i8mm, sve) into a FatELF:\n");
+  fprintf(stderr,
+          "  iree-fatelf join elf.so elf_avx512.so@avx512,avx512vnni > "
+          "fatelf.sos\n");
+  fprintf(stderr, "\n");
   fprintf(stderr, "Split a FatELF into multiple ELF files (to dir):\n");
   fprintf(stderr, "  iree-fatelf split fatelf.sos\n");
   fprintf(stderr, "\n");
-  fprintf(stderr, "Select a FatELF matching the current arch:\n");
+  fprintf(stderr, "Select a FatELF matching the current arch and CPU:\n");
   fprintf(stderr, "  iree-fatelf select fatelf.sos > elf.so\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Dump header records:\n");
@@ -112,8 +119,7 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
-        .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
+        .features = iree_unaligned_load_le_u16(&raw_record->features),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
     };
@@ -178,8 +184,52 @@ typedef struct {
   uint64_t offset;
   iree_file_contents_t* contents;
   iree_const_byte_span_t elf_data;
+  // Comma-separated feature names following the `@` in the argument, if any.
+  iree_string_view_t feature_names;
 } fatelf_entry_t;
 
+// Parses comma-separated |feature_names| for records of |machine|.
+static iree_status_t fatelf_parse_features(
+    iree_elf64_half_t machine, iree_string_view_t feature_names,
+    iree_fatelf_features_t* out_features) {
+  *out_features = 0;
+  while (!iree_string_view_is_empty(feature_names)) {
+    iree_string_view_t name = iree_string_view_empty();
+    iree_string_view_split(feature_names, ',', &name, &feature_names);
+    name = iree_string_view_trim(name);
+    if (iree_string_view_is_empty(name)) continue;
+    iree_fatelf_features_t feature = 0;
+    IREE_RETURN_IF_ERROR(iree_fatelf_lookup_feature(machine, name, &feature));
+    *out_features |= feature;
+  }
+  return iree_ok_status();
+}
+
+// Formats |features| of |machine| records as `+`-separated feature names into
+// |buffer| or `base` if there are none.
+static const char* fatelf_format_features(iree_elf64_half_t machine,
+                                          iree_fatelf_features_t features,
+                                          char* buffer,
+                                          iree_host_size_t capacity) {
+  if (!features) return "base";
+  iree_host_size_t length = 0;
+  buffer[0] = 0;
+  for (int i = 0; i < 16; ++i) {
+    iree_fatelf_features_t feature = (iree_fatelf_features_t)(1u << i);
+    if (!(features & feature)) continue;
+    const char* name = iree_fatelf_feature_name(machine, feature);
+    const char* separator = length ? "+" : "";
+    int written =
+        name ? snprintf(buffer + length, capacity - length, "%s%s", separator,
+                        name)
+             : snprintf(buffer + length, capacity - length, "%sbit%d",
+                        separator, i);
+    if (written < 0 || (iree_host_size_t)written >= capacity - length) break;
+    length += written;
+  }
+  return buffer;
+}
+
 // Joins one or more ELF files together and writes the output to stdout.
 static iree_status_t fatelf_join(int argc, char** argv) {
   IREE_SET_BINARY_MODE(stdout);  // ensure binary output mode
@@ -194,8 +244,17 @@ static iree_status_t fatelf_join(int argc, char** argv) {
       (fatelf_entry_t*)iree_alloca(entry_count * sizeof(fatelf_entry_t));
   memset(entries, 0, entry_count * sizeof(*entries));
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
+    // Arguments may have the form `path@feature,feature`.
+    char* path = argv[i];
+    char* feature_separator = strrchr(path, '@');
+    if (feature_separator) {
+      *feature_separator = 0;
+      entries[i].feature_names =
+          iree_make_cstring_view(feature_separator + 1);
+    }
     IREE_RETURN_IF_ERROR(iree_file_read_contents(
-        argv[i], iree_allocator_system(), &entries[i].contents));
+        path, IREE_FILE_READ_FLAG_DEFAULT, iree_allocator_system(),
+        &entries[i].contents));
     entries[i].elf_data = entries[i].contents->const_buffer;
   }
 
@@ -228,6 +287,9 @@ static iree_status_t fatelf_join(int argc, char** argv) {
     IREE_RETURN_IF_ERROR(
         fatelf_parse_elf_metadata(entries[i].elf_data, &machine, &osabi,
                                   &osabi_version, &elf_class, &elf_data));
+    iree_fatelf_features_t features = 0;
+    IREE_RETURN_IF_ERROR(
+        fatelf_parse_features(machine, entries[i].feature_names, &features));
     iree_fatelf_record_t host_record = {
         .machine = machine,
         .osabi = osabi,
@@ -238,8 +300,7 @@ static iree_status_t fatelf_join(int argc, char** argv) {
         .byte_order = elf_data == IREE_ELF_ELFDATA2LSB
                           ? IREE_FATELF_BYTE_ORDER_LSB
                           : IREE_FATELF_BYTE_ORDER_MSB,
-        .reserved0 = 0,
-        .reserved1 = 0,
+        .features = features,
         .offset = (iree_elf64_off_t)entries[i].offset,
         .size = (iree_elf64_xword_t)entries[i].elf_data.data_length,
     };
@@ -327,8 +388,9 @@ static const char* fatelf_byte_order_id_str(iree_elf64_byte_t value) {
 // Splits a FatELF into multiple files, writing each beside the input file.
 static iree_status_t fatelf_split(int argc, char** argv) {
   iree_file_contents_t* fatelf_contents = NULL;
-  IREE_RETURN_IF_ERROR(iree_file_read_contents(argv[0], iree_allocator_system(),
-                                               &fatelf_contents));
+  IREE_RETURN_IF_ERROR(
+      iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
+                              iree_allocator_system(), &fatelf_contents));
   iree_fatelf_header_t* header = NULL;
   IREE_RETURN_IF_ERROR(fatelf_parse(fatelf_contents->const_buffer, &header));
 
@@ -344,13 +406,17 @@ static iree_status_t fatelf_split(int argc, char** argv) {
     const char* osabi_str = fatelf_osabi_id_str(record->osabi);
     const char* word_size_str = fatelf_word_size_id_str(record->word_size);
     const char* byte_order_str = fatelf_byte_order_id_str(record->byte_order);
+    char features_buffer[256];
+    const char* features_str =
+        fatelf_format_features(record->machine, record->features,
+                               features_buffer, sizeof(features_buffer));
 
     char record_path[2048];
-    iree_host_size_t record_path_length =
-        snprintf(record_path, IREE_ARRAYSIZE(record_path),
-                 "%.*s%s%.*s.%s_%s_%s%s.so", (int)dirname.size, dirname.data,
-                 dirname.size ? "/" : "", (int)stem.size, stem.data,
-                 machine_str, osabi_str, word_size_str, byte_order_str);
+    iree_host_size_t record_path_length = snprintf(
+        record_path, IREE_ARRAYSIZE(record_path), "%.*s%s%.*s.%s_%s_%s%s_%s.so",
+        (int)dirname.size, dirname.data, dirname.size ? "/" : "",
+        (int)stem.size, stem.data, machine_str, osabi_str, word_size_str,
+        byte_order_str, features_str);
     record_path_length =
         iree_file_path_canonicalize(record_path, record_path_length);
 
@@ -369,16 +435,19 @@ static iree_status_t fatelf_split(int argc, char** argv) {
   return iree_ok_status();
 }
 
-// Selects the ELF matching the current host config from a FatELF and writes
-// it to stdout.
+// Selects the ELF matching the current host config and CPU from a FatELF and
+// writes it to stdout.
 static iree_status_t fatelf_select(int argc, char** argv) {
   IREE_SET_BINARY_MODE(stdout);  // ensure binary output mode
   iree_file_contents_t* fatelf_contents = NULL;
-  IREE_RETURN_IF_ERROR(iree_file_read_contents(argv[0], iree_allocator_system(),
-                                               &fatelf_contents));
-  iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
   IREE_RETURN_IF_ERROR(
-      iree_fatelf_select(fatelf_contents->const_buffer, &elf_data));
+      iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
+                              iree_allocator_system(), &fatelf_contents));
+  iree_cpu_initialize(iree_allocator_system());
+  iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(iree_fatelf_select_for_cpu(
+      fatelf_contents->const_buffer, IREE_CPU_DATA_FIELD_COUNT,
+      iree_cpu_data_fields(), &elf_data));
   fwrite(elf_data.data, 1, elf_data.data_length, stdout);
   iree_file_contents_free(fatelf_contents);
   return iree_ok_status();
@@ -409,8 +478,9 @@ static const char* fatelf_byte_order_enum_str(iree_elf64_byte_t value) {
 // Dumps the FatELF file records.
 static iree_status_t fatelf_dump(int argc, char** argv) {
   iree_file_contents_t* fatelf_contents = NULL;
-  IREE_RETURN_IF_ERROR(iree_file_read_contents(argv[0], iree_allocator_system(),
-                                               &fatelf_contents));
+  IREE_RETURN_IF_ERROR(
+      iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
+                              iree_allocator_system(), &fatelf_contents));
   iree_fatelf_header_t* header = NULL;
   IREE_RETURN_IF_ERROR(fatelf_parse(fatelf_contents->const_buffer, &header));
 
@@ -434,10 +504,11 @@ static iree_status_t fatelf_dump(int argc, char** argv) {
             record->word_size, fatelf_word_size_enum_str(record->word_size));
     fprintf(stdout, " byte_order: %d / %02X = %s\n", record->byte_order,
             record->byte_order, fatelf_byte_order_enum_str(record->byte_order));
-    fprintf(stdout, "  reserved0: %d / %02X\n", record->reserved0,
-            record->reserved0);
-    fprintf(stdout, "  reserved1: %d / %02X\n", record->reserved1,
-            record->reserved1);
+    char features_buffer[256];
+    fprintf(stdout, "   features: %d / %04X = %s\n", record->features,
+            record->features,
+            fatelf_format_features(record->machine, record->features,
+                                   features_buffer, sizeof(features_buffer)));
     fprintf(stdout, "     offset: %" PRIu64 " / %016" PRIX64 "\n",
             record->offset, record->offset);
     fprintf(stdout, "       size: %" PRIu64 " / %016" PRIX64 "\n", record->size,
@@ -91,7 +91,7 @@ namespace {
 iree_status_t Run(int* out_exit_code) {
   IREE_TRACE_SCOPE0("iree-run-module");
 
-  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_allocator_t host_allocator = iree_tooling_host_allocator();
   vm::ref<iree_vm_instance_t> instance;
   IREE_RETURN_IF_ERROR(iree_tooling_create_instance(host_allocator, &instance),
                        "creating instance");
@@ -11,6 +11,8 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
 #include "iree/base/internal/path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/trace_replay.h"
@@ -23,6 +25,17 @@ IREE_FLAG(bool, trace_execution, false, "Traces VM execution to stderr.");
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(bool, honor_timestamps, false,
+          "Delays each call with a recorded `timestamp` until that many "
+          "seconds have elapsed since the replay started instead of running "
+          "calls back-to-back.");
+IREE_FLAG(bool, concurrent, false,
+          "Replays each trace file on its own thread concurrently with the "
+          "others instead of sequentially. Traces recorded from multiple "
+          "contexts are written as one file per context and can be replayed "
+          "as concurrent streams with their recorded timing when combined "
+          "with --honor_timestamps.");
+
 IREE_FLAG(bool, print_calls, false, "Prints all I/O for each call to stdout.");
 IREE_FLAG(bool, print_call_inputs, false,
           "Prints all inputs for each call before they are made to stdout.");
@@ -83,21 +96,27 @@ IREE_FLAG(int32_t, output_max_element_count, 1024,
           "Prints up to the maximum number of elements of output tensors, "
           "eliding the remainder.");
 
+// Serializes printing from concurrently replayed traces.
+static iree_slim_mutex_t iree_run_trace_print_mutex;
+
 static iree_status_t iree_trace_replay_call_before(void* user_data,
                                                    iree_trace_replay_t* replay,
                                                    yaml_document_t* document,
                                                    yaml_node_t* event_node,
                                                    iree_vm_function_t function,
                                                    iree_vm_list_t* input_list) {
+  iree_status_t status = iree_ok_status();
   if (FLAG_print_calls || FLAG_print_call_inputs) {
+    iree_slim_mutex_lock(&iree_run_trace_print_mutex);
     iree_string_view_t function_name = iree_vm_function_name(&function);
     fprintf(stdout, "--- CALL[%.*s] ---\n", (int)function_name.size,
             function_name.data);
-    IREE_RETURN_IF_ERROR(iree_tooling_variant_list_fprint(
+    status = iree_tooling_variant_list_fprint(
         IREE_SV("arg"), input_list,
-        (iree_host_size_t)FLAG_output_max_element_count, stdout));
+        (iree_host_size_t)FLAG_output_max_element_count, stdout);
+    iree_slim_mutex_unlock(&iree_run_trace_print_mutex);
   }
-  return iree_ok_status();
+  return status;
 }
 
 static iree_status_t iree_trace_replay_call_after(void* user_data,
@@ -106,28 +125,36 @@ static iree_status_t iree_trace_replay_call_after(void* user_data,
                                                   yaml_node_t* event_node,
                                                   iree_vm_function_t function,
                                                   iree_vm_list_t* output_list) {
+  iree_status_t status = iree_ok_status();
   if (FLAG_print_calls || FLAG_print_call_outputs) {
+    iree_slim_mutex_lock(&iree_run_trace_print_mutex);
     if (!FLAG_print_calls && !FLAG_print_call_inputs) {
       iree_string_view_t function_name = iree_vm_function_name(&function);
       fprintf(stdout, "--- CALL[%.*s] ---\n", (int)function_name.size,
               function_name.data);
     }
-    IREE_RETURN_IF_ERROR(iree_tooling_variant_list_fprint(
+    status = iree_tooling_variant_list_fprint(
         IREE_SV("result"), output_list,
-        (iree_host_size_t)FLAG_output_max_element_count, stdout));
+        (iree_host_size_t)FLAG_output_max_element_count, stdout);
+    iree_slim_mutex_unlock(&iree_run_trace_print_mutex);
   }
-  return iree_ok_status();
+  return status;
 }
 
 // Runs the trace in |file| using |root_path| as the base for any path lookups
-// required for external files referenced in |file|.
+// required for external files referenced in |file|. Recorded call timestamps
+// are relative to |timestamp_origin_ns| when honored.
 static iree_status_t iree_run_trace_file(iree_string_view_t root_path,
                                          FILE* file,
+                                         iree_time_t timestamp_origin_ns,
                                          iree_vm_instance_t* instance) {
   iree_trace_replay_flags_t replay_flags = IREE_TRACE_REPLAY_FLAG_NONE;
   if (FLAG_print_statistics) {
     replay_flags |= IREE_TRACE_REPLAY_FLAG_PRINT_STATISTICS;
   }
+  if (FLAG_honor_timestamps) {
+    replay_flags |= IREE_TRACE_REPLAY_FLAG_HONOR_TIMESTAMPS;
+  }
 
   iree_vm_context_flags_t context_flags = IREE_VM_CONTEXT_FLAG_NONE;
   if (FLAG_trace_execution) {
@@ -138,6 +165,7 @@ static iree_status_t iree_run_trace_file(iree_string_view_t root_path,
   IREE_RETURN_IF_ERROR(iree_trace_replay_initialize(
       root_path, instance, replay_flags, context_flags,
       iree_hal_available_driver_registry(), iree_allocator_system(), &replay));
+  replay.timestamp_origin_ns = timestamp_origin_ns;
 
   // Hook into all calls processed during the trace.
   replay.call_hooks.user_data = NULL;
@@ -197,43 +225,118 @@ static iree_status_t iree_run_trace_file(iree_string_view_t root_path,
   yaml_parser_delete(&parser);
 
   // Optionally process outputs from the replay session.
+  iree_slim_mutex_lock(&iree_run_trace_print_mutex);
   if (iree_status_is_ok(status)) {
     if (FLAG_output_list().count == 0) {
-      IREE_RETURN_IF_ERROR(
+      status = iree_status_annotate(
           iree_tooling_variant_list_fprint(
               IREE_SV("output"), replay.outputs,
               (iree_host_size_t)FLAG_output_max_element_count, stdout),
-          "printing results");
+          IREE_SV("printing results"));
     } else {
-      IREE_RETURN_IF_ERROR(
+      status = iree_status_annotate(
           iree_tooling_output_variant_list(
               replay.outputs, FLAG_output_list().values,
               FLAG_output_list().count,
               (iree_host_size_t)FLAG_output_max_element_count, stdout),
-          "outputting results");
+          IREE_SV("outputting results"));
     }
   }
+  iree_slim_mutex_unlock(&iree_run_trace_print_mutex);
 
   iree_trace_replay_deinitialize(&replay);
   return status;
 }
 
-// Runs each of the given traces files sequentially in isolated contexts.
+// Opens and runs the trace file at |file_path| in an isolated context.
+static iree_status_t iree_run_trace_file_path(const char* file_path_cstr,
+                                              iree_time_t timestamp_origin_ns,
+                                              iree_vm_instance_t* instance) {
+  iree_string_view_t file_path = iree_make_cstring_view(file_path_cstr);
+  iree_string_view_t root_path = iree_file_path_dirname(file_path);
+  FILE* file = fopen(file_path_cstr, "rb");
+  if (!file) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open trace file '%.*s'",
+                            (int)file_path.size, file_path.data);
+  }
+  iree_status_t status =
+      iree_run_trace_file(root_path, file, timestamp_origin_ns, instance);
+  fclose(file);
+  return iree_status_annotate_f(status, "replaying trace file '%.*s'",
+                                (int)file_path.size, file_path.data);
+}
+
+// A trace file replayed on its own thread with --concurrent.
+typedef struct iree_run_trace_stream_t {
+  const char* file_path;
+  iree_time_t timestamp_origin_ns;
+  iree_vm_instance_t* instance;
+  iree_thread_t* thread;
+  iree_status_t status;
+} iree_run_trace_stream_t;
+
+static int iree_run_trace_stream_main(void* entry_arg) {
+  iree_run_trace_stream_t* stream = (iree_run_trace_stream_t*)entry_arg;
+  stream->status = iree_run_trace_file_path(
+      stream->file_path, stream->timestamp_origin_ns, stream->instance);
+  return 0;
+}
+
+// Runs each of the given traces files concurrently in isolated contexts with
+// one thread per file.
+static iree_status_t iree_run_trace_files_concurrently(
+    int file_count, char** file_paths, iree_time_t timestamp_origin_ns,
+    iree_vm_instance_t* instance) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_run_trace_stream_t* streams = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, file_count * sizeof(*streams), (void**)&streams));
+  memset(streams, 0, file_count * sizeof(*streams));
+
+  iree_status_t status = iree_ok_status();
+  int stream_count = 0;
+  for (; stream_count < file_count; ++stream_count) {
+    iree_run_trace_stream_t* stream = &streams[stream_count];
+    stream->file_path = file_paths[stream_count];
+    stream->timestamp_origin_ns = timestamp_origin_ns;
+    stream->instance = instance;
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-run-trace-stream");
+    status = iree_thread_create(iree_run_trace_stream_main, stream, params,
+                                host_allocator, &stream->thread);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  // Releasing the threads joins them. The first failure is returned.
+  for (int i = 0; i < stream_count; ++i) {
+    iree_thread_release(streams[i].thread);
+    if (iree_status_is_ok(status)) {
+      status = streams[i].status;
+    } else {
+      iree_status_ignore(streams[i].status);
+    }
+  }
+
+  iree_allocator_free(host_allocator, streams);
+  return status;
+}
+
+// Runs each of the given traces files in isolated contexts. Files run
+// sequentially unless --concurrent is set.
 static iree_status_t iree_run_trace_files(int file_count, char** file_paths,
                                           iree_vm_instance_t* instance) {
+  // All traces share the same timeline so that streams recorded concurrently
+  // replay with their relative timing.
+  const iree_time_t timestamp_origin_ns = iree_time_now();
+  if (FLAG_concurrent && file_count > 1) {
+    return iree_run_trace_files_concurrently(file_count, file_paths,
+                                             timestamp_origin_ns, instance);
+  }
   for (int i = 0; i < file_count; ++i) {
-    iree_string_view_t file_path = iree_make_cstring_view(file_paths[i]);
-    iree_string_view_t root_path = iree_file_path_dirname(file_path);
-    FILE* file = fopen(file_paths[i], "rb");
-    if (!file) {
-      return iree_make_status(iree_status_code_from_errno(errno),
-                              "failed to open trace file '%.*s'",
-                              (int)file_path.size, file_path.data);
-    }
-    iree_status_t status = iree_run_trace_file(root_path, file, instance);
-    fclose(file);
-    IREE_RETURN_IF_ERROR(status, "replaying trace file '%.*s'",
-                         (int)file_path.size, file_path.data);
+    IREE_RETURN_IF_ERROR(
+        iree_run_trace_file_path(file_paths[i], timestamp_origin_ns, instance));
   }
   return iree_ok_status();
 }
@@ -311,7 +414,9 @@ int main(int argc, char** argv) {
       "`type: call`\n"
       "Invokes a function in the context by fully-qualified `function` name.\n"
       "Uses arguments from an `args` sequence and produces results into a\n"
-      "`results` sequence.\n"
+      "`results` sequence. An optional `timestamp` records when the call was\n"
+      "made in seconds since the recording started and is used to pace the\n"
+      "replay with --honor_timestamps.\n"
       "\n"
       "--- Sources ---\n"
       "\n"
@@ -356,6 +461,7 @@ int main(int argc, char** argv) {
       "are consumed via `!blackboard.take` or the blackboard is cleared.\n"
       "\n");
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  iree_slim_mutex_initialize(&iree_run_trace_print_mutex);
   if (argc <= 1) {
     fprintf(stderr,
             "no trace files provided; pass one or more yaml file paths");
@@ -369,6 +475,7 @@ int main(int argc, char** argv) {
     status = iree_run_trace_files(argc - 1, argv + 1, instance);
   }
   iree_vm_instance_release(instance);
+  iree_slim_mutex_deinitialize(&iree_run_trace_print_mutex);
   if (!iree_status_is_ok(status)) {
     iree_status_fprint(stderr, status);
     iree_status_free(status);
@@ -1,8 +1,16 @@
 // RUN: iree-compile --iree-hal-target-backends=vmvx %s | iree-benchmark-module --device=local-task --function=abs --input=f32=-2 | FileCheck %s
 // RUN: [[ $IREE_VULKAN_DISABLE == 1 ]] || (iree-compile --iree-hal-target-backends=vulkan-spirv %s | iree-benchmark-module --device=vulkan --function=abs --input=f32=-2 | FileCheck %s)
 // RUN: iree-compile --iree-hal-target-backends=llvm-cpu %s | iree-benchmark-module --device=local-task --function=abs --input=f32=-2 | FileCheck %s
+// RUN: iree-compile --iree-hal-target-backends=vmvx %s | iree-benchmark-module --device=local-task --function=abs --input=f32=-2 --open_loop_qps=1000 --open_loop_requests=32 --open_loop_contexts=2 | FileCheck --check-prefix=OPEN-LOOP %s
+// RUN: iree-compile --iree-hal-target-backends=vmvx %s | iree-benchmark-module --device=local-task --function=abs --input=f32=-2 --dispatch_timing 2>&1 | FileCheck --check-prefix=DISPATCH-TIMING %s
 
 // CHECK-LABEL: BM_abs
+// OPEN-LOOP: Open-loop: 32 invocations across 2 contexts
+// OPEN-LOOP: achieved throughput:
+// OPEN-LOOP: latency p50 :
+// OPEN-LOOP: latency p999:
+// DISPATCH-TIMING: export,dispatches,time_ns,mean_time_ns,percent
+// DISPATCH-TIMING-NEXT: {{.+}},{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},
 func.func @abs(%input : tensor<f32>) -> (tensor<f32>) {
   %result = math.absf %input : tensor<f32>
   return %result : tensor<f32>
@@ -15,6 +15,19 @@
 //      RUN-TRACE{LITERAL}: [ 0. 4. 8. 12.]
 // RUN-TRACE-NEXT{LITERAL}: [ 0. 12. 24. 36.]
 
+// Tests that replaying with the recorded call timestamps produces the same
+// results.
+// RUN: (iree-compile --iree-hal-target-backends=vmvx %s | \
+// RUN:  iree-run-trace %S/iree-run-trace.yml \
+// RUN:                 --device=local-sync \
+// RUN:                 --honor_timestamps \
+// RUN:                 --input=4xf32=4,4,4,4) | \
+// RUN: FileCheck %s --check-prefix=TIMESTAMPS
+//      TIMESTAMPS: output[0]: hal.buffer_view
+// TIMESTAMPS-NEXT: 4xf32=0 4 8 12
+//      TIMESTAMPS: output[1]: hal.buffer_view
+// TIMESTAMPS-NEXT: 4xf32=0 12 24 36
+
 // Tests iree-run-benchmark usage by running the same sequence as above but with
 // benchmarking enabled. The tools are mostly interchangable except benchmarking
 // doesn't yield any output values or feature I/O printing. All traces that can